@@ -6,6 +6,8 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfconvert.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/reorder.cpp
@@ -14,6 +16,7 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/erf.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
 )
 
 if(MSVC)
@@ -35,7 +38,11 @@ if(MSVC)
         COMMAND
             armasm64.exe ${ARMASM_FLAGS} ${pre_filename} ${obj_filename}
     )
-    set(mlas_platform_srcs ${obj_filename})
+    set(mlas_platform_srcs
+      ${obj_filename}
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/sconv_kernel_neon.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/spool_kernel_neon.cpp
+    )
   elseif(CMAKE_GENERATOR_PLATFORM STREQUAL "ARM" OR CMAKE_GENERATOR MATCHES "ARM")
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/arm/sgemmc.cpp
@@ -59,10 +66,14 @@ if(MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SpoolKernelAvx.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SpoolKernelAvx512F.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/sgemma.asm
-      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/cvtfp16a.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelAvx512F.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelAvx512F.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelAvx512F.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SoftmaxKernelAvx512F.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfconvert_kernel_f16c.cpp
     )
   else()
     enable_language(ASM_MASM)
@@ -113,6 +124,8 @@ else()
 
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemmKernelNeon.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/sconv_kernel_neon.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/spool_kernel_neon.cpp
     )
   elseif(X86)
     enable_language(ASM)
@@ -157,6 +170,11 @@ else()
     )
     set_source_files_properties(${mlas_platform_srcs_avx} PROPERTIES COMPILE_FLAGS "-mavx")
 
+    set(mlas_platform_srcs_f16c
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfconvert_kernel_f16c.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_f16c} PROPERTIES COMPILE_FLAGS "-mavx -mf16c")
+
     set(mlas_platform_srcs_avx2
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/QgemmU8U8KernelAvx2.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelFma3.S
@@ -171,6 +189,10 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SconvKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SpoolKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SoftmaxKernelAvx512F.S
     )
     set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -183,6 +205,7 @@ else()
     set(mlas_platform_srcs
       ${mlas_platform_srcs_sse2}
       ${mlas_platform_srcs_avx}
+      ${mlas_platform_srcs_f16c}
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
       ${mlas_platform_srcs_avx512bw}
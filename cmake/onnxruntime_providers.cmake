@@ -68,6 +68,31 @@ if(onnxruntime_USE_NNAPI)
   set(PROVIDERS_NNAPI onnxruntime_providers_nnapi)
   list(APPEND ONNXRUNTIME_PROVIDER_NAMES nnapi)
 endif()
+# the kernels of the CPU execution provider built for an instruction set extension, selected at load on the CPUs
+# supporting it. see CpuIsaDispatch.
+file(GLOB_RECURSE onnxruntime_providers_avx2_srcs CONFIGURE_DEPENDS
+  "${ONNXRUNTIME_ROOT}/core/providers/cpu/*_avx2.cc"
+)
+file(GLOB_RECURSE onnxruntime_providers_avx512_srcs CONFIGURE_DEPENDS
+  "${ONNXRUNTIME_ROOT}/core/providers/cpu/*_avx512.cc"
+)
+set(onnxruntime_cpu_isa_kernels_x86 OFF)
+if(MSVC)
+  if(CMAKE_GENERATOR_PLATFORM STREQUAL "x64" OR CMAKE_GENERATOR MATCHES "Win64")
+    set(onnxruntime_cpu_isa_kernels_x86 ON)
+    set_source_files_properties(${onnxruntime_providers_avx2_srcs} PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+    set_source_files_properties(${onnxruntime_providers_avx512_srcs} PROPERTIES COMPILE_FLAGS "/arch:AVX512")
+  endif()
+elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64)$" AND NOT CMAKE_SYSTEM_NAME STREQUAL "Android")
+  set(onnxruntime_cpu_isa_kernels_x86 ON)
+  set_source_files_properties(${onnxruntime_providers_avx2_srcs} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
+  set_source_files_properties(${onnxruntime_providers_avx512_srcs} PROPERTIES COMPILE_FLAGS
+                              "-mavx512f -mavx512bw -mavx512vl -mavx2 -mfma -mf16c")
+endif()
+if(NOT onnxruntime_cpu_isa_kernels_x86)
+  list(REMOVE_ITEM onnxruntime_providers_srcs ${onnxruntime_providers_avx2_srcs} ${onnxruntime_providers_avx512_srcs})
+endif()
+
 source_group(TREE ${ONNXRUNTIME_ROOT}/core FILES ${onnxruntime_providers_common_srcs} ${onnxruntime_providers_srcs})
 
 set(onnxruntime_providers_src ${onnxruntime_providers_common_srcs} ${onnxruntime_providers_srcs})
@@ -85,6 +110,9 @@ if (onnxruntime_USE_AUTOML)
 endif()
 
 add_library(onnxruntime_providers ${onnxruntime_providers_src})
+if(onnxruntime_cpu_isa_kernels_x86)
+  target_compile_definitions(onnxruntime_providers PRIVATE ORT_CPU_ISA_KERNELS_X86)
+endif()
 onnxruntime_add_include_to_target(onnxruntime_providers onnxruntime_common onnxruntime_framework gsl onnx onnx_proto protobuf::libprotobuf)
 
 if (onnxruntime_USE_AUTOML)
@@ -54,6 +54,20 @@ if (onnxruntime_USE_MKLDNN)
   target_compile_definitions(onnxruntime_pybind11_state PRIVATE USE_MKLDNN=1)
 endif()
 
+if (onnxruntime_USE_CUDA)
+  # OrtValues on CUDA devices are allocated and copied by the module
+  target_include_directories(onnxruntime_pybind11_state PRIVATE ${onnxruntime_CUDNN_HOME}/include ${CMAKE_CUDA_TOOLKIT_INCLUDE_DIRECTORIES})
+endif()
+
+# the DLPack header comes with the tvm submodule
+set(onnxruntime_DLPACK_INCLUDE_DIR ${PROJECT_SOURCE_DIR}/external/tvm/3rdparty/dlpack/include)
+if (EXISTS ${onnxruntime_DLPACK_INCLUDE_DIR}/dlpack/dlpack.h)
+  target_include_directories(onnxruntime_pybind11_state PRIVATE ${onnxruntime_DLPACK_INCLUDE_DIR})
+  target_compile_definitions(onnxruntime_pybind11_state PRIVATE ENABLE_DLPACK)
+else()
+  message(WARNING "dlpack.h not found in ${onnxruntime_DLPACK_INCLUDE_DIR}: OrtValue.to_dlpack and from_dlpack are disabled")
+endif()
+
 target_include_directories(onnxruntime_pybind11_state PRIVATE ${ONNXRUNTIME_ROOT} ${PYTHON_INCLUDE_DIR} ${NUMPY_INCLUDE_DIR})
 target_include_directories(onnxruntime_pybind11_state PRIVATE ${pybind11_INCLUDE_DIRS})
 onnxruntime_add_include_to_target(onnxruntime_pybind11_state gsl)
@@ -112,14 +112,21 @@ set(onnxruntime_server_lib_srcs
   "${ONNXRUNTIME_ROOT}/server/http/json_handling.cc"
   "${ONNXRUNTIME_ROOT}/server/http/predict_request_handler.cc"
   "${ONNXRUNTIME_ROOT}/server/http/util.cc"
+  "${ONNXRUNTIME_ROOT}/server/batcher.cc"
   "${ONNXRUNTIME_ROOT}/server/environment.cc"
   "${ONNXRUNTIME_ROOT}/server/executor.cc"
+  "${ONNXRUNTIME_ROOT}/server/model_residency.cc"
+  "${ONNXRUNTIME_ROOT}/server/request_scheduler.cc"
+  "${ONNXRUNTIME_ROOT}/server/response_cache.cc"
+  "${ONNXRUNTIME_ROOT}/server/served_model.cc"
+  "${ONNXRUNTIME_ROOT}/server/shared_memory.cc"
   "${ONNXRUNTIME_ROOT}/server/converter.cc"
   "${ONNXRUNTIME_ROOT}/server/util.cc"
   "${ONNXRUNTIME_ROOT}/server/core/request_id.cc"
   "${ONNXRUNTIME_ROOT}/server/grpc/prediction_service_impl.cc"
   "${ONNXRUNTIME_ROOT}/server/grpc/grpc_app.cc"
   "${ONNXRUNTIME_ROOT}/server/serializing/tensorprotoutils.cc"
+  "${ONNXRUNTIME_ROOT}/core/common/metrics.cc"
   )
 if(NOT WIN32)
   if(HAS_UNUSED_PARAMETER)
@@ -178,6 +185,11 @@ target_link_libraries(onnxruntime_server_lib PRIVATE
   onnxruntime
 )
 
+# shm_open of the shared memory regions
+if (UNIX AND NOT APPLE)
+  target_link_libraries(onnxruntime_server_lib PUBLIC rt)
+endif()
+
 if (onnxruntime_USE_SYSLOG)
   target_compile_definitions(onnxruntime_server_lib PUBLIC USE_SYSLOG="1")
 endif()
@@ -540,7 +540,9 @@ install(TARGETS onnx_test_runner
         RUNTIME  DESTINATION ${CMAKE_INSTALL_BINDIR})
 
 if(onnxruntime_BUILD_BENCHMARKS)
-  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc)
+  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc
+                 ${TEST_SRC_DIR}/onnx/microbenchmark/run_state_cache.cc ${TEST_SRC_DIR}/onnx/microbenchmark/op_benchmark.cc
+                 ${TEST_SRC_DIR}/onnx/microbenchmark/dispatch_benchmark.cc)
   target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} benchmark)
   onnxruntime_add_include_to_target(onnxruntime_benchmark gsl)
   if(WIN32)
@@ -620,6 +622,21 @@ if (onnxruntime_USE_TVM)
   endif()
 endif()
 
+# runs the models of the model zoo through onnxruntime_perf_test, failing on regressions from the baseline
+if (onnxruntime_BUILD_BENCHMARKS AND onnxruntime_MODEL_ZOO_DIR)
+  find_package(PythonInterp 3.5 REQUIRED)
+  set(onnxruntime_model_zoo_benchmark_args --perf_test $<TARGET_FILE:onnxruntime_perf_test>
+      --model_dir ${onnxruntime_MODEL_ZOO_DIR} --output ${CMAKE_CURRENT_BINARY_DIR}/model_zoo_benchmark.json)
+  if (onnxruntime_MODEL_ZOO_BASELINE)
+    list(APPEND onnxruntime_model_zoo_benchmark_args --baseline ${onnxruntime_MODEL_ZOO_BASELINE})
+  endif()
+  add_custom_target(onnxruntime_model_zoo_benchmark
+    COMMAND ${PYTHON_EXECUTABLE} ${REPO_ROOT}/tools/python/model_zoo_benchmark.py ${onnxruntime_model_zoo_benchmark_args}
+    DEPENDS onnxruntime_perf_test
+    USES_TERMINAL)
+  set_target_properties(onnxruntime_model_zoo_benchmark PROPERTIES FOLDER "ONNXRuntimeTest")
+endif()
+
 # Opaque API test can not be a part of the shared lib tests since it is using
 # C++ internals apis to register custom type, kernel and schema. It also can not
 # a part of providers unit tests since it requires its own environment.
@@ -762,3 +779,10 @@ endif()
 list(APPEND onnxruntime_mlas_test_libs Threads::Threads)
 target_link_libraries(onnxruntime_mlas_test PRIVATE ${onnxruntime_mlas_test_libs})
 set_target_properties(onnxruntime_mlas_test PROPERTIES FOLDER "ONNXRuntimeTest")
+
+if(onnxruntime_BUILD_BENCHMARKS)
+  add_executable(onnxruntime_mlas_benchmark ${TEST_SRC_DIR}/mlas/bench.cpp)
+  target_include_directories(onnxruntime_mlas_benchmark PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc)
+  target_link_libraries(onnxruntime_mlas_benchmark PRIVATE benchmark ${onnxruntime_mlas_test_libs})
+  set_target_properties(onnxruntime_mlas_benchmark PROPERTIES FOLDER "ONNXRuntimeTest")
+endif()
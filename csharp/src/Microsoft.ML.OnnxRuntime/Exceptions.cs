@@ -26,6 +26,7 @@ namespace Microsoft.ML.OnnxRuntime
         InvalidGraph = 10,
         ShapeInferenceNotRegistered = 11,
         RequirementNotRegistered = 12,
+        OutOfMemory = 13,
     }
 
     /// <summary>
@@ -48,6 +49,7 @@ namespace Microsoft.ML.OnnxRuntime
             { ErrorCode.InvalidGraph, "InvalidGraph" },
             { ErrorCode.ShapeInferenceNotRegistered, "ShapeInferenceNotRegistered" },
             { ErrorCode.RequirementNotRegistered, "RequirementNotRegistered" },
+            { ErrorCode.OutOfMemory, "OutOfMemory" },
         };
 
         internal OnnxRuntimeException(ErrorCode errorCode, string message)
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+using Microsoft.ML.OnnxRuntime.Tensors;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// A native tensor created once on a pinned managed buffer, to be passed to many Run calls as an input or
+    /// as a preallocated output, without copying the data or allocating per call.
+    /// The buffer stays pinned until the value is disposed. Runs read an input from the buffer,
+    /// and write an output to it.
+    /// </summary>
+    public class FixedBufferOnnxValue : IDisposable
+    {
+        private MemoryHandle _pinnedMemory;
+        private bool _disposed = false;
+
+        internal IntPtr Value { get; private set; }
+
+        private FixedBufferOnnxValue(MemoryHandle pinnedMemory, IntPtr value)
+        {
+            _pinnedMemory = pinnedMemory;
+            Value = value;
+        }
+
+        /// <summary>
+        /// Creates a value on the buffer of a tensor. The data of tensors other than DenseTensor, and of string
+        /// tensors, is copied to a native buffer once.
+        /// </summary>
+        public static FixedBufferOnnxValue CreateFromTensor<T>(Tensor<T> value)
+        {
+            NamedOnnxValue.CreateFromTensor(string.Empty, value).ToNativeOnnxValue(out IntPtr nativeValue, out MemoryHandle pinnedMemory);
+            return new FixedBufferOnnxValue(pinnedMemory, nativeValue);
+        }
+
+        /// <summary>
+        /// Creates a value of the given dimensions on a buffer, which holds the elements in row-major order.
+        /// </summary>
+        public static FixedBufferOnnxValue CreateFromMemory<T>(Memory<T> memory, int[] dimensions)
+        {
+            return CreateFromTensor(new DenseTensor<T>(memory, dimensions));
+        }
+
+        #region IDisposable Support
+        protected virtual void Dispose(bool disposing)
+        {
+            if (_disposed)
+            {
+                return;
+            }
+
+            // the native tensor goes first, as it refers to the pinned buffer
+            NativeMethods.OrtReleaseValue(Value);
+            Value = IntPtr.Zero;
+            _pinnedMemory.Dispose();
+            _disposed = true;
+        }
+
+        ~FixedBufferOnnxValue()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+        #endregion
+    }
+}
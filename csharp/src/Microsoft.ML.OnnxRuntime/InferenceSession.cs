@@ -169,6 +169,73 @@ namespace Microsoft.ML.OnnxRuntime
 
         }
 
+        /// <summary>
+        /// Runs the loaded model with inputs and preallocated outputs on pinned buffers. The outputs are written to
+        /// the buffers of <paramref name="outputValues"/>, so no output value is allocated.
+        /// </summary>
+        /// <param name="inputNames"></param>
+        /// <param name="inputValues">in the order of <paramref name="inputNames"/></param>
+        /// <param name="outputNames"></param>
+        /// <param name="outputValues">in the order of <paramref name="outputNames"/></param>
+        public void Run(IReadOnlyCollection<string> inputNames, IReadOnlyCollection<FixedBufferOnnxValue> inputValues, IReadOnlyCollection<string> outputNames, IReadOnlyCollection<FixedBufferOnnxValue> outputValues)
+        {
+            Run(inputNames, inputValues, outputNames, outputValues, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with inputs and preallocated outputs on pinned buffers, using the given RunOptions.
+        /// </summary>
+        public void Run(IReadOnlyCollection<string> inputNames, IReadOnlyCollection<FixedBufferOnnxValue> inputValues, IReadOnlyCollection<string> outputNames, IReadOnlyCollection<FixedBufferOnnxValue> outputValues, RunOptions options)
+        {
+            if (inputNames.Count != inputValues.Count)
+            {
+                throw new ArgumentException(string.Format("{0} input names for {1} input values", inputNames.Count, inputValues.Count));
+            }
+            if (outputNames.Count != outputValues.Count)
+            {
+                throw new ArgumentException(string.Format("{0} output names for {1} output values", outputNames.Count, outputValues.Count));
+            }
+
+            IntPtr[] inputValueArray = inputValues.Select(value => value.Value).ToArray();
+            IntPtr[] outputValueArray = outputValues.Select(value => value.Value).ToArray();
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRun(
+                                                this._nativeHandle,
+                                                options.Handle,
+                                                inputNames.ToArray(),
+                                                inputValueArray,
+                                                (UIntPtr)inputValueArray.Length,
+                                                outputNames.ToArray(),
+                                                (UIntPtr)outputValueArray.Length,
+                                                outputValueArray /* preallocated, so the run writes to them */
+                                                ));
+        }
+
+        /// <summary>
+        /// Binds inputs and preallocated outputs on pinned buffers once, for <see cref="Run(PreparedRun)"/> calls that
+        /// don't allocate managed memory. Update the data of the input buffers between the calls.
+        /// </summary>
+        /// <returns>The PreparedRun, which must be disposed before the session.</returns>
+        public PreparedRun PrepareRun(IReadOnlyCollection<string> inputNames, IReadOnlyCollection<FixedBufferOnnxValue> inputValues, IReadOnlyCollection<string> outputNames, IReadOnlyCollection<FixedBufferOnnxValue> outputValues)
+        {
+            return new PreparedRun(_nativeHandle, inputNames, inputValues, outputNames, outputValues);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound by <see cref="PrepareRun"/>.
+        /// </summary>
+        public void Run(PreparedRun preparedRun)
+        {
+            preparedRun.Run(_nativeHandle, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound by <see cref="PrepareRun"/>, using the given RunOptions.
+        /// </summary>
+        public void Run(PreparedRun preparedRun, RunOptions options)
+        {
+            preparedRun.Run(_nativeHandle, options);
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -65,6 +65,31 @@ namespace Microsoft.ML.OnnxRuntime
                                                 IntPtr[] outputValues /* An array of output value pointers. Array must be allocated by the caller */
                                                 );
 
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtPrepareRun(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                string[] inputNames,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                out IntPtr /*(OrtPreparedRun*)*/ preparedRun);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtRunPrepared(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                IntPtr /*(OrtPreparedRun*)*/ preparedRun,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                UIntPtr outputCount,
+
+                                                [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 5 /*index of outputCount*/)][In, Out]
+                                                IntPtr[] outputValues /* preallocated values are used as is, null entries receive new values */
+                                                );
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtReleasePreparedRun(IntPtr /*(OrtPreparedRun*)*/ preparedRun);
+
 
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern IntPtr /*(OrtStatus*)*/ OrtSessionGetInputCount(
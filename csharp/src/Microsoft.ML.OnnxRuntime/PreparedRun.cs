@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// Inputs and outputs of a session bound once to FixedBufferOnnxValues, for repeated Run calls which neither
+    /// look the names up again nor allocate managed memory. Created by <see cref="InferenceSession.PrepareRun"/>.
+    /// The values must outlive the PreparedRun, which must be disposed before the session.
+    /// A PreparedRun must not be used by concurrent Run calls.
+    /// </summary>
+    public class PreparedRun : IDisposable
+    {
+        private IntPtr _nativeHandle;
+        private readonly IntPtr[] _inputValues;
+        private readonly IntPtr[] _outputValues;
+
+        internal PreparedRun(IntPtr sessionHandle,
+                             IReadOnlyCollection<string> inputNames,
+                             IReadOnlyCollection<FixedBufferOnnxValue> inputValues,
+                             IReadOnlyCollection<string> outputNames,
+                             IReadOnlyCollection<FixedBufferOnnxValue> outputValues)
+        {
+            if (inputNames.Count != inputValues.Count)
+            {
+                throw new ArgumentException(string.Format("{0} input names for {1} input values", inputNames.Count, inputValues.Count));
+            }
+            if (outputNames.Count != outputValues.Count)
+            {
+                throw new ArgumentException(string.Format("{0} output names for {1} output values", outputNames.Count, outputValues.Count));
+            }
+
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtPrepareRun(
+                                                sessionHandle,
+                                                inputNames.ToArray(),
+                                                (UIntPtr)inputNames.Count,
+                                                outputNames.ToArray(),
+                                                (UIntPtr)outputNames.Count,
+                                                out _nativeHandle));
+            _inputValues = inputValues.Select(value => value.Value).ToArray();
+            _outputValues = outputValues.Select(value => value.Value).ToArray();
+        }
+
+        internal void Run(IntPtr sessionHandle, RunOptions options)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRunPrepared(
+                                                sessionHandle,
+                                                options.Handle,
+                                                _nativeHandle,
+                                                _inputValues,
+                                                (UIntPtr)_inputValues.Length,
+                                                (UIntPtr)_outputValues.Length,
+                                                _outputValues));
+        }
+
+        #region IDisposable Support
+        protected virtual void Dispose(bool disposing)
+        {
+            if (_nativeHandle != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleasePreparedRun(_nativeHandle);
+                _nativeHandle = IntPtr.Zero;
+            }
+        }
+
+        ~PreparedRun()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+        #endregion
+    }
+}
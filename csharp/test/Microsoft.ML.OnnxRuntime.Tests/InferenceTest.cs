@@ -413,6 +413,36 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             }
         }
 
+        [Fact]
+        private void TestRunWithFixedBufferValues()
+        {
+            // model takes 1x5 input of fixed type, echoes back
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "test_types_FLOAT.pb");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                var inputBuffer = new float[] { 1.0f, 2.0f, -3.0f, float.MinValue, float.MaxValue };
+                var outputBuffer = new float[5];
+                var dims = new int[] { 1, 5 };
+                using (var input = FixedBufferOnnxValue.CreateFromMemory<float>(inputBuffer, dims))
+                using (var output = FixedBufferOnnxValue.CreateFromMemory<float>(outputBuffer, dims))
+                {
+                    session.Run(new[] { "input" }, new[] { input }, new[] { "output" }, new[] { output });
+                    Assert.Equal(inputBuffer, outputBuffer);
+
+                    using (var preparedRun = session.PrepareRun(new[] { "input" }, new[] { input }, new[] { "output" }, new[] { output }))
+                    {
+                        for (int i = 0; i < 3; i++)
+                        {
+                            inputBuffer[0] = i;
+                            session.Run(preparedRun);
+                            Assert.Equal(inputBuffer, outputBuffer);
+                        }
+                    }
+                }
+            }
+        }
+
         [Fact]
         private void TestModelInputBOOL()
         {
@@ -33,6 +33,18 @@ class Capture {
       : logger_{&logger}, severity_{severity}, category_{category}, data_type_{dataType}, location_{location} {
   }
 
+  /**
+     Initializes a new instance of the Capture class that isn't sent to a logger when destroyed, such as the copy of a
+     message a sink forwards to another sink.
+     @param severity The severity.
+     @param category The category.
+     @param dataType Type of the data.
+     @param location The file location the log message is coming from.
+  */
+  Capture(logging::Severity severity, const char* category, logging::DataType dataType, const CodeLocation& location)
+      : logger_{nullptr}, severity_{severity}, category_{category}, data_type_{dataType}, location_{location} {
+  }
+
   /**
      The stream that can capture the message via operator<<.
      @returns Output stream.
@@ -55,6 +55,7 @@ namespace profiling {
 enum EventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  KERNEL_EVENT,
   EVENT_CATEGORY_MAX
 };
 
@@ -63,7 +64,8 @@ Event descriptions for the above session events.
 */
 static constexpr const char* event_categor_names_[EVENT_CATEGORY_MAX] = {
     "Session",
-    "Node"};
+    "Node",
+    "Kernel"};
 
 /*
 Timing record for all events.
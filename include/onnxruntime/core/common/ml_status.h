@@ -20,7 +20,8 @@ enum class MLStatus : uint32_t {
   NOT_IMPLEMENTED = 9,
   INVALID_GRAPH = 10,
   SHAPE_INFERENCE_NOT_REGISTERED = 11,
-  REQUIREMENT_NOT_REGISTERED = 12
+  REQUIREMENT_NOT_REGISTERED = 12,
+  OUT_OF_MEMORY = 13
 };
 
 inline const char* MLStatusToString(MLStatus status) noexcept {
@@ -49,6 +50,8 @@ inline const char* MLStatusToString(MLStatus status) noexcept {
       return "SHAPE_INFERENCE_NOT_REGISTERED";
     case MLStatus::REQUIREMENT_NOT_REGISTERED:
       return "REQUIREMENT_NOT_REGISTERED";
+    case MLStatus::OUT_OF_MEMORY:
+      return "OUT_OF_MEMORY";
     default:
       return "GENERAL ERROR";
   }
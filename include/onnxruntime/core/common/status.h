@@ -44,6 +44,7 @@ enum StatusCode {
   INVALID_GRAPH = static_cast<unsigned int>(MLStatus::INVALID_GRAPH),
   SHAPE_INFERENCE_NOT_REGISTERED = static_cast<unsigned int>(MLStatus::SHAPE_INFERENCE_NOT_REGISTERED),
   REQUIREMENT_NOT_REGISTERED = static_cast<unsigned int>(MLStatus::REQUIREMENT_NOT_REGISTERED),
+  OUT_OF_MEMORY = static_cast<unsigned int>(MLStatus::OUT_OF_MEMORY),
 };
 
 class Status {
@@ -27,7 +27,9 @@ enum class AllocKind {
   kPreExisting = 2,
   kAllocateStatically = 3,
   kAllocateOutput = 4,
-  kShare = 5
+  kShare = 5,
+  kSubTensor = 6,  // a contiguous part of the buffer of another value, e.g. an input written in place into a Concat
+  kView = 7        // a strided view of the buffer of another value, created by the kernel, e.g. Transpose
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
@@ -10,10 +10,15 @@
 #include "core/framework/tensor.h"
 #include "core/framework/func_api.h"
 #include "core/framework/data_transfer.h"
+#include "core/framework/run_options.h"
 
 namespace onnxruntime {
 class GraphViewer;
+class IWeightStreamer;
 class Node;
+namespace profiling {
+class EpProfiler;
+}
 }  // namespace onnxruntime
 namespace onnxruntime {
 
@@ -38,6 +43,18 @@ struct NodeComputeInfo {
   DestroyFunctionStateFunc release_state_func;
 };
 
+/**
+   The device work of an execution, captured by IExecutionProvider::BeginGraphCapture/EndGraphCapture.
+   It keeps the memory the kernels allocated during the capture, as every replay uses the same addresses.
+*/
+class ICapturedGraph {
+ public:
+  virtual ~ICapturedGraph() = default;
+
+  // Submit the captured work again from the calling thread.
+  virtual common::Status Replay() = 0;
+};
+
 class IExecutionProvider {
  protected:
   IExecutionProvider(const std::string& type) : type_{type} {}
@@ -79,6 +96,14 @@ class IExecutionProvider {
   GetCapability(const onnxruntime::GraphViewer& graph_viewer,
                 const std::vector<const KernelRegistry*>& kernel_registries) const;
 
+  /**
+     Returns true if the provider can run the unassigned <node> with its own kernels, even if GetCapability
+     leaves it to another provider, e.g. because its inputs come from the CPU. The cost based partitioning
+     moves such nodes to the provider when that saves copies, see PartitioningCostModel.
+     The default is false, so that only the nodes the provider claims are assigned to it.
+  */
+  virtual bool CanRunNode(const onnxruntime::Node& /*node*/) const { return false; }
+
   /**
      Get kernel registry per execution provider type.
      The KernelRegistry share pointer returned is shared across sessions.
@@ -125,7 +150,7 @@ class IExecutionProvider {
      Run may not be finished on device This function should be regarded as the
      point after which a new Run would start to submit commands from CPU
   */
-  virtual common::Status OnRunStart();
+  virtual common::Status OnRunStart(const RunOptions& run_options);
 
   /**
      Called when InferenceSession::Run ended
@@ -133,10 +158,48 @@ class IExecutionProvider {
      may not be finished on device This function should be regarded as the point
      that all commands of current Run has been submmited by CPU
   */
-  virtual common::Status OnRunEnd();
+  virtual common::Status OnRunEnd(const RunOptions& run_options);
+
+  /**
+     Returns true if the provider can capture the device work that its kernels submit into a graph, which
+     later executions replay instead of running the kernels. See SessionOptions::enable_graph_capture.
+  */
+  virtual bool SupportsGraphCapture() const { return false; }
+
+  /**
+     Start capturing the device work submitted from the calling thread, instead of executing it.
+     The memory the provider allocates until EndGraphCapture is kept by the captured graph.
+  */
+  virtual common::Status BeginGraphCapture() const;
+
+  /**
+     End the capture started by BeginGraphCapture.
+     @param captured_graph the graph of the captured work. Left empty if the capture failed.
+  */
+  virtual common::Status EndGraphCapture(std::unique_ptr<ICapturedGraph>& captured_graph) const;
+
+  /**
+     Returns the profiler recording the work the provider runs asynchronously on its device in the session
+     profile, or nullptr if it has none. Called once per session.
+  */
+  virtual std::unique_ptr<profiling::EpProfiler> GetProfiler() { return nullptr; }
+
+  /**
+     Returns the streamer that copies the initializers the kernels of the provider read from its device memory,
+     kept in host memory instead, into a device buffer of buffer_size bytes ahead of their nodes. nullptr if the
+     provider doesn't support weight streaming. See SessionOptions::weight_streaming_buffer_size.
+  */
+  virtual std::unique_ptr<IWeightStreamer> CreateWeightStreamer(size_t /*buffer_size*/) { return nullptr; }
 
   void InsertAllocator(AllocatorPtr allocator);
 
+  /**
+     Replace the allocator registered for the same OrtMemoryInfo as <allocator>, if any.
+     Used to make the provider use an allocator that is shared with other sessions.
+     @return true if an allocator was replaced.
+  */
+  bool ReplaceAllocator(AllocatorPtr allocator);
+
   /**
   Given a list of fused_node, return create_state/compute/release_state func for each node.
   */
@@ -153,6 +216,14 @@ class IExecutionProvider {
   virtual common::Status Compile(const std::vector<onnxruntime::Node*>& fused_node,
                                  std::string& dll_path);
 
+  /**
+     Returns the configuration of the provider the functions returned by Compile depend on besides the fused node,
+     e.g. its device and backend. The sessions of the providers of the same configuration share the functions
+     compiled for the same fused subgraph, compiling it once in the process, see CompiledFuncCache.
+     Empty, the default, if the functions refer to the provider instance, so they can't outlive it.
+  */
+  virtual std::string GetCompileCacheKey() const { return std::string(); }
+
  private:
   const std::string type_;
   AllocatorMap allocators_;
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -48,7 +49,7 @@ class KernelDef {
   }
 #endif
 
-  onnxruntime::ProviderType Provider() const {
+  const onnxruntime::ProviderType& Provider() const {
     return provider_type_;
   }
 
@@ -64,6 +65,14 @@ class KernelDef {
     return alias_map_;
   }
 
+  const std::vector<std::pair<int, int>>& MayView() const {
+    return view_map_;
+  }
+
+  bool AcceptsStridedInput(size_t input_index) const {
+    return std::find(strided_inputs_.begin(), strided_inputs_.end(), input_index) != strided_inputs_.end();
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -118,6 +127,12 @@ class KernelDef {
   // An element <i, j> means that output j is an alias of input i.
   std::vector<std::pair<int, int>> alias_map_;
 
+  // An element <i, j> means that output j may be a strided view of input i.
+  std::vector<std::pair<int, int>> view_map_;
+
+  // The inputs the kernel reads through their strides, so it gets strided views as they are.
+  std::vector<size_t> strided_inputs_;
+
   // The memory types of inputs/outputs of this kernel
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
@@ -201,6 +216,23 @@ class KernelDefBuilder {
   KernelDefBuilder& Alias(const std::vector<std::pair<int, int>>& aliases);
   KernelDefBuilder& Alias(int input_index, int output_index);
 
+  /**
+     View mapping from inputs to outputs. The kernel may create the output as a
+     strided view of the input with OpKernelContext::OutputView, such as for
+     Transpose and Slice, if the allocation plan lets it. The consumers of the
+     view must accept it as a strided input for the plan to let it.
+  */
+  KernelDefBuilder& MayView(int input_index, int output_index);
+
+  /**
+     Specify that this kernel reads an input through its strides, see Tensor::Strides.
+     The other inputs are copied into contiguous tensors if they are strided views.
+  */
+  KernelDefBuilder& AcceptStridedInput(int input_index) {
+    kernel_def_->strided_inputs_.push_back(static_cast<size_t>(input_index));
+    return *this;
+  }
+
   /**
      Specify that this kernel requires an input arg
      in certain memory type (instead of the default, device memory).
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 /**
@@ -33,7 +36,10 @@ class KernelRegistry {
                          std::unique_ptr<OpKernel>& op_kernel) const;
 
   // Check if an execution provider can create kernel for a node and return
-  // the kernel if so
+  // the kernel if so.
+  // The result is cached by the signature of the node: its op, schema version,
+  // provider and argument types, so the nodes of a signature seen before, in
+  // this or an earlier session sharing the registry, skip the type checks.
   const KernelCreateInfo* TryFindKernel(const onnxruntime::Node& node,
                                         onnxruntime::ProviderType exec_provider) const;
 
@@ -67,7 +73,18 @@ class KernelRegistry {
                               std::string& error_str,
                               onnxruntime::ProviderType exec_provider = "");
 
+  void AddToKernelIndex(const KernelCreateInfo& create_info);
+
   // Kernel create function map from op name to kernel creation info.
   KernelCreateMap kernel_creator_fn_map_;
+
+  // The entries of kernel_creator_fn_map_ by op name, domain and provider, in
+  // registration order.
+  std::unordered_map<std::string, std::vector<const KernelCreateInfo*>> kernel_index_;
+
+  // The kernel found for each node signature by TryFindKernel, or nullptr if
+  // there is none. Cleared when a kernel is registered.
+  mutable OrtMutex kernel_lookup_cache_lock_;
+  mutable std::unordered_map<std::string, const KernelCreateInfo*> kernel_lookup_cache_;
 };
 }  // namespace onnxruntime
@@ -65,6 +65,15 @@ class OpKernelContext {
                            const OpKernel* kernel,
                            const logging::Logger& logger);
 
+  /**
+  @param node_offset The offset of the values of the kernel's node in the frame, when the caller already has it.
+  See IExecutionFrame::GetNodeOffset.
+  */
+  OpKernelContext(IExecutionFrame* frame,
+                  const OpKernel* kernel,
+                  int node_offset,
+                  const logging::Logger& logger);
+
   virtual ~OpKernelContext() = default;
 
   /**
@@ -109,6 +118,13 @@ class OpKernelContext {
   // unless static optimization pre-allocates it.
   SparseTensor* Output(int index, size_t num_values, const TensorShape& shape);
 
+  // Create the output tensor as a strided view of the buffer of an input, with the strides in elements and the
+  // offset in bytes from the start of that buffer, if the kernel may view the input (see KernelDefBuilder::MayView)
+  // and the allocation plan lets it.
+  // Return nullptr otherwise, in which case the kernel must write the output with Output(index, shape).
+  Tensor* OutputView(int index, const Tensor& input, const TensorShape& shape, const std::vector<int64_t>& strides,
+                     int64_t byte_offset);
+
   const logging::Logger& Logger() const {
     return *logger_;
   }
@@ -163,6 +179,16 @@ class OpKernelContext {
   **/
   const std::string& GetOpDomain() const;
 
+  /**
+  Returns true once the Run the kernel is part of has been asked to terminate (see RunOptions::terminate).
+  Kernels that run for long, such as the iterations of the control flow operators or a Conv over a large batch,
+  check it between their steps and return TerminatedStatus() so the Run gives its threads back promptly.
+  **/
+  virtual bool IsTerminated() const noexcept { return false; }
+
+  // The status a kernel returns when it stops early because IsTerminated() is true.
+  static Status TerminatedStatus();
+
  protected:
   onnxruntime::NodeIndex GetNodeIndex() const;
 
@@ -180,6 +206,9 @@ class OpKernelContext {
 
   OrtValue* GetOrCreateOutputMLValue(int index);
 
+  // the value itself, or a contiguous copy if it is a strided view and the kernel doesn't accept those
+  const OrtValue* GetInputMLValueAsAccepted(int arg_index, const OrtValue* p_ml_value) const;
+
   int GetInputArgIndex(int index) const;
   int GetImplicitInputArgIndex(int index) const;
   int GetOutputArgIndex(int index) const;
@@ -192,6 +221,9 @@ class OpKernelContext {
   int node_input_start_index_{-1};
   int node_implicit_input_start_index_{-1};
   int node_output_start_index_{-1};
+
+  // contiguous copies of the strided inputs, made when the kernel first gets them, by their index in the frame
+  mutable std::unordered_map<int, OrtValue> contiguous_inputs_;
 };
 
 // Fetching output tensor without shape is not allowed except when it already exists
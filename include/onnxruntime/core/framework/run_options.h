@@ -22,6 +22,17 @@ struct OrtRunOptions {
   // be forced to terminate with an error status.
   bool terminate = false;
 
+  // Stream of the application that the Run is ordered with, such as a cudaStream_t for the CUDA execution
+  // provider. nullptr uses the stream given to the execution provider, if any.
+  void* compute_stream = nullptr;
+
+  // If > 0, a Run whose feeds are tensors sharing a first dimension that the model leaves unspecified, and that is
+  // larger than this, is split along it into micro-batches of at most this many rows. The micro-batches run one after
+  // another and their outputs are written into the outputs of the whole batch, which bounds the peak memory of large
+  // batches. Only valid for models whose rows are computed independently, and whose outputs all keep the rows in their
+  // first dimension.
+  int64_t max_micro_batch_size = 0;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
@@ -73,6 +73,15 @@ class Tensor final {
    */
   Tensor(MLDataType p_type, const TensorShape& shape, std::shared_ptr<IAllocator> allocator, int64_t offset = 0);
 
+  /**
+   * Create tensor with given type, shape and pre-allocated memory, taking the ownership of the memory.
+   * The buffer is released with deleter->Free(p_data) when the tensor is destructed.
+   * \param p_data A preallocated buffer. String elements are constructed in it, as for an allocated buffer.
+   * \param deleter The allocator releasing the buffer. Its Info() is where the buffer is.
+   */
+  Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, std::shared_ptr<IAllocator> deleter,
+         int64_t offset = 0);
+
   ~Tensor();
 
   //Move is allowed
@@ -87,6 +96,12 @@ class Tensor final {
   */
   MLDataType DataType() const { return dtype_; }
 
+  /**
+     Returns true if the elements are strings, which are constructed in the buffer
+     rather than copied as bytes.
+  */
+  bool IsDataTypeString() const { return dtype_ == DataTypeImpl::GetType<std::string>(); }
+
   /**
      Returns the shape of the tensor.
   */
@@ -97,6 +112,11 @@ class Tensor final {
   */
   const OrtMemoryInfo& Location() const { return alloc_info_; }
 
+  /**
+     Returns true if the tensor releases its buffer when destructed.
+  */
+  bool OwnsBuffer() const noexcept { return buffer_deleter_ != nullptr; }
+
   /**
      May return nullptr if tensor size is zero
   */
@@ -155,12 +175,35 @@ class Tensor final {
     return p_data_;
   }
 
+  /**
+     Returns the offset in bytes of the first element from the start of the buffer.
+  */
+  int64_t ByteOffset() const noexcept { return byte_offset_; }
+
+  /**
+     Returns false if the tensor is a strided view of its buffer, whose elements are not laid out one after another.
+     Only the kernels accepting strided inputs (see KernelDefBuilder::AcceptStridedInputs) get such tensors.
+  */
+  bool IsContiguous() const noexcept { return strides_.empty(); }
+
+  /**
+     Returns the distance in elements between consecutive indices of each dimension.
+  */
+  std::vector<int64_t> Strides() const;
+
+  /**
+     Makes the tensor a view of its buffer with the given strides in elements, one per dimension.
+     Strides that describe the contiguous layout make the tensor contiguous again.
+  */
+  void SetStrides(const std::vector<int64_t>& strides);
+
   /**
    * Resizes the tensor without touching underlying storage.
    * This requires the total size of the tensor to remains constant.
    * @warning this function is NOT thread-safe.
    */
   inline void Reshape(const TensorShape& new_shape) {
+    ORT_ENFORCE(IsContiguous(), "A strided view can't be reshaped");
     ORT_ENFORCE(shape_.Size() == new_shape.Size(),
                 "Tensor size (" + std::to_string(shape_.Size()) +
                     ") != new size (" + std::to_string(new_shape.Size()) + ")");
@@ -204,8 +247,16 @@ class Tensor final {
   MLDataType dtype_;
   OrtMemoryInfo alloc_info_;
   int64_t byte_offset_;
+  // the strides in elements of a view, empty if the tensor is contiguous
+  std::vector<int64_t> strides_;
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
+
+/**
+   Copies the elements of a tensor on the CPU, contiguous or a strided view, into the contiguous tensor dst of the
+   same type and shape.
+*/
+void CopyToContiguous(const Tensor& src, Tensor& dst);
 }  // namespace onnxruntime
@@ -454,6 +454,11 @@ class Node {
 
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
+
+  // Hash of the inputs, outputs and initializers seen by the last successful type and shape inferencing of this
+  // Node. Resolve skips the inferencing while it matches, and changes to the attributes invalidate it.
+  size_t inference_signature_ = 0;
+  bool inference_signature_valid_ = false;
 };
 
 /**
@@ -593,6 +598,15 @@ class Graph {
     return *(result.first->second);
   }
 
+  /** Replaces the type and shape of a NodeArg, e.g. when a graph transformer changes the node producing a graph
+  output to one with a different output type.
+  @param node_arg NodeArg of this Graph.
+  @param type_proto The new type and shape.
+  */
+  void SetNodeArgType(NodeArg& node_arg, const ONNX_NAMESPACE::TypeProto& type_proto) {
+    node_arg.SetType(type_proto);
+  }
+
   /** Generate a unique name.in this Graph for a NodeArg */
   std::string GenerateNodeArgName(const std::string& base_name);
 
@@ -828,7 +842,8 @@ class Graph {
   struct ResolveContext {
     ResolveContext() = default;
 
-    std::unordered_map<std::string, std::pair<Node*, int>> output_args;
+    // keyed by the NodeArg instances of this graph, which are unique per name, to avoid hashing the names
+    std::unordered_map<const NodeArg*, std::pair<Node*, int>> output_args;
     std::unordered_set<std::string> inputs_and_initializers;
     std::unordered_set<std::string> outer_scope_node_args;
     std::unordered_map<std::string, NodeIndex> node_name_to_index;
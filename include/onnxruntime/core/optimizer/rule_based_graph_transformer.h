@@ -67,7 +67,10 @@ class RuleBasedGraphTransformer : public GraphTransformer {
 
  private:
   using RuleEffect = RewriteRule::RewriteRuleEffect;
-  
+
+  // The maximum number of times the rules are applied to a node while they keep modifying the graph around it.
+  static constexpr unsigned kMaxRoundsPerNode = 8;
+
   // The list of unique pointers for all rules (so that rules can be registered for several op types).
   std::vector<std::unique_ptr<RewriteRule>> rules_;
   // Map that associates a node's op type with the vector of rules that are registered to be triggered for that node.
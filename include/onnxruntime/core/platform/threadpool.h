@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <functional>
@@ -25,6 +27,20 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+struct ThreadOptions {
+  // logical processors the threads are pinned to. thread i runs on affinity[i % affinity.size()].
+  // empty leaves the placement to the OS.
+  std::vector<int> affinity;
+
+  // split the work of ParallelFor into one block per thread, and keep the threads that ran a block polling for the
+  // next ParallelFor for spin_duration_us before they go back to the pool, where they park once it is empty.
+  // Saves the wake-up of parked threads on every ParallelFor, which matters when a whole inference takes less
+  // than a millisecond, at the cost of keeping the processors busy while polling. The polling threads don't
+  // run the other work scheduled on the pool until they stop polling.
+  bool low_latency = false;
+  int spin_duration_us = 1000;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
@@ -36,6 +52,10 @@ class ThreadPool {
   */
   ThreadPool(const std::string& name, int num_threads);
 
+  ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options);
+
+  ~ThreadPool();
+
   /*
   Enqueue a unit of work.
   */
@@ -58,10 +78,31 @@ class ThreadPool {
 
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler() { return *impl_; }
 
  private:
-  Eigen::ThreadPool impl_;
+  struct ParallelSection;
+  struct Worker;
+
+  void LowLatencyParallelFor(int32_t total, const std::function<void(int32_t)>& fn);
+  // hand the section to up to count polling threads. returns how many took it.
+  int AssignWorkers(ParallelSection& section, int count);
+  // schedule threads to poll for work until count threads are polling or about to.
+  void WakeWorkers(int count);
+  void SpinForWork(Worker& worker);
+
+  const bool low_latency_;
+  const std::chrono::microseconds spin_duration_;
+  // polling state of each thread of the pool, indexed by CurrentThreadId
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<int> awake_workers_{0};
+  std::atomic<int> spinning_workers_{0};
+  // tasks scheduled and not started yet, exported as the queue depth of the pool
+  std::atomic<int> pending_tasks_{0};
+  size_t metrics_collector_id_;
+
+  // declared last so the threads are joined before the state they poll is destroyed
+  std::unique_ptr<Eigen::ThreadPoolInterface> impl_;
 };
 
 }  // namespace concurrency
@@ -12,6 +12,41 @@ extern "C" {
  */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * \param device_id cuda device id, starts from zero.
+ * \param compute_stream cudaStream_t of the application. Every Run starts after the work submitted to the stream
+ * before it, and the work submitted to the stream after the Run waits for it, without blocking the host.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDAWithStream, _In_ OrtSessionOptions* options, int device_id,
+               _In_ void* compute_stream);
+
+/**
+ * \param device_id cuda device id, starts from zero.
+ * \param cudnn_algo_cache_filepath file the cudnn algorithms found by benchmarking, such as for Conv, are loaded
+ * from when the provider is created and saved to when it is destroyed. The algorithms are shared by the sessions of
+ * the process, and later processes with the same GPU model and cudnn version skip the benchmarks.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDAWithAlgoCache, _In_ OrtSessionOptions* options,
+               int device_id, _In_ const ORTCHAR_T* cudnn_algo_cache_filepath);
+
+/**
+ * \param device_id cuda device id, starts from zero.
+ * The device memory is allocated by a caching allocator the threads share instead of an arena per thread. The blocks
+ * freed are cached in bins of size classes and reused in the order of the stream they were allocated on, without
+ * synchronizing, and the blocks cached are given back to the device when it runs out of memory and by
+ * OrtSessionShrinkArenas.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDAWithCachingAllocator, _In_ OrtSessionOptions* options,
+               int device_id);
+
+/**
+ * Get the allocator of pinned host memory shared by the process, an arena that grows on demand.
+ * The inputs created in its memory, e.g. by OrtCreateTensorWithDataAsOrtValue with the OrtMemoryInfo of the
+ * allocator, are copied to the CUDA devices asynchronously and without staging them in other pinned memory.
+ * \param out Owned by the runtime, it must not be freed.
+ */
+ORT_API_STATUS(OrtGetCudaPinnedAllocator, _Outptr_ OrtAllocator** out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,14 @@ extern "C" {
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_OpenVINO,
     _In_ OrtSessionOptions* options, const char* device_id);
 
+/**
+ * \param device_id the OpenVINO device and precision, like CPU_FP32.
+ * \param num_streams the number of infer requests per subgraph, which concurrent Runs share,
+ *   and the number of throughput streams on CPU. 0 for the latency mode of the device.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_OpenVINOWithStreams,
+    _In_ OrtSessionOptions* options, const char* device_id, int num_streams);
+
 #ifdef __cplusplus
 }
 #endif
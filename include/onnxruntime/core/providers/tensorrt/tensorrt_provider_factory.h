@@ -9,6 +9,30 @@ extern "C" {
 
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Tensorrt, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * \param max_batch_size the batch size the engines are built for when the session is created, 0 to read it from
+ * ORT_TENSORRT_MAX_BATCH_SIZE. Larger batches fail unless max_dynamic_batch_size allows them.
+ * \param max_workspace_size the workspace size of the engines in bytes, 0 to read it from
+ * ORT_TENSORRT_MAX_WORKSPACE_SIZE.
+ * \param max_dynamic_batch_size the largest batch for which an engine is built on demand, for the next power of two
+ * of the batch size, when the engines built so far are too small. 0 not to build engines on demand.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_TensorrtWithBatchSizes, _In_ OrtSessionOptions* options,
+               int device_id, int max_batch_size, size_t max_workspace_size, int max_dynamic_batch_size);
+
+/**
+ * \param fp16_enable nonzero to build FP16 engines, where the GPU has fast FP16.
+ * \param int8_enable nonzero to build INT8 engines, where the GPU has fast INT8. Without a calibration table, the
+ * engines run in FP32, or FP16, until the calibration recorded the inputs of int8_calibration_size rows from the runs
+ * of the session, then they are calibrated on them and replaced with INT8 engines.
+ * \param int8_calibration_table_path the directory the calibration tables are read from and written to, so that
+ * only the first session calibrates. NULL or empty to keep them in memory.
+ * \param int8_calibration_size the number of input rows to calibrate on, 0 for 512.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_TensorrtWithPrecision, _In_ OrtSessionOptions* options,
+               int device_id, int fp16_enable, int int8_enable, _In_opt_ const char* int8_calibration_table_path,
+               int int8_calibration_size);
+
 #ifdef __cplusplus
 }
 #endif
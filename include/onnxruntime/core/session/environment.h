@@ -5,10 +5,33 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+struct OrtArenaCfg;
+
+// Settings of the thread pools owned by the environment. See OrtCreateThreadingOptions.
+struct OrtThreadingOptions {
+  // number of threads running the parallel loops inside the kernels. <0 lets the runtime choose, 0 creates no pool.
+  int intra_op_num_threads = -1;
+  // number of threads the parallel executor runs the nodes on. 0 creates no pool, so the nodes
+  // run on the intra-op pool.
+  int inter_op_num_threads = 0;
+  // logical processors the threads of each pool are pinned to. empty leaves the placement to the OS.
+  std::vector<int> intra_op_thread_affinity;
+  std::vector<int> inter_op_thread_affinity;
+};
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+using ThreadingOptions = OrtThreadingOptions;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -20,6 +43,13 @@ class Environment {
   */
   static Status Create(std::unique_ptr<Environment>& environment);
 
+  /**
+     Create and initialize the runtime environment, along with thread pools that are shared by all the sessions
+     created with SessionOptions::use_per_session_threads set to false.
+     @param tp_options settings of the thread pools. nullptr creates no thread pools.
+  */
+  static Status Create(std::unique_ptr<Environment>& environment, const ThreadingOptions* tp_options);
+
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
   */
@@ -30,6 +60,30 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Register an allocator to be shared by all sessions created with SessionOptions::use_env_allocators.
+     Such a session uses it in place of the allocator its execution providers create for the same OrtMemoryInfo.
+     Fails if an allocator is already registered for that OrtMemoryInfo.
+  */
+  Status RegisterAllocator(AllocatorPtr allocator);
+
+  /**
+     Create a CPU allocator, backed by an arena if mem_info.type is OrtArenaAllocator, and register it.
+     @param arena_cfg settings of the arena. nullptr uses the defaults.
+  */
+  Status CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, const OrtArenaCfg* arena_cfg);
+
+  /**
+     Returns a snapshot of the allocators registered so far.
+  */
+  std::vector<AllocatorPtr> GetRegisteredSharedAllocators() const;
+
+  /**
+     Returns the thread pools shared by the sessions. Either may be nullptr.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_.get(); }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_.get(); }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -37,5 +91,11 @@ class Environment {
   Status Initialize();
 
   static std::atomic<bool> is_initialized_;
+
+  mutable OrtMutex shared_allocators_mutex_;
+  std::vector<AllocatorPtr> shared_allocators_;
+
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
 };
 }  // namespace onnxruntime
@@ -124,6 +124,8 @@ typedef enum OrtErrorCode {
   ORT_INVALID_GRAPH,
   ORT_SHAPE_INFERENCE_NOT_REGISTERED,
   ORT_REQUIREMENT_NOT_REGISTERED,
+  // an allocation failed, as a memory limit was reached or the device is out of memory
+  ORT_OUT_OF_MEMORY,
 } OrtErrorCode;
 
 // __VA_ARGS__ on Windows and Linux are different
@@ -154,6 +156,9 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(ArenaCfg);
+ORT_RUNTIME_CLASS(ThreadingOptions);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -182,6 +187,69 @@ ORT_API_STATUS(OrtCreateEnvWithCustomLogger, OrtLoggingFunction logging_function
                _In_ const char* logid,
                _Outptr_ OrtEnv** out);
 
+/**
+ * Create an environment whose log messages are written by a thread of its own: logging a message only queues a copy
+ * of it, so a slow logging_function or console doesn't slow down the threads running the models. The messages queued
+ * are all written before OrtReleaseEnv returns.
+ * \param logging_function Called with each message, from the logging thread. May be null to write the messages to
+ *   std::clog as OrtCreateEnv does.
+ * \param out Should be freed by `OrtReleaseEnv` after use
+ */
+ORT_API_STATUS(OrtCreateEnvWithAsyncLogger, _In_opt_ OrtLoggingFunction logging_function,
+               _In_opt_ void* logger_param, OrtLoggingLevel default_logging_level,
+               _In_ const char* logid,
+               _Outptr_ OrtEnv** out);
+
+/**
+ * Create an allocator owned by the environment and shared by all sessions created with OrtEnableEnvAllocators,
+ * so that they don't each hold their own idle arena. Only CPU allocators are supported.
+ * \param mem_info Describes the allocator. Its type chooses between an arena (OrtArenaAllocator) and a plain
+ *   device allocator (OrtDeviceAllocator).
+ * \param arena_cfg Settings of the arena. May be null to use the defaults.
+ */
+ORT_API_STATUS(OrtCreateAndRegisterAllocator, _Inout_ OrtEnv* env, _In_ const OrtMemoryInfo* mem_info,
+               _In_opt_ const OrtArenaCfg* arena_cfg);
+
+/**
+ * Create the settings of the thread pools owned by an OrtEnv. See OrtCreateEnvWithGlobalThreadPools.
+ * By default the intra-op pool gets a runtime chosen number of threads, there is no inter-op pool and
+ * the threads aren't pinned to any processor.
+ * \return A pointer to the newly created object. The pointer should be freed by OrtReleaseThreadingOptions after use
+ */
+ORT_API_STATUS(OrtCreateThreadingOptions, _Outptr_ OrtThreadingOptions** out);
+
+/**
+ * \param intra_op_num_threads Threads running the parallel loops inside the kernels.
+ *   <0, let the runtime choose a default. =0, Don't create extra threads.
+ */
+ORT_API_STATUS(OrtSetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads);
+
+/**
+ * \param inter_op_num_threads Threads the parallel executor runs the nodes on.
+ *   =0, Don't create extra threads: the nodes run on the intra-op pool.
+ */
+ORT_API_STATUS(OrtSetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads);
+
+/**
+ * Pin the threads of a pool to the given logical processors. Thread i runs on logical_processors[i % num_processors],
+ * so listing the processors of one socket or NUMA node keeps the pool on it. Pass 0 processors to unpin the threads.
+ * Threads whose processor isn't available run unpinned.
+ */
+ORT_API_STATUS(OrtSetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+               _In_opt_ const int* logical_processors, size_t num_processors);
+ORT_API_STATUS(OrtSetGlobalInterOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+               _In_opt_ const int* logical_processors, size_t num_processors);
+
+/**
+ * Create an OrtEnv owning thread pools shared by all the sessions created with OrtDisablePerSessionThreads,
+ * so that they don't each start their own threads.
+ * \param tp_options Settings of the thread pools. They are copied.
+ * \param out Should be freed by `OrtReleaseEnv` after use
+ */
+ORT_API_STATUS(OrtCreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+               _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out)
+ORT_ALL_ARGS_NONNULL;
+
 // TODO: document the path separator convention? '/' vs '\'
 // TODO: should specify the access characteristics of model_path. Is this read only during the
 // execution of OrtCreateSession, or does the OrtSession retain a handle to the file/directory
@@ -198,12 +266,87 @@ ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtValue** out);
 
+/**
+ * Called during an OrtRunWithOutputAllocator call once the shape of an output is known, for the memory to write
+ * it into.
+ * \param user_data The user_data passed to OrtRunWithOutputAllocator.
+ * \param output_index The index of the output in the output names.
+ * \param size The size of the output in bytes.
+ * \return A CPU buffer of at least size bytes, suitably aligned for type, or NULL for the output to be allocated
+ *  by the session. The buffer must stay valid while the output value is used, and isn't freed by it.
+ */
+typedef void*(ORT_API_CALL* OrtOutputAllocatorFn)(void* user_data, size_t output_index,
+                                                  ONNXTensorElementDataType type, const int64_t* shape,
+                                                  size_t shape_len, size_t size);
+
+/**
+ * Same as OrtRun, but the outputs that are NULL in the output array are written into the memory returned by
+ * allocator, e.g. a shared memory region, so they don't need to be copied out of the session's memory.
+ * Only the non-string tensor outputs that the session computes in CPU memory go through the allocator; the other
+ * outputs are allocated as with OrtRun. Compare the data pointer of an output with the buffer to tell them apart.
+ * The outputs should still be freed by OrtReleaseValue.
+ */
+ORT_API_STATUS(OrtRunWithOutputAllocator, _Inout_ OrtSession* sess,
+               _In_opt_ const OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len,
+               _In_ OrtOutputAllocatorFn allocator, _In_opt_ void* user_data, _Inout_ OrtValue** output);
+
+/**
+ * Resolve the input and output names of OrtRunPrepared calls once, instead of in every OrtRun.
+ * The names are checked against the model and mapped to the session's values here, and the device copies of
+ * the inputs and outputs are worked out in the first OrtRunPrepared, so later calls must pass inputs and outputs
+ * on the same devices.
+ * An OrtPreparedRun must not be used by concurrent OrtRunPrepared calls; prepare one for each thread instead.
+ * \param out Should be freed by OrtReleasePreparedRun, before the session is released.
+ */
+ORT_API_STATUS(OrtPrepareRun, _Inout_ OrtSession* sess,
+               _In_ const char* const* input_names, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtPreparedRun** out);
+
+/**
+ * Same as OrtRun, with the input and output names of prepared_run.
+ * \param input in the order of the input names passed to OrtPrepareRun
+ * \param out in the order of the output names passed to OrtPrepareRun
+ */
+ORT_API_STATUS(OrtRunPrepared, _Inout_ OrtSession* sess,
+               _In_opt_ const OrtRunOptions* run_options, _Inout_ OrtPreparedRun* prepared_run,
+               _In_ const OrtValue* const* input, size_t input_len,
+               size_t output_len, _Outptr_ OrtValue** out);
+
+/**
+ * Called once when an OrtRunAsync call completes, on the thread that executed it.
+ * \param user_data The user_data passed to OrtRunAsync.
+ * \param outputs The output array passed to OrtRunAsync. If status is NULL, the entries that were NULL hold
+ *  new values, which should be freed by OrtReleaseValue.
+ * \param status NULL if the run succeeded. Otherwise it should be freed by OrtReleaseStatus.
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                                  OrtStatus* status);
+
+/**
+ * Same as OrtRun, but returns once the run is scheduled on the inter-op thread pool of the env (see
+ * OrtCreateEnvWithGlobalThreadPools), or on threads of the session when it doesn't use the global thread pools.
+ * It fails if the session uses the global thread pools and the env has no inter-op one.
+ * run_options, if not NULL, and the output array must stay valid until the callback is called.
+ * The inputs are referenced by the run, so they can be released once this returns.
+ * Releasing the session waits for its pending runs.
+ * \param callback Called when the outputs are ready, or the run failed. It's not called if this returns an error.
+ */
+ORT_API_STATUS(OrtRunAsync, _Inout_ OrtSession* sess,
+               _In_opt_ const OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Inout_ OrtValue** output,
+               _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
 ORT_API_STATUS(OrtCreateSessionOptions, _Outptr_ OrtSessionOptions** options);
 
 // Set filepath to save optimized model after graph level transformations.
+// Sessions created from the saved model with the same execution providers and an optimization level no higher than
+// the one it was saved with skip the graph transformations.
 ORT_API_STATUS(OrtSetOptimizedModelFilePath, _Inout_ OrtSessionOptions* options, _In_ const ORTCHAR_T* optimized_model_filepath);
 
 // create a copy of an existing OrtSessionOptions
@@ -215,6 +358,21 @@ ORT_API_STATUS(OrtDisableSequentialExecution, _Inout_ OrtSessionOptions* options
 ORT_API_STATUS(OrtEnableProfiling, _Inout_ OrtSessionOptions* options, _In_ const ORTCHAR_T* profile_file_prefix);
 ORT_API_STATUS(OrtDisableProfiling, _Inout_ OrtSessionOptions* options);
 
+// Profile only 1 in sampling_interval executions of the graphs when profiling is enabled, recording the time of
+// their nodes without locking or allocating, so that profiling can stay enabled in production.
+// 0, the default, records all the events of all the executions.
+ORT_API_STATUS(OrtSetProfilingSamplingInterval, _Inout_ OrtSessionOptions* options, int sampling_interval);
+
+// Record the cycles, instructions, last level cache misses and estimated memory bandwidth of each node when
+// profiling is enabled, read from the hardware counters of the thread running the graph. Linux only.
+ORT_API_STATUS(OrtEnableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options);
+
+// Record the duration and failures of the runs of the session, the compute time of its kernels per execution
+// provider and the bytes its Memcpy nodes copy, labelled with the logid of the session. See OrtGetMetrics.
+ORT_API_STATUS(OrtEnableMetrics, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableMetrics, _Inout_ OrtSessionOptions* options);
+
 // Enable the memory pattern optimization.
 // The idea is if the input shapes are the same, we could trace the internal memory allocation
 // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -223,12 +381,108 @@ ORT_API_STATUS(OrtDisableProfiling, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtEnableMemPattern, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtDisableMemPattern, _Inout_ OrtSessionOptions* options);
 
+// Plan the memory pattern once when the session is initialized, from the execution order and the inferred
+// shapes, instead of tracing it from a Run. Tensors whose lifetimes don't overlap share memory even if their
+// sizes differ. Only used when memory pattern is enabled and all the intermediate tensor shapes are known.
+ORT_API_STATUS(OrtEnableStaticMemoryPlanning, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableStaticMemoryPlanning, _Inout_ OrtSessionOptions* options);
+
 // Enable the memory arena on CPU
 // Arena may pre-allocate memory for future usage.
 // set this option to false if you don't want it.
 ORT_API_STATUS(OrtEnableCpuMemArena, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtDisableCpuMemArena, _Inout_ OrtSessionOptions* options);
 
+// Enable a per-thread cache of small freed chunks in front of the CPU memory arena.
+// Frees and re-allocations of cached sizes skip the arena lock, which helps when many threads call OrtRun
+// concurrently. Has no effect if the CPU memory arena is disabled.
+ORT_API_STATUS(OrtEnableCpuMemArenaThreadCache, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableCpuMemArenaThreadCache, _Inout_ OrtSessionOptions* options);
+
+// Back the large regions of the CPU memory arena, and the initializers placed in them, with huge pages where the
+// platform has them (transparent or reserved huge pages on Linux, large pages on Windows), to save TLB misses on
+// large tensors. Falls back to regular pages where they aren't available.
+ORT_API_STATUS(OrtEnableCpuMemArenaHugePages, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableCpuMemArenaHugePages, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Create the settings for a memory arena.
+ * \param max_mem The most memory the arena may hold. 0 means no limit.
+ * \param arena_extend_strategy How the arena grows: 0 doubles the size of each new region until the request fits,
+ *   1 allocates regions of the requested size (but at least initial_chunk_size_bytes). -1 uses the default (0).
+ * \param initial_chunk_size_bytes The size of the first region the arena allocates. 0 uses the default (1MB).
+ * \return A pointer to the newly created object. The pointer should be freed by OrtReleaseArenaCfg after use
+ */
+ORT_API_STATUS(OrtCreateArenaCfg, size_t max_mem, int arena_extend_strategy, size_t initial_chunk_size_bytes,
+               _Outptr_ OrtArenaCfg** out);
+
+/**
+ * Cap the memory the memory arenas of all the sessions in the process may take from the device of info, on top of
+ * the max_mem of each arena. An allocation the cap refuses fails as if the device were out of memory: the arena first
+ * gives back its unused regions, and a Run that still runs out of memory releases the memory its session caches
+ * between Runs and retries once before failing with ORT_OUT_OF_MEMORY.
+ * \param limit The most memory in bytes. 0 removes the cap.
+ */
+ORT_API_STATUS(OrtSetProcessArenaMemoryLimit, _In_ const OrtMemoryInfo* info, size_t limit);
+
+// Use the given settings for the memory arena on CPU. The settings are copied.
+ORT_API_STATUS(OrtSetCpuMemArenaCfg, _Inout_ OrtSessionOptions* options, _In_ const OrtArenaCfg* arena_cfg);
+
+// Make sessions created with these options use the allocators registered with the OrtEnv
+// (see OrtCreateAndRegisterAllocator) in place of the ones their execution providers create.
+ORT_API_STATUS(OrtEnableEnvAllocators, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableEnvAllocators, _Inout_ OrtSessionOptions* options);
+
+// Give memory regions of the arenas that hold no in-use allocations back to the devices
+// whenever the last in-progress OrtRun call of the session finishes. See OrtSessionShrinkArenas.
+ORT_API_STATUS(OrtEnableMemArenaShrinkAfterRun, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableMemArenaShrinkAfterRun, _Inout_ OrtSessionOptions* options);
+
+// Let the kernels that support several implementations, such as Conv on CPU, benchmark them when the session is
+// initialized and use the fastest one for the input shapes of the model. Kernels only benchmark the shapes missing
+// from the kernel tuning cache.
+ORT_API_STATUS(OrtEnableKernelTuning, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableKernelTuning, _Inout_ OrtSessionOptions* options);
+
+// Set the file the kernel tuning cache is loaded from when the session is initialized. If kernel tuning is enabled,
+// the cache is saved to the file after the kernels are created, so later sessions skip the benchmarks.
+ORT_API_STATUS(OrtSetKernelTuningCacheFilePath, _Inout_ OrtSessionOptions* options,
+               _In_ const ORTCHAR_T* kernel_tuning_cache_filepath);
+
+// Move the groups of connected nodes left on the CPU between the nodes of a device execution provider, such as CUDA,
+// to the device, and the groups assigned to the device to the CPU, where their compute and the copies of their
+// inputs and outputs between the host and the device are estimated to cost less.
+// Only groups whose shapes are known when the session is initialized are considered.
+ORT_API_STATUS(OrtEnableCostBasedPartitioning, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableCostBasedPartitioning, _Inout_ OrtSessionOptions* options);
+
+// Set the estimates of the cost based partitioning, in units of the time the CPU takes to compute an element:
+// how many times faster the device computes, and the cost of a copy between the host and the device, a fixed
+// latency plus a cost per byte. Defaults to 10, 10000 and 0.1.
+ORT_API_STATUS(OrtSetCostBasedPartitioningFactors, _Inout_ OrtSessionOptions* options, double device_speedup,
+               double copy_latency, double copy_cost_per_byte);
+
+// Capture the device work of a Run into a graph, such as a CUDA graph, and replay it for the later Runs with inputs
+// of the same shapes. Only applies with sequential execution to models whose nodes are all assigned to one execution
+// provider that supports it, without copies to or from the host inside the model.
+ORT_API_STATUS(OrtEnableGraphCapture, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableGraphCapture, _Inout_ OrtSessionOptions* options);
+
+// Compute the float nodes assigned to the CUDA execution provider in float16 where it has kernels for them, with
+// casts inserted between float and float16 values. Reductions and Softmax are kept in float.
+ORT_API_STATUS(OrtEnableFloat16Compute, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableFloat16Compute, _Inout_ OrtSessionOptions* options);
+
+// Remove the ZipMap nodes producing outputs of the model, so those outputs are the float tensors of the class
+// probabilities, one row per sample and one column per class label in the order of the ZipMap attributes.
+ORT_API_STATUS(OrtEnableZipMapElimination, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableZipMapElimination, _Inout_ OrtSessionOptions* options);
+
+// Create the kernels and load the initializers of the subgraphs of control flow nodes, such as the branches of If,
+// when they first run instead of when the session is initialized. Subgraphs that never run cost no memory.
+ORT_API_STATUS(OrtEnableLazySubgraphInitialization, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableLazySubgraphInitialization, _Inout_ OrtSessionOptions* options);
+
 // < logger id to use for session output
 ORT_API_STATUS(OrtSetSessionLogId, _Inout_ OrtSessionOptions* options, const char* logid);
 
@@ -255,6 +509,60 @@ ORT_API_STATUS(OrtSetSessionGraphOptimizationLevel, _Inout_ OrtSessionOptions* o
  */
 ORT_API_STATUS(OrtSetSessionThreadPoolSize, _Inout_ OrtSessionOptions* options, int session_thread_pool_size);
 
+// Make sessions created with these options run on the thread pools of the OrtEnv
+// (see OrtCreateEnvWithGlobalThreadPools) instead of creating their own. OrtSetSessionThreadPoolSize is ignored.
+ORT_API_STATUS(OrtDisablePerSessionThreads, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Make the session thread pool split the parallel loops of the kernels into one block per thread, and keep its
+ * threads polling for the next loop instead of parking, which saves their wake-up when an inference takes less
+ * than a millisecond. The polling keeps the processors busy.
+ * \param spin_duration_us How long the threads poll after their last loop before they park.
+ */
+ORT_API_STATUS(OrtEnableLowLatencyThreading, _Inout_ OrtSessionOptions* options, int spin_duration_us);
+ORT_API_STATUS(OrtDisableLowLatencyThreading, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Create num_replicas session thread pools of OrtSetSessionThreadPoolSize threads each, and run every Run on the
+ * one with the fewest Runs in progress. Concurrent Runs then share the weights of the session, each on its own
+ * threads.
+ * \param replica_affinities Can be null. Otherwise num_replicas * num_processors_per_replica logical processors,
+ *                           the threads of replica i are pinned to the num_processors_per_replica processors
+ *                           starting at replica_affinities[i * num_processors_per_replica].
+ */
+/**
+ * Use val instead of deserializing the initializer of the model with the given name, so that the sessions of the
+ * same model created with the same values share their weights. val must be a tensor of the element type and shape
+ * of the initializer, in CPU memory for the CPU execution provider. It isn't copied: it must outlive the options
+ * and the sessions created with them.
+ */
+ORT_API_STATUS(OrtAddInitializer, _Inout_ OrtSessionOptions* options, _In_ const char* name,
+               _In_ const OrtValue* val);
+
+ORT_API_STATUS(OrtSetSessionThreadPoolReplicas, _Inout_ OrtSessionOptions* options, int num_replicas,
+               _In_opt_ const int* replica_affinities, size_t num_processors_per_replica);
+
+// On a machine of several NUMA nodes, create a session thread pool replica per node pinned to its processors, in
+// place of the ones set by OrtSetSessionThreadPoolReplicas, and keep the memory of the CPU arena of each node apart,
+// so each OrtRun computes on the threads of one node over the memory of that node. No effect on a single node.
+ORT_API_STATUS(OrtEnableNuma, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableNuma, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Run models whose initializers don't fit in the memory of the device: the initializers the CUDA kernels read are
+ * kept in pinned host memory, and copied into a device buffer of buffer_size bytes while the nodes before the ones
+ * reading them compute. The buffer must hold the initializers of every node. 0, the default, disables it.
+ * Used with sequential execution. The OrtRun calls of the session take turns, as they share the buffer.
+ */
+ORT_API_STATUS(OrtSetWeightStreamingBufferSize, _Inout_ OrtSessionOptions* options, size_t buffer_size);
+
+/**
+ * Reuse the feeds/fetches mapping and the execution frame of a Run for the next Runs with the same input and
+ * output names. Only used with sequential execution in sessions with CPU execution providers only.
+ */
+ORT_API_STATUS(OrtEnableRunStateCache, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableRunStateCache, _Inout_ OrtSessionOptions* options);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -269,6 +577,32 @@ ORT_API_STATUS(OrtSetSessionThreadPoolSize, _Inout_ OrtSessionOptions* options,
 ORT_API_STATUS(OrtSessionGetInputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 ORT_API_STATUS(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 
+/**
+ * Give memory regions of the arenas used by the session that hold no in-use allocations back to the devices.
+ * Can be called at any time, including concurrently with OrtRun, e.g. from a timer in a long-running server.
+ */
+ORT_API_STATUS(OrtSessionShrinkArenas, _Inout_ OrtSession* sess);
+
+/**
+ * Run the session once on synthetic inputs, so the arenas, the memory patterns and the caches of the kernels, such as
+ * the algorithm searches and compilations done for new shapes, are populated before the session serves real traffic.
+ * Call it once per shape profile after creating the session. The inputs not named take their shape from the model,
+ * which must then be fully known. The inputs are filled with zeros, or empty strings.
+ * \param input_names, input_shapes, input_shape_lengths the names of input_count inputs, and their shapes
+ */
+ORT_API_STATUS(OrtSessionWarmup, _Inout_ OrtSession* sess, _In_ const char* const* input_names,
+               _In_ const int64_t* const* input_shapes, _In_ const size_t* input_shape_lengths, size_t input_count);
+
+/**
+ * The time taken by each phase of loading and initializing the session, such as every graph transformer, the
+ * GetCapability and Compile calls of every execution provider and the loading of the initializers, whether profiling
+ * is enabled or not. The phases are also in the profile when it is.
+ * \param out is set to a null terminated JSON array of events in the chrome tracing format, timed in microseconds from
+ * the creation of the session, allocated using 'allocator'. The caller is responsible in freeing it.
+ */
+ORT_API_STATUS(OrtSessionGetInitializationTimings, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+               _Outptr_ char** out);
+
 /**
  * \param out  should be freed by OrtReleaseTypeInfo after use
  */
@@ -306,6 +640,17 @@ ORT_API_STATUS(OrtRunOptionsSetTerminate, _Inout_ OrtRunOptions* options);
 // Unset the terminate flag to enable this OrtRunOptions instance being used in new OrtRun calls.
 ORT_API_STATUS(OrtRunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options);
 
+// Set the stream of the application, such as a cudaStream_t, that the Run is ordered with. The Run starts after
+// the work submitted to the stream before it, and the work submitted to the stream after the Run waits for it,
+// without blocking the host. It overrides the stream given to the execution provider.
+ORT_API_STATUS(OrtRunOptionsSetComputeStream, _Inout_ OrtRunOptions* options, _In_opt_ void* compute_stream);
+
+// Split the Runs whose inputs share a first (batch) dimension larger than max_micro_batch_size, which the model
+// leaves unspecified, into micro-batches of at most max_micro_batch_size rows that run one after another, to bound
+// the peak memory of large batches. The outputs hold the rows of all the micro-batches. Only valid for models whose
+// rows are computed independently. 0 disables the splitting.
+ORT_API_STATUS(OrtRunOptionsSetMaxMicroBatchSize, _Inout_ OrtRunOptions* options, int64_t max_micro_batch_size);
+
 /**
  * Create a tensor from an allocator. OrtReleaseValue will also release the buffer inside the output value
  * \param out Should be freed by calling OrtReleaseValue
@@ -454,6 +799,14 @@ ORT_API_STATUS(OrtAllocatorGetInfo, _In_ const OrtAllocator* ptr, _Out_ const Or
 ORT_API_STATUS(OrtGetAllocatorWithDefaultOptions, _Outptr_ OrtAllocator** out);
 
 ORT_API(const char*, OrtGetVersionString);
+
+/**
+ * The metrics of the process in the Prometheus text format: the arenas, the thread pools, the caches and the
+ * sessions created with OrtEnableMetrics.
+ * \param out is set to a null terminated string allocated using 'allocator'. The caller is responsible in freeing it.
+ */
+ORT_API_STATUS(OrtGetMetrics, _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
 /**
  * \param msg A null-terminated string. Its content will be copied into the newly created OrtStatus
  */
@@ -592,6 +945,19 @@ struct OrtCustomOpApi {
   OrtStatus*(ORT_API_CALL* KernelContext_GetInput)(_In_ const OrtKernelContext* context, _In_ size_t index, _Out_ const OrtValue** out);
   OrtStatus*(ORT_API_CALL* KernelContext_GetOutputCount)(_In_ const OrtKernelContext* context, _Out_ size_t* out);
   OrtStatus*(ORT_API_CALL* KernelContext_GetOutput)(_Inout_ OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count, _Outptr_ OrtValue** out);
+
+  /*
+   * These let a kernel run on the intra op thread pool of the session and allocate its scratch memory from the
+   * allocator the built-in kernels of its execution provider use for it.
+  */
+  // The number of threads fn may run on at once, including the calling thread.
+  OrtStatus*(ORT_API_CALL* KernelContext_GetThreadCount)(_In_ const OrtKernelContext* context, _Out_ size_t* out);
+  // Calls fn for each index of [0, total) on the thread pool and returns when all the calls are done. A kernel
+  // splits its work into about as many blocks as there are threads.
+  OrtStatus*(ORT_API_CALL* KernelContext_ParallelFor)(_In_ OrtKernelContext* context, _In_ void(ORT_API_CALL* fn)(_In_ void* user_data, _In_ size_t index), _In_ size_t total, _In_ void* user_data);
+  // The memory must be released with KernelContext_FreeTemp before Compute returns.
+  OrtStatus*(ORT_API_CALL* KernelContext_AllocateTemp)(_In_ OrtKernelContext* context, _In_ size_t size, _Outptr_ void** out);
+  OrtStatus*(ORT_API_CALL* KernelContext_FreeTemp)(_In_ OrtKernelContext* context, _In_ void* p);
 };
 typedef struct OrtCustomOpApi OrtCustomOpApi;
 
@@ -43,7 +43,10 @@ struct Exception : std::exception {
 #define ORT_DEFINE_RELEASE(NAME) \
   inline void OrtRelease(Ort##NAME* ptr) { OrtRelease##NAME(ptr); }
 
+ORT_DEFINE_RELEASE(ArenaCfg);
+ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(MemoryInfo);
+ORT_DEFINE_RELEASE(PreparedRun);
 ORT_DEFINE_RELEASE(CustomOpDomain);
 ORT_DEFINE_RELEASE(Env);
 ORT_DEFINE_RELEASE(RunOptions);
@@ -98,13 +101,36 @@ struct Env;
 struct TypeInfo;
 struct Value;
 
+struct ThreadingOptions : Base<OrtThreadingOptions> {
+  explicit ThreadingOptions(nullptr_t) {}
+  ThreadingOptions();
+
+  ThreadingOptions& SetGlobalIntraOpNumThreads(int intra_op_num_threads);
+  ThreadingOptions& SetGlobalInterOpNumThreads(int inter_op_num_threads);
+  ThreadingOptions& SetGlobalIntraOpThreadAffinity(const int* logical_processors, size_t num_processors);
+  ThreadingOptions& SetGlobalInterOpThreadAffinity(const int* logical_processors, size_t num_processors);
+};
+
 struct Env : Base<OrtEnv> {
   Env(nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level, _In_ const char* logid);
+  Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_logging_level, _In_ const char* logid);
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
+
+  // An environment writing its log messages from a thread of its own, see OrtCreateEnvWithAsyncLogger
+  static Env WithAsyncLogger(OrtLoggingLevel default_logging_level, const char* logid,
+                             OrtLoggingFunction logging_function = nullptr, void* logger_param = nullptr);
+
+  Env& CreateAndRegisterAllocator(const OrtMemoryInfo* mem_info, const OrtArenaCfg* arena_cfg);
 };
 
+// The metrics of the process in the Prometheus text format, see OrtGetMetrics
+std::string GetMetrics();
+
+// Cap the memory the arenas of the process take from the device of mem_info, see OrtSetProcessArenaMemoryLimit
+void SetProcessArenaMemoryLimit(const OrtMemoryInfo* mem_info, size_t limit);
+
 struct CustomOpDomain : Base<OrtCustomOpDomain> {
   explicit CustomOpDomain(nullptr_t) {}
   explicit CustomOpDomain(const char* domain);
@@ -129,6 +155,17 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // order the Run with a stream of the application, such as a cudaStream_t
+  RunOptions& SetComputeStream(void* compute_stream);
+
+  // split large batches into micro-batches of at most max_micro_batch_size rows, see OrtRunOptionsSetMaxMicroBatchSize
+  RunOptions& SetMaxMicroBatchSize(int64_t max_micro_batch_size);
+};
+
+struct ArenaCfg : Base<OrtArenaCfg> {
+  explicit ArenaCfg(nullptr_t) {}
+  ArenaCfg(size_t max_mem, int arena_extend_strategy, size_t initial_chunk_size_bytes);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -139,19 +176,75 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions Clone() const;
 
   SessionOptions& SetThreadPoolSize(int session_thread_pool_size);
+  SessionOptions& DisablePerSessionThreads();
+
+  SessionOptions& EnableLowLatencyThreading(int spin_duration_us);
+  SessionOptions& DisableLowLatencyThreading();
+  // value isn't copied, it must outlive the options and the sessions created with them
+  SessionOptions& AddInitializer(const char* name, const Value& value);
+  SessionOptions& SetThreadPoolReplicas(int num_replicas, const int* replica_affinities = nullptr,
+                                        size_t num_processors_per_replica = 0);
+  SessionOptions& EnableNuma();
+  SessionOptions& DisableNuma();
+  SessionOptions& SetWeightStreamingBufferSize(size_t buffer_size);
+  SessionOptions& EnableRunStateCache();
+  SessionOptions& DisableRunStateCache();
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
 
   SessionOptions& EnableCpuMemArena();
   SessionOptions& DisableCpuMemArena();
 
+  SessionOptions& EnableCpuMemArenaThreadCache();
+  SessionOptions& DisableCpuMemArenaThreadCache();
+
+  SessionOptions& EnableCpuMemArenaHugePages();
+  SessionOptions& DisableCpuMemArenaHugePages();
+
+  SessionOptions& SetCpuMemArenaCfg(const ArenaCfg& arena_cfg);
+
+  SessionOptions& EnableEnvAllocators();
+  SessionOptions& DisableEnvAllocators();
+
+  SessionOptions& EnableMemArenaShrinkAfterRun();
+  SessionOptions& DisableMemArenaShrinkAfterRun();
+
+  SessionOptions& EnableKernelTuning();
+  SessionOptions& DisableKernelTuning();
+  SessionOptions& SetKernelTuningCacheFilePath(const ORTCHAR_T* kernel_tuning_cache_file);
+
+  SessionOptions& EnableCostBasedPartitioning();
+  SessionOptions& DisableCostBasedPartitioning();
+  SessionOptions& SetCostBasedPartitioningFactors(double device_speedup, double copy_latency,
+                                                  double copy_cost_per_byte);
+
+  SessionOptions& EnableGraphCapture();
+  SessionOptions& DisableGraphCapture();
+
+  SessionOptions& EnableFloat16Compute();
+  SessionOptions& DisableFloat16Compute();
+
+  SessionOptions& EnableZipMapElimination();
+  SessionOptions& DisableZipMapElimination();
+
+  SessionOptions& EnableLazySubgraphInitialization();
+  SessionOptions& DisableLazySubgraphInitialization();
+
   SessionOptions& SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_file);
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
   SessionOptions& DisableProfiling();
+  SessionOptions& SetProfilingSamplingInterval(int sampling_interval);
+  SessionOptions& EnableProfilingHardwareCounters();
+  SessionOptions& DisableProfilingHardwareCounters();
+  SessionOptions& EnableMetrics();
+  SessionOptions& DisableMetrics();
 
   SessionOptions& EnableMemPattern();
   SessionOptions& DisableMemPattern();
 
+  SessionOptions& EnableStaticMemoryPlanning();
+  SessionOptions& DisableStaticMemoryPlanning();
+
   SessionOptions& EnableSequentialExecution();
   SessionOptions& DisableSequentialExecution();
 
@@ -160,6 +253,12 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions& Add(OrtCustomOpDomain* custom_op_domain);
 };
 
+// Created by Session::PrepareRun, and must be released before the Session
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(nullptr_t) {}
+  explicit PreparedRun(OrtPreparedRun* p) : Base<OrtPreparedRun>{p} {}
+};
+
 struct Session : Base<OrtSession> {
   explicit Session(nullptr_t) {}
   Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options);
@@ -172,9 +271,36 @@ struct Session : Base<OrtSession> {
   void Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
 
+  // Run that returns once scheduled, and calls callback when done. See OrtRunAsync.
+  // run_options and output_values must stay valid until then.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count,
+                OrtRunAsyncCallbackFn callback, void* user_data);
+
+  // Run that writes the outputs that are null in output_values into the buffers of allocator.
+  // See OrtRunWithOutputAllocator.
+  void Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+           const char* const* output_names, Value* output_values, size_t output_count,
+           OrtOutputAllocatorFn allocator, void* user_data);
+
+  PreparedRun PrepareRun(const char* const* input_names, size_t input_count,
+                         const char* const* output_names, size_t output_count);
+  // Run with the input and output names of prepared_run
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
 
+  void ShrinkArenas();
+
+  // see OrtSessionWarmup
+  void Warmup(const char* const* input_names, const int64_t* const* input_shapes, const size_t* input_shape_lengths,
+              size_t input_count);
+
+  // see OrtSessionGetInitializationTimings
+  char* GetInitializationTimings(OrtAllocator* allocator) const;
+
   char* GetInputName(size_t index, OrtAllocator* allocator) const;
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
 
@@ -289,6 +415,11 @@ struct CustomOpApi {
   const OrtValue* KernelContext_GetInput(const OrtKernelContext* context, _In_ size_t index);
   size_t KernelContext_GetOutputCount(const OrtKernelContext* context);
   OrtValue* KernelContext_GetOutput(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
+  size_t KernelContext_GetThreadCount(const OrtKernelContext* context);
+  template <typename TFunc>
+  void KernelContext_ParallelFor(OrtKernelContext* context, size_t total, TFunc&& fn);
+  void* KernelContext_AllocateTemp(OrtKernelContext* context, size_t size);
+  void KernelContext_FreeTemp(OrtKernelContext* context, void* p);
 
  private:
   const OrtCustomOpApi& api_;
@@ -73,10 +73,65 @@ inline Env::Env(OrtLoggingLevel default_warning_level, _In_ const char* logid) {
   ORT_THROW_ON_ERROR(OrtCreateEnv(default_warning_level, logid, &p_));
 }
 
+inline ThreadingOptions::ThreadingOptions() {
+  ORT_THROW_ON_ERROR(OrtCreateThreadingOptions(&p_));
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpNumThreads(int intra_op_num_threads) {
+  ORT_THROW_ON_ERROR(OrtSetGlobalIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpNumThreads(int inter_op_num_threads) {
+  ORT_THROW_ON_ERROR(OrtSetGlobalInterOpNumThreads(p_, inter_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpThreadAffinity(const int* logical_processors,
+                                                                          size_t num_processors) {
+  ORT_THROW_ON_ERROR(OrtSetGlobalIntraOpThreadAffinity(p_, logical_processors, num_processors));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpThreadAffinity(const int* logical_processors,
+                                                                          size_t num_processors) {
+  ORT_THROW_ON_ERROR(OrtSetGlobalInterOpThreadAffinity(p_, logical_processors, num_processors));
+  return *this;
+}
+
+inline Env::Env(const ThreadingOptions& tp_options, OrtLoggingLevel default_warning_level, _In_ const char* logid) {
+  ORT_THROW_ON_ERROR(OrtCreateEnvWithGlobalThreadPools(default_warning_level, logid, tp_options, &p_));
+}
+
 inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param) {
   ORT_THROW_ON_ERROR(OrtCreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
 
+inline Env Env::WithAsyncLogger(OrtLoggingLevel default_warning_level, const char* logid,
+                                OrtLoggingFunction logging_function, void* logger_param) {
+  OrtEnv* p;
+  ORT_THROW_ON_ERROR(OrtCreateEnvWithAsyncLogger(logging_function, logger_param, default_warning_level, logid, &p));
+  return Env{p};
+}
+
+inline Env& Env::CreateAndRegisterAllocator(const OrtMemoryInfo* mem_info, const OrtArenaCfg* arena_cfg) {
+  ORT_THROW_ON_ERROR(OrtCreateAndRegisterAllocator(p_, mem_info, arena_cfg));
+  return *this;
+}
+
+inline void SetProcessArenaMemoryLimit(const OrtMemoryInfo* mem_info, size_t limit) {
+  ORT_THROW_ON_ERROR(OrtSetProcessArenaMemoryLimit(mem_info, limit));
+}
+
+inline std::string GetMetrics() {
+  AllocatorWithDefaultOptions allocator;
+  char* out;
+  ORT_THROW_ON_ERROR(OrtGetMetrics(allocator, &out));
+  std::string metrics{out};
+  allocator.Free(out);
+  return metrics;
+}
+
 inline CustomOpDomain::CustomOpDomain(const char* domain) {
   ORT_THROW_ON_ERROR(OrtCreateCustomOpDomain(domain, &p_));
 }
@@ -85,6 +140,10 @@ inline void CustomOpDomain::Add(OrtCustomOp* op) {
   ORT_THROW_ON_ERROR(OrtCustomOpDomain_Add(p_, op));
 }
 
+inline ArenaCfg::ArenaCfg(size_t max_mem, int arena_extend_strategy, size_t initial_chunk_size_bytes) {
+  ORT_THROW_ON_ERROR(OrtCreateArenaCfg(max_mem, arena_extend_strategy, initial_chunk_size_bytes, &p_));
+}
+
 inline RunOptions::RunOptions() {
   ORT_THROW_ON_ERROR(OrtCreateRunOptions(&p_));
 }
@@ -126,6 +185,16 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetComputeStream(void* compute_stream) {
+  ORT_THROW_ON_ERROR(OrtRunOptionsSetComputeStream(p_, compute_stream));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetMaxMicroBatchSize(int64_t max_micro_batch_size) {
+  ORT_THROW_ON_ERROR(OrtRunOptionsSetMaxMicroBatchSize(p_, max_micro_batch_size));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ORT_THROW_ON_ERROR(OrtCreateSessionOptions(&p_));
 }
@@ -141,6 +210,58 @@ inline SessionOptions& SessionOptions::SetThreadPoolSize(int session_thread_pool
   return *this;
 }
 
+inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
+  ORT_THROW_ON_ERROR(OrtDisablePerSessionThreads(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableLowLatencyThreading(int spin_duration_us) {
+  ORT_THROW_ON_ERROR(OrtEnableLowLatencyThreading(p_, spin_duration_us));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableLowLatencyThreading() {
+  ORT_THROW_ON_ERROR(OrtDisableLowLatencyThreading(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::AddInitializer(const char* name, const Value& value) {
+  ORT_THROW_ON_ERROR(OrtAddInitializer(p_, name, value));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetThreadPoolReplicas(int num_replicas, const int* replica_affinities,
+                                                             size_t num_processors_per_replica) {
+  ORT_THROW_ON_ERROR(OrtSetSessionThreadPoolReplicas(p_, num_replicas, replica_affinities,
+                                                     num_processors_per_replica));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableNuma() {
+  ORT_THROW_ON_ERROR(OrtEnableNuma(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableNuma() {
+  ORT_THROW_ON_ERROR(OrtDisableNuma(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetWeightStreamingBufferSize(size_t buffer_size) {
+  ORT_THROW_ON_ERROR(OrtSetWeightStreamingBufferSize(p_, buffer_size));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableRunStateCache() {
+  ORT_THROW_ON_ERROR(OrtEnableRunStateCache(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableRunStateCache() {
+  ORT_THROW_ON_ERROR(OrtDisableRunStateCache(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level) {
   ORT_THROW_ON_ERROR(OrtSetSessionGraphOptimizationLevel(p_, graph_optimization_level));
   return *this;
@@ -161,6 +282,31 @@ inline SessionOptions& SessionOptions::DisableProfiling() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetProfilingSamplingInterval(int sampling_interval) {
+  ORT_THROW_ON_ERROR(OrtSetProfilingSamplingInterval(p_, sampling_interval));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableProfilingHardwareCounters() {
+  ORT_THROW_ON_ERROR(OrtEnableProfilingHardwareCounters(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableProfilingHardwareCounters() {
+  ORT_THROW_ON_ERROR(OrtDisableProfilingHardwareCounters(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableMetrics() {
+  ORT_THROW_ON_ERROR(OrtEnableMetrics(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableMetrics() {
+  ORT_THROW_ON_ERROR(OrtDisableMetrics(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableMemPattern() {
   ORT_THROW_ON_ERROR(OrtEnableMemPattern(p_));
   return *this;
@@ -171,6 +317,16 @@ inline SessionOptions& SessionOptions::DisableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableStaticMemoryPlanning() {
+  ORT_THROW_ON_ERROR(OrtEnableStaticMemoryPlanning(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableStaticMemoryPlanning() {
+  ORT_THROW_ON_ERROR(OrtDisableStaticMemoryPlanning(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableCpuMemArena() {
   ORT_THROW_ON_ERROR(OrtEnableCpuMemArena(p_));
   return *this;
@@ -181,6 +337,122 @@ inline SessionOptions& SessionOptions::DisableCpuMemArena() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableCpuMemArenaThreadCache() {
+  ORT_THROW_ON_ERROR(OrtEnableCpuMemArenaThreadCache(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCpuMemArenaThreadCache() {
+  ORT_THROW_ON_ERROR(OrtDisableCpuMemArenaThreadCache(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableCpuMemArenaHugePages() {
+  ORT_THROW_ON_ERROR(OrtEnableCpuMemArenaHugePages(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCpuMemArenaHugePages() {
+  ORT_THROW_ON_ERROR(OrtDisableCpuMemArenaHugePages(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetCpuMemArenaCfg(const ArenaCfg& arena_cfg) {
+  ORT_THROW_ON_ERROR(OrtSetCpuMemArenaCfg(p_, arena_cfg));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableEnvAllocators() {
+  ORT_THROW_ON_ERROR(OrtEnableEnvAllocators(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableEnvAllocators() {
+  ORT_THROW_ON_ERROR(OrtDisableEnvAllocators(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableMemArenaShrinkAfterRun() {
+  ORT_THROW_ON_ERROR(OrtEnableMemArenaShrinkAfterRun(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableMemArenaShrinkAfterRun() {
+  ORT_THROW_ON_ERROR(OrtDisableMemArenaShrinkAfterRun(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableKernelTuning() {
+  ORT_THROW_ON_ERROR(OrtEnableKernelTuning(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableKernelTuning() {
+  ORT_THROW_ON_ERROR(OrtDisableKernelTuning(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetKernelTuningCacheFilePath(const ORTCHAR_T* kernel_tuning_cache_filepath) {
+  ORT_THROW_ON_ERROR(OrtSetKernelTuningCacheFilePath(p_, kernel_tuning_cache_filepath));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableCostBasedPartitioning() {
+  ORT_THROW_ON_ERROR(OrtEnableCostBasedPartitioning(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCostBasedPartitioning() {
+  ORT_THROW_ON_ERROR(OrtDisableCostBasedPartitioning(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetCostBasedPartitioningFactors(double device_speedup, double copy_latency,
+                                                                       double copy_cost_per_byte) {
+  ORT_THROW_ON_ERROR(OrtSetCostBasedPartitioningFactors(p_, device_speedup, copy_latency, copy_cost_per_byte));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableGraphCapture() {
+  ORT_THROW_ON_ERROR(OrtEnableGraphCapture(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableGraphCapture() {
+  ORT_THROW_ON_ERROR(OrtDisableGraphCapture(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableFloat16Compute() {
+  ORT_THROW_ON_ERROR(OrtEnableFloat16Compute(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableFloat16Compute() {
+  ORT_THROW_ON_ERROR(OrtDisableFloat16Compute(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableZipMapElimination() {
+  ORT_THROW_ON_ERROR(OrtEnableZipMapElimination(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableZipMapElimination() {
+  ORT_THROW_ON_ERROR(OrtDisableZipMapElimination(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableLazySubgraphInitialization() {
+  ORT_THROW_ON_ERROR(OrtEnableLazySubgraphInitialization(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableLazySubgraphInitialization() {
+  ORT_THROW_ON_ERROR(OrtDisableLazySubgraphInitialization(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableSequentialExecution() {
   ORT_THROW_ON_ERROR(OrtEnableSequentialExecution(p_));
   return *this;
@@ -225,12 +497,62 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ORT_THROW_ON_ERROR(OrtRun(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+                              const char* const* output_names, Value* output_values, size_t output_count,
+                              OrtRunAsyncCallbackFn callback, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ORT_THROW_ON_ERROR(OrtRunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                                 ort_output_values, callback, user_data));
+}
+
+inline void Session::Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+                         const char* const* output_names, Value* output_values, size_t output_count,
+                         OrtOutputAllocatorFn allocator, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ORT_THROW_ON_ERROR(OrtRunWithOutputAllocator(p_, run_options, input_names, ort_input_values, input_count, output_names,
+                                               output_count, allocator, user_data, ort_output_values));
+}
+
+inline PreparedRun Session::PrepareRun(const char* const* input_names, size_t input_count,
+                                       const char* const* output_names, size_t output_count) {
+  OrtPreparedRun* out;
+  ORT_THROW_ON_ERROR(OrtPrepareRun(p_, input_names, input_count, output_names, output_count, &out));
+  return PreparedRun{out};
+}
+
+inline void Session::Run(const RunOptions& run_options, PreparedRun& prepared_run, Value* input_values, size_t input_count,
+                         Value* output_values, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ORT_THROW_ON_ERROR(OrtRunPrepared(p_, run_options, prepared_run, ort_input_values, input_count, output_count, ort_output_values));
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ORT_THROW_ON_ERROR(OrtSessionGetInputCount(p_, &out));
   return out;
 }
 
+inline void Session::ShrinkArenas() {
+  ORT_THROW_ON_ERROR(OrtSessionShrinkArenas(p_));
+}
+
+inline void Session::Warmup(const char* const* input_names, const int64_t* const* input_shapes,
+                            const size_t* input_shape_lengths, size_t input_count) {
+  ORT_THROW_ON_ERROR(OrtSessionWarmup(p_, input_names, input_shapes, input_shape_lengths, input_count));
+}
+
+inline char* Session::GetInitializationTimings(OrtAllocator* allocator) const {
+  char* out;
+  ORT_THROW_ON_ERROR(OrtSessionGetInitializationTimings(p_, allocator, &out));
+  return out;
+}
+
 inline size_t Session::GetOutputCount() const {
   size_t out;
   ORT_THROW_ON_ERROR(OrtSessionGetOutputCount(p_, &out));
@@ -515,4 +837,28 @@ inline OrtValue* CustomOpApi::KernelContext_GetOutput(OrtKernelContext* context,
   return out;
 }
 
+inline size_t CustomOpApi::KernelContext_GetThreadCount(const OrtKernelContext* context) {
+  size_t out;
+  ORT_THROW_ON_ERROR(api_.KernelContext_GetThreadCount(context, &out));
+  return out;
+}
+
+template <typename TFunc>
+inline void CustomOpApi::KernelContext_ParallelFor(OrtKernelContext* context, size_t total, TFunc&& fn) {
+  using Func = typename std::decay<TFunc>::type;
+  ORT_THROW_ON_ERROR(api_.KernelContext_ParallelFor(
+      context, [](void* user_data, size_t index) { (*static_cast<Func*>(user_data))(index); },
+      total, const_cast<Func*>(&fn)));
+}
+
+inline void* CustomOpApi::KernelContext_AllocateTemp(OrtKernelContext* context, size_t size) {
+  void* out;
+  ORT_THROW_ON_ERROR(api_.KernelContext_AllocateTemp(context, size, &out));
+  return out;
+}
+
+inline void CustomOpApi::KernelContext_FreeTemp(OrtKernelContext* context, void* p) {
+  ORT_THROW_ON_ERROR(api_.KernelContext_FreeTemp(context, p));
+}
+
 }  // namespace Ort
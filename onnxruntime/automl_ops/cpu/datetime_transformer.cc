@@ -1,9 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 #include "core/automl/featurizers/src/FeaturizerPrep/Featurizers/DateTimeFeaturizer.h"
 
@@ -38,5 +43,71 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>())
         .TypeConstraint("T2", DataTypeImpl::GetType<Microsoft::Featurizer::DateTimeFeaturizer::TimePoint>()),
     DateTimeTransformer);
+
+// Splits every timestamp of a tensor into one output tensor per component of TimePoint, in parallel chunks.
+class DateTimeBatchTransformer final : public OpKernel {
+ public:
+  explicit DateTimeBatchTransformer(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+// the timestamps converted by a task
+constexpr int64_t kDateTimeBatchChunkSize = 16384;
+
+Status DateTimeBatchTransformer::Compute(OpKernelContext* ctx) const {
+  const Tensor* input_tensor = ctx->Input<Tensor>(0);
+  const TensorShape& shape = input_tensor->Shape();
+  const int64_t count = shape.Size();
+
+  dtf::TimePointColumns columns;
+  columns.year = ctx->Output(0, shape)->MutableData<int32_t>();
+  columns.month = ctx->Output(1, shape)->MutableData<uint8_t>();
+  columns.day = ctx->Output(2, shape)->MutableData<uint8_t>();
+  columns.hour = ctx->Output(3, shape)->MutableData<uint8_t>();
+  columns.minute = ctx->Output(4, shape)->MutableData<uint8_t>();
+  columns.second = ctx->Output(5, shape)->MutableData<uint8_t>();
+  columns.dayOfWeek = ctx->Output(6, shape)->MutableData<uint8_t>();
+  columns.dayOfYear = ctx->Output(7, shape)->MutableData<uint16_t>();
+  columns.quarterOfYear = ctx->Output(8, shape)->MutableData<uint8_t>();
+  columns.weekOfMonth = ctx->Output(9, shape)->MutableData<uint8_t>();
+
+  const int64_t* seconds = input_tensor->Data<int64_t>();
+  const int64_t num_chunks = (count + kDateTimeBatchChunkSize - 1) / kDateTimeBatchChunkSize;
+
+  // the featurizer throws on dates out of range, which must not escape the threads of the pool
+  std::vector<Status> chunk_status(static_cast<size_t>(num_chunks));
+  auto transform_chunk = [&](int32_t chunk) {
+    const int64_t begin = chunk * kDateTimeBatchChunkSize;
+    const int64_t end = std::min(begin + kDateTimeBatchChunkSize, count);
+    try {
+      dtf::TransformBatch(seconds + begin, static_cast<size_t>(end - begin), columns, static_cast<size_t>(begin));
+    } catch (const std::exception& ex) {
+      chunk_status[chunk] = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, ex.what());
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr && num_chunks > 1) {
+    tp->ParallelFor(static_cast<int32_t>(num_chunks), transform_chunk);
+  } else {
+    for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+      transform_chunk(static_cast<int32_t>(chunk));
+    }
+  }
+
+  for (const auto& status : chunk_status) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    DateTimeBatchTransformer,
+    kMSAutoMLDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
+    DateTimeBatchTransformer);
 }  // namespace automl
 }  // namespace onnxruntime
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/attention.h"
+#include <cmath>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Attention,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Attention);
+
+AttentionBase::AttentionBase(const OpKernelInfo& info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0,
+              "Attention requires a positive num_heads attribute.");
+  num_heads_ = static_cast<int>(num_heads);
+}
+
+Status AttentionBase::CheckInputs(const Tensor* input, const Tensor* weights, const Tensor* bias,
+                                  const Tensor* mask) const {
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "input is expected to have 3 dimensions, got ",
+                           input->Shape());
+  }
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+  const int64_t hidden_size = dims[2];
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "hidden_size ", hidden_size,
+                           " is not a multiple of num_heads ", num_heads_);
+  }
+
+  const auto& weights_dims = weights->Shape().GetDims();
+  if (weights_dims.size() != 2 || weights_dims[0] != hidden_size || weights_dims[1] != 3 * hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "weight is expected to have shape (", hidden_size, ", ",
+                           3 * hidden_size, "), got ", weights->Shape());
+  }
+
+  const auto& bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1 || bias_dims[0] != 3 * hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "bias is expected to have shape (", 3 * hidden_size,
+                           "), got ", bias->Shape());
+  }
+
+  if (mask != nullptr) {
+    const auto& mask_dims = mask->Shape().GetDims();
+    if (mask_dims.size() != 4 ||
+        (mask_dims[0] != batch_size && mask_dims[0] != 1) ||
+        mask_dims[1] != 1 ||
+        (mask_dims[2] != sequence_length && mask_dims[2] != 1) ||
+        mask_dims[3] != sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "mask is expected to have shape (", batch_size,
+                             " or 1, 1, ", sequence_length, " or 1, ", sequence_length, "), got ", mask->Shape());
+    }
+  }
+
+  return Status::OK();
+}
+
+Status Attention::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask));
+
+  const auto& dims = input->Shape().GetDims();
+  const auto batch_size = static_cast<size_t>(dims[0]);
+  const auto sequence_length = static_cast<size_t>(dims[1]);
+  const auto hidden_size = static_cast<size_t>(dims[2]);
+  const auto num_heads = static_cast<size_t>(num_heads_);
+  const size_t head_size = hidden_size / num_heads;
+
+  Tensor* output = context->Output(0, input->Shape());
+  float* output_data = output->MutableData<float>();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  // Q, K and V of every token side by side: (batch_size * sequence_length, 3 * hidden_size). Each row
+  // starts as the bias so the projection GEMM accumulates onto it.
+  const size_t token_count = batch_size * sequence_length;
+  const size_t qkv_width = 3 * hidden_size;
+  auto qkv = IAllocator::MakeUniquePtr<float>(alloc, token_count * qkv_width);
+  const float* bias_data = bias->Data<float>();
+  for (size_t token = 0; token < token_count; token++) {
+    memcpy(qkv.get() + token * qkv_width, bias_data, qkv_width * sizeof(float));
+  }
+  MlasSgemm(CblasNoTrans, CblasNoTrans, token_count, qkv_width, hidden_size, 1.0f, input->Data<float>(),
+            hidden_size, weights->Data<float>(), qkv_width, 1.0f, qkv.get(), qkv_width, tp);
+
+  // Scores of every head, (batch_size, num_heads, sequence_length, sequence_length). The heads of a
+  // batch are consecutive head_size column blocks of the projection, so they form one strided batch.
+  const size_t score_size = sequence_length * sequence_length;
+  auto scores = IAllocator::MakeUniquePtr<float>(alloc, batch_size * num_heads * score_size);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+  for (size_t b = 0; b < batch_size; b++) {
+    const float* q = qkv.get() + b * sequence_length * qkv_width;
+    const float* k = q + hidden_size;
+    MlasSgemmBatch(CblasNoTrans, CblasTrans, sequence_length, sequence_length, head_size, scale,
+                   q, qkv_width, head_size, k, qkv_width, head_size, 0.0f,
+                   scores.get() + b * num_heads * score_size, sequence_length, score_size, num_heads, tp);
+  }
+
+  if (mask != nullptr) {
+    const auto& mask_dims = mask->Shape().GetDims();
+    const float* mask_data = mask->Data<float>();
+    const size_t mask_batch_stride = mask_dims[0] == 1 ? 0 : static_cast<size_t>(mask_dims[2]) * sequence_length;
+    const size_t mask_row_stride = mask_dims[2] == 1 ? 0 : sequence_length;
+    for (size_t b = 0; b < batch_size; b++) {
+      for (size_t n = 0; n < num_heads; n++) {
+        float* score_row = scores.get() + (b * num_heads + n) * score_size;
+        for (size_t i = 0; i < sequence_length; i++) {
+          const float* mask_row = mask_data + b * mask_batch_stride + i * mask_row_stride;
+          for (size_t j = 0; j < sequence_length; j++) {
+            score_row[j] += mask_row[j];
+          }
+          score_row += sequence_length;
+        }
+      }
+    }
+  }
+
+  MlasComputeSoftmax(scores.get(), scores.get(), batch_size * num_heads * sequence_length, sequence_length, false,
+                     tp);
+
+  // The context of each head is written straight to its column block of the output, which
+  // concatenates the heads back to (batch_size, sequence_length, hidden_size).
+  for (size_t b = 0; b < batch_size; b++) {
+    const float* v = qkv.get() + b * sequence_length * qkv_width + 2 * hidden_size;
+    MlasSgemmBatch(CblasNoTrans, CblasNoTrans, sequence_length, head_size, sequence_length, 1.0f,
+                   scores.get() + b * num_heads * score_size, sequence_length, score_size,
+                   v, qkv_width, head_size, 0.0f,
+                   output_data + b * sequence_length * hidden_size, hidden_size, head_size, num_heads, tp);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attributes and input validation shared by the CPU and CUDA Attention kernels.
+class AttentionBase {
+ protected:
+  explicit AttentionBase(const OpKernelInfo& info);
+
+  Status CheckInputs(const Tensor* input, const Tensor* weights, const Tensor* bias, const Tensor* mask) const;
+
+  int num_heads_;
+};
+
+// Multi-head self-attention. The query, key and value projections of all heads are a single GEMM,
+// and the per-head products are batched GEMMs that read the heads in place from the projection.
+class Attention final : public OpKernel, public AttentionBase {
+ public:
+  explicit Attention(const OpKernelInfo& info) : OpKernel(info), AttentionBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -31,20 +31,15 @@ AttentionWrapper<T>::AttentionWrapper(AllocatorPtr alloc, const logging::Logger&
   alignments_ = Allocate(allocator_, batch_size_ * mem_max_steps, alignments_ptr_, true);
   attn_context_ = Allocate(allocator_, batch_size_ * attn_context_depth, attn_context_ptr_, true);
   attn_states_ = (has_attn_layer_) ? Allocate(allocator_, batch_size_ * attn_layer_depth_, attn_states_ptr_, true) : attn_context_;
+  if (has_attn_layer_) {
+    attn_layer_input_ = Allocate(allocator_, batch_size_ * (inner_cell_hidden_size_ + attn_context_depth_),
+                                 attn_layer_input_ptr_, true);
+  }
 }
 
 // rnn_cell_output is of [batch_size, rnn_cell_hidden_size]
 template <typename T>
 void AttentionWrapper<T>::ProcessOutput(const gsl::span<const T>& rnn_cell_output) {
-  if (has_attn_layer_) {
-    // rnn_cell_output * cell_weights, (part of the attention layer above the attention mechanism).
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    batch_size_, attn_layer_depth_, inner_cell_hidden_size_, T{1.0},
-                    rnn_cell_output.data(), inner_cell_hidden_size_,
-                    attn_layer_cell_weights_.data(), attn_layer_depth_, T{0.0},
-                    attn_states_.data(), attn_layer_depth_, ttp_);
-  }
-
   // Get the context which is calculated within attention mechanism.
   attention_mechanism_.Compute(rnn_cell_output, prev_alignments_, attn_context_, alignments_);
   if (attention_mechanism_.NeedPrevAlignment()) {
@@ -52,13 +47,21 @@ void AttentionWrapper<T>::ProcessOutput(const gsl::span<const T>& rnn_cell_outpu
   }
 
   if (has_attn_layer_) {
-    //concat([p_cell_output, context]) * stack([attn_layer_cell_weights_, attn_layer_attn_weights_]) =
-    //     p_cell_output * attn_layer_cell_weights_ + context * attn_layer_attn_weights_
-    // The first part is calulated above. Here just add the later.
+    // concat([p_cell_output, context]) * stack([attn_layer_cell_weights, attn_layer_attn_weights]) in a single
+    // GEMM, instead of one for each part accumulated into attn_states_.
+    const int input_depth = inner_cell_hidden_size_ + attn_context_depth_;
+    for (int b = 0; b < batch_size_; b++) {
+      auto cell_output = rnn_cell_output.subspan(b * inner_cell_hidden_size_, inner_cell_hidden_size_);
+      auto context = attn_context_.subspan(b * attn_context_depth_, attn_context_depth_);
+      T* input = attn_layer_input_.data() + b * input_depth;
+      std::copy(cell_output.cbegin(), cell_output.cend(), input);
+      std::copy(context.cbegin(), context.cend(), input + inner_cell_hidden_size_);
+    }
+
     math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    batch_size_, attn_layer_depth_, attn_context_depth_, T{1.0},
-                    attn_context_.data(), attn_context_depth_,
-                    attn_layer_attn_weights_.data(), attn_layer_depth_, T{1.0},
+                    batch_size_, attn_layer_depth_, input_depth, T{1.0},
+                    attn_layer_input_.data(), input_depth,
+                    attn_layer_weights_.data(), attn_layer_depth_, T{0.0},
                     attn_states_.data(), attn_layer_depth_, ttp_);
   }
 }
@@ -76,8 +79,7 @@ void AttentionWrapper<T>::SetWeights(const gsl::span<const T>& wrapper_weights)
     //cell weight size and attn weight size in the attn layer
     size_t cws = inner_cell_hidden_size_ * attn_layer_depth_;
     size_t aws = attn_context_depth_ * attn_layer_depth_;
-    attn_layer_cell_weights_ = wrapper_weights.subspan(0, cws);
-    attn_layer_attn_weights_ = wrapper_weights.subspan(cws, aws);
+    attn_layer_weights_ = wrapper_weights.subspan(0, cws + aws);
   }
 }
 
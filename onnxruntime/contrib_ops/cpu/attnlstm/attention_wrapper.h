@@ -47,8 +47,12 @@ class AttentionWrapper {
   AllocatorPtr allocator_;
   const logging::Logger& logger_;
 
-  gsl::span<const T> attn_layer_cell_weights_;
-  gsl::span<const T> attn_layer_attn_weights_;
+  // stack([attn_layer_cell_weights, attn_layer_attn_weights]), [inner_cell_hidden_size + attn_context_depth, attn_layer_depth]
+  gsl::span<const T> attn_layer_weights_;
+
+  // concat([rnn_cell_output, attn_context]), [batch_size, inner_cell_hidden_size + attn_context_depth]
+  IAllocatorUniquePtr<T> attn_layer_input_ptr_;
+  gsl::span<T> attn_layer_input_;
 
   IAllocatorUniquePtr<T> attn_context_ptr_;
   gsl::span<T> attn_context_;
@@ -3,7 +3,11 @@
 
 #include "bahdanau_attention.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <memory.h>
 
@@ -20,6 +24,7 @@ BahdanauAttention<T>::BahdanauAttention(AllocatorPtr allocator, const logging::L
   values_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * memory_depth_, values_ptr_, true);
   keys_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, keys_ptr_, true);
   processed_query_ = Allocate(allocator_, batch_size_ * attn_depth_, processed_query_ptr_, true);
+  scores_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, scores_ptr_, true);
   mem_seq_lengths_ = Allocate(allocator_, batch_size_, mem_seq_lengths_ptr_, true);
 
   ORT_ENFORCE(!normalize_, "not support normalize yet.");
@@ -80,14 +85,26 @@ void BahdanauAttention<T>::PrepareMemory(
 }
 
 template <typename T>
-static void SoftmaxInplace(const gsl::span<T>& alignments) {
+static void TanhInplace(T* x, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    x[i] = tanh(x[i]);
+  }
+}
+
+template <>
+void TanhInplace<float>(float* x, size_t len) {
+  MlasComputeTanh(x, x, len);
+}
+
+template <typename T>
+static void SoftmaxInplace(const gsl::span<T>& alignments, T max_alignment) {
   T* x = alignments.data();
   size_t len = alignments.size();
 
+  // subtracting the maximum keeps exp from overflowing on large scores
   double sum = 0.0;
-
   for (size_t i = 0; i < len; i++) {
-    T e = exp(x[i]);
+    T e = exp(x[i] - max_alignment);
     sum += e;
     x[i] = e;
   }
@@ -121,36 +138,60 @@ void BahdanauAttention<T>::Compute(
                   query_layer_weights_.data(), attn_depth_, T{0.0},
                   processed_query_.data(), attn_depth_, ttp_);
 
-  std::fill(aligns.begin(), aligns.end(), T{});
-
-  // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
-  for (int b = 0; b < batch_size_; b++) {
+  // The score, softmax and context of a batch entry run back to back on the same scores block, which stays in
+  // cache, instead of a pass over the whole batch for each. Only the real memory steps are computed.
+  auto compute_entry = [this, &output, &aligns](int b) {
     T* alignments = aligns.data() + b * max_memory_steps_;
     const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
     const T* query = processed_query_.data() + b * attn_depth_;
+    T* scores = scores_.data() + b * max_memory_steps_ * attn_depth_;
+    const T* v = attention_v_.data();
 
     int mem_steps = mem_seq_lengths_[b];
+
+    // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
     for (int step = 0; step < mem_steps; step++) {
       const T* keys_on_step = keys + step * attn_depth_;
-      T* dest = alignments + step;
+      T* scores_on_step = scores + step * attn_depth_;
+      for (int i = 0; i < attn_depth_; i++) {
+        scores_on_step[i] = keys_on_step[i] + query[i];
+      }
+    }
+    TanhInplace(scores, static_cast<size_t>(mem_steps) * attn_depth_);
 
-      // reduce_sum(v * tanh(keys[step] + query)) on last dimension
-      *dest = T(0.0);
+    T max_alignment = std::numeric_limits<T>::lowest();
+    for (int step = 0; step < mem_steps; step++) {
+      const T* scores_on_step = scores + step * attn_depth_;
+      T alignment{0.0};
       for (int i = 0; i < attn_depth_; i++) {
-        *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
+        alignment += v[i] * scores_on_step[i];
       }
+      alignments[step] = alignment;
+      max_alignment = std::max(max_alignment, alignment);
     }
 
-    SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
+    SoftmaxInplace(gsl::span<T>{alignments, static_cast<size_t>(mem_steps)}, max_alignment);
+    std::fill(alignments + mem_steps, alignments + max_memory_steps_, T{});
+
+    // Calculate the context, the steps past the memory sequence length have no weight
+    T* context = output.data() + b * memory_depth_;
+    const T* values = values_.data() + b * max_memory_steps_ * memory_depth_;
+    std::fill(context, context + memory_depth_, T{});
+    for (int step = 0; step < mem_steps; step++) {
+      const T weight = alignments[step];
+      const T* values_on_step = values + step * memory_depth_;
+      for (int i = 0; i < memory_depth_; i++) {
+        context[i] += weight * values_on_step[i];
+      }
+    }
+  };
 
-    // Calculate the context
-    auto outspan = output.subspan(b * memory_depth_);
-    auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    1, memory_depth_, max_memory_steps_, T{1.0},
-                    alignments, max_memory_steps_,
-                    values.data(), memory_depth_, T{0.0},
-                    outspan.data(), memory_depth_, ttp_);
+  if (ttp_ != nullptr && batch_size_ > 1) {
+    ttp_->ParallelFor(batch_size_, compute_entry);
+  } else {
+    for (int b = 0; b < batch_size_; b++) {
+      compute_entry(b);
+    }
   }
 }
 
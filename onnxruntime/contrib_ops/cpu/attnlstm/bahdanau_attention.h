@@ -73,6 +73,10 @@ class BahdanauAttention : public IAttentionMechanism<T> {
   IAllocatorUniquePtr<T> processed_query_ptr_;
   gsl::span<T> processed_query_;
 
+  // keys + processed query of each step, before and after the tanh, [batch_size_, max_memory_steps_, attn_depth_]
+  IAllocatorUniquePtr<T> scores_ptr_;
+  gsl::span<T> scores_;
+
   IAllocatorUniquePtr<int> mem_seq_lengths_ptr_;
   gsl::span<int> mem_seq_lengths_;
 
@@ -0,0 +1,674 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    BeamSearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    BeamSearch);
+
+ONNX_OPERATOR_KERNEL_EX(
+    GreedySearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int32_t>()),
+    GreedySearch);
+
+namespace {
+
+// the decoder inputs before the past state of the layers
+constexpr int kFirstPastInput = 3;
+
+template <typename T>
+OrtValue CreateTensor(const AllocatorPtr& allocator, const std::vector<int64_t>& dims) {
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<T>(), TensorShape(dims), allocator);
+  return OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// The state of a generation over rows of sequences, each batch entry being repeated over num_beams rows.
+// The decoder runs with one execution frame for all the steps.
+class Generation {
+ public:
+  Generation(OpKernelContextInternal& context, const SessionState& session_state, const FeedsFetchesManager& ffm,
+             const AllocatorPtr& allocator, int num_layers, int num_heads, int head_size)
+      : context_{context},
+        session_state_{session_state},
+        ffm_{ffm},
+        allocator_{allocator},
+        num_layers_{num_layers},
+        num_heads_{num_heads},
+        head_size_{head_size} {}
+
+  // Sets up the first step, which runs the decoder on input_ids with an empty past state
+  void Initialize(const Tensor& input_ids, int num_beams, int max_length, int32_t pad_token_id) {
+    const auto& dims = input_ids.Shape().GetDims();
+    batch_size_ = static_cast<int>(dims[0]);
+    sequence_length_ = static_cast<int>(dims[1]);
+    num_beams_ = num_beams;
+    max_length_ = max_length;
+    rows_ = batch_size_ * num_beams;
+    current_length_ = sequence_length_;
+
+    // the pad tokens of input_ids are masked out, and don't take a position
+    const int32_t* ids = input_ids.Data<int32_t>();
+    prompt_mask_.resize(static_cast<size_t>(batch_size_) * sequence_length_);
+    prompt_lengths_.assign(batch_size_, 0);
+    for (int b = 0; b < batch_size_; ++b) {
+      for (int t = 0; t < sequence_length_; ++t) {
+        const bool is_token = ids[b * sequence_length_ + t] != pad_token_id;
+        prompt_mask_[b * sequence_length_ + t] = is_token ? 1 : 0;
+        prompt_lengths_[b] += is_token ? 1 : 0;
+      }
+    }
+
+    sequences_.resize(static_cast<size_t>(rows_) * max_length);
+    next_sequences_.resize(sequences_.size());
+
+    feeds_.resize(kFirstPastInput + num_layers_);
+    feeds_[0] = CreateTensor<int32_t>(allocator_, {rows_, sequence_length_});
+    feeds_[1] = CreateTensor<int32_t>(allocator_, {rows_, sequence_length_});
+    int32_t* input_ids_feed = feeds_[0].GetMutable<Tensor>()->MutableData<int32_t>();
+    int32_t* position_ids = feeds_[1].GetMutable<Tensor>()->MutableData<int32_t>();
+    for (int r = 0; r < rows_; ++r) {
+      const int b = r / num_beams;
+      std::copy_n(ids + b * sequence_length_, sequence_length_, input_ids_feed + r * sequence_length_);
+      std::copy_n(ids + b * sequence_length_, sequence_length_, sequences_.data() + r * max_length);
+
+      int32_t position = 0;
+      for (int t = 0; t < sequence_length_; ++t) {
+        position_ids[r * sequence_length_ + t] = std::max(position - 1 + prompt_mask_[b * sequence_length_ + t], 0);
+        position += prompt_mask_[b * sequence_length_ + t];
+      }
+    }
+    SetAttentionMask();
+
+    for (int i = 0; i < num_layers_; ++i) {
+      feeds_[kFirstPastInput + i] = CreateTensor<float>(allocator_, {2, rows_, num_heads_, 0, head_size_});
+    }
+
+    for (const auto* implicit_input : context_.GetImplicitInputs()) {
+      feeds_.push_back(*implicit_input);
+    }
+  }
+
+  // Runs the decoder on the current step
+  Status RunDecoder() {
+    fetches_.clear();
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(session_state_, ffm_, feeds_, fetches_, {},
+                                               /*sequential_execution*/ true, context_.GetTerminateFlag(),
+                                               context_.Logger(), &frame_, context_.GetOperatorThreadPool()));
+
+    const auto& logits_shape = fetches_[0].Get<Tensor>().Shape();
+    const int64_t step_length = feeds_[0].Get<Tensor>().Shape()[1];
+    if (logits_shape.NumDimensions() != 3 || logits_shape[0] != rows_ || logits_shape[1] != step_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The logits of the decoder must have shape {", rows_, ",",
+                             step_length, ",vocab_size}. Actual:", logits_shape);
+    }
+    vocab_size_ = static_cast<int>(logits_shape[2]);
+
+    for (int i = 0; i < num_layers_; ++i) {
+      const auto& present_shape = fetches_[1 + i].Get<Tensor>().Shape();
+      if (present_shape != TensorShape({2, rows_, num_heads_, current_length_, head_size_})) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The present state ", i, " of the decoder must have shape {2,",
+                               rows_, ",", num_heads_, ",", current_length_, ",", head_size_,
+                               "}. Actual:", present_shape);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  // the logits of the next token of a row, after RunDecoder
+  const float* NextTokenLogits(int row) const {
+    const auto& logits = fetches_[0].Get<Tensor>();
+    const int64_t step_length = logits.Shape()[1];
+    return logits.Data<float>() + (row * step_length + step_length - 1) * vocab_size_;
+  }
+
+  // Appends tokens[r] to each row r, continuing the sequence of source_rows[r], or of the row itself if source_rows
+  // is nullptr, and sets up the next step
+  void Append(const int32_t* tokens, const int* source_rows) {
+    for (int r = 0; r < rows_; ++r) {
+      const int source = source_rows != nullptr ? source_rows[r] : r;
+      std::copy_n(sequences_.data() + source * max_length_, current_length_, next_sequences_.data() + r * max_length_);
+      next_sequences_[r * max_length_ + current_length_] = tokens[r];
+    }
+    sequences_.swap(next_sequences_);
+
+    if (source_rows != nullptr) {
+      GatherPastState(source_rows);
+    } else {
+      // the present state of each row is its past state in the next step
+      for (int i = 0; i < num_layers_; ++i) {
+        feeds_[kFirstPastInput + i] = fetches_[1 + i];
+      }
+    }
+
+    // the next step runs on the appended tokens
+    feeds_[0] = CreateTensor<int32_t>(allocator_, {rows_, 1});
+    feeds_[1] = CreateTensor<int32_t>(allocator_, {rows_, 1});
+    std::copy_n(tokens, rows_, feeds_[0].GetMutable<Tensor>()->MutableData<int32_t>());
+    int32_t* position_ids = feeds_[1].GetMutable<Tensor>()->MutableData<int32_t>();
+    for (int r = 0; r < rows_; ++r) {
+      position_ids[r] = prompt_lengths_[r / num_beams_] + current_length_ - sequence_length_;
+    }
+
+    ++current_length_;
+    SetAttentionMask();
+    fetches_.clear();
+  }
+
+  int Rows() const { return rows_; }
+  int VocabSize() const { return vocab_size_; }
+  int CurrentLength() const { return current_length_; }
+  const int32_t* Sequence(int row) const { return sequences_.data() + row * max_length_; }
+
+ private:
+  // the prompt mask of the batch entry of each row followed by the generated tokens
+  void SetAttentionMask() {
+    feeds_[2] = CreateTensor<int32_t>(allocator_, {rows_, current_length_});
+    int32_t* mask = feeds_[2].GetMutable<Tensor>()->MutableData<int32_t>();
+    for (int r = 0; r < rows_; ++r, mask += current_length_) {
+      std::copy_n(prompt_mask_.data() + (r / num_beams_) * sequence_length_, sequence_length_, mask);
+      std::fill(mask + sequence_length_, mask + current_length_, 1);
+    }
+  }
+
+  // Gathers the present state of source_rows into the past state, which the layers keep in buffers sized for
+  // max_length and allocated once
+  void GatherPastState(const int* source_rows) {
+    const size_t row_size = static_cast<size_t>(num_heads_) * current_length_ * head_size_;
+    const size_t buffer_size = 2 * static_cast<size_t>(rows_) * num_heads_ * max_length_ * head_size_;
+    if (past_buffers_.empty()) {
+      for (int i = 0; i < num_layers_; ++i) {
+        past_buffers_.emplace_back(allocator_->Alloc(buffer_size * sizeof(float)), BufferDeleter(allocator_));
+      }
+    }
+
+    for (int i = 0; i < num_layers_; ++i) {
+      const float* present = fetches_[1 + i].Get<Tensor>().Data<float>();
+      float* past = static_cast<float*>(past_buffers_[i].get());
+      for (int half = 0; half < 2; ++half) {
+        for (int r = 0; r < rows_; ++r) {
+          std::memcpy(past + (half * rows_ + r) * row_size, present + (half * rows_ + source_rows[r]) * row_size,
+                      row_size * sizeof(float));
+        }
+      }
+
+      auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(),
+                                             TensorShape({2, rows_, num_heads_, current_length_, head_size_}), past,
+                                             allocator_->Info());
+      feeds_[kFirstPastInput + i] = OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+    }
+  }
+
+  OpKernelContextInternal& context_;
+  const SessionState& session_state_;
+  const FeedsFetchesManager& ffm_;
+  AllocatorPtr allocator_;
+  const int num_layers_;
+  const int num_heads_;
+  const int head_size_;
+
+  int batch_size_ = 0;
+  int sequence_length_ = 0;
+  int num_beams_ = 1;
+  int max_length_ = 0;
+  int rows_ = 0;
+  int current_length_ = 0;
+  int vocab_size_ = 0;
+
+  std::vector<int32_t> prompt_mask_;
+  std::vector<int32_t> prompt_lengths_;
+
+  // the tokens of the rows, max_length_ apart
+  std::vector<int32_t> sequences_;
+  std::vector<int32_t> next_sequences_;
+
+  // feeds: input_ids, position_ids, attention_mask, the past state of each layer, then the implicit inputs
+  std::vector<OrtValue> feeds_;
+  // fetches: logits, then the present state of each layer
+  std::vector<OrtValue> fetches_;
+  std::unique_ptr<ExecutionFrame> frame_;
+
+  std::vector<BufferUniquePtr> past_buffers_;
+};
+
+// the log of the softmax of the logits of a token, where eos_token_id can't be picked if blocked
+void LogSoftmax(const float* logits, int vocab_size, int32_t eos_token_id, bool block_eos, float* log_probs) {
+  const float max = *std::max_element(logits, logits + vocab_size);
+  float sum = 0.f;
+  for (int v = 0; v < vocab_size; ++v) {
+    sum += std::exp(logits[v] - max);
+  }
+
+  const float log_sum = max + std::log(sum);
+  for (int v = 0; v < vocab_size; ++v) {
+    log_probs[v] = logits[v] - log_sum;
+  }
+
+  if (block_eos && eos_token_id >= 0 && eos_token_id < vocab_size) {
+    log_probs[eos_token_id] = std::numeric_limits<float>::lowest();
+  }
+}
+
+// The best finished sequences of a batch entry
+class BeamHypotheses {
+ public:
+  BeamHypotheses(int num_beams, float length_penalty, bool early_stopping)
+      : num_beams_{num_beams}, length_penalty_{length_penalty}, early_stopping_{early_stopping} {}
+
+  // Adds the sequence if it scores above the worst one kept
+  void Add(const int32_t* tokens, int length, float sum_log_probs) {
+    const float score = sum_log_probs / std::pow(static_cast<float>(length), length_penalty_);
+    if (static_cast<int>(beams_.size()) == num_beams_ && score <= beams_.back().first) {
+      return;
+    }
+
+    auto position = std::upper_bound(beams_.begin(), beams_.end(), score,
+                                     [](float value, const std::pair<float, std::vector<int32_t>>& beam) {
+                                       return value > beam.first;
+                                     });
+    beams_.emplace(position, score, std::vector<int32_t>(tokens, tokens + length));
+    if (static_cast<int>(beams_.size()) > num_beams_) {
+      beams_.pop_back();
+    }
+  }
+
+  // whether none of the beams can be added anymore, given the best score of the beams at the current length
+  bool IsDone(float best_sum_log_probs, int current_length) const {
+    if (static_cast<int>(beams_.size()) < num_beams_) {
+      return false;
+    }
+    return early_stopping_ ||
+           best_sum_log_probs / std::pow(static_cast<float>(current_length), length_penalty_) <= beams_.back().first;
+  }
+
+  // the finished sequences, best first
+  const std::vector<std::pair<float, std::vector<int32_t>>>& Beams() const { return beams_; }
+
+ private:
+  const int num_beams_;
+  const float length_penalty_;
+  const bool early_stopping_;
+  std::vector<std::pair<float, std::vector<int32_t>>> beams_;
+};
+
+// the top k of the scores, best first, as (score, index) pairs. a min-heap of k entries avoids sorting the scores.
+void TopK(const float* scores, int count, int k, std::vector<std::pair<float, int>>& top) {
+  std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>,
+                      std::greater<std::pair<float, int>>>
+      heap;
+  for (int i = 0; i < count; ++i) {
+    if (static_cast<int>(heap.size()) < k) {
+      heap.emplace(scores[i], i);
+    } else if (scores[i] > heap.top().first) {
+      heap.pop();
+      heap.emplace(scores[i], i);
+    }
+  }
+
+  top.resize(heap.size());
+  for (auto it = top.rbegin(); it != top.rend(); ++it) {
+    *it = heap.top();
+    heap.pop();
+  }
+}
+
+}  // namespace
+
+SequenceGenerationBase::SequenceGenerationBase(const OpKernelInfo& info) : OpKernel(info) {
+  // make sure the attribute was present even though we don't need it here.
+  // the decoder is run through its subgraph session state, see SetupSubgraphExecutionInfo.
+  ONNX_NAMESPACE::GraphProto proto;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+  ORT_IGNORE_RETURN_VALUE(proto);
+
+  int64_t value;
+  ORT_ENFORCE(info.GetAttr<int64_t>("eos_token_id", &value).IsOK());
+  eos_token_id_ = static_cast<int32_t>(value);
+  ORT_ENFORCE(info.GetAttr<int64_t>("pad_token_id", &value).IsOK());
+  pad_token_id_ = static_cast<int32_t>(value);
+}
+
+common::Status SequenceGenerationBase::SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                                                  const std::string& attribute_name,
+                                                                  const SessionState& subgraph_session_state) {
+  ORT_ENFORCE(feeds_fetches_manager_ == nullptr,
+              "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+  ORT_UNUSED_PARAMETER(attribute_name);
+
+  const auto& subgraph = *subgraph_session_state.GetGraphViewer();
+  const auto& subgraph_inputs = subgraph.GetInputs();
+  const auto& subgraph_outputs = subgraph.GetOutputs();
+
+  num_layers_ = static_cast<int>(subgraph_inputs.size()) - kFirstPastInput;
+  if (num_layers_ < 0 || subgraph_outputs.size() != static_cast<size_t>(num_layers_) + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The decoder must have the inputs input_ids, position_ids, ",
+                           "attention_mask and the past state of each layer, and the outputs logits and the ",
+                           "present state of each layer. Found ", subgraph_inputs.size(), " inputs and ",
+                           subgraph_outputs.size(), " outputs.");
+  }
+
+  // the past state is shaped [2, batch_size, num_heads, past_sequence_length, head_size]
+  for (int i = 0; i < num_layers_; ++i) {
+    const auto& past = *subgraph_inputs[kFirstPastInput + i];
+    const auto* shape = past.Shape();
+    if (past.TypeAsProto() == nullptr ||
+        past.TypeAsProto()->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        shape == nullptr || shape->dim_size() != 5 || !shape->dim(2).has_dim_value() ||
+        !shape->dim(4).has_dim_value()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The past state input ", past.Name(),
+                             " of the decoder must be a float tensor of rank 5 with static num_heads and head_size.");
+    }
+
+    const int num_heads = static_cast<int>(shape->dim(2).dim_value());
+    const int head_size = static_cast<int>(shape->dim(4).dim_value());
+    if (i > 0 && (num_heads != num_heads_ || head_size != head_size_)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                             "The past state inputs of the decoder must have the same num_heads and head_size.");
+    }
+    num_heads_ = num_heads;
+    head_size_ = head_size;
+  }
+
+  std::vector<std::string> feed_names;
+  feed_names.reserve(subgraph_inputs.size() + Node().ImplicitInputDefs().size());
+  for (const auto* input : subgraph_inputs) {
+    feed_names.push_back(input->Name());
+  }
+  for (const auto* entry : Node().ImplicitInputDefs()) {
+    feed_names.push_back(entry->Name());
+  }
+
+  // the decoder inputs are created on CPU by the generation, so only the implicit inputs are looked up
+  std::vector<OrtDevice> feed_locations;
+  ORT_RETURN_IF_ERROR(controlflow::detail::FindDevicesForValues(session_state, feed_names, feed_locations,
+                                                                subgraph_inputs.size()));
+
+  std::vector<std::string> output_names;
+  output_names.reserve(subgraph_outputs.size());
+  for (const auto* output : subgraph_outputs) {
+    output_names.push_back(output->Name());
+  }
+
+  std::unique_ptr<FeedsFetchesManager> ffm;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names,
+                                                  subgraph_session_state.GetOrtValueNameIdxMap(), ffm));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(subgraph_session_state, *ffm));
+
+  // the decoder outputs aren't pre-allocated
+  std::vector<const OrtMemoryInfo*> fetch_locations(output_names.size(), nullptr);
+  utils::FinalizeFeedFetchCopyInfo(subgraph_session_state, *ffm, feed_locations, fetch_locations);
+
+  feeds_fetches_manager_ = std::move(ffm);
+
+  return Status::OK();
+}
+
+// reads a scalar input, or returns default_value if the input is missing
+template <typename T>
+static Status GetScalarInput(const OpKernelContext& context, int index, const char* name, T default_value,
+                             T& value) {
+  const auto* tensor = context.Input<Tensor>(index);
+  if (tensor == nullptr) {
+    value = default_value;
+    return Status::OK();
+  }
+
+  if (tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name, " must hold a single value. Actual shape:",
+                           tensor->Shape());
+  }
+  value = *tensor->Data<T>();
+  return Status::OK();
+}
+
+Status SequenceGenerationBase::ValidateInputs(const OpKernelContext& context, Parameters& parameters) const {
+  const auto& input_ids_shape = context.Input<Tensor>(0)->Shape();
+  if (input_ids_shape.NumDimensions() != 2 || input_ids_shape[0] == 0 || input_ids_shape[1] == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input input_ids must have shape {batch_size,sequence_length} with non-zero dims. Actual:",
+                           input_ids_shape);
+  }
+  parameters.batch_size = static_cast<int>(input_ids_shape[0]);
+  parameters.sequence_length = static_cast<int>(input_ids_shape[1]);
+
+  int32_t max_length;
+  int32_t min_length;
+  ORT_RETURN_IF_ERROR(GetScalarInput<int32_t>(context, 1, "max_length", 0, max_length));
+  ORT_RETURN_IF_ERROR(GetScalarInput<int32_t>(context, 2, "min_length", 0, min_length));
+  if (max_length <= parameters.sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input max_length must be greater than the ",
+                           "sequence length of input_ids, ", parameters.sequence_length, ". Actual:", max_length);
+  }
+  parameters.max_length = max_length;
+  parameters.min_length = min_length;
+
+  return Status::OK();
+}
+
+Status SequenceGenerationBase::Generate(OpKernelContext& context, const Parameters& parameters, int num_beams,
+                                        int num_return_sequences, float length_penalty, bool early_stopping) const {
+  auto& context_internal = static_cast<OpKernelContextInternal&>(context);
+  const auto* session_state = context_internal.SubgraphSessionState("decoder");
+  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'decoder' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_, "SetupSubgraphExecutionInfo must be called prior to execution of graph.");
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&allocator));
+
+  Generation generation{context_internal, *session_state, *feeds_fetches_manager_, allocator, num_layers_,
+                        num_heads_, head_size_};
+  generation.Initialize(*context.Input<Tensor>(0), num_beams, parameters.max_length, pad_token_id_);
+
+  const int batch_size = parameters.batch_size;
+  const int rows = generation.Rows();
+  std::vector<int32_t> tokens(rows);
+  std::vector<float> log_probs;
+
+  // a greedy search appends the token of the highest logit to each row until it ends
+  if (num_beams == 1) {
+    std::vector<bool> finished(rows, false);
+    while (generation.CurrentLength() < parameters.max_length) {
+      ORT_RETURN_IF_ERROR(generation.RunDecoder());
+
+      const int vocab_size = generation.VocabSize();
+      const bool block_eos = generation.CurrentLength() < parameters.min_length;
+      for (int r = 0; r < rows; ++r) {
+        if (finished[r]) {
+          tokens[r] = pad_token_id_;
+          continue;
+        }
+
+        const float* logits = generation.NextTokenLogits(r);
+        int32_t best = 0;
+        for (int v = 1; v < vocab_size; ++v) {
+          if ((v != eos_token_id_ || !block_eos) && (logits[v] > logits[best] || (block_eos && best == eos_token_id_))) {
+            best = v;
+          }
+        }
+        tokens[r] = best;
+        finished[r] = best == eos_token_id_;
+      }
+
+      generation.Append(tokens.data(), nullptr);
+      if (std::all_of(finished.cbegin(), finished.cend(), [](bool value) { return value; })) {
+        break;
+      }
+    }
+
+    Tensor* sequences = context.Output(0, {batch_size, parameters.max_length});
+    int32_t* output = sequences->MutableData<int32_t>();
+    const int length = generation.CurrentLength();
+    for (int r = 0; r < rows; ++r, output += parameters.max_length) {
+      std::copy_n(generation.Sequence(r), length, output);
+      std::fill(output + length, output + parameters.max_length, pad_token_id_);
+    }
+
+    return Status::OK();
+  }
+
+  // the first step picks the tokens of the first beam of each batch entry only, as all its beams are the same
+  std::vector<float> beam_scores(rows, -1e9f);
+  for (int b = 0; b < batch_size; ++b) {
+    beam_scores[b * num_beams] = 0.f;
+  }
+
+  std::vector<BeamHypotheses> hypotheses(batch_size, BeamHypotheses(num_beams, length_penalty, early_stopping));
+  std::vector<bool> done(batch_size, false);
+  std::vector<float> next_beam_scores(rows);
+  std::vector<int> source_rows(rows);
+  std::vector<std::pair<float, int>> top;
+
+  while (generation.CurrentLength() < parameters.max_length) {
+    ORT_RETURN_IF_ERROR(generation.RunDecoder());
+
+    const int vocab_size = generation.VocabSize();
+    const int current_length = generation.CurrentLength();
+    const bool block_eos = current_length < parameters.min_length;
+    log_probs.resize(static_cast<size_t>(num_beams) * vocab_size);
+
+    for (int b = 0; b < batch_size; ++b) {
+      const int first_row = b * num_beams;
+      if (done[b]) {
+        // a finished batch entry keeps its rows, padded
+        for (int j = 0; j < num_beams; ++j) {
+          tokens[first_row + j] = pad_token_id_;
+          source_rows[first_row + j] = first_row + j;
+          next_beam_scores[first_row + j] = 0.f;
+        }
+        continue;
+      }
+
+      // the scores of the beams extended by each token of the vocabulary
+      for (int j = 0; j < num_beams; ++j) {
+        float* scores = log_probs.data() + j * vocab_size;
+        LogSoftmax(generation.NextTokenLogits(first_row + j), vocab_size, eos_token_id_, block_eos, scores);
+        std::transform(scores, scores + vocab_size, scores,
+                       [score = beam_scores[first_row + j]](float log_prob) { return log_prob + score; });
+      }
+
+      // 2 * num_beams candidates leave num_beams beams that don't end, with at most num_beams ended by eos
+      TopK(log_probs.data(), num_beams * vocab_size, 2 * num_beams, top);
+      int num_next_beams = 0;
+      for (size_t rank = 0; rank < top.size() && num_next_beams < num_beams; ++rank) {
+        const int source_row = first_row + top[rank].second / vocab_size;
+        const int32_t token = top[rank].second % vocab_size;
+        if (token == eos_token_id_) {
+          if (static_cast<int>(rank) < num_beams) {
+            hypotheses[b].Add(generation.Sequence(source_row), current_length, top[rank].first);
+          }
+          continue;
+        }
+
+        tokens[first_row + num_next_beams] = token;
+        source_rows[first_row + num_next_beams] = source_row;
+        next_beam_scores[first_row + num_next_beams] = top[rank].first;
+        ++num_next_beams;
+      }
+
+      done[b] = hypotheses[b].IsDone(next_beam_scores[first_row], current_length);
+    }
+
+    if (std::all_of(done.cbegin(), done.cend(), [](bool value) { return value; })) {
+      break;
+    }
+
+    generation.Append(tokens.data(), source_rows.data());
+    beam_scores.swap(next_beam_scores);
+  }
+
+  // the beams of the batch entries that didn't end are finished as they are
+  for (int b = 0; b < batch_size; ++b) {
+    if (!done[b]) {
+      for (int j = 0; j < num_beams; ++j) {
+        const int row = b * num_beams + j;
+        hypotheses[b].Add(generation.Sequence(row), generation.CurrentLength(), beam_scores[row]);
+      }
+    }
+  }
+
+  Tensor* sequences = context.Output(0, {batch_size, num_return_sequences, parameters.max_length});
+  Tensor* sequences_scores = context.Output(1, {batch_size, num_return_sequences});
+  int32_t* output = sequences->MutableData<int32_t>();
+  float* output_scores = sequences_scores != nullptr ? sequences_scores->MutableData<float>() : nullptr;
+  for (int b = 0; b < batch_size; ++b) {
+    const auto& beams = hypotheses[b].Beams();
+    for (int i = 0; i < num_return_sequences; ++i, output += parameters.max_length) {
+      // the finished sequences are kept without the eos token that ended them
+      const auto& beam = beams[i].second;
+      int32_t* end = std::copy(beam.cbegin(), beam.cend(), output);
+      if (end != output + parameters.max_length) {
+        *end++ = eos_token_id_;
+      }
+      std::fill(end, output + parameters.max_length, pad_token_id_);
+      if (output_scores != nullptr) {
+        *output_scores++ = beams[i].first;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+BeamSearch::BeamSearch(const OpKernelInfo& info) : SequenceGenerationBase(info) {
+  early_stopping_ = info.GetAttrOrDefault<int64_t>("early_stopping", 0) == 1;
+}
+
+Status BeamSearch::Compute(OpKernelContext* context) const {
+  Parameters parameters;
+  ORT_RETURN_IF_ERROR(ValidateInputs(*context, parameters));
+
+  int32_t num_beams;
+  int32_t num_return_sequences;
+  float length_penalty;
+  ORT_RETURN_IF_ERROR(GetScalarInput<int32_t>(*context, 3, "num_beams", 1, num_beams));
+  ORT_RETURN_IF_ERROR(GetScalarInput<int32_t>(*context, 4, "num_return_sequences", 1, num_return_sequences));
+  ORT_RETURN_IF_ERROR(GetScalarInput<float>(*context, 5, "length_penalty", 1.f, length_penalty));
+  if (num_beams < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input num_beams must be at least 2. Actual:", num_beams);
+  }
+  if (num_return_sequences < 1 || num_return_sequences > num_beams) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input num_return_sequences must be in [1, num_beams]. ",
+                           "Actual:", num_return_sequences);
+  }
+
+  return Generate(*context, parameters, num_beams, num_return_sequences, length_penalty, early_stopping_);
+}
+
+Status GreedySearch::Compute(OpKernelContext* context) const {
+  Parameters parameters;
+  ORT_RETURN_IF_ERROR(ValidateInputs(*context, parameters));
+
+  return Generate(*context, parameters, 1, 1, 1.f, false);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/controlflow/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Base of the operators generating sequences with the decoder subgraph, which run it once per generated token.
+class SequenceGenerationBase : public OpKernel, public controlflow::IControlFlowKernel {
+ public:
+  SequenceGenerationBase(const OpKernelInfo& info);
+
+  common::Status SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                            const std::string& attribute_name,
+                                            const SessionState& subgraph_session_state) override;
+
+ protected:
+  // the inputs shared by the operators
+  struct Parameters {
+    int batch_size;
+    int sequence_length;
+    int max_length;
+    int min_length;
+  };
+
+  Status ValidateInputs(const OpKernelContext& context, Parameters& parameters) const;
+
+  // runs the generation with num_beams beams per batch entry, a greedy search for a single beam
+  Status Generate(OpKernelContext& context, const Parameters& parameters, int num_beams, int num_return_sequences,
+                  float length_penalty, bool early_stopping) const;
+
+ private:
+  int32_t eos_token_id_;
+  int32_t pad_token_id_;
+
+  // the layers of the past state of the decoder, and the dims of their heads
+  int num_layers_ = 0;
+  int num_heads_ = 0;
+  int head_size_ = 0;
+
+  // FeedsFetchesManager re-used for each decoder execution.
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+};
+
+class BeamSearch final : public SequenceGenerationBase {
+ public:
+  BeamSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool early_stopping_;
+};
+
+class GreedySearch final : public SequenceGenerationBase {
+ public:
+  GreedySearch(const OpKernelInfo& info) : SequenceGenerationBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,7 +8,10 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "assert.h"
+#include <algorithm>
+#include <vector>
 #ifndef USE_OPENMP
 #include "core/util/eigen_common_wrapper.h"
 #endif
@@ -16,77 +19,105 @@
 namespace onnxruntime {
 namespace contrib {
 
+// Runs fn(begin, end) over blocks of the rows [0, rows), each of which costs about cost_per_row.
+template <typename Func>
+void ParallelForRows(size_t rows, double cost_per_row, concurrency::ThreadPool* tp, Func&& fn) {
+#ifndef USE_OPENMP
+  if (tp != nullptr) {
+    Eigen::ThreadPoolDevice device(&tp->GetHandler(), tp->NumThreads());
+    device.parallelFor(static_cast<Eigen::Index>(rows), Eigen::TensorOpCost(0, 0, cost_per_row),
+                       [&fn](Eigen::Index begin, Eigen::Index end) {
+                         fn(static_cast<size_t>(begin), static_cast<size_t>(end));
+                       });
+    return;
+  }
+#else
+  (void)cost_per_row;
+  (void)tp;
+#endif
+  fn(size_t{0}, rows);
+}
+
 // https://docs.scipy.org/doc/scipy/reference/generated/scipy.spatial.distance.cdist.html
 //\param a: matrix with shape of[ma,n]
 //\param b: matrix with shape of[mb,n]
 //\param dest: matrix with shape of [ma,mb]
+// The rows of a are split across the threads, and each thread goes through b by blocks that stay in the cache
+// while they are compared with all its rows of a.
 template <typename T, typename ElemFunc>
-void cdist_single_threaded(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n) {
-  ElemFunc f;
-  for (size_t i = 0; i != ma; ++i) {
-    const T* a1 = a + n * i;
-    for (size_t j = 0; j != mb; ++j) {
-      const T* b1 = b + n * j;
-      *dest++ = f(a1, b1, n);
+void cdist(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, concurrency::ThreadPool* tp) {
+  const size_t block_b = std::max<size_t>(1, (16 * 1024) / (n * sizeof(T)));
+  ParallelForRows(ma, static_cast<double>(3 * n * mb), tp, [=](size_t begin, size_t end) {
+    ElemFunc f;
+    for (size_t j0 = 0; j0 < mb; j0 += block_b) {
+      const size_t j1 = std::min(mb, j0 + block_b);
+      for (size_t i = begin; i != end; ++i) {
+        const T* a1 = a + n * i;
+        T* dest1 = dest + mb * i;
+        for (size_t j = j0; j != j1; ++j) {
+          dest1[j] = f(a1, b + n * j, n);
+        }
+      }
     }
-  }
+  });
 }
 
-template <typename T, typename ElemFunc>
-class CDistOneBlock {
- public:
-  const T* a;
-  const T* b;
-  T* dest;
-  size_t mb;
-  size_t n;
-
-  CDistOneBlock(const T* a1, const T* b1, T* dest1, size_t mb1, size_t n1)
-      : a(a1), b(b1), dest(dest1), mb(mb1), n(n1) {}
-
-  void operator()(Eigen::Index start, Eigen::Index end) {
-    Eigen::Index mb_local = mb;
-    Eigen::Index i = start / mb_local;
-    Eigen::Index j = start - i * mb_local;
-    assert(i * mb_local + j == start);
-    Eigen::Index i_end = end / mb_local;
-    Eigen::Index j_end = end - i_end * mb_local;
-    assert(i_end * mb_local + j_end == end);
-
-    T* dest_local = dest + start;
-    ElemFunc f;
-    const T* a1 = a + n * i;
-    for (; i != i_end; ++i) {
-      a1 = a + n * i;
-      for (; j != mb_local; ++j) {
-        const T* b1 = b + n * j;
-        *dest_local++ = f(a1, b1, n);
+// dest = alpha * a * b^T
+template <typename T>
+void MatMulTransB(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, T alpha,
+                  concurrency::ThreadPool*) {
+  EigenMatrixMapRowMajor<T>(dest, ma, mb).noalias() =
+      alpha * ConstEigenMatrixMapRowMajor<T>(a, ma, n) * ConstEigenMatrixMapRowMajor<T>(b, mb, n).transpose();
+}
+
+template <>
+inline void MatMulTransB<float>(const float* a, const float* b, float* dest, size_t ma, size_t mb, size_t n,
+                                float alpha, concurrency::ThreadPool* tp) {
+  MlasSgemm(CblasNoTrans, CblasTrans, ma, mb, n, alpha, a, n, b, n, 0.0f, dest, mb, tp);
+}
+
+// The squared norms of the rows of a matrix with shape of [m,n].
+template <typename T>
+std::vector<T> RowSquaredNorms(const T* a, size_t m, size_t n) {
+  std::vector<T> norms(m);
+  EigenVectorMap<T>(norms.data(), m) = ConstEigenMatrixMapRowMajor<T>(a, m, n).rowwise().squaredNorm();
+  return norms;
+}
+
+// Computes the squared Euclidean distances as ||a||^2 + ||b||^2 - 2ab with a matrix multiplication, and their
+// square roots if sqrt is set. It loses precision for points much closer to each other than to the origin.
+template <typename T>
+void cdist_euclidean_gemm(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, bool sqrt,
+                          concurrency::ThreadPool* tp) {
+  MatMulTransB<T>(a, b, dest, ma, mb, n, static_cast<T>(-2), tp);
+  const std::vector<T> norms_a = RowSquaredNorms(a, ma, n);
+  const std::vector<T> norms_b = RowSquaredNorms(b, mb, n);
+  ParallelForRows(ma, static_cast<double>(3 * mb), tp, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i != end; ++i) {
+      auto row = EigenVectorArrayMap<T>(dest + mb * i, mb);
+      row = (row + norms_a[i] + ConstEigenVectorArrayMap<T>(norms_b.data(), mb)).max(T(0));
+      if (sqrt) {
+        row = row.sqrt();
       }
-      j = 0;
-    }
-    a1 = a + n * i;
-    for (j = 0; j != j_end; ++j) {
-      const T* b1 = b + n * j;
-      *dest_local++ = f(a1, b1, n);
     }
-    assert(dest_local == dest + end);
-  }
-};
+  });
+}
 
-template <typename T, typename ElemFunc>
-void cdist(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, concurrency::ThreadPool* tp) {
-#ifndef USE_OPENMP
-  if (tp == nullptr) {
-#else
-  (void)tp;
-#endif
-    return cdist_single_threaded<T, ElemFunc>(a, b, dest, ma, mb, n);
-#ifndef USE_OPENMP
-  }
-  Eigen::ThreadPoolDevice device(&tp->GetHandler(), tp->NumThreads());
-  device.parallelFor(ma * mb, Eigen::TensorOpCost(0, 0, static_cast<double>(3 * n)),
-                     CDistOneBlock<T, ElemFunc>(a, b, dest, mb, n));
-#endif
+// Computes the cosine distances as 1 - ab / (||a|| ||b||) with a matrix multiplication.
+template <typename T>
+void cdist_cosine_gemm(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n,
+                       concurrency::ThreadPool* tp) {
+  MatMulTransB<T>(a, b, dest, ma, mb, n, static_cast<T>(1), tp);
+  std::vector<T> norms_a = RowSquaredNorms(a, ma, n);
+  std::vector<T> norms_b = RowSquaredNorms(b, mb, n);
+  EigenVectorArrayMap<T>(norms_a.data(), ma) = EigenVectorArrayMap<T>(norms_a.data(), ma).sqrt();
+  EigenVectorArrayMap<T>(norms_b.data(), mb) = EigenVectorArrayMap<T>(norms_b.data(), mb).sqrt();
+  ParallelForRows(ma, static_cast<double>(3 * mb), tp, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i != end; ++i) {
+      auto row = EigenVectorArrayMap<T>(dest + mb * i, mb);
+      row = T(1) - row / (norms_a[i] * ConstEigenVectorArrayMap<T>(norms_b.data(), mb));
+    }
+  });
 }
 
 template <typename T>
@@ -94,7 +125,7 @@ class CDist final : public OpKernel {
  private:
   typedef void (*DistFunc)(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n,
                            concurrency::ThreadPool* tp);
-  enum { EUCLIDEAN, SQEUCLIDEAN } mode_;
+  enum { EUCLIDEAN, SQEUCLIDEAN, COSINE, CITYBLOCK } mode_;
 
  public:
   CDist(const OpKernelInfo& info) : OpKernel(info) {
@@ -104,6 +135,10 @@ class CDist final : public OpKernel {
       mode_ = SQEUCLIDEAN;
     else if (metric.compare("euclidean") == 0) {
       mode_ = EUCLIDEAN;
+    } else if (metric.compare("cosine") == 0) {
+      mode_ = COSINE;
+    } else if (metric.compare("cityblock") == 0) {
+      mode_ = CITYBLOCK;
     } else
       ORT_NOT_IMPLEMENTED();
   }
@@ -131,19 +166,36 @@ class CDist final : public OpKernel {
     TensorShape output_shape = {shape_a[0], shape_b[0]};
     Tensor* C = context->Output(0, output_shape);
     T* output = C->MutableData<T>();
+    if (output_shape.Size() == 0) {
+      return Status::OK();
+    }
+
+    const T* a = A->Data<T>();
+    const T* b = B->Data<T>();
+    const size_t ma = static_cast<size_t>(shape_a[0]);
+    const size_t mb = static_cast<size_t>(shape_b[0]);
+    const size_t n = static_cast<size_t>(shape_a[1]);
     switch (mode_) {
       case EUCLIDEAN:
-        if (shape_a[1] >= 8)
-          cdist<T, EuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+        if (n >= 8)
+          cdist_euclidean_gemm<T>(a, b, output, ma, mb, n, true, tp);
         else  // for smaller vector size, a raw loop is better
-          cdist<T, Euclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+          cdist<T, Euclidean<T> >(a, b, output, ma, mb, n, tp);
         break;
       case SQEUCLIDEAN:
-        if (shape_a[1] >= 8)
-          cdist<T, SqeuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1],
-                                             tp);
+        if (n >= 8)
+          cdist_euclidean_gemm<T>(a, b, output, ma, mb, n, false, tp);
+        else  // for smaller vector size, a raw loop is better
+          cdist<T, Sqeuclidean<T> >(a, b, output, ma, mb, n, tp);
+        break;
+      case COSINE:
+        cdist_cosine_gemm<T>(a, b, output, ma, mb, n, tp);
+        break;
+      case CITYBLOCK:
+        if (n >= 8)
+          cdist<T, CityblockWithEigen<T> >(a, b, output, ma, mb, n, tp);
         else  // for smaller vector size, a raw loop is better
-          cdist<T, Sqeuclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+          cdist<T, Cityblock<T> >(a, b, output, ma, mb, n, tp);
         break;
       default:
         return Status(ONNXRUNTIME, NOT_IMPLEMENTED);
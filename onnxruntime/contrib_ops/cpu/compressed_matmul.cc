@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/compressed_matmul.h"
+
+#include <algorithm>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    CompressedMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<MLFloat16>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    CompressedMatMul);
+
+CompressedMatMul::CompressedMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+  alpha_ = info.GetAttrOrDefault<float>("alpha", 1.f);
+  beta_ = info.GetAttrOrDefault<float>("beta", 1.f);
+  scale_ = info.GetAttrOrDefault<float>("scale", 1.f);
+}
+
+Status CompressedMatMul::Compute(OpKernelContext* context) const {
+  const Tensor* A = context->Input<Tensor>(0);
+  const Tensor* B = context->Input<Tensor>(1);
+  const Tensor* C = context->Input<Tensor>(2);
+  const auto& A_shape = A->Shape();
+  const auto& B_shape = B->Shape();
+  const size_t rank = A_shape.NumDimensions();
+  if (B_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "B must be 2-D. B shape: ", B_shape);
+  }
+
+  const int64_t K = trans_b_ ? B_shape[1] : B_shape[0];
+  const int64_t N = trans_b_ ? B_shape[0] : B_shape[1];
+  if (rank < 1 || A_shape[rank - 1] != K) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The last dimension of A must be ", K,
+                           ". A shape: ", A_shape);
+  }
+  if (C != nullptr && C->Shape().Size() != 1 && C->Shape().Size() != N) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "C must hold a single value or ", N,
+                           " values. C shape: ", C->Shape());
+  }
+
+  std::vector<int64_t> Y_dims(A_shape.GetDims());
+  Y_dims.back() = N;
+  Tensor* Y = context->Output(0, Y_dims);
+
+  const int64_t M = A_shape.SizeToDimension(rank - 1);
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // the output starts from the bias, which the product accumulates into
+  float* Y_data = Y->MutableData<float>();
+  if (C == nullptr) {
+    std::fill_n(Y_data, M * N, 0.f);
+  } else if (C->Shape().Size() == 1) {
+    std::fill_n(Y_data, M * N, beta_ * *C->Data<float>());
+  } else {
+    const float* C_data = C->Data<float>();
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        Y_data[m * N + n] = beta_ * C_data[n];
+      }
+    }
+  }
+
+  // the integers of an int8 weight are multiplied by its scale through alpha
+  const bool is_int8 = B->DataType() == DataTypeImpl::GetType<int8_t>();
+  MlasSgemmCompressedB(CblasNoTrans, trans_b_ ? CblasTrans : CblasNoTrans,
+                       static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                       alpha_ * scale_, A->Data<float>(), static_cast<size_t>(K),
+                       B->DataRaw(), is_int8 ? MlasCompressedInt8 : MlasCompressedHalf,
+                       static_cast<size_t>(B_shape[1]), 1.f, Y_data, static_cast<size_t>(N),
+                       static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
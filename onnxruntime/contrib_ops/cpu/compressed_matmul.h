@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Multiplies its input with a weight stored in float16, or in int8 with a scale. MLAS expands the weight to float
+// a panel at a time while it packs it, so the weight stays at its compressed size in memory.
+class CompressedMatMul final : public OpKernel {
+ public:
+  explicit CompressedMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool trans_b_;
+  float alpha_;
+  float beta_;
+  float scale_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
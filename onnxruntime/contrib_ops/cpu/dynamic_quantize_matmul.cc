@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/dynamic_quantize_matmul.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeMatMul);
+
+DynamicQuantizeMatMul::DynamicQuantizeMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  const Tensor* b;
+  if (info.TryGetConstantInput(1, &b)) {
+    QGemmPackBu8(*b, info.GetAllocator(0, OrtMemTypeDefault), packed_b_);
+  }
+}
+
+Status DynamicQuantizeMatMul::Compute(OpKernelContext* context) const {
+  const Tensor* a = context->Input<Tensor>(0);
+  const Tensor* b = context->Input<Tensor>(1);
+  const Tensor* b_scale = context->Input<Tensor>(2);
+  const Tensor* b_zero_point = context->Input<Tensor>(3);
+  const Tensor* bias = context->Input<Tensor>(4);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  const int64_t N = helper.N();
+  const bool per_column_scale = !IsScalarOr1ElementVector(b_scale);
+  ORT_RETURN_IF_NOT(!per_column_scale || (b_scale->Shape().NumDimensions() == 1 && b_scale->Shape()[0] == N),
+                    "DynamicQuantizeMatMul : b_scale must be a scalar or 1D tensor of size 1 or of the number of "
+                    "columns of B");
+  // a zero point per column of B is applied after the multiply, which runs with a zero point of 0 for B
+  uint8_t b_offset = 0;
+  const uint8_t* b_offsets = nullptr;
+  if (b_zero_point != nullptr) {
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      b_offset = *b_zero_point->Data<uint8_t>();
+    } else {
+      ORT_RETURN_IF_NOT(b_zero_point->Shape().NumDimensions() == 1 && b_zero_point->Shape()[0] == N,
+                        "DynamicQuantizeMatMul : b_zero_point must be a scalar or 1D tensor of size 1 or of the "
+                        "number of columns of B");
+      b_offsets = b_zero_point->Data<uint8_t>();
+    }
+  }
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().NumDimensions() == 1 && bias->Shape()[0] == N,
+                      "DynamicQuantizeMatMul : bias must be a 1D tensor with one value per column of B");
+  }
+
+  Tensor* y = context->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  const int64_t K = helper.K();
+  const int64_t a_rows = K == 0 ? 0 : a->Shape().Size() / K;
+  auto a_quantized = IAllocator::MakeUniquePtr<uint8_t>(alloc, static_cast<size_t>(a->Shape().Size()));
+  float a_scale;
+  uint8_t a_offset;
+  DynamicQuantizeu8(static_cast<int>(a_rows), static_cast<int>(K), a->Data<float>(), static_cast<int>(K),
+                    a_quantized.get(), a_scale, a_offset);
+
+  // the int32 products are written to Y, which has the same size, and converted to float in place
+  static_assert(sizeof(int32_t) == sizeof(float), "The int32 products must fit in the float output");
+  float* y_data = y->MutableData<float>();
+  int32_t* products = reinterpret_cast<int32_t*>(y_data);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  const int M = static_cast<int>(helper.M());
+  size_t left_stride, right_stride, output_stride;
+  if (!packed_b_ && helper.BatchStrides(left_stride, right_stride, output_stride)) {
+    QGemmBatchu8u8_s32(M, static_cast<int>(N), static_cast<int>(K), a_quantized.get(), left_stride, a_offset,
+                       b->Data<uint8_t>(), right_stride, b_offset, products, output_stride,
+                       helper.OutputOffsets().size(), tp);
+  } else {
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      if (packed_b_) {
+        QGemmu8u8_s32(M, static_cast<int>(N), static_cast<int>(K), a_quantized.get() + helper.LeftOffsets()[i],
+                      static_cast<int>(K), a_offset, packed_b_.get(), b_offset,
+                      products + helper.OutputOffsets()[i], static_cast<int>(N), tp);
+      } else {
+        QGemmu8u8_s32(M, static_cast<int>(N), static_cast<int>(K), a_quantized.get() + helper.LeftOffsets()[i],
+                      static_cast<int>(K), a_offset, b->Data<uint8_t>() + helper.RightOffsets()[i],
+                      static_cast<int>(N), b_offset, products + helper.OutputOffsets()[i], static_cast<int>(N), tp);
+      }
+    }
+  }
+
+  if (b_offsets != nullptr) {
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      QGemmApplyColumnOffsets(M, static_cast<int>(N), static_cast<int>(K), a_quantized.get() + helper.LeftOffsets()[i],
+                              static_cast<int>(K), a_offset, b_offsets, products + helper.OutputOffsets()[i],
+                              static_cast<int>(N));
+    }
+  }
+
+  // Y = A_scale * B_scale * (A - A_zero_point) * (B - B_zero_point) + bias, a row at a time, with the scale of B
+  // given for each column or for all of them
+  std::vector<float> multipliers(static_cast<size_t>(N), a_scale * *b_scale->Data<float>());
+  if (per_column_scale) {
+    const float* b_scale_data = b_scale->Data<float>();
+    for (int64_t n = 0; n < N; ++n) {
+      multipliers[n] = a_scale * b_scale_data[n];
+    }
+  }
+  ConstEigenVectorMap<float> multipliers_vector(multipliers.data(), N);
+  const int64_t y_rows = y->Shape().Size() / N;
+  for (int64_t row = 0; row < y_rows; ++row) {
+    EigenVectorMap<float> y_row(y_data + row * N, N);
+    auto scaled = ConstEigenVectorMap<int32_t>(products + row * N, N).cast<float>().cwiseProduct(multipliers_vector);
+    if (bias != nullptr) {
+      y_row = scaled + ConstEigenVectorMap<float>(bias->Data<float>(), N);
+    } else {
+      y_row = scaled;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul of a float A quantized at run time with a uint8 B, scaled back to float with an optional bias.
+class DynamicQuantizeMatMul final : public OpKernel {
+ public:
+  explicit DynamicQuantizeMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // a constant B is packed once here instead of on every Compute
+  BufferUniquePtr packed_b_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/dynamic_quantize_rnn.h"
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using rnn::detail::GemmWeights;
+
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicQuantizeLSTM,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeLSTM);
+
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicQuantizeGRU,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeGRU);
+
+namespace {
+
+// the scale and zero point of W or R hold a value per direction
+Status ValidateQuantizationParameters(const Tensor* scale, const Tensor* zero_point, int num_directions,
+                                      const char* name) {
+  if (scale == nullptr || scale->Shape().NumDimensions() != 1 || scale->Shape()[0] != num_directions) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name, "_scale must have shape {",
+                           num_directions, "}");
+  }
+  if (zero_point == nullptr || zero_point->Shape().NumDimensions() != 1 ||
+      zero_point->Shape()[0] != num_directions) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name, "_zero_point must have shape {",
+                           num_directions, "}");
+  }
+  return Status::OK();
+}
+
+// Gets the inputs W, R and their scales and zero points if they are all constant, with the shapes of the operator
+bool TryGetConstantWeights(const OpKernelInfo& info, int scale_index, int num_directions, int64_t rows,
+                           int64_t hidden_size, const Tensor*& W, const Tensor*& R, const Tensor* parameters[4]) {
+  if (!info.TryGetConstantInput(1, &W) || !info.TryGetConstantInput(2, &R)) {
+    return false;
+  }
+  for (int i = 0; i < 4; ++i) {
+    if (!info.TryGetConstantInput(scale_index + i, &parameters[i])) {
+      return false;
+    }
+  }
+
+  // a bad shape is left to Compute
+  const auto& W_shape = W->Shape();
+  const auto& R_shape = R->Shape();
+  return W_shape.NumDimensions() == 3 && W_shape[0] == num_directions && W_shape[1] == rows &&
+         R_shape.NumDimensions() == 3 && R_shape[0] == num_directions && R_shape[1] == rows &&
+         R_shape[2] == hidden_size &&
+         ValidateQuantizationParameters(parameters[0], parameters[1], num_directions, "W").IsOK() &&
+         ValidateQuantizationParameters(parameters[2], parameters[3], num_directions, "R").IsOK();
+}
+
+// Prepares N rows starting at row of the given direction of the uint8 weights, shaped [num_directions, rows, K]
+GemmWeights PrepareWeights(const AllocatorPtr& alloc, const Tensor& weights, const Tensor& scale,
+                           const Tensor& zero_point, int direction, int row, int N, BufferUniquePtr& buffer) {
+  const auto& shape = weights.Shape();
+  const int K = gsl::narrow<int>(shape[2]);
+  const uint8_t* data = weights.Data<uint8_t>() + (direction * shape[1] + row) * K;
+  return rnn::detail::QuantizeGemmWeights(alloc, N, K, data, scale.Data<float>()[direction],
+                                          zero_point.Data<uint8_t>()[direction], buffer);
+}
+
+}  // namespace
+
+DynamicQuantizeLSTM::DynamicQuantizeLSTM(const OpKernelInfo& info) : DeepCpuLstmOp(info) {
+  const Tensor* W;
+  const Tensor* R;
+  const Tensor* parameters[4];
+  if (!TryGetConstantWeights(info, 8, num_directions_, 4 * hidden_size_, hidden_size_, W, R, parameters)) {
+    return;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  for (int i = 0; i < num_directions_; ++i) {
+    input_weights_[i] = PrepareWeights(alloc, *W, *parameters[0], *parameters[1], i, 0, 4 * hidden_size_,
+                                       weights_buffers_[2 * i]);
+    recurrent_weights_[i] = PrepareWeights(alloc, *R, *parameters[2], *parameters[3], i, 0, 4 * hidden_size_,
+                                           weights_buffers_[2 * i + 1]);
+  }
+  weights_prepared_ = true;
+}
+
+Status DynamicQuantizeLSTM::Compute(OpKernelContext* context) const {
+  ORT_RETURN_IF_ERROR(ValidateInputs(*context));
+
+  // W_scale, W_zero_point, R_scale, R_zero_point
+  const Tensor* parameters[4];
+  for (int i = 0; i < 4; ++i) {
+    parameters[i] = context->Input<Tensor>(8 + i);
+  }
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(parameters[0], parameters[1], num_directions_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(parameters[2], parameters[3], num_directions_, "R"));
+
+  if (weights_prepared_) {
+    return ComputeWithWeights(*context, input_weights_, recurrent_weights_);
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  const Tensor& W = *context->Input<Tensor>(1);
+  const Tensor& R = *context->Input<Tensor>(2);
+  GemmWeights input_weights[2];
+  GemmWeights recurrent_weights[2];
+  BufferUniquePtr weights_buffers[4];
+  for (int i = 0; i < num_directions_; ++i) {
+    input_weights[i] = PrepareWeights(alloc, W, *parameters[0], *parameters[1], i, 0, 4 * hidden_size_,
+                                      weights_buffers[2 * i]);
+    recurrent_weights[i] = PrepareWeights(alloc, R, *parameters[2], *parameters[3], i, 0, 4 * hidden_size_,
+                                          weights_buffers[2 * i + 1]);
+  }
+
+  return ComputeWithWeights(*context, input_weights, recurrent_weights);
+}
+
+DynamicQuantizeGRU::DynamicQuantizeGRU(const OpKernelInfo& info) : DeepCpuGruOp(info) {
+  const Tensor* W;
+  const Tensor* R;
+  const Tensor* parameters[4];
+  if (!TryGetConstantWeights(info, 6, num_directions_, 3 * hidden_size_, hidden_size_, W, R, parameters)) {
+    return;
+  }
+
+  // R[h] follows R[zr] in R
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  for (int i = 0; i < num_directions_; ++i) {
+    input_weights_[i] = PrepareWeights(alloc, *W, *parameters[0], *parameters[1], i, 0, 3 * hidden_size_,
+                                       weights_buffers_[3 * i]);
+    recurrent_weights_zr_[i] = PrepareWeights(alloc, *R, *parameters[2], *parameters[3], i, 0, 2 * hidden_size_,
+                                              weights_buffers_[3 * i + 1]);
+    recurrent_weights_h_[i] = PrepareWeights(alloc, *R, *parameters[2], *parameters[3], i, 2 * hidden_size_,
+                                             hidden_size_, weights_buffers_[3 * i + 2]);
+  }
+  weights_prepared_ = true;
+}
+
+Status DynamicQuantizeGRU::Compute(OpKernelContext* context) const {
+  ORT_RETURN_IF_ERROR(ValidateInputs(*context));
+
+  // W_scale, W_zero_point, R_scale, R_zero_point
+  const Tensor* parameters[4];
+  for (int i = 0; i < 4; ++i) {
+    parameters[i] = context->Input<Tensor>(6 + i);
+  }
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(parameters[0], parameters[1], num_directions_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(parameters[2], parameters[3], num_directions_, "R"));
+
+  if (weights_prepared_) {
+    return ComputeWithWeights(*context, input_weights_, recurrent_weights_zr_, recurrent_weights_h_);
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  const Tensor& W = *context->Input<Tensor>(1);
+  const Tensor& R = *context->Input<Tensor>(2);
+  GemmWeights input_weights[2];
+  GemmWeights recurrent_weights_zr[2];
+  GemmWeights recurrent_weights_h[2];
+  BufferUniquePtr weights_buffers[6];
+  for (int i = 0; i < num_directions_; ++i) {
+    input_weights[i] = PrepareWeights(alloc, W, *parameters[0], *parameters[1], i, 0, 3 * hidden_size_,
+                                      weights_buffers[3 * i]);
+    recurrent_weights_zr[i] = PrepareWeights(alloc, R, *parameters[2], *parameters[3], i, 0, 2 * hidden_size_,
+                                             weights_buffers[3 * i + 1]);
+    recurrent_weights_h[i] = PrepareWeights(alloc, R, *parameters[2], *parameters[3], i, 2 * hidden_size_,
+                                            hidden_size_, weights_buffers[3 * i + 2]);
+  }
+
+  return ComputeWithWeights(*context, input_weights, recurrent_weights_zr, recurrent_weights_h);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/allocator.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/rnn/deep_cpu_gru.h"
+#include "core/providers/cpu/rnn/deep_cpu_lstm.h"
+#include "core/providers/cpu/rnn/rnn_helpers.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// LSTM with the weights W and R quantized to uint8 with a scale and zero point per direction. The inputs of each
+// GEMM are quantized on the fly, so the GEMMs run on integers.
+class DynamicQuantizeLSTM final : public DeepCpuLstmOp {
+ public:
+  DynamicQuantizeLSTM(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // W and R of each direction, prepared once if they are constant along with their scales and zero points
+  bool weights_prepared_ = false;
+  rnn::detail::GemmWeights input_weights_[2];
+  rnn::detail::GemmWeights recurrent_weights_[2];
+  BufferUniquePtr weights_buffers_[4];
+};
+
+// GRU with the weights W and R quantized to uint8 with a scale and zero point per direction, see DynamicQuantizeLSTM.
+class DynamicQuantizeGRU final : public DeepCpuGruOp {
+ public:
+  DynamicQuantizeGRU(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // W, R[zr] and R[h] of each direction, prepared once if they are constant along with their scales and zero points
+  bool weights_prepared_ = false;
+  rnn::detail::GemmWeights input_weights_[2];
+  rnn::detail::GemmWeights recurrent_weights_zr_[2];
+  rnn::detail::GemmWeights recurrent_weights_h_[2];
+  BufferUniquePtr weights_buffers_[6];
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
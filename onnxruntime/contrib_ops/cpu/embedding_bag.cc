@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+// smallest number of gathered elements accumulated by a task
+constexpr int64_t kMinEmbeddingBagElementsPerTask = 32768;
+
+EmbeddingBag::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag mode must be 'sum' or 'mean', got ", mode);
+  mean_ = mode == "mean";
+}
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  if (context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>()) {
+    return ComputeImpl<int32_t>(context);
+  }
+  return ComputeImpl<int64_t>(context);
+}
+
+template <typename Tind>
+Status EmbeddingBag::ComputeImpl(OpKernelContext* context) const {
+  const Tensor* data = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* weights = context->Input<Tensor>(3);
+
+  const TensorShape& data_shape = data->Shape();
+  const TensorShape& indices_shape = indices->Shape();
+  if (data_shape.NumDimensions() < 1 || indices_shape.NumDimensions() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data and indices must have a rank of at least 1, got ",
+                           data_shape, " and ", indices_shape);
+  }
+
+  const int64_t num_rows = data_shape[0];
+  const int64_t row_size = data_shape.SizeFromDimension(1);
+  const int64_t num_indices = indices_shape.Size();
+  const Tind* indices_data = indices->Data<Tind>();
+
+  std::vector<int64_t> output_dims;
+  int64_t num_bags;
+  int64_t bag_length = 0;
+  const Tind* offsets_data = nullptr;
+  if (offsets != nullptr) {
+    if (indices_shape.NumDimensions() != 1 || offsets->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices and offsets must be 1-D, got ",
+                             indices_shape, " and ", offsets->Shape());
+    }
+    num_bags = offsets->Shape()[0];
+    offsets_data = offsets->Data<Tind>();
+    for (int64_t b = 0; b < num_bags; ++b) {
+      const Tind limit = b + 1 < num_bags ? offsets_data[b + 1] : static_cast<Tind>(num_indices);
+      if (offsets_data[b] < 0 || offsets_data[b] > limit) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "offsets must be increasing and within indices, offset=",
+                               offsets_data[b], " at bag ", b);
+      }
+    }
+    output_dims.push_back(num_bags);
+  } else {
+    const size_t bag_axis = indices_shape.NumDimensions() - 1;
+    num_bags = indices_shape.SizeToDimension(bag_axis);
+    bag_length = indices_shape[bag_axis];
+    output_dims.assign(indices_shape.GetDims().begin(), indices_shape.GetDims().begin() + bag_axis);
+  }
+
+  const float* weights_data = nullptr;
+  if (weights != nullptr) {
+    if (weights->Shape().Size() != num_indices) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "per_sample_weights with shape ", weights->Shape(),
+                             " must have as many elements as indices with shape ", indices_shape);
+    }
+    weights_data = weights->Data<float>();
+  }
+
+  // Check the indices first so the accumulation below can't fail.
+  for (int64_t i = 0; i < num_indices; ++i) {
+    if (indices_data[i] < 0 || indices_data[i] >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=",
+                             indices_data[i], " data_dim=", num_rows);
+    }
+  }
+
+  const auto& data_dims = data_shape.GetDims();
+  output_dims.insert(output_dims.end(), data_dims.begin() + 1, data_dims.end());
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+
+  const float* table = data->Data<float>();
+  float* output_data = output->MutableData<float>();
+
+  auto compute_bags = [&](int64_t first_bag, int64_t last_bag) {
+    for (int64_t b = first_bag; b < last_bag; ++b) {
+      int64_t begin, end;
+      if (offsets_data != nullptr) {
+        begin = offsets_data[b];
+        end = b + 1 < num_bags ? offsets_data[b + 1] : num_indices;
+      } else {
+        begin = b * bag_length;
+        end = begin + bag_length;
+      }
+
+      EigenVectorArrayMap<float> bag(output_data + b * row_size, row_size);
+      bag.setZero();
+      for (int64_t i = begin; i < end; ++i) {
+        ConstEigenVectorArrayMap<float> row(table + indices_data[i] * row_size, row_size);
+        if (weights_data != nullptr) {
+          bag += row * weights_data[i];
+        } else {
+          bag += row;
+        }
+      }
+      if (mean_ && end > begin) {
+        bag /= static_cast<float>(end - begin);
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(num_bags, num_indices * row_size / kMinEmbeddingBagElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_bags(0, num_bags);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      compute_bags(num_bags * task / num_tasks, num_bags * (task + 1) / num_tasks);
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Sums or averages bags of rows looked up from a table, accumulating each row into the output of its
+// bag directly instead of gathering all the rows into an intermediate tensor first.
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(OpKernelContext* context) const;
+
+  bool mean_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -11,6 +11,7 @@ class FusedConvFloat final : public Conv<float> {
  public:
   FusedConvFloat(const OpKernelInfo& info) : Conv<float>(info) {
     ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+    ORT_ENFORCE(info.GetInputCount() < 4, "The Z input of FusedConv is only supported by the CUDA kernel.");
   }
 };
 
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "contrib_ops/cpu/fused_elementwise.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedElementwise,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// number of elements carried through the whole chain at a time
+constexpr int64_t kFusedElementwiseBlockSize = 512;
+
+// smallest number of elements computed by a task
+constexpr int64_t kMinFusedElementwiseElementsPerTask = 16384;
+
+using ElementwiseOp = FusedElementwise::ElementwiseOp;
+
+bool IsBinaryOp(ElementwiseOp op) {
+  return op == ElementwiseOp::Add || op == ElementwiseOp::Sub || op == ElementwiseOp::Mul || op == ElementwiseOp::Div;
+}
+
+template <typename Op>
+void ApplyBinary(const float* input, const float* operand, bool scalar_operand, float* output, int64_t count, Op op) {
+  if (scalar_operand) {
+    const float b = *operand;
+    for (int64_t i = 0; i < count; i++) {
+      output[i] = op(input[i], b);
+    }
+  } else {
+    for (int64_t i = 0; i < count; i++) {
+      output[i] = op(input[i], operand[i]);
+    }
+  }
+}
+
+template <typename Op>
+void ApplyUnary(const float* input, float* output, int64_t count, Op op) {
+  for (int64_t i = 0; i < count; i++) {
+    output[i] = op(input[i]);
+  }
+}
+
+// Applies op to count elements of input, which may alias output.
+void ApplyOp(ElementwiseOp op, const float* input, const float* operand, bool scalar_operand, float* output,
+             int64_t count) {
+  switch (op) {
+    case ElementwiseOp::Add:
+      ApplyBinary(input, operand, scalar_operand, output, count, [](float a, float b) { return a + b; });
+      break;
+    case ElementwiseOp::Sub:
+      ApplyBinary(input, operand, scalar_operand, output, count, [](float a, float b) { return a - b; });
+      break;
+    case ElementwiseOp::Mul:
+      ApplyBinary(input, operand, scalar_operand, output, count, [](float a, float b) { return a * b; });
+      break;
+    case ElementwiseOp::Div:
+      ApplyBinary(input, operand, scalar_operand, output, count, [](float a, float b) { return a / b; });
+      break;
+    case ElementwiseOp::Relu:
+      ApplyUnary(input, output, count, [](float a) { return std::max(a, 0.0f); });
+      break;
+    case ElementwiseOp::Sigmoid:
+      MlasComputeLogistic(input, output, static_cast<size_t>(count));
+      break;
+    case ElementwiseOp::Tanh:
+      MlasComputeTanh(input, output, static_cast<size_t>(count));
+      break;
+    case ElementwiseOp::Exp:
+      MlasComputeExp(input, output, static_cast<size_t>(count));
+      break;
+    case ElementwiseOp::Neg:
+      ApplyUnary(input, output, count, [](float a) { return -a; });
+      break;
+    case ElementwiseOp::Abs:
+      ApplyUnary(input, output, count, [](float a) { return std::abs(a); });
+      break;
+    case ElementwiseOp::Sqrt:
+      ApplyUnary(input, output, count, [](float a) { return std::sqrt(a); });
+      break;
+  }
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  static const std::unordered_map<std::string, ElementwiseOp> op_names = {
+      {"Add", ElementwiseOp::Add},
+      {"Sub", ElementwiseOp::Sub},
+      {"Mul", ElementwiseOp::Mul},
+      {"Div", ElementwiseOp::Div},
+      {"Relu", ElementwiseOp::Relu},
+      {"Sigmoid", ElementwiseOp::Sigmoid},
+      {"Tanh", ElementwiseOp::Tanh},
+      {"Exp", ElementwiseOp::Exp},
+      {"Neg", ElementwiseOp::Neg},
+      {"Abs", ElementwiseOp::Abs},
+      {"Sqrt", ElementwiseOp::Sqrt},
+  };
+
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK(), "FusedElementwise requires the ops attribute.");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one operator.");
+
+  for (const auto& name : ops) {
+    auto it = op_names.find(name);
+    ORT_ENFORCE(it != op_names.end(), "FusedElementwise does not support operator ", name);
+    ops_.push_back(it->second);
+    if (IsBinaryOp(it->second)) {
+      binary_op_count_++;
+    }
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const int64_t size = X->Shape().Size();
+
+  if (static_cast<size_t>(context->InputCount()) != binary_op_count_ + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise expects ", binary_op_count_ + 1,
+                           " inputs but got ", context->InputCount());
+  }
+
+  std::vector<const float*> operands;
+  std::vector<bool> scalar_operands;
+  for (size_t i = 1; i <= binary_op_count_; i++) {
+    const Tensor* operand = context->Input<Tensor>(static_cast<int>(i));
+    const int64_t operand_size = operand->Shape().Size();
+    if (operand_size != size && operand_size != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise input ", i, " with shape ",
+                             operand->Shape(), " is neither a scalar nor the shape of the first input ", X->Shape());
+    }
+    operands.push_back(operand->Data<float>());
+    scalar_operands.push_back(operand_size == 1);
+  }
+
+  const float* x_data = X->Data<float>();
+  float* y_data = context->Output(0, X->Shape())->MutableData<float>();
+
+  // Carries each block through the whole chain: the first operator reads the input and every
+  // operator after it updates the output block in place while it is still in the cache.
+  auto compute_range = [&](int64_t first, int64_t last) {
+    for (int64_t start = first; start < last; start += kFusedElementwiseBlockSize) {
+      const int64_t count = std::min(kFusedElementwiseBlockSize, last - start);
+      const float* input = x_data + start;
+      float* output = y_data + start;
+      size_t operand_index = 0;
+      for (auto op : ops_) {
+        const float* operand = nullptr;
+        bool scalar_operand = false;
+        if (IsBinaryOp(op)) {
+          scalar_operand = scalar_operands[operand_index];
+          operand = operands[operand_index] + (scalar_operand ? 0 : start);
+          operand_index++;
+        }
+        ApplyOp(op, input, operand, scalar_operand, output, count);
+        input = output;
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_tasks = size / kMinFusedElementwiseElementsPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_range(0, size);
+  } else {
+    const int64_t num_blocks = (size + kFusedElementwiseBlockSize - 1) / kFusedElementwiseBlockSize;
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      const int64_t first = num_blocks * task / num_tasks * kFusedElementwiseBlockSize;
+      const int64_t last = std::min(num_blocks * (task + 1) / num_tasks * kFusedElementwiseBlockSize, size);
+      compute_range(first, last);
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
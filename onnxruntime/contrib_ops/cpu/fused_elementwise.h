@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Applies a chain of element-wise operators block by block, so each intermediate value stays in
+// the cache instead of being written to a full size tensor between operators.
+class FusedElementwise final : public OpKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class ElementwiseOp {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Relu,
+    Sigmoid,
+    Tanh,
+    Exp,
+    Neg,
+    Abs,
+    Sqrt,
+  };
+
+ private:
+  std::vector<ElementwiseOp> ops_;
+  size_t binary_op_count_{0};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
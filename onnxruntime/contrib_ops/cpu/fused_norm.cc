@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/nn/batch_norm.h"
+#include "core/providers/cpu/nn/instance_norm.h"
+#include "contrib_ops/cpu/fused_activation.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class FusedBatchNormFloat final : public BatchNorm<float> {
+ public:
+  FusedBatchNormFloat(const OpKernelInfo& info) : BatchNorm<float>(info) {
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+};
+
+class FusedInstanceNormFloat final : public InstanceNorm<float> {
+ public:
+  FusedInstanceNormFloat(const OpKernelInfo& info) : InstanceNorm<float>(info) {
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+};
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedBatchNormalization,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedBatchNormFloat);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedInstanceNormalization,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedInstanceNormFloat);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "contrib_ops/cpu/gather_nd.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace contrib     {
@@ -45,9 +46,6 @@ Status GatherNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) con
   auto output_tensor = context->Output(0,TensorShape(shape));
   std::vector<int64_t> element_counts(last_indice_dimension, 0LL); // Number of elements for each input dimension
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
   for (int64_t i = 0; i < last_indice_dimension; ++i) {
     element_counts[i] = input_shape.SizeFromDimension(i + 1);
 }
@@ -68,9 +66,6 @@ Status GatherNDBase::PrepareForCompute(OpKernelContext* context, Prepare& p) con
     p.output_base     = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
   for (int64_t i = 0; i < offset_count; ++i) {
     for (int64_t j = 0; j < last_indice_dimension; ++j) {
       auto indice = *(indice_offset + i * last_indice_dimension + j);
@@ -90,34 +85,53 @@ template Status GatherNDBase::PrepareForCompute<int64_t>(OpKernelContext*, Prepa
 
 Status GatherND::Compute(OpKernelContext* context) const {
   Prepare p;
-  ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ? 
+  ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ?
                               PrepareForCompute<int32_t>(context, p) : PrepareForCompute<int64_t>(context, p));
 
-  return nullptr == p.input_str_base ? GatherNumber(p) : GatherString(p);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
-Status GatherND::GatherNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + i * p.bytes_to_copy,
-           p.input_base + p.element_offsets[i] * p.element_bytes,
-           p.bytes_to_copy);
+// Splits the slices across the threads of tp, with at least kMinGatherNDBytesPerTask bytes per task.
+template <typename CopyFn>
+static void GatherNDParallelFor(int64_t slice_count, uint64_t slice_bytes, concurrency::ThreadPool* tp, CopyFn copy) {
+  constexpr int64_t kMinGatherNDBytesPerTask = 32768;
+  int64_t num_tasks = slice_count * static_cast<int64_t>(slice_bytes) / kMinGatherNDBytesPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
   }
 
+  if (tp == nullptr || num_tasks <= 1) {
+    copy(0, slice_count);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      copy(slice_count * task / num_tasks, slice_count * (task + 1) / num_tasks);
+    });
+  }
+}
+
+Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
+  GatherNDParallelFor(static_cast<int64_t>(p.element_offsets.size()), p.bytes_to_copy, tp,
+                      [&p](int64_t first, int64_t last) {
+                        for (int64_t i = first; i < last; ++i) {
+                          memcpy(p.output_base + i * p.bytes_to_copy,
+                                 p.input_base + p.element_offsets[i] * p.element_bytes,
+                                 p.bytes_to_copy);
+                        }
+                      });
+
   return Status::OK();
 }
 
-Status GatherND::GatherString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
-    }
-  }
+Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) const {
+  GatherNDParallelFor(static_cast<int64_t>(p.element_offsets.size()), p.element_to_copy * sizeof(std::string), tp,
+                      [&p](int64_t first, int64_t last) {
+                        for (int64_t i = first; i < last; ++i) {
+                          for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
+                            p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+                          }
+                        }
+                      });
 
   return Status::OK();
 }
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/gelu.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Gelu,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
+    Gelu);
+
+// number of elements carried through erf and the final product at a time
+constexpr int64_t kGeluBlockSize = 512;
+
+// smallest number of elements computed by a task
+constexpr int64_t kMinGeluElementsPerTask = 16384;
+
+constexpr float kSqrtHalf = 0.70710678118654752440f;
+
+Status Gelu::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const int64_t size = X->Shape().Size();
+  const float* x_data = X->Data<float>();
+  float* y_data = context->Output(0, X->Shape())->MutableData<float>();
+
+  auto compute_range = [&](int64_t first, int64_t last) {
+    float erf_buffer[kGeluBlockSize];
+    for (int64_t start = first; start < last; start += kGeluBlockSize) {
+      const int64_t count = std::min(kGeluBlockSize, last - start);
+      const float* x = x_data + start;
+      float* y = y_data + start;
+      for (int64_t i = 0; i < count; i++) {
+        erf_buffer[i] = x[i] * kSqrtHalf;
+      }
+      MlasComputeErf(erf_buffer, erf_buffer, static_cast<size_t>(count));
+      for (int64_t i = 0; i < count; i++) {
+        y[i] = 0.5f * x[i] * (1.0f + erf_buffer[i]);
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_tasks = size / kMinGeluElementsPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_range(0, size);
+  } else {
+    const int64_t num_blocks = (size + kGeluBlockSize - 1) / kGeluBlockSize;
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      const int64_t first = num_blocks * task / num_tasks * kGeluBlockSize;
+      const int64_t last = std::min(num_blocks * (task + 1) / num_tasks * kGeluBlockSize, size);
+      compute_range(first, last);
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
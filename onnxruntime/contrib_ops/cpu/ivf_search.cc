@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/ivf_search.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "contrib_ops/cpu/cdist.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    IVFSearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<uint8_t>()}),
+    IVFSearch);
+
+// the number of centroids of the codebook of each subvector
+static constexpr int64_t kNumCodes = 256;
+
+IVFSearch::IVFSearch(const OpKernelInfo& info) : OpKernel(info) {
+  ORT_ENFORCE(info.GetAttr<int64_t>("k", &k_).IsOK() && k_ > 0, "k must be positive");
+  nprobe_ = info.GetAttrOrDefault<int64_t>("nprobe", 1);
+  ORT_ENFORCE(nprobe_ > 0, "nprobe must be positive");
+}
+
+Status IVFSearch::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* centroids = context->Input<Tensor>(1);
+  const Tensor* list_offsets = context->Input<Tensor>(2);
+  const Tensor* ids = context->Input<Tensor>(3);
+  const Tensor* vectors = context->Input<Tensor>(4);
+  const Tensor* codebooks = context->Input<Tensor>(5);
+
+  const auto& x_shape = X->Shape();
+  const auto& centroids_shape = centroids->Shape();
+  const auto& vectors_shape = vectors->Shape();
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() == 2, "X must be 2D: ", x_shape);
+  ORT_RETURN_IF_NOT(centroids_shape.NumDimensions() == 2 && centroids_shape[1] == x_shape[1],
+                    "centroids must have a shape of (L, D): ", centroids_shape);
+  const int64_t num_queries = x_shape[0];
+  const int64_t dim = x_shape[1];
+  const int64_t num_lists = centroids_shape[0];
+  ORT_RETURN_IF_NOT(list_offsets->Shape().NumDimensions() == 1 && list_offsets->Shape()[0] == num_lists + 1,
+                    "list_offsets must have L + 1 values");
+  ORT_RETURN_IF_NOT(ids->Shape().NumDimensions() == 1, "ids must be 1D");
+  const int64_t num_vectors = ids->Shape()[0];
+  ORT_RETURN_IF_NOT(vectors_shape.NumDimensions() == 2 && vectors_shape[0] == num_vectors,
+                    "vectors must have one row per id: ", vectors_shape);
+
+  const bool is_pq = vectors->DataType() == DataTypeImpl::GetType<uint8_t>();
+  int64_t num_subvectors = 0;
+  int64_t subvector_dim = 0;
+  if (is_pq) {
+    ORT_RETURN_IF_NOT(codebooks != nullptr, "codebooks are required for vectors of codes");
+    num_subvectors = vectors_shape[1];
+    ORT_RETURN_IF_NOT(num_subvectors > 0 && dim % num_subvectors == 0,
+                      "The number of codes of a vector must divide D: ", vectors_shape);
+    subvector_dim = dim / num_subvectors;
+    ORT_RETURN_IF_NOT(codebooks->Shape() == TensorShape({num_subvectors, kNumCodes, subvector_dim}),
+                      "codebooks must have a shape of (M, 256, D / M): ", codebooks->Shape());
+  } else {
+    ORT_RETURN_IF_NOT(vectors_shape[1] == dim, "vectors must have a shape of (N, D): ", vectors_shape);
+  }
+
+  const int64_t* offsets = list_offsets->Data<int64_t>();
+  for (int64_t l = 0; l < num_lists; ++l) {
+    ORT_RETURN_IF_NOT(0 <= offsets[l] && offsets[l] <= offsets[l + 1] && offsets[l + 1] <= num_vectors,
+                      "list_offsets must be ascending offsets of vectors");
+  }
+
+  const TensorShape output_shape({num_queries, k_});
+  float* distances_data = context->Output(0, output_shape)->MutableData<float>();
+  int64_t* indices_data = context->Output(1, output_shape)->MutableData<int64_t>();
+  if (num_queries == 0) {
+    return Status::OK();
+  }
+
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  const float* x_data = X->Data<float>();
+  const float* centroids_data = centroids->Data<float>();
+  const int64_t* ids_data = ids->Data<int64_t>();
+
+  // the distances of the queries to the centroids select the lists each query searches
+  std::vector<float> coarse_distances(static_cast<size_t>(num_queries * num_lists));
+  if (num_lists > 0) {
+    cdist_euclidean_gemm<float>(x_data, centroids_data, coarse_distances.data(), static_cast<size_t>(num_queries),
+                                static_cast<size_t>(num_lists), static_cast<size_t>(dim), false, tp);
+  }
+
+  const int64_t nprobe = std::min(nprobe_, num_lists);
+  const int64_t k = k_;
+  const double cost_per_query = static_cast<double>(num_vectors * std::max<int64_t>(num_subvectors, dim)) *
+                                static_cast<double>(std::max<int64_t>(nprobe, 1)) /
+                                static_cast<double>(std::max<int64_t>(num_lists, 1));
+
+  ParallelForRows(static_cast<size_t>(num_queries), cost_per_query, tp, [&](size_t begin, size_t end) {
+    std::vector<int64_t> lists(static_cast<size_t>(num_lists));
+    std::vector<float> list_distances;
+    std::vector<float> residual(static_cast<size_t>(dim));
+    std::vector<float> table(static_cast<size_t>(num_subvectors * kNumCodes));
+    // a max heap of the k closest vectors found so far
+    std::vector<std::pair<float, int64_t>> heap;
+    heap.reserve(static_cast<size_t>(k));
+
+    for (size_t q = begin; q != end; ++q) {
+      const float* query = x_data + q * dim;
+      const float* query_coarse = coarse_distances.data() + q * num_lists;
+      std::iota(lists.begin(), lists.end(), int64_t{0});
+      std::partial_sort(lists.begin(), lists.begin() + nprobe, lists.end(), [query_coarse](int64_t a, int64_t b) {
+        return query_coarse[a] < query_coarse[b];
+      });
+
+      heap.clear();
+      for (int64_t p = 0; p < nprobe; ++p) {
+        const int64_t l = lists[p];
+        const int64_t first = offsets[l];
+        const int64_t count = offsets[l + 1] - first;
+        if (count == 0) {
+          continue;
+        }
+
+        list_distances.resize(static_cast<size_t>(count));
+        auto distances = EigenVectorMap<float>(list_distances.data(), count);
+        if (!is_pq) {
+          distances = (ConstEigenMatrixMapRowMajor<float>(vectors->Data<float>() + first * dim, count, dim).rowwise() -
+                       ConstEigenVectorMap<float>(query, dim).transpose())
+                          .rowwise()
+                          .squaredNorm();
+        } else {
+          // The distance to a vector is the sum over its subvectors of the distances of the residual to the
+          // centroids of their codes, which are computed once per list.
+          const float* centroid = centroids_data + l * dim;
+          for (int64_t i = 0; i < dim; ++i) {
+            residual[i] = query[i] - centroid[i];
+          }
+          const float* codebooks_data = codebooks->Data<float>();
+          for (int64_t m = 0; m < num_subvectors; ++m) {
+            EigenVectorMap<float>(table.data() + m * kNumCodes, kNumCodes) =
+                (ConstEigenMatrixMapRowMajor<float>(codebooks_data + m * kNumCodes * subvector_dim, kNumCodes,
+                                                    subvector_dim)
+                     .rowwise() -
+                 ConstEigenVectorMap<float>(residual.data() + m * subvector_dim, subvector_dim).transpose())
+                    .rowwise()
+                    .squaredNorm();
+          }
+          const uint8_t* codes = vectors->Data<uint8_t>() + first * num_subvectors;
+          for (int64_t v = 0; v < count; ++v) {
+            float distance = 0.0f;
+            for (int64_t m = 0; m < num_subvectors; ++m) {
+              distance += table[m * kNumCodes + codes[v * num_subvectors + m]];
+            }
+            list_distances[v] = distance;
+          }
+        }
+
+        for (int64_t v = 0; v < count; ++v) {
+          const std::pair<float, int64_t> candidate(list_distances[v], ids_data[first + v]);
+          if (static_cast<int64_t>(heap.size()) < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+          } else if (candidate < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end());
+          }
+        }
+      }
+
+      std::sort_heap(heap.begin(), heap.end());
+      float* query_distances = distances_data + q * k;
+      int64_t* query_indices = indices_data + q * k;
+      for (int64_t i = 0; i < k; ++i) {
+        if (i < static_cast<int64_t>(heap.size())) {
+          query_distances[i] = heap[i].first;
+          query_indices[i] = heap[i].second;
+        } else {
+          query_distances[i] = std::numeric_limits<float>::infinity();
+          query_indices[i] = -1;
+        }
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
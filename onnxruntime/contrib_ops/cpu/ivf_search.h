@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Searches the k nearest neighbors of queries in an inverted file index, whose vectors are stored either as they
+// are or as product quantization codes.
+class IVFSearch final : public OpKernel {
+ public:
+  explicit IVFSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t k_;
+  int64_t nprobe_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
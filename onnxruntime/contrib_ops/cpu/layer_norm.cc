@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/layer_norm.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    LayerNormalization,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    LayerNorm);
+
+// smallest number of elements normalized by a task
+constexpr int64_t kMinLayerNormElementsPerTask = 16384;
+
+LayerNorm::LayerNorm(const OpKernelInfo& info) : OpKernel(info) {
+  axis_ = info.GetAttrOrDefault<int64_t>("axis", -1);
+  epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+}
+
+Status LayerNorm::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+
+  const TensorShape& x_shape = X->Shape();
+  const auto axis = static_cast<size_t>(HandleNegativeAxis(axis_, x_shape.NumDimensions()));
+  const int64_t norm_count = x_shape.SizeToDimension(axis);
+  const int64_t norm_size = x_shape.SizeFromDimension(axis);
+  if (scale->Shape().Size() != norm_size || bias->Shape().Size() != norm_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "scale with shape ", scale->Shape(), " and B with shape ",
+                           bias->Shape(), " must have as many elements as the normalized dimensions of X with shape ",
+                           x_shape, " from axis ", axis);
+  }
+
+  Tensor* Y = context->Output(0, x_shape);
+  if (norm_size == 0) {
+    return Status::OK();
+  }
+
+  const float* x_data = X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+  ConstEigenVectorArrayMap<float> scale_map(scale->Data<float>(), norm_size);
+  ConstEigenVectorArrayMap<float> bias_map(bias->Data<float>(), norm_size);
+
+  auto normalize_rows = [&](int64_t first_row, int64_t last_row) {
+    for (int64_t row = first_row; row < last_row; ++row) {
+      ConstEigenVectorArrayMap<float> x(x_data + row * norm_size, norm_size);
+      EigenVectorArrayMap<float> y(y_data + row * norm_size, norm_size);
+      // the row is still in the cache for the second pass, which avoids the cancellation of
+      // computing the variance as E[x^2] - mean^2
+      const float mean = x.mean();
+      y = x - mean;
+      const float inv_std = 1.0f / std::sqrt(y.square().mean() + epsilon_);
+      y = y * (scale_map * inv_std) + bias_map;
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(norm_count, norm_count * norm_size / kMinLayerNormElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    normalize_rows(0, norm_count);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      normalize_rows(norm_count * task / num_tasks, norm_count * (task + 1) / num_tasks);
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Normalizes each slice of the input over the trailing dimensions from axis, then applies the scale
+// and bias, in place of the chain of reductions and element-wise nodes it is exported as.
+class LayerNorm final : public OpKernel {
+ public:
+  explicit LayerNorm(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  float epsilon_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
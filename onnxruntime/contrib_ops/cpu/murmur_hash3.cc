@@ -9,6 +9,12 @@
 
 #include "contrib_ops/cpu/murmur_hash3.h"
 
+#include <algorithm>
+#include <functional>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
 // Platform-specific functions and macros
 
 // Microsoft Visual Studio
@@ -103,6 +109,8 @@ ONNX_OPERATOR_KERNEL_EX(
     KernelDefBuilder()
         .TypeConstraint("T1", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
                                                       DataTypeImpl::GetTensorType<uint32_t>(),
+                                                      DataTypeImpl::GetTensorType<int64_t>(),
+                                                      DataTypeImpl::GetTensorType<uint64_t>(),
                                                       DataTypeImpl::GetTensorType<std::string>()})
         .TypeConstraint("T2", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
                                                       DataTypeImpl::GetTensorType<uint32_t>()}),
@@ -163,6 +171,47 @@ void MurmurHash3::MurmurHash3_x86_32(const void* key, int len, uint32_t seed, vo
   }
 }
 
+namespace {
+
+// the keys of a chunk hashed by a thread
+constexpr int64_t kMinKeysPerThread = 1 << 14;
+
+FORCE_INLINE uint32_t MixBlock(uint32_t h1, uint32_t k1) {
+  k1 *= 0xcc9e2d51;
+  k1 = ROTL32(k1, 15);
+  k1 *= 0x1b873593;
+
+  h1 ^= k1;
+  h1 = ROTL32(h1, 13);
+  return h1 * 5 + 0xe6546b64;
+}
+
+// MurmurHash3_x86_32 of keys of 4 and 8 bytes, without the loop and the tail of the general case, so that the loops
+// over the keys are vectorized
+FORCE_INLINE uint32_t HashKey(uint32_t key, uint32_t seed) {
+  return fmix(MixBlock(seed, key) ^ 4u);
+}
+
+FORCE_INLINE uint32_t HashKey(uint64_t key, uint32_t seed) {
+  const uint32_t h1 = MixBlock(MixBlock(seed, static_cast<uint32_t>(key)), static_cast<uint32_t>(key >> 32));
+  return fmix(h1 ^ 8u);
+}
+
+template <typename TKey>
+void HashKeys(const TKey* keys, uint32_t* output, int64_t count, uint32_t seed, uint32_t num_buckets) {
+  if (num_buckets == 0) {
+    for (int64_t i = 0; i < count; ++i) {
+      output[i] = HashKey(keys[i], seed);
+    }
+  } else {
+    for (int64_t i = 0; i < count; ++i) {
+      output[i] = HashKey(keys[i], seed) % num_buckets;
+    }
+  }
+}
+
+}  // namespace
+
 Status MurmurHash3::Compute(OpKernelContext* ctx) const {
   const Tensor* keys = ctx->Input<Tensor>(0);
   ORT_ENFORCE(keys);
@@ -171,32 +220,45 @@ Status MurmurHash3::Compute(OpKernelContext* ctx) const {
   Tensor* output_tensor = ctx->Output(0, input_shape);
 
   const MLDataType keys_type = keys->DataType();
-  const int input_element_bytes = static_cast<int>(keys->DataType()->Size());
-  const int output_element_bytes = static_cast<int>(output_tensor->DataType()->Size());
   const int64_t input_count = input_shape.Size();
-  for (int i = 0; i < input_count; ++i) {
-    if (DataTypeImpl::GetType<std::string>() == keys_type) {
-      auto input = keys->DataRaw();
-      auto output = output_tensor->MutableDataRaw();
-      auto input_string = reinterpret_cast<const std::string*>(input)[i];
-      MurmurHash3_x86_32(input_string.c_str(),
-                         static_cast<int>(input_string.length()),
-                         seed_,
-                         reinterpret_cast<uint8_t*>(output) + static_cast<int64_t>(i) * output_element_bytes);
-    } else {
-      auto output_type = output_tensor->DataType();
-      if ((DataTypeImpl::GetType<int32_t>() == keys_type || DataTypeImpl::GetType<uint32_t>() == keys_type) &&
-          (DataTypeImpl::GetType<int32_t>() == output_type || DataTypeImpl::GetType<uint32_t>() == output_type)) {
-        auto input = keys->DataRaw();
-        auto output = output_tensor->MutableDataRaw();
-        MurmurHash3_x86_32(reinterpret_cast<const uint8_t*>(input) + static_cast<int64_t>(i) * input_element_bytes,
-                           input_element_bytes,
-                           seed_,
-                           reinterpret_cast<uint8_t*>(output) + static_cast<int64_t>(i) * output_element_bytes);
-      } else {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type not supported.");
+  // the signed and unsigned outputs have the same bits
+  auto* output = reinterpret_cast<uint32_t*>(output_tensor->MutableDataRaw());
+
+  std::function<void(int64_t, int64_t)> hash_range;
+  if (DataTypeImpl::GetType<std::string>() == keys_type) {
+    const auto* input = keys->Data<std::string>();
+    hash_range = [this, input, output](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        MurmurHash3_x86_32(input[i].c_str(), static_cast<int>(input[i].length()), seed_, output + i);
+        if (num_buckets_ != 0) {
+          output[i] %= num_buckets_;
+        }
       }
-    }
+    };
+  } else if (keys_type->Size() == sizeof(uint32_t)) {
+    const auto* input = reinterpret_cast<const uint32_t*>(keys->DataRaw());
+    hash_range = [this, input, output](int64_t begin, int64_t end) {
+      HashKeys(input + begin, output + begin, end - begin, seed_, num_buckets_);
+    };
+  } else if (keys_type->Size() == sizeof(uint64_t)) {
+    const auto* input = reinterpret_cast<const uint64_t*>(keys->DataRaw());
+    hash_range = [this, input, output](int64_t begin, int64_t end) {
+      HashKeys(input + begin, output + begin, end - begin, seed_, num_buckets_);
+    };
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type not supported.");
+  }
+
+  auto* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  const int32_t num_chunks = tp == nullptr ? 1
+                                           : static_cast<int32_t>(std::min<int64_t>(tp->NumThreads() + 1,
+                                                                                    input_count / kMinKeysPerThread));
+  if (num_chunks <= 1) {
+    hash_range(0, input_count);
+  } else {
+    tp->ParallelFor(num_chunks, [&hash_range, input_count, num_chunks](int32_t chunk) {
+      hash_range(input_count * chunk / num_chunks, input_count * (chunk + 1) / num_chunks);
+    });
   }
 
   return Status::OK();
@@ -6,6 +6,8 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 
+#include <limits>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -14,6 +16,10 @@ class MurmurHash3 final : public OpKernel {
   MurmurHash3(const OpKernelInfo& info) : OpKernel(info) {
     seed_ = static_cast<uint32_t>(info.GetAttrOrDefault<int64_t>("seed", 0));
     is_positive_ = static_cast<int64_t>(info.GetAttrOrDefault<int64_t>("positive", 1));
+    const int64_t num_buckets = info.GetAttrOrDefault<int64_t>("num_buckets", 0);
+    ORT_ENFORCE(num_buckets >= 0 && num_buckets <= std::numeric_limits<int32_t>::max(),
+                "num_buckets must be between 0 and the largest int32 value.");
+    num_buckets_ = static_cast<uint32_t>(num_buckets);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -24,6 +30,8 @@ private:
 private :
   uint32_t seed_;
   int64_t is_positive_{1};
+  // if not 0, the hashes are reduced modulo the number of buckets
+  uint32_t num_buckets_{0};
 };
 }  // namespace contrib
 }  // namespace onnxruntime
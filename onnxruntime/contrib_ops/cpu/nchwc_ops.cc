@@ -68,6 +68,14 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Upsample,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcUpsample);
+
 template <typename T>
 Status ReorderInput<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -198,5 +206,25 @@ Status NchwcAveragePool::Compute(OpKernelContext* context) const {
   return NchwcPoolBase::NchwcPool(context, count_include_pad_ ? MlasAveragePoolingIncludePad : MlasAveragePoolingExcludePad);
 }
 
+Status NchwcUpsample::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+
+  const auto& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+
+  std::vector<int64_t> Y_shape(X_shape.GetDims());
+  Y_shape[2] *= scales_[2];
+  Y_shape[3] *= scales_[3];
+  auto* Y = context->Output(0, Y_shape);
+
+  MlasNchwcUpsample(X_shape.GetDims().data(),
+                    scales_.data() + 2,
+                    X->template Data<float>(),
+                    Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -73,5 +73,20 @@ class NchwcAveragePool : public OpKernel, public NchwcPoolBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
+class NchwcUpsample : public OpKernel {
+ public:
+  NchwcUpsample(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttrs<int64_t>("scales", scales_).IsOK());
+    ORT_ENFORCE(scales_.size() == 4);
+    // Batch and channel dimensions cannot scale and spatial scaling must be positive.
+    ORT_ENFORCE(scales_[0] == 1 && scales_[1] == 1 && scales_[2] >= 1 && scales_[3] >= 1);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<int64_t> scales_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/nhwc_pool.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NhwcMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NhwcGlobalMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NhwcAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NhwcGlobalAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+Status NhwcPoolBase::NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+  const auto* X = context->Input<Tensor>(0);
+
+  const auto& X_shape = X->Shape();
+  const size_t rank = X_shape.NumDimensions();
+  ORT_RETURN_IF_NOT(rank >= 3 && rank <= 5, "Input dimension must be between 3 and 5.");
+  if (!global_pooling_) {
+    ORT_RETURN_IF_NOT(kernel_shape_.size() == rank - 2, "kernel_shape num_dims is not compatible with X num_dims.");
+  }
+
+  // The output size is computed on the NCHW layout, so the channels are moved in front of the spatial dimensions
+  // and back out of the output dimensions.
+  const int64_t channels = X_shape[rank - 1];
+  std::vector<int64_t> nchw_dims{X_shape[0], channels};
+  nchw_dims.insert(nchw_dims.end(), X_shape.GetDims().begin() + 1, X_shape.GetDims().end() - 1);
+
+  std::vector<int64_t> pads = pads_;
+  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(TensorShape(nchw_dims), channels, &pads, dilations_,
+                                                             ceil_mode_);
+  output_dims.erase(output_dims.begin() + 1);
+  output_dims.push_back(channels);
+  auto* Y = context->Output(0, output_dims);
+
+  MlasNhwcPool(kind,
+               rank - 2,
+               X_shape.GetDims().data(),
+               global_pooling_ ? nullptr : kernel_shape_.data(),
+               global_pooling_ ? nullptr : pads.data(),
+               global_pooling_ ? nullptr : strides_.data(),
+               output_dims.data(),
+               X->template Data<float>(),
+               Y->template MutableData<float>(),
+               static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+Status NhwcMaxPool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, MlasMaximumPooling);
+}
+
+Status NhwcAveragePool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, count_include_pad_ ? MlasAveragePoolingIncludePad : MlasAveragePoolingExcludePad);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/pool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Pooling of an input in the NHWC layout, where the channels are the last dimension.
+class NhwcPoolBase : public PoolBase {
+ public:
+  NhwcPoolBase(const OpKernelInfo& info) : PoolBase(info) {
+  }
+
+  Status NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+};
+
+class NhwcMaxPool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcMaxPool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NhwcAveragePool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcAveragePool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
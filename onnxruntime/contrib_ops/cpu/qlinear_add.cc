@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/qlinear_add.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearAdd,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearAdd);
+
+namespace {
+
+float GetScalar(OpKernelContext& context, int index, const char* name) {
+  const Tensor& tensor = *context.Input<Tensor>(index);
+  ORT_ENFORCE(IsScalarOr1ElementVector(&tensor), "QLinearAdd : ", name, " must be a scalar or 1D tensor of size 1");
+  return tensor.IsDataType<float>() ? *tensor.Data<float>() : static_cast<float>(*tensor.Data<uint8_t>());
+}
+
+}  // namespace
+
+Status QLinearAdd::Compute(OpKernelContext* context) const {
+  const float a_scale = GetScalar(*context, 1, "A_scale");
+  const float a_zero_point = GetScalar(*context, 2, "A_zero_point");
+  const float b_scale = GetScalar(*context, 4, "B_scale");
+  const float b_zero_point = GetScalar(*context, 5, "B_zero_point");
+  const float c_scale = GetScalar(*context, 6, "C_scale");
+  const float c_zero_point = GetScalar(*context, 7, "C_zero_point");
+  ORT_RETURN_IF_NOT(c_scale != 0.f, "QLinearAdd : C_scale must not be zero");
+
+  // C = A * a_multiplier + B * b_multiplier + offset, rounded and saturated to uint8
+  const float a_multiplier = a_scale / c_scale;
+  const float b_multiplier = b_scale / c_scale;
+  const float offset = c_zero_point - a_zero_point * a_multiplier - b_zero_point * b_multiplier;
+  auto requantize = [](EigenVectorMap<uint8_t>& c, const auto& sum) {
+    c.array() = sum.round().cwiseMax(0.f).cwiseMin(255.f).template cast<uint8_t>();
+  };
+
+  TBroadcaster<uint8_t, uint8_t> bc(*context->Input<Tensor>(0), *context->Input<Tensor>(3));
+  Tensor& output = *context->Output(0, bc.GetOutputShape());
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal&>(*context).GetOperatorThreadPool();
+  ParallelBroadcastLoop<uint8_t, uint8_t, uint8_t>(
+      bc, output, tp,
+      [&](EigenVectorMap<uint8_t> c, uint8_t a, ConstEigenVectorMap<uint8_t> b) {
+        requantize(c, b.array().cast<float>() * b_multiplier + (a * a_multiplier + offset));
+      },
+      [&](EigenVectorMap<uint8_t> c, ConstEigenVectorMap<uint8_t> a, uint8_t b) {
+        requantize(c, a.array().cast<float>() * a_multiplier + (b * b_multiplier + offset));
+      },
+      [&](EigenVectorMap<uint8_t> c, ConstEigenVectorMap<uint8_t> a, ConstEigenVectorMap<uint8_t> b) {
+        requantize(c, a.array().cast<float>() * a_multiplier + b.array().cast<float>() * b_multiplier + offset);
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/sparse_matmul.h"
+
+#include <algorithm>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    SparseMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    SparseMatMul);
+
+// smallest number of multiply-adds and input values visited by a task
+constexpr int64_t kMinSparseMatMulOpsPerTask = 32768;
+
+template <typename T>
+static std::vector<T> UnpackValues(const ONNX_NAMESPACE::TensorProto& tensor, int64_t size) {
+  std::vector<T> values(static_cast<size_t>(size));
+  const bool has_raw_data = utils::HasRawData(tensor);
+  ORT_THROW_IF_ERROR(utils::UnpackTensor<T>(tensor, has_raw_data ? tensor.raw_data().data() : nullptr,
+                                            has_raw_data ? tensor.raw_data().size() : 0, values.data(), size));
+  return values;
+}
+
+SparseMatMul::SparseMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  ONNX_NAMESPACE::SparseTensorProto B;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::SparseTensorProto>("B", &B).IsOK(), "Attribute B is required");
+  ORT_ENFORCE(B.dims_size() == 2, "B must be 2-D");
+  rows_ = B.dims(0);
+  columns_ = B.dims(1);
+  alpha_ = info.GetAttrOrDefault<float>("alpha", 1.f);
+  beta_ = info.GetAttrOrDefault<float>("beta", 1.f);
+
+  // The values are [NNZ], and the indices either the linear index of each value, [NNZ], or its
+  // coordinates, [NNZ, 2].
+  const auto& values_proto = B.values();
+  const auto& indices_proto = B.indices();
+  ORT_ENFORCE(values_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT && values_proto.dims_size() == 1,
+              "The values of B must be a 1-D float tensor");
+  const int64_t nnz = values_proto.dims(0);
+  const bool linear_indices = indices_proto.dims_size() == 1;
+  ORT_ENFORCE(indices_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64 &&
+                  indices_proto.dims_size() >= 1 && indices_proto.dims(0) == nnz &&
+                  (linear_indices || (indices_proto.dims_size() == 2 && indices_proto.dims(1) == 2)),
+              "The indices of B must be an int64 tensor of shape [NNZ] or [NNZ, 2]");
+
+  const auto values = UnpackValues<float>(values_proto, nnz);
+  const auto indices = UnpackValues<int64_t>(indices_proto, linear_indices ? nnz : 2 * nnz);
+
+  std::vector<int64_t> rows(static_cast<size_t>(nnz));
+  std::vector<int64_t> columns(static_cast<size_t>(nnz));
+  for (int64_t i = 0; i < nnz; ++i) {
+    rows[i] = linear_indices ? indices[i] / columns_ : indices[2 * i];
+    columns[i] = linear_indices ? indices[i] % columns_ : indices[2 * i + 1];
+    ORT_ENFORCE(rows[i] >= 0 && rows[i] < rows_ && columns[i] >= 0 && columns[i] < columns_,
+                "The indices of B are out of its bounds");
+  }
+
+  // Counting sort of the nonzeros by row, which keeps the order of the columns of each row
+  row_offsets_.assign(static_cast<size_t>(rows_) + 1, 0);
+  for (auto row : rows) {
+    ++row_offsets_[row + 1];
+  }
+  for (int64_t k = 0; k < rows_; ++k) {
+    row_offsets_[k + 1] += row_offsets_[k];
+  }
+
+  std::vector<int64_t> next(row_offsets_.begin(), row_offsets_.end() - 1);
+  column_indices_.resize(static_cast<size_t>(nnz));
+  values_.resize(static_cast<size_t>(nnz));
+  for (int64_t i = 0; i < nnz; ++i) {
+    const int64_t position = next[rows[i]]++;
+    column_indices_[position] = columns[i];
+    values_[position] = values[i];
+  }
+}
+
+Status SparseMatMul::Compute(OpKernelContext* context) const {
+  const Tensor* A = context->Input<Tensor>(0);
+  const Tensor* C = context->Input<Tensor>(1);
+  const auto& A_shape = A->Shape();
+  const size_t rank = A_shape.NumDimensions();
+  if (rank < 1 || A_shape[rank - 1] != rows_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The last dimension of A must be ", rows_,
+                           ". A shape: ", A_shape);
+  }
+  if (C != nullptr && C->Shape().Size() != 1 && C->Shape().Size() != columns_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "C must hold a single value or ", columns_,
+                           " values. C shape: ", C->Shape());
+  }
+
+  std::vector<int64_t> Y_dims(A_shape.GetDims());
+  Y_dims.back() = columns_;
+  Tensor* Y = context->Output(0, Y_dims);
+
+  const int64_t M = A_shape.SizeToDimension(rank - 1);
+  const float* A_data = A->Data<float>();
+  const float* C_data = C != nullptr ? C->Data<float>() : nullptr;
+  const bool broadcast_C = C != nullptr && C->Shape().Size() == 1;
+  float* Y_data = Y->MutableData<float>();
+
+  auto compute_rows = [&](int64_t first, int64_t last) {
+    for (int64_t m = first; m < last; ++m) {
+      float* y = Y_data + m * columns_;
+      if (C_data == nullptr) {
+        std::fill_n(y, columns_, 0.f);
+      } else if (broadcast_C) {
+        std::fill_n(y, columns_, beta_ * *C_data);
+      } else {
+        for (int64_t n = 0; n < columns_; ++n) {
+          y[n] = beta_ * C_data[n];
+        }
+      }
+
+      const float* a = A_data + m * rows_;
+      for (int64_t k = 0; k < rows_; ++k) {
+        const float scale = alpha_ * a[k];
+        if (scale == 0.f) {
+          continue;
+        }
+        for (int64_t i = row_offsets_[k]; i < row_offsets_[k + 1]; ++i) {
+          y[column_indices_[i]] += scale * values_[i];
+        }
+      }
+    }
+  };
+
+  // Each row of A visits its values and the nonzeros of B at most once
+  const int64_t ops_per_row = rows_ + static_cast<int64_t>(values_.size()) + columns_;
+  int64_t num_tasks = M * ops_per_row / kMinSparseMatMulOpsPerTask;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+  num_tasks = std::min(num_tasks, M);
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_rows(0, M);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      compute_rows(M * task / num_tasks, M * (task + 1) / num_tasks);
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
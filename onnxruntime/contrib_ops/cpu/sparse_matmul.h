@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Multiplies its input with a constant sparse matrix, which the kernel converts once from the COO form of the
+// attribute to compressed sparse rows (CSR). Each row of the output accumulates the rows of B scaled by the
+// values of the input row, so only the nonzeros of B are visited.
+class SparseMatMul final : public OpKernel {
+ public:
+  explicit SparseMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t rows_;
+  int64_t columns_;
+  // the nonzeros of row k of B are at [row_offsets_[k], row_offsets_[k + 1]) of column_indices_ and values_
+  std::vector<int64_t> row_offsets_;
+  std::vector<int64_t> column_indices_;
+  std::vector<float> values_;
+  float alpha_;
+  float beta_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
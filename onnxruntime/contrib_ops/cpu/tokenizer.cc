@@ -4,12 +4,17 @@
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/threadpool.h"
 #include "onnx/defs/schema.h"
 
 #include "core/common/utf8_util.h"
 #include "re2/re2.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -33,6 +38,10 @@ class Tokenizer final : public OpKernel {
                          size_t N, size_t C,
                          const std::vector<int64_t>& input_dims) const;
 
+  // Writes the tokens of each row to the output, padded to the longest row
+  Status OutputTokens(OpKernelContext* ctx, const std::vector<std::vector<re2::StringPiece>>& rows,
+                      const std::vector<int64_t>& input_dims) const;
+
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
@@ -54,6 +63,9 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 namespace tokenizer_details {
 const char start_text = 0x2;
 const char end_text = 0x3;
+
+// smallest number of strings tokenized by a task
+constexpr size_t kMinRowsPerTask = 64;
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
@@ -116,27 +128,54 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   }
 }
 
+// Runs fn over ranges of [0, count) split across the operator thread pool
+// and returns the first error of the ranges
+static Status ParallelForRows(OpKernelContext* ctx, size_t count,
+                              const std::function<Status(size_t, size_t)>& fn) {
+  int64_t num_tasks = static_cast<int64_t>(count / kMinRowsPerTask);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    return fn(0, count);
+  }
+
+  std::vector<Status> statuses(static_cast<size_t>(num_tasks));
+  tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+    statuses[task] = fn(count * task / num_tasks, count * (task + 1) / num_tasks);
+  });
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
 Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
                                const std::vector<int64_t>& input_dims) const {
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+  const size_t rows = N * C;
+  std::vector<size_t> row_tokens(rows);
+  auto status = ParallelForRows(ctx, rows, [&](size_t first, size_t last) -> Status {
+    for (size_t row = first; row < last; ++row) {
+      const auto& s = input_data[row];
+      size_t tokens = 0;  // length in utf8 chars
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         tokens)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars: " + s);
+      }
+      row_tokens[row] = tokens;
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
-  }
+    return Status::OK();
+  });
+  ORT_RETURN_IF_ERROR(status);
+  size_t max_tokens = *std::max_element(row_tokens.cbegin(), row_tokens.cend());
 
   std::vector<int64_t> output_dims(input_dims);
   // Check if we have no output due to apparently empty strings input.
@@ -155,126 +194,50 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (mark_ * 2) <= max_tokens);
-    const size_t pads = max_tokens - (mark_ * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+
+  // Each row is written to its own range of the output
+  return ParallelForRows(ctx, rows, [&](size_t first, size_t last) -> Status {
+    for (size_t row = first; row < last; ++row) {
+      const auto& s = input_data[row];
+      size_t output_index = row * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      size_t tokens = 0;
+      const size_t str_len = s.size();
+      for (size_t token_idx = 0; token_idx < str_len;) {
+        size_t tlen = 0;
+        bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+        assert(result);
+        (void)result;
+        assert(token_idx + tlen <= str_len);
+        (output_data + output_index)->assign(s, token_idx, tlen);
+        ++output_index;
+        token_idx += tlen;
+        ++tokens;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      // Padding strings
+      assert(tokens + (mark_ * 2) <= max_tokens);
+      const size_t pads = max_tokens - (mark_ * 2) - tokens;
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
     }
-    ++curr_input;
-  }
-  return Status::OK();
+    return Status::OK();
+  });
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               const std::vector<int64_t>& input_dims) const {
-  using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
-
-  // We do not constraint the search to match
-  // on the beginning or end of the string
-  const RE2::Anchor anchor = RE2::UNANCHORED;
-
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
+Status Tokenizer::OutputTokens(OpKernelContext* ctx, const std::vector<std::vector<re2::StringPiece>>& rows,
+                               const std::vector<int64_t>& input_dims) const {
   size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
-
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + submatch.as_string());
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
-          } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
-          }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
+  for (const auto& row : rows) {
     max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -297,166 +260,188 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+  // The tokens are views of the input strings, so they are only copied once, to the output.
+  // Each row is written to its own range of the output.
+  return ParallelForRows(ctx, rows.size(), [&](size_t first, size_t last) -> Status {
+    for (size_t row_idx = first; row_idx < last; ++row_idx) {
+      const auto& row = rows[row_idx];
+      size_t output_index = row_idx * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      // Output tokens for this row
+      for (const auto& token : row) {
+        (output_data + output_index)->assign(token.data(), token.size());
+        ++output_index;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      const size_t pads = max_tokens - (mark_ * 2) - row.size();
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
+      assert(output_index == (row_idx + 1) * max_tokens);
     }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+    return Status::OK();
+  });
+}
+
+Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
+                                               size_t N, size_t C,
+                                               const std::vector<int64_t>& input_dims) const {
+  using namespace re2;
+  std::vector<std::vector<StringPiece>> rows(N * C);
+
+  // We do not constraint the search to match
+  // on the beginning or end of the string
+  const RE2::Anchor anchor = RE2::UNANCHORED;
+
+  // Scan all strings and attempt to find separators in them
+  // collect all the output tokens here. RE2 matching is thread-safe,
+  // so the strings are scanned in parallel.
+  auto X = ctx->Input<Tensor>(0);
+  auto const input_data = X->template Data<std::string>();
+  auto status = ParallelForRows(ctx, rows.size(), [&](size_t first, size_t last) -> Status {
+    for (size_t row_idx = first; row_idx < last; ++row_idx) {
+      const auto& s = input_data[row_idx];
+      size_t utf8_chars = 0;  // length in utf8 chars
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars: " + s);
+      }
+
+      auto& row = rows[row_idx];
+      row.emplace_back(s);
+
+      for (const auto& sep : separators_) {
+        std::vector<StringPiece> tokens;
+        for (const auto& text : row) {
+          const auto end_pos = text.length();
+          size_t start_pos = 0;
+          StringPiece submatch;
+
+          bool match = true;
+          do {
+            match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+            if (match) {
+              // Record  pos/len
+              assert(submatch.data() != nullptr);
+              size_t match_pos = submatch.data() - text.data();
+              assert(match_pos >= start_pos);
+              auto token_len = match_pos - start_pos;
+              utf8_chars = 0;
+              bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                    token_len, utf8_chars);
+              if (!valid) {
+                return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                              "Match contains invalid utf8 chars: " + submatch.as_string());
+              }
+              if (utf8_chars >= size_t(mincharnum_)) {
+                tokens.emplace_back(text.data() + start_pos, token_len);
+              }
+              // Update starting position
+              // Guard against empty string match
+              auto match_len = submatch.length();
+              if (match_len > 0) {
+                start_pos = match_pos + match_len;
+              } else {
+                size_t bytes = 0;
+                utf8_bytes(*submatch.data(), bytes);
+                start_pos = match_pos + bytes;
+              }
+            } else {
+              // record trailing token
+              auto trailing_len = end_pos - start_pos;
+              utf8_chars = 0;
+              utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                       trailing_len, utf8_chars);
+              if (utf8_chars >= size_t(mincharnum_)) {
+                tokens.emplace_back(text.data() + start_pos, trailing_len);
+              }
+            }
+          } while (match);
+        }  // row
+        // Replace the row with the results of this tokenezation
+        row.swap(tokens);
+      }  // separators_
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-  return Status::OK();
+    return Status::OK();
+  });
+  ORT_RETURN_IF_ERROR(status);
+
+  return OutputTokens(ctx, rows, input_dims);
 }
 
 Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                                   size_t N, size_t C,
                                   const std::vector<int64_t>& input_dims) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
+  // The tokens of each row, as views of the input string
+  std::vector<std::vector<StringPiece>> tokens(N * C);
 
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  // RE2 matching is thread-safe, so the strings are scanned in parallel
+  auto status = ParallelForRows(ctx, tokens.size(), [&](size_t first, size_t last) -> Status {
+    for (size_t row_idx = first; row_idx < last; ++row_idx) {
+      const auto& s = input_data[row_idx];
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + submatch.as_string());
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
-        }
+      size_t utf8_chars = 0;
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars: " + s);
       }
-    } while (match);
-    max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
-  }
 
-  // Check for empty output
-  std::vector<int64_t> output_dims(input_dims);
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      auto& row = tokens[row_idx];
+
+      StringPiece text(s);
+      const auto end_pos = s.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - s.data();
+          assert(match_pos >= start_pos);
+          // Guard against empty match and make
+          // sure we make progress either way
+          auto token_len = submatch.length();
+          utf8_chars = 0;
+          if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + submatch.as_string());
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            row.push_back(submatch);
+            start_pos = match_pos + token_len;
+          } else {
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
+          }
+        }
+      } while (match);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
+    return Status::OK();
+  });
+  ORT_RETURN_IF_ERROR(status);
 
-  return Status::OK();
+  return OutputTokens(ctx, tokens, input_dims);
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
@@ -8,6 +8,15 @@
 #pragma warning(disable : 4996)
 #endif
 #include "unique.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -17,11 +26,62 @@ ONNX_OPERATOR_KERNEL_EX(Unique,
                         kMSDomain,
                         1,
                         kCpuExecutionProvider,
-                        KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
-                        Unique<float>);
+                        KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),
+                                                                DataTypeImpl::GetTensorType<int32_t>(),
+                                                                DataTypeImpl::GetTensorType<int64_t>()}),
+                        Unique);
+
+namespace {
+
+// inputs of at least twice this size are split across the threads of the thread pool
+constexpr int64_t kMinElementsPerThread = 1 << 14;
+
+// The unique elements of a range of the input, in the order in which they are first seen, with their counts.
+template <typename T>
+struct UniqueElements {
+  std::unordered_map<T, int64_t> indices;
+  std::vector<T> elements;
+  std::vector<int64_t> counts;
+
+  // returns the index of the element in elements
+  int64_t Add(T element, int64_t count) {
+    const auto result = indices.emplace(element, static_cast<int64_t>(elements.size()));
+    if (result.second) {
+      elements.push_back(element);
+      counts.push_back(count);
+    } else {
+      counts[result.first->second] += count;
+    }
+    return result.first->second;
+  }
+};
+
+// a strict weak ordering of the elements, which puts NaNs last
+template <typename T>
+bool LessWithNaNLast(T a, T b) {
+  return a < b;
+}
 
 template <>
-Status Unique<float>::Compute(OpKernelContext* ctx) const {
+bool LessWithNaNLast<float>(float a, float b) {
+  return a < b || (!std::isnan(a) && std::isnan(b));
+}
+
+}  // namespace
+
+Status Unique::Compute(OpKernelContext* ctx) const {
+  const auto* data_type = ctx->Input<Tensor>(0)->DataType();
+  if (data_type == DataTypeImpl::GetType<float>())
+    return ComputeImpl<float>(ctx);
+  if (data_type == DataTypeImpl::GetType<int32_t>())
+    return ComputeImpl<int32_t>(ctx);
+  if (data_type == DataTypeImpl::GetType<int64_t>())
+    return ComputeImpl<int64_t>(ctx);
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported input type of Unique");
+}
+
+template <typename T>
+Status Unique::ComputeImpl(OpKernelContext* ctx) const {
   const Tensor* input = ctx->Input<Tensor>(0);
 
   // validate input
@@ -29,58 +89,97 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input tensor to Unique op should be 1D");
 
   // obtain raw input data
-  const float* input_data = input->Data<float>();
-  size_t num_elements = static_cast<size_t>(input->Shape().Size());
+  const T* input_data = input->Data<T>();
+  const int64_t num_elements = input->Shape().Size();
 
-  // 'idx' output has same output shape as input
+  // 'idx' output has same output shape as input, and is only computed if it is used
   Tensor* output_idx = ctx->Output(1, input->Shape());
-  int64_t* output_idx_data = output_idx->template MutableData<int64_t>();
-
-  // container to hold the unique elements (in the order it was first seen)
-  std::vector<float> unique_elements;
-  // number of unique elements is atmost number of elements in the raw data
-  unique_elements.reserve(num_elements);
-
-  // containers to store other metadata needed for other output tensors
-  std::unordered_map<float, size_t> mapped_indices;
-  std::unordered_map<float, size_t> element_counts;
-
-  // processing
-  for (size_t i = 0; i < num_elements; ++i) {
-    float temp = input_data[i];
-
-    const auto iter = mapped_indices.find(temp);
-    if (iter == mapped_indices.end()) {
-      // element is being seen for the first time
-      element_counts[temp] = 1;
-      output_idx_data[i] = mapped_indices[temp] = unique_elements.size();
-      unique_elements.push_back(temp);
-    } else {
-      // element has been seen before
-      output_idx_data[i] = iter->second;
-      ++element_counts[temp];
+  int64_t* output_idx_data = output_idx != nullptr ? output_idx->template MutableData<int64_t>() : nullptr;
+
+  // the unique elements in the order they are first seen
+  UniqueElements<T> uniques;
+
+  auto* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  const int32_t num_chunks = tp == nullptr ? 1
+                                           : static_cast<int32_t>(std::min<int64_t>(tp->NumThreads() + 1,
+                                                                                    num_elements / kMinElementsPerThread));
+  if (num_chunks <= 1) {
+    for (int64_t i = 0; i < num_elements; ++i) {
+      const int64_t index = uniques.Add(input_data[i], 1);
+      if (output_idx_data != nullptr)
+        output_idx_data[i] = index;
+    }
+  } else {
+    // Each thread finds the unique elements of a chunk of the input, then the chunks are merged in order, which keeps
+    // the order in which the elements are first seen, and the indices are mapped to the merged ones.
+    const auto chunk_begin = [num_elements, num_chunks](int32_t chunk) {
+      return num_elements * chunk / num_chunks;
+    };
+    std::vector<UniqueElements<T>> chunks(num_chunks);
+    tp->ParallelFor(num_chunks, [&](int32_t chunk) {
+      for (int64_t i = chunk_begin(chunk), end = chunk_begin(chunk + 1); i < end; ++i) {
+        const int64_t index = chunks[chunk].Add(input_data[i], 1);
+        if (output_idx_data != nullptr)
+          output_idx_data[i] = index;
+      }
+    });
+
+    std::vector<std::vector<int64_t>> merged_indices(num_chunks);
+    for (int32_t chunk = 0; chunk < num_chunks; ++chunk) {
+      const auto& elements = chunks[chunk].elements;
+      merged_indices[chunk].resize(elements.size());
+      for (size_t j = 0; j < elements.size(); ++j) {
+        merged_indices[chunk][j] = uniques.Add(elements[j], chunks[chunk].counts[j]);
+      }
+      chunks[chunk] = UniqueElements<T>();
+    }
+
+    if (output_idx_data != nullptr) {
+      tp->ParallelFor(num_chunks, [&](int32_t chunk) {
+        const auto& indices = merged_indices[chunk];
+        for (int64_t i = chunk_begin(chunk), end = chunk_begin(chunk + 1); i < end; ++i) {
+          output_idx_data[i] = indices[output_idx_data[i]];
+        }
+      });
+    }
+  }
+
+  const size_t num_uniques = uniques.elements.size();
+  if (sorted_) {
+    std::vector<int64_t> order(num_uniques);
+    std::iota(order.begin(), order.end(), int64_t{0});
+    const auto& elements = uniques.elements;
+    std::sort(order.begin(), order.end(), [&elements](int64_t a, int64_t b) {
+      return LessWithNaNLast(elements[a], elements[b]);
+    });
+
+    std::vector<T> sorted_elements(num_uniques);
+    std::vector<int64_t> sorted_counts(num_uniques);
+    std::vector<int64_t> ranks(num_uniques);
+    for (size_t j = 0; j < num_uniques; ++j) {
+      sorted_elements[j] = elements[order[j]];
+      sorted_counts[j] = uniques.counts[order[j]];
+      ranks[order[j]] = static_cast<int64_t>(j);
+    }
+    uniques.elements.swap(sorted_elements);
+    uniques.counts.swap(sorted_counts);
+
+    if (output_idx_data != nullptr) {
+      for (int64_t i = 0; i < num_elements; ++i) {
+        output_idx_data[i] = ranks[output_idx_data[i]];
+      }
     }
   }
 
   // 'uniques' output
-  TensorShape output_shape({static_cast<int64_t>(unique_elements.size())});
+  TensorShape output_shape({static_cast<int64_t>(num_uniques)});
   Tensor* output_uniques = ctx->Output(0, output_shape);
-  float* output_uniques_data = output_uniques->template MutableData<float>();
+  std::copy(uniques.elements.cbegin(), uniques.elements.cend(), output_uniques->template MutableData<T>());
 
   // 'counts' output
   Tensor* output_counts = ctx->Output(2, output_shape);
-  int64_t* output_counts_data = output_counts->template MutableData<int64_t>();
-
-  size_t iter = 0;
-  for (const float& e : unique_elements) {
-    // 'uniques' data
-    output_uniques_data[iter] = e;
-
-    // 'counts' data
-    const auto iter_map = element_counts.find(e);
-    output_counts_data[iter] = static_cast<int64_t>(iter_map->second);
-
-    ++iter;
+  if (output_counts != nullptr) {
+    std::copy(uniques.counts.cbegin(), uniques.counts.cend(), output_counts->template MutableData<int64_t>());
   }
 
   return Status::OK();
@@ -8,13 +8,19 @@
 namespace onnxruntime {
 namespace contrib {
 
-template <class T>
 class Unique final : public OpKernel {
  public:
-  explicit Unique(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {}
+  explicit Unique(const OpKernelInfo& op_kernel_info)
+      : OpKernel(op_kernel_info), sorted_(op_kernel_info.GetAttrOrDefault<int64_t>("sorted", 0) != 0) {}
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
+
+ private:
+  template <typename T>
+  Status ComputeImpl(OpKernelContext* p_op_kernel_context) const;
+
+  bool sorted_;
 };
 
 }  // namespace contrib
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -32,6 +32,17 @@ class Affine final : public UnaryElementwise {
   float beta_;
 };
 
+template <typename T>
+class Gelu final : public UnaryElementwise {
+ public:
+  Gelu(const OpKernelInfo& info) : UnaryElementwise(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  MAKE_FUNC_CTX_NULL()
+};
+
 template <typename T>
 class ParametricSoftplus final : public UnaryElementwise {
  public:
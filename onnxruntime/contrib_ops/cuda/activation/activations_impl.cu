@@ -19,6 +19,13 @@ struct OP_Affine : public CtxAffine {
   }
 };
 
+template <typename T>
+struct OP_Gelu : public CtxGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    return (T)0.5f * a * (_Erf(a * (T)0.70710678118654752440f) + (T)1);
+  }
+};
+
 template <typename T>
 struct OP_ParametricSoftplus : public CtxParametricSoftplus {
   __device__ __inline__ T operator()(const T& a) const {
@@ -9,12 +9,14 @@ namespace contrib {
 namespace cuda {
 
 typedef onnxruntime::cuda::CtxAlphaBeta CtxAffine;
+typedef onnxruntime::cuda::CtxNull CtxGelu;
 typedef onnxruntime::cuda::CtxAlphaBeta CtxParametricSoftplus;
 typedef onnxruntime::cuda::CtxAlphaBeta CtxScaledTanh;
 
 #define UNARY_CONTRIB_ACTIVATION_OPS() \
   UNARY_ACTIVATION_OP_NAME(ScaledTanh) \
   UNARY_ACTIVATION_OP_NAME(Affine)     \
+  UNARY_ACTIVATION_OP_NAME(Gelu)       \
   UNARY_ACTIVATION_OP_NAME(ParametricSoftplus)
 
 #define UNARY_ACTIVATION_IMPL_DECLARATION(name) \
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention.h"
+#include "attention_impl.h"
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Attention,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Attention<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask));
+
+  const auto& dims = input->Shape().GetDims();
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  const int head_size = hidden_size / num_heads_;
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  CudaT one = ToCudaType<T>::FromFloat(1.0f);
+  CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+  CudaT scale = ToCudaType<T>::FromFloat(1.0f / sqrtf(static_cast<float>(head_size)));
+  cublasHandle_t cublas = CublasHandle();
+
+  // note that onnxruntime tensors are row major while cublas is column major, so every product
+  // below is computed as its transpose with the operands swapped
+  const int token_count = batch_size * sequence_length;
+  const size_t qkv_size = static_cast<size_t>(token_count) * 3 * hidden_size;
+  auto qkv = GetScratchBuffer<CudaT>(qkv_size);
+  CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+      cublas, CUBLAS_OP_N, CUBLAS_OP_N, 3 * hidden_size, token_count, hidden_size, &one,
+      reinterpret_cast<const CudaT*>(weights->template Data<T>()), 3 * hidden_size,
+      reinterpret_cast<const CudaT*>(input->template Data<T>()), hidden_size,
+      &zero, qkv.get(), 3 * hidden_size));
+
+  // (3, batch_size, num_heads, sequence_length, head_size)
+  auto heads = GetScratchBuffer<CudaT>(qkv_size);
+  AddBiasTransposeQKV<CudaT>(qkv.get(), reinterpret_cast<const CudaT*>(bias->template Data<T>()), batch_size,
+                             sequence_length, num_heads_, head_size, heads.get());
+
+  const int batch_count = batch_size * num_heads_;
+  const long long int head_stride = static_cast<long long int>(sequence_length) * head_size;
+  const long long int score_stride = static_cast<long long int>(sequence_length) * sequence_length;
+  const CudaT* q = heads.get();
+  const CudaT* k = q + static_cast<size_t>(batch_count) * head_stride;
+  const CudaT* v = k + static_cast<size_t>(batch_count) * head_stride;
+
+  // scores = Q * K^T / sqrt(head_size) for every head
+  auto scores = GetScratchBuffer<CudaT>(static_cast<size_t>(batch_count) * score_stride);
+  CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+      cublas, CUBLAS_OP_T, CUBLAS_OP_N, sequence_length, sequence_length, head_size, &scale,
+      k, head_size, head_stride, q, head_size, head_stride,
+      &zero, scores.get(), sequence_length, score_stride, batch_count));
+
+  const CudaT* mask_data = nullptr;
+  int mask_batch_stride = 0;
+  int mask_row_stride = 0;
+  if (mask != nullptr) {
+    const auto& mask_dims = mask->Shape().GetDims();
+    mask_data = reinterpret_cast<const CudaT*>(mask->template Data<T>());
+    mask_batch_stride = mask_dims[0] == 1 ? 0 : static_cast<int>(mask_dims[2]) * sequence_length;
+    mask_row_stride = mask_dims[2] == 1 ? 0 : sequence_length;
+  }
+  MaskedSoftmaxImpl<CudaT>(mask_data, mask_batch_stride, mask_row_stride, batch_size, num_heads_, sequence_length,
+                           scores.get());
+
+  // context = softmax(scores) * V for every head, reusing the projection buffer
+  CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+      cublas, CUBLAS_OP_N, CUBLAS_OP_N, head_size, sequence_length, sequence_length, &one,
+      v, head_size, head_stride, scores.get(), sequence_length, score_stride,
+      &zero, qkv.get(), head_size, head_stride, batch_count));
+
+  TransposeAttentionContext<CudaT>(qkv.get(), batch_size, sequence_length, num_heads_, head_size,
+                                   reinterpret_cast<CudaT*>(output->template MutableData<T>()));
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <math_constants.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cu_inc/block_reduce.cuh"
+#include "attention_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+constexpr int kSoftmaxMaxThreadsPerBlock = 256;
+
+template <typename T>
+__global__ void _AddBiasTransposeQKVKernel(
+    const T* qkv_data,
+    const T* bias_data,
+    const fast_divmod fdm_head_size,
+    const fast_divmod fdm_num_heads,
+    const fast_divmod fdm_qkv,
+    const fast_divmod fdm_sequence_length,
+    const int batch_size,
+    T* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  // id walks the input, laid out as (batch_size, sequence_length, 3, num_heads, head_size)
+  int token, m, n, h, b, s, remainder;
+  fdm_head_size.divmod(id, remainder, h);
+  fdm_num_heads.divmod(remainder, remainder, n);
+  fdm_qkv.divmod(remainder, token, m);
+  fdm_sequence_length.divmod(token, b, s);
+
+  const int num_heads = fdm_num_heads.d_;
+  const int head_size = fdm_head_size.d_;
+  const int sequence_length = fdm_sequence_length.d_;
+  const int64_t out_index =
+      ((((static_cast<int64_t>(m) * batch_size + b) * num_heads + n) * sequence_length + s) * head_size) + h;
+  output_data[out_index] = qkv_data[id] + bias_data[(m * num_heads + n) * head_size + h];
+}
+
+template <typename T>
+void AddBiasTransposeQKV(
+    const T* qkv_data,
+    const T* bias_data,
+    const int batch_size,
+    const int sequence_length,
+    const int num_heads,
+    const int head_size,
+    T* output_data) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(batch_size) * sequence_length * 3 * num_heads * head_size;
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _AddBiasTransposeQKVKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      qkv_data, bias_data, fast_divmod(head_size), fast_divmod(num_heads), fast_divmod(3),
+      fast_divmod(sequence_length), batch_size, output_data, N);
+}
+
+// Each block computes the softmax of one row of scores, in float whatever the element type.
+template <typename T>
+__global__ void _MaskedSoftmaxKernel(
+    const T* mask_data,
+    const int mask_batch_stride,
+    const int mask_row_stride,
+    const int num_heads,
+    const int sequence_length,
+    T* scores_data) {
+  const int row = blockIdx.x;
+  const int i = row % sequence_length;
+  const int b = row / sequence_length / num_heads;
+  T* scores = scores_data + static_cast<int64_t>(row) * sequence_length;
+  const T* mask = mask_data == nullptr ? nullptr : mask_data + b * mask_batch_stride + i * mask_row_stride;
+
+  float max_value = -CUDART_INF_F;
+  for (int j = threadIdx.x; j < sequence_length; j += blockDim.x) {
+    float value = static_cast<float>(scores[j]);
+    if (mask != nullptr) {
+      value += static_cast<float>(mask[j]);
+    }
+    max_value = value > max_value ? value : max_value;
+  }
+  max_value = BlockReduce(max_value, MaxOp(), -CUDART_INF_F);
+
+  float sum = 0.0f;
+  for (int j = threadIdx.x; j < sequence_length; j += blockDim.x) {
+    float value = static_cast<float>(scores[j]);
+    if (mask != nullptr) {
+      value += static_cast<float>(mask[j]);
+    }
+    sum += expf(value - max_value);
+  }
+  const float inv_sum = 1.0f / BlockReduce(sum, SumOp(), 0.0f);
+
+  for (int j = threadIdx.x; j < sequence_length; j += blockDim.x) {
+    float value = static_cast<float>(scores[j]);
+    if (mask != nullptr) {
+      value += static_cast<float>(mask[j]);
+    }
+    scores[j] = static_cast<T>(expf(value - max_value) * inv_sum);
+  }
+}
+
+template <typename T>
+void MaskedSoftmaxImpl(
+    const T* mask_data,
+    const int mask_batch_stride,
+    const int mask_row_stride,
+    const int batch_size,
+    const int num_heads,
+    const int sequence_length,
+    T* scores_data) {
+  const int rows = batch_size * num_heads * sequence_length;
+  const int threads = std::min(kSoftmaxMaxThreadsPerBlock, (sequence_length + kWarpSize - 1) / kWarpSize * kWarpSize);
+  _MaskedSoftmaxKernel<T><<<rows, threads, 0>>>(
+      mask_data, mask_batch_stride, mask_row_stride, num_heads, sequence_length, scores_data);
+}
+
+template <typename T>
+__global__ void _TransposeAttentionContextKernel(
+    const T* context_data,
+    const fast_divmod fdm_head_size,
+    const fast_divmod fdm_sequence_length,
+    const fast_divmod fdm_num_heads,
+    T* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  // id walks the input, laid out as (batch_size, num_heads, sequence_length, head_size)
+  int b, n, s, h, remainder;
+  fdm_head_size.divmod(id, remainder, h);
+  fdm_sequence_length.divmod(remainder, remainder, s);
+  fdm_num_heads.divmod(remainder, b, n);
+
+  const int num_heads = fdm_num_heads.d_;
+  const int head_size = fdm_head_size.d_;
+  const int sequence_length = fdm_sequence_length.d_;
+  output_data[((static_cast<int64_t>(b) * sequence_length + s) * num_heads + n) * head_size + h] = context_data[id];
+}
+
+template <typename T>
+void TransposeAttentionContext(
+    const T* context_data,
+    const int batch_size,
+    const int sequence_length,
+    const int num_heads,
+    const int head_size,
+    T* output_data) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(batch_size) * num_heads * sequence_length * head_size;
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _TransposeAttentionContextKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      context_data, fast_divmod(head_size), fast_divmod(sequence_length), fast_divmod(num_heads), output_data, N);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                         \
+  template void AddBiasTransposeQKV<T>(const T* qkv_data, const T* bias_data, const int batch_size,                \
+                                       const int sequence_length, const int num_heads, const int head_size,        \
+                                       T* output_data);                                                             \
+  template void MaskedSoftmaxImpl<T>(const T* mask_data, const int mask_batch_stride, const int mask_row_stride,   \
+                                     const int batch_size, const int num_heads, const int sequence_length,         \
+                                     T* scores_data);                                                               \
+  template void TransposeAttentionContext<T>(const T* context_data, const int batch_size, const int sequence_length, \
+                                             const int num_heads, const int head_size, T* output_data);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Adds the bias to the (batch_size * sequence_length, 3, num_heads, head_size) projection and
+// transposes it to (3, batch_size, num_heads, sequence_length, head_size), so the query, key and
+// value of every head are contiguous matrices with a constant stride between heads.
+template <typename T>
+void AddBiasTransposeQKV(
+    const T* qkv_data,
+    const T* bias_data,
+    const int batch_size,
+    const int sequence_length,
+    const int num_heads,
+    const int head_size,
+    T* output_data);
+
+// Adds the optional mask to the (batch_size, num_heads, sequence_length, sequence_length) scores
+// and replaces each row with its softmax. mask_batch_stride and mask_row_stride are 0 for the
+// dimensions the mask broadcasts over.
+template <typename T>
+void MaskedSoftmaxImpl(
+    const T* mask_data,
+    const int mask_batch_stride,
+    const int mask_row_stride,
+    const int batch_size,
+    const int num_heads,
+    const int sequence_length,
+    T* scores_data);
+
+// Transposes the (batch_size, num_heads, sequence_length, head_size) context of the heads back to
+// (batch_size, sequence_length, num_heads, head_size).
+template <typename T>
+void TransposeAttentionContext(
+    const T* context_data,
+    const int batch_size,
+    const int sequence_length,
+    const int num_heads,
+    const int head_size,
+    T* output_data);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
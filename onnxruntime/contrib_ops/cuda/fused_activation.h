@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/activation/activations_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The activation of a fused node, which the CUDA kernels apply in place to their output.
+struct FusedActivation {
+  enum Kind {
+    Identity,
+    Relu,
+    Sigmoid,
+    Tanh,
+    LeakyRelu,
+  };
+
+  Kind kind = Identity;
+  float alpha = 0.01f;  // LeakyRelu only
+};
+
+// sets the kind of activation from the name of the fused activation op, which is empty if there is none.
+inline Status ParseFusedActivation(const std::string& name, FusedActivation& activation) {
+  if (name.empty()) {
+    activation.kind = FusedActivation::Identity;
+  } else if (name == "Relu") {
+    activation.kind = FusedActivation::Relu;
+  } else if (name == "Sigmoid") {
+    activation.kind = FusedActivation::Sigmoid;
+  } else if (name == "Tanh") {
+    activation.kind = FusedActivation::Tanh;
+  } else if (name == "LeakyRelu") {
+    activation.kind = FusedActivation::LeakyRelu;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "unimplemented activation: ", name);
+  }
+  return Status::OK();
+}
+
+template <typename CudaT>
+void ApplyFusedActivation(const FusedActivation& activation, CudaT* data, size_t count) {
+  using namespace ::onnxruntime::cuda;
+  switch (activation.kind) {
+    case FusedActivation::Relu: {
+      CtxRelu ctx;
+      Impl_Relu<CudaT>(data, data, &ctx, count);
+      break;
+    }
+    case FusedActivation::Sigmoid: {
+      CtxSigmoid ctx;
+      Impl_Sigmoid<CudaT>(data, data, &ctx, count);
+      break;
+    }
+    case FusedActivation::Tanh: {
+      CtxTanh ctx;
+      Impl_Tanh<CudaT>(data, data, &ctx, count);
+      break;
+    }
+    case FusedActivation::LeakyRelu: {
+      CtxLeakyRelu ctx;
+      ctx.alpha = activation.alpha;
+      Impl_LeakyRelu<CudaT>(data, data, &ctx, count);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/conv.h"
+#include "contrib_ops/cuda/fused_activation.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// FusedConv computes Y = activation(Conv(X, W) + B + Z). A Relu after a bias runs in the convolution through
+// cudnnConvolutionBiasActivationForward, which adds Z as well, so the output is written once. Otherwise Z is copied
+// to Y for the convolution to accumulate into, and the bias and the activation are applied in place.
+template <typename T>
+class FusedConv final : public ::onnxruntime::cuda::Conv<T> {
+  using Base = ::onnxruntime::cuda::Conv<T>;
+
+ public:
+  FusedConv(const OpKernelInfo& info) : Base(info) {
+    ORT_ENFORCE(ParseFusedActivation(info.GetAttrOrDefault<std::string>("activation", ""), activation_).IsOK());
+    if (activation_.kind == FusedActivation::LeakyRelu) {
+      std::vector<float> activation_params;
+      ORT_ENFORCE(info.GetAttrs<float>("activation_params", activation_params).IsOK() &&
+                      activation_params.size() == 1,
+                  "LeakyRelu takes its alpha from activation_params");
+      activation_.alpha = activation_params[0];
+    }
+
+    if (activation_.kind == FusedActivation::Relu) {
+      CUDNN_CALL_THROW(cudnnCreateActivationDescriptor(&relu_desc_));
+      CUDNN_CALL_THROW(cudnnSetActivationDescriptor(relu_desc_, CUDNN_ACTIVATION_RELU, CUDNN_NOT_PROPAGATE_NAN, 0.0));
+    }
+  }
+
+  ~FusedConv() {
+    if (relu_desc_ != nullptr) {
+      cudnnDestroyActivationDescriptor(relu_desc_);
+    }
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override {
+    typedef typename ToCudaType<T>::MappedType CudaT;
+
+    Tensor* Y;
+    ORT_RETURN_IF_ERROR(Base::UpdateState(context, Y));
+
+    const Tensor* B = context->Input<Tensor>(2);
+    const Tensor* Z = context->Input<Tensor>(3);
+    ORT_RETURN_IF_NOT(Z == nullptr || Z->Shape() == Y->Shape(), "Z should have the shape of the output");
+
+    auto x_data = reinterpret_cast<const CudaT*>(context->Input<Tensor>(0)->template Data<T>());
+    auto w_data = reinterpret_cast<const CudaT*>(context->Input<Tensor>(1)->template Data<T>());
+    auto y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+
+    const auto& s = this->s_;
+    const auto alpha = Consts<CudaT>::One;
+    const auto z_alpha = Z != nullptr ? Consts<CudaT>::One : Consts<CudaT>::Zero;
+
+    IAllocatorUniquePtr<void> workspace = this->template GetScratchBuffer<void>(s.workspace_bytes);
+
+    if (activation_.kind == FusedActivation::Relu && B != nullptr) {
+      auto b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
+      auto z_data = Z != nullptr ? reinterpret_cast<const CudaT*>(Z->template Data<T>()) : y_data;
+      CUDNN_RETURN_IF_ERROR(cudnnConvolutionBiasActivationForward(this->CudnnHandle(),
+                                                                  &alpha,
+                                                                  s.x_tensor,
+                                                                  x_data,
+                                                                  s.filter_desc,
+                                                                  w_data,
+                                                                  s.conv_desc,
+                                                                  s.algo,
+                                                                  workspace.get(),
+                                                                  s.workspace_bytes,
+                                                                  &z_alpha,
+                                                                  s.y_tensor,
+                                                                  z_data,
+                                                                  s.b_tensor,
+                                                                  b_data,
+                                                                  relu_desc_,
+                                                                  s.y_tensor,
+                                                                  y_data));
+      return Status::OK();
+    }
+
+    if (Z != nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(y_data, Z->DataRaw(), Y->SizeInBytes(), cudaMemcpyDeviceToDevice));
+    }
+
+    CUDNN_RETURN_IF_ERROR(cudnnConvolutionForward(this->CudnnHandle(),
+                                                  &alpha,
+                                                  s.x_tensor,
+                                                  x_data,
+                                                  s.filter_desc,
+                                                  w_data,
+                                                  s.conv_desc,
+                                                  s.algo,
+                                                  workspace.get(),
+                                                  s.workspace_bytes,
+                                                  &z_alpha,
+                                                  s.y_tensor,
+                                                  y_data));
+
+    if (B != nullptr) {
+      auto b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
+      CUDNN_RETURN_IF_ERROR(cudnnAddTensor(this->CudnnHandle(), &alpha, s.b_tensor, b_data, &alpha, s.y_tensor, y_data));
+    }
+
+    ApplyFusedActivation<CudaT>(activation_, y_data, static_cast<size_t>(Y->Shape().Size()));
+    return Status::OK();
+  }
+
+ private:
+  FusedActivation activation_;
+  cudnnActivationDescriptor_t relu_desc_ = nullptr;
+};
+
+#define REGISTER_KERNEL_TYPED(op_name, T)                                       \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      op_name,                                                                  \
+      kMSDomain,                                                                \
+      1,                                                                        \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedConv<T>);
+
+REGISTER_KERNEL_TYPED(FusedConv, float)
+REGISTER_KERNEL_TYPED(FusedConv, double)
+REGISTER_KERNEL_TYPED(FusedConv, MLFloat16)
+// the NHWC layout is taken from the name of the op, see Conv
+REGISTER_KERNEL_TYPED(NhwcConv, float)
+REGISTER_KERNEL_TYPED(NhwcConv, MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/gemm.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+#include "contrib_ops/cuda/fused_activation.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// FusedGemm computes Y = activation(alpha * A * B + beta * C). The bias is already accumulated by the Gemm itself,
+// and the activation runs in place on Y.
+template <typename T>
+class FusedGemm final : public ::onnxruntime::cuda::Gemm<T> {
+  using Base = ::onnxruntime::cuda::Gemm<T>;
+
+ public:
+  FusedGemm(const OpKernelInfo& info) : Base(info) {
+    ORT_ENFORCE(ParseFusedActivation(info.GetAttrOrDefault<std::string>("activation", ""), activation_).IsOK());
+    activation_.alpha = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override {
+    typedef typename ToCudaType<T>::MappedType CudaT;
+
+    ORT_RETURN_IF_ERROR(Base::ComputeInternal(context));
+
+    const auto X = context->Input<Tensor>(0);
+    const auto W = context->Input<Tensor>(1);
+    const auto B = context->Input<Tensor>(2);
+    GemmHelper helper(X->Shape(), this->trans_A_, W->Shape(), this->trans_B_, B->Shape());
+    Tensor* Y = context->Output(0, TensorShape(std::vector<int64_t>{helper.M(), helper.N()}));
+
+    ApplyFusedActivation<CudaT>(activation_, reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+                                static_cast<size_t>(Y->Shape().Size()));
+    return Status::OK();
+  }
+
+ private:
+  FusedActivation activation_;
+};
+
+#define REGISTER_KERNEL_TYPED(T)                                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      FusedGemm,                                                                \
+      kMSDomain,                                                                \
+      1,                                                                        \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "layer_norm.h"
+#include "layer_norm_impl.h"
+#include "core/providers/common.h"
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      LayerNormalization,                                         \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      LayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+LayerNorm<T>::LayerNorm(const OpKernelInfo& info) : CudaKernel(info) {
+  axis_ = info.GetAttrOrDefault<int64_t>("axis", -1);
+  epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+}
+
+template <typename T>
+Status LayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+
+  const TensorShape& x_shape = X->Shape();
+  const auto axis = static_cast<size_t>(HandleNegativeAxis(axis_, x_shape.NumDimensions()));
+  const int64_t norm_count = x_shape.SizeToDimension(axis);
+  const int64_t norm_size = x_shape.SizeFromDimension(axis);
+  if (scale->Shape().Size() != norm_size || bias->Shape().Size() != norm_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "scale with shape ", scale->Shape(), " and B with shape ",
+                           bias->Shape(), " must have as many elements as the normalized dimensions of X with shape ",
+                           x_shape, " from axis ", axis);
+  }
+
+  Tensor* Y = context->Output(0, x_shape);
+  if (norm_count == 0 || norm_size == 0) {
+    return Status::OK();
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  LayerNormImpl<CudaT>(
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      reinterpret_cast<const CudaT*>(scale->template Data<T>()),
+      reinterpret_cast<const CudaT*>(bias->template Data<T>()),
+      epsilon_,
+      static_cast<int>(norm_count),
+      static_cast<int>(norm_size),
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()));
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cu_inc/block_reduce.cuh"
+#include "layer_norm_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+constexpr int kLayerNormThreadsPerBlock = 256;
+
+// Each block normalizes one row, accumulating in float whatever the element type.
+template <typename T>
+__global__ void _LayerNormKernel(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    const float epsilon,
+    const int norm_size,
+    T* output_data) {
+  const T* x = input_data + static_cast<int64_t>(blockIdx.x) * norm_size;
+  T* y = output_data + static_cast<int64_t>(blockIdx.x) * norm_size;
+
+  float sum = 0.0f;
+  for (int i = threadIdx.x; i < norm_size; i += blockDim.x) {
+    sum += static_cast<float>(x[i]);
+  }
+  const float mean = BlockReduce(sum, SumOp(), 0.0f) / norm_size;
+
+  float sum_squares = 0.0f;
+  for (int i = threadIdx.x; i < norm_size; i += blockDim.x) {
+    const float centered = static_cast<float>(x[i]) - mean;
+    sum_squares += centered * centered;
+  }
+  const float inv_std = rsqrtf(BlockReduce(sum_squares, SumOp(), 0.0f) / norm_size + epsilon);
+
+  for (int i = threadIdx.x; i < norm_size; i += blockDim.x) {
+    const float normalized = (static_cast<float>(x[i]) - mean) * inv_std;
+    y[i] = static_cast<T>(normalized * static_cast<float>(scale_data[i]) + static_cast<float>(bias_data[i]));
+  }
+}
+
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    const float epsilon,
+    const int norm_count,
+    const int norm_size,
+    T* output_data) {
+  _LayerNormKernel<T><<<norm_count, kLayerNormThreadsPerBlock, 0>>>(
+      input_data, scale_data, bias_data, epsilon, norm_size, output_data);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void LayerNormImpl<T>(const T* input_data, const T* scale_data, const T* bias_data, const float epsilon, const int norm_count, const int norm_size, T* output_data);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
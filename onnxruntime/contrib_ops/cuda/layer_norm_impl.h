@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    const float epsilon,
+    const int norm_count,
+    const int norm_size,
+    T* output_data);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/batch_norm.h"
+#include "core/providers/cuda/nn/pool.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The NHWC ops the CUDA NHWC transformer creates run on the kernels of their NCHW ops, which take their layout from
+// the name of the op, so cuDNN reads and writes the NHWC tensors in place. NhwcConv runs on FusedConv, see
+// fused_conv.cc.
+template <typename T>
+using NhwcMaxPoolKernel = ::onnxruntime::cuda::Pool<T, ::onnxruntime::MaxPool<1>>;
+template <typename T>
+using NhwcAveragePoolKernel = ::onnxruntime::cuda::Pool<T, ::onnxruntime::AveragePool>;
+template <typename T>
+using NhwcBatchNormKernel = ::onnxruntime::cuda::BatchNorm<T>;
+
+#define REGISTER_NHWC_KERNEL_TYPED(op_name, T, kernel_class)                    \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      op_name,                                                                  \
+      kMSDomain,                                                                \
+      1,                                                                        \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      kernel_class<T>);
+
+#define REGISTER_NHWC_KERNELS_TYPED(T)                                        \
+  REGISTER_NHWC_KERNEL_TYPED(NhwcMaxPool, T, NhwcMaxPoolKernel)               \
+  REGISTER_NHWC_KERNEL_TYPED(NhwcGlobalMaxPool, T, NhwcMaxPoolKernel)         \
+  REGISTER_NHWC_KERNEL_TYPED(NhwcAveragePool, T, NhwcAveragePoolKernel)       \
+  REGISTER_NHWC_KERNEL_TYPED(NhwcGlobalAveragePool, T, NhwcAveragePoolKernel) \
+  REGISTER_NHWC_KERNEL_TYPED(NhwcBatchNormalization, T, NhwcBatchNormKernel)
+
+REGISTER_NHWC_KERNELS_TYPED(float)
+REGISTER_NHWC_KERNELS_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
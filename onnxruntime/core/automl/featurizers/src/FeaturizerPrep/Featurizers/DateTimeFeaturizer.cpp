@@ -50,6 +50,71 @@ namespace DateTimeFeaturizer {
         return Microsoft::Featurizer::DateTimeFeaturizer::TimePoint(arg);
     }
 
+    namespace {
+
+        // The days of the year before the first day of each month, in years
+        // that aren't leap years and in those that are.
+        constexpr std::uint16_t DaysBeforeMonth[2][12] = {
+            {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334},
+            {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335}
+        };
+
+        constexpr std::int64_t SecondsPerDay = 86400;
+
+        // The days in a 400 year cycle of the Gregorian calendar.
+        constexpr std::int64_t DaysPerEra = 146097;
+
+        // Floor division, so the times before the epoch fall in the day
+        // that contains them.
+        inline std::int64_t FloorDiv(std::int64_t a, std::int64_t b) {
+            return a / b - ((a % b) != 0 && ((a % b) < 0) != (b < 0));
+        }
+
+    } // anonymous namespace
+
+    void TransformBatch(std::int64_t const* seconds, std::size_t count, TimePointColumns const& columns,
+                        std::size_t offset) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::int64_t value = seconds[i];
+            const std::int64_t days = FloorDiv(value, SecondsPerDay);
+            const std::int64_t secondOfDay = value - days * SecondsPerDay;
+
+            // The civil date of the days since 1970-01-01, counted in eras of
+            // 400 years starting on March 1st, so that the leap day is the
+            // last day of each year of the era (H. Hinnant, civil_from_days).
+            const std::int64_t z = days + 719468;
+            const std::int64_t era = FloorDiv(z, DaysPerEra);
+            const std::int64_t dayOfEra = z - era * DaysPerEra;
+            const std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const std::int64_t dayOfMarchYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const std::int64_t marchMonth = (5 * dayOfMarchYear + 2) / 153;
+            const std::int64_t dayOfMonth = dayOfMarchYear - (153 * marchMonth + 2) / 5 + 1;
+            const std::int64_t monthOfYear = marchMonth < 10 ? marchMonth + 3 : marchMonth - 9;
+            const std::int64_t year = yearOfEra + era * 400 + (monthOfYear <= 2);
+
+            if (year < INT32_MIN || year > INT32_MAX) {
+                throw std::invalid_argument("The year of the input date is out of range.");
+            }
+
+            const bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+            // 1970-01-01 was a Thursday
+            const std::int64_t dayOfWeek = (days + 4) - FloorDiv(days + 4, 7) * 7;
+
+            const std::size_t j = offset + i;
+            columns.year[j] = static_cast<std::int32_t>(year);
+            columns.month[j] = static_cast<std::uint8_t>(monthOfYear);
+            columns.day[j] = static_cast<std::uint8_t>(dayOfMonth);
+            columns.hour[j] = static_cast<std::uint8_t>(secondOfDay / 3600);
+            columns.minute[j] = static_cast<std::uint8_t>(secondOfDay / 60 % 60);
+            columns.second[j] = static_cast<std::uint8_t>(secondOfDay % 60);
+            columns.dayOfWeek[j] = static_cast<std::uint8_t>(dayOfWeek);
+            columns.dayOfYear[j] = static_cast<std::uint16_t>(DaysBeforeMonth[isLeapYear][monthOfYear - 1] + dayOfMonth - 1);
+            columns.quarterOfYear[j] = static_cast<std::uint8_t>((monthOfYear + 2) / 3);
+            columns.weekOfMonth[j] = static_cast<std::uint8_t>((dayOfMonth - 1) / 7);
+        }
+    }
+
 
 } // namespace DateTimeFeaturizer
 } // namespace Featurizer
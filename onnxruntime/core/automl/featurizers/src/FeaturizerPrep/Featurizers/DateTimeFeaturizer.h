@@ -6,6 +6,7 @@
 
 #include "../Featurizer.h"
 #include <chrono>
+#include <cstddef>
 #include <ctime>
 #include <cstdint>
 #include <stdexcept>
@@ -72,6 +73,38 @@ namespace DateTimeFeaturizer {
         return TimePoint (sysTime);
     }
 
+    /////////////////////////////////////////////////////////////////////////
+    ///  \struct        TimePointColumns
+    ///  \brief         The components of a batch of timestamps, one array per
+    ///                 field of TimePoint, each with one element per timestamp.
+    ///
+    struct TimePointColumns {
+        std::int32_t* year = nullptr;
+        std::uint8_t* month = nullptr;
+        std::uint8_t* day = nullptr;
+        std::uint8_t* hour = nullptr;
+        std::uint8_t* minute = nullptr;
+        std::uint8_t* second = nullptr;
+        std::uint8_t* dayOfWeek = nullptr;
+        std::uint16_t* dayOfYear = nullptr;
+        std::uint8_t* quarterOfYear = nullptr;
+        std::uint8_t* weekOfMonth = nullptr;
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    ///  \fn            TransformBatch
+    ///  \brief         Splits count timestamps, in seconds since the epoch (UTC),
+    ///                 into the components TimePoint holds, written to the
+    ///                 elements [offset, offset + count) of the columns.
+    ///                 The dates are computed from the days since the epoch and
+    ///                 a table of the days before each month instead of gmtime,
+    ///                 so timestamps before 1970 are supported on all platforms.
+    ///                 Throws std::invalid_argument if a year doesn't fit in
+    ///                 TimePoint::year.
+    ///
+    void TransformBatch(std::int64_t const* seconds, std::size_t count, TimePointColumns const& columns,
+                        std::size_t offset = 0);
+
     /////////////////////////////////////////////////////////////////////////
     ///  \class         DateTimeTransformer
     ///  \brief         Transformer
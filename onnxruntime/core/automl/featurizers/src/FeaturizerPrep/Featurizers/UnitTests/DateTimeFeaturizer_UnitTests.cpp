@@ -120,6 +120,69 @@ TEST(DateTimeFeaturizer_Transformer, Pre_Epoch__1776_July_4) {
     ASSERT_EQ(tp.day, 4);
 }
 #endif /* _MSC_VER */
+TEST(DateTimeFeaturizer_TransformBatch, MatchesTimePoint) {
+    // 1976-11-17 12:27:04, 2025-06-30, 2000-02-29 and the last second of 1999
+    const std::int64_t dates[] = {217081624, 1751241600, 951782400, 946684799};
+    constexpr std::size_t count = sizeof(dates) / sizeof(dates[0]);
+
+    std::int32_t year[count];
+    std::uint8_t month[count], day[count], hour[count], minute[count], second[count], dayOfWeek[count],
+        quarterOfYear[count], weekOfMonth[count];
+    std::uint16_t dayOfYear[count];
+    TimePointColumns columns;
+    columns.year = year;
+    columns.month = month;
+    columns.day = day;
+    columns.hour = hour;
+    columns.minute = minute;
+    columns.second = second;
+    columns.dayOfWeek = dayOfWeek;
+    columns.dayOfYear = dayOfYear;
+    columns.quarterOfYear = quarterOfYear;
+    columns.weekOfMonth = weekOfMonth;
+    TransformBatch(dates, count, columns);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        TimePoint tp(SysClock::from_time_t(dates[i]));
+        ASSERT_EQ(year[i], tp.year);
+        ASSERT_EQ(month[i], tp.month);
+        ASSERT_EQ(day[i], tp.day);
+        ASSERT_EQ(hour[i], tp.hour);
+        ASSERT_EQ(minute[i], tp.minute);
+        ASSERT_EQ(second[i], tp.second);
+        ASSERT_EQ(dayOfWeek[i], tp.dayOfWeek);
+        ASSERT_EQ(dayOfYear[i], tp.dayOfYear);
+        ASSERT_EQ(quarterOfYear[i], tp.quarterOfYear);
+        ASSERT_EQ(weekOfMonth[i], tp.weekOfMonth);
+    }
+}
+
+TEST(DateTimeFeaturizer_TransformBatch, Pre_Epoch__1776_July_4) {
+    const std::int64_t date = -6106060800;
+
+    std::int32_t year;
+    std::uint8_t month, day, hour, minute, second, dayOfWeek, quarterOfYear, weekOfMonth;
+    std::uint16_t dayOfYear;
+    TimePointColumns columns;
+    columns.year = &year;
+    columns.month = &month;
+    columns.day = &day;
+    columns.hour = &hour;
+    columns.minute = &minute;
+    columns.second = &second;
+    columns.dayOfWeek = &dayOfWeek;
+    columns.dayOfYear = &dayOfYear;
+    columns.quarterOfYear = &quarterOfYear;
+    columns.weekOfMonth = &weekOfMonth;
+    TransformBatch(&date, 1, columns);
+
+    ASSERT_EQ(year, 1776);
+    ASSERT_EQ(month, TimePoint::JULY);
+    ASSERT_EQ(day, 4);
+    ASSERT_EQ(dayOfWeek, TimePoint::THURSDAY);
+    ASSERT_EQ(dayOfYear, 185);
+}
+
 } // namespace DateTimeFeaturizer
 } // namespace Featurizer
 } // namespace Microsoft
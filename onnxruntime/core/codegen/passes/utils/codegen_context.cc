@@ -4,6 +4,7 @@
 #include "core/codegen/passes/utils/codegen_context.h"
 
 #include "core/codegen/common/common.h"
+#include "gsl/gsl_util"
 
 namespace onnxruntime {
 namespace tvm_codegen {
@@ -12,7 +13,11 @@ CodeGenContext::CodeGenContext(
     const codegen::CodeGenHandle* handle)
     : handle_(handle), unname_symbol_counter_(0) {}
 
-tvm::Var CodeGenContext::GetOrCreateDynamicDim(const std::string& name) {
+tvm::Expr CodeGenContext::GetOrCreateDynamicDim(const std::string& name) {
+  auto iter = specialized_dims_.find(name);
+  if (iter != specialized_dims_.end())
+    return tvm::Expr(gsl::narrow_cast<int32_t>(iter->second));
+
   if (dynamic_dims_.count(name) == 0)
     dynamic_dims_.emplace(name, tvm::Var(name));
 
@@ -20,8 +20,13 @@ class CodeGenContext {
 
   virtual ~CodeGenContext() = default;
 
-  // returns tvm::Var for the dynamic dim
-  tvm::Var GetOrCreateDynamicDim(const std::string& name);
+  // returns tvm::Var for the dynamic dim, or its value if the dim is specialized
+  tvm::Expr GetOrCreateDynamicDim(const std::string& name);
+
+  // specializes dynamic dims to values, so that the IR is built for these values only
+  void SetSpecializedDims(const std::unordered_map<std::string, int64_t>& dims) {
+    specialized_dims_ = dims;
+  }
 
   const codegen::CodeGenHandle* GetCodeGenHandle() const {
     return handle_;
@@ -32,6 +37,8 @@ class CodeGenContext {
  protected:
   std::unordered_map<std::string, tvm::Var> dynamic_dims_;
 
+  std::unordered_map<std::string, int64_t> specialized_dims_;
+
   const codegen::CodeGenHandle* handle_;
 
   int unname_symbol_counter_;
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/codegen/passes/weight_layout/packed_panels_2d.h"
+
+#include "core/codegen/passes/utils/codegen_context.h"
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+constexpr auto local_name_prefix = "packed_panels_2d_";
+
+static std::string PackedPanelsName(int panel_width, int interleave) {
+  return local_name_prefix + std::to_string(panel_width) + "_" + std::to_string(interleave);
+}
+
+const std::string WeightLayoutPackedPanels2D::GetKey(
+    ONNX_NAMESPACE::TensorProto_DataType proto_type,
+    int panel_width,
+    int interleave) {
+  return WeightLayout::GetKey(
+      PackedPanelsName(panel_width, interleave),
+      proto_type, 2, 0.0f);
+}
+
+WeightLayoutPackedPanels2D::WeightLayoutPackedPanels2D(
+    ONNX_NAMESPACE::TensorProto_DataType proto_type,
+    int panel_width,
+    int interleave)
+    : WeightLayout(
+          PackedPanelsName(panel_width, interleave),
+          proto_type, 2, 0.0f),
+      panel_width_(panel_width),
+      interleave_(interleave) {
+  ORT_ENFORCE(panel_width_ > 0 && interleave_ > 0);
+}
+
+CoordTransFunc WeightLayoutPackedPanels2D::ToActual(const tvm::Tensor& /*X*/) const {
+  return [&](const tvm::Array<tvm::Expr>& nominal_coord) {
+    ORT_ENFORCE(nominal_coord.size() == 2);
+    const auto& k = nominal_coord[0];
+    const auto& n = nominal_coord[1];
+    return tvm::Array<tvm::Expr>{
+        n / panel_width_,
+        k / interleave_,
+        n % panel_width_,
+        k % interleave_};
+  };
+}
+
+CoordTransFunc WeightLayoutPackedPanels2D::ToNominal(const tvm::Tensor& /*X*/) const {
+  return [&](const tvm::Array<tvm::Expr>& actual_coord) {
+    ORT_ENFORCE(actual_coord.size() == 4);
+    const auto& panel = actual_coord[0];
+    const auto& k_block = actual_coord[1];
+    const auto& n_in_panel = actual_coord[2];
+    const auto& k_in_block = actual_coord[3];
+    return tvm::Array<tvm::Expr>{
+        k_in_block + interleave_ * k_block,
+        n_in_panel + panel_width_ * panel};
+  };
+}
+
+tvm::Array<tvm::Expr> WeightLayoutPackedPanels2D::ToActualShape(const tvm::Tensor& X) const {
+  tvm::Array<tvm::Expr> new_shape = {
+      (X->shape[1] + panel_width_ - 1) / panel_width_,
+      (X->shape[0] + interleave_ - 1) / interleave_,
+      panel_width_,
+      interleave_};
+  return new_shape;
+}
+
+std::vector<int64_t> WeightLayoutPackedPanels2D::ToActualShape(const Tensor* X) const {
+  ORT_ENFORCE(X != nullptr);
+  auto old_shape = X->Shape().GetDims();
+
+  ORT_ENFORCE(old_shape.size() == 2);
+
+  std::vector<int64_t> new_shape = {
+      (old_shape[1] + panel_width_ - 1) / panel_width_,
+      (old_shape[0] + interleave_ - 1) / interleave_,
+      panel_width_,
+      interleave_};
+
+  return new_shape;
+}
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/codegen/common/common.h"
+#include "core/codegen/passes/weight_layout/weight_layout.h"
+#include <tvm/tvm.h>
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+// WeightLayoutPackedPanels2D for packing a 2D weight [K, N] into panels of panel_width columns,
+// the tile width of a GEMM microkernel, with interleave consecutive rows of a column stored together,
+// like the 4 int8 values a VNNI dot product (vpdpbusd) reduces into an int32 lane, or 2 int16 values for vpmaddwd.
+// [K, N] => [N/panel_width, K/interleave, panel_width, interleave], padded with zeros
+class WeightLayoutPackedPanels2D : public WeightLayout {
+ public:
+  static const std::string GetKey(
+      ONNX_NAMESPACE::TensorProto_DataType proto_type,
+      int panel_width,
+      int interleave);
+
+ public:
+  WeightLayoutPackedPanels2D(
+      ONNX_NAMESPACE::TensorProto_DataType proto_type,
+      int panel_width,
+      int interleave);
+
+  ~WeightLayoutPackedPanels2D() = default;
+
+  virtual CoordTransFunc ToNominal(const tvm::Tensor& X) const override;
+  virtual CoordTransFunc ToActual(const tvm::Tensor& X) const override;
+  tvm::Array<tvm::Expr> ToActualShape(const tvm::Tensor& X) const override;
+  std::vector<int64_t> ToActualShape(const Tensor* X) const override;
+
+ private:
+  int panel_width_;
+  int interleave_;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WeightLayoutPackedPanels2D);
+};
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/cpuid_info.h"
+
+namespace onnxruntime {
+
+/**
+Selects, among the builds of a CPU kernel for several instruction set levels, the one for the highest level the CPU
+supports, so a single binary runs the kernels at full speed on every CPU. The builds for a level are compiled in
+source files of their own with the flags of the level (the *_avx2.cc and *_avx512.cc files of the CPU execution
+provider, see onnxruntime_providers.cmake), and only called once the CPU is known to support it.
+
+Sample usage, selecting once at load:
+
+  static const KernelFn kernel = CpuIsaDispatch<KernelFn>(KernelBaseline)
+                                     .Add(CpuIsa::kAVX2, KernelAvx2)
+                                     .Add(CpuIsa::kAVX512, KernelAvx512)
+                                     .Get();
+*/
+template <typename T>
+class CpuIsaDispatch {
+ public:
+  // baseline is built for the instructions every supported CPU has.
+  explicit CpuIsaDispatch(T baseline) : selected_(baseline) {}
+
+  // Select build, for the instructions of isa, if the CPU supports them. The builds are added from the lowest level
+  // up, so the last one supported wins.
+  CpuIsaDispatch& Add(CpuIsa isa, T build) {
+    if (CPUIDInfo::GetCPUIDInfo().Supports(isa)) {
+      selected_ = build;
+      selected_isa_ = isa;
+    }
+    return *this;
+  }
+
+  T Get() const { return selected_; }
+  CpuIsa GetIsa() const { return selected_isa_; }
+
+ private:
+  T selected_;
+  CpuIsa selected_isa_ = CpuIsa::kBaseline;
+};
+
+}  // namespace onnxruntime
@@ -5,6 +5,10 @@
 #define PLATFORM_X86
 #endif
 
+#if defined(__aarch64__) && defined(__linux__)
+#define PLATFORM_ARM64_LINUX
+#endif
+
 #if defined(PLATFORM_X86)
 #include <memory>
 #include <mutex>
@@ -16,16 +20,30 @@
 #endif
 #endif
 
+#if defined(PLATFORM_ARM64_LINUX)
+#include <sys/auxv.h>
+
+#ifndef HWCAP_ASIMDDP
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+#ifndef HWCAP2_BF16
+#define HWCAP2_BF16 (1 << 14)
+#endif
+#endif
+
 #include "core/common/cpuid_info.h"
 
 namespace onnxruntime {
 
 #if defined(PLATFORM_X86)
-static inline void GetCPUID(int function_id, int data[4]) {  // NOLINT
+static inline void GetCPUID(int function_id, int subfunction_id, int data[4]) {  // NOLINT
 #if defined(_MSC_VER)
-  __cpuid(reinterpret_cast<int*>(data), function_id);
+  __cpuidex(reinterpret_cast<int*>(data), function_id, subfunction_id);
 #elif defined(__GNUC__)
-  __cpuid(function_id, data[0], data[1], data[2], data[3]);
+  __cpuid_count(function_id, subfunction_id, data[0], data[1], data[2], data[3]);
 #endif
 }
 
@@ -45,11 +63,11 @@ static inline int XGETBV() {
 CPUIDInfo::CPUIDInfo() noexcept {
 #if defined(PLATFORM_X86)
   int data[4] = {-1};
-  GetCPUID(0, data);
+  GetCPUID(0, 0, data);
 
   int num_IDs = data[0];
   if (num_IDs >= 1) {
-    GetCPUID(1, data);
+    GetCPUID(1, 0, data);
     if (data[2] & (1 << 27)) {
       const int AVX_MASK = 0x6;
       const int AVX512_MASK = 0xE6;
@@ -57,15 +75,50 @@ CPUIDInfo::CPUIDInfo() noexcept {
       bool has_avx = (data[2] & (1 << 28)) && ((value & AVX_MASK) == AVX_MASK);
       bool has_avx512 = (value & AVX512_MASK) == AVX512_MASK;
       has_f16c_ = has_avx && (data[2] & (1 << 29)) && (data[3] & (1 << 26));
+      has_fma_ = has_avx && (data[2] & (1 << 12));
 
       if (num_IDs >= 7) {
-        GetCPUID(7, data);
+        GetCPUID(7, 0, data);
+        const int max_subfunction_id = data[0];
         has_avx2_ = has_avx && (data[1] & (1 << 5));
         has_avx512f_ = has_avx512 && (data[1] & (1 << 16));
+        has_avx512bw_ = has_avx512f_ && (data[1] & (1 << 30));
+        has_avx512vl_ = has_avx512f_ && (data[1] & (1 << 31));
+        has_avx512_vnni_ = has_avx512f_ && (data[2] & (1 << 11));
+
+        if (max_subfunction_id >= 1) {
+          GetCPUID(7, 1, data);
+          has_avx_vnni_ = has_avx2_ && (data[0] & (1 << 4));
+          has_avx512_bf16_ = has_avx512f_ && (data[0] & (1 << 5));
+        }
       }
     }
   }
+#elif defined(PLATFORM_ARM64_LINUX)
+  const unsigned long hwcap = getauxval(AT_HWCAP);
+  const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+  has_arm_neon_dot_ = (hwcap & HWCAP_ASIMDDP) != 0;
+  has_arm_sve_ = (hwcap & HWCAP_SVE) != 0;
+  has_arm_bf16_ = (hwcap2 & HWCAP2_BF16) != 0;
 #endif
 }
 
+bool CPUIDInfo::Supports(CpuIsa isa) const {
+  switch (isa) {
+    case CpuIsa::kBaseline:
+      return true;
+    case CpuIsa::kAVX2:
+      return has_avx2_ && has_fma_ && has_f16c_;
+    case CpuIsa::kAVX512:
+      return has_avx512f_ && has_avx512bw_ && has_avx512vl_ && Supports(CpuIsa::kAVX2);
+    case CpuIsa::kAVX512Vnni:
+      return has_avx512_vnni_ && Supports(CpuIsa::kAVX512);
+    case CpuIsa::kArmNeonDot:
+      return has_arm_neon_dot_;
+    case CpuIsa::kArmSVE:
+      return has_arm_sve_ && has_arm_neon_dot_;
+  }
+  return false;
+}
+
 }  // namespace onnxruntime
@@ -5,6 +5,24 @@
 
 namespace onnxruntime {
 
+/**
+The instruction set levels the CPU kernels are built for, each a superset of the previous one of its architecture.
+See CpuIsaDispatch.
+*/
+enum class CpuIsa {
+  kBaseline,
+  // AVX2 with FMA and F16C
+  kAVX2,
+  // AVX-512 F, BW and VL
+  kAVX512,
+  // kAVX512 with the VNNI int8 dot products
+  kAVX512Vnni,
+  // ARM64 with the NEON int8 dot products
+  kArmNeonDot,
+  // kArmNeonDot with SVE
+  kArmSVE,
+};
+
 class CPUIDInfo {
 public:
   static const CPUIDInfo& GetCPUIDInfo() {
@@ -15,12 +33,33 @@ public:
   bool HasAVX2() const { return has_avx2_; }
   bool HasAVX512f() const { return has_avx512f_; }
   bool HasF16C() const { return has_f16c_; }
+  bool HasFMA() const { return has_fma_; }
+  bool HasAVX512bw() const { return has_avx512bw_; }
+  bool HasAVX512vl() const { return has_avx512vl_; }
+  bool HasAVX512Vnni() const { return has_avx512_vnni_; }
+  bool HasAVXVnni() const { return has_avx_vnni_; }
+  bool HasAVX512Bf16() const { return has_avx512_bf16_; }
+  bool HasArmNeonDot() const { return has_arm_neon_dot_; }
+  bool HasArmSVE() const { return has_arm_sve_; }
+  bool HasArmBf16() const { return has_arm_bf16_; }
+
+  // whether the CPU supports the instructions of isa
+  bool Supports(CpuIsa isa) const;
 
 private:
   CPUIDInfo() noexcept;
   bool has_avx2_{false};
   bool has_avx512f_{false};
   bool has_f16c_{false};
+  bool has_fma_{false};
+  bool has_avx512bw_{false};
+  bool has_avx512vl_{false};
+  bool has_avx512_vnni_{false};
+  bool has_avx_vnni_{false};
+  bool has_avx512_bf16_{false};
+  bool has_arm_neon_dot_{false};
+  bool has_arm_sve_{false};
+  bool has_arm_bf16_{false};
 };
 
 }  // namespace onnxruntime
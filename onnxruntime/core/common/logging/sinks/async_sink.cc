@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <iterator>
+#include <vector>
+
+namespace onnxruntime {
+namespace logging {
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, size_t max_queued_messages)
+    : sink_{std::move(sink)}, max_queued_messages_{max_queued_messages > 0 ? max_queued_messages : 1} {
+  thread_ = std::thread([this]() { SendQueued(); });
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stop_ = true;
+  }
+  queued_cv_.notify_one();
+  thread_.join();
+}
+
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  // copy the message before taking the lock, so the threads logging only contend for the queue
+  QueuedMessage queued{timestamp, logger_id, message.Severity(), message.Category(), message.DataType(),
+                       message.Location(), message.Message()};
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    dequeued_cv_.wait(lock, [this]() { return queue_.size() < max_queued_messages_; });
+    queue_.push_back(std::move(queued));
+  }
+  queued_cv_.notify_one();
+}
+
+void AsyncSink::SendQueued() {
+  std::vector<QueuedMessage> batch;
+  for (;;) {
+    {
+      std::unique_lock<OrtMutex> lock(mutex_);
+      queued_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        // stop_ is set and every message was sent
+        return;
+      }
+      batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.end()));
+      queue_.clear();
+    }
+    dequeued_cv_.notify_all();
+
+    for (const QueuedMessage& queued : batch) {
+      Capture capture{queued.severity, queued.category, queued.data_type, queued.location};
+      capture.Stream() << queued.message;
+      sink_->Send(queued.timestamp, queued.logger_id, capture);
+    }
+    batch.clear();
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/common/code_location.h"
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// An ISink that queues the messages and sends them to another sink from a thread of its own, so logging a message
+/// only costs the thread logging it a copy of the message, however slow the other sink is to write it.
+/// The messages queued are all sent before the sink is destroyed.
+/// </summary>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncSink"/> class.
+  /// </summary>
+  /// <param name="sink">The sink the messages are sent to.</param>
+  /// <param name="max_queued_messages">The messages queued at most. Logging a message waits for the queue to have
+  /// room, so the memory of the queue is bounded however fast the messages come.</param>
+  explicit AsyncSink(std::unique_ptr<ISink> sink, size_t max_queued_messages = 4096);
+
+  ~AsyncSink() override;
+
+  /// <summary>
+  /// Sends the profiling event to the sink, from the calling thread.
+  /// </summary>
+  void SendProfileEvent(profiling::EventRecord& event_record) const override {
+    sink_->SendProfileEvent(event_record);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncSink);
+
+  struct QueuedMessage {
+    Timestamp timestamp;
+    std::string logger_id;
+    Severity severity;
+    const char* category;
+    DataType data_type;
+    CodeLocation location;
+    std::string message;
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  // sends the messages queued to sink_ until the sink is destroyed
+  void SendQueued();
+
+  const std::unique_ptr<ISink> sink_;
+  const size_t max_queued_messages_;
+  OrtMutex mutex_;
+  OrtCondVar queued_cv_;
+  OrtCondVar dequeued_cv_;
+  std::deque<QueuedMessage> queue_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
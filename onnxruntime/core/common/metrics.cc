@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace onnxruntime {
+namespace metrics {
+
+namespace {
+std::string FormatValue(double value) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.15g", value);
+  return buffer;
+}
+
+// name="value" pairs separated by commas, with the values escaped as the text format requires
+std::string LabelsText(const Labels& labels) {
+  std::string text;
+  for (const auto& label : labels) {
+    if (!text.empty()) {
+      text += ',';
+    }
+    text += label.first;
+    text += "=\"";
+    for (char c : label.second) {
+      if (c == '\\' || c == '"') {
+        text += '\\';
+        text += c;
+      } else if (c == '\n') {
+        text += "\\n";
+      } else {
+        text += c;
+      }
+    }
+    text += '"';
+  }
+  return text;
+}
+
+std::string Braced(const std::string& labels_text) {
+  return labels_text.empty() ? std::string() : "{" + labels_text + "}";
+}
+
+void WriteHeader(std::ostringstream& out, const std::string& name, const std::string& help, const char* type) {
+  out << "# HELP " << name << ' ' << help << '\n';
+  out << "# TYPE " << name << ' ' << type << '\n';
+}
+
+template <typename T>
+T& GetOrCreate(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& labels_text,
+               const std::function<std::unique_ptr<T>()>& create) {
+  auto& metric = metrics[labels_text];
+  if (metric == nullptr) {
+    metric = create();
+  }
+  return *metric;
+}
+}  // namespace
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)), buckets_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void Histogram::Observe(double value) {
+  const size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  double sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<uint64_t> Histogram::BucketCounts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+void MetricsRegistry::Collection::Add(const std::string& name, const std::string& help, const Labels& labels,
+                                      double value) {
+  auto& family = families_[name];
+  if (family.help.empty()) {
+    family.help = help;
+  }
+  family.values[LabelsText(labels)] += value;
+}
+
+Counter& MetricsRegistry::GetCounter(const std::string& name, const std::string& help, const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = counters_[name];
+  family.help = help;
+  return GetOrCreate<Counter>(family.metrics, LabelsText(labels), []() { return std::make_unique<Counter>(); });
+}
+
+Gauge& MetricsRegistry::GetGauge(const std::string& name, const std::string& help, const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = gauges_[name];
+  family.help = help;
+  return GetOrCreate<Gauge>(family.metrics, LabelsText(labels), []() { return std::make_unique<Gauge>(); });
+}
+
+Histogram& MetricsRegistry::GetHistogram(const std::string& name, const std::string& help,
+                                         const std::vector<double>& bounds, const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = histograms_[name];
+  family.help = help;
+  return GetOrCreate<Histogram>(family.metrics, LabelsText(labels),
+                                [&bounds]() { return std::make_unique<Histogram>(bounds); });
+}
+
+size_t MetricsRegistry::AddCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  const size_t id = next_collector_id_++;
+  collectors_.emplace(id, std::move(collector));
+  return id;
+}
+
+void MetricsRegistry::RemoveCollector(size_t id) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  collectors_.erase(id);
+}
+
+std::string MetricsRegistry::ToPrometheusText() {
+  Collection collection;
+  {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (auto& collector : collectors_) {
+      collector.second(collection);
+    }
+  }
+
+  std::ostringstream out;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& family : counters_) {
+    WriteHeader(out, family.first, family.second.help, "counter");
+    for (const auto& metric : family.second.metrics) {
+      out << family.first << Braced(metric.first) << ' ' << metric.second->Value() << '\n';
+    }
+  }
+
+  for (const auto& family : gauges_) {
+    WriteHeader(out, family.first, family.second.help, "gauge");
+    for (const auto& metric : family.second.metrics) {
+      out << family.first << Braced(metric.first) << ' ' << FormatValue(metric.second->Value()) << '\n';
+    }
+  }
+
+  for (const auto& family : collection.families_) {
+    WriteHeader(out, family.first, family.second.help, "gauge");
+    for (const auto& value : family.second.values) {
+      out << family.first << Braced(value.first) << ' ' << FormatValue(value.second) << '\n';
+    }
+  }
+
+  for (const auto& family : histograms_) {
+    WriteHeader(out, family.first, family.second.help, "histogram");
+    for (const auto& metric : family.second.metrics) {
+      const Histogram& histogram = *metric.second;
+      const std::string prefix = metric.first.empty() ? std::string() : metric.first + ",";
+      const auto counts = histogram.BucketCounts();
+      uint64_t cumulated = 0;
+      for (size_t i = 0; i < counts.size(); ++i) {
+        cumulated += counts[i];
+        const std::string bound = i < histogram.Bounds().size() ? FormatValue(histogram.Bounds()[i]) : "+Inf";
+        out << family.first << "_bucket{" << prefix << "le=\"" << bound << "\"} " << cumulated << '\n';
+      }
+      out << family.first << "_sum" << Braced(metric.first) << ' ' << FormatValue(histogram.Sum()) << '\n';
+      out << family.first << "_count" << Braced(metric.first) << ' ' << histogram.Count() << '\n';
+    }
+  }
+
+  return out.str();
+}
+
+MetricsRegistry& MetricsRegistry::Global() {
+  // never destroyed, so that the collectors of static objects can be removed at exit
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+const std::vector<double>& MetricsRegistry::DefaultDurationBounds() {
+  static const std::vector<double> bounds{0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                          0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+  return bounds;
+}
+
+}  // namespace metrics
+}  // namespace onnxruntime
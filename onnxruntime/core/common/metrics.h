@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+namespace metrics {
+
+// the label names and values of a metric, e.g. {{"session", "my_session"}}
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter {
+ public:
+  void Add(uint64_t value) { value_.fetch_add(value, std::memory_order_relaxed); }
+  void Increment() { Add(1); }
+  uint64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+class Gauge {
+ public:
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+  double Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0};
+};
+
+// Counts the observed values in the buckets of fixed upper bounds, and keeps their count and sum.
+class Histogram {
+ public:
+  // bounds are the sorted upper bounds of the buckets, the last bucket without upper bound is implicit
+  explicit Histogram(std::vector<double> bounds);
+
+  void Observe(double value);
+
+  const std::vector<double>& Bounds() const { return bounds_; }
+  // the number of values in each bucket, not cumulated. one more than the bounds.
+  std::vector<uint64_t> BucketCounts() const;
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  double Sum() const { return sum_.load(std::memory_order_relaxed); }
+
+ private:
+  const std::vector<double> bounds_;
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<double> sum_{0};
+};
+
+/**
+The metrics of the process, exported in the Prometheus text format.
+The counters, gauges and histograms are created on first use and live as long as the registry, so the components
+look them up once and update them without locking.
+Values which are cheaper to read when exporting than to keep up to date, such as the bytes in use in an arena,
+are given by collectors, which are called at each export.
+*/
+class MetricsRegistry {
+ public:
+  // the values given by the collectors of an export. the values of a name and labels are summed.
+  class Collection {
+   public:
+    void Add(const std::string& name, const std::string& help, const Labels& labels, double value);
+
+   private:
+    friend class MetricsRegistry;
+    struct Family {
+      std::string help;
+      std::map<std::string, double> values;
+    };
+    std::map<std::string, Family> families_;
+  };
+
+  using Collector = std::function<void(Collection&)>;
+
+  Counter& GetCounter(const std::string& name, const std::string& help, const Labels& labels = {});
+  Gauge& GetGauge(const std::string& name, const std::string& help, const Labels& labels = {});
+  // the bounds of a histogram are the ones given when it is created
+  Histogram& GetHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds,
+                          const Labels& labels = {});
+
+  // returns the id to remove the collector with. a collector is not called anymore once removed.
+  size_t AddCollector(Collector collector);
+  void RemoveCollector(size_t id);
+
+  std::string ToPrometheusText();
+
+  // the registry of the process
+  static MetricsRegistry& Global();
+
+  // the upper bounds of the buckets of durations in seconds, from 100 us to 10 s
+  static const std::vector<double>& DefaultDurationBounds();
+
+ private:
+  template <typename T>
+  struct Family {
+    std::string help;
+    // by the text of the labels
+    std::map<std::string, std::unique_ptr<T>> metrics;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, Family<Counter>> counters_;
+  std::map<std::string, Family<Gauge>> gauges_;
+  std::map<std::string, Family<Histogram>> histograms_;
+
+  // held while the collectors are called, so that a collector isn't removed during its call
+  std::mutex collectors_mutex_;
+  std::map<size_t, Collector> collectors_;
+  size_t next_collector_id_ = 0;
+};
+
+}  // namespace metrics
+}  // namespace onnxruntime
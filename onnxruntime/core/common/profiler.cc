@@ -2,19 +2,73 @@
 // Licensed under the MIT License.
 
 #include "profiler.h"
+#include <sstream>
+#include "core/platform/hardware_counters.h"
 
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
 
+// number of events the ring buffer of a thread holds until they are drained. Events are dropped once it is full.
+static constexpr size_t kSampledEventsRingCapacity = 4096;
+static constexpr int kSampledEventsDrainIntervalMs = 100;
+
+static std::atomic<uint64_t> next_sampling_id{1};
+
+// the ids of StartEpEvents, unique in the process as the device work of all the sessions is recorded together
+static std::atomic<uint64_t> next_ep_events_id{1};
+
+/*
+Single producer, single consumer ring buffer of the sampled events of a thread. The thread pushes its events,
+and DrainSampledEvents pops them.
+*/
+class Profiler::SampledEventRing {
+ public:
+  SampledEventRing() : events_(new SampledEvent[kSampledEventsRingCapacity]), tid_(logging::GetThreadId()) {}
+
+  int ThreadId() const { return tid_; }
+
+  bool Push(const SampledEvent& event) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kSampledEventsRingCapacity) {
+      return false;
+    }
+    events_[head % kSampledEventsRingCapacity] = event;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename TFunc>
+  void Drain(TFunc&& func) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    for (size_t i = tail; i != head; ++i) {
+      func(events_[i % kSampledEventsRingCapacity]);
+    }
+    tail_.store(head, std::memory_order_release);
+  }
+
+ private:
+  std::unique_ptr<SampledEvent[]> events_;
+  const int tid_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+// defined here, where SampledEventRing is complete
+Profiler::Profiler() noexcept : creation_time_(std::chrono::high_resolution_clock::now()) {}  //NOLINT
+
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
 Profiler* Profiler::instance_ = nullptr;
 
 profiling::Profiler::~Profiler() {
+  StopSampling();
   instance_ = nullptr;
 }
 #else
-profiling::Profiler::~Profiler() {}
+profiling::Profiler::~Profiler() {
+  StopSampling();
+}
 #endif
 
 ::onnxruntime::TimePoint profiling::Profiler::StartTime() const {
@@ -40,6 +94,9 @@ void Profiler::StartProfiling(const logging::Logger* custom_logger) {
   profile_with_logger_ = true;
   custom_logger_ = custom_logger;
   profiling_start_time_ = StartTime();
+  for (auto& ep_profiler : ep_profilers_) {
+    ep_profiler->StartProfiling(profiling_start_time_);
+  }
 }
 
 template <typename T>
@@ -48,6 +105,9 @@ void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
   profile_stream_ = std::ofstream(file_name, std::ios::out | std::ios::trunc);
   profile_stream_file_ = ToMBString(file_name);
   profiling_start_time_ = StartTime();
+  for (auto& ep_profiler : ep_profilers_) {
+    ep_profiler->StartProfiling(profiling_start_time_);
+  }
 }
 
 template void Profiler::StartProfiling<char>(const std::basic_string<char>& file_name);
@@ -65,10 +125,26 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
 
   EventRecord event(category, logging::GetProcessId(),
                     logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+  //TODO: sync_gpu if needed.
+  RecordEvent(event);
+}
+
+void Profiler::EndTimeAndRecordEventWithArgs(EventCategory category,
+                                             const std::string& event_name,
+                                             TimePoint& start_time,
+                                             std::unordered_map<std::string, std::string>&& event_args) {
+  long long dur = TimeDiffMicroSeconds(start_time);
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+
+  EventRecord event(category, logging::GetProcessId(),
+                    logging::GetThreadId(), event_name, ts, dur, std::move(event_args));
+  RecordEvent(event);
+}
+
+void Profiler::RecordEvent(EventRecord& event) {
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
-    //TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
       events_.emplace_back(event);
@@ -82,10 +158,197 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
   }
 }
 
+void Profiler::RecordInitializationPhase(const std::string& phase_name,
+                                         TimePoint& start_time,
+                                         std::unordered_map<std::string, std::string>&& phase_args) {
+  const long long dur = TimeDiffMicroSeconds(start_time);
+  const int pid = logging::GetProcessId();
+  const int tid = logging::GetThreadId();
+  if (enabled_) {
+    EventRecord event(SESSION_EVENT, pid, tid, phase_name, TimeDiffMicroSeconds(profiling_start_time_, start_time),
+                      dur, std::unordered_map<std::string, std::string>(phase_args));
+    RecordEvent(event);
+  }
+
+  std::lock_guard<OrtMutex> lock(initialization_phases_mutex_);
+  initialization_phases_.emplace_back(SESSION_EVENT, pid, tid, phase_name,
+                                      TimeDiffMicroSeconds(creation_time_, start_time), dur, std::move(phase_args));
+}
+
+std::string Profiler::GetInitializationTimings() const {
+  std::ostringstream stream;
+  stream << "[\n";
+  std::lock_guard<OrtMutex> lock(initialization_phases_mutex_);
+  for (size_t i = 0; i < initialization_phases_.size(); ++i) {
+    WriteEvent(stream, initialization_phases_[i]);
+    stream << (i == initialization_phases_.size() - 1 ? "\n" : ",\n");
+  }
+  stream << "]\n";
+  return stream.str();
+}
+
+void Profiler::WriteEvent(std::ostream& stream, const EventRecord& event) {
+  stream << R"({"cat" : ")" << event_categor_names_[event.cat] << "\",";
+  stream << "\"pid\" :" << event.pid << ",";
+  stream << "\"tid\" :" << event.tid << ",";
+  stream << "\"dur\" :" << event.dur << ",";
+  stream << "\"ts\" :" << event.ts << ",";
+  stream << R"("ph" : "X",)";
+  stream << R"("name" :")" << event.name << "\",";
+  stream << "\"args\" : {";
+  bool is_first_arg = true;
+  for (const auto& event_arg : event.args) {
+    if (!is_first_arg) stream << ",";
+    stream << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
+    is_first_arg = false;
+  }
+  stream << "}}";
+}
+
+void Profiler::AddEpProfiler(std::unique_ptr<EpProfiler> ep_profiler) {
+  ORT_ENFORCE(ep_profiler != nullptr);
+  if (enabled_) {
+    ep_profiler->StartProfiling(profiling_start_time_);
+  }
+  ep_profilers_.push_back(std::move(ep_profiler));
+}
+
+uint64_t Profiler::StartEpEvents(const std::string& node_name) {
+  const uint64_t id = next_ep_events_id.fetch_add(1, std::memory_order_relaxed);
+  for (auto& ep_profiler : ep_profilers_) {
+    ep_profiler->Start(id, node_name);
+  }
+  return id;
+}
+
+void Profiler::StopEpEvents(uint64_t id) {
+  for (auto& ep_profiler : ep_profilers_) {
+    ep_profiler->Stop(id);
+  }
+}
+
+void Profiler::EnableHardwareCounters() {
+  ORT_ENFORCE(enabled_, "Profiling must be started before hardware counters are enabled.");
+
+  std::string reason;
+  if (HardwareCounters::ForCurrentThread(&reason) == nullptr) {
+    LOGS(*session_logger_, WARNING) << "Hardware counters are not recorded in the profile: " << reason;
+    return;
+  }
+  hardware_counters_enabled_ = true;
+}
+
+void Profiler::EnableSampling(int sampling_interval) {
+  ORT_ENFORCE(enabled_, "Profiling must be started before sampling is enabled.");
+  ORT_ENFORCE(sampling_interval > 0, "Invalid profiling sampling interval: ", sampling_interval);
+  ORT_ENFORCE(!IsSampling(), "Profiling sampling is already enabled.");
+
+  sampling_interval_ = sampling_interval;
+  sampling_id_ = next_sampling_id.fetch_add(1);
+  stop_draining_ = false;
+  drain_thread_ = std::thread([this]() {
+    std::unique_lock<OrtMutex> lock(drain_mutex_);
+    while (!stop_draining_) {
+      drain_cv_.wait_for(lock, std::chrono::milliseconds(kSampledEventsDrainIntervalMs));
+      lock.unlock();
+      DrainSampledEvents();
+      lock.lock();
+    }
+  });
+}
+
+Profiler::SampledEventRing& Profiler::ThreadRing() {
+  // the profiler the thread recorded its last sampled event to, and the ring buffer of the thread in it
+  thread_local uint64_t cached_sampling_id = 0;
+  thread_local SampledEventRing* cached_ring = nullptr;
+
+  if (cached_sampling_id != sampling_id_) {
+    std::lock_guard<OrtMutex> lock(rings_mutex_);
+    auto& ring = rings_[std::this_thread::get_id()];
+    if (ring == nullptr) {
+      ring = std::make_unique<SampledEventRing>();
+    }
+    cached_ring = ring.get();
+    cached_sampling_id = sampling_id_;
+  }
+  return *cached_ring;
+}
+
+void Profiler::RecordSampledEvent(EventCategory category,
+                                  const std::string& event_name,
+                                  const char* name_suffix,
+                                  TimePoint& start_time,
+                                  const std::string* op_name,
+                                  const std::string* provider) {
+  SampledEvent event;
+  event.cat = category;
+  event.name = &event_name;
+  event.name_suffix = name_suffix;
+  event.op_name = op_name;
+  event.provider = provider;
+  event.dur = TimeDiffMicroSeconds(start_time);
+  event.ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+
+  if (!ThreadRing().Push(event)) {
+    num_dropped_sampled_events_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Profiler::DrainSampledEvents() {
+  const int pid = logging::GetProcessId();
+  std::lock_guard<OrtMutex> lock(rings_mutex_);
+  for (auto& ring : rings_) {
+    const int tid = ring.second->ThreadId();
+    ring.second->Drain([&](const SampledEvent& sampled) {
+      std::unordered_map<std::string, std::string> args;
+      if (sampled.op_name != nullptr) {
+        args.emplace("op_name", *sampled.op_name);
+      }
+      if (sampled.provider != nullptr) {
+        args.emplace("provider", *sampled.provider);
+      }
+      EventRecord event(sampled.cat, pid, tid, *sampled.name + sampled.name_suffix, sampled.ts, sampled.dur,
+                        std::move(args));
+      RecordEvent(event);
+    });
+  }
+}
+
+void Profiler::StopSampling() {
+  if (!drain_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<OrtMutex> lock(drain_mutex_);
+    stop_draining_ = true;
+  }
+  drain_cv_.notify_all();
+  drain_thread_.join();
+
+  // the events recorded since the last drain
+  DrainSampledEvents();
+
+  const size_t num_dropped = num_dropped_sampled_events_.load();
+  if (num_dropped > 0 && session_logger_) {
+    LOGS(*session_logger_, WARNING) << num_dropped << " sampled profile events were dropped as their ring buffer "
+                                    << "was full.";
+  }
+}
+
 std::string Profiler::EndProfiling() {
   if (!enabled_) {
     return std::string();
   }
+  StopSampling();
+
+  std::vector<EventRecord> ep_events;
+  for (auto& ep_profiler : ep_profilers_) {
+    ep_profiler->EndProfiling(profiling_start_time_, ep_events);
+  }
+  for (auto& event : ep_events) {
+    RecordEvent(event);
+  }
+
   if (profile_with_logger_) {
     profile_with_logger_ = false;
     return std::string();
@@ -99,27 +362,8 @@ std::string Profiler::EndProfiling() {
   profile_stream_ << "[\n";
 
   for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
-    profile_stream_ << R"({"cat" : ")" << event_categor_names_[rec.cat] << "\",";
-    profile_stream_ << "\"pid\" :" << rec.pid << ",";
-    profile_stream_ << "\"tid\" :" << rec.tid << ",";
-    profile_stream_ << "\"dur\" :" << rec.dur << ",";
-    profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
-    profile_stream_ << R"("name" :")" << rec.name << "\",";
-    profile_stream_ << "\"args\" : {";
-    bool is_first_arg = true;
-    for (std::pair<std::string, std::string> event_arg : rec.args) {
-      if (!is_first_arg) profile_stream_ << ",";
-      profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
-      is_first_arg = false;
-    }
-    profile_stream_ << "}";
-    if (i == events_.size() - 1) {
-      profile_stream_ << "}\n";
-    } else {
-      profile_stream_ << "},\n";
-    }
+    WriteEvent(profile_stream_, events_[i]);
+    profile_stream_ << (i == events_.size() - 1 ? "\n" : ",\n");
   }
   profile_stream_ << "]\n";
   profile_stream_.close();
@@ -2,10 +2,15 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <thread>
 #include <tuple>
 #include <initializer_list>
+#include <unordered_map>
+#include <vector>
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
 
@@ -17,6 +22,26 @@ namespace profiling {
 // note that static profiler instance only works with single session
 //#define ENABLE_STATIC_PROFILER_INSTANCE
 
+/**
+ * Records the work an execution provider runs asynchronously on its device, such as the kernels and copies of a
+ * GPU, and gives it as events of the session profile. The work is attributed to the nodes whose computation
+ * submitted it, between Start and Stop on the thread computing them.
+ */
+class EpProfiler {
+ public:
+  virtual ~EpProfiler() = default;
+
+  // start recording the work of the device. the events are timed from profiling_start_time.
+  virtual void StartProfiling(TimePoint profiling_start_time) = 0;
+
+  // stop recording, and append the events of the work recorded since StartProfiling
+  virtual void EndProfiling(TimePoint profiling_start_time, std::vector<EventRecord>& events) = 0;
+
+  // attribute the work submitted by the calling thread to the node until Stop. ids are unique in the process.
+  virtual void Start(uint64_t id, const std::string& node_name) = 0;
+  virtual void Stop(uint64_t id) = 0;
+};
+
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
@@ -25,7 +50,7 @@ class Profiler {
  public:
   /// turned off by default.
   /// Even this function is marked as noexcept, the code inside it may throw exceptions
-  Profiler() noexcept {};  //NOLINT
+  Profiler() noexcept;  //NOLINT
 
   ~Profiler();
 
@@ -67,6 +92,92 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a phase of loading or initializing the session, such as a graph transformer, the GetCapability of an
+  execution provider or the loading of the initializers. The phases are kept whether profiling is enabled or not,
+  see GetInitializationTimings, and are session events of the profile when it is.
+  */
+  void RecordInitializationPhase(const std::string& phase_name,
+                                 TimePoint& start_time,
+                                 std::unordered_map<std::string, std::string>&& phase_args = {});
+
+  /*
+  The phases recorded by RecordInitializationPhase as a JSON array of events in the chrome tracing format, timed
+  from the creation of the profiler.
+  */
+  std::string GetInitializationTimings() const;
+
+  /*
+  Record the device events of an execution provider in the profile, see EpProfiler. Started with the profiler, or
+  right away if profiling is already started.
+  */
+  void AddEpProfiler(std::unique_ptr<EpProfiler> ep_profiler);
+
+  bool HasEpProfilers() const {
+    return !ep_profilers_.empty();
+  }
+
+  /*
+  Attribute the device work submitted by the calling thread to the node until StopEpEvents, whose id is returned.
+  Only needed if HasEpProfilers.
+  */
+  uint64_t StartEpEvents(const std::string& node_name);
+  void StopEpEvents(uint64_t id);
+
+  /*
+  Sample the executions of the graphs instead of recording all their events. 1 in sampling_interval executions
+  records the events of its nodes with RecordSampledEvent, into per-thread lock-free ring buffers that a background
+  thread drains into the profile, so that the profiler can stay enabled in production.
+  Call after StartProfiling.
+  */
+  void EnableSampling(int sampling_interval);
+
+  /*
+  Whether the executions of the graphs are sampled. If so, they record their events with RecordSampledEvent
+  instead of EndTimeAndRecordEvent.
+  */
+  bool IsSampling() const {
+    return sampling_interval_ > 0;
+  }
+
+  /*
+  Record the hardware counters of the threads computing the nodes in their kernel time events, see
+  HardwareCounters. Call after StartProfiling. Logs a warning and leaves them disabled if they are not available.
+  */
+  void EnableHardwareCounters();
+
+  bool IsHardwareCountersEnabled() const {
+    return hardware_counters_enabled_;
+  }
+
+  /*
+  Whether the current execution of a graph is sampled. To be called once per execution.
+  */
+  bool SampleExecution() {
+    return sampling_counter_.fetch_add(1, std::memory_order_relaxed) % sampling_interval_ == 0;
+  }
+
+  /*
+  Same as EndTimeAndRecordEvent, with the arguments of the event built at run time.
+  */
+  void EndTimeAndRecordEventWithArgs(EventCategory category,
+                                     const std::string& event_name,
+                                     TimePoint& start_time,
+                                     std::unordered_map<std::string, std::string>&& event_args);
+
+  /*
+  Record an event of a sampled execution, without allocating or locking. The event is dropped if the ring buffer
+  of the thread is full. The strings are not copied, so they must outlive the profiler, e.g. the names of the
+  nodes of the graph and the strings of the kernel definitions. The name of the event is event_name followed by
+  name_suffix.
+  */
+  void RecordSampledEvent(EventCategory category,
+                          const std::string& event_name,
+                          const char* name_suffix,
+                          TimePoint& start_time,
+                          const std::string* op_name = nullptr,
+                          const std::string* provider = nullptr);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -85,6 +196,32 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  // fixed size event of a sampled execution, see RecordSampledEvent
+  struct SampledEvent {
+    EventCategory cat;
+    const std::string* name;
+    const char* name_suffix;
+    const std::string* op_name;
+    const std::string* provider;
+    long long ts;
+    long long dur;
+  };
+
+  class SampledEventRing;
+
+  // the ring buffer of the calling thread, created on its first sampled event
+  SampledEventRing& ThreadRing();
+
+  // move the sampled events from the ring buffers to the profile
+  void DrainSampledEvents();
+
+  void RecordEvent(EventRecord& event);
+
+  // write an event of the profile, without the separator
+  static void WriteEvent(std::ostream& stream, const EventRecord& event);
+
+  void StopSampling();
+
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
   bool enabled_{false};
@@ -95,9 +232,31 @@ class Profiler {
   TimePoint profiling_start_time_;
   std::vector<EventRecord> events_;
   bool max_events_reached{false};
+  // see RecordInitializationPhase
+  const TimePoint creation_time_;
+  mutable OrtMutex initialization_phases_mutex_;
+  std::vector<EventRecord> initialization_phases_;
   static constexpr size_t max_num_events_ = 1000000;
   bool profile_with_logger_{false};
 
+  bool hardware_counters_enabled_{false};
+
+  std::vector<std::unique_ptr<EpProfiler>> ep_profilers_;
+
+  int sampling_interval_{0};
+  std::atomic<uint64_t> sampling_counter_{0};
+  // identifies the profiler in the per-thread cache of ThreadRing, as its address may be reused
+  uint64_t sampling_id_{0};
+  // a ring buffer per thread recording sampled events, each written by its thread only
+  OrtMutex rings_mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<SampledEventRing>> rings_;
+  // drains the ring buffers every kSampledEventsDrainIntervalMs, until sampling stops
+  std::thread drain_thread_;
+  OrtMutex drain_mutex_;
+  OrtCondVar drain_cv_;
+  bool stop_draining_{false};
+  std::atomic<size_t> num_dropped_sampled_events_{0};
+
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
   static Profiler* instance_;
 #endif
@@ -3,8 +3,16 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/common/metrics.h"
+#include "core/platform/env.h"
 
+#include <algorithm>
 #include <cassert>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#include <emmintrin.h>
+#endif
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -25,12 +33,131 @@ using Eigen::Barrier;
 namespace onnxruntime {
 
 namespace concurrency {
+
+namespace {
+// Thread environment of the Eigen thread pool, which pins each thread it creates to one of the given processors.
+class AffinityThreadEnvironment {
+ public:
+  struct Task {
+    std::function<void()> f;
+  };
+
+  class EnvThread {
+   public:
+    explicit EnvThread(std::function<void()> f) : thr_(std::move(f)) {}
+    ~EnvThread() { thr_.join(); }
+    // This function is called when the threadpool is cancelled.
+    void OnCancel() {}
+
+   private:
+    std::thread thr_;
+  };
+
+  explicit AffinityThreadEnvironment(std::vector<int> affinity) : affinity_(std::move(affinity)) {}
+
+  EnvThread* CreateThread(std::function<void()> f) {
+    if (affinity_.empty()) {
+      return new EnvThread(std::move(f));
+    }
+
+    int logical_processor = affinity_[next_thread_++ % affinity_.size()];
+    return new EnvThread([logical_processor, f]() {
+      // run unpinned rather than failing if the processor isn't available
+      Env::Default().SetCurrentThreadAffinity(logical_processor);
+      f();
+    });
+  }
+
+  Task CreateTask(std::function<void()> f) { return Task{std::move(f)}; }
+  void ExecuteTask(const Task& t) { t.f(); }
+
+ private:
+  std::vector<int> affinity_;
+  size_t next_thread_ = 0;
+};
+
+inline void SpinPause() {
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+}  // namespace
+
+// One ParallelFor in low latency mode. Lives on the stack of the calling thread, which waits for every worker
+// the section was assigned to before returning.
+struct ThreadPool::ParallelSection {
+  ParallelSection(const std::function<void(int32_t)>& fn_in, int32_t total_in, int32_t block_size_in)
+      : fn(fn_in), total(total_in), block_size(block_size_in), num_blocks((total_in + block_size_in - 1) / block_size_in) {}
+
+  // run blocks until none is left
+  void RunBlocks() {
+    for (int32_t block = next_block.fetch_add(1, std::memory_order_relaxed); block < num_blocks;
+         block = next_block.fetch_add(1, std::memory_order_relaxed)) {
+      const int32_t end = std::min(total, (block + 1) * block_size);
+      for (int32_t i = block * block_size; i < end; ++i) {
+        fn(i);
+      }
+    }
+  }
+
+  const std::function<void(int32_t)>& fn;
+  const int32_t total;
+  const int32_t block_size;
+  const int32_t num_blocks;
+  std::atomic<int32_t> next_block{0};
+  // workers assigned to the section that haven't finished yet
+  std::atomic<int> pending_workers{0};
+};
+
+struct ThreadPool::Worker {
+  enum State : int {
+    kIdle,      // not polling
+    kSpinning,  // polling for a section
+    kClaimed,   // a caller is assigning a section
+    kAssigned,  // section is set
+  };
+
+  std::atomic<int> state{kIdle};
+  ParallelSection* section = nullptr;
+};
+
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadPool::ThreadPool(const std::string& name, int num_threads) : ThreadPool(name, num_threads, ThreadOptions()) {}
+
+ThreadPool::ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options)
+    : low_latency_(thread_options.low_latency),
+      spin_duration_(std::max(thread_options.spin_duration_us, 0)),
+      impl_(std::make_unique<Eigen::ThreadPoolTempl<AffinityThreadEnvironment>>(
+          num_threads, AffinityThreadEnvironment(thread_options.affinity))) {
+  if (low_latency_) {
+    workers_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      workers_.push_back(std::make_unique<Worker>());
+    }
+  }
 
-void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
+  metrics_collector_id_ = metrics::MetricsRegistry::Global().AddCollector(
+      [this, name](metrics::MetricsRegistry::Collection& collection) {
+        const metrics::Labels labels{{"pool", name}};
+        collection.Add("onnxruntime_threadpool_threads", "Threads of the thread pools.", labels, NumThreads());
+        collection.Add("onnxruntime_threadpool_pending_tasks", "Tasks queued in the thread pools and not started.",
+                       labels, pending_tasks_.load(std::memory_order_relaxed));
+      });
+}
+
+ThreadPool::~ThreadPool() {
+  metrics::MetricsRegistry::Global().RemoveCollector(metrics_collector_id_);
+}
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  pending_tasks_.fetch_add(1, std::memory_order_relaxed);
+  impl_->Schedule([this, fn]() {
+    pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+    fn();
+  });
+}
 
 void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
   if (total <= 0) return;
@@ -39,6 +166,12 @@ void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
     fn(0);
     return;
   }
+
+  if (low_latency_) {
+    LowLatencyParallelFor(total, fn);
+    return;
+  }
+
   // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
   // We will simply rely on the work queue and stealing in the short term.
   if (total > NumThreads()) {
@@ -93,12 +226,115 @@ void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<voi
   barrier.Wait();
 }
 
+void ThreadPool::LowLatencyParallelFor(int32_t total, const std::function<void(int32_t)>& fn) {
+  // one block for each thread of the pool and one for the calling thread
+  const int32_t max_blocks = std::min(total, NumThreads() + 1);
+  ParallelSection section(fn, total, (total + max_blocks - 1) / max_blocks);
+
+  const int helpers_wanted = section.num_blocks - 1;
+  int helpers = AssignWorkers(section, helpers_wanted);
+  // threads that are parked now won't be in time for this section, but they'll be polling for the next one
+  WakeWorkers(helpers_wanted);
+
+  for (;;) {
+    // hand blocks to the threads that started polling since
+    if (helpers < helpers_wanted && spinning_workers_.load(std::memory_order_relaxed) > 0) {
+      helpers += AssignWorkers(section, helpers_wanted - helpers);
+    }
+
+    const int32_t block = section.next_block.fetch_add(1, std::memory_order_relaxed);
+    if (block >= section.num_blocks) {
+      break;
+    }
+
+    const int32_t end = std::min(total, (block + 1) * section.block_size);
+    for (int32_t i = block * section.block_size; i < end; ++i) {
+      fn(i);
+    }
+  }
+
+  while (section.pending_workers.load(std::memory_order_acquire) != 0) {
+    SpinPause();
+  }
+}
+
+int ThreadPool::AssignWorkers(ParallelSection& section, int count) {
+  int assigned = 0;
+  for (auto& worker : workers_) {
+    if (assigned == count) {
+      break;
+    }
+
+    int expected = Worker::kSpinning;
+    if (worker->state.load(std::memory_order_relaxed) == Worker::kSpinning &&
+        worker->state.compare_exchange_strong(expected, Worker::kClaimed, std::memory_order_acquire)) {
+      worker->section = &section;
+      section.pending_workers.fetch_add(1, std::memory_order_relaxed);
+      worker->state.store(Worker::kAssigned, std::memory_order_release);
+      ++assigned;
+    }
+  }
+
+  return assigned;
+}
+
+void ThreadPool::WakeWorkers(int count) {
+  count = std::min(count, NumThreads());
+  int awake = awake_workers_.load(std::memory_order_relaxed);
+  while (awake < count) {
+    if (!awake_workers_.compare_exchange_weak(awake, awake + 1, std::memory_order_relaxed)) {
+      continue;
+    }
+
+    impl_->Schedule([this]() {
+      // a full queue runs the task inline on the caller, which may not be a thread of the pool
+      const int id = CurrentThreadId();
+      if (id >= 0) {
+        SpinForWork(*workers_[id]);
+      }
+      awake_workers_.fetch_sub(1, std::memory_order_relaxed);
+    });
+    ++awake;
+  }
+}
+
+void ThreadPool::SpinForWork(Worker& worker) {
+  worker.state.store(Worker::kSpinning, std::memory_order_release);
+  spinning_workers_.fetch_add(1, std::memory_order_relaxed);
+
+  auto deadline = std::chrono::steady_clock::now() + spin_duration_;
+  for (unsigned iteration = 1;; ++iteration) {
+    const int state = worker.state.load(std::memory_order_acquire);
+    if (state == Worker::kAssigned) {
+      ParallelSection* section = worker.section;
+      section->RunBlocks();
+      worker.state.store(Worker::kSpinning, std::memory_order_relaxed);
+      // the caller may return and destroy the section once this is seen
+      section->pending_workers.fetch_sub(1, std::memory_order_release);
+      deadline = std::chrono::steady_clock::now() + spin_duration_;
+      continue;
+    }
+
+    // reading the clock is slower than polling, so check it every few iterations only
+    if (state == Worker::kSpinning && iteration % 64 == 0 && std::chrono::steady_clock::now() >= deadline) {
+      int expected = Worker::kSpinning;
+      if (worker.state.compare_exchange_strong(expected, Worker::kIdle, std::memory_order_acq_rel)) {
+        break;
+      }
+    }
+
+    SpinPause();
+  }
+
+  spinning_workers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
 //   impl_->SetStealPartitions(partitions);
 // }
 
-int ThreadPool::NumThreads() const { return impl_.NumThreads(); }
+int ThreadPool::NumThreads() const { return impl_->NumThreads(); }
 
-int ThreadPool::CurrentThreadId() const { return impl_.CurrentThreadId(); }
+int ThreadPool::CurrentThreadId() const { return impl_->CurrentThreadId(); }
 }  // namespace concurrency
 }  // namespace onnxruntime
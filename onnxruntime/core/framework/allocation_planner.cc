@@ -3,6 +3,7 @@
 
 #include "core/framework/allocation_planner.h"
 #include <list>
+#include <map>
 #include <unordered_map>
 #include <algorithm>
 #include <sstream>
@@ -10,6 +11,7 @@
 #include "core/platform/env.h"
 #include "core/framework/data_types.h"
 #include "core/framework/kernel_def_builder.h"
+#include "core/framework/mem_pattern_planner.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
@@ -40,6 +42,12 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kShare:
       out << "Share";
       break;
+    case AllocKind::kSubTensor:
+      out << "SubTensor";
+      break;
+    case AllocKind::kView:
+      out << "View";
+      break;
   }
   return out;
 }
@@ -62,7 +70,10 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     if (0 <= index && static_cast<size_t>(index) < plan_size) {
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
-      if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kReuse || elt_plan.alloc_kind == AllocKind::kView)
+        out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kSubTensor)
+        out << " " << elt_plan.reused_buffer << " at byte " << elt_plan.sub_tensor_offset;
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -153,6 +164,9 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // the values written in place into the output of a Concat, and the index of that output
+  std::unordered_map<OrtValueIndex, OrtValueIndex> sub_tensor_buffers_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -203,6 +217,32 @@ class PlannerImpl {
     symplan.reused_buffer = original;
   }
 
+  // Find the graph input, outer scope value or initializer that a graph output of an Identity (or of a Dropout,
+  // which is an Identity for inference) passes through unchanged.
+  bool FindPassedThroughValue(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* value) {
+    if (output_arg_num != 0 || (node.OpType() != "Identity" && node.OpType() != "Dropout")) {
+      return false;
+    }
+
+    // A subgraph returns its outputs to the node running it, which may give them a buffer of its own through
+    // custom allocators. Loop copies its fetches to the feeds of the next iteration so it's fine to share there.
+    if (parent_node_ && parent_node_->OpType() != "Loop") {
+      return false;
+    }
+
+    const auto* p_input_arg = node.InputDefs()[0];
+    const auto input_index = Index(p_input_arg->Name());
+    const auto& input_plan = AllocPlan(input_index);
+    const bool is_initializer = graph_viewer_.GetAllInitializedTensors().count(p_input_arg->Name()) > 0;
+    if ((input_plan.alloc_kind != AllocKind::kPreExisting && !is_initializer) ||
+        !(input_plan.location == AllocPlan(node.OutputDefs()[0]->Name()).location)) {
+      return false;
+    }
+
+    *value = input_index;
+    return true;
+  }
+
   // Find if there exists some input tensor that we can use in-place for output_arg
   bool FindReusableInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* reusable_input) {
     auto p_output_arg = node.OutputDefs()[output_arg_num];
@@ -235,7 +275,8 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            // a view is read through its strides, which writing the output into its buffer would overwrite
+            if (1 == UseCount(original) && AllocPlan(input_arg_index).alloc_kind != AllocKind::kView) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -249,6 +290,42 @@ class PlannerImpl {
     return false;
   }
 
+  // Find if the kernel of the node may create output_arg as a strided view of one of its inputs. Only the
+  // consumers of the output read it, so they must all accept strided inputs; otherwise each would copy the view.
+  bool FindViewedInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* viewed_input) {
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr || ci->kernel_def->MayView().empty()) {
+      return false;
+    }
+
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (it->GetSrcArgIndex() != output_arg_num) continue;
+      const Node& consumer = it->GetNode();
+      // implicit inputs are passed to subgraphs, whose nodes may not accept strided inputs
+      if (static_cast<size_t>(it->GetDstArgIndex()) >= consumer.InputDefs().size()) return false;
+      const KernelCreateInfo* consumer_ci;
+      st = kernel_registry_.SearchKernelRegistry(consumer, &consumer_ci);
+      if (!st.IsOK() || consumer_ci == nullptr || consumer_ci->kernel_def == nullptr ||
+          !consumer_ci->kernel_def->AcceptsStridedInput(it->GetDstArgIndex())) {
+        return false;
+      }
+    }
+
+    auto input_args = node.InputDefs();
+    auto& output_location = AllocPlan(node.OutputDefs()[output_arg_num]->Name()).location;
+    for (auto pair : ci->kernel_def->MayView()) {
+      if (pair.second == output_arg_num && 0 <= pair.first && static_cast<size_t>(pair.first) < input_args.size()) {
+        auto p_input_arg = input_args[pair.first];
+        if (p_input_arg->Exists() && AllocPlan(p_input_arg->Name()).location == output_location) {
+          *viewed_input = Index(p_input_arg->Name());
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -435,8 +512,9 @@ class PlannerImpl {
       }
       // if sync is needed, mark allocation plan as create_fence_if_async=true
       // note that the input arg may come from an execution provider (i.e. CPU) that does not support async,
-      // in which case create_fence_if_async would be ignored when creating MLValue
-      if (p_kernelDef->ExecQueueId() != 0) {
+      // in which case create_fence_if_async would be ignored when creating MLValue.
+      // with parallel execution the nodes may run on the streams of different threads, so every def needs a fence.
+      if (p_kernelDef->ExecQueueId() != 0 || context_.IsParallelExecutionEnabled()) {
         pnode->ForEachDef([this](const onnxruntime::NodeArg& arg, bool /*is_input*/) {
           OrtValueIndex index = Index(arg.Name());
           AllocPlan(index).create_fence_if_async = true;
@@ -498,6 +576,120 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // The dimensions of a tensor if they are all known.
+  bool GetStaticDims(const NodeArg& arg, std::vector<int64_t>& dims) {
+    const auto* shape = context_.GetShape(arg);
+    if (shape == nullptr) return false;
+    dims.clear();
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return false;
+      dims.push_back(dim.dim_value());
+    }
+    return true;
+  }
+
+  // Whether the output of a CPU node can be a sub-tensor of the buffer of another value: the kernel writes it itself,
+  // rather than aliasing one of its inputs or running a subgraph.
+  bool CanWriteSubTensor(const Node& node, size_t output_index) {
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider || node.ContainsSubgraph()) return false;
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) return false;
+    for (auto pair : ci->kernel_def->Alias()) {
+      if (pair.second == static_cast<int>(output_index)) return false;
+    }
+    return true;
+  }
+
+  // Find the CPU Concat nodes whose inputs can be written by their producers directly into the output, so the Concat
+  // doesn't copy them. Tensors have no strides, so each input must be a contiguous part of the output, which is the
+  // case when all the dimensions of the output before the axis are 1. Each input must be a tensor produced in this
+  // graph and only used by the Concat, and all the shapes must be known. The output is then allocated with the first
+  // of its inputs the plan runs, so it can't reuse a buffer freed in between.
+  // Should only be used after ComputeUseCounts()
+  Status ComputeSubTensorPlan() {
+    // the producers of the inputs of a Concat could then allocate its output concurrently
+    if (context_.IsParallelExecutionEnabled()) return Status::OK();
+
+    // the node producing each value, and the index of the value in its outputs
+    std::unordered_map<const NodeArg*, std::pair<const Node*, size_t>> producers;
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      const auto& output_defs = pnode->OutputDefs();
+      for (size_t i = 0; i < output_defs.size(); ++i) {
+        producers[output_defs[i]] = {pnode, i};
+      }
+    }
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    for (const auto& step : plan_.execution_plan) {
+      const auto& concat = *graph_viewer_.GetNode(step.node_index);
+      if (concat.OpType() != "Concat" || concat.GetExecutionProviderType() != kCpuExecutionProvider) continue;
+
+      const NodeArg* output = concat.OutputDefs()[0];
+      if (!output->Exists() || IsNonTensor(*output) ||
+          std::find(graph_outputs.begin(), graph_outputs.end(), output) != graph_outputs.end())
+        continue;
+
+      // string tensors must be constructed in their buffer
+      auto element_type = utils::GetMLDataType(*output)->AsTensorType()->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) continue;
+
+      std::vector<int64_t> output_dims;
+      if (!GetStaticDims(*output, output_dims) || output_dims.empty()) continue;
+
+      const auto& attributes = concat.GetAttributes();
+      auto axis_attr = attributes.find("axis");
+      if (axis_attr == attributes.end()) continue;
+      const auto rank = static_cast<int64_t>(output_dims.size());
+      int64_t axis = axis_attr->second.i();
+      if (axis < 0) axis += rank;
+      if (axis < 0 || axis >= rank) continue;
+      if (std::any_of(output_dims.begin(), output_dims.begin() + axis, [](int64_t dim) { return dim != 1; }))
+        continue;
+
+      const OrtValueIndex output_index = Index(output->Name());
+      std::vector<std::pair<OrtValueIndex, size_t>> sub_tensors;
+      size_t offset = 0;
+      bool eligible = true;
+      for (const NodeArg* input : concat.InputDefs()) {
+        auto producer = producers.find(input);
+        std::vector<int64_t> input_dims;
+        // graph inputs, initializers and outer scope values have no producer. a use count of 2 is the producer and
+        // this single use by the Concat, so the value is not a graph output either.
+        if (!input->Exists() || producer == producers.end() ||
+            !CanWriteSubTensor(*producer->second.first, producer->second.second) ||
+            UseCount(input->Name()) != 2 || !GetStaticDims(*input, input_dims)) {
+          eligible = false;
+          break;
+        }
+
+        const OrtValueIndex input_index = Index(input->Name());
+        if (!(AllocPlan(input_index).location == AllocPlan(output_index).location)) {
+          eligible = false;
+          break;
+        }
+
+        int64_t num_elements = 1;
+        for (auto dim : input_dims) num_elements *= dim;
+        sub_tensors.emplace_back(input_index, offset);
+        offset += static_cast<size_t>(num_elements) * element_type->Size();
+      }
+
+      int64_t output_num_elements = 1;
+      for (auto dim : output_dims) output_num_elements *= dim;
+      if (!eligible || offset != static_cast<size_t>(output_num_elements) * element_type->Size()) continue;
+
+      for (const auto& sub_tensor : sub_tensors) {
+        sub_tensor_buffers_[sub_tensor.first] = output_index;
+        AllocPlan(sub_tensor.first).sub_tensor_offset = sub_tensor.second;
+      }
+      plan_.sub_tensor_buffer_shapes[output_index] = std::move(output_dims);
+    }
+
+    return Status::OK();
+  }
+
   // Should only be used after ProcessDef()
   Status ComputeReusePlan() {
     std::vector<SequentialExecutionPlan::NodeExecutionPlan>& execution_plan{plan_.execution_plan};
@@ -526,6 +718,9 @@ class PlannerImpl {
     // set AllocationInfo for each weight
     ORT_RETURN_IF_ERROR(GeneratePlanForWeights());
 
+    // find the values that are written in place into the output of a Concat
+    ORT_RETURN_IF_ERROR(ComputeSubTensorPlan());
+
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
       SequentialExecutionPlan::NodeExecutionPlan step = execution_plan[program_counter];
       auto pnode = graph_viewer_.GetNode(step.node_index);
@@ -542,21 +737,23 @@ class PlannerImpl {
           // node_output is graph's output, so we can't reuse intermediate buffer
           AllocPlan(current).alloc_kind = AllocKind::kAllocateOutput;
 
-          // hacky perf optimization to not copy a pre-existing value to an output if this is a Loop subgraph.
-          // ideally this is temporary, and a future ONNX change to allow empty variadic inputs means we don't
-          // have converted models that unnecessarily add loop state variables. if the value is just being
-          // passed through an implicit input should be used instead.
-          if (parent_node_ && pnode->OpType() == "Identity" && parent_node_->OpType() == "Loop") {
-            const auto& input_name = pnode->InputDefs()[0]->Name();
-            const auto input_index = Index(input_name);
-            const auto& alloc_plan = AllocPlan(input_index);
-            if (alloc_plan.alloc_kind == AllocKind::kPreExisting) {
-              Reuse(input_index, current, AllocKind::kShare);
-            }
+          // an output passing a graph input or an initializer through shares its OrtValue instead of copying it,
+          // as if the value itself were the output
+          if (FindPassedThroughValue(*pnode, output_arg_num, &reused)) {
+            Reuse(reused, current, AllocKind::kShare);
           }
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (sub_tensor_buffers_.count(current)) {
+          // written in place into the output of the Concat using it
+          Reuse(sub_tensor_buffers_[current], current, AllocKind::kSubTensor);
+        } else if (plan_.sub_tensor_buffer_shapes.count(current)) {
+          // allocated with its first sub-tensor, so it can't reuse a buffer freed since
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (FindViewedInput(*pnode, output_arg_num, &reused)) {
+          // a strided view of one of this node's inputs, which lives as long as the view
+          Reuse(reused, current, AllocKind::kView);
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
@@ -682,6 +879,51 @@ class PlannerImpl {
   }
 };  // namespace onnxruntime
 
+// The topological order with each copy from the host to a device moved up to right after the nodes producing its
+// input, or to the start if there are none. The copies run on their own queue, so the data moves while the nodes
+// before the ones using it run, and the fences only make its users wait for the copy if it isn't done.
+static std::vector<NodeIndex> HoistCopiesToDevice(const GraphViewer& graph_viewer,
+                                                  const std::vector<NodeIndex>& topological_order) {
+  std::vector<NodeIndex> copies;
+  for (auto n : topological_order) {
+    if (graph_viewer.GetNode(n)->OpType() == "MemcpyFromHost") {
+      copies.push_back(n);
+    }
+  }
+  if (copies.empty()) {
+    return topological_order;
+  }
+
+  std::vector<NodeIndex> order;
+  order.reserve(topological_order.size());
+  std::vector<bool> placed(graph_viewer.MaxNodeIndex(), false);
+  auto place_ready_copies = [&]() {
+    for (auto it = copies.begin(); it != copies.end();) {
+      const Node& copy = *graph_viewer.GetNode(*it);
+      const bool ready = std::all_of(copy.InputNodesBegin(), copy.InputNodesEnd(),
+                                     [&placed](const Node& producer) { return placed[producer.Index()]; });
+      if (ready) {
+        order.push_back(*it);
+        placed[*it] = true;
+        it = copies.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  };
+
+  place_ready_copies();
+  for (auto n : topological_order) {
+    if (!placed[n]) {
+      order.push_back(n);
+      placed[n] = true;
+      place_ready_copies();
+    }
+  }
+
+  return order;
+}
+
 Status PlannerImpl::CreatePlan() {
   auto& p_graph_nodes = graph_viewer_.GetNodesInTopologicalOrder();
 
@@ -689,9 +931,9 @@ Status PlannerImpl::CreatePlan() {
 
   Initialize(p_graph_nodes.size(), static_cast<size_t>(num_ml_values));
 
-  // Determine execution order: we use the default topological sort order for now. We can later
-  // explore more efficient orderings (from a memory usage perspective).
-  for (auto n : p_graph_nodes) {
+  // Determine execution order: we use the default topological sort order, with the copies to devices moved as early
+  // as their inputs allow. We can later explore more efficient orderings (from a memory usage perspective).
+  for (auto n : HoistCopiesToDevice(graph_viewer_, p_graph_nodes)) {
     plan_.execution_plan.emplace_back(n);
   }
 
@@ -725,4 +967,93 @@ Status SequentialPlanner::CreatePlan(const Node* parent_node, const onnxruntime:
   return planner.CreatePlan();
 }
 
+Status SequentialPlanner::CreateStaticMemoryPattern(const onnxruntime::GraphViewer& graph_viewer,
+                                                    const SequentialExecutionPlan& plan,
+                                                    const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                                    const ISequentialPlannerContext& context,
+                                                    std::unique_ptr<MemoryPatternGroup>& mem_patterns) {
+  mem_patterns = nullptr;
+
+  const auto& execution_plan = plan.execution_plan;
+  if (execution_plan.empty()) return Status::OK();
+
+  // the step after which each value is freed. values that are never freed live until the end.
+  std::vector<size_t> free_steps(plan.allocation_plan.size(), execution_plan.size() - 1);
+  for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
+    const auto& step = execution_plan[program_counter];
+    for (int i = step.free_from_index; i <= step.free_to_index; ++i) {
+      free_steps[plan.to_be_freed[i]] = program_counter;
+    }
+  }
+
+  // the step at which each buffer holding sub-tensors is allocated, which is that of its first sub-tensor. The output
+  // of a Concat can itself be a sub-tensor of an outer Concat, so the step goes up to every buffer holding it.
+  std::unordered_map<OrtValueIndex, size_t> sub_tensor_buffer_steps;
+  for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
+    const auto* pnode = graph_viewer.GetNode(execution_plan[program_counter].node_index);
+    if (pnode == nullptr)
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Can not find the node ", execution_plan[program_counter].node_index);
+
+    for (const auto* node_output : pnode->OutputDefs()) {
+      if (!node_output->Exists()) continue;
+
+      OrtValueIndex index;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(node_output->Name(), index));
+      for (const auto* value_plan = &plan.allocation_plan[index]; value_plan->alloc_kind == AllocKind::kSubTensor;
+           value_plan = &plan.allocation_plan[value_plan->reused_buffer]) {
+        sub_tensor_buffer_steps.emplace(value_plan->reused_buffer, program_counter);
+      }
+    }
+  }
+
+  std::map<OrtMemoryInfo, StaticMemPatternPlanner> planners;
+  for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
+    const auto* pnode = graph_viewer.GetNode(execution_plan[program_counter].node_index);
+    if (pnode == nullptr)
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Can not find the node ", execution_plan[program_counter].node_index);
+
+    for (const auto* node_output : pnode->OutputDefs()) {
+      if (!node_output->Exists()) continue;
+
+      OrtValueIndex index;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(node_output->Name(), index));
+      const auto& value_plan = plan.allocation_plan[index];
+      if (value_plan.alloc_kind != AllocKind::kAllocate || value_plan.value_type == nullptr ||
+          !value_plan.value_type->IsTensorType())
+        continue;
+
+      // string tensors are not allocated from a memory pattern, see ExecutionFrame::TraceAllocate
+      auto element_type = value_plan.value_type->AsTensorType()->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) continue;
+
+      const auto* shape = context.GetShape(*node_output);
+      if (shape == nullptr) return Status::OK();
+
+      int64_t len = 1;
+      for (const auto& dim : shape->dim()) {
+        if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return Status::OK();
+        len *= dim.dim_value();
+      }
+
+      size_t size;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(static_cast<size_t>(len), element_type->Size(), &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "size overflow for ", node_output->Name());
+      }
+
+      auto sub_tensor_buffer_step = sub_tensor_buffer_steps.find(index);
+      const size_t alloc_step =
+          sub_tensor_buffer_step != sub_tensor_buffer_steps.end() ? sub_tensor_buffer_step->second : program_counter;
+      planners[value_plan.location].AddValue(index, size, alloc_step, free_steps[index]);
+    }
+  }
+
+  mem_patterns = std::make_unique<MemoryPatternGroup>();
+  for (const auto& location_planner : planners) {
+    mem_patterns->locations.push_back(location_planner.first);
+    mem_patterns->patterns.push_back(location_planner.second.GenerateMemPattern());
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -16,6 +16,7 @@ namespace onnxruntime {
 class ExecutionProviders;
 class KernelRegistryManager;
 class OrtValueNameIdxMap;
+struct MemoryPatternGroup;
 
 // ISequentialPlannerContext abstracts how the planner accesses information (such as inferred shape)
 // to do the planning.
@@ -51,6 +52,15 @@ class SequentialPlanner {
                            const ExecutionProviders& providers, const KernelRegistryManager& kernel_registry,
                            const OrtValueNameIdxMap& ort_value_name_idx_map, const ISequentialPlannerContext& context,
                            std::unique_ptr<SequentialExecutionPlan>& plan);
+
+  // Plan the offset of every tensor the execution plan allocates (AllocKind::kAllocate) in one buffer per location,
+  // using the lifetimes given by the order of the execution plan and the sizes given by the inferred shapes.
+  // Tensors with non-overlapping lifetimes may share memory regardless of their sizes.
+  // mem_patterns is set to nullptr if the size of any of those tensors is not known statically.
+  static Status CreateStaticMemoryPattern(const onnxruntime::GraphViewer& graph, const SequentialExecutionPlan& plan,
+                                          const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                          const ISequentialPlannerContext& context,
+                                          std::unique_ptr<MemoryPatternGroup>& mem_patterns);
 };
 
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
+#include "core/framework/error_code_helper.h"
 #include "core/framework/utils.h"
 #include <cstdlib>
 #include <sstream>
@@ -42,6 +44,41 @@ ORT_API_STATUS_IMPL(OrtCreateMemoryInfo, _In_ const char* name1, OrtAllocatorTyp
 
 ORT_API(void, OrtReleaseMemoryInfo, _Frees_ptr_opt_ OrtMemoryInfo* p) { delete p; }
 
+ORT_API_STATUS_IMPL(OrtCreateArenaCfg, size_t max_mem, int arena_extend_strategy, size_t initial_chunk_size_bytes,
+                    _Outptr_ OrtArenaCfg** out) {
+  API_IMPL_BEGIN
+  auto cfg = std::make_unique<OrtArenaCfg>();
+  if (max_mem != 0) {
+    cfg->max_mem = max_mem;
+  }
+
+  switch (arena_extend_strategy) {
+    case -1:
+      break;
+    case static_cast<int>(onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo):
+    case static_cast<int>(onnxruntime::ArenaExtendStrategy::kSameAsRequested):
+      cfg->arena_extend_strategy = static_cast<onnxruntime::ArenaExtendStrategy>(arena_extend_strategy);
+      break;
+    default:
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "arena_extend_strategy is not valid");
+  }
+
+  if (initial_chunk_size_bytes != 0) {
+    cfg->initial_chunk_size_bytes = initial_chunk_size_bytes;
+  }
+
+  *out = cfg.release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSetProcessArenaMemoryLimit, _In_ const OrtMemoryInfo* info, size_t limit) {
+  onnxruntime::BFCArena::SetProcessMemoryLimit(info->device, limit);
+  return nullptr;
+}
+
+ORT_API(void, OrtReleaseArenaCfg, _Frees_ptr_opt_ OrtArenaCfg* p) { delete p; }
+
 ORT_API_STATUS_IMPL(OrtMemoryInfoGetName, _In_ const OrtMemoryInfo* ptr, _Out_ const char** out) {
   *out = ptr->name;
   return nullptr;
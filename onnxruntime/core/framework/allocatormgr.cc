@@ -16,7 +16,8 @@ AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
   if (device_allocator->AllowsArena())
     return std::shared_ptr<IArenaAllocator>(
-        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem));
+        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, info.arena_extend_strategy,
+                                   info.initial_chunk_size_bytes, info.thread_cache_config));
 
   return device_allocator;
 }
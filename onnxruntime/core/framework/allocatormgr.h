@@ -14,6 +14,9 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  size_t initial_chunk_size_bytes = kDefaultArenaInitialChunkSizeBytes;
+  ArenaThreadCacheConfig thread_cache_config{};
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
@@ -3,12 +3,46 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+// How an arena grows once the memory it holds can't satisfy a request.
+enum class ArenaExtendStrategy : int32_t {
+  // Double the size of the next region until it fits the request.
+  kNextPowerOfTwo = 0,
+  // Allocate a region of the requested size, but at least the initial chunk size.
+  kSameAsRequested = 1,
+};
+
+constexpr size_t kDefaultArenaInitialChunkSizeBytes = 1 << 20;
+}  // namespace onnxruntime
+
+// Settings used to construct an arena. See OrtCreateArenaCfg.
+struct OrtArenaCfg {
+  // The most memory the arena may hold.
+  size_t max_mem = std::numeric_limits<size_t>::max();
+  onnxruntime::ArenaExtendStrategy arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+  // The size of the first region the arena allocates.
+  size_t initial_chunk_size_bytes = onnxruntime::kDefaultArenaInitialChunkSizeBytes;
+};
+
+namespace onnxruntime {
+using ArenaCfg = OrtArenaCfg;
+
+// Settings for the optional per-thread cache of small freed chunks an arena may keep in front of its shared bins.
+// Frees and re-allocations of cached sizes are served from the cache of the calling thread and skip the arena lock.
+struct ArenaThreadCacheConfig {
+  bool enable = false;
+  // Largest chunk size (after rounding) that is cached.
+  size_t max_cached_chunk_size = 64 * 1024;
+  // A thread cache holding more than this many bytes of free chunks drains back to the shared bins.
+  size_t high_water_mark = 4 * 1024 * 1024;
+};
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -26,6 +60,9 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return memory the arena holds but doesn't use back to the device.
+  // Shrink call need to be thread safe.
+  virtual Status Shrink() { return Status::OK(); }
   const OrtMemoryInfo& Info() const override = 0;
   // allocate host pinned memory?
 };
@@ -3,17 +3,76 @@
 
 #include "core/framework/bfc_arena.h"
 
+#include <atomic>
+#include <map>
+#include <tuple>
+
+#include "core/common/metrics.h"
+
 namespace onnxruntime {
+
+namespace {
+// The memory the arenas of a device may take from it, shared by all the sessions in the process.
+struct DeviceMemoryBudget {
+  size_t limit = 0;  // 0 is unlimited
+  size_t allocated = 0;
+};
+
+using DeviceKey = std::tuple<OrtDevice::DeviceType, OrtDevice::MemoryType, OrtDevice::DeviceId>;
+
+OrtMutex& DeviceMemoryBudgetMutex() {
+  static OrtMutex mutex;
+  return mutex;
+}
+
+// Leaked so arenas destroyed during static destruction can still return their memory to it.
+std::map<DeviceKey, DeviceMemoryBudget>& DeviceMemoryBudgets() {
+  static auto* budgets = new std::map<DeviceKey, DeviceMemoryBudget>();
+  return *budgets;
+}
+
+DeviceKey KeyOf(const OrtDevice& device) {
+  return DeviceKey(device.Type(), device.MemType(), device.Id());
+}
+
+bool ReserveDeviceMemory(const OrtDevice& device, size_t bytes) {
+  std::lock_guard<OrtMutex> lock(DeviceMemoryBudgetMutex());
+  auto& budget = DeviceMemoryBudgets()[KeyOf(device)];
+  if (budget.limit != 0 && budget.allocated + bytes > budget.limit) {
+    return false;
+  }
+  budget.allocated += bytes;
+  return true;
+}
+
+void ReleaseDeviceMemory(const OrtDevice& device, size_t bytes) {
+  std::lock_guard<OrtMutex> lock(DeviceMemoryBudgetMutex());
+  auto& budget = DeviceMemoryBudgets()[KeyOf(device)];
+  budget.allocated -= std::min(bytes, budget.allocated);
+}
+}  // namespace
+
+void BFCArena::SetProcessMemoryLimit(const OrtDevice& device, size_t limit) {
+  std::lock_guard<OrtMutex> lock(DeviceMemoryBudgetMutex());
+  DeviceMemoryBudgets()[KeyOf(device)].limit = limit;
+}
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
+                   size_t total_memory,
+                   ArenaExtendStrategy arena_extend_strategy,
+                   size_t initial_chunk_size_bytes,
+                   const ArenaThreadCacheConfig& thread_cache_config)
     : device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      thread_cache_config_(thread_cache_config) {
+  ORT_ENFORCE(initial_chunk_size_bytes > 0, "initial_chunk_size_bytes must be positive");
+  initial_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, initial_chunk_size_bytes));
+  curr_region_allocation_bytes_ = initial_region_allocation_bytes_;
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
+  arena_extend_strategy_ = arena_extend_strategy;
   stats_.bytes_limit = static_cast<int64_t>(total_memory);
   // Create a bunch of bins of various good sizes.
 
@@ -32,11 +91,35 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_config_.enable && thread_cache_config_.max_cached_chunk_size >= kMinAllocationSize) {
+    const size_t num_free_lists = RoundedBytes(thread_cache_config_.max_cached_chunk_size) >> kMinAllocationBits;
+    cache_shards_ = std::make_unique<CacheShard[]>(kNumCacheShards);
+    for (CacheShardNum s = 0; s < kNumCacheShards; s++) {
+      cache_shards_[s].free_lists.resize(num_free_lists);
+    }
+  }
+
+  // the arenas of a device are summed in the exported gauges
+  metrics_collector_id_ = metrics::MetricsRegistry::Global().AddCollector([this](metrics::MetricsRegistry::Collection& collection) {
+    AllocatorStats stats;
+    GetStats(&stats);
+    const metrics::Labels labels{{"arena", info_.name}};
+    collection.Add("onnxruntime_arena_bytes_in_use", "Bytes in use in the arenas.", labels,
+                   static_cast<double>(stats.bytes_in_use));
+    collection.Add("onnxruntime_arena_allocated_bytes", "Bytes the arenas allocated from their devices.", labels,
+                   static_cast<double>(stats.total_allocated_bytes));
+    collection.Add("onnxruntime_arena_max_bytes_in_use", "Peak bytes in use in the arenas.", labels,
+                   static_cast<double>(stats.max_bytes_in_use));
+  });
 }
 
 BFCArena::~BFCArena() {
+  metrics::MetricsRegistry::Global().RemoveCollector(metrics_collector_id_);
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
+    ReleaseDeviceMemory(info_.device, region.memory_size());
   }
 
   for (const auto& reserve_chunk : reserved_chunks_) {
@@ -53,6 +136,17 @@ BFCArena::Chunk* BFCArena::ChunkFromHandle(ChunkHandle h) {
   return &(chunks_[h]);
 }
 
+void* BFCArena::AllocateRegion(size_t bytes) {
+  if (!ReserveDeviceMemory(info_.device, bytes)) {
+    return nullptr;
+  }
+  void* mem_addr = device_allocator_->Alloc(bytes);
+  if (mem_addr == nullptr) {
+    ReleaseDeviceMemory(info_.device, bytes);
+  }
+  return mem_addr;
+}
+
 bool BFCArena::Extend(size_t rounded_bytes) {
   size_t available_bytes = memory_limit_ - stats_.total_allocated_bytes;
   // Rounds available_bytes down to the nearest multiple of kMinAllocationSize.
@@ -64,18 +158,23 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  // If curr_region_allocation_bytes_ is not enough to satisfy the
-  // allocation, keep multiplying by a power of two until that is
-  // sufficient.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo) {
+    // If curr_region_allocation_bytes_ is not enough to satisfy the
+    // allocation, keep multiplying by a power of two until that is
+    // sufficient.
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= 2;
+      increased_allocation = true;
+    }
+  } else {
+    // Only ever reserve what was asked for, in steps of at least the initial region size.
+    curr_region_allocation_bytes_ = std::max(rounded_bytes, initial_region_allocation_bytes_);
   }
 
   // Try allocating.
   size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
-  void* mem_addr = device_allocator_->Alloc(bytes);
+  void* mem_addr = AllocateRegion(bytes);
   if (mem_addr == nullptr && !started_backpedal_) {
     // Only backpedal once.
     started_backpedal_ = true;
@@ -86,7 +185,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     while (mem_addr == nullptr) {
       bytes = RoundedBytes(static_cast<size_t>(bytes * kBackpedalFactor));
       if (bytes < rounded_bytes) break;
-      mem_addr = device_allocator_->Alloc(bytes);
+      mem_addr = AllocateRegion(bytes);
     }
   }
 
@@ -94,7 +193,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  if (!increased_allocation) {
+  if (!increased_allocation && arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo) {
     // Increase the region size of the next required allocation.
     curr_region_allocation_bytes_ *= 2;
   }
@@ -132,6 +231,55 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   return true;
 }
 
+Status BFCArena::Shrink() {
+  if (cache_shards_ != nullptr) {
+    for (CacheShardNum s = 0; s < kNumCacheShards; s++) {
+      DrainThreadCache(s, 0);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  FreeUnusedRegions();
+
+  return Status::OK();
+}
+
+size_t BFCArena::FreeUnusedRegions() {
+  // A region is unused if it is covered by one free chunk.
+  std::vector<void*> unused_regions;
+  for (const auto& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->size == region.memory_size()) {
+      unused_regions.push_back(region.ptr());
+    }
+  }
+
+  size_t freed_bytes = 0;
+  for (void* region_ptr : unused_regions) {
+    ChunkHandle h = region_manager_.get_handle(region_ptr);
+    const size_t region_bytes = ChunkFromHandle(h)->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(region_ptr);
+    device_allocator_->Free(region_ptr);
+    ReleaseDeviceMemory(info_.device, region_bytes);
+    stats_.total_allocated_bytes -= region_bytes;
+    freed_bytes += region_bytes;
+  }
+
+  if (!unused_regions.empty()) {
+    // Start growing from scratch so that the next Extend doesn't reserve as much
+    // memory as the largest region we just gave back.
+    curr_region_allocation_bytes_ = initial_region_allocation_bytes_;
+    started_backpedal_ = false;
+  }
+
+  LOGS_DEFAULT(INFO) << "Shrinking arena freed " << unused_regions.size() << " regions totalling "
+                     << freed_bytes << " bytes.";
+
+  return freed_bytes;
+}
+
 BFCArena::ChunkHandle BFCArena::AllocateChunk() {
   if (free_chunks_list_ != kInvalidChunkHandle) {
     ChunkHandle h = free_chunks_list_;
@@ -163,6 +311,99 @@ void* BFCArena::Alloc(size_t size) {
   return AllocateRawInternal(size, false);
 }
 
+// static
+BFCArena::CacheShardNum BFCArena::CurrentCacheShardNum() {
+  // Hand out shards round-robin so that up to kNumCacheShards threads never share one.
+  static std::atomic<int> next_shard_num{0};
+  thread_local const CacheShardNum shard_num =
+      static_cast<CacheShardNum>(next_shard_num.fetch_add(1, std::memory_order_relaxed) % kNumCacheShards);
+  return shard_num;
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t rounded_bytes) {
+  CacheShard& shard = cache_shards_[CurrentCacheShardNum()];
+  const size_t index = CacheIndexForSize(rounded_bytes);
+  std::lock_guard<OrtMutex> lock(shard.lock);
+  auto& free_list = shard.free_lists[index];
+  if (free_list.empty()) {
+    return nullptr;
+  }
+  void* ptr = free_list.back();
+  free_list.pop_back();
+  shard.free_bytes -= rounded_bytes;
+  ++shard.num_hits;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* ptr) {
+  const CacheShardNum shard_num = CurrentCacheShardNum();
+  CacheShard& shard = cache_shards_[shard_num];
+  bool needs_drain = false;
+  {
+    std::lock_guard<OrtMutex> lock(shard.lock);
+    auto entry = shard.owned_chunks.find(ptr);
+    if (entry == shard.owned_chunks.end()) {
+      return false;
+    }
+    shard.free_lists[CacheIndexForSize(entry->second)].push_back(ptr);
+    shard.free_bytes += entry->second;
+    needs_drain = shard.free_bytes > thread_cache_config_.high_water_mark;
+  }
+
+  if (needs_drain) {
+    // Drain to half of the high-water mark so that we don't bounce around it.
+    DrainThreadCache(shard_num, thread_cache_config_.high_water_mark / 2);
+  }
+  return true;
+}
+
+void BFCArena::AdoptIntoThreadCache(ChunkHandle h) {
+  Chunk* c = ChunkFromHandle(h);
+  if (c->size > thread_cache_config_.max_cached_chunk_size) {
+    return;
+  }
+
+  const CacheShardNum shard_num = CurrentCacheShardNum();
+  CacheShard& shard = cache_shards_[shard_num];
+  std::lock_guard<OrtMutex> lock(shard.lock);
+  shard.owned_chunks[c->ptr] = c->size;
+  c->cache_shard = shard_num;
+}
+
+void BFCArena::DrainThreadCache(CacheShardNum shard_num, size_t target_bytes) {
+  CacheShard& shard = cache_shards_[shard_num];
+  std::vector<void*> drained;
+  {
+    std::lock_guard<OrtMutex> lock(shard.lock);
+    // Give back the largest chunks first; they are the least likely to be re-used soon.
+    for (size_t index = shard.free_lists.size(); index > 0 && shard.free_bytes > target_bytes; --index) {
+      auto& free_list = shard.free_lists[index - 1];
+      const size_t chunk_size = index << kMinAllocationBits;
+      while (!free_list.empty() && shard.free_bytes > target_bytes) {
+        void* ptr = free_list.back();
+        free_list.pop_back();
+        shard.owned_chunks.erase(ptr);
+        shard.free_bytes -= chunk_size;
+        drained.push_back(ptr);
+      }
+    }
+  }
+
+  if (drained.empty()) {
+    return;
+  }
+
+  // The drained chunks are in use as far as the bins know and nobody else holds them,
+  // so it is safe to hand them back without the shard lock.
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* ptr : drained) {
+    BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    ChunkFromHandle(h)->cache_shard = kInvalidCacheShardNum;
+    FreeAndMaybeCoalesce(h);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -195,6 +436,11 @@ size_t BFCArena::AllocatedSize(const void* ptr) {
   return c->size;
 }
 
+bool BFCArena::Owns(const void* ptr) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  return region_manager_.Contains(ptr) || reserved_chunks_.find(const_cast<void*>(ptr)) != reserved_chunks_.end();
+}
+
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
                                     bool dump_log_on_failure) {
   if (num_bytes == 0) {
@@ -206,21 +452,34 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // so all memory addresses are nicely byte aligned.
   size_t rounded_bytes = RoundedBytes(num_bytes);
 
+  const bool use_thread_cache = cache_shards_ != nullptr &&
+                                rounded_bytes <= thread_cache_config_.max_cached_chunk_size;
+  if (use_thread_cache) {
+    void* ptr = AllocateFromThreadCache(rounded_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-  if (ptr != nullptr) {
-    return ptr;
+
+  // Try to extend, and if the device or a memory limit refuses the memory, give back the regions
+  // nothing is using and try again, since their memory may be what the new region needs.
+  if (ptr == nullptr) {
+    if (Extend(rounded_bytes) || (FreeUnusedRegions() != 0 && Extend(rounded_bytes))) {
+      ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
+    }
   }
 
-  // Try to extend
-  if (Extend(rounded_bytes)) {
-    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-    if (ptr != nullptr) {
-      return ptr;
+  if (ptr != nullptr) {
+    if (use_thread_cache) {
+      AdoptIntoThreadCache(region_manager_.get_handle(ptr));
     }
+    return ptr;
   }
 
   // We searched all bins for an existing free chunk to use and
@@ -236,8 +495,29 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
-  std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+
+    // the free chunks of a bin are sorted by size, so the largest one is the last of the largest non-empty bin
+    for (BinNum b = kNumBins; b > 0; b--) {
+      const Bin* bin = BinFromIndex(b - 1);
+      if (!bin->free_chunks.empty()) {
+        stats->largest_free_chunk_bytes = static_cast<int64_t>(ChunkFromHandle(*bin->free_chunks.rbegin())->size);
+        break;
+      }
+    }
+  }
+
+  if (cache_shards_ != nullptr) {
+    // Report chunks parked in thread caches as free, and cache hits as allocations.
+    for (CacheShardNum s = 0; s < kNumCacheShards; s++) {
+      CacheShard& shard = cache_shards_[s];
+      std::lock_guard<OrtMutex> lock(shard.lock);
+      stats->bytes_in_use -= static_cast<int64_t>(shard.free_bytes);
+      stats->num_allocs += shard.num_hits;
+    }
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -328,6 +608,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (cache_shards_ != nullptr && FreeToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -345,6 +630,16 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
 
+  // A chunk owned by the cache shard of another thread is freed from here, so
+  // take it away from that shard and return it to the bins.
+  Chunk* c = ChunkFromHandle(h);
+  if (c->cache_shard != kInvalidCacheShardNum) {
+    CacheShard& shard = cache_shards_[c->cache_shard];
+    std::lock_guard<OrtMutex> lock(shard.lock);
+    shard.owned_chunks.erase(ptr);
+    c->cache_shard = kInvalidCacheShardNum;
+  }
+
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
 }
@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -49,6 +50,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  // The largest free chunk of the regions. Compared to the free bytes of the regions, it tells how fragmented
+  // they are.
+  int64_t largest_free_chunk_bytes;
 
   AllocatorStats() { Clear(); }
 
@@ -59,6 +63,7 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->largest_free_chunk_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -68,7 +73,8 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "LargestFree:    " << this->largest_free_chunk_bytes << "\n";
     return ss.str();
   }
 };
@@ -81,9 +87,18 @@ struct AllocatorStats {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// If thread_cache_config.enable is set, small chunks freed by a thread are parked
+// in a cache shard owned by that thread instead of going back to the bins, so the
+// next allocation of the same rounded size from that thread does not need the
+// arena lock. Cached chunks stay 'in use' from the point of view of the bins
+// until the shard passes its high-water mark and drains.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo,
+           size_t initial_chunk_size_bytes = kDefaultArenaInitialChunkSizeBytes,
+           const ArenaThreadCacheConfig& thread_cache_config = ArenaThreadCacheConfig());
 
   ~BFCArena() override;
 
@@ -97,6 +112,10 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Frees every region that holds no chunk in use, after draining the thread
+  // caches. Growth of the arena starts over from the initial region size.
+  Status Shrink() override;
+
   size_t Used() const override {
     return stats_.bytes_in_use;
   }
@@ -116,10 +135,20 @@ class BFCArena : public IArenaAllocator {
 
   void GetStats(AllocatorStats* stats);
 
+  // The requested size of a chunk re-used from a thread cache is the size it
+  // was first allocated with.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
 
+  // Returns true if ptr was allocated by this arena and not freed back to the device.
+  bool Owns(const void* ptr);
+
+  // Caps the memory the arenas on device take from it, summed over all the arenas in the process, so
+  // sessions sharing a device can't together exhaust it. An arena refused memory by the cap fails the
+  // allocation as if the device were out of memory. A limit of 0 removes the cap.
+  static void SetProcessMemoryLimit(const OrtDevice& device, size_t limit);
+
  private:
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
@@ -133,6 +162,10 @@ class BFCArena : public IArenaAllocator {
   static const int kInvalidBinNum = -1;
   static const int kNumBins = 21;
 
+  using CacheShardNum = int;
+  static const int kInvalidCacheShardNum = -1;
+  static const int kNumCacheShards = 16;
+
   // Chunks point to memory.  Their prev/next pointers form a
   // doubly-linked list of addresses sorted by base address that
   // must be contiguous.  Chunks contain information about whether
@@ -167,6 +200,10 @@ class BFCArena : public IArenaAllocator {
     // What bin are we in?
     BinNum bin_num = kInvalidBinNum;
 
+    // Which thread cache shard owns this chunk? Owned chunks are in use as far as
+    // the bins are concerned, whether or not the shard has handed them out.
+    CacheShardNum cache_shard = kInvalidCacheShardNum;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -306,6 +343,14 @@ class BFCArena : public IArenaAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr,
+                  "Could not find Region for ", ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -328,6 +373,12 @@ class BFCArena : public IArenaAllocator {
       return const_cast<AllocationRegion*>(RegionFor(p));
     }
 
+    bool Contains(const void* p) const {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), p, &Comparator);
+      return entry != regions_.end() && entry->ptr() <= p;
+    }
+
     const AllocationRegion* RegionFor(const void* p) const {
       auto entry =
           std::upper_bound(regions_.begin(), regions_.end(), p, &Comparator);
@@ -344,6 +395,48 @@ class BFCArena : public IArenaAllocator {
     std::vector<AllocationRegion> regions_;
   };
 
+  // A per-thread cache of free chunks of up to max_cached_chunk_size bytes.
+  // Shards never touch chunks_ or the bins, so a shard lock may be taken while
+  // holding lock_ but lock_ must never be taken while holding a shard lock.
+  struct CacheShard {
+    OrtMutex lock;
+
+    // Free chunk pointers, indexed by (chunk size / kMinAllocationSize) - 1.
+    std::vector<std::vector<void*>> free_lists;
+
+    // Size of every chunk owned by this shard, whether handed out or free.
+    std::unordered_map<const void*, size_t> owned_chunks;
+
+    // Total size of the chunks in free_lists.
+    size_t free_bytes = 0;
+
+    // Number of allocations served from free_lists.
+    int64_t num_hits = 0;
+  };
+
+  // Returns the shard of the calling thread.
+  static CacheShardNum CurrentCacheShardNum();
+
+  size_t CacheIndexForSize(size_t rounded_bytes) const {
+    return (rounded_bytes >> kMinAllocationBits) - 1;
+  }
+
+  // Serves an allocation of 'rounded_bytes' from the cache shard of the calling
+  // thread, or returns nullptr.
+  void* AllocateFromThreadCache(size_t rounded_bytes);
+
+  // Parks 'ptr' in the cache shard of the calling thread if that shard owns it.
+  // Returns false if the chunk has to be freed through the bins.
+  bool FreeToThreadCache(void* ptr);
+
+  // Hands the just allocated chunk 'h' over to the cache shard of the calling
+  // thread if it is small enough. Requires lock_.
+  void AdoptIntoThreadCache(ChunkHandle h);
+
+  // Returns free chunks of shard 'shard_num' to the bins until it holds at most
+  // 'target_bytes'. Must not be called while holding lock_.
+  void DrainThreadCache(CacheShardNum shard_num, size_t target_bytes);
+
   // Returns 'bytes' rounded up to the next highest kMinAllocationSize.
   size_t RoundedBytes(size_t bytes);
 
@@ -352,6 +445,14 @@ class BFCArena : public IArenaAllocator {
   // failure.
   bool Extend(size_t rounded_bytes);
 
+  // Allocates a region of 'bytes' bytes from the device if the process memory limit of the
+  // device allows it. Returns nullptr on failure.
+  void* AllocateRegion(size_t bytes);
+
+  // Returns the regions covered by one free chunk to the device, and the number of bytes freed.
+  // Requires lock_ to be held.
+  size_t FreeUnusedRegions();
+
   // Returns a pointer to an underlying allocated chunk of size
   // 'rounded_bytes'.
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes);
@@ -402,6 +503,7 @@ class BFCArena : public IArenaAllocator {
 
   // Structures immutable after construction
   size_t memory_limit_ = 0;
+  ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
 
   int Log2FloorNonZeroSlow(uint64_t n) {
     int r = 0;
@@ -454,6 +556,9 @@ class BFCArena : public IArenaAllocator {
 
   char bins_space_[sizeof(Bin) * kNumBins];
 
+  // The size of the first region allocation.
+  size_t initial_region_allocation_bytes_;
+
   // The size of the current region allocation.
   size_t curr_region_allocation_bytes_;
 
@@ -480,6 +585,12 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  const ArenaThreadCacheConfig thread_cache_config_;
+  std::unique_ptr<CacheShard[]> cache_shards_;
+
+  // the collector of the memory gauges of the arena in the metrics registry
+  size_t metrics_collector_id_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
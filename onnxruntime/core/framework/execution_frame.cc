@@ -76,6 +76,27 @@ Status IExecutionFrame::GetOrCreateNodeOutputMLValue(int index, const TensorShap
   return status;
 }
 
+Status IExecutionFrame::CreateNodeOutputView(int index, const Tensor& source, const TensorShape& shape,
+                                             const std::vector<int64_t>& strides, int64_t byte_offset,
+                                             OrtValue*& p_ort_value) {
+  p_ort_value = nullptr;
+  int ort_value_idx = GetNodeIdxToMLValueIdx(index);
+  if (ort_value_idx == NodeIndexInfo::kInvalidEntry || !IsViewMLValue(ort_value_idx)) {
+    return Status::OK();
+  }
+
+  OrtValue& ort_value = all_values_[ort_value_idx];
+  ORT_RETURN_IF_NOT(!ort_value.IsAllocated(), "The view ", ort_value_idx, " was already created");
+
+  // the view doesn't own the buffer, which the plan keeps alive as long as the view
+  auto p_tensor = std::make_unique<Tensor>(source.DataType(), shape, const_cast<void*>(source.DataRaw()),
+                                           source.Location(), byte_offset);
+  p_tensor->SetStrides(strides);
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  p_ort_value = &ort_value;
+  return Status::OK();
+}
+
 AllocatorPtr IExecutionFrame::GetAllocator(const OrtMemoryInfo& info) const {
   return GetAllocatorImpl(info);
 }
@@ -98,6 +119,22 @@ Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   return Status::OK();
 }
 
+void IExecutionFrame::ReleaseAllMLValues() {
+  for (auto& ort_value : all_values_) {
+    ort_value = OrtValue();
+  }
+}
+
+void IExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                            const std::unordered_map<int, OrtValue>& initializers,
+                            const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs_.size());
+
+  ReleaseAllMLValues();
+  Init(feed_mlvalue_idxs, feeds, initializers, fetches);
+}
+
 int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
   // the validity of index is checked by GetMLValueIndex
   int ort_value_idx = node_index_info_.GetMLValueIndex(index);
@@ -186,46 +223,121 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     }
   }
 
+  InitMemoryPatterns(feeds);
+}
+
+ExecutionFrame::~ExecutionFrame() = default;
+
+void ExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                           const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(custom_allocators_.empty(), "An execution frame with custom fetch allocators can't be reset.");
+  IExecutionFrame::Reset(feed_mlvalue_idxs, feeds, session_state_.GetInitializedTensors(), fetches);
+  InitMemoryPatterns(feeds);
+}
+
+// returns true if the dims of the tensors in feeds equal dims, which holds the rank followed by the dims of each feed
+static bool FeedDimsEqual(const std::vector<OrtValue>& feeds, const std::vector<int64_t>& dims) {
+  size_t pos = 0;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+
+    const auto& shape = feed.Get<Tensor>().Shape();
+    const size_t rank = shape.NumDimensions();
+    if (pos + 1 + rank > dims.size() || dims[pos] != static_cast<int64_t>(rank)) {
+      return false;
+    }
+
+    ++pos;
+    for (size_t i = 0; i < rank; ++i, ++pos) {
+      if (dims[pos] != shape[i]) {
+        return false;
+      }
+    }
+  }
+
+  return pos == dims.size();
+}
+
+void ExecutionFrame::InitMemoryPatterns(const std::vector<OrtValue>& feeds) {
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan()) {
-    std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
+  if (!session_state_.GetEnableMemoryPattern() || !session_state_.GetExecutionPlan()) {
+    return;
+  }
+
+  // a previous execution with the same input shapes already found the pattern
+  if (mem_patterns_ && !planner_ && FeedDimsEqual(feeds, mem_patterns_feed_dims_)) {
+    return;
+  }
+
+  planner_.reset();
+
+  // a pattern planned ahead of execution doesn't depend on the input shapes.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns = session_state_.GetStaticMemoryPatternGroup();
+  mem_patterns_feed_dims_.clear();
+
+  if (!mem_patterns) {
     bool all_tensors = true;
     // Reserve mem to avoid re-allocation.
-    input_shapes.reserve(feeds.size());
+    input_shapes_.clear();
+    input_shapes_.reserve(feeds.size());
     for (const auto& feed : feeds) {
       if (!(feed.IsTensor())) {
         all_tensors = false;
         break;
       }
       auto& tensor = feed.Get<Tensor>();
-      input_shapes.push_back(std::cref(tensor.Shape()));
+      input_shapes_.push_back(std::cref(tensor.Shape()));
     }
 
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
+      mem_patterns = session_state_.GetMemoryPatternGroup(input_shapes_);
       // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = std::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
+      if (!mem_patterns) {
+        planner_ = std::make_unique<OrtValuePatternPlanner>(*session_state_.GetExecutionPlan());
       } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
-                             ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
-                             : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
+        for (const TensorShape& shape : input_shapes_) {
+          mem_patterns_feed_dims_.push_back(static_cast<int64_t>(shape.NumDimensions()));
+          for (size_t i = 0, end = shape.NumDimensions(); i < end; ++i) {
+            mem_patterns_feed_dims_.push_back(shape[i]);
+          }
         }
       }
     }
+
+    input_shapes_.clear();
   }
-}
 
-ExecutionFrame::~ExecutionFrame() = default;
+  // the buffers of the previous execution still fit
+  if (mem_patterns == mem_patterns_) {
+    return;
+  }
+
+  buffers_.clear();
+  mem_patterns_ = std::move(mem_patterns);
+
+  if (mem_patterns_) {
+    // pre-allocate the big chunk requested in memory pattern.
+    // all the internal kernel's input/output tensors will be allocated on these buffer.
+    for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+      ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+      AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+      void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
+                         ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
+                         : nullptr;
+      if (buffer == nullptr && mem_patterns_->patterns[i].PeakSize() > 0) {
+        LOGS_DEFAULT(WARNING) << "Failed to allocate the " << mem_patterns_->patterns[i].PeakSize()
+                              << " bytes of the memory pattern on " << mem_patterns_->locations[i].name
+                              << ", allocating its tensors one by one instead";
+      }
+      buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
+    }
+  }
+}
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
@@ -272,19 +384,23 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // the pattern may have been generated from larger input shapes in the same bucket,
+        // so any block that is large enough can be used.
+        // the buffer is null if its allocation failed, in which case the tensors are allocated one by one.
+        if (it != buffers_.end() && it->second.get() != nullptr && block->size_ >= size) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
+          if (memory_profile_) {
+            ProfileAllocation(ort_value_index, size, true);
+          }
           return status;
         }
-        if (block->size_ != size) {
+        if (block->size_ < size) {
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
-          // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
           LOGS_DEFAULT(VERBOSE) << "For ort_value with index: " << ort_value_index
                                 << ", block in memory pattern size is: " << block->size_
                                 << " but the actually size is: " << size
@@ -297,7 +413,13 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     }
   }
   //no memory pattern, or the pattern is not correct.
-  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, shape, alloc);
+  void* buffer = len > 0 ? alloc->AllocArray(static_cast<size_t>(len), element_type->Size()) : nullptr;
+  if (len > 0 && buffer == nullptr) {
+    return Status(ONNXRUNTIME, OUT_OF_MEMORY,
+                  MakeString("Failed to allocate ", size, " bytes on ", location.name, " for ort_value with index: ",
+                             ort_value_index));
+  }
+  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, shape, buffer, alloc);
 
   ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
 
@@ -308,6 +430,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     TraceAllocate(ort_value_index, size);
   }
 
+  if (memory_profile_) {
+    ProfileAllocation(ort_value_index, size, false);
+  }
+
   return Status::OK();
 }
 
@@ -349,6 +475,10 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
 
   // reused OrtValue share the same fence
   ort_value.ShareFenceWith(ort_value_reuse);
+
+  if (memory_profile_) {
+    memory_profile_->node_reused_bytes += static_cast<size_t>(required_num_elements) * element_type->Size();
+  }
   return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
 }
 
@@ -362,6 +492,35 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_v
   return Status::OK();
 }
 
+Status ExecutionFrame::AllocateMLValueSubTensor(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                                MLDataType element_type, const TensorShape& shape) {
+  // the buffer is allocated with the static shape the planner laid the sub-tensors out in
+  const int buffer_index = per_alloc_plan.reused_buffer;
+  OrtValue& buffer_value = GetMutableMLValue(buffer_index);
+  if (!buffer_value.IsAllocated()) {
+    const auto& buffer_shapes = session_state_.GetExecutionPlan()->sub_tensor_buffer_shapes;
+    auto buffer_shape_entry = buffer_shapes.find(buffer_index);
+    ORT_ENFORCE(buffer_shape_entry != buffer_shapes.end(), "No shape for the buffer of sub-tensors ", buffer_index);
+    const TensorShape buffer_shape(buffer_shape_entry->second);
+    ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(buffer_value, buffer_index, &buffer_shape, 0));
+  }
+
+  auto* buffer_tensor = buffer_value.GetMutable<Tensor>();
+  const int64_t num_elements = shape.Size();
+  if (num_elements < 0 || per_alloc_plan.sub_tensor_offset + static_cast<size_t>(num_elements) * element_type->Size() >
+                              buffer_tensor->SizeInBytes()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "A tensor of shape ", shape, " doesn't fit at byte ",
+                           per_alloc_plan.sub_tensor_offset, " of the buffer of shape ", buffer_tensor->Shape(),
+                           ". Validate the shapes of the inputs of the Concat nodes in the model.");
+  }
+
+  void* buffer = static_cast<char*>(buffer_tensor->MutableDataRaw()) + per_alloc_plan.sub_tensor_offset;
+  if (memory_profile_) {
+    memory_profile_->node_reused_bytes += static_cast<size_t>(num_elements) * element_type->Size();
+  }
+  return AllocateTensorWithPreAllocateBufferHelper(ort_value, buffer, element_type, per_alloc_plan.location, shape);
+}
+
 static Status AllocateTraditionalMLValue(OrtValue& ort_value, const NonTensorTypeBase& type) {
   auto creator = type.GetCreateFunc();
   ort_value.Init(creator(), &type, type.GetDeleteFunc());
@@ -431,6 +590,14 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
             ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
         break;
       }
+      case AllocKind::kView: {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "OrtValue ", ort_value_index,
+                               " is planned as a view, which its kernel must create with OpKernelContext::OutputView");
+      }
+      case AllocKind::kSubTensor: {
+        ORT_RETURN_IF_ERROR(AllocateMLValueSubTensor(ort_value, per_alloc_plan, ml_data_type, *shape));
+        break;
+      }
       case AllocKind::kShare: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
         // copy at the OrtValue level so the shared_ptr for the data is shared between the two OrtValue instances
@@ -463,12 +630,58 @@ Status ExecutionFrame::CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_
   return AllocateAsPerAllocationPlan(ort_value, ort_value_idx, shape, nnz);
 }
 
+bool ExecutionFrame::IsViewMLValue(int ort_value_idx) const {
+  const auto& alloc_plan = session_state_.GetExecutionPlan()->allocation_plan;
+  return ort_value_idx >= 0 && static_cast<size_t>(ort_value_idx) < alloc_plan.size() &&
+         alloc_plan[ort_value_idx].alloc_kind == AllocKind::kView;
+}
+
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
+  if (memory_profile_) {
+    auto& value_bytes = memory_profile_->value_bytes[ort_value_idx];
+    memory_profile_->live_bytes -= value_bytes;
+    value_bytes = 0;
+  }
   return Status::OK();
 }
 
+void ExecutionFrame::EnableMemoryProfiling() {
+  memory_profile_ = std::make_unique<MemoryProfile>();
+  memory_profile_->value_bytes.resize(session_state_.GetExecutionPlan()->allocation_plan.size());
+}
+
+void ExecutionFrame::TakeNodeMemoryStats(size_t& allocated_bytes, size_t& pattern_bytes, size_t& reused_bytes) {
+  allocated_bytes = memory_profile_->node_allocated_bytes;
+  pattern_bytes = memory_profile_->node_pattern_bytes;
+  reused_bytes = memory_profile_->node_reused_bytes;
+  memory_profile_->node_allocated_bytes = 0;
+  memory_profile_->node_pattern_bytes = 0;
+  memory_profile_->node_reused_bytes = 0;
+}
+
+void ExecutionFrame::ProfileAllocation(int ort_value_idx, size_t size, bool from_pattern) {
+  auto& profile = *memory_profile_;
+  if (from_pattern) {
+    profile.node_pattern_bytes += size;
+  } else {
+    profile.node_allocated_bytes += size;
+  }
+
+  profile.live_bytes += size - profile.value_bytes[ort_value_idx];
+  profile.value_bytes[ort_value_idx] = size;
+  if (profile.live_bytes > profile.peak_bytes) {
+    profile.peak_bytes = profile.live_bytes;
+    profile.peak_values.clear();
+    for (size_t i = 0; i < profile.value_bytes.size(); ++i) {
+      if (profile.value_bytes[i] > 0) {
+        profile.peak_values.emplace_back(static_cast<int>(i), profile.value_bytes[i]);
+      }
+    }
+  }
+}
+
 const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
   const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
   const auto& alloc_plan = p_seq_exec_plan->allocation_plan;
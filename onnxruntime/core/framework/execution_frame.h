@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "core/common/common.h"
@@ -18,6 +19,7 @@
 namespace onnxruntime {
 
 class SessionState;
+class ICapturedGraph;
 class OrtValueNameIdxMap;
 class OrtValuePatternPlanner;
 struct MemoryPatternGroup;
@@ -48,6 +50,12 @@ class IExecutionFrame {
   // Shape is required for tensors but not traditional ML values.
   Status GetOrCreateNodeOutputMLValue(int index, const TensorShape* shape, OrtValue*& p_ort_value, size_t nnz = 0);
 
+  // Create the output at index as a strided view of the buffer of source, with the strides in elements and the
+  // offset in bytes from the start of that buffer, if the allocation plan lets it (AllocKind::kView).
+  // Set p_ort_value to nullptr otherwise.
+  Status CreateNodeOutputView(int index, const Tensor& source, const TensorShape& shape,
+                              const std::vector<int64_t>& strides, int64_t byte_offset, OrtValue*& p_ort_value);
+
   /**
    * write the output values to the 'fetches' vector
    * Don't access the values after SessionState is destroyed 
@@ -58,6 +66,9 @@ class IExecutionFrame {
 
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Release all the values, including the feeds and the outputs, without releasing the storage of the frame.
+  void ReleaseAllMLValues();
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
@@ -69,6 +80,11 @@ class IExecutionFrame {
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // release all the values and set up the feeds, fetches and initializers of another execution.
+  // the feeds and fetches must map to the OrtValue indexes the frame was created with.
+  void Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::unordered_map<int, OrtValue>& initializers, const std::vector<OrtValue>& fetches);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
@@ -85,6 +101,9 @@ class IExecutionFrame {
 
   virtual Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) = 0;
 
+  // whether the value is planned as a view created by its kernel
+  virtual bool IsViewMLValue(int /*ort_value_idx*/) const { return false; }
+
   const NodeIndexInfo& node_index_info_;
 
   // All the intermediate values for the entire graph.
@@ -107,6 +126,15 @@ class ExecutionFrame final : public IExecutionFrame {
 
   ~ExecutionFrame() override;
 
+  /**
+   * Prepare the frame for another execution, so repeated executions don't reallocate its storage.
+   * The buffers of the memory pattern are kept if the pattern still applies to the new feeds.
+   * The feeds and fetches must map to the same OrtValue indexes as the ones the frame was created with,
+   * and the frame must have been created without custom fetch allocators.
+   */
+  void Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::vector<OrtValue>& fetches);
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -125,12 +153,60 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_ != nullptr;
   }
 
+  // The device work captured from an execution with this frame, which the next executions with feeds of the same
+  // types and shapes replay instead of running the kernels. See SequentialExecutor.
+  struct CapturedGraph {
+    std::unique_ptr<ICapturedGraph> graph;
+    // the feeds and the outputs at the addresses the graph reads and writes
+    std::vector<OrtValue> feeds;
+    std::vector<OrtValue> fetches;
+
+    size_t num_executions = 0;
+    // set if capturing failed, so it isn't tried again
+    bool capture_failed = false;
+  };
+
+  CapturedGraph& GetCapturedGraph() { return captured_graph_; }
+
+  // The memory used by the tensors of an execution, recorded for the profiler. See EnableMemoryProfiling.
+  struct MemoryProfile {
+    // bytes of the tensors created since the last call of TakeNodeMemoryStats, by where their memory comes from:
+    // allocated from an allocator, placed in the buffers of the memory pattern, or sharing the buffer of another
+    // value as the allocation plan says
+    size_t node_allocated_bytes = 0;
+    size_t node_pattern_bytes = 0;
+    size_t node_reused_bytes = 0;
+
+    // bytes of the tensors the frame allocated or placed in the memory pattern that are not released yet,
+    // and the maximum they reached
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    // per OrtValue index, the bytes counted in live_bytes
+    std::vector<size_t> value_bytes;
+    // the OrtValue indexes and bytes of the tensors alive when peak_bytes was reached
+    std::vector<std::pair<int, size_t>> peak_values;
+  };
+
+  // Start recording the memory used by the tensors of the execution. Not thread safe, so only for executions
+  // that create the tensors of one node at a time.
+  void EnableMemoryProfiling();
+
+  // nullptr unless memory profiling is enabled
+  const MemoryProfile* GetMemoryProfile() const { return memory_profile_.get(); }
+
+  // returns the bytes allocated, placed in the memory pattern and reused by the tensors created since the last call
+  void TakeNodeMemoryStats(size_t& allocated_bytes, size_t& pattern_bytes, size_t& reused_bytes);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
   AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const override;
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
+  bool IsViewMLValue(int ort_value_idx) const override;
+
+  // find the memory pattern for the feeds and allocate its buffers, or set up the planner that traces one
+  void InitMemoryPatterns(const std::vector<OrtValue>& feeds);
 
   common::Status AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                              size_t nnz);
@@ -142,9 +218,15 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
                                                    const OrtMemoryInfo& location, const TensorShape& shape);
 
+  // allocate a kSubTensor value in the buffer of another value, allocating that first if needed
+  Status AllocateMLValueSubTensor(OrtValue& ort_value, const AllocPlanPerValue& per_alloc_plan,
+                                  MLDataType element_type, const TensorShape& shape);
+
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
+  void ProfileAllocation(int ort_value_idx, size_t size, bool from_pattern);
+
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
   const SessionState& session_state_;
@@ -155,7 +237,8 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // Shared with the SessionState cache, which may evict it while this frame is running.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -163,5 +246,15 @@ class ExecutionFrame final : public IExecutionFrame {
 
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
+
+  // the dims of the feeds from which mem_patterns_ was looked up, as the rank followed by the dims of each feed.
+  // lets Reset skip the lookup if the shapes didn't change.
+  std::vector<int64_t> mem_patterns_feed_dims_;
+  // storage for the shapes passed to the memory pattern lookup
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes_;
+
+  CapturedGraph captured_graph_;
+
+  std::unique_ptr<MemoryProfile> memory_profile_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_pipeline.h"
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+ExecutionPipeline::ExecutionPipeline(const SessionState& session_state,
+                                     const std::vector<concurrency::ThreadPool*>& thread_pools)
+    : session_state_{session_state}, plan_{*session_state.GetCompiledExecutionPlan()} {
+  ORT_ENFORCE(!thread_pools.empty(), "A pipeline needs at least one stage.");
+
+  const size_t num_steps = plan_.steps.size();
+  const size_t num_stages = thread_pools.size();
+
+  // the steps after which the execution provider changes
+  std::vector<size_t> provider_changes;
+  for (size_t s = 1; s < num_steps; ++s) {
+    if (plan_.steps[s].kernel->Node().GetExecutionProviderType() !=
+        plan_.steps[s - 1].kernel->Node().GetExecutionProviderType()) {
+      provider_changes.push_back(s);
+    }
+  }
+
+  // Each boundary between stages moves from where it balances the nodes to the closest change of execution provider
+  // before the next one, if any, so the host nodes of an execution overlap with the device nodes of another.
+  std::vector<size_t> boundaries(num_stages + 1, num_steps);
+  boundaries[0] = 0;
+  for (size_t i = 1; i < num_stages; ++i) {
+    const size_t balanced = num_steps * i / num_stages;
+    const size_t next_balanced = num_steps * (i + 1) / num_stages;
+    boundaries[i] = balanced;
+    size_t best_distance = num_steps;
+    for (size_t change : provider_changes) {
+      const size_t distance = change > balanced ? change - balanced : balanced - change;
+      if (change > boundaries[i - 1] && change < next_balanced && distance < best_distance) {
+        boundaries[i] = change;
+        best_distance = distance;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_stages; ++i) {
+    auto stage = std::make_unique<Stage>();
+    stage->begin = boundaries[i];
+    stage->end = boundaries[i + 1];
+    stage->thread_pool = thread_pools[i];
+    stages_.push_back(std::move(stage));
+  }
+
+  for (size_t i = 0; i < num_stages; ++i) {
+    stages_[i]->thread = std::thread([this, i]() { RunStage(i); });
+  }
+}
+
+ExecutionPipeline::~ExecutionPipeline() {
+  for (auto& stage : stages_) {
+    {
+      std::lock_guard<OrtMutex> lock(stage->mutex);
+      stage->stop = true;
+    }
+    stage->cv.notify_one();
+  }
+
+  for (auto& stage : stages_) {
+    stage->thread.join();
+  }
+}
+
+Status ExecutionPipeline::Execute(ExecutionFrame& frame, const bool& terminate_flag, const logging::Logger& logger) {
+  Request request{&frame, &terminate_flag, &logger};
+  Enqueue(0, request);
+
+  std::unique_lock<OrtMutex> lock(done_mutex_);
+  done_cv_.wait(lock, [&request]() { return request.done; });
+  return request.status;
+}
+
+void ExecutionPipeline::Enqueue(size_t stage, Request& request) {
+  auto& next = *stages_[stage];
+  {
+    std::lock_guard<OrtMutex> lock(next.mutex);
+    next.requests.push_back(&request);
+  }
+  next.cv.notify_one();
+}
+
+void ExecutionPipeline::Complete(Request& request) {
+  {
+    std::lock_guard<OrtMutex> lock(done_mutex_);
+    request.done = true;
+  }
+  done_cv_.notify_all();
+}
+
+void ExecutionPipeline::RunStage(size_t stage_index) {
+  auto& stage = *stages_[stage_index];
+  for (;;) {
+    Request* request;
+    {
+      std::unique_lock<OrtMutex> lock(stage.mutex);
+      stage.cv.wait(lock, [&stage]() { return stage.stop || !stage.requests.empty(); });
+      if (stage.requests.empty()) {
+        return;
+      }
+      request = stage.requests.front();
+      stage.requests.pop_front();
+    }
+
+    // the kernels may throw, which must not end the thread of the stage
+    try {
+      request->status = SequentialExecutor::ExecuteCompiledSteps(session_state_, plan_, stage.begin, stage.end,
+                                                                 *request->frame, *request->terminate_flag,
+                                                                 stage.thread_pool, *request->logger);
+    } catch (const std::exception& ex) {
+      request->status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    } catch (...) {
+      request->status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Unknown exception in pipeline stage ",
+                                        stage_index);
+    }
+
+    // a failed execution skips the remaining stages
+    if (request->status.IsOK() && stage_index + 1 < stages_.size()) {
+      Enqueue(stage_index + 1, *request);
+    } else {
+      Complete(*request);
+    }
+  }
+}
+
+Status PipelineExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
+                                 const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
+                                 std::vector<OrtValue>& fetches,
+                                 const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                 const logging::Logger& logger) {
+  ORT_ENFORCE(&session_state == &pipeline_.GetSessionState(),
+              "The pipeline runs the plan of another session state.");
+
+  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  LOGS(logger, INFO) << "Begin execution through " << pipeline_.NumStages() << " pipeline stages";
+  ORT_RETURN_IF_ERROR(pipeline_.Execute(frame, terminate_flag_, logger));
+
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  return SequentialExecutor::CacheMemoryPatterns(session_state, frame, feeds);
+}
+}  // namespace onnxruntime
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/iexecutor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class ExecutionFrame;
+class SessionState;
+struct CompiledExecutionPlan;
+namespace concurrency {
+class ThreadPool;
+}
+namespace logging {
+class Logger;
+}
+
+/**
+ * Runs the compiled execution plan of a session as a pipeline: the steps are split into consecutive stages, each run
+ * by its own thread with its own thread pool for the parallel loops of the kernels. A frame is handed from one stage
+ * to the next, so concurrent executions overlap, each in a different stage, instead of competing for the same threads.
+ * The stages are balanced by their number of nodes, with their boundaries moved to the closest changes of execution
+ * provider, so the host nodes of an execution run while the device nodes of another do. The fences of the values
+ * order the work of the queues of the devices across stages, as they do for the sequential executor.
+ */
+class ExecutionPipeline {
+ public:
+  /**
+   * @param thread_pools The pool of each stage, and so the number of stages. A nullptr is the session state's pool.
+   * The session state must have a compiled execution plan.
+   */
+  ExecutionPipeline(const SessionState& session_state, const std::vector<concurrency::ThreadPool*>& thread_pools);
+  ~ExecutionPipeline();
+
+  // runs the plan on the frame through all the stages, and returns once the last stage is done with it
+  common::Status Execute(ExecutionFrame& frame, const bool& terminate_flag, const logging::Logger& logger);
+
+  const SessionState& GetSessionState() const { return session_state_; }
+  size_t NumStages() const { return stages_.size(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionPipeline);
+
+  // an execution in flight, owned by the caller of Execute
+  struct Request {
+    ExecutionFrame* frame;
+    const bool* terminate_flag;
+    const logging::Logger* logger;
+    common::Status status;
+    bool done = false;
+  };
+
+  struct Stage {
+    // the steps [begin, end) of the compiled plan
+    size_t begin;
+    size_t end;
+    concurrency::ThreadPool* thread_pool;
+    std::thread thread;
+    OrtMutex mutex;
+    OrtCondVar cv;
+    std::deque<Request*> requests;
+    bool stop = false;
+  };
+
+  void Enqueue(size_t stage, Request& request);
+  void RunStage(size_t stage);
+  void Complete(Request& request);
+
+  const SessionState& session_state_;
+  const CompiledExecutionPlan& plan_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+
+  OrtMutex done_mutex_;
+  OrtCondVar done_cv_;
+};
+
+/**
+ * Executes the graph of the session state of an ExecutionPipeline through it, with a frame created per execution.
+ */
+class PipelineExecutor : public IExecutor {
+ public:
+  PipelineExecutor(ExecutionPipeline& pipeline, const bool& terminate_flag)
+      : pipeline_{pipeline}, terminate_flag_{terminate_flag} {}
+
+  common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
+                         const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
+                         std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineExecutor);
+
+  ExecutionPipeline& pipeline_;
+  const bool& terminate_flag_;
+};
+}  // namespace onnxruntime
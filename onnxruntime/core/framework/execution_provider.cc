@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #include "core/framework/execution_provider.h"
 
+#include <algorithm>
+
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -45,9 +47,17 @@ IExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
 
 common::Status IExecutionProvider::Sync() const { return Status::OK(); };
 
-common::Status IExecutionProvider::OnRunStart() { return Status::OK(); }
+common::Status IExecutionProvider::OnRunStart(const RunOptions& /*run_options*/) { return Status::OK(); }
+
+common::Status IExecutionProvider::OnRunEnd(const RunOptions& /*run_options*/) { return Status::OK(); }
 
-common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
+common::Status IExecutionProvider::BeginGraphCapture() const {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, type_, " does not support graph capture.");
+}
+
+common::Status IExecutionProvider::EndGraphCapture(std::unique_ptr<ICapturedGraph>& /*captured_graph*/) const {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, type_, " does not support graph capture.");
+}
 
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtMemoryInfo& info = allocator->Info();
@@ -60,6 +70,22 @@ void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   allocator_list_.emplace_back(gsl::not_null<IAllocator*>(allocator.get()));
 }
 
+bool IExecutionProvider::ReplaceAllocator(AllocatorPtr allocator) {
+  const OrtMemoryInfo& info = allocator->Info();
+  auto iter = allocators_.find(MakeKey(info.id, info.mem_type));
+  if (iter == allocators_.end() || iter->second->Info() != info) {
+    return false;
+  }
+
+  const IAllocator* existing = iter->second.get();
+  auto list_entry = std::find_if(allocator_list_.begin(), allocator_list_.end(),
+                                 [existing](const IAllocator* entry) { return entry == existing; });
+  ORT_ENFORCE(list_entry != allocator_list_.end());
+  *list_entry = gsl::not_null<IAllocator*>(allocator.get());
+  iter->second = std::move(allocator);
+  return true;
+}
+
 common::Status IExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& /*fused_node*/,
                                            std::vector<NodeComputeInfo>& /*node_compute_funcs*/) {
   return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
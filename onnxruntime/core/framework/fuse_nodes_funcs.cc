@@ -1,4 +1,8 @@
 #include "core/framework/fuse_nodes_funcs.h"
+
+#include <map>
+
+#include "core/graph/function.h"
 #include "core/platform/env.h"
 
 namespace onnxruntime {
@@ -20,6 +24,23 @@ Status FuncManager::AddFuncInfo(const std::string& name, ComputeFunc compute, Cr
   return Status::OK();
 }
 
+Status FuncManager::AddFuncInfo(const std::string& name, std::shared_ptr<const NodeComputeInfo> compiled) {
+  if (!compiled || !compiled->compute_func || !compiled->create_state_func || !compiled->release_state_func)
+    return Status(common::ONNXRUNTIME, common::FAIL, "Can't use func with null ptr");
+  // the functions are shared, only the pointer to them is copied into the kernels
+  return AddFuncInfo(
+      name,
+      [compiled](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
+        return compiled->compute_func(state, api, context);
+      },
+      [compiled](ComputeContext* context, FunctionState* state) {
+        return compiled->create_state_func(context, state);
+      },
+      [compiled](FunctionState state) {
+        compiled->release_state_func(state);
+      });
+}
+
 Status FuncManager::GetFuncs(const std::string& name, ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const {
   auto it = fused_funcs_->find(name);
   if (it == fused_funcs_->end())
@@ -58,4 +79,63 @@ Status FuncManager::GetFuncs(const std::string& name, ComputeFunc* compute, Crea
   return Status::OK();
 }
 
+CompiledFuncCache& CompiledFuncCache::Instance() {
+  static CompiledFuncCache cache;
+  return cache;
+}
+
+std::string CompiledFuncCache::GetKey(const IExecutionProvider& provider, const Node& fused_node) {
+  const std::string provider_key = provider.GetCompileCacheKey();
+  const auto* function = fused_node.GetFunctionBody();
+  if (provider_key.empty() || function == nullptr) {
+    return std::string();
+  }
+
+  // the subgraph holds the initializers the fused node reads, so subgraphs of different weights don't match
+  const Graph& subgraph = function->Body();
+  std::string content = subgraph.ToGraphProto().SerializeAsString();
+  const std::map<std::string, int> opsets(subgraph.DomainToVersionMap().begin(), subgraph.DomainToVersionMap().end());
+  for (const auto& opset : opsets) {
+    content += opset.first + ":" + std::to_string(opset.second) + ";";
+  }
+
+  // the whole content rather than a hash of it, as a collision would run the functions of another subgraph
+  return provider.Type() + ";" + provider_key + ";" + content;
+}
+
+std::shared_ptr<const NodeComputeInfo> CompiledFuncCache::Get(const std::string& key) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  return it != entries_.end() ? it->second.lock() : nullptr;
+}
+
+std::shared_ptr<const NodeComputeInfo> CompiledFuncCache::Insert(const std::string& key, NodeComputeInfo compiled) {
+  // the functions are destroyed outside of mutex_ if another session cached its own meanwhile
+  auto entry = std::make_shared<const NodeComputeInfo>(std::move(compiled));
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Prune();
+  auto& cached = entries_[key];
+  if (auto existing = cached.lock()) {
+    return existing;
+  }
+  cached = entry;
+  return entry;
+}
+
+size_t CompiledFuncCache::Size() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Prune();
+  return entries_.size();
+}
+
+void CompiledFuncCache::Prune() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 #include "core/common/common.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/ex_lib_loader.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -13,6 +14,9 @@ class FuncManager {
 
   Status AddFuncInfo(const std::string& name, ComputeFunc compute, CreateFunctionStateFunc create, DestroyFunctionStateFunc release);
 
+  // Adds the functions of a CompiledFuncCache entry, which the functions handed out keep alive.
+  Status AddFuncInfo(const std::string& name, std::shared_ptr<const NodeComputeInfo> compiled);
+
   Status GetFuncs(const std::string& name, ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const;
 
   void SetFusedFuncs(const FuncManager& func_mgr) {
@@ -38,4 +42,40 @@ class FuncManager {
   std::unique_ptr<ExLibLoader> lib_loader_;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FuncManager);
 };
+
+/**
+The functions the execution providers compiled for fused nodes, shared by the sessions of the process.
+
+The entries are keyed by the provider type and GetCompileCacheKey, and by the content of the fused subgraph:
+its nodes, attributes, initializers and opsets. So the sessions of the same model, or of models sharing
+subgraphs, compile each subgraph once and share the compiled functions rather than holding a copy each. An entry
+lives as long as a session uses its functions, and only the providers with a non-empty GetCompileCacheKey use the
+cache.
+*/
+class CompiledFuncCache {
+ public:
+  static CompiledFuncCache& Instance();
+
+  // The key of fused_node compiled by provider. Empty if the provider doesn't share its compiled functions.
+  static std::string GetKey(const IExecutionProvider& provider, const Node& fused_node);
+
+  // The functions cached under key, nullptr if there are none.
+  std::shared_ptr<const NodeComputeInfo> Get(const std::string& key);
+
+  // Caches compiled under key. Returns the functions another session cached under key meanwhile, if any.
+  std::shared_ptr<const NodeComputeInfo> Insert(const std::string& key, NodeComputeInfo compiled);
+
+  // the number of entries in use
+  size_t Size();
+
+ private:
+  CompiledFuncCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CompiledFuncCache);
+
+  // Drops the entries no session uses anymore. Requires mutex_.
+  void Prune();
+
+  OrtMutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<const NodeComputeInfo>> entries_;
+};
 }  // namespace onnxruntime
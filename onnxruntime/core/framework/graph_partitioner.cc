@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <algorithm>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +13,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/framework/tensorprotoutils.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,6 +109,253 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+namespace {
+// Returns true if the memory of the provider isn't on the host, such as CUDA.
+bool IsDeviceProvider(const IExecutionProvider& provider) {
+  auto allocator = provider.GetAllocator(0, OrtMemTypeDefault);
+  return allocator != nullptr && allocator->Info().device.Type() != OrtDevice::CPU;
+}
+
+// Returns the island of connected nodes assigned to the same provider as start, and marks them visited.
+std::vector<const Node*> CollectIsland(const Node& start, std::unordered_set<NodeIndex>& visited) {
+  const std::string& provider_type = start.GetExecutionProviderType();
+  std::vector<const Node*> island;
+  std::vector<const Node*> to_visit{&start};
+  visited.insert(start.Index());
+  while (!to_visit.empty()) {
+    const Node* node = to_visit.back();
+    to_visit.pop_back();
+    island.push_back(node);
+
+    auto visit = [&](const Node& next) {
+      if (next.GetExecutionProviderType() == provider_type && visited.insert(next.Index()).second) {
+        to_visit.push_back(&next);
+      }
+    };
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      visit(*it);
+    }
+    for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+      visit(*it);
+    }
+  }
+  return island;
+}
+
+// Returns the size of a tensor from its inferred type and shape, or -1 if the shape isn't known.
+double GetStaticSizeInBytes(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape == nullptr) {
+    return -1;
+  }
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_data_type(type->tensor_type().elem_type());
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return -1;
+    }
+    tensor_proto.add_dims(dim.dim_value());
+  }
+
+  size_t bytes = 0;
+  if (!utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &bytes).IsOK()) {
+    return -1;
+  }
+  return static_cast<double>(bytes);
+}
+
+// Returns the number of elements of a tensor from its inferred shape, or -1 if the shape isn't known.
+double GetStaticElementCount(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return -1;
+  }
+
+  double count = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return -1;
+    }
+    count *= static_cast<double>(dim.dim_value());
+  }
+  return count;
+}
+
+// Estimates the operations a node computes on the CPU, or returns -1 if the shapes aren't known. The products of
+// matrices and convolutions cost an operation per output and element reduced, other nodes an operation per
+// input and output element.
+double EstimateComputeCost(const Node& node) {
+  double input_elements = 0;
+  for (const auto* input : node.InputDefs()) {
+    if (input->Exists()) {
+      const double count = GetStaticElementCount(*input);
+      if (count < 0) {
+        return -1;
+      }
+      input_elements += count;
+    }
+  }
+
+  double output_elements = 0;
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      const double count = GetStaticElementCount(*output);
+      if (count < 0) {
+        return -1;
+      }
+      output_elements += count;
+    }
+  }
+
+  // the reduced dimension is the last one of the first input for MatMul, and the size of a filter for Conv
+  const auto& inputs = node.InputDefs();
+  if ((node.OpType() == "MatMul" || node.OpType() == "Gemm" || node.OpType() == "Conv") && inputs.size() >= 2) {
+    const auto* shape = inputs[node.OpType() == "Conv" ? 1 : 0]->Shape();
+    if (shape != nullptr && shape->dim_size() >= 2) {
+      double reduced = 1;
+      const int first = node.OpType() == "Conv" ? 1 : shape->dim_size() - 1;
+      for (int i = first; i < shape->dim_size(); ++i) {
+        reduced *= static_cast<double>(shape->dim(i).dim_value());
+      }
+      return output_elements * reduced;
+    }
+  }
+
+  return input_elements + output_elements;
+}
+}  // namespace
+
+void GraphPartitioner::PlaceIslandsByCost(
+    Graph& graph, const std::unordered_set<NodeIndex>& cpu_nodes,
+    const std::unordered_map<NodeIndex, std::vector<const IExecutionProvider*>>& device_nodes) const {
+  // the nodes of a provider whose memory isn't on the host, which run their own kernels instead of a fused node.
+  auto is_device_node = [this](const Node& node) {
+    const auto* provider = providers_.Get(node);
+    return provider != nullptr && node.GetExecutionProviderType() != kCpuExecutionProvider &&
+           IsDeviceProvider(*provider) &&
+           kernel_registry_mgr_.HasImplementationOf(node, node.GetExecutionProviderType());
+  };
+
+  // the graph inputs and outputs are on the host
+  const std::unordered_set<const NodeArg*> graph_inputs(graph.GetInputs().cbegin(), graph.GetInputs().cend());
+  const std::unordered_set<const NodeArg*> graph_outputs(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+
+  // estimates the cost of running the island on the CPU and on a device: its compute, and the copies of the values
+  // crossing its boundary from or to the other side. The initializers are copied once when the session is
+  // initialized. Returns false if the shapes aren't known.
+  auto estimate_costs = [&](const std::vector<const Node*>& island, double& cpu_cost, double& device_cost) {
+    std::unordered_set<NodeIndex> island_nodes;
+    double compute_cost = 0;
+    for (const Node* node : island) {
+      const double cost = EstimateComputeCost(*node);
+      if (cost < 0) {
+        return false;
+      }
+      compute_cost += cost;
+      island_nodes.insert(node->Index());
+    }
+
+    bool known = true;
+    double copy_cost_on_device = 0;
+    double copy_cost_on_cpu = 0;
+    auto add_copy = [&](const NodeArg& arg, bool other_side_on_device) {
+      const double bytes = GetStaticSizeInBytes(arg);
+      if (bytes < 0) {
+        known = false;
+      }
+      (other_side_on_device ? copy_cost_on_cpu : copy_cost_on_device) +=
+          cost_model_->copy_latency + cost_model_->copy_cost_per_byte * bytes;
+    };
+
+    std::unordered_set<const NodeArg*> boundary_args;
+    for (const Node* node : island) {
+      for (auto it = node->InputEdgesBegin(); it != node->InputEdgesEnd(); ++it) {
+        const Node& producer = it->GetNode();
+        const NodeArg* arg = producer.OutputDefs()[it->GetSrcArgIndex()];
+        if (island_nodes.count(producer.Index()) == 0 && boundary_args.insert(arg).second) {
+          add_copy(*arg, is_device_node(producer));
+        }
+      }
+      for (const auto* input : node->InputDefs()) {
+        if (graph_inputs.count(input) != 0 && boundary_args.insert(input).second) {
+          add_copy(*input, false);
+        }
+      }
+      for (auto it = node->OutputEdgesBegin(); it != node->OutputEdgesEnd(); ++it) {
+        const Node& consumer = it->GetNode();
+        const NodeArg* arg = node->OutputDefs()[it->GetSrcArgIndex()];
+        if (island_nodes.count(consumer.Index()) == 0 && boundary_args.insert(arg).second) {
+          add_copy(*arg, is_device_node(consumer));
+        }
+      }
+      for (const auto* output : node->OutputDefs()) {
+        if (graph_outputs.count(output) != 0 && boundary_args.insert(output).second) {
+          add_copy(*output, false);
+        }
+      }
+    }
+
+    cpu_cost = compute_cost + copy_cost_on_cpu;
+    device_cost = compute_cost / cost_model_->device_speedup + copy_cost_on_device;
+    return known;
+  };
+
+  // first move the islands left on the CPU to the device provider preferred among those that can run all their
+  // nodes, e.g. the nodes CUDA leaves on the CPU because their inputs come from the CPU. Moving an island between
+  // device nodes merges them into one device island.
+  std::unordered_set<NodeIndex> visited;
+  for (auto& start : graph.Nodes()) {
+    if (visited.count(start.Index()) != 0 || start.GetExecutionProviderType() != kCpuExecutionProvider) {
+      continue;
+    }
+
+    const auto island = CollectIsland(start, visited);
+    auto can_run_island = [&](const IExecutionProvider* provider) {
+      return std::all_of(island.cbegin(), island.cend(), [&](const Node* node) {
+        auto entry = device_nodes.find(node->Index());
+        return entry != device_nodes.cend() &&
+               std::find(entry->second.cbegin(), entry->second.cend(), provider) != entry->second.cend();
+      });
+    };
+
+    auto candidates = device_nodes.find(start.Index());
+    if (candidates == device_nodes.cend()) {
+      continue;
+    }
+    auto device = std::find_if(candidates->second.cbegin(), candidates->second.cend(), can_run_island);
+    double cpu_cost = 0;
+    double device_cost = 0;
+    if (device != candidates->second.cend() && estimate_costs(island, cpu_cost, device_cost) &&
+        device_cost < cpu_cost) {
+      for (const Node* node : island) {
+        graph.GetNode(node->Index())->SetExecutionProviderType((*device)->Type());
+      }
+    }
+  }
+
+  // then move the device islands that are cheaper to run on the CPU, if it can run all their nodes.
+  visited.clear();
+  for (auto& start : graph.Nodes()) {
+    if (visited.count(start.Index()) != 0 || !is_device_node(start)) {
+      continue;
+    }
+
+    const auto island = CollectIsland(start, visited);
+    const bool cpu_can_run_island = std::all_of(island.cbegin(), island.cend(), [&](const Node* node) {
+      return cpu_nodes.count(node->Index()) != 0;
+    });
+    double cpu_cost = 0;
+    double device_cost = 0;
+    if (cpu_can_run_island && estimate_costs(island, cpu_cost, device_cost) && cpu_cost < device_cost) {
+      for (const Node* node : island) {
+        graph.GetNode(node->Index())->SetExecutionProviderType(kCpuExecutionProvider);
+      }
+    }
+  }
+}
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
@@ -133,6 +384,28 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // Partitioning <graph> based on provider preference and their capabilities.
   GraphViewer graph_viewer(graph);
 
+  // the nodes the CPU execution provider has kernels for, and the device providers that can run each node, between
+  // which the cost model may move the nodes. They are looked up before the nodes are assigned, as the kernel lookup
+  // matches the assigned provider.
+  std::unordered_set<NodeIndex> cpu_nodes;
+  std::unordered_map<NodeIndex, std::vector<const IExecutionProvider*>> device_nodes;
+  const bool place_by_cost = cost_model_ != nullptr && providers_.Get(kCpuExecutionProvider) != nullptr;
+  if (place_by_cost) {
+    for (const auto& node : graph.Nodes()) {
+      if (!node.GetExecutionProviderType().empty()) {
+        continue;
+      }
+      if (kernel_registry_mgr_.HasImplementationOf(node, kCpuExecutionProvider)) {
+        cpu_nodes.insert(node.Index());
+      }
+      for (const auto& provider : providers_) {
+        if (IsDeviceProvider(*provider) && provider->CanRunNode(node)) {
+          device_nodes[node.Index()].push_back(provider.get());
+        }
+      }
+    }
+  }
+
   // If an execution provider return the capability that he could run a sub-graph,
   // onnxruntime will fuse the sub-graph into a function node. if the execution provider
   // says he need to compile the graph at runtime (by need_compile flag),
@@ -146,8 +419,19 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   for (auto& provider : providers_) {
     int count = 0;
     std::vector<Node*> nodes_need_compile;
+    TimePoint start_time;
+    if (profiler_ != nullptr) {
+      start_time = profiler_->StartTime();
+    }
     std::vector<std::unique_ptr<ComputeCapability>> capabilities =
         provider->GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
+    if (profiler_ != nullptr) {
+      profiler_->RecordInitializationPhase(provider->Type() + "_GetCapability", start_time,
+                                           {{"phase", "get_capability"},
+                                            {"provider", provider->Type()},
+                                            {"graph", graph.Name()},
+                                            {"capabilities", std::to_string(capabilities.size())}});
+    }
     for (auto& capability : capabilities) {
       Node* n = PlaceNode(graph, std::move(capability->sub_graph), kernel_registry_mgr_, provider->Type(), count);
       if (n != nullptr) {
@@ -156,20 +440,53 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     }
 
     if (!nodes_need_compile.empty()) {
+      if (profiler_ != nullptr) {
+        start_time = profiler_->StartTime();
+      }
       if (export_dll) {
         std::string dll_path;
         ORT_RETURN_IF_ERROR(provider->Compile(nodes_need_compile, dll_path));
         for (auto* node : nodes_need_compile)
           ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(node->Name(), dll_path));
       } else {
+        // the nodes whose subgraph another session compiled reuse its functions, the others are compiled
+        auto& cache = CompiledFuncCache::Instance();
+        std::vector<Node*> nodes_to_compile;
+        std::vector<std::string> cache_keys;
+        for (auto* node : nodes_need_compile) {
+          std::string key = CompiledFuncCache::GetKey(*provider, *node);
+          auto compiled = key.empty() ? nullptr : cache.Get(key);
+          if (compiled != nullptr) {
+            ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(node->Name(), std::move(compiled)));
+          } else {
+            nodes_to_compile.push_back(node);
+            cache_keys.push_back(std::move(key));
+          }
+        }
+
         std::vector<NodeComputeInfo> node_compute_funcs;
-        ORT_RETURN_IF_ERROR(provider->Compile(nodes_need_compile, node_compute_funcs));
-        ORT_ENFORCE(node_compute_funcs.size() == nodes_need_compile.size(),
+        if (!nodes_to_compile.empty()) {
+          ORT_RETURN_IF_ERROR(provider->Compile(nodes_to_compile, node_compute_funcs));
+        }
+        ORT_ENFORCE(node_compute_funcs.size() == nodes_to_compile.size(),
                     "Provider doesn't return correct number of compiled functions");
-        for (size_t j = 0; j < nodes_need_compile.size(); j++)
-          ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(nodes_need_compile[j]->Name(), node_compute_funcs[j].compute_func,
-                                                   node_compute_funcs[j].create_state_func,
-                                                   node_compute_funcs[j].release_state_func));
+        for (size_t j = 0; j < nodes_to_compile.size(); j++) {
+          if (!cache_keys[j].empty()) {
+            ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(nodes_to_compile[j]->Name(),
+                                                     cache.Insert(cache_keys[j], std::move(node_compute_funcs[j]))));
+          } else {
+            ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(nodes_to_compile[j]->Name(), node_compute_funcs[j].compute_func,
+                                                     node_compute_funcs[j].create_state_func,
+                                                     node_compute_funcs[j].release_state_func));
+          }
+        }
+      }
+      if (profiler_ != nullptr) {
+        profiler_->RecordInitializationPhase(provider->Type() + "_Compile", start_time,
+                                             {{"phase", "compile"},
+                                              {"provider", provider->Type()},
+                                              {"graph", graph.Name()},
+                                              {"fused_nodes", std::to_string(nodes_need_compile.size())}});
       }
       for (auto* node : nodes_need_compile) {
         //prepare the func kernel
@@ -181,6 +498,10 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
     }
   }
 
+  if (place_by_cost) {
+    PlaceIslandsByCost(graph, cpu_nodes, device_nodes);
+  }
+
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   // To see if the node with no provider can be inlined. If one such nodes can be
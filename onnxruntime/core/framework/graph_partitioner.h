@@ -4,9 +4,11 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/profiler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/fuse_nodes_funcs.h"
+#include "core/framework/partitioning_cost_model.h"
 
 namespace onnxruntime {
 
@@ -16,16 +18,33 @@ class KernelRegistryManager;
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  //If a cost model is given, the assignment is refined after the providers claim their nodes. The connected groups
+  //of nodes left on the CPU that a device provider can run are moved to the device, and the groups of nodes assigned
+  //to a device are moved to the CPU, where their estimated compute and copies between the host and the device
+  //cost less.
+  //If a profiler is given, the GetCapability and Compile calls of the providers are recorded as initialization phases.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   const PartitioningCostModel* cost_model = nullptr, profiling::Profiler* profiler = nullptr)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {}
+        providers_(providers),
+        cost_model_(cost_model),
+        profiler_(profiler) {}
 
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
+  // moves the islands of nodes between the CPU and the devices where they cost less, see the constructor.
+  // cpu_nodes holds the nodes the CPU execution provider has kernels for, and device_nodes the device providers
+  // that can run a node, in the order of preference.
+  void PlaceIslandsByCost(
+      Graph& graph, const std::unordered_set<NodeIndex>& cpu_nodes,
+      const std::unordered_map<NodeIndex, std::vector<const IExecutionProvider*>>& device_nodes) const;
+
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  const PartitioningCostModel* const cost_model_;
+  profiling::Profiler* const profiler_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/huge_page_allocator.h"
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+constexpr size_t HugePageCPUAllocator::kMinHugePageAllocation;
+
+void* HugePageCPUAllocator::Alloc(size_t size) {
+  if (size >= kMinHugePageAllocation) {
+    size_t mapped_size = 0;
+    void* p = Env::Default().AllocateHugePages(size, mapped_size);
+    if (p != nullptr) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      huge_page_allocations_.emplace(p, mapped_size);
+      return p;
+    }
+  }
+
+  return CPUAllocator::Alloc(size);
+}
+
+void HugePageCPUAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  size_t mapped_size = 0;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = huge_page_allocations_.find(p);
+    if (it != huge_page_allocations_.end()) {
+      mapped_size = it->second;
+      huge_page_allocations_.erase(it);
+    }
+  }
+
+  if (mapped_size != 0) {
+    Env::Default().FreeHugePages(p, mapped_size);
+  } else {
+    CPUAllocator::Free(p);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+A CPU allocator that backs allocations of at least a huge page with huge pages, so large buffers such as the
+regions of an arena and the initializers placed in them need far fewer TLB entries.
+Smaller allocations, and the ones huge pages aren't available for, use the regular CPU allocation.
+*/
+class HugePageCPUAllocator : public CPUAllocator {
+ public:
+  // the smallest allocation backed by huge pages
+  static constexpr size_t kMinHugePageAllocation = size_t{2} << 20;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  OrtMutex mutex_;
+  // the mapped size of each allocation backed by huge pages
+  std::unordered_map<void*, size_t> huge_page_allocations_;
+};
+
+}  // namespace onnxruntime
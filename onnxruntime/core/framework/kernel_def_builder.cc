@@ -156,4 +156,9 @@ KernelDefBuilder& KernelDefBuilder::Alias(int input_index, int output_index) {
   return *this;
 }
 
+KernelDefBuilder& KernelDefBuilder::MayView(int input_index, int output_index) {
+  kernel_def_->view_map_.emplace_back(input_index, output_index);
+  return *this;
+}
+
 }  // namespace onnxruntime
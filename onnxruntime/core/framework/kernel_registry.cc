@@ -111,6 +111,41 @@ class TypeBindingResolver {
   const Node& node_;
   std::unique_ptr<TypeBindingMap> type_binding_map_;
 };
+
+std::string GetKernelIndexKey(const std::string& op_type, const std::string& domain, const std::string& provider) {
+  return op_type + '\n' + domain + '\n' + provider;
+}
+
+// Builds the key of the kernel lookup cache for node, which holds everything VerifyKernelDef reads from the node:
+// the op, its schema version, the provider and the types of the arguments, with the number of actual arguments of
+// each formal input so variadic inputs bind the same way. Returns false if the node has no schema.
+bool GetKernelLookupKey(const Node& node, const std::string& provider, std::string& key) {
+  if (node.Op() == nullptr) {
+    return false;
+  }
+
+  key = GetKernelIndexKey(node.OpType(), node.Domain(), provider);
+  key += '\n';
+  key += std::to_string(node.Op()->since_version());
+  for (int count : node.InputArgCount()) {
+    key += ',';
+    key += std::to_string(count);
+  }
+
+  auto append_types = [&key](const ConstPointerContainer<std::vector<NodeArg*>>& args) {
+    for (const NodeArg* arg : args) {
+      key += '\n';
+      // a missing optional argument is empty, and an argument without a type is marked
+      if (arg->Exists()) {
+        key += arg->Type() != nullptr ? *arg->Type() : "?";
+      }
+    }
+  };
+  append_types(node.InputDefs());
+  key += "\n->";
+  append_types(node.OutputDefs());
+  return true;
+}
 };  // namespace
 
 bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
@@ -229,17 +264,29 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
                      ": Conflicting with a registered kernel with op versions.");
       // For invalid entries, we keep them in the map now. Must check for status
       // when using the entries from the map.
-      kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+      AddToKernelIndex(kernel_creator_fn_map_.emplace(op_name, std::move(create_info))->second);
       return st;
     }
   }
 
   // Register the kernel.
   // Ownership of the KernelDef is transferred to the map.
-  kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+  AddToKernelIndex(kernel_creator_fn_map_.emplace(op_name, std::move(create_info))->second);
   return Status::OK();
 }
 
+void KernelRegistry::AddToKernelIndex(const KernelCreateInfo& create_info) {
+  if (create_info.kernel_def) {
+    const KernelDef& kernel_def = *create_info.kernel_def;
+    kernel_index_[GetKernelIndexKey(kernel_def.OpName(), kernel_def.Domain(), kernel_def.Provider())].push_back(
+        &create_info);
+  }
+
+  // the new kernel may match signatures that were looked up before
+  std::lock_guard<OrtMutex> lock(kernel_lookup_cache_lock_);
+  kernel_lookup_cache_.clear();
+}
+
 Status KernelRegistry::TryCreateKernel(const onnxruntime::Node& node,
                                        const IExecutionProvider& execution_provider,
                                        const std::unordered_map<int, OrtValue>& constant_initialized_tensors,
@@ -278,25 +325,49 @@ static std::string ToString(const std::vector<std::string>& error_strs) {
 // otherwise, kernel_def.provider must equal to node.provider. exec_provider is ignored.
 const KernelCreateInfo* KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
                                                       onnxruntime::ProviderType exec_provider) const {
-  auto range = kernel_creator_fn_map_.equal_range(node.OpType());
-  std::vector<std::string> error_strs;
-  for (auto i = range.first; i != range.second; ++i) {
-    if (!i->second.status.IsOK()) {
-      LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
-                          << " since it was ill-formed during registration";
-      continue;
+  const std::string& expected_provider =
+      (node.GetExecutionProviderType().empty() ? exec_provider : node.GetExecutionProviderType());
+
+  std::string lookup_key;
+  const bool use_cache = GetKernelLookupKey(node, expected_provider, lookup_key);
+  if (use_cache) {
+    std::lock_guard<OrtMutex> lock(kernel_lookup_cache_lock_);
+    auto cached = kernel_lookup_cache_.find(lookup_key);
+    if (cached != kernel_lookup_cache_.end()) {
+      return cached->second;
     }
-    std::string error_str;
-    if (VerifyKernelDef(node, *i->second.kernel_def, error_str, exec_provider)) {
-      return &i->second;
+  }
+
+  // Only the kernels of the op, domain and provider of the node can match it.
+  const KernelCreateInfo* result = nullptr;
+  std::vector<std::string> error_strs;
+  auto candidates = kernel_index_.find(GetKernelIndexKey(node.OpType(), node.Domain(), expected_provider));
+  if (candidates != kernel_index_.end()) {
+    for (const KernelCreateInfo* create_info : candidates->second) {
+      if (!create_info->status.IsOK()) {
+        LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
+                            << " since it was ill-formed during registration";
+        continue;
+      }
+      std::string error_str;
+      if (VerifyKernelDef(node, *create_info->kernel_def, error_str, exec_provider)) {
+        result = create_info;
+        break;
+      }
+      error_strs.push_back(error_str);
     }
-    error_strs.push_back(error_str);
   }
-  std::string expected_provider =
-      (node.GetExecutionProviderType().empty() ? exec_provider : node.GetExecutionProviderType());
-  LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
-                     << " Encountered following errors: " << ToString(error_strs);
-  return nullptr;
+
+  if (result == nullptr) {
+    LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
+                       << " Encountered following errors: " << ToString(error_strs);
+  }
+
+  if (use_cache) {
+    std::lock_guard<OrtMutex> lock(kernel_lookup_cache_lock_);
+    kernel_lookup_cache_.emplace(std::move(lookup_key), result);
+  }
+  return result;
 }
 
 }  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_tuning_cache.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace onnxruntime {
+
+bool KernelTuningCache::Lookup(const std::string& key, int& choice) const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = choices_.find(key);
+  if (it == choices_.end()) {
+    return false;
+  }
+  choice = it->second;
+  return true;
+}
+
+void KernelTuningCache::Insert(const std::string& key, int choice) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  choices_[key] = choice;
+}
+
+// The file holds a line per choice, with the key followed by the choice. Keys don't contain spaces.
+common::Status KernelTuningCache::Load(const std::basic_string<ORTCHAR_T>& path) {
+  std::ifstream stream(path);
+  if (!stream) {
+    return common::Status::OK();
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string key;
+    int choice;
+    if (!(fields >> key >> choice)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid kernel tuning cache entry: ", line);
+    }
+    choices_[key] = choice;
+  }
+  return common::Status::OK();
+}
+
+common::Status KernelTuningCache::Save(const std::basic_string<ORTCHAR_T>& path) const {
+  std::ofstream stream(path, std::ios::out | std::ios::trunc);
+  if (!stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the kernel tuning cache file for writing.");
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (const auto& choice : choices_) {
+    stream << choice.first << ' ' << choice.second << '\n';
+  }
+  stream.flush();
+  if (!stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the kernel tuning cache file.");
+  }
+  return common::Status::OK();
+}
+
+}  // namespace onnxruntime
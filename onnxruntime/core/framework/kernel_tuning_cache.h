@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+// KernelTuningCache holds the implementation a kernel chose for a configuration, such as the operator and its
+// input shapes, by benchmarking the implementations it supports when the kernel is created. The choices can be
+// saved to a file and loaded again, so the sessions created later skip the benchmarks. The kernels only benchmark
+// configurations missing from the cache if tuning is enabled.
+// Thread-safe.
+class KernelTuningCache {
+ public:
+  explicit KernelTuningCache(bool enable_tuning) : enable_tuning_(enable_tuning) {}
+
+  bool IsTuningEnabled() const { return enable_tuning_; }
+
+  // returns true and sets choice if the cache holds a choice for key.
+  bool Lookup(const std::string& key, int& choice) const;
+
+  void Insert(const std::string& key, int choice);
+
+  // loads the choices saved to path by Save. A missing file leaves the cache unchanged.
+  common::Status Load(const std::basic_string<ORTCHAR_T>& path);
+
+  common::Status Save(const std::basic_string<ORTCHAR_T>& path) const;
+
+ private:
+  const bool enable_tuning_;
+  mutable OrtMutex lock_;
+  std::map<std::string, int> choices_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelTuningCache);
+};
+
+}  // namespace onnxruntime
@@ -16,7 +16,9 @@ limitations under the License.
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include <list>
+#include <vector>
 
 #include "core/framework/mem_pattern.h"
 #include "core/framework/allocation_planner.h"
@@ -104,4 +106,79 @@ class MemPatternPlanner {
   mutable OrtMutex lock_;
 };
 
+// StaticMemPatternPlanner generates a memory pattern ahead of execution for values whose size and
+// lifetime (the execution plan steps they are allocated and freed at) are known.
+// Values are placed largest first, each at the best fitting gap left by the already placed values
+// whose lifetimes overlap its own. Not thread-safe.
+class StaticMemPatternPlanner {
+ public:
+  StaticMemPatternPlanner() = default;
+
+  // the value is live from the start of step alloc_step until the end of step free_step.
+  void AddValue(int ml_value_idx, size_t size, size_t alloc_step, size_t free_step) {
+    values_.push_back({ml_value_idx, size, alloc_step, free_step});
+  }
+
+  MemoryPattern GenerateMemPattern() const {
+    std::vector<const ValueLifetime*> order;
+    order.reserve(values_.size());
+    for (auto& value : values_) order.push_back(&value);
+    std::stable_sort(order.begin(), order.end(), [](const ValueLifetime* a, const ValueLifetime* b) {
+      return a->size > b->size;
+    });
+
+    MemoryPattern pattern;
+    // placed values, sorted in order of their offset
+    std::vector<std::pair<const ValueLifetime*, MemoryBlock>> placed;
+    for (auto* value : order) {
+      if (value->size == 0) {
+        pattern.patterns_[value->index] = MemoryBlock(0, 0);
+        continue;
+      }
+
+      size_t current = 0;
+      size_t waste_bytes = std::numeric_limits<size_t>::max();
+      size_t best_offset = 0;
+      bool found = false;
+      for (auto& entry : placed) {
+        const ValueLifetime* other = entry.first;
+        if (other->alloc_step > value->free_step || value->alloc_step > other->free_step) continue;
+
+        if (entry.second.offset_ >= current) {
+          auto gap = entry.second.offset_ - current;
+          if (gap >= value->size && (gap - value->size) < waste_bytes) {
+            waste_bytes = gap - value->size;
+            best_offset = current;
+            found = true;
+          }
+        }
+        current = std::max(current, entry.second.offset_ + entry.second.size_);
+      }
+
+      if (!found) best_offset = current;
+
+      MemoryBlock block(best_offset, value->size);
+      auto it = std::upper_bound(placed.begin(), placed.end(), best_offset,
+                                 [](size_t offset, const std::pair<const ValueLifetime*, MemoryBlock>& entry) {
+                                   return offset < entry.second.offset_;
+                                 });
+      placed.insert(it, {value, block});
+      pattern.patterns_[value->index] = block;
+      pattern.peak_size_ = std::max(pattern.peak_size_, best_offset + value->size);
+    }
+
+    return pattern;
+  }
+
+ private:
+  struct ValueLifetime {
+    int index;
+    size_t size;
+    size_t alloc_step;
+    size_t free_step;
+  };
+
+  std::vector<ValueLifetime> values_;
+};
+
 }  // namespace onnxruntime
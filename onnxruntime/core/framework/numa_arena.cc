@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_arena.h"
+
+#include <algorithm>
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+// the node NumaArena::ScopedNode selected for the thread, -1 if none
+thread_local int t_numa_node = -1;
+
+// Places the memory of a device allocator on a NUMA node.
+class NumaNodeAllocator : public IDeviceAllocator {
+ public:
+  NumaNodeAllocator(std::unique_ptr<IDeviceAllocator> allocator, int node)
+      : allocator_(std::move(allocator)), node_(node) {}
+
+  void* Alloc(size_t size) override {
+    void* p = allocator_->Alloc(size);
+    // the arena regions are fresh memory, so none of their pages are placed yet
+    Env::Default().BindMemoryToNumaNode(p, size, node_);
+    return p;
+  }
+
+  void Free(void* p) override { allocator_->Free(p); }
+
+  const OrtMemoryInfo& Info() const override { return allocator_->Info(); }
+
+ private:
+  std::unique_ptr<IDeviceAllocator> allocator_;
+  const int node_;
+};
+}  // namespace
+
+NumaArena::NumaArena(const DeviceAllocatorRegistrationInfo& info, const std::vector<std::vector<int>>& nodes) {
+  const size_t num_nodes = std::max<size_t>(nodes.size(), 1);
+  for (size_t node = 0; node < num_nodes; ++node) {
+    arenas_.push_back(std::make_unique<BFCArena>(
+        std::make_unique<NumaNodeAllocator>(info.factory(0), static_cast<int>(node)), info.max_mem,
+        info.arena_extend_strategy, info.initial_chunk_size_bytes, info.thread_cache_config));
+  }
+
+  for (size_t node = 0; node < nodes.size(); ++node) {
+    for (int processor : nodes[node]) {
+      if (processor < 0) {
+        continue;
+      }
+      if (static_cast<size_t>(processor) >= node_of_processor_.size()) {
+        node_of_processor_.resize(processor + 1, 0);
+      }
+      node_of_processor_[processor] = node;
+    }
+  }
+}
+
+size_t NumaArena::CurrentNode() const {
+  if (t_numa_node >= 0) {
+    return static_cast<size_t>(t_numa_node) < arenas_.size() ? t_numa_node : 0;
+  }
+
+  const int processor = Env::Default().GetCurrentLogicalProcessor();
+  return processor >= 0 && static_cast<size_t>(processor) < node_of_processor_.size() ? node_of_processor_[processor]
+                                                                                      : 0;
+}
+
+void* NumaArena::Alloc(size_t size) {
+  return arenas_[CurrentNode()]->Alloc(size);
+}
+
+void* NumaArena::Reserve(size_t size) {
+  return arenas_[CurrentNode()]->Reserve(size);
+}
+
+void NumaArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  // memory is mostly freed on the node that allocated it, so look there first
+  const size_t current_node = CurrentNode();
+  if (arenas_[current_node]->Owns(p)) {
+    arenas_[current_node]->Free(p);
+    return;
+  }
+
+  for (size_t node = 0; node < arenas_.size(); ++node) {
+    if (node != current_node && arenas_[node]->Owns(p)) {
+      arenas_[node]->Free(p);
+      return;
+    }
+  }
+
+  ORT_THROW("Freeing memory that the NUMA arena didn't allocate: ", p);
+}
+
+size_t NumaArena::Used() const {
+  size_t used = 0;
+  for (const auto& arena : arenas_) {
+    used += arena->Used();
+  }
+  return used;
+}
+
+size_t NumaArena::Max() const {
+  return arenas_.front()->Max();
+}
+
+Status NumaArena::Shrink() {
+  for (auto& arena : arenas_) {
+    ORT_RETURN_IF_ERROR(arena->Shrink());
+  }
+  return Status::OK();
+}
+
+NumaArena::ScopedNode::ScopedNode(int node) : previous_node_(t_numa_node) {
+  t_numa_node = node;
+}
+
+NumaArena::ScopedNode::~ScopedNode() {
+  t_numa_node = previous_node_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
+
+namespace onnxruntime {
+
+/**
+An arena made of one BFCArena per NUMA node, each holding memory placed on its node.
+Allocations are served by the arena of the node a NumaArena::ScopedNode selects for the calling thread, or else of
+the node of the processor the thread runs on, so the tensors of a Run whose threads are pinned to one node stay in
+the memory of that node. Memory is freed to the arena that allocated it, whichever thread frees it.
+*/
+class NumaArena : public IArenaAllocator {
+ public:
+  // nodes holds the logical processors of each NUMA node, see Env::GetNumaNodes. info sets up the arena of each node.
+  NumaArena(const DeviceAllocatorRegistrationInfo& info, const std::vector<std::vector<int>>& nodes);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  void* Reserve(size_t size) override;
+
+  // the bytes in use in the arenas of all the nodes
+  size_t Used() const override;
+  // the most memory the arena of each node may hold
+  size_t Max() const override;
+  Status Shrink() override;
+
+  const OrtMemoryInfo& Info() const override { return arenas_.front()->Info(); }
+
+  size_t NumNodes() const { return arenas_.size(); }
+
+  // Makes the allocations of the calling thread use the arena of node while in scope.
+  // A negative node restores the choice by the processor the thread runs on.
+  class ScopedNode {
+   public:
+    explicit ScopedNode(int node);
+    ~ScopedNode();
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedNode);
+    int previous_node_;
+  };
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaArena);
+
+  size_t CurrentNode() const;
+
+  std::vector<std::unique_ptr<BFCArena>> arenas_;
+  // the NUMA node of each logical processor
+  std::vector<size_t> node_of_processor_;
+};
+
+}  // namespace onnxruntime
@@ -12,13 +12,22 @@ namespace onnxruntime {
 OpKernelContext::OpKernelContext(IExecutionFrame* frame,
                                  const OpKernel* kernel,
                                  const logging::Logger& logger)
+    : OpKernelContext(frame, kernel,
+                      frame != nullptr && kernel != nullptr ? frame->GetNodeOffset(kernel->Node().Index()) : -1,
+                      logger) {
+}
+
+OpKernelContext::OpKernelContext(IExecutionFrame* frame,
+                                 const OpKernel* kernel,
+                                 int node_offset,
+                                 const logging::Logger& logger)
     : execution_frame_(frame),
       kernel_(kernel),
       logger_(&logger) {
   ORT_ENFORCE(frame != nullptr, "Execution frame was null");
   ORT_ENFORCE(kernel != nullptr, "OpKernel was null");
 
-  node_input_start_index_ = frame->GetNodeOffset(kernel->Node().Index());
+  node_input_start_index_ = node_offset;
   node_implicit_input_start_index_ = node_input_start_index_ + InputCount();
   node_output_start_index_ = node_implicit_input_start_index_ + ImplicitInputCount();
 }
@@ -33,6 +42,18 @@ SparseTensor* OpKernelContext::Output(int index, size_t nnz, const TensorShape&
   return p_ml_value ? p_ml_value->GetMutable<SparseTensor>() : nullptr;
 }
 
+Tensor* OpKernelContext::OutputView(int index, const Tensor& input, const TensorShape& shape,
+                                    const std::vector<int64_t>& strides, int64_t byte_offset) {
+  if (index < 0 || index >= OutputCount())
+    return nullptr;
+
+  OrtValue* p_ml_value = nullptr;
+  Status status = execution_frame_->CreateNodeOutputView(GetOutputArgIndex(index), input, shape, strides,
+                                                         byte_offset, p_ml_value);
+  ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+  return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+}
+
 OrtValue* OpKernelContext::OutputMLValue(int index, const TensorShape& shape, size_t nnz) {
   if (index < 0 || index >= OutputCount())
     return nullptr;
@@ -63,6 +84,10 @@ Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
   return Status::OK();
 }
 
+Status OpKernelContext::TerminatedStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+}
+
 MLDataType OpKernelContext::InputType(int index) const {
   int input_arg_index = GetInputArgIndex(index);
   const OrtValue* p_ml_value = execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
@@ -135,7 +160,7 @@ const OrtValue* OpKernelContext::GetInputMLValue(int index) const {
     return nullptr;
 
   int input_arg_index = GetInputArgIndex(index);
-  return execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
+  return GetInputMLValueAsAccepted(input_arg_index, execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index));
 }
 
 const OrtValue* OpKernelContext::GetImplicitInputMLValue(int index) const {
@@ -143,7 +168,30 @@ const OrtValue* OpKernelContext::GetImplicitInputMLValue(int index) const {
     return nullptr;
 
   int input_arg_index = GetImplicitInputArgIndex(index);
-  return execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
+  return GetInputMLValueAsAccepted(input_arg_index, execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index));
+}
+
+const OrtValue* OpKernelContext::GetInputMLValueAsAccepted(int arg_index, const OrtValue* p_ml_value) const {
+  // implicit inputs follow the inputs in the frame, so their index is past those a kernel accepts strided
+  if (p_ml_value == nullptr || !p_ml_value->IsTensor() || p_ml_value->Get<Tensor>().IsContiguous() ||
+      kernel_->KernelDef().AcceptsStridedInput(static_cast<size_t>(arg_index - node_input_start_index_))) {
+    return p_ml_value;
+  }
+
+  auto entry = contiguous_inputs_.find(arg_index);
+  if (entry == contiguous_inputs_.end()) {
+    // views are only created on the CPU, see AllocKind::kView
+    const Tensor& view = p_ml_value->Get<Tensor>();
+    auto allocator = execution_frame_->GetAllocator(view.Location());
+    ORT_ENFORCE(allocator != nullptr, "No allocator for the copy of a strided input at ", view.Location().ToString());
+    auto p_tensor = std::make_unique<Tensor>(view.DataType(), view.Shape(), allocator);
+    CopyToContiguous(view, *p_tensor);
+
+    OrtValue contiguous;
+    contiguous.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    entry = contiguous_inputs_.emplace(arg_index, std::move(contiguous)).first;
+  }
+  return &entry->second;
 }
 
 OrtValue* OpKernelContext::GetOutputMLValue(int index) {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/session/onnxruntime_c_api.h"
@@ -20,10 +21,24 @@ class OpKernelContextInternal : public OpKernelContext {
                                    IExecutionFrame& frame,
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
-                                   const bool& terminate_flag)
-      : OpKernelContext(&frame, &kernel, logger),
+                                   const bool& terminate_flag,
+                                   concurrency::ThreadPool* thread_pool = nullptr)
+      : OpKernelContextInternal(session_state, frame, kernel, frame.GetNodeOffset(kernel.Node().Index()), logger,
+                                terminate_flag, thread_pool) {
+  }
+
+  // node_offset is the offset of the values of the kernel's node in the frame, see CompiledExecutionPlan
+  OpKernelContextInternal(const SessionState& session_state,
+                          IExecutionFrame& frame,
+                          const OpKernel& kernel,
+                          int node_offset,
+                          const logging::Logger& logger,
+                          const bool& terminate_flag,
+                          concurrency::ThreadPool* thread_pool = nullptr)
+      : OpKernelContext(&frame, &kernel, node_offset, logger),
         session_state_{session_state},
-        terminate_flag_{terminate_flag} {
+        terminate_flag_{terminate_flag},
+        thread_pool_{thread_pool != nullptr ? thread_pool : session_state.GetThreadPool()} {
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
     int num_implicit_inputs = static_cast<int>(implicit_inputs.size());
     implicit_input_values_.reserve(num_implicit_inputs);
@@ -59,12 +74,16 @@ class OpKernelContextInternal : public OpKernelContext {
 
   const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
 
-  _Ret_maybenull_ const onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() const { return session_state_.GetThreadPool(); }
-  _Ret_maybenull_ onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() { return session_state_.GetThreadPool(); }
+  bool IsTerminated() const noexcept override { return terminate_flag_; }
+
+  // the thread pool of the Run, which is the session state's unless the session has thread pool replicas
+  _Ret_maybenull_ const onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() const { return thread_pool_; }
+  _Ret_maybenull_ onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() { return thread_pool_; }
 
  private:
   const SessionState& session_state_;
   const bool& terminate_flag_;
+  concurrency::ThreadPool* const thread_pool_;
   std::vector<const OrtValue*> implicit_input_values_;
 };
 
@@ -39,6 +39,10 @@ template <>
 inline bool HasTyped<GraphProto>(const AttributeProto* attr) {
   return utils::HasGraph(*attr);
 }
+template <>
+inline bool HasTyped<SparseTensorProto>(const AttributeProto* attr) {
+  return utils::HasSparseTensor(*attr);
+}
 
 #define ORT_DEFINE_GET_ATTR(IMPL_T, T, type)                                                       \
   template <>                                                                                      \
@@ -100,6 +104,7 @@ ORT_DEFINE_GET_ATTR_SPECIALIZATIONS(int64_t, i)
 ORT_DEFINE_GET_ATTR_SPECIALIZATIONS(std::string, s)
 ORT_DEFINE_GET_ATTR_SPECIALIZATIONS(TensorProto, t)
 ORT_DEFINE_GET_ATTR_SPECIALIZATIONS(GraphProto, g)
+ORT_DEFINE_GET_ATTR_SPECIALIZATIONS(SparseTensorProto, sparse_tensor)
 ORT_DEFINE_GET_ATTRS_SPECIALIZATIONS(float, floats)
 ORT_DEFINE_GET_ATTRS_SPECIALIZATIONS(int64_t, ints)
 ORT_DEFINE_GET_ATTRS_SPECIALIZATIONS(std::string, strings)
@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -11,6 +12,7 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/session_metrics.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
@@ -18,15 +20,35 @@
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_{terminate_flag} {
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag,
+                                   concurrency::ThreadPool* intra_op_thread_pool)
+    : out_standings_(0),
+      active_workers_(0),
+      queued_nodes_(0),
+      terminate_flag_{terminate_flag},
+      intra_op_thread_pool_{intra_op_thread_pool != nullptr ? intra_op_thread_pool : session_state.GetThreadPool()},
+      thread_pool_{session_state.GetInterOpThreadPool() != nullptr ? session_state.GetInterOpThreadPool()
+                                                                   : intra_op_thread_pool_},
+      max_workers_(0) {
   auto graph_viewer = session_state.GetGraphViewer();
   node_refs_.resize(graph_viewer->MaxNodeIndex());
   for (auto& node : graph_viewer->Nodes()) {
     node_refs_[node.Index()] = node.GetInputEdgesCount();
   }
 
-  executor_pool_ = std::make_unique<onnxruntime::concurrency::ThreadPool>("EXECUTOR", 32);
+  size_t num_queues = 1;
+  if (thread_pool_ != nullptr) {
+    // unless the nodes have a pool of their own, keep one thread of the pool free of nodes, so the parallel loops
+    // of the running kernels, which are scheduled on the same pool, can always make progress.
+    max_workers_ = thread_pool_ == intra_op_thread_pool_ ? thread_pool_->NumThreads() - 1
+                                                         : thread_pool_->NumThreads();
+    num_queues += static_cast<size_t>(thread_pool_->NumThreads());
+  }
+
+  queues_.reserve(num_queues);
+  for (size_t i = 0; i < num_queues; ++i) {
+    queues_.push_back(std::make_unique<NodeQueue>());
+  }
 }
 
 Status ParallelExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
@@ -35,15 +57,24 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
                                  const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                  const logging::Logger& logger) {
   TimePoint tp;
-  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
-  if (is_profiler_enabled) {
+  const bool is_profiler_enabled = session_state.Profiler().IsEnabled() && !session_state.Profiler().IsSampling();
+  is_execution_sampled_ = session_state.Profiler().IsEnabled() && session_state.Profiler().IsSampling() &&
+                          session_state.Profiler().SampleExecution();
+  if (is_profiler_enabled || is_execution_sampled_) {
     tp = session_state.Profiler().StartTime();
   }
 
   root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                  fetch_allocators, session_state);
+  // queue the root nodes with the most critical at the front
+  std::vector<NodeIndex> root_nodes = session_state.GetGraphViewer()->GetRootNodes();
+  const auto& node_priorities = session_state.GetNodePriorities();
+  std::sort(root_nodes.begin(), root_nodes.end(), [&node_priorities](NodeIndex lhs, NodeIndex rhs) {
+    return node_priorities[lhs] < node_priorities[rhs];
+  });
+
   //std::cout << "start nodes:" << std::endl;
-  for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
+  for (auto node_index : root_nodes) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
@@ -52,18 +83,34 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     EnqueueNode(node_index, session_state, logger);
   }
 
-  // Wait for finish.
+  // Run the queued nodes on this thread as well, and wait for finish.
+  const size_t queue_slot = CurrentQueueSlot();
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
-    while (out_standings_ > 0) complete_cv_.wait(lock);
+    while (out_standings_ > 0) {
+      if (queued_nodes_ > 0) {
+        lock.unlock();
+        ProcessQueues(queue_slot, session_state, logger);
+        lock.lock();
+        continue;
+      }
+
+      complete_cv_.wait(lock);
+    }
+
+    // the workers reference this executor until they exit.
+    while (active_workers_ > 0) complete_cv_.wait(lock);
   }
 
   Status status = Status::OK();
 
   if (!errors_.empty()) {
-    if (errors_.size() == 1)
+    if (terminate_flag_) {
+      // the nodes running when the Run was terminated each failed, so report it once as the sequential executor does
+      status = OpKernelContext::TerminatedStatus();
+    } else if (errors_.size() == 1) {
       status = errors_.front();
-    else {
+    } else {
       std::stringstream ss;
       ss << "Multiple errors were found.";
       for (const auto& s : errors_) {
@@ -104,6 +151,9 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
 
   if (is_profiler_enabled) {
     session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
+  } else if (is_execution_sampled_) {
+    static const std::string execute_event_name = "ParallelExecutor::Execute";
+    session_state.Profiler().RecordSampledEvent(profiling::SESSION_EVENT, execute_event_name, "", tp);
   }
 
   return Status::OK();
@@ -121,16 +171,22 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   auto graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
-  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  const bool f_profiler_enabled = session_state.Profiler().IsEnabled() && !session_state.Profiler().IsSampling();
+  const bool record_ep_events = f_profiler_enabled && session_state.Profiler().HasEpProfilers();
+  SessionMetrics* metrics = session_state.Metrics();
+  std::chrono::high_resolution_clock::time_point metrics_begin_time;
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  const auto& node_priorities = session_state.GetNodePriorities();
+  std::vector<size_t> ready_nodes;
+  // the nodes to run on this thread after node_index, the last one first
+  std::vector<size_t> inline_nodes;
 
   // Avoid context switching if possible.
   while (keep_running) {
-    // TODO: Convert RunNodeAsync return Status.
-    // to also handle exception propagation
     if (terminate_flag_) {
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
+      status = OpKernelContext::TerminatedStatus();
+      break;
     }
 
     auto p_op_kernel = session_state.GetKernel(node_index);
@@ -141,7 +197,8 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                 graph_viewer->GetNode(node_index)->Name());
     }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_,
+                                              intra_op_thread_pool_);
 
     if (f_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -185,14 +242,25 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      sync_time_begin,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
+      kernel_begin_time = session_state.Profiler().StartTime();
+    } else if (is_execution_sampled_) {
       kernel_begin_time = session_state.Profiler().StartTime();
     }
 
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
+    if (metrics != nullptr) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
     // Execute the kernel.
+    const uint64_t ep_events_id =
+        record_ep_events ? session_state.Profiler().StartEpEvents(p_op_kernel->Node().Name()) : 0;
     status = p_op_kernel->Compute(&op_kernel_context);
+    if (record_ep_events) {
+      session_state.Profiler().StopEpEvents(ep_events_id);
+    }
     if (!status.IsOK()) {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                                "Compute failed for node: ", graph_viewer->GetNode(node_index)->Name(),
@@ -200,6 +268,12 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (metrics != nullptr) {
+      metrics->RecordKernel(*p_op_kernel, op_kernel_context,
+                            std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::high_resolution_clock::now() - metrics_begin_time));
+    }
+
     if (f_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      p_op_kernel->Node().Name() + "_kernel_time",
@@ -207,6 +281,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
 
       sync_time_begin = session_state.Profiler().StartTime();
+    } else if (is_execution_sampled_) {
+      session_state.Profiler().RecordSampledEvent(profiling::NODE_EVENT, p_op_kernel->Node().Name(), "_kernel_time",
+                                                  kernel_begin_time, &p_op_kernel->KernelDef().OpName(),
+                                                  &p_op_kernel->KernelDef().Provider());
     }
     // sync after compute for outputs
     if (exec_plan.NodeHasFence(node_index)) {
@@ -241,9 +319,8 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 
     //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
-    keep_running = false;
-
     // Checking which output nodes ready for running.
+    ready_nodes.clear();
     {
       auto begin = p_op_kernel->Node().OutputEdgesBegin();
       auto end = p_op_kernel->Node().OutputEdgesEnd();
@@ -252,12 +329,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
         if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
+          ready_nodes.push_back(idx);
         }
 
         // std::cout << "handle output, current name: " << p_op_kernel->Node().Name() << ", current index: "
@@ -265,12 +337,41 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
         // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
       }
     }
+
+    // The ready node on the longest path to the end of the graph keeps running on this thread, after the cheap ones,
+    // which aren't worth queuing. The others are queued for it or for idle threads to steal, the most critical at
+    // the front of the queue.
+    std::sort(ready_nodes.begin(), ready_nodes.end(), [&node_priorities](size_t lhs, size_t rhs) {
+      return node_priorities[lhs] < node_priorities[rhs];
+    });
+    if (!ready_nodes.empty()) {
+      inline_nodes.push_back(ready_nodes.back());
+      ready_nodes.pop_back();
+    }
+
+    auto queued_end = std::stable_partition(ready_nodes.begin(), ready_nodes.end(), [&session_state](size_t idx) {
+      return !session_state.IsCheapNode(idx);
+    });
+    inline_nodes.insert(inline_nodes.end(), queued_end, ready_nodes.end());
+    ready_nodes.erase(queued_end, ready_nodes.end());
+
+    // enqueue outside of ref_mutex_ as a worker may be started inline if the pool's queue is full.
+    for (auto idx : ready_nodes) {
+      EnqueueNode(idx, session_state, logger);
+    }
+
+    keep_running = !inline_nodes.empty();
+    if (keep_running) {
+      node_index = inline_nodes.back();
+      inline_nodes.pop_back();
+    }
   }
 
   return status;
 }
 
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
+  bool start_worker = false;
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
     // if there are errors there's no point queuing more work
@@ -278,28 +379,96 @@ void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& sess
       return;
 
     out_standings_++;
+
+    {
+      auto& queue = *queues_[CurrentQueueSlot()];
+      std::lock_guard<OrtMutex> queue_lock(queue.mutex);
+      queue.nodes.push_front(p_node_index);
+    }
+    queued_nodes_++;
+
+    if (active_workers_ < max_workers_) {
+      active_workers_++;
+      start_worker = true;
+    }
+  }
+
+  // wake up Execute if it's waiting, so it helps with the queued nodes
+  complete_cv_.notify_all();
+
+  if (start_worker) {
+    thread_pool_->Schedule([this, &session_state, &logger]() {
+      ProcessQueues(CurrentQueueSlot(), session_state, logger);
+
+      bool finished = false;
+      {
+        std::lock_guard<OrtMutex> lock(complete_mutex_);
+        finished = --active_workers_ == 0;
+      }
+
+      if (finished) {
+        complete_cv_.notify_all();
+      }
+    });
+  }
+}
+
+void ParallelExecutor::ProcessQueues(size_t queue_slot, const SessionState& session_state,
+                                     const logging::Logger& logger) {
+  size_t node_index;
+  while (TryGetNode(queue_slot, node_index)) {
+    RunNodeAndFinish(node_index, session_state, logger);
   }
+}
 
-  executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
-    auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
-      const auto* node = session_state.GetGraphViewer()->GetNode(p_node_index);
-
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
-                             " node '", node->Name(), "'. ",
-                             ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
-    };
-
-    Status status;
-    try {
-      status = ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
-    } catch (const std::exception& ex) {
-      status = create_exception_message(&ex);
-    } catch (...) {
-      // catch node processing failure exceptions here to prevent app crash.
-      status = create_exception_message(nullptr);
+bool ParallelExecutor::TryGetNode(size_t queue_slot, size_t& node_index) {
+  {
+    auto& queue = *queues_[queue_slot];
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    if (!queue.nodes.empty()) {
+      node_index = queue.nodes.front();
+      queue.nodes.pop_front();
+      queued_nodes_--;
+      return true;
     }
+  }
 
-    FinishNodeRun(status);
-  });
+  // steal the oldest node of another queue
+  const size_t num_queues = queues_.size();
+  for (size_t i = 1; i < num_queues && queued_nodes_ > 0; ++i) {
+    auto& queue = *queues_[(queue_slot + i) % num_queues];
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    if (!queue.nodes.empty()) {
+      node_index = queue.nodes.back();
+      queue.nodes.pop_back();
+      queued_nodes_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ParallelExecutor::RunNodeAndFinish(size_t p_node_index, const SessionState& session_state,
+                                        const logging::Logger& logger) {
+  auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
+    const auto* node = session_state.GetGraphViewer()->GetNode(p_node_index);
+
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
+                           " node '", node->Name(), "'. ",
+                           ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
+  };
+
+  Status status;
+  try {
+    status = ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
+  } catch (const std::exception& ex) {
+    status = create_exception_message(&ex);
+  } catch (...) {
+    // catch node processing failure exceptions here to prevent app crash.
+    status = create_exception_message(nullptr);
+  }
+
+  FinishNodeRun(status);
 }
 }  // namespace onnxruntime
@@ -3,8 +3,11 @@
 
 #pragma once
 
-#include <vector>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
+#include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
 #include "core/common/logging/logging.h"
@@ -21,7 +24,10 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  // intra_op_thread_pool is the pool the kernels run their parallel loops on, nullptr for the session state's.
+  // The nodes run on the inter-op pool of the session state if it has one, else on the intra-op pool.
+  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false,
+                   concurrency::ThreadPool* intra_op_thread_pool = nullptr);
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -36,6 +42,19 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // run nodes from the queue of 'queue_slot', stealing from the other queues once it's empty,
+  // until no queued node is left.
+  void ProcessQueues(size_t queue_slot, const SessionState& session_state, const logging::Logger& logger);
+
+  bool TryGetNode(size_t queue_slot, size_t& node_index);
+
+  void RunNodeAndFinish(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  // queue of the calling thread. slot 0 is used by threads outside of the pool, e.g. the one calling Execute.
+  size_t CurrentQueueSlot() const {
+    return thread_pool_ == nullptr ? 0 : static_cast<size_t>(thread_pool_->CurrentThreadId() + 1);
+  }
+
   void FinishNodeRun(const Status& status) {
     bool finished = false;
     {
@@ -52,16 +71,36 @@ class ParallelExecutor : public IExecutor {
     }
   }
 
+  // Ready nodes are pushed to the front of the queue of the thread that made them ready and popped from the front
+  // by that thread, so a node usually runs where its inputs were just produced. Idle threads steal from the back.
+  struct NodeQueue {
+    OrtMutex mutex;
+    std::deque<size_t> nodes;
+  };
+
   std::unique_ptr<ExecutionFrame> root_frame_;
   std::vector<size_t> node_refs_;
   OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  int out_standings_;   //protected by complete_mutex_
+  int active_workers_;  //protected by complete_mutex_
+  // number of nodes in queues_. only incremented while holding complete_mutex_.
+  std::atomic<int> queued_nodes_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
   std::vector<Status> errors_;
 
+  // whether the profiler samples this execution, see Profiler::SampleExecution
+  bool is_execution_sampled_ = false;
+
   const bool& terminate_flag_;
-  // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
-  std::unique_ptr<onnxruntime::concurrency::ThreadPool> executor_pool_;
+
+  // the pool the kernels run their parallel loops on
+  onnxruntime::concurrency::ThreadPool* const intra_op_thread_pool_;
+  // the pool the nodes run on, the inter-op pool or else the intra-op one, shared with the kernels.
+  // nodes run on the thread calling Execute only if there is none.
+  onnxruntime::concurrency::ThreadPool* const thread_pool_;
+  // max number of pool threads running nodes at the same time.
+  int max_workers_;
+  std::vector<std::unique_ptr<NodeQueue>> queues_;
 };
 }  // namespace onnxruntime
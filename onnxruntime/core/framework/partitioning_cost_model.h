@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+
+// The estimates the cost based partitioning compares to place the groups of connected nodes on the CPU or a device,
+// in units of the time the CPU takes to compute an element, about a nanosecond. See GraphPartitioner.
+struct PartitioningCostModel {
+  // how many times faster the device computes than the CPU.
+  double device_speedup = 10.0;
+
+  // the fixed cost of a copy between the host and the device, for launching and synchronizing it: about 10us.
+  double copy_latency = 10000.0;
+
+  // the cost of every byte copied between the host and the device: about 10GB/s over PCIe.
+  double copy_cost_per_byte = 0.1;
+};
+
+}  // namespace onnxruntime
@@ -52,3 +52,16 @@ ORT_API_STATUS_IMPL(OrtRunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options)
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetComputeStream, _Inout_ OrtRunOptions* options, _In_opt_ void* compute_stream) {
+  options->compute_stream = compute_stream;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetMaxMicroBatchSize, _Inout_ OrtRunOptions* options, int64_t max_micro_batch_size) {
+  if (max_micro_batch_size < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "max_micro_batch_size must not be negative");
+  }
+  options->max_micro_batch_size = max_micro_batch_size;
+  return nullptr;
+}
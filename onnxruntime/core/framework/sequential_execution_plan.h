@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "core/graph/basic_types.h"
 #include "core/framework/alloc_kind.h"
 #include "core/framework/data_types.h"
@@ -17,6 +20,7 @@ namespace onnxruntime {
 using OrtValueIndex = int;
 using OrtValueName = std::string;
 
+class OpKernel;
 class SessionState;
 
 // AllocPlanPerValue: (a simplified form of AllocationPlanPerValue above)
@@ -25,9 +29,11 @@ struct AllocPlanPerValue {
   AllocKind alloc_kind{AllocKind::kAllocate};
   MLDataType value_type{nullptr};
   OrtMemoryInfo location;
-  // reused_buffer is valid only if alloc_kind == kReuse. It indicates
+  // reused_buffer is valid only if alloc_kind == kReuse, kShare, kSubTensor or kView. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // for kSubTensor, the offset in bytes of this OrtValue in the buffer of reused_buffer
+  size_t sub_tensor_offset{0};
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -72,6 +78,10 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
+  // The static shapes of the values whose buffers hold kSubTensor values, by the index of the value. Such a buffer is
+  // allocated along with the first of its sub-tensors, before the node producing the value runs.
+  std::unordered_map<OrtValueIndex, std::vector<int64_t>> sub_tensor_buffer_shapes;
+
   const OrtMemoryInfo& GetLocation(size_t ort_value_index) const override {
     return allocation_plan[ort_value_index].location;
   }
@@ -94,6 +104,24 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   }
 };
 
+// CompiledExecutionPlan: the SequentialExecutionPlan flattened with the kernels of its nodes once they are
+// created, so the SequentialExecutor runs each step without looking up the kernel and the values of its node.
+struct CompiledExecutionPlan {
+  struct Step {
+    const OpKernel* kernel;
+    // offset of the values of the node in the execution frame, see NodeIndexInfo::GetNodeOffset
+    int node_offset;
+    // the ml-values to free after the step are release_values[release_begin, release_end)
+    int release_begin;
+    int release_end;
+    // the values of the node have fences to wait on before the kernel runs, and to signal after
+    bool has_fence;
+  };
+
+  std::vector<Step> steps;
+  std::vector<OrtValueIndex> release_values;
+};
+
 // Output details of an execution plan:
 std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionPlan*, const SessionState*> planinfo);
 }  // namespace onnxruntime
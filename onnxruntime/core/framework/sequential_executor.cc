@@ -3,17 +3,22 @@
 
 #include "core/framework/sequential_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <vector>
 #include <sstream>
+#include <unordered_set>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/session_metrics.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/hardware_counters.h"
 
 // Define this symbol to create Concurrency Visualizer markers.
 // See https://docs.microsoft.com/en-us/visualstudio/profiling/concurrency-visualizer-sdk
@@ -27,28 +32,380 @@ using namespace Concurrency;
 
 namespace onnxruntime {
 
+// the compiled execution plan skips the per node markers and dumps of these builds
+#if defined(CONCURRENCY_VISUALIZER) || defined(DEBUG_NODE_INPUTS_OUTPUTS)
+static constexpr bool kCanRunCompiledPlan = false;
+#else
+static constexpr bool kCanRunCompiledPlan = true;
+#endif
+
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
                                   const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
                                   const logging::Logger& logger);
 
+// bytes in use in the arena the kernel allocates its outputs from, -1 if it doesn't allocate from an arena
+static int64_t ArenaBytesInUse(const OpKernel& kernel) {
+  auto allocator = kernel.Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+  return arena == nullptr ? -1 : static_cast<int64_t>(arena->Used());
+}
+
+// the hardware counters of the thread during the compute of a node, as arguments of its kernel time event
+static void AddHardwareCounterArgs(const HardwareCounters::Values& begin, const HardwareCounters::Values& end,
+                                   long long duration_us, std::unordered_map<std::string, std::string>& args) {
+  // each miss of the last level cache reads a cache line from memory
+  constexpr uint64_t kCacheLineBytes = 64;
+  const uint64_t cycles = end.cycles - begin.cycles;
+  const uint64_t instructions = end.instructions - begin.instructions;
+  const uint64_t llc_misses = end.llc_misses - begin.llc_misses;
+
+  args["cycles"] = std::to_string(cycles);
+  args["instructions"] = std::to_string(instructions);
+  args["ipc"] = std::to_string(cycles == 0 ? 0. : static_cast<double>(instructions) / cycles);
+  args["llc_misses"] = std::to_string(llc_misses);
+  // bytes per microsecond are megabytes per second
+  args["memory_bandwidth_mbps"] = std::to_string(duration_us <= 0 ? 0 : llc_misses * kCacheLineBytes / duration_us);
+}
+
+// record the peak memory of the tensors of the execution and the tensors alive at the peak, largest first,
+// and the statistics of the arenas of the execution providers
+static void RecordMemoryEvents(const SessionState& session_state, const ExecutionFrame& frame) {
+  auto& profiler = session_state.Profiler();
+  const auto* memory_profile = frame.GetMemoryProfile();
+
+  auto peak_values = memory_profile->peak_values;
+  std::sort(peak_values.begin(), peak_values.end(),
+            [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) { return a.second > b.second; });
+  std::unordered_map<int, const std::string*> value_names;
+  for (const auto& value : peak_values) {
+    value_names[value.first] = nullptr;
+  }
+  for (const auto& name_idx : session_state.GetOrtValueNameIdxMap()) {
+    auto it = value_names.find(name_idx.second);
+    if (it != value_names.end()) {
+      it->second = &name_idx.first;
+    }
+  }
+  std::ostringstream peak_tensors;
+  for (size_t i = 0; i < peak_values.size(); ++i) {
+    const std::string* name = value_names[peak_values[i].first];
+    peak_tensors << (i > 0 ? ";" : "") << (name != nullptr ? *name : std::to_string(peak_values[i].first)) << ":"
+                 << peak_values[i].second;
+  }
+
+  TimePoint tp = profiler.StartTime();
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::PeakMemory", tp,
+                                 {{"peak_bytes", std::to_string(memory_profile->peak_bytes)},
+                                  {"tensors_at_peak", peak_tensors.str()}});
+
+  std::unordered_set<const IAllocator*> recorded_arenas;
+  for (const auto& provider : session_state.GetExecutionProviders()) {
+    for (const auto* info_allocator : provider->GetAllocators()) {
+      auto allocator = provider->GetAllocator(info_allocator->Info().id, info_allocator->Info().mem_type);
+      auto* arena = dynamic_cast<BFCArena*>(allocator.get());
+      if (arena == nullptr || !recorded_arenas.insert(arena).second) {
+        continue;
+      }
+
+      AllocatorStats stats;
+      arena->GetStats(&stats);
+      // the share of the free bytes of the regions that a single allocation can't use
+      const int64_t free_bytes = stats.total_allocated_bytes - stats.bytes_in_use;
+      const double fragmentation =
+          free_bytes > 0 ? 1.0 - static_cast<double>(stats.largest_free_chunk_bytes) / free_bytes : 0.0;
+      tp = profiler.StartTime();
+      profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, std::string("Arena::") + arena->Info().name, tp,
+                                     {{"provider", provider->Type()},
+                                      {"bytes_in_use", std::to_string(stats.bytes_in_use)},
+                                      {"max_bytes_in_use", std::to_string(stats.max_bytes_in_use)},
+                                      {"total_allocated_bytes", std::to_string(stats.total_allocated_bytes)},
+                                      {"largest_free_chunk_bytes", std::to_string(stats.largest_free_chunk_bytes)},
+                                      {"fragmentation", std::to_string(fragmentation)},
+                                      {"num_allocs", std::to_string(stats.num_allocs)}});
+    }
+  }
+}
+
+// true if the feeds have the types and shapes of the feeds a graph was captured with
+static bool MatchesCapturedFeeds(const std::vector<OrtValue>& captured_feeds, const std::vector<OrtValue>& feeds) {
+  if (captured_feeds.size() != feeds.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return false;
+    }
+    const auto& captured = captured_feeds[i].Get<Tensor>();
+    const auto& feed = feeds[i].Get<Tensor>();
+    if (captured.DataType() != feed.DataType() || captured.Shape() != feed.Shape()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// copy the tensors in src to dst, allocating the values of dst that aren't allocated at the location of src
+static Status CopyTensors(const SessionState& session_state, const std::vector<OrtValue>& src,
+                          std::vector<OrtValue>& dst) {
+  dst.resize(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (!src[i].IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Graph capture only supports tensor feeds and outputs.");
+    }
+
+    const auto& src_tensor = src[i].Get<Tensor>();
+    if (!dst[i].IsAllocated()) {
+      auto allocator = utils::GetAllocator(session_state, src_tensor.Location());
+      auto p_tensor = std::make_unique<Tensor>(src_tensor.DataType(), src_tensor.Shape(), allocator);
+      dst[i].Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    }
+
+    auto* dst_tensor = dst[i].GetMutable<Tensor>();
+    if (dst_tensor->Shape() != src_tensor.Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shape of pre-allocated output ", i, " is ",
+                             dst_tensor->Shape(), " instead of ", src_tensor.Shape());
+    }
+    ORT_RETURN_IF_ERROR(session_state.GetDataTransferMgr().CopyTensor(src_tensor, *dst_tensor));
+  }
+
+  return Status::OK();
+}
+
+static Status ReplayCapturedGraph(const SessionState& session_state, ExecutionFrame::CapturedGraph& captured,
+                                  const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+  ORT_RETURN_IF_ERROR(CopyTensors(session_state, feeds, captured.feeds));
+  ORT_RETURN_IF_ERROR(captured.graph->Replay());
+  return CopyTensors(session_state, captured.fetches, fetches);
+}
+
 Status SequentialExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                                    const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
                                    std::vector<OrtValue>& fetches,
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
-  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  if (cached_frame_ == nullptr) {
+    ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+    return ExecuteWithFrame(session_state, frame, feeds, fetches, logger);
+  }
+
+  ORT_ENFORCE(fetch_allocators.empty(), "A cached execution frame can't be used with custom fetch allocators.");
+  if (*cached_frame_) {
+    auto& captured = (*cached_frame_)->GetCapturedGraph();
+    if (captured.graph) {
+      if (MatchesCapturedFeeds(captured.feeds, feeds)) {
+        return ReplayCapturedGraph(session_state, captured, feeds, fetches);
+      }
+
+      // the graph only applies to the shapes it was captured with. capture again with the new ones.
+      captured = ExecutionFrame::CapturedGraph();
+    }
+
+    (*cached_frame_)->Reset(feed_mlvalue_idxs, feeds, fetches);
+  } else {
+    *cached_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                      fetch_allocators, session_state);
+  }
+
+  // the first execution with the frame, or one that traces a memory pattern, allocates memory for the first time
+  // and lets the kernels warm up, which can't be captured.
+  ExecutionFrame& frame = **cached_frame_;
+  auto& captured = frame.GetCapturedGraph();
+  if (session_state.GetGraphCaptureProvider() != nullptr && !captured.capture_failed &&
+      ++captured.num_executions > 1 && !frame.HasMemoryPatternPlanner()) {
+    auto status = CaptureGraph(session_state, frame, feed_mlvalue_idxs, feeds, fetches, logger);
+    if (status.IsOK()) {
+      return status;
+    }
+
+    LOGS(logger, WARNING) << "Running the kernels as the graph could not be captured: " << status.ErrorMessage();
+    captured = ExecutionFrame::CapturedGraph();
+    captured.capture_failed = true;
+    frame.Reset(feed_mlvalue_idxs, feeds, fetches);
+  }
+
+  auto status = ExecuteWithFrame(session_state, frame, feeds, fetches, logger);
+  // don't keep the feeds and outputs alive until the frame is reused
+  frame.ReleaseAllMLValues();
+  return status;
+}
+
+Status SequentialExecutor::CaptureGraph(const SessionState& session_state, ExecutionFrame& frame,
+                                        const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                                        std::vector<OrtValue>& fetches, const logging::Logger& logger) {
+  // the graph reads the feeds and writes the outputs at the addresses of the capture, so the frame executes with
+  // copies of the feeds and outputs it allocates itself, which are kept with the graph.
+  ExecutionFrame::CapturedGraph captured;
+  ORT_RETURN_IF_ERROR(CopyTensors(session_state, feeds, captured.feeds));
+  captured.fetches.resize(fetches.size());
+  frame.Reset(feed_mlvalue_idxs, captured.feeds, captured.fetches);
+
+  const IExecutionProvider& provider = *session_state.GetGraphCaptureProvider();
+  ORT_RETURN_IF_ERROR(provider.BeginGraphCapture());
+  auto status = ExecuteWithFrame(session_state, frame, captured.feeds, captured.fetches, logger);
+  auto end_status = provider.EndGraphCapture(captured.graph);
+  frame.ReleaseAllMLValues();
+  ORT_RETURN_IF_ERROR(status);
+  ORT_RETURN_IF_ERROR(end_status);
+  if (!captured.graph) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, provider.Type(), " failed to capture the graph.");
+  }
+
+  // the capture only recorded the work, so replay it for this execution as well
+  auto& frame_captured = frame.GetCapturedGraph();
+  captured.num_executions = frame_captured.num_executions;
+  frame_captured = std::move(captured);
+  return ReplayCapturedGraph(session_state, frame_captured, feeds, fetches);
+}
+
+Status SequentialExecutor::ExecuteWithFrame(const SessionState& session_state, ExecutionFrame& frame,
+                                            const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                            const logging::Logger& logger) {
+  const bool is_profiler_enabled = session_state.Profiler().IsEnabled() && !session_state.Profiler().IsSampling();
+  // a sampled execution only records the kernel time of the nodes, see Profiler::RecordSampledEvent
+  const bool is_execution_sampled = session_state.Profiler().IsEnabled() && session_state.Profiler().IsSampling() &&
+                                    session_state.Profiler().SampleExecution();
   TimePoint tp;
-  TimePoint sync_time_begin;
-  TimePoint kernel_begin_time;
 
-  if (is_profiler_enabled) {
+  if (is_profiler_enabled || is_execution_sampled) {
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  if (is_profiler_enabled) {
+    frame.EnableMemoryProfiling();
+  }
+
+  // the Runs with weight streaming take turns, as they share the buffer the weights are copied into
+  WeightStreaming* weight_streaming = session_state.GetWeightStreaming();
+  std::unique_lock<OrtMutex> weight_streaming_lock;
+  if (weight_streaming != nullptr) {
+    weight_streaming_lock = weight_streaming->BeginRun();
+  }
 
   LOGS(logger, INFO) << "Begin execution";
+  // the compiled plan runs the kernels without anything recorded per node
+  const CompiledExecutionPlan* compiled_plan = session_state.GetCompiledExecutionPlan();
+  if (kCanRunCompiledPlan && compiled_plan != nullptr && !is_profiler_enabled && !is_execution_sampled &&
+      session_state.Metrics() == nullptr && weight_streaming == nullptr) {
+    ORT_RETURN_IF_ERROR(ExecuteCompiledSteps(session_state, *compiled_plan, 0, compiled_plan->steps.size(), frame,
+                                             terminate_flag_, thread_pool_, logger));
+  } else {
+    ORT_RETURN_IF_ERROR(ExecuteNodes(session_state, frame, is_profiler_enabled, is_execution_sampled, logger));
+  }
+
+  VLOGS(logger, 1) << "Fetching output.";
+  // ExecutionFrame::Finalize will update 'fetches' with the final output
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done with execution.";
+
+  ORT_RETURN_IF_ERROR(CacheMemoryPatterns(session_state, frame, feeds));
+
+  if (is_profiler_enabled) {
+    RecordMemoryEvents(session_state, frame);
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+  } else if (is_execution_sampled) {
+    static const std::string execute_event_name = "SequentialExecutor::Execute";
+    session_state.Profiler().RecordSampledEvent(profiling::SESSION_EVENT, execute_event_name, "", tp);
+  }
+
+  return Status::OK();
+}
+
+Status SequentialExecutor::CacheMemoryPatterns(const SessionState& session_state, ExecutionFrame& frame,
+                                               const std::vector<OrtValue>& feeds) {
+  if (!frame.HasMemoryPatternPlanner()) {
+    return Status::OK();
+  }
+
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
+  for (const auto& feed : feeds) {
+    if (!(feed.IsTensor())) {
+      return Status::OK();
+    }
+    auto& tensor = feed.Get<Tensor>();
+    input_shapes.push_back(std::cref(tensor.Shape()));
+  }
+
+  auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+  ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
+  return session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns));
+}
+
+// waits for the work on other queues that the values of the kernel depend on, before it runs on queue_id
+static void WaitOnFences(const OpKernel& kernel, const OpKernelContextInternal& op_kernel_context, int queue_id) {
+  for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+    Fence_t fence = op_kernel_context.InputFence(input_index);
+    if (fence) {
+      auto execution_provider_type = kernel.Node().GetExecutionProviderType();
+      if (OrtMemTypeCPUInput == kernel.KernelDef().InputMemoryType(input_index)) {
+        execution_provider_type = kCpuExecutionProvider;
+      }
+      fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+    }
+  }
+
+  for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+    Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+    if (fence) {
+      auto execution_provider_type = kernel.Node().GetExecutionProviderType();
+      if (OrtMemTypeCPUInput == kernel.KernelDef().InputMemoryType(input_index)) {
+        execution_provider_type = kCpuExecutionProvider;
+      }
+      fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+    }
+  }
+
+  for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+    Fence_t fence = op_kernel_context.OutputFence(output_index);
+    if (fence) {
+      fence->BeforeUsingAsOutput(kernel.Node().GetExecutionProviderType(), queue_id);
+    }
+  }
+}
+
+// records the work the kernel submitted on queue_id in the fences of its values
+static void SignalFences(const OpKernelContextInternal& op_kernel_context, int queue_id) {
+  for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+    Fence_t fence = op_kernel_context.InputFence(input_index);
+    if (fence) {
+      fence->AfterUsedAsInput(queue_id);
+    }
+  }
+
+  for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+    Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+    if (fence) {
+      fence->AfterUsedAsInput(queue_id);
+    }
+  }
+
+  for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+    Fence_t fence = op_kernel_context.OutputFence(output_index);
+    if (fence) {
+      fence->AfterUsedAsOutput(queue_id);
+    }
+  }
+}
+
+Status SequentialExecutor::ExecuteNodes(const SessionState& session_state, ExecutionFrame& frame,
+                                        bool is_profiler_enabled, bool is_execution_sampled,
+                                        const logging::Logger& logger) {
+  TimePoint sync_time_begin;
+  TimePoint kernel_begin_time;
+  SessionMetrics* metrics = session_state.Metrics();
+  std::chrono::high_resolution_clock::time_point metrics_begin_time;
+  // the counters of this thread, which only cover the work the kernels don't hand to the thread pool
+  HardwareCounters* hardware_counters = is_profiler_enabled && session_state.Profiler().IsHardwareCountersEnabled()
+                                            ? HardwareCounters::ForCurrentThread()
+                                            : nullptr;
+  HardwareCounters::Values counters_begin, counters_end;
+  bool has_counters = false;
+  long long counters_duration_us = 0;
+  // attribute the device work of the kernels to their nodes, see Profiler::StartEpEvents
+  const bool record_ep_events = is_profiler_enabled && session_state.Profiler().HasEpProfilers();
+
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
   VLOGS(logger, 1) << "Size of execution plan vector: " << exec_plan_vec.size();
@@ -56,6 +413,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   // uncomment the line below to dump execution plan
   //std::cout << std::make_pair(p_seq_exec_plan, &session_state) << "\n";
   const auto* graph_viewer = session_state.GetGraphViewer();
+  WeightStreaming* weight_streaming = session_state.GetWeightStreaming();
 
 #ifdef CONCURRENCY_VISUALIZER
   // need unique name for the series. number of nodes should be good enough for a subgraph
@@ -68,10 +426,11 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   diagnostic::marker_series series(series_name);
 #endif
 
-  for (const auto& node_exec_plan : exec_plan_vec) {
+  for (size_t step = 0; step < exec_plan_vec.size(); ++step) {
+    const auto& node_exec_plan = exec_plan_vec[step];
     if (terminate_flag_) {
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      return OpKernelContext::TerminatedStatus();
     }
 
     auto node_index = node_exec_plan.node_index;
@@ -88,9 +447,14 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Got nullptr from GetKernel for node: ",
                              node.Name());
 
+    if (weight_streaming != nullptr) {
+      ORT_RETURN_IF_ERROR(weight_streaming->BeginStep(session_state, step, frame));
+    }
+
     // construct OpKernelContext
     // TODO: log kernel inputs?
-    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_,
+                                              thread_pool_);
     // TODO: log kernel outputs?
     if (is_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -99,34 +463,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     // sync before compute
     int queue_id = p_op_kernel->KernelDef().ExecQueueId();
     if (seq_exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = p_op_kernel->Node().GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
-
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = p_op_kernel->Node().GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
-
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->BeforeUsingAsOutput(p_op_kernel->Node().GetExecutionProviderType(), queue_id);
-        }
-      }
+      WaitOnFences(*p_op_kernel, op_kernel_context, queue_id);
     }
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
@@ -143,6 +480,13 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
       kernel_begin_time = session_state.Profiler().StartTime();
+      has_counters = hardware_counters != nullptr && hardware_counters->Read(counters_begin);
+    } else if (is_execution_sampled) {
+      kernel_begin_time = session_state.Profiler().StartTime();
+    }
+
+    if (metrics != nullptr) {
+      metrics_begin_time = std::chrono::high_resolution_clock::now();
     }
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -150,7 +494,11 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       diagnostic::span span(series, "%s.%d", node.OpType().c_str(), node.Index());
 #endif
 
+      const uint64_t ep_events_id = record_ep_events ? session_state.Profiler().StartEpEvents(node.Name()) : 0;
       Status compute_status = p_op_kernel->Compute(&op_kernel_context);
+      if (record_ep_events) {
+        session_state.Profiler().StopEpEvents(ep_events_id);
+      }
       if (!compute_status.IsOK()) {
         std::ostringstream ss;
         ss << "Non-zero status code returned while running Node: " << node.Name()
@@ -160,41 +508,55 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
         return Status(compute_status.Category(), compute_status.Code(), msg_string);
       }
 
+      if (has_counters) {
+        has_counters = hardware_counters->Read(counters_end);
+        counters_duration_us = TimeDiffMicroSeconds(kernel_begin_time);
+      }
+
 #ifdef CONCURRENCY_VISUALIZER
     }
 #endif
 
+    if (weight_streaming != nullptr) {
+      ORT_RETURN_IF_ERROR(weight_streaming->EndStep(session_state, step, frame));
+    }
+
+    if (metrics != nullptr) {
+      metrics->RecordKernel(*p_op_kernel, op_kernel_context,
+                            std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::high_resolution_clock::now() - metrics_begin_time));
+    }
+
     if (is_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+      // the memory of the outputs of the node, and the arena it allocates them from
+      size_t output_allocated_bytes, output_pattern_bytes, output_reused_bytes;
+      frame.TakeNodeMemoryStats(output_allocated_bytes, output_pattern_bytes, output_reused_bytes);
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", p_op_kernel->KernelDef().OpName()},
+          {"provider", p_op_kernel->KernelDef().Provider()},
+          {"output_allocated_bytes", std::to_string(output_allocated_bytes)},
+          {"output_pattern_bytes", std::to_string(output_pattern_bytes)},
+          {"output_reused_bytes", std::to_string(output_reused_bytes)},
+          {"arena_bytes_in_use", std::to_string(ArenaBytesInUse(*p_op_kernel))},
+          {"live_tensor_bytes", std::to_string(frame.GetMemoryProfile()->live_bytes)}};
+      if (has_counters) {
+        AddHardwareCounterArgs(counters_begin, counters_end, counters_duration_us, event_args);
+      }
+      session_state.Profiler().EndTimeAndRecordEventWithArgs(profiling::NODE_EVENT,
+                                                             p_op_kernel->Node().Name() + "_kernel_time",
+                                                             kernel_begin_time,
+                                                             std::move(event_args));
 
       sync_time_begin = session_state.Profiler().StartTime();
+    } else if (is_execution_sampled) {
+      session_state.Profiler().RecordSampledEvent(profiling::NODE_EVENT, p_op_kernel->Node().Name(), "_kernel_time",
+                                                  kernel_begin_time, &p_op_kernel->KernelDef().OpName(),
+                                                  &p_op_kernel->KernelDef().Provider());
     }
 
     // sync after compute for outputs
     if (seq_exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
-      }
-
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
-      }
-
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->AfterUsedAsOutput(queue_id);
-        }
-      }
+      SignalFences(op_kernel_context, queue_id);
     }
 
     if (is_profiler_enabled) {
@@ -213,32 +575,44 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
   }
 
-  VLOGS(logger, 1) << "Fetching output.";
-  // ExecutionFrame::Finalize will update 'fetches' with the final output
-  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
-  VLOGS(logger, 1) << "Done with execution.";
+  return Status::OK();
+}
 
-  if (frame.HasMemoryPatternPlanner()) {
-    std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.Get<Tensor>();
-      input_shapes.push_back(std::cref(tensor.Shape()));
+Status SequentialExecutor::ExecuteCompiledSteps(const SessionState& session_state, const CompiledExecutionPlan& plan,
+                                                size_t begin, size_t end, ExecutionFrame& frame,
+                                                const bool& terminate_flag, concurrency::ThreadPool* thread_pool,
+                                                const logging::Logger& logger) {
+  for (size_t s = begin; s < end; ++s) {
+    const auto& step = plan.steps[s];
+    if (terminate_flag) {
+      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+      return OpKernelContext::TerminatedStatus();
     }
 
-    if (all_tensors) {
-      auto mem_patterns = std::make_unique<MemoryPatternGroup>();
-      ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
+    OpKernelContextInternal op_kernel_context(session_state, frame, *step.kernel, step.node_offset, logger,
+                                              terminate_flag, thread_pool);
+    const int queue_id = step.kernel->KernelDef().ExecQueueId();
+    if (step.has_fence) {
+      WaitOnFences(*step.kernel, op_kernel_context, queue_id);
     }
-  }
 
-  if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+    Status compute_status = step.kernel->Compute(&op_kernel_context);
+    if (!compute_status.IsOK()) {
+      std::ostringstream ss;
+      ss << "Non-zero status code returned while running Node: " << step.kernel->Node().Name()
+         << " Status Message: " << compute_status.ErrorMessage();
+      const auto msg_string = ss.str();
+      LOGS(logger, ERROR) << msg_string;
+      return Status(compute_status.Category(), compute_status.Code(), msg_string);
+    }
+
+    if (step.has_fence) {
+      SignalFences(op_kernel_context, queue_id);
+    }
+
+    for (int i = step.release_begin; i < step.release_end; ++i) {
+      ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(plan.release_values[i]));
+    }
   }
 
   return Status::OK();
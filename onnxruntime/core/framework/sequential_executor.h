@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include "core/common/common.h"
@@ -15,9 +16,27 @@
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
+  /**
+   * @param thread_pool The pool the kernels run their parallel loops on. nullptr for the session state's.
+   */
+  SequentialExecutor(const bool& terminate_flag = false, concurrency::ThreadPool* thread_pool = nullptr)
+      : terminate_flag_{terminate_flag}, thread_pool_{thread_pool} {}
+
+  /**
+   * @param cached_frame If it holds a frame, the frame is reset and reused for the execution. Otherwise the frame
+   * created for the execution is left in it. It must only be used with feeds and fetches that map to the same
+   * OrtValue indexes, and without custom fetch allocators.
+   * If the session state has a graph capture provider, an execution that reuses the frame with its memory pattern
+   * in place is captured into a graph of device work. The next executions with feeds of the same types and shapes
+   * copy the feeds to the captured ones and replay the graph instead of running the kernels.
+   */
+  SequentialExecutor(const bool& terminate_flag, std::unique_ptr<ExecutionFrame>& cached_frame,
+                     concurrency::ThreadPool* thread_pool = nullptr)
+      : terminate_flag_{terminate_flag}, cached_frame_{&cached_frame}, thread_pool_{thread_pool} {}
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -25,8 +44,36 @@ class SequentialExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                          const logging::Logger& logger) override;
 
+  /**
+   * Runs the steps [begin, end) of the compiled plan of the session state on the frame, with the kernels and node
+   * offsets resolved when the session was created. Nothing is recorded per node.
+   */
+  static common::Status ExecuteCompiledSteps(const SessionState& session_state, const CompiledExecutionPlan& plan,
+                                             size_t begin, size_t end, ExecutionFrame& frame,
+                                             const bool& terminate_flag, concurrency::ThreadPool* thread_pool,
+                                             const logging::Logger& logger);
+
+  // caches the memory pattern the frame planned for the shapes of the feeds, when they are all tensors
+  static common::Status CacheMemoryPatterns(const SessionState& session_state, ExecutionFrame& frame,
+                                            const std::vector<OrtValue>& feeds);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
+
+  common::Status ExecuteWithFrame(const SessionState& session_state, ExecutionFrame& frame,
+                                  const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                  const logging::Logger& logger);
+
+  // runs the nodes of the execution plan, recording what the profiler and the session metrics ask for
+  common::Status ExecuteNodes(const SessionState& session_state, ExecutionFrame& frame, bool is_profiler_enabled,
+                              bool is_execution_sampled, const logging::Logger& logger);
+
+  common::Status CaptureGraph(const SessionState& session_state, ExecutionFrame& frame,
+                              const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                              std::vector<OrtValue>& fetches, const logging::Logger& logger);
+
   const bool& terminate_flag_;
+  std::unique_ptr<ExecutionFrame>* const cached_frame_ = nullptr;
+  concurrency::ThreadPool* const thread_pool_;
 };
 }  // namespace onnxruntime
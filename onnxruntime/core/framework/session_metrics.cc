@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_metrics.h"
+
+#include "core/framework/execution_providers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+
+SessionMetrics::SessionMetrics(const std::string& session_logid, const ExecutionProviders& execution_providers)
+    : run_duration_(metrics::MetricsRegistry::Global().GetHistogram(
+          "onnxruntime_session_run_duration_seconds", "Duration of the runs of the sessions.",
+          metrics::MetricsRegistry::DefaultDurationBounds(), {{"session", session_logid}})),
+      run_failures_(metrics::MetricsRegistry::Global().GetCounter(
+          "onnxruntime_session_run_failures_total", "Runs of the sessions which failed.",
+          {{"session", session_logid}})),
+      memcpy_from_host_bytes_(metrics::MetricsRegistry::Global().GetCounter(
+          "onnxruntime_session_memcpy_bytes_total", "Bytes the Memcpy nodes of the sessions copied.",
+          {{"session", session_logid}, {"direction", "from_host"}})),
+      memcpy_to_host_bytes_(metrics::MetricsRegistry::Global().GetCounter(
+          "onnxruntime_session_memcpy_bytes_total", "Bytes the Memcpy nodes of the sessions copied.",
+          {{"session", session_logid}, {"direction", "to_host"}})) {
+  for (const auto& provider : execution_providers) {
+    provider_compute_us_[provider->Type()] = &metrics::MetricsRegistry::Global().GetCounter(
+        "onnxruntime_session_kernel_compute_microseconds_total",
+        "Time the kernels of the sessions spent in Compute, per execution provider.",
+        {{"session", session_logid}, {"provider", provider->Type()}});
+  }
+}
+
+void SessionMetrics::RecordRun(std::chrono::duration<double> duration, bool failed) {
+  run_duration_.Observe(duration.count());
+  if (failed) {
+    run_failures_.Increment();
+  }
+}
+
+void SessionMetrics::RecordKernel(const OpKernel& kernel, const OpKernelContext& context,
+                                  std::chrono::microseconds duration) {
+  auto it = provider_compute_us_.find(kernel.Node().GetExecutionProviderType());
+  if (it != provider_compute_us_.end()) {
+    it->second->Add(static_cast<uint64_t>(duration.count()));
+  }
+
+  const auto& op_type = kernel.Node().OpType();
+  if (op_type == "MemcpyFromHost" || op_type == "MemcpyToHost") {
+    const auto* tensor = context.Input<Tensor>(0);
+    if (tensor != nullptr) {
+      (op_type == "MemcpyFromHost" ? memcpy_from_host_bytes_ : memcpy_to_host_bytes_).Add(tensor->SizeInBytes());
+    }
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/metrics.h"
+
+namespace onnxruntime {
+
+class ExecutionProviders;
+class OpKernel;
+class OpKernelContext;
+
+/**
+The metrics a session records in the metrics registry when its enable_metrics option is set, labelled with
+its logid: the duration and failures of its runs, the compute time of its kernels per execution provider, and the
+bytes its Memcpy nodes copy between the host and the devices.
+*/
+class SessionMetrics {
+ public:
+  SessionMetrics(const std::string& session_logid, const ExecutionProviders& execution_providers);
+
+  void RecordRun(std::chrono::duration<double> duration, bool failed);
+
+  // record the compute time of a kernel, and the bytes it copied if it is a Memcpy node
+  void RecordKernel(const OpKernel& kernel, const OpKernelContext& context, std::chrono::microseconds duration);
+
+ private:
+  metrics::Histogram& run_duration_;
+  metrics::Counter& run_failures_;
+  // by execution provider type
+  std::unordered_map<std::string, metrics::Counter*> provider_compute_us_;
+  metrics::Counter& memcpy_from_host_bytes_;
+  metrics::Counter& memcpy_to_host_bytes_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionMetrics);
+};
+
+}  // namespace onnxruntime
@@ -3,9 +3,11 @@
 
 #include "core/framework/session_state.h"
 
+#include <limits>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
+#include "core/common/metrics.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
@@ -100,11 +102,102 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
   }
   node_index_info_ = std::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
+  CompileExecutionPlan();
+  ComputeNodePriorities();
   return Status::OK();
 }
 
+// the most elements a node reads and writes to be run on the thread that made it ready
+static constexpr int64_t kMaxCheapNodeElements = 4096;
+
+// The number of elements of the values a node reads and writes, which stands for its cost. known is false if a
+// shape isn't fully known statically, in which case its unknown dimensions count as 1.
+static int64_t EstimateNodeElements(const Node& node, bool& known) {
+  known = true;
+  int64_t elements = 0;
+  auto add_values = [&elements, &known](const ConstPointerContainer<std::vector<NodeArg*>>& defs) {
+    for (const auto* def : defs) {
+      if (!def->Exists()) {
+        continue;
+      }
+
+      const auto* shape = def->Shape();
+      if (shape == nullptr) {
+        known = false;
+        continue;
+      }
+
+      int64_t size = 1;
+      for (const auto& dim : shape->dim()) {
+        if (dim.has_dim_value()) {
+          size *= dim.dim_value();
+        } else {
+          known = false;
+        }
+      }
+      elements += size;
+    }
+  };
+
+  add_values(node.InputDefs());
+  add_values(node.OutputDefs());
+  return elements;
+}
+
+void SessionState::ComputeNodePriorities() {
+  const size_t max_node_index = graph_viewer_->MaxNodeIndex();
+  node_priorities_.assign(max_node_index, 0);
+  cheap_nodes_.assign(max_node_index, false);
+
+  // the consumers of a node come after it in the topological order
+  const auto& order = graph_viewer_->GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const Node& node = *graph_viewer_->GetNode(*it);
+    bool known = false;
+    const int64_t elements = EstimateNodeElements(node, known);
+    cheap_nodes_[*it] = known && elements <= kMaxCheapNodeElements && !node.ContainsSubgraph();
+
+    int64_t longest_consumer_path = 0;
+    for (auto consumer = node.OutputNodesBegin(); consumer != node.OutputNodesEnd(); ++consumer) {
+      longest_consumer_path = std::max(longest_consumer_path, node_priorities_[consumer->Index()]);
+    }
+    node_priorities_[*it] = std::max<int64_t>(elements, 1) + longest_consumer_path;
+  }
+}
+
 void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan) {
   p_seq_exec_plan_ = std::move(p_seq_exec_plan);
+  CompileExecutionPlan();
+}
+
+void SessionState::CompileExecutionPlan() {
+  compiled_exec_plan_.reset();
+  if (p_seq_exec_plan_ == nullptr || node_index_info_ == nullptr) {
+    return;
+  }
+
+  auto compiled = std::make_unique<CompiledExecutionPlan>();
+  compiled->steps.reserve(p_seq_exec_plan_->execution_plan.size());
+  for (const auto& node_exec_plan : p_seq_exec_plan_->execution_plan) {
+    const NodeIndex node_index = node_exec_plan.node_index;
+    const OpKernel* kernel = GetKernel(node_index);
+    if (kernel == nullptr) {
+      return;
+    }
+
+    CompiledExecutionPlan::Step step;
+    step.kernel = kernel;
+    step.node_offset = node_index_info_->GetNodeOffset(node_index);
+    step.release_begin = static_cast<int>(compiled->release_values.size());
+    for (int i = node_exec_plan.free_from_index; i <= node_exec_plan.free_to_index; ++i) {
+      compiled->release_values.push_back(p_seq_exec_plan_->to_be_freed[i]);
+    }
+    step.release_end = static_cast<int>(compiled->release_values.size());
+    step.has_fence = p_seq_exec_plan_->NodeHasFence(node_index);
+    compiled->steps.push_back(step);
+  }
+
+  compiled_exec_plan_ = std::move(compiled);
 }
 
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const { return p_seq_exec_plan_.get(); }
@@ -148,39 +241,111 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
+// round a dim up to the next power of 2 so that shapes which only differ in e.g. sequence length share a pattern.
+static int64_t BucketDim(int64_t dim) {
+  if (dim <= 1) return dim;
+  int64_t bucket = 1;
+  while (bucket < dim && bucket < (std::numeric_limits<int64_t>::max() >> 1)) bucket <<= 1;
+  return bucket < dim ? dim : bucket;
+}
+
+// flatten the input shapes as [rank, dims..., rank, dims..., ...]
+static std::vector<int64_t> FlattenShapes(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
+  std::vector<int64_t> flattened;
   for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    const auto& dims = shape.get().GetDims();
+    flattened.push_back(static_cast<int64_t>(dims.size()));
+    flattened.insert(flattened.end(), dims.begin(), dims.end());
+  }
+  return flattened;
+}
+
+static std::vector<int64_t> CalculateMemoryPatternsKey(const std::vector<int64_t>& flattened_shapes) {
+  std::vector<int64_t> key;
+  key.reserve(flattened_shapes.size());
+  // ranks are kept as is, only dims are bucketed
+  for (size_t i = 0; i < flattened_shapes.size();) {
+    auto rank = flattened_shapes[i++];
+    key.push_back(rank);
+    for (int64_t j = 0; j < rank; ++j, ++i) key.push_back(BucketDim(flattened_shapes[i]));
   }
   return key;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// true if every dim in 'dims' is at least as large as the matching dim in 'other'.
+// both must have the same key, so they have the same layout.
+static bool Covers(const std::vector<int64_t>& dims, const std::vector<int64_t>& other) {
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (dims[i] < other[i]) return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  auto dims = FlattenShapes(input_shapes);
+  auto key = CalculateMemoryPatternsKey(dims);
+
+  static metrics::Counter& hits = metrics::MetricsRegistry::Global().GetCounter(
+      "onnxruntime_memory_pattern_cache_hits_total", "Runs which found the memory pattern of their input shapes.");
+  static metrics::Counter& misses = metrics::MetricsRegistry::Global().GetCounter(
+      "onnxruntime_memory_pattern_cache_misses_total", "Runs which had no memory pattern for their input shapes.");
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  auto it = mem_patterns_index_.find(key);
+  if (it == mem_patterns_index_.end() || !Covers(it->second->dims, dims)) {
+    misses.Increment();
+    return nullptr;
+  }
 
-  return it->second.get();
+  auto entry = it->second;
+  hits.Increment();
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, entry);
+  return entry->mem_patterns;
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  auto dims = FlattenShapes(input_shapes);
+  auto key = CalculateMemoryPatternsKey(dims);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  auto it = mem_patterns_index_.find(key);
+  if (it != mem_patterns_index_.end()) {
+    auto entry = it->second;
+    // keep a pattern generated from larger shapes, as it can be used for more requests in the bucket.
+    // runs holding the previous pattern keep it alive through their shared_ptr.
+    if (Covers(dims, entry->dims)) {
+      entry->dims = std::move(dims);
+      entry->mem_patterns = std::move(mem_patterns);
+    }
+
+    mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, entry);
+    return Status::OK();
+  }
+
+  if (mem_pattern_cache_capacity_ == 0) return Status::OK();
+
+  if (mem_patterns_.size() >= mem_pattern_cache_capacity_) {
+    mem_patterns_index_.erase(mem_patterns_.back().key);
+    mem_patterns_.pop_back();
   }
 
+  mem_patterns_.push_front(MemoryPatternCacheEntry{key, std::move(dims), std::move(mem_patterns)});
+  mem_patterns_index_.emplace(std::move(key), mem_patterns_.begin());
+
   return Status::OK();
 }
 
+void SessionState::SetStaticMemoryPatternGroup(std::unique_ptr<MemoryPatternGroup> mem_patterns) {
+  static_mem_patterns_ = std::move(mem_patterns);
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetStaticMemoryPatternGroup() const {
+  return static_mem_patterns_;
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
@@ -294,13 +459,36 @@ SessionState* SessionState::GetMutableSubgraphSessionState(onnxruntime::NodeInde
 
 const SessionState* SessionState::GetSubgraphSessionState(onnxruntime::NodeIndex index,
                                                           const std::string& attribute_name) const {
-  return const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index, attribute_name);
+  const SessionState* session_state = const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index,
+                                                                                                       attribute_name);
+
+  if (session_state != nullptr && session_state->deferred_initializer_pending_.load(std::memory_order_acquire)) {
+    std::lock_guard<OrtMutex> lock(session_state->deferred_initializer_lock_);
+    if (!session_state->deferred_initializer_ran_) {
+      session_state->deferred_initializer_status_ = session_state->deferred_initializer_();
+      session_state->deferred_initializer_ran_ = true;
+      if (session_state->deferred_initializer_status_.IsOK()) {
+        session_state->deferred_initializer_pending_.store(false, std::memory_order_release);
+      }
+    }
+
+    // a failure stays pending so it is reported to every use of the subgraph
+    ORT_THROW_IF_ERROR(session_state->deferred_initializer_status_);
+  }
+
+  return session_state;
 }
 
 void SessionState::RemoveSubgraphSessionState(onnxruntime::NodeIndex index) {
   subgraph_session_states_.erase(index);
 }
 
+void SessionState::SetDeferredInitializer(std::function<common::Status()> initializer) {
+  deferred_initializer_ = std::move(initializer);
+  deferred_initializer_ran_ = false;
+  deferred_initializer_pending_ = deferred_initializer_ != nullptr;
+}
+
 const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   ORT_ENFORCE(node_index_info_, "SetGraphAndCreateKernels must be called prior to GetExecutionInfo.");
   return *node_index_info_;
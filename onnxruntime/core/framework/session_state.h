@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "gsl/gsl_util"
 
@@ -23,6 +27,7 @@
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/weight_streaming.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/platform/threadpool.h"
@@ -33,6 +38,7 @@ class ExecutionProviders;
 class KernelDef;
 class OpKernel;
 class NodeIndexInfo;
+class SessionMetrics;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 
@@ -49,9 +55,16 @@ struct MemoryPatternGroup;
  */
 class SessionState {
  public:
+  // default number of input shape buckets a memory pattern is cached for.
+  static constexpr size_t kDefaultMemPatternCacheCapacity = 16;
+
   SessionState(const ExecutionProviders& execution_providers, bool enable_mem_pattern,
-               concurrency::ThreadPool* thread_pool)
-      : execution_providers_{execution_providers}, enable_mem_pattern_(enable_mem_pattern), thread_pool_(thread_pool) {}
+               concurrency::ThreadPool* thread_pool,
+               size_t mem_pattern_cache_capacity = kDefaultMemPatternCacheCapacity)
+      : execution_providers_{execution_providers},
+        enable_mem_pattern_(enable_mem_pattern),
+        mem_pattern_cache_capacity_(mem_pattern_cache_capacity),
+        thread_pool_(thread_pool) {}
 
   ~SessionState() {
     for (auto* p : session_kernels_) {
@@ -113,6 +126,24 @@ class SessionState {
   void SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan);
   const SequentialExecutionPlan* GetExecutionPlan() const;
 
+  /**
+  The execution plan flattened with the kernels of its nodes, which is available once there are both an
+  execution plan and kernels.
+  */
+  const CompiledExecutionPlan* GetCompiledExecutionPlan() const { return compiled_exec_plan_.get(); }
+
+  /**
+  The priority of each node for the ParallelExecutor, by node index: the estimated cost of the longest path from the
+  node to the end of the graph, so the nodes on the critical path have the highest ones. Set with the kernels.
+  */
+  const std::vector<int64_t>& GetNodePriorities() const { return node_priorities_; }
+
+  /**
+  Whether the node is estimated cheap enough for the ParallelExecutor to run it on the thread that made it ready
+  rather than queue it. Set with the kernels.
+  */
+  bool IsCheapNode(NodeIndex node_index) const { return cheap_nodes_[node_index]; }
+
   /**
   Set the logger to use for this session.
   */
@@ -136,18 +167,41 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Set the metrics the executors record for this session, nullptr when the session doesn't record metrics.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  void SetMetrics(SessionMetrics* metrics) { metrics_ = metrics; }
+  SessionMetrics* Metrics() const { return metrics_; }
+
+  /**
+  Get cached memory pattern based on input shapes.
+  Patterns are cached per bucket of input shapes (each dim rounded up to a power of 2). A pattern is returned
+  if it was generated from shapes in the same bucket that are at least as large as input_shapes in every dim,
+  as every block in it is then large enough for the tensors of this run.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
+  Replaces the cached pattern of the bucket if input_shapes are at least as large in every dim as the shapes it
+  was generated from. The least recently used bucket is evicted once the cache holds mem_pattern_cache_capacity
+  patterns.
   Const as it's an internal cache update only.
   */
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Set the memory pattern planned ahead of execution for all input shapes.
+  See SequentialPlanner::CreateStaticMemoryPattern.
+  */
+  void SetStaticMemoryPatternGroup(std::unique_ptr<MemoryPatternGroup> mem_patterns);
+
+  /**
+  Get the memory pattern planned ahead of execution. nullptr if none was planned.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetStaticMemoryPatternGroup() const;
+
   /**
   Get enable memory pattern flag
   */
@@ -188,6 +242,8 @@ class SessionState {
                                std::unique_ptr<SessionState> session_state);
 
   /// Return SessionState for the given Node index and attribute name if found.
+  /// Runs the deferred initializer of the subgraph SessionState if it has one that hasn't run yet, and throws if
+  /// that fails. Only one caller runs it, the concurrent ones wait for it.
   const SessionState* GetSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name) const;
 
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
@@ -196,8 +252,43 @@ class SessionState {
   // If the node isn't going to be executed by the CPU provider we don't need it.
   void RemoveSubgraphSessionState(onnxruntime::NodeIndex index);
 
+  /// Defer the initialization of this subgraph SessionState, which creates its plan, initializers and kernels and
+  /// sets up the node running the subgraph, to the first GetSubgraphSessionState for it.
+  /// See SessionOptions::enable_lazy_subgraph_initialization.
+  void SetDeferredInitializer(std::function<common::Status()> initializer);
+
   concurrency::ThreadPool* GetThreadPool() const { return thread_pool_; }
 
+  /**
+  Set the thread pool the parallel executor runs the nodes on. If not set, the nodes run on the thread pool
+  returned by GetThreadPool, which also runs the parallel loops inside the kernels.
+  */
+  void SetInterOpThreadPool(concurrency::ThreadPool* thread_pool) { inter_op_thread_pool_ = thread_pool; }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_; }
+
+  /**
+  Set the provider that captures the executions of the graph with a cached frame into graphs of device work,
+  which the later executions replay. See SequentialExecutor.
+  */
+  void SetGraphCaptureProvider(const IExecutionProvider* provider) { graph_capture_provider_ = provider; }
+  const IExecutionProvider* GetGraphCaptureProvider() const { return graph_capture_provider_; }
+
+  /**
+  Set the weight streaming of the graph, which copies the initializers of a provider to its device memory ahead of
+  the nodes reading them. See SessionOptions::weight_streaming_buffer_size.
+  */
+  void SetWeightStreaming(std::unique_ptr<WeightStreaming> weight_streaming) {
+    weight_streaming_ = std::move(weight_streaming);
+  }
+  WeightStreaming* GetWeightStreaming() const { return weight_streaming_.get(); }
+
+  /**
+  Set the outputs returned in the device memory the graph produces them in, rather than in CPU memory, when the
+  Run doesn't pre-allocate them. See SessionOptions::device_outputs.
+  */
+  void SetDeviceOutputs(const std::unordered_set<std::string>& names) { device_outputs_ = names; }
+  bool IsDeviceOutput(const std::string& name) const { return device_outputs_.count(name) != 0; }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -213,6 +304,12 @@ class SessionState {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
+  // builds compiled_exec_plan_ from the execution plan and the kernels if both are set
+  void CompileExecutionPlan();
+
+  // sets node_priorities_ and cheap_nodes_ from the shapes of the values of the graph
+  void ComputeNodePriorities();
+
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::vector<OpKernel*> session_kernels_;
@@ -231,16 +328,37 @@ class SessionState {
   std::unordered_map<int, OrtCallback> deleter_for_initialized_tensors_;
   std::vector<BufferUniquePtr> weights_buffers_;
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
+  std::unique_ptr<CompiledExecutionPlan> compiled_exec_plan_;
+  std::vector<int64_t> node_priorities_;
+  std::vector<bool> cheap_nodes_;
 
   const logging::Logger* logger_ = nullptr;
-  profiling::Profiler* profiler_;
+  profiling::Profiler* profiler_{nullptr};
+  SessionMetrics* metrics_ = nullptr;
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
+  // max number of entries in mem_patterns_.
+  const size_t mem_pattern_cache_capacity_;
+
+  struct MemoryPatternCacheEntry {
+    // bucketed input shapes. see CalculateMemoryPatternsKey.
+    std::vector<int64_t> key;
+    // the input shapes the pattern was generated from, in the same layout as key.
+    std::vector<int64_t> dims;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+  };
+  using MemoryPatternCacheList = std::list<MemoryPatternCacheEntry>;
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // cache for the generated mem_patterns, most recently used first.
+  mutable MemoryPatternCacheList mem_patterns_;
+  // index into mem_patterns_. key is calculated based on input shapes.
+  mutable std::map<std::vector<int64_t>, MemoryPatternCacheList::iterator> mem_patterns_index_;
+  // memory pattern planned from the execution plan when all tensor sizes are known statically.
+  // used instead of mem_patterns_ if set.
+  std::shared_ptr<const MemoryPatternGroup> static_mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -251,8 +369,21 @@ class SessionState {
       std::unordered_map<onnxruntime::NodeIndex, std::unordered_map<std::string, std::unique_ptr<SessionState>>>;
   SubgraphSessionStateMap subgraph_session_states_;
 
+  // initializes this subgraph SessionState on its first use, see SetDeferredInitializer.
+  // deferred_initializer_pending_ is checked without the lock, and cleared once the initializer has succeeded.
+  mutable OrtMutex deferred_initializer_lock_;
+  std::function<common::Status()> deferred_initializer_;
+  mutable std::atomic<bool> deferred_initializer_pending_{false};
+  mutable bool deferred_initializer_ran_ = false;
+  mutable common::Status deferred_initializer_status_;
+
   // It could be NULL
   concurrency::ThreadPool* const thread_pool_;
+  // It could be NULL
+  concurrency::ThreadPool* inter_op_thread_pool_ = nullptr;
+  const IExecutionProvider* graph_capture_provider_ = nullptr;
+  std::unique_ptr<WeightStreaming> weight_streaming_;
+  std::unordered_set<std::string> device_outputs_;
 
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -27,14 +28,23 @@
 
 namespace onnxruntime {
 
+// records a phase of the initialization, see SessionStateInitializer::RecordPhase
+using RecordPhaseFunc =
+    std::function<void(const std::string&, TimePoint&, std::unordered_map<std::string, std::string>&&)>;
+
 // T should have signature of '(int idx, const OrtValue& value, const OrtCallback& d) -> Status'
 template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                              const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                             const ExecutionPlanBase& exec_plan,
+                                             const InitializersToShareMap* initializers_to_share_map,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             concurrency::ThreadPool* thread_pool,
+                                             const Env::FileMappingAdvice& external_data_advice,
+                                             const RecordPhaseFunc& record_phase);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -46,19 +56,63 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
                                                  const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                                  onnxruntime::Graph& graph, SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 const InitializersToShareMap* initializers_to_share_map,
+                                                 profiling::Profiler* profiler,
+                                                 const Env::FileMappingAdvice& external_data_advice)
     : graph_loc_(graph_loc),
       graph_{graph},
       session_state_{session_state},
       execution_providers_{providers},
       kernel_registry_manager_{kernel_registry_manager},
+      initializers_to_share_map_{initializers_to_share_map},
       logger_{session_state.Logger()},
-      enable_mem_pattern_(enable_mem_pattern) {}
+      enable_mem_pattern_(enable_mem_pattern),
+      profiler_(profiler),
+      external_data_advice_(external_data_advice) {}
+
+void SessionStateInitializer::CreateWeightStreaming(size_t buffer_size, SequentialExecutionPlan& exec_plan) {
+  // the shared initializers stay where their owner put them
+  std::unordered_set<std::string> excluded;
+  if (initializers_to_share_map_ != nullptr) {
+    for (const auto& entry : *initializers_to_share_map_) {
+      excluded.insert(entry.first);
+    }
+  }
+
+  for (const auto& provider : execution_providers_) {
+    auto streamer = provider->CreateWeightStreamer(buffer_size);
+    if (streamer == nullptr) {
+      continue;
+    }
+
+    auto weight_streaming = std::make_unique<WeightStreaming>(std::move(streamer));
+    weight_streaming->Plan(*session_state_.GetGraphViewer(), session_state_.GetOrtValueNameIdxMap(), excluded,
+                           exec_plan);
+    LOGS(logger_, INFO) << "Streaming " << weight_streaming->NumStreamedInitializers() << " initializers of "
+                        << provider->Type() << " through a buffer of " << buffer_size << " bytes.";
+    if (weight_streaming->NumStreamedInitializers() != 0) {
+      session_state_.SetWeightStreaming(std::move(weight_streaming));
+    }
+    return;
+  }
+
+  LOGS(logger_, WARNING) << "Weight streaming is disabled: no execution provider supports it.";
+}
+
+void SessionStateInitializer::RecordPhase(const std::string& phase_name, TimePoint& start_time,
+                                          std::unordered_map<std::string, std::string>&& phase_args) const {
+  if (profiler_ != nullptr) {
+    phase_args.emplace("phase", phase_name);
+    phase_args.emplace("graph", graph_.Name());
+    profiler_->RecordInitializationPhase(phase_name, start_time, std::move(phase_args));
+  }
+}
 
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
     const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-    bool enable_sequential_execution) {
+    bool enable_sequential_execution, bool enable_static_memory_planning, size_t weight_streaming_buffer_size) {
   session_state_.SetGraph(graph_);
   const GraphViewer* graph_viewer = session_state_.GetGraphViewer();
 
@@ -77,45 +131,81 @@ common::Status SessionStateInitializer::CreatePlan(
                   });
   }
 
+  TimePoint start_time = std::chrono::high_resolution_clock::now();
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
   SequentialPlannerContext context(!enable_sequential_execution);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_registry_manager_,
                                                     ort_value_name_idx_map, context, exec_plan));
+  if (weight_streaming_buffer_size != 0 && parent_node == nullptr) {
+    if (enable_sequential_execution) {
+      CreateWeightStreaming(weight_streaming_buffer_size, *exec_plan);
+    } else {
+      LOGS(logger_, WARNING) << "Weight streaming is disabled: it needs sequential execution.";
+    }
+  }
   session_state_.SetExecutionPlan(std::move(exec_plan));
+  RecordPhase("execution_planning", start_time);
 
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
+  if (enable_static_memory_planning && session_state_.GetEnableMemoryPattern()) {
+    start_time = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<MemoryPatternGroup> mem_patterns;
+    ORT_RETURN_IF_ERROR(SequentialPlanner::CreateStaticMemoryPattern(*graph_viewer, *exec_plan_ptr,
+                                                                     ort_value_name_idx_map, context, mem_patterns));
+    if (mem_patterns) {
+      session_state_.SetStaticMemoryPatternGroup(std::move(mem_patterns));
+    } else {
+      LOGS(logger_, INFO) << "Not all tensor sizes are known statically. "
+                          << "Memory patterns will be traced from the first Run with each input shape.";
+    }
+    RecordPhase("static_memory_planning", start_time);
+  }
+
   std::unique_ptr<ITensorAllocator> tensor_allocator_(ITensorAllocator::Create(
       enable_mem_pattern_, *exec_plan_ptr, execution_providers_, session_state_.GetMutableWeightsBuffers()));
 
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
+      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, *exec_plan_ptr,
+      initializers_to_share_map_, tensor_allocator_.get(),
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), session_state_.GetThreadPool(), external_data_advice_,
+      [this](const std::string& phase_name, TimePoint& phase_start_time,
+             std::unordered_map<std::string, std::string>&& phase_args) {
+        RecordPhase(phase_name, phase_start_time, std::move(phase_args));
+      }));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
   graph_.CleanAllInitializedTensors();
 
+  start_time = std::chrono::high_resolution_clock::now();
   ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_));
+  RecordPhase("kernel_creation", start_time, {{"nodes", std::to_string(graph_.NumberOfNodes())}});
+
   ORT_RETURN_IF_ERROR(
       SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_, outer_scope_node_args));
   return Status::OK();
 }
 
+// true if the tensors in the location are deserialized directly, see DeserializeTensorProto
+static bool IsCpuLocation(const OrtMemoryInfo& location) {
+  return strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput;
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
                                              const ExecutionProviders& exec_providers, OrtValue& ort_value,
                                              OrtCallback& deleter,
                                              const DataTransferManager& data_transfer_mgr) {
   const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuLocation(alloc_info)) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
   }
@@ -168,55 +258,188 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+// checks that a value passed in SessionOptions::initializers_to_share_map can replace the initializer
+static common::Status CheckInitializerToShare(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtValue& value,
+                                              const OrtMemoryInfo& location) {
+  const std::string& name = tensor_proto.name();
+  if (!value.IsTensor()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The initializer to share ", name, " is not a tensor");
+  }
+
+  const Tensor& tensor = value.Get<Tensor>();
+  if (utils::GetTensorProtoType(tensor) != tensor_proto.data_type()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The initializer to share ", name,
+                           " doesn't have the element type of the initializer in the model");
+  }
+
+  const TensorShape shape(std::vector<int64_t>(tensor_proto.dims().begin(), tensor_proto.dims().end()));
+  if (tensor.Shape() != shape) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The initializer to share ", name, " has shape ",
+                           tensor.Shape(), " instead of ", shape);
+  }
+
+  if (!(tensor.Location().device == location.device)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The initializer to share ", name, " is in ",
+                           tensor.Location().ToString(), ", the session needs it in ", location.ToString());
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const Graph& graph, const ExecutionProviders& exec_providers,
-                                      const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
-                                      const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                      const ExecutionPlanBase& exec_plan,
+                                      const InitializersToShareMap* initializers_to_share_map,
+                                      ITensorAllocator* planner, const T& save_tensor_func,
+                                      const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
+                                      concurrency::ThreadPool* thread_pool,
+                                      const Env::FileMappingAdvice& external_data_advice,
+                                      const RecordPhaseFunc& record_phase) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
+  TimePoint start_time = std::chrono::high_resolution_clock::now();
 
-  //1. first plan the memory
+  //1. first plan the memory, except for the initializers shared with other sessions, which have theirs, and the
+  //   ones used in place in the mapping of their external data
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
+  std::unordered_map<int, std::pair<const std::string*, const OrtValue*>> id_to_shared_initializer;
+  std::unordered_set<int> mapped_initializers;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
+    if (initializers_to_share_map != nullptr) {
+      auto shared = initializers_to_share_map->find(entry.first);
+      if (shared != initializers_to_share_map->end()) {
+        ORT_RETURN_IF_ERROR(CheckInitializerToShare(*entry.second, *shared->second,
+                                                    exec_plan.GetLocation(ort_value_index)));
+        id_to_shared_initializer[ort_value_index] = {&entry.first, shared->second};
+        continue;
+      }
+    }
     id_to_initialized_tensor[ort_value_index] = entry.second;
+    if (IsCpuLocation(exec_plan.GetLocation(ort_value_index)) && utils::IsExternalDataUsedInPlace(*entry.second)) {
+      mapped_initializers.insert(ort_value_index);
+    }
   }
   for (const auto& entry : id_to_initialized_tensor) {
-    ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    if (mapped_initializers.count(entry.first) == 0) {
+      ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    }
   }
 
   //2. allocate weight buffer on different locations
   ORT_RETURN_IF_ERROR(planner->FinalizePlan());
-  OrtCallback deleter;
-  //3. create weight tensors based on weights buffer
+
+  //3. create weight tensors based on weights buffer. the buffers are taken from the planner and the tensors are
+  //   saved on the calling thread, the deserialization and the copies to the devices run on the thread pool.
+  struct Weight {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> m;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  std::vector<Weight> weights(id_to_initialized_tensor.size());
+  size_t num_weights = 0;
   for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
+    auto& weight = weights[num_weights++];
+    weight.ort_value_index = entry.first;
+    weight.tensor_proto = entry.second;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
-    std::unique_ptr<MemBuffer> m;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+    if (mapped_initializers.count(entry.first) != 0) {
+      weight.m = std::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(entry.first));
+    } else {
+      // TODO: if the tensor need be copied, does it have enough room?
+      ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(entry.first, name, weight.m));
+    }
 #ifndef NDEBUG
-    ORT_ENFORCE(m != nullptr);
-    ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+    ORT_ENFORCE(weight.m != nullptr);
+    ORT_ENFORCE(weight.m->GetBuffer() != nullptr || weight.m->GetLen() == 0);
 #endif
-    OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, exec_providers, ort_value, deleter, data_transfer_mgr);
-    if (!st.IsOK()) {
+  }
+  record_phase("initializers_memory_planning", start_time,
+               {{"initializers", std::to_string(id_to_initialized_tensor.size())},
+                {"mapped_initializers", std::to_string(mapped_initializers.size())}});
+
+  start_time = std::chrono::high_resolution_clock::now();
+
+  auto deserialize = [&](int32_t i) {
+    auto& weight = weights[i];
+    try {
+      weight.status = DeserializeTensorProto(env, graph_loc, *weight.tensor_proto, *weight.m, exec_providers,
+                                             weight.ort_value, weight.deleter, data_transfer_mgr);
+      // the data of a mapped initializer is the mapping of its file, read on demand unless advised otherwise
+      if (weight.status.IsOK() && weight.m->GetBuffer() == nullptr && weight.ort_value.IsTensor()) {
+        const auto& tensor = weight.ort_value.Get<Tensor>();
+        env.AdviseFileMapping(tensor.DataRaw(), tensor.SizeInBytes(), external_data_advice);
+      }
+    } catch (const std::exception& ex) {
+      weight.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+
+  if (thread_pool != nullptr && weights.size() > 1) {
+    thread_pool->ParallelFor(static_cast<int32_t>(weights.size()), deserialize);
+  } else {
+    for (size_t i = 0; i < weights.size(); ++i) {
+      deserialize(static_cast<int32_t>(i));
+    }
+  }
+
+  // the initializers and their bytes by the device they are loaded to
+  std::map<std::string, std::pair<size_t, size_t>> loaded_by_location;
+  Status status;
+  for (auto& weight : weights) {
+    if (!status.IsOK()) {
+      // release the weights that won't be saved
+      if (weight.deleter.f != nullptr) {
+        weight.deleter.f(weight.deleter.param);
+      }
+      continue;
+    }
+
+    const char* name = (weight.tensor_proto->name().empty()) ? "" : weight.tensor_proto->name().c_str();
+    if (!weight.status.IsOK()) {
       std::ostringstream oss;
-      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-      return Status(st.Category(), st.Code(), oss.str());
+      oss << "Deserialize tensor " << name << " failed." << weight.status.ErrorMessage();
+      status = Status(weight.status.Category(), weight.status.Code(), oss.str());
+      continue;
     }
 
+    if (weight.ort_value.IsTensor()) {
+      auto& loaded = loaded_by_location[weight.m->GetAllocInfo().name];
+      ++loaded.first;
+      loaded.second += weight.ort_value.Get<Tensor>().SizeInBytes();
+    }
+
+    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
+    status = save_tensor_func(weight.ort_value_index, weight.ort_value, weight.deleter, constant);
+
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << weight.ort_value_index;
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  // the initializers of all the devices are loaded together, so the phase counts those of each
+  std::unordered_map<std::string, std::string> loading_args;
+  for (const auto& entry : loaded_by_location) {
+    loading_args.emplace(entry.first + "_initializers", std::to_string(entry.second.first));
+    loading_args.emplace(entry.first + "_bytes", std::to_string(entry.second.second));
+  }
+  record_phase("initializers_loading", start_time, std::move(loading_args));
+
+  // the shared initializers are owned by the caller, they don't need a deleter
+  for (const auto& entry : id_to_shared_initializer) {
+    const std::string& name = *entry.second.first;
     bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    ORT_RETURN_IF_ERROR(save_tensor_func(entry.first, *entry.second.second, OrtCallback{nullptr, nullptr}, constant));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Shared weight with name : " << name << " with index: " << entry.first;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -3,12 +3,17 @@
 
 #pragma once
 #include <map>
+#include <string>
+#include <unordered_map>
 
 #include "core/common/const_pointer_container.h"
+#include "core/common/profiler.h"
 #include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
 #include "core/framework/path_lib.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/env.h"
 
 namespace onnxruntime {
 class ExecutionProviders;
@@ -19,36 +24,60 @@ class KernelRegistryManager;
 class Node;
 class NodeArg;
 class SessionState;
+struct SequentialExecutionPlan;
 
 namespace logging {
 class Logger;
 }
 
+// initializers of a graph, by name, replaced by values owned by the caller. See SessionOptions.
+using InitializersToShareMap = std::unordered_map<std::string, const OrtValue*>;
+
 // Don't use this class before graph partition is done
 class SessionStateInitializer {
  public:
   /**
    *
    * \param graph_loc The file path of where the graph was loaded. e.g. /tmp/test_squeezenet/model.onnx
+   * \param initializers_to_share_map The initializers that use the given values instead of being deserialized,
+   *                                  nullptr if there are none. The values must outlive the session state.
+   * \param profiler If given, the phases of CreatePlan are recorded as initialization phases.
+   * \param external_data_advice How the initializers used in place in the mapping of their external data are
+   *                             accessed.
    */
   SessionStateInitializer(bool enable_mem_pattern, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                           onnxruntime::Graph& graph, SessionState& session_state, const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager,
+                          const InitializersToShareMap* initializers_to_share_map = nullptr,
+                          profiling::Profiler* profiler = nullptr,
+                          const Env::FileMappingAdvice& external_data_advice = {});
 
   // First perform any transformations and create the execution plan
   // Then initialize tensors, and save. save kernels and input/output node mappings
+  // weight_streaming_buffer_size streams the initializers of the main graph if not 0, see WeightStreaming.
   common::Status CreatePlan(_In_opt_ const Node* parent_node,
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-                            bool enable_sequential_execution);
+                            bool enable_sequential_execution, bool enable_static_memory_planning = false,
+                            size_t weight_streaming_buffer_size = 0);
 
  private:
+  // sets up the weight streaming of the graph with the first provider that supports it, and places the
+  // initializers it streams in host memory in exec_plan.
+  void CreateWeightStreaming(size_t buffer_size, SequentialExecutionPlan& exec_plan);
+
+  void RecordPhase(const std::string& phase_name, TimePoint& start_time,
+                   std::unordered_map<std::string, std::string>&& phase_args = {}) const;
+
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
   onnxruntime::Graph& graph_;
   SessionState& session_state_;
 
   const ExecutionProviders& execution_providers_;
   KernelRegistryManager& kernel_registry_manager_;
+  const InitializersToShareMap* const initializers_to_share_map_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  profiling::Profiler* const profiler_;
+  const Env::FileMappingAdvice external_data_advice_;
 };
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/tensor.h"
 
+#include <cstring>
 #include <utility>
 #include "core/framework/allocatormgr.h"
 using namespace std;
@@ -27,6 +28,13 @@ Tensor::Tensor(MLDataType p_type, const TensorShape& shape, std::shared_ptr<IAll
   Init(p_type, shape, p_data, allocator, offset);
 }
 
+Tensor::Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, std::shared_ptr<IAllocator> deleter,
+               int64_t offset)
+    : alloc_info_(deleter->Info()) {
+  ORT_ENFORCE(p_type != nullptr);
+  Init(p_type, shape, p_data, deleter, offset);
+}
+
 void Tensor::Init(MLDataType p_type, const TensorShape& shape, void* p_raw_data, AllocatorPtr deleter, int64_t offset) {
   int64_t shape_size = shape.Size();
   if (shape_size < 0) ORT_THROW("shape.Size() must >=0");
@@ -53,12 +61,14 @@ Tensor::Tensor(Tensor&& other) noexcept
       shape_(other.shape_),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
-      byte_offset_(other.byte_offset_) {
+      byte_offset_(other.byte_offset_),
+      strides_(std::move(other.strides_)) {
   other.dtype_ = DataTypeImpl::GetType<float>();
   other.shape_ = TensorShape(vector<int64_t>(1, 0));
   other.p_data_ = nullptr;
   other.buffer_deleter_ = nullptr;
   other.byte_offset_ = 0;
+  other.strides_.clear();
 }
 
 Tensor& Tensor::operator=(Tensor&& other) noexcept {
@@ -69,6 +79,7 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     shape_ = other.shape_;
     alloc_info_ = other.alloc_info_;
     byte_offset_ = other.byte_offset_;
+    strides_ = std::move(other.strides_);
     p_data_ = other.p_data_;
     buffer_deleter_ = other.buffer_deleter_;
 
@@ -76,11 +87,89 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     other.shape_ = TensorShape(vector<int64_t>(1, 0));
     other.p_data_ = nullptr;
     other.byte_offset_ = 0;
+    other.strides_.clear();
     other.buffer_deleter_ = nullptr;
   }
   return *this;
 }
 
+static std::vector<int64_t> ContiguousStrides(const TensorShape& shape) {
+  const auto& dims = shape.GetDims();
+  std::vector<int64_t> strides(dims.size(), 1);
+  for (size_t i = dims.size(); i-- > 1;) {
+    strides[i - 1] = strides[i] * dims[i];
+  }
+  return strides;
+}
+
+std::vector<int64_t> Tensor::Strides() const {
+  return IsContiguous() ? ContiguousStrides(shape_) : strides_;
+}
+
+void Tensor::SetStrides(const std::vector<int64_t>& strides) {
+  ORT_ENFORCE(strides.size() == shape_.NumDimensions(), "Expected ", shape_.NumDimensions(), " strides, got ",
+              strides.size());
+  // the strides of dimensions of size 1 are never used, so they don't make a view non-contiguous
+  const auto contiguous = ContiguousStrides(shape_);
+  bool is_contiguous = true;
+  for (size_t i = 0; i < strides.size(); ++i) {
+    is_contiguous = is_contiguous && (shape_[i] == 1 || strides[i] == contiguous[i]);
+  }
+  if (is_contiguous) {
+    strides_.clear();
+  } else {
+    strides_ = strides;
+  }
+}
+
+void CopyToContiguous(const Tensor& src, Tensor& dst) {
+  ORT_ENFORCE(src.DataType() == dst.DataType() && src.Shape() == dst.Shape() && dst.IsContiguous(),
+              "The copy of a tensor must be contiguous, with its type and shape");
+  const int64_t size = src.Shape().Size();
+  if (size == 0) return;
+
+  const auto& dims = src.Shape().GetDims();
+  const size_t rank = dims.size();
+  const auto strides = src.Strides();
+  const auto element_size = static_cast<int64_t>(src.DataType()->Size());
+  const bool is_string = src.DataType() == DataTypeImpl::GetType<string>();
+  const char* source = static_cast<const char*>(src.DataRaw()) + src.ByteOffset();
+  char* target = static_cast<char*>(dst.MutableDataRaw()) + dst.ByteOffset();
+
+  // copy a row of the innermost dimension at a time, as one block if its elements are next to each other
+  const int64_t row_size = rank > 0 ? dims[rank - 1] : 1;
+  const int64_t row_stride = rank > 0 ? strides[rank - 1] : 1;
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t copied = 0; copied < size; copied += row_size) {
+    int64_t offset = 0;
+    for (size_t i = 0; i + 1 < rank; ++i) {
+      offset += index[i] * strides[i];
+    }
+
+    if (is_string) {
+      const auto* row = reinterpret_cast<const string*>(source) + offset;
+      auto* out = reinterpret_cast<string*>(target);
+      for (int64_t j = 0; j < row_size; ++j) {
+        out[j] = row[j * row_stride];
+      }
+    } else if (row_stride == 1) {
+      memcpy(target, source + offset * element_size, static_cast<size_t>(row_size * element_size));
+    } else {
+      for (int64_t j = 0; j < row_size; ++j) {
+        memcpy(target + j * element_size, source + (offset + j * row_stride) * element_size,
+               static_cast<size_t>(element_size));
+      }
+    }
+    target += row_size * element_size;
+
+    // next row: increment the index of the outer dimensions
+    for (size_t i = rank; i-- > 1;) {
+      if (++index[i - 1] < dims[i - 1]) break;
+      index[i - 1] = 0;
+    }
+  }
+}
+
 Tensor::~Tensor() {
   ReleaseBuffer();
 }
@@ -360,6 +360,22 @@ static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   from.param = nullptr;
 }
 
+bool IsExternalDataUsedInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (!IsLittleEndianOrder() || tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    return false;
+  }
+
+  // the file is mapped from the start of a page
+  const size_t element_size = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType()->Size();
+  return external_data_info->GetOffset() % element_size == 0;
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, OrtValue& value,
                             OrtCallback& deleter) {
@@ -400,7 +416,8 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       raw_data = tensor_proto.raw_data().data();
       raw_data_len = tensor_proto.raw_data().size();
     }
-    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr) {
+    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr &&
+        reinterpret_cast<uintptr_t>(raw_data) % type->Size() == 0) {
       tensor_data = const_cast<void*>(raw_data);
       MoveOrtCallback(deleter_for_file_data.d, deleter);
     } else {
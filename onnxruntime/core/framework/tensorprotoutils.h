@@ -30,10 +30,16 @@ TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShape
  * \param tensor_proto_path A local file path of where the 'input' was loaded from. Can be NULL if the tensor proto doesn't
  *                        have any external data or it was loaded from current working dir. This path could be either a
  *                        relative path or an absolute path.
+ * The external data of the tensors for which IsExternalDataUsedInPlace is true isn't copied: the tensor uses the
+ * read-only mapping of the file, released by the deleter, and m may be empty.
  */
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
+
+// True if the tensor has external data that TensorProtoToMLValue maps from its file and uses in place on CPU,
+// which needs the data to be little-endian and aligned on its elements in the file
+bool IsExternalDataUsedInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto);
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
@@ -172,6 +178,10 @@ inline bool HasTensors(const ONNX_NAMESPACE::AttributeProto& at_proto) {
   return at_proto.type() == ONNX_NAMESPACE::AttributeProto::AttributeType::AttributeProto_AttributeType_TENSORS;
 }
 
+inline bool HasSparseTensor(const ONNX_NAMESPACE::AttributeProto& at_proto) {
+  return at_proto.type() == ONNX_NAMESPACE::AttributeProto::AttributeType::AttributeProto_AttributeType_SPARSE_TENSOR;
+}
+
 inline bool HasGraph(const ONNX_NAMESPACE::AttributeProto& at_proto) {
   return at_proto.type() == ONNX_NAMESPACE::AttributeProto::AttributeType::AttributeProto_AttributeType_GRAPH;
 }
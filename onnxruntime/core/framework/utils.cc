@@ -8,6 +8,7 @@
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/execution_pipeline.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_def_builder.h"
@@ -124,7 +125,7 @@ static Status CopyMLValue(const DataTransferManager& data_transfer_mgr,
   return Status::OK();
 }
 
-static bool HaveCpuExecutionProvidersOnly(const ExecutionProviders& execution_providers) {
+bool HaveCpuExecutionProvidersOnly(const ExecutionProviders& execution_providers) {
   for (const auto& execution_provider : execution_providers) {
     if (!ProviderIsCpuBased(execution_provider->Type())) {
       return false;
@@ -322,10 +323,15 @@ static void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
   // create default instances if needed
   fetches.resize(num_outputs);
 
+  const auto& output_names = feeds_fetches_manager.GetFeedsFetchesInfo().output_names;
+
   for (size_t i = 0; i < num_outputs; ++i) {
     const auto& fetch = fetches[i];
     if (fetch.IsAllocated() && fetch.IsTensor()) {
       fetch_alloc_info[i] = &fetch.Get<Tensor>().Location();
+    } else if (session_state.IsDeviceOutput(output_names[i])) {
+      // returned where the plan places it, so it isn't copied
+      fetch_alloc_info[i] = &FindMemoryInfoForValue(session_state, output_names[i]);
     }
   }
 
@@ -386,25 +392,17 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        const FeedsFetchesManager& feeds_fetches_manager,
                                        const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                                       bool sequential_execution, const bool& terminate_flag,
-                                       const logging::Logger& logger) {
-  std::unique_ptr<IExecutor> p_exec;
-  if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
-  } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
-  }
-
+                                       IExecutor& executor, const logging::Logger& logger) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   const auto& device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 
   // see if we can skip copies due to the types of execution providers available
   if (device_copy_checks.status == DeviceCopyCheck::NoCopy) {
     // no device copies are needed so simple execute
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(executor.Execute(session_state,
+                                         feeds_fetches_info.feeds_mlvalue_idxs, feeds,
+                                         feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
+                                         logger));
   } else {
     const std::vector<OrtValue>* p_feeds = &feeds;
     std::vector<OrtValue>* p_fetches = &fetches;
@@ -437,10 +435,10 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
       p_fetches = &device_fetches;
     }
 
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(executor.Execute(session_state,
+                                         feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
+                                         feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
+                                         logger));
 
     if (device_copy_checks.output_copy_needed == DeviceCopyCheck::Copy) {
       ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, fetch_copy_info));
@@ -450,28 +448,100 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
   return Status::OK();
 }
 
+static common::Status ExecuteGraphImpl(const SessionState& session_state,
+                                       const FeedsFetchesManager& feeds_fetches_manager,
+                                       const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                       bool sequential_execution, const bool& terminate_flag,
+                                       const logging::Logger& logger,
+                                       std::unique_ptr<ExecutionFrame>* cached_frame,
+                                       concurrency::ThreadPool* thread_pool) {
+  if (sequential_execution) {
+    if (cached_frame != nullptr) {
+      SequentialExecutor executor(terminate_flag, *cached_frame, thread_pool);
+      return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators, executor,
+                              logger);
+    }
+
+    SequentialExecutor executor(terminate_flag, thread_pool);
+    return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators, executor, logger);
+  }
+
+  ParallelExecutor executor(session_state, terminate_flag, thread_pool);
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators, executor, logger);
+}
+
+static common::Status PrepareFeedFetchCopyInfo(const SessionState& session_state,
+                                               FeedsFetchesManager& feeds_fetches_manager,
+                                               const std::vector<OrtValue>& feeds,
+                                               std::vector<OrtValue>& fetches) {
+  // a manager reused from an earlier execution already has the copy info
+  if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::Unknown) {
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  }
+
+  // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
+  FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches);
+  return Status::OK();
+}
+
+static common::Status FinalizeAndExecuteGraph(
+    const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
+    const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+    bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger,
+    std::unique_ptr<ExecutionFrame>* cached_frame, concurrency::ThreadPool* thread_pool) {
+  ORT_RETURN_IF_ERROR(PrepareFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches));
+
+  auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                 sequential_execution, terminate_flag, logger, cached_frame, thread_pool);
+
+  return status;
+}
+
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                             bool sequential_execution, const bool& terminate_flag,
-                            const logging::Logger& logger) {
-  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+                            const logging::Logger& logger, std::unique_ptr<ExecutionFrame>* cached_frame,
+                            concurrency::ThreadPool* thread_pool) {
+  return FinalizeAndExecuteGraph(session_state, feeds_fetches_manager, feeds, fetches, {}, sequential_execution,
+                                 terminate_flag, logger, cached_frame, thread_pool);
+}
 
-  // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
-  FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches);
+common::Status ExecuteGraph(const SessionState& session_state,
+                            FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution, const bool& terminate_flag,
+                            const logging::Logger& logger, concurrency::ThreadPool* thread_pool) {
+  return FinalizeAndExecuteGraph(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                 sequential_execution, terminate_flag, logger, nullptr, thread_pool);
+}
 
-  auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
-                                 sequential_execution, terminate_flag, logger);
+common::Status ExecuteGraphWithPipeline(const SessionState& session_state,
+                                        FeedsFetchesManager& feeds_fetches_manager,
+                                        const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                        ExecutionPipeline& pipeline, const bool& terminate_flag,
+                                        const logging::Logger& logger) {
+  ORT_RETURN_IF_ERROR(PrepareFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches));
 
-  return status;
+  PipelineExecutor executor(pipeline, terminate_flag);
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {}, executor, logger);
 }
 
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger) {
+                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger,
+                               std::unique_ptr<ExecutionFrame>* cached_frame, concurrency::ThreadPool* thread_pool) {
+  // the first execution of a loop may allocate its outputs with fetch_allocators, which a cached frame can't hold
+  if (!fetch_allocators.empty()) {
+    cached_frame = nullptr;
+  }
+
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 sequential_execution, terminate_flag, logger);
+                                 sequential_execution, terminate_flag, logger, cached_frame, thread_pool);
   return status;
 }
 
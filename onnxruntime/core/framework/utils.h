@@ -11,6 +11,8 @@
 #include "core/framework/session_state.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+class ExecutionPipeline;
 class ExecutionProviders;
 struct FeedsFetchesInfo;
 class FeedsFetchesManager;
@@ -57,17 +59,47 @@ void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
                                const std::vector<OrtDevice>& feed_locations,
                                const std::vector<const OrtMemoryInfo*>& fetch_alloc_info);
 
+// Returns true if all the execution providers are CPU based, so no copies of the feeds and fetches are needed.
+bool HaveCpuExecutionProvidersOnly(const ExecutionProviders& execution_providers);
+
 // Execute the main graph. The feed_fetches_manager will be finalized based on the provided feeds and fetches.
+// A feed_fetches_manager that was used before keeps the copy info of its first execution when no copies were needed.
+// With sequential execution, a frame held by cached_frame is reused, else the frame that is created is left in it.
+// See SequentialExecutor.
+// The kernels run their parallel loops on thread_pool, or on the thread pool of the session state if it's nullptr.
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                            bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
+                            bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger,
+                            std::unique_ptr<ExecutionFrame>* cached_frame = nullptr,
+                            concurrency::ThreadPool* thread_pool = nullptr);
+
+// Execute the main graph as above, allocating the fetches of fetch_allocators with them. The index of a fetch is
+// the key of its allocator. A frame can't be cached with custom allocators, so there is no cached_frame.
+common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger,
+                            concurrency::ThreadPool* thread_pool = nullptr);
+
+// Execute the main graph through the stages of pipeline, which must run the plan of session_state.
+// The feed_fetches_manager is finalized as in ExecuteGraph.
+common::Status ExecuteGraphWithPipeline(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
+                                        const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                        ExecutionPipeline& pipeline, const bool& terminate_flag,
+                                        const logging::Logger& logger);
 
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
+// The control flow kernels that run the subgraph repeatedly pass a cached_frame, which is reused by the executions
+// without fetch_allocators as in ExecuteGraph, so that the values of the subgraph and its memory pattern are set up
+// once per loop rather than once per iteration.
+// thread_pool is the one of the parent graph's execution, see ExecuteGraph.
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
+                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger,
+                               std::unique_ptr<ExecutionFrame>* cached_frame = nullptr,
+                               concurrency::ThreadPool* thread_pool = nullptr);
 
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 // to create a build with these enabled run the build script with
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/weight_streaming.h"
+
+#include <algorithm>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/session_state.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+// the alignment of the copies in the buffer, enough for the vectorized loads of the kernels
+constexpr size_t kCopyAlignment = 256;
+
+size_t AlignedSize(size_t bytes) {
+  return (bytes + kCopyAlignment - 1) / kCopyAlignment * kCopyAlignment;
+}
+}  // namespace
+
+WeightStreaming::WeightStreaming(std::unique_ptr<IWeightStreamer> streamer) : streamer_(std::move(streamer)) {}
+
+void WeightStreaming::Plan(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                           const std::unordered_set<std::string>& excluded, SequentialExecutionPlan& plan) {
+  // the outputs and the values the subgraphs read are used outside of the steps that read them
+  std::unordered_set<std::string> not_streamed = excluded;
+  for (const auto* output : graph_viewer.GetOutputs()) {
+    not_streamed.insert(output->Name());
+  }
+  for (const auto& node : graph_viewer.Nodes()) {
+    for (const auto* input : node.ImplicitInputDefs()) {
+      not_streamed.insert(input->Name());
+    }
+  }
+
+  const auto& initializers = graph_viewer.GetAllInitializedTensors();
+  std::unordered_set<int> streamed;
+  steps_.clear();
+  steps_.reserve(plan.execution_plan.size());
+  for (const auto& node_plan : plan.execution_plan) {
+    StepInputs step{node_plan.node_index, {}};
+    const auto& input_defs = graph_viewer.GetNode(node_plan.node_index)->InputDefs();
+    for (size_t i = 0; i < input_defs.size(); ++i) {
+      const auto& name = input_defs[i]->Name();
+      int idx;
+      if (!input_defs[i]->Exists() || initializers.count(name) == 0 || not_streamed.count(name) != 0 ||
+          !ort_value_name_idx_map.GetIdx(name, idx).IsOK() ||
+          plan.allocation_plan[idx].location != streamer_->BufferLocation()) {
+        continue;
+      }
+
+      // a node reading an initializer more than once gets a single copy
+      const bool copied = std::any_of(step.inputs.cbegin(), step.inputs.cend(),
+                                      [idx](const StreamedInput& input) { return input.ort_value_idx == idx; });
+      if (!copied) {
+        step.inputs.push_back({idx, static_cast<int>(i)});
+        streamed.insert(idx);
+      }
+    }
+    steps_.push_back(std::move(step));
+  }
+
+  for (int idx : streamed) {
+    plan.allocation_plan[idx].location = streamer_->HostLocation();
+  }
+  num_streamed_ = streamed.size();
+}
+
+std::unique_lock<OrtMutex> WeightStreaming::BeginRun() {
+  std::unique_lock<OrtMutex> lock(run_mutex_);
+
+  // a Run that failed may have left copies it didn't use, which the work it queued is done with as well
+  for (auto& copy : copies_) {
+    if (!copy.used) {
+      ORT_THROW_IF_ERROR(streamer_->RecordUse(copy.slot));
+      copy.used = true;
+    }
+  }
+  next_step_ = 0;
+  return lock;
+}
+
+WeightStreaming::Copy* WeightStreaming::FindCopy(size_t step) {
+  auto it = std::find_if(copies_.begin(), copies_.end(),
+                         [step](const Copy& copy) { return copy.step == step && !copy.used; });
+  return it != copies_.end() ? &*it : nullptr;
+}
+
+Status WeightStreaming::CopyStep(const SessionState& session_state, size_t step, bool& started) {
+  const auto& initializers = session_state.GetInitializedTensors();
+  const auto& inputs = steps_[step].inputs;
+
+  size_t bytes = 0;
+  for (const auto& input : inputs) {
+    bytes += AlignedSize(initializers.at(input.ort_value_idx).Get<Tensor>().SizeInBytes());
+  }
+  if (bytes > streamer_->BufferSize()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The initializers of node ",
+                           session_state.GetGraphViewer()->GetNode(steps_[step].node_index)->Name(), " need ", bytes,
+                           " bytes, more than the weight streaming buffer of ", streamer_->BufferSize(), " bytes.");
+  }
+
+  // the copies the new one overwrites must be used. as the compute queue runs in order, the copy queue only waits
+  // for the use of the last of them.
+  const size_t offset = head_ + bytes <= streamer_->BufferSize() ? head_ : 0;
+  size_t overwritten = 0;
+  for (size_t i = 0; i < copies_.size(); ++i) {
+    const auto& copy = copies_[i];
+    if (copy.offset < offset + bytes && offset < copy.offset + copy.bytes) {
+      if (!copy.used) {
+        started = false;
+        return Status::OK();
+      }
+      overwritten = i + 1;
+    }
+  }
+  for (size_t i = 0; i < overwritten; ++i) {
+    if (i + 1 == overwritten) {
+      ORT_RETURN_IF_ERROR(streamer_->WaitForUse(copies_.front().slot));
+    }
+    free_slots_.push_back(copies_.front().slot);
+    copies_.pop_front();
+  }
+
+  Copy copy{step, offset, bytes, -1, false, {}};
+  if (free_slots_.empty()) {
+    copy.slot = num_slots_++;
+  } else {
+    copy.slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+
+  auto* buffer = static_cast<char*>(streamer_->Buffer());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  size_t input_offset = offset;
+  for (const auto& input : inputs) {
+    const auto& src = initializers.at(input.ort_value_idx).Get<Tensor>();
+    auto dst = std::make_unique<Tensor>(src.DataType(), src.Shape(), buffer + input_offset,
+                                        streamer_->BufferLocation());
+    ORT_RETURN_IF_ERROR(streamer_->CopyAsync(src, *dst));
+    input_offset += AlignedSize(src.SizeInBytes());
+
+    OrtValue value;
+    value.Init(dst.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+    copy.values.push_back(std::move(value));
+  }
+  ORT_RETURN_IF_ERROR(streamer_->RecordCopies(copy.slot));
+
+  copies_.push_back(std::move(copy));
+  head_ = offset + bytes;
+  started = true;
+  return Status::OK();
+}
+
+Status WeightStreaming::BeginStep(const SessionState& session_state, size_t step, ExecutionFrame& frame) {
+  if (steps_[step].inputs.empty()) {
+    return Status::OK();
+  }
+
+  // copy the inputs of the step if they aren't yet, then the ones of the next steps while there is room
+  for (; next_step_ < steps_.size(); ++next_step_) {
+    if (steps_[next_step_].inputs.empty()) {
+      continue;
+    }
+
+    bool started = false;
+    ORT_RETURN_IF_ERROR(CopyStep(session_state, next_step_, started));
+    if (!started) {
+      // only copies of later steps aren't used yet, so the inputs of this step are copied already
+      ORT_ENFORCE(next_step_ > step, "The inputs of step ", step, " weren't copied.");
+      break;
+    }
+  }
+
+  Copy* copy = FindCopy(step);
+  ORT_ENFORCE(copy != nullptr, "The inputs of step ", step, " weren't copied.");
+  ORT_RETURN_IF_ERROR(streamer_->WaitForCopies(copy->slot));
+
+  const int node_offset = frame.GetNodeOffset(steps_[step].node_index);
+  const auto& inputs = steps_[step].inputs;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    *frame.GetMutableNodeInputOrOutputMLValue(node_offset + inputs[i].input_index) = copy->values[i];
+  }
+  return Status::OK();
+}
+
+Status WeightStreaming::EndStep(const SessionState& session_state, size_t step, ExecutionFrame& frame) {
+  if (steps_[step].inputs.empty()) {
+    return Status::OK();
+  }
+
+  Copy* copy = FindCopy(step);
+  ORT_ENFORCE(copy != nullptr, "The inputs of step ", step, " weren't copied.");
+  ORT_RETURN_IF_ERROR(streamer_->RecordUse(copy->slot));
+  copy->used = true;
+
+  const auto& initializers = session_state.GetInitializedTensors();
+  const int node_offset = frame.GetNodeOffset(steps_[step].node_index);
+  for (const auto& input : steps_[step].inputs) {
+    *frame.GetMutableNodeInputOrOutputMLValue(node_offset + input.input_index) =
+        initializers.at(input.ort_value_idx);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
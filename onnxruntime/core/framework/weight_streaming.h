@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class ExecutionFrame;
+class GraphViewer;
+class OrtValueNameIdxMap;
+class SessionState;
+struct SequentialExecutionPlan;
+
+/**
+The device side of weight streaming, implemented by the execution providers that support it.
+See IExecutionProvider::CreateWeightStreamer.
+The copies run on a queue of their own, so they overlap the kernels running on the compute queue. Each slot has an
+event for the copies of one step of the execution plan, and one for the kernels of the step that read them.
+*/
+class IWeightStreamer {
+ public:
+  virtual ~IWeightStreamer() = default;
+
+  // the memory the streamed initializers are kept in, which the device copies them from asynchronously.
+  virtual const OrtMemoryInfo& HostLocation() const = 0;
+
+  // the device buffer the initializers are copied into in turn, in the memory the kernels read them from.
+  virtual void* Buffer() const = 0;
+  virtual size_t BufferSize() const = 0;
+  virtual const OrtMemoryInfo& BufferLocation() const = 0;
+
+  // Start copying src, in HostLocation, into dst, in the buffer, on the copy queue.
+  virtual common::Status CopyAsync(const Tensor& src, Tensor& dst) = 0;
+
+  // Record the copies started so far in the copy event of slot.
+  virtual common::Status RecordCopies(int slot) = 0;
+  // Make the work queued on the compute queue from now on wait for the copy event of slot.
+  virtual common::Status WaitForCopies(int slot) = 0;
+
+  // Record the work queued so far on the compute queue in the use event of slot.
+  virtual common::Status RecordUse(int slot) = 0;
+  // Make the copies started from now on wait for the use event of slot.
+  virtual common::Status WaitForUse(int slot) = 0;
+};
+
+/**
+Runs models whose initializers don't fit in the memory of the device. The initializers the nodes of a provider read
+from its device memory are kept in host memory instead, and the sequential executor copies the ones of each node
+into a device buffer while the nodes before it compute. The copies rotate through the buffer, so it only needs to
+hold the initializers of the node reading the most of them, and the larger it is the further ahead they are copied.
+See SessionOptions::weight_streaming_buffer_size.
+*/
+class WeightStreaming {
+ public:
+  explicit WeightStreaming(std::unique_ptr<IWeightStreamer> streamer);
+
+  /**
+  Select the initializers to stream, the explicit inputs of the nodes that the plan places in the memory of the
+  buffer, and place them in the host location of the streamer instead.
+  @param excluded the initializers that stay where the plan placed them.
+  */
+  void Plan(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+            const std::unordered_set<std::string>& excluded, SequentialExecutionPlan& plan);
+
+  size_t NumStreamedInitializers() const { return num_streamed_; }
+
+  // Start a Run. The Runs take turns while they hold the returned lock, as they share the buffer.
+  std::unique_lock<OrtMutex> BeginRun();
+
+  // Set the streamed inputs of the node of step in frame to their copies in the buffer, starting the copies
+  // of the next steps as far as the buffer has room.
+  common::Status BeginStep(const SessionState& session_state, size_t step, ExecutionFrame& frame);
+
+  // Once the kernel of step is queued, let the copies of later steps overwrite its inputs, and set them back to
+  // the initializers in frame.
+  common::Status EndStep(const SessionState& session_state, size_t step, ExecutionFrame& frame);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WeightStreaming);
+
+  struct StreamedInput {
+    int ort_value_idx;
+    // the index of the input in the frame, relative to the offset of the node
+    int input_index;
+  };
+
+  struct StepInputs {
+    NodeIndex node_index;
+    std::vector<StreamedInput> inputs;
+  };
+
+  // the copies of the inputs of a step in the buffer
+  struct Copy {
+    size_t step;
+    size_t offset;
+    size_t bytes;
+    int slot;
+    // whether the kernel of the step is queued, so the copy may be overwritten
+    bool used;
+    std::vector<OrtValue> values;
+  };
+
+  // starts copying the inputs of step, unless they would overwrite copies not used yet.
+  common::Status CopyStep(const SessionState& session_state, size_t step, bool& started);
+
+  Copy* FindCopy(size_t step);
+
+  std::unique_ptr<IWeightStreamer> streamer_;
+  std::vector<StepInputs> steps_;
+  size_t num_streamed_ = 0;
+
+  OrtMutex run_mutex_;
+  // the copies in the buffer, oldest first. Only the Run holding run_mutex_ uses the members below.
+  std::deque<Copy> copies_;
+  // the end of the newest copy in the buffer
+  size_t head_ = 0;
+  // the next step whose inputs to copy
+  size_t next_step_ = 0;
+  std::vector<int> free_slots_;
+  int num_slots_ = 0;
+};
+
+}  // namespace onnxruntime
@@ -41,6 +41,47 @@ void RegisterAutoMLSchemas() {
           "Constrain output type to an AutoML specific Microsoft::Featurizers::TimePoint type"
           "currently not part of ONNX standard. When it becomes a part of the standard we will adjust this"
           "kernel definition and move it to ONNX repo");
+
+  static const char* DateTimeBatchTransformer_ver1_doc = R"DOC(
+    DateTimeBatchTransformer splits each timestamp of an int64 tensor, in seconds since the epoch (UTC),
+    into the components of Microsoft::DateTimeFeaturizer::TimePoint, with one output tensor per component
+    of the shape of the input. The whole tensor is converted at once, in parallel, without creating a
+    TimePoint per timestamp.
+  )DOC";
+
+  MS_AUTOML_OPERATOR_SCHEMA(DateTimeBatchTransformer)
+      .SinceVersion(1)
+      .SetDomain(kMSAutoMLDomain)
+      .SetDoc(DateTimeBatchTransformer_ver1_doc)
+      .Input(0, "X", "The timestamps, in seconds since the epoch.", "T1")
+      .Output(0, "year", "The years.", "tensor(int32)")
+      .Output(1, "month", "The months, 1-12.", "tensor(uint8)")
+      .Output(2, "day", "The days of the month, 1-31.", "tensor(uint8)")
+      .Output(3, "hour", "The hours, 0-23.", "tensor(uint8)")
+      .Output(4, "minute", "The minutes, 0-59.", "tensor(uint8)")
+      .Output(5, "second", "The seconds, 0-59.", "tensor(uint8)")
+      .Output(6, "day_of_week", "The days of the week, 0-6 from Sunday.", "tensor(uint8)")
+      .Output(7, "day_of_year", "The days of the year, 0-365.", "tensor(uint16)")
+      .Output(8, "quarter_of_year", "The quarters of the year, 1-4.", "tensor(uint8)")
+      .Output(9, "week_of_month", "The weeks of the month, 0-4.", "tensor(uint8)")
+      .TypeConstraint(
+          "T1",
+          {"tensor(int64)"},
+          "Constrain input type to int64 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        const ONNX_NAMESPACE::TensorProto_DataType types[] = {
+            ONNX_NAMESPACE::TensorProto_DataType_INT32, ONNX_NAMESPACE::TensorProto_DataType_UINT8,
+            ONNX_NAMESPACE::TensorProto_DataType_UINT8, ONNX_NAMESPACE::TensorProto_DataType_UINT8,
+            ONNX_NAMESPACE::TensorProto_DataType_UINT8, ONNX_NAMESPACE::TensorProto_DataType_UINT8,
+            ONNX_NAMESPACE::TensorProto_DataType_UINT8, ONNX_NAMESPACE::TensorProto_DataType_UINT16,
+            ONNX_NAMESPACE::TensorProto_DataType_UINT8, ONNX_NAMESPACE::TensorProto_DataType_UINT8};
+        for (size_t i = 0; i < ctx.getNumOutputs(); ++i) {
+          ONNX_NAMESPACE::updateOutputElemType(ctx, i, types[i]);
+          if (ONNX_NAMESPACE::hasInputShape(ctx, 0)) {
+            ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, 0, i);
+          }
+        }
+      });
 }
 }  // namespace automl
 }  // namespace onnxruntime
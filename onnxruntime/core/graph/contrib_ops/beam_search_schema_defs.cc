@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "beam_search_schema_defs.h"
+
+#include <vector>
+
+#include "core/graph/constants.h"
+#include "core/graph/op.h"
+#include "onnx/defs/shape_inference.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using ::ONNX_NAMESPACE::AttributeProto;
+using ::ONNX_NAMESPACE::InferenceContext;
+using ::ONNX_NAMESPACE::OpSchema;
+using ::ONNX_NAMESPACE::TensorProto;
+using ::ONNX_NAMESPACE::TensorShapeProto;
+using ::ONNX_NAMESPACE::TypeProto;
+
+static const char* BeamSearch_ver1_doc = R"DOC(
+Generates sequences from input_ids with a beam search over the decoder subgraph, which runs once per generated token.
+
+The decoder has the inputs input_ids, position_ids and attention_mask, all int32 tensors shaped
+`[batch_size, sequence_length]` except attention_mask shaped `[batch_size, total_sequence_length]`, followed by the
+past state of each layer, shaped `[2, batch_size, num_heads, past_sequence_length, head_size]`.
+It has the outputs logits, shaped `[batch_size, sequence_length, vocab_size]`, and the present state of each layer,
+shaped `[2, batch_size, num_heads, total_sequence_length, head_size]`.
+The first step runs on input_ids with an empty past state. Each following step runs on the tokens chosen by the
+previous step, with the present state of the beams they extend as the past state.
+The tokens of input_ids equal to pad_token_id are masked out by attention_mask.
+)DOC";
+
+static const char* GreedySearch_ver1_doc = R"DOC(
+Generates sequences from input_ids by picking the token of the highest logit at each step of the decoder subgraph,
+which is shaped as in BeamSearch. The present state of a step is the past state of the next one.
+)DOC";
+
+// runs the inference of the decoder subgraph on the types it declares, and infers the rank and batch size of the
+// outputs of the sequences and their scores
+static void SequenceGenerationShapeInference(InferenceContext& ctx, int sequences_rank) {
+  const auto* decoder = ctx.getAttribute("decoder");
+  if (decoder == nullptr || !decoder->has_g()) {
+    fail_type_inference("The decoder attribute is required.");
+  }
+
+  auto* graph_inferencer = ctx.getGraphAttributeInferencer("decoder");
+  if (graph_inferencer != nullptr) {
+    std::vector<const TypeProto*> subgraph_input_types;
+    for (const auto& input : decoder->g().input()) {
+      subgraph_input_types.push_back(&input.type());
+    }
+    std::vector<const TensorProto*> input_data(subgraph_input_types.size(), nullptr);
+    graph_inferencer->doInferencing(subgraph_input_types, input_data);
+  }
+
+  TensorShapeProto::Dimension batch_size;
+  if (hasInputShape(ctx, 0)) {
+    auto& input_ids_shape = getInputShape(ctx, 0);
+    if (input_ids_shape.dim_size() != 2) {
+      fail_shape_inference("input_ids must have rank 2");
+    }
+    batch_size = input_ids_shape.dim(0);
+  }
+
+  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  auto* sequences_shape = getOutputShape(ctx, 0);
+  *sequences_shape->add_dim() = batch_size;
+  for (int i = 1; i < sequences_rank; ++i) {
+    sequences_shape->add_dim();
+  }
+
+  if (ctx.getNumOutputs() > 1) {
+    updateOutputElemType(ctx, 1, TensorProto::FLOAT);
+    auto* scores_shape = getOutputShape(ctx, 1);
+    *scores_shape->add_dim() = batch_size;
+    scores_shape->add_dim();
+  }
+}
+
+// the attributes and the inputs shared by the sequence generation operators
+static OpSchema& SequenceGenerationCommon(OpSchema& op_schema) {
+  return op_schema
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr("eos_token_id", "The id of the token that ends a sequence.", AttributeProto::INT)
+      .Attr("pad_token_id", "The id of the token that pads the sequences after their end.", AttributeProto::INT)
+      .Attr("decoder", "The decoder subgraph run once per generated token.", AttributeProto::GRAPH)
+      .Input(0, "input_ids", "The tokens the sequences start with, shaped `[batch_size, sequence_length]`.", "I")
+      .Input(1, "max_length", "The length of the generated sequences, including input_ids. Shape is `[1]`.", "I")
+      .Input(2, "min_length",
+             "The length under which eos_token_id can't end a sequence. Shape is `[1]`. Defaults to 0.",
+             "I", OpSchema::Optional)
+      .TypeConstraint("I", {"tensor(int32)"}, "Constrain the token ids and lengths to int32 tensors.");
+}
+
+OpSchema& RegisterBeamSearchOpSchema(OpSchema&& op_schema) {
+  return SequenceGenerationCommon(op_schema)
+      .Attr("early_stopping",
+            "If 1, the search of a batch entry ends once num_beams sequences are finished, otherwise once none of "
+            "the beams can score above the finished ones.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(3, "num_beams", "The number of beams of each batch entry, at least 2. Shape is `[1]`.", "I")
+      .Input(4, "num_return_sequences",
+             "The number of sequences returned for each batch entry, at most num_beams. Shape is `[1]`.", "I")
+      .Input(5, "length_penalty",
+             "The exponent of the sequence length the score of a finished sequence is divided by. Shape is `[1]`. "
+             "Defaults to 1.",
+             "T", OpSchema::Optional)
+      .Output(0, "sequences",
+              "The generated sequences padded with pad_token_id, best first, shaped "
+              "`[batch_size, num_return_sequences, max_length]`.",
+              "I")
+      .Output(1, "sequences_scores",
+              "The scores of the generated sequences, shaped `[batch_size, num_return_sequences]`.",
+              "T", OpSchema::Optional)
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the scores to float tensors.")
+      .SetDoc(BeamSearch_ver1_doc)
+      .TypeAndShapeInferenceFunction([](InferenceContext& ctx) { SequenceGenerationShapeInference(ctx, 3); });
+}
+
+OpSchema& RegisterGreedySearchOpSchema(OpSchema&& op_schema) {
+  return SequenceGenerationCommon(op_schema)
+      .Output(0, "sequences",
+              "The generated sequences padded with pad_token_id, shaped `[batch_size, max_length]`.", "I")
+      .SetDoc(GreedySearch_ver1_doc)
+      .TypeAndShapeInferenceFunction([](InferenceContext& ctx) { SequenceGenerationShapeInference(ctx, 2); });
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -4,7 +4,9 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/attn_lstm_schema_defs.h"
+#include "core/graph/contrib_ops/beam_search_schema_defs.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
+#include "core/graph/contrib_ops/quantized_rnn_schema_defs.h"
 #include "core/graph/contrib_ops/range_schema_defs.h"
 #include "core/graph/op.h"
 #include "onnx/defs/schema.h"
@@ -65,6 +67,170 @@ void NchwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
   });
 }
 
+// Infers the shape of an NHWC pooling output, where the channels are the last dimension of the input.
+void NhwcPoolShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool global_pooling) {
+  ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasNInputShapes(ctx, 1)) {
+    return;
+  }
+
+  const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+  const int rank = input_shape.dim_size();
+  if (rank < 3) {
+    fail_shape_inference("Input tensor must have at least 3 dimensions");
+  }
+  const int spatial_rank = rank - 2;
+
+  std::vector<int64_t> kernel_shape;
+  std::vector<int64_t> strides;
+  std::vector<int64_t> pads;
+  std::string auto_pad = "NOTSET";
+  int64_t ceil_mode = 0;
+  if (!global_pooling) {
+    const auto* kernel_shape_attr = ctx.getAttribute("kernel_shape");
+    if (kernel_shape_attr == nullptr || kernel_shape_attr->ints_size() != spatial_rank) {
+      fail_shape_inference("Attribute kernel_shape must have one value per spatial dimension");
+    }
+    kernel_shape.assign(kernel_shape_attr->ints().begin(), kernel_shape_attr->ints().end());
+    if (!getRepeatedAttribute(ctx, "strides", strides) || strides.empty()) {
+      strides.assign(spatial_rank, 1);
+    }
+    if (!getRepeatedAttribute(ctx, "pads", pads) || pads.empty()) {
+      pads.assign(spatial_rank * 2, 0);
+    }
+    if (static_cast<int>(strides.size()) != spatial_rank || static_cast<int>(pads.size()) != spatial_rank * 2) {
+      fail_shape_inference("Attributes strides and pads must match the spatial dimensions");
+    }
+    if (const auto* auto_pad_attr = ctx.getAttribute("auto_pad")) {
+      auto_pad = auto_pad_attr->s();
+    }
+    ceil_mode = getAttribute(ctx, "ceil_mode", 0);
+  }
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+  *output_shape->add_dim() = input_shape.dim(0);
+  for (int i = 0; i < spatial_rank; ++i) {
+    auto* dim = output_shape->add_dim();
+    const auto& input_dim = input_shape.dim(i + 1);
+    if (global_pooling) {
+      dim->set_dim_value(1);
+      continue;
+    }
+    if (!input_dim.has_dim_value()) {
+      continue;
+    }
+
+    const int64_t input_size = input_dim.dim_value();
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      dim->set_dim_value((input_size + strides[i] - 1) / strides[i]);
+      continue;
+    }
+
+    const int64_t padded_size = auto_pad == "VALID" ? input_size : input_size + pads[i] + pads[i + spatial_rank];
+    const int64_t span = padded_size - kernel_shape[i];
+    dim->set_dim_value((ceil_mode != 0 ? (span + strides[i] - 1) / strides[i] : span / strides[i]) + 1);
+  }
+  *output_shape->add_dim() = input_shape.dim(rank - 1);
+}
+
+// Infers the shape of an NhwcConv output, (N, O1, ..., On, M), from the input (N, D1, ..., Dn, C) and the weight
+// (M, k1, ..., kn, C / group).
+void NhwcConvShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
+  ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasNInputShapes(ctx, 2)) {
+    return;
+  }
+
+  const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+  const auto& weight_shape = ctx.getInputType(1)->tensor_type().shape();
+  const int rank = input_shape.dim_size();
+  if (rank < 3) {
+    fail_shape_inference("Input tensor must have at least 3 dimensions");
+  }
+  if (weight_shape.dim_size() != rank) {
+    fail_shape_inference("Weight tensor must have the rank of the input");
+  }
+  const int spatial_rank = rank - 2;
+
+  std::vector<int64_t> dilations;
+  std::vector<int64_t> strides;
+  std::vector<int64_t> pads;
+  if (!getRepeatedAttribute(ctx, "dilations", dilations) || dilations.empty()) {
+    dilations.assign(spatial_rank, 1);
+  }
+  if (!getRepeatedAttribute(ctx, "strides", strides) || strides.empty()) {
+    strides.assign(spatial_rank, 1);
+  }
+  if (!getRepeatedAttribute(ctx, "pads", pads) || pads.empty()) {
+    pads.assign(spatial_rank * 2, 0);
+  }
+  if (static_cast<int>(dilations.size()) != spatial_rank || static_cast<int>(strides.size()) != spatial_rank ||
+      static_cast<int>(pads.size()) != spatial_rank * 2) {
+    fail_shape_inference("Attributes dilations, strides and pads must match the spatial dimensions");
+  }
+  std::string auto_pad = "NOTSET";
+  if (const auto* auto_pad_attr = ctx.getAttribute("auto_pad")) {
+    auto_pad = auto_pad_attr->s();
+  }
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+  *output_shape->add_dim() = input_shape.dim(0);
+  for (int i = 0; i < spatial_rank; ++i) {
+    auto* dim = output_shape->add_dim();
+    const auto& input_dim = input_shape.dim(i + 1);
+    const auto& kernel_dim = weight_shape.dim(i + 1);
+    if (!input_dim.has_dim_value() || !kernel_dim.has_dim_value()) {
+      continue;
+    }
+
+    const int64_t input_size = input_dim.dim_value();
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      dim->set_dim_value((input_size + strides[i] - 1) / strides[i]);
+      continue;
+    }
+
+    const int64_t kernel_extent = (kernel_dim.dim_value() - 1) * dilations[i] + 1;
+    const int64_t padded_size = auto_pad == "VALID" ? input_size : input_size + pads[i] + pads[i + spatial_rank];
+    dim->set_dim_value((padded_size - kernel_extent) / strides[i] + 1);
+  }
+  *output_shape->add_dim() = weight_shape.dim(0);
+}
+
+void NhwcPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(
+Pooling of an input in the NHWC layout, with the channels as the last dimension. The attributes are those of the
+ONNX pooling op, applied to the spatial dimensions between the batch and the channels, and the output is in the NHWC
+layout too.)DOC");
+  schema.Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"));
+  schema.Attr("kernel_shape", "The size of the kernel along each spatial axis.", AttributeProto::INTS);
+  schema.Attr("strides", "Stride along each spatial axis.", AttributeProto::INTS, OPTIONAL);
+  schema.Attr("pads", "Padding for the beginning and ending along each spatial axis.", AttributeProto::INTS, OPTIONAL);
+  schema.Attr("ceil_mode", "Whether to use ceil or floor to compute the output shape.", AttributeProto::INT,
+              static_cast<int64_t>(0));
+  schema.Input(0, "X", "Input tensor of shape (N, D1, ..., Dn, C).", "T");
+  schema.Output(0, "Y", "Output tensor in the layout of X.", "T");
+  schema.TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    NhwcPoolShapeInference(ctx, false);
+  });
+}
+
+void NhwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(
+Global pooling of an input in the NHWC layout, reducing the spatial dimensions between the batch and the channels to
+1, so the output has the shape (N, 1, ..., 1, C).)DOC");
+  schema.Input(0, "X", "Input tensor of shape (N, D1, ..., Dn, C).", "T");
+  schema.Output(0, "Y", "Output tensor of shape (N, 1, ..., 1, C).", "T");
+  schema.TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    NhwcPoolShapeInference(ctx, true);
+  });
+}
+
 void RegisterNchwcSchemas() {
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderInput)
       .SetDomain(kMSNchwcDomain)
@@ -189,6 +355,42 @@ void RegisterNchwcSchemas() {
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
       .FillUsing(NchwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "scales",
+          "",
+          AttributeProto::INTS)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        std::vector<int64_t> scales;
+        if (!getRepeatedAttribute(ctx, "scales", scales) ||
+            static_cast<int>(scales.size()) != input_shape.dim_size()) {
+          fail_shape_inference("scales must be specified for each input dimension");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < input_shape.dim_size(); i++) {
+          auto* output_dim = output_shape->add_dim();
+          auto& input_dim = input_shape.dim(i);
+          if (input_dim.has_dim_value()) {
+            output_dim->set_dim_value(input_dim.dim_value() * scales[i]);
+          } else if (scales[i] == 1) {
+            *output_dim = input_dim;
+          }
+        }
+      });
 }
 
 void RegisterContribSchemas() {
@@ -749,6 +951,62 @@ and op)DOC";
 Sample echo operator.)DOC");
 
   // register schemas for more operators here
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcMaxPool)
+      .FillUsing(NhwcPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcAveragePool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr(
+          "count_include_pad",
+          "Whether to include pad pixels when calculating values for the edges.",
+          AttributeProto::INT,
+          static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcGlobalMaxPool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcGlobalAveragePool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcConv)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+FusedConv of an input in the NHWC layout, with the channels as the last dimension, by a weight in the layout
+(M, k1, ..., kn, C / group), so both match the layout of the Tensor Core convolutions of cuDNN. The attributes are
+those of FusedConv, and Z and the output are in the NHWC layout too.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("dilations", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL)
+      .Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL)
+      .Input(0, "X", "Input tensor of shape (N, D1, ..., Dn, C).", "T")
+      .Input(1, "W", "Weight tensor of shape (M, k1, ..., kn, C / group).", "T")
+      .Input(2, "B", "Bias tensor of shape (M).", "T", OpSchema::Optional)
+      .Input(3, "Z", "Tensor of the shape of Y, added to it before the activation.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output tensor of shape (N, O1, ..., On, M).", "T")
+      .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(NhwcConvShapeInference);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NhwcBatchNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+The inference of ONNX BatchNormalization on an input in the NHWC layout, with the channels as the last
+dimension.)DOC")
+      .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, 1e-5f)
+      .Input(0, "X", "Input tensor of shape (N, D1, ..., Dn, C).", "T")
+      .Input(1, "scale", "Scale tensor of shape (C).", "T")
+      .Input(2, "B", "Bias tensor of shape (C).", "T")
+      .Input(3, "mean", "Running mean tensor of shape (C).", "T")
+      .Input(4, "var", "Running variance tensor of shape (C).", "T")
+      .Output(0, "Y", "Output tensor in the shape and layout of X.", "T")
+      .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(MaxpoolWithMask)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -850,7 +1108,8 @@ Sample echo operator.)DOC");
       .SinceVersion(1)
       .SetDoc(R"DOC(
 The fused convolution operator schema is the same as Conv besides it includes an attribute
-activation.)DOC")
+activation, and an optional input Z added to the output before the activation, as in
+Y = activation(Conv(X, W) + B + Z).)DOC")
       .Attr(
           "auto_pad",
           "",
@@ -907,6 +1166,12 @@ activation.)DOC")
           "",
           "T",
           OpSchema::Optional)
+      .Input(
+          3,
+          "Z",
+          "Tensor of the shape of Y, added to it before the activation.",
+          "T",
+          OpSchema::Optional)
       .Output(
           0,
           "Y",
@@ -918,6 +1183,71 @@ activation.)DOC")
         ONNX_NAMESPACE::convPoolShapeInference(ctx, true, false, 0, 1);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedBatchNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+The fused batch normalization operator is the inference form of BatchNormalization, with the single output Y,
+besides it includes the attributes activation and activation_params of an activation applied to Y, as in
+Y = activation(BatchNormalization(X, scale, B, mean, var)).)DOC")
+      .Attr(
+          "epsilon",
+          "The epsilon value to use to avoid division by zero.",
+          AttributeProto::FLOAT,
+          1e-5f)
+      .Attr(
+          "momentum",
+          "Not used for inference.",
+          AttributeProto::FLOAT,
+          0.9f)
+      .Attr(
+          "activation",
+          "",
+          AttributeProto::STRING,
+          OPTIONAL)
+      .Attr(
+          "activation_params",
+          "",
+          AttributeProto::FLOATS,
+          OPTIONAL)
+      .Input(0, "X", "Input data tensor of shape (N x C x D1 x ... x Dn).", "T")
+      .Input(1, "scale", "Scale tensor of shape (C).", "T")
+      .Input(2, "B", "Bias tensor of shape (C).", "T")
+      .Input(3, "mean", "The running mean of shape (C).", "T")
+      .Input(4, "var", "The running variance of shape (C).", "T")
+      .Output(0, "Y", "The output tensor of the same shape as X.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedInstanceNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+The fused instance normalization operator schema is the same as InstanceNormalization besides it includes the
+attributes activation and activation_params of an activation applied to the output, as in
+Y = activation(InstanceNormalization(X, scale, B)).)DOC")
+      .Attr(
+          "epsilon",
+          "The epsilon value to use to avoid division by zero.",
+          AttributeProto::FLOAT,
+          1e-5f)
+      .Attr(
+          "activation",
+          "",
+          AttributeProto::STRING,
+          OPTIONAL)
+      .Attr(
+          "activation_params",
+          "",
+          AttributeProto::FLOATS,
+          OPTIONAL)
+      .Input(0, "input", "Input data tensor of shape (N x C x D1 x ... x Dn).", "T")
+      .Input(1, "scale", "The input 1-dimensional scale tensor of size C.", "T")
+      .Input(2, "B", "The input 1-dimensional bias tensor of size C.", "T")
+      .Output(0, "output", "The output tensor of the same shape as input.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(FusedGemm)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1008,6 +1338,215 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Evaluates a chain of element-wise operators in a single pass over the data. The first input is the
+input of the chain. The operators listed in the ops attribute are applied in order to the running
+value; each binary operator (Add, Sub, Mul, Div) takes the running value as its first operand and the
+next unused input as its second. The other inputs must have the same shape as the first input or
+contain a single element. Supported unary operators are Relu, Sigmoid, Tanh, Exp, Neg, Abs and Sqrt.)DOC")
+      .Attr(
+          "ops",
+          "The element-wise operators to apply, in order.",
+          AttributeProto::STRINGS)
+      .Input(0, "inputs", "The input of the chain followed by the second operands of the binary operators.", "T",
+             OpSchema::Variadic)
+      .Output(0, "Y", "Output tensor with the shape of the first input.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        propagateShapeFromInputToOutput(ctx, 0, 0);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Looks up bags of rows of data and reduces the rows of each bag, without materializing the gathered
+rows. Without offsets, the last dimension of indices holds the bags, so the op computes
+ReduceSum(Gather(data, indices), axes=[-1 of indices], keepdims=0) or the equivalent ReduceMean. With
+offsets, indices must be 1-D and bag i holds the indices from offsets[i] up to offsets[i + 1], or to the
+end of indices for the last bag. Each gathered row is scaled by its entry of per_sample_weights if that
+input is given. In mean mode a bag is divided by its number of indices, and empty bags are zero.)DOC")
+      .Attr(
+          "mode",
+          "How the rows of a bag are reduced: 'sum' or 'mean'.",
+          AttributeProto::STRING,
+          std::string("sum"))
+      .Input(0, "data", "The table of rows, with the rows along the first dimension.", "T")
+      .Input(1, "indices", "The rows to look up.", "Tind")
+      .Input(2, "offsets", "1-D tensor with the start of each bag in indices.", "Tind", OpSchema::Optional)
+      .Input(3, "per_sample_weights", "Weight for each index, with as many elements as indices.", "T",
+             OpSchema::Optional)
+      .Output(0, "output", "The reduced rows of each bag.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+          return;
+        }
+
+        auto& data_shape = getInputShape(ctx, 0);
+        auto& indices_shape = getInputShape(ctx, 1);
+        if (data_shape.dim_size() < 1 || indices_shape.dim_size() < 1) {
+          fail_shape_inference("data and indices must have a rank of at least 1");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        if (ctx.getNumInputs() > 2 && hasInputShape(ctx, 2)) {
+          *output_shape.add_dim() = getInputShape(ctx, 2).dim(0);
+        } else if (ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr) {
+          output_shape.add_dim();
+        } else {
+          for (int i = 0; i < indices_shape.dim_size() - 1; ++i) {
+            *output_shape.add_dim() = indices_shape.dim(i);
+          }
+        }
+        for (int i = 1; i < data_shape.dim_size(); ++i) {
+          *output_shape.add_dim() = data_shape.dim(i);
+        }
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Computes Y = alpha * (A x B) + beta * C, where B is a constant 2-D sparse tensor held by the node. A is
+multiplied as in MatMul, so its last dimension must match the first dimension of B, and C broadcasts to a
+single value or one value per column of B. Only the nonzero values of B are stored and multiplied, which
+saves memory and time over the dense product for weights that are mostly zeros, such as pruned weights.)DOC")
+      .Attr("B", "The sparse 2-D matrix A is multiplied with.", AttributeProto::SPARSE_TENSOR)
+      .Attr("alpha", "Scalar multiplier for the product of A and B.", AttributeProto::FLOAT, 1.0f)
+      .Attr("beta", "Scalar multiplier for C.", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "A", "Input tensor with the rows of B as its last dimension.", "T")
+      .Input(1, "C", "Optional bias with a single value or one value per column of B.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output tensor with the columns of B as its last dimension.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        const auto* B = ctx.getAttribute("B");
+        if (B == nullptr || !hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        auto& A_shape = getInputShape(ctx, 0);
+        if (B->sparse_tensor().dims_size() != 2 || A_shape.dim_size() < 1) {
+          fail_shape_inference("B must be 2-D and A must have a rank of at least 1");
+        }
+
+        const auto& K = A_shape.dim(A_shape.dim_size() - 1);
+        if (K.has_dim_value() && K.dim_value() != B->sparse_tensor().dims(0)) {
+          fail_shape_inference("The last dimension of A must match the first dimension of B");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < A_shape.dim_size() - 1; ++i) {
+          *output_shape.add_dim() = A_shape.dim(i);
+        }
+        output_shape.add_dim()->set_dim_value(B->sparse_tensor().dims(1));
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(CompressedMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Computes Y = alpha * (A x (scale * op(B))) + beta * C, where B is a 2-D weight stored in float16, or in int8 with
+the scale as a single value for the whole weight. op(B) is B, or its transpose if transB is set. A is multiplied as
+in MatMul, so its last dimension must match the first dimension of op(B), and C broadcasts to a single value or one
+value per column of op(B). The weight is expanded to float while the multiplication runs, so it is held at half or
+a quarter of the size of the float weight, without quantizing A.)DOC")
+      .Attr("transB", "Whether B should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("alpha", "Scalar multiplier for the product of A and B.", AttributeProto::FLOAT, 1.0f)
+      .Attr("beta", "Scalar multiplier for C.", AttributeProto::FLOAT, 1.0f)
+      .Attr("scale", "Scalar multiplier for the values of B.", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "A", "Input tensor with the rows of op(B) as its last dimension.", "T")
+      .Input(1, "B", "The 2-D weight.", "T2")
+      .Input(2, "C", "Optional bias with a single value or one value per column of op(B).", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output tensor with the columns of op(B) as its last dimension.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T2", {"tensor(float16)", "tensor(int8)"}, "Constrain the weight to float16 or int8 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+          return;
+        }
+
+        auto& A_shape = getInputShape(ctx, 0);
+        auto& B_shape = getInputShape(ctx, 1);
+        if (B_shape.dim_size() != 2 || A_shape.dim_size() < 1) {
+          fail_shape_inference("B must be 2-D and A must have a rank of at least 1");
+        }
+
+        const bool trans_b = getAttribute(ctx, "transB", 0) != 0;
+        const auto& B_rows = B_shape.dim(trans_b ? 1 : 0);
+        const auto& K = A_shape.dim(A_shape.dim_size() - 1);
+        if (K.has_dim_value() && B_rows.has_dim_value() && K.dim_value() != B_rows.dim_value()) {
+          fail_shape_inference("The last dimension of A must match the first dimension of op(B)");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < A_shape.dim_size() - 1; ++i) {
+          *output_shape.add_dim() = A_shape.dim(i);
+        }
+        *output_shape.add_dim() = B_shape.dim(trans_b ? 0 : 1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(LayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Normalizes each slice of X over the dimensions from axis to the last one to zero mean and unit variance,
+then scales and shifts it: Y = (X - mean) / sqrt(variance + epsilon) * scale + B. This is the layer
+normalization that transformer models otherwise express with ReduceMean, Sub, Pow, Sqrt and Div nodes.)DOC")
+      .Attr("axis", "The first normalized dimension. Negative values count from the back.", AttributeProto::INT,
+            static_cast<int64_t>(-1))
+      .Attr("epsilon", "The value added to the variance to avoid dividing by zero.", AttributeProto::FLOAT, 1e-5f)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Input(1, "scale", "Scale with the shape of the normalized dimensions.", "T")
+      .Input(2, "B", "Bias with the shape of the normalized dimensions.", "T")
+      .Output(0, "Y", "Output data tensor with the shape of X.", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)", "tensor(double)"},
+                      "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Gelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Gaussian Error Linear Unit, Y = 0.5 * X * (1 + erf(X / sqrt(2))), applied element-wise.)DOC")
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor with the shape of X.", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)", "tensor(double)"},
+                      "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Multi-head self-attention over input of shape (batch_size, sequence_length, hidden_size). The query, key
+and value projections are computed together as input * weight + bias, where weight is (hidden_size,
+3 * hidden_size) with the query, key and value columns in that order. Each of the num_heads heads takes
+head_size = hidden_size / num_heads of those columns and computes
+softmax(Q * K^T / sqrt(head_size) + mask) * V. The output concatenates the heads back to
+(batch_size, sequence_length, hidden_size). The optional mask is added to the attention scores and has the
+shape (batch_size or 1, 1, sequence_length or 1, sequence_length), so it is broadcast across heads and,
+when its third dimension is 1, across query positions.)DOC")
+      .Attr("num_heads", "Number of attention heads.", AttributeProto::INT)
+      .Input(0, "input", "3-D input tensor with shape (batch_size, sequence_length, hidden_size).", "T")
+      .Input(1, "weight", "2-D weight tensor with shape (hidden_size, 3 * hidden_size).", "T")
+      .Input(2, "bias", "1-D bias tensor with shape (3 * hidden_size).", "T")
+      .Input(3, "mask", "Additive attention mask.", "T", OpSchema::Optional)
+      .Output(0, "output", "3-D output tensor with the shape of input.", "T")
+      .TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1053,6 +1592,10 @@ activation and leaky_relu_alpha.)DOC")
 
   ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(AttnLSTM, RegisterAttnLSTMContribOpSchema);
   ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(Range, RegisterRangeOpSchema);
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(DynamicQuantizeLSTM, RegisterDynamicQuantizeLSTMOpSchema);
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(DynamicQuantizeGRU, RegisterDynamicQuantizeGRUOpSchema);
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(BeamSearch, RegisterBeamSearchOpSchema);
+  ONNX_CONTRIB_OPERATOR_SCHEMA_ELSEWHERE(GreedySearch, RegisterGreedySearchOpSchema);
 
   static const char* QuantizeLinear_ver1_doc = R"DOC(
 The linear quantization operator. It consumes a full precision data, a scale, a zero point and computes the quantized data. 
@@ -1167,6 +1710,39 @@ Scale and zero point must have same shape. They must be either scalar (per tenso
         updateOutputShape(ctx, 0, input_shape);
       });
 
+  static const char* QLinearAdd_ver1_doc = R"DOC(
+Performs element-wise addition of two quantized tensors (with Numpy-style broadcasting support).
+The result is C = quantize(dequantize(A) + dequantize(B)), computed with the given scales and zero points,
+where the scales and the zero points are scalars (per-tensor quantization).)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(QLinearAdd)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(QLinearAdd_ver1_doc)
+      .Input(0, "A", "First operand.", "T")
+      .Input(1, "A_scale", "Input A's scale. It's a scalar, which means a per-tensor/layer quantization.", "tensor(float)")
+      .Input(2, "A_zero_point", "Input A zero point. It's a scalar, which means a per-tensor/layer quantization.", "T")
+      .Input(3, "B", "Second operand.", "T")
+      .Input(4, "B_scale", "Input B's scale. It's a scalar, which means a per-tensor/layer quantization.", "tensor(float)")
+      .Input(5, "B_zero_point", "Input B zero point. It's a scalar, which means a per-tensor/layer quantization.", "T")
+      .Input(6, "C_scale", "Output scale. It's a scalar, which means a per-tensor/layer quantization.", "tensor(float)")
+      .Input(7, "C_zero_point", "Output zero point. It's a scalar, which means a per-tensor/layer quantization.", "T")
+      .Output(0, "C", "Result, has same element type as the inputs", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(uint8)"},
+          "Constrain input and output types to 8 bit unsigned integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        if (hasInputShape(ctx, 0) && hasInputShape(ctx, 3)) {
+          bidirectionalBroadcastShapeInference(
+              ctx.getInputType(0)->tensor_type().shape(),
+              ctx.getInputType(3)->tensor_type().shape(),
+              *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+        }
+      });
+
   static const char* Tokenizer_ver1_doc = R"DOC(
   Tokenizer divides each string in X into a vector of strings along the last axis. Allowed input shapes are [C] and [N, C].
   If the maximum number of tokens found per input string is D, the output shape would be [N, C, D] when input shape is [N, C].
@@ -1309,6 +1885,28 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         matmulShapeInference(ctx, 0, 1);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Computes Y = A x B + bias like MatMul, with A quantized to uint8 at run time as by DynamicQuantizeLinear and
+multiplied with the uint8 matrix B in integers. The int32 products are scaled back to float by the scales of A
+and B and the bias is added while writing Y. This is the DynamicQuantizeLinear, MatMulInteger, Cast, Mul and Add
+nodes of a dynamically quantized model in one operator, without their intermediate tensors.)DOC")
+      .Input(0, "A", "N-dimensional float matrix A", "T1")
+      .Input(1, "B", "N-dimensional uint8 matrix B", "T2")
+      .Input(2, "b_scale", "Scale of B, a scalar or a 1-D tensor with one value per column of B.", "T1")
+      .Input(3, "b_zero_point", "Zero point of B, a scalar or a 1-D tensor with one value per column of B. "
+             "0 if not specified.", "T2", OpSchema::Optional)
+      .Input(4, "bias", "1-D bias with one value per column of B, added to the result.", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, the scale, the bias and output Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain input B and its zero point to 8-bit unsigned integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        matmulShapeInference(ctx, 0, 1);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReduceSumInteger)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1340,7 +1938,7 @@ with the exception that numpy default keepdims to False instead of True.)DOC")
       .SetDoc(R"DOC(The underlying implementation is MurmurHash3_x86_32 generating low latency 32bits hash suitable for implementing lookup tables, Bloom filters, count min sketch or feature hashing.)DOC")
       .Input(0, "X", "An input tensor to hash.", "T1")
       .Output(0, "Y", "32-bit hash value.", "T2")
-      .TypeConstraint("T1", {"tensor(uint32)", "tensor(int32)", "tensor(string)"}, "Constrain input type to unsigned or signed 32-bit integer tensor, or string tensor. It should be utf-8 encoded if using unicode.")
+      .TypeConstraint("T1", {"tensor(uint32)", "tensor(int32)", "tensor(uint64)", "tensor(int64)", "tensor(string)"}, "Constrain input type to unsigned or signed 32-bit or 64-bit integer tensor, or string tensor. It should be utf-8 encoded if using unicode.")
       .TypeConstraint("T2", {"tensor(uint32)", "tensor(int32)"}, "Constrain output type to unsigned and signed 32-bit integer tensor.")
       .Attr(
           "seed",
@@ -1352,6 +1950,12 @@ with the exception that numpy default keepdims to False instead of True.)DOC")
           "If value is 1, output type is uint32_t, else int32_t. Default value is 1.",
           AttributeProto::INT,
           (int64_t)1LL)
+      .Attr(
+          "num_buckets",
+          "If not 0, the output is the unsigned 32-bit hash modulo num_buckets, the bucket of the input for feature "
+          "hashing. It must fit in a signed 32-bit integer. Default value is 0.",
+          AttributeProto::INT,
+          (int64_t)0LL)
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
         // type inference
         auto positive_attr = ctx.getAttribute("positive");
@@ -1586,6 +2190,10 @@ Example 4:
   ONNX_CONTRIB_OPERATOR_SCHEMA(Unique)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
+      .Attr("sorted",
+            "Whether the unique values are sorted in ascending order instead of the order "
+            "in which they occur in the input 'x'.",
+            AttributeProto::INT, static_cast<int64_t>(0))
       .Input(0, "x", "A 1-D input tensor that is to be processed.", "T")
       .Output(0, "y",
               "A 1-D tensor of the same type as 'x' "
@@ -1596,18 +2204,24 @@ Example 4:
               "A 1-D INT64 tensor of the same size as 'x' "
               "containing the indices for each value in 'x' "
               "in the output 'uniques'",
-              "tensor(int64)")
+              "tensor(int64)", OpSchema::Optional)
       .Output(2, "counts",
               "A 1-D INT64 tensor containing the "
               "the count of each element "
               "of 'uniques' in the input 'x'",
-              "tensor(int64)")
+              "tensor(int64)", OpSchema::Optional)
       .TypeConstraint("T", OpSchema::all_tensor_types(), "Input can be of any tensor type.")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
         // Type inference
         ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
-        ONNX_NAMESPACE::updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
-        ONNX_NAMESPACE::updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::INT64);
+        const bool has_idx = ctx.getNumOutputs() > 1 && ctx.getOutputType(1) != nullptr;
+        const bool has_counts = ctx.getNumOutputs() > 2 && ctx.getOutputType(2) != nullptr;
+        if (has_idx) {
+          ONNX_NAMESPACE::updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
+        }
+        if (has_counts) {
+          ONNX_NAMESPACE::updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::INT64);
+        }
 
         // Shape inference
 
@@ -1618,10 +2232,12 @@ Example 4:
             ->mutable_shape()
             ->add_dim();
 
-        ctx.getOutputType(2)
-            ->mutable_tensor_type()
-            ->mutable_shape()
-            ->add_dim();
+        if (has_counts) {
+          ctx.getOutputType(2)
+              ->mutable_tensor_type()
+              ->mutable_shape()
+              ->add_dim();
+        }
 
         // if the input shape doesn't exist, further shape inference is not possible
         if (!hasNInputShapes(ctx, 1)) {
@@ -1629,7 +2245,9 @@ Example 4:
         }
 
         // 'idx' output has same shape as input
-        ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, 0, 1);
+        if (has_idx) {
+          ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, 0, 1);
+        }
 
         return;
       })
@@ -1641,6 +2259,8 @@ Example 4:
               The second output tensor 'idx' is the same size as the input and it contains the index
               of each value of the input in 'uniques'.
               The third output tensor 'counts' contains the count of each element of 'uniques' in the input.
+              With 'sorted' set, 'uniques' is in ascending order instead, and 'idx' and 'counts' follow it.
+              'idx' and 'counts' are optional, and are only computed when they are used.
               Example:
                 input_x = [2, 1, 1, 3, 4, 3]
                 output_uniques = [2, 1, 3, 4]
@@ -1656,7 +2276,8 @@ Example 4:
             "The distance metric to use. If a string, the distance function can be \"braycurtis\", \"canberra\", "
             "\"chebyshev\", \"cityblock\", \"correlation\", \"cosine\", \"dice\", \"euclidean\", \"hamming\", \"jaccard\", "
             "\"jensenshannon\", \"kulsinski\", \"mahalanobis\", \"matching\", \"minkowski\", \"rogerstanimoto\", \"russellrao\", "
-            "\"seuclidean\", \"sokalmichener\", \"sokalsneath\", \"sqeuclidean\", \"wminkowski\", \"yule\".",
+            "\"seuclidean\", \"sokalmichener\", \"sokalsneath\", \"sqeuclidean\", \"wminkowski\", \"yule\". "
+            "The CPU kernel implements \"euclidean\", \"sqeuclidean\", \"cosine\" and \"cityblock\".",
             AttributeProto::STRING, std::string("sqeuclidean"))     
       .Input(0, "A", "2D matrix with shape (M,N)", "T")
 	  .Input(1, "B", "2D matrix with shape (K,N)", "T")
@@ -1665,6 +2286,58 @@ Example 4:
               "T")
       .TypeConstraint("T", {"tensor(float)", "tensor(double)"}, "Constrains input to only numeric types.");
 
+  static const char* IVFSearch_ver1_doc = R"DOC(
+Approximate k nearest neighbor search of the rows of X, by squared Euclidean distance, in an inverted file index.
+The vectors of the index are grouped in lists, one per centroid of a coarse quantizer. Each query is compared with
+the vectors of the nprobe lists whose centroids are the closest to it. The vectors are either stored as they are
+(IVF-Flat), or as product quantization codes of their residuals to the centroid of their list (IVF-PQ): the
+residual is split in M subvectors of D/M values, each encoded by the index of the closest of the 256 centroids of
+its codebook. The index is built offline and stored in the model as initializers.
+If fewer than k vectors are compared with a query, the remaining indices are -1 with infinite distances.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(IVFSearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(IVFSearch_ver1_doc)
+      .Attr("k", "The number of neighbors returned per query.", AttributeProto::INT)
+      .Attr("nprobe", "The number of lists searched per query.", AttributeProto::INT, static_cast<int64_t>(1))
+      .Input(0, "X", "The queries, with shape (Q, D).", "tensor(float)")
+      .Input(1, "centroids", "The centroids of the lists, with shape (L, D).", "tensor(float)")
+      .Input(2, "list_offsets",
+             "1D tensor of L + 1 offsets: the vectors of list l are the rows list_offsets[l] to "
+             "list_offsets[l + 1] - 1 of vectors.",
+             "tensor(int64)")
+      .Input(3, "ids", "The ids returned for the vectors, with shape (N).", "tensor(int64)")
+      .Input(4, "vectors",
+             "The vectors of the lists, with shape (N, D) for IVF-Flat, or their codes, with shape (N, M) for IVF-PQ.",
+             "T")
+      .Input(5, "codebooks",
+             "The centroids of the subvectors of the residuals, with shape (M, 256, D / M). Required for IVF-PQ.",
+             "tensor(float)", OpSchema::Optional)
+      .Output(0, "distances", "The squared distances of the neighbors in ascending order, with shape (Q, k).",
+              "tensor(float)")
+      .Output(1, "indices", "The ids of the neighbors, with shape (Q, k).", "tensor(int64)")
+      .TypeConstraint("T", {"tensor(float)", "tensor(uint8)"},
+                      "Constrain the vectors to float for IVF-Flat and to uint8 codes for IVF-PQ.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::FLOAT);
+        updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        const auto& x_shape = getInputShape(ctx, 0);
+        if (x_shape.dim_size() != 2) {
+          fail_shape_inference("X must be 2D");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = x_shape.dim(0);
+        output_shape.add_dim()->set_dim_value(getAttribute(ctx, "k", 0));
+        updateOutputShape(ctx, 0, output_shape);
+        updateOutputShape(ctx, 1, output_shape);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(CropAndResize)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
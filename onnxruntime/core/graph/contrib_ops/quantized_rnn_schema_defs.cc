@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "quantized_rnn_schema_defs.h"
+
+#include <string>
+
+#include "core/graph/constants.h"
+#include "core/graph/op.h"
+#include "onnx/defs/shape_inference.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using ::ONNX_NAMESPACE::AttributeProto;
+using ::ONNX_NAMESPACE::InferenceContext;
+using ::ONNX_NAMESPACE::OPTIONAL;
+using ::ONNX_NAMESPACE::OpSchema;
+using ::ONNX_NAMESPACE::TensorShapeProto;
+
+static const char* DynamicQuantizeLSTM_ver1_doc = R"DOC(
+LSTM, as the ONNX operator, with the weights W and R quantized to uint8 with a scale and zero point per direction,
+W = W_scale * (W_quantized - W_zero_point) and R = R_scale * (R_quantized - R_zero_point). The inputs of the GEMMs
+are quantized on the fly, so the GEMMs run on integers. The other inputs and the outputs are floats.
+)DOC";
+
+static const char* DynamicQuantizeGRU_ver1_doc = R"DOC(
+GRU, as the ONNX operator, with the weights W and R quantized to uint8 with a scale and zero point per direction,
+W = W_scale * (W_quantized - W_zero_point) and R = R_scale * (R_quantized - R_zero_point). The inputs of the GEMMs
+are quantized on the fly, so the GEMMs run on integers. The other inputs and the outputs are floats.
+)DOC";
+
+// the outputs of the RNN operators from X, direction and hidden_size, as in ONNX
+static void QuantizedRnnShapeInference(InferenceContext& ctx) {
+  TensorShapeProto::Dimension num_directions, seq_length, batch_size, hidden_size;
+
+  auto direction = getAttribute(ctx, "direction", "forward");
+  if (direction == "forward" || direction == "reverse") {
+    num_directions.set_dim_value(1);
+  } else if (direction == "bidirectional") {
+    num_directions.set_dim_value(2);
+  }
+
+  auto hidden_size_value = getAttribute(ctx, "hidden_size", -1);
+  if (hidden_size_value > 0) {
+    hidden_size.set_dim_value(hidden_size_value);
+  }
+
+  if (hasInputShape(ctx, 0)) {
+    auto& X_shape = getInputShape(ctx, 0);
+    if (X_shape.dim_size() != 3) {
+      fail_shape_inference("First input tensor must have rank 3");
+    }
+    seq_length = X_shape.dim(0);
+    batch_size = X_shape.dim(1);
+  }
+
+  auto num_outputs = ctx.getNumOutputs();
+  if (num_outputs > 0) {
+    propagateElemTypeFromInputToOutput(ctx, 0, 0);
+    updateOutputShape(ctx, 0, {seq_length, num_directions, batch_size, hidden_size});
+  }
+  for (size_t i = 1; i < num_outputs; ++i) {
+    propagateElemTypeFromInputToOutput(ctx, 0, i);
+    updateOutputShape(ctx, i, {num_directions, batch_size, hidden_size});
+  }
+}
+
+// the attributes, types and inputs shared by the quantized RNN operators
+static OpSchema& QuantizedRnnCommon(OpSchema& op_schema, int activation_count) {
+  return op_schema
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .Attr("activations",
+            "A list of " + std::to_string(activation_count) + " (or " + std::to_string(2 * activation_count) +
+                " if bidirectional) activation functions, as in the ONNX operator.",
+            AttributeProto::STRINGS, OPTIONAL)
+      .Attr("activation_alpha",
+            "Optional scaling values used by some activation functions, as in the ONNX operator.",
+            AttributeProto::FLOATS, OPTIONAL)
+      .Attr("activation_beta",
+            "Optional scaling values used by some activation functions, as in the ONNX operator.",
+            AttributeProto::FLOATS, OPTIONAL)
+      .Attr("clip",
+            "Cell clip threshold. Clipping bounds the elements of a tensor in the range of "
+            "[-threshold, +threshold] and is applied to the input of activations. No clip if not specified.",
+            AttributeProto::FLOAT, OPTIONAL)
+      .Attr("hidden_size", "Number of neurons in the hidden layer.", AttributeProto::INT, OPTIONAL)
+      .Attr("direction",
+            "Specify if the RNN is forward, reverse, or bidirectional. Must be one of "
+            "forward (default), reverse, or bidirectional.",
+            AttributeProto::STRING, std::string("forward"))
+      .Input(0, "X",
+             "The input sequences packed (and potentially padded) into one 3-D tensor "
+             "with the shape of `[seq_length, batch_size, input_size]`.",
+             "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T1", {"tensor(int32)"}, "Constrain seq_lens to integer tensor.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain the quantized weights and their zero points to uint8 tensors.")
+      .TypeAndShapeInferenceFunction(QuantizedRnnShapeInference);
+}
+
+OpSchema& RegisterDynamicQuantizeLSTMOpSchema(OpSchema&& op_schema) {
+  return QuantizedRnnCommon(op_schema, 3)
+      .Attr("input_forget", "Couple the input and forget gates if 1.", AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(1, "W",
+             "The quantized weight tensor for the gates, `W[iofc]` and `WB[iofc]` (if bidirectional). "
+             "It has shape `[num_directions, 4*hidden_size, input_size]`.",
+             "T2")
+      .Input(2, "R",
+             "The quantized recurrence weight tensor, `R[iofc]` and `RB[iofc]` (if bidirectional). "
+             "It has shape `[num_directions, 4*hidden_size, hidden_size]`.",
+             "T2")
+      .Input(3, "B",
+             "The bias tensor, `[Wb[iofc], Rb[iofc]]` and `[WBb[iofc], RBb[iofc]]` (if bidirectional). "
+             "It has shape `[num_directions, 8*hidden_size]`. Optional: If not specified - assumed to be 0.",
+             "T", OpSchema::Optional)
+      .Input(4, "sequence_lens",
+             "Optional tensor specifying lengths of the sequences in a batch. If not specified - assumed all "
+             "sequences in the batch to have length `seq_length`. It has shape `[batch_size]`.",
+             "T1", OpSchema::Optional)
+      .Input(5, "initial_h",
+             "Optional initial value of the hidden. If not specified - assumed to be 0. "
+             "It has shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(6, "initial_c",
+             "Optional initial value of the cell. If not specified - assumed to be 0. "
+             "It has shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(7, "P",
+             "The weight tensor for peepholes, `P[iof]` and `PB[iof]` (if bidirectional). "
+             "It has shape `[num_directions, 3*hidden_size]`. Optional: If not specified - assumed to be 0.",
+             "T", OpSchema::Optional)
+      .Input(8, "W_scale", "The scale of W for each direction. It has shape `[num_directions]`.", "T")
+      .Input(9, "W_zero_point", "The zero point of W for each direction. It has shape `[num_directions]`.", "T2")
+      .Input(10, "R_scale", "The scale of R for each direction. It has shape `[num_directions]`.", "T")
+      .Input(11, "R_zero_point", "The zero point of R for each direction. It has shape `[num_directions]`.", "T2")
+      .Output(0, "Y",
+              "A tensor that concats all the intermediate output values of the hidden. "
+              "It has shape `[seq_length, num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional)
+      .Output(1, "Y_h",
+              "The last output value of the hidden. It has shape `[num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional)
+      .Output(2, "Y_c",
+              "The last output value of the cell. It has shape `[num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional)
+      .SetDoc(DynamicQuantizeLSTM_ver1_doc);
+}
+
+OpSchema& RegisterDynamicQuantizeGRUOpSchema(OpSchema&& op_schema) {
+  return QuantizedRnnCommon(op_schema, 2)
+      .Attr("linear_before_reset",
+            "When computing the output of the hidden gate, apply the linear transformation before multiplying by "
+            "the output of the reset gate.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(1, "W",
+             "The quantized weight tensor for the gates, `W[zrh]` and `WB[zrh]` (if bidirectional). "
+             "It has shape `[num_directions, 3*hidden_size, input_size]`.",
+             "T2")
+      .Input(2, "R",
+             "The quantized recurrence weight tensor, `R[zrh]` and `RB[zrh]` (if bidirectional). "
+             "It has shape `[num_directions, 3*hidden_size, hidden_size]`.",
+             "T2")
+      .Input(3, "B",
+             "The bias tensor, `[Wb[zrh], Rb[zrh]]` and `[WBb[zrh], RBb[zrh]]` (if bidirectional). "
+             "It has shape `[num_directions, 6*hidden_size]`. Optional: If not specified - assumed to be 0.",
+             "T", OpSchema::Optional)
+      .Input(4, "sequence_lens",
+             "Optional tensor specifying lengths of the sequences in a batch. If not specified - assumed all "
+             "sequences in the batch to have length `seq_length`. It has shape `[batch_size]`.",
+             "T1", OpSchema::Optional)
+      .Input(5, "initial_h",
+             "Optional initial value of the hidden. If not specified - assumed to be 0. "
+             "It has shape `[num_directions, batch_size, hidden_size]`.",
+             "T", OpSchema::Optional)
+      .Input(6, "W_scale", "The scale of W for each direction. It has shape `[num_directions]`.", "T")
+      .Input(7, "W_zero_point", "The zero point of W for each direction. It has shape `[num_directions]`.", "T2")
+      .Input(8, "R_scale", "The scale of R for each direction. It has shape `[num_directions]`.", "T")
+      .Input(9, "R_zero_point", "The zero point of R for each direction. It has shape `[num_directions]`.", "T2")
+      .Output(0, "Y",
+              "A tensor that concats all the intermediate output values of the hidden. "
+              "It has shape `[seq_length, num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional)
+      .Output(1, "Y_h",
+              "The last output value of the hidden. It has shape `[num_directions, batch_size, hidden_size]`.",
+              "T", OpSchema::Optional)
+      .SetDoc(DynamicQuantizeGRU_ver1_doc);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,6 +8,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <stack>
 
@@ -424,6 +425,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_signature_valid_ = false;
   attributes_[attr_name] = value;
 }
 
@@ -431,6 +433,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inference_signature_valid_ = false;                                      \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -442,6 +445,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    inference_signature_valid_ = false;                                      \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -454,6 +458,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    inference_signature_valid_ = false;                      \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -466,6 +471,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_signature_valid_ = false;
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -490,6 +496,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  inference_signature_valid_ = false;
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -643,15 +650,16 @@ Graph::Graph(GraphProto* graph_proto, const std::unordered_map<std::string, int>
   ORT_ENFORCE(graph_proto != nullptr, "graph_proto cannot be null");
   ArgNameToTypeMap name_to_type_map;
 
-  for (auto& node : graph_proto_->node()) {
+  for (auto& node : *graph_proto_->mutable_node()) {
     if (node.op_type() != kConstant) {
       continue;
     }
 
-    // Copy constant nodes _value to name_to_initial_tensor_
+    // Move constant nodes _value to name_to_initial_tensor_. The nodes are removed below, so their value
+    // is swapped out rather than copied.
     const gsl::not_null<TensorProto*>
         tensor{graph_proto_->add_initializer()};
-    *tensor = node.attribute(0).t();
+    tensor->Swap(node.mutable_attribute(0)->mutable_t());
     *(tensor->mutable_name()) = node.output(0);
   }
 
@@ -725,6 +733,7 @@ Status Graph::VerifyNoDuplicateName() {
   auto& node_name_to_index = resolve_context_.node_name_to_index;
 
   output_args.clear();
+  output_args.reserve(static_cast<size_t>(NumberOfNodes()));
   node_name_to_index.clear();
   // inputs_and_initializers: this is passed in as a parameter, since functions don't have initializers
   // but graphs have them.
@@ -753,7 +762,7 @@ Status Graph::VerifyNoDuplicateName() {
                         "This is an invalid model. Error: Duplicate definition of name (" + output_arg_name + ").");
           return status;
         }
-        auto result = output_args.insert({output_arg_name, {&node, output_index}});
+        auto result = output_args.insert({output_def, {&node, output_index}});
         if (!result.second) {
           // Two outputs with same name, so that insertion fails.
           Status status(ONNXRUNTIME, FAIL,
@@ -790,7 +799,9 @@ common::Status Graph::SetOuterScopeNodeArgs(const std::unordered_set<std::string
 
     std::transform(resolve_context_.output_args.cbegin(), resolve_context_.output_args.cend(),
                    std::inserter(node_args_in_scope_for_subgraph, node_args_in_scope_for_subgraph.end()),
-                   [](const std::pair<std::string, std::pair<Node*, int>>& entry) { return entry.first; });
+                   [](const std::pair<const NodeArg* const, std::pair<Node*, int>>& entry) {
+                     return entry.first->Name();
+                   });
 
     for (auto* node : resolve_context_.nodes_with_subgraphs) {
       for (auto& subgraph : node->MutableSubgraphs()) {
@@ -951,7 +962,7 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
             input_slot_index += static_cast<int>(iter - implicit_inputs.cbegin());
           }
 
-          auto entry = resolve_context_.output_args.find(node_arg_name);
+          auto entry = resolve_context_.output_args.find(node_arg);
           if (entry != resolve_context_.output_args.end()) {
             // Create relationship between this node (node), and the node providing the output (output_node).
             Node& output_node = *entry->second.first;
@@ -988,8 +999,7 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
           continue;
         }
 
-        const auto& input_arg_name = input_arg->Name();
-        auto output_arg_iter = resolve_context_.output_args.find(input_arg_name);
+        auto output_arg_iter = resolve_context_.output_args.find(input_arg);
         if (resolve_context_.output_args.end() != output_arg_iter) {
           // The input to this node is an output from a previous node in this graph.
           // Create relationship between this node (node), and the node providing the output (output_node).
@@ -1001,6 +1011,7 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
           // the value is either an input, an initializer, or coming from outer scope. we only need to take action
           // if coming from outer scope, so first check if this is a subgraph (otherwise there is no outer scope).
           if (parent_graph_ != nullptr) {
+            const auto& input_arg_name = input_arg->Name();
             // make sure it's not an input or initializer first as those override any outer scope values
             if (resolve_context_.inputs_and_initializers.find(input_arg_name) ==
                 resolve_context_.inputs_and_initializers.cend()) {
@@ -1092,10 +1103,13 @@ void Graph::ReverseDFSFrom(const std::vector<const Node*>& from,
 GSL_SUPPRESS(es .84)  // noisy warning about ignoring return value from insert(...)
 Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
   nodes_in_topological_order_.clear();
+  nodes_in_topological_order_.reserve(static_cast<size_t>(NumberOfNodes()));
+  // the sets of nodes are indexed by NodeIndex, as hashing every visit is slow for large graphs.
   // nodes that have been processed and added to nodes_in_topological_order.
-  std::unordered_set<NodeIndex> processed_nodes;
-  std::unordered_set<NodeIndex> output_nodes;
-  std::unordered_set<NodeIndex> nodes_added_for_processing;
+  const size_t max_node_index = static_cast<size_t>(MaxNodeIndex());
+  std::vector<bool> processed_nodes(max_node_index, false);
+  std::vector<bool> output_nodes(max_node_index, false);
+  std::vector<bool> nodes_added_for_processing(max_node_index, false);
   std::stack<NodeIndex> stack;
 
   // push the top level nodes into nodes_in_topological_order in the order they were added
@@ -1108,7 +1122,7 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
                   // find the top level nodes in the graph.
                   // need to also consider nodes that only have Constants as inputs as top level nodes,
                   // as the constant will get replaced by an initializer.
-                  auto input_edges = node.GetRelationships().input_edges;
+                  const auto& input_edges = node.GetRelationships().input_edges;
                   auto has_inputs = std::any_of(input_edges.cbegin(), input_edges.cend(), [](const Node::EdgeEnd& edge) {
                     return edge.GetNode().OpType() != kConstant;
                   });
@@ -1116,10 +1130,10 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
                   if (!has_inputs) {
                     // add to the topological list, and ensure we skip these nodes when walking the graph
                     nodes_in_topological_order_.push_back(index);
-                    processed_nodes.insert(index);
+                    processed_nodes[index] = true;
 
                     // mark this as added as we've fully processed it and don't need to do it again later
-                    nodes_added_for_processing.insert(index);
+                    nodes_added_for_processing[index] = true;
                   }
                 });
 
@@ -1135,16 +1149,16 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
     const NodeIndex current = stack.top();
     stack.pop();
 
-    if (processed_nodes.find(current) != processed_nodes.end()) {
+    if (processed_nodes[current]) {
       continue;
     }
 
-    if (nodes_added_for_processing.find(current) != nodes_added_for_processing.end()) {
+    if (nodes_added_for_processing[current]) {
       // we popped the stack and are back to a node that was added previously,
       // so we know all the upstream nodes from it have been fully processed,
       nodes_in_topological_order_.push_back(current);
-      processed_nodes.insert(current);
-      output_nodes.erase(current);
+      processed_nodes[current] = true;
+      output_nodes[current] = false;
       continue;
     }
 
@@ -1154,22 +1168,22 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
     }
 
     stack.push(current);
-    output_nodes.insert(current);
+    output_nodes[current] = true;
 
     for (auto iter = node->InputNodesBegin(); iter != node->InputNodesEnd(); ++iter) {
       const NodeIndex idx = (*iter).Index();
-      if (output_nodes.find(idx) != output_nodes.end()) {
+      if (output_nodes[idx]) {
         Status status(ONNXRUNTIME, FAIL, "This is an invalid model. Error: the graph is not acyclic.");
         return status;
       }
 
       // avoid re-processing nodes
-      if (nodes_added_for_processing.find(idx) == nodes_added_for_processing.end()) {
+      if (!nodes_added_for_processing[idx]) {
         stack.push(idx);
       }
     }
 
-    nodes_added_for_processing.insert(current);
+    nodes_added_for_processing[current] = true;
   }
 
   if (num_of_nodes_ >= 0 && static_cast<size_t>(num_of_nodes_) == nodes_in_topological_order_.size()) {
@@ -1649,6 +1663,55 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+static void CombineHash(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static void CombineNodeArgHash(size_t& seed, const NodeArg* node_arg) {
+  CombineHash(seed, std::hash<const NodeArg*>{}(node_arg));
+  CombineHash(seed, std::hash<const void*>{}(node_arg->Type()));
+
+  const TensorShapeProto* shape = node_arg->Shape();
+  if (shape == nullptr) {
+    CombineHash(seed, std::numeric_limits<size_t>::max());
+    return;
+  }
+
+  CombineHash(seed, static_cast<size_t>(shape->dim_size()));
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim)) {
+      CombineHash(seed, std::hash<int64_t>{}(dim.dim_value()));
+    } else {
+      CombineHash(seed, std::hash<std::string>{}(dim.dim_param()));
+    }
+  }
+}
+
+// The inputs of type and shape inferencing of a node other than its attributes: its schema, the types and shapes of
+// its inputs and outputs, and the initializers, whose values some inferencing functions read.
+static size_t ComputeInferenceSignature(const Node& node, const Graph& graph) {
+  size_t seed = std::hash<const void*>{}(node.Op());
+
+  for (int arg_count : node.InputArgCount()) {
+    CombineHash(seed, std::hash<int>{}(arg_count));
+  }
+
+  for (const auto* input_def : node.InputDefs()) {
+    CombineNodeArgHash(seed, input_def);
+
+    const TensorProto* initializer = nullptr;
+    if (input_def->Exists() && graph.GetInitializedTensor(input_def->Name(), initializer)) {
+      CombineHash(seed, std::hash<const void*>{}(initializer));
+    }
+  }
+
+  for (const auto* output_def : node.OutputDefs()) {
+    CombineNodeArgHash(seed, output_def);
+  }
+
+  return seed;
+}
+
 Status Graph::VerifyNodeAndOpMatch() {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
@@ -1675,20 +1738,24 @@ Status Graph::VerifyNodeAndOpMatch() {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
-    auto iter = model_functions_.find(node.OpType());
-    if (iter != model_functions_.end()) {
-      const ONNX_NAMESPACE::FunctionProto* model_function_proto = iter->second;
-      auto model_func_ptr = std::make_unique<onnxruntime::FunctionImpl>(*this, node.Index(), model_function_proto);
-      function_container_.emplace_back(std::move(model_func_ptr));
-      node.SetFunctionBody(*function_container_.back());
+    // the function body of a model function is created once, and kept over later calls to Resolve
+    if (node.GetFunctionBody() == nullptr) {
+      auto iter = model_functions_.find(node.OpType());
+      if (iter != model_functions_.end()) {
+        const ONNX_NAMESPACE::FunctionProto* model_function_proto = iter->second;
+        auto model_func_ptr = std::make_unique<onnxruntime::FunctionImpl>(*this, node.Index(), model_function_proto);
+        function_container_.emplace_back(std::move(model_func_ptr));
+        node.SetFunctionBody(*function_container_.back());
+      }
     }
 
     if (!node.Op()) {
+      // only a node without a schema, which is new since the last Resolve, is checked against the ONNX spec
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       try {
         checker::check_node(node_proto, ctx, lsc);
       } catch (const std::exception& ex) {
@@ -1716,6 +1783,18 @@ Status Graph::VerifyNodeAndOpMatch() {
 
     ORT_RETURN_IF_ERROR(node.UpdateInputArgCount());
 
+    // Accumulate output names of the iterated Node
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
+    }
+
+    // Nothing the inferencing of the node reads has changed since it last succeeded, and its default attributes
+    // were filled then. Subgraphs are not part of the signature so nodes with them are always inferred.
+    if (node.inference_signature_valid_ && !node.ContainsSubgraph() &&
+        node.inference_signature_ == ComputeInferenceSignature(node, *this)) {
+      continue;
+    }
+
     // currently an Op is required by ValidateVersion, so we use gsl::not_null to validate that.
     // This may change in the future to allow a null Op
     const gsl::not_null<const OpSchema*> p_op{node.Op()};
@@ -1747,10 +1826,8 @@ Status Graph::VerifyNodeAndOpMatch() {
 
     NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
 
-    // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
-    }
+    node.inference_signature_ = ComputeInferenceSignature(node, *this);
+    node.inference_signature_valid_ = true;
   }
 
   return Status::OK();
@@ -445,6 +445,11 @@ size_t RemoveNodeOutputEdges(Graph& graph, Node& node) {
   return output_edges.size();
 }
 
+bool HasSingleConsumer(const Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(node) &&
+         node.OutputNodesBegin()->GetExecutionProviderType() == node.GetExecutionProviderType();
+}
+
 }  // namespace graph_utils
 
 }  // namespace onnxruntime
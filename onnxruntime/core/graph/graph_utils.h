@@ -100,6 +100,10 @@ bool RemoveNode(Graph& graph, Node& node);
     This should probably be elevated to the Graph API eventually. */
 size_t RemoveNodeOutputEdges(Graph& graph, Node& node);
 
+/** Checks if the outputs of the given Node are consumed by a single Node assigned to the same execution provider,
+    and are not graph outputs, so that a fusion can remove the Node. */
+bool HasSingleConsumer(const Graph& graph, const Node& node);
+
 }  // namespace graph_utils
 
 }  // namespace onnxruntime
@@ -204,6 +204,20 @@ const ModelMetaData& Model::MetaData() const noexcept {
   return model_metadata_;
 }
 
+void Model::SetMetaDataValue(const std::string& key, const std::string& value) {
+  model_metadata_[key] = value;
+  for (auto& prop : *model_proto_->mutable_metadata_props()) {
+    if (prop.key() == key) {
+      prop.set_value(value);
+      return;
+    }
+  }
+
+  const gsl::not_null<StringStringEntryProto*> prop{model_proto_->add_metadata_props()};
+  prop->set_key(key);
+  prop->set_value(value);
+}
+
 Graph& Model::MainGraph() noexcept {
   return *graph_;
 }
@@ -379,6 +393,13 @@ Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOp
   FileInputStream fs(fd);
   const bool result = model_proto->ParseFromZeroCopyStream(&fs) && fs.GetErrno() == 0;
   if (!result) {
+    // protobuf can't parse a message of 2GB or more, which larger models avoid by storing their initializers as
+    // external data
+    if (fs.ByteCount() >= INT_MAX) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF,
+                             "Protobuf parsing failed. The model is larger than the 2GB protobuf limit, "
+                             "and needs its initializers stored as external data to be loaded.");
+    }
     return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
   }
 #else
@@ -75,6 +75,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Set the value of a metadata property, adding it if the model doesn't have it.
+  void SetMetaDataValue(const std::string& key, const std::string& value);
 
   // Get model's main graph.
   Graph& MainGraph() noexcept;
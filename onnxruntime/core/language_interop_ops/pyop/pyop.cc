@@ -16,6 +16,9 @@
 #endif
 #include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 // #define LOAD_PYOP_SYM(n, v, m) ORT_ENFORCE(Env::Default().GetSymbolFromLibrary(handle_, n, reinterpret_cast<void**>(&v)) == Status::OK(), m)
 
 namespace onnxruntime {
@@ -45,9 +48,10 @@ PyCustomKernel::PyCustomKernel(Ort::CustomOpApi ort,
                                const std::string& module,
                                const std::string& class_name,
                                const std::string& compute,
-                               PyOpLogFunc logging_func) : ort_(ort), attrs_(attrs), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func) {
+                               PyOpLogFunc logging_func,
+                               int64_t max_batch_size) : ort_(ort), attrs_(attrs), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func), max_batch_size_(static_cast<size_t>(std::max<int64_t>(max_batch_size, 1))) {
   std::string err;
-  instance_ = PyOpLibProxy::GetInstance().new_instance_(module.c_str(), class_name_.c_str(), attrs_);
+  instance_ = PyOpLibProxy::GetInstance().new_instance_(module.c_str(), class_name_.c_str(), compute_.c_str(), attrs_);
   ORT_ENFORCE(nullptr != instance_, PyOpLibProxy::GetInstance().get_last_error_message_(err));
 }
 
@@ -64,30 +68,163 @@ void PyCustomKernel::GetOutputShape(OrtKernelContext*, size_t, OrtTensorTypeAndS
 void PyCustomKernel::Compute(OrtKernelContext* context) {
   ORT_ENFORCE(nullptr != context);
   auto inputs_count = (size_t) reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->InputCount();
-  std::vector<const void*> inputs;
-  std::vector<std::unique_ptr<char[]>> outputs;
-  std::vector<int32_t> inputs_type, outputs_elem_size;
-  std::vector<std::vector<int64_t>> inputs_dim, outputs_dim;
-
+  Call call;
+  call.context = context;
   for (size_t i = 0; i < inputs_count; ++i) {
     auto ort_value = ort_.KernelContext_GetInput(context, i);
-    inputs.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().DataRaw());
-    inputs_type.push_back(GetType(ort_value));
-    inputs_dim.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().Shape().GetDims());
+    const auto& tensor = ort_value->Get<Tensor>();
+    call.inputs.push_back(tensor.DataRaw());
+    call.inputs_type.push_back(GetType(ort_value));
+    call.inputs_dim.push_back(tensor.Shape().GetDims());
+    call.inputs_size.push_back(tensor.SizeInBytes());
+  }
+
+  if (max_batch_size_ == 1) {
+    Invoke(call, [this, context](size_t index, int32_t elem_size, const std::vector<int64_t>& dim) {
+      return AllocateOutput(context, index, elem_size, dim);
+    });
+    return;
   }
 
+  // The python calls run one at a time, so the calls that arrive in the meantime queue up and the thread that
+  // invokes python next takes the ones that batch with the first of them.
+  std::unique_lock<OrtMutex> lock(batch_mutex_);
+  pending_calls_.push_back(&call);
+  while (!call.done) {
+    if (invoking_) {
+      batch_cv_.wait(lock);
+      continue;
+    }
+
+    std::vector<Call*> batch;
+    for (auto it = pending_calls_.begin(); it != pending_calls_.end() && batch.size() < max_batch_size_;) {
+      if (batch.empty() || CanBatch(*batch.front(), **it)) {
+        batch.push_back(*it);
+        it = pending_calls_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    invoking_ = true;
+    lock.unlock();
+    std::string error;
+    try {
+      InvokeBatch(batch);
+    } catch (const std::exception& ex) {
+      error = ex.what();
+    }
+    lock.lock();
+
+    for (auto* batched_call : batch) {
+      batched_call->error = error;
+      batched_call->done = true;
+    }
+    invoking_ = false;
+    batch_cv_.notify_all();
+  }
+  lock.unlock();
+
+  ORT_ENFORCE(call.error.empty(), call.error);
+}
+
+void PyCustomKernel::Invoke(const Call& call, const PyOpAllocateFunc& allocate_output) const {
   std::string err;
-  ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, compute_.c_str(), inputs, inputs_type,
-                                                              inputs_dim, outputs, outputs_elem_size,
-                                                              outputs_dim, logging_func_),
+  ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, call.inputs, call.inputs_type,
+                                                              call.inputs_dim, allocate_output, logging_func_),
               PyOpLibProxy::GetInstance().get_last_error_message_(err));  //ORT_ENFORCE
+}
 
-  for (size_t i = 0; i < outputs.size(); ++i) {
-    auto ort_output = ort_.KernelContext_GetOutput(context, i, outputs_dim[i].data(), outputs_dim[i].size());
-    auto output_mem_addr = ort_.GetTensorMutableData<char>(ort_output);
-    auto output_len = std::accumulate(begin(outputs_dim[i]), end(outputs_dim[i]), static_cast<int64_t>(outputs_elem_size[i]), std::multiplies<int64_t>());
-    memcpy(output_mem_addr, outputs[i].get(), output_len);
+void PyCustomKernel::InvokeBatch(const std::vector<Call*>& calls) const {
+  if (calls.size() == 1) {
+    auto context = calls.front()->context;
+    Invoke(*calls.front(), [this, context](size_t index, int32_t elem_size, const std::vector<int64_t>& dim) {
+      return AllocateOutput(context, index, elem_size, dim);
+    });
+    return;
+  }
+
+  // the inputs of the calls are concatenated along their first dimension
+  Call batch;
+  std::vector<std::vector<char>> input_buffers(calls.front()->inputs.size());
+  batch.inputs_type = calls.front()->inputs_type;
+  for (size_t i = 0; i < input_buffers.size(); ++i) {
+    auto dim = calls.front()->inputs_dim[i];
+    dim[0] = 0;
+    size_t size = 0;
+    for (const auto* call : calls) {
+      dim[0] += call->inputs_dim[i][0];
+      size += call->inputs_size[i];
+    }
+
+    input_buffers[i].resize(size);
+    size_t offset = 0;
+    for (const auto* call : calls) {
+      memcpy(input_buffers[i].data() + offset, call->inputs[i], call->inputs_size[i]);
+      offset += call->inputs_size[i];
+    }
+    batch.inputs.push_back(input_buffers[i].data());
+    batch.inputs_dim.push_back(std::move(dim));
+  }
+
+  std::vector<std::vector<char>> output_buffers;
+  std::vector<std::vector<int64_t>> outputs_dim;
+  std::vector<int32_t> outputs_elem_size;
+  Invoke(batch, [&](size_t index, int32_t elem_size, const std::vector<int64_t>& dim) -> void* {
+    if (output_buffers.size() <= index) {
+      output_buffers.resize(index + 1);
+      outputs_dim.resize(index + 1);
+      outputs_elem_size.resize(index + 1);
+    }
+    output_buffers[index].resize(std::accumulate(dim.begin(), dim.end(), static_cast<size_t>(elem_size),
+                                                 std::multiplies<size_t>()));
+    outputs_dim[index] = dim;
+    outputs_elem_size[index] = elem_size;
+    return output_buffers[index].data();
+  });
+
+  // and the outputs are split back along theirs
+  const auto batch_size = batch.inputs_dim[0][0];
+  for (size_t i = 0; i < output_buffers.size(); ++i) {
+    ORT_ENFORCE(!outputs_dim[i].empty() && outputs_dim[i][0] == batch_size, "PyOp output ", i,
+                " of a batched call must have a first dimension of ", batch_size);
+    const size_t row_size = batch_size > 0 ? output_buffers[i].size() / static_cast<size_t>(batch_size) : 0;
+    size_t offset = 0;
+    for (const auto* call : calls) {
+      auto dim = outputs_dim[i];
+      dim[0] = call->inputs_dim[0][0];
+      auto output = AllocateOutput(call->context, i, outputs_elem_size[i], dim);
+      ORT_ENFORCE(nullptr != output, "PyOp failed to allocate output ", i);
+      const size_t size = row_size * static_cast<size_t>(dim[0]);
+      memcpy(output, output_buffers[i].data() + offset, size);
+      offset += size;
+    }
+  }
+}
+
+void* PyCustomKernel::AllocateOutput(OrtKernelContext* context, size_t index, int32_t elem_size,
+                                     const std::vector<int64_t>& dim) const {
+  auto ort_output = ort_.KernelContext_GetOutput(context, index, dim.data(), dim.size());
+  auto tensor = ort_output->GetMutable<Tensor>();
+  if (tensor->DataType()->Size() != static_cast<size_t>(elem_size)) {
+    logging_func_("PyCustomKernel: the type of a returned numpy does not match the type of the output");
+    return nullptr;
+  }
+  return tensor->MutableDataRaw();
+}
+
+// the calls of a batch have inputs of the same types and dimensions, but for the first one, shared by the inputs
+bool PyCustomKernel::CanBatch(const Call& first, const Call& call) {
+  for (size_t i = 0; i < first.inputs_dim.size(); ++i) {
+    const auto& first_dim = first.inputs_dim[i];
+    const auto& dim = call.inputs_dim[i];
+    if (first.inputs_type[i] != call.inputs_type[i] || first_dim.empty() || dim.size() != first_dim.size() ||
+        !std::equal(dim.begin() + 1, dim.end(), first_dim.begin() + 1) ||
+        first_dim[0] != first.inputs_dim[0][0] || dim[0] != call.inputs_dim[0][0]) {
+      return false;
+    }
   }
+  return true;
 }
 
 int32_t PyCustomKernel::GetType(const OrtValue* input) const {
@@ -128,10 +265,11 @@ PyCustomOp::PyCustomOp(const OnnxAttrs& attrs,
                        const std::string& module,
                        const std::string& class_name,
                        const std::string& compute,
-                       PyOpLogFunc logging_func) : attrs_(attrs), inputs_type_(inputs_type), outputs_type_(outputs_type), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func) { OrtCustomOp::version = ORT_API_VERSION; }
+                       PyOpLogFunc logging_func,
+                       int64_t max_batch_size) : attrs_(attrs), inputs_type_(inputs_type), outputs_type_(outputs_type), module_(module), class_name_(class_name), compute_(compute), logging_func_(logging_func), max_batch_size_(max_batch_size) { OrtCustomOp::version = ORT_API_VERSION; }
 
 void* PyCustomOp::CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo*) {
-  return new PyCustomKernel(api, attrs_, module_, class_name_, compute_, logging_func_);
+  return new PyCustomKernel(api, attrs_, module_, class_name_, compute_, logging_func_, max_batch_size_);
 }
 
 const char* PyCustomOp::GetName() const { return "PyOp"; }
@@ -146,6 +284,7 @@ PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc lo
   OnnxAttrs onnx_attrs;
   OnnxTypes input_types, output_types;
   std::string module, class_name, compute = "compute";
+  int64_t max_batch_size = 1;
   for (int j = 0; j < node_proto.attribute_size(); ++j) {
     const auto& attr = node_proto.attribute(j);
     if (utils::HasString(attr)) {
@@ -157,6 +296,8 @@ PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc lo
         compute = attr.s();
       else
         onnx_attrs[attr.name()] = attr.s();
+    } else if (utils::HasInt(attr) && attr.name() == "max_batch_size") {
+      max_batch_size = attr.i();
     } else if (attr.ints_size() > 0) {
       if (attr.name() == "input_types") {
         for (int k = 0; k < attr.ints_size(); ++k) {
@@ -173,6 +314,7 @@ PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc lo
   ORT_ENFORCE(class_name != "", "PyOp class name not specified");
   ORT_ENFORCE(!input_types.empty(), "PyOp node inputs not specified");
   ORT_ENFORCE(!output_types.empty(), "PyOp node outputs not specified");
-  return new PyCustomOp(onnx_attrs, input_types, output_types, module, class_name, compute, log_func);
+  ORT_ENFORCE(max_batch_size > 0, "PyOp max_batch_size must be positive");
+  return new PyCustomOp(onnx_attrs, input_types, output_types, module, class_name, compute, log_func, max_batch_size);
 }
 }  // namespace onnxruntime
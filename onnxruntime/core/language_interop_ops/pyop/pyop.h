@@ -4,6 +4,8 @@
 #include "core/framework/ml_value.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/ort_mutex.h"
+#include <deque>
 #include <iostream>
 #include <vector>
 #include <unordered_map>
@@ -18,20 +20,19 @@ namespace onnxruntime {
 using OnnxTypes   = std::vector<ONNXTensorElementDataType>;
 using OnnxAttrs   = std::unordered_map<std::string, std::string>;
 using PyOpLogFunc = std::function<void(const char*)>;
+// allocates output i of the given element size and dimensions, the data of the numpy is copied into
+using PyOpAllocateFunc = std::function<void*(size_t, int32_t, const std::vector<int64_t>&)>;
 
 typedef bool Initialize();
 typedef void ReleaseInstance(void*);
 typedef bool InvokePythonFunc(void*,
-                              const char*,
                               const std::vector<const void*>&,
                               const std::vector<int32_t>&,
                               const std::vector<std::vector<int64_t>>&,
-                              std::vector<std::unique_ptr<char[]>>&,
-                              std::vector<int32_t>&,
-                              std::vector<std::vector<int64_t>>&,
+                              const PyOpAllocateFunc&,
                               std::function<void(const char*)>);
 typedef const char* GetLastErrorMessage(std::string&);
-typedef void* NewInstance(const char*, const char*, const OnnxAttrs&);
+typedef void* NewInstance(const char*, const char*, const char*, const OnnxAttrs&);
 
 class PyOpLibProxy {
 
@@ -55,12 +56,29 @@ struct PyCustomKernel {
                    const std::string& module,
                    const std::string& class_name,
                    const std::string& compute,
-                   PyOpLogFunc        logging_func);
+                   PyOpLogFunc        logging_func,
+                   int64_t            max_batch_size = 1);
     ~PyCustomKernel();
     void    GetOutputShape(OrtKernelContext*, size_t, OrtTensorTypeAndShapeInfo*);
     void    Compute(OrtKernelContext* context);
     int32_t GetType(const OrtValue* input) const;
 private:
+    // the inputs of a call of Compute, whose outputs are allocated in its context
+    struct Call {
+        OrtKernelContext*                 context = nullptr;
+        std::vector<const void*>          inputs;
+        std::vector<int32_t>              inputs_type;
+        std::vector<std::vector<int64_t>> inputs_dim;
+        std::vector<size_t>               inputs_size;
+        bool                              done = false;
+        std::string                       error;
+    };
+    void    Invoke(const Call& call, const PyOpAllocateFunc& allocate_output) const;
+    void    InvokeBatch(const std::vector<Call*>& calls) const;
+    void*   AllocateOutput(OrtKernelContext* context, size_t index, int32_t elem_size,
+                           const std::vector<int64_t>& dim) const;
+    static bool CanBatch(const Call& first, const Call& call);
+
     Ort::CustomOpApi ort_;
     OnnxAttrs        attrs_;
     std::string      module_;
@@ -68,6 +86,13 @@ private:
     std::string      compute_;
     void*            instance_ = nullptr;
     PyOpLogFunc      logging_func_;
+    // the calls of Compute that arrive while python runs another one are invoked together, up to this number,
+    // concatenated along the first dimension of their inputs and outputs
+    size_t           max_batch_size_;
+    OrtMutex         batch_mutex_;
+    OrtCondVar       batch_cv_;
+    std::deque<Call*> pending_calls_;
+    bool             invoking_ = false;
 };
 
 struct PyCustomOp: Ort::CustomOpBase<PyCustomOp, PyCustomKernel> {
@@ -77,8 +102,9 @@ struct PyCustomOp: Ort::CustomOpBase<PyCustomOp, PyCustomKernel> {
                const OnnxTypes&    outputs_type,
                const std::string&  module,
                const std::string&  class_name,
-               const std::string&  compute      = "compute",
-               PyOpLogFunc         logging_func = [](const char*){});
+               const std::string&  compute        = "compute",
+               PyOpLogFunc         logging_func   = [](const char*){},
+               int64_t             max_batch_size = 1);
     void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo*);
     const char* GetName() const;
     size_t GetInputTypeCount() const;
@@ -93,6 +119,7 @@ private:
     std::string    class_name_;
     std::string    compute_;
     PyOpLogFunc    logging_func_;
+    int64_t        max_batch_size_;
 };//struct PyCustomOp
 
 PyCustomOp* LoadPyOp(const ONNX_NAMESPACE::NodeProto& node_proto, PyOpLogFunc log_func);
@@ -90,47 +90,54 @@ PYOP_EXPORT const char* GetLastErrorMessage(std::string& err) {
     return err.c_str();
 }
 
+using AllocateOutputFunc = std::function<void*(size_t, int32_t, const vector<int64_t>&)>;
+
+struct Instance
+{
+    PyObject* object   = nullptr;
+    PyObject* function = nullptr;
+    PyObject* args     = nullptr;//reused across calls as long as python keeps no reference to it
+};
+
+//a read-only view over the data of a tensor, which is only valid during the call
 PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim) {
     std::vector<npy_intp> np_dim;
     for (auto d: dim) {
         np_dim.push_back(static_cast<npy_intp>(d));
     }
-    auto pyObj = static_cast<PyObject*>(PyArray_EMPTY(static_cast<int>(np_dim.size()), np_dim.data(), type, 0));
-    auto data_len = std::accumulate(begin(np_dim), end(np_dim),
-                                    static_cast<int64_t>(PyArray_DescrFromType(type)->elsize),
-                                    std::multiplies<int64_t>());
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    memcpy(PyArray_DATA(np_array), data, data_len);
+    auto pyObj = PyArray_SimpleNewFromData(static_cast<int>(np_dim.size()), np_dim.data(), type, const_cast<void*>(data));
+    if (nullptr != pyObj) {
+        PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(pyObj), NPY_ARRAY_WRITEABLE);
+    }
     return pyObj;
 }
 
-bool ExtractOutput(PyObject*                   pyObj,
-                   vector<unique_ptr<char[]>>& outputs,
-                   vector<int32_t>&            outputs_elem_size,
-                   vector<vector<int64_t>>&    outputs_dim) {
+//copies the data of a numpy straight into the output allocated for it
+bool ExtractOutput(PyObject*                 pyObj,
+                   size_t                    index,
+                   const AllocateOutputFunc& allocate_output) {
     if (!PyArray_Check(pyObj)) {
         return false;
     }
 
-    outputs_dim.push_back({});
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
-
-    for (int i = 0; i < PyArray_NDIM(np_array); ++i) {
-        outputs_dim.back().push_back(PyArray_SHAPE(np_array)[i]);
+    auto np_array = PyArray_GETCONTIGUOUS(reinterpret_cast<PyArrayObject*>(pyObj));
+    if (nullptr == np_array) {
+        return false;
     }
 
-    auto data_len = std::accumulate(begin(outputs_dim.back()),
-                                    end(outputs_dim.back()),
-                                    static_cast<int64_t>(outputs_elem_size.back()),
-                                    std::multiplies<int64_t>());
-
-    outputs.push_back(unique_ptr<char[]>(new char[data_len]));
-    memcpy(static_cast<void*>(outputs.back().get()), PyArray_DATA(np_array), data_len);
-    return true;
+    vector<int64_t> dim(PyArray_SHAPE(np_array), PyArray_SHAPE(np_array) + PyArray_NDIM(np_array));
+    auto output = allocate_output(index, static_cast<int32_t>(PyArray_ITEMSIZE(np_array)), dim);
+    if (nullptr != output) {
+        memcpy(output, PyArray_DATA(np_array), PyArray_NBYTES(np_array));
+    }
+    Py_DECREF(np_array);
+    return nullptr != output;
 }
 
-PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const unordered_map<string, string>& args) {
+PYOP_EXPORT void* NewInstance(const char*                         module,
+                              const char*                         class_name,
+                              const char*                         function,
+                              const unordered_map<string, string>& args) {
     Scope scope; 
     auto pyModule = PyImport_ImportModule(module);
     if (nullptr == pyModule) {
@@ -149,65 +156,106 @@ PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const
     auto named_args = PyDict_New();
     scope.Add(named_args);
     for (const auto& iter: args) {
-        PyDict_SetItemString(named_args, iter.first.c_str(), PyUnicode_FromString(iter.second.c_str()));
+        auto pyValue = PyUnicode_FromString(iter.second.c_str());
+        scope.Add(pyValue);
+        PyDict_SetItemString(named_args, iter.first.c_str(), pyValue);
+    }
+
+    auto pyObj = PyObject_Call(pyClass, empty_args, named_args);
+    if (nullptr == pyObj) {
+        return nullptr;
+    }
+
+    //the function is looked up once for all the calls
+    auto pyFunc = PyObject_GetAttrString(pyObj, function);
+    if (nullptr == pyFunc) {
+        scope.Add(pyObj);
+        return nullptr;
     }
 
-    return PyObject_Call(pyClass, empty_args, named_args);
+    auto instance = new Instance;
+    instance->object   = pyObj;
+    instance->function = pyFunc;
+    return instance;
 }
 
-PYOP_EXPORT void ReleaseInstance(void* instance) {
-    Scope scope({static_cast<PyObject*>(instance)});
+PYOP_EXPORT void ReleaseInstance(void* raw_inst) {
+    auto instance = static_cast<Instance*>(raw_inst);
+    Scope scope({instance->args, instance->function, instance->object});
+    delete instance;
 }
 
 PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
-                                  const char*                      function,
                                   const vector<const void*>&       inputs,
                                   const vector<int32_t>&           inputs_type,
                                   const vector<vector<int64_t>>&   inputs_dim,
-                                  vector<unique_ptr<char[]>>&      outputs,
-                                  vector<int32_t>&                 outputs_elem_size,
-                                  vector<vector<int64_t>>&         outputs_dim,
+                                  const AllocateOutputFunc&        allocate_output,
                                   std::function<void(const char*)> logging_func) {
     Scope scope;
-    auto instance = static_cast<PyObject*>(raw_inst);
-    if (nullptr == instance || nullptr == function) {
+    auto instance = static_cast<Instance*>(raw_inst);
+    if (nullptr == instance || nullptr == instance->function) {
         logging_func("InvokePythonFunc: found invalid instance or function");
         return false;
     }
 
-    auto pyFunc = PyObject_GetAttrString(instance, function);
-    if (nullptr == pyFunc) {
-        logging_func("InvokePythonFunc: failed to create function object");
-        return false;
+    //python may only keep the arguments of a call if they are not reused
+    if (nullptr != instance->args && Py_REFCNT(instance->args) > 1) {
+        Py_DECREF(instance->args);
+        instance->args = nullptr;
+    }
+    if (nullptr == instance->args) {
+        instance->args = PyTuple_New(inputs.size());
+        if (nullptr == instance->args) {
+            logging_func("InvokePythonFunc: failed to create arguments");
+            return false;
+        }
     }
 
-    scope.Add(pyFunc);
-    auto pyArgs = PyTuple_New(inputs.size());
+    auto pyArgs = instance->args;
     for (size_t i = 0; i < inputs.size(); ++i) {
-        PyTuple_SetItem(pyArgs, i, MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]));
+        auto pyObj = MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]);
+        if (nullptr == pyObj) {
+            logging_func("InvokePythonFunc: failed to create input");
+            return false;
+        }
+        PyTuple_SetItem(pyArgs, i, pyObj);
     }
 
-    scope.Add(pyArgs);
-    auto pyResult = PyEval_CallObject(pyFunc, pyArgs);
+    auto pyResult = PyObject_CallObject(instance->function, pyArgs);
+    bool succeeded = true;
     if (nullptr == pyResult) {
         logging_func("InvokePythonFunc: no result");
-        return false;
-    }
-
-    scope.Add(pyResult);
-    if (PyArray_Check(pyResult)) {
-        ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim);
+        succeeded = false;
+    } else if (PyArray_Check(pyResult)) {
+        succeeded = ExtractOutput(pyResult, 0, allocate_output);
+        if (!succeeded) {
+            logging_func("InvokePythonFunc: failed to extract output");
+        }
     } else if (PyTuple_Check(pyResult)) {
-        for (int32_t i = 0; i < PyTuple_Size(pyResult); ++i) {
-            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim)) {
+        for (int32_t i = 0; i < PyTuple_Size(pyResult) && succeeded; ++i) {
+            succeeded = ExtractOutput(PyTuple_GetItem(pyResult, i), static_cast<size_t>(i), allocate_output);
+            if (!succeeded) {
                 logging_func("InvokePythonFunc: failed to extract output");
-                return false;
             }
         }
     } else {
         logging_func("InvokePythonFunc: returned value must be numpy(s)");
-        return false;
+        succeeded = false;
     }
-    return true;
+    Py_XDECREF(pyResult);
+
+    //the views are over tensors that are released after the call
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (Py_REFCNT(PyTuple_GET_ITEM(pyArgs, i)) > 1) {
+            logging_func("InvokePythonFunc: a reference to an input is kept beyond the call, copy it instead");
+        }
+    }
+    if (Py_REFCNT(pyArgs) == 1) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            Py_INCREF(Py_None);
+            PyTuple_SetItem(pyArgs, i, Py_None);
+        }
+    }
+    return succeeded;
 }//bool InvokePythonFunc
 }//namespace onnxruntime
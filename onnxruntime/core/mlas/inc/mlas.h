@@ -68,6 +68,38 @@ MlasGetPreferredBufferAlignment(
     void
     );
 
+//
+// Instruction sets that the platform kernels are dispatched for. The baseline
+// is SSE2 on x86/x64 and the only instruction set on other targets. AVX2
+// includes the FMA3 kernels.
+//
+// MlasSetMaximumIsa limits the kernel selection for testing and benchmarking
+// the dispatch paths and must not be called while other library routines are
+// executing.
+//
+
+enum MLAS_ISA {
+    MlasIsaBaseline,
+    MlasIsaAvx,
+    MlasIsaAvx2,
+    MlasIsaAvx512F,
+    MlasIsaAvx512BW,
+    MlasIsaAvx512Vnni,
+    MlasIsaMaximum = MlasIsaAvx512Vnni,
+};
+
+MLAS_ISA
+MLASCALL
+MlasSetMaximumIsa(
+    MLAS_ISA MaximumIsa
+    );
+
+MLAS_ISA
+MLASCALL
+MlasGetIsa(
+    void
+    );
+
 //
 // Activation routines.
 //
@@ -129,6 +161,199 @@ MlasSgemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Single precision matrix/matrix multiply routine with a matrix B packed once
+// by MlasSgemmPackB, for matrices that are reused across calls. The packed
+// buffer must be aligned to MlasGetPreferredBufferAlignment().
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine with a block sparse matrix B
+// packed once by MlasSgemmPackBSparse. Blocks of 16 columns by 16 rows of
+// matrix B that only hold zeros are dropped from the packed buffer and skipped
+// by the multiply. MlasSgemmPackBSparseSize returns zero if too few blocks are
+// zero for the sparse multiply to be faster than MlasSgemm with MlasSgemmPackB.
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSparseSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSgemmPackBSparse(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmSparse(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine for a batch of matrices
+// separated by constant strides. The work of the whole batch is partitioned
+// across threads in one dispatch, so batches of small matrices still scale
+// across cores. A stride of zero reuses the same matrix for every multiply.
+//
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Reduced precision matrix/matrix multiply routines. Matrices A and B stay in
+// half precision (IEEE binary16) or bfloat16 in memory and are expanded to
+// single precision a panel at a time, so the product is accumulated in single
+// precision at half of the input memory bandwidth.
+//
+
+void
+MLASCALL
+MlasHalfGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasBFloat16Gemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine with a matrix B stored
+// compressed, e.g. a weight kept at half of its size or less. Matrix B is
+// expanded to single precision a panel at a time while it is packed.
+//
+
+enum MLAS_COMPRESSED_FORMAT {
+    MlasCompressedHalf,
+    MlasCompressedInt8,
+};
+
+void
+MLASCALL
+MlasSgemmCompressedB(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* B,
+    MLAS_COMPRESSED_FORMAT FormatB,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Quantized integer matrix/matrix multiply routine.
 //
@@ -150,14 +375,86 @@ MlasQgemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Quantized integer matrix/matrix multiply routine with a matrix B packed once
+// by MlasQgemmPackB along with its column sums, for matrices that are reused
+// across calls. The packed buffer must be aligned to
+// MlasGetPreferredBufferAlignment().
+//
+
+size_t
+MLASCALL
+MlasQgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasQgemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Quantized integer matrix/matrix multiply routine for a batch of matrices
+// separated by constant strides, partitioned across threads like
+// MlasSgemmBatch.
+//
+
+void
+MLASCALL
+MlasQgemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    size_t StrideA,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    size_t StrideB,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
+// N.B. If MlasConvPrepare selects MlasConvAlgorithmWinograd, then the filter
+// passed to MlasConv must be transformed by MlasConvWinogradTransformFilter.
+//
 
 enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
+    MlasConvAlgorithmWinograd,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -186,6 +483,9 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileBlockSize;
+        } Winograd;
     } u;
 };
 
@@ -209,6 +509,21 @@ MlasConvPrepare(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Switches a convolution prepared by MlasConvPrepare to another algorithm, for
+// example to benchmark the alternatives. Returns false if the algorithm does
+// not support the convolution.
+//
+
+bool
+MLASCALL
+MlasConvSelectAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasConv(
@@ -221,6 +536,24 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    );
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
 //
 // Pooling routines.
 //
@@ -247,6 +580,21 @@ MlasPool(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasNhwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    size_t Dimensions,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -275,6 +623,30 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+//
+// Computes the softmax (or log softmax when LogSoftmax is true) of each of the
+// N rows of D elements. The rows are partitioned across threads.
+//
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -288,6 +660,15 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+extern "C"
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -324,6 +705,21 @@ MlasReorderFilterOIHWBo(
     float* D
     );
 
+//
+// Transposes the M x N matrix A into the N x M matrix B.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    size_t M,
+    size_t N,
+    const float* A,
+    size_t lda,
+    float* B,
+    size_t ldb
+    );
+
 //
 // Single precision NCHWc routines.
 //
@@ -369,3 +765,12 @@ MlasNchwcPool(
     float* Output,
     MLAS_THREADPOOL* ThreadPool
     );
+
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output
+    );
@@ -0,0 +1,205 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   ErfKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements a kernel for computing the error function for a
+;   buffer of elements.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasErfConstants:NEAR
+
+;
+; Structure layout for the erf constants block.
+;
+
+ErfConstants STRUCT
+
+        ErfUpperAbsRange DWORD ?
+        ErfSplitBoundary DWORD ?
+        ErfSMALL_P0 DWORD ?
+        ErfSMALL_P1 DWORD ?
+        ErfSMALL_P2 DWORD ?
+        ErfSMALL_P3 DWORD ?
+        ErfSMALL_P4 DWORD ?
+        ErfSMALL_P5_Minus_One DWORD ?
+        ErfReserve0 DWORD ?
+        ErfBIG_P0 DWORD ?
+        ErfBIG_P1 DWORD ?
+        ErfBIG_P2 DWORD ?
+        ErfBIG_P3 DWORD ?
+        ErfBIG_P4 DWORD ?
+        ErfBIG_P5 DWORD ?
+        ErfBIG_P6_Minus_One DWORD ?
+        ErfNegZero DWORD ?
+        ErfOne DWORD ?
+
+        Exp_UpperRange DWORD ?
+        Exp_LowerRange DWORD ?
+        Exp_Log2Reciprocal DWORD ?
+        Exp_log2_hi DWORD ?
+        Exp_log2_lo DWORD ?
+        Exp_P0 DWORD ?
+        Exp_P1 DWORD ?
+        Exp_P2 DWORD ?
+        Exp_P3 DWORD ?
+        Exp_P4 DWORD ?
+        Exp_P5 DWORD ?
+        Exp_P6 DWORD ?
+        Exp_C DWORD ?
+        Exp_X7F DWORD ?
+
+ErfConstants ENDS
+
+;
+; Macro Description:
+;
+;   This macro computes the error function for a vector of 16 elements.
+;
+; Arguments:
+;
+;   zmm0 - Supplies the input vector and returns the output vector.
+;
+; Implicit Arguments:
+;
+;   rax - Supplies the address of the erf constants block.
+;
+;   zmm16-zmm28 - Supplies the broadcasted erf constants.
+;
+
+ComputeErfBy16 MACRO
+
+        vpandd  zmm1,zmm0,zmm16                 ; vsign
+        vpandnd zmm0,zmm16,zmm0                 ; abs(vx)  va
+        vminps  zmm0,zmm0,zmm17                 ; force abs value in range
+        vmulps  zmm2,zmm0,zmm0                  ; vs (square)
+        vmovaps zmm3,zmm26
+        vfmadd213ps zmm3,zmm2,DWORD BCST ErfConstants.ErfSMALL_P1[rax]
+        vfmadd213ps zmm3,zmm2,DWORD BCST ErfConstants.ErfSMALL_P2[rax]
+        vfmadd213ps zmm3,zmm2,DWORD BCST ErfConstants.ErfSMALL_P3[rax]
+        vfmadd213ps zmm3,zmm2,DWORD BCST ErfConstants.ErfSMALL_P4[rax]
+        vfmadd213ps zmm3,zmm2,DWORD BCST ErfConstants.ErfSMALL_P5_Minus_One[rax]
+        vfmadd213ps zmm3,zmm0,zmm0
+        vcmpgtps k2,zmm0,zmm18                  ; vmask
+        knotw   k3,k2
+        vmovaps zmm3{k3}{z},zmm3                ; clear result for bigger numbers
+        vmovaps zmm0{k2}{z},zmm0                ; clear smaller numbers
+
+        vmovaps zmm4,zmm27
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P1[rax]
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P2[rax]
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P3[rax]
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P4[rax]
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P5[rax]
+        vfmadd213ps zmm4,zmm0,DWORD BCST ErfConstants.ErfBIG_P6_Minus_One[rax]
+        vfmadd213ps zmm4,zmm0,zmm0
+        vpxord  zmm4,zmm4,zmm16                 ; -r_big
+
+        vmaxps  zmm4,zmm4,zmm19                 ; expf(zmm4)
+        vmovaps zmm5,zmm20
+        vfmadd213ps zmm5,zmm4,zmm21
+        vsubps  zmm5,zmm5,zmm21                 ; vr = round()
+        vmovaps zmm2,zmm22
+        vfmadd213ps zmm2,zmm5,zmm4              ; vf = vr * log2_hi + ve
+        vfmadd231ps zmm2,zmm5,zmm23             ; vf += vr * log_2_lo
+        vmovaps zmm4,zmm28
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P1[rax]
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P2[rax]
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P3[rax]
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P4[rax]
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P5[rax]
+        vfmadd213ps zmm4,zmm2,DWORD BCST ErfConstants.Exp_P6[rax]
+        vcvttps2dq zmm5,zmm5
+        vpaddd  zmm5,zmm5,zmm24                 ; +127
+        vpslld  zmm5,zmm5,23
+        vmulps  zmm4,zmm4,zmm5                  ; 2^i * exp(vf)
+        vsubps  zmm4,zmm25,zmm4
+
+        vpord   zmm4,zmm4,zmm3                  ; merge small numbers' result
+        vpord   zmm0,zmm4,zmm1                  ; copy sign
+
+        ENDM
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the error function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8)  - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        LEAF_ENTRY MlasErfKernelAvx512F, _TEXT
+
+        lea     rax,MlasErfConstants
+        vbroadcastss zmm16,ErfConstants.ErfNegZero[rax]
+        vbroadcastss zmm17,ErfConstants.ErfUpperAbsRange[rax]
+        vbroadcastss zmm18,ErfConstants.ErfSplitBoundary[rax]
+        vbroadcastss zmm19,ErfConstants.Exp_LowerRange[rax]
+        vbroadcastss zmm20,ErfConstants.Exp_Log2Reciprocal[rax]
+        vbroadcastss zmm21,ErfConstants.Exp_C[rax]
+        vbroadcastss zmm22,ErfConstants.Exp_log2_hi[rax]
+        vbroadcastss zmm23,ErfConstants.Exp_log2_lo[rax]
+        vpbroadcastd zmm24,DWORD PTR ErfConstants.Exp_X7F[rax]
+        vbroadcastss zmm25,ErfConstants.ErfOne[rax]
+        vbroadcastss zmm26,ErfConstants.ErfSMALL_P0[rax]
+        vbroadcastss zmm27,ErfConstants.ErfBIG_P0[rax]
+        vbroadcastss zmm28,ErfConstants.Exp_P0[rax]
+
+        sub     r8,16
+        jb      ErfProcessRemainingCount
+
+ComputeErfBy16Loop:
+        vmovups zmm0,ZMMWORD PTR [rcx]
+        ComputeErfBy16
+        add     rcx,16*4                        ; advance input by 16 elements
+        vmovups ZMMWORD PTR [rdx],zmm0
+        add     rdx,16*4                        ; advance output by 16 elements
+        sub     r8,16
+        jae     ComputeErfBy16Loop
+
+ErfProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ErfExitKernel
+        mov     r9,rcx
+        mov     ecx,r8d
+        mov     r10d,1
+        shl     r10d,cl
+        dec     r10d
+        kmovw   k1,r10d                         ; compute mask for remaining elements
+        vmovups zmm0{k1}{z},ZMMWORD PTR [r9]
+        ComputeErfBy16
+        vmovups ZMMWORD PTR [rdx]{k1},zmm0
+
+ErfExitKernel:
+        vzeroupper
+        ret
+
+        LEAF_END MlasErfKernelAvx512F, _TEXT
+
+        END
@@ -0,0 +1,152 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   LogisticKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements a kernel for computing the logistic function for a
+;   buffer of elements.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasLogisticConstants:NEAR
+
+;
+; Structure layout for the logistic constants block.
+;
+
+LogisticConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        alpha_9 DWORD ?
+        alpha_7 DWORD ?
+        alpha_5 DWORD ?
+        alpha_3 DWORD ?
+        alpha_1 DWORD ?
+        beta_10 DWORD ?
+        beta_8 DWORD ?
+        beta_6 DWORD ?
+        beta_4 DWORD ?
+        beta_2 DWORD ?
+        beta_0 DWORD ?
+        one_half DWORD ?
+
+LogisticConstants ENDS
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the logistic function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8)  - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        LEAF_ENTRY MlasLogisticKernelAvx512F, _TEXT
+
+        lea     rax,MlasLogisticConstants
+        vbroadcastss zmm18,LogisticConstants.LowerRange[rax]
+        vbroadcastss zmm19,LogisticConstants.UpperRange[rax]
+        vbroadcastss zmm20,LogisticConstants.alpha_9[rax]
+        vbroadcastss zmm21,LogisticConstants.alpha_7[rax]
+        vbroadcastss zmm22,LogisticConstants.alpha_5[rax]
+        vbroadcastss zmm23,LogisticConstants.alpha_3[rax]
+        vbroadcastss zmm24,LogisticConstants.alpha_1[rax]
+        vbroadcastss zmm25,LogisticConstants.beta_10[rax]
+        vbroadcastss zmm26,LogisticConstants.beta_8[rax]
+        vbroadcastss zmm27,LogisticConstants.beta_6[rax]
+        vbroadcastss zmm28,LogisticConstants.beta_4[rax]
+        vbroadcastss zmm29,LogisticConstants.beta_2[rax]
+        vbroadcastss zmm30,LogisticConstants.beta_0[rax]
+        vbroadcastss zmm31,LogisticConstants.one_half[rax]
+        vpxord  zmm17,zmm17,zmm17
+
+        sub     r8,16
+        jb      ProcessRemainingCount
+
+ComputeLogisticBy16Loop:
+        vmaxps  zmm16,zmm18,ZMMWORD PTR [rcx]   ; clamp lower bound
+        vmovaps zmm2,zmm21
+        vminps  zmm16,zmm19,zmm16               ; clamp upper bound
+        vmulps  zmm1,zmm16,zmm16                ; x2
+        vmovaps zmm3,zmm26
+        vfmadd231ps zmm2,zmm1,zmm20             ; p = x2 * alpha_9 + alpha_7
+        vfmadd213ps zmm2,zmm1,zmm22             ; p = x2 * p + alpha_5
+        vfmadd213ps zmm2,zmm1,zmm23             ; p = x2 * p + alpha_3
+        vfmadd213ps zmm2,zmm1,zmm24             ; p = x2 * p + alpha_1
+        vfmadd231ps zmm3,zmm1,zmm25             ; q = x2 * beta_10 + beta_8
+        vfmadd213ps zmm3,zmm1,zmm27             ; q = x2 * q + beta_6
+        vfmadd213ps zmm3,zmm1,zmm28             ; q = x2 * q + beta_4
+        vfmadd213ps zmm3,zmm1,zmm29             ; q = x2 * q + beta_2
+        vfmadd213ps zmm3,zmm1,zmm30             ; q = x2 * q + beta_0
+        vmulps  zmm2,zmm16,zmm2                 ; p = x * p
+        vdivps  zmm2,zmm2,zmm3
+        vaddps  zmm0,zmm2,zmm31                 ; logistic = p / q + 0.5
+        vmaxps  zmm0,zmm17,zmm0                 ; clamp lower bound
+        add     rcx,16*4                        ; advance input by 16 elements
+        vmovups ZMMWORD PTR [rdx],zmm0
+        add     rdx,16*4                        ; advance output by 16 elements
+        sub     r8,16
+        jae     ComputeLogisticBy16Loop
+
+ProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ExitKernel
+        mov     r9,rcx
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; compute mask for remaining elements
+        vmovups zmm16{k1}{z},ZMMWORD PTR [r9]
+        vmaxps  zmm16,zmm18,zmm16               ; clamp lower bound
+        vmovaps zmm2,zmm21
+        vminps  zmm16,zmm19,zmm16               ; clamp upper bound
+        vmulps  zmm1,zmm16,zmm16                ; x2
+        vmovaps zmm3,zmm26
+        vfmadd231ps zmm2,zmm1,zmm20             ; p = x2 * alpha_9 + alpha_7
+        vfmadd213ps zmm2,zmm1,zmm22             ; p = x2 * p + alpha_5
+        vfmadd213ps zmm2,zmm1,zmm23             ; p = x2 * p + alpha_3
+        vfmadd213ps zmm2,zmm1,zmm24             ; p = x2 * p + alpha_1
+        vfmadd231ps zmm3,zmm1,zmm25             ; q = x2 * beta_10 + beta_8
+        vfmadd213ps zmm3,zmm1,zmm27             ; q = x2 * q + beta_6
+        vfmadd213ps zmm3,zmm1,zmm28             ; q = x2 * q + beta_4
+        vfmadd213ps zmm3,zmm1,zmm29             ; q = x2 * q + beta_2
+        vfmadd213ps zmm3,zmm1,zmm30             ; q = x2 * q + beta_0
+        vmulps  zmm2,zmm16,zmm2                 ; p = x * p
+        vdivps  zmm2,zmm2,zmm3
+        vaddps  zmm0,zmm2,zmm31                 ; logistic = p / q + 0.5
+        vmaxps  zmm0,zmm17,zmm0                 ; clamp lower bound
+        vmovups ZMMWORD PTR [rdx]{k1},zmm0
+
+ExitKernel:
+        vzeroupper
+        ret
+
+        LEAF_END MlasLogisticKernelAvx512F, _TEXT
+
+        END
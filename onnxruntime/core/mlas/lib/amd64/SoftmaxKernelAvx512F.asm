@@ -0,0 +1,326 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   SoftmaxKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements the kernels for the exponential function and the
+;   softmax function for a buffer of elements.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasExpConstants:NEAR
+
+;
+; Structure layout for the exponential constants block.
+;
+
+ExpConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        RoundingBias DWORD ?
+        Log2Reciprocal DWORD ?
+        Log2High DWORD ?
+        Log2Low DWORD ?
+        poly_0 DWORD ?
+        poly_1 DWORD ?
+        poly_2 DWORD ?
+        poly_3 DWORD ?
+        poly_4 DWORD ?
+        poly_5 DWORD ?
+        poly_6 DWORD ?
+
+ExpConstants ENDS
+
+;
+; Macro Description:
+;
+;   This macro loads the exponential constants into registers zmm16-zmm28.
+;
+; Arguments:
+;
+;   None.
+;
+
+LoadExpConstants MACRO
+
+        lea     rax,MlasExpConstants
+        vbroadcastss zmm16,ExpConstants.LowerRange[rax]
+        vbroadcastss zmm17,ExpConstants.UpperRange[rax]
+        vbroadcastss zmm18,ExpConstants.RoundingBias[rax]
+        vbroadcastss zmm19,ExpConstants.Log2Reciprocal[rax]
+        vbroadcastss zmm20,ExpConstants.Log2High[rax]
+        vbroadcastss zmm21,ExpConstants.Log2Low[rax]
+        vbroadcastss zmm22,ExpConstants.poly_0[rax]
+        vbroadcastss zmm23,ExpConstants.poly_1[rax]
+        vbroadcastss zmm24,ExpConstants.poly_2[rax]
+        vbroadcastss zmm25,ExpConstants.poly_3[rax]
+        vbroadcastss zmm26,ExpConstants.poly_4[rax]
+        vbroadcastss zmm27,ExpConstants.poly_5[rax]
+        vbroadcastss zmm28,ExpConstants.poly_6[rax]
+
+        ENDM
+
+;
+; Macro Description:
+;
+;   This macro computes the exponential function for a vector of 16 elements.
+;
+;   The scaling by 2^m is done with vscalefps, which produces infinity or a
+;   denormal result without overflowing the exponent of the power of two.
+;
+; Arguments:
+;
+;   zmm0 - Supplies the input vector and returns the output vector.
+;
+; Implicit Arguments:
+;
+;   zmm16-zmm28 - Supplies the broadcasted exponential constants.
+;
+
+ComputeExpBy16 MACRO
+
+        vmaxps  zmm0,zmm16,zmm0                 ; clamp lower bound
+        vmovaps zmm1,zmm18
+        vminps  zmm0,zmm17,zmm0                 ; clamp upper bound
+        vfmadd231ps zmm1,zmm0,zmm19             ; m = x * log2(e) + bias
+        vsubps  zmm1,zmm1,zmm18                 ; m = round(x * log2(e))
+        vfmadd231ps zmm0,zmm1,zmm20             ; f = m * log2_hi + x
+        vfmadd231ps zmm0,zmm1,zmm21             ; f = m * log2_lo + f
+        vmovaps zmm2,zmm22
+        vfmadd213ps zmm2,zmm0,zmm23             ; p = p * f + poly_1
+        vfmadd213ps zmm2,zmm0,zmm24             ; p = p * f + poly_2
+        vfmadd213ps zmm2,zmm0,zmm25             ; p = p * f + poly_3
+        vfmadd213ps zmm2,zmm0,zmm26             ; p = p * f + poly_4
+        vfmadd213ps zmm2,zmm0,zmm27             ; p = p * f + poly_5
+        vfmadd213ps zmm2,zmm0,zmm28             ; p = p * f + poly_6
+        vscalefps zmm0,zmm2,zmm1                ; exp = p * 2^m
+
+        ENDM
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the exponential function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8)  - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        LEAF_ENTRY MlasComputeExpF32KernelAvx512F, _TEXT
+
+        LoadExpConstants
+
+        sub     r8,16
+        jb      ComputeExpProcessRemainingCount
+
+ComputeExpBy16Loop:
+        vmovups zmm0,ZMMWORD PTR [rcx]
+        ComputeExpBy16
+        add     rcx,16*4                        ; advance input by 16 elements
+        vmovups ZMMWORD PTR [rdx],zmm0
+        add     rdx,16*4                        ; advance output by 16 elements
+        sub     r8,16
+        jae     ComputeExpBy16Loop
+
+ComputeExpProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ComputeExpExitKernel
+        mov     r9,rcx
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; compute mask for remaining elements
+        vmovups zmm0{k1}{z},ZMMWORD PTR [r9]
+        ComputeExpBy16
+        vmovups ZMMWORD PTR [rdx]{k1},zmm0
+
+ComputeExpExitKernel:
+        vzeroupper
+        ret
+
+        LEAF_END MlasComputeExpF32KernelAvx512F, _TEXT
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel to find the maximum value of
+;   the supplied buffer.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   N (rdx) - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   Returns the maximum value of the supplied buffer.
+;
+;--
+
+        LEAF_ENTRY MlasReduceMaximumF32KernelAvx512F, _TEXT
+
+        mov     eax,0FF7FFFFFh                  ; -FLT_MAX
+        vpbroadcastd zmm0,eax
+        vmovaps zmm1,zmm0
+        vmovaps zmm2,zmm0
+        vmovaps zmm3,zmm0
+
+        sub     rdx,64
+        jb      ReduceMaximumProcessRemainingCountBy16
+
+ReduceMaximumBy64Loop:
+        vmaxps  zmm0,zmm0,ZMMWORD PTR [rcx]
+        vmaxps  zmm1,zmm1,ZMMWORD PTR [rcx+16*4]
+        vmaxps  zmm2,zmm2,ZMMWORD PTR [rcx+32*4]
+        vmaxps  zmm3,zmm3,ZMMWORD PTR [rcx+48*4]
+        add     rcx,64*4                        ; advance input by 64 elements
+        sub     rdx,64
+        jae     ReduceMaximumBy64Loop
+
+ReduceMaximumProcessRemainingCountBy16:
+        add     rdx,64                          ; correct for over-subtract above
+        vmaxps  zmm0,zmm0,zmm1
+        vmaxps  zmm2,zmm2,zmm3
+        vmaxps  zmm0,zmm0,zmm2
+        sub     rdx,16
+        jb      ReduceMaximumProcessRemainingCount
+
+ReduceMaximumBy16Loop:
+        vmaxps  zmm0,zmm0,ZMMWORD PTR [rcx]
+        add     rcx,16*4                        ; advance input by 16 elements
+        sub     rdx,16
+        jae     ReduceMaximumBy16Loop
+
+ReduceMaximumProcessRemainingCount:
+        add     rdx,16                          ; correct for over-subtract above
+        jz      ReduceMaximumReduceVector
+        mov     r9,rcx
+        mov     ecx,edx
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; compute mask for remaining elements
+        vmaxps  zmm0{k1},zmm0,ZMMWORD PTR [r9]
+
+ReduceMaximumReduceVector:
+        vextractf64x4 ymm1,zmm0,1
+        vmaxps  ymm0,ymm0,ymm1
+        vextractf128 xmm1,ymm0,1
+        vmaxps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,0EEh
+        vmaxps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,055h
+        vmaxss  xmm0,xmm0,xmm1
+        vzeroupper
+        ret
+
+        LEAF_END MlasReduceMaximumF32KernelAvx512F, _TEXT
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel to compute the exponential
+;   function of each element biased by the negative of the row maximum and to
+;   accumulate the sum of these exponentials.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Optionally supplies the output buffer. If nullptr, then only
+;       the sum of the exponentials is computed.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+;   NegativeMaximum (r9) - Supplies the address of the negative of the maximum
+;       value of the input buffer.
+;
+; Return Value:
+;
+;   Returns the sum of the exponentials.
+;
+;--
+
+        LEAF_ENTRY MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+        LoadExpConstants
+        vbroadcastss zmm31,DWORD PTR [r9]       ; broadcast negative maximum
+        vpxord  zmm30,zmm30,zmm30               ; clear accumulator
+
+        sub     r8,16
+        jb      ComputeSumExpProcessRemainingCount
+
+ComputeSumExpBy16Loop:
+        vaddps  zmm0,zmm31,ZMMWORD PTR [rcx]    ; bias by negative maximum
+        ComputeExpBy16
+        add     rcx,16*4                        ; advance input by 16 elements
+        vaddps  zmm30,zmm30,zmm0
+        test    rdx,rdx
+        jz      ComputeSumExpSkipStoreBy16
+        vmovups ZMMWORD PTR [rdx],zmm0
+        add     rdx,16*4                        ; advance output by 16 elements
+
+ComputeSumExpSkipStoreBy16:
+        sub     r8,16
+        jae     ComputeSumExpBy16Loop
+
+ComputeSumExpProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ComputeSumExpReduceVector
+        mov     r9,rcx
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; compute mask for remaining elements
+        vaddps  zmm0{k1}{z},zmm31,ZMMWORD PTR [r9]
+        ComputeExpBy16
+        vaddps  zmm30{k1},zmm30,zmm0
+        test    rdx,rdx
+        jz      ComputeSumExpReduceVector
+        vmovups ZMMWORD PTR [rdx]{k1},zmm0
+
+ComputeSumExpReduceVector:
+        vextractf64x4 ymm0,zmm30,1
+        vaddps  zmm0,zmm0,zmm30
+        vextractf128 xmm1,ymm0,1
+        vaddps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,0EEh
+        vaddps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,055h
+        vaddss  xmm0,xmm0,xmm1
+        vzeroupper
+        ret
+
+        LEAF_END MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+        END
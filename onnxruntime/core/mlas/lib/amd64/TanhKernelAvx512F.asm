@@ -0,0 +1,146 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   TanhKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements a kernel for computing the hyperbolic tangent
+;   function for a buffer of elements.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasTanhConstants:NEAR
+
+;
+; Structure layout for the tanh constants block.
+;
+
+TanhConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        alpha_13 DWORD ?
+        alpha_11 DWORD ?
+        alpha_9 DWORD ?
+        alpha_7 DWORD ?
+        alpha_5 DWORD ?
+        alpha_3 DWORD ?
+        alpha_1 DWORD ?
+        beta_6 DWORD ?
+        beta_4 DWORD ?
+        beta_2 DWORD ?
+        beta_0 DWORD ?
+
+TanhConstants ENDS
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the hyperbolic tangent
+;   function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8)  - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        LEAF_ENTRY MlasTanhKernelAvx512F, _TEXT
+
+        lea     rax,MlasTanhConstants
+        vbroadcastss zmm18,TanhConstants.LowerRange[rax]
+        vbroadcastss zmm19,TanhConstants.UpperRange[rax]
+        vbroadcastss zmm20,TanhConstants.alpha_13[rax]
+        vbroadcastss zmm21,TanhConstants.alpha_11[rax]
+        vbroadcastss zmm22,TanhConstants.alpha_9[rax]
+        vbroadcastss zmm23,TanhConstants.alpha_7[rax]
+        vbroadcastss zmm24,TanhConstants.alpha_5[rax]
+        vbroadcastss zmm25,TanhConstants.alpha_3[rax]
+        vbroadcastss zmm26,TanhConstants.alpha_1[rax]
+        vbroadcastss zmm27,TanhConstants.beta_6[rax]
+        vbroadcastss zmm28,TanhConstants.beta_4[rax]
+        vbroadcastss zmm29,TanhConstants.beta_2[rax]
+        vbroadcastss zmm30,TanhConstants.beta_0[rax]
+
+        sub     r8,16
+        jb      ProcessRemainingCount
+
+ComputeTanhBy16Loop:
+        vmaxps  zmm16,zmm18,ZMMWORD PTR [rcx]   ; clamp lower bound
+        vmovaps zmm2,zmm21
+        vminps  zmm16,zmm19,zmm16               ; clamp upper bound
+        vmulps  zmm1,zmm16,zmm16                ; x2
+        vmovaps zmm3,zmm28
+        vfmadd231ps zmm2,zmm1,zmm20             ; p = x2 * alpha_13 + alpha_11
+        vfmadd213ps zmm2,zmm1,zmm22             ; p = x2 * p + alpha_9
+        vfmadd213ps zmm2,zmm1,zmm23             ; p = x2 * p + alpha_7
+        vfmadd213ps zmm2,zmm1,zmm24             ; p = x2 * p + alpha_5
+        vfmadd213ps zmm2,zmm1,zmm25             ; p = x2 * p + alpha_3
+        vfmadd213ps zmm2,zmm1,zmm26             ; p = x2 * p + alpha_1
+        vfmadd231ps zmm3,zmm1,zmm27             ; q = x2 * beta_6 + beta_4
+        vfmadd213ps zmm3,zmm1,zmm29             ; q = x2 * q + beta_2
+        vfmadd213ps zmm3,zmm1,zmm30             ; q = x2 * q + beta_0
+        vmulps  zmm2,zmm16,zmm2                 ; p = x * p
+        vdivps  zmm0,zmm2,zmm3                  ; tanh = p / q
+        add     rcx,16*4                        ; advance input by 16 elements
+        vmovups ZMMWORD PTR [rdx],zmm0
+        add     rdx,16*4                        ; advance output by 16 elements
+        sub     r8,16
+        jae     ComputeTanhBy16Loop
+
+ProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ExitKernel
+        mov     r9,rcx
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; compute mask for remaining elements
+        vmovups zmm16{k1}{z},ZMMWORD PTR [r9]
+        vmaxps  zmm16,zmm18,zmm16               ; clamp lower bound
+        vmovaps zmm2,zmm21
+        vminps  zmm16,zmm19,zmm16               ; clamp upper bound
+        vmulps  zmm1,zmm16,zmm16                ; x2
+        vmovaps zmm3,zmm28
+        vfmadd231ps zmm2,zmm1,zmm20             ; p = x2 * alpha_13 + alpha_11
+        vfmadd213ps zmm2,zmm1,zmm22             ; p = x2 * p + alpha_9
+        vfmadd213ps zmm2,zmm1,zmm23             ; p = x2 * p + alpha_7
+        vfmadd213ps zmm2,zmm1,zmm24             ; p = x2 * p + alpha_5
+        vfmadd213ps zmm2,zmm1,zmm25             ; p = x2 * p + alpha_3
+        vfmadd213ps zmm2,zmm1,zmm26             ; p = x2 * p + alpha_1
+        vfmadd231ps zmm3,zmm1,zmm27             ; q = x2 * beta_6 + beta_4
+        vfmadd213ps zmm3,zmm1,zmm29             ; q = x2 * q + beta_2
+        vfmadd213ps zmm3,zmm1,zmm30             ; q = x2 * q + beta_0
+        vmulps  zmm2,zmm16,zmm2                 ; p = x * p
+        vdivps  zmm0,zmm2,zmm3                  ; tanh = p / q
+        vmovups ZMMWORD PTR [rdx]{k1},zmm0
+
+ExitKernel:
+        vzeroupper
+        ret
+
+        LEAF_END MlasTanhKernelAvx512F, _TEXT
+
+        END
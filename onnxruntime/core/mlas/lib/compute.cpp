@@ -0,0 +1,617 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements miscellaneous computation routines.
+
+    The exponential function uses the same polynomial coefficients and range
+    reduction as the exponential used by the error function. Our usage requires
+    building platform specific versions of the algorithm to target different
+    instruction sets. The implementation below targets the base instruction set
+    (typically SSE2) while assembly implementations target newer instruction
+    sets (such as AVX512F).
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+#include <limits>
+
+//
+// Bundles the constants for use by kernels written in assembly.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float LowerRange;
+    float UpperRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+} MlasExpConstants = {
+    -103.9720840454f,
+    88.7762626647950f,
+    1.25829120e+7f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.38319808e-3f,
+    8.37550033e-3f,
+    4.16689515e-2f,
+    1.66664466e-1f,
+    4.99999851e-1f,
+    1.00000000e+0f,
+    1.00000000e+0f,
+};
+
+//
+// Define the parameters to execute segments of a softmax operation on worker
+// threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    int32_t ThreadCountN;
+    bool LogSoftmax;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for the supplied vector.
+
+    The input is reduced to the range [-ln(2)/2, ln(2)/2] such that
+    exp(x) = exp(f) * 2^m. The scale factor is applied in two steps in order to
+    produce infinity or a denormal result without overflowing or underflowing
+    the exponent of an intermediate power of two.
+
+Arguments:
+
+    Vector - Supplies the values to operate on.
+
+Return Value:
+
+    Returns the exponential of the supplied values.
+
+--*/
+{
+    Vector = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.LowerRange), Vector);
+    Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+
+    const MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+
+    MLAS_FLOAT32X4 m = MlasMultiplyAddFloat32x4(Vector, MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = MlasSubtractFloat32x4(m, RoundingBias);
+
+    Vector = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    Vector = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), Vector);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasExpConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_6));
+
+    MLAS_FLOAT32X4 m1 = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(0.5f), RoundingBias);
+    m1 = MlasSubtractFloat32x4(m1, RoundingBias);
+    MLAS_FLOAT32X4 m2 = MlasSubtractFloat32x4(m, m1);
+
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m1));
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m2));
+
+    return p;
+}
+
+MLAS_FORCEINLINE
+float
+MlasComputeExpScalar(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for the supplied value
+    using the same algorithm as MlasComputeExpVector.
+
+Arguments:
+
+    Value - Supplies the value to operate on.
+
+Return Value:
+
+    Returns the exponential of the supplied value.
+
+--*/
+{
+    Value = (std::min)(MlasExpConstants.UpperRange, (std::max)(MlasExpConstants.LowerRange, Value));
+
+    float m = Value * MlasExpConstants.Log2Reciprocal + MlasExpConstants.RoundingBias;
+    m -= MlasExpConstants.RoundingBias;
+
+    Value = m * MlasExpConstants.Log2High + Value;
+    Value = m * MlasExpConstants.Log2Low + Value;
+
+    float p = MlasExpConstants.poly_0;
+    p = p * Value + MlasExpConstants.poly_1;
+    p = p * Value + MlasExpConstants.poly_2;
+    p = p * Value + MlasExpConstants.poly_3;
+    p = p * Value + MlasExpConstants.poly_4;
+    p = p * Value + MlasExpConstants.poly_5;
+    p = p * Value + MlasExpConstants.poly_6;
+
+    return ldexpf(p, int(m));
+}
+
+void
+MLASCALL
+MlasComputeExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeExpVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = MlasComputeExpScalar(*Input++);
+
+        N -= 1;
+    }
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to find the maximum value of
+    the supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value of the supplied buffer.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(Maximum);
+
+        while (N >= 4) {
+
+            MaximumVector = MlasMaximumFloat32x4(MaximumVector, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Maximum = (std::max)(Maximum, MlasExtractLaneFloat32x4<0>(MaximumVector));
+        Maximum = (std::max)(Maximum, MlasExtractLaneFloat32x4<1>(MaximumVector));
+        Maximum = (std::max)(Maximum, MlasExtractLaneFloat32x4<2>(MaximumVector));
+        Maximum = (std::max)(Maximum, MlasExtractLaneFloat32x4<3>(MaximumVector));
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input++);
+
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to compute the exponential
+    function of each element biased by the negative of the row maximum and to
+    accumulate the sum of these exponentials.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. If nullptr, then only the
+        sum of the exponentials is computed.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the address of the negative of the maximum value
+        of the input buffer.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    const float Bias = *NegativeMaximum;
+
+    float Accumulation = 0.0f;
+
+    if (N >= 4) {
+
+        const MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+        MLAS_FLOAT32X4 AccumulationVector = MlasZeroFloat32x4();
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasComputeExpVector(MlasAddFloat32x4(MlasLoadFloat32x4(Input), BiasVector));
+
+            if (Output != nullptr) {
+                MlasStoreFloat32x4(Output, Vector);
+                Output += 4;
+            }
+
+            AccumulationVector = MlasAddFloat32x4(AccumulationVector, Vector);
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulation = MlasExtractLaneFloat32x4<0>(AccumulationVector) +
+            MlasExtractLaneFloat32x4<1>(AccumulationVector) +
+            MlasExtractLaneFloat32x4<2>(AccumulationVector) +
+            MlasExtractLaneFloat32x4<3>(AccumulationVector);
+    }
+
+    while (N > 0) {
+
+        float Value = MlasComputeExpScalar(*Input++ + Bias);
+
+        if (Output != nullptr) {
+            *Output++ = Value;
+        }
+
+        Accumulation += Value;
+
+        N -= 1;
+    }
+
+    return Accumulation;
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ComputeExpF32Kernel(Input, Output, N);
+#else
+    MlasComputeExpF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    const size_t WorkPerThread = N / WorkBlock->ThreadCountN;
+    const size_t WorkPerThreadExtra = N % WorkBlock->ThreadCountN;
+
+    size_t n;
+    size_t CountN;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        n = (WorkPerThread + 1) * Index;
+        CountN = WorkPerThread + 1;
+    } else {
+        n = WorkPerThread * Index + WorkPerThreadExtra;
+        CountN = WorkPerThread;
+    }
+
+    //
+    // Compute the softmax or log softmax function.
+    //
+
+    const bool LogSoftmax = WorkBlock->LogSoftmax;
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+    while (CountN > 0) {
+
+        //
+        // Find the maximum value for the row.
+        //
+
+#if defined(MLAS_TARGET_AMD64)
+        float Maximum = MlasPlatform.ReduceMaximumF32Kernel(Input, D);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+#endif
+        float NegativeMaximum = -Maximum;
+
+        if (LogSoftmax) {
+
+            //
+            // Compute the sum of the exponential functions for the row.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#endif
+
+            //
+            // Compute the log softmax output.
+            //
+
+            float Bias = NegativeMaximum - std::log(Accumulation);
+            MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+
+            const float* input = Input;
+            float* output = Output;
+            size_t d = D;
+
+            while (d >= 4) {
+                MlasStoreFloat32x4(output, MlasAddFloat32x4(MlasLoadFloat32x4(input), BiasVector));
+                input += 4;
+                output += 4;
+                d -= 4;
+            }
+
+            while (d > 0) {
+                *output++ = *input++ + Bias;
+                d -= 1;
+            }
+
+        } else {
+
+            //
+            // Compute the exponential function for each element of the row and
+            // compute the sum of these exponential functions.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#endif
+
+            //
+            // Normalize the softmax output.
+            //
+
+            float Scale = 1.0f / Accumulation;
+            MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+            float* output = Output;
+            size_t d = D;
+
+            while (d >= 4) {
+                MlasStoreFloat32x4(output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(output), ScaleVector));
+                output += 4;
+                d -= 4;
+            }
+
+            while (d > 0) {
+                *output++ *= Scale;
+                d -= 1;
+            }
+        }
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the softmax parameters to the work block.
+    //
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Compute the number of target threads given the complexity of the softmax
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCountN = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
@@ -23,6 +23,34 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the parameters of the Winograd F(4x4, 3x3) algorithm. Each 4x4 output
+// tile is computed from a 6x6 input tile as 36 independent GEMMs over the
+// input channels, one for each element of the transformed tile.
+//
+
+#define MLAS_CONV_WINOGRAD_OUTPUT_TILE                   4
+#define MLAS_CONV_WINOGRAD_INPUT_TILE                    6
+#define MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS            36
+
+//
+// Define the minimum number of input channels and filters for which the
+// Winograd algorithm is selected. Smaller convolutions are dominated by the
+// cost of the input and output transforms.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS              16
+
+//
+// Define the range of tiles that are transformed and multiplied together and
+// the target number of working buffer elements per thread used to pick a
+// size in that range.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK            16
+#define MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK            64
+#define MLAS_CONV_WINOGRAD_WORKING_BUFFER_TARGET         (256 * 1024)
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -736,131 +764,102 @@ Return Value:
     }
 }
 
-inline
-bool
-MlasConvTryMultithread(
-    const MLAS_CONV_PARAMETERS* Parameters,
+MLAS_FORCEINLINE
+float
+MlasConvDepthwiseComputeSingle(
     const float* Input,
     const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    size_t InputWidth,
+    size_t KernelWidth,
+    size_t EffectiveKernelHeight,
+    size_t DilatedInputWidth,
+    size_t DilationWidth,
+    ptrdiff_t iw0
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+    This routine computes a single output element of a depthwise convolution
+    where the kernel may extend into the left or right padding columns.
 
 Arguments:
 
-    Parameters - Supplies the structure that contains the convolution
-        parameters.
+    Input - Supplies the first valid input row for the output element.
 
-    Input - Supplies the input tensor.
+    Filter - Supplies the first valid filter row for the output element.
 
-    Filter - Supplies the filter tensor.
+    InputWidth - Supplies the width of the input image.
 
-    Bias - Optionally supplies the bias vector.
+    KernelWidth - Supplies the width of the kernel.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    EffectiveKernelHeight - Supplies the number of kernel rows that do not
+        reference the top or bottom padding rows.
 
-    Output - Supplies the output tensor.
+    DilatedInputWidth - Supplies the distance in elements between adjacent
+        kernel rows in the input image.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    DilationWidth - Supplies the distance in elements between adjacent kernel
+        columns in the input image.
+
+    iw0 - Supplies the input column of the first kernel column, which may be
+        negative for left padding columns.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    Returns the output element.
 
 --*/
 {
-    MLAS_CONV_WORK_BLOCK WorkBlock;
-
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
-
-    if (ThreadStrideN >= OutputSize) {
-        return false;
-    }
-
-    //
-    // Initialize the common fields of the work block.
-    //
-
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
-
-    //
-    // Segment the operation across multiple threads.
-    //
+    float Accumulator = 0.0f;
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+    for (size_t kh = 0; kh < EffectiveKernelHeight; kh++) {
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
 
-        SegmentCountN = OutputSize - SegmentStartN;
+            size_t iw = size_t(iw0 + ptrdiff_t(kw * DilationWidth));
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
+            if (iw < InputWidth) {
+                Accumulator += Input[iw] * Filter[kw];
+            }
         }
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
-
-        Index++;
+        Input += DilatedInputWidth;
+        Filter += KernelWidth;
     }
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
-
-    return true;
+    return Accumulator;
 }
 
+template<size_t KernelWidthT>
 void
-MLASCALL
-MlasConv(
+MlasConvDepthwiseFloatCHW(
     const MLAS_CONV_PARAMETERS* Parameters,
     const float* Input,
     const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    float* Output
     )
 /*++
 
 Routine Description:
 
-    This routine implements the convolution operation.
+    This routine implements the direct depthwise convolution of a single
+    channel of a two dimensional image without expanding the input.
+
+    Output columns whose kernel footprint lies entirely inside the input width
+    are computed without bounds checks and, for unit strides, four columns at
+    a time. Kernel rows that fall in the top or bottom padding are skipped.
 
 Arguments:
 
     Parameters - Supplies the structure that contains the convolution
         parameters.
 
-    Input - Supplies the input tensor.
-
-    Filter - Supplies the filter tensor.
-
-    Bias - Optionally supplies the bias vector.
-
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+    Input - Supplies the input channel.
 
-    Output - Supplies the output tensor.
+    Filter - Supplies the filter for the channel.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    Output - Supplies the output channel.
 
 Return Value:
 
@@ -868,195 +867,1348 @@ Return Value:
 
 --*/
 {
-    const size_t FilterCount = Parameters->FilterCount;
-    const size_t OutputSize = Parameters->OutputSize;
-    const size_t K = Parameters->K;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = (KernelWidthT != 0) ? KernelWidthT : Parameters->KernelShape[1];
 
-    const size_t BatchCount = Parameters->BatchCount;
-    const size_t GroupCount = Parameters->GroupCount;
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
 
-    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+    const size_t DilatedInputWidth = DilationHeight * InputWidth;
 
     //
-    // Schedule batches of GEMMs across multiple threads.
+    // Compute the range of output columns that do not reference the left or
+    // right padding columns.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    const size_t SpanWidth = (KernelWidth - 1) * DilationWidth + 1;
 
-        const size_t BatchGroupCount = BatchCount * GroupCount;
+    size_t OutputWidthEnd = 0;
 
-        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    if (InputWidth + PaddingLeft >= SpanWidth) {
+        OutputWidthEnd = std::min(OutputWidth,
+            (InputWidth + PaddingLeft - SpanWidth) / StrideWidth + 1);
+    }
 
-        if (size_t(TargetThreadCount) >= BatchGroupCount) {
-            TargetThreadCount = int32_t(BatchGroupCount);
-        }
+    const size_t OutputWidthStart = std::min(OutputWidthEnd,
+        (PaddingLeft + StrideWidth - 1) / StrideWidth);
 
-        MLAS_CONV_WORK_BLOCK WorkBlock;
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
 
-        WorkBlock.Parameters = Parameters;
-        WorkBlock.Input = Input;
-        WorkBlock.Filter = Filter;
-        WorkBlock.Bias = Bias;
-        WorkBlock.WorkingBuffer = nullptr;
-        WorkBlock.Output = Output;
-        WorkBlock.TargetThreadCount = TargetThreadCount;
+        //
+        // Compute the range of kernel rows that do not reference the top or
+        // bottom padding rows.
+        //
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+        const ptrdiff_t ih0 = ptrdiff_t(oh * StrideHeight) - ptrdiff_t(PaddingTop);
 
-        return;
-    }
+        size_t KernelHeightStart = 0;
+        size_t KernelHeightEnd = 0;
 
-    //
-    // Iterate over each batch and group.
-    //
+        if (ih0 < 0) {
+            KernelHeightStart = (size_t(-ih0) + DilationHeight - 1) / DilationHeight;
+        }
 
-    for (size_t batch = 0; batch < BatchCount; batch++) {
+        if (ih0 < ptrdiff_t(InputHeight)) {
+            KernelHeightEnd = std::min(KernelHeight,
+                (InputHeight - 1 - size_t(ih0)) / DilationHeight + 1);
+        }
 
-        const float* filter = Filter;
-        const float* bias = Bias;
+        float* output = Output + oh * OutputWidth;
 
-        for (size_t group = 0; group < GroupCount; group++) {
+        if (KernelHeightStart >= KernelHeightEnd) {
+            std::fill_n(output, OutputWidth, 0.0f);
+            continue;
+        }
 
-            //
-            // Dispatch the convolution.
-            //
+        const size_t EffectiveKernelHeight = KernelHeightEnd - KernelHeightStart;
 
-            switch (Algorithm) {
+        const float* input = Input + (ih0 + ptrdiff_t(KernelHeightStart * DilationHeight)) *
+            ptrdiff_t(InputWidth);
+        const float* filter = Filter + KernelHeightStart * KernelWidth;
 
-                case MlasConvAlgorithmGemmDirect:
-                {
-                    //
-                    // Invoke the threaded GEMM directly with the input tensor.
-                    //
+        //
+        // Compute the output columns that reference the left padding columns.
+        //
 
-                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize, ThreadPool);
+        size_t ow = 0;
 
-                    //
-                    // Apply the activation with optional bias.
-                    //
+        for (; ow < OutputWidthStart; ow++) {
+            output[ow] = MlasConvDepthwiseComputeSingle(input, filter, InputWidth,
+                KernelWidth, EffectiveKernelHeight, DilatedInputWidth, DilationWidth,
+                ptrdiff_t(ow * StrideWidth) - ptrdiff_t(PaddingLeft));
+        }
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+        //
+        // Compute the output columns that do not reference any padding columns.
+        //
 
-                    break;
-                }
+        if (StrideWidth == 1) {
 
-                case MlasConvAlgorithmExpandThenGemm:
-                {
-                    //
-                    // Expand the input tensor to the working buffer and then invoke the
-                    // threaded GEMM.
-                    //
+            for (; ow + 4 <= OutputWidthEnd; ow += 4) {
 
-                    if (Parameters->Dimensions == 2) {
-                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    } else {
-                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
-                    }
+                MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
 
-                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool);
+                const float* row = input + ow - PaddingLeft;
+                const float* f = filter;
 
-                    //
-                    // Apply the activation with optional bias.
-                    //
+                for (size_t kh = 0; kh < EffectiveKernelHeight; kh++) {
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                    for (size_t kw = 0; kw < KernelWidth; kw++) {
+                        Accumulator = MlasMultiplyAddFloat32x4(
+                            MlasLoadFloat32x4(row + kw * DilationWidth),
+                            MlasBroadcastFloat32x4(f + kw), Accumulator);
+                    }
 
-                    break;
+                    row += DilatedInputWidth;
+                    f += KernelWidth;
                 }
 
-                case MlasConvAlgorithmExpandThenGemmSegmented:
-                {
-                    //
-                    // Attempt to launch the convolution across multiple threads or fall
-                    // back to a single thread.
-                    //
+                MlasStoreFloat32x4(output + ow, Accumulator);
+            }
+        }
 
-                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
-                        Output, ThreadPool)) {
-                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
-                            Output, 0, OutputSize);
-                    }
+        for (; ow < OutputWidthEnd; ow++) {
 
-                    break;
+            float Accumulator = 0.0f;
+
+            const float* row = input + ow * StrideWidth - PaddingLeft;
+            const float* f = filter;
+
+            for (size_t kh = 0; kh < EffectiveKernelHeight; kh++) {
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+                    Accumulator += row[kw * DilationWidth] * f[kw];
                 }
+
+                row += DilatedInputWidth;
+                f += KernelWidth;
             }
 
-            //
-            // Advance the buffer pointers.
-            //
+            output[ow] = Accumulator;
+        }
 
-            if (bias != nullptr) {
-                bias += FilterCount;
-            }
+        //
+        // Compute the output columns that reference the right padding columns.
+        //
 
-            filter += FilterGroupSize;
-            Input += InputGroupSize;
-            Output += OutputGroupSize;
+        for (; ow < OutputWidth; ow++) {
+            output[ow] = MlasConvDepthwiseComputeSingle(input, filter, InputWidth,
+                KernelWidth, EffectiveKernelHeight, DilatedInputWidth, DilationWidth,
+                ptrdiff_t(ow * StrideWidth) - ptrdiff_t(PaddingLeft));
         }
     }
 }
 
 void
-MLASCALL
-MlasConvPrepare(
-    MLAS_CONV_PARAMETERS* Parameters,
-    size_t Dimensions,
-    size_t BatchCount,
-    size_t GroupCount,
-    size_t InputChannels,
-    const int64_t* InputShape,
-    const int64_t* KernelShape,
-    const int64_t* DilationShape,
-    const int64_t* Padding,
-    const int64_t* StrideShape,
-    const int64_t* OutputShape,
-    size_t FilterCount,
-    const MLAS_ACTIVATION* Activation,
-    size_t* WorkingBufferSize,
-    MLAS_THREADPOOL* ThreadPool
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
     )
 /*++
 
 Routine Description:
 
-    This routine prepares for a convolution operation by computing required
-    parameters including the required working buffer size for intermediate
-    results.
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
 
 Arguments:
 
-    Parameters - Supplies the structure that stores the provided and computed
-        parameters for the convolution operation.
+    Context - Supplies the pointer to the context for the threaded operation.
 
-    Dimensions - Supplies the number of dimensions (must be 2 or 3).
+    Index - Supplies the current index of the threaded operation.
 
-    BatchCount - Supplies the number of batches to the processed.
+Return Value:
 
-    GroupCount - Supplies the number of channel groups.
+    None.
 
-    InputChannels - Supplies the number of input channels per group.
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
 
-    InputShape - Supplies the shape of the input tensor.
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
 
-    KernelShape - Supplies the shape of the kernel transform.
+    //
+    // Compute the range of channels to use for this thread.
+    //
 
-    DilationShape - Supplies the shape of the dilation.
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
 
-    Padding - Supplies the number of zero padding elements at the edge of the
-        input tensor.
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
 
-    StrideShape - Supplies the shape of the stride.
+    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
+    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
 
-    OutputShape - Supplies the shape of the output tensor.
+    size_t BatchGroupStart;
+    size_t BatchGroupEnd;
+
+    if (uint32_t(Index) < BatchGroupCountExtra) {
+        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
+    } else {
+        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
+    }
+
+    //
+    // Select the kernel specialized for the common kernel widths.
+    //
+
+    void (*Kernel)(const MLAS_CONV_PARAMETERS*, const float*, const float*, float*);
+
+    switch (Parameters->KernelShape[1]) {
+
+        case 3:
+            Kernel = MlasConvDepthwiseFloatCHW<3>;
+            break;
+
+        case 5:
+            Kernel = MlasConvDepthwiseFloatCHW<5>;
+            break;
+
+        default:
+            Kernel = MlasConvDepthwiseFloatCHW<0>;
+            break;
+    }
+
+    //
+    // Iterate over the channels allocated to this thread.
+    //
+
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        float* output = WorkBlock->Output + bg * OutputSize;
+
+        Kernel(Parameters, WorkBlock->Input + bg * InputSize,
+            WorkBlock->Filter + group * K, output);
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, 1, OutputSize,
+            OutputSize);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradFilterTransform6(
+    float g0,
+    float g1,
+    float g2,
+    float* Output,
+    size_t Stride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of three filter elements by the Winograd
+    F(4x4, 3x3) filter transform matrix G.
+
+Arguments:
+
+    g0, g1, g2 - Supplies the filter elements.
+
+    Output - Supplies the buffer to receive the six transformed elements.
+
+    Stride - Supplies the distance in elements between transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Output[0 * Stride] = g0 * (1.0f / 4.0f);
+    Output[1 * Stride] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+    Output[2 * Stride] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+    Output[3 * Stride] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    Output[4 * Stride] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    Output[5 * Stride] = g2;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradInputTransform6(
+    const float* d,
+    size_t InputStride,
+    float* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of six input elements by the Winograd
+    F(4x4, 3x3) input transform matrix B^T.
+
+Arguments:
+
+    d - Supplies the input elements.
+
+    InputStride - Supplies the distance in elements between input elements.
+
+    Output - Supplies the buffer to receive the six transformed elements.
+
+    OutputStride - Supplies the distance in elements between transformed
+        elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float d0 = d[0 * InputStride];
+    const float d1 = d[1 * InputStride];
+    const float d2 = d[2 * InputStride];
+    const float d3 = d[3 * InputStride];
+    const float d4 = d[4 * InputStride];
+    const float d5 = d[5 * InputStride];
+
+    Output[0 * OutputStride] = 4.0f * d0 - 5.0f * d2 + d4;
+    Output[1 * OutputStride] = -4.0f * (d1 + d2) + d3 + d4;
+    Output[2 * OutputStride] = 4.0f * (d1 - d2) - d3 + d4;
+    Output[3 * OutputStride] = 2.0f * (d3 - d1) - d2 + d4;
+    Output[4 * OutputStride] = 2.0f * (d1 - d3) - d2 + d4;
+    Output[5 * OutputStride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradOutputTransform4(
+    const float* m,
+    size_t InputStride,
+    float* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of six transformed output elements by the
+    Winograd F(4x4, 3x3) output transform matrix A^T.
+
+Arguments:
+
+    m - Supplies the transformed output elements.
+
+    InputStride - Supplies the distance in elements between transformed output
+        elements.
+
+    Output - Supplies the buffer to receive the four output elements.
+
+    OutputStride - Supplies the distance in elements between output elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float m0 = m[0 * InputStride];
+    const float m1 = m[1 * InputStride];
+    const float m2 = m[2 * InputStride];
+    const float m3 = m[3 * InputStride];
+    const float m4 = m[4 * InputStride];
+    const float m5 = m[5 * InputStride];
+
+    const float a = m1 + m2;
+    const float b = m1 - m2;
+    const float c = m3 + m4;
+    const float e = m3 - m4;
+
+    Output[0 * OutputStride] = m0 + a + c;
+    Output[1 * OutputStride] = b + 2.0f * e;
+    Output[2 * OutputStride] = a + 4.0f * c;
+    Output[3 * OutputStride] = b + 8.0f * e + m5;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements required to store a 3x3
+    filter tensor transformed by MlasConvWinogradTransformFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter tensor.
+
+--*/
+{
+    return GroupCount * MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    size_t GroupCount,
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter tensor for use with the Winograd
+    convolution algorithm. The transform only depends on the filter, so
+    callers with a constant filter can transform it once and reuse it for
+    every invocation of MlasConv.
+
+    Each group of the transformed filter is stored as 36 row major matrices
+    of FilterCount rows by InputChannels columns.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    FilterCount - Supplies the number of filters per group.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    Filter - Supplies the filter tensor in OIHW format.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filter
+        tensor. The buffer must have MlasConvWinogradFilterSize elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                //
+                // Compute G * g * G^T for the 3x3 filter of this channel.
+                //
+
+                float Columns[MLAS_CONV_WINOGRAD_INPUT_TILE * 3];
+
+                for (size_t j = 0; j < 3; j++) {
+                    MlasConvWinogradFilterTransform6(Filter[j], Filter[3 + j], Filter[6 + j],
+                        &Columns[j], 3);
+                }
+
+                float* output = TransformedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < MLAS_CONV_WINOGRAD_INPUT_TILE; i++) {
+                    MlasConvWinogradFilterTransform6(Columns[i * 3 + 0], Columns[i * 3 + 1],
+                        Columns[i * 3 + 2], output + i * MLAS_CONV_WINOGRAD_INPUT_TILE * MatrixSize,
+                        MatrixSize);
+                }
+
+                Filter += 9;
+            }
+        }
+
+        TransformedFilter += MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS * MatrixSize;
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd F(4x4, 3x3) convolution operation.
+
+    The output of each batch and group is divided into 4x4 tiles which are
+    processed in blocks. For each block, the input tiles are transformed to
+    the working buffer, multiplied by the transformed filter with one GEMM per
+    transformed element, and transformed back to the output tensor.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+
+    const size_t TileCountWidth = (OutputWidth + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+    const size_t TileCountHeight = (OutputHeight + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+    const size_t TileCount = TileCountHeight * TileCountWidth;
+    const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+    //
+    // Compute the range of tile blocks to use for this thread.
+    //
+
+    const size_t TotalWork = Parameters->BatchCount * GroupCount * TileBlockCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t WorkPerThread = TotalWork / TargetThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % TargetThreadCount;
+
+    size_t WorkIndex;
+    size_t WorkIndexEnd;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkIndexEnd = WorkIndex + WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkIndexEnd = WorkIndex + WorkPerThread;
+    }
+
+    //
+    // Each thread uses a private slice of the working buffer for the
+    // transformed input and output tiles.
+    //
+
+    const size_t TransformedInputSize = InputChannels * TileBlockSize;
+    const size_t TransformedOutputSize = FilterCount * TileBlockSize;
+
+    float* TransformedInput = WorkBlock->WorkingBuffer + size_t(Index) *
+        MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS * (TransformedInputSize + TransformedOutputSize);
+    float* TransformedOutput = TransformedInput +
+        MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS * TransformedInputSize;
+
+    for (; WorkIndex < WorkIndexEnd; WorkIndex++) {
+
+        const size_t bg = WorkIndex / TileBlockCount;
+        const size_t group = bg % GroupCount;
+
+        const size_t TileStart = (WorkIndex % TileBlockCount) * TileBlockSize;
+        const size_t TileCountThisBlock = std::min(TileBlockSize, TileCount - TileStart);
+
+        const float* input = WorkBlock->Input + bg * InputChannels * InputSize;
+        const float* filter = WorkBlock->Filter + group * MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS *
+            FilterCount * InputChannels;
+        float* output = WorkBlock->Output + bg * FilterCount * OutputSize;
+
+        //
+        // Transform the input tiles of this block for every input channel.
+        //
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            for (size_t t = 0; t < TileCountThisBlock; t++) {
+
+                const size_t TileIndex = TileStart + t;
+                const size_t th = TileIndex / TileCountWidth;
+                const size_t tw = TileIndex % TileCountWidth;
+
+                const size_t ih0 = th * MLAS_CONV_WINOGRAD_OUTPUT_TILE - PaddingTop;
+                const size_t iw0 = tw * MLAS_CONV_WINOGRAD_OUTPUT_TILE - PaddingLeft;
+
+                //
+                // Gather the input tile, substituting zeros for the padding
+                // elements.
+                //
+
+                float d[MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS];
+
+                if (InputHeight >= MLAS_CONV_WINOGRAD_INPUT_TILE &&
+                    ih0 <= InputHeight - MLAS_CONV_WINOGRAD_INPUT_TILE &&
+                    InputWidth >= MLAS_CONV_WINOGRAD_INPUT_TILE &&
+                    iw0 <= InputWidth - MLAS_CONV_WINOGRAD_INPUT_TILE) {
+
+                    const float* row = input + ih0 * InputWidth + iw0;
+
+                    for (size_t i = 0; i < MLAS_CONV_WINOGRAD_INPUT_TILE; i++) {
+                        for (size_t j = 0; j < MLAS_CONV_WINOGRAD_INPUT_TILE; j++) {
+                            d[i * MLAS_CONV_WINOGRAD_INPUT_TILE + j] = row[j];
+                        }
+                        row += InputWidth;
+                    }
+
+                } else {
+
+                    for (size_t i = 0; i < MLAS_CONV_WINOGRAD_INPUT_TILE; i++) {
+
+                        const size_t ih = ih0 + i;
+
+                        for (size_t j = 0; j < MLAS_CONV_WINOGRAD_INPUT_TILE; j++) {
+
+                            const size_t iw = iw0 + j;
+
+                            d[i * MLAS_CONV_WINOGRAD_INPUT_TILE + j] =
+                                (ih < InputHeight && iw < InputWidth) ?
+                                input[ih * InputWidth + iw] : 0.0f;
+                        }
+                    }
+                }
+
+                //
+                // Compute B^T * d * B and scatter the transformed elements to
+                // their matrices.
+                //
+
+                float Columns[MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS];
+
+                for (size_t j = 0; j < MLAS_CONV_WINOGRAD_INPUT_TILE; j++) {
+                    MlasConvWinogradInputTransform6(&d[j], MLAS_CONV_WINOGRAD_INPUT_TILE,
+                        &Columns[j], MLAS_CONV_WINOGRAD_INPUT_TILE);
+                }
+
+                float* transformed = TransformedInput + c * TileBlockSize + t;
+
+                for (size_t i = 0; i < MLAS_CONV_WINOGRAD_INPUT_TILE; i++) {
+                    MlasConvWinogradInputTransform6(&Columns[i * MLAS_CONV_WINOGRAD_INPUT_TILE], 1,
+                        transformed + i * MLAS_CONV_WINOGRAD_INPUT_TILE * TransformedInputSize,
+                        TransformedInputSize);
+                }
+            }
+
+            input += InputSize;
+        }
+
+        //
+        // Multiply each transformed filter matrix by the matching transformed
+        // input matrix.
+        //
+
+        for (size_t e = 0; e < MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS; e++) {
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCountThisBlock,
+                InputChannels, 1.0f, filter + e * FilterCount * InputChannels, InputChannels,
+                TransformedInput + e * TransformedInputSize, TileBlockSize, 0.0f,
+                TransformedOutput + e * TransformedOutputSize, TileBlockSize);
+        }
+
+        //
+        // Compute A^T * m * A for every output tile and store the elements that
+        // are inside the output image.
+        //
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* transformed = TransformedOutput + f * TileBlockSize;
+            float* OutputChannel = output + f * OutputSize;
+
+            for (size_t t = 0; t < TileCountThisBlock; t++) {
+
+                const size_t TileIndex = TileStart + t;
+                const size_t oh0 = (TileIndex / TileCountWidth) * MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+                const size_t ow0 = (TileIndex % TileCountWidth) * MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+
+                float m[MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS];
+
+                for (size_t e = 0; e < MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS; e++) {
+                    m[e] = transformed[e * TransformedOutputSize + t];
+                }
+
+                float Columns[MLAS_CONV_WINOGRAD_OUTPUT_TILE * MLAS_CONV_WINOGRAD_INPUT_TILE];
+
+                for (size_t j = 0; j < MLAS_CONV_WINOGRAD_INPUT_TILE; j++) {
+                    MlasConvWinogradOutputTransform4(&m[j], MLAS_CONV_WINOGRAD_INPUT_TILE,
+                        &Columns[j], MLAS_CONV_WINOGRAD_INPUT_TILE);
+                }
+
+                float y[MLAS_CONV_WINOGRAD_OUTPUT_TILE * MLAS_CONV_WINOGRAD_OUTPUT_TILE];
+
+                for (size_t i = 0; i < MLAS_CONV_WINOGRAD_OUTPUT_TILE; i++) {
+                    MlasConvWinogradOutputTransform4(&Columns[i * MLAS_CONV_WINOGRAD_INPUT_TILE], 1,
+                        &y[i * MLAS_CONV_WINOGRAD_OUTPUT_TILE], 1);
+                }
+
+                const size_t CountHeight = std::min(size_t(MLAS_CONV_WINOGRAD_OUTPUT_TILE),
+                    OutputHeight - oh0);
+                const size_t CountWidth = std::min(size_t(MLAS_CONV_WINOGRAD_OUTPUT_TILE),
+                    OutputWidth - ow0);
+
+                float* row = OutputChannel + oh0 * OutputWidth + ow0;
+
+                for (size_t i = 0; i < CountHeight; i++) {
+                    for (size_t j = 0; j < CountWidth; j++) {
+                        row[j] = y[i * MLAS_CONV_WINOGRAD_OUTPUT_TILE + j];
+                    }
+                    row += OutputWidth;
+                }
+            }
+        }
+
+        //
+        // Apply the activation with optional bias to each output row segment
+        // produced by this block.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        const size_t TileEnd = TileStart + TileCountThisBlock;
+
+        for (size_t TileIndex = TileStart; TileIndex < TileEnd; ) {
+
+            const size_t th = TileIndex / TileCountWidth;
+            const size_t tw = TileIndex % TileCountWidth;
+            const size_t TileCountRow = std::min(TileCountWidth - tw, TileEnd - TileIndex);
+
+            const size_t oh0 = th * MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+            const size_t ow0 = tw * MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+            const size_t ohEnd = std::min(oh0 + MLAS_CONV_WINOGRAD_OUTPUT_TILE, OutputHeight);
+            const size_t CountWidth = std::min(TileCountRow * MLAS_CONV_WINOGRAD_OUTPUT_TILE,
+                OutputWidth - ow0);
+
+            for (size_t oh = oh0; oh < ohEnd; oh++) {
+                MlasActivation(Parameters->Activation, output + oh * OutputWidth + ow0, bias,
+                    FilterCount, CountWidth, OutputSize);
+            }
+
+            TileIndex += TileCountRow;
+        }
+    }
+}
+
+inline
+bool
+MlasConvTryMultithread(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a convolution operation across multiple
+    threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    if (ThreadStrideN >= OutputSize) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+    size_t SegmentCountN;
+
+    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+
+        SegmentCountN = OutputSize - SegmentStartN;
+
+        if (SegmentCountN > ThreadStrideN) {
+            SegmentCountN = ThreadStrideN;
+        }
+
+        WorkBlock.Segments[Index].StartN = SegmentStartN;
+        WorkBlock.Segments[Index].CountN = SegmentCountN;
+
+        Index++;
+    }
+
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = FilterCount * K;
+
+    const size_t BatchCount = Parameters->BatchCount;
+    const size_t GroupCount = Parameters->GroupCount;
+
+    const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
+
+    //
+    // Schedule batches of GEMMs across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Schedule the tile blocks of a Winograd convolution across the number of
+    // threads computed by MlasConvPrepare.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = WorkingBuffer;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Schedule the channels of a depthwise convolution across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Iterate over each batch and group.
+    //
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+
+        const float* filter = Filter;
+        const float* bias = Bias;
+
+        for (size_t group = 0; group < GroupCount; group++) {
+
+            //
+            // Dispatch the convolution.
+            //
+
+            switch (Algorithm) {
+
+                case MlasConvAlgorithmGemmDirect:
+                {
+                    //
+                    // Invoke the threaded GEMM directly with the input tensor.
+                    //
+
+                    MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+                        OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
+                        Output, OutputSize, ThreadPool);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemm:
+                {
+                    //
+                    // Expand the input tensor to the working buffer and then invoke the
+                    // threaded GEMM.
+                    //
+
+                    if (Parameters->Dimensions == 2) {
+                        MlasConvIm2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    } else {
+                        MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
+                    }
+
+                    MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmExpandThenGemmSegmented:
+                {
+                    //
+                    // Attempt to launch the convolution across multiple threads or fall
+                    // back to a single thread.
+                    //
+
+                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output, ThreadPool)) {
+                        MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
+                            Output, 0, OutputSize);
+                    }
+
+                    break;
+                }
+
+                case MlasConvAlgorithmDepthwise:
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Depthwise and Winograd convolutions are scheduled across
+                    // all batches and groups above.
+                    //
+
+                    break;
+                }
+            }
+
+            //
+            // Advance the buffer pointers.
+            //
+
+            if (bias != nullptr) {
+                bias += FilterCount;
+            }
+
+            filter += FilterGroupSize;
+            Input += InputGroupSize;
+            Output += OutputGroupSize;
+        }
+    }
+}
+
+bool
+MlasConvIsWinogradSupported(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the Winograd algorithm can compute the
+    convolution, which requires a 3x3 kernel with unit strides and dilations.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the convolution
+        parameters.
+
+Return Value:
+
+    Returns true if the Winograd algorithm supports the convolution.
+
+--*/
+{
+    return Parameters->Dimensions == 2 &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        Parameters->StrideShape[0] == 1 && Parameters->StrideShape[1] == 1 &&
+        Parameters->DilationShape[0] == 1 && Parameters->DilationShape[1] == 1 &&
+        Parameters->OutputShape[0] >= MLAS_CONV_WINOGRAD_OUTPUT_TILE &&
+        Parameters->OutputShape[1] >= MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+}
+
+size_t
+MlasConvPrepareWinograd(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution using the Winograd F(4x4, 3x3)
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns the number of elements to allocate for the working buffer.
+
+--*/
+{
+    //
+    // Size the block of tiles so that the transformed input and output
+    // tiles stay near the target working buffer size per thread.
+    //
+
+    const size_t TileElements = MLAS_CONV_WINOGRAD_TRANSFORM_ELEMENTS *
+        (Parameters->InputChannels + Parameters->FilterCount);
+
+    size_t TileBlockSize = MLAS_CONV_WINOGRAD_WORKING_BUFFER_TARGET / TileElements;
+
+    TileBlockSize = std::max(TileBlockSize, size_t(MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK));
+    TileBlockSize = std::min(TileBlockSize, size_t(MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK));
+
+    const size_t TileCount =
+        ((Parameters->OutputShape[0] + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) / MLAS_CONV_WINOGRAD_OUTPUT_TILE) *
+        ((Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) / MLAS_CONV_WINOGRAD_OUTPUT_TILE);
+
+    TileBlockSize = std::min(TileBlockSize, TileCount);
+
+    const size_t TotalWork = Parameters->BatchCount * Parameters->GroupCount *
+        ((TileCount + TileBlockSize - 1) / TileBlockSize);
+
+    int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= TotalWork) {
+        TargetThreadCount = int32_t(TotalWork);
+    }
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+
+    return size_t(TargetThreadCount) * TileBlockSize * TileElements;
+}
+
+size_t
+MlasConvPrepareExpandThenGemm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution that expands the input and then
+    invokes the GEMM, which supports any convolution.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns the number of elements to allocate for the working buffer.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    size_t WorkingBufferSize;
+
+    if (FilterCount > OutputSize) {
+
+        //
+        // The filter count is larger than the output dimensions, so perform the
+        // full matrix expansion and then invoke the threaded GEMM.
+        //
+
+        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+
+        WorkingBufferSize = OutputSize * K;
+
+    } else {
+
+        //
+        // Segment the operation across multiple threads by slicing the N
+        // dimension (see MlasSgemmTryMultithread).
+        //
+        // Compute the number of target threads given the complexity of the
+        // convolution operation. Small requests should run using the single
+        // threaded path.
+        //
+
+        int32_t TargetThreadCount;
+        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        } else {
+            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        //
+        // Compute the thread stride for slicing the N dimension.
+        //
+
+        size_t StrideN = OutputSize / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != OutputSize) {
+            StrideN++;
+        }
+
+        if (TargetThreadCount > 1) {
+
+            StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+            if (StrideN >= OutputSize) {
+                TargetThreadCount = 1;
+            } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
+                TargetThreadCount--;
+            }
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
+        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
+        Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+
+        WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+    }
+
+    return WorkingBufferSize;
+}
+
+void
+MLASCALL
+MlasConvPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t Dimensions,
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t FilterCount,
+    const MLAS_ACTIVATION* Activation,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a convolution operation by computing required
+    parameters including the required working buffer size for intermediate
+    results.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    Dimensions - Supplies the number of dimensions (must be 2 or 3).
+
+    BatchCount - Supplies the number of batches to the processed.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of zero padding elements at the edge of the
+        input tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor.
 
     FilterCount - Supplies the number of rows of the filter matrix per group.
 
@@ -1166,69 +2318,106 @@ Return Value:
         }
     }
 
-    if (FilterCount > OutputSize) {
+    if (Dimensions == 2 && InputChannels == 1 && FilterCount == 1 && GroupCount > 1) {
 
         //
-        // The filter count is larger than the output dimensions, so perform the
-        // full matrix expansion and then invoke the threaded GEMM.
+        // Detect a depthwise convolution where each group has a single input
+        // and output channel. These are computed directly from the input
+        // tensor instead of expanding each channel for a single row GEMM.
         //
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
 
-        *WorkingBufferSize = OutputSize * K;
+        return;
+    }
 
-    } else {
+    if (MlasConvIsWinogradSupported(Parameters) &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
 
         //
-        // Segment the operation across multiple threads by slicing the N
-        // dimension (see MlasSgemmTryMultithread).
-        //
-        // Compute the number of target threads given the complexity of the
-        // convolution operation. Small requests should run using the single
-        // threaded path.
+        // Use the Winograd F(4x4, 3x3) algorithm for 3x3 unit stride
+        // convolutions, which reduces the number of multiplies by 2.25x
+        // compared to the direct GEMM of the expanded input.
         //
 
-        int32_t TargetThreadCount;
-        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+        *WorkingBufferSize = MlasConvPrepareWinograd(Parameters, ThreadPool);
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-        } else {
-            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-        }
+        return;
+    }
 
-        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    *WorkingBufferSize = MlasConvPrepareExpandThenGemm(Parameters, ThreadPool);
+}
 
-        if (TargetThreadCount >= MaximumThreadCount) {
-            TargetThreadCount = MaximumThreadCount;
-        }
+bool
+MLASCALL
+MlasConvSelectAlgorithm(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_ALGORITHM Algorithm,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
 
-        //
-        // Compute the thread stride for slicing the N dimension.
-        //
+Routine Description:
 
-        size_t StrideN = OutputSize / TargetThreadCount;
+    This routine switches a convolution prepared by MlasConvPrepare to another
+    algorithm, for example to benchmark the alternatives to the algorithm that
+    MlasConvPrepare selected.
 
-        if ((StrideN * TargetThreadCount) != OutputSize) {
-            StrideN++;
-        }
+Arguments:
 
-        if (TargetThreadCount > 1) {
+    Parameters - Supplies the structure returned by MlasConvPrepare, which is
+        updated for the algorithm.
 
-            StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+    Algorithm - Supplies the algorithm to use. Either of the algorithms that
+        expand the input selects the variant that suits the shape.
 
-            if (StrideN >= OutputSize) {
-                TargetThreadCount = 1;
-            } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
-                TargetThreadCount--;
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the algorithm supports the convolution, else false and the
+    parameters are left unchanged.
+
+--*/
+{
+    switch (Algorithm) {
+
+        case MlasConvAlgorithmWinograd:
+        {
+            if (!MlasConvIsWinogradSupported(Parameters)) {
+                return false;
             }
+
+            *WorkingBufferSize = MlasConvPrepareWinograd(Parameters, ThreadPool);
+            return true;
         }
 
-        Parameters->ThreadCount = TargetThreadCount;
+        case MlasConvAlgorithmExpandThenGemm:
+        case MlasConvAlgorithmExpandThenGemmSegmented:
+        {
+            *WorkingBufferSize = MlasConvPrepareExpandThenGemm(Parameters, ThreadPool);
+            return true;
+        }
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
-        Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+        default:
+        {
+            //
+            // The direct GEMM and depthwise algorithms are only used for the
+            // shapes that MlasConvPrepare selects them for.
+            //
+
+            if (Parameters->Algorithm != Algorithm) {
+                return false;
+            }
 
-        *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+            *WorkingBufferSize = 0;
+            return true;
+        }
     }
 }
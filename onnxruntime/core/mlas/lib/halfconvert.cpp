@@ -0,0 +1,398 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfconvert.cpp
+
+Abstract:
+
+    This module implements routines to convert between buffers of half
+    precision and single precision floating point values.
+
+    The implementation below targets the base instruction set (typically SSE2)
+    while the F16C kernels convert eight elements per instruction on processors
+    that support them.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Accesses the bits of a single precision value.
+//
+
+union MLAS_HALFCONVERT_FLOATBITS {
+    uint32_t u;
+    float f;
+};
+
+MLAS_FORCEINLINE
+float
+MlasConvertHalfToFloat(
+    unsigned short Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision value to single precision.
+
+Arguments:
+
+    Value - Supplies the half precision value.
+
+Return Value:
+
+    Returns the single precision value.
+
+--*/
+{
+    const uint32_t ShiftedExponent = 0x7C00 << 13;
+
+    MLAS_HALFCONVERT_FLOATBITS Result;
+
+    Result.u = (uint32_t(Value) & 0x7FFF) << 13;
+
+    uint32_t Exponent = ShiftedExponent & Result.u;
+
+    Result.u += (127 - 15) << 23;
+
+    if (Exponent == ShiftedExponent) {
+
+        //
+        // Infinity or NaN.
+        //
+
+        Result.u += (128 - 16) << 23;
+
+    } else if (Exponent == 0) {
+
+        //
+        // Zero or denormal: renormalize through a float subtraction.
+        //
+
+        MLAS_HALFCONVERT_FLOATBITS Magic;
+
+        Magic.u = 113 << 23;
+
+        Result.u += 1 << 23;
+        Result.f -= Magic.f;
+    }
+
+    Result.u |= (uint32_t(Value) & 0x8000) << 16;
+
+    return Result.f;
+}
+
+MLAS_FORCEINLINE
+unsigned short
+MlasConvertFloatToHalf(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to half precision, rounding
+    to the nearest even value. Values too large for half precision become
+    infinity and NaNs stay NaNs.
+
+Arguments:
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the half precision value.
+
+--*/
+{
+    MLAS_HALFCONVERT_FLOATBITS Bits;
+
+    Bits.f = Value;
+
+    const uint32_t Sign = Bits.u & 0x80000000;
+    Bits.u ^= Sign;
+
+    uint32_t Result;
+
+    if (Bits.u >= ((127 + 16) << 23)) {
+
+        //
+        // Infinity or NaN, or a value that overflows to infinity.
+        //
+
+        Result = (Bits.u > (255 << 23)) ? 0x7E00 : 0x7C00;
+
+    } else if (Bits.u < (113 << 23)) {
+
+        //
+        // Zero or denormal: align the mantissa bits through a float addition,
+        // which rounds to nearest even.
+        //
+
+        MLAS_HALFCONVERT_FLOATBITS Magic;
+
+        Magic.u = 126 << 23;
+
+        Bits.f += Magic.f;
+        Result = Bits.u - Magic.u;
+
+    } else {
+
+        //
+        // Rebias the exponent and round the mantissa to nearest even.
+        //
+
+        const uint32_t MantissaOdd = (Bits.u >> 13) & 1;
+
+        Bits.u += (uint32_t(15 - 127) << 23) + 0xFFF + MantissaOdd;
+        Result = Bits.u >> 13;
+    }
+
+    return (unsigned short)(Result | (Sign >> 16));
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to convert the source buffer of
+    half precision floats to the destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half precision floats.
+
+    Destination - Supplies the destination buffer of single precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i MaskSign = _mm_set1_epi32(0x7FFF);
+    const __m128i CompareInfinity = _mm_set1_epi32(0x7C00);
+    const __m128i CompareSmallest = _mm_set1_epi32(0x0400);
+    const __m128i AdjustExponent = _mm_set1_epi32(0x38000000);
+    const __m128i MagicDenormal = _mm_set1_epi32(0x38800000);
+
+    while (Count >= 4) {
+
+        __m128i Value = _mm_loadl_epi64((const __m128i*)Source);
+
+        Value = _mm_unpacklo_epi16(Value, Value);
+
+        //
+        // Split the sign from the exponent and mantissa, and find the
+        // infinities, NaNs and denormals.
+        //
+
+        __m128i ExponentMantissa = _mm_and_si128(Value, MaskSign);
+        __m128i Sign = _mm_slli_epi32(_mm_xor_si128(Value, ExponentMantissa), 16);
+        __m128i NotInfinity = _mm_cmpgt_epi32(CompareInfinity, ExponentMantissa);
+        __m128i Denormal = _mm_cmpgt_epi32(CompareSmallest, ExponentMantissa);
+
+        ExponentMantissa = _mm_slli_epi32(ExponentMantissa, 13);
+
+        __m128i Normal = _mm_add_epi32(ExponentMantissa, AdjustExponent);
+        Normal = _mm_add_epi32(Normal, _mm_andnot_si128(NotInfinity, AdjustExponent));
+
+        __m128 Renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(ExponentMantissa, MagicDenormal)),
+            _mm_castsi128_ps(MagicDenormal));
+
+        __m128i Result = _mm_or_si128(_mm_and_si128(Denormal, _mm_castps_si128(Renormalized)),
+            _mm_andnot_si128(Denormal, Normal));
+
+        _mm_storeu_ps(Destination, _mm_castsi128_ps(_mm_or_si128(Result, Sign)));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    while (Count > 0) {
+
+        *Destination++ = MlasConvertHalfToFloat(*Source++);
+        Count -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to convert the source buffer of
+    single precision floats to the destination buffer of half precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of single precision floats.
+
+    Destination - Supplies the destination buffer of half precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i MaskSign = _mm_set1_epi32(0x7FFFFFFF);
+    const __m128i CompareOverflow = _mm_set1_epi32(((127 + 16) << 23) - 1);
+    const __m128i CompareInfinity = _mm_set1_epi32(255 << 23);
+    const __m128i CompareDenormal = _mm_set1_epi32(113 << 23);
+    const __m128i HalfInfinity = _mm_set1_epi32(0x7C00);
+    const __m128i HalfQuietNaN = _mm_set1_epi32(0x0200);
+    const __m128i MagicDenormal = _mm_set1_epi32(126 << 23);
+    const __m128i AdjustExponent = _mm_set1_epi32(int32_t(uint32_t(15 - 127) << 23) + 0xFFF);
+    const __m128i One = _mm_set1_epi32(1);
+
+    while (Count >= 4) {
+
+        __m128i Value = _mm_castps_si128(_mm_loadu_ps(Source));
+
+        __m128i Magnitude = _mm_and_si128(Value, MaskSign);
+        __m128i Sign = _mm_srli_epi32(_mm_xor_si128(Value, Magnitude), 16);
+
+        //
+        // Compute the infinities and NaNs, the denormals and the normal
+        // values, then select the result for each element.
+        //
+
+        __m128i Overflow = _mm_cmpgt_epi32(Magnitude, CompareOverflow);
+        __m128i Special = _mm_or_si128(HalfInfinity,
+            _mm_and_si128(_mm_cmpgt_epi32(Magnitude, CompareInfinity), HalfQuietNaN));
+
+        __m128i Denormal = _mm_cmpgt_epi32(CompareDenormal, Magnitude);
+        __m128i Subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Magnitude),
+            _mm_castsi128_ps(MagicDenormal))), MagicDenormal);
+
+        __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Magnitude, 13), One);
+        __m128i Normal = _mm_add_epi32(_mm_add_epi32(Magnitude, AdjustExponent), MantissaOdd);
+        Normal = _mm_srli_epi32(Normal, 13);
+
+        __m128i Result = _mm_or_si128(_mm_and_si128(Denormal, Subnormal), _mm_andnot_si128(Denormal, Normal));
+        Result = _mm_or_si128(_mm_and_si128(Overflow, Special), _mm_andnot_si128(Overflow, Result));
+        Result = _mm_or_si128(Result, Sign);
+
+        //
+        // Sign extend the 16-bit results so the signed saturating pack keeps
+        // their bits.
+        //
+
+        Result = _mm_srai_epi32(_mm_slli_epi32(Result, 16), 16);
+        _mm_storel_epi64((__m128i*)Destination, _mm_packs_epi32(Result, Result));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#endif
+
+    while (Count > 0) {
+
+        *Destination++ = MlasConvertFloatToHalf(*Source++);
+        Count -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision floats to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half precision floats.
+
+    Destination - Supplies the destination buffer of single precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertHalfToFloatKernelRoutine(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of half precision floats, rounding to the nearest even
+    value.
+
+Arguments:
+
+    Source - Supplies the source buffer of single precision floats.
+
+    Destination - Supplies the destination buffer of half precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertFloatToHalfKernelRoutine(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
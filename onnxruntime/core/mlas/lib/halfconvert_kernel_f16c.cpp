@@ -0,0 +1,137 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfconvert_kernel_f16c.cpp
+
+Abstract:
+
+    This module implements the kernels to convert between buffers of half
+    precision and single precision floating point values.
+
+    This implementation uses F16C instructions.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half precision floats to the
+    destination buffer of single precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half precision floats.
+
+    Destination - Supplies the destination buffer of single precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m128i Value = _mm_loadu_si128((const __m128i*)Source);
+
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(Value));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a local buffer.
+        //
+
+        unsigned short HalfBuffer[8] = { 0 };
+        float FloatBuffer[8];
+
+        std::copy_n(Source, Count, HalfBuffer);
+
+        __m128i Value = _mm_loadu_si128((const __m128i*)HalfBuffer);
+
+        _mm256_storeu_ps(FloatBuffer, _mm256_cvtph_ps(Value));
+
+        std::copy_n(FloatBuffer, Count, Destination);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single precision floats to the
+    destination buffer of half precision floats, rounding to the nearest even
+    value.
+
+Arguments:
+
+    Source - Supplies the source buffer of single precision floats.
+
+    Destination - Supplies the destination buffer of half precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m256 Value = _mm256_loadu_ps(Source);
+
+        _mm_storeu_si128((__m128i*)Destination, _mm256_cvtps_ph(Value, 0));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        //
+        // Convert the remaining elements through a local buffer.
+        //
+
+        float FloatBuffer[8] = { 0 };
+        unsigned short HalfBuffer[8];
+
+        std::copy_n(Source, Count, FloatBuffer);
+
+        __m256 Value = _mm256_loadu_ps(FloatBuffer);
+
+        _mm_storeu_si128((__m128i*)HalfBuffer, _mm256_cvtps_ph(Value, 0));
+
+        std::copy_n(HalfBuffer, Count, Destination);
+    }
+}
@@ -0,0 +1,665 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the reduced precision matrix/matrix multiply
+    operations for half precision and bfloat16 matrices, and the single
+    precision matrix/matrix multiply with a matrix B compressed to half
+    precision or 8-bit integers.
+
+    The input matrices are converted to single precision one slice at a time
+    into local buffers and multiplied with the SGEMM kernels, so the full
+    precision copies of the inputs never exist in memory.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows from matrix A to convert to a local buffer.
+//
+
+#define MLAS_HALFGEMM_STRIDEM               32
+
+//
+// Define the conversion routines for the supported input formats.
+//
+
+union MLAS_HALFGEMM_FLOATBITS {
+    uint32_t u;
+    float f;
+};
+
+struct MLAS_HALFGEMM_HALF_CONVERTER {
+
+    typedef unsigned short ValueType;
+
+    static
+    float
+    Convert(
+        unsigned short Value
+        )
+    {
+        const uint32_t ShiftedExponent = 0x7C00 << 13;
+
+        MLAS_HALFGEMM_FLOATBITS Result;
+
+        Result.u = (uint32_t(Value) & 0x7FFF) << 13;
+
+        uint32_t Exponent = ShiftedExponent & Result.u;
+
+        Result.u += (127 - 15) << 23;
+
+        if (Exponent == ShiftedExponent) {
+
+            //
+            // Infinity or NaN.
+            //
+
+            Result.u += (128 - 16) << 23;
+
+        } else if (Exponent == 0) {
+
+            //
+            // Zero or denormal: renormalize through a float subtraction.
+            //
+
+            MLAS_HALFGEMM_FLOATBITS Magic;
+
+            Magic.u = 113 << 23;
+
+            Result.u += 1 << 23;
+            Result.f -= Magic.f;
+        }
+
+        Result.u |= (uint32_t(Value) & 0x8000) << 16;
+
+        return Result.f;
+    }
+};
+
+struct MLAS_HALFGEMM_BFLOAT16_CONVERTER {
+
+    typedef unsigned short ValueType;
+
+    static
+    float
+    Convert(
+        unsigned short Value
+        )
+    {
+        MLAS_HALFGEMM_FLOATBITS Result;
+
+        Result.u = uint32_t(Value) << 16;
+
+        return Result.f;
+    }
+};
+
+struct MLAS_HALFGEMM_INT8_CONVERTER {
+
+    typedef int8_t ValueType;
+
+    static
+    float
+    Convert(
+        int8_t Value
+        )
+    {
+        return float(Value);
+    }
+};
+
+struct MLAS_HALFGEMM_FLOAT_CONVERTER {
+
+    typedef float ValueType;
+
+    static
+    float
+    Convert(
+        float Value
+        )
+    {
+        return Value;
+    }
+};
+
+//
+// Define the parameters to execute segments of a reduced precision GEMM
+// operation on worker threads.
+//
+
+struct MLAS_HALFGEMM_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const void* A;
+    size_t lda;
+    const void* B;
+    size_t ldb;
+    float beta;
+    float* C;
+    size_t ldc;
+    size_t ThreadCount;
+};
+
+template<typename Converter>
+void
+MlasHalfGemmConvertMatrix(
+    CBLAS_TRANSPOSE Trans,
+    const typename Converter::ValueType* S,
+    size_t lds,
+    size_t Rows,
+    size_t Columns,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a slice of a reduced precision matrix to a row major
+    single precision buffer, applying the transpose operation of the matrix.
+
+Arguments:
+
+    Trans - Supplies the transpose operation of the source matrix.
+
+    S - Supplies the address of the first element of the slice.
+
+    lds - Supplies the first dimension of the source matrix.
+
+    Rows - Supplies the number of rows of the slice after the transpose
+        operation.
+
+    Columns - Supplies the number of columns of the slice after the transpose
+        operation.
+
+    D - Supplies the address of the destination buffer, which has a first
+        dimension of Columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Trans == CblasNoTrans) {
+
+        for (size_t r = 0; r < Rows; r++) {
+
+            const typename Converter::ValueType* s = S + r * lds;
+
+            for (size_t c = 0; c < Columns; c++) {
+                *D++ = Converter::Convert(s[c]);
+            }
+        }
+
+    } else {
+
+        for (size_t r = 0; r < Rows; r++) {
+
+            const typename Converter::ValueType* s = S + r;
+
+            for (size_t c = 0; c < Columns; c++) {
+                *D++ = Converter::Convert(s[c * lds]);
+            }
+        }
+    }
+}
+
+template<typename ConverterA, typename ConverterB>
+void
+MlasHalfGemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const typename ConverterA::ValueType* A,
+    size_t lda,
+    const typename ConverterB::ValueType* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the reduced precision matrix/matrix multiply
+    operation on a single thread.
+
+    Each slice of matrix B is converted and packed once, then multiplied by
+    the converted slices of matrix A along the M dimension.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HALFGEMM_STRIDEM * MLAS_SGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEK * MLAS_SGEMM_STRIDEN], 64);
+    MLAS_DECLSPEC_ALIGN(float PackedB[MLAS_SGEMM_STRIDEK * MLAS_SGEMM_STRIDEN], 64);
+
+    size_t CountN;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = MLAS_SGEMM_STRIDEN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        const size_t AlignedCountN = (CountN + 15) & ~size_t(15);
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const typename ConverterB::ValueType* b = (TransB == CblasNoTrans) ? B + k * ldb + n : B + n * ldb + k;
+
+            MlasHalfGemmConvertMatrix<ConverterB>(TransB, b, ldb, CountK, CountN, PanelB);
+
+            MlasSgemmPackB(CblasNoTrans, CountN, CountK, PanelB, CountN, PackedB);
+
+            float SliceBeta = (k == 0) ? beta : 1.0f;
+
+            size_t CountM;
+
+            for (size_t m = 0; m < M; m += CountM) {
+
+                CountM = MLAS_HALFGEMM_STRIDEM;
+
+                if (CountM > (M - m)) {
+                    CountM = M - m;
+                }
+
+                const typename ConverterA::ValueType* a = (TransA == CblasNoTrans) ? A + m * lda + k : A + k * lda + m;
+
+                MlasHalfGemmConvertMatrix<ConverterA>(TransA, a, lda, CountM, CountK, PanelA);
+
+                MlasSgemmPackedOperation(CblasNoTrans, CountM, 0, CountN, CountK,
+                    alpha, PanelA, CountK, PackedB, AlignedCountN, SliceBeta,
+                    C + m * ldc + n, ldc);
+            }
+        }
+    }
+}
+
+template<typename ConverterA, typename ConverterB>
+void
+MlasHalfGemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    reduced precision GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_HALFGEMM_WORK_BLOCK* WorkBlock = (const MLAS_HALFGEMM_WORK_BLOCK*)Context;
+
+    const typename ConverterA::ValueType* A = (const typename ConverterA::ValueType*)WorkBlock->A;
+    const typename ConverterB::ValueType* B = (const typename ConverterB::ValueType*)WorkBlock->B;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    //
+    // Segment the operation along the larger of the M and N dimensions.
+    //
+
+    if (N > M) {
+
+        size_t StrideN = (N + WorkBlock->ThreadCount - 1) / WorkBlock->ThreadCount;
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        size_t n = size_t(Index) * StrideN;
+
+        if (n >= N) {
+            return;
+        }
+
+        size_t CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+        MlasHalfGemmOperation<ConverterA, ConverterB>(WorkBlock->TransA, WorkBlock->TransB,
+            M, CountN, WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda,
+            B + n * pldb, WorkBlock->ldb, WorkBlock->beta,
+            WorkBlock->C + n, WorkBlock->ldc);
+
+    } else {
+
+        size_t StrideM = (M + WorkBlock->ThreadCount - 1) / WorkBlock->ThreadCount;
+
+        size_t m = size_t(Index) * StrideM;
+
+        if (m >= M) {
+            return;
+        }
+
+        size_t CountM = StrideM;
+
+        if (CountM > (M - m)) {
+            CountM = M - m;
+        }
+
+        size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+        MlasHalfGemmOperation<ConverterA, ConverterB>(WorkBlock->TransA, WorkBlock->TransB,
+            CountM, N, WorkBlock->K, WorkBlock->alpha, A + m * plda,
+            WorkBlock->lda, B, WorkBlock->ldb, WorkBlock->beta,
+            WorkBlock->C + m * WorkBlock->ldc, WorkBlock->ldc);
+    }
+}
+
+template<typename ConverterA, typename ConverterB>
+void
+MlasHalfGemmDispatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const typename ConverterA::ValueType* A,
+    size_t lda,
+    const typename ConverterB::ValueType* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine runs a reduced precision matrix/matrix multiply operation
+    across multiple threads or falls back to a single thread based on the
+    complexity of the operation.
+
+Arguments:
+
+    See MlasHalfGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation, using the same per-thread target as SGEMM.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasHalfGemmOperation<ConverterA, ConverterB>(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+        return;
+    }
+
+    MLAS_HALFGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.ThreadCount = size_t(TargetThreadCount);
+
+    MlasExecuteThreaded(MlasHalfGemmOperationThreaded<ConverterA, ConverterB>, &WorkBlock, TargetThreadCount,
+        ThreadPool);
+}
+
+void
+MLASCALL
+MlasHalfGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the matrix/matrix multiply operation for half
+    precision matrices A and B with a single precision matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasHalfGemmDispatch<MLAS_HALFGEMM_HALF_CONVERTER, MLAS_HALFGEMM_HALF_CONVERTER>(TransA, TransB, M, N, K,
+        alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasBFloat16Gemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const unsigned short* A,
+    size_t lda,
+    const unsigned short* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the matrix/matrix multiply operation for bfloat16
+    matrices A and B with a single precision matrix C.
+
+Arguments:
+
+    See MlasHalfGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasHalfGemmDispatch<MLAS_HALFGEMM_BFLOAT16_CONVERTER, MLAS_HALFGEMM_BFLOAT16_CONVERTER>(TransA, TransB, M, N, K,
+        alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
+
+void
+MLASCALL
+MlasSgemmCompressedB(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* B,
+    MLAS_COMPRESSED_FORMAT FormatB,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation with a matrix B compressed to half precision or to signed 8-bit
+    integers. Each slice of matrix B is expanded to single precision while it
+    is packed, so the memory holding matrix B stays at the compressed size.
+
+Arguments:
+
+    FormatB - Supplies the format of the elements of matrix B. The elements of
+        a MlasCompressedInt8 matrix are multiplied as their integer values, so
+        the scale of the matrix is applied through alpha.
+
+    See MlasHalfGemm for the other arguments.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (FormatB == MlasCompressedInt8) {
+        MlasHalfGemmDispatch<MLAS_HALFGEMM_FLOAT_CONVERTER, MLAS_HALFGEMM_INT8_CONVERTER>(TransA, TransB, M, N, K,
+            alpha, A, lda, (const int8_t*)B, ldb, beta, C, ldc, ThreadPool);
+    } else {
+        MlasHalfGemmDispatch<MLAS_HALFGEMM_FLOAT_CONVERTER, MLAS_HALFGEMM_HALF_CONVERTER>(TransA, TransB, M, N, K,
+            alpha, A, lda, (const unsigned short*)B, ldb, beta, C, ldc, ThreadPool);
+    }
+}
@@ -129,6 +129,21 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the shape of the blocks of a block sparse matrix B. Blocks span the
+// 16 columns of a packed panel and MLAS_SGEMM_SPARSE_BLOCK_K rows, and a
+// matrix is packed as block sparse when at most the fraction
+// 1/MLAS_SGEMM_SPARSE_MINIMUM_RATIO of its blocks are nonzero, since each
+// block is a separate kernel call that reloads the output.
+//
+// The rows of matrix A are stepped through MLAS_SGEMM_SPARSE_STRIDEM at a time
+// so that a slice of matrix A stays in the cache for all panels of matrix B.
+//
+
+#define MLAS_SGEMM_SPARSE_BLOCK_K                   16
+#define MLAS_SGEMM_SPARSE_MINIMUM_RATIO             2
+#define MLAS_SGEMM_SPARSE_STRIDEM                   64
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -240,6 +255,22 @@ size_t
 
 typedef MLAS_GEMM_U8U8_KERNEL* PMLAS_GEMM_U8U8_KERNEL;
 
+//
+// Define the convolution kernel flags.
+//
+
+#define MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT     0x00000001
+#define MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION         0x00000002
+#define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION       0x00000004
+#define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION      0x00000008
+
+//
+// Define the NCHWc block size used by the NEON convolution and pooling
+// kernels. The block is processed as a pair of 128-bit vectors.
+//
+
+#define MLAS_NEON_NCHWC_BLOCK_SIZE                  8
+
 typedef
 void
 (MLASCALL MLAS_CONV_FLOAT_KERNEL)(
@@ -339,6 +370,46 @@ void
 
 typedef MLAS_ELEMENTWISE_KERNEL_ROUTINE* PMLAS_ELEMENTWISE_KERNEL_ROUTINE;
 
+typedef
+float
+(MLASCALL MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL)(
+    const float* Input,
+    size_t N
+    );
+
+typedef MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL;
+
+typedef
+float
+(MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    );
+
+typedef MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_KERNEL)(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_KERNEL* PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL;
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -415,10 +486,23 @@ extern "C" {
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasLogisticKernel;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasTanhKernel;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernel;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32Kernel;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32Kernel;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernel;
 #if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_KERNEL MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasLogisticKernelFma3;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasTanhKernelFma3;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernelFma3;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasLogisticKernelAvx512F;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasTanhKernelAvx512F;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernelAvx512F;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32KernelAvx512F;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx512F;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
 #endif
 
 }
@@ -459,6 +543,20 @@ extern "C" {
 #endif
 #endif
 
+//
+// Define the target number of per-thread elements before using another thread
+// to compute additional rows of a softmax operation.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (16 * 1024)
+
+//
+// Define the target number of per-thread input elements reduced before using
+// another thread to compute additional channels of a pooling operation.
+//
+
+#define MLAS_POOL_THREAD_COMPLEXITY                 (64 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -480,6 +578,23 @@ MlasSgemmOperation(
     size_t ldc
     );
 
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
 //
 // Environment information class.
 //
@@ -488,6 +603,10 @@ struct MLAS_PLATFORM {
 
     MLAS_PLATFORM(void);
 
+    MLAS_ISA SelectKernels(MLAS_ISA MaximumIsa);
+
+    MLAS_ISA Isa;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
     PMLAS_GEMM_FLOAT_KERNEL GemmFloatKernel;
     PMLAS_GEMM_U8U8_COPY_PACKA_ROUTINE GemmU8U8CopyPackARoutine;
@@ -507,6 +626,11 @@ struct MLAS_PLATFORM {
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE TanhKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE ErfKernelRoutine;
+    PMLAS_ELEMENTWISE_KERNEL_ROUTINE ComputeExpF32Kernel;
+    PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL ReduceMaximumF32Kernel;
+    PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL ComputeSumExpF32Kernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_KERNEL ConvertHalfToFloatKernelRoutine;
+    PMLAS_CONVERT_FLOAT_TO_HALF_KERNEL ConvertFloatToHalfKernelRoutine;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
@@ -77,6 +77,31 @@ Return Value:
 
 --*/
 {
+    this->Isa = SelectKernels(MlasIsaMaximum);
+}
+
+MLAS_ISA
+MLAS_PLATFORM::SelectKernels(
+    MLAS_ISA MaximumIsa
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the kernels for the highest instruction set supported
+    by the processor that does not exceed the supplied limit.
+
+Arguments:
+
+    MaximumIsa - Supplies the highest instruction set that may be selected.
+
+Return Value:
+
+    Returns the instruction set that was selected.
+
+--*/
+{
+    MLAS_ISA Isa = MlasIsaBaseline;
 
 #if defined(MLAS_TARGET_AMD64_IX86)
 
@@ -91,6 +116,8 @@ Return Value:
 
 #if defined(MLAS_TARGET_AMD64)
 
+    this->KernelM1Routine = nullptr;
+    this->KernelM1TransposeBRoutine = nullptr;
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
@@ -102,6 +129,11 @@ Return Value:
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
     this->ErfKernelRoutine = MlasErfKernel;
+    this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
+    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->ConvertHalfToFloatKernelRoutine = MlasConvertHalfToFloatKernel;
+    this->ConvertFloatToHalfKernelRoutine = MlasConvertFloatToHalfKernel;
     this->NchwcBlockSize = 8;
     this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
 
@@ -118,7 +150,7 @@ Return Value:
     __cpuid(1, Cpuid1[0], Cpuid1[1], Cpuid1[2], Cpuid1[3]);
 #endif
 
-    if ((Cpuid1[2] & 0x18000000) == 0x18000000) {
+    if (MaximumIsa >= MlasIsaAvx && (Cpuid1[2] & 0x18000000) == 0x18000000) {
 
         //
         // Check if the operating system supports saving SSE and AVX states.
@@ -128,6 +160,8 @@ Return Value:
 
         if ((xcr0 & 0x6) == 0x6) {
 
+            Isa = MlasIsaAvx;
+
             this->GemmFloatKernel = MlasGemmFloatKernelAvx;
 
 #if defined(MLAS_TARGET_AMD64)
@@ -143,6 +177,15 @@ Return Value:
             this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
             this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
 
+            //
+            // Check if the processor supports the F16C feature.
+            //
+
+            if ((Cpuid1[2] & 0x20000000) != 0) {
+                this->ConvertHalfToFloatKernelRoutine = MlasConvertHalfToFloatKernelF16C;
+                this->ConvertFloatToHalfKernelRoutine = MlasConvertFloatToHalfKernelF16C;
+            }
+
             //
             // Check if the processor supports AVX512F (and the operating
             // system supports saving AVX512F state) or AVX2/FMA3 features.
@@ -155,13 +198,22 @@ Return Value:
             __cpuid_count(7, 0, Cpuid7[0], Cpuid7[1], Cpuid7[2], Cpuid7[3]);
 #endif
 
-            if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
+            if (MaximumIsa >= MlasIsaAvx2 &&
+                ((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
+
+                Isa = MlasIsaAvx2;
 
                 this->GemmU8U8CopyPackARoutine = MlasGemmU8U8CopyPackAAvx2;
                 this->GemmU8U8CopyPackBRoutine = MlasGemmU8U8CopyPackBAvx2;
                 this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx2;
+                this->LogisticKernelRoutine = MlasLogisticKernelFma3;
+                this->TanhKernelRoutine = MlasTanhKernelFma3;
+                this->ErfKernelRoutine = MlasErfKernelFma3;
 
-                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
+                if (MaximumIsa >= MlasIsaAvx512F &&
+                    ((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
+
+                    Isa = MlasIsaAvx512F;
 
                     this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
                     this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx512F;
@@ -171,6 +223,12 @@ Return Value:
                     this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+                    this->LogisticKernelRoutine = MlasLogisticKernelAvx512F;
+                    this->TanhKernelRoutine = MlasTanhKernelAvx512F;
+                    this->ErfKernelRoutine = MlasErfKernelAvx512F;
+                    this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
+                    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx512F;
+                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
 
@@ -178,7 +236,9 @@ Return Value:
                     // Check if the processor supports AVX512BW.
                     //
 
-                    if ((Cpuid7[1] & 0x40000000) != 0) {
+                    if (MaximumIsa >= MlasIsaAvx512BW && (Cpuid7[1] & 0x40000000) != 0) {
+
+                        Isa = MlasIsaAvx512BW;
 
                         this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512BW;
 
@@ -186,7 +246,8 @@ Return Value:
                         // Check if the processor supports AVX512VNNI.
                         //
 
-                        if ((Cpuid7[2] & 0x800) != 0) {
+                        if (MaximumIsa >= MlasIsaAvx512Vnni && (Cpuid7[2] & 0x800) != 0) {
+                            Isa = MlasIsaAvx512Vnni;
                             this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Vnni;
                         }
                     }
@@ -199,10 +260,6 @@ Return Value:
                     this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
                     this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
                 }
-
-                this->LogisticKernelRoutine = MlasLogisticKernelFma3;
-                this->TanhKernelRoutine = MlasTanhKernelFma3;
-                this->ErfKernelRoutine = MlasErfKernelFma3;
             }
 
 #endif
@@ -210,8 +267,73 @@ Return Value:
         }
     }
 
+#else
+
+    MLAS_UNREFERENCED_PARAMETER(MaximumIsa);
+
 #endif
 
+    return Isa;
+}
+
+MLAS_ISA
+MLASCALL
+MlasSetMaximumIsa(
+    MLAS_ISA MaximumIsa
+    )
+/*++
+
+Routine Description:
+
+    This routine reselects the kernels used by this library, limiting the
+    selection to instruction sets that do not exceed the supplied limit. This
+    allows tests and benchmarks to exercise each of the dispatch paths
+    supported by the processor.
+
+    This routine must not be called while other library routines are
+    executing. Buffers that were reordered to the NCHWc format or that were
+    allocated with the preferred buffer alignment before this call may no
+    longer match the values returned afterwards.
+
+Arguments:
+
+    MaximumIsa - Supplies the highest instruction set that may be selected.
+        Specifying MlasIsaMaximum restores the default selection.
+
+Return Value:
+
+    Returns the instruction set that was selected.
+
+--*/
+{
+    MlasPlatform.Isa = MlasPlatform.SelectKernels(MaximumIsa);
+
+    return MlasPlatform.Isa;
+}
+
+MLAS_ISA
+MLASCALL
+MlasGetIsa(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the instruction set used by the currently selected
+    kernels.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the selected instruction set.
+
+--*/
+{
+    return MlasPlatform.Isa;
 }
 
 size_t
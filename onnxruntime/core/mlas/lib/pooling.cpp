@@ -46,6 +46,21 @@ void
 
 typedef MLAS_POOL_KERNEL_ROUTINE* PMLAS_POOL_KERNEL_ROUTINE;
 
+//
+// Define the parameters to execute a range of the channels of a pooling
+// operation on worker threads.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    const float* Input;
+    float* Output;
+    size_t TotalChannelCount;
+    size_t OutputSize;
+    int32_t ThreadCount;
+};
+
 //
 // Define the number of elements to allocate on the stack for the reduction
 // buffer in the vectorized kernels.
@@ -1071,6 +1086,34 @@ Return Value:
 
         MLAS_FLOAT32X4 Reduction = PoolingType::InitialVector();
 
+        //
+        // Reduce into independent vectors so that consecutive reductions do
+        // not wait on each other, then combine the vectors.
+        //
+
+        if (InputSizeRemaining >= 16) {
+
+            MLAS_FLOAT32X4 Reduction1 = Reduction;
+            MLAS_FLOAT32X4 Reduction2 = Reduction;
+            MLAS_FLOAT32X4 Reduction3 = Reduction;
+
+            do {
+
+                Reduction = PoolingType::Reduce(Reduction, MlasLoadFloat32x4(Input));
+                Reduction1 = PoolingType::Reduce(Reduction1, MlasLoadFloat32x4(Input + 4));
+                Reduction2 = PoolingType::Reduce(Reduction2, MlasLoadFloat32x4(Input + 8));
+                Reduction3 = PoolingType::Reduce(Reduction3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                InputSizeRemaining -= 16;
+
+            } while (InputSizeRemaining >= 16);
+
+            Reduction = PoolingType::Reduce(Reduction, Reduction1);
+            Reduction2 = PoolingType::Reduce(Reduction2, Reduction3);
+            Reduction = PoolingType::Reduce(Reduction, Reduction2);
+        }
+
         while (InputSizeRemaining >= 4) {
             Reduction = PoolingType::Reduce(Reduction, MlasLoadFloat32x4(Input));
             Input += 4;
@@ -1171,6 +1214,62 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    //
+    // Partition the channels evenly across the threads.
+    //
+
+    const size_t TotalChannelCount = ThreadedWorkBlock->TotalChannelCount;
+    const size_t ChannelsPerThread = TotalChannelCount / ThreadedWorkBlock->ThreadCount;
+    const size_t ChannelsPerThreadExtra = TotalChannelCount % ThreadedWorkBlock->ThreadCount;
+
+    size_t ChannelIndex;
+    size_t ChannelCount;
+
+    if (uint32_t(Index) < ChannelsPerThreadExtra) {
+        ChannelIndex = (ChannelsPerThread + 1) * Index;
+        ChannelCount = ChannelsPerThread + 1;
+    } else {
+        ChannelIndex = ChannelsPerThread * Index + ChannelsPerThreadExtra;
+        ChannelCount = ChannelsPerThread;
+    }
+
+    if (ChannelCount == 0) {
+        return;
+    }
+
+    const MLAS_WORK_BLOCK* WorkBlock = ThreadedWorkBlock->WorkBlock;
+
+    ThreadedWorkBlock->PoolKernelRoutine(WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + ChannelIndex * WorkBlock->InputSize,
+        ThreadedWorkBlock->Output + ChannelIndex * ThreadedWorkBlock->OutputSize);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1242,6 +1341,8 @@ Return Value:
     size_t InputSize = 1;
     size_t OutputSize = 1;
 
+    size_t KernelSize = 1;
+
     bool InputAndKernelShapeMatch = true;
     bool AllStridesAreOne = true;
     bool AllPaddingIsZero = true;
@@ -1274,6 +1375,7 @@ Return Value:
 
         InputSize *= WorkBlock.InputShape[dim];
         OutputSize *= WorkBlock.OutputShape[dim];
+        KernelSize *= size_t(WorkBlock.KernelShape[dim]);
 
         InputAndKernelShapeMatch &= (WorkBlock.KernelShape[dim] == int64_t(WorkBlock.InputShape[dim]));
         AllStridesAreOne &= (WorkBlock.StrideShape[dim] == 1);
@@ -1319,35 +1421,404 @@ Return Value:
         }
     }
 
-#ifdef MLAS_NO_ONNXRUNTIME_THREADPOOL
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-#else
     //
-    // Use an external thread pool if one is provided.
-    // TODO: change to use MlasExecuteThreaded
+    // Compute the number of target threads given the complexity of the pooling
+    // operation. Limit the number of threads to the number of channels and try
+    // to keep each thread reducing a minimum number of input elements before
+    // using another thread.
+    //
+
+    const double Complexity = double(TotalChannelCount) * double(OutputSize) * double(KernelSize);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_POOL_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_POOL_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
-    // TODO: revisit the strategy of multi-threading logic
-    if (0 && !(ThreadPool == nullptr)) {
-        std::function<void(int32_t)> WorkObject = [&](int64_t c) { PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize); };
-        ThreadPool->ParallelFor((int32_t)TotalChannelCount, WorkObject);
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= TotalChannelCount) {
+        TargetThreadCount = int32_t(TotalChannelCount);
+    }
+
+    if (TargetThreadCount <= 1) {
+        PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
         return;
     }
-#endif
+
+    MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
+
+    ThreadedWorkBlock.WorkBlock = &WorkBlock;
+    ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    ThreadedWorkBlock.Input = Input;
+    ThreadedWorkBlock.Output = Output;
+    ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+    ThreadedWorkBlock.OutputSize = OutputSize;
+    ThreadedWorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, TargetThreadCount, ThreadPool);
+}
+
+//
+// Define the parameters to execute segments of an NHWC pooling operation on
+// worker threads. The spatial dimensions are aligned to the innermost of three
+// dimensions, with the unused outer dimensions having a size of one.
+//
+
+struct MLAS_NHWC_POOL_WORK_BLOCK {
+    MLAS_POOLING_KIND PoolingKind;
+    size_t InputShape[3];
+    size_t InputSize;
+    size_t OutputShape[3];
+    size_t OutputSize;
+    int64_t KernelShape[3];
+    size_t KernelSize;
+    int64_t Padding[3];
+    int64_t StrideShape[3];
+    size_t Channels;
+    size_t ChannelBlockCount;
+    size_t TotalWork;
+    const float* Input;
+    float* Output;
+    int32_t ThreadCount;
+};
+
+//
+// Define the number of channels reduced together by a unit of work of the
+// NHWC pooling operation.
+//
+
+#define MLAS_NHWC_POOL_CHANNEL_BLOCK    size_t(64)
+
+template<typename PoolingType>
+void
+MlasNhwcPoolKernel(
+    const MLAS_NHWC_POOL_WORK_BLOCK* WorkBlock,
+    size_t WorkIndex,
+    size_t WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NHWC pooling operation for a range of work.
+    Each unit of work is a block of the channels of an output position, which
+    is computed by reducing the matching channels of each input position of
+    the kernel window. The channels are contiguous, so the reduction uses
+    vector operations across the channels.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the pooling parameters.
+
+    WorkIndex - Supplies the index of the first unit of work.
+
+    WorkRemaining - Supplies the number of units of work to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Channels = WorkBlock->Channels;
+    const size_t ChannelBlockCount = WorkBlock->ChannelBlockCount;
+    const bool IncludePad = (WorkBlock->PoolingKind == MlasAveragePoolingIncludePad);
+
+    while (WorkRemaining > 0) {
+
+        const size_t OutputIndex = WorkIndex / ChannelBlockCount;
+        const size_t ChannelStart = (WorkIndex % ChannelBlockCount) * MLAS_NHWC_POOL_CHANNEL_BLOCK;
+        const size_t ChannelCount = (std::min)(Channels - ChannelStart, MLAS_NHWC_POOL_CHANNEL_BLOCK);
+
+        //
+        // Compute the bounds of the input window for the output position.
+        //
+
+        size_t Position = OutputIndex % WorkBlock->OutputSize;
+        size_t WindowStart[3];
+        size_t WindowEnd[3];
+        size_t WindowSize = 1;
+
+        for (size_t dim = 3; dim-- > 0;) {
+
+            const int64_t OutputPosition = int64_t(Position % WorkBlock->OutputShape[dim]);
+            Position /= WorkBlock->OutputShape[dim];
+
+            int64_t InputStart = OutputPosition * WorkBlock->StrideShape[dim] - WorkBlock->Padding[dim];
+            int64_t InputEnd = (std::min)(InputStart + WorkBlock->KernelShape[dim], int64_t(WorkBlock->InputShape[dim]));
+            InputStart = (std::max)(InputStart, int64_t(0));
+            InputEnd = (std::max)(InputEnd, InputStart);
+
+            WindowStart[dim] = size_t(InputStart);
+            WindowEnd[dim] = size_t(InputEnd);
+            WindowSize *= WindowEnd[dim] - WindowStart[dim];
+        }
+
+        const size_t Batch = OutputIndex / WorkBlock->OutputSize;
+        const float* Input = WorkBlock->Input + Batch * WorkBlock->InputSize * Channels + ChannelStart;
+        float* Output = WorkBlock->Output + OutputIndex * Channels + ChannelStart;
+
+        //
+        // Reduce the channels of each input position of the window into the
+        // output.
+        //
+
+        std::fill_n(Output, ChannelCount, PoolingType::InitialValue());
+
+        for (size_t ih = WindowStart[0]; ih < WindowEnd[0]; ih++) {
+
+            for (size_t iw = WindowStart[1]; iw < WindowEnd[1]; iw++) {
+
+                for (size_t id = WindowStart[2]; id < WindowEnd[2]; id++) {
+
+                    const float* InputRow = Input +
+                        ((ih * WorkBlock->InputShape[1] + iw) * WorkBlock->InputShape[2] + id) * Channels;
+
+                    size_t c = 0;
+
+                    for (; c + 4 <= ChannelCount; c += 4) {
+                        MLAS_FLOAT32X4 Reduction = PoolingType::Reduce(MlasLoadFloat32x4(Output + c),
+                            MlasLoadFloat32x4(InputRow + c));
+                        MlasStoreFloat32x4(Output + c, Reduction);
+                    }
+
+                    for (; c < ChannelCount; c++) {
+                        Output[c] = PoolingType::Reduce(Output[c], InputRow[c]);
+                    }
+                }
+            }
+        }
+
+        //
+        // Apply average pooling if necessary.
+        //
+
+        const float Divisor = float(IncludePad ? WorkBlock->KernelSize : WindowSize);
+
+        for (size_t c = 0; c < ChannelCount; c++) {
+            Output[c] = PoolingType::AveragePool(Output[c], Divisor);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+typedef
+void
+(MLAS_NHWC_POOL_KERNEL_ROUTINE)(
+    const MLAS_NHWC_POOL_WORK_BLOCK* WorkBlock,
+    size_t WorkIndex,
+    size_t WorkRemaining
+    );
+
+static MLAS_NHWC_POOL_KERNEL_ROUTINE* const MlasNhwcPoolKernels[] =
+{
+    MlasNhwcPoolKernel<MLAS_MAXIMUM_POOLING>,
+    MlasNhwcPoolKernel<MLAS_AVERAGE_POOLING>,
+    MlasNhwcPoolKernel<MLAS_AVERAGE_POOLING>,
+};
+
+void
+MlasNhwcPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    NHWC pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NHWC_POOL_WORK_BLOCK*)Context;
 
     //
-    // Execute the pooling kernel routine.
+    // Partition the units of work evenly across the threads.
     //
 
-#if defined(_OPENMP)
+    const size_t WorkPerThread = WorkBlock->TotalWork / WorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = WorkBlock->TotalWork % WorkBlock->ThreadCount;
 
-#pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkRemaining = WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkRemaining = WorkPerThread;
     }
 
-#else
+    MlasNhwcPoolKernels[WorkBlock->PoolingKind](WorkBlock, WorkIndex, WorkRemaining);
+}
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+void
+MLASCALL
+MlasNhwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    size_t Dimensions,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
 
-#endif
+Routine Description:
+
+    This routine implements the pooling operation for tensors in the NHWC
+    layout, where the channels are the innermost dimension.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    Dimensions - Supplies the number of spatial dimensions.
+
+    InputShape - Supplies the shape of the input tensor: the batch count, the
+        spatial dimensions and the channel count.
+
+    KernelShape - Supplies the shape of the kernel transform, else nullptr for
+        a global pooling operation.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor, else nullptr for a global pooling operation.
+
+    StrideShape - Supplies the shape of the stride, else nullptr for a global
+        pooling operation.
+
+    OutputShape - Supplies the shape of the output tensor, in the same layout
+        as the input tensor.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NHWC_POOL_WORK_BLOCK WorkBlock;
+
+    WorkBlock.PoolingKind = PoolingKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    //
+    // Save the pooling parameters, aligning the spatial dimensions to the
+    // innermost of the three supported dimensions.
+    //
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t Channels = size_t(InputShape[Dimensions + 1]);
+
+    WorkBlock.InputSize = 1;
+    WorkBlock.OutputSize = 1;
+    WorkBlock.KernelSize = 1;
+
+    for (size_t dim = 0; dim < 3; dim++) {
+
+        WorkBlock.InputShape[dim] = 1;
+        WorkBlock.OutputShape[dim] = 1;
+        WorkBlock.KernelShape[dim] = 1;
+        WorkBlock.Padding[dim] = 0;
+        WorkBlock.StrideShape[dim] = 1;
+
+        if (dim + Dimensions >= 3) {
+
+            const size_t SpatialDim = dim + Dimensions - 3;
+
+            WorkBlock.InputShape[dim] = size_t(InputShape[SpatialDim + 1]);
+            WorkBlock.OutputShape[dim] = size_t(OutputShape[SpatialDim + 1]);
+
+            if (KernelShape != nullptr) {
+                WorkBlock.KernelShape[dim] = KernelShape[SpatialDim];
+            } else {
+                WorkBlock.KernelShape[dim] = InputShape[SpatialDim + 1];
+            }
+
+            if (Padding != nullptr) {
+                WorkBlock.Padding[dim] = Padding[SpatialDim];
+            }
+
+            if (StrideShape != nullptr) {
+                WorkBlock.StrideShape[dim] = StrideShape[SpatialDim];
+            }
+        }
+
+        WorkBlock.InputSize *= WorkBlock.InputShape[dim];
+        WorkBlock.OutputSize *= WorkBlock.OutputShape[dim];
+        WorkBlock.KernelSize *= size_t(WorkBlock.KernelShape[dim]);
+    }
+
+    WorkBlock.Channels = Channels;
+    WorkBlock.ChannelBlockCount = (Channels + MLAS_NHWC_POOL_CHANNEL_BLOCK - 1) / MLAS_NHWC_POOL_CHANNEL_BLOCK;
+    WorkBlock.TotalWork = BatchCount * WorkBlock.OutputSize * WorkBlock.ChannelBlockCount;
+
+    if (WorkBlock.TotalWork == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the pooling
+    // operation. Limit the number of threads to the units of work and try to
+    // keep each thread reducing a minimum number of input elements before
+    // using another thread.
+    //
+
+    const double Complexity = double(BatchCount) * double(WorkBlock.OutputSize) *
+        double(WorkBlock.KernelSize) * double(Channels);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_POOL_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_POOL_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= WorkBlock.TotalWork) {
+        TargetThreadCount = int32_t(WorkBlock.TotalWork);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasNhwcPoolThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
 }
@@ -25,6 +25,39 @@ Abstract:
 #define MLAS_GEMM_U8U8_STRIDEN              128
 #define MLAS_GEMM_U8U8_STRIDEK              128
 
+//
+// Define the alignment for segmenting a QGEMM operation across multiple
+// threads.
+//
+
+#define MLAS_QGEMM_STRIDEN_THREAD_ALIGN     16
+
+//
+// Define the parameters to execute a batch of QGEMM operations on worker
+// threads. Each thread either executes a range of whole operations from the
+// batch or a segment of a single operation.
+//
+
+struct MLAS_QGEMM_BATCH_WORK_BLOCK {
+    size_t M;
+    size_t N;
+    size_t K;
+    const uint8_t* A;
+    size_t lda;
+    size_t StrideA;
+    uint8_t offa;
+    const uint8_t* B;
+    size_t ldb;
+    size_t StrideB;
+    uint8_t offb;
+    int32_t* C;
+    size_t ldc;
+    size_t StrideC;
+    size_t BatchCount;
+    size_t BatchesPerThread;
+    size_t ThreadsPerBatch;
+};
+
 #ifdef MLAS_TARGET_AMD64_IX86
 
 void
@@ -509,6 +542,100 @@ Return Value:
     return 1;
 }
 
+void
+MlasQgemmPanelOperation(
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* PanelB,
+    uint8_t offb,
+    const int32_t* ColumnSumVector,
+    int32_t* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and accumulates the result to a slice of matrix C.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the panel and matrix C.
+
+    CountK - Supplies the number of columns of the slice of matrix A and the
+        number of rows of the panel.
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    ColumnSumVector - Supplies the sums of the columns of the panel multiplied
+        by the negated zero point offset of matrix A.
+
+    C - Supplies the address of the slice of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8U8_STRIDEM], 16);
+
+    size_t CountM;
+
+    for (size_t m = 0; m < M; m += CountM) {
+
+        CountM = MLAS_GEMM_U8U8_STRIDEM;
+
+        if (CountM > (M - m)) {
+            CountM = M - m;
+        }
+
+        MlasPlatform.GemmU8U8CopyPackARoutine(PanelA, A + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(offb));
+
+        int16_t* pa = PanelA;
+        int32_t* c = C + m * ldc;
+
+        int32_t* RowSums = RowSumVector;
+
+        size_t RowsRemaining = CountM;
+        size_t RowsHandled;
+
+        size_t PairedCountK = (CountK + 1) / 2;
+
+        while (RowsRemaining > 0) {
+
+            RowsHandled = MlasPlatform.GemmU8U8Kernel(pa, PanelB, c, PairedCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * offb, ZeroMode);
+
+            RowsRemaining -= RowsHandled;
+            c += ldc * RowsHandled;
+            pa += 2 * PairedCountK * RowsHandled;
+            RowSums += RowsHandled;
+        }
+    }
+}
+
 void
 MLASCALL
 MlasQgemm(
@@ -526,13 +653,10 @@ MlasQgemm(
     MLAS_THREADPOOL* ThreadPool
     )
 {
-    MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(uint8_t PanelB[MLAS_GEMM_U8U8_STRIDEN * MLAS_GEMM_U8U8_STRIDEK], 64);
 
-    MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8U8_STRIDEM], 16);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8U8_STRIDEN], 16);
 
-    size_t StrideM = MLAS_GEMM_U8U8_STRIDEM;
     size_t StrideN = MLAS_GEMM_U8U8_STRIDEN;
     size_t StrideK = MLAS_GEMM_U8U8_STRIDEK;
 
@@ -560,40 +684,495 @@ MlasQgemm(
 
             MlasPlatform.GemmU8U8CopyPackBRoutine(PanelB, B + n + k * ldb, ldb, CountN, CountK, ColumnSumVector, -int16_t(offa));
 
-            size_t CountM;
+            MlasQgemmPanelOperation(M, CountN, CountK, A + k, lda, offa, PanelB, offb, ColumnSumVector, C + n, ldc, k == 0);
+        }
+    }
+}
 
-            for (size_t m = 0; m < M; m += CountM) {
+inline
+size_t
+MlasQgemmPackedAlignedN(
+    size_t N
+    )
+/*++
 
-                CountM = StrideM;
+Routine Description:
 
-                if (CountM > (M - m)) {
-                    CountM = M - m;
-                }
+    This routine returns the number of columns of a packed matrix B, which is
+    padded to the widest column block written by the packing routines.
 
-                MlasPlatform.GemmU8U8CopyPackARoutine(PanelA, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(offb));
+Arguments:
 
-                int16_t* pa = PanelA;
-                int32_t* c = C + n + m * ldc;
+    N - Supplies the number of columns of matrix B.
 
-                int32_t* RowSums = RowSumVector;
+Return Value:
 
-                size_t RowsRemaining = CountM;
-                size_t RowsHandled;
+    Returns the number of columns of the packed matrix B.
 
-                size_t PairedCountK = (CountK + 1) / 2;
+--*/
+{
+    return (N + 15) & ~size_t(15);
+}
 
-                while (RowsRemaining > 0) {
+size_t
+MLASCALL
+MlasQgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
 
-                    RowsHandled = MlasPlatform.GemmU8U8Kernel(pa, PanelB, c, PairedCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * offb, k == 0);
+Routine Description:
 
-                    RowsRemaining -= RowsHandled;
-                    c += ldc * RowsHandled;
-                    pa += 2 * PairedCountK * RowsHandled;
-                    RowSums += RowsHandled;
-                }
+    This routine computes the number of bytes required to pack matrix B with
+    MlasQgemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    const size_t AlignedN = MlasQgemmPackedAlignedN(N);
+    const size_t SliceCount = (K + MLAS_GEMM_U8U8_STRIDEK - 1) / MLAS_GEMM_U8U8_STRIDEK;
+
+    //
+    // The packed rows of matrix B are followed by the column sums of each
+    // slice of MLAS_GEMM_U8U8_STRIDEK rows.
+    //
+
+    return AlignedN * ((K + 1) & ~size_t(1)) + AlignedN * SliceCount * sizeof(int32_t);
+}
+
+void
+MLASCALL
+MlasQgemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B once for use by the packed QGEMM routine.
+
+    Matrix B is stored as slices of MLAS_GEMM_U8U8_STRIDEK rows in the format
+    consumed by the QGEMM kernels, followed by the sums of the columns of each
+    slice. The sums don't depend on the zero point offset of matrix A, which
+    is applied when the packed matrix is used.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer, which must be at
+        least MlasQgemmPackBSize bytes long and aligned to
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = MlasQgemmPackedAlignedN(N);
+
+    //
+    // Zero the buffer so that the padding columns and their sums are zero.
+    //
+
+    memset(PackedB, 0, MlasQgemmPackBSize(N, K));
+
+    uint8_t* D = (uint8_t*)PackedB;
+    int32_t* ColumnSums = (int32_t*)(D + AlignedN * ((K + 1) & ~size_t(1)));
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_GEMM_U8U8_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        MlasPlatform.GemmU8U8CopyPackBRoutine(D, B + k * ldb, ldb, N, CountK, ColumnSums, 1);
+
+        D += AlignedN * ((CountK + 1) & ~size_t(1));
+        ColumnSums += AlignedN;
+    }
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const void* PackedB,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) using a matrix B packed by MlasQgemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8U8_STRIDEN], 16);
+
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+
+    const size_t AlignedN = MlasQgemmPackedAlignedN(N);
+
+    const uint8_t* PackedSlice = (const uint8_t*)PackedB;
+    const int32_t* PackedColumnSums = (const int32_t*)(PackedSlice + AlignedN * ((K + 1) & ~size_t(1)));
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_GEMM_U8U8_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        const size_t PackedCountK = (CountK + 1) & ~size_t(1);
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = MLAS_GEMM_U8U8_STRIDEN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            //
+            // Apply the zero point offset of matrix A to the column sums,
+            // including the zero padded columns read by the kernels.
+            //
+
+            const size_t AlignedCountN = MlasQgemmPackedAlignedN(CountN);
+
+            for (size_t i = 0; i < AlignedCountN; i++) {
+                ColumnSumVector[i] = PackedColumnSums[n + i] * -int32_t(offa);
             }
+
+            MlasQgemmPanelOperation(M, CountN, CountK, A + k, lda, offa, PackedSlice + n * PackedCountK, offb, ColumnSumVector, C + n, ldc, k == 0);
+        }
+
+        PackedSlice += AlignedN * PackedCountK;
+        PackedColumnSums += AlignedN;
+    }
+}
+
+void
+MlasQgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of a batch
+    of QGEMM operations or a segment of one of its operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_QGEMM_BATCH_WORK_BLOCK* WorkBlock = (const MLAS_QGEMM_BATCH_WORK_BLOCK*)Context;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    if (WorkBlock->ThreadsPerBatch == 1) {
+
+        size_t Batch = size_t(Index) * WorkBlock->BatchesPerThread;
+        size_t BatchEnd = Batch + WorkBlock->BatchesPerThread;
+
+        if (BatchEnd > WorkBlock->BatchCount) {
+            BatchEnd = WorkBlock->BatchCount;
         }
+
+        for (; Batch < BatchEnd; Batch++) {
+            MlasQgemm(M, N, WorkBlock->K, WorkBlock->A + Batch * WorkBlock->StrideA,
+                WorkBlock->lda, WorkBlock->offa, WorkBlock->B + Batch * WorkBlock->StrideB,
+                WorkBlock->ldb, WorkBlock->offb, WorkBlock->C + Batch * WorkBlock->StrideC,
+                WorkBlock->ldc, nullptr);
+        }
+
+        return;
     }
+
+    //
+    // Segment the operation along the larger of the M and N dimensions.
+    //
+
+    const size_t Batch = size_t(Index) / WorkBlock->ThreadsPerBatch;
+    const size_t ThreadIndex = size_t(Index) % WorkBlock->ThreadsPerBatch;
+
+    const uint8_t* A = WorkBlock->A + Batch * WorkBlock->StrideA;
+    const uint8_t* B = WorkBlock->B + Batch * WorkBlock->StrideB;
+    int32_t* C = WorkBlock->C + Batch * WorkBlock->StrideC;
+
+    if (N > M) {
+
+        size_t StrideN = (N + WorkBlock->ThreadsPerBatch - 1) / WorkBlock->ThreadsPerBatch;
+
+        StrideN =
+            (StrideN + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        size_t n = ThreadIndex * StrideN;
+
+        if (n >= N) {
+            return;
+        }
+
+        size_t CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        MlasQgemm(M, CountN, WorkBlock->K, A, WorkBlock->lda, WorkBlock->offa,
+            B + n, WorkBlock->ldb, WorkBlock->offb, C + n, WorkBlock->ldc, nullptr);
+
+    } else {
+
+        size_t StrideM = (M + WorkBlock->ThreadsPerBatch - 1) / WorkBlock->ThreadsPerBatch;
+
+        size_t m = ThreadIndex * StrideM;
+
+        if (m >= M) {
+            return;
+        }
+
+        size_t CountM = StrideM;
+
+        if (CountM > (M - m)) {
+            CountM = M - m;
+        }
+
+        MlasQgemm(CountM, N, WorkBlock->K, A + m * WorkBlock->lda, WorkBlock->lda,
+            WorkBlock->offa, B, WorkBlock->ldb, WorkBlock->offb,
+            C + m * WorkBlock->ldc, WorkBlock->ldc, nullptr);
+    }
+}
+
+void
+MLASCALL
+MlasQgemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    size_t StrideA,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    size_t StrideB,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of quantized integer matrix/matrix
+    multiply operations (QGEMM) with matrices separated by constant strides.
+    The work of the whole batch is partitioned across threads in a single
+    dispatch.
+
+Arguments:
+
+    M - Supplies the number of rows of each matrix A and matrix C.
+
+    N - Supplies the number of columns of each matrix B and matrix C.
+
+    K - Supplies the number of columns of each matrix A and the number of rows
+        of each matrix B.
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of each matrix A.
+
+    StrideA - Supplies the number of elements between each matrix A, or zero
+        if every operation uses the same matrix A.
+
+    offa - Supplies the zero point offset of each matrix A.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of each matrix B.
+
+    StrideB - Supplies the number of elements between each matrix B, or zero
+        if every operation uses the same matrix B.
+
+    offb - Supplies the zero point offset of each matrix B.
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of each matrix C.
+
+    StrideC - Supplies the number of elements between each matrix C.
+
+    BatchCount - Supplies the number of operations in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_QGEMM_BATCH_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    if (BatchCount == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch, using the same per-thread target as SGEMM.
+    //
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t Batch = 0; Batch < BatchCount; Batch++) {
+            MlasQgemm(M, N, K, A + Batch * StrideA, lda, offa, B + Batch * StrideB,
+                ldb, offb, C + Batch * StrideC, ldc, nullptr);
+        }
+
+        return;
+    }
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.offa = offa;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.StrideB = StrideB;
+    WorkBlock.offb = offb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.BatchCount = BatchCount;
+
+    //
+    // Give each thread a range of whole operations if the batch has enough of
+    // them, else split each operation across several threads.
+    //
+
+    size_t Iterations;
+
+    if (BatchCount >= size_t(TargetThreadCount)) {
+
+        WorkBlock.BatchesPerThread = (BatchCount + TargetThreadCount - 1) / TargetThreadCount;
+        WorkBlock.ThreadsPerBatch = 1;
+
+        Iterations = (BatchCount + WorkBlock.BatchesPerThread - 1) / WorkBlock.BatchesPerThread;
+
+    } else {
+
+        WorkBlock.BatchesPerThread = 1;
+        WorkBlock.ThreadsPerBatch = size_t(TargetThreadCount) / BatchCount;
+
+        Iterations = BatchCount * WorkBlock.ThreadsPerBatch;
+    }
+
+    MlasExecuteThreaded(MlasQgemmBatchOperationThreaded, &WorkBlock, int32_t(Iterations), ThreadPool);
 }
 
 #endif
@@ -649,3 +649,86 @@ Return Value:
         S += BlockSize * InputStride;
     }
 }
+
+void
+MLASCALL
+MlasTranspose(
+    size_t M,
+    size_t N,
+    const float* A,
+    size_t lda,
+    float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix: B[n][m] = A[m][n].
+
+    The matrix is processed in strips of 16 rows of A. Each group of four
+    columns of a strip is transposed as 4x4 tiles, so that every row of B
+    receives a cache line of 16 elements from the strip while the rows of A
+    that are being read stay in the cache.
+
+Arguments:
+
+    M - Supplies the number of rows of A and columns of B.
+
+    N - Supplies the number of columns of A and rows of B.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of the destination matrix.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t StripRows = 16;
+
+    for (size_t m = 0; m < M; m += StripRows) {
+
+        const size_t RowsThisIteration = (std::min)(M - m, StripRows);
+        const size_t AlignedRowsThisIteration = RowsThisIteration & (~3);
+
+        const float* a = A + m * lda;
+        float* b = B + m;
+        size_t n = 0;
+
+        for (; n + 4 <= N; n += 4) {
+
+            const float* aa = a + n;
+            float* bb = b + n * ldb;
+            size_t r = 0;
+
+            for (; r < AlignedRowsThisIteration; r += 4) {
+                MlasReorderTransposeFloat32x4x4(aa, bb, lda, ldb);
+                aa += 4 * lda;
+                bb += 4;
+            }
+
+            for (; r < RowsThisIteration; r += 1) {
+                MlasReorderScatterFloat32x4(aa, bb, ldb);
+                aa += lda;
+                bb += 1;
+            }
+        }
+
+        for (; n < N; n += 1) {
+
+            const float* aa = a + n;
+            float* bb = b + n * ldb;
+
+            for (size_t r = 0; r < RowsThisIteration; r += 1) {
+                bb[r] = aa[r * lda];
+            }
+        }
+    }
+}
@@ -0,0 +1,867 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sconv_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the single precision convolution kernels for ARM
+    NEON used by the NCHWc convolution operations.
+
+    Each NCHWc block of eight channels is held in a pair of 128-bit vectors.
+    The kernels compute up to four filter blocks at once and produce two output
+    blocks per iteration for the output elements that do not touch any padding.
+
+--*/
+
+#include "mlasi.h"
+
+constexpr size_t BlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+
+//
+// Define the maximum number of output blocks computed per iteration for the
+// output elements that do not include any padding.
+//
+
+constexpr size_t MaximumOutputCount = 2;
+
+//
+// Define the formats of the input and filter buffers.
+//
+// MlasConvKernelNchw: The input buffer is a single NCHW plane and the filter
+// buffer is in OIhw8o format, so each input element is broadcast across the
+// output block.
+//
+// MlasConvKernelNchwc: The input buffer is in NCHW8c format and the filter
+// buffer is in OIhw8i8o format.
+//
+// MlasConvKernelDepthwise: The input buffer is in NCHW8c format and the filter
+// buffer is in Ohw8o format, so each channel of the input block only
+// contributes to the same channel of the output block.
+//
+
+enum MLAS_CONV_KERNEL_FORMAT {
+    MlasConvKernelNchw,
+    MlasConvKernelNchwc,
+    MlasConvKernelDepthwise,
+};
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvClearBlockNeon(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][OutputCount][2]
+    )
+/*++
+
+Routine Description:
+
+    This routine clears the accumulators for a matrix of output blocks.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for the output blocks.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t o = 0; o < OutputCount; o++) {
+            Accumulators[f][o][0] = MlasZeroFloat32x4();
+            Accumulators[f][o][1] = MlasZeroFloat32x4();
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvComputeBlockNeon(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][OutputCount][2],
+    const float* Input,
+    size_t StrideWidth,
+    const float* Filter,
+    size_t FilterStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a vector of input blocks by a vector of OIhw8i8o
+    filter blocks and accumulates the products into the output blocks.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for the output blocks.
+
+    Input - Supplies the address of the first input block.
+
+    StrideWidth - Supplies the number of elements between input blocks.
+
+    Filter - Supplies the address of the first filter block.
+
+    FilterStride - Supplies the number of elements between filter blocks.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t i = 0; i < BlockSize; i++) {
+
+        MLAS_FLOAT32X4 InputVector[OutputCount];
+
+        for (size_t o = 0; o < OutputCount; o++) {
+            InputVector[o] = MlasBroadcastFloat32x4(&Input[o * StrideWidth + i]);
+        }
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* filter = Filter + f * FilterStride + i * BlockSize;
+
+            MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(&filter[0]);
+            MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(&filter[4]);
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                Accumulators[f][o][0] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector0, Accumulators[f][o][0]);
+                Accumulators[f][o][1] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector1, Accumulators[f][o][1]);
+            }
+        }
+    }
+}
+
+template<MLAS_CONV_KERNEL_FORMAT KernelFormat, size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvComputeKernelPositionNeon(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][OutputCount][2],
+    const float* Input,
+    size_t StrideWidth,
+    const float* Filter,
+    size_t FilterStride
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the products for a single kernel position into a
+    matrix of output blocks.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for the output blocks.
+
+    Input - Supplies the address of the input element or block.
+
+    StrideWidth - Supplies the number of elements between the inputs of
+        adjacent output blocks.
+
+    Filter - Supplies the address of the filter for the kernel position.
+
+    FilterStride - Supplies the number of elements between filter blocks.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (KernelFormat == MlasConvKernelNchwc) {
+
+        MlasConvComputeBlockNeon<FilterCount, OutputCount>(Accumulators,
+            Input, StrideWidth, Filter, FilterStride);
+
+    } else if (KernelFormat == MlasConvKernelNchw) {
+
+        MLAS_FLOAT32X4 InputVector[OutputCount];
+
+        for (size_t o = 0; o < OutputCount; o++) {
+            InputVector[o] = MlasBroadcastFloat32x4(&Input[o * StrideWidth]);
+        }
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* filter = Filter + f * FilterStride;
+
+            MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(&filter[0]);
+            MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(&filter[4]);
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                Accumulators[f][o][0] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector0, Accumulators[f][o][0]);
+                Accumulators[f][o][1] = MlasMultiplyAddFloat32x4(InputVector[o], FilterVector1, Accumulators[f][o][1]);
+            }
+        }
+
+    } else {
+
+        MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(&Filter[0]);
+        MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(&Filter[4]);
+
+        for (size_t o = 0; o < OutputCount; o++) {
+
+            const float* input = Input + o * StrideWidth;
+
+            Accumulators[0][o][0] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[0]), FilterVector0, Accumulators[0][o][0]);
+            Accumulators[0][o][1] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[4]), FilterVector1, Accumulators[0][o][1]);
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvPostProcessBlockNeon(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][OutputCount][2],
+    float* Output,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the post processing options to a matrix of output
+    blocks and stores the output blocks to the output buffer.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for the output blocks.
+
+    Output - Supplies the address of the first output block.
+
+    OutputStride - Supplies the number of elements between the output blocks
+        of adjacent filter blocks.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ZeroVector = MlasZeroFloat32x4();
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        MLAS_FLOAT32X4 BiasVector0 = ZeroVector;
+        MLAS_FLOAT32X4 BiasVector1 = ZeroVector;
+
+        if ((Flags & MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION) != 0) {
+            BiasVector0 = MlasLoadFloat32x4(&Bias[f * BlockSize]);
+            BiasVector1 = MlasLoadFloat32x4(&Bias[f * BlockSize + 4]);
+        }
+
+        for (size_t o = 0; o < OutputCount; o++) {
+
+            float* output = Output + f * OutputStride + o * BlockSize;
+
+            MLAS_FLOAT32X4 Vector0 = Accumulators[f][o][0];
+            MLAS_FLOAT32X4 Vector1 = Accumulators[f][o][1];
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT) != 0) {
+                Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(&output[0]));
+                Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(&output[4]));
+            }
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION) != 0) {
+                Vector0 = MlasAddFloat32x4(Vector0, BiasVector0);
+                Vector1 = MlasAddFloat32x4(Vector1, BiasVector1);
+            }
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION) != 0) {
+                Vector0 = MlasMaximumFloat32x4(Vector0, ZeroVector);
+                Vector1 = MlasMaximumFloat32x4(Vector1, ZeroVector);
+            }
+
+            MlasStoreFloat32x4(&output[0], Vector0);
+            MlasStoreFloat32x4(&output[4], Vector1);
+        }
+    }
+}
+
+template<MLAS_CONV_KERNEL_FORMAT KernelFormat, size_t FilterCount>
+void
+MlasConvFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter blocks.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel. All strides and widths have been converted
+    from bytes to elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the filter increment for each kernel position.
+    //
+
+    const size_t FilterIncrement =
+        (KernelFormat == MlasConvKernelNchwc) ? BlockSize * BlockSize : BlockSize;
+
+    const size_t TotalOutputCount = OutputCountLeftPad + OutputCount + OutputCountRightPad;
+
+    size_t OutputIndex = 0;
+
+    while (OutputIndex < TotalOutputCount) {
+
+        const float* input = Input + OutputIndex * StrideWidth;
+        float* output = Output + OutputIndex * BlockSize;
+
+        //
+        // Output elements that do not include any padding are processed
+        // several at a time without validating the input addresses.
+        //
+
+        if (OutputIndex >= OutputCountLeftPad &&
+            OutputIndex + MaximumOutputCount <= OutputCountLeftPad + OutputCount) {
+
+            MLAS_FLOAT32X4 Accumulators[FilterCount][MaximumOutputCount][2];
+
+            MlasConvClearBlockNeon<FilterCount, MaximumOutputCount>(Accumulators);
+
+            const float* filter = Filter;
+
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                    MlasConvComputeKernelPositionNeon<KernelFormat, FilterCount, MaximumOutputCount>(
+                        Accumulators, input, StrideWidth, filter, FilterStride);
+
+                    input += DilationWidth;
+                    filter += FilterIncrement;
+                }
+
+                input += InputStride;
+            }
+
+            MlasConvPostProcessBlockNeon<FilterCount, MaximumOutputCount>(Accumulators,
+                output, OutputStride, Bias, Flags);
+
+            OutputIndex += MaximumOutputCount;
+            continue;
+        }
+
+        //
+        // Output elements that include padding are processed one at a time
+        // and skip the input addresses that fall outside of the input row.
+        //
+
+        MLAS_FLOAT32X4 Accumulators[FilterCount][1][2];
+
+        MlasConvClearBlockNeon<FilterCount, 1>(Accumulators);
+
+        const float* filter = Filter;
+        const float* input_base = InputBase;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (size_t(input - input_base) < InputWidth) {
+                    MlasConvComputeKernelPositionNeon<KernelFormat, FilterCount, 1>(
+                        Accumulators, input, StrideWidth, filter, FilterStride);
+                }
+
+                input += DilationWidth;
+                filter += FilterIncrement;
+            }
+
+            input += InputStride;
+            input_base += DilatedInputWidth;
+        }
+
+        MlasConvPostProcessBlockNeon<FilterCount, 1>(Accumulators, output,
+            OutputStride, Bias, Flags);
+
+        OutputIndex += 1;
+    }
+}
+
+template<MLAS_CONV_KERNEL_FORMAT KernelFormat>
+void
+MlasConvFloatKernelNeonDispatch(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the byte strides supplied by the NCHWc convolution
+    algorithms to element strides and dispatches to the convolution kernel
+    specialized for the number of filter blocks.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    StrideWidth /= sizeof(float);
+    DilationWidth /= sizeof(float);
+    InputStride /= sizeof(float);
+    FilterStride /= sizeof(float);
+    OutputStride /= sizeof(float);
+    InputWidth /= sizeof(float);
+    DilatedInputWidth /= sizeof(float);
+
+    decltype(&MlasConvFloatKernelNeon<KernelFormat, 1>) Kernel;
+
+    switch (FilterCount) {
+
+        case 1:
+            Kernel = MlasConvFloatKernelNeon<KernelFormat, 1>;
+            break;
+
+        case 2:
+            Kernel = MlasConvFloatKernelNeon<KernelFormat, 2>;
+            break;
+
+        case 3:
+            Kernel = MlasConvFloatKernelNeon<KernelFormat, 3>;
+            break;
+
+        default:
+            Kernel = MlasConvFloatKernelNeon<KernelFormat, 4>;
+            break;
+    }
+
+    Kernel(Input, Filter, Output, StrideWidth, DilationWidth, InputStride,
+        FilterStride, OutputStride, KernelHeight, KernelWidth, InputBase,
+        InputWidth, DilatedInputWidth, OutputCountLeftPad, OutputCount,
+        OutputCountRightPad, Bias, Flags);
+}
+
+void
+MLASCALL
+MlasConvNchwFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the input buffer is in
+    NCHW format.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvFloatKernelNeonDispatch<MlasConvKernelNchw>(Input, Filter, Output,
+        StrideWidth, DilationWidth, FilterCount, InputStride, FilterStride,
+        OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth,
+        DilatedInputWidth, OutputCountLeftPad, OutputCount, OutputCountRightPad,
+        Bias, Flags);
+}
+
+void
+MLASCALL
+MlasConvNchwcFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+        The address is biased to include padding blocks for the left width
+        dimension. The address is not biased to include padding rows for the
+        left height dimension; these are accounted for in the outer kernel.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation width.
+
+    FilterCount - Supplies the number of filters to process in this iteration.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row.
+
+    FilterStride - Supplies the length in bytes to advance the filter buffer
+        to the next set of filters.
+
+    OutputStride - Supplies the length in bytes to advance the output buffer
+        to the next output address associated with the next set of filters.
+
+    KernelHeight - Supplies the height of the kernel to apply. This height may
+        be less than the original kernel height after removing any padding
+        rows.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+        This parameter is similar to the Input parameter, but does not include
+        the padding blocks for the left width dimension. This parameter is used
+        with the following InputWidth parameter in order to validate that the
+        current input buffer address in bounds and not in the left or right
+        width padding region.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvFloatKernelNeonDispatch<MlasConvKernelNchwc>(Input, Filter, Output,
+        StrideWidth, DilationWidth, FilterCount, InputStride, FilterStride,
+        OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth,
+        DilatedInputWidth, OutputCountLeftPad, OutputCount, OutputCountRightPad,
+        Bias, Flags);
+}
+
+void
+MLASCALL
+MlasConvDepthwiseFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows.
+
+    Depthwise separable convolutions are a form of grouped convolution where
+    the number of input and output channels per group are one.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel. The filter count is implicitly one.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvFloatKernelNeonDispatch<MlasConvKernelDepthwise>(Input, Filter,
+        Output, StrideWidth, DilationWidth, 1, InputStride, 0, 0, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
+}
+
+template<size_t FilterCount>
+void
+MlasConvPointwiseFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a pointwise convolution for the
+    elements of an output row for a set of filter blocks.
+
+Arguments:
+
+    See MlasConvPointwiseFloatKernel. All strides have been converted from
+    bytes to elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t OutputIndex = 0;
+
+    for (; OutputIndex + MaximumOutputCount <= OutputCount; OutputIndex += MaximumOutputCount) {
+
+        MLAS_FLOAT32X4 Accumulators[FilterCount][MaximumOutputCount][2];
+
+        MlasConvClearBlockNeon<FilterCount, MaximumOutputCount>(Accumulators);
+
+        const float* input = Input + OutputIndex * StrideWidth;
+        const float* filter = Filter;
+
+        for (size_t ic = 0; ic < InputChannels; ic++) {
+
+            MlasConvComputeBlockNeon<FilterCount, MaximumOutputCount>(Accumulators,
+                input, StrideWidth, filter, FilterStride);
+
+            input += InputStride;
+            filter += BlockSize * BlockSize;
+        }
+
+        MlasConvPostProcessBlockNeon<FilterCount, MaximumOutputCount>(Accumulators,
+            Output + OutputIndex * BlockSize, OutputStride, Bias, Flags);
+    }
+
+    for (; OutputIndex < OutputCount; OutputIndex++) {
+
+        MLAS_FLOAT32X4 Accumulators[FilterCount][1][2];
+
+        MlasConvClearBlockNeon<FilterCount, 1>(Accumulators);
+
+        const float* input = Input + OutputIndex * StrideWidth;
+        const float* filter = Filter;
+
+        for (size_t ic = 0; ic < InputChannels; ic++) {
+
+            MlasConvComputeBlockNeon<FilterCount, 1>(Accumulators, input,
+                StrideWidth, filter, FilterStride);
+
+            input += InputStride;
+            filter += BlockSize * BlockSize;
+        }
+
+        MlasConvPostProcessBlockNeon<FilterCount, 1>(Accumulators,
+            Output + OutputIndex * BlockSize, OutputStride, Bias, Flags);
+    }
+}
+
+void
+MLASCALL
+MlasConvPointwiseFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows.
+
+    Pointwise convolutions have a kernel size of one. To simplify this
+    implementation, no input padding is allowed, which matches typical usage in
+    models.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    InputChannels - Supplies the number of input channel blocks to process.
+
+    FilterCount - Supplies the number of rows from the filter to process.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input channel of the same input row.
+
+    FilterStride - Supplies the length in bytes to advance the filter buffer
+        to the next set of filters.
+
+    OutputStride - Supplies the length in bytes to advance the output buffer
+        to the next output address associated with the next set of filters.
+
+    OutputCount - Supplies the number of output elements.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    StrideWidth /= sizeof(float);
+    InputStride /= sizeof(float);
+    FilterStride /= sizeof(float);
+    OutputStride /= sizeof(float);
+
+    decltype(&MlasConvPointwiseFloatKernelNeon<1>) Kernel;
+
+    switch (FilterCount) {
+
+        case 1:
+            Kernel = MlasConvPointwiseFloatKernelNeon<1>;
+            break;
+
+        case 2:
+            Kernel = MlasConvPointwiseFloatKernelNeon<2>;
+            break;
+
+        case 3:
+            Kernel = MlasConvPointwiseFloatKernelNeon<3>;
+            break;
+
+        default:
+            Kernel = MlasConvPointwiseFloatKernelNeon<4>;
+            break;
+    }
+
+    Kernel(Input, Filter, Output, StrideWidth, InputChannels, InputStride,
+        FilterStride, OutputStride, OutputCount, Bias, Flags);
+}
@@ -40,15 +40,69 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
+    size_t AlignedN;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartN;
         const float* A;
         const float* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute segments of a SGEMM operation with a block
+// sparse packed matrix B on worker threads.
+//
+
+struct MLAS_SGEMM_SPARSE_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    size_t K;
+    size_t lda;
+    size_t ldc;
+    float alpha;
+    float beta;
+    const void* PackedB;
+    size_t N;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        size_t StartN;
+        const float* A;
+        float* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads. Each thread either executes a range of whole operations from the
+// batch or a segment of a single operation.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    size_t StrideA;
+    const float* B;
+    size_t ldb;
+    size_t StrideB;
+    float beta;
+    float* C;
+    size_t ldc;
+    size_t StrideC;
+    size_t BatchCount;
+    size_t BatchesPerThread;
+    size_t ThreadsPerBatch;
+};
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 //
@@ -772,6 +826,169 @@ Return Value:
     }
 }
 
+inline
+size_t
+MlasSgemmPackedAlignedN(
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of columns of a packed matrix B, which is
+    padded to the 16 column width of the packed panels.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+Return Value:
+
+    Returns the number of columns of the packed matrix B.
+
+--*/
+{
+    return (N + 15) & ~size_t(15);
+}
+
+void
+MlasSgemmPanelOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and accumulates the result to a slice of matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the panel and matrix C.
+
+    CountK - Supplies the number of columns of the slice of matrix A and the
+        number of rows of the panel.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the slice of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -830,7 +1047,6 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -937,87 +1153,117 @@ Return Value:
             // Step through each slice of matrix A along the M dimension.
             //
 
-            float* c = C + n;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+            MlasSgemmPanelOperation(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode);
+        }
+    }
+}
 
-            if (TransA == CblasNoTrans) {
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
 
-                const float* a = A + k;
+Routine Description:
 
-                //
-                // Step through the rows of matrix A.
-                //
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B packed by MlasSgemmPackB.
 
-                do {
+Arguments:
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    TransA - Supplies the transpose operation for matrix A.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    M - Supplies the number of rows of matrix A and matrix C.
 
-                    RowsRemaining -= RowsHandled;
+    RangeStartN - Supplies the starting column from the packed matrix B. The
+        starting column must be a multiple of 16.
 
-                } while (RowsRemaining > 0);
+    RangeCountN - Supplies the number of columns from the packed matrix B and
+        the number of columns of matrix C.
 
-            } else {
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
 
-                const float* a = A + k * lda;
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    AlignedN - Supplies the number of columns of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-                do {
+    C - Supplies the address of matrix C.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    ldc - Supplies the first dimension of matrix C.
 
-                    size_t RowsTransposed = RowsRemaining;
+Return Value:
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    None.
 
-                    RowsRemaining -= RowsTransposed;
+--*/
+{
+    //
+    // Step through each slice of matrix B along the N dimension. The packed
+    // buffer stores slices of MLAS_SGEMM_STRIDEK rows, so the K stride is
+    // fixed.
+    //
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    size_t CountN;
+    size_t CountK;
 
-                    a += RowsTransposed;
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+        CountN = MLAS_SGEMM_STRIDEN;
 
-                    const float* pa = PanelA;
+        if (CountN > (RangeCountN - n)) {
+            CountN = RangeCountN - n;
+        }
 
-                    do {
+        //
+        // Multiply the output matrix by beta as needed.
+        //
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
-#else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+        for (size_t k = 0; k < K; k += CountK) {
 
-                        RowsTransposed -= RowsHandled;
+            bool ZeroMode = (k == 0 && beta == 0.0f);
 
-                    } while (RowsTransposed > 0);
+            CountK = MLAS_SGEMM_STRIDEK;
 
-                } while (RowsRemaining > 0);
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + AlignedN * k + (RangeStartN + n) * CountK;
+
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmPanelOperation(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode);
         }
     }
 }
@@ -1050,10 +1296,17 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    if (WorkBlock->PackedB != nullptr) {
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->AlignedN, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc);
+    } else {
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc);
+    }
 }
 
 inline
@@ -1069,6 +1322,7 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    const float* PackedB,
     float beta,
     float* C,
     size_t ldc,
@@ -1104,6 +1358,9 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    PackedB - Supplies the address of matrix B packed by MlasSgemmPackB, else
+        nullptr if matrix B is supplied through B and ldb.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
@@ -1158,6 +1415,8 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.AlignedN = MlasSgemmPackedAlignedN(N);
 
     //
     // Segment the operation across multiple threads.
@@ -1188,8 +1447,9 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartN = n;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (B != nullptr) ? B + n * pldb : nullptr;
             WorkBlock.Segments[Index].C = C + n;
 
             Index++;
@@ -1215,6 +1475,7 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1296,7 +1557,1034 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr, beta, C, ldc, ThreadPool)) {
         MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
     }
 }
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasSgemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    return MlasSgemmPackedAlignedN(N) * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B once for use by the packed SGEMM routine.
+
+    Matrix B is stored as slices of MLAS_SGEMM_STRIDEK rows. Each slice holds
+    the panels of 16 columns that the SGEMM kernels consume, so a multiply
+    can point its kernels directly into the packed buffer.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer, which must be at
+        least MlasSgemmPackBSize bytes long and aligned to
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = MlasSgemmPackedAlignedN(N);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B packed by MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, nullptr, 0, (const float*)PackedB, beta, C, ldc, ThreadPool)) {
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda, (const float*)PackedB, MlasSgemmPackedAlignedN(N), beta, C, ldc);
+    }
+}
+
+inline
+size_t
+MlasSgemmSparseHeaderSize(
+    size_t PanelCount,
+    size_t BlockCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of bytes before the blocks of a block
+    sparse packed matrix B.
+
+    The header holds the offsets of the first block of each panel of 16
+    columns, followed by one more offset for the end of the last panel, and
+    then the first row of each block. The blocks follow at an alignment of 16
+    floats.
+
+Arguments:
+
+    PanelCount - Supplies the number of panels of 16 columns of matrix B.
+
+    BlockCount - Supplies the number of blocks stored in the packed buffer.
+
+Return Value:
+
+    Returns the size in bytes of the header.
+
+--*/
+{
+    const size_t HeaderSize = (PanelCount + 1 + BlockCount) * sizeof(size_t);
+
+    return (HeaderSize + 16 * sizeof(float) - 1) & ~(16 * sizeof(float) - 1);
+}
+
+bool
+MlasSgemmIsZeroBlock(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether a block of matrix B only holds zeros.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    B - Supplies the address of the first element of the block.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    CountN - Supplies the number of columns of the block.
+
+    CountK - Supplies the number of rows of the block.
+
+Return Value:
+
+    Returns true if all elements of the block are zero.
+
+--*/
+{
+    for (size_t k = 0; k < CountK; k++) {
+
+        for (size_t n = 0; n < CountN; n++) {
+
+            float Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+
+            if (Value != 0.0f) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+size_t
+MlasSgemmCountNonzeroBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t* BlockOffsets
+    )
+/*++
+
+Routine Description:
+
+    This routine counts the blocks of matrix B that hold a nonzero element.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BlockOffsets - Optionally supplies the address of the offsets of the first
+        block of each panel to fill in, else nullptr.
+
+Return Value:
+
+    Returns the number of nonzero blocks.
+
+--*/
+{
+    size_t BlockCount = 0;
+    size_t Panel = 0;
+
+    for (size_t n = 0; n < N; n += 16, Panel++) {
+
+        size_t CountN = (N - n) < 16 ? (N - n) : 16;
+
+        if (BlockOffsets != nullptr) {
+            BlockOffsets[Panel] = BlockCount;
+        }
+
+        for (size_t k = 0; k < K; k += MLAS_SGEMM_SPARSE_BLOCK_K) {
+
+            size_t CountK = (K - k) < MLAS_SGEMM_SPARSE_BLOCK_K ? (K - k) : MLAS_SGEMM_SPARSE_BLOCK_K;
+
+            const float* b = (TransB == CblasNoTrans) ? B + k * ldb + n : B + n * ldb + k;
+
+            if (!MlasSgemmIsZeroBlock(TransB, b, ldb, CountN, CountK)) {
+                BlockCount++;
+            }
+        }
+    }
+
+    if (BlockOffsets != nullptr) {
+        BlockOffsets[Panel] = BlockCount;
+    }
+
+    return BlockCount;
+}
+
+size_t
+MLASCALL
+MlasSgemmPackBSparseSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasSgemmPackBSparse.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer, else zero if too few blocks
+    of matrix B are zero to pack it as block sparse.
+
+--*/
+{
+    if (N == 0 || K == 0) {
+        return 0;
+    }
+
+    const size_t PanelCount = (N + 15) / 16;
+    const size_t TotalBlockCount = PanelCount * ((K + MLAS_SGEMM_SPARSE_BLOCK_K - 1) / MLAS_SGEMM_SPARSE_BLOCK_K);
+    const size_t BlockCount = MlasSgemmCountNonzeroBlocks(TransB, N, K, B, ldb, nullptr);
+
+    if (BlockCount * MLAS_SGEMM_SPARSE_MINIMUM_RATIO > TotalBlockCount) {
+        return 0;
+    }
+
+    return MlasSgemmSparseHeaderSize(PanelCount, BlockCount) +
+        BlockCount * MLAS_SGEMM_SPARSE_BLOCK_K * 16 * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSgemmPackBSparse(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the nonzero blocks of matrix B once for use by the
+    block sparse SGEMM routine.
+
+    Each block is stored as the rows of a panel of 16 columns that the SGEMM
+    kernels consume, so a multiply can point its kernels directly into the
+    packed buffer. The blocks of a panel are stored in increasing row order.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer, which must be at
+        least MlasSgemmPackBSparseSize bytes long and aligned to
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PanelCount = (N + 15) / 16;
+
+    size_t* BlockOffsets = (size_t*)PackedB;
+    const size_t BlockCount = MlasSgemmCountNonzeroBlocks(TransB, N, K, B, ldb, BlockOffsets);
+
+    size_t* BlockStartK = BlockOffsets + PanelCount + 1;
+    float* D = (float*)((uint8_t*)PackedB + MlasSgemmSparseHeaderSize(PanelCount, BlockCount));
+
+    size_t Block = 0;
+
+    for (size_t n = 0; n < N; n += 16) {
+
+        size_t CountN = (N - n) < 16 ? (N - n) : 16;
+
+        for (size_t k = 0; k < K; k += MLAS_SGEMM_SPARSE_BLOCK_K) {
+
+            size_t CountK = (K - k) < MLAS_SGEMM_SPARSE_BLOCK_K ? (K - k) : MLAS_SGEMM_SPARSE_BLOCK_K;
+
+            if (TransB == CblasNoTrans) {
+
+                if (MlasSgemmIsZeroBlock(TransB, B + k * ldb + n, ldb, CountN, CountK)) {
+                    continue;
+                }
+
+                MlasSgemmCopyPackB(D, B + k * ldb + n, ldb, CountN, CountK);
+
+            } else {
+
+                if (MlasSgemmIsZeroBlock(TransB, B + n * ldb + k, ldb, CountN, CountK)) {
+                    continue;
+                }
+
+                MlasSgemmTransposePackB(D, B + n * ldb + k, ldb, CountN, CountK);
+            }
+
+            BlockStartK[Block++] = k;
+            D += MLAS_SGEMM_SPARSE_BLOCK_K * 16;
+        }
+    }
+}
+
+void
+MlasSgemmSparseOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B packed by MlasSgemmPackBSparse.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from the packed matrix B. The
+        starting column must be a multiple of 16.
+
+    RangeCountN - Supplies the number of columns from the packed matrix B and
+        the number of columns of matrix C.
+
+    N - Supplies the number of columns of the packed matrix B.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PanelCount = (N + 15) / 16;
+    const size_t* BlockOffsets = (const size_t*)PackedB;
+    const size_t* BlockStartK = BlockOffsets + PanelCount + 1;
+    const float* Blocks = (const float*)((const uint8_t*)PackedB +
+        MlasSgemmSparseHeaderSize(PanelCount, BlockOffsets[PanelCount]));
+
+    size_t CountM;
+
+    for (size_t m = 0; m < M; m += CountM) {
+
+        CountM = (M - m) < MLAS_SGEMM_SPARSE_STRIDEM ? (M - m) : MLAS_SGEMM_SPARSE_STRIDEM;
+
+        const float* a = (TransA == CblasNoTrans) ? A + m * lda : A + m;
+        float* c = C + m * ldc;
+
+        //
+        // Step through each panel of matrix B along the N dimension.
+        //
+
+        for (size_t n = 0; n < RangeCountN; n += 16) {
+
+            size_t CountN = (RangeCountN - n) < 16 ? (RangeCountN - n) : 16;
+            size_t Panel = (RangeStartN + n) / 16;
+
+            size_t FirstBlock = BlockOffsets[Panel];
+            size_t LastBlock = BlockOffsets[Panel + 1];
+
+            //
+            // A panel without nonzero blocks only scales the output matrix by
+            // beta.
+            //
+
+            if (FirstBlock == LastBlock && beta == 0.0f) {
+
+                for (size_t i = 0; i < CountM; i++) {
+                    std::fill_n(c + i * ldc + n, CountN, 0.0f);
+                }
+
+                continue;
+            }
+
+            if (beta != 0.0f && beta != 1.0f) {
+                MlasSgemmMultiplyBeta(c + n, CountM, CountN, ldc, beta);
+            }
+
+            //
+            // Step through the nonzero blocks of the panel.
+            //
+
+            for (size_t Block = FirstBlock; Block < LastBlock; Block++) {
+
+                bool ZeroMode = (Block == FirstBlock && beta == 0.0f);
+
+                size_t k = BlockStartK[Block];
+                size_t CountK = (K - k) < MLAS_SGEMM_SPARSE_BLOCK_K ? (K - k) : MLAS_SGEMM_SPARSE_BLOCK_K;
+
+                const float* PanelB = Blocks + Block * MLAS_SGEMM_SPARSE_BLOCK_K * 16;
+                const float* ak = (TransA == CblasNoTrans) ? a + k : a + k * lda;
+
+                MlasSgemmPanelOperation(TransA, CountM, CountN, CountK, alpha, ak, lda, PanelB, c + n, ldc, ZeroMode);
+            }
+        }
+    }
+}
+
+void
+MlasSgemmSparseOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    block sparse SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_SPARSE_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_SPARSE_WORK_BLOCK*)Context;
+
+    MLAS_SGEMM_SPARSE_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasSgemmSparseOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+        Segment->N, WorkBlock->N, WorkBlock->K, WorkBlock->alpha, Segment->A,
+        WorkBlock->lda, WorkBlock->PackedB, WorkBlock->beta, Segment->C,
+        WorkBlock->ldc);
+}
+
+void
+MLASCALL
+MlasSgemmSparse(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B packed by MlasSgemmPackBSparse.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the number of target threads given the multiply-adds of the
+    // nonzero blocks. Small requests run using the single threaded path.
+    //
+
+    const size_t PanelCount = (N + 15) / 16;
+    const size_t BlockCount = ((const size_t*)PackedB)[PanelCount];
+
+    double Complexity = double(M) * double(BlockCount) * double(MLAS_SGEMM_SPARSE_BLOCK_K * 16);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasSgemmSparseOperation(TransA, M, 0, N, N, K, alpha, A, lda, PackedB, beta, C, ldc);
+        return;
+    }
+
+    MLAS_SGEMM_SPARSE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.N = N;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartN = n;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].C = C + n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartN = 0;
+            WorkBlock.Segments[Index].A = A + m * plda;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasSgemmSparseOperationThreaded, &WorkBlock, Index, ThreadPool);
+}
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of a batch
+    of SGEMM operations or a segment of one of its operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (const MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    if (WorkBlock->ThreadsPerBatch == 1) {
+
+        size_t Batch = size_t(Index) * WorkBlock->BatchesPerThread;
+        size_t BatchEnd = Batch + WorkBlock->BatchesPerThread;
+
+        if (BatchEnd > WorkBlock->BatchCount) {
+            BatchEnd = WorkBlock->BatchCount;
+        }
+
+        for (; Batch < BatchEnd; Batch++) {
+            MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, M, N,
+                WorkBlock->K, WorkBlock->alpha, WorkBlock->A + Batch * WorkBlock->StrideA,
+                WorkBlock->lda, WorkBlock->B + Batch * WorkBlock->StrideB,
+                WorkBlock->ldb, WorkBlock->beta, WorkBlock->C + Batch * WorkBlock->StrideC,
+                WorkBlock->ldc);
+        }
+
+        return;
+    }
+
+    //
+    // Segment the operation like MlasSgemmTryMultithread, along the larger
+    // of the M and N dimensions.
+    //
+
+    const size_t Batch = size_t(Index) / WorkBlock->ThreadsPerBatch;
+    const size_t ThreadIndex = size_t(Index) % WorkBlock->ThreadsPerBatch;
+
+    const float* A = WorkBlock->A + Batch * WorkBlock->StrideA;
+    const float* B = WorkBlock->B + Batch * WorkBlock->StrideB;
+    float* C = WorkBlock->C + Batch * WorkBlock->StrideC;
+
+    if (N > M) {
+
+        size_t StrideN = (N + WorkBlock->ThreadsPerBatch - 1) / WorkBlock->ThreadsPerBatch;
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        size_t n = ThreadIndex * StrideN;
+
+        if (n >= N) {
+            return;
+        }
+
+        size_t CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, M, CountN,
+            WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda, B + n * pldb,
+            WorkBlock->ldb, WorkBlock->beta, C + n, WorkBlock->ldc);
+
+    } else {
+
+        size_t StrideM = (M + WorkBlock->ThreadsPerBatch - 1) / WorkBlock->ThreadsPerBatch;
+
+        size_t m = ThreadIndex * StrideM;
+
+        if (m >= M) {
+            return;
+        }
+
+        size_t CountM = StrideM;
+
+        if (CountM > (M - m)) {
+            CountM = M - m;
+        }
+
+        size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, CountM, N,
+            WorkBlock->K, WorkBlock->alpha, A + m * plda, WorkBlock->lda, B,
+            WorkBlock->ldb, WorkBlock->beta, C + m * WorkBlock->ldc, WorkBlock->ldc);
+    }
+}
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) with matrices separated by constant strides. The work
+    of the whole batch is partitioned across threads in a single dispatch.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for each matrix A.
+
+    TransB - Supplies the transpose operation for each matrix B.
+
+    M - Supplies the number of rows of each matrix A and matrix C.
+
+    N - Supplies the number of columns of each matrix B and matrix C.
+
+    K - Supplies the number of columns of each matrix A and the number of rows
+        of each matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of each matrix A.
+
+    StrideA - Supplies the number of elements between each matrix A, or zero
+        if every operation uses the same matrix A.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of each matrix B.
+
+    StrideB - Supplies the number of elements between each matrix B, or zero
+        if every operation uses the same matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of each matrix C.
+
+    StrideC - Supplies the number of elements between each matrix C.
+
+    BatchCount - Supplies the number of operations in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    if (BatchCount == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t Batch = 0; Batch < BatchCount; Batch++) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A + Batch * StrideA,
+                lda, B + Batch * StrideB, ldb, beta, C + Batch * StrideC, ldc);
+        }
+
+        return;
+    }
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.StrideB = StrideB;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.BatchCount = BatchCount;
+
+    //
+    // Give each thread a range of whole operations if the batch has enough of
+    // them, else split each operation across several threads.
+    //
+
+    size_t Iterations;
+
+    if (BatchCount >= size_t(TargetThreadCount)) {
+
+        WorkBlock.BatchesPerThread = (BatchCount + TargetThreadCount - 1) / TargetThreadCount;
+        WorkBlock.ThreadsPerBatch = 1;
+
+        Iterations = (BatchCount + WorkBlock.BatchesPerThread - 1) / WorkBlock.BatchesPerThread;
+
+    } else {
+
+        WorkBlock.BatchesPerThread = 1;
+        WorkBlock.ThreadsPerBatch = size_t(TargetThreadCount) / BatchCount;
+
+        Iterations = BatchCount * WorkBlock.ThreadsPerBatch;
+    }
+
+    MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, int32_t(Iterations), ThreadPool);
+}
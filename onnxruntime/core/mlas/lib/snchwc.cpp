@@ -66,15 +66,6 @@ struct MLAS_NCHWC_POOL_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK
     MLAS_POOLING_KIND PoolingKind;
 };
 
-//
-// Define the convolution kernel flags.
-//
-
-#define MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT     0x00000001
-#define MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION         0x00000002
-#define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION       0x00000004
-#define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION      0x00000008
-
 size_t
 MLASCALL
 MlasNchwcGetBlockSize(
@@ -103,6 +94,8 @@ Return Value:
 {
 #if defined(MLAS_TARGET_AMD64)
     return MlasPlatform.NchwcBlockSize;
+#elif defined(MLAS_TARGET_ARM64)
+    return MLAS_NEON_NCHWC_BLOCK_SIZE;
 #else
     return 1;
 #endif
@@ -1437,7 +1430,79 @@ Return Value:
     MlasExecuteThreaded(MlasNchwcThreaded<MLAS_NCHWC_POOL_ALGORITHM>, &WorkBlock, WorkBlock.tids, ThreadPool);
 }
 
-#if !defined(MLAS_TARGET_AMD64)
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc nearest neighbor upsample operation with
+    integral scale factors.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Scales - Supplies the scale factors for the height and width dimensions.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t TotalInputHeight = size_t(InputShape[0]) *
+        (size_t(InputShape[1]) / BlockSize) * size_t(InputShape[2]);
+    const size_t InputWidth = size_t(InputShape[3]);
+
+    const size_t ScaleHeight = size_t(Scales[0]);
+    const size_t ScaleWidth = size_t(Scales[1]);
+
+    const size_t OutputRowSize = InputWidth * ScaleWidth * BlockSize;
+
+    for (size_t h = 0; h < TotalInputHeight; h++) {
+
+        //
+        // Replicate each channel block of the input row along the width
+        // dimension.
+        //
+
+        float* OutputRow = Output;
+
+        for (size_t w = 0; w < InputWidth; w++) {
+
+            for (size_t sw = 0; sw < ScaleWidth; sw++) {
+                std::copy_n(Input, BlockSize, Output);
+                Output += BlockSize;
+            }
+
+            Input += BlockSize;
+        }
+
+        //
+        // Replicate the expanded row along the height dimension.
+        //
+
+        for (size_t sh = 1; sh < ScaleHeight; sh++) {
+            std::copy_n(OutputRow, OutputRowSize, Output);
+            Output += OutputRowSize;
+        }
+    }
+}
+
+#if !defined(MLAS_TARGET_AMD64) && !defined(MLAS_TARGET_ARM64)
 
 //
 // Convolution and pooling kernel stubs for architectures that do not yet have
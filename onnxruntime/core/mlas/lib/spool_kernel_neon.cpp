@@ -0,0 +1,250 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    spool_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the single precision pooling kernels for ARM NEON
+    used by the NCHWc pooling operations.
+
+    Each NCHWc block of eight channels is held in a pair of 128-bit vectors.
+
+--*/
+
+#include "mlasi.h"
+
+constexpr size_t BlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+
+template<MLAS_POOLING_KIND PoolingKind>
+void
+MlasPoolFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute pooling for the elements of an
+    output row for a set of filter rows.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+        The address is biased to include padding blocks for the left width
+        dimension. The address is not biased to include padding rows for the
+        left height dimension; these are accounted for in the outer kernel.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation width.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row.
+
+    ActualKernelSize - Supplies the size of the kernel based on the original
+        kernel dimensions, used for PoolingKind=MlasAveragePoolingIncludePad.
+
+    KernelHeight - Supplies the height of the kernel to apply. This height may
+        be less than the original kernel height after removing any padding
+        rows.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+        This parameter is similar to the Input parameter, but does not include
+        the padding blocks for the left width dimension. This parameter is used
+        with the following InputWidth parameter in order to validate that the
+        current input buffer address in bounds and not in the left or right
+        width padding region.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    StrideWidth /= sizeof(float);
+    DilationWidth /= sizeof(float);
+    InputStride /= sizeof(float);
+    InputWidth /= sizeof(float);
+    DilatedInputWidth /= sizeof(float);
+
+    const size_t TotalOutputCount = OutputCountLeftPad + OutputCount + OutputCountRightPad;
+
+    const MLAS_FLOAT32X4 InitialVector = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 KernelSizeVector = MlasBroadcastFloat32x4(float(ActualKernelSize));
+
+    for (size_t OutputIndex = 0; OutputIndex < TotalOutputCount; OutputIndex++) {
+
+        //
+        // Only the output elements that include padding need to validate the
+        // input addresses against the input row.
+        //
+
+        const bool CheckPadding = (OutputIndex < OutputCountLeftPad ||
+            OutputIndex >= OutputCountLeftPad + OutputCount);
+
+        const float* input = Input + OutputIndex * StrideWidth;
+        const float* input_base = InputBase;
+
+        MLAS_FLOAT32X4 Vector0 = InitialVector;
+        MLAS_FLOAT32X4 Vector1 = InitialVector;
+        size_t ValidCount = 0;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckPadding || size_t(input - input_base) < InputWidth) {
+
+                    MLAS_FLOAT32X4 InputVector0 = MlasLoadFloat32x4(&input[0]);
+                    MLAS_FLOAT32X4 InputVector1 = MlasLoadFloat32x4(&input[4]);
+
+                    if (PoolingKind == MlasMaximumPooling) {
+                        Vector0 = MlasMaximumFloat32x4(Vector0, InputVector0);
+                        Vector1 = MlasMaximumFloat32x4(Vector1, InputVector1);
+                    } else {
+                        Vector0 = MlasAddFloat32x4(Vector0, InputVector0);
+                        Vector1 = MlasAddFloat32x4(Vector1, InputVector1);
+                    }
+
+                    ValidCount++;
+                }
+
+                input += DilationWidth;
+            }
+
+            input += InputStride;
+            input_base += DilatedInputWidth;
+        }
+
+        if (PoolingKind == MlasAveragePoolingExcludePad) {
+            MLAS_FLOAT32X4 ValidCountVector = MlasBroadcastFloat32x4(float(ValidCount));
+            Vector0 = MlasDivideFloat32x4(Vector0, ValidCountVector);
+            Vector1 = MlasDivideFloat32x4(Vector1, ValidCountVector);
+        }
+
+        if (PoolingKind == MlasAveragePoolingIncludePad) {
+            Vector0 = MlasDivideFloat32x4(Vector0, KernelSizeVector);
+            Vector1 = MlasDivideFloat32x4(Vector1, KernelSizeVector);
+        }
+
+        MlasStoreFloat32x4(&Output[0], Vector0);
+        MlasStoreFloat32x4(&Output[4], Vector1);
+
+        Output += BlockSize;
+    }
+}
+
+void
+MLASCALL
+MlasPoolMaximumFloatKernel(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasMaximumPooling>(Input, Output, StrideWidth,
+        DilationWidth, InputStride, ActualKernelSize, KernelHeight, KernelWidth,
+        InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad,
+        OutputCount, OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageExcludePadFloatKernel(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasAveragePoolingExcludePad>(Input, Output,
+        StrideWidth, DilationWidth, InputStride, ActualKernelSize, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageIncludePadFloatKernel(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolFloatKernelNeon<MlasAveragePoolingIncludePad>(Input, Output,
+        StrideWidth, DilationWidth, InputStride, ActualKernelSize, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad);
+}
@@ -0,0 +1,337 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/attention_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+bool IsFloatTensor(const NodeArg& arg) {
+  return arg.Type() != nullptr && *arg.Type() == "tensor(float)";
+}
+
+// Returns the node producing arg among the inputs of node, or nullptr if arg is not produced by a node.
+const Node* GetProducer(const Node& node, const NodeArg* arg) {
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    for (const NodeArg* output : it->OutputDefs()) {
+      if (output == arg) {
+        return &*it;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Reads a constant float initializer holding a single value.
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  Initializer initializer(tensor_proto);
+  if (initializer.size() != 1) {
+    return false;
+  }
+  value = *initializer.data<float>();
+  return true;
+}
+
+// Reads a constant 1-D int64 initializer, such as the shape input of a Reshape.
+bool GetInt64Constant(const Graph& graph, const NodeArg& arg, std::vector<int64_t>& values) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() != 1) {
+    return false;
+  }
+
+  if (tensor_proto->has_raw_data()) {
+    const std::string& raw_data = tensor_proto->raw_data();
+    values.resize(raw_data.size() / sizeof(int64_t));
+    std::memcpy(values.data(), raw_data.data(), values.size() * sizeof(int64_t));
+  } else {
+    values.assign(tensor_proto->int64_data().begin(), tensor_proto->int64_data().end());
+  }
+  return static_cast<int64_t>(values.size()) == tensor_proto->dims(0);
+}
+
+bool IsTranspose(const Node& node, const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) &&
+         graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm) && perm == expected_perm;
+}
+
+// Returns true if the leading two entries of a Reshape shape keep the batch and sequence dimensions of input,
+// either by copying them with 0, inferring one of them with -1, or repeating their known values.
+bool KeepsBatchAndSequence(const std::vector<int64_t>& shape, const TensorShapeProto& input_shape) {
+  int inferred = 0;
+  for (int i = 0; i < 2; ++i) {
+    if (shape[i] == -1) {
+      inferred++;
+    } else if (shape[i] != 0 &&
+               (!input_shape.dim(i).has_dim_value() || input_shape.dim(i).dim_value() != shape[i])) {
+      return false;
+    }
+  }
+  return inferred <= 1;
+}
+
+bool HaveSameValue(const TensorShapeProto_Dimension& dim1, const TensorShapeProto_Dimension& dim2) {
+  if (dim1.has_dim_value() && dim2.has_dim_value()) {
+    return dim1.dim_value() == dim2.dim_value();
+  }
+  return dim1.has_dim_param() && dim2.has_dim_param() && !dim1.dim_param().empty() &&
+         dim1.dim_param() == dim2.dim_param();
+}
+
+// The nodes projecting the input to the query, key or value heads.
+struct Projection {
+  const Node* matmul;
+  const Node* add;
+  const Node* reshape;
+  const Node* transpose;
+  const TensorProto* weight;
+  const TensorProto* bias;
+};
+
+// Matches Transpose(Reshape(Add(MatMul(input, weight), bias), [batch, sequence, num_heads, head_size]), perm)
+// backwards from transpose. The input, num_heads and head_size found by the first projection must be shared
+// by the others.
+bool MatchProjection(const Graph& graph, const Node* transpose, const std::vector<int64_t>& perm,
+                     NodeArg*& input, int64_t& num_heads, int64_t& head_size, Projection& projection) {
+  if (transpose == nullptr || !IsTranspose(*transpose, perm) || !graph_utils::HasSingleConsumer(graph, *transpose)) {
+    return false;
+  }
+
+  const Node* reshape = GetProducer(*transpose, transpose->InputDefs()[0]);
+  std::vector<int64_t> shape;
+  if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5}) ||
+      !graph_utils::HasSingleConsumer(graph, *reshape) || !GetInt64Constant(graph, *reshape->InputDefs()[1], shape) ||
+      shape.size() != 4 || shape[2] <= 0 || shape[3] <= 0) {
+    return false;
+  }
+
+  const Node* add = GetProducer(*reshape, reshape->InputDefs()[0]);
+  if (add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*add, "Add", {7}) ||
+      !graph_utils::HasSingleConsumer(graph, *add)) {
+    return false;
+  }
+
+  const auto& add_inputs = add->InputDefs();
+  const Node* matmul = GetProducer(*add, add_inputs[0]);
+  const NodeArg* bias = add_inputs[1];
+  if (matmul == nullptr || matmul->OpType() != "MatMul") {
+    matmul = GetProducer(*add, add_inputs[1]);
+    bias = add_inputs[0];
+  }
+  if (matmul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*matmul, "MatMul", {1, 9}) ||
+      !graph_utils::HasSingleConsumer(graph, *matmul)) {
+    return false;
+  }
+
+  NodeArg* x = const_cast<Node*>(matmul)->MutableInputDefs()[0];
+  const TensorShapeProto* x_shape = x->Shape();
+  if (x_shape == nullptr || x_shape->dim_size() != 3 || !x_shape->dim(2).has_dim_value() || !IsFloatTensor(*x) ||
+      (input != nullptr && x != input)) {
+    return false;
+  }
+  const int64_t hidden_size = x_shape->dim(2).dim_value();
+
+  const auto* weight_proto = graph_utils::GetConstantInitializer(graph, matmul->InputDefs()[1]->Name());
+  const auto* bias_proto = graph_utils::GetConstantInitializer(graph, bias->Name());
+  if (weight_proto == nullptr || weight_proto->data_type() != TensorProto_DataType_FLOAT ||
+      weight_proto->dims_size() != 2 || weight_proto->dims(0) != hidden_size || weight_proto->dims(1) != hidden_size ||
+      bias_proto == nullptr || bias_proto->data_type() != TensorProto_DataType_FLOAT ||
+      bias_proto->dims_size() != 1 || bias_proto->dims(0) != hidden_size) {
+    return false;
+  }
+
+  if (shape[2] * shape[3] != hidden_size || !KeepsBatchAndSequence(shape, *x_shape) ||
+      (input != nullptr && (shape[2] != num_heads || shape[3] != head_size))) {
+    return false;
+  }
+
+  input = x;
+  num_heads = shape[2];
+  head_size = shape[3];
+  projection = {matmul, add, reshape, transpose, weight_proto, bias_proto};
+  return true;
+}
+
+}  // namespace
+
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  const std::vector<int64_t> split_heads_perm{0, 2, 1, 3};
+  const std::vector<int64_t> split_key_heads_perm{0, 2, 3, 1};
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& softmax = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders()) ||
+        !graph_utils::HasSingleConsumer(graph, softmax) || !IsFloatTensor(*softmax.InputDefs()[0])) {
+      continue;
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(softmax, "axis");
+    if (axis_attr == nullptr || (axis_attr->i() != 3 && axis_attr->i() != -1)) {
+      continue;
+    }
+
+    // An optional additive mask between the scaling and the Softmax.
+    const Node* scale = GetProducer(softmax, softmax.InputDefs()[0]);
+    const Node* add_mask = nullptr;
+    NodeArg* mask = nullptr;
+    if (scale != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Add", {7})) {
+      add_mask = scale;
+      auto& add_inputs = const_cast<Node*>(add_mask)->MutableInputDefs();
+      scale = GetProducer(*add_mask, add_inputs[0]);
+      mask = add_inputs[1];
+      if (scale == nullptr || (scale->OpType() != "Div" && scale->OpType() != "Mul")) {
+        scale = GetProducer(*add_mask, add_inputs[1]);
+        mask = add_inputs[0];
+      }
+
+      const TensorShapeProto* mask_shape = mask->Shape();
+      if (!graph_utils::HasSingleConsumer(graph, *add_mask) || !IsFloatTensor(*mask) || mask_shape == nullptr ||
+          mask_shape->dim_size() != 4 || !mask_shape->dim(1).has_dim_value() || mask_shape->dim(1).dim_value() != 1) {
+        continue;
+      }
+    }
+
+    float scale_value;
+    if (scale == nullptr || !graph_utils::HasSingleConsumer(graph, *scale) ||
+        !(graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Div", {7}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(*scale, "Mul", {7})) ||
+        !GetScalarConstant(graph, *scale->InputDefs()[1], scale_value)) {
+      continue;
+    }
+
+    const Node* qk = GetProducer(*scale, scale->InputDefs()[0]);
+    if (qk == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*qk, "MatMul", {1, 9}) ||
+        !graph_utils::HasSingleConsumer(graph, *qk)) {
+      continue;
+    }
+
+    // The probabilities are applied to the values and the heads are merged back to (batch, sequence, hidden).
+    const Node& pv = *softmax.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(pv, "MatMul", {1, 9}) ||
+        pv.InputDefs()[0] != softmax.OutputDefs()[0] || !graph_utils::HasSingleConsumer(graph, pv)) {
+      continue;
+    }
+
+    const Node& merge_transpose = *pv.OutputNodesBegin();
+    if (!IsTranspose(merge_transpose, split_heads_perm) || !graph_utils::HasSingleConsumer(graph, merge_transpose)) {
+      continue;
+    }
+
+    const Node& merge_reshape = *merge_transpose.OutputNodesBegin();
+    std::vector<int64_t> merge_shape;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(merge_reshape, "Reshape", {5}) ||
+        !GetInt64Constant(graph, *merge_reshape.InputDefs()[1], merge_shape) || merge_shape.size() != 3) {
+      continue;
+    }
+
+    NodeArg* input = nullptr;
+    int64_t num_heads = 0;
+    int64_t head_size = 0;
+    Projection q, k, v;
+    if (!MatchProjection(graph, GetProducer(*qk, qk->InputDefs()[0]), split_heads_perm, input, num_heads, head_size, q) ||
+        !MatchProjection(graph, GetProducer(*qk, qk->InputDefs()[1]), split_key_heads_perm, input, num_heads, head_size, k) ||
+        !MatchProjection(graph, GetProducer(pv, pv.InputDefs()[1]), split_heads_perm, input, num_heads, head_size, v)) {
+      continue;
+    }
+
+    const int64_t hidden_size = num_heads * head_size;
+    const float expected_scale = std::sqrt(static_cast<float>(head_size));
+    const bool is_div = scale->OpType() == "Div";
+    if ((is_div && std::abs(scale_value - expected_scale) > 1e-3f * expected_scale) ||
+        (!is_div && std::abs(scale_value * expected_scale - 1.0f) > 1e-3f) ||
+        merge_shape[2] != hidden_size || !KeepsBatchAndSequence(merge_shape, *input->Shape()) ||
+        (mask != nullptr && !HaveSameValue(mask->Shape()->dim(3), input->Shape()->dim(1)))) {
+      continue;
+    }
+
+    // Concatenate the projections so the query, key and value of every head come out of a single GEMM.
+    std::vector<float> weight(static_cast<size_t>(hidden_size * 3 * hidden_size));
+    std::vector<float> bias(static_cast<size_t>(3 * hidden_size));
+    const Projection* projections[] = {&q, &k, &v};
+    for (int64_t p = 0; p < 3; ++p) {
+      Initializer projection_weight(projections[p]->weight);
+      Initializer projection_bias(projections[p]->bias);
+      for (int64_t row = 0; row < hidden_size; ++row) {
+        std::copy_n(projection_weight.data<float>() + row * hidden_size, hidden_size,
+                    weight.data() + row * 3 * hidden_size + p * hidden_size);
+      }
+      std::copy_n(projection_bias.data<float>(), hidden_size, bias.data() + p * hidden_size);
+    }
+
+    TensorProto weight_tensor_proto;
+    weight_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    weight_tensor_proto.set_name(graph.GenerateNodeArgName("attention_weight"));
+    weight_tensor_proto.set_raw_data(weight.data(), weight.size() * sizeof(float));
+    weight_tensor_proto.add_dims(hidden_size);
+    weight_tensor_proto.add_dims(3 * hidden_size);
+    graph.AddInitializedTensor(weight_tensor_proto);
+
+    TensorProto bias_tensor_proto;
+    bias_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    bias_tensor_proto.set_name(graph.GenerateNodeArgName("attention_bias"));
+    bias_tensor_proto.set_raw_data(bias.data(), bias.size() * sizeof(float));
+    bias_tensor_proto.add_dims(3 * hidden_size);
+    graph.AddInitializedTensor(bias_tensor_proto);
+
+    std::vector<NodeArg*> fused_inputs{input,
+                                       &graph.GetOrCreateNodeArg(weight_tensor_proto.name(), nullptr),
+                                       &graph.GetOrCreateNodeArg(bias_tensor_proto.name(), nullptr)};
+    if (mask != nullptr) {
+      fused_inputs.push_back(mask);
+    }
+
+    Node& attention = graph.AddNode(graph.GenerateNodeName("fused " + softmax.Name()), "Attention",
+                                    "fused self-attention around " + softmax.Name(),
+                                    fused_inputs,
+                                    const_cast<Node&>(merge_reshape).MutableOutputDefs(),
+                                    nullptr,
+                                    kMSDomain);
+    attention.AddAttribute("num_heads", num_heads);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention.SetExecutionProviderType(softmax.GetExecutionProviderType());
+
+    for (const Projection* projection : projections) {
+      for (const Node* node : {projection->matmul, projection->add, projection->reshape, projection->transpose}) {
+        removed_nodes.push_front(node->Index());
+      }
+    }
+    for (const Node* node : {qk, scale, add_mask, static_cast<const Node*>(&softmax), &pv, &merge_transpose,
+                             &merge_reshape}) {
+      if (node != nullptr) {
+        removed_nodes.push_front(node->Index());
+      }
+    }
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
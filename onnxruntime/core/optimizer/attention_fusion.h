@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AttentionFusion
+
+Fuses multi-head self-attention into an Attention node. The query, key and value branches each project
+the same input with MatMul and Add of constant weights and split the heads with Reshape and Transpose;
+the heads are combined by MatMul, scaled by Div or Mul, optionally masked by Add, normalized by Softmax,
+applied to the values by MatMul and merged back with Transpose and Reshape. The three projections are
+concatenated into a single weight and bias so the fused node computes them with one GEMM.
+*/
+class AttentionFusion : public GraphTransformer {
+ public:
+  AttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("AttentionFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
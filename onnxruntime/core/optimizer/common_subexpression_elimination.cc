@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <map>
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// Appends a length prefixed field so the concatenation of fields is unambiguous.
+void AppendField(std::string& key, const std::string& value) {
+  key += std::to_string(value.size());
+  key += ':';
+  key += value;
+}
+
+// Returns the signature of everything that determines the outputs of node: its op, execution provider,
+// attributes and inputs. Nodes with the same signature compute the same values.
+std::string NodeSignature(const Node& node) {
+  std::string key;
+  AppendField(key, node.Domain());
+  AppendField(key, node.OpType());
+  AppendField(key, node.GetExecutionProviderType());
+
+  for (const auto* input : node.InputDefs()) {
+    AppendField(key, input->Exists() ? input->Name() : std::string());
+  }
+
+  // the same op may be declared with a different number of optional outputs
+  key += '|';
+  for (const auto* output : node.OutputDefs()) {
+    key += output->Exists() ? '1' : '0';
+  }
+
+  const auto& attributes = node.GetAttributes();
+  std::vector<std::string> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end());
+  for (const auto& name : attribute_names) {
+    AppendField(key, name);
+    AppendField(key, attributes.at(name).SerializeAsString());
+  }
+
+  return key;
+}
+
+// Returns the value of an initializer without its name, so initializers holding the same tensor compare equal.
+std::string InitializerContent(const TensorProto& tensor) {
+  TensorProto value(tensor);
+  value.clear_name();
+  value.clear_doc_string();
+  return value.SerializeAsString();
+}
+
+// Returns the names of the values that subgraphs of the nodes in graph reference by name. These can't be
+// replaced without rewriting the subgraphs.
+std::unordered_set<std::string> GetImplicitInputNames(const Graph& graph) {
+  std::unordered_set<std::string> names;
+  for (const auto& node : graph.Nodes()) {
+    for (const auto* input : node.ImplicitInputDefs()) {
+      names.insert(input->Name());
+    }
+  }
+  return names;
+}
+
+}  // namespace
+
+bool CommonSubexpressionElimination::MergeInitializers(Graph& graph) const {
+  // Only initializers with the same type and shape can hold the same value, so group them by that first
+  // and only compare the data of initializers that share a group.
+  std::map<std::string, std::vector<std::string>> groups;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    const TensorProto& tensor = *entry.second;
+    if (graph.GetNodeArg(entry.first) == nullptr ||
+        !graph_utils::IsConstantInitializer(graph, entry.first, false)) {
+      continue;
+    }
+
+    std::string group;
+    AppendField(group, std::to_string(tensor.data_type()));
+    for (auto dim : tensor.dims()) {
+      AppendField(group, std::to_string(dim));
+    }
+    groups[group].push_back(entry.first);
+  }
+
+  std::unordered_set<std::string> pinned_names = GetImplicitInputNames(graph);
+  for (const auto* output : graph.GetOutputs()) {
+    pinned_names.insert(output->Name());
+  }
+
+  std::unordered_map<std::string, NodeArg*> replacements;
+  for (auto& group : groups) {
+    auto& names = group.second;
+    if (names.size() < 2) {
+      continue;
+    }
+
+    // keep the first name of the tensors with the same value
+    std::sort(names.begin(), names.end());
+    std::unordered_map<std::string, std::string> kept_by_content;
+    for (const auto& name : names) {
+      const TensorProto* tensor = nullptr;
+      graph.GetInitializedTensor(name, tensor);
+      auto result = kept_by_content.emplace(InitializerContent(*tensor), name);
+      if (!result.second && pinned_names.find(name) == pinned_names.end()) {
+        replacements.emplace(name, graph.GetNodeArg(result.first->second));
+      }
+    }
+  }
+
+  if (replacements.empty()) {
+    return false;
+  }
+
+  // Initializers don't create edges, so replacing the input definitions is enough.
+  for (auto& node : graph.Nodes()) {
+    for (auto& input : node.MutableInputDefs()) {
+      auto it = replacements.find(input->Name());
+      if (it != replacements.end()) {
+        input = it->second;
+      }
+    }
+  }
+
+  for (const auto& replacement : replacements) {
+    graph.RemoveInitializedTensor(replacement.first);
+  }
+
+  return true;
+}
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  if (MergeInitializers(graph)) {
+    modified = true;
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  const std::unordered_set<std::string> implicit_input_names = GetImplicitInputNames(graph);
+
+  std::unordered_map<std::string, NodeIndex> signatures;
+  std::vector<NodeIndex> removed_nodes;
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    // Nodes with subgraphs are not compared, the nodes inside them are handled by the Recurse call above.
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
+        node->ContainsSubgraph() || node->OutputDefs().empty()) {
+      continue;
+    }
+
+    std::string signature = NodeSignature(*node);
+    auto it = signatures.find(signature);
+    if (it == signatures.end()) {
+      signatures.emplace(std::move(signature), index);
+      continue;
+    }
+
+    // The outputs of the duplicate must only be consumed by explicit inputs of nodes in this graph.
+    if (graph.IsNodeOutputsInGraphOutputs(*node) ||
+        std::any_of(node->OutputDefs().begin(), node->OutputDefs().end(), [&](const NodeArg* output) {
+          return implicit_input_names.find(output->Name()) != implicit_input_names.end();
+        })) {
+      continue;
+    }
+
+    Node& original = *graph.GetNode(it->second);
+    std::vector<Node::EdgeEnd> output_edges(node->OutputEdgesBegin(), node->OutputEdgesEnd());
+    for (const auto& edge : output_edges) {
+      Node& consumer = *graph.GetNode(edge.GetNode().Index());
+      const int src_arg_index = edge.GetSrcArgIndex();
+      const int dst_arg_index = edge.GetDstArgIndex();
+      graph.RemoveEdge(index, consumer.Index(), src_arg_index, dst_arg_index);
+      // adding the edge points the input of the consumer at the output of the original node
+      graph.AddEdge(original.Index(), consumer.Index(), src_arg_index, dst_arg_index);
+    }
+
+    removed_nodes.push_back(index);
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class CommonSubexpressionElimination
+
+Transformer that merges duplicate computations. Constant initializers with the same type, shape and
+data are merged first, then the graph is traversed top-down and every node with the same op type,
+domain, attributes, inputs and execution provider as an earlier node is removed, with its consumers
+rewired to the outputs of the earlier node. As inputs are rewired while traversing, whole duplicate
+branches collapse in a single pass.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+ private:
+  /** Nodes whose op_type is included in this set are never merged.
+      All non-deterministic operators should be included in this set. */
+  const std::unordered_set<std::string> excluded_op_types_ =
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  /** Replaces every use of a constant initializer by an earlier initializer holding the same value. */
+  bool MergeInitializers(Graph& graph) const;
+};
+
+}  // namespace onnxruntime
@@ -11,6 +11,56 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+namespace {
+// Returns the size of the constant inputs of a node.
+size_t GetSizeInBytes(const InitializedTensorSet& constant_inputs) {
+  size_t total_bytes = 0;
+  for (const auto& entry : constant_inputs) {
+    size_t bytes = 0;
+    if (utils::GetSizeInBytesFromTensorProto<0>(*entry.second, &bytes).IsOK()) {
+      total_bytes += bytes;
+    }
+  }
+  return total_bytes;
+}
+
+// Estimates the size of the outputs of a node from their inferred types and shapes, which is only possible if
+// all of them are tensors with a known shape.
+bool EstimateOutputSizeInBytes(const Node& node, size_t& total_bytes) {
+  total_bytes = 0;
+  for (const auto* output : node.OutputDefs()) {
+    const auto* type = output->TypeAsProto();
+    const auto* shape = output->Shape();
+    if (type == nullptr || !type->has_tensor_type() || shape == nullptr) {
+      return false;
+    }
+
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_data_type(type->tensor_type().elem_type());
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim)) {
+        return false;
+      }
+      tensor_proto.add_dims(dim.dim_value());
+    }
+
+    size_t bytes = 0;
+    if (!utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &bytes).IsOK()) {
+      return false;
+    }
+    total_bytes += bytes;
+  }
+  return true;
+}
+}  // namespace
+
+bool ConstantFolding::ShouldFold(size_t input_bytes, size_t output_bytes) const {
+  if (output_bytes > max_output_bytes_) {
+    return false;
+  }
+  return output_bytes <= kSmallOutputBytes || output_bytes / kMaxExpansionRatio <= input_bytes;
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -39,6 +89,15 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
       continue;
     }
 
+    // Nodes without inputs, such as Constant, already hold their outputs in the model, so they are always folded.
+    // Skip the other nodes whose outputs are known to be too large before computing them.
+    const bool check_size = !node->InputDefs().empty();
+    const size_t input_bytes = GetSizeInBytes(constant_inputs);
+    size_t output_bytes = 0;
+    if (check_size && EstimateOutputSizeInBytes(*node, output_bytes) && !ShouldFold(input_bytes, output_bytes)) {
+      continue;
+    }
+
     // Create execution frame for executing constant nodes.
     OptimizerExecutionFrame::Info info({node}, constant_inputs);
 
@@ -60,6 +119,15 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
     // Go over all output node args and substitute them with the newly computed tensors, which will be
     // added to the graph as initializers.
     ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
+    output_bytes = 0;
+    for (const OrtValue& ort_value : fetches) {
+      ORT_ENFORCE(ort_value.IsTensor());
+      output_bytes += ort_value.Get<Tensor>().SizeInBytes();
+    }
+    if (check_size && !ShouldFold(input_bytes, output_bytes)) {
+      continue;
+    }
+
     for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
       OrtValue& ort_value = fetches[fetch_idx];
 
@@ -13,20 +13,43 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+A node is only folded if its outputs stay small enough: they must not exceed max_output_bytes, and unless
+they are small, they must not be much larger than the constant inputs of the node. Nodes such as
+ConstantOfShape, Tile or Expand that turn small inputs into large outputs are cheap to run but would grow
+the memory and the load time of the model if folded. The folded initializers are part of the optimized
+model saved with SessionOptions::optimized_model_filepath, so they are only computed once.
 */
 class ConstantFolding : public GraphTransformer {
  public:
-  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept :
-    GraphTransformer("ConstantFolding", compatible_execution_providers) {}
+  /** The default limit of the size of the outputs of a folded node. */
+  static constexpr size_t kDefaultMaxOutputBytes = 256 * 1024 * 1024;
+
+  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                  size_t max_output_bytes = kDefaultMaxOutputBytes) noexcept
+      : GraphTransformer("ConstantFolding", compatible_execution_providers), max_output_bytes_(max_output_bytes) {}
 
  private:
+  /** Outputs up to this size, such as the results of shape computations, are folded regardless of their inputs. */
+  static constexpr size_t kSmallOutputBytes = 4 * 1024;
+
+  /** Larger outputs are not folded if they are more than this many times the size of the constant inputs. */
+  static constexpr size_t kMaxExpansionRatio = 4;
+
+  const size_t max_output_bytes_;
+
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
-      All non-deterministic operators should be included in this set. */
+      All non-deterministic operators should be included in this set. DequantizeLinear is kept so QDQFusion can
+      run the nodes using a quantized weight on the weight itself. */
   const std::unordered_set<std::string> excluded_op_types_ =
-      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial", "DequantizeLinear"};
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
 
+  /** Returns true if a node with constant inputs of input_bytes should be replaced by initializers of
+  output_bytes. */
+  bool ShouldFold(size_t input_bytes, size_t output_bytes) const;
+
   /** Create a TensorProto that has the same value as the given OrtValue
   and the same type and dimensions as the given NodeArg. */
   void BuildTensorProtoForInitializer(const OrtValue& ort_value, const NodeArg& constant_node_arg,
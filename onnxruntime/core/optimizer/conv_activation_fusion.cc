@@ -57,7 +57,9 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
         !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6})) {
       if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LeakyRelu", {6})) {
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "alpha")->f());
-      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6})) {
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6}) &&
+                 node->GetExecutionProviderType() != kCudaExecutionProvider) {
+        // the CUDA kernel has no Clip activation
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "min")->f());
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "max")->f());
       } else {
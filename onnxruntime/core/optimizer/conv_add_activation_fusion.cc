@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/conv_add_activation_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Returns true if both args have known shapes with the same dimensions, as the residual can't be broadcast.
+bool HaveSameShape(const NodeArg& a, const NodeArg& b) {
+  const auto* a_shape = a.Shape();
+  const auto* b_shape = b.Shape();
+  if (a_shape == nullptr || b_shape == nullptr || a_shape->dim_size() != b_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < a_shape->dim_size(); ++i) {
+    const auto& a_dim = a_shape->dim(i);
+    const auto& b_dim = b_shape->dim(i);
+    const bool same_value = a_dim.has_dim_value() && b_dim.has_dim_value() && a_dim.dim_value() == b_dim.dim_value();
+    const bool same_param = a_dim.has_dim_param() && b_dim.has_dim_param() && a_dim.dim_param() == b_dim.dim_param();
+    if (!same_value && !same_param) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+Status ConvAddActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto* conv = graph.GetNode(index);
+    if (!conv) {
+      continue;
+    }
+    ORT_RETURN_IF_ERROR(Recurse(*conv, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(*conv, "Conv", {1}) ||
+        !graph_utils::IsSupportedProvider(*conv, GetCompatibleExecutionProviders()) ||
+        !graph_utils::HasSingleConsumer(graph, *conv)) {
+      continue;
+    }
+
+    const Node& add = *conv->OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add, "Add", {7})) {
+      continue;
+    }
+
+    const NodeArg* conv_output = conv->OutputDefs()[0];
+    const auto& add_inputs = add.InputDefs();
+    if (add_inputs[0] == add_inputs[1]) {
+      continue;
+    }
+    NodeArg* residual = const_cast<NodeArg*>(add_inputs[0] == conv_output ? add_inputs[1] : add_inputs[0]);
+    if (!HaveSameShape(*residual, *conv_output)) {
+      continue;
+    }
+
+    const Node* relu = nullptr;
+    if (graph_utils::HasSingleConsumer(graph, add) &&
+        graph_utils::IsSupportedOptypeVersionAndDomain(*add.OutputNodesBegin(), "Relu", {6})) {
+      relu = &*add.OutputNodesBegin();
+    }
+    const Node& last = relu != nullptr ? *relu : add;
+
+    // Z is the fourth input, after an empty bias if the Conv has none
+    std::vector<NodeArg*> inputs = conv->MutableInputDefs();
+    if (inputs.size() < 3) {
+      inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+    }
+    inputs.push_back(residual);
+
+    Node& fused_conv = graph.AddNode(graph.GenerateNodeName("fused " + conv->Name()), "FusedConv",
+                                     "fused Conv " + conv->Name() + " with residual Add " + add.Name(),
+                                     inputs,
+                                     const_cast<Node&>(last).MutableOutputDefs(),
+                                     &conv->GetAttributes(),
+                                     kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_conv.SetExecutionProviderType(conv->GetExecutionProviderType());
+    if (relu != nullptr) {
+      fused_conv.AddAttribute("activation", std::string("Relu"));
+    }
+
+    for (const Node* node : {static_cast<const Node*>(conv), &add, relu}) {
+      if (node != nullptr) {
+        removed_nodes.push_front(node->Index());
+      }
+    }
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
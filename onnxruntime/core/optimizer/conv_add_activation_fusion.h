@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ConvAddActivationFusion
+
+Fuses a Conv, the Add of a residual of the shape of its output, and an optional Relu after the Add, into a FusedConv
+that takes the residual as its Z input, as in the blocks of residual networks.
+*/
+class ConvAddActivationFusion : public GraphTransformer {
+ public:
+  ConvAddActivationFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ConvAddActivationFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
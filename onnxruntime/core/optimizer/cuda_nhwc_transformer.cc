@@ -0,0 +1,452 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/cuda_nhwc_transformer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The permutations between the NCHW and the NHWC layouts of a 4-D tensor.
+const std::vector<int64_t> kNchwToNhwcPerm{0, 2, 3, 1};
+const std::vector<int64_t> kNhwcToNchwPerm{0, 3, 1, 2};
+
+bool IsFloat16Tensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT16;
+}
+
+bool Has4DShape(const NodeArg& arg) {
+  return arg.Shape() != nullptr && arg.Shape()->dim_size() == 4;
+}
+
+// Returns true if the shapes of a and b are known and equal.
+bool HaveSameShape(const NodeArg& a, const NodeArg& b) {
+  const auto* a_shape = a.Shape();
+  const auto* b_shape = b.Shape();
+  if (a_shape == nullptr || b_shape == nullptr || a_shape->dim_size() != b_shape->dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < a_shape->dim_size(); i++) {
+    const auto& a_dim = a_shape->dim(i);
+    const auto& b_dim = b_shape->dim(i);
+    if (!utils::HasDimValue(a_dim) || !utils::HasDimValue(b_dim) || a_dim.dim_value() != b_dim.dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the name of the NHWC pooling op replacing node, or an empty string if the CUDA kernels of the NHWC
+// pooling ops don't compute node.
+std::string GetNhwcPoolOpType(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10})) {
+    return "Nhwc" + node.OpType();
+  }
+
+  // the NHWC kernel has no Indices output or dilations
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10}) &&
+      (node.OutputDefs().size() == 1 || !node.OutputDefs()[1]->Exists())) {
+    std::vector<int64_t> dilations;
+    if (graph_utils::GetRepeatedNodeAttributeValues(node, "dilations", dilations)) {
+      for (auto dilation : dilations) {
+        if (dilation != 1) {
+          return std::string();
+        }
+      }
+    }
+    return "NhwcMaxPool";
+  }
+
+  return std::string();
+}
+}  // namespace
+
+class CudaNhwcTransformerImpl {
+ public:
+  CudaNhwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+ private:
+  // Associate the following state with each created NHWC output keyed off the original NodeArg.
+  struct NhwcArgument {
+    // Stores the NodeArg that represents the NHWC output.
+    NodeArg* nhwc_arg_;
+
+    // Stores the remaining number of uses for the original NodeArg. The count is decremented as uses are converted
+    // to the NHWC layout. A Transpose back to NCHW is inserted if this count is non-zero.
+    size_t remaining_original_uses_;
+  };
+
+  size_t RemoveOutputEdges(Node& node);
+  void CreateNhwcArgument(Node& node, Node& nhwc_node);
+  NhwcArgument* LookupNhwcArgument(NodeArg* arg);
+  NodeArg* UseNhwcArgument(NhwcArgument& nhwc_arg);
+  NodeArg* GetNhwcInput(NodeArg* input, const Node& node);
+  NodeArg* GetNhwcFilter(NodeArg* filter, const TensorProto& filter_tensor_proto);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformBatchNormalization(Node& node);
+  void TransformActivation(Node& node);
+  void TransformAdd(Node& node);
+  void TransformConcat(Node& node);
+
+  Graph& graph_;
+
+  // Stores a queue of nodes to be removed after walking through the graph.
+  std::deque<NodeIndex> removed_nodes_;
+
+  // Stores a mapping from the original NodeArg outputs to the NHWC variants created inside this graph transform.
+  std::unordered_map<NodeArg*, NhwcArgument> nhwc_args_;
+
+  // Stores a mapping of NodeArg inputs that have already been transposed to NHWC, so multiple nodes can share the
+  // NHWC input.
+  std::unordered_map<NodeArg*, NodeArg*> transposed_inputs_;
+
+  // Stores a mapping of NodeArg filters that have already been reordered to (M, kH, kW, C / group), so multiple
+  // nodes can share the NHWC filter.
+  std::unordered_map<NodeArg*, NodeArg*> nhwc_filters_;
+};
+
+size_t CudaNhwcTransformerImpl::RemoveOutputEdges(Node& node) {
+  size_t output_uses = graph_utils::RemoveNodeOutputEdges(graph_, node);
+  // A graph output is one more use, which keeps the NCHW layout.
+  if (graph_.IsNodeOutputsInGraphOutputs(node)) {
+    output_uses++;
+  }
+  return output_uses;
+}
+
+void CudaNhwcTransformerImpl::CreateNhwcArgument(Node& node, Node& nhwc_node) {
+  size_t original_uses = RemoveOutputEdges(node);
+
+  // Create a new NodeArg to track the output from the NHWC node.
+  auto& output_defs = nhwc_node.MutableOutputDefs();
+  auto* output_original_arg = output_defs[0];
+  auto* output_nhwc_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName("nhwc"), nullptr);
+  nhwc_args_[output_original_arg] = NhwcArgument{output_nhwc_arg, original_uses};
+  output_defs[0] = output_nhwc_arg;
+}
+
+CudaNhwcTransformerImpl::NhwcArgument* CudaNhwcTransformerImpl::LookupNhwcArgument(NodeArg* arg) {
+  auto it = nhwc_args_.find(arg);
+  return it != nhwc_args_.end() ? &it->second : nullptr;
+}
+
+NodeArg* CudaNhwcTransformerImpl::UseNhwcArgument(NhwcArgument& nhwc_arg) {
+  nhwc_arg.remaining_original_uses_--;
+  return nhwc_arg.nhwc_arg_;
+}
+
+// Returns the NHWC variant of the 4-D input of node, which is transposed from NCHW unless it is already available.
+NodeArg* CudaNhwcTransformerImpl::GetNhwcInput(NodeArg* input, const Node& node) {
+  auto* nhwc_input = LookupNhwcArgument(input);
+  if (nhwc_input != nullptr) {
+    return UseNhwcArgument(*nhwc_input);
+  }
+
+  auto it = transposed_inputs_.find(input);
+  if (it != transposed_inputs_.end()) {
+    return it->second;
+  }
+
+  auto* input_nhwc_arg = &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName("nhwc"), nullptr);
+  transposed_inputs_[input] = input_nhwc_arg;
+  Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("TransposeToNhwc"),
+                                        "Transpose",
+                                        "Transpose to NHWC",
+                                        {input},
+                                        {input_nhwc_arg});
+  transpose_node.AddAttribute("perm", kNchwToNhwcPerm);
+  transpose_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  return input_nhwc_arg;
+}
+
+// Returns the NodeArg of the filter reordered statically from (M, C / group, kH, kW) to (M, kH, kW, C / group).
+NodeArg* CudaNhwcTransformerImpl::GetNhwcFilter(NodeArg* filter, const TensorProto& filter_tensor_proto) {
+  auto it = nhwc_filters_.find(filter);
+  if (it != nhwc_filters_.end()) {
+    return it->second;
+  }
+
+  Initializer conv_W{&filter_tensor_proto};
+  const auto& dims = conv_W.dims();
+  const int64_t output_channels = dims[0];
+  const int64_t input_channels = dims[1];
+  const int64_t kernel_size = dims[2] * dims[3];
+
+  // The float16 values are moved as their bits.
+  const auto* filter_data = conv_W.data<uint16_t>();
+  std::vector<uint16_t> reordered_filter(static_cast<size_t>(conv_W.size()));
+  for (int64_t m = 0; m < output_channels; m++) {
+    for (int64_t c = 0; c < input_channels; c++) {
+      for (int64_t k = 0; k < kernel_size; k++) {
+        reordered_filter[(m * kernel_size + k) * input_channels + c] =
+            filter_data[(m * input_channels + c) * kernel_size + k];
+      }
+    }
+  }
+
+  TensorProto nhwc_conv_W_tensor_proto;
+  nhwc_conv_W_tensor_proto.set_data_type(TensorProto_DataType_FLOAT16);
+  nhwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("nhwc"));
+  nhwc_conv_W_tensor_proto.set_raw_data(reordered_filter.data(), reordered_filter.size() * sizeof(uint16_t));
+  for (int64_t dim : {dims[0], dims[2], dims[3], dims[1]}) {
+    nhwc_conv_W_tensor_proto.add_dims(dim);
+  }
+  graph_.AddInitializedTensor(nhwc_conv_W_tensor_proto);
+
+  auto* nhwc_conv_W_arg = &graph_.GetOrCreateNodeArg(nhwc_conv_W_tensor_proto.name(), nullptr);
+  nhwc_filters_.emplace(filter, nhwc_conv_W_arg);
+  return nhwc_conv_W_arg;
+}
+
+// A Conv or FusedConv starts an NHWC region, or extends it if its input is already NHWC.
+void CudaNhwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  if (!IsFloat16Tensor(*input_defs[0]) ||
+      (LookupNhwcArgument(input_defs[0]) == nullptr && !Has4DShape(*input_defs[0]))) {
+    return;
+  }
+
+  // Require that the weights tensor be static.
+  const TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+      !graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      (conv_W_tensor_proto->data_type() != TensorProto_DataType_FLOAT16) ||
+      (conv_W_tensor_proto->dims_size() != 4)) {
+    return;
+  }
+
+  // The residual input of a FusedConv must be 4-D as well to be transposed.
+  const bool has_z = input_defs.size() >= 4 && input_defs[3]->Exists();
+  if (has_z && LookupNhwcArgument(input_defs[3]) == nullptr && !Has4DShape(*input_defs[3])) {
+    return;
+  }
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(node.Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "NhwcConv",
+                                   nhwc_node_name,
+                                   input_defs,
+                                   node.MutableOutputDefs(),
+                                   &node.GetAttributes(),
+                                   kMSDomain);
+  nhwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  auto& nhwc_input_defs = nhwc_node.MutableInputDefs();
+  nhwc_input_defs[0] = GetNhwcInput(input_defs[0], node);
+  nhwc_input_defs[1] = GetNhwcFilter(input_defs[1], *conv_W_tensor_proto);
+  if (has_z) {
+    nhwc_input_defs[3] = GetNhwcInput(input_defs[3], node);
+  }
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void CudaNhwcTransformerImpl::TransformPool(Node& node) {
+  auto* nhwc_input = LookupNhwcArgument(node.MutableInputDefs()[0]);
+  const std::string op_type = GetNhwcPoolOpType(node);
+  if (nhwc_input == nullptr || op_type.empty()) {
+    return;
+  }
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(node.Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   op_type,
+                                   nhwc_node_name,
+                                   {UseNhwcArgument(*nhwc_input)},
+                                   {node.MutableOutputDefs()[0]},
+                                   nullptr,
+                                   kMSDomain);
+  for (const char* name : {"auto_pad", "kernel_shape", "pads", "strides", "ceil_mode", "count_include_pad"}) {
+    const auto* attr = graph_utils::GetNodeAttribute(node, name);
+    if (attr != nullptr) {
+      nhwc_node.AddAttribute(name, *attr);
+    }
+  }
+  nhwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void CudaNhwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified, or normalizes per activation.
+  for (size_t i = 1; i < output_defs.size(); i++) {
+    if (output_defs[i]->Exists()) {
+      return;
+    }
+  }
+  const auto* spatial_attr = graph_utils::GetNodeAttribute(node, "spatial");
+  if (spatial_attr != nullptr && utils::HasInt(*spatial_attr) && spatial_attr->i() != 1) {
+    return;
+  }
+
+  auto* nhwc_input = LookupNhwcArgument(input_defs[0]);
+  if (nhwc_input == nullptr) {
+    return;
+  }
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(node.Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "NhwcBatchNormalization",
+                                   nhwc_node_name,
+                                   {UseNhwcArgument(*nhwc_input), input_defs[1], input_defs[2], input_defs[3],
+                                    input_defs[4]},
+                                   {output_defs[0]},
+                                   nullptr,
+                                   kMSDomain);
+  const auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr) {
+    nhwc_node.AddAttribute("epsilon", *epsilon_attr);
+  }
+  nhwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Element-wise activations compute NHWC tensors as they are, so the node is kept and reads the NHWC input.
+void CudaNhwcTransformerImpl::TransformActivation(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto* nhwc_input = LookupNhwcArgument(input_defs[0]);
+  if (nhwc_input != nullptr) {
+    input_defs[0] = UseNhwcArgument(*nhwc_input);
+    CreateNhwcArgument(node, node);
+  }
+}
+
+// Add and Sum compute NHWC tensors as they are if the inputs all have the same shape, without broadcasting.
+void CudaNhwcTransformerImpl::TransformAdd(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  std::vector<NhwcArgument*> nhwc_inputs;
+  nhwc_inputs.reserve(input_defs.size());
+  for (size_t i = 0; i < input_defs.size(); i++) {
+    auto* nhwc_input = LookupNhwcArgument(input_defs[i]);
+    if (nhwc_input == nullptr || !HaveSameShape(*input_defs[0], *input_defs[i])) {
+      return;
+    }
+    nhwc_inputs.push_back(nhwc_input);
+  }
+
+  for (size_t i = 0; i < input_defs.size(); i++) {
+    input_defs[i] = UseNhwcArgument(*nhwc_inputs[i]);
+  }
+  CreateNhwcArgument(node, node);
+}
+
+// A Concat of NHWC tensors along the channels concatenates them along their last axis.
+void CudaNhwcTransformerImpl::TransformConcat(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr) || (axis_attr->i() != 1 && axis_attr->i() != -3)) {
+    return;
+  }
+
+  std::vector<NhwcArgument*> nhwc_inputs;
+  nhwc_inputs.reserve(input_defs.size());
+  for (auto* input_def : input_defs) {
+    auto* nhwc_input = LookupNhwcArgument(input_def);
+    if (nhwc_input == nullptr) {
+      return;
+    }
+    nhwc_inputs.push_back(nhwc_input);
+  }
+
+  for (size_t i = 0; i < input_defs.size(); i++) {
+    input_defs[i] = UseNhwcArgument(*nhwc_inputs[i]);
+  }
+  node.AddAttribute("axis", static_cast<int64_t>(3));
+  CreateNhwcArgument(node, node);
+}
+
+void CudaNhwcTransformerImpl::Transform(Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
+    TransformConv(node);
+  } else if (node.GetInputEdgesCount() == 0 && node.InputDefs().size() != 0) {
+    // The following transforms only extend NHWC regions, and only run when the input edge count has already been
+    // decremented to zero by earlier transforms. This is a hint that the node may already have all inputs converted
+    // to NHWC format and avoids doing extra string checks for nodes unrelated to this transformer.
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1})) {
+      TransformPool(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
+      TransformActivation(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8})) {
+      TransformAdd(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
+      TransformConcat(node);
+    }
+  }
+
+  // The node may not match any of the checks above, but may still use an input produced by an NHWC node.
+  // Finalize() transposes these inputs back to NCHW.
+}
+
+void CudaNhwcTransformerImpl::Finalize(bool& modified) {
+  // Transpose the NHWC outputs that still have uses in the NCHW layout back to their original NodeArg.
+  for (auto& nhwc_output : nhwc_args_) {
+    if (nhwc_output.second.remaining_original_uses_ > 0) {
+      Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("TransposeToNchw"),
+                                            "Transpose",
+                                            "Transpose to NCHW",
+                                            {nhwc_output.second.nhwc_arg_},
+                                            {nhwc_output.first});
+      transpose_node.AddAttribute("perm", kNhwcToNchwPerm);
+      transpose_node.SetExecutionProviderType(kCudaExecutionProvider);
+    }
+  }
+
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  if (!removed_nodes_.empty()) {
+    modified = true;
+  }
+}
+
+Status CudaNhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  CudaNhwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+    if (node.GetExecutionProviderType() == kCudaExecutionProvider) {
+      impl.Transform(node);
+    }
+  }
+  impl.Finalize(modified);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class CudaNhwcTransformer
+
+Transformer that runs the float16 convolutional parts of the graph assigned to the CUDA execution provider in the
+NHWC layout, the layout of the Tensor Core convolutions of cuDNN, so cuDNN doesn't transpose the tensors of each
+convolution. A Conv is replaced with an NhwcConv whose weight is reordered statically, and the pooling,
+BatchNormalization, element-wise and Concat nodes reading its NHWC output follow in the NHWC layout too. Transposes
+are only inserted where an NHWC region begins and where its values are read in the NCHW layout.
+*/
+class CudaNhwcTransformer : public GraphTransformer {
+ public:
+  CudaNhwcTransformer() noexcept : GraphTransformer("CudaNhwcTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include <unordered_set>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Returns the only consumer of the output of node if it has the same provider, or nullptr.
+const Node* GetSingleConsumer(const Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node) ||
+      node.OutputNodesBegin()->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return &*node.OutputNodesBegin();
+}
+
+// Returns the node producing the input_index-th input of node, or nullptr.
+const Node* GetInputNode(const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+// Returns the other input of a binary node than arg.
+NodeArg* GetOtherInput(Node& node, const NodeArg* arg) {
+  auto& inputs = node.MutableInputDefs();
+  return inputs[0] == arg ? inputs[1] : inputs[0];
+}
+
+// Returns true if the scale or zero point of the weight holds a single value or one value per column of the 2-D weight.
+bool IsPerTensorOrColumn(const NodeArg& arg, const NodeArg& weight) {
+  const TensorShapeProto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() > 1) {
+    return false;
+  }
+  if (shape->dim_size() == 0) {
+    return true;
+  }
+  const TensorShapeProto* weight_shape = weight.Shape();
+  return shape->dim(0).has_dim_value() &&
+         (shape->dim(0).dim_value() == 1 ||
+          (weight_shape != nullptr && weight_shape->dim_size() == 2 && weight_shape->dim(1).has_dim_value() &&
+           weight_shape->dim(1).dim_value() == shape->dim(0).dim_value()));
+}
+
+// Returns true if bias is a 1-D constant initializer with one value per column of the 2-D weight.
+bool IsBias(const Graph& graph, const NodeArg& bias, const NodeArg& weight) {
+  const auto* bias_proto = graph_utils::GetConstantInitializer(graph, bias.Name());
+  const TensorShapeProto* weight_shape = weight.Shape();
+  return bias_proto != nullptr && bias_proto->data_type() == TensorProto_DataType_FLOAT &&
+         bias_proto->dims_size() == 1 && weight_shape != nullptr && weight_shape->dim_size() == 2 &&
+         weight_shape->dim(1).has_dim_value() && weight_shape->dim(1).dim_value() == bias_proto->dims(0);
+}
+}  // namespace
+
+Status DynamicQuantizeMatMulFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::unordered_set<onnxruntime::NodeIndex> quantize_nodes;
+  for (auto index : order) {
+    auto& matmul = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(matmul, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMulInteger", {10}) ||
+        !graph_utils::IsSupportedProvider(matmul, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the input and its zero point come from a DynamicQuantizeLinear, the weight is uint8
+    auto& matmul_inputs = matmul.MutableInputDefs();
+    const Node* quantize = GetInputNode(matmul, 0);
+    if (quantize == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*quantize, "DynamicQuantizeLinear", {11}) ||
+        quantize->GetExecutionProviderType() != matmul.GetExecutionProviderType() ||
+        matmul_inputs.size() < 3 || matmul_inputs[2] != quantize->OutputDefs()[2] ||
+        matmul_inputs[1]->Type() == nullptr || *matmul_inputs[1]->Type() != "tensor(uint8)") {
+      continue;
+    }
+
+    const Node* cast = GetSingleConsumer(graph, matmul);
+    if (cast == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*cast, "Cast", {6, 9})) {
+      continue;
+    }
+    const auto* to_attr = graph_utils::GetNodeAttribute(*cast, "to");
+    if (to_attr == nullptr || to_attr->i() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    // the result is multiplied by input_scale * weight_scale
+    const Node* mul = GetSingleConsumer(graph, *cast);
+    if (mul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", {7})) {
+      continue;
+    }
+    const Node* scale_mul = GetInputNode(*mul, mul->InputDefs()[0] == cast->OutputDefs()[0] ? 1 : 0);
+    if (scale_mul == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*scale_mul, "Mul", {7}) ||
+        GetSingleConsumer(graph, *scale_mul) != mul) {
+      continue;
+    }
+    const NodeArg* input_scale = quantize->OutputDefs()[1];
+    auto& scale_inputs = const_cast<Node*>(scale_mul)->MutableInputDefs();
+    if (scale_inputs[0] != input_scale && scale_inputs[1] != input_scale) {
+      continue;
+    }
+    NodeArg* weight_scale = GetOtherInput(*const_cast<Node*>(scale_mul), input_scale);
+    if (weight_scale == input_scale || !IsPerTensorOrColumn(*weight_scale, *matmul_inputs[1]) ||
+        (matmul_inputs.size() > 3 && matmul_inputs[3]->Exists() &&
+         !IsPerTensorOrColumn(*matmul_inputs[3], *matmul_inputs[1]))) {
+      continue;
+    }
+
+    // an optional Add of a bias
+    const Node* add = GetSingleConsumer(graph, *mul);
+    NodeArg* bias = nullptr;
+    if (add != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*add, "Add", {7})) {
+      bias = GetOtherInput(*const_cast<Node*>(add), mul->OutputDefs()[0]);
+      if (!IsBias(graph, *bias, *matmul_inputs[1])) {
+        add = nullptr;
+        bias = nullptr;
+      }
+    } else {
+      add = nullptr;
+    }
+
+    std::vector<NodeArg*> fused_inputs{const_cast<Node*>(quantize)->MutableInputDefs()[0], matmul_inputs[1],
+                                       weight_scale};
+    if (matmul_inputs.size() > 3 && matmul_inputs[3]->Exists()) {
+      fused_inputs.push_back(matmul_inputs[3]);
+    } else if (bias != nullptr) {
+      fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+    }
+    if (bias != nullptr) {
+      fused_inputs.push_back(bias);
+    }
+
+    Node& last = *const_cast<Node*>(add != nullptr ? add : mul);
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("fused " + matmul.Name()), "DynamicQuantizeMatMul",
+                                     "fused MatMulInteger " + matmul.Name() + " with its dynamic quantization",
+                                     fused_inputs,
+                                     last.MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(matmul.GetExecutionProviderType());
+
+    std::vector<const Node*> fused_nodes{&matmul, cast, scale_mul, mul};
+    if (add != nullptr) {
+      fused_nodes.push_back(add);
+    }
+    for (const Node* node : fused_nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *const_cast<Node*>(node));
+      removed_nodes.push_front(node->Index());
+    }
+    quantize_nodes.insert(quantize->Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  // a DynamicQuantizeLinear only feeding fused nodes is no longer needed
+  for (auto quantize_index : quantize_nodes) {
+    const Node* quantize = graph.GetNode(quantize_index);
+    if (quantize->GetOutputEdgesCount() == 0 && !graph.IsNodeOutputsInGraphOutputs(*quantize)) {
+      graph.RemoveNode(quantize_index);
+    }
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
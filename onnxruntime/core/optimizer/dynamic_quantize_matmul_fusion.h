@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeMatMulFusion
+
+Fuses the MatMul of a dynamically quantized model into a DynamicQuantizeMatMul node: the DynamicQuantizeLinear of
+the input, the MatMulInteger with the uint8 weight, the Cast of its int32 result to float, the Mul by the product
+of the scales of the input and the weight, and an optional following Add of a 1-D constant bias.
+The DynamicQuantizeLinear is removed once all the MatMulInteger nodes using it are fused.
+*/
+class DynamicQuantizeMatMulFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeMatMulFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeMatMulFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/elementwise_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+bool IsFusableBinaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7});
+}
+
+bool IsFusableUnaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6});
+}
+
+// Conv, Gemm and MatMul have their own fusions with a following Add, Mul or activation, which
+// should not be taken over by an element-wise chain.
+bool HasFusableProducer(const Node& node) {
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    const Node& producer = *it;
+    if (producer.OpType() == "Conv" || producer.OpType() == "FusedConv" ||
+        producer.OpType() == "Gemm" || producer.OpType() == "MatMul") {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  return arg.Type() != nullptr && *arg.Type() == "tensor(float)";
+}
+
+// Returns true if both shapes are known to be the same, either from dimension values or symbolic dimensions.
+bool HaveSameShape(const TensorShapeProto* shape1, const TensorShapeProto* shape2) {
+  if (shape1 == nullptr || shape2 == nullptr || shape1->dim_size() != shape2->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape1->dim_size(); i++) {
+    const auto& dim1 = shape1->dim(i);
+    const auto& dim2 = shape2->dim(i);
+    if (dim1.has_dim_value() && dim2.has_dim_value()) {
+      if (dim1.dim_value() != dim2.dim_value()) {
+        return false;
+      }
+    } else if (!dim1.has_dim_param() || !dim2.has_dim_param() || dim1.dim_param().empty() ||
+               dim1.dim_param() != dim2.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if the shape has a single element and broadcasting it does not add dimensions to the output.
+bool IsScalarOf(const TensorShapeProto* shape, const TensorShapeProto* output_shape) {
+  if (shape == nullptr || shape->dim_size() > output_shape->dim_size()) {
+    return false;
+  }
+
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsFusableOperand(const NodeArg& operand, const TensorShapeProto* output_shape) {
+  return IsFloatTensor(operand) &&
+         (HaveSameShape(operand.Shape(), output_shape) || IsScalarOf(operand.Shape(), output_shape));
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::unordered_set<onnxruntime::NodeIndex> fused_nodes;
+  for (auto index : order) {
+    auto* node = graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (fused_nodes.count(index) != 0 ||
+        !(IsFusableBinaryOp(*node) || IsFusableUnaryOp(*node)) ||
+        !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        HasFusableProducer(*node)) {
+      continue;
+    }
+
+    // The first input of the chain determines the shape of every value in the chain.
+    auto& start_inputs = node->MutableInputDefs();
+    const TensorShapeProto* shape = start_inputs[0]->Shape();
+    if (!IsFloatTensor(*start_inputs[0]) || shape == nullptr) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs{start_inputs[0]};
+    std::vector<std::string> fused_ops{node->OpType()};
+    std::vector<NodeIndex> chain{index};
+    if (IsFusableBinaryOp(*node)) {
+      if (!IsFusableOperand(*start_inputs[1], shape)) {
+        continue;
+      }
+      fused_inputs.push_back(start_inputs[1]);
+    }
+
+    const Node* last = node;
+    while (last->GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(*last)) {
+      const Node& next = *(last->OutputNodesBegin());
+      if (next.GetExecutionProviderType() != node->GetExecutionProviderType() ||
+          fused_nodes.count(next.Index()) != 0) {
+        break;
+      }
+
+      if (IsFusableBinaryOp(next)) {
+        // Only Add and Mul can take the running value as their second operand.
+        const auto& next_inputs = next.InputDefs();
+        const NodeArg* value = last->OutputDefs()[0];
+        int operand_index;
+        if (next_inputs[0] == value) {
+          operand_index = 1;
+        } else if (next.OpType() == "Add" || next.OpType() == "Mul") {
+          operand_index = 0;
+        } else {
+          break;
+        }
+
+        NodeArg* operand = const_cast<Node&>(next).MutableInputDefs()[operand_index];
+        if (!IsFusableOperand(*operand, shape)) {
+          break;
+        }
+        fused_inputs.push_back(operand);
+      } else if (!IsFusableUnaryOp(next)) {
+        break;
+      }
+
+      fused_ops.push_back(next.OpType());
+      chain.push_back(next.Index());
+      last = &next;
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("fused " + node->Name()), "FusedElementwise",
+                                     "fused element-wise chain starting at " + node->Name(),
+                                     fused_inputs,
+                                     const_cast<Node*>(last)->MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    fused_node.AddAttribute("ops", fused_ops);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node->GetExecutionProviderType());
+
+    for (auto chain_index : chain) {
+      fused_nodes.insert(chain_index);
+      removed_nodes.push_front(chain_index);
+    }
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuses chains of element-wise operators, e.g. Mul -> Add -> Relu, into a single FusedElementwise
+node that evaluates the whole chain in one pass over memory. Each binary operator in the chain
+must take the running value as its first operand (either operand for Add and Mul), and its other
+operand must have the same shape as the running value or contain a single element.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
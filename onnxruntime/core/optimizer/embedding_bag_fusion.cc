@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Returns true if the weights hold one value per index: the shape of the indices followed by
+// data_rank - 1 dimensions of 1, so each gathered row is scaled by a single weight.
+bool IsPerSampleWeight(const NodeArg& weights, const TensorShapeProto& indices_shape, int data_rank) {
+  const TensorShapeProto* shape = weights.Shape();
+  if (shape == nullptr || weights.Type() == nullptr || *weights.Type() != "tensor(float)" ||
+      shape->dim_size() != indices_shape.dim_size() + data_rank - 1) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    if (i >= indices_shape.dim_size()) {
+      if (!dim.has_dim_value() || dim.dim_value() != 1) {
+        return false;
+      }
+      continue;
+    }
+
+    const auto& indices_dim = indices_shape.dim(i);
+    if (dim.has_dim_value() && indices_dim.has_dim_value()) {
+      if (dim.dim_value() != indices_dim.dim_value()) {
+        return false;
+      }
+    } else if (!dim.has_dim_param() || dim.dim_param().empty() || dim.dim_param() != indices_dim.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& gather = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(gather, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather, "Gather", {1}) ||
+        !graph_utils::IsSupportedProvider(gather, GetCompatibleExecutionProviders()) ||
+        !graph_utils::HasSingleConsumer(graph, gather)) {
+      continue;
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(gather, "axis");
+    if (axis_attr != nullptr && axis_attr->i() != 0) {
+      continue;
+    }
+
+    NodeArg* data = gather.MutableInputDefs()[0];
+    NodeArg* indices = gather.MutableInputDefs()[1];
+    if (data->Type() == nullptr || *data->Type() != "tensor(float)" ||
+        data->Shape() == nullptr || data->Shape()->dim_size() < 1 ||
+        indices->Shape() == nullptr || indices->Shape()->dim_size() < 1) {
+      continue;
+    }
+    const TensorShapeProto& indices_shape = *indices->Shape();
+    const int data_rank = data->Shape()->dim_size();
+
+    // An optional Mul scaling each gathered row by its own weight.
+    const Node* next = &*gather.OutputNodesBegin();
+    const Node* mul = nullptr;
+    NodeArg* weights = nullptr;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*next, "Mul", {7})) {
+      if (!graph_utils::HasSingleConsumer(graph, *next)) {
+        continue;
+      }
+      const NodeArg* gathered = gather.OutputDefs()[0];
+      auto& mul_inputs = const_cast<Node*>(next)->MutableInputDefs();
+      weights = mul_inputs[0] == gathered ? mul_inputs[1] : mul_inputs[0];
+      if (weights == gathered || !IsPerSampleWeight(*weights, indices_shape, data_rank)) {
+        continue;
+      }
+      mul = next;
+      next = &*next->OutputNodesBegin();
+    }
+
+    // The reduction must remove the last dimension of the indices and nothing else.
+    const Node& reduce = *next;
+    if (!(graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceSum", {1}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceMean", {1}))) {
+      continue;
+    }
+
+    const auto* keepdims_attr = graph_utils::GetNodeAttribute(reduce, "keepdims");
+    std::vector<int64_t> axes;
+    if (keepdims_attr == nullptr || keepdims_attr->i() != 0 ||
+        !graph_utils::GetRepeatedNodeAttributeValues(reduce, "axes", axes) || axes.size() != 1) {
+      continue;
+    }
+
+    const int64_t reduced_rank = indices_shape.dim_size() + data_rank - 1;
+    const int64_t axis = axes[0] < 0 ? axes[0] + reduced_rank : axes[0];
+    if (axis != indices_shape.dim_size() - 1) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs{data, indices};
+    if (weights != nullptr) {
+      fused_inputs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      fused_inputs.push_back(weights);
+    }
+
+    Node& embedding_bag = graph.AddNode(graph.GenerateNodeName("fused " + gather.Name()), "EmbeddingBag",
+                                        "fused Gather " + gather.Name() + " with " + reduce.OpType(),
+                                        fused_inputs,
+                                        const_cast<Node&>(reduce).MutableOutputDefs(),
+                                        nullptr,
+                                        kMSDomain);
+    embedding_bag.AddAttribute("mode", reduce.OpType() == "ReduceMean" ? std::string("mean") : std::string("sum"));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag.SetExecutionProviderType(gather.GetExecutionProviderType());
+
+    removed_nodes.push_front(gather.Index());
+    if (mul != nullptr) {
+      removed_nodes.push_front(mul->Index());
+    }
+    removed_nodes.push_front(reduce.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
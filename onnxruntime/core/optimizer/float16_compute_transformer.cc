@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/float16_compute_transformer.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/util/math.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// Ops bound by compute, which are converted whenever they have a float16 kernel, as Tensor Cores speed them up.
+bool IsComputeBoundOp(const Node& node) {
+  static const std::unordered_set<std::string> op_types = {"Conv", "ConvTranspose", "Gemm", "MatMul"};
+  if (graph_utils::MatchesOpSetDomain(node, kMSDomain)) {
+    return node.OpType() == "FusedConv" || node.OpType() == "FusedGemm";
+  }
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) && op_types.count(node.OpType()) != 0;
+}
+
+// Ops that don't lose precision in float16, which follow the precision of their inputs to save casts.
+bool IsPrecisionNeutralOp(const Node& node) {
+  static const std::unordered_set<std::string> op_types = {
+      "Abs", "Add", "AveragePool", "Concat", "Dropout", "Elu", "Expand", "Flatten", "Gather",
+      "GlobalAveragePool", "GlobalMaxPool", "HardSigmoid", "Identity", "LeakyRelu", "Max", "MaxPool", "Min",
+      "Mul", "Neg", "PRelu", "Relu", "Reshape", "Resize", "Selu", "Sigmoid", "Split", "Squeeze", "Sub", "Sum",
+      "Tanh", "Tile", "Transpose", "Unsqueeze", "Upsample"};
+  if (graph_utils::MatchesOpSetDomain(node, kMSDomain)) {
+    return node.OpType() == "Gelu";
+  }
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) && op_types.count(node.OpType()) != 0;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() && type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+const std::string& GetTypeStr(const std::vector<OpSchema::FormalParameter>& params, size_t index) {
+  // the last parameter may be variadic
+  return params[std::min(index, params.size() - 1)].GetTypeStr();
+}
+
+// Collects the inputs and outputs of node bound to the type of its first input, which is the type it computes in.
+// Returns false if any of them isn't float.
+bool GetComputeArgs(const Node& node, std::vector<size_t>& inputs, std::vector<size_t>& outputs) {
+  const auto* schema = node.Op();
+  if (schema == nullptr || schema->inputs().empty() || schema->outputs().empty()) {
+    return false;
+  }
+
+  const auto& type_str = schema->inputs()[0].GetTypeStr();
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 0; i < input_defs.size(); ++i) {
+    if (!input_defs[i]->Exists() || GetTypeStr(schema->inputs(), i) != type_str) {
+      continue;
+    }
+    if (!IsFloatTensor(*input_defs[i])) {
+      return false;
+    }
+    inputs.push_back(i);
+  }
+
+  const auto& output_defs = node.OutputDefs();
+  for (size_t i = 0; i < output_defs.size(); ++i) {
+    if (!output_defs[i]->Exists() || GetTypeStr(schema->outputs(), i) != type_str) {
+      continue;
+    }
+    if (!IsFloatTensor(*output_defs[i])) {
+      return false;
+    }
+    outputs.push_back(i);
+  }
+
+  return !inputs.empty();
+}
+
+NodeArg& CreateFloat16Arg(Graph& graph, const NodeArg& arg) {
+  TypeProto type(*arg.TypeAsProto());
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_fp16"), &type);
+}
+
+void AddCast(Graph& graph, NodeArg& input, NodeArg& output, TensorProto_DataType to, const std::string& provider) {
+  Node& cast = graph.AddNode(graph.GenerateNodeName(output.Name() + "_cast"), "Cast",
+                             "cast for float16 compute", {&input}, {&output});
+  cast.AddAttribute("to", static_cast<int64_t>(to));
+  cast.SetExecutionProviderType(provider);
+}
+
+// Makes float16_arg the float16 copy of the float value arg, by converting it if it is a constant initializer, or
+// casting it otherwise.
+void AddFloat16Producer(Graph& graph, NodeArg& arg, NodeArg& float16_arg, const std::string& provider) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr) {
+    AddCast(graph, arg, float16_arg, TensorProto_DataType_FLOAT16, provider);
+    return;
+  }
+
+  Initializer initializer{tensor_proto};
+  const float* data = initializer.data<float>();
+  std::string raw_data(static_cast<size_t>(initializer.size()) * sizeof(uint16_t), '\0');
+  auto* float16_data = reinterpret_cast<uint16_t*>(&raw_data[0]);
+  for (int64_t i = 0; i < initializer.size(); ++i) {
+    float16_data[i] = math::floatToHalf(data[i]);
+  }
+
+  TensorProto float16_tensor_proto;
+  float16_tensor_proto.set_name(float16_arg.Name());
+  float16_tensor_proto.set_data_type(TensorProto_DataType_FLOAT16);
+  float16_tensor_proto.mutable_dims()->CopyFrom(tensor_proto->dims());
+  float16_tensor_proto.set_raw_data(std::move(raw_data));
+  graph.AddInitializedTensor(float16_tensor_proto);
+}
+}  // namespace
+
+Status Float16ComputeTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the float16 copies of float values, and the float outputs of the converted nodes, which now produce them.
+  std::unordered_map<const NodeArg*, NodeArg*> float16_args;
+  std::vector<std::pair<NodeArg*, const std::string*>> converted_outputs;
+
+  for (auto index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    const bool compute_bound = IsComputeBoundOp(*node);
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        (!compute_bound && !IsPrecisionNeutralOp(*node)) || !GetComputeArgs(*node, inputs, outputs)) {
+      continue;
+    }
+
+    auto& input_defs = node->MutableInputDefs();
+    auto& output_defs = node->MutableOutputDefs();
+    if (!compute_bound && std::none_of(inputs.cbegin(), inputs.cend(), [&](size_t i) {
+          return float16_args.count(input_defs[i]) != 0;
+        })) {
+      continue;
+    }
+
+    // switch the node to float16 values and keep it only if the provider has a float16 kernel for it
+    const auto original_input_defs = input_defs;
+    const auto original_output_defs = output_defs;
+    std::vector<size_t> new_inputs;
+    for (auto i : inputs) {
+      auto it = float16_args.find(input_defs[i]);
+      if (it != float16_args.end()) {
+        input_defs[i] = it->second;
+      } else {
+        input_defs[i] = &CreateFloat16Arg(graph, *input_defs[i]);
+        new_inputs.push_back(i);
+      }
+    }
+    for (auto i : outputs) {
+      output_defs[i] = &CreateFloat16Arg(graph, *output_defs[i]);
+    }
+
+    if (!registry_manager_.HasImplementationOf(*node, node->GetExecutionProviderType())) {
+      input_defs = original_input_defs;
+      output_defs = original_output_defs;
+      continue;
+    }
+
+    for (auto i : new_inputs) {
+      // a value read by several inputs of the node is converted once
+      auto it = float16_args.find(original_input_defs[i]);
+      if (it != float16_args.end()) {
+        input_defs[i] = it->second;
+        continue;
+      }
+      AddFloat16Producer(graph, *original_input_defs[i], *input_defs[i], node->GetExecutionProviderType());
+      float16_args[original_input_defs[i]] = input_defs[i];
+    }
+    for (auto i : outputs) {
+      float16_args[original_output_defs[i]] = output_defs[i];
+      converted_outputs.emplace_back(original_output_defs[i], &node->GetExecutionProviderType());
+    }
+    modified = true;
+  }
+
+  if (converted_outputs.empty()) {
+    return Status::OK();
+  }
+
+  // the float outputs of converted nodes that are still read, by graph outputs, nodes left in float or subgraphs,
+  // are cast back from float16.
+  std::unordered_set<const NodeArg*> float_reads(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+  for (const auto& node : graph.Nodes()) {
+    float_reads.insert(node.InputDefs().cbegin(), node.InputDefs().cend());
+    float_reads.insert(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+  }
+
+  for (const auto& output : converted_outputs) {
+    if (float_reads.count(output.first) != 0) {
+      AddCast(graph, *float16_args[output.first], *output.first, TensorProto_DataType_FLOAT, *output.second);
+    }
+  }
+
+  graph.SetGraphResolveNeeded();
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class Float16ComputeTransformer
+
+Transformer that runs the float nodes assigned to the compatible execution providers in float16, where they have
+float16 kernels. The ops that are bound by compute, such as Conv and MatMul, are always converted, while the ops that
+don't lose precision in float16, such as Relu or Reshape, are converted when they read values already in float16.
+Other ops, such as the reductions and Softmax, stay in float. Cast nodes are inserted where float and float16 values
+meet, and float initializers read by the converted nodes are converted once at load time.
+*/
+class Float16ComputeTransformer : public GraphTransformer {
+ public:
+  Float16ComputeTransformer(const KernelRegistryManager& registry_manager,
+                            const std::unordered_set<std::string>& compatible_execution_providers)
+      : GraphTransformer("Float16ComputeTransformer", compatible_execution_providers),
+        registry_manager_{registry_manager} {}
+
+ private:
+  common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  const KernelRegistryManager& registry_manager_;
+};
+
+}  // namespace onnxruntime
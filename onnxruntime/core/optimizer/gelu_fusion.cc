@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/gelu_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The CPU kernel is implemented for float and the CUDA kernel for float, float16 and double.
+bool IsSupportedType(const NodeArg& arg, const std::string& provider) {
+  return arg.Type() != nullptr &&
+         (*arg.Type() == "tensor(float)" ||
+          (provider == kCudaExecutionProvider &&
+           (*arg.Type() == "tensor(float16)" || *arg.Type() == "tensor(double)")));
+}
+
+// Returns true if arg is a constant initializer holding a single value within a float16 rounding of expected.
+bool IsScalarConstant(const Graph& graph, const NodeArg& arg, float expected) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || !Initializer::IsSupportedDataType(tensor_proto)) {
+    return false;
+  }
+
+  Initializer initializer(tensor_proto);
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  float value;
+  switch (initializer.data_type()) {
+    case TensorProto_DataType_FLOAT:
+      value = *initializer.data<float>();
+      break;
+    case TensorProto_DataType_DOUBLE:
+      value = static_cast<float>(*initializer.data<double>());
+      break;
+    case TensorProto_DataType_FLOAT16:
+      value = math::halfToFloat(*initializer.data<uint16_t>());
+      break;
+    default:
+      return false;
+  }
+  return std::abs(value - expected) <= 1e-3f * std::abs(expected);
+}
+
+// Returns the input of a binary node other than input, or nullptr if input is not one of them.
+const NodeArg* OtherInput(const Node& node, const NodeArg* input) {
+  const auto& inputs = node.InputDefs();
+  if (inputs[0] == input) {
+    return inputs[1];
+  }
+  return inputs[1] == input ? inputs[0] : nullptr;
+}
+
+// Returns the node producing arg among the inputs of node, or nullptr if arg is not produced by a node.
+const Node* GetProducer(const Node& node, const NodeArg* arg) {
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    for (const NodeArg* output : it->OutputDefs()) {
+      if (output == arg) {
+        return &*it;
+      }
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+Status GeluFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  constexpr float kSqrt2 = 1.41421356f;
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& div = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(div, modified, graph_level));
+
+    // X / sqrt(2), or X * (1 / sqrt(2)) once the division has been folded.
+    const auto& div_inputs = div.InputDefs();
+    if (!graph_utils::IsSupportedProvider(div, GetCompatibleExecutionProviders()) ||
+        !graph_utils::HasSingleConsumer(graph, div) ||
+        !((graph_utils::IsSupportedOptypeVersionAndDomain(div, "Div", {7}) &&
+           IsScalarConstant(graph, *div_inputs[1], kSqrt2)) ||
+          (graph_utils::IsSupportedOptypeVersionAndDomain(div, "Mul", {7}) &&
+           IsScalarConstant(graph, *div_inputs[1], 1.0f / kSqrt2)))) {
+      continue;
+    }
+
+    const std::string& provider = div.GetExecutionProviderType();
+    NodeArg* x = div.MutableInputDefs()[0];
+    if (!IsSupportedType(*x, provider)) {
+      continue;
+    }
+
+    const Node& erf = *div.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(erf, "Erf", {9}) ||
+        !graph_utils::HasSingleConsumer(graph, erf)) {
+      continue;
+    }
+
+    const Node& add = *erf.OutputNodesBegin();
+    const NodeArg* one = OtherInput(add, erf.OutputDefs()[0]);
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add, "Add", {7}) ||
+        one == nullptr || !IsScalarConstant(graph, *one, 1.0f) || !graph_utils::HasSingleConsumer(graph, add)) {
+      continue;
+    }
+
+    // Either (X * (1 + erf)) * 0.5 or (X * 0.5) * (1 + erf).
+    const Node& mul = *add.OutputNodesBegin();
+    const NodeArg* other = OtherInput(mul, add.OutputDefs()[0]);
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(mul, "Mul", {7}) || other == nullptr) {
+      continue;
+    }
+
+    const Node* half = nullptr;
+    const Node* last = &mul;
+    if (other == x) {
+      if (!graph_utils::HasSingleConsumer(graph, mul)) {
+        continue;
+      }
+      half = &*mul.OutputNodesBegin();
+      const NodeArg* half_value = OtherInput(*half, mul.OutputDefs()[0]);
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(*half, "Mul", {7}) ||
+          half_value == nullptr || !IsScalarConstant(graph, *half_value, 0.5f)) {
+        continue;
+      }
+      last = half;
+    } else {
+      half = GetProducer(mul, other);
+      if (half == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*half, "Mul", {7}) ||
+          !graph_utils::HasSingleConsumer(graph, *half)) {
+        continue;
+      }
+      const NodeArg* half_value = OtherInput(*half, x);
+      if (half_value == nullptr || !IsScalarConstant(graph, *half_value, 0.5f)) {
+        continue;
+      }
+    }
+
+    Node& gelu = graph.AddNode(graph.GenerateNodeName("fused " + div.Name()), "Gelu",
+                               "fused Gelu starting at " + div.Name(),
+                               std::vector<NodeArg*>{x},
+                               const_cast<Node*>(last)->MutableOutputDefs(),
+                               nullptr,
+                               kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    gelu.SetExecutionProviderType(provider);
+
+    for (const Node* node : {&static_cast<const Node&>(div), &erf, &add, &mul, half}) {
+      removed_nodes.push_front(node->Index());
+    }
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
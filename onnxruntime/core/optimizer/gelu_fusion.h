@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GeluFusion
+
+Fuses the exact GELU activation, exported as X * 0.5 * (1 + Erf(X / sqrt(2))) with either order of
+the two multiplications, into a Gelu node.
+*/
+class GeluFusion : public GraphTransformer {
+ public:
+  GeluFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GeluFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/gemm_bn_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status GemmBNFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  auto& gemm_node = node;
+  const Node& bn_node = *gemm_node.OutputNodesBegin();
+  const bool is_gemm = gemm_node.OpType() == "Gemm";
+
+  // Get value of attribute epsilon
+  float epsilon = 1e-5f;
+  const auto* epsilon_attr = graph_utils::GetNodeAttribute(bn_node, "epsilon");
+  if (epsilon_attr != nullptr) {
+    if (epsilon_attr->type() != AttributeProto_AttributeType_FLOAT) {
+      return Status::OK();
+    }
+    epsilon = epsilon_attr->f();
+  }
+
+  // Get initializers of BatchNormalization
+  const auto& bn_inputs = bn_node.InputDefs();
+  const auto* bn_scale_tensor_proto = graph_utils::GetConstantInitializer(graph, bn_inputs[1]->Name());
+  ORT_ENFORCE(bn_scale_tensor_proto);
+
+  const auto* bn_B_tensor_proto = graph_utils::GetConstantInitializer(graph, bn_inputs[2]->Name());
+  ORT_ENFORCE(bn_B_tensor_proto);
+
+  const auto* bn_mean_tensor_proto = graph_utils::GetConstantInitializer(graph, bn_inputs[3]->Name());
+  ORT_ENFORCE(bn_mean_tensor_proto);
+
+  const auto* bn_var_tensor_proto = graph_utils::GetConstantInitializer(graph, bn_inputs[4]->Name());
+  ORT_ENFORCE(bn_var_tensor_proto);
+
+  const auto& gemm_inputs = gemm_node.InputDefs();
+  const auto* gemm_W_tensor_proto = graph_utils::GetConstantInitializer(graph, gemm_inputs[1]->Name());
+  ORT_ENFORCE(gemm_W_tensor_proto);
+
+  if (!Initializer::IsSupportedDataType(gemm_W_tensor_proto) || gemm_W_tensor_proto->dims_size() != 2) {
+    return Status::OK();
+  }
+
+  // The channels of BatchNormalization are the output columns, which are the rows of a transposed weight.
+  const auto* trans_B_attr = graph_utils::GetNodeAttribute(gemm_node, "transB");
+  const bool trans_B = is_gemm && trans_B_attr != nullptr && trans_B_attr->i() != 0;
+  const int64_t columns = gemm_W_tensor_proto->dims(trans_B ? 0 : 1);
+
+  for (const auto* tensor_proto : {bn_scale_tensor_proto, bn_B_tensor_proto, bn_mean_tensor_proto, bn_var_tensor_proto}) {
+    if (tensor_proto->data_type() != gemm_W_tensor_proto->data_type() ||
+        tensor_proto->dims_size() != 1 ||
+        tensor_proto->dims(0) != columns) {
+      return Status::OK();
+    }
+  }
+
+  // The folded bias replaces C of a Gemm node, so C must hold one value per column that isn't scaled by beta.
+  const ONNX_NAMESPACE::TensorProto* gemm_C_tensor_proto = nullptr;
+  std::unique_ptr<Initializer> gemm_C = nullptr;
+  if (is_gemm) {
+    gemm_C_tensor_proto = graph_utils::GetConstantInitializer(graph, gemm_inputs[2]->Name());
+    ORT_ENFORCE(gemm_C_tensor_proto);
+
+    const auto* beta_attr = graph_utils::GetNodeAttribute(gemm_node, "beta");
+    if ((beta_attr != nullptr && beta_attr->f() != 1.0f) ||
+        gemm_C_tensor_proto->data_type() != gemm_W_tensor_proto->data_type() ||
+        gemm_C_tensor_proto->dims_size() < 1 ||
+        gemm_C_tensor_proto->dims_size() > 2 ||
+        gemm_C_tensor_proto->dims(gemm_C_tensor_proto->dims_size() - 1) != columns ||
+        (gemm_C_tensor_proto->dims_size() == 2 && gemm_C_tensor_proto->dims(0) != 1)) {
+      return Status::OK();
+    }
+    gemm_C = std::make_unique<Initializer>(gemm_C_tensor_proto);
+  }
+
+  auto bn_scale = std::make_unique<Initializer>(bn_scale_tensor_proto);
+  auto bn_B = std::make_unique<Initializer>(bn_B_tensor_proto);
+  auto bn_mean = std::make_unique<Initializer>(bn_mean_tensor_proto);
+  auto bn_var = std::make_unique<Initializer>(bn_var_tensor_proto);
+  auto gemm_W = std::make_unique<Initializer>(gemm_W_tensor_proto);
+
+  // Calculate new value of initializers of gemm node
+  bn_var->add(epsilon);
+  bn_var->sqrt();
+  bn_scale->div(*bn_var);
+  if (trans_B) {
+    gemm_W->scale_by_axis(*bn_scale, 1);
+  } else {
+    gemm_W->scale_by_last_axis(*bn_scale);
+  }
+
+  ONNX_NAMESPACE::TensorProto new_gemm_W_tensor_proto(*gemm_W_tensor_proto);
+  gemm_W->ToProto(&new_gemm_W_tensor_proto);
+  graph_utils::ReplaceInitializer(graph, gemm_W_tensor_proto->name(), new_gemm_W_tensor_proto);
+
+  if (is_gemm) {
+    gemm_C->sub(*bn_mean);
+    gemm_C->mul(*bn_scale);
+    gemm_C->add(*bn_B);
+
+    ONNX_NAMESPACE::TensorProto new_gemm_C_tensor_proto(*gemm_C_tensor_proto);
+    gemm_C->ToProto(&new_gemm_C_tensor_proto);
+    graph_utils::ReplaceInitializer(graph, gemm_C_tensor_proto->name(), new_gemm_C_tensor_proto);
+
+    // Remove BN node.
+    auto* bn_node_to_remove = graph.GetNode(bn_node.Index());
+    if (graph_utils::RemoveNode(graph, *bn_node_to_remove)) {
+      rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+    }
+    return Status::OK();
+  }
+
+  // MatMul has no bias input, so replace BN with an Add of the folded bias. MatMulAddFusion can later
+  // turn the pair into a single Gemm node.
+  bn_mean->mul(*bn_scale);
+  bn_B->sub(*bn_mean);
+
+  ONNX_NAMESPACE::TensorProto bias_tensor_proto;
+  bn_B->ToProto(&bias_tensor_proto);
+  bias_tensor_proto.set_name(graph.GenerateNodeArgName(bn_node.Name() + "_bias"));
+  graph.AddInitializedTensor(bias_tensor_proto);
+  auto& bias_arg = graph.GetOrCreateNodeArg(bias_tensor_proto.name(), bn_inputs[2]->TypeAsProto());
+
+  auto& bn_node_to_remove = *graph.GetNode(bn_node.Index());
+  Node& add_node = graph.AddNode(graph.GenerateNodeName(bn_node.Name() + "_add"),
+                                 "Add",
+                                 "folded BatchNormalization " + bn_node.Name(),
+                                 {gemm_node.MutableOutputDefs()[0], &bias_arg},
+                                 bn_node_to_remove.MutableOutputDefs());
+  add_node.SetExecutionProviderType(bn_node.GetExecutionProviderType());
+
+  // Move the consumers of BN over to the Add node.
+  std::vector<Node::EdgeEnd> output_edges(bn_node.OutputEdgesBegin(), bn_node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    graph.RemoveEdge(bn_node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    graph.AddEdge(add_node.Index(), edge.GetNode().Index(), 0, edge.GetDstArgIndex());
+  }
+  graph.RemoveNode(bn_node_to_remove.Index());
+  graph.AddEdge(gemm_node.Index(), add_node.Index(), 0, 0);
+
+  rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+  return Status::OK();
+}
+
+bool GemmBNFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+  if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+      node.GetOutputEdgesCount() != 1 || (is_gemm && node.InputDefs().size() != 3)) {
+    return false;
+  }
+
+  // BatchNormalization normalizes the second dimension, which is only the output column dimension if the
+  // MatMul output is a matrix.
+  if (!is_gemm) {
+    const auto* input_shape = node.InputDefs()[0]->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() != 2) {
+      return false;
+    }
+  }
+
+  const auto& next_node = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "BatchNormalization", {7, 9}) ||
+      next_node.GetInputEdgesCount() != 1 || next_node.OutputDefs().size() != 1 ||
+      graph.IsNodeOutputsInGraphOutputs(next_node) ||
+      // Make sure the two nodes do not span execution providers.
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // Check that the appropriate inputs to the Gemm/MatMul and BN nodes are constants.
+  if (!graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[1]) ||
+      (is_gemm && !graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[2])) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[1]) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[2]) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[3]) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[4])) {
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmBNFusion
+
+Rewrite rule that folds a BatchNormalization node into the weights and bias of the preceding Gemm node,
+or into the weights of the preceding two dimensional MatMul node followed by an Add of the folded bias.
+
+It is attempted to be triggered only on nodes with op type "Gemm" or "MatMul".
+*/
+class GemmBNFusion : public RewriteRule {
+ public:
+  GemmBNFusion() noexcept : RewriteRule("GemmBNFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Gemm", "MatMul"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 using namespace onnxruntime;
@@ -8,18 +9,49 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
-common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level) const {
+common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level,
+                                                          profiling::Profiler* profiler) const {
   const auto& transformers = level_to_transformer_map_.find(level);
   if (transformers == level_to_transformer_map_.end()) {
     return Status::OK();
   }
 
+  // The graph version counts the modifications made by the transformers. A transformer that left the graph
+  // unchanged has nothing left to do until another transformer modifies the graph, so it is skipped while
+  // the version is the same as after its last run.
+  size_t graph_version = 0;
+  std::vector<size_t> unchanged_version(transformers->second.size(), std::numeric_limits<size_t>::max());
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < transformers->second.size(); ++i) {
+      if (unchanged_version[i] == graph_version) {
+        continue;
+      }
+
+      const auto& transformer = transformers->second[i];
+      TimePoint start_time;
+      if (profiler != nullptr) {
+        start_time = profiler->StartTime();
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified));
-      graph_changed = graph_changed || modified;
+
+      if (profiler != nullptr) {
+        profiler->RecordInitializationPhase(transformer->Name(), start_time,
+                                            {{"phase", "graph_transformer"},
+                                             {"level", std::to_string(static_cast<uint32_t>(level))},
+                                             {"step", std::to_string(step)},
+                                             {"modified", modified ? "1" : "0"}});
+      }
+
+      if (modified) {
+        ++graph_version;
+        graph_changed = true;
+      } else {
+        unchanged_version[i] = graph_version;
+      }
     }
     if (!graph_changed) {
       break;
@@ -39,4 +71,4 @@ common::Status GraphTransformerManager::Register(std::unique_ptr<GraphTransforme
   level_to_transformer_map_[level].push_back(std::move(transformer));
   return Status::OK();
 }
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -7,16 +7,33 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
+#include "core/optimizer/gemm_bn_fusion.h"
+#include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/optimizer/symbolic_shape_folding.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/conv_activation_fusion.h"
+#include "core/optimizer/conv_add_activation_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/norm_activation_fusion.h"
+#include "core/optimizer/sparse_matmul_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/attention_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/nhwc_pool_transformer.h"
+#include "core/optimizer/cuda_nhwc_transformer.h"
 #include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
@@ -44,6 +61,8 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
       rules.push_back(std::make_unique<ConvAddFusion>());
       rules.push_back(std::make_unique<ConvMulFusion>());
       rules.push_back(std::make_unique<ConvBNFusion>());
+      rules.push_back(std::make_unique<MatMulScaleFusion>());
+      rules.push_back(std::make_unique<GemmBNFusion>());
       break;
 
     case TransformerLevel::Level3:
@@ -95,21 +114,43 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       std::unordered_set<std::string> l1_execution_providers = {};
 
       transformers.emplace_back(std::make_unique<ConstantFolding>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<SymbolicShapeFolding>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<CommonSubexpressionElimination>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<TransposeOptimizer>(l1_execution_providers));
 
       rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l1_execution_providers);
     } break;
 
     case TransformerLevel::Level2: {
       std::unordered_set<std::string> l2_execution_providers = {onnxruntime::kCpuExecutionProvider};
+      std::unordered_set<std::string> cpu_cuda_execution_providers = {onnxruntime::kCpuExecutionProvider,
+                                                                      onnxruntime::kCudaExecutionProvider};
 
       // create rule based transformer consisting of all the level2 rewrite rules
-      rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l2_execution_providers);
+      rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable,
+                                                           cpu_cuda_execution_providers);
 
       // create standalone transformers
+      transformers.emplace_back(std::make_unique<QDQFusion>(l2_execution_providers));
 #ifndef DISABLE_CONTRIB_OPS
-      transformers.emplace_back(std::make_unique<GemmActivationFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_cuda_execution_providers));
+      // The transformer block fusions match Add, Mul and Div nodes that the element-wise fusion would take.
+      transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_execution_providers));
       transformers.emplace_back(std::make_unique<MatMulAddFusion>(l2_execution_providers));
-      transformers.emplace_back(std::make_unique<ConvActivationFusion>(l2_execution_providers));
+      // Only the CUDA kernel of FusedConv adds a residual.
+      transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(
+          std::unordered_set<std::string>{onnxruntime::kCudaExecutionProvider}));
+      transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_cuda_execution_providers));
+      // Runs before ElementwiseFusion, which would take the activation.
+      transformers.emplace_back(std::make_unique<NormActivationFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(l2_execution_providers));
+      // Runs after MatMulAddFusion so the bias of a sparse MatMul is folded into the SparseMatMul through Gemm.
+      transformers.emplace_back(std::make_unique<SparseMatMulTransformer>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<NhwcPoolTransformer>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<ElementwiseFusion>(l2_execution_providers));
 #endif
     } break;
 
@@ -119,6 +160,8 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       if (MlasNchwcGetBlockSize() > 1) {
         transformers.emplace_back(std::make_unique<NchwcTransformer>());
       }
+      // Register the NHWC layout transformer for the float16 convolutions of the CUDA execution provider.
+      transformers.emplace_back(std::make_unique<CudaNhwcTransformer>());
 #endif
 
     } break;
@@ -131,8 +174,10 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
   // if the custom list to enable transformers\rules is empty then return the default generated transformers and rules
   // otherwise generate a filtered list based on the provided custom list.
   if (transformers_and_rules_to_enable.empty()) {
+    // Run the rewrite rules first, so constants are folded into Conv/Gemm/MatMul weights before standalone
+    // fusions such as ElementwiseFusion take the Mul/Add nodes.
     if (rule_transformer != nullptr) {
-      transformers.emplace_back(std::move(rule_transformer));
+      transformers.insert(transformers.begin(), std::move(rule_transformer));
     }
     return transformers;
   }
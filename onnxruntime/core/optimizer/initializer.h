@@ -456,6 +456,41 @@ class Initializer final {
     }
   }
 
+  // Multiplies each element by the entry of other for its index along the last
+  // axis. other holds either a single value or one value per entry of that axis.
+  inline void scale_by_last_axis(const Initializer& other) {
+    const int64_t num = other.size() == 1 || dims_.empty() ? 1 : dims_.back();
+    const int64_t n = size();
+    switch (data_type_) {
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16: {
+        uint16_t* dst = data<uint16_t>();
+        const uint16_t* src = other.data<uint16_t>();
+        for (int64_t i = 0; i < n; i++) {
+          dst[i] = math::floatToHalf(math::halfToFloat(dst[i]) * math::halfToFloat(src[i % num]));
+        }
+        break;
+      }
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
+        float* dst = data<float>();
+        const float* src = other.data<float>();
+        for (int64_t i = 0; i < n; i++) {
+          dst[i] *= src[i % num];
+        }
+        break;
+      }
+      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE: {
+        double* dst = data<double>();
+        const double* src = other.data<double>();
+        for (int64_t i = 0; i < n; i++) {
+          dst[i] *= src[i % num];
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
  private:
   int data_type_;
   std::string name_;
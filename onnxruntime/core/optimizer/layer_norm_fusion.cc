@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/layer_norm_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The CPU kernel is implemented for float and the CUDA kernel for float and float16.
+bool IsSupportedType(const NodeArg& arg, const std::string& provider) {
+  return arg.Type() != nullptr &&
+         (*arg.Type() == "tensor(float)" ||
+          (provider == kCudaExecutionProvider && *arg.Type() == "tensor(float16)"));
+}
+
+// Reads a constant initializer holding a single floating point value.
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || !Initializer::IsSupportedDataType(tensor_proto)) {
+    return false;
+  }
+
+  Initializer initializer(tensor_proto);
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  switch (initializer.data_type()) {
+    case TensorProto_DataType_FLOAT:
+      value = *initializer.data<float>();
+      break;
+    case TensorProto_DataType_DOUBLE:
+      value = static_cast<float>(*initializer.data<double>());
+      break;
+    case TensorProto_DataType_FLOAT16:
+      value = math::halfToFloat(*initializer.data<uint16_t>());
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+// Returns true if node is a ReduceMean of input over its last dimension only, keeping the dimension.
+bool IsLastAxisMean(const Node& node, const NodeArg& input) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11})) {
+    return false;
+  }
+
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(node, "keepdims");
+  std::vector<int64_t> axes;
+  if ((keepdims_attr != nullptr && keepdims_attr->i() == 0) ||
+      !graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes.size() != 1) {
+    return false;
+  }
+
+  return axes[0] == -1 ||
+         (input.Shape() != nullptr && axes[0] == input.Shape()->dim_size() - 1);
+}
+
+// Returns true if node squares input with Pow(input, 2) or Mul(input, input).
+bool IsSquare(const Graph& graph, const Node& node, const NodeArg* input) {
+  const auto& inputs = node.InputDefs();
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+    return inputs[0] == input && inputs[1] == input;
+  }
+
+  float exponent;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pow", {7}) &&
+         inputs[0] == input && GetScalarConstant(graph, *inputs[1], exponent) && exponent == 2.0f;
+}
+
+// Returns true if arg is a constant vector with one element per entry of the last dimension of input.
+bool IsNormalizedVector(const Graph& graph, const NodeArg& arg, const NodeArg& input) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  const TensorShapeProto* shape = input.Shape();
+  if (tensor_proto == nullptr || tensor_proto->dims_size() != 1 || shape == nullptr || shape->dim_size() < 1) {
+    return false;
+  }
+
+  const auto& last_dim = shape->dim(shape->dim_size() - 1);
+  return last_dim.has_dim_value() && last_dim.dim_value() == tensor_proto->dims(0) &&
+         arg.Type() != nullptr && input.Type() != nullptr && *arg.Type() == *input.Type();
+}
+
+// Returns the input of a binary node other than input, or nullptr if input is not one of them.
+NodeArg* OtherInput(const Node& node, const NodeArg* input) {
+  auto& inputs = const_cast<Node&>(node).MutableInputDefs();
+  if (inputs[0] == input) {
+    return inputs[1];
+  }
+  return inputs[1] == input ? inputs[0] : nullptr;
+}
+
+}  // namespace
+
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& mean = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(mean, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(mean, GetCompatibleExecutionProviders()) ||
+        !IsLastAxisMean(mean, *mean.InputDefs()[0]) || !graph_utils::HasSingleConsumer(graph, mean)) {
+      continue;
+    }
+
+    const std::string& provider = mean.GetExecutionProviderType();
+    NodeArg* x = mean.MutableInputDefs()[0];
+    if (!IsSupportedType(*x, provider)) {
+      continue;
+    }
+
+    // The centered values are consumed twice: squared for the variance and divided by the deviation.
+    const Node& sub = *mean.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(sub, "Sub", {7}) ||
+        sub.InputDefs()[0] != x || sub.InputDefs()[1] != mean.OutputDefs()[0] ||
+        graph.IsNodeOutputsInGraphOutputs(sub)) {
+      continue;
+    }
+
+    const NodeArg* centered = sub.OutputDefs()[0];
+    const Node* square = nullptr;
+    const Node* div = nullptr;
+    bool same_provider = true;
+    for (auto it = sub.OutputNodesBegin(); it != sub.OutputNodesEnd(); ++it) {
+      same_provider = same_provider && it->GetExecutionProviderType() == provider;
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Div", {7}) && it->InputDefs()[0] == centered) {
+        div = &*it;
+      } else if (IsSquare(graph, *it, centered)) {
+        square = &*it;
+      }
+    }
+    // Mul(centered, centered) has an edge for each of its inputs.
+    if (!same_provider || square == nullptr || div == nullptr ||
+        sub.GetOutputEdgesCount() != (square->OpType() == "Mul" ? 3u : 2u) ||
+        !graph_utils::HasSingleConsumer(graph, *square)) {
+      continue;
+    }
+
+    const Node& variance = *square->OutputNodesBegin();
+    if (!IsLastAxisMean(variance, *x) || !graph_utils::HasSingleConsumer(graph, variance)) {
+      continue;
+    }
+
+    const Node& add_epsilon = *variance.OutputNodesBegin();
+    const NodeArg* epsilon_arg = OtherInput(add_epsilon, variance.OutputDefs()[0]);
+    float epsilon;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_epsilon, "Add", {7}) ||
+        epsilon_arg == nullptr || !GetScalarConstant(graph, *epsilon_arg, epsilon) ||
+        !graph_utils::HasSingleConsumer(graph, add_epsilon)) {
+      continue;
+    }
+
+    const Node& sqrt = *add_epsilon.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(sqrt, "Sqrt", {6}) ||
+        !graph_utils::HasSingleConsumer(graph, sqrt) || &*sqrt.OutputNodesBegin() != div ||
+        div->InputDefs()[1] != sqrt.OutputDefs()[0] || !graph_utils::HasSingleConsumer(graph, *div)) {
+      continue;
+    }
+
+    const Node& mul = *div->OutputNodesBegin();
+    NodeArg* scale = OtherInput(mul, div->OutputDefs()[0]);
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(mul, "Mul", {7}) ||
+        scale == nullptr || !IsNormalizedVector(graph, *scale, *x) || !graph_utils::HasSingleConsumer(graph, mul)) {
+      continue;
+    }
+
+    const Node& add = *mul.OutputNodesBegin();
+    NodeArg* bias = OtherInput(add, mul.OutputDefs()[0]);
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add, "Add", {7}) ||
+        bias == nullptr || !IsNormalizedVector(graph, *bias, *x)) {
+      continue;
+    }
+
+    Node& layer_norm = graph.AddNode(graph.GenerateNodeName("fused " + mean.Name()), "LayerNormalization",
+                                     "fused layer normalization starting at " + mean.Name(),
+                                     std::vector<NodeArg*>{x, scale, bias},
+                                     const_cast<Node&>(add).MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    layer_norm.AddAttribute("axis", static_cast<int64_t>(-1));
+    layer_norm.AddAttribute("epsilon", epsilon);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm.SetExecutionProviderType(provider);
+
+    for (const Node* node : {&static_cast<const Node&>(mean), &sub, square, &variance, &add_epsilon, &sqrt, div,
+                             &mul, &add}) {
+      removed_nodes.push_front(node->Index());
+    }
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LayerNormFusion
+
+Fuses the layer normalization subgraph that frameworks export for the last dimension,
+Add(Mul(Div(Sub(X, ReduceMean(X)), Sqrt(Add(ReduceMean(Pow(Sub(X, ReduceMean(X)), 2)), epsilon))), scale), B),
+into a LayerNormalization node that normalizes each row in a single pass over the cache.
+*/
+class LayerNormFusion : public GraphTransformer {
+ public:
+  LayerNormFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/matmul_scale_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Returns the input of the Mul node that is not the output of the MatMul/Gemm node.
+const NodeArg* GetScaleInput(const Node& matmul_node, const Node& mul_node) {
+  const auto& mul_inputs = mul_node.InputDefs();
+  return mul_inputs[0] == matmul_node.OutputDefs()[0] ? mul_inputs[1] : mul_inputs[0];
+}
+}  // namespace
+
+Status MatMulScaleFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  auto& matmul_node = node;
+  const auto& mul_node = *matmul_node.OutputNodesBegin();
+  const auto& matmul_inputs = matmul_node.InputDefs();
+  const bool is_gemm = matmul_node.OpType() == "Gemm";
+
+  const auto* matmul_W_tensor_proto = graph_utils::GetConstantInitializer(graph, matmul_inputs[1]->Name());
+  ORT_ENFORCE(matmul_W_tensor_proto);
+
+  const auto* mul_B_tensor_proto = graph_utils::GetConstantInitializer(graph, GetScaleInput(matmul_node, mul_node)->Name());
+  ORT_ENFORCE(mul_B_tensor_proto);
+
+  if (!Initializer::IsSupportedDataType(matmul_W_tensor_proto) ||
+      matmul_W_tensor_proto->data_type() != mul_B_tensor_proto->data_type() ||
+      matmul_W_tensor_proto->dims_size() != 2) {
+    return Status::OK();
+  }
+
+  const auto* trans_B_attr = graph_utils::GetNodeAttribute(matmul_node, "transB");
+  const bool trans_B = is_gemm && trans_B_attr != nullptr && trans_B_attr->i() != 0;
+  const int64_t columns = matmul_W_tensor_proto->dims(trans_B ? 0 : 1);
+
+  // The scale must be a single value or hold a value per output column, such as 1xN.
+  const int mul_B_rank = mul_B_tensor_proto->dims_size();
+  for (int i = 0; i < mul_B_rank - 1; i++) {
+    if (mul_B_tensor_proto->dims(i) != 1) {
+      return Status::OK();
+    }
+  }
+  if (mul_B_rank > 0 && mul_B_tensor_proto->dims(mul_B_rank - 1) != 1 &&
+      mul_B_tensor_proto->dims(mul_B_rank - 1) != columns) {
+    return Status::OK();
+  }
+
+  // The scale must not broadcast the output to a higher rank. The output of MatMul has the rank of its first
+  // input, or is a vector if that rank is unknown.
+  int output_rank = 2;
+  if (!is_gemm) {
+    const auto* input_shape = matmul_inputs[0]->Shape();
+    output_rank = input_shape != nullptr ? input_shape->dim_size() : 1;
+  }
+  if (mul_B_rank > output_rank) {
+    return Status::OK();
+  }
+
+  auto matmul_W = std::make_unique<Initializer>(matmul_W_tensor_proto);
+  auto mul_B = std::make_unique<Initializer>(mul_B_tensor_proto);
+
+  // The bias of Gemm broadcasts to the output, so a per column scale requires C to hold a value per column.
+  const ONNX_NAMESPACE::TensorProto* gemm_C_tensor_proto = nullptr;
+  std::unique_ptr<Initializer> gemm_C = nullptr;
+  if (is_gemm) {
+    gemm_C_tensor_proto = graph_utils::GetConstantInitializer(graph, matmul_inputs[2]->Name());
+    ORT_ENFORCE(gemm_C_tensor_proto);
+
+    if (gemm_C_tensor_proto->data_type() != mul_B_tensor_proto->data_type() ||
+        (mul_B->size() != 1 &&
+         (gemm_C_tensor_proto->dims_size() == 0 ||
+          gemm_C_tensor_proto->dims(gemm_C_tensor_proto->dims_size() - 1) != columns))) {
+      return Status::OK();
+    }
+    gemm_C = std::make_unique<Initializer>(gemm_C_tensor_proto);
+  }
+
+  // Calculate new value of initializers of matmul node
+  if (trans_B) {
+    matmul_W->scale_by_axis(*mul_B, 1);
+  } else {
+    matmul_W->scale_by_last_axis(*mul_B);
+  }
+
+  ONNX_NAMESPACE::TensorProto new_matmul_W_tensor_proto(*matmul_W_tensor_proto);
+  matmul_W->ToProto(&new_matmul_W_tensor_proto);
+  graph_utils::ReplaceInitializer(graph, matmul_inputs[1]->Name(), new_matmul_W_tensor_proto);
+
+  if (is_gemm) {
+    gemm_C->scale_by_last_axis(*mul_B);
+
+    ONNX_NAMESPACE::TensorProto new_gemm_C_tensor_proto(*gemm_C_tensor_proto);
+    gemm_C->ToProto(&new_gemm_C_tensor_proto);
+    graph_utils::ReplaceInitializer(graph, matmul_inputs[2]->Name(), new_gemm_C_tensor_proto);
+  }
+
+  // Remove Mul node.
+  auto* mul_node_to_remove = graph.GetNode(mul_node.Index());
+  if (graph_utils::RemoveNode(graph, *mul_node_to_remove)) {
+    rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+  }
+
+  return Status::OK();
+}
+
+bool MatMulScaleFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+  if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+      node.GetOutputEdgesCount() != 1 || (is_gemm && node.InputDefs().size() != 3)) {
+    return false;
+  }
+
+  const auto& next_node = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Mul", {7}) ||
+      next_node.GetInputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(next_node) ||
+      // Make sure the two nodes do not span execution providers.
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // Check that the appropriate inputs to the MatMul/Gemm and Mul nodes are constants.
+  if (!graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[1]) ||
+      (is_gemm && !graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[2])) ||
+      !graph_utils::NodeArgIsConstant(graph, *GetScaleInput(node, next_node))) {
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulScaleFusion
+
+Rewrite rule that folds a Mul by a constant scalar or per column vector into the weights of the preceding
+MatMul or Gemm node, and into the bias of the Gemm node.
+
+It is attempted to be triggered only on nodes with op type "MatMul" or "Gemm".
+*/
+class MatMulScaleFusion : public RewriteRule {
+ public:
+  MatMulScaleFusion() noexcept : RewriteRule("MatMulScaleFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"MatMul", "Gemm"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
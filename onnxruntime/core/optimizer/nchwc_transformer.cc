@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <deque>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
@@ -118,6 +119,8 @@ class NchwcTransformerImpl {
   void TransformAdd(Node& node);
   void TransformConcat(Node& node);
   void TransformActivation(Node& node);
+  void TransformBatchNormalization(Node& node);
+  void TransformUpsample(Node& node);
 
   Graph& graph_;
 
@@ -660,6 +663,182 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
   }
 }
 
+// BatchNormalization is an affine transform of each channel, so it can be
+// computed by a NCHWc depthwise 1x1 convolution. This keeps the tensor in NCHWc
+// format and allows a following activation to be fused as well.
+void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  // Depthwise convolutions require the channel count to be block aligned.
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % MlasNchwcGetBlockSize()) != 0) {
+    return;
+  }
+
+  // Require that the scale, bias, mean and variance tensors be static.
+  std::unique_ptr<Initializer> bn_params[4];
+  for (size_t i = 0; i < 4; i++) {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[i + 1]) ||
+        !graph_.GetInitializedTensor(input_defs[i + 1]->Name(), tensor_proto) ||
+        (tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (tensor_proto->dims_size() != 1) ||
+        (tensor_proto->dims(0) != channels)) {
+      return;
+    }
+    bn_params[i] = std::make_unique<Initializer>(tensor_proto);
+  }
+
+  float epsilon = 1e-5f;
+  auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr && utils::HasFloat(*epsilon_attr)) {
+    epsilon = epsilon_attr->f();
+  }
+
+  // Fold the normalization into a per channel scale and bias.
+  const float* bn_scale = bn_params[0]->data<float>();
+  const float* bn_B = bn_params[1]->data<float>();
+  const float* bn_mean = bn_params[2]->data<float>();
+  const float* bn_var = bn_params[3]->data<float>();
+
+  std::vector<float> conv_W(static_cast<size_t>(channels));
+  std::vector<float> conv_B(static_cast<size_t>(channels));
+  for (size_t c = 0; c < static_cast<size_t>(channels); c++) {
+    conv_W[c] = bn_scale[c] / std::sqrt(bn_var[c] + epsilon);
+    conv_B[c] = bn_B[c] - bn_mean[c] * conv_W[c];
+  }
+
+  const int64_t conv_W_dims[] = {channels, 1, 1, 1};
+  std::vector<float> reordered_filter(static_cast<size_t>(channels));
+  MlasReorderFilterOIHWBo(conv_W_dims, conv_W.data(), reordered_filter.data());
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_W_tensor_proto;
+
+  nchwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_scale"));
+  nchwc_conv_W_tensor_proto.set_raw_data(reordered_filter.data(), reordered_filter.size() * sizeof(float));
+
+  for (size_t i = 0; i < 4; i++) {
+    nchwc_conv_W_tensor_proto.add_dims(conv_W_dims[i]);
+  }
+
+  graph_.AddInitializedTensor(nchwc_conv_W_tensor_proto);
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_B_tensor_proto;
+
+  nchwc_conv_B_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_B_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_B"));
+  nchwc_conv_B_tensor_proto.set_raw_data(conv_B.data(), conv_B.size() * sizeof(float));
+
+  nchwc_conv_B_tensor_proto.add_dims(channels);
+
+  graph_.AddInitializedTensor(nchwc_conv_B_tensor_proto);
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_bn_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Conv",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_,
+                                     &graph_.GetOrCreateNodeArg(nchwc_conv_W_tensor_proto.name(), nullptr),
+                                     &graph_.GetOrCreateNodeArg(nchwc_conv_B_tensor_proto.name(), nullptr)},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("group", channels);
+
+  nchwc_input->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Nearest neighbor upsampling with integral scale factors only replicates
+// spatial elements, so each NCHWc channel block can be copied as a unit.
+void NchwcTransformerImpl::TransformUpsample(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  auto* mode_attr = graph_utils::GetNodeAttribute(node, "mode");
+  if (mode_attr != nullptr && utils::HasString(*mode_attr) && mode_attr->s() != "nearest") {
+    return;
+  }
+
+  // Upsample-7 stores the scales as an attribute. Later versions and Resize-10
+  // read the scales from the second input, which must be static.
+  std::vector<float> scales;
+  if (input_defs.size() == 1) {
+    if (!graph_utils::GetRepeatedNodeAttributeValues(node, "scales", scales)) {
+      return;
+    }
+  } else {
+    const ONNX_NAMESPACE::TensorProto* scales_tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+        !graph_.GetInitializedTensor(input_defs[1]->Name(), scales_tensor_proto) ||
+        (scales_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (scales_tensor_proto->dims_size() != 1)) {
+      return;
+    }
+    Initializer scales_initializer(scales_tensor_proto);
+    scales.assign(scales_initializer.data<float>(), scales_initializer.data<float>() + scales_initializer.size());
+  }
+
+  // The batch and channel dimensions must be unchanged and the spatial
+  // dimensions must be scaled by a positive integer.
+  if (scales.size() != kNchwcDims || scales[0] != 1.0f || scales[1] != 1.0f) {
+    return;
+  }
+  std::vector<int64_t> int64_scales(kNchwcDims);
+  for (size_t i = 0; i < kNchwcDims; i++) {
+    int64_scales[i] = static_cast<int64_t>(scales[i]);
+    if (int64_scales[i] < 1 || static_cast<float>(int64_scales[i]) != scales[i]) {
+      return;
+    }
+  }
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Upsample",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("scales", int64_scales);
+
+  nchwc_input->remaining_original_uses_--;
+
+  // Maintain the batch and channel dimensions from the NCHWc input. The
+  // spatial dimensions are now derived from this node.
+  NchwcArgument::Shape output_shape(output_defs[0]);
+  output_shape.dims_[0] = nchwc_input->shape_.dims_[0];
+  output_shape.dims_[1] = nchwc_input->shape_.dims_[1];
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, output_shape);
+  removed_nodes_.push_front(node.Index());
+}
+
 void NchwcTransformerImpl::Transform(Node& node) {
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1}) ||
       graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
@@ -682,6 +861,11 @@ void NchwcTransformerImpl::Transform(Node& node) {
       TransformConcat(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6})) {
       TransformActivation(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {7, 9}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10})) {
+      TransformUpsample(node);
     }
   }
 
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/nhwc_pool_transformer.h"
+
+#include <deque>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// The permutation moving the channels of an NHWC tensor of rank to the front of the spatial dimensions.
+std::vector<int64_t> NhwcToNchwPermutation(size_t rank) {
+  std::vector<int64_t> perm{0, static_cast<int64_t>(rank) - 1};
+  for (size_t i = 1; i < rank - 1; ++i) {
+    perm.push_back(static_cast<int64_t>(i));
+  }
+  return perm;
+}
+
+// The permutation moving the channels of an NCHW tensor of rank after the spatial dimensions.
+std::vector<int64_t> NchwToNhwcPermutation(size_t rank) {
+  std::vector<int64_t> perm{0};
+  for (size_t i = 2; i < rank; ++i) {
+    perm.push_back(static_cast<int64_t>(i));
+  }
+  perm.push_back(1);
+  return perm;
+}
+
+bool IsTransposeWithPermutation(const Node& node, const std::vector<int64_t>& perm) {
+  std::vector<int64_t> node_perm;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) &&
+         graph_utils::GetRepeatedNodeAttributeValues(node, "perm", node_perm) && node_perm == perm;
+}
+
+// Returns the name of the NHWC pooling op replacing node, or an empty string if node isn't a pooling the NHWC
+// kernels compute.
+std::string GetNhwcPoolOpType(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10})) {
+    return "Nhwc" + node.OpType();
+  }
+
+  // the NHWC kernel has no Indices output or dilations
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10}) &&
+      (node.OutputDefs().size() == 1 || !node.OutputDefs()[1]->Exists())) {
+    std::vector<int64_t> dilations;
+    if (graph_utils::GetRepeatedNodeAttributeValues(node, "dilations", dilations)) {
+      for (auto dilation : dilations) {
+        if (dilation != 1) {
+          return std::string();
+        }
+      }
+    }
+    return "NhwcMaxPool";
+  }
+
+  return std::string();
+}
+
+}  // namespace
+
+Status NhwcPoolTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& transpose = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(transpose, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(transpose, "Transpose", {1}) ||
+        !graph_utils::IsSupportedProvider(transpose, GetCompatibleExecutionProviders()) ||
+        !graph_utils::HasSingleConsumer(graph, transpose)) {
+      continue;
+    }
+
+    NodeArg* input = transpose.MutableInputDefs()[0];
+    if (input->Type() == nullptr || *input->Type() != "tensor(float)" || input->Shape() == nullptr) {
+      continue;
+    }
+    const size_t rank = static_cast<size_t>(input->Shape()->dim_size());
+    if (rank < 3 || rank > 5 || !IsTransposeWithPermutation(transpose, NhwcToNchwPermutation(rank))) {
+      continue;
+    }
+
+    auto& pool = *graph.GetNode(transpose.OutputNodesBegin()->Index());
+    const std::string op_type = GetNhwcPoolOpType(pool);
+    if (op_type.empty()) {
+      continue;
+    }
+
+    // The Transpose back to NHWC is dropped when it is the only consumer of the pooling.
+    Node* output_transpose = nullptr;
+    if (graph_utils::HasSingleConsumer(graph, pool)) {
+      auto* next_node = graph.GetNode(pool.OutputNodesBegin()->Index());
+      if (IsTransposeWithPermutation(*next_node, NchwToNhwcPermutation(rank))) {
+        output_transpose = next_node;
+      }
+    }
+
+    NodeArg* output;
+    if (output_transpose != nullptr) {
+      output = output_transpose->MutableOutputDefs()[0];
+    } else {
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+      output = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(pool.OutputDefs()[0]->Name() + "_nhwc"), &type);
+    }
+
+    Node& nhwc_pool = graph.AddNode(graph.GenerateNodeName("nhwc " + pool.Name()), op_type,
+                                    "NHWC " + pool.OpType() + " " + pool.Name(),
+                                    {input},
+                                    {output},
+                                    nullptr,
+                                    kMSDomain);
+    for (const char* name : {"auto_pad", "kernel_shape", "pads", "strides", "ceil_mode", "count_include_pad"}) {
+      const auto* attr = graph_utils::GetNodeAttribute(pool, name);
+      if (attr != nullptr) {
+        nhwc_pool.AddAttribute(name, *attr);
+      }
+    }
+    nhwc_pool.SetExecutionProviderType(pool.GetExecutionProviderType());
+
+    if (output_transpose != nullptr) {
+      removed_nodes.push_front(output_transpose->Index());
+    } else {
+      Node& nchw_transpose = graph.AddNode(graph.GenerateNodeName("nchw " + pool.Name()), "Transpose",
+                                           "transpose NHWC " + pool.OpType() + " " + pool.Name(),
+                                           {output},
+                                           {pool.MutableOutputDefs()[0]});
+      nchw_transpose.AddAttribute("perm", NhwcToNchwPermutation(rank));
+      nchw_transpose.SetExecutionProviderType(pool.GetExecutionProviderType());
+    }
+
+    removed_nodes.push_front(transpose.Index());
+    removed_nodes.push_front(pool.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
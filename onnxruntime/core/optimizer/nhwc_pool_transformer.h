@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NhwcPoolTransformer
+
+Replaces a float pooling node whose input is transposed from NHWC to NCHW with the NHWC pooling node of the
+com.microsoft domain reading the input before the Transpose. The Transpose back to NHWC following the pooling is
+dropped if there is one, otherwise the smaller pooled output is transposed to NCHW instead of the input.
+*/
+class NhwcPoolTransformer : public GraphTransformer {
+ public:
+  NhwcPoolTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("NhwcPoolTransformer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
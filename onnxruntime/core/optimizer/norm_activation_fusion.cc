@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include <limits>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/norm_activation_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// Returns true if the node is an activation of the fused kernels, and sets the parameters of the activation.
+bool GetFusableActivation(const Node& node, std::vector<float>& activation_params) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6})) {
+    const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+    activation_params.push_back(alpha_attr != nullptr ? alpha_attr->f() : 0.01f);
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6})) {
+    const auto* min_attr = graph_utils::GetNodeAttribute(node, "min");
+    const auto* max_attr = graph_utils::GetNodeAttribute(node, "max");
+    activation_params.push_back(min_attr != nullptr ? min_attr->f() : std::numeric_limits<float>::lowest());
+    activation_params.push_back(max_attr != nullptr ? max_attr->f() : std::numeric_limits<float>::max());
+    return true;
+  }
+
+  return false;
+}
+
+// Returns true if only the first output of the normalization exists, as in inference.
+bool HasSingleOutput(const Node& node) {
+  const auto& outputs = node.OutputDefs();
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    if (outputs[i]->Exists()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if the input of the node is the output of a convolution. The NCHWc transformer turns a
+// BatchNormalization following a convolution into a depthwise convolution, which fuses the activation as well.
+bool FollowsConv(const Node& node) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 0 && (it->GetNode().OpType() == "Conv" || it->GetNode().OpType() == "FusedConv")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+Status NormActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& norm = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(norm, modified, graph_level));
+
+    const bool is_batch_norm = graph_utils::IsSupportedOptypeVersionAndDomain(norm, "BatchNormalization", {7, 9});
+    if (!(is_batch_norm || graph_utils::IsSupportedOptypeVersionAndDomain(norm, "InstanceNormalization", {6})) ||
+        !graph_utils::IsSupportedProvider(norm, GetCompatibleExecutionProviders()) ||
+        norm.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(norm) || !HasSingleOutput(norm)) {
+      continue;
+    }
+
+    // the kernel only supports the spatial form of BatchNormalization opset 7
+    const auto* spatial_attr = graph_utils::GetNodeAttribute(norm, "spatial");
+    if (is_batch_norm && ((spatial_attr != nullptr && spatial_attr->i() != 1) || FollowsConv(norm))) {
+      continue;
+    }
+
+    const Node& act = *norm.OutputNodesBegin();
+    std::vector<float> activation_params;
+    if (act.GetExecutionProviderType() != norm.GetExecutionProviderType() ||
+        !GetFusableActivation(act, activation_params)) {
+      continue;
+    }
+
+    NodeAttributes attributes;
+    const auto* epsilon_attr = graph_utils::GetNodeAttribute(norm, "epsilon");
+    if (epsilon_attr != nullptr) {
+      attributes["epsilon"] = *epsilon_attr;
+    }
+
+    std::vector<NodeArg*> fused_inputs = norm.MutableInputDefs();
+    Node& fused_norm = graph.AddNode(graph.GenerateNodeName("fused " + norm.Name()),
+                                     is_batch_norm ? "FusedBatchNormalization" : "FusedInstanceNormalization",
+                                     "fused " + norm.OpType() + " " + norm.Name() + " with activation " + act.OpType(),
+                                     fused_inputs,
+                                     const_cast<Node&>(act).MutableOutputDefs(),
+                                     &attributes,
+                                     kMSDomain);
+
+    // Add attributes to specify the activation type and parameters.
+    fused_norm.AddAttribute("activation", act.OpType());
+    if (!activation_params.empty()) {
+      fused_norm.AddAttribute("activation_params", activation_params);
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_norm.SetExecutionProviderType(norm.GetExecutionProviderType());
+
+    removed_nodes.push_front(norm.Index());
+    removed_nodes.push_front(act.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
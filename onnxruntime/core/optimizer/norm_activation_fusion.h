@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NormActivationFusion
+
+Fuses a BatchNormalization or InstanceNormalization followed by a Relu, LeakyRelu, Sigmoid, Tanh or Clip into a
+FusedBatchNormalization or FusedInstanceNormalization node, which applies the activation to each normalized plane
+while it is still in the cache instead of in another pass over the tensor. Only the BatchNormalization nodes of
+inference, whose optional outputs don't exist, are fused, and not those following a convolution, which the NCHWc
+transformer handles.
+*/
+class NormActivationFusion : public GraphTransformer {
+ public:
+  NormActivationFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("NormActivationFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <unordered_set>
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/qdq_fusion.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsQuantizeOp(const Node& node, const std::string& op_type) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, {10}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, {1}, kMSDomain);
+}
+
+bool IsUint8Tensor(const NodeArg* arg) {
+  return arg != nullptr && arg->Exists() && arg->Type() != nullptr && *arg->Type() == "tensor(uint8)";
+}
+
+// Returns the number of values of a 0-D or 1-D argument of known shape, or 0 otherwise.
+int64_t NumValues(const NodeArg& arg) {
+  const TensorShapeProto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() > 1) {
+    return 0;
+  }
+  if (shape->dim_size() == 0) {
+    return 1;
+  }
+  return shape->dim(0).has_dim_value() ? shape->dim(0).dim_value() : 0;
+}
+
+// Returns the DequantizeLinear node producing the input_index-th input of node from uint8 values with a
+// zero point. The scale and the zero point hold a single value, or num_channels values along axis 0 if num_channels
+// is positive.
+const Node* GetDequantizeInput(const Node& node, int input_index, int64_t num_channels) {
+  const Node* dequantize = nullptr;
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      dequantize = &it->GetNode();
+    }
+  }
+  if (dequantize == nullptr || !IsQuantizeOp(*dequantize, "DequantizeLinear")) {
+    return nullptr;
+  }
+
+  const auto& inputs = dequantize->InputDefs();
+  if (inputs.size() != 3 || !IsUint8Tensor(inputs[0]) || !IsUint8Tensor(inputs[2])) {
+    return nullptr;
+  }
+
+  const int64_t num_scales = NumValues(*inputs[1]);
+  if (num_scales == 1 && NumValues(*inputs[2]) == 1) {
+    return dequantize;
+  }
+#ifndef USE_GEMMLOWP
+  // only the MLAS build of QLinearConv requantizes per output channel
+  const auto* axis_attr = graph_utils::GetNodeAttribute(*dequantize, "axis");
+  if (num_channels > 1 && num_scales == num_channels && NumValues(*inputs[2]) == num_channels &&
+      (axis_attr == nullptr || axis_attr->i() == 0)) {
+    return dequantize;
+  }
+#else
+  ORT_UNUSED_PARAMETER(num_channels);
+#endif
+  return nullptr;
+}
+
+// Returns the QuantizeLinear node that is the only consumer of the output of node, with a uint8 zero point and a
+// single scale.
+const Node* GetQuantizeOutput(const Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+
+  const Node& quantize = *node.OutputNodesBegin();
+  if (!IsQuantizeOp(quantize, "QuantizeLinear")) {
+    return nullptr;
+  }
+
+  const auto& inputs = quantize.InputDefs();
+  if (inputs.size() != 3 || !IsUint8Tensor(inputs[2]) || NumValues(*inputs[1]) != 1 || NumValues(*inputs[2]) != 1) {
+    return nullptr;
+  }
+  return &quantize;
+}
+
+// Returns a scalar zero point for a zero point holding a single value, or the same value for every channel.
+// QLinearMatMul, and QLinearConv with gemmlowp, shift all the channels of the weight by the same zero point.
+// Returns nullptr otherwise.
+NodeArg* GetScalarZeroPoint(Graph& graph, NodeArg& zero_point) {
+  if (NumValues(zero_point) == 1) {
+    return &zero_point;
+  }
+
+  const auto* zero_point_proto = graph_utils::GetConstantInitializer(graph, zero_point.Name());
+  if (zero_point_proto == nullptr) {
+    return nullptr;
+  }
+  std::vector<uint8_t> values(static_cast<size_t>(NumValues(zero_point)));
+  const bool has_raw_data = utils::HasRawData(*zero_point_proto);
+  if (!utils::UnpackTensor<uint8_t>(*zero_point_proto, has_raw_data ? zero_point_proto->raw_data().data() : nullptr,
+                                    has_raw_data ? zero_point_proto->raw_data().size() : 0, values.data(),
+                                    static_cast<int64_t>(values.size()))
+           .IsOK() ||
+      std::any_of(values.begin(), values.end(), [&values](uint8_t value) { return value != values[0]; })) {
+    return nullptr;
+  }
+
+  TensorProto scalar_zero_point;
+  scalar_zero_point.set_data_type(TensorProto_DataType_UINT8);
+  scalar_zero_point.set_name(graph.GenerateNodeArgName(zero_point.Name() + "_scalar"));
+  scalar_zero_point.add_int32_data(values[0]);
+  graph.AddInitializedTensor(scalar_zero_point);
+
+  TypeProto uint8_tensor;
+  uint8_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  return &graph.GetOrCreateNodeArg(scalar_zero_point.name(), &uint8_tensor);
+}
+
+// Quantizes a constant float bias to int32 with the scale of the input times the scale of the filter, per tensor or
+// per output channel. Returns nullptr if the bias or the scales aren't constant.
+NodeArg* QuantizeBias(Graph& graph, const NodeArg& bias, const NodeArg& input_scale, const NodeArg& filter_scale) {
+  const auto* bias_proto = graph_utils::GetConstantInitializer(graph, bias.Name());
+  const auto* input_scale_proto = graph_utils::GetConstantInitializer(graph, input_scale.Name());
+  const auto* filter_scale_proto = graph_utils::GetConstantInitializer(graph, filter_scale.Name());
+  if (bias_proto == nullptr || input_scale_proto == nullptr || filter_scale_proto == nullptr ||
+      bias_proto->data_type() != TensorProto_DataType_FLOAT || bias_proto->dims_size() != 1 ||
+      input_scale_proto->data_type() != TensorProto_DataType_FLOAT ||
+      filter_scale_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+
+  Initializer bias_values(bias_proto);
+  Initializer input_scale_value(input_scale_proto);
+  Initializer filter_scale_values(filter_scale_proto);
+  const int64_t num_channels = bias_proto->dims(0);
+  const int64_t num_filter_scales = filter_scale_values.size();
+  if (num_filter_scales != 1 && num_filter_scales != num_channels) {
+    return nullptr;
+  }
+
+  TensorProto quantized_bias;
+  quantized_bias.set_data_type(TensorProto_DataType_INT32);
+  quantized_bias.set_name(graph.GenerateNodeArgName(bias.Name() + "_quantized"));
+  quantized_bias.add_dims(num_channels);
+  for (int64_t m = 0; m < num_channels; ++m) {
+    const float scale = *input_scale_value.data<float>() *
+                        filter_scale_values.data<float>()[num_filter_scales == 1 ? 0 : m];
+    quantized_bias.add_int32_data(static_cast<int32_t>(std::nearbyint(bias_values.data<float>()[m] / scale)));
+  }
+  graph.AddInitializedTensor(quantized_bias);
+
+  TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  return &graph.GetOrCreateNodeArg(quantized_bias.name(), &int32_tensor);
+}
+
+}  // namespace
+
+Status QDQFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::unordered_set<onnxruntime::NodeIndex> dequantize_nodes;
+  for (auto index : order) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_conv = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11});
+#ifndef DISABLE_CONTRIB_OPS
+    // QLinearAdd is a contrib op, implemented by the CPU execution provider only
+    const bool is_add = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) &&
+                        node.GetExecutionProviderType() == kCpuExecutionProvider;
+#else
+    const bool is_add = false;
+#endif
+    if (!(is_conv || is_add || graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (is_add) {
+      const Node* dequantize_a = GetDequantizeInput(node, 0, 0);
+      const Node* dequantize_b = GetDequantizeInput(node, 1, 0);
+      const Node* quantize_output = GetQuantizeOutput(graph, node);
+      if (dequantize_a == nullptr || dequantize_b == nullptr || quantize_output == nullptr ||
+          dequantize_a->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          dequantize_b->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          quantize_output->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        continue;
+      }
+
+      auto& a_inputs = const_cast<Node*>(dequantize_a)->MutableInputDefs();
+      auto& b_inputs = const_cast<Node*>(dequantize_b)->MutableInputDefs();
+      auto& c_inputs = const_cast<Node*>(quantize_output)->MutableInputDefs();
+      Node& fused_node = graph.AddNode(graph.GenerateNodeName("quantized " + node.Name()),
+                                       "QLinearAdd",
+                                       "quantized Add " + node.Name(),
+                                       {a_inputs[0], a_inputs[1], a_inputs[2],
+                                        b_inputs[0], b_inputs[1], b_inputs[2],
+                                        c_inputs[1], c_inputs[2]},
+                                       const_cast<Node*>(quantize_output)->MutableOutputDefs(),
+                                       nullptr,
+                                       kMSDomain);
+      fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+      graph_utils::RemoveNodeOutputEdges(graph, node);
+      graph_utils::RemoveNodeOutputEdges(graph, *const_cast<Node*>(quantize_output));
+      removed_nodes.push_front(quantize_output->Index());
+      removed_nodes.push_front(node.Index());
+      dequantize_nodes.insert(dequantize_a->Index());
+      dequantize_nodes.insert(dequantize_b->Index());
+      continue;
+    }
+
+    // a filter [M, C/group, kH, kW] may be quantized per output channel
+    int64_t num_channels = 0;
+    const TensorShapeProto* filter_shape = node.InputDefs()[1]->Shape();
+    if (is_conv && filter_shape != nullptr && filter_shape->dim_size() > 0 && filter_shape->dim(0).has_dim_value()) {
+      num_channels = filter_shape->dim(0).dim_value();
+    }
+
+    const Node* dequantize_input = GetDequantizeInput(node, 0, 0);
+    const Node* dequantize_weight = GetDequantizeInput(node, 1, num_channels);
+    const Node* quantize_output = GetQuantizeOutput(graph, node);
+    if (dequantize_input == nullptr || dequantize_weight == nullptr || quantize_output == nullptr) {
+      continue;
+    }
+
+    bool same_provider = true;
+    for (const Node* quantize_node : {dequantize_input, dequantize_weight, quantize_output}) {
+      same_provider = same_provider && quantize_node->GetExecutionProviderType() == node.GetExecutionProviderType();
+    }
+    if (!same_provider) {
+      continue;
+    }
+
+    auto& x_inputs = const_cast<Node*>(dequantize_input)->MutableInputDefs();
+    auto& w_inputs = const_cast<Node*>(dequantize_weight)->MutableInputDefs();
+    auto& y_inputs = const_cast<Node*>(quantize_output)->MutableInputDefs();
+#ifndef USE_GEMMLOWP
+    // the MLAS build of QLinearConv takes a zero point per output channel
+    NodeArg* w_zero_point = is_conv ? w_inputs[2] : GetScalarZeroPoint(graph, *w_inputs[2]);
+#else
+    NodeArg* w_zero_point = GetScalarZeroPoint(graph, *w_inputs[2]);
+#endif
+    if (w_zero_point == nullptr) {
+      continue;
+    }
+    std::vector<NodeArg*> fused_inputs{x_inputs[0], x_inputs[1], x_inputs[2],
+                                       w_inputs[0], w_inputs[1], w_zero_point,
+                                       y_inputs[1], y_inputs[2]};
+
+    if (is_conv && node.InputDefs().size() > 2 && node.InputDefs()[2]->Exists()) {
+      NodeArg* bias = QuantizeBias(graph, *node.InputDefs()[2], *x_inputs[1], *w_inputs[1]);
+      if (bias == nullptr) {
+        continue;
+      }
+      fused_inputs.push_back(bias);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("quantized " + node.Name()),
+                                     is_conv ? "QLinearConv" : "QLinearMatMul",
+                                     "quantized " + node.OpType() + " " + node.Name(),
+                                     fused_inputs,
+                                     const_cast<Node*>(quantize_output)->MutableOutputDefs(),
+                                     is_conv ? &node.GetAttributes() : nullptr,
+                                     kOnnxDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph_utils::RemoveNodeOutputEdges(graph, *const_cast<Node*>(quantize_output));
+    removed_nodes.push_front(quantize_output->Index());
+    removed_nodes.push_front(node.Index());
+    dequantize_nodes.insert(dequantize_input->Index());
+    dequantize_nodes.insert(dequantize_weight->Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  // the DequantizeLinear nodes only feeding fused nodes are no longer needed
+  for (auto dequantize_index : dequantize_nodes) {
+    const Node* dequantize = graph.GetNode(dequantize_index);
+    if (dequantize->GetOutputEdgesCount() == 0 && !graph.IsNodeOutputsInGraphOutputs(*dequantize)) {
+      graph.RemoveNode(dequantize_index);
+    }
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
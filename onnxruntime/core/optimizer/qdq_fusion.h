@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQFusion
+
+Fuses a MatMul, Conv or Add whose inputs are DequantizeLinear nodes and whose output only feeds a QuantizeLinear
+node into a QLinearMatMul, QLinearConv or QLinearAdd, so the operation runs on the quantized values. These are the
+patterns of models trained with quantize-dequantize pairs, and the form the quantizer emits models in (see
+core/session/quantization.h). QLinearAdd is a contrib op of the CPU execution provider.
+In builds using MLAS, the filter of a Conv may be quantized per output channel. A float bias
+of a Conv must be a constant initializer, which is quantized to int32 with the product of the input and filter
+scales.
+*/
+class QDQFusion : public GraphTransformer {
+ public:
+  QDQFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
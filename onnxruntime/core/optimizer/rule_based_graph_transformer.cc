@@ -49,10 +49,6 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
       continue;
     }
 
-    // Initialize the effect of rules on this node to denote that the graph has not yet been modified
-    // by the rule application on the current node.
-    auto rule_effect = RuleEffect::kNone;
- 
     if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
       continue;
     }
@@ -60,23 +56,36 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
     // First apply rewrite rules that are registered for the op type of the current node; then apply rules that are
     // registered to be applied regardless of the op type; then recursively apply rules to subgraphs (if any).
     // Stop further rule application for the current node, if the node gets removed by a rule.
-    const std::vector<std::reference_wrapper<const RewriteRule>>* rules = nullptr;
+    // While the rules keep modifying the graph around the node, they are applied again, so that a chain such as
+    // Conv+Add+Mul+BatchNormalization is folded in this pass instead of taking a graph transformation step per node.
+    auto rule_effect = RuleEffect::kNone;
+    for (unsigned round = 0; round < kMaxRoundsPerNode; ++round) {
+      // Initialize the effect of rules on this node to denote that the graph has not yet been modified
+      // by the rule application on the current node.
+      rule_effect = RuleEffect::kNone;
 
-    rules = GetRewriteRulesForOpType(node->OpType());
-    if (rules) {
-      ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, *node, *rules, rule_effect));
-    }
+      const std::vector<std::reference_wrapper<const RewriteRule>>* rules = nullptr;
 
-    if (rule_effect != RuleEffect::kRemovedCurrentNode) {
-      rules = GetAnyOpRewriteRules();
+      rules = GetRewriteRulesForOpType(node->OpType());
       if (rules) {
         ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, *node, *rules, rule_effect));
       }
-    }
 
-    // Update the modified field of the rule-based transformer.
-    if (rule_effect != RuleEffect::kNone) {
-      modified = true;
+      if (rule_effect != RuleEffect::kRemovedCurrentNode) {
+        rules = GetAnyOpRewriteRules();
+        if (rules) {
+          ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, *node, *rules, rule_effect));
+        }
+      }
+
+      // Update the modified field of the rule-based transformer.
+      if (rule_effect != RuleEffect::kNone) {
+        modified = true;
+      }
+
+      if (rule_effect == RuleEffect::kNone || rule_effect == RuleEffect::kRemovedCurrentNode) {
+        break;
+      }
     }
 
     if (rule_effect != RuleEffect::kRemovedCurrentNode) {
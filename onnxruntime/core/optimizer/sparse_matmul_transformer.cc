@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/sparse_matmul_transformer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// A weight is converted when at least this fraction of it is zero and it is large enough for the dense
+// multiplication to dominate the cost of the node.
+constexpr float kMinSparsity = 0.9f;
+constexpr int64_t kMinSparseElements = 16384;
+
+// Returns true if the bias of a Gemm holds a single value or one value per column of the output.
+bool IsRowBroadcastBias(const NodeArg& bias, int64_t columns) {
+  const TensorShapeProto* shape = bias.Shape();
+  if (shape == nullptr || bias.Type() == nullptr || *bias.Type() != "tensor(float)" || shape->dim_size() > 2) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const bool is_last = i == shape->dim_size() - 1;
+    if (!dim.has_dim_value() || (dim.dim_value() != 1 && !(is_last && dim.dim_value() == columns))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Collects the nonzeros of the [K, N] weight, stored transposed as [N, K] when transposed is set, into a
+// sparse tensor whose indices are the linear indices into [K, N] in increasing order.
+bool CreateSparseWeight(const TensorProto& weight_proto, bool transposed, SparseTensorProto& sparse_weight) {
+  Initializer weight(&weight_proto);
+  const float* data = weight.data<float>();
+  const int64_t rows = transposed ? weight_proto.dims(1) : weight_proto.dims(0);
+  const int64_t columns = transposed ? weight_proto.dims(0) : weight_proto.dims(1);
+  const int64_t size = rows * columns;
+
+  int64_t nnz = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    nnz += data[i] != 0.f;
+  }
+  if (size < kMinSparseElements || static_cast<float>(size - nnz) < kMinSparsity * static_cast<float>(size)) {
+    return false;
+  }
+
+  sparse_weight.add_dims(rows);
+  sparse_weight.add_dims(columns);
+  TensorProto& values = *sparse_weight.mutable_values();
+  TensorProto& indices = *sparse_weight.mutable_indices();
+  values.set_name(weight_proto.name() + "_values");
+  values.set_data_type(TensorProto_DataType_FLOAT);
+  values.add_dims(nnz);
+  indices.set_name(weight_proto.name() + "_indices");
+  indices.set_data_type(TensorProto_DataType_INT64);
+  indices.add_dims(nnz);
+  for (int64_t k = 0; k < rows; ++k) {
+    for (int64_t n = 0; n < columns; ++n) {
+      const float value = transposed ? data[n * rows + k] : data[k * columns + n];
+      if (value != 0.f) {
+        values.add_float_data(value);
+        indices.add_int64_data(k * columns + n);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status SparseMatMulTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+    if (!(is_gemm || graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    auto& inputs = node.MutableInputDefs();
+    NodeArg* input = inputs[0];
+    if (input->Type() == nullptr || *input->Type() != "tensor(float)") {
+      continue;
+    }
+
+    const auto* weight_proto = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+    if (weight_proto == nullptr || weight_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weight_proto->dims_size() != 2) {
+      continue;
+    }
+
+    bool transposed = false;
+    float alpha = 1.f;
+    float beta = 1.f;
+    NodeArg* bias = nullptr;
+    if (is_gemm) {
+      const auto* trans_a_attr = graph_utils::GetNodeAttribute(node, "transA");
+      const auto* trans_b_attr = graph_utils::GetNodeAttribute(node, "transB");
+      const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+      const auto* beta_attr = graph_utils::GetNodeAttribute(node, "beta");
+      if (trans_a_attr != nullptr && trans_a_attr->i() != 0) {
+        continue;
+      }
+      transposed = trans_b_attr != nullptr && trans_b_attr->i() != 0;
+      alpha = alpha_attr != nullptr ? alpha_attr->f() : 1.f;
+      beta = beta_attr != nullptr ? beta_attr->f() : 1.f;
+
+      if (inputs.size() > 2 && inputs[2]->Exists()) {
+        bias = inputs[2];
+        const int64_t columns = transposed ? weight_proto->dims(0) : weight_proto->dims(1);
+        if (!IsRowBroadcastBias(*bias, columns)) {
+          continue;
+        }
+      }
+    }
+
+    SparseTensorProto sparse_weight;
+    if (!CreateSparseWeight(*weight_proto, transposed, sparse_weight)) {
+      continue;
+    }
+
+    std::vector<NodeArg*> sparse_inputs{input};
+    if (bias != nullptr) {
+      sparse_inputs.push_back(bias);
+    }
+
+    Node& sparse_matmul = graph.AddNode(graph.GenerateNodeName("sparse " + node.Name()), "SparseMatMul",
+                                        "sparse " + node.OpType() + " " + node.Name(),
+                                        sparse_inputs,
+                                        node.MutableOutputDefs(),
+                                        nullptr,
+                                        kMSDomain);
+    sparse_matmul.AddAttribute("B", sparse_weight);
+    sparse_matmul.AddAttribute("alpha", alpha);
+    sparse_matmul.AddAttribute("beta", beta);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    sparse_matmul.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    removed_nodes.push_front(node.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
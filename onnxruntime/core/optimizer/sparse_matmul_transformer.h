@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SparseMatMulTransformer
+
+Replaces a MatMul or Gemm whose weight is a large, mostly zero constant initializer with a SparseMatMul node
+holding the nonzeros of the weight as a sparse tensor attribute, so the multiplication only visits them.
+A Gemm carries its alpha, beta and bias over when the bias broadcasts along the rows of the output.
+*/
+class SparseMatMulTransformer : public GraphTransformer {
+ public:
+  SparseMatMulTransformer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SparseMatMulTransformer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,470 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include "core/optimizer/symbolic_shape_folding.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// A dimension of a shape value, which is either a known value or a symbol for a value that is only known at
+// run time. Dimensions with the same symbol hold the same value.
+struct SymbolicDim {
+  int64_t value = 0;
+  std::string symbol;
+
+  bool IsKnown() const { return symbol.empty(); }
+};
+
+// The value of an int64 scalar or vector computing a shape.
+struct ShapeValue {
+  std::vector<SymbolicDim> dims;
+  bool is_scalar = false;
+
+  bool IsKnown() const {
+    return std::all_of(dims.begin(), dims.end(), [](const SymbolicDim& dim) { return dim.IsKnown(); });
+  }
+};
+
+SymbolicDim KnownDim(int64_t value) {
+  SymbolicDim dim;
+  dim.value = value;
+  return dim;
+}
+
+// Returns a symbol that is only equal to itself, for a value that can't be expressed by the other symbols.
+SymbolicDim UniqueDim(const NodeArg& arg, size_t index) {
+  SymbolicDim dim;
+  dim.symbol = "?" + arg.Name() + ":" + std::to_string(index);
+  return dim;
+}
+
+// Returns the dimension at index of the inferred shape of arg. Dimensions without a value or a name from
+// shape inference are still the same for every Shape of arg.
+SymbolicDim GetShapeDim(const NodeArg& arg, int index) {
+  const auto& dim = arg.Shape()->dim(index);
+  if (utils::HasDimValue(dim)) {
+    return KnownDim(dim.dim_value());
+  }
+  if (utils::HasDimParam(dim)) {
+    SymbolicDim result;
+    result.symbol = dim.dim_param();
+    return result;
+  }
+  return UniqueDim(arg, index);
+}
+
+// Tracks the values of the int64 scalars and vectors computing shapes. Constant initializers are read when
+// they are first used.
+class ShapeValueMap {
+ public:
+  explicit ShapeValueMap(const Graph& graph) : graph_(graph) {}
+
+  // Returns the value of arg, or nullptr if it isn't tracked.
+  const ShapeValue* Get(const NodeArg& arg) {
+    auto it = values_.find(&arg);
+    if (it != values_.end()) {
+      return &it->second;
+    }
+
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, arg.Name());
+    if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+        tensor_proto->dims_size() > 1) {
+      return nullptr;
+    }
+
+    std::vector<int64_t> data;
+    if (tensor_proto->has_raw_data()) {
+      const std::string& raw_data = tensor_proto->raw_data();
+      data.resize(raw_data.size() / sizeof(int64_t));
+      std::memcpy(data.data(), raw_data.data(), data.size() * sizeof(int64_t));
+    } else {
+      data.assign(tensor_proto->int64_data().begin(), tensor_proto->int64_data().end());
+    }
+    const int64_t size = tensor_proto->dims_size() == 0 ? 1 : tensor_proto->dims(0);
+    if (static_cast<int64_t>(data.size()) != size) {
+      return nullptr;
+    }
+
+    ShapeValue value;
+    value.is_scalar = tensor_proto->dims_size() == 0;
+    for (auto element : data) {
+      value.dims.push_back(KnownDim(element));
+    }
+    return &values_.emplace(&arg, std::move(value)).first->second;
+  }
+
+  void Set(const NodeArg& arg, ShapeValue value) {
+    values_[&arg] = std::move(value);
+  }
+
+ private:
+  const Graph& graph_;
+  std::unordered_map<const NodeArg*, ShapeValue> values_;
+};
+
+// Returns the tracked vector input of node at index, or nullptr.
+const ShapeValue* GetVectorInput(const Node& node, size_t index, ShapeValueMap& values) {
+  if (index >= node.InputDefs().size() || !node.InputDefs()[index]->Exists()) {
+    return nullptr;
+  }
+  const ShapeValue* value = values.Get(*node.InputDefs()[index]);
+  return value != nullptr && !value->is_scalar ? value : nullptr;
+}
+
+// Reads the known elements of the input of node at index.
+bool GetKnownInput(const Node& node, size_t index, ShapeValueMap& values, std::vector<int64_t>& elements) {
+  const ShapeValue* value = GetVectorInput(node, index, values);
+  if (value == nullptr || !value->IsKnown()) {
+    return false;
+  }
+  elements.clear();
+  for (const auto& dim : value->dims) {
+    elements.push_back(dim.value);
+  }
+  return true;
+}
+
+// Returns true if the axis attribute of node is missing or selects the only axis of a vector.
+bool IsFirstAxis(const Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  return axis_attr == nullptr || axis_attr->i() == 0 || axis_attr->i() == -1;
+}
+
+bool ComputeGather(const Node& node, ShapeValueMap& values, ShapeValue& result) {
+  const ShapeValue* data = GetVectorInput(node, 0, values);
+  const ShapeValue* indices = values.Get(*node.InputDefs()[1]);
+  if (data == nullptr || indices == nullptr || !indices->IsKnown() || !IsFirstAxis(node)) {
+    return false;
+  }
+
+  const int64_t size = static_cast<int64_t>(data->dims.size());
+  for (const auto& index_dim : indices->dims) {
+    const int64_t index = index_dim.value < 0 ? index_dim.value + size : index_dim.value;
+    if (index < 0 || index >= size) {
+      return false;
+    }
+    result.dims.push_back(data->dims[index]);
+  }
+  result.is_scalar = indices->is_scalar;
+  return true;
+}
+
+bool ComputeSlice(const Node& node, ShapeValueMap& values, ShapeValue& result) {
+  const ShapeValue* data = GetVectorInput(node, 0, values);
+  if (data == nullptr) {
+    return false;
+  }
+
+  std::vector<int64_t> starts;
+  std::vector<int64_t> ends;
+  std::vector<int64_t> axes;
+  if (node.Op()->SinceVersion() == 1) {
+    if (!graph_utils::GetRepeatedNodeAttributeValues(node, "starts", starts) ||
+        !graph_utils::GetRepeatedNodeAttributeValues(node, "ends", ends)) {
+      return false;
+    }
+    graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes);
+  } else {
+    std::vector<int64_t> steps;
+    if (!GetKnownInput(node, 1, values, starts) || !GetKnownInput(node, 2, values, ends) ||
+        (node.InputDefs().size() > 3 && node.InputDefs()[3]->Exists() && !GetKnownInput(node, 3, values, axes)) ||
+        (node.InputDefs().size() > 4 && node.InputDefs()[4]->Exists() &&
+         (!GetKnownInput(node, 4, values, steps) ||
+          std::any_of(steps.begin(), steps.end(), [](int64_t step) { return step != 1; })))) {
+      return false;
+    }
+  }
+
+  if (starts.size() != 1 || ends.size() != 1 || axes.size() > 1 ||
+      (axes.size() == 1 && axes[0] != 0 && axes[0] != -1)) {
+    return false;
+  }
+
+  const int64_t size = static_cast<int64_t>(data->dims.size());
+  auto clamp = [size](int64_t index) {
+    return std::min(std::max(index < 0 ? index + size : index, static_cast<int64_t>(0)), size);
+  };
+  const int64_t start = clamp(starts[0]);
+  const int64_t end = clamp(ends[0]);
+  for (int64_t i = start; i < end; ++i) {
+    result.dims.push_back(data->dims[i]);
+  }
+  return true;
+}
+
+bool ComputeBinaryOp(const Node& node, ShapeValueMap& values, ShapeValue& result) {
+  const ShapeValue* lhs = values.Get(*node.InputDefs()[0]);
+  const ShapeValue* rhs = values.Get(*node.InputDefs()[1]);
+  if (lhs == nullptr || rhs == nullptr ||
+      (lhs->dims.size() != rhs->dims.size() && lhs->dims.size() != 1 && rhs->dims.size() != 1)) {
+    return false;
+  }
+
+  const std::string& op_type = node.OpType();
+  const size_t size = lhs->dims.size() == 1 ? rhs->dims.size() : lhs->dims.size();
+  for (size_t i = 0; i < size; ++i) {
+    const SymbolicDim& a = lhs->dims[lhs->dims.size() == 1 ? 0 : i];
+    const SymbolicDim& b = rhs->dims[rhs->dims.size() == 1 ? 0 : i];
+    if (a.IsKnown() && b.IsKnown()) {
+      if (op_type == "Add") {
+        result.dims.push_back(KnownDim(a.value + b.value));
+      } else if (op_type == "Sub") {
+        result.dims.push_back(KnownDim(a.value - b.value));
+      } else if (op_type == "Mul") {
+        result.dims.push_back(KnownDim(a.value * b.value));
+      } else if (b.value != 0) {
+        result.dims.push_back(KnownDim(a.value / b.value));
+      } else {
+        return false;
+      }
+    } else if (b.IsKnown() && ((b.value == 0 && (op_type == "Add" || op_type == "Sub")) ||
+                               (b.value == 1 && (op_type == "Mul" || op_type == "Div")))) {
+      result.dims.push_back(a);
+    } else if (a.IsKnown() && ((a.value == 0 && op_type == "Add") || (a.value == 1 && op_type == "Mul"))) {
+      result.dims.push_back(b);
+    } else {
+      result.dims.push_back(UniqueDim(*node.OutputDefs()[0], i));
+    }
+  }
+  result.is_scalar = lhs->is_scalar && rhs->is_scalar;
+  return true;
+}
+
+// Computes the value of the output of node if it is a shape computation, with the inputs it needs tracked.
+bool ComputeValue(const Node& node, ShapeValueMap& values, ShapeValue& result) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Shape", {1})) {
+    const NodeArg& input = *node.InputDefs()[0];
+    if (input.Shape() == nullptr) {
+      return false;
+    }
+    for (int i = 0; i < input.Shape()->dim_size(); ++i) {
+      result.dims.push_back(GetShapeDim(input, i));
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1})) {
+    return ComputeGather(node, values, result);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {1, 10})) {
+    return ComputeSlice(node, values, result);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
+    if (!IsFirstAxis(node)) {
+      return false;
+    }
+    for (size_t i = 0; i < node.InputDefs().size(); ++i) {
+      const ShapeValue* input = GetVectorInput(node, i, values);
+      if (input == nullptr) {
+        return false;
+      }
+      result.dims.insert(result.dims.end(), input->dims.begin(), input->dims.end());
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1})) {
+    const ShapeValue* input = values.Get(*node.InputDefs()[0]);
+    std::vector<int64_t> axes;
+    if (input == nullptr || !input->is_scalar ||
+        !graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes != std::vector<int64_t>{0}) {
+      return false;
+    }
+    result.dims = input->dims;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1})) {
+    const ShapeValue* input = GetVectorInput(node, 0, values);
+    std::vector<int64_t> axes;
+    if (input == nullptr || input->dims.size() != 1 ||
+        (graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) && axes != std::vector<int64_t>{0})) {
+      return false;
+    }
+    result.dims = input->dims;
+    result.is_scalar = true;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9})) {
+    // Only int64 values are tracked, so a Cast to int64 of a tracked value is an identity.
+    const auto* to_attr = graph_utils::GetNodeAttribute(node, "to");
+    const ShapeValue* input = values.Get(*node.InputDefs()[0]);
+    if (to_attr == nullptr || to_attr->i() != TensorProto_DataType_INT64 || input == nullptr) {
+      return false;
+    }
+    result = *input;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7})) {
+    return ComputeBinaryOp(node, values, result);
+  }
+
+  return false;
+}
+
+// Removes the node at index if its outputs are no longer used, then does the same for the shape nodes
+// producing its inputs.
+void RemoveIfUnused(Graph& graph, NodeIndex index, const std::unordered_set<NodeIndex>& shape_nodes) {
+  std::vector<NodeIndex> candidates{index};
+  while (!candidates.empty()) {
+    auto* node = graph.GetNode(candidates.back());
+    candidates.pop_back();
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || graph.IsNodeOutputsInGraphOutputs(*node)) {
+      continue;
+    }
+
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      if (shape_nodes.count(it->Index()) != 0) {
+        candidates.push_back(it->Index());
+      }
+    }
+    graph.RemoveNode(node->Index());
+  }
+}
+
+TensorProto MakeInt64Tensor(const std::string& name, const ShapeValue& value) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  if (!value.is_scalar) {
+    tensor_proto.add_dims(static_cast<int64_t>(value.dims.size()));
+  }
+  for (const auto& dim : value.dims) {
+    tensor_proto.add_int64_data(dim.value);
+  }
+  return tensor_proto;
+}
+
+// Replaces a shape input of Reshape that is not fully known by a constant, with 0 for the dimensions that
+// copy the input dimension at the same index and -1 for a single dimension that is left to infer.
+bool FoldReshapeShape(Graph& graph, Node& reshape, ShapeValueMap& values,
+                      const std::unordered_set<NodeIndex>& shape_nodes) {
+  const NodeArg& data = *reshape.InputDefs()[0];
+  const NodeArg& shape = *reshape.InputDefs()[1];
+  const ShapeValue* target = values.Get(shape);
+  if (target == nullptr || target->is_scalar || graph_utils::NodeArgIsConstant(graph, shape)) {
+    return false;
+  }
+
+  ShapeValue new_shape;
+  int inferred_index = -1;
+  for (size_t i = 0; i < target->dims.size(); ++i) {
+    const SymbolicDim& dim = target->dims[i];
+    if (dim.IsKnown()) {
+      new_shape.dims.push_back(dim);
+    } else if (data.Shape() != nullptr && static_cast<int>(i) < data.Shape()->dim_size() &&
+               GetShapeDim(data, static_cast<int>(i)).symbol == dim.symbol) {
+      new_shape.dims.push_back(KnownDim(0));
+    } else if (inferred_index == -1) {
+      inferred_index = static_cast<int>(i);
+      new_shape.dims.push_back(KnownDim(-1));
+    } else {
+      return false;
+    }
+  }
+
+  // The inferred dimension is the size of the input divided by the other dimensions, which only gives the
+  // original value if those are known and not zero.
+  if (inferred_index != -1) {
+    for (size_t i = 0; i < new_shape.dims.size(); ++i) {
+      if (static_cast<int>(i) != inferred_index && new_shape.dims[i].value <= 0) {
+        return false;
+      }
+    }
+  }
+
+  TensorProto shape_initializer_proto = MakeInt64Tensor(graph.GenerateNodeArgName(reshape.Name() + "_shape"),
+                                                        new_shape);
+  graph.AddInitializedTensor(shape_initializer_proto);
+  TypeProto shape_type;
+  shape_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  shape_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(new_shape.dims.size());
+  auto& new_shape_arg = graph.GetOrCreateNodeArg(shape_initializer_proto.name(), &shape_type);
+
+  // Disconnect the subgraph computing the shape, and remove it if nothing else uses it.
+  const Node::EdgeEnd* shape_edge = nullptr;
+  for (auto it = reshape.InputEdgesBegin(); it != reshape.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 1) {
+      shape_edge = &*it;
+    }
+  }
+  if (shape_edge != nullptr) {
+    const NodeIndex producer_index = shape_edge->GetNode().Index();
+    graph.RemoveEdge(producer_index, reshape.Index(), shape_edge->GetSrcArgIndex(), 1);
+    reshape.MutableInputDefs()[1] = &new_shape_arg;
+    if (shape_nodes.count(producer_index) != 0) {
+      RemoveIfUnused(graph, producer_index, shape_nodes);
+    }
+  } else {
+    reshape.MutableInputDefs()[1] = &new_shape_arg;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+Status SymbolicShapeFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  ShapeValueMap values(graph);
+  // the nodes whose outputs are tracked, which are removed once their outputs are no longer used
+  std::unordered_set<NodeIndex> shape_nodes;
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Reshape", {5})) {
+      if (FoldReshapeShape(graph, *node, values, shape_nodes)) {
+        modified = true;
+      }
+      continue;
+    }
+
+    ShapeValue value;
+    if (node->OutputDefs().size() != 1 || !ComputeValue(*node, values, value)) {
+      continue;
+    }
+
+    const NodeArg& output = *node->OutputDefs()[0];
+    const bool is_known = value.IsKnown();
+    values.Set(output, std::move(value));
+    shape_nodes.insert(index);
+
+    // Replace a fully known value by an initializer with the same name, as ShapeToInitializer does.
+    if (is_known && !graph.IsNodeOutputsInGraphOutputs(*node)) {
+      TensorProto initializer_proto = MakeInt64Tensor(output.Name(), *values.Get(output));
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      RemoveIfUnused(graph, index, shape_nodes);
+      graph.AddInitializedTensor(initializer_proto);
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
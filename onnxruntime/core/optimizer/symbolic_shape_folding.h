@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class SymbolicShapeFolding
+
+Transformer that evaluates the subgraphs computing shapes at load time. The value of every int64 scalar or
+vector produced by Shape, Gather, Slice, Concat, Unsqueeze, Squeeze, Cast and integer arithmetic is tracked
+as a list of dimensions, which are either known values or symbols taken from the inferred shapes, such as a
+dynamic batch dimension. Values that turn out to be fully known are replaced by initializers. The shape input
+of a Reshape that is not fully known is replaced by a constant if every symbolic dimension either copies the
+input dimension at the same index (0) or is the only dimension left to infer (-1). The nodes of the shape
+subgraphs that are no longer used are removed.
+*/
+class SymbolicShapeFolding : public GraphTransformer {
+ public:
+  SymbolicShapeFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SymbolicShapeFolding", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
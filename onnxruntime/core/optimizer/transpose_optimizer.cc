@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// Element-wise ops with a single input and output, which commute with any Transpose.
+bool IsLayoutAgnosticUnaryOp(const Node& node) {
+  static const std::unordered_set<std::string> op_types = {
+      "Abs", "Ceil", "Elu", "Erf", "Exp", "Floor", "HardSigmoid", "Identity", "LeakyRelu", "Log",
+      "Neg", "Not", "Reciprocal", "Relu", "Round", "Selu", "Sigmoid", "Sign", "Softplus", "Softsign",
+      "Sqrt", "Tanh", "ThresholdedRelu"};
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) && op_types.count(node.OpType()) != 0 &&
+         node.InputDefs().size() == 1 && node.OutputDefs().size() == 1;
+}
+
+// Element-wise ops with two broadcast inputs and a single output. Transposing both inputs with the
+// same permutation transposes the output.
+bool IsLayoutAgnosticBinaryOp(const Node& node) {
+  static const std::unordered_set<std::string> op_types = {
+      "Add", "And", "Div", "Equal", "Greater", "Less", "Max", "Min", "Mul", "Or", "Pow", "Sub", "Sum", "Xor"};
+  return graph_utils::MatchesOpSetDomain(node, kOnnxDomain) && op_types.count(node.OpType()) != 0 &&
+         node.InputDefs().size() == 2 && node.OutputDefs().size() == 1;
+}
+
+// Reads the permutation of a Transpose, which reverses the dimensions if the attribute is missing.
+bool GetPermutation(const Node& transpose, std::vector<int64_t>& perm) {
+  if (graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm)) {
+    return true;
+  }
+
+  const auto* shape = transpose.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  perm.resize(shape->dim_size());
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    perm[i] = shape->dim_size() - 1 - i;
+  }
+  return true;
+}
+
+bool IsIdentityPermutation(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if arg is a constant with a single element, which broadcasts the same way to any layout.
+bool IsScalarConstant(const Graph& graph, const NodeArg& arg) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->dims_size() > 1) {
+    return false;
+  }
+  return tensor_proto->dims_size() == 0 || tensor_proto->dims(0) == 1;
+}
+
+// Adds a copy of node reading inputs, and returns its output, whose shape is left to be inferred.
+NodeArg& AddNodeCopy(Graph& graph, const Node& node, const std::vector<NodeArg*>& inputs) {
+  TypeProto type(*node.OutputDefs()[0]->TypeAsProto());
+  type.mutable_tensor_type()->clear_shape();
+  auto& output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(node.Name()), &type);
+
+  Node& copy = graph.AddNode(graph.GenerateNodeName(node.Name()), node.OpType(), node.Description(),
+                             inputs, {&output}, &node.GetAttributes(), node.Domain());
+  copy.SetExecutionProviderType(node.GetExecutionProviderType());
+  return output;
+}
+
+void AddTranspose(Graph& graph, const Node& transpose, NodeArg& input, NodeArg& output,
+                  const std::vector<int64_t>& perm) {
+  Node& node = graph.AddNode(graph.GenerateNodeName(transpose.Name()), "Transpose", transpose.Description(),
+                             {&input}, {&output});
+  node.AddAttribute("perm", perm);
+  node.SetExecutionProviderType(transpose.GetExecutionProviderType());
+}
+
+// Removes an identity Transpose whose output can't be bypassed because it is a graph output, by making the
+// node producing its input write the graph output directly.
+bool RemoveIdentityAtGraphOutput(Graph& graph, Node& transpose) {
+  if (transpose.GetInputEdgesCount() != 1) {
+    return false;
+  }
+
+  const Node& producer = *transpose.InputNodesBegin();
+  if (!graph_utils::HasSingleConsumer(graph, producer)) {
+    return false;
+  }
+
+  Node& node = *graph.GetNode(producer.Index());
+  auto& outputs = node.MutableOutputDefs();
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (outputs[i] == transpose.InputDefs()[0]) {
+      graph.RemoveEdge(node.Index(), transpose.Index(), static_cast<int>(i), 0);
+      outputs[i] = transpose.MutableOutputDefs()[0];
+      graph.RemoveNode(transpose.Index());
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  // Every pass moves each Transpose by one node, and the graph is resolved between passes so the
+  // next pass sees the new edges. Nodes replaced in a pass are not matched again in the same pass.
+  for (bool first_pass = true;; first_pass = false) {
+    GraphViewer graph_viewer(graph);
+    const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+    std::unordered_set<NodeIndex> replaced_nodes;
+    bool removed_identity = false;
+    for (NodeIndex index : order) {
+      auto* node = graph.GetNode(index);
+      if (!node) {
+        continue;
+      }
+
+      if (first_pass) {
+        ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+      }
+
+      std::vector<int64_t> perm;
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Transpose", {1}) ||
+          !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+          replaced_nodes.count(index) != 0 || !GetPermutation(*node, perm)) {
+        continue;
+      }
+
+      Node& transpose = *node;
+      if (IsIdentityPermutation(perm)) {
+        if (graph_utils::RemoveNode(graph, transpose) || RemoveIdentityAtGraphOutput(graph, transpose)) {
+          removed_identity = true;
+        }
+        continue;
+      }
+
+      if (!graph_utils::HasSingleConsumer(graph, transpose)) {
+        continue;
+      }
+
+      NodeArg& input = *transpose.MutableInputDefs()[0];
+      const NodeArg* transposed = transpose.OutputDefs()[0];
+      const Node& consumer = *transpose.OutputNodesBegin();
+      if (replaced_nodes.count(consumer.Index()) != 0 ||
+          !graph_utils::IsSupportedProvider(consumer, GetCompatibleExecutionProviders())) {
+        continue;
+      }
+      NodeArg& output = *const_cast<Node&>(consumer).MutableOutputDefs()[0];
+
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Transpose", {1})) {
+        // Transpose(Transpose(x, p), q) is Transpose(x, c) with c[i] = p[q[i]].
+        std::vector<int64_t> consumer_perm;
+        if (!GetPermutation(consumer, consumer_perm) || consumer_perm.size() != perm.size()) {
+          continue;
+        }
+        std::vector<int64_t> combined_perm(perm.size());
+        for (size_t i = 0; i < perm.size(); ++i) {
+          combined_perm[i] = perm[consumer_perm[i]];
+        }
+        AddTranspose(graph, transpose, input, output, combined_perm);
+      } else if (output.TypeAsProto() == nullptr) {
+        continue;
+      } else if (IsLayoutAgnosticUnaryOp(consumer)) {
+        NodeArg& result = AddNodeCopy(graph, consumer, {&input});
+        AddTranspose(graph, transpose, result, output, perm);
+      } else if (IsLayoutAgnosticBinaryOp(consumer)) {
+        const auto& consumer_inputs = consumer.InputDefs();
+        const int transposed_index = consumer_inputs[0] == transposed ? 0 : 1;
+        NodeArg* other = const_cast<Node&>(consumer).MutableInputDefs()[1 - transposed_index];
+        if (other == transposed) {
+          continue;
+        }
+
+        // The other input must be transposed the same way, or be a scalar that is not affected by it.
+        const Node* other_transpose = nullptr;
+        for (auto it = consumer.InputNodesBegin(); it != consumer.InputNodesEnd(); ++it) {
+          if (it->OutputDefs()[0] == other) {
+            other_transpose = &*it;
+          }
+        }
+
+        std::vector<int64_t> other_perm;
+        if (other_transpose != nullptr &&
+            graph_utils::IsSupportedOptypeVersionAndDomain(*other_transpose, "Transpose", {1}) &&
+            replaced_nodes.count(other_transpose->Index()) == 0 &&
+            graph_utils::HasSingleConsumer(graph, *other_transpose) &&
+            GetPermutation(*other_transpose, other_perm) && other_perm == perm) {
+          other = const_cast<Node*>(other_transpose)->MutableInputDefs()[0];
+          replaced_nodes.insert(other_transpose->Index());
+        } else if (!IsScalarConstant(graph, *other)) {
+          continue;
+        }
+
+        std::vector<NodeArg*> inputs(2);
+        inputs[transposed_index] = &input;
+        inputs[1 - transposed_index] = other;
+        NodeArg& result = AddNodeCopy(graph, consumer, inputs);
+        AddTranspose(graph, transpose, result, output, perm);
+      } else {
+        continue;
+      }
+
+      replaced_nodes.insert(transpose.Index());
+      replaced_nodes.insert(consumer.Index());
+    }
+
+    for (auto replaced_node : replaced_nodes) {
+      graph.RemoveNode(replaced_node);
+    }
+
+    if (replaced_nodes.empty() && !removed_identity) {
+      break;
+    }
+
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
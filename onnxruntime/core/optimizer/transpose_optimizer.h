@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class TransposeOptimizer
+
+Transformer that moves Transpose nodes towards each other until they cancel. A Transpose feeding a
+layout agnostic element-wise op is pushed below it: through unary ops, and through binary ops whose
+other input is a Transpose with the same permutation or a scalar constant. Consecutive Transposes
+are merged into one and Transposes with the identity permutation are removed. This removes the
+Transpose pairs that converters insert around layout sensitive ops such as Conv.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
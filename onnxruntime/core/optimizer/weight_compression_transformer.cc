@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/weight_compression_transformer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/util/math.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+// A weight is compressed when it is large enough for its memory to matter.
+constexpr int64_t kMinCompressedElements = 4096;
+
+// the largest magnitude float16 holds
+constexpr float kMaxFloat16 = 65504.f;
+
+// Returns true if the bias of a Gemm holds a single value or one value per column of the output.
+bool IsRowBroadcastBias(const NodeArg& bias, int64_t columns) {
+  const TensorShapeProto* shape = bias.Shape();
+  if (shape == nullptr || bias.Type() == nullptr || *bias.Type() != "tensor(float)" || shape->dim_size() > 2) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const bool is_last = i == shape->dim_size() - 1;
+    if (!dim.has_dim_value() || (dim.dim_value() != 1 && !(is_last && dim.dim_value() == columns))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Converts the float weight to the compressed tensor named name, and sets the scale its values are multiplied by.
+// Returns false if the weight can't be compressed.
+bool CompressWeight(const TensorProto& weight_proto, WeightCompression compression, const std::string& name,
+                    TensorProto& compressed_proto, float& scale) {
+  Initializer weight(&weight_proto);
+  const float* data = weight.data<float>();
+  const int64_t size = weight.size();
+
+  float max_magnitude = 0.f;
+  for (int64_t i = 0; i < size; ++i) {
+    // a NaN fails the comparison and becomes the maximum, so the weight isn't compressed
+    if (!(std::abs(data[i]) <= max_magnitude)) {
+      max_magnitude = std::abs(data[i]);
+    }
+  }
+  if (!std::isfinite(max_magnitude)) {
+    return false;
+  }
+
+  compressed_proto.set_name(name);
+  compressed_proto.mutable_dims()->CopyFrom(weight_proto.dims());
+  if (compression == WeightCompression::kFloat16) {
+    if (max_magnitude > kMaxFloat16) {
+      return false;
+    }
+
+    std::string raw_data(static_cast<size_t>(size) * sizeof(uint16_t), '\0');
+    auto* float16_data = reinterpret_cast<uint16_t*>(&raw_data[0]);
+    for (int64_t i = 0; i < size; ++i) {
+      float16_data[i] = math::floatToHalf(data[i]);
+    }
+    compressed_proto.set_data_type(TensorProto_DataType_FLOAT16);
+    compressed_proto.set_raw_data(std::move(raw_data));
+    scale = 1.f;
+  } else {
+    // symmetric, so the weight is the integers times the scale
+    scale = max_magnitude > 0.f ? max_magnitude / 127.f : 1.f;
+    std::string raw_data(static_cast<size_t>(size), '\0');
+    auto* int8_data = reinterpret_cast<int8_t*>(&raw_data[0]);
+    for (int64_t i = 0; i < size; ++i) {
+      const float value = std::nearbyint(data[i] / scale);
+      int8_data[i] = static_cast<int8_t>(std::min(std::max(value, -127.f), 127.f));
+    }
+    compressed_proto.set_data_type(TensorProto_DataType_INT8);
+    compressed_proto.set_raw_data(std::move(raw_data));
+  }
+  return true;
+}
+
+}  // namespace
+
+Status WeightCompressionTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  if (compression_ == WeightCompression::kNone) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the compressed weights, by the name of the weight, so a weight shared by several nodes is converted once
+  std::unordered_map<std::string, std::pair<NodeArg*, float>> compressed_weights;
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  for (auto index : order) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11});
+    if (!(is_gemm || graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the 1-D inputs of a MatMul drop a dimension of the output, which CompressedMatMul doesn't
+    auto& inputs = node.MutableInputDefs();
+    NodeArg* input = inputs[0];
+    if (input->Type() == nullptr || *input->Type() != "tensor(float)" || input->Shape() == nullptr ||
+        input->Shape()->dim_size() < 2) {
+      continue;
+    }
+
+    const auto* weight_proto = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+    if (weight_proto == nullptr || weight_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weight_proto->dims_size() != 2 || weight_proto->dims(0) * weight_proto->dims(1) < kMinCompressedElements) {
+      continue;
+    }
+
+    bool transposed = false;
+    float alpha = 1.f;
+    float beta = 1.f;
+    NodeArg* bias = nullptr;
+    if (is_gemm) {
+      const auto* trans_a_attr = graph_utils::GetNodeAttribute(node, "transA");
+      const auto* trans_b_attr = graph_utils::GetNodeAttribute(node, "transB");
+      const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+      const auto* beta_attr = graph_utils::GetNodeAttribute(node, "beta");
+      if (trans_a_attr != nullptr && trans_a_attr->i() != 0) {
+        continue;
+      }
+      transposed = trans_b_attr != nullptr && trans_b_attr->i() != 0;
+      alpha = alpha_attr != nullptr ? alpha_attr->f() : 1.f;
+      beta = beta_attr != nullptr ? beta_attr->f() : 1.f;
+
+      if (inputs.size() > 2 && inputs[2]->Exists()) {
+        bias = inputs[2];
+        const int64_t columns = transposed ? weight_proto->dims(0) : weight_proto->dims(1);
+        if (!IsRowBroadcastBias(*bias, columns)) {
+          continue;
+        }
+      }
+    }
+
+    auto compressed = compressed_weights.find(inputs[1]->Name());
+    if (compressed == compressed_weights.end()) {
+      TensorProto compressed_proto;
+      float scale;
+      const std::string name = graph.GenerateNodeArgName(
+          inputs[1]->Name() + (compression_ == WeightCompression::kFloat16 ? "_float16" : "_int8"));
+      if (!CompressWeight(*weight_proto, compression_, name, compressed_proto, scale)) {
+        continue;
+      }
+
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(compressed_proto.data_type());
+      auto* shape = type.mutable_tensor_type()->mutable_shape();
+      for (auto dim : compressed_proto.dims()) {
+        shape->add_dim()->set_dim_value(dim);
+      }
+      NodeArg& compressed_arg = graph.GetOrCreateNodeArg(name, &type);
+      graph.AddInitializedTensor(compressed_proto);
+      compressed = compressed_weights.emplace(inputs[1]->Name(), std::make_pair(&compressed_arg, scale)).first;
+    }
+
+    std::vector<NodeArg*> compressed_inputs{input, compressed->second.first};
+    if (bias != nullptr) {
+      compressed_inputs.push_back(bias);
+    }
+
+    Node& compressed_matmul = graph.AddNode(graph.GenerateNodeName("compressed " + node.Name()), "CompressedMatMul",
+                                            "compressed " + node.OpType() + " " + node.Name(),
+                                            compressed_inputs,
+                                            node.MutableOutputDefs(),
+                                            nullptr,
+                                            kMSDomain);
+    compressed_matmul.AddAttribute("transB", static_cast<int64_t>(transposed));
+    compressed_matmul.AddAttribute("alpha", alpha);
+    compressed_matmul.AddAttribute("beta", beta);
+    compressed_matmul.AddAttribute("scale", compressed->second.second);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    compressed_matmul.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    removed_nodes.push_front(node.Index());
+  }
+
+  for (auto removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+// The format the float weights of MatMul and Gemm nodes are stored in. See WeightCompressionTransformer.
+enum class WeightCompression {
+  kNone,
+  // half precision, half of the size of the weights
+  kFloat16,
+  // signed 8-bit integers with a scale per weight, a quarter of the size of the weights
+  kInt8
+};
+
+/**
+@Class WeightCompressionTransformer
+
+Replaces a MatMul or Gemm whose weight is a large constant float initializer with a CompressedMatMul node reading
+the weight converted to float16, or to int8 with a scale, so the session holds the weight at half or a quarter of
+its size. The weight is expanded back to float a panel at a time while the multiplication packs it, without a
+quantization of the activations. A Gemm carries its alpha, beta and bias over when the bias broadcasts along the
+rows of the output.
+*/
+class WeightCompressionTransformer : public GraphTransformer {
+ public:
+  WeightCompressionTransformer(WeightCompression compression,
+                               const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("WeightCompressionTransformer", compatible_execution_providers),
+        compression_{compression} {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+
+  const WeightCompression compression_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/zipmap_elimination.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status ZipMapElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  ORT_UNUSED_PARAMETER(graph_level);
+
+  // ZipMap nodes are only removed from the main graph, whose outputs are what the caller receives.
+  if (graph.IsSubgraph()) {
+    return Status::OK();
+  }
+
+  std::vector<NodeIndex> zipmaps;
+  for (auto& node : graph.Nodes()) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ZipMap", {1}, kMLDomain) &&
+        node.GetOutputEdgesCount() == 0 && graph.IsNodeOutputsInGraphOutputs(node) &&
+        node.GetInputEdgesCount() == 1) {
+      zipmaps.push_back(node.Index());
+    }
+  }
+
+  for (auto index : zipmaps) {
+    Node& zipmap = *graph.GetNode(index);
+    const NodeArg* probabilities = zipmap.InputDefs()[0];
+    const auto* type = probabilities->TypeAsProto();
+    if (type == nullptr || *probabilities->Type() != "tensor(float)" ||
+        std::find(graph.GetOutputs().cbegin(), graph.GetOutputs().cend(), probabilities) != graph.GetOutputs().cend()) {
+      continue;
+    }
+
+    // The probabilities must only be read by the ZipMap, since the producer writes to the graph output instead.
+    const Node::EdgeEnd& input_edge = *zipmap.InputEdgesBegin();
+    Node& producer = *graph.GetNode(input_edge.GetNode().Index());
+    const int output_index = input_edge.GetSrcArgIndex();
+    bool has_other_consumers = false;
+    for (auto it = producer.OutputEdgesBegin(); it != producer.OutputEdgesEnd(); ++it) {
+      if (it->GetSrcArgIndex() == output_index && it->GetNode().Index() != index) {
+        has_other_consumers = true;
+      }
+    }
+    if (has_other_consumers) {
+      continue;
+    }
+
+    NodeArg* output = zipmap.MutableOutputDefs()[0];
+    graph.SetNodeArgType(*output, *type);
+    graph.RemoveNode(index);
+    producer.MutableOutputDefs()[output_index] = output;
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapElimination
+
+Removes the ZipMap nodes producing outputs of the main graph, so the node producing their float input writes to
+the graph output instead. The graph output then holds a float tensor with one row per sample and one column per
+class label, in the order of the labels of the ZipMap, instead of a sequence of one map per sample.
+Only applied when requested through SessionOptions::enable_zipmap_elimination, since it changes the output types.
+*/
+class ZipMapElimination : public GraphTransformer {
+ public:
+  ZipMapElimination() noexcept : GraphTransformer("ZipMapElimination") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
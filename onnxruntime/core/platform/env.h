@@ -73,6 +73,43 @@ class Env {
   /// On Windows, it's the min time to sleep, not the actual one.
   virtual void SleepForMicroseconds(int64_t micros) const = 0;
 
+  /// Restricts the calling thread to the given logical processor.
+  /// Returns false if it failed or isn't supported on this platform.
+  virtual bool SetCurrentThreadAffinity(int logical_processor) const {
+    ORT_UNUSED_PARAMETER(logical_processor);
+    return false;
+  }
+
+  /// Returns the logical processor the calling thread runs on, or -1 if it isn't known on this platform.
+  virtual int GetCurrentLogicalProcessor() const { return -1; }
+
+  /// Returns the logical processors of each NUMA node, indexed by node number.
+  /// Empty if the platform doesn't report its NUMA topology.
+  virtual std::vector<std::vector<int>> GetNumaNodes() const { return {}; }
+
+  /// Hints the operating system to place the pages of [p, p + len) that aren't touched yet on NUMA node.
+  /// Only the whole pages in the range are placed, failures and unsupported hints are ignored.
+  virtual void BindMemoryToNumaNode(void* p, size_t len, int node) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(len);
+    ORT_UNUSED_PARAMETER(node);
+  }
+
+  /// Maps at least size bytes of memory backed by huge pages, and sets mapped_size to the bytes it mapped.
+  /// Returns nullptr if huge pages aren't available, so the caller allocates regular memory instead.
+  /// Free the memory with FreeHugePages.
+  virtual void* AllocateHugePages(size_t size, size_t& mapped_size) const {
+    ORT_UNUSED_PARAMETER(size);
+    mapped_size = 0;
+    return nullptr;
+  }
+
+  /// Frees memory from AllocateHugePages. mapped_size is the size AllocateHugePages set.
+  virtual void FreeHugePages(void* p, size_t mapped_size) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(mapped_size);
+  }
+
 #ifndef _WIN32
   /**
    *
@@ -89,6 +126,20 @@ class Env {
                                           OrtCallback& deleter) const = 0;
 #endif
 
+  /// How the memory of a file mapped by ReadFileAsString is going to be accessed. See AdviseFileMapping.
+  struct FileMappingAdvice {
+    bool prefetch = false;    // read the data ahead of its first access
+    bool huge_pages = false;  // back the data with huge pages, where the file system supports it
+  };
+
+  /// Hints the operating system about the access to [p, p + len), memory returned by ReadFileAsString.
+  /// The hints don't change the contents of the memory, failures and unsupported hints are ignored.
+  virtual void AdviseFileMapping(const void* p, size_t len, const FileMappingAdvice& advice) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(len);
+    ORT_UNUSED_PARAMETER(advice);
+  }
+
 #ifdef _WIN32
   //Mainly for use with protobuf library
   virtual common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const = 0;
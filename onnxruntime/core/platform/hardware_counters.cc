@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+namespace onnxruntime {
+
+HardwareCounters* HardwareCounters::ForCurrentThread(std::string* reason) {
+  // opened once per thread, and closed when the thread exits
+  thread_local bool opened = false;
+  thread_local std::unique_ptr<HardwareCounters> counters;
+  thread_local std::string open_failure;
+  if (!opened) {
+    opened = true;
+    counters = Open(open_failure);
+  }
+
+  if (counters == nullptr && reason != nullptr) {
+    *reason = open_failure;
+  }
+  return counters.get();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace onnxruntime {
+
+/**
+The hardware performance counters of a thread: cycles, instructions and last level cache misses, counted in user
+mode. They are only available on Linux, through perf_event_open, and only if perf_event_paranoid allows it.
+*/
+class HardwareCounters {
+ public:
+  struct Values {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llc_misses = 0;
+  };
+
+  /**
+  The counters of the calling thread, opened on its first call.
+  @returns nullptr if the counters can't be opened, and then sets the reason if given.
+  */
+  static HardwareCounters* ForCurrentThread(std::string* reason = nullptr);
+
+  // the counts since the counters were opened. returns false if they can't be read.
+  bool Read(Values& values) const;
+
+  ~HardwareCounters();
+
+ private:
+  explicit HardwareCounters(std::vector<int> fds) : fds_(std::move(fds)) {}
+
+  static std::unique_ptr<HardwareCounters> Open(std::string& reason);
+
+  // the file descriptors of the counters. the first one leads the group, which reads all the counters at once.
+  std::vector<int> fds_;
+};
+
+}  // namespace onnxruntime
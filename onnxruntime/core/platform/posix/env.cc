@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 // Portions Copyright (c) Microsoft Corporation
 
+#include <sched.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -21,9 +22,11 @@ limitations under the License.
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <string.h>
+#include <fstream>
 #include <thread>
 #include <vector>
 #include <assert.h>
@@ -95,6 +98,134 @@ class PosixEnv : public Env {
     }
   }
 
+  bool SetCurrentThreadAffinity(int logical_processor) const override {
+#if defined(__linux__)
+    if (logical_processor < 0 || logical_processor >= CPU_SETSIZE) return false;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(logical_processor, &cpuset);
+    // pid 0 is the calling thread
+    return sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    // macOS only supports affinity hints through the thread_policy API
+    ORT_UNUSED_PARAMETER(logical_processor);
+    return false;
+#endif
+  }
+
+  int GetCurrentLogicalProcessor() const override {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+  }
+
+  std::vector<std::vector<int>> GetNumaNodes() const override {
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    // each node lists its processors as ranges, e.g. "0-15,32-47"
+    for (int node = 0;; ++node) {
+      std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      if (!cpulist) {
+        break;
+      }
+
+      std::vector<int> processors;
+      std::string range;
+      while (std::getline(cpulist, range, ',')) {
+        int first = 0;
+        int last = 0;
+        const int count = sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (count < 1) {
+          continue;
+        }
+        for (int processor = first; processor <= (count == 1 ? first : last); ++processor) {
+          processors.push_back(processor);
+        }
+      }
+      nodes.push_back(std::move(processors));
+    }
+#endif
+    return nodes;
+  }
+
+  void BindMemoryToNumaNode(void* p, size_t len, int node) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMaxNodes = 64;
+    if (p == nullptr || len == 0 || node < 0 || node >= kMaxNodes) {
+      return;
+    }
+
+    // mbind takes page aligned ranges, so only the whole pages of the range are placed
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(p) + page_size - 1) / page_size * page_size;
+    const auto end = (reinterpret_cast<uintptr_t>(p) + len) / page_size * page_size;
+    if (end <= begin) {
+      return;
+    }
+
+    // MPOL_PREFERRED places the pages on node when they are first touched, and elsewhere once node is full
+    constexpr int kMpolPreferred = 1;
+    uint64_t node_mask = uint64_t{1} << node;
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, &node_mask, kMaxNodes + 1, 0) != 0) {
+      LOGS_DEFAULT(VERBOSE) << "mbind failed. error code:" << errno;
+    }
+#else
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(len);
+    ORT_UNUSED_PARAMETER(node);
+#endif
+  }
+
+  void* AllocateHugePages(size_t size, size_t& mapped_size) const override {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    constexpr size_t kHugePageSize = size_t{2} << 20;
+    mapped_size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+    // explicit huge pages only exist if the administrator reserved them
+    void* p = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      return p;
+    }
+
+    // else map a range aligned to a huge page, which transparent huge pages can back entirely
+    const size_t padded_size = mapped_size + kHugePageSize;
+    p = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      mapped_size = 0;
+      return nullptr;
+    }
+
+    const auto begin = reinterpret_cast<uintptr_t>(p);
+    const auto aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > begin) {
+      munmap(p, aligned - begin);
+    }
+    if (begin + padded_size > aligned + mapped_size) {
+      munmap(reinterpret_cast<void*>(aligned + mapped_size), begin + padded_size - aligned - mapped_size);
+    }
+
+    p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (madvise(p, mapped_size, MADV_HUGEPAGE) != 0) {
+      LOGS_DEFAULT(VERBOSE) << "madvise(MADV_HUGEPAGE) failed. error code:" << errno;
+    }
+#endif
+    return p;
+#else
+    ORT_UNUSED_PARAMETER(size);
+    mapped_size = 0;
+    return nullptr;
+#endif
+  }
+
+  void FreeHugePages(void* p, size_t mapped_size) const override {
+    if (p != nullptr && munmap(p, mapped_size) != 0) {
+      LOGS_DEFAULT(VERBOSE) << "munmap failed. error code:" << errno;
+    }
+  }
+
   PIDType GetSelfPid() const override {
     return getpid();
   }
@@ -175,6 +306,26 @@ class PosixEnv : public Env {
     return common::Status::OK();
   }
 
+  void AdviseFileMapping(const void* p, size_t len, const FileMappingAdvice& advice) const override {
+    if (p == nullptr || len == 0 || (!advice.prefetch && !advice.huge_pages)) {
+      return;
+    }
+
+    // madvise takes page aligned ranges, the data of a tensor starts anywhere in its page
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<uintptr_t>(p) / page_size * page_size;
+    const auto aligned_len = static_cast<size_t>(reinterpret_cast<uintptr_t>(p) + len - begin);
+    void* addr = reinterpret_cast<void*>(begin);
+    if (advice.prefetch && madvise(addr, aligned_len, MADV_WILLNEED) != 0) {
+      LOGS_DEFAULT(VERBOSE) << "madvise(MADV_WILLNEED) failed. error code:" << errno;
+    }
+#ifdef MADV_HUGEPAGE
+    if (advice.huge_pages && madvise(addr, aligned_len, MADV_HUGEPAGE) != 0) {
+      LOGS_DEFAULT(VERBOSE) << "madvise(MADV_HUGEPAGE) failed. error code:" << errno;
+    }
+#endif
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto e = errno;
     char buf[1024];
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+
+#ifdef __linux__
+namespace {
+// the counters of a group, in the order their values are read
+constexpr uint64_t kCounterConfigs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_MISSES};
+constexpr size_t kNumCounters = sizeof(kCounterConfigs) / sizeof(kCounterConfigs[0]);
+
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  // the group starts disabled so that its counters start together
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // the calling thread, on any cpu
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+}  // namespace
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Open(std::string& reason) {
+  std::vector<int> fds;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    const int fd = OpenCounter(kCounterConfigs[i], fds.empty() ? -1 : fds[0]);
+    if (fd == -1) {
+      reason = std::string("perf_event_open failed: ") + strerror(errno) +
+               (errno == EACCES || errno == EPERM ? ". Check /proc/sys/kernel/perf_event_paranoid." : "");
+      for (int opened_fd : fds) {
+        close(opened_fd);
+      }
+      return nullptr;
+    }
+    fds.push_back(fd);
+  }
+
+  ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return std::unique_ptr<HardwareCounters>(new HardwareCounters(std::move(fds)));
+}
+
+bool HardwareCounters::Read(Values& values) const {
+  // the number of counters, then their values
+  uint64_t buffer[1 + kNumCounters];
+  if (read(fds_[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != kNumCounters) {
+    return false;
+  }
+
+  values.cycles = buffer[1];
+  values.instructions = buffer[2];
+  values.llc_misses = buffer[3];
+  return true;
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (int fd : fds_) {
+    close(fd);
+  }
+}
+
+#else
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Open(std::string& reason) {
+  reason = "hardware counters are only supported on Linux";
+  return nullptr;
+}
+
+bool HardwareCounters::Read(Values&) const { return false; }
+
+HardwareCounters::~HardwareCounters() = default;
+
+#endif
+
+}  // namespace onnxruntime
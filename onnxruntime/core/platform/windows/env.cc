@@ -65,6 +65,29 @@ class WindowsEnv : public Env {
     return default_env;
   }
 
+  bool SetCurrentThreadAffinity(int logical_processor) const override {
+    // only the processors of the current processor group can be addressed with an affinity mask
+    if (logical_processor < 0 || logical_processor >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << logical_processor) != 0;
+  }
+
+  void* AllocateHugePages(size_t size, size_t& mapped_size) const override {
+    mapped_size = 0;
+    const SIZE_T large_page_size = GetLargePageMinimum();
+    if (large_page_size == 0) return nullptr;
+
+    // large pages need the SeLockMemoryPrivilege, without it the allocation fails
+    const size_t rounded_size = (size + large_page_size - 1) / large_page_size * large_page_size;
+    void* p = VirtualAlloc(nullptr, rounded_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (p != nullptr) mapped_size = rounded_size;
+    return p;
+  }
+
+  void FreeHugePages(void* p, size_t mapped_size) const override {
+    ORT_UNUSED_PARAMETER(mapped_size);
+    if (p != nullptr) VirtualFree(p, 0, MEM_RELEASE);
+  }
+
   PIDType GetSelfPid() const override {
     return GetCurrentProcessId();
   }
@@ -0,0 +1,17 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+namespace onnxruntime {
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Open(std::string& reason) {
+  reason = "hardware counters are only supported on Linux";
+  return nullptr;
+}
+
+bool HardwareCounters::Read(Values&) const { return false; }
+
+HardwareCounters::~HardwareCounters() = default;
+
+}  // namespace onnxruntime
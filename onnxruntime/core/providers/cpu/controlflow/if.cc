@@ -190,16 +190,17 @@ common::Status If::SetupSubgraphExecutionInfo(const SessionState& session_state,
 }
 
 Status If::Compute(OpKernelContext* ctx) const {
-  ORT_ENFORCE(then_feeds_fetches_manager_ && else_feeds_fetches_manager_,
-              "CreateFeedsFetchesManager must be called prior to execution of graph.");
-
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
 
   auto condition = *ctx->Input<Tensor>(0)->Data<bool>();
 
+  // getting the SessionState initializes a lazily initialized branch, which sets up its FeedsFetchesManager,
+  // so only the branch that runs is checked
   auto attribute = condition ? "then_branch" : "else_branch";
   auto* session_state = ctx_internal->SubgraphSessionState(attribute);
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for '", attribute, "' attribute.");
+  ORT_ENFORCE(condition ? then_feeds_fetches_manager_ != nullptr : else_feeds_fetches_manager_ != nullptr,
+              "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
   const auto& info = condition ? then_info_ : else_info_;
   IfImpl impl{*ctx_internal, *session_state, *info};
@@ -307,7 +308,7 @@ Status IfImpl::Execute(const FeedsFetchesManager& ffm) {
 
   status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                   /*sequential_execution*/ true, context_.GetTerminateFlag(),
-                                  context_.Logger());
+                                  context_.Logger(), nullptr, context_.GetOperatorThreadPool());
 
   ORT_RETURN_IF_ERROR(status);
 
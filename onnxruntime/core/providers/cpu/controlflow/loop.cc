@@ -12,7 +12,11 @@
 #include "core/providers/cpu/controlflow/loop.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "core/framework/allocator.h"
+#include "core/framework/execution_frame.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
@@ -131,6 +135,38 @@ struct Loop::Info {
       auto& output = subgraph_outputs[i];
       subgraph_output_names.push_back(output->Name());
     }
+
+    // a loop carried var can be written over the value the iteration before the previous one produced for it, if the
+    // subgraph produces it with a static shape and only outputs it once. an Identity node passing a feed through as
+    // an output shares the buffer of the feed, so its values are only written by fresh allocations.
+    std::unordered_set<std::string> produced_outputs;
+    bool passes_feed_through = false;
+    for (const auto& node : subgraph.Nodes()) {
+      for (const auto* output : node.OutputDefs()) {
+        produced_outputs.insert(output->Name());
+        if (node.OpType() == "Identity" &&
+            std::find(subgraph_output_names.cbegin(), subgraph_output_names.cend(), output->Name()) !=
+                subgraph_output_names.cend()) {
+          passes_feed_through = true;
+        }
+      }
+    }
+
+    loop_carried_var_shapes.resize(num_loop_carried_vars);
+    double_buffered_loop_carried_vars.resize(num_loop_carried_vars, false);
+    for (int i = 0; i < num_loop_carried_vars && !passes_feed_through; ++i) {
+      const auto& output = *subgraph_outputs[i + 1];  // skip cond
+      const auto* shape = output.Shape();
+      if (shape == nullptr || produced_outputs.count(output.Name()) == 0 ||
+          std::count(subgraph_output_names.cbegin(), subgraph_output_names.cend(), output.Name()) != 1 ||
+          !std::all_of(shape->dim().cbegin(), shape->dim().cend(),
+                       [](const TensorShapeProto_Dimension& dim) { return dim.has_dim_value(); })) {
+        continue;
+      }
+
+      loop_carried_var_shapes[i] = utils::GetTensorShapeFromTensorShapeProto(*shape);
+      double_buffered_loop_carried_vars[i] = true;
+    }
   }
 
   const GraphViewer& subgraph;
@@ -144,6 +180,10 @@ struct Loop::Info {
 
   std::vector<std::string> subgraph_input_names;
   std::vector<std::string> subgraph_output_names;
+
+  // the loop carried vars whose buffers alternate between two values across the iterations, and their shapes
+  std::vector<bool> double_buffered_loop_carried_vars;
+  std::vector<TensorShape> loop_carried_var_shapes;
 };
 
 class LoopImpl {
@@ -411,19 +451,44 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::vector<OrtValue> next_fetches;
+
+  // the iterations reuse one frame, so the subgraph values and memory pattern are set up once
+  std::unique_ptr<ExecutionFrame> frame;
+
+  // outputs copied across devices are written to buffers of their own
+  const bool double_buffer = ffm.GetDeviceCopyChecks().output_copy_needed == DeviceCopyCheck::NoCopy;
 
   CreateInitialFeeds(feeds);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
+    if (context_.IsTerminated()) {
+      return OpKernelContext::TerminatedStatus();
+    }
+
     if (iter_num_value != 0) {
+      // the loop carried vars fed to the previous iteration, which the subgraph produced unless they are the Loop
+      // inputs, are free once the feeds are updated and hold the outputs of the next iteration
+      next_fetches.assign(info_.num_subgraph_outputs, OrtValue());
+      if (double_buffer && iter_num_value > 1) {
+        for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+          const auto& previous_feed = feeds[i + 2];  // skip iter_num and cond
+          if (info_.double_buffered_loop_carried_vars[i] &&
+              previous_feed.Get<Tensor>().Shape() == info_.loop_carried_var_shapes[i]) {
+            next_fetches[i + 1] = previous_feed;  // skip cond
+          }
+        }
+      }
+
       SaveOutputsAndUpdateFeeds(fetches, feeds);
-      fetches.clear();
+      fetches.swap(next_fetches);
     }
 
     status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
-                                    /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+                                    /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger(),
+                                    &frame, context_.GetOperatorThreadPool());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -13,6 +13,7 @@
 
 #include "gsl/gsl_algorithm"
 
+#include "core/framework/execution_frame.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
@@ -193,6 +194,9 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
   std::vector<OrtValue> fetches;
   std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
+  // the iterations after the first one, which allocates the final outputs with fetch_allocators, reuse one frame
+  std::unique_ptr<ExecutionFrame> frame;
+
   feeds.resize(num_inputs);
   fetches.resize(num_variadic_outputs);
 
@@ -204,6 +208,10 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
 
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
+    if (context.IsTerminated()) {
+      return OpKernelContext::TerminatedStatus();
+    }
+
     for (int input = 0; input < num_variadic_inputs; ++input) {
       if (input < num_loop_state_variables) {
         // add loop state variable input
@@ -245,7 +253,8 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
 
     // Create Executor and run graph.
     status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
-                                    /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger());
+                                    /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger(),
+                                    &frame, context.GetOperatorThreadPool());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -5,6 +5,9 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/huge_page_allocator.h"
+#include "core/framework/kernel_tuning_cache.h"
+#include "core/framework/numa_arena.h"
 #include "core/graph/constants.h"
 
 namespace onnxruntime {
@@ -12,6 +15,16 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  bool enable_arena_thread_cache{false};
+  // back the large allocations of the CPU allocator with huge pages, see HugePageCPUAllocator.
+  bool use_huge_pages{false};
+  ArenaCfg arena_cfg;
+  // the implementations chosen by the kernels that benchmark them, shared by the sessions that use it.
+  // The kernels use their default implementations if it is null.
+  std::shared_ptr<KernelTuningCache> kernel_tuning_cache;
+  // the logical processors of each NUMA node. With more than one node, the arena holds the memory of each node
+  // apart, see NumaArena.
+  std::vector<std::vector<int>> numa_nodes;
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -26,10 +39,19 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider},
+        kernel_tuning_cache_{info.kernel_tuning_cache} {
+    const bool use_huge_pages = info.use_huge_pages;
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
-                                                [](int) { return std::make_unique<CPUAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                [use_huge_pages](int) -> std::unique_ptr<IDeviceAllocator> {
+                                                  if (use_huge_pages)
+                                                    return std::make_unique<HugePageCPUAllocator>();
+                                                  return std::make_unique<CPUAllocator>();
+                                                },
+                                                info.arena_cfg.max_mem};
+    device_info.arena_extend_strategy = info.arena_cfg.arena_extend_strategy;
+    device_info.initial_chunk_size_bytes = info.arena_cfg.initial_chunk_size_bytes;
+    device_info.thread_cache_config.enable = info.enable_arena_thread_cache;
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
@@ -37,7 +59,9 @@ class CPUExecutionProvider : public IExecutionProvider {
         std::shared_ptr<IArenaAllocator>(
             std::make_unique<DummyArena>(device_info.factory(0))));
 #else
-    if (info.create_arena)
+    if (info.create_arena && info.numa_nodes.size() > 1)
+      InsertAllocator(std::make_shared<NumaArena>(device_info, info.numa_nodes));
+    else if (info.create_arena)
       InsertAllocator(CreateAllocator(device_info));
     else
       InsertAllocator(
@@ -49,7 +73,10 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  KernelTuningCache* GetKernelTuningCache() const { return kernel_tuning_cache_.get(); }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  std::shared_ptr<KernelTuningCache> kernel_tuning_cache_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/element_wise_kernels.h"
+
+#include "core/common/cpu_isa_dispatch.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+
+namespace {
+void AddBaseline(const float* a, const float* b, float* out, size_t count) {
+  const auto size = static_cast<ptrdiff_t>(count);
+  EigenVectorMap<float>(out, size) = ConstEigenVectorMap<float>(a, size) + ConstEigenVectorMap<float>(b, size);
+}
+
+void SubBaseline(const float* a, const float* b, float* out, size_t count) {
+  const auto size = static_cast<ptrdiff_t>(count);
+  EigenVectorMap<float>(out, size) = ConstEigenVectorMap<float>(a, size) - ConstEigenVectorMap<float>(b, size);
+}
+
+void MulBaseline(const float* a, const float* b, float* out, size_t count) {
+  const auto size = static_cast<ptrdiff_t>(count);
+  EigenVectorMap<float>(out, size) =
+      ConstEigenVectorMap<float>(a, size).cwiseProduct(ConstEigenVectorMap<float>(b, size));
+}
+
+void DivBaseline(const float* a, const float* b, float* out, size_t count) {
+  const auto size = static_cast<ptrdiff_t>(count);
+  EigenVectorMap<float>(out, size) =
+      ConstEigenVectorMap<float>(a, size).cwiseQuotient(ConstEigenVectorMap<float>(b, size));
+}
+
+const ElementWiseFloatKernels kBaselineKernels{AddBaseline, SubBaseline, MulBaseline, DivBaseline};
+}  // namespace
+
+const ElementWiseFloatKernels& GetElementWiseFloatKernels() {
+  static const ElementWiseFloatKernels* kernels = CpuIsaDispatch<const ElementWiseFloatKernels*>(&kBaselineKernels)
+#ifdef ORT_CPU_ISA_KERNELS_X86
+                                                      .Add(CpuIsa::kAVX2, &kElementWiseFloatKernelsAvx2)
+                                                      .Add(CpuIsa::kAVX512, &kElementWiseFloatKernelsAvx512)
+#endif
+                                                      .Get();
+  return *kernels;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace onnxruntime {
+
+// computes out[i] = a[i] op b[i] for i in [0, count)
+using BinaryFloatKernel = void (*)(const float* a, const float* b, float* out, size_t count);
+
+// The kernels of the float element-wise ops for the spans of equal length, built for an instruction set level.
+struct ElementWiseFloatKernels {
+  BinaryFloatKernel add;
+  BinaryFloatKernel sub;
+  BinaryFloatKernel mul;
+  BinaryFloatKernel div;
+};
+
+// the kernels built for the instruction set level the CPU supports, selected on the first call. See CpuIsaDispatch.
+const ElementWiseFloatKernels& GetElementWiseFloatKernels();
+
+#ifdef ORT_CPU_ISA_KERNELS_X86
+// in element_wise_kernels_avx2.cc and element_wise_kernels_avx512.cc. Only their addresses are read on the CPUs
+// that don't support them, as they are initialized at compile time.
+extern const ElementWiseFloatKernels kElementWiseFloatKernelsAvx2;
+extern const ElementWiseFloatKernels kElementWiseFloatKernelsAvx512;
+#endif
+
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// built with the flags of AVX2, see onnxruntime_providers.cmake
+
+#include "core/providers/cpu/math/element_wise_kernels.h"
+
+#include <immintrin.h>
+
+namespace onnxruntime {
+
+namespace {
+struct AddOp {
+  static __m256 Apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+  static float Apply(float a, float b) { return a + b; }
+};
+
+struct SubOp {
+  static __m256 Apply(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+  static float Apply(float a, float b) { return a - b; }
+};
+
+struct MulOp {
+  static __m256 Apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+  static float Apply(float a, float b) { return a * b; }
+};
+
+struct DivOp {
+  static __m256 Apply(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+  static float Apply(float a, float b) { return a / b; }
+};
+
+template <typename Op>
+void BinaryAvx2(const float* a, const float* b, float* out, size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256 result0 = Op::Apply(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    const __m256 result1 = Op::Apply(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+    _mm256_storeu_ps(out + i, result0);
+    _mm256_storeu_ps(out + i + 8, result1);
+  }
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, Op::Apply(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  for (; i < count; ++i) {
+    out[i] = Op::Apply(a[i], b[i]);
+  }
+}
+}  // namespace
+
+const ElementWiseFloatKernels kElementWiseFloatKernelsAvx2{BinaryAvx2<AddOp>, BinaryAvx2<SubOp>, BinaryAvx2<MulOp>,
+                                                           BinaryAvx2<DivOp>};
+
+}  // namespace onnxruntime
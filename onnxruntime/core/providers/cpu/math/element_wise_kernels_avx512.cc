@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// built with the flags of AVX-512, see onnxruntime_providers.cmake
+
+#include "core/providers/cpu/math/element_wise_kernels.h"
+
+#include <immintrin.h>
+
+namespace onnxruntime {
+
+namespace {
+struct AddOp {
+  static __m512 Apply(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+};
+
+struct SubOp {
+  static __m512 Apply(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+};
+
+struct MulOp {
+  static __m512 Apply(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+};
+
+struct DivOp {
+  static __m512 Apply(__m512 a, __m512 b) { return _mm512_div_ps(a, b); }
+};
+
+template <typename Op>
+void BinaryAvx512(const float* a, const float* b, float* out, size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    _mm512_storeu_ps(out + i, Op::Apply(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+  }
+  if (i < count) {
+    // the masked lanes are neither read nor written
+    const __mmask16 mask = static_cast<__mmask16>((1u << (count - i)) - 1);
+    const __m512 result = Op::Apply(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+    _mm512_mask_storeu_ps(out + i, mask, result);
+  }
+}
+}  // namespace
+
+const ElementWiseFloatKernels kElementWiseFloatKernelsAvx512{BinaryAvx512<AddOp>, BinaryAvx512<SubOp>, BinaryAvx512<MulOp>,
+                                                             BinaryAvx512<DivOp>};
+
+}  // namespace onnxruntime
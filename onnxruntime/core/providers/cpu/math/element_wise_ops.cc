@@ -2,20 +2,39 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/providers/cpu/math/element_wise_kernels.h"
 #include <unsupported/Eigen/SpecialFunctions>
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/broadcast_copy.h"
 
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 namespace onnxruntime {
 
-#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      OP_TYPE,                                                                     \
-      VERSION,                                                                     \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+// The element-wise kernels compute each output element from the input elements at the same position, or from
+// broadcast values, so the output may reuse the buffer of an input of the same shape that isn't used afterwards.
+#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)                          \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      OP_TYPE,                                                                                      \
+      VERSION,                                                                                      \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KERNEL_CLASS<TYPE>);
+
+// binary operators whose output may reuse either input, e.g. the second input of Add with a broadcast first input
+#define REG_ELEMENTWISE_BINARY_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                 \
+      OP_TYPE,                                                                    \
+      VERSION,                                                                    \
+      TYPE,                                                                       \
+      KernelDefBuilder()                                                          \
+          .MayInplace(0, 0)                                                       \
+          .MayInplace(1, 0)                                                       \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),              \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -32,7 +51,7 @@ namespace onnxruntime {
       OP_TYPE,                                                                                        \
       VERSION_FROM, VERSION_TO,                                                                       \
       TYPE,                                                                                           \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                    \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),   \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
@@ -44,25 +63,25 @@ namespace onnxruntime {
                         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),                    \
       KERNEL_CLASS<TYPE>);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int64_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, float, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, double, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int32_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int64_t, Add);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, float, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, double, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int64_t, Sub);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, float, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, double, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int64_t, Mul);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int64_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, float, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, double, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int32_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int64_t, Div);
 
 REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, float, Abs);
 REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, double, Abs);
@@ -89,8 +108,8 @@ REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
 REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
 REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, float, Pow);
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, double, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, float, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, double, Pow);
 
 REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, float, Exp);
 REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, double, Exp);
@@ -159,13 +178,29 @@ ONNX_CPU_OPERATOR_KERNEL(
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Xor);
 
+// Returns the function computing the spans of equal length of a binary op: eigen_op, or for float the kernel built
+// for the instruction set level of the CPU, see GetElementWiseFloatKernels.
+template <typename T, typename EigenOp, typename std::enable_if<!std::is_same<T, float>::value, int>::type = 0>
+EigenOp WithFloatKernel(BinaryFloatKernel ElementWiseFloatKernels::*, EigenOp eigen_op) {
+  return eigen_op;
+}
+
+template <typename T, typename EigenOp, typename std::enable_if<std::is_same<T, float>::value, int>::type = 0>
+auto WithFloatKernel(BinaryFloatKernel ElementWiseFloatKernels::*kernel, EigenOp) {
+  return [kernel](EigenVectorMap<float> output, ConstEigenVectorMap<float> input0, ConstEigenVectorMap<float> input1) {
+    (GetElementWiseFloatKernels().*kernel)(input0.data(), input1.data(), output.data(),
+                                           static_cast<size_t>(output.size()));
+  };
+}
+
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 + input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() + input1; },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 + input1; });
+      WithFloatKernel<T>(&ElementWiseFloatKernels::add,
+                         [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 + input1; }));
 }
 
 template <typename T>
@@ -174,7 +209,8 @@ Status Sub<T>::Compute(OpKernelContext* context) const {
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 - input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() - input1; },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 - input1; });
+      WithFloatKernel<T>(&ElementWiseFloatKernels::sub,
+                         [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 - input1; }));
 }
 
 template <typename T>
@@ -183,7 +219,8 @@ Status Mul<T>::Compute(OpKernelContext* context) const {
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 * input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() * input1; },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseProduct(input1); });
+      WithFloatKernel<T>(&ElementWiseFloatKernels::mul,
+                         [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseProduct(input1); }));
 }
 
 template <typename T>
@@ -192,7 +229,8 @@ Status Div<T>::Compute(OpKernelContext* context) const {
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 / input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() / input1; },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseQuotient(input1); });
+      WithFloatKernel<T>(&ElementWiseFloatKernels::div,
+                         [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseQuotient(input1); }));
 }
 
 template <>
@@ -790,33 +828,6 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
-// This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
-template <typename T>
-struct TBroadcasterExpand {
-  TBroadcasterExpand(const Tensor& input, const std::vector<int64_t>& shape)
-      : input_tensor_(input),
-        broadcaster_(input.Shape().GetDims(), shape) {
-  }
-
-  TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
-  size_t GetSpanSize() const { return span_size_; }
-
-  bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
-
-  T NextScalar() { return *Next(); }
-
-  ConstEigenVectorMap<T> NextEigen() { return ConstEigenVectorMap<T>(Next(), span_size_); }
-
- private:
-  const T* Next() { return input_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
-
-  const Tensor& input_tensor_;
-  Broadcaster broadcaster_;
-  size_t span_size_{broadcaster_.GetSpanSize()};
-
-  const T* input_{input_tensor_.template Data<T>()};
-};
-
 template <typename T>
 Status Expand_8<T>::Compute(OpKernelContext* context) const {
   auto& tensor_shape = *context->Input<Tensor>(1);
@@ -826,19 +837,28 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
   const auto* p_shape = tensor_shape.template Data<int64_t>();
   std::vector<int64_t> shape{p_shape, p_shape + tensor_shape.Shape().Size()};
 
-  TBroadcasterExpand<T> bc(*context->Input<Tensor>(0), shape);
-  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
-
-  // This doesn't use BroadcastLoop since there is no second tensor, just duplicating the first
-  if (bc.IsInput0Scalar()) {
-    // Input0 being a scalar is the only special case here, since we're duplicating a single value
-    while (output)
-      output.NextEigenOutput().array() = bc.NextScalar();
-  } else {
-    // Input1 being a scalar doesn't matter (as there's no actual input1). We're still duplicating Input0 in the same sized chunks
-    while (output)
-      output.NextEigenOutput() = bc.NextEigen();
+  // Broadcast the input and the shape against each other, aligned on the innermost axis. An axis the input
+  // broadcasts along is read with a stride of 0.
+  const auto& input = *context->Input<Tensor>(0);
+  const auto& input_dims = input.Shape().GetDims();
+  const size_t rank = std::max(input_dims.size(), shape.size());
+  std::vector<int64_t> output_dims(rank);
+  std::vector<int64_t> input_strides(rank);
+  int64_t input_pitch = 1;
+  for (size_t i = 0; i < rank; ++i) {
+    const size_t axis = rank - 1 - i;
+    const int64_t input_dim = i < input_dims.size() ? input_dims[input_dims.size() - 1 - i] : 1;
+    const int64_t shape_dim = i < shape.size() ? shape[shape.size() - 1 - i] : 1;
+    ORT_ENFORCE(input_dim == shape_dim || input_dim == 1 || shape_dim == 1,
+                "Attempting to broadcast an axis by a dimension other than 1. ", input_dim, " by ", shape_dim);
+    output_dims[axis] = input_dim == 1 ? shape_dim : input_dim;
+    input_strides[axis] = input_dim == 1 ? 0 : input_pitch;
+    input_pitch *= input_dim;
   }
+
+  auto& output = *context->Output(0, TensorShape(output_dims));
+  BroadcastCopy(input.template Data<T>(), output.template MutableData<T>(), sizeof(T), output_dims, input_strides,
+                static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
   return Status::OK();
 }
 
@@ -5,6 +5,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -320,6 +322,19 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Moves to the given element of the output, which must be the start of a span. A step of counter k
+  // (after counters 0..k-1 wrap around) moves the index by counts_[k - 1] steps of counter k - 1 plus deltas_[k].
+  void Seek(size_t position) {
+    index_ = 0;
+    ptrdiff_t step = 0;
+    for (size_t counterIndex = 0; counterIndex < counters_.size(); counterIndex++) {
+      step = counterIndex == 0 ? deltas_[0] : step * counts_[counterIndex - 1] + deltas_[counterIndex];
+      counters_[counterIndex] = position % counts_[counterIndex];
+      position /= counts_[counterIndex];
+      index_ += counters_[counterIndex] * step;
+    }
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(max_dims);
     counts_.reserve(max_dims);
@@ -473,6 +488,12 @@ struct TBroadcaster {
   bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
   bool IsInput1Scalar() const { return broadcaster_.iterator2_.deltas_.front() == 0; }
 
+  // Moves to the given element of the output, which must be a multiple of the span size.
+  void Seek(size_t offset) {
+    broadcaster_.iterator1_.Seek(offset);
+    broadcaster_.iterator2_.Seek(offset);
+  }
+
   const T0& NextScalar0() { return *Next0(); }
   const T1& NextScalar1() { return *Next1(); }
 
@@ -503,6 +524,13 @@ struct TBroadcastOutput {
     output_end_ = output_ + tensor.Shape().Size();
   }
 
+  // Output of the elements [start_offset, end_offset), which must be multiples of the span size.
+  TBroadcastOutput(size_t span_size, Tensor& tensor, int64_t start_offset, int64_t end_offset)
+      : span_size_(span_size) {
+    output_ = tensor.template MutableData<T>() + start_offset;
+    output_end_ = tensor.template MutableData<T>() + end_offset;
+  }
+
   operator bool() const {
     return output_ != output_end_;
   }
@@ -583,11 +611,80 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// smallest number of output elements computed by a task of ParallelBroadcastLoop
+constexpr int64_t kMinBroadcastElementsPerTask = 32768;
+
+// BroadcastLoop over the whole output, split across the threads of tp for large outputs. When there are
+// enough spans they are partitioned across the threads, each of which seeks its own copy of the broadcaster
+// to its first span. Otherwise each span is split into segments, so the functions must be element-wise.
+template <typename TInput0, typename TInput1, typename TOutput,
+          typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(TBroadcaster<TInput0, TInput1>& bc, Tensor& output_tensor, concurrency::ThreadPool* tp,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const int64_t output_size = output_tensor.Shape().Size();
+  const int64_t span_size = static_cast<int64_t>(bc.GetSpanSize());
+  int64_t num_tasks = output_size / kMinBroadcastElementsPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1 || span_size == 0) {
+    TBroadcastOutput<TOutput> output(span_size, output_tensor);
+    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    return;
+  }
+
+  const int64_t num_spans = output_size / span_size;
+  if (num_spans >= num_tasks) {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      const int64_t start_offset = num_spans * task / num_tasks * span_size;
+      const int64_t end_offset = num_spans * (task + 1) / num_tasks * span_size;
+      TBroadcaster<TInput0, TInput1> task_bc(bc);
+      task_bc.Seek(start_offset);
+      TBroadcastOutput<TOutput> output(span_size, output_tensor, start_offset, end_offset);
+      BroadcastLoop(task_bc, output, input0scalar, input1scalar, general);
+    });
+    return;
+  }
+
+  TBroadcastOutput<TOutput> output(span_size, output_tensor);
+  auto split_span = [tp, span_size, num_tasks](auto&& fn) {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [span_size, num_tasks, &fn](int32_t task) {
+      const int64_t first = span_size * task / num_tasks;
+      fn(first, span_size * (task + 1) / num_tasks - first);
+    });
+  };
+  while (output) {
+    TOutput* out = output.NextEigenOutput().data();
+    if (bc.IsInput0Scalar()) {
+      const TInput0& in0 = bc.NextScalar0();
+      const TInput1* in1 = bc.NextEigen1().data();
+      split_span([&](int64_t first, int64_t count) {
+        input0scalar(EigenVectorMap<TOutput>(out + first, count), in0, ConstEigenVectorMap<TInput1>(in1 + first, count));
+      });
+    } else if (bc.IsInput1Scalar()) {
+      const TInput0* in0 = bc.NextEigen0().data();
+      const TInput1& in1 = bc.NextScalar1();
+      split_span([&](int64_t first, int64_t count) {
+        input1scalar(EigenVectorMap<TOutput>(out + first, count), ConstEigenVectorMap<TInput0>(in0 + first, count), in1);
+      });
+    } else {
+      const TInput0* in0 = bc.NextEigen0().data();
+      const TInput1* in1 = bc.NextEigen1().data();
+      split_span([&](int64_t first, int64_t count) {
+        general(EigenVectorMap<TOutput>(out + first, count), ConstEigenVectorMap<TInput0>(in0 + first, count),
+                ConstEigenVectorMap<TInput1>(in1 + first, count));
+      });
+    }
+  }
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  Tensor& output = *context.Output(0, bc.GetOutputShape());
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal&>(context).GetOperatorThreadPool();
+  ParallelBroadcastLoop<TInput, TInput, TOutput>(bc, output, tp, input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -607,6 +704,7 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
   std::unique_ptr<Tensor> tempOutput;
 
   TensorAllocator<TOutput> tensorAllocator(context);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal&>(context).GetOperatorThreadPool();
 
   // For more than 2 tensors, we sum the first two into a temporary tensor, then sum the next with the temporary tensor
   for (int i = 0; i < input_count - 1; i++) {
@@ -624,9 +722,7 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TInput, TInput, TOutput>(bc, *p_output, tp, input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
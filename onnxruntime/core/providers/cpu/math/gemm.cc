@@ -3,12 +3,89 @@
 
 #include "core/providers/cpu/math/gemm.h"
 
+#include "core/mlas/inc/mlas.h"
+
 namespace onnxruntime {
 
-ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     Gemm,
     7,
     9,
+    float,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    7,
+    9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+template <>
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  const auto X = context->Input<Tensor>(0);
+  const auto W = context->Input<Tensor>(1);
+  const auto B = context->Input<Tensor>(2);
+  GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans, B->Shape());
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int64_t M = helper.M();
+  int64_t N = helper.N();
+  int64_t K = helper.K();
+  auto Y = context->Output(0, {M, N});
+  // if input is emtpy tensor, return directly as nothing need to be calculated.
+  if (M == 0 || N == 0)
+    return Status::OK();
+
+  // accumulate in float, MLAS expands the half precision inputs a panel at a time
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto* c_data = static_cast<float*>(alloc->Alloc(sizeof(float) * M * N));
+  BufferUniquePtr c_buffer(c_data, BufferDeleter(alloc));
+
+  // Broadcast the bias as needed.
+  if (beta_ != 0) {
+    const auto& b_shape = B->Shape();
+    const MLFloat16* b_data = B->template Data<MLFloat16>();
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        int64_t b_index;
+        if (b_shape.Size() == 1) {
+          // B is (), (1,) or (1, 1), set the scalar
+          b_index = 0;
+        } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+          // B is (N,) or (1, N)
+          b_index = n;
+        } else if (b_shape[1] == 1) {
+          // B is (M, 1)
+          b_index = m;
+        } else {
+          // B is (M, N), no broadcast needed.
+          b_index = m * N + n;
+        }
+        c_data[m * N + n] = math::halfToFloat(b_data[b_index].val);
+      }
+    }
+  }
+
+  MlasHalfGemm(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha_,
+               &X->template Data<MLFloat16>()->val, static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+               &W->template Data<MLFloat16>()->val, static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+               beta_, c_data, static_cast<size_t>(N), tp);
+
+  MLFloat16* y_data = Y->template MutableData<MLFloat16>();
+  for (int64_t i = 0; i < M * N; i++) {
+    y_data[i] = MLFloat16(math::floatToHalf(c_data[i]));
+  }
+
+  return Status::OK();
 }
+
+}  // namespace onnxruntime
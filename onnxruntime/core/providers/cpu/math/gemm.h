@@ -8,6 +8,7 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
+#include "gemm_pack.h"
 #include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
@@ -25,6 +26,16 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    // a constant W is packed once here instead of on every Compute
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W)) {
+      // a weight that is mostly zero blocks, e.g. after pruning, skips them instead
+      sparse_b_ = GemmPackBSparse(info, trans_B_, *W, packed_b_);
+      if (!sparse_b_) {
+        GemmPackB(info, trans_B_, *W, packed_b_);
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -68,18 +79,25 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        helper.K(),
-        alpha_,
-        X->template Data<T>(),
-        W->template Data<T>(),
-        beta_,
-        y_data,
-        tp);
+    if (sparse_b_) {
+      GemmPackedSparse(trans_A_, M, N, helper.K(), alpha_, X->template Data<T>(), packed_b_.get(), beta_, y_data,
+                       tp);
+    } else if (packed_b_) {
+      GemmPacked(trans_A_, M, N, helper.K(), alpha_, X->template Data<T>(), packed_b_.get(), beta_, y_data, tp);
+    } else {
+      math::Gemm<T>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          helper.K(),
+          alpha_,
+          X->template Data<T>(),
+          W->template Data<T>(),
+          beta_,
+          y_data,
+          tp);
+    }
 
     FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -91,6 +109,8 @@ class Gemm : public OpKernel {
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
+  BufferUniquePtr packed_b_;
+  bool sparse_b_ = false;
 
  protected:
   // For fused gemm + activation
@@ -98,4 +118,8 @@ class Gemm : public OpKernel {
   float leaky_relu_alpha_;
 };
 
+// Half precision inputs are multiplied by MLAS in float and narrowed back to half once at the end.
+template <>
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
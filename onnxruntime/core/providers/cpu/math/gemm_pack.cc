@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/gemm_pack.h"
+
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+bool GemmPackB(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, const Tensor& b, BufferUniquePtr& packed_b) {
+  packed_b.reset();
+
+#if defined(USE_MKLML_FOR_BLAS)
+  // the BLAS library does its own packing
+  ORT_UNUSED_PARAMETER(info);
+  ORT_UNUSED_PARAMETER(trans_b);
+  ORT_UNUSED_PARAMETER(b);
+  return false;
+#else
+  const auto& shape = b.Shape();
+  if (b.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 2 || shape.Size() == 0) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(trans_b == CblasNoTrans ? shape[0] : shape[1]);
+  const size_t N = static_cast<size_t>(trans_b == CblasNoTrans ? shape[1] : shape[0]);
+  const size_t ldb = static_cast<size_t>(shape[1]);
+  return GemmPackB(info, trans_b, N, K, b.Data<float>(), ldb, packed_b);
+#endif
+}
+
+bool GemmPackB(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, size_t N, size_t K, const float* b, size_t ldb,
+               BufferUniquePtr& packed_b) {
+  packed_b.reset();
+
+#if defined(USE_MKLML_FOR_BLAS)
+  ORT_UNUSED_PARAMETER(info);
+  ORT_UNUSED_PARAMETER(trans_b);
+  ORT_UNUSED_PARAMETER(N);
+  ORT_UNUSED_PARAMETER(K);
+  ORT_UNUSED_PARAMETER(b);
+  ORT_UNUSED_PARAMETER(ldb);
+  return false;
+#else
+  if (N == 0 || K == 0) {
+    return false;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  void* buffer = alloc->Alloc(MlasSgemmPackBSize(N, K));
+  packed_b = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasSgemmPackB(trans_b, N, K, b, ldb, buffer);
+  return true;
+#endif
+}
+
+bool GemmPackBSparse(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, const Tensor& b, BufferUniquePtr& packed_b) {
+  packed_b.reset();
+
+#if defined(USE_MKLML_FOR_BLAS)
+  ORT_UNUSED_PARAMETER(info);
+  ORT_UNUSED_PARAMETER(trans_b);
+  ORT_UNUSED_PARAMETER(b);
+  return false;
+#else
+  const auto& shape = b.Shape();
+  if (b.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 2 || shape.Size() == 0) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(trans_b == CblasNoTrans ? shape[0] : shape[1]);
+  const size_t N = static_cast<size_t>(trans_b == CblasNoTrans ? shape[1] : shape[0]);
+  const size_t ldb = static_cast<size_t>(shape[1]);
+  const size_t packed_size = MlasSgemmPackBSparseSize(trans_b, N, K, b.Data<float>(), ldb);
+  if (packed_size == 0) {
+    return false;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  void* buffer = alloc->Alloc(packed_size);
+  packed_b = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasSgemmPackBSparse(trans_b, N, K, b.Data<float>(), ldb, buffer);
+  return true;
+#endif
+}
+
+void GemmPacked(CBLAS_TRANSPOSE trans_a, int64_t M, int64_t N, int64_t K, float alpha, const float* a,
+                const void* packed_b, float beta, float* c, concurrency::ThreadPool* tp) {
+  const size_t lda = static_cast<size_t>(trans_a == CblasNoTrans ? K : M);
+  MlasSgemm(trans_a, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha, a, lda,
+            packed_b, beta, c, static_cast<size_t>(N), tp);
+}
+
+void GemmPackedSparse(CBLAS_TRANSPOSE trans_a, int64_t M, int64_t N, int64_t K, float alpha, const float* a,
+                      const void* packed_b, float beta, float* c, concurrency::ThreadPool* tp) {
+  const size_t lda = static_cast<size_t>(trans_a == CblasNoTrans ? K : M);
+  MlasSgemmSparse(trans_a, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha, a, lda,
+                  packed_b, beta, c, static_cast<size_t>(N), tp);
+}
+
+}  // namespace onnxruntime
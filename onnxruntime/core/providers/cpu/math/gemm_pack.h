@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+#include "core/util/math.h"
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+/**
+Pack a constant matrix B once for the single precision GEMM, so kernels whose B is an initializer
+don't repack it on every call.
+@param info Kernel info of the node, used to allocate the packed buffer.
+@param trans_b Transpose operation applied to B.
+@param b Constant matrix B.
+@param packed_b Packed buffer. Left empty if B can't be packed.
+@returns true if B is a 2-D float tensor that was packed.
+*/
+bool GemmPackB(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, const Tensor& b, BufferUniquePtr& packed_b);
+
+/**
+Pack a constant matrix B held in part of a tensor, e.g. the weights of one direction of a RNN.
+@param N Number of columns of op(B)
+@param K Number of rows of op(B)
+@param b Constant matrix B, with ldb elements between its rows.
+@param packed_b Packed buffer. Left empty if B can't be packed.
+@returns true if B was packed.
+*/
+bool GemmPackB(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, size_t N, size_t K, const float* b, size_t ldb,
+               BufferUniquePtr& packed_b);
+
+/**
+Pack a constant matrix B once for the block sparse single precision GEMM, if enough of its blocks are zeros
+for skipping them to beat the dense GEMM, e.g. the weights of a pruned model.
+@param info Kernel info of the node, used to allocate the packed buffer.
+@param trans_b Transpose operation applied to B.
+@param b Constant matrix B.
+@param packed_b Packed buffer. Left empty if B isn't packed.
+@returns true if B is a 2-D float tensor that was packed as block sparse.
+*/
+bool GemmPackBSparse(const OpKernelInfo& info, CBLAS_TRANSPOSE trans_b, const Tensor& b, BufferUniquePtr& packed_b);
+
+/**
+Calculate C = alpha * op(A) * B + beta * C with a matrix B packed by GemmPackB.
+@param trans_a Transpose operation applied to A.
+@param M Number of rows of op(A) and C
+@param N Number of columns of B and C
+@param K Number of columns of op(A) and rows of B
+@param packed_b Packed matrix B
+*/
+void GemmPacked(CBLAS_TRANSPOSE trans_a, int64_t M, int64_t N, int64_t K, float alpha, const float* a,
+                const void* packed_b, float beta, float* c, concurrency::ThreadPool* tp);
+
+/**
+Calculate C = alpha * op(A) * B + beta * C with a matrix B packed by GemmPackBSparse.
+*/
+void GemmPackedSparse(CBLAS_TRANSPOSE trans_a, int64_t M, int64_t N, int64_t K, float alpha, const float* a,
+                      const void* packed_b, float beta, float* c, concurrency::ThreadPool* tp);
+}  // namespace onnxruntime
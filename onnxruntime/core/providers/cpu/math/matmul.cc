@@ -3,6 +3,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -23,6 +24,13 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     9, 9,
@@ -78,4 +86,101 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  size_t left_stride, right_stride, output_stride;
+  if (!packed_b_ && helper.BatchStrides(left_stride, right_stride, output_stride)) {
+    // run the whole batch as one strided multiply so small matrices still spread across the thread pool
+    math::MatMulBatch<float>(
+        static_cast<int>(helper.M()),
+        static_cast<int>(helper.N()),
+        static_cast<int>(helper.K()),
+        left_X->Data<float>(), left_stride,
+        right_X->Data<float>(), right_stride,
+        Y->MutableData<float>(), output_stride,
+        helper.OutputOffsets().size(), thread_pool);
+    return Status::OK();
+  }
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    if (sparse_b_) {
+      GemmPackedSparse(CblasNoTrans, helper.M(), helper.N(), helper.K(), 1.f,
+                       left_X->Data<float>() + helper.LeftOffsets()[i], packed_b_.get(), 0.f,
+                       Y->MutableData<float>() + helper.OutputOffsets()[i], thread_pool);
+    } else if (packed_b_) {
+      // a packed B is 2-D, so every multiply uses all of it
+      GemmPacked(CblasNoTrans, helper.M(), helper.N(), helper.K(), 1.f,
+                 left_X->Data<float>() + helper.LeftOffsets()[i], packed_b_.get(), 0.f,
+                 Y->MutableData<float>() + helper.OutputOffsets()[i], thread_pool);
+    } else {
+      math::MatMul<float>(
+          static_cast<int>(helper.M()),
+          static_cast<int>(helper.N()),
+          static_cast<int>(helper.K()),
+          left_X->Data<float>() + helper.LeftOffsets()[i],
+          right_X->Data<float>() + helper.RightOffsets()[i],
+          Y->MutableData<float>() + helper.OutputOffsets()[i], thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // accumulate each multiply in float, MLAS expands the half precision inputs a panel at a time
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto* c_data = static_cast<float*>(alloc->Alloc(sizeof(float) * M * N));
+  BufferUniquePtr c_buffer(c_data, BufferDeleter(alloc));
+
+  const MLFloat16* left_data = left_X->Data<MLFloat16>();
+  const MLFloat16* right_data = right_X->Data<MLFloat16>();
+  MLFloat16* y_data = Y->MutableData<MLFloat16>();
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    MlasHalfGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.f,
+                 &left_data[helper.LeftOffsets()[i]].val, K,
+                 &right_data[helper.RightOffsets()[i]].val, N,
+                 0.f, c_data, N, thread_pool);
+
+    MLFloat16* y = y_data + helper.OutputOffsets()[i];
+    for (size_t j = 0; j < M * N; j++) {
+      y[j] = MLFloat16(math::floatToHalf(c_data[j]));
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm_pack.h"
 
 namespace onnxruntime {
 
@@ -18,4 +19,31 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info)
+      : OpKernel(info) {
+    // a constant B is packed once here instead of on every Compute
+    const Tensor* B;
+    if (info.TryGetConstantInput(1, &B)) {
+      // a weight that is mostly zero blocks, e.g. after pruning, skips them instead
+      sparse_b_ = GemmPackBSparse(info, CblasNoTrans, *B, packed_b_);
+      if (!sparse_b_) {
+        GemmPackB(info, CblasNoTrans, *B, packed_b_);
+      }
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  BufferUniquePtr packed_b_;
+  bool sparse_b_ = false;
+};
+
+// Half precision inputs are multiplied by MLAS in float and narrowed back to half once at the end.
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
@@ -236,6 +236,23 @@ class MatMulComputeHelper {
     return output_offsets_;
   }
 
+  // Strides between consecutive matrices when the batched Gemm offsets are evenly spaced, so the batch can run
+  // as a single strided batch. A stride of 0 means every multiply reuses the same matrix.
+  // Returns false if broadcasting leaves the offsets unevenly spaced.
+  bool BatchStrides(size_t& left_stride, size_t& right_stride, size_t& output_stride) const {
+    const size_t len = output_offsets_.size();
+    left_stride = len > 1 ? left_offsets_[1] : 0;
+    right_stride = len > 1 ? right_offsets_[1] : 0;
+    output_stride = len > 1 ? output_offsets_[1] : 0;
+    for (size_t i = 0; i < len; i++) {
+      if (left_offsets_[i] != i * left_stride || right_offsets_[i] != i * right_stride ||
+          output_offsets_[i] != i * output_stride) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   template <typename T>
   static void OffsetToArrays(T* p, const std::vector<size_t>& offsets, gsl::span<T*> arrays) {
     auto len = offsets.size();
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul_integer.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/qmath.h"
 #include "core/providers/common.h"
@@ -52,27 +53,89 @@ Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
                 "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
     a_offset = static_cast<int32_t>(*a_zero_point->template Data<uint8_t>());
   }
+  // a zero point per column of B is applied after the multiply, which runs with a zero point of 0 for B
+  const uint8_t* b_offsets = nullptr;
   if (has_b_zero_point_) {
     auto b_zero_point = ctx->Input<Tensor>(3);
-    ORT_ENFORCE(IsScalarOr1ElementVector(b_zero_point),
-                "MatmulInteger : input2 zero point must be a scalar or 1D tensor of size 1");
-    b_offset = static_cast<int32_t>(*b_zero_point->template Data<uint8_t>());
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      b_offset = static_cast<int32_t>(*b_zero_point->template Data<uint8_t>());
+    } else {
+      ORT_ENFORCE(b_zero_point->Shape().NumDimensions() == 1 &&
+                      b_zero_point->Shape()[0] == static_cast<int64_t>(helper.N()),
+                  "MatmulInteger : input2 zero point must be a scalar or 1D tensor of size 1 or of the number of "
+                  "columns of input2");
+      b_offsets = b_zero_point->template Data<uint8_t>();
+    }
+  }
+
+  auto apply_column_offsets = [&]() {
+    if (b_offsets == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      QGemmApplyColumnOffsets(static_cast<int>(helper.M()),
+                              static_cast<int>(helper.N()),
+                              static_cast<int>(helper.K()),
+                              a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                              static_cast<int>(helper.K()),
+                              a_offset,
+                              b_offsets,
+                              y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                              static_cast<int>(helper.N()));
+    }
+  };
+
+  size_t left_stride, right_stride, output_stride;
+  if (!packed_b_ && helper.BatchStrides(left_stride, right_stride, output_stride)) {
+    // run the whole batch as one strided multiply so small matrices still spread across the thread pool
+    auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+    QGemmBatchu8u8_s32(static_cast<int>(helper.M()),
+                       static_cast<int>(helper.N()),
+                       static_cast<int>(helper.K()),
+                       a->template Data<uint8_t>(),
+                       left_stride,
+                       a_offset,
+                       b->template Data<uint8_t>(),
+                       right_stride,
+                       b_offset,
+                       y->template MutableData<int32_t>(),
+                       output_stride,
+                       helper.OutputOffsets().size(),
+                       ctx_internal->GetOperatorThreadPool());
+    apply_column_offsets();
+    return Status::OK();
   }
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
-    QGemmu8u8_s32(static_cast<int>(helper.M()),
-                  static_cast<int>(helper.N()),
-                  static_cast<int>(helper.K()),
-                  a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                  static_cast<int>(helper.K()),
-                  a_offset,
-                  b->template Data<uint8_t>() + helper.RightOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  b_offset,
-                  y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
-                  static_cast<int>(helper.N()),
-                  nullptr);
+    if (packed_b_) {
+      // a packed B is 2-D, so every multiply uses all of it
+      QGemmu8u8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    a_offset,
+                    packed_b_.get(),
+                    b_offset,
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    nullptr);
+    } else {
+      QGemmu8u8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    a_offset,
+                    b->template Data<uint8_t>() + helper.RightOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    b_offset,
+                    y->template MutableData<int32_t>() + helper.OutputOffsets()[i],
+                    static_cast<int>(helper.N()),
+                    nullptr);
+    }
   }
+  apply_column_offsets();
   return Status::OK();
 }
 
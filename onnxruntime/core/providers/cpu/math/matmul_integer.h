@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 
@@ -21,6 +22,12 @@ class MatMulInteger final : public OpKernel {
     if (info.GetInputCount() > 3) {
       has_b_zero_point_ = true;
     }
+
+    // a constant uint8 B is packed once here instead of on every Compute
+    const Tensor* b;
+    if (info.TryGetConstantInput(1, &b)) {
+      QGemmPackBu8(*b, info.GetAllocator(0, OrtMemTypeDefault), packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,5 +35,6 @@ class MatMulInteger final : public OpKernel {
  private:
   bool has_a_zero_point_;
   bool has_b_zero_point_;
+  BufferUniquePtr packed_b_;
 };
 }  // namespace onnxruntime
@@ -60,6 +60,34 @@ Status QLinearMatMul<uint8_t, uint8_t, uint8_t>::Compute(OpKernelContext* ctx) c
   int right_shift;
   QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
 
+  if (packed_b_) {
+    // a packed B is 2-D, so every multiply uses all of it
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    const size_t gemm_output_size = static_cast<size_t>(helper.M() * helper.N());
+    auto* gemm_output = static_cast<int32_t*>(alloc->Alloc(sizeof(int32_t) * gemm_output_size));
+    BufferUniquePtr gemm_output_buffer(gemm_output, BufferDeleter(alloc));
+
+    for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+      QGemmu8u8_s32(static_cast<int>(helper.M()),
+                    static_cast<int>(helper.N()),
+                    static_cast<int>(helper.K()),
+                    a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                    static_cast<int>(helper.K()),
+                    *a_offset->template Data<uint8_t>(),
+                    packed_b_.get(),
+                    *b_offset->template Data<uint8_t>(),
+                    gemm_output,
+                    static_cast<int>(helper.N()),
+                    nullptr);
+      QuantizeDownInt32ToUint8(gemm_output, y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                               static_cast<int>(helper.M()), static_cast<int>(helper.N()), nullptr,
+                               *y_offset->template Data<uint8_t>(), integer_multiplier, right_shift);
+    }
+
+    return Status::OK();
+  }
+
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
     GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
                             b->template Data<uint8_t>() + helper.RightOffsets()[i],
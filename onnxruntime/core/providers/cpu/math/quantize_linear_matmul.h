@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/gemmlowp_common.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 
@@ -14,9 +15,16 @@ template <typename T1, typename T2, typename T3>
 class QLinearMatMul final : public OpKernel {
  public:
   QLinearMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    // a constant B is packed once here instead of on every Compute
+    const Tensor* b;
+    if (info.TryGetConstantInput(3, &b)) {
+      QGemmPackBu8(*b, info.GetAllocator(0, OrtMemTypeDefault), packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
+ private:
+  BufferUniquePtr packed_b_;
 };
 }  // namespace onnxruntime
@@ -32,13 +32,9 @@ Status Softmax<float>::Compute(OpKernelContext* ctx) const {
 
   auto* Ydata = Y->template MutableData<float>();
 
-  std::vector<float> scale_(N);
-  std::vector<float> rowmax_(N);
-  std::vector<float> sum_multiplier_(D, 1.f);  // initialize all multiplier values to 1.0
-
   const bool logarithmic = false;
   auto status = SoftmaxCPU(N, D, X.template Data<float>(), Ydata,
-                           scale_.data(), sum_multiplier_.data(), logarithmic, rowmax_.data(), tp);
+                           nullptr, nullptr, logarithmic, nullptr, tp);
 
   return status;
 }
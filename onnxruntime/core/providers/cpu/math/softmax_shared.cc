@@ -18,24 +18,13 @@
 * limitations under the License.
 */
 
-// disable noisy warning about use of std::copy_n by gsl::copy. gsl_algorithm does the same thing
-// but that's too late for the disable to work
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#endif
-#include <algorithm>
-#include <cmath>
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
+#include <sstream>
 
 #include "core/providers/cpu/math/softmax_shared.h"
 
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include "core/common/common.h"
+#include "core/mlas/inc/mlas.h"
 
-#include "gsl/gsl_algorithm"
 #include "gsl/gsl_util"
 
 namespace onnxruntime {
@@ -57,36 +46,11 @@ common::Status SoftmaxCPU(const int64_t N,
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, msg);
   }
 
-  const int n = gsl::narrow_cast<int>(N);
-  const int d = gsl::narrow_cast<int>(D);
-  const int nd = gsl::narrow_cast<int>(N * D);
+  ORT_UNUSED_PARAMETER(scale);
+  ORT_UNUSED_PARAMETER(sum_multiplier);
+  ORT_UNUSED_PARAMETER(rowmax);
 
-  math::RowwiseMax<float, CPUMathUtil>(n, d, Xdata, rowmax, nullptr);
-
-  // Put the intermediate result X - max(X) into Y by first copying X to Y, and then subtracting max from each entry
-  gsl::copy(gsl::make_span(Xdata, nd), gsl::make_span(Ydata, nd));
-
-  math::Gemm<float>(CblasNoTrans, CblasNoTrans, n, d, 1, -1, rowmax, sum_multiplier, 1, Ydata, tp);
-
-  // Exponentiation
-  math::Exp<float, CPUMathUtil>(nd, Ydata, Ydata, nullptr);
-  math::Gemv<float, CPUMathUtil>(CblasNoTrans, n, d, 1, Ydata, sum_multiplier, 0, scale, nullptr);
-
-  // Do division
-  if (!logarithmic) {
-    for (int i = 0; i < N; ++i) {
-      for (int j = 0; j < D; ++j) {
-        Ydata[i * D + j] /= scale[i];
-      }
-    }
-  } else {
-    for (int i = 0; i < N; ++i) {
-      auto log_fmaxf_scale_i = std::log(fmaxf(scale[i], 1e-20f));
-      for (int j = 0; j < D; ++j) {
-        Ydata[i * D + j] = Xdata[i * D + j] - rowmax[i] - log_fmaxf_scale_i;
-      }
-    }
-  }
+  MlasComputeSoftmax(Xdata, Ydata, gsl::narrow_cast<size_t>(N), gsl::narrow_cast<size_t>(D), logarithmic, tp);
 
   return Status::OK();
 }
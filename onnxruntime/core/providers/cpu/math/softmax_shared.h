@@ -15,10 +15,10 @@ Calculate Softmax using CPU memory.
 @param D Number of elements in each row
 @param Xdata Source data
 @param Ydata Output data
-@param scale Storage for scale calculation. Size must be >= N.
-@param sum_multiplier Weights for each element. Size must be >= D.
+@param scale Unused. May be nullptr.
+@param sum_multiplier Unused. May be nullptr.
 @param logarithmic If true, compute LogSoftmax. If false compute Softmax.
-@param rowmax Storage for calculation of maximum in each row. Size must be >= N.
+@param rowmax Unused. May be nullptr.
 */
 common::Status SoftmaxCPU(int64_t N, int64_t D, const float* Xdata, float* Ydata, float* scale,
                           const float* sum_multiplier, bool logarithmic, float* rowmax, concurrency::ThreadPool* tp);
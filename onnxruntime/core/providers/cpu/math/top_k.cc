@@ -19,9 +19,11 @@
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
-#include <queue>
+#include <algorithm>
 using namespace std;
 namespace onnxruntime {
 
@@ -48,13 +50,48 @@ template <typename T>
 struct ValueCmp {
   bool operator()(
       const pair<T, int64_t>& lhs,
-      const pair<T, int64_t>& rhs) {
+      const pair<T, int64_t>& rhs) const {
     return (
         lhs.first > rhs.first ||
         (lhs.first == rhs.first && lhs.second < rhs.second));
   }
 };
 
+// smallest number of input elements examined by a task
+constexpr int64_t kMinTopKElementsPerTask = 16384;
+
+// Selects the k largest of the dim values at input[l * stride] into result, largest first, with ties
+// ordered by index. A min-heap of the k best values so far is used when k is small compared to dim,
+// as most values are then rejected by a single comparison with the top of the heap. Otherwise all the
+// values are partitioned around the k-th with nth_element and only the first k are sorted.
+static void SelectTopK(const float* input, int64_t dim, int64_t stride, unsigned k,
+                       vector<pair<float, int64_t>>& result) {
+  const ValueCmp<float> cmp;
+  result.clear();
+
+  if (static_cast<int64_t>(k) * 4 < dim) {
+    for (int64_t l = 0; l < dim; ++l) {
+      const float value = input[l * stride];
+      if (result.size() < k) {
+        result.emplace_back(value, l);
+        push_heap(result.begin(), result.end(), cmp);
+      } else if (value > result.front().first) {
+        pop_heap(result.begin(), result.end(), cmp);
+        result.back() = {value, l};
+        push_heap(result.begin(), result.end(), cmp);
+      }
+    }
+    sort_heap(result.begin(), result.end(), cmp);
+  } else {
+    for (int64_t l = 0; l < dim; ++l) {
+      result.emplace_back(input[l * stride], l);
+    }
+    nth_element(result.begin(), result.begin() + (k - 1), result.end(), cmp);
+    result.resize(k);
+    sort(result.begin(), result.end(), cmp);
+  }
+}
+
 // Core TopK implementation
 Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int axis, const unsigned k) {
 
@@ -78,10 +115,7 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
 
   const int64_t rows = SizeToDim(axis_parsed, in_dims);
   const int64_t cols = X->Shape().Size() / rows;
-  auto input_map = ConstEigenMatrixMapRowMajor<float>(
-      static_cast<const float*>(X->template Data<float>()),
-      rows,
-      cols);
+  const float* input_data = X->template Data<float>();
 
   // Resize output tensors to be the same shape as the input except
   // for the specified dimension ((i.e.) axis_parsed), which will be of size k. E.x. for an input tensor
@@ -100,36 +134,37 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
 
   // This is basically the number of elements within each of the "k" rows
   const int64_t block_slice = reduced_cols / k;
-  // Sort preserving Indices
-  for (int64_t i = 0; i < rows; ++i) {
-    for (int64_t j = 0; j < block_slice; ++j) {
-      // Build a min-heap, the heap element is pair of (value, idx)
-      // the top of the heap is the smallest value
-      priority_queue<
-          pair<float, int64_t>,
-          vector<pair<float, int64_t>>,
-          ValueCmp<float>>
-          min_heap;
-      // Maintain the size of heap to be less or equal to k_, so the
-      // heap will hold the k largest Values
-      for (int64_t l = 0; l < in_dims[axis_parsed]; ++l) {
-        const auto value = input_map(i, l * block_slice + j);
-        if (min_heap.size() < k || value > min_heap.top().first) {
-          min_heap.push({value, l});
-        }
-        if (min_heap.size() > k) {
-          min_heap.pop();
-        }
-      }
-      // Extract these k elements and place them in the results placeholder
+  const int64_t dim = in_dims[axis_parsed];
+
+  // Each (row, column within the block) pair selects independently from dim values strided by block_slice.
+  const int64_t num_slices = rows * block_slice;
+  auto select_slices = [&](int64_t first, int64_t last) {
+    vector<pair<float, int64_t>> result;
+    result.reserve(static_cast<int64_t>(k) * 4 < dim ? k : dim);
+    for (int64_t slice = first; slice < last; ++slice) {
+      const int64_t i = slice / block_slice;
+      const int64_t j = slice % block_slice;
+      SelectTopK(input_data + i * cols + j, dim, block_slice, k, result);
       for (int64_t l = 0; l < k; ++l) {
-        auto& pqElem = min_heap.top();
-        auto col_index = (k - l - 1) * block_slice + j;
-        Values_map(i, col_index) = pqElem.first;
-        Indices_map(i, col_index) = pqElem.second;
-        min_heap.pop();
+        auto col_index = l * block_slice + j;
+        Values_map(i, col_index) = result[l].first;
+        Indices_map(i, col_index) = result[l].second;
       }
     }
+  };
+
+  auto* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(num_slices, num_slices * dim / kMinTopKElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    select_slices(0, num_slices);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      select_slices(num_slices * task / num_tasks, num_slices * (task + 1) / num_tasks);
+    });
   }
 
   return Status::OK();
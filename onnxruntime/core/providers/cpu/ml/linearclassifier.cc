@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/linearclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -73,79 +75,90 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
-  int64_t zindex = 0;
+  if (static_cast<int64_t>(coefficients_.size()) < class_count_ * stride) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "X has ", stride, " features but there are only ",
+                           coefficients_.size(), " coefficients for ", class_count_, " classes");
+  }
+
   const auto* x_data = X->template Data<T>();
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
 
-  auto class_count = static_cast<size_t>(class_count_);
-  std::vector<float> scores;
-  scores.reserve(class_count);
-  for (int64_t i = 0; i < N; i++)  //for each point
-  {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
-    int maxclass = -1;
-    float maxweight = 0.f;
-    for (int j = 0; j < class_count_; j++)  // for each class
-    {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
-      if (weight > maxweight || maxclass == -1) {
-        maxweight = weight;
-        maxclass = j;
-      }
+  // The scores of a block of rows are X * coefficients^T + intercepts, computed by one GEMM.
+  BatchParallelFor(tp, N, class_count_ * stride, [&](int64_t first_row, int64_t num_rows,
+                                                     concurrency::ThreadPool* block_tp) {
+    std::vector<float> x_buffer;
+    int64_t ldx;
+    const float* x = BatchRowsAsFloat(x_data, first_row, num_rows, stride, stride, nullptr, x_buffer, ldx);
+
+    std::vector<float> block_scores(static_cast<size_t>(num_rows * class_count_));
+    for (int64_t r = 0; r < num_rows; ++r) {
+      std::copy(intercepts_.begin(), intercepts_.end(), block_scores.begin() + r * class_count_);
     }
-    //write top class
-    if (intercepts_.size() == 1)  //binary
-    {
-      if (using_strings_) {
-        if (classlabels_strings_.size() == 2 && maxweight > 0) {
-          Y->template MutableData<std::string>()[i] = classlabels_strings_[1];  //positive label
-        } else if (classlabels_strings_.size() == 2) {
-          Y->template MutableData<std::string>()[i] = classlabels_strings_[0];  //negative label
-        } else if (maxweight > 0) {
-          Y->template MutableData<std::string>()[i] = "1";  //positive label
-        } else {
-          Y->template MutableData<std::string>()[i] = "0";  //negative label
-        }
-      } else  //no strings
-      {
-        if (classlabels_ints_.size() == 2 && maxweight > 0) {
-          Y->template MutableData<int64_t>()[i] = classlabels_ints_[1];  //positive label
-        } else if (classlabels_ints_.size() == 2) {
-          Y->template MutableData<int64_t>()[i] = classlabels_ints_[0];  //negative label
-        } else if (maxweight > 0) {
-          Y->template MutableData<int64_t>()[i] = 1;  //positive label
-        } else {
-          Y->template MutableData<int64_t>()[i] = 0;  //negative label
-        }
+    MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(num_rows), static_cast<size_t>(class_count_),
+              static_cast<size_t>(stride), 1.f, x, static_cast<size_t>(ldx), coefficients_.data(),
+              static_cast<size_t>(stride), 1.f, block_scores.data(),
+              static_cast<size_t>(class_count_), block_tp);
+
+    std::vector<float> scores;
+    scores.reserve(static_cast<size_t>(output_classes));
+    for (int64_t r = 0; r < num_rows; ++r) {
+      ScoreRow(block_scores.data() + r * class_count_, first_row + r, output_classes, add_second_class, scores, Y, Z);
+    }
+  });
+
+  return Status::OK();
+}
+
+template <typename T>
+void LinearClassifier<T>::ScoreRow(const float* row_scores, int64_t row, int64_t output_classes,
+                                   bool add_second_class, std::vector<float>& scores, Tensor* Y, Tensor* Z) const {
+  scores.assign(row_scores, row_scores + class_count_);
+  int maxclass = -1;
+  float maxweight = 0.f;
+  for (int j = 0; j < class_count_; j++) {
+    if (scores[j] > maxweight || maxclass == -1) {
+      maxweight = scores[j];
+      maxclass = j;
+    }
+  }
+  //write top class
+  if (intercepts_.size() == 1)  //binary
+  {
+    if (using_strings_) {
+      if (classlabels_strings_.size() == 2 && maxweight > 0) {
+        Y->template MutableData<std::string>()[row] = classlabels_strings_[1];  //positive label
+      } else if (classlabels_strings_.size() == 2) {
+        Y->template MutableData<std::string>()[row] = classlabels_strings_[0];  //negative label
+      } else if (maxweight > 0) {
+        Y->template MutableData<std::string>()[row] = "1";  //positive label
+      } else {
+        Y->template MutableData<std::string>()[row] = "0";  //negative label
       }
-    } else  //multiclass
+    } else  //no strings
     {
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
+      if (classlabels_ints_.size() == 2 && maxweight > 0) {
+        Y->template MutableData<int64_t>()[row] = classlabels_ints_[1];  //positive label
+      } else if (classlabels_ints_.size() == 2) {
+        Y->template MutableData<int64_t>()[row] = classlabels_ints_[0];  //negative label
+      } else if (maxweight > 0) {
+        Y->template MutableData<int64_t>()[row] = 1;  //positive label
       } else {
-        Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
+        Y->template MutableData<int64_t>()[row] = 0;  //negative label
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
-    } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
+  } else  //multiclass
+  {
+    if (using_strings_) {
+      Y->template MutableData<std::string>()[row] = classlabels_strings_[maxclass];
     } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+      Y->template MutableData<int64_t>()[row] = classlabels_ints_[maxclass];
     }
-    zindex += scores.size();
-  }  //for each point
-  return Status::OK();
+  }
+  //write float values, each row has output_classes scores
+  const int add_second_class_mode = add_second_class ? (maxweight > 0 ? 0 : 1) : -1;
+  ::onnxruntime::ml::write_scores(scores, post_transform_, row * output_classes, Z, add_second_class_mode);
+  float* z_data = Z->template MutableData<float>() + row * output_classes;
+  std::fill(z_data + std::min(scores.size(), static_cast<size_t>(output_classes)), z_data + output_classes, 0.f);
 }
 
 }  // namespace ml
@@ -18,6 +18,10 @@ class LinearClassifier final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  // writes the label and the scores of a row from its scores of each class
+  void ScoreRow(const float* row_scores, int64_t row, int64_t output_classes, bool add_second_class,
+                std::vector<float>& scores, Tensor* Y, Tensor* Z) const;
+
   int64_t multi_class_;
   int64_t class_count_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -358,5 +360,63 @@ void write_scores(std::vector<T>& scores, POST_EVAL_TRANSFORM post_transform, in
   memcpy(out_p, scores.data(), len);
 }
 
+// smallest number of multiply-adds computed by a task of the batched linear and SVM kernels
+constexpr int64_t kMinBatchOpsPerTask = 32768;
+// largest number of rows whose scores are computed by one GEMM, which bounds the scratch buffers of a task
+constexpr int64_t kMaxBatchBlockRows = 256;
+
+// Splits the N rows of a batch into blocks of at most kMaxBatchBlockRows rows, and runs
+// fn(first_row, num_rows, block_tp) for each of them. The blocks are spread over the threads of tp when the batch
+// costs enough, otherwise they run in turn and block_tp lets them use the thread pool themselves.
+template <typename TFunc>
+void BatchParallelFor(concurrency::ThreadPool* tp, int64_t N, int64_t ops_per_row, TFunc&& fn) {
+  int64_t num_tasks = N * ops_per_row / kMinBatchOpsPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+  num_tasks = std::min(num_tasks, N);
+
+  auto run_rows = [&fn](int64_t first, int64_t last, concurrency::ThreadPool* block_tp) {
+    for (int64_t row = first; row < last; row += kMaxBatchBlockRows) {
+      fn(row, std::min(kMaxBatchBlockRows, last - row), block_tp);
+    }
+  };
+
+  if (tp == nullptr || num_tasks <= 1) {
+    run_rows(0, N, tp);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      run_rows(N * task / num_tasks, N * (task + 1) / num_tasks, nullptr);
+    });
+  }
+}
+
+// Returns the num_rows rows of x_data starting at first_row, of which the first len values are read, as floats.
+// Rows that need a conversion or an offset subtracted are written to buffer, and ld is set to the distance between
+// the returned rows.
+template <typename T>
+const float* BatchRowsAsFloat(const T* x_data, int64_t first_row, int64_t num_rows, int64_t stride, int64_t len,
+                              const float* offset, std::vector<float>& buffer, int64_t& ld) {
+  buffer.resize(static_cast<size_t>(num_rows * len));
+  for (int64_t r = 0; r < num_rows; ++r) {
+    const T* x = x_data + (first_row + r) * stride;
+    float* row = buffer.data() + r * len;
+    for (int64_t i = 0; i < len; ++i) {
+      row[i] = offset == nullptr ? static_cast<float>(x[i]) : static_cast<float>(x[i]) - offset[i];
+    }
+  }
+  ld = len;
+  return buffer.data();
+}
+
+inline const float* BatchRowsAsFloat(const float* x_data, int64_t first_row, int64_t num_rows, int64_t stride,
+                                     int64_t len, const float* offset, std::vector<float>& buffer, int64_t& ld) {
+  if (offset != nullptr) {
+    return BatchRowsAsFloat<float>(x_data, first_row, num_rows, stride, len, offset, buffer, ld);
+  }
+  ld = stride;
+  return x_data + first_row * stride;
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
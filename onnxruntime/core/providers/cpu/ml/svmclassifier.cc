@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -58,6 +59,7 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
   if (vector_count_ > 0) {
     feature_count_ = support_vectors_.size() / vector_count_;  //length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
+    prepare_support_vectors(support_vectors_, vector_count_, feature_count_);
   } else {
     feature_count_ = coefficients_.size() / class_count_;  //liblinear mode
     mode_ = SVM_TYPE::SVM_LINEAR;
@@ -121,126 +123,138 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "X has ", stride, " features but the model reads ",
+                           feature_count_);
+  }
+
   const T* x_data = X->template Data<T>();
-  int64_t zindex = 0;
+  // liblinear mode scores the classes with their coefficients, otherwise the kernels of the support vectors are
+  // combined by the classifiers of each pair of classes
+  const bool svc = mode_ == SVM_TYPE::SVM_SVC;
+  const int64_t count = svc ? vector_count_ : class_count_;
+  const auto& vectors = svc ? support_vectors_ : coefficients_;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+
+  BatchParallelFor(tp, N, count * feature_count_, [&](int64_t first_row, int64_t num_rows,
+                                                      concurrency::ThreadPool* block_tp) {
+    std::vector<float> kernels(static_cast<size_t>(num_rows * count));
+    batched_kernel(x_data, first_row, num_rows, stride, vectors, count, feature_count_, get_kernel_type(),
+                   kernels.data(), block_tp);
 
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    std::vector<float> decisions;
     std::vector<float> scores;
-    std::vector<float> kernels;
     std::vector<int64_t> votes;
+    for (int64_t r = 0; r < num_rows; ++r) {
+      ScoreRow(kernels.data() + r * count, first_row + r, nb_columns, scores, votes, Y, Z);
+    }
+  });
 
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
-    } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
-      int evals = 0;
-
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      votes.resize(class_count_, 0);
-      for (int64_t i = 0; i < class_count_; i++) {        // for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
-          double sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[evals];
-          scores.push_back((float)sum);
-          ++(votes[sum > 0 ? i : j]);
-          ++evals;  //index into rho
-        }
+  return Status::OK();
+}
+
+template <typename T>
+void SVMClassifier<T>::ScoreRow(const float* kernels, int64_t row, int64_t nb_columns, std::vector<float>& scores,
+                                std::vector<int64_t>& votes, Tensor* Y, Tensor* Z) const {
+  int64_t maxclass = -1;
+  scores.clear();
+  votes.clear();
+
+  if (mode_ == SVM_TYPE::SVM_LINEAR) {
+    for (int64_t j = 0; j < class_count_; j++) {  //for each class
+      scores.push_back(kernels[j] + rho_[0]);
+    }
+  } else {
+    int evals = 0;
+    votes.resize(class_count_, 0);
+    for (int64_t i = 0; i < class_count_; i++) {        // for each class
+      for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
+        double sum = 0;
+        int64_t start_index_i = starting_vector_[i];  // *feature_count_;
+        int64_t start_index_j = starting_vector_[j];  // *feature_count_;
+
+        int64_t class_i_support_count = vectors_per_class_[i];
+        int64_t class_j_support_count = vectors_per_class_[j];
+
+        int64_t pos1 = (vector_count_) * (j - 1);
+        int64_t pos2 = (vector_count_) * (i);
+        const float* val1 = &(coefficients_[pos1 + start_index_i]);
+        const float* val2 = kernels + start_index_i;
+        for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        val1 = &(coefficients_[pos2 + start_index_j]);
+        val2 = kernels + start_index_j;
+        for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
+          sum += *val1 * *val2;
+
+        sum += rho_[evals];
+        scores.push_back((float)sum);
+        ++(votes[sum > 0 ? i : j]);
+        ++evals;  //index into rho
       }
     }
+  }
 
-    if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
-      //compute probabilities from the scores
-      int64_t num = class_count_ * class_count_;
-      std::vector<float> probsp2(num, 0.f);
-      std::vector<float> estimates(class_count_, 0.f);
-      int64_t index = 0;
-      for (int64_t i = 0; i < class_count_; ++i) {
-        int64_t p1 = i * class_count_ + i + 1;
-        int64_t p2 = (i + 1) * class_count_ + i;
-        for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
-          float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
-          float val2 = std::max(val1, 1.0e-7f);
-          val2 = std::min(val2, 1 - 1.0e-7f);
-          probsp2[p1] = val2;
-          probsp2[p2] = 1 - val2;
-          ++p1;
-          p2 += class_count_;
-        }
+  if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
+    //compute probabilities from the scores
+    int64_t num = class_count_ * class_count_;
+    std::vector<float> probsp2(num, 0.f);
+    std::vector<float> estimates(class_count_, 0.f);
+    int64_t index = 0;
+    for (int64_t i = 0; i < class_count_; ++i) {
+      int64_t p1 = i * class_count_ + i + 1;
+      int64_t p2 = (i + 1) * class_count_ + i;
+      for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
+        float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
+        float val2 = std::max(val1, 1.0e-7f);
+        val2 = std::min(val2, 1 - 1.0e-7f);
+        probsp2[p1] = val2;
+        probsp2[p2] = 1 - val2;
+        ++p1;
+        p2 += class_count_;
       }
-      multiclass_probability(class_count_, probsp2, estimates);
-      // copy probabilities back into scores
-      scores.resize(estimates.size());
-      std::copy(estimates.begin(), estimates.end(), scores.begin());
     }
+    multiclass_probability(class_count_, probsp2, estimates);
+    // copy probabilities back into scores
+    scores.resize(estimates.size());
+    std::copy(estimates.begin(), estimates.end(), scores.begin());
+  }
+
+  float max_weight = 0;
+  if (votes.size() > 0) {
+    auto it_maxvotes = std::max_element(votes.begin(), votes.end());
+    maxclass = std::distance(votes.begin(), it_maxvotes);
+  } else {
+    auto it_max_weight = std::max_element(scores.begin(), scores.end());
+    maxclass = std::distance(scores.begin(), it_max_weight);
+    max_weight = *it_max_weight;
+  }
 
-    float max_weight = 0;
-    if (votes.size() > 0) {
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
+  // write top class
+  // onnx specs expects one column per class.
+  int write_additional_scores = -1;
+  if (rho_.size() == 1) {
+    if (using_strings_) {
+      write_additional_scores = _set_score_svm<std::string>(
+          Y, max_weight, maxclass, row, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_strings_, "1", "0");
     } else {
-      auto it_max_weight = std::max_element(scores.begin(), scores.end());
-      maxclass = std::distance(scores.begin(), it_max_weight);
-      max_weight = *it_max_weight;
+      write_additional_scores = _set_score_svm<int64_t>(
+          Y, max_weight, maxclass, row, post_transform_, proba_,
+          weights_are_all_positive_, classlabels_ints_, 1, 0);
     }
-
-    // write top class
-    // onnx specs expects one column per class.
-    int write_additional_scores = -1;
-    if (rho_.size() == 1) {
-      if (using_strings_) {
-        write_additional_scores = _set_score_svm<std::string>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_strings_, "1", "0");
-      } else {
-        write_additional_scores = _set_score_svm<int64_t>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_ints_, 1, 0);
-      }
-    } else {  //multiclass
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
-      }
+  } else {  //multiclass
+    if (using_strings_) {
+      Y->template MutableData<std::string>()[row] = classlabels_strings_[maxclass];
+    } else {
+      Y->template MutableData<int64_t>()[row] = classlabels_ints_[maxclass];
     }
-
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
   }
 
-  return Status::OK();
+  // each row has nb_columns scores
+  write_scores(scores, post_transform_, row * nb_columns, Z, write_additional_scores);
+  float* z_data = Z->template MutableData<float>() + row * nb_columns;
+  std::fill(z_data + std::min(scores.size(), static_cast<size_t>(nb_columns)), z_data + nb_columns, 0.f);
 }
 
 }  // namespace ml
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,31 +30,87 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
+  // Prepares the count support vectors of len values for batched_kernel. The RBF kernel centers them on their
+  // mean, which keeps their distances to the inputs but makes the expansion of the distances more accurate, and
+  // keeps their squared norms.
+  void prepare_support_vectors(std::vector<float>& vectors, int64_t count, int64_t len) {
+    if (kernel_type_ != KERNEL::RBF || count == 0) {
+      return;
+    }
+    std::vector<double> sums(static_cast<size_t>(len), 0.);
+    for (int64_t j = 0; j < count; ++j) {
+      for (int64_t i = 0; i < len; ++i) {
+        sums[i] += vectors[j * len + i];
+      }
+    }
+    center_.resize(static_cast<size_t>(len));
+    for (int64_t i = 0; i < len; ++i) {
+      center_[i] = static_cast<float>(sums[i] / count);
+    }
+    vector_norms_.resize(static_cast<size_t>(count));
+    for (int64_t j = 0; j < count; ++j) {
+      double norm = 0.;
+      for (int64_t i = 0; i < len; ++i) {
+        float& value = vectors[j * len + i];
+        value -= center_[i];
+        norm += static_cast<double>(value) * value;
+      }
+      vector_norms_[j] = static_cast<float>(norm);
+    }
+  }
+
+  // Computes the kernel values of the num_rows rows of X from first_row with the count vectors of len values, into
+  // the num_rows x count matrix kernels. The dot products of the rows with the vectors are a single GEMM, and the
+  // RBF kernel expands the squared distances as |x|^2 - 2 x.v + |v|^2.
+  void batched_kernel(const T* x_data, int64_t first_row, int64_t num_rows, int64_t stride,
+                      const std::vector<float>& vectors, int64_t count, int64_t len, KERNEL k, float* kernels,
+                      concurrency::ThreadPool* tp) const {
+    const bool rbf = k == KERNEL::RBF;
+    std::vector<float> x_buffer;
+    int64_t ldx;
+    const float* x = BatchRowsAsFloat(x_data, first_row, num_rows, stride, len,
+                                      rbf && !center_.empty() ? center_.data() : nullptr, x_buffer, ldx);
+    MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(num_rows), static_cast<size_t>(count),
+              static_cast<size_t>(len), rbf ? -2.f : 1.f, x, static_cast<size_t>(ldx), vectors.data(),
+              static_cast<size_t>(len), 0.f, kernels, static_cast<size_t>(count), tp);
+
+    const size_t size = static_cast<size_t>(num_rows * count);
     if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      const int degree = static_cast<int>(degree_);
+      const bool integer_degree = degree_ == static_cast<float>(degree) && degree >= 1 && degree <= 8;
+      for (size_t i = 0; i < size; ++i) {
+        const float base = gamma_ * kernels[i] + coef0_;
+        if (integer_degree) {
+          float value = base;
+          for (int d = 1; d < degree; ++d) {
+            value *= base;
+          }
+          kernels[i] = value;
+        } else {
+          kernels[i] = static_cast<float>(std::pow(static_cast<double>(base), degree_));
+        }
+      }
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
+      for (size_t i = 0; i < size; ++i) {
+        kernels[i] = gamma_ * kernels[i] + coef0_;
+      }
+      MlasComputeTanh(kernels, kernels, size);
+    } else if (rbf) {
+      for (int64_t r = 0; r < num_rows; ++r) {
+        const float* row = x + r * ldx;
+        double row_norm = 0.;
+        for (int64_t i = 0; i < len; ++i) {
+          row_norm += static_cast<double>(row[i]) * row[i];
+        }
+        float* row_kernels = kernels + r * count;
+        for (int64_t j = 0; j < count; ++j) {
+          // rounding can make the distance of nearly equal vectors negative
+          const float distance = std::max(static_cast<float>(row_norm) + vector_norms_[j] + row_kernels[j], 0.f);
+          row_kernels[j] = -gamma_ * distance;
+        }
       }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+      MlasComputeExp(kernels, kernels, size);
     }
-    return (float)sum;
   }
 
  private:
@@ -61,11 +118,15 @@ class SVMCommon {
   float gamma_;
   float coef0_;
   float degree_;
+  // the mean subtracted from the support vectors of the RBF kernel, and their squared norms
+  std::vector<float> center_;
+  std::vector<float> vector_norms_;
 };
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::prepare_support_vectors;
+  using SVMCommon<T>::batched_kernel;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -74,6 +135,10 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   Status Compute(OpKernelContext* context) const override;
 
  private:
+  // writes the label and the scores of a row from its kernel values, or its decision values in liblinear mode
+  void ScoreRow(const float* kernels, int64_t row, int64_t nb_columns, std::vector<float>& scores,
+                std::vector<int64_t>& votes, Tensor* Y, Tensor* Z) const;
+
   bool weights_are_all_positive_;
   int64_t feature_count_;
   int64_t class_count_;
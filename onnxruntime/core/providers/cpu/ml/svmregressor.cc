@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -29,6 +30,7 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
   if (vector_count_ > 0) {
     feature_count_ = support_vectors_.size() / vector_count_;  //length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
+    prepare_support_vectors(support_vectors_, vector_count_, feature_count_);
   } else {
     feature_count_ = coefficients_.size();
     mode_ = SVM_TYPE::SVM_LINEAR;
@@ -44,33 +46,46 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "X has ", stride, " features but the model reads ",
+                           feature_count_);
+  }
+
   const auto* x_data = X->template Data<T>();
+  float* y_data = Y->template MutableData<float>();
+  // liblinear mode has a single vector of coefficients, otherwise the kernels of the support vectors are weighted
+  // by their coefficients
+  const bool svc = mode_ == SVM_TYPE::SVM_SVC;
+  const int64_t count = svc ? vector_count_ : 1;
+  const auto& vectors = svc ? support_vectors_ : coefficients_;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
+  BatchParallelFor(tp, N, count * feature_count_, [&](int64_t first_row, int64_t num_rows,
+                                                      concurrency::ThreadPool* block_tp) {
+    std::vector<float> kernels(static_cast<size_t>(num_rows * count));
+    batched_kernel(x_data, first_row, num_rows, stride, vectors, count, feature_count_, get_kernel_type(),
+                   kernels.data(), block_tp);
 
-    float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
+    for (int64_t r = 0; r < num_rows; ++r) {
+      const float* row_kernels = kernels.data() + r * count;
+      float sum = 0.f;
+      if (svc) {
+        for (int64_t j = 0; j < vector_count_; j++) {
+          sum += row_kernels[j] * coefficients_[j];
+        }
+      } else {
+        sum = row_kernels[0];
       }
       sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
-    }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
+      if (one_class_ && sum > 0) {
+        y_data[first_row + r] = 1.f;
+      } else if (one_class_) {
+        y_data[first_row + r] = -1.f;
+      } else {
+        y_data[first_row + r] = sum;
+      }
     }
-  }
+  });
 
   return Status::OK();
 }
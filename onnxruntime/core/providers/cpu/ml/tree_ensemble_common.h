@@ -0,0 +1,345 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+constexpr uint32_t kInvalidNode = std::numeric_limits<uint32_t>::max();
+constexpr int64_t kMaxTreeDepth = 1000;
+// rows evaluated against a tree before moving to the next one
+constexpr int64_t kRowBlockSize = 64;
+// smallest partition when the trees of a single block are split across threads
+constexpr int64_t kMinTreesPerTask = 64;
+
+// Dense per row accumulation of the leaf votes for num_targets targets (classes for the classifier).
+// has marks the targets that received at least one vote, mins and maxs are only tracked when requested.
+struct TreeEnsembleScores {
+  TreeEnsembleScores(int64_t num_rows, int64_t num_targets, bool track_extrema)
+      : num_targets(num_targets),
+        track_extrema(track_extrema),
+        sums(static_cast<size_t>(num_rows * num_targets)),
+        mins(track_extrema ? sums.size() : 0),
+        maxs(track_extrema ? sums.size() : 0),
+        has(sums.size()) {}
+
+  void Reset() {
+    std::fill(has.begin(), has.end(), static_cast<uint8_t>(0));
+  }
+
+  void Add(int64_t row, int64_t target, float weight) {
+    const size_t i = static_cast<size_t>(row * num_targets + target);
+    if (has[i] == 0) {
+      has[i] = 1;
+      sums[i] = weight;
+      if (track_extrema) {
+        mins[i] = weight;
+        maxs[i] = weight;
+      }
+    } else {
+      sums[i] += weight;
+      if (track_extrema) {
+        mins[i] = std::min(mins[i], weight);
+        maxs[i] = std::max(maxs[i], weight);
+      }
+    }
+  }
+
+  // combines the votes of another partition of the trees for the same rows
+  void Merge(const TreeEnsembleScores& other) {
+    for (size_t i = 0, end = has.size(); i < end; ++i) {
+      if (other.has[i] == 0) continue;
+      if (has[i] == 0) {
+        has[i] = 1;
+        sums[i] = other.sums[i];
+        if (track_extrema) {
+          mins[i] = other.mins[i];
+          maxs[i] = other.maxs[i];
+        }
+      } else {
+        sums[i] += other.sums[i];
+        if (track_extrema) {
+          mins[i] = std::min(mins[i], other.mins[i]);
+          maxs[i] = std::max(maxs[i], other.maxs[i]);
+        }
+      }
+    }
+  }
+
+  const int64_t num_targets;
+  const bool track_extrema;
+  std::vector<float> sums;
+  std::vector<float> mins;
+  std::vector<float> maxs;
+  std::vector<uint8_t> has;
+};
+
+// Tree ensemble shared by TreeEnsembleClassifier and TreeEnsembleRegressor.
+// The nodes_* attributes and the <vote_prefix>_treeids/_nodeids/_ids/_weights leaf votes are compiled once
+// at construction into contiguous arrays indexed by node position, with the children resolved to positions
+// and the votes of each node stored contiguously, so evaluation does no lookups.
+// Rows are evaluated in blocks against one tree at a time to keep the tree in cache, and the blocks
+// (or the trees, when there are few rows) are partitioned across the threads of the pool.
+class TreeEnsemble {
+ public:
+  TreeEnsemble(const OpKernelInfo& info, const std::string& vote_prefix) {
+    std::vector<int64_t> nodes_treeids(info.GetAttrsOrDefault<int64_t>("nodes_treeids"));
+    std::vector<int64_t> nodes_nodeids(info.GetAttrsOrDefault<int64_t>("nodes_nodeids"));
+    std::vector<int64_t> nodes_featureids(info.GetAttrsOrDefault<int64_t>("nodes_featureids"));
+    std::vector<float> nodes_values(info.GetAttrsOrDefault<float>("nodes_values"));
+    std::vector<float> nodes_hitrates(info.GetAttrsOrDefault<float>("nodes_hitrates"));
+    std::vector<std::string> nodes_modes(info.GetAttrsOrDefault<std::string>("nodes_modes"));
+    std::vector<int64_t> nodes_truenodeids(info.GetAttrsOrDefault<int64_t>("nodes_truenodeids"));
+    std::vector<int64_t> nodes_falsenodeids(info.GetAttrsOrDefault<int64_t>("nodes_falsenodeids"));
+    std::vector<int64_t> missing_tracks_true(info.GetAttrsOrDefault<int64_t>("nodes_missing_value_tracks_true"));
+    std::vector<int64_t> vote_treeids(info.GetAttrsOrDefault<int64_t>(vote_prefix + "_treeids"));
+    std::vector<int64_t> vote_nodeids(info.GetAttrsOrDefault<int64_t>(vote_prefix + "_nodeids"));
+    std::vector<int64_t> vote_ids(info.GetAttrsOrDefault<int64_t>(vote_prefix + "_ids"));
+    std::vector<float> vote_weights(info.GetAttrsOrDefault<float>(vote_prefix + "_weights"));
+
+    const size_t num_nodes = nodes_nodeids.size();
+    ORT_ENFORCE(!nodes_treeids.empty());
+    ORT_ENFORCE(num_nodes == nodes_treeids.size());
+    ORT_ENFORCE(num_nodes == nodes_featureids.size());
+    ORT_ENFORCE(num_nodes == nodes_values.size());
+    ORT_ENFORCE(num_nodes == nodes_modes.size());
+    ORT_ENFORCE(num_nodes == nodes_truenodeids.size());
+    ORT_ENFORCE(num_nodes == nodes_falsenodeids.size());
+    ORT_ENFORCE((num_nodes == nodes_hitrates.size()) || (nodes_hitrates.empty()));
+    ORT_ENFORCE(num_nodes < static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
+    ORT_ENFORCE(vote_nodeids.size() < static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
+    ORT_ENFORCE(vote_nodeids.size() == vote_treeids.size());
+    ORT_ENFORCE(vote_nodeids.size() == vote_ids.size());
+    ORT_ENFORCE(vote_nodeids.size() == vote_weights.size());
+
+    // in the absence of bool type supported by GetAttrs this ensure that we don't have any negative
+    // values so that we can check for the truth condition without worrying about negative values.
+    ORT_ENFORCE(std::all_of(
+        std::begin(missing_tracks_true),
+        std::end(missing_tracks_true), [](int64_t elem) { return elem >= 0; }));
+
+    // map the (tree id, node id) pairs to node positions. node ids are unique within a tree.
+    std::unordered_map<int64_t, std::unordered_map<int64_t, uint32_t>> positions;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      positions[nodes_treeids[i]].insert(std::make_pair(nodes_nodeids[i], static_cast<uint32_t>(i)));
+    }
+    auto find_node = [&positions](int64_t treeid, int64_t nodeid) {
+      auto tree = positions.find(treeid);
+      if (tree == positions.end()) return kInvalidNode;
+      auto node = tree->second.find(nodeid);
+      return node == tree->second.end() ? kInvalidNode : node->second;
+    };
+
+    modes_.reserve(num_nodes);
+    feature_ids_.resize(num_nodes);
+    thresholds_ = std::move(nodes_values);
+    true_children_.resize(num_nodes);
+    false_children_.resize(num_nodes);
+    if (missing_tracks_true.size() == num_nodes) {
+      missing_tracks_true_.resize(num_nodes);
+    }
+
+    // roots are the nodes that no other node of the tree points to
+    std::vector<uint8_t> has_parent(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+      modes_.push_back(MakeTreeNodeMode(nodes_modes[i]));
+      if (!missing_tracks_true_.empty()) {
+        missing_tracks_true_[i] = missing_tracks_true[i] != 0;
+      }
+      if (modes_[i] == NODE_MODE::LEAF) {
+        feature_ids_[i] = 0;
+        true_children_[i] = static_cast<uint32_t>(i);
+        false_children_[i] = static_cast<uint32_t>(i);
+        continue;
+      }
+      ORT_ENFORCE(nodes_featureids[i] >= 0, "Invalid feature id ", nodes_featureids[i], " for a branch node.");
+      feature_ids_[i] = nodes_featureids[i];
+      max_feature_id_ = std::max(max_feature_id_, nodes_featureids[i]);
+      // they must be in the same tree
+      true_children_[i] = find_node(nodes_treeids[i], nodes_truenodeids[i]);
+      false_children_[i] = find_node(nodes_treeids[i], nodes_falsenodeids[i]);
+      ORT_ENFORCE(true_children_[i] != kInvalidNode && false_children_[i] != kInvalidNode,
+                  "Branch node ", nodes_nodeids[i], " of tree ", nodes_treeids[i], " has a missing child.");
+      has_parent[true_children_[i]] = 1;
+      has_parent[false_children_[i]] = 1;
+    }
+    for (size_t i = 0; i < num_nodes; ++i) {
+      if (has_parent[i] == 0) {
+        roots_.push_back(static_cast<uint32_t>(i));
+      }
+    }
+
+    // leaf votes, grouped by node position. votes for nodes that don't exist are never reached.
+    std::vector<std::pair<uint32_t, size_t>> votes;
+    votes.reserve(vote_nodeids.size());
+    for (size_t i = 0, end = vote_nodeids.size(); i < end; ++i) {
+      ORT_ENFORCE(vote_ids[i] >= 0, "Invalid ", vote_prefix, "_ids value of ", vote_ids[i]);
+      uint32_t node = find_node(vote_treeids[i], vote_nodeids[i]);
+      if (node != kInvalidNode) {
+        votes.push_back(std::make_pair(node, i));
+      }
+      max_vote_id_ = std::max(max_vote_id_, vote_ids[i]);
+    }
+    std::stable_sort(votes.begin(), votes.end(),
+                     [](const std::pair<uint32_t, size_t>& v1, const std::pair<uint32_t, size_t>& v2) {
+                       return v1.first < v2.first;
+                     });
+    vote_begin_.assign(num_nodes + 1, 0);
+    vote_ids_.reserve(votes.size());
+    vote_weights_.reserve(votes.size());
+    for (const auto& vote : votes) {
+      vote_begin_[vote.first + 1]++;
+      vote_ids_.push_back(vote_ids[vote.second]);
+      vote_weights_.push_back(vote_weights[vote.second]);
+    }
+    for (size_t i = 0; i < num_nodes; ++i) {
+      vote_begin_[i + 1] += vote_begin_[i];
+    }
+  }
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // the largest id of a leaf vote, or -1 if there are none
+  int64_t MaxVoteId() const { return max_vote_id_; }
+
+  // the smallest row stride of the input that the branch nodes can read within
+  int64_t MinimumStride() const { return max_feature_id_ + 1; }
+
+  // Evaluates num_rows rows of x_data and calls finalize(first_row, block_rows, scores) with the accumulated
+  // votes of all trees for each block of rows, where row r of scores is row first_row + r of x_data.
+  // finalize may be called concurrently for different blocks.
+  template <typename T, typename Finalize>
+  void Evaluate(const T* x_data, int64_t stride, int64_t num_rows, int64_t num_targets, bool track_extrema,
+                concurrency::ThreadPool* tp, Finalize&& finalize) const {
+    const int64_t num_blocks = (num_rows + kRowBlockSize - 1) / kRowBlockSize;
+    const int64_t num_trees = static_cast<int64_t>(roots_.size());
+    const int64_t max_tasks = tp != nullptr ? static_cast<int64_t>(tp->NumThreads()) + 1 : 1;
+
+    if (num_blocks == 1 && max_tasks > 1 && num_trees >= 2 * kMinTreesPerTask) {
+      // too few rows to split, so split the trees and reduce the votes of each partition in order
+      const int64_t num_tasks = std::min(max_tasks, num_trees / kMinTreesPerTask);
+      std::vector<TreeEnsembleScores> partitions;
+      partitions.reserve(static_cast<size_t>(num_tasks));
+      for (int64_t task = 0; task < num_tasks; ++task) {
+        partitions.emplace_back(num_rows, num_targets, track_extrema);
+      }
+      tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+        const size_t first_tree = static_cast<size_t>(num_trees * task / num_tasks);
+        const size_t last_tree = static_cast<size_t>(num_trees * (task + 1) / num_tasks);
+        EvaluateBlock(x_data, stride, num_rows, first_tree, last_tree, partitions[task]);
+      });
+      for (int64_t task = 1; task < num_tasks; ++task) {
+        partitions[0].Merge(partitions[task]);
+      }
+      finalize(static_cast<int64_t>(0), num_rows, static_cast<const TreeEnsembleScores&>(partitions[0]));
+      return;
+    }
+
+    const int64_t num_tasks = std::min(max_tasks, num_blocks);
+    auto evaluate_blocks = [&](int32_t task) {
+      const int64_t first_block = num_blocks * task / num_tasks;
+      const int64_t last_block = num_blocks * (task + 1) / num_tasks;
+      TreeEnsembleScores scores(std::min(num_rows, kRowBlockSize), num_targets, track_extrema);
+      for (int64_t block = first_block; block < last_block; ++block) {
+        const int64_t first_row = block * kRowBlockSize;
+        const int64_t block_rows = std::min(kRowBlockSize, num_rows - first_row);
+        scores.Reset();
+        EvaluateBlock(x_data + first_row * stride, stride, block_rows, 0, roots_.size(), scores);
+        finalize(first_row, block_rows, static_cast<const TreeEnsembleScores&>(scores));
+      }
+    };
+
+    if (num_tasks > 1) {
+      tp->ParallelFor(static_cast<int32_t>(num_tasks), evaluate_blocks);
+    } else if (num_tasks == 1) {
+      evaluate_blocks(0);
+    }
+  }
+
+ private:
+  // walks down the tree from root to the leaf for one row
+  template <typename T>
+  uint32_t ProcessTree(uint32_t index, const T* x_data) const {
+    int64_t loopcount = 0;
+    while (modes_[index] != NODE_MODE::LEAF) {
+      const T val = x_data[feature_ids_[index]];
+      const float threshold = thresholds_[index];
+      bool result;
+      switch (modes_[index]) {
+        case NODE_MODE::BRANCH_LEQ:
+          result = val <= threshold;
+          break;
+        case NODE_MODE::BRANCH_LT:
+          result = val < threshold;
+          break;
+        case NODE_MODE::BRANCH_GTE:
+          result = val >= threshold;
+          break;
+        case NODE_MODE::BRANCH_GT:
+          result = val > threshold;
+          break;
+        case NODE_MODE::BRANCH_EQ:
+          result = val == threshold;
+          break;
+        default:
+          result = val != threshold;
+          break;
+      }
+      if (!result && !missing_tracks_true_.empty() && missing_tracks_true_[index] &&
+          std::isnan(static_cast<float>(val))) {
+        result = true;
+      }
+      index = result ? true_children_[index] : false_children_[index];
+      if (++loopcount > kMaxTreeDepth) break;
+    }
+    return index;
+  }
+
+  // accumulates the votes of trees [first_tree, last_tree) for num_rows rows of x_data.
+  // the rows are the inner loop so that the nodes of a tree stay in cache for the whole block.
+  template <typename T>
+  void EvaluateBlock(const T* x_data, int64_t stride, int64_t num_rows, size_t first_tree, size_t last_tree,
+                     TreeEnsembleScores& scores) const {
+    for (size_t j = first_tree; j < last_tree; ++j) {
+      const uint32_t root = roots_[j];
+      const T* x_row = x_data;
+      for (int64_t r = 0; r < num_rows; ++r, x_row += stride) {
+        const uint32_t leaf = ProcessTree(root, x_row);
+        for (uint32_t v = vote_begin_[leaf], end = vote_begin_[leaf + 1]; v < end; ++v) {
+          scores.Add(r, vote_ids_[v], vote_weights_[v]);
+        }
+      }
+    }
+  }
+
+  // nodes, indexed by position
+  std::vector<NODE_MODE> modes_;
+  std::vector<int64_t> feature_ids_;
+  std::vector<float> thresholds_;
+  std::vector<uint32_t> true_children_;
+  std::vector<uint32_t> false_children_;
+  std::vector<uint8_t> missing_tracks_true_;  // empty if no node tracks missing values
+  std::vector<uint32_t> roots_;
+
+  // votes of node i are [vote_begin_[i], vote_begin_[i + 1])
+  std::vector<uint32_t> vote_begin_;
+  std::vector<int64_t> vote_ids_;
+  std::vector<float> vote_weights_;
+
+  int64_t max_feature_id_ = -1;
+  int64_t max_vote_id_ = -1;
+};
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
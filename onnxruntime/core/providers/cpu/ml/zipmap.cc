@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/ml/zipmap.h"
 #include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <numeric>
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
 ONNX_OPERATOR_SCHEMA(ZipMap)
@@ -35,6 +38,24 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
                                             DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()}),
     ZipMapOp);
 
+// Returns the indices of the labels sorted by label. Of duplicated labels only the last index is kept, as assigning
+// the values in the order of the labels would.
+template <typename T>
+static std::vector<size_t> SortedLabelIndices(const std::vector<T>& labels) {
+  std::vector<size_t> indices(labels.size());
+  std::iota(indices.begin(), indices.end(), size_t{0});
+  std::stable_sort(indices.begin(), indices.end(), [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+
+  std::vector<size_t> unique_indices;
+  unique_indices.reserve(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (i + 1 == indices.size() || labels[indices[i]] < labels[indices[i + 1]]) {
+      unique_indices.push_back(indices[i]);
+    }
+  }
+  return unique_indices;
+}
+
 ZipMapOp::ZipMapOp(const OpKernelInfo& info)
     : OpKernel(info),
       classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
@@ -42,6 +63,8 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+  sorted_label_indices_ = using_strings_ ? SortedLabelIndices(classlabels_strings_)
+                                         : SortedLabelIndices(classlabels_int64s_);
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -82,12 +105,12 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     y_data->resize(batch_size);
     int64_t current_weight_0 = 0;
     for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
+      auto& map1 = (*y_data)[n];
+      map1.clear();
+      for (auto j : sorted_label_indices_) {
+        map1.emplace_hint(map1.end(), classlabels_strings_[j], x_data[current_weight_0 + j]);
       }
       current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
     }
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
@@ -101,13 +124,13 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     //auto* y_data = Y->template MutableData<std::vector<std::map<int64_t, float>>>();
     y_data->resize(batch_size);
     int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
+    for (int64_t n = 0; n < batch_size; n++) {
+      auto& map2 = (*y_data)[n];
+      map2.clear();
+      for (auto j : sorted_label_indices_) {
+        map2.emplace_hint(map2.end(), classlabels_int64s_[j], x_data[current_weight_0 + j]);
       }
       current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
     }
   }
   return common::Status::OK();
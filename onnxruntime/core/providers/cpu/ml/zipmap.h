@@ -16,6 +16,8 @@ class ZipMapOp final : public OpKernel {
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+  // the indices of the labels in increasing label order, so each map is built by appending to its end
+  std::vector<size_t> sorted_label_indices_;
 };
 
 }  // namespace ml
@@ -17,8 +17,16 @@
 
 #include "core/providers/cpu/nn/batch_norm.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
+
+namespace {
+// the smallest number of elements worth handing to another thread
+constexpr size_t kMinBatchNormElementsPerTask = 16384;
+}  // namespace
+
 // spec: https://github.com/onnx/onnx/blob/master/docs/Operators.md#BatchNormalization
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     BatchNormalization,
@@ -67,10 +75,38 @@ Status BatchNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
   Eigen::Array<float, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
   Eigen::Array<float, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-  EigenArrayMap<float> Y_arr(Y->template MutableData<float>(), sample_size, N * C);
-  ConstEigenArrayMap<float> X_arr(X->template Data<float>(), sample_size, N * C);
-  for (size_t nc = 0; nc < N * C; ++nc) {
-    Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
+  const float* Xdata = X->template Data<float>();
+  float* Ydata = Y->template MutableData<float>();
+
+  // the activation is applied to each plane right after it is normalized, while it is still in the cache
+  auto normalize_planes = [&](size_t first, size_t last) {
+    for (size_t nc = first; nc < last; ++nc) {
+      const float* Xi = Xdata + nc * sample_size;
+      float* Yi = Ydata + nc * sample_size;
+      const float channel_scale = new_scale(nc % C);
+      const float channel_shift = new_bias(nc % C);
+      for (size_t i = 0; i < sample_size; ++i) {
+        Yi[i] = Xi[i] * channel_scale + channel_shift;
+      }
+      if (activation_.ActivationKind != MlasIdentityActivation) {
+        MlasActivation(&activation_, Yi, nullptr, 1, sample_size, sample_size);
+      }
+    }
+  };
+
+  const size_t planes = N * C;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  size_t num_tasks = std::min(planes, planes * sample_size / kMinBatchNormElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<size_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    normalize_planes(0, planes);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      normalize_planes(planes * task / num_tasks, planes * (task + 1) / num_tasks);
+    });
   }
 
   return Status::OK();
@@ -22,6 +22,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/autopad_type.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -40,12 +41,16 @@ class BatchNorm : public OpKernel {
     }
 
     //TODO: momentum
+
+    activation_.ActivationKind = MlasIdentityActivation;
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
 
   protected:
    float epsilon_;
+   // applied to the normalized output, see FusedBatchNormalization
+   MLAS_ACTIVATION activation_;
    //int64_t is_test_;   ignored in this implementation since we're doing inferencing only.
 };
 }  // namespace onnxruntime
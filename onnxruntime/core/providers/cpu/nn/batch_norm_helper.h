@@ -10,11 +10,13 @@
 namespace onnxruntime {
 class BatchNormHelper {
  public:
+  // channels_last is set if the channels are the last dimension of X instead of the second
   static common::Status ValidateInputs(const Tensor* X,
                                        const Tensor* scale,
                                        const Tensor* B,
                                        const Tensor* mean,
-                                       const Tensor* var) {
+                                       const Tensor* var,
+                                       bool channels_last = false) {
     // defined as per spec and used for validation
     constexpr int kNumInputScaleDimensions = 1;
     constexpr int kNumInputBiasDimensions = 1;
@@ -27,7 +29,7 @@ class BatchNormHelper {
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Invalid input X: Empty dimensions");
     }
 
-    int64_t num_channels = X->Shape().GetDims()[1];
+    int64_t num_channels = channels_last ? X->Shape().GetDims().back() : X->Shape().GetDims()[1];
 
     if (scale->Shape().NumDimensions() != kNumInputScaleDimensions) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input scale: NumDimensions() != ", kNumInputScaleDimensions);
@@ -18,8 +18,13 @@
 
 #include "core/providers/cpu/nn/conv.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/util/math_cpuonly.h"
 
+#include <chrono>
+#include <limits>
+#include <sstream>
+
 namespace onnxruntime {
 
 template <typename T>
@@ -85,6 +90,10 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
                           output_shape.GetDims().end());
 
   for (int image_id = 0; image_id < N; ++image_id) {
+    if (context->IsTerminated()) {
+      return OpKernelContext::TerminatedStatus();
+    }
+
     for (int group_id = 0; group_id < group_; ++group_id) {
       if (Is2DKernel) {
         math::Im2col<T, CPUMathUtil, StorageOrder::NCHW>(
@@ -146,6 +155,185 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+void Conv<float>::TransformWinogradFilter(const OpKernelInfo& info, const Tensor& W) {
+  const auto& shape = W.Shape();
+  if (W.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 4 ||
+      shape[2] != 3 || shape[3] != 3 || shape.Size() == 0 || shape[0] % group_ != 0) {
+    return;
+  }
+
+  // MlasConvPrepare only selects the Winograd algorithm for unit strides and dilations
+  for (auto stride : strides_) {
+    if (stride != 1) {
+      return;
+    }
+  }
+  for (auto dilation : dilations_) {
+    if (dilation != 1) {
+      return;
+    }
+  }
+
+  const size_t group_count = static_cast<size_t>(group_);
+  const size_t filter_count = static_cast<size_t>(shape[0] / group_);
+  const size_t input_channels = static_cast<size_t>(shape[1]);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  void* buffer = alloc->Alloc(sizeof(float) * MlasConvWinogradFilterSize(group_count, filter_count, input_channels));
+  winograd_filter_ = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasConvWinogradTransformFilter(group_count, filter_count, input_channels, W.Data<float>(),
+                                  static_cast<float*>(buffer));
+}
+
+namespace {
+// the number of timed runs of each algorithm, after a run to warm up the caches.
+constexpr int kTuningRuns = 3;
+
+template <typename T>
+void AppendDims(std::ostringstream& key, char prefix, const std::vector<T>& dims) {
+  key << '_' << prefix;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    key << (i == 0 ? "" : "x") << dims[i];
+  }
+}
+}  // namespace
+
+void Conv<float>::TuneAlgorithm(const OpKernelInfo& info, const Tensor& W) {
+  const auto* provider = info.GetExecutionProvider();
+  if (provider == nullptr || provider->Type() != kCpuExecutionProvider) {
+    return;
+  }
+  auto* cache = static_cast<const CPUExecutionProvider*>(provider)->GetKernelTuningCache();
+  if (cache == nullptr || W.DataType() != DataTypeImpl::GetType<float>()) {
+    return;
+  }
+
+  // the algorithms are benchmarked ahead of the first Run, so the input shape must be known
+  const auto* X_shape_proto = info.node().InputDefs()[0]->Shape();
+  if (X_shape_proto == nullptr) {
+    return;
+  }
+  std::vector<int64_t> X_dims;
+  for (const auto& dim : X_shape_proto->dim()) {
+    if (!dim.has_dim_value()) {
+      return;
+    }
+    X_dims.push_back(dim.dim_value());
+  }
+
+  // only the 2D convolutions have alternative algorithms
+  const auto& W_shape = W.Shape();
+  if (X_dims.size() != 4 || W_shape.NumDimensions() != 4 || W_shape.Size() == 0 ||
+      W_shape[0] % group_ != 0 || X_dims[1] != W_shape[1] * group_) {
+    return;
+  }
+
+  std::vector<int64_t> kernel_shape;
+  if (!ComputeKernelShape(W_shape, kernel_shape).IsOK()) {
+    return;
+  }
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  const int64_t N = X_dims[0];
+  const int64_t C = X_dims[1];
+  const int64_t M = W_shape[0];
+  std::vector<int64_t> Y_dims{N, M};
+  const TensorShape input_shape = TensorShape(X_dims).Slice(2);
+  if (!InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims).IsOK()) {
+    return;
+  }
+  const TensorShape output_shape = TensorShape(Y_dims).Slice(2);
+  if (TensorShape(X_dims).Size() == 0 || output_shape.Size() <= 0) {
+    return;
+  }
+
+  MLAS_CONV_PARAMETERS Parameters;
+  size_t WorkingBufferSize;
+  MlasConvPrepare(&Parameters,
+                  kernel_shape.size(),
+                  static_cast<size_t>(N),
+                  static_cast<size_t>(group_),
+                  static_cast<size_t>(C / group_),
+                  input_shape.GetDims().data(),
+                  kernel_shape.data(),
+                  dilations.data(),
+                  pads.data(),
+                  strides.data(),
+                  output_shape.GetDims().data(),
+                  static_cast<size_t>(M / group_),
+                  &activation_,
+                  &WorkingBufferSize,
+                  nullptr);
+
+  // the direct GEMM and depthwise algorithms are only selected for the shapes they suit best, so only the
+  // choice between the Winograd algorithm and the GEMM of the expanded input is tuned.
+  MLAS_CONV_PARAMETERS WinogradParameters = Parameters;
+  size_t WinogradWorkingBufferSize;
+  MLAS_CONV_PARAMETERS ExpandParameters = Parameters;
+  size_t ExpandWorkingBufferSize;
+  if (Parameters.Algorithm == MlasConvAlgorithmGemmDirect || Parameters.Algorithm == MlasConvAlgorithmDepthwise ||
+      winograd_filter_ == nullptr ||
+      !MlasConvSelectAlgorithm(&WinogradParameters, MlasConvAlgorithmWinograd, &WinogradWorkingBufferSize, nullptr) ||
+      !MlasConvSelectAlgorithm(&ExpandParameters, MlasConvAlgorithmExpandThenGemm, &ExpandWorkingBufferSize, nullptr)) {
+    return;
+  }
+
+  std::ostringstream key;
+  key << "Conv";
+  AppendDims(key, 'x', X_dims);
+  AppendDims(key, 'w', W_shape.GetDims());
+  AppendDims(key, 'p', pads);
+  AppendDims(key, 's', strides);
+  AppendDims(key, 'd', dilations);
+  key << "_g" << group_;
+
+  int choice;
+  if (cache->Lookup(key.str(), choice)) {
+    tuned_algorithm_ = static_cast<MLAS_CONV_ALGORITHM>(choice);
+  } else if (cache->IsTuningEnabled()) {
+    std::vector<float> X(static_cast<size_t>(TensorShape(X_dims).Size()), 1.0f);
+    std::vector<float> Y(static_cast<size_t>(TensorShape(Y_dims).Size()));
+
+    // the thread pool of the session isn't available to the kernel constructor, so the benchmarks use the
+    // threading of MLAS itself.
+    auto measure = [&](const MLAS_CONV_PARAMETERS& parameters, size_t working_buffer_size, const float* filter) {
+      std::vector<float> working_buffer(working_buffer_size);
+      double best = std::numeric_limits<double>::max();
+      for (int i = 0; i <= kTuningRuns; ++i) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        MlasConv(&parameters, X.data(), filter, nullptr, working_buffer.data(), Y.data(), nullptr);
+        const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        if (i > 0) {
+          best = std::min(best, elapsed.count());
+        }
+      }
+      return best;
+    };
+
+    const double winograd_time = measure(WinogradParameters, WinogradWorkingBufferSize,
+                                         static_cast<const float*>(winograd_filter_.get()));
+    const double expand_time = measure(ExpandParameters, ExpandWorkingBufferSize, W.Data<float>());
+    tuned_algorithm_ = winograd_time <= expand_time ? MlasConvAlgorithmWinograd : ExpandParameters.Algorithm;
+    cache->Insert(key.str(), static_cast<int>(tuned_algorithm_));
+  } else {
+    return;
+  }
+
+  is_algorithm_tuned_ = true;
+  tuned_input_dims_ = std::move(X_dims);
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
   concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
@@ -210,12 +398,37 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &WorkingBufferSize,
                     tp);
 
+    if (is_algorithm_tuned_ && Parameters.Algorithm != tuned_algorithm_ &&
+        X->Shape().GetDims() == tuned_input_dims_) {
+      MlasConvSelectAlgorithm(&Parameters, tuned_algorithm_, &WorkingBufferSize, tp);
+    }
+
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
 
+    // the Winograd algorithm consumes a transformed filter, which is only prepared here if W isn't constant
+    const float* filter_data = W->template Data<float>();
+    BufferUniquePtr transformed_filter;
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+      if (winograd_filter_) {
+        filter_data = static_cast<const float*>(winograd_filter_.get());
+      } else {
+        const size_t filter_size = MlasConvWinogradFilterSize(static_cast<size_t>(group_),
+                                                              static_cast<size_t>(M / group_),
+                                                              static_cast<size_t>(C / group_));
+        transformed_filter = BufferUniquePtr(alloc->Alloc(sizeof(float) * filter_size), BufferDeleter(alloc));
+        MlasConvWinogradTransformFilter(static_cast<size_t>(group_),
+                                        static_cast<size_t>(M / group_),
+                                        static_cast<size_t>(C / group_),
+                                        filter_data,
+                                        static_cast<float*>(transformed_filter.get()));
+        filter_data = static_cast<const float*>(transformed_filter.get());
+      }
+    }
+
     MlasConv(&Parameters,
              Xdata,
-             W->template Data<float>(),
+             filter_data,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata,
@@ -240,6 +453,10 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                             output_shape.GetDims().end());
 
     for (int image_id = 0; image_id < N; ++image_id) {
+      if (context->IsTerminated()) {
+        return OpKernelContext::TerminatedStatus();
+      }
+
       for (int group_id = 0; group_id < group_; ++group_id) {
         math::Im2colNd<float, CPUMathUtil, StorageOrder::NCHW>()(
             Xdata + group_id * X_offset,
@@ -22,12 +22,32 @@ class Conv<float> : public OpKernel, public ConvBase {
  public:
   Conv<float>(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    // a constant 3x3 filter is transformed once here for the Winograd algorithm
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W)) {
+      TransformWinogradFilter(info, *W);
+      TuneAlgorithm(info, *W);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
+
+ private:
+  void TransformWinogradFilter(const OpKernelInfo& info, const Tensor& W);
+
+  // chooses the faster of the MLAS algorithms for the static input shape of the node, using the kernel tuning
+  // cache of the execution provider, see KernelTuningCache.
+  void TuneAlgorithm(const OpKernelInfo& info, const Tensor& W);
+
+  BufferUniquePtr winograd_filter_;
+
+  // the algorithm used instead of the one MlasConvPrepare selects, if the input shape is tuned_input_dims_
+  bool is_algorithm_tuned_{false};
+  MLAS_CONV_ALGORITHM tuned_algorithm_{MlasConvAlgorithmExpandThenGemm};
+  std::vector<int64_t> tuned_input_dims_;
 };
 
 }  // namespace onnxruntime
@@ -128,19 +128,24 @@ class ConvBase {
   }
 
   Status ValidateInputShape(const Tensor* X, const Tensor* W) const {
-    const int64_t C = X->Shape()[1];
-    const int64_t M = W->Shape()[0];
+    return ValidateInputShape(X->Shape(), W->Shape());
+  }
+
+  // input_shape and weight_shape are in the NCHW layout
+  Status ValidateInputShape(const TensorShape& input_shape, const TensorShape& weight_shape) const {
+    const int64_t C = input_shape[1];
+    const int64_t M = weight_shape[0];
 
-    if (X->Shape().NumDimensions() != W->Shape().NumDimensions()) {
+    if (input_shape.NumDimensions() != weight_shape.NumDimensions()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "X num_dims does not match W num_dims.",
-                             " X: ", X->Shape().ToString().c_str(),
-                             " W: ", W->Shape().ToString().c_str());
+                             " X: ", input_shape.ToString().c_str(),
+                             " W: ", weight_shape.ToString().c_str());
     }
 
-    if (C != W->Shape()[1] * group_) {
+    if (C != weight_shape[1] * group_) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input channels C is not equal to kernel channels * group.",
                              " C: ", C,
-                             " kernel channels: ", W->Shape()[1],
+                             " kernel channels: ", weight_shape[1],
                              " group: ", group_);
     }
 
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/conv_integer.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
@@ -81,9 +84,18 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   const int64_t kernel_dim = C / group_ * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-  auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  // a 1x1 kernel with unit strides and no padding reads each image directly as its column buffer
+  const bool is_pointwise = kernel_size == 1 &&
+                            std::all_of(strides.begin(), strides.end(), [](int64_t s) { return s == 1; }) &&
+                            std::all_of(pads.begin(), pads.end(), [](int64_t p) { return p == 0; });
+
+  BufferUniquePtr col_buffer;
+  uint8_t* col_buffer_data = nullptr;
+  if (!is_pointwise) {
+    auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+    col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  }
 
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
@@ -92,21 +104,25 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
 
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
-      math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
-          Xdata + group_id * X_offset,
-          image_shape.GetDims().data(),
-          col_buffer_shape.data(),
-          C * input_image_size,
-          col_buffer_size,
-          kernel_shape.data(),
-          strides.data(),
-          dilations.data(),
-          pads.data(),
-          static_cast<int>(kernel_shape.size()),
-          col_buffer_data,
-          &CPUMathUtil::Instance(),
-          false,
-          input_offset);
+      const uint8_t* col_input = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance(),
+            false,
+            input_offset);
+        col_input = col_buffer_data;
+      }
 
       QGemmu8u8_s32(static_cast<int>(M / group_),
                     static_cast<int>(output_image_size),
@@ -114,7 +130,7 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
                     W->template Data<uint8_t>() + group_id * W_offset,
                     static_cast<int>(kernel_dim),
                     filter_offset,
-                    col_buffer_data,
+                    col_input,
                     static_cast<int>(output_image_size),
                     input_offset,
                     Ydata + group_id * Y_offset,
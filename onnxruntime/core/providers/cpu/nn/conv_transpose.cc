@@ -18,6 +18,7 @@
 #include "core/providers/cpu/nn/conv_transpose.h"
 #include "core/framework/op_kernel_context_internal.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -223,6 +224,200 @@ void ConvTransposeBase::ComputePadsAndOutputShape(
   output_shape->insert(output_shape->begin(), {N, output_channel, output_height, output_width});
 }
 
+namespace {
+
+// The outputs of a transposed convolution along one dimension whose position plus the head padding is congruent to
+// a phase modulo the stride only receive the filter taps phase, phase + stride, ..., so each phase is a stride 1
+// convolution of the input with those taps in reverse order. This describes such a convolution.
+struct SubPixelPhase {
+  int64_t first_output;
+  int64_t output_count;
+  int64_t tap_count;
+  int64_t pad_head;
+  int64_t pad_tail;
+};
+
+// Returns false if the phase starts reading the input past its head or stops before its tail, which the zero
+// padding of a convolution can't express.
+bool GetSubPixelPhase(int64_t input_size, int64_t output_size, int64_t kernel, int64_t stride, int64_t pad,
+                      int64_t phase, SubPixelPhase& result) {
+  result.first_output = ((phase - pad) % stride + stride) % stride;
+  result.output_count =
+      output_size > result.first_output ? (output_size - result.first_output + stride - 1) / stride : 0;
+  result.tap_count = kernel > phase ? (kernel - phase + stride - 1) / stride : 0;
+  result.pad_head = 0;
+  result.pad_tail = 0;
+  if (result.output_count == 0 || result.tap_count == 0) {
+    return true;
+  }
+
+  // the input the first tap of the phase reads for its first output
+  const int64_t first_input = (result.first_output + pad - phase) / stride;
+  result.pad_head = result.tap_count - 1 - first_input;
+  result.pad_tail = result.output_count + result.tap_count - 1 - input_size - result.pad_head;
+  return result.pad_head >= 0 && result.pad_tail >= 0;
+}
+
+}  // namespace
+
+bool ConvTransposeBase::TryComputeSubPixel(const Prepare& p, AllocatorPtr alloc, concurrency::ThreadPool* tp) const {
+  if (p.kernel_shape.size() != 2 || p.dilations[0] != 1 || p.dilations[1] != 1) {
+    return false;
+  }
+
+  const int64_t output_height = p.Y->Shape()[2];
+  const int64_t output_width = p.Y->Shape()[3];
+  const int64_t kernel_height = p.kernel_shape[0];
+  const int64_t kernel_width = p.kernel_shape[1];
+  const int64_t stride_height = p.strides[0];
+  const int64_t stride_width = p.strides[1];
+
+  std::vector<SubPixelPhase> height_phases(static_cast<size_t>(stride_height));
+  std::vector<SubPixelPhase> width_phases(static_cast<size_t>(stride_width));
+  for (int64_t phase = 0; phase < stride_height; ++phase) {
+    if (!GetSubPixelPhase(p.H, output_height, kernel_height, stride_height, p.pads[0], phase,
+                          height_phases[phase])) {
+      return false;
+    }
+  }
+  for (int64_t phase = 0; phase < stride_width; ++phase) {
+    if (!GetSubPixelPhase(p.W, output_width, kernel_width, stride_width, p.pads[1], phase, width_phases[phase])) {
+      return false;
+    }
+  }
+
+  const int64_t input_channels = p.num_input_channels / group_;
+  const int64_t output_channels = p.num_output_channels / group_;
+  const int64_t planes = p.N * p.num_output_channels;
+  const int64_t output_image_size = output_height * output_width;
+  const float* Xdata = p.X->Data<float>();
+  const float* filter_data = p.F->Data<float>();
+  const float* Bdata = p.B != nullptr ? p.B->Data<float>() : nullptr;
+  float* Ydata = p.Y->MutableData<float>();
+
+  // a unit stride has a single phase, which is written to the output in place
+  const bool single_phase = stride_height == 1 && stride_width == 1;
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  for (int64_t height_phase = 0; height_phase < stride_height; ++height_phase) {
+    for (int64_t width_phase = 0; width_phase < stride_width; ++width_phase) {
+      const SubPixelPhase& hp = height_phases[height_phase];
+      const SubPixelPhase& wp = width_phases[width_phase];
+      if (hp.output_count == 0 || wp.output_count == 0) {
+        continue;
+      }
+
+      // the phase outputs are written to a [N, M, output_count_h, output_count_w] buffer, then copied to the
+      // strided output positions of the phase
+      const int64_t phase_image_size = hp.output_count * wp.output_count;
+      BufferUniquePtr phase_buffer;
+      float* phase_output = Ydata;
+      if (!single_phase) {
+        phase_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * planes * phase_image_size), BufferDeleter(alloc));
+        phase_output = static_cast<float*>(phase_buffer.get());
+      }
+
+      if (hp.tap_count == 0 || wp.tap_count == 0) {
+        // no filter tap reaches the outputs of the phase
+        for (int64_t plane = 0; plane < planes; ++plane) {
+          const float bias = Bdata != nullptr ? Bdata[plane % p.num_output_channels] : 0.0f;
+          std::fill_n(phase_output + plane * phase_image_size, phase_image_size, bias);
+        }
+      } else {
+        // the taps of the phase, in reverse order and laid out as the [M, C/group, kH, kW] filter of a convolution
+        const int64_t taps = hp.tap_count * wp.tap_count;
+        BufferUniquePtr phase_filter_buffer(alloc->Alloc(sizeof(float) * p.num_output_channels * input_channels * taps),
+                                            BufferDeleter(alloc));
+        float* phase_filter = static_cast<float*>(phase_filter_buffer.get());
+        for (int64_t group_id = 0; group_id < group_; ++group_id) {
+          for (int64_t oc = 0; oc < output_channels; ++oc) {
+            for (int64_t ic = 0; ic < input_channels; ++ic) {
+              const float* filter = filter_data + ((group_id * input_channels + ic) * output_channels + oc) *
+                                                      kernel_height * kernel_width;
+              float* dest = phase_filter + ((group_id * output_channels + oc) * input_channels + ic) * taps;
+              for (int64_t th = 0; th < hp.tap_count; ++th) {
+                const int64_t kh = height_phase + stride_height * (hp.tap_count - 1 - th);
+                for (int64_t tw = 0; tw < wp.tap_count; ++tw) {
+                  const int64_t kw = width_phase + stride_width * (wp.tap_count - 1 - tw);
+                  *dest++ = filter[kh * kernel_width + kw];
+                }
+              }
+            }
+          }
+        }
+
+        const int64_t input_shape[] = {p.H, p.W};
+        const int64_t kernel_shape[] = {hp.tap_count, wp.tap_count};
+        const int64_t dilations[] = {1, 1};
+        const int64_t pads[] = {hp.pad_head, wp.pad_head, hp.pad_tail, wp.pad_tail};
+        const int64_t strides[] = {1, 1};
+        const int64_t output_shape[] = {hp.output_count, wp.output_count};
+
+        MLAS_CONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+        MlasConvPrepare(&Parameters,
+                        2,
+                        static_cast<size_t>(p.N),
+                        static_cast<size_t>(group_),
+                        static_cast<size_t>(input_channels),
+                        input_shape,
+                        kernel_shape,
+                        dilations,
+                        pads,
+                        strides,
+                        output_shape,
+                        static_cast<size_t>(output_channels),
+                        &activation,
+                        &WorkingBufferSize,
+                        tp);
+
+        auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
+        BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+
+        const float* conv_filter = phase_filter;
+        BufferUniquePtr transformed_filter;
+        if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+          const size_t filter_size = MlasConvWinogradFilterSize(static_cast<size_t>(group_),
+                                                                static_cast<size_t>(output_channels),
+                                                                static_cast<size_t>(input_channels));
+          transformed_filter = BufferUniquePtr(alloc->Alloc(sizeof(float) * filter_size), BufferDeleter(alloc));
+          MlasConvWinogradTransformFilter(static_cast<size_t>(group_),
+                                          static_cast<size_t>(output_channels),
+                                          static_cast<size_t>(input_channels),
+                                          phase_filter,
+                                          static_cast<float*>(transformed_filter.get()));
+          conv_filter = static_cast<const float*>(transformed_filter.get());
+        }
+
+        MlasConv(&Parameters,
+                 Xdata,
+                 conv_filter,
+                 Bdata,
+                 static_cast<float*>(working_buffer.get()),
+                 phase_output,
+                 tp);
+      }
+
+      if (!single_phase) {
+        for (int64_t plane = 0; plane < planes; ++plane) {
+          const float* source = phase_output + plane * phase_image_size;
+          float* dest = Ydata + plane * output_image_size + hp.first_output * output_width + wp.first_output;
+          for (int64_t h = 0; h < hp.output_count; ++h) {
+            float* row = dest + h * stride_height * output_width;
+            for (int64_t w = 0; w < wp.output_count; ++w) {
+              row[w * stride_width] = *source++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 template <typename T>
 Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
   return ConvTranspose<T>::DoConvTranspose(context, false);
@@ -238,6 +433,13 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   bool has_bias = dynamic_padding ? num_inputs == 4 : num_inputs == 3;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, has_bias, p, dynamic_padding));
 
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  if (std::is_same<T, float>::value && TryComputeSubPixel(p, alloc, tp)) {
+    return Status::OK();
+  }
+
   const int64_t input_image_size = p.H * p.W;
   const int64_t X_offset = p.num_input_channels / group_ * input_image_size;
   const int64_t Y_offset = p.Y->Shape().Size() / p.Y->Shape()[0] / group_;
@@ -245,9 +447,6 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   const int64_t kernel_dim = p.num_output_channels / group_ * p.kernel_shape[0] * p.kernel_shape[1];
   const int64_t output_image_size = p.Y->Shape()[2] * p.Y->Shape()[3];
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
   auto col_data = alloc->Alloc(sizeof(T) * kernel_dim * p.H * p.W);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   T* col_buffer_data = static_cast<T*>(col_buffer.get());
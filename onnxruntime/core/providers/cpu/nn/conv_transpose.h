@@ -52,6 +52,11 @@ class ConvTransposeBase : public ConvBase {
                                  const std::vector<int64_t>& dilations, const std::vector<int64_t>& output_padding,
                                  std::vector<int64_t>* pads, std::vector<int64_t>* output_shape) const;
 
+  // Computes a 2D float transposed convolution without dilations as stride_h * stride_w convolutions of the input
+  // with the filter taps of each output phase, instead of a GEMM into a column buffer and its scatter-add to the
+  // output. Returns false if the padding of the transposed convolution doesn't allow it.
+  bool TryComputeSubPixel(const Prepare& p, AllocatorPtr alloc, concurrency::ThreadPool* tp) const;
+
   const std::vector<int64_t> output_padding_;
   const std::vector<int64_t> output_shape_;
 };
@@ -3,11 +3,21 @@
 
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <cmath>
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+namespace {
+// the smallest number of elements worth handing to another thread
+constexpr int64_t kMinInstanceNormElementsPerTask = 16384;
+}  // namespace
+
 ONNX_CPU_OPERATOR_KERNEL(
     InstanceNormalization,
     6,
@@ -28,15 +38,54 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
+  const float* Xdata = input->Data<float>();
+  const float* scale_data = scale->Data<float>();
+  const float* B_data = B->Data<float>();
+  float* Ydata = Y->MutableData<float>();
+
+  // Each plane is read once for its mean and variance and once more to be normalized and activated, while
+  // it is still in the cache.
+  auto normalize_planes = [&](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) {
+      const float* Xi = Xdata + W * i;
+      float* Yi = Ydata + W * i;
+
+      // accumulated in double, so the difference of the squares keeps the variance of planes with a large mean
+      double sum = 0.0;
+      double sum_squares = 0.0;
+      for (int64_t j = 0; j < W; ++j) {
+        const double x = Xi[j];
+        sum += x;
+        sum_squares += x * x;
+      }
+      const double mean = sum / W;
+      const double variance = std::max(sum_squares / W - mean * mean, 0.0);
+
+      const float inv_stdev = 1.0f / std::sqrt(static_cast<float>(variance) + epsilon_);
+      const float channel_scale = inv_stdev * scale_data[i % C];
+      const float channel_shift = B_data[i % C] - static_cast<float>(mean) * channel_scale;
+      for (int64_t j = 0; j < W; ++j) {
+        Yi[j] = Xi[j] * channel_scale + channel_shift;
+      }
+      if (activation_.ActivationKind != MlasIdentityActivation) {
+        MlasActivation(&activation_, Yi, nullptr, 1, static_cast<size_t>(W), static_cast<size_t>(W));
+      }
+    }
+  };
+
+  const int64_t planes = N * C;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(planes, planes * W / kMinInstanceNormElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    normalize_planes(0, planes);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      normalize_planes(planes * task / num_tasks, planes * (task + 1) / num_tasks);
+    });
   }
 
   return Status::OK();
@@ -4,18 +4,24 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
 template <typename T>
-class InstanceNorm final : public OpKernel {
+class InstanceNorm : public OpKernel {
  public:
   InstanceNorm(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
     ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+    activation_.ActivationKind = MlasIdentityActivation;
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
 
+ protected:
+  // applied to the normalized output, see FusedInstanceNormalization
+  MLAS_ACTIVATION activation_;
+
  private:
   float epsilon_;
 };
@@ -101,7 +101,8 @@ class LpPool {
 class PoolBase {
  private:
   static bool IsGlobalPooling(const std::string& op_name) {
-    return op_name == "GlobalAveragePool" || op_name == "GlobalMaxPool" || op_name == "GlobalLpPool";
+    return op_name == "GlobalAveragePool" || op_name == "GlobalMaxPool" || op_name == "GlobalLpPool" ||
+           op_name == "NhwcGlobalAveragePool" || op_name == "NhwcGlobalMaxPool";
   }
 
  protected:
@@ -137,7 +138,7 @@ class PoolBase {
         default_dilations_ = std::all_of(dilations_.begin(), dilations_.end(), [](int64_t i) { return i == 1; });
       }
 
-      if (op_name_ == "AveragePool") {
+      if (op_name_ == "AveragePool" || op_name_ == "NhwcAveragePool") {
         int64_t temp;
         ORT_ENFORCE(info.GetAttr<int64_t>("count_include_pad", &temp).IsOK());
         count_include_pad_ = (temp != 0);
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 #include "core/providers/common.h"
 
 namespace onnxruntime {
@@ -29,8 +33,16 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_offset = context->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(input_offset),
               "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
+#ifdef USE_GEMMLOWP
   ORT_ENFORCE(IsScalarOr1ElementVector(filter_offset),
               "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
+#else
+  // the product of each output channel is corrected for its own filter zero point after the GEMM
+  ORT_ENFORCE(IsScalarOr1ElementVector(filter_offset) ||
+                  (filter_offset->Shape().NumDimensions() == 1 && filter_offset->Shape()[0] == W->Shape()[0]),
+              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1 or of the number of output "
+              "channels");
+#endif
   ORT_ENFORCE(IsScalarOr1ElementVector(result_offset),
               "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -40,19 +52,29 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_scale = context->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(input_scale),
               "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
+#ifdef USE_GEMMLOWP
   ORT_ENFORCE(IsScalarOr1ElementVector(filter_scale),
               "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
+#else
+  // MLAS requantizes each output channel separately, so the filter may be quantized per channel
+  ORT_ENFORCE(IsScalarOr1ElementVector(filter_scale) ||
+                  (filter_scale->Shape().NumDimensions() == 1 && filter_scale->Shape()[0] == W->Shape()[0]),
+              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1 or of the number of output channels");
+#endif
   ORT_ENFORCE(IsScalarOr1ElementVector(result_scale),
               "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
 
   auto input_scale_data = *(input_scale->template Data<float>());
-  auto filter_scale_data = *(filter_scale->template Data<float>());
   auto result_scale_data = *(result_scale->template Data<float>());
 
-  const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  const auto* filter_scale_data = filter_scale->template Data<float>();
+  const size_t num_filter_scales = static_cast<size_t>(filter_scale->Shape().Size());
+  std::vector<int32_t> integer_multipliers(num_filter_scales);
+  std::vector<int> right_shifts(num_filter_scales);
+  for (size_t i = 0; i < num_filter_scales; ++i) {
+    const float real_multiplier = (input_scale_data * filter_scale_data[i]) / result_scale_data;
+    QuantizeMultiplier(real_multiplier, &integer_multipliers[i], &right_shifts[i]);
+  }
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -104,9 +126,28 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   const int64_t col_buffer_size = kernel_dim * output_image_size;
   const int bias_offset = static_cast<int>(M / group_);
 
-  auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  // a 1x1 kernel with unit strides and no padding reads each image directly as its column buffer
+  const bool is_pointwise = kernel_size == 1 &&
+                            std::all_of(strides.begin(), strides.end(), [](int64_t s) { return s == 1; }) &&
+                            std::all_of(pads.begin(), pads.end(), [](int64_t p) { return p == 0; });
+
+  BufferUniquePtr col_buffer;
+  uint8_t* col_buffer_data = nullptr;
+  if (!is_pointwise) {
+    auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+    col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  }
+
+#ifndef USE_GEMMLOWP
+  const auto* filter_offset_data = filter_offset->template Data<uint8_t>();
+  const bool per_channel_filter_offset = filter_offset->Shape().Size() > 1;
+
+  // MLAS accumulates each group into int32 before the result is requantized to uint8
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * (M / group_) * output_image_size);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+#endif
 
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
@@ -115,24 +156,29 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
-      math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
-          Xdata + group_id * X_offset,
-          image_shape.GetDims().data(),
-          col_buffer_shape.data(),
-          C * input_image_size,
-          col_buffer_size,
-          kernel_shape.data(),
-          strides.data(),
-          dilations.data(),
-          pads.data(),
-          static_cast<int>(kernel_shape.size()),
-          col_buffer_data,
-          &CPUMathUtil::Instance(),
-          false,
-          *input_offset->template Data<uint8_t>());
-
+      const uint8_t* col_input = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance(),
+            false,
+            *input_offset->template Data<uint8_t>());
+        col_input = col_buffer_data;
+      }
+
+#ifdef USE_GEMMLOWP
       GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
+                              col_input,
                               Ydata + group_id * Y_offset,
                               *filter_offset->template Data<uint8_t>(),
                               *input_offset->template Data<uint8_t>(),
@@ -140,9 +186,58 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
                               static_cast<int>(M / group_),
                               static_cast<int>(output_image_size),
                               static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
+                              integer_multipliers[0],
+                              right_shifts[0],
                               bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+#else
+      QGemmu8u8_s32(static_cast<int>(M / group_),
+                    static_cast<int>(output_image_size),
+                    static_cast<int>(kernel_dim),
+                    W->template Data<uint8_t>() + group_id * W_offset,
+                    static_cast<int>(kernel_dim),
+                    per_channel_filter_offset ? uint8_t{0} : filter_offset_data[0],
+                    col_input,
+                    static_cast<int>(output_image_size),
+                    *input_offset->template Data<uint8_t>(),
+                    gemm_output,
+                    static_cast<int>(output_image_size),
+                    nullptr);
+      if (per_channel_filter_offset) {
+        QGemmApplyRowOffsets(static_cast<int>(M / group_),
+                             static_cast<int>(output_image_size),
+                             static_cast<int>(kernel_dim),
+                             filter_offset_data + group_id * (M / group_),
+                             col_input,
+                             static_cast<int>(output_image_size),
+                             *input_offset->template Data<uint8_t>(),
+                             gemm_output,
+                             static_cast<int>(output_image_size));
+      }
+
+      const int32_t* group_bias = bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset;
+      if (num_filter_scales == 1) {
+        QuantizeDownInt32ToUint8(gemm_output,
+                                 Ydata + group_id * Y_offset,
+                                 static_cast<int>(M / group_),
+                                 static_cast<int>(output_image_size),
+                                 group_bias,
+                                 *result_offset->template Data<uint8_t>(),
+                                 integer_multipliers[0],
+                                 right_shifts[0]);
+      } else {
+        for (int64_t m = 0; m < M / group_; ++m) {
+          const int64_t channel = group_id * (M / group_) + m;
+          QuantizeDownInt32ToUint8(gemm_output + m * output_image_size,
+                                   Ydata + group_id * Y_offset + m * output_image_size,
+                                   1,
+                                   static_cast<int>(output_image_size),
+                                   group_bias == nullptr ? nullptr : group_bias + m,
+                                   *result_offset->template Data<uint8_t>(),
+                                   integer_multipliers[channel],
+                                   right_shifts[channel]);
+        }
+      }
+#endif
     }
 
     Xdata += X_offset * group_;
@@ -4,15 +4,19 @@
 #include "string_normalizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <locale.h>
 #endif
 
+#include <algorithm>
 #include <codecvt>
 #include <locale>
 #include <functional>
+#include <memory>
 #include <unordered_set>
 
 namespace onnxruntime {
@@ -101,10 +105,39 @@ const std::string default_locale("en_US.UTF-8");
 
 #endif
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
+// std::wstring_convert keeps conversion state, so each task converts with its own
+using Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
+
+// smallest number of strings converted by a task
+constexpr size_t kMinStringsPerTask = 128;
+
+// Runs fn over ranges of [0, count) split across the operator thread pool
+// and returns the first error of the ranges
+Status ParallelForStrings(OpKernelContext* ctx, size_t count,
+                          const std::function<Status(size_t, size_t)>& fn) {
+  int64_t num_tasks = static_cast<int64_t>(count / kMinStringsPerTask);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    return fn(0, count);
+  }
+
+  std::vector<Status> statuses(static_cast<size_t>(num_tasks));
+  tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+    statuses[task] = fn(count * task / num_tasks, count * (task + 1) / num_tasks);
+  });
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+template <class RandomAccessIter>
+Status CopyCaseAction(RandomAccessIter first, RandomAccessIter end, OpKernelContext* ctx,
                       const Locale& loc,
-                      std::wstring_convert<std::codecvt_utf8<wchar_t>>& converter,
                       size_t N, size_t C,
                       StringNormalizer::CaseAction caseaction) {
   std::vector<int64_t> output_dims;
@@ -127,10 +160,21 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
+  assert(static_cast<size_t>(end - first) == C);
+  (void)end;
+  if (caseaction == StringNormalizer::NONE) {
+    for (size_t output_idx = 0; output_idx < C; ++output_idx) {
+      // Simple copy or move if the iterator points to a non-const string
+      *(output_data + output_idx) = std::move(first[output_idx]);
+    }
+    return Status::OK();
+  }
+
+  // Each string is converted on its own, so the strings are split across the tasks
+  return ParallelForStrings(ctx, C, [&](size_t first_idx, size_t last_idx) -> Status {
+    Converter converter(conv_error, wconv_error);
+    for (size_t output_idx = first_idx; output_idx < last_idx; ++output_idx) {
+      auto& s = first[output_idx];
       std::wstring wstr = converter.from_bytes(s);
       if (wstr == wconv_error) {
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
@@ -139,15 +183,9 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
       // In place transform
       loc.ChangeCase(caseaction, wstr);
       *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
     }
-    ++output_idx;
-    ++first;
-  }
-  return Status::OK();
+    return Status::OK();
+  });
 }
 }  // namespace string_normalizer
 
@@ -229,7 +267,6 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
 
   Status status;
   Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
   auto const input_data = X->template Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
   if (is_case_sensitive_) {
@@ -245,50 +282,62 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         }
         ++first;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
+      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale,
                               N, filtered_strings.size(), case_change_action_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, N, C, case_change_action_);
     }
   } else {
     if (!wstopwords_.empty()) {
       // Filter input. When no case action is required
       // we simply store original string references.
       // Otherwise, we store converted strings.
+      // The strings are converted in parallel, then filtered in order.
+      std::unique_ptr<bool[]> is_stopword(new bool[C]);
+      std::vector<std::string> cased_strings(case_change_action_ == NONE ? 0 : C);
+      status = ParallelForStrings(ctx, C, [&](size_t first_idx, size_t last_idx) -> Status {
+        Converter converter(conv_error, wconv_error);
+        for (size_t idx = first_idx; idx < last_idx; ++idx) {
+          const std::string& s = input_data[idx];
+          std::wstring wstr = converter.from_bytes(s);
+          if (wstr == wconv_error) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Input contains invalid utf8 chars at: " + s);
+          }
+          locale.ChangeCase(compare_caseaction_, wstr);
+          is_stopword[idx] = wstopwords_.count(wstr) != 0;
+          if (!is_stopword[idx] && case_change_action_ != NONE) {
+            cased_strings[idx] = converter.to_bytes(wstr);
+          }
+        }
+        return Status::OK();
+      });
+      ORT_RETURN_IF_ERROR(status);
+
       std::vector<StrRef> filtered_orignal_strings;
       std::vector<std::string> filtered_cased_strings;
       filtered_orignal_strings.reserve(C);
       filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
+      for (size_t idx = 0; idx < C; ++idx) {
+        if (!is_stopword[idx]) {
           if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
+            filtered_orignal_strings.push_back(std::cref(input_data[idx]));
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            filtered_cased_strings.push_back(std::move(cased_strings[idx]));
           }
         }
-        ++first;
       }
       if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
+        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale,
                                 N, filtered_orignal_strings.size(), NONE);
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
+        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale,
                                 N, filtered_cased_strings.size(), NONE);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, N, C, case_change_action_);
     }
   }
   return status;
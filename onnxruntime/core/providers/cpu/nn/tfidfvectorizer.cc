@@ -4,12 +4,14 @@
 #include "tfidfvectorizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
-#include <unordered_set>
-#include <ostream>
-#include <iterator>
+#include <limits>
+#include <unordered_map>
 
 namespace onnxruntime {
 
@@ -42,147 +44,99 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 
 namespace ngram_details {
 
-class NgramEntryBase {
-  size_t id_;  // Id in the pool
- protected:
-  NgramEntryBase(size_t id) : id_(id) {}
-  ~NgramEntryBase() = default;
-
- public:
-  size_t Id() const { return id_; }
+// The type of the items of the pool an input is looked up in,
+// int32 inputs are looked up in the pool_int64s n-grams
+template <typename T>
+struct PoolItem {
+  using type = int64_t;
 };
 
-template <class T>
-class NgramEntry;
-
 template <>
-class NgramEntry<int64_t> : public NgramEntryBase {
-  std::vector<int64_t> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf{};
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
-
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(*first);
-      ++first;
-    }
-    assert(!items_.empty());
-  }
-  // For sampling
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(int64_t v) {
-    items_.push_back(v);
-    RunningHash(v);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
-  bool operator==(const NgramEntry& o) const {
-    return items_ == o.items_;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
+struct PoolItem<std::string> {
+  using type = std::string;
 };
 
-template <>
-class NgramEntry<int32_t> : public NgramEntry<int64_t> {
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntry<int64_t>(id, first, last) {}
-  explicit NgramEntry() = default;
-};
+// Marks a trie node that no n-gram ends at, or an item that continues no n-gram
+constexpr size_t kNoNgram = std::numeric_limits<size_t>::max();
 
-template <>
-class NgramEntry<std::string> : public NgramEntryBase {
- private:
-  std::vector<std::reference_wrapper<const std::string>> items_;
-  size_t hash_ = 0;
+// A trie of the n-grams of the pool built once by the kernel. Each node maps the items
+// that continue its n-gram to their nodes, so matching the n-grams that start at a position
+// takes a single lookup per item, and stops at the first item that continues no n-gram
+// of the pool instead of hashing and comparing every longer n-gram.
+template <typename Item>
+class NgramTrie {
+ public:
+  static constexpr size_t kRoot = 0;
 
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf{};
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
+  NgramTrie() : nodes_(1) {}
 
- public:
+  // Adds the n-gram of the items [first, first + ngram_size) as id.
+  // Returns false if the n-gram is already in the trie.
   template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(std::cref(*first));
-      ++first;
+  bool Insert(ForwardIter first, size_t ngram_size, size_t id) {
+    size_t node = kRoot;
+    for (size_t i = 0; i < ngram_size; ++i, ++first) {
+      auto hit = nodes_[node].children.find(*first);
+      if (hit != nodes_[node].children.end()) {
+        node = hit->second;
+      } else {
+        const size_t child = nodes_.size();
+        nodes_[node].children.emplace(*first, child);
+        nodes_.emplace_back();
+        node = child;
+      }
     }
-    assert(!items_.empty());
-  }
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(const std::string& s) {
-    items_.push_back(std::cref(s));
-    RunningHash(s);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
+    if (nodes_[node].id != kNoNgram) {
+      return false;
+    }
+    nodes_[node].id = id;
+    return true;
   }
 
-  bool operator==(const NgramEntry& o) const {
-    if (items_.size() == o.items_.size()) {
-      return std::equal(items_.cbegin(), items_.cend(),
-                        o.items_.cbegin(), o.items_.cend(),
-                        std::equal_to<std::string>());
+  // The node of the n-gram of node followed by item, or kNoNgram
+  size_t Next(size_t node, const Item& item) const {
+    const auto& children = nodes_[node].children;
+    auto hit = children.find(item);
+    if (hit == children.end()) {
+      return kNoNgram;
     }
-    return false;
+    return hit->second;
   }
-  size_t Hash() const {
-    return hash_;
+
+  // The id of the n-gram of node, or kNoNgram if it only starts n-grams of the pool
+  size_t Id(size_t node) const {
+    return nodes_[node].id;
   }
-};
 
-using IntegerPoolSet = std::unordered_set<NgramEntry<int64_t>>;
-// Does not own strings, contains references to them. This helps
-// to search by string references that point to the current input.
-using StringPoolSet = std::unordered_set<NgramEntry<std::string>>;
+ private:
+  struct Node {
+    std::unordered_map<Item, size_t> children;
+    size_t id = kNoNgram;
+  };
+  std::vector<Node> nodes_;
+};
 
-template <typename ForwardIter, typename Cont>
-inline void Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Cont& c) {
+// Adds ngrams n-grams of ngram_size items starting at first to the trie.
+// Returns false if any of them was already there.
+template <typename ForwardIter, typename Trie>
+inline bool Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Trie& trie) {
+  bool unique = true;
   for (; ngrams > 0; --ngrams) {
-    c.emplace(ngram_id, first, first + ngram_size);
+    unique = trie.Insert(first, ngram_size, ngram_id) && unique;
     first += ngram_size;
     ++ngram_id;
   }
+  return unique;
 }
 
+// smallest number of input items counted by a task
+constexpr size_t kMinItemsPerTask = 4096;
+
 }  // namespace ngram_details
 }  // namespace onnxruntime
 
 using namespace onnxruntime::ngram_details;
 
-namespace std {
-template <typename T>
-struct hash<NgramEntry<T>> {
-  typedef NgramEntry<T> argument_type;
-  typedef size_t result_type;
-  result_type operator()(const argument_type& a) const {
-    return a.Hash();
-  }
-};
-}  // namespace std
-
 namespace onnxruntime {
 
 // The weighting criteria.
@@ -219,12 +173,10 @@ struct TfIdfVectorizer::Impl {
   std::vector<int64_t> ngram_indexes_;
   std::vector<float> weights_;
 
-  std::vector<std::string> pool_strings_;
-  // This set contains references to pool_string_ entries
-  // of pool_strings attribute
-  StringPoolSet str_set_;
-  // This set contains pool_int64s entries
-  IntegerPoolSet int64_set_;
+  // The n-grams of pool_strings attribute
+  NgramTrie<std::string> str_trie_;
+  // The n-grams of pool_int64s attribute
+  NgramTrie<int64_t> int64_trie_;
   size_t output_size_ = 0;
 
   Impl() = default;
@@ -233,10 +185,7 @@ struct TfIdfVectorizer::Impl {
   Impl& operator=(const Impl&) = delete;
 
   template <typename T>
-  auto PoolEnd() const;
-
-  template <typename T>
-  auto PoolFind(const ngram_details::NgramEntry<T>&) const;
+  const NgramTrie<typename PoolItem<T>::type>& Pool() const;
 
   void IncrementCount(size_t ngram_id, size_t row_num,
                       std::vector<uint32_t>& frequencies) const {
@@ -248,33 +197,18 @@ struct TfIdfVectorizer::Impl {
 };
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int64_t>() const {
-  return int64_set_.cend();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int32_t>() const {
-  return PoolEnd<int64_t>();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<std::string>() const {
-  return str_set_.cend();
+inline const NgramTrie<int64_t>& TfIdfVectorizer::Impl::Pool<int64_t>() const {
+  return int64_trie_;
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int64_t>(const NgramEntry<int64_t>& i) const {
-  return int64_set_.find(i);
+inline const NgramTrie<int64_t>& TfIdfVectorizer::Impl::Pool<int32_t>() const {
+  return int64_trie_;
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int32_t>(const NgramEntry<int32_t>& i) const {
-  return int64_set_.find(i);
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<std::string>(const NgramEntry<std::string>& i) const {
-  return str_set_.find(i);
+inline const NgramTrie<std::string>& TfIdfVectorizer::Impl::Pool<std::string>() const {
+  return str_trie_;
 }
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(new Impl) {
@@ -334,16 +268,17 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
   }
 
   std::vector<int64_t> pool_int64s;
-  status = info.GetAttrs("pool_strings", impl_->pool_strings_);
+  std::vector<std::string> pool_strings;
+  status = info.GetAttrs("pool_strings", pool_strings);
   if (status.IsOK()) {
-    ORT_ENFORCE(!impl_->pool_strings_.empty(), "pool_strings must not be empty if specified");
+    ORT_ENFORCE(!pool_strings.empty(), "pool_strings must not be empty if specified");
   } else {
     status = info.GetAttrs("pool_int64s", pool_int64s);
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (impl_->pool_strings_.empty()) ? pool_int64s.size() : impl_->pool_strings_.size();
+  const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
   size_t ngram_id = 0;
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = impl_->min_gram_length_;
@@ -359,16 +294,14 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the trie ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (impl_->pool_strings_.empty()) {
-          auto before_insert = impl_->int64_set_.size();
-          Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->int64_set_.size(), "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
+        if (pool_strings.empty()) {
+          bool unique = Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_trie_);
+          ORT_ENFORCE(unique, "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
         } else {
-          auto before_insert = impl_->str_set_.size();
-          Emplace(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->str_set_.size(), "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
+          bool unique = Emplace(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_trie_);
+          ORT_ENFORCE(unique, "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
         }
       } else {
         ngram_id += ngrams;
@@ -435,7 +368,7 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
 template <typename T>
 Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   const auto& impl = *impl_;
-  auto const set_end = impl.PoolEnd<T>();
+  const auto& pool = impl.Pool<T>();
 
   auto X = ctx->Input<Tensor>(0);
   auto& input_shape = X->Shape();
@@ -484,79 +417,97 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
 
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+  const auto min_gram_length = impl.min_gram_length_;
   auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
-
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
+
+  // Each row counts its n-grams into its own range of frequencies
+  auto compute_rows = [&](size_t first_row, size_t last_row) {
+    auto start_ngram_size = min_gram_length;
+    auto const rows_data = input_data + first_row * C;
+    auto const end_data = input_data + last_row * C;
+
+    // Treat 1-grams in a special way
+    if (start_ngram_size == 1) {
+      size_t row_num = first_row;
+      auto ngram_start = rows_data;
+      while (ngram_start < end_data) {
+        auto const ngram_row_end = ngram_start + C;
+        while (ngram_start < ngram_row_end) {
+          auto node = pool.Next(pool.kRoot, *ngram_start);
+          if (node != kNoNgram && pool.Id(node) != kNoNgram) {
+            // record frequency
+            impl.IncrementCount(pool.Id(node), row_num, frequencies);
+          }
+          ++ngram_start;
         }
-        ++ngram_start;
+        ++row_num;
+        ngram_start = ngram_row_end;
+      }
+      if (++start_ngram_size > max_gram_length) {
+        return;
       }
-      ++row_num;
-      ngram_start = ngram_row_end;
-    }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
     }
-  }
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
-          break;
-        }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
-          // Do not test anything before start_ngram_size
-          if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
+    for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+      auto ngram_start = rows_data;
+      size_t row_num = first_row;
+      while (ngram_start < end_data) {
+        assert((B == 0) || (row_num < B));
+        auto const ngram_row_end = ngram_start + C;
+        assert(ngram_row_end <= end_data);
+        while (ngram_start < ngram_row_end) {
+          // Check if any n-gram size in [start_ngram_size..max_gram_length] range
+          // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
+          // At least items of start_ngram_size should fit
+          // last row should match end_data
+          auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
+          if (at_least_this >= ngram_row_end) {
+            break;
+          }
+          // Walk down the trie, which ends the n-gram as soon as no n-gram of the pool continues it
+          auto node = pool.kRoot;
+          auto ngram_item = ngram_start;
+          for (auto ngram_size = 1;
+               ngram_size <= max_gram_length &&
+               ngram_item < ngram_row_end;
+               ++ngram_size, ngram_item += skip_distance) {
+            node = pool.Next(node, *ngram_item);
+            if (node == kNoNgram) {
+              break;
+            }
+
+            // Do not test anything before start_ngram_size
+            if (ngram_size >= start_ngram_size && pool.Id(node) != kNoNgram) {
               // record frequency
-              auto ngram_id = hit->Id();
-              impl.IncrementCount(ngram_id, row_num, frequencies);
+              impl.IncrementCount(pool.Id(node), row_num, frequencies);
             }
           }
+          // Sliding window shift
+          ++ngram_start;
         }
-        // Sliding window shift
-        ++ngram_start;
+        // Next row
+        ngram_start = ngram_row_end;
+        ++row_num;
       }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
     }
+  };
+
+  // The rows are split across the operator thread pool, with enough items per task to amortize the dispatch
+  int64_t num_tasks = static_cast<int64_t>(total_items / kMinItemsPerTask);
+  num_tasks = std::min(num_tasks, static_cast<int64_t>(b_dim));
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
   }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_rows(0, b_dim);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      compute_rows(b_dim * task / num_tasks, b_dim * (task + 1) / num_tasks);
+    });
+  }
+
   OutputResult(ctx, B, frequencies);
   return Status::OK();
 }
@@ -13,7 +13,8 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -50,6 +51,92 @@ Status GetThresholdsFromInputs(const PrepareContext& pc,
 }
 }  // namespace nms_helpers
 
+namespace {
+
+// smallest number of boxes scored by a task
+constexpr int64_t kMinNmsBoxesPerTask = 1024;
+
+struct ScoreIndexPair {
+  float score_{};
+  int64_t index_{};
+
+  ScoreIndexPair() = default;
+  explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+
+  // orders by descending score, then ascending index
+  bool operator<(const ScoreIndexPair& rhs) const {
+    return score_ > rhs.score_ || (score_ == rhs.score_ && index_ < rhs.index_);
+  }
+};
+
+// Corners and areas of boxes stored as separate arrays, so the IOU of one box against many others is
+// computed with a loop the compiler can vectorize. The results match SuppressByIOU.
+struct BoxCorners {
+  explicit BoxCorners(int64_t count) : x_min(count), y_min(count), x_max(count), y_max(count), area(count) {}
+
+  void Set(int64_t i, const float* box, int64_t center_point_box) {
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min[i], x_max[i]);
+      MaxMin(box[0], box[2], y_min[i], y_max[i]);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[i] = box[0] - width_half;
+      x_max[i] = box[0] + width_half;
+      y_min[i] = box[1] - height_half;
+      y_max[i] = box[1] + height_half;
+    }
+    area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+  }
+
+  void Clear() {
+    x_min.clear();
+    y_min.clear();
+    x_max.clear();
+    y_max.clear();
+    area.clear();
+  }
+
+  void Append(const BoxCorners& boxes, int64_t i) {
+    x_min.push_back(boxes.x_min[i]);
+    y_min.push_back(boxes.y_min[i]);
+    x_max.push_back(boxes.x_max[i]);
+    y_max.push_back(boxes.y_max[i]);
+    area.push_back(boxes.area[i]);
+  }
+
+  // Returns true if the IOU of box i of boxes with any of these boxes exceeds iou_threshold.
+  bool SuppressesBox(const BoxCorners& boxes, int64_t i, float iou_threshold) const {
+    const float box_x_min = boxes.x_min[i];
+    const float box_y_min = boxes.y_min[i];
+    const float box_x_max = boxes.x_max[i];
+    const float box_y_max = boxes.y_max[i];
+    const float box_area = boxes.area[i];
+    const size_t count = area.size();
+
+    bool suppressed = false;
+    for (size_t j = 0; j < count; ++j) {
+      const float intersection_width = std::min(box_x_max, x_max[j]) - std::max(box_x_min, x_min[j]);
+      const float intersection_height = std::min(box_y_max, y_max[j]) - std::max(box_y_min, y_min[j]);
+      const float intersection_area = std::max(intersection_width, .0f) * std::max(intersection_height, .0f);
+      const float union_area = box_area + area[j] - intersection_area;
+      suppressed |= (intersection_area > .0f) & (box_area > .0f) & (area[j] > .0f) & (union_area > .0f) &
+                    (intersection_area / union_area > iou_threshold);
+    }
+    return suppressed;
+  }
+
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+};
+
+}  // namespace
+
 Status NonMaxSuppressionBase::PrepareCompute(OpKernelContext* ctx, PrepareContext& pc) {
   const auto* boxes_tensor = ctx->Input<Tensor>(0);
   ORT_ENFORCE(boxes_tensor);
@@ -122,69 +209,74 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
+  const auto center_point_box = GetCenterPointBox();
 
-  struct ScoreIndexPair {
-    float score_{};
-    int64_t index_{};
+  // The corners and areas of the boxes of every batch, computed once and shared by all the classes.
+  const int64_t total_boxes = pc.num_batches_ * pc.num_boxes_;
+  BoxCorners corners(total_boxes);
+  for (int64_t i = 0; i < total_boxes; ++i) {
+    corners.Set(i, boxes_data + 4 * i, center_point_box);
+  }
 
-    ScoreIndexPair() = default;
-    explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+  // Each (batch, class) pair is suppressed independently into its own list, and the lists are
+  // concatenated in order afterwards so the output doesn't depend on the number of threads.
+  const int64_t num_pairs = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<SelectedIndex>> pair_selected_indices(num_pairs);
+  auto suppress_pairs = [&](int64_t first_pair, int64_t last_pair) {
+    std::vector<ScoreIndexPair> candidates;
+    BoxCorners selected_corners(0);
+    for (int64_t pair = first_pair; pair < last_pair; ++pair) {
+      const int64_t batch_index = pair / pc.num_classes_;
+      const int64_t class_index = pair % pc.num_classes_;
+      const int64_t box_offset = batch_index * pc.num_boxes_;
+      const auto* class_scores = scores_data + pair * pc.num_boxes_;
+
+      // Filter by score_threshold_ and sort by descending score, with ties ordered by index.
+      candidates.clear();
+      for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+        if (pc.score_threshold_ == nullptr || class_scores[box_index] > score_threshold) {
+          candidates.emplace_back(class_scores[box_index], box_index);
+        }
+      }
+      std::sort(candidates.begin(), candidates.end());
+
+      // Select the boxes in order of score, suppressing any whose IOU (Intersection Over Union) with a
+      // box already selected for this class exceeds the threshold.
+      auto& selected_indices = pair_selected_indices[pair];
+      selected_corners.Clear();
+      for (const auto& candidate : candidates) {
+        if (max_output_boxes_per_class > 0 &&
+            static_cast<int64_t>(selected_indices.size()) >= max_output_boxes_per_class) {
+          break;
+        }
 
-    bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
+        const int64_t box = box_offset + candidate.index_;
+        if (!selected_corners.SuppressesBox(corners, box, iou_threshold)) {
+          selected_corners.Append(corners, box);
+          selected_indices.emplace_back(batch_index, class_index, candidate.index_);
+        }
+      }
     }
   };
 
-  const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
-      // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
-          }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
-        }
-      }
+  auto* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(num_pairs, num_pairs * pc.num_boxes_ / kMinNmsBoxesPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
 
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
-            break;
-          }
-        }
+  if (tp == nullptr || num_tasks <= 1) {
+    suppress_pairs(0, num_pairs);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      suppress_pairs(num_pairs * task / num_tasks, num_pairs * (task + 1) / num_tasks);
+    });
+  }
 
-        if (selected) {
-          if (max_output_boxes_per_class > 0 &&
-              static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
-            break;
-          }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+  std::vector<SelectedIndex> selected_indices;
+  for (const auto& pair_indices : pair_selected_indices) {
+    selected_indices.insert(selected_indices.end(), pair_indices.begin(), pair_indices.end());
+  }
 
   const auto last_dim = 3;
   const auto num_selected = selected_indices.size();
@@ -154,6 +154,9 @@ void pre_calc_for_bilinear_interpolate(
   }
 }
 
+// smallest number of pooled output elements computed by a task
+constexpr int64_t kMinRoiAlignElementsPerTask = 4096;
+
 template <typename T>
 void RoiAlignForward(
     int64_t nthreads,
@@ -173,7 +176,7 @@ void RoiAlignForward(
     const ThreadPool* ttp) {
   int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
 
-  std::function<void(int32_t)> work_object = [&](int32_t n) {
+  auto compute_roi = [&](int64_t n) {
     int64_t index_n = n * channels * pooled_width * pooled_height;
 
     const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
@@ -270,7 +273,27 @@ void RoiAlignForward(
       }    // for ph
     }      // for c
   };       // for n
-  if (ttp != nullptr) const_cast<ThreadPool*>(ttp)->ParallelFor(static_cast<int32_t>(n_rois), work_object);
+
+  // Hand each task a contiguous range of ROIs rather than one ROI at a time, so small
+  // pooled outputs don't pay a scheduling round trip per ROI.
+  auto* tp = const_cast<ThreadPool*>(ttp);
+  int64_t num_tasks = std::min(n_rois, nthreads / kMinRoiAlignElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    for (int64_t n = 0; n < n_rois; n++) {
+      compute_roi(n);
+    }
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      const int64_t last = n_rois * (task + 1) / num_tasks;
+      for (int64_t n = n_rois * task / num_tasks; n < last; n++) {
+        compute_roi(n);
+      }
+    });
+  }
 }
 }  // namespace
 
@@ -75,25 +75,8 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMax, 11);
 REGISTER_UNARY_ELEMENTWISE_VERSIONED_KERNEL(ArgMin, 1, 10);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ArgMin, 11);
 
-// When all reduce axises located at the tail of the dims, quite general cases, transpose and extra
-// copy could be skiped to improve performance, if required by check_no_transpose = true;
-// return value: true means transposedInputData is not created/copied, input tensor data could
-//               be direct use as row major matrix [block_size, blocks], where blocks is the
-//               size of each reduce.
-template <typename T>
-bool PrepareForReduce(OpKernelContext* ctx,
-                      std::vector<T>& transposedInputData,
-                      Tensor** reducedTensor,
-                      int64_t& block_size,
-                      int64_t& blocks,
-                      const std::vector<int64_t>& axes_,
-                      bool keepdims_,
-                      bool check_no_transpose = false) {
-  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
-  ORT_ENFORCE(input_tensor_ptr != nullptr);
-  const Tensor& input = *input_tensor_ptr;
-
-  size_t ndim = input.Shape().GetDims().size();
+// Returns the sorted, non-negative axes to reduce.
+static std::vector<int64_t> GetReduceAxes(size_t ndim, const std::vector<int64_t>& axes_) {
   std::vector<int64_t> axes;
   axes.reserve(axes_.size());
   for (int64_t axis : axes_) {
@@ -107,12 +90,40 @@ bool PrepareForReduce(OpKernelContext* ctx,
   }
 
   std::sort(axes.begin(), axes.end());
+  return axes;
+}
 
-  // If all reduced axes are located at the tail of the input shape, then copy could be skipped is required
-  bool need_copy = true;
-  if (axes.size() <= ndim && axes.front() == static_cast<int64_t>(ndim - axes.size()) && axes.back() == static_cast<int64_t>(ndim) - 1) {
-    need_copy = false;
+static std::vector<int64_t> GetReducedDims(const std::vector<int64_t>& in_dims,
+                                           const vector<bool>& keep_axis,
+                                           bool keepdims_) {
+  std::vector<int64_t> reduced_dims;
+  for (size_t i = 0; i < in_dims.size(); i++) {
+    if (keep_axis[i]) {
+      reduced_dims.push_back(in_dims[i]);
+    } else if (keepdims_) {
+      reduced_dims.push_back(1);
+    }
   }
+  return reduced_dims;
+}
+
+// Transposes the input so that all to-be-reduced axes are at the head. transposedInputData can then be used
+// as a column major matrix [block_size, blocks], where blocks is the size of each reduce.
+// Reductions whose reduced axes are adjacent read the input in place with FastReduce instead.
+template <typename T>
+void PrepareForReduce(OpKernelContext* ctx,
+                      std::vector<T>& transposedInputData,
+                      Tensor** reducedTensor,
+                      int64_t& block_size,
+                      int64_t& blocks,
+                      const std::vector<int64_t>& axes_,
+                      bool keepdims_) {
+  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
+
+  size_t ndim = input.Shape().GetDims().size();
+  std::vector<int64_t> axes = GetReduceAxes(ndim, axes_);
 
   vector<bool> keep_axis(ndim, true);
   for (auto i : axes) {
@@ -151,32 +162,20 @@ bool PrepareForReduce(OpKernelContext* ctx,
   size_t count = input.Shape().Size();
 
   //set to-be-reduced axes to one. squeeze is keepdims_ is false
-  int64_t first_dim = 1;
-  std::vector<int64_t> reduced_dims;
-  for (size_t i = 0; i < in_dims.size(); i++) {
-    if (keep_axis[i]) {
-      reduced_dims.push_back(in_dims[i]);
-    } else {
-      first_dim *= in_dims[i];
-      if (keepdims_) {
-        reduced_dims.push_back(1);
-      }
+  *reducedTensor = ctx->Output(0, GetReducedDims(in_dims, keep_axis, keepdims_));
+  blocks = 1;
+  for (size_t i = 0; i < ndim; i++) {
+    if (!keep_axis[i]) {
+      blocks *= in_dims[i];
     }
   }
-
-  *reducedTensor = ctx->Output(0, reduced_dims);
-  block_size = input.Shape().Size() / first_dim;
-  blocks = first_dim;
-
-  if (!need_copy && check_no_transpose) {
-    return true;
-  }
+  block_size = input.Shape().Size() / blocks;
 
   transposedInputData.resize(input.Shape().Size(), 0);
   T* to_data = &transposedInputData[0];
   if (num_axes < 2 || n_shared_idxs == num_axes) {
     memcpy(to_data, from_data, count * sizeof(T));
-    return false;
+    return;
   }
 
   int itr_axes = num_axes - n_shared_idxs;
@@ -235,11 +234,314 @@ bool PrepareForReduce(OpKernelContext* ctx,
       }
     }
   }
-  return false;
 }
 
+// Reductions whose reduced axes are adjacent, once the axes of size 1 are ignored, view the input in place as
+// a row major [outer, reduced, inner] tensor and the output as [outer, inner]. This covers reducing the tail
+// axes (inner == 1, each output is the reduction of a contiguous vector), the head axes (outer == 1) and a
+// single axis, so there is no transpose copy, and the outputs are split across the threads of the pool.
+struct FastReduceShape {
+  int64_t outer;
+  int64_t reduced;
+  int64_t inner;
+};
+
+// smallest number of input elements reduced by a task
+constexpr int64_t kMinReduceElementsPerTask = 16384;
+
+// Returns false without allocating the output if the reduced axes aren't adjacent or the input is empty.
+static bool PrepareForFastReduce(OpKernelContext* ctx,
+                                 Tensor** reducedTensor,
+                                 FastReduceShape& shape,
+                                 const std::vector<int64_t>& axes_,
+                                 bool keepdims_) {
+  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
+
+  const std::vector<int64_t>& in_dims = input.Shape().GetDims();
+  size_t ndim = in_dims.size();
+  if (input.Shape().Size() == 0) {
+    return false;
+  }
+
+  vector<bool> keep_axis(ndim, true);
+  for (auto i : GetReduceAxes(ndim, axes_)) {
+    keep_axis[i] = false;
+  }
+
+  shape.outer = 1;
+  shape.reduced = 1;
+  shape.inner = 1;
+  bool seen_reduced = false;
+  for (size_t i = 0; i < ndim; i++) {
+    if (in_dims[i] == 1) {
+      continue;
+    }
+    if (!keep_axis[i]) {
+      if (shape.inner != 1) {
+        return false;  // a kept axis separates two reduced axes
+      }
+      seen_reduced = true;
+      shape.reduced *= in_dims[i];
+    } else if (seen_reduced) {
+      shape.inner *= in_dims[i];
+    } else {
+      shape.outer *= in_dims[i];
+    }
+  }
+
+  *reducedTensor = ctx->Output(0, GetReducedDims(in_dims, keep_axis, keepdims_));
+  return true;
+}
+
+// Aggregator::Contiguous(data, size) reduces a contiguous vector. Aggregator::Strided(data, reduced, stride,
+// size, out) reduces the columns [0, size) of a [reduced, stride] row major block into out.
+template <typename T, typename TOut, typename Aggregator>
+bool FastReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes_, bool keepdims_) {
+  FastReduceShape shape;
+  Tensor* reduced;
+  if (!PrepareForFastReduce(ctx, &reduced, shape, axes_, keepdims_)) {
+    return false;
+  }
+
+  const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+  TOut* output_data = reduced->template MutableData<TOut>();
+  const int64_t num_outputs = shape.outer * shape.inner;
+
+  // reduces the outputs [first, last)
+  auto reduce_range = [&shape, input_data, output_data](int64_t first, int64_t last) {
+    if (shape.inner == 1) {
+      for (int64_t i = first; i < last; ++i) {
+        output_data[i] = Aggregator::Contiguous(input_data + i * shape.reduced, shape.reduced);
+      }
+      return;
+    }
+    while (first < last) {
+      const int64_t outer = first / shape.inner;
+      const int64_t column = first - outer * shape.inner;
+      const int64_t size = std::min(last - first, shape.inner - column);
+      Aggregator::Strided(input_data + outer * shape.reduced * shape.inner + column,
+                          shape.reduced, shape.inner, size, output_data + first);
+      first += size;
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(num_outputs, num_outputs * shape.reduced / kMinReduceElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    reduce_range(0, num_outputs);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [num_outputs, num_tasks, &reduce_range](int32_t task) {
+      reduce_range(num_outputs * task / num_tasks, num_outputs * (task + 1) / num_tasks);
+    });
+  }
+  return true;
+}
+
+// The strided aggregators accumulate whole rows of the block into the output so the inner loop is vectorized.
+template <typename T>
+struct ReduceAggregatorSum {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).sum();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size);
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc += ConstEigenVectorArrayMap<T>(data + r * stride, size);
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorMean {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).mean();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    ReduceAggregatorSum<T>::Strided(data, reduced, stride, size, out);
+    EigenVectorArrayMap<T>(out, size) /= static_cast<T>(reduced);
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorSumSquare {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).squaredNorm();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size).square();
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc += ConstEigenVectorArrayMap<T>(data + r * stride, size).square();
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorL1 {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).cwiseAbs().sum();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size).abs();
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc += ConstEigenVectorArrayMap<T>(data + r * stride, size).abs();
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorL2 {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).norm();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    ReduceAggregatorSumSquare<T>::Strided(data, reduced, stride, size, out);
+    for (int64_t i = 0; i < size; ++i) {
+      out[i] = static_cast<T>(std::sqrt(out[i]));
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorLogSum {
+  static T Contiguous(const T* data, int64_t size) {
+    return static_cast<T>(std::log(ConstEigenVectorMap<T>(data, size).sum()));
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    ReduceAggregatorSum<T>::Strided(data, reduced, stride, size, out);
+    for (int64_t i = 0; i < size; ++i) {
+      out[i] = static_cast<T>(std::log(out[i]));
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorProd {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).prod();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size);
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc *= ConstEigenVectorArrayMap<T>(data + r * stride, size);
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorMax {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).maxCoeff();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size);
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc = acc.max(ConstEigenVectorArrayMap<T>(data + r * stride, size));
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorMin {
+  static T Contiguous(const T* data, int64_t size) {
+    return ConstEigenVectorMap<T>(data, size).minCoeff();
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    EigenVectorArrayMap<T> acc(out, size);
+    acc = ConstEigenVectorArrayMap<T>(data, size);
+    for (int64_t r = 1; r < reduced; ++r) {
+      acc = acc.min(ConstEigenVectorArrayMap<T>(data + r * stride, size));
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorLogSumExp {
+  static T Contiguous(const T* data, int64_t size) {
+    T max_value = ConstEigenVectorMap<T>(data, size).maxCoeff();
+    T scaled_exp_sum = 0;
+    for (int64_t i = 0; i < size; ++i) {
+      scaled_exp_sum += static_cast<T>(std::exp(data[i] - max_value));
+    }
+    return static_cast<T>(std::log(scaled_exp_sum) + max_value);
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, T* out) {
+    // out holds the maximums until the scaled sums are complete
+    ReduceAggregatorMax<T>::Strided(data, reduced, stride, size, out);
+    std::vector<T> scaled_exp_sums(static_cast<size_t>(size), 0);
+    for (int64_t r = 0; r < reduced; ++r) {
+      const T* row = data + r * stride;
+      for (int64_t i = 0; i < size; ++i) {
+        scaled_exp_sums[i] += static_cast<T>(std::exp(row[i] - out[i]));
+      }
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      out[i] = static_cast<T>(std::log(scaled_exp_sums[i]) + out[i]);
+    }
+  }
+};
+
+// ArgMax and ArgMin return the index of the first maximum or minimum
+template <typename T>
+struct ReduceAggregatorArgMax {
+  static int64_t Contiguous(const T* data, int64_t size) {
+    Eigen::MatrixXf::Index maxIndex;
+    ConstEigenVectorMap<T>(data, size).maxCoeff(&maxIndex);
+    return maxIndex;
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, int64_t* out) {
+    std::vector<T> max_values(data, data + size);
+    std::fill(out, out + size, static_cast<int64_t>(0));
+    for (int64_t r = 1; r < reduced; ++r) {
+      const T* row = data + r * stride;
+      for (int64_t i = 0; i < size; ++i) {
+        if (row[i] > max_values[i]) {
+          max_values[i] = row[i];
+          out[i] = r;
+        }
+      }
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorArgMin {
+  static int64_t Contiguous(const T* data, int64_t size) {
+    Eigen::MatrixXf::Index minIndex;
+    ConstEigenVectorMap<T>(data, size).minCoeff(&minIndex);
+    return minIndex;
+  }
+  static void Strided(const T* data, int64_t reduced, int64_t stride, int64_t size, int64_t* out) {
+    std::vector<T> min_values(data, data + size);
+    std::fill(out, out + size, static_cast<int64_t>(0));
+    for (int64_t r = 1; r < reduced; ++r) {
+      const T* row = data + r * stride;
+      for (int64_t i = 0; i < size; ++i) {
+        if (row[i] < min_values[i]) {
+          min_values[i] = row[i];
+          out[i] = r;
+        }
+      }
+    }
+  }
+};
+
 template <typename T>
 Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorL1<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -256,6 +558,10 @@ Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorL2<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -272,6 +578,10 @@ Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorLogSum<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -292,6 +602,10 @@ Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorLogSumExp<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -316,6 +630,10 @@ Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorMax<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -332,33 +650,30 @@ Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorMean<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
   Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
 
   return Status::OK();
 }
 
 template <typename T>
 Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorMin<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -375,6 +690,10 @@ Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorProd<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -391,33 +710,30 @@ Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorSum<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
   Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
 
   return Status::OK();
 }
 
 template <typename T>
 Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, T, ReduceAggregatorSumSquare<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -434,6 +750,10 @@ Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, int64_t, ReduceAggregatorArgMax<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
@@ -454,6 +774,10 @@ Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ArgMin<T>::Compute(OpKernelContext* ctx) const {
+  if (FastReduce<T, int64_t, ReduceAggregatorArgMin<T>>(ctx, axes_, keepdims_)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
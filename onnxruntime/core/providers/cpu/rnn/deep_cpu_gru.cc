@@ -20,6 +20,7 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
 #include "core/framework/tensor.h"
+#include "core/providers/cpu/math/gemm_pack.h"
 
 #include "core/platform/ort_mutex.h"
 
@@ -173,7 +174,8 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights& input_weights, const GemmWeights& recurrent_weights_zr,
+               const GemmWeights& recurrent_weights_h,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
@@ -241,6 +243,43 @@ class UniDirectionalGru {
 };
 }  // namespace detail
 
+void DeepCpuGruOp::PackWeights(const OpKernelInfo& info) {
+  const Tensor* W;
+  const Tensor* R;
+  if (!info.TryGetConstantInput(1, &W) || !info.TryGetConstantInput(2, &R) ||
+      W->DataType() != DataTypeImpl::GetType<float>() || R->DataType() != DataTypeImpl::GetType<float>()) {
+    return;
+  }
+
+  // W is [num_directions, 3*hidden_size, input_size] and R is [num_directions, 3*hidden_size, hidden_size].
+  // a bad shape is left to ValidateCommonRnnInputs
+  const auto& W_shape = W->Shape();
+  const auto& R_shape = R->Shape();
+  if (W_shape.NumDimensions() != 3 || W_shape[0] != num_directions_ || W_shape[1] != 3 * hidden_size_ ||
+      R_shape.NumDimensions() != 3 || R_shape[0] != num_directions_ || R_shape[1] != 3 * hidden_size_ ||
+      R_shape[2] != hidden_size_) {
+    return;
+  }
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  const size_t input_size = static_cast<size_t>(W_shape[2]);
+  for (int i = 0; i < num_directions_; ++i) {
+    // all are used as B^T. R[h] follows R[zr] in R
+    const float* recurrent_weights = R->Data<float>() + i * 3 * hidden_size * hidden_size;
+    if (!GemmPackB(info, CblasTrans, 3 * hidden_size, input_size, W->Data<float>() + i * 3 * hidden_size * input_size,
+                   input_size, packed_input_weights_[i]) ||
+        !GemmPackB(info, CblasTrans, 2 * hidden_size, hidden_size, recurrent_weights, hidden_size,
+                   packed_recurrent_weights_zr_[i]) ||
+        !GemmPackB(info, CblasTrans, hidden_size, hidden_size, recurrent_weights + 2 * hidden_size * hidden_size,
+                   hidden_size, packed_recurrent_weights_h_[i])) {
+      packed_input_weights_[i].reset();
+      packed_recurrent_weights_zr_[i].reset();
+      packed_recurrent_weights_h_[i].reset();
+      return;
+    }
+  }
+}
+
 // #define DUMP_MATRIXES to provide lots of diagnostic output
 #if defined(DUMP_MATRIXES)
 #define DumpMatrix(...) onnxruntime::rnn::detail::DumpMatrixImpl(__VA_ARGS__)
@@ -254,9 +293,33 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   Status status;
 
   auto data_type = X.DataType();
-  if (data_type == DataTypeImpl::GetType<float>())
-    status = ComputeImpl<float>(*context);
-  else if (data_type == DataTypeImpl::GetType<double>()) {
+  if (data_type == DataTypeImpl::GetType<float>()) {
+    ORT_RETURN_IF_ERROR(ValidateInputs(*context));
+
+    const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
+    const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
+    const size_t input_weights_size_per_direction = W.Shape().Size() / num_directions_;
+    const size_t recurrent_weights_size_per_direction = R.Shape().Size() / num_directions_;
+    const size_t recurrent_weights_zr_size = 2 * hidden_size_ * hidden_size_;
+
+    // R[h] follows R[zr] in R
+    GemmWeights input_weights[2];
+    GemmWeights recurrent_weights_zr[2];
+    GemmWeights recurrent_weights_h[2];
+    for (int i = 0; i < num_directions_; ++i) {
+      gsl::span<const float> recurrent_weights = R.DataAsSpan<float>().subspan(
+          i * recurrent_weights_size_per_direction, recurrent_weights_size_per_direction);
+      input_weights[i] = GemmWeights(W.DataAsSpan<float>().subspan(i * input_weights_size_per_direction,
+                                                                   input_weights_size_per_direction),
+                                     packed_input_weights_[i].get());
+      recurrent_weights_zr[i] = GemmWeights(recurrent_weights.subspan(0, recurrent_weights_zr_size),
+                                            packed_recurrent_weights_zr_[i].get());
+      recurrent_weights_h[i] = GemmWeights(recurrent_weights.subspan(recurrent_weights_zr_size),
+                                           packed_recurrent_weights_h_[i].get());
+    }
+
+    status = ComputeImpl<float>(*context, input_weights, recurrent_weights_zr, recurrent_weights_h);
+  } else if (data_type == DataTypeImpl::GetType<double>()) {
     /* Need to update all the helpers to support double...
     status = ComputeImpl<double>(*context); */
     ORT_NOT_IMPLEMENTED("GRU operator does not support double yet");
@@ -266,14 +329,26 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   return status;
 }
 
+Status DeepCpuGruOp::ValidateInputs(const OpKernelContext& context) const {
+  return ValidateCommonRnnInputs(*context.Input<Tensor>(0), *context.Input<Tensor>(1), *context.Input<Tensor>(2),
+                                 context.Input<Tensor>(3), 3, context.Input<Tensor>(4), context.Input<Tensor>(5),
+                                 num_directions_, hidden_size_);
+}
+
+Status DeepCpuGruOp::ComputeWithWeights(OpKernelContext& context, const GemmWeights* input_weights,
+                                        const GemmWeights* recurrent_weights_zr,
+                                        const GemmWeights* recurrent_weights_h) const {
+  return ComputeImpl<float>(context, input_weights, recurrent_weights_zr, recurrent_weights_h);
+}
+
 template <typename T>
-Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
+Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context, const GemmWeights* input_weights,
+                                 const GemmWeights* recurrent_weights_zr,
+                                 const GemmWeights* recurrent_weights_h) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(&context);
   concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
 
   // optional
   const auto* B = context.Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
@@ -286,9 +361,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  auto status = ValidateCommonRnnInputs(X, W, R, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
-  ORT_RETURN_IF_ERROR(status);
-
   // GRU outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -307,19 +379,12 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
-  ORT_RETURN_IF_ERROR(status);
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 3 * hidden_size_ * input_size;
-  const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -354,10 +419,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -376,24 +437,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights_zr[0],
+               recurrent_weights_h[0], output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights[1], recurrent_weights_zr[1],
+               recurrent_weights_h[1], output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights_zr[0],
+                  recurrent_weights_h[0], output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -492,8 +553,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights& input_weights,
+                                   const GemmWeights& recurrent_weights_zr,
+                                   const GemmWeights& recurrent_weights_h,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -510,11 +572,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
+  DumpMatrix("input_weights", input_weights.buffer.data(), 3 * hidden_size_, input_size_);
+  DumpMatrix("recurrent_weights", recurrent_weights_zr.buffer.data(), 3 * hidden_size_, hidden_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -546,8 +605,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, beta,
+              input_weights,
+              beta,
               outputZRH_.begin(), outputZRH_.end(),
               hidden_size_x3, ttp_);
 
@@ -612,8 +671,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
                 prev_Ht, prev_Ht_end,
                 hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, beta,
+                recurrent_weights_zr,
+                beta,
                 outputZRH_.begin() + out_added_offset, outputZRH_.end(),
                 hidden_size_x3, ttp_);
 
@@ -628,8 +687,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weights_h,  // Rh^T
+                  beta,
                   linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
                   hidden_size_, ttp_);
 
@@ -699,8 +758,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weights_h,  // Rh^T
+                  beta,
                   out_H, outputZRH_.end(),
                   hidden_size_x3, ttp_);
     }
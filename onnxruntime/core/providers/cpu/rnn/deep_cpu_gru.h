@@ -13,7 +13,7 @@ namespace onnxruntime {
 
 /// The class represents GRU operator using DeepCPU implementation for
 /// fast inference computation on CPU machines.
-class DeepCpuGruOp final : public OpKernel {
+class DeepCpuGruOp : public OpKernel {
  public:
   DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info) {
     // required attributes
@@ -50,24 +50,47 @@ class DeepCpuGruOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    PackWeights(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
 
- private:
+ protected:
+  // Validates the inputs of the operator, W and R only by their shapes
+  Status ValidateInputs(const OpKernelContext& context) const;
+
+  // Runs the GRU on the validated inputs, with the weights W, R[zr] and R[h] of each direction given by
+  // input_weights, recurrent_weights_zr and recurrent_weights_h
+  Status ComputeWithWeights(OpKernelContext& context, const rnn::detail::GemmWeights* input_weights,
+                            const rnn::detail::GemmWeights* recurrent_weights_zr,
+                            const rnn::detail::GemmWeights* recurrent_weights_h) const;
+
   rnn::detail::Direction direction_;
   int num_directions_;
 
   int hidden_size_ {};
+
+ private:
   float clip_;
   int linear_before_reset_ {};
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W, R[zr] and R[h] of each direction packed by PackWeights, empty if they weren't packed
+  BufferUniquePtr packed_input_weights_[2];
+  BufferUniquePtr packed_recurrent_weights_zr_[2];
+  BufferUniquePtr packed_recurrent_weights_h_[2];
+
   template <typename T>
-  Status ComputeImpl(OpKernelContext& context) const;
+  Status ComputeImpl(OpKernelContext& context, const rnn::detail::GemmWeights* input_weights,
+                     const rnn::detail::GemmWeights* recurrent_weights_zr,
+                     const rnn::detail::GemmWeights* recurrent_weights_h) const;
+
+  // Packs the weights of each direction once for the GEMMs, if W and R are constant float initializers
+  void PackWeights(const OpKernelInfo& info);
 };
 
 }  // namespace onnxruntime
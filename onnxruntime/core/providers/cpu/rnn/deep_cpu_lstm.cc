@@ -17,6 +17,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/providers/cpu/math/gemm_pack.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -200,7 +201,7 @@ class UniDirectionalLstm {
                      concurrency::ThreadPool* mlas_tp_);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights& input_weights, const GemmWeights& recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -293,9 +294,27 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
   // auto& logger = context->Logger();
 
   auto data_type = X.DataType();
-  if (data_type == DataTypeImpl::GetType<float>())
-    status = ComputeImpl<float>(*context);
-  else if (data_type == DataTypeImpl::GetType<double>()) {
+  if (data_type == DataTypeImpl::GetType<float>()) {
+    ORT_RETURN_IF_ERROR(ValidateInputs(*context));
+
+    const Tensor& W = *context->Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
+    const Tensor& R = *context->Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
+    const size_t input_weights_size_per_direction = W.Shape().Size() / num_directions_;
+    const size_t recurrent_weights_size_per_direction = R.Shape().Size() / num_directions_;
+
+    GemmWeights input_weights[2];
+    GemmWeights recurrent_weights[2];
+    for (int i = 0; i < num_directions_; ++i) {
+      input_weights[i] = GemmWeights(W.DataAsSpan<float>().subspan(i * input_weights_size_per_direction,
+                                                                   input_weights_size_per_direction),
+                                     packed_input_weights_[i].get());
+      recurrent_weights[i] = GemmWeights(R.DataAsSpan<float>().subspan(i * recurrent_weights_size_per_direction,
+                                                                       recurrent_weights_size_per_direction),
+                                         packed_recurrent_weights_[i].get());
+    }
+
+    status = ComputeImpl<float>(*context, input_weights, recurrent_weights);
+  } else if (data_type == DataTypeImpl::GetType<double>()) {
     /* Need to update all the helpers to support double...
     status = ComputeImpl<double>(*context); */
     ORT_NOT_IMPLEMENTED("LSTM operator does not support double yet");
@@ -305,6 +324,40 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
   return status;
 }
 
+void DeepCpuLstmOp::PackWeights(const OpKernelInfo& info) {
+  const Tensor* W;
+  const Tensor* R;
+  if (!info.TryGetConstantInput(1, &W) || !info.TryGetConstantInput(2, &R) ||
+      W->DataType() != DataTypeImpl::GetType<float>() || R->DataType() != DataTypeImpl::GetType<float>()) {
+    return;
+  }
+
+  // W is [num_directions, 4*hidden_size, input_size] and R is [num_directions, 4*hidden_size, hidden_size].
+  // a bad shape is left to ValidateInputs
+  const auto& W_shape = W->Shape();
+  const auto& R_shape = R->Shape();
+  if (W_shape.NumDimensions() != 3 || W_shape[0] != num_directions_ || W_shape[1] != 4 * hidden_size_ ||
+      R_shape.NumDimensions() != 3 || R_shape[0] != num_directions_ || R_shape[1] != 4 * hidden_size_ ||
+      R_shape[2] != hidden_size_) {
+    return;
+  }
+
+  const size_t N = static_cast<size_t>(4 * hidden_size_);
+  const size_t input_size = static_cast<size_t>(W_shape[2]);
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  for (int i = 0; i < num_directions_; ++i) {
+    // both are used as B^T
+    if (!GemmPackB(info, CblasTrans, N, input_size, W->Data<float>() + i * N * input_size, input_size,
+                   packed_input_weights_[i]) ||
+        !GemmPackB(info, CblasTrans, N, hidden_size, R->Data<float>() + i * N * hidden_size, hidden_size,
+                   packed_recurrent_weights_[i])) {
+      packed_input_weights_[i].reset();
+      packed_recurrent_weights_[i].reset();
+      return;
+    }
+  }
+}
+
 // #define DUMP_MATRIXES to provide lots of diagnostic output
 #if defined(DUMP_MATRIXES)
 #define DumpMatrix(...) ::onnxruntime::rnn::detail::DumpMatrixImpl(__VA_ARGS__)
@@ -312,16 +365,20 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+Status DeepCpuLstmOp::ComputeWithWeights(OpKernelContext& context, const GemmWeights* input_weights,
+                                         const GemmWeights* recurrent_weights) const {
+  return ComputeImpl<float>(context, input_weights, recurrent_weights);
+}
+
 template <typename T>
-Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
+Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context, const GemmWeights* input_weights,
+                                  const GemmWeights* recurrent_weights) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(&context);
   concurrency::ThreadPool* mlas_thread_pool = ctx_internal->GetOperatorThreadPool();
 
   auto& logger = context.Logger();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 4*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 4*hidden_size, hidden_size]
 
   // optional
   const Tensor* B = context.Input<Tensor>(3);              // bias. [num_directions, 8*hidden_size]
@@ -336,9 +393,6 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  Status status = ValidateInputs(X, W, R, B, sequence_lens, initial_h, initial_c, P, batch_size);
-  ORT_RETURN_IF_ERROR(status);
-
   // LSTM outputs are optional but must be in the same order
   TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
   Tensor* Y = context.Output(/*index*/ 0, Y_dims);
@@ -361,22 +415,15 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   }
 
   AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
-  ORT_RETURN_IF_ERROR(status);
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
 
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
   gsl::span<const T> peephole_weights = P != nullptr ? P->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
-  const size_t input_weights_size_per_direction = 4 * hidden_size_ * input_size;
-  const size_t hidden_weights_size_per_direction = 4 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 8 * hidden_size_;
   const size_t peephole_weights_size_per_direction = 3 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, hidden_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
   gsl::span<const T> peephole_weights_1 =
       peephole_weights.empty() ? peephole_weights
@@ -428,10 +475,6 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> hidden_weights_2 = recurrent_weights.subspan(hidden_weights_size_per_direction,
-                                                                    hidden_weights_size_per_direction);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
     gsl::span<const T> peephole_weights_2 =
         peephole_weights.empty() ? peephole_weights
@@ -470,9 +513,9 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[5],
                                      clip_, lstm_tp_, mlas_thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights[0],
                output_1, hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights[1], recurrent_weights[1],
                output_2, hidden_output_2, last_cell_2);
   } else {
     detail::UniDirectionalLstm<T> fw(alloc, logger, seq_length, batch_size, input_size,
@@ -483,7 +526,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[2],
                                      clip_, lstm_tp_, mlas_thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights[0], recurrent_weights[0],
                output_1, hidden_output_1, last_cell_1);
   }
 
@@ -497,6 +540,13 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   return Status::OK();
 }
 
+Status DeepCpuLstmOp::ValidateInputs(const OpKernelContext& context) const {
+  const Tensor& X = *context.Input<Tensor>(0);
+  return ValidateInputs(X, *context.Input<Tensor>(1), *context.Input<Tensor>(2), context.Input<Tensor>(3),
+                        context.Input<Tensor>(4), context.Input<Tensor>(5), context.Input<Tensor>(6),
+                        context.Input<Tensor>(7), gsl::narrow<int>(X.Shape()[1]));
+}
+
 Status DeepCpuLstmOp::ValidateInputs(const Tensor& X, const Tensor& W, const Tensor& R, const Tensor* B,
                                      const Tensor* sequence_lens, const Tensor* initial_h, const Tensor* initial_c,
                                      const Tensor* P, int batch_size) const {
@@ -720,8 +770,8 @@ template <typename T>
 void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const gsl::span<const int>& sequence_lengths_arg,
                                     const int num_directions,
-                                    const gsl::span<const T>& input_weights,
-                                    const gsl::span<const T>& recurrent_weights,
+                                    const GemmWeights& input_weights,
+                                    const GemmWeights& recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -781,8 +831,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta,
+              input_weights,  // W[iofc]
+              beta,
               output_iofc_.begin(), output_iofc_.end(),
               hidden_size_x4, mlas_tp_);
 
@@ -818,20 +868,37 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       // after the first step this will switch to the output from the previous step
       span_T_const_iter previous_state = batched_hidden_state_one_step.cbegin() + row * hidden_size_;
 
+      // the rows of this chunk are done once its longest sequence is
+      int local_max_sequence_length = 0;
+      for (int lrow = row; lrow < row + local_fused_hidden_rows; ++lrow) {
+        local_max_sequence_length = std::max(local_max_sequence_length, sequence_lengths[lrow]);
+        if (sequence_lengths[lrow] == 0) {
+          auto final_cell_state_dst = final_cell_state.begin() + lrow * hidden_size_;
+          std::fill_n(final_cell_state_dst, hidden_size_, T{});
+        }
+      }
+
       // run through steps sequentially
-      for (int step = 0; step < max_sequence_length; step++) {
+      for (int step = 0; step < local_max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
         const std::string row_str = " [row=" + std::to_string(row) + ",seqno=" + std::to_string(step) + "]";
 #endif
 
         span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + row) * hidden_size_x4;
 
+        // the finished rows are skipped by GateComputations, so the GEMM stops at the last row still running
+        int gemm_rows = local_fused_hidden_rows;
+        if (step >= min_sequence_length) {
+          while (gemm_rows > 0 && step >= sequence_lengths[row + gemm_rows - 1])
+            --gemm_rows;
+        }
+
         // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-        ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
+        ComputeGemm(gemm_rows, hidden_size_x4, hidden_size_, alpha,
                     previous_state, previous_state_end,  // Ht-1
                     hidden_size_,
-                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta,
+                    recurrent_weights,  // R[iofc]
+                    beta,
                     step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
                     hidden_size_x4, mlas_tp_);
 
@@ -863,10 +930,6 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
             gsl::span<T> dst = final_cell_state.subspan(lrow * hidden_size_, hidden_size_);
             gsl::copy(src, dst);
           }
-          if (step == 0 && sequence_lengths[lrow] == 0) {
-            auto final_cell_state_dst = final_cell_state.begin() + lrow * hidden_size_;
-            std::fill_n(final_cell_state_dst, hidden_size_, T{});
-          }
         }
 
         if (output_sequence) {
@@ -882,6 +945,14 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         previous_state = batched_output + row * hidden_size_;
         previous_state_end = batched_output_end;
       }
+
+      // zero the outputs of the steps skipped once the chunk was done
+      if (output_sequence) {
+        for (int step = local_max_sequence_length; step < max_sequence_length; step++) {
+          auto output_row = outputs.begin() + step * output_step_length + row * hidden_size_;
+          std::fill_n(output_row, local_fused_hidden_rows * hidden_size_, T{});
+        }
+      }
     };
 
     ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, lstm_tp_, logger_);
@@ -908,8 +979,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
                   previous_state, previous_state_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, beta,
+                  recurrent_weights,  // R[iofc]
+                  beta,
                   step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
                   hidden_size_x4, mlas_tp_);
 
@@ -5,6 +5,7 @@
 
 #include <limits>
 
+#include "core/framework/allocator.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 #include "core/platform/threadpool.h"
@@ -13,7 +14,7 @@ namespace onnxruntime {
 
 /// The class represents DeepCPU implementation of a long short term memory (LSTM) operator.
 /// For details, refer to http://aka.ms/dl-optimization/.
-class DeepCpuLstmOp final : public OpKernel {
+class DeepCpuLstmOp : public OpKernel {
  public:
   DeepCpuLstmOp(const OpKernelInfo& info)
       : OpKernel(info), clip_(info.GetAttrOrDefault<float>("clip", std::numeric_limits<float>::max())) {
@@ -49,15 +50,35 @@ class DeepCpuLstmOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    PackWeights(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuLstmOp() override = default;
 
+ protected:
+  // Validates the inputs of the operator, W and R only by their shapes
+  Status ValidateInputs(const OpKernelContext& context) const;
+
+  // Runs the LSTM on the validated inputs, with the weights W and R of each direction given by
+  // input_weights and recurrent_weights
+  Status ComputeWithWeights(OpKernelContext& context, const rnn::detail::GemmWeights* input_weights,
+                            const rnn::detail::GemmWeights* recurrent_weights) const;
+
+  rnn::detail::Direction direction_;
+  int num_directions_;
+
+  int hidden_size_ = 0;
+
  private:
   template <typename T>
-  Status ComputeImpl(OpKernelContext& context) const;
+  Status ComputeImpl(OpKernelContext& context, const rnn::detail::GemmWeights* input_weights,
+                     const rnn::detail::GemmWeights* recurrent_weights) const;
+
+  // Packs the weights of each direction once for the GEMMs, if W and R are constant float initializers
+  void PackWeights(const OpKernelInfo& info);
 
   Status ValidateInputs(const Tensor& X,
                         const Tensor& W,
@@ -69,15 +90,15 @@ class DeepCpuLstmOp final : public OpKernel {
                         const Tensor* P,
                         int batch_size) const;
 
-  rnn::detail::Direction direction_;
-  int num_directions_;
-
-  int hidden_size_ = 0;
   float clip_;
   bool input_forget_ = false;
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W and R of each direction packed by PackWeights, empty if they weren't packed
+  BufferUniquePtr packed_input_weights_[2];
+  BufferUniquePtr packed_recurrent_weights_[2];
+
   // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
   // across them. mutable due to this.
   // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
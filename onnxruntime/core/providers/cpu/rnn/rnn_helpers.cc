@@ -13,9 +13,11 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/rnn/rnn_activation_functors.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 namespace rnn {
@@ -101,6 +103,78 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+GemmWeights QuantizeGemmWeights(const AllocatorPtr& allocator, int N, int K, const uint8_t* weights, float scale,
+                                uint8_t zero_point, BufferUniquePtr& buffer) {
+  GemmWeights result;
+  result.quantized = true;
+  result.scale = scale;
+  result.zero_point = zero_point;
+
+  // the integer GEMM takes B as K x N rows
+  const size_t size = static_cast<size_t>(N) * K;
+  BufferUniquePtr transposed(allocator->Alloc(size), BufferDeleter(allocator));
+  auto* transposed_data = static_cast<uint8_t*>(transposed.get());
+  for (int n = 0; n < N; ++n) {
+    for (int k = 0; k < K; ++k) {
+      transposed_data[k * N + n] = weights[n * K + k];
+    }
+  }
+
+  if (QGemmPackBu8(N, K, transposed_data, N, allocator, buffer)) {
+    result.quantized_packed = buffer.get();
+  } else {
+    buffer = std::move(transposed);
+    result.quantized_buffer = static_cast<const uint8_t*>(buffer.get());
+  }
+
+  return result;
+}
+
+void ComputeGemm(int M, int N, int K, float alpha, const float* A, int lda, const GemmWeights& weights,
+                 float beta, float* C, int ldc, concurrency::ThreadPool* tp) {
+  if (!weights.quantized) {
+    if (weights.packed != nullptr) {
+      MlasSgemm(CblasNoTrans, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha, A,
+                static_cast<size_t>(lda), weights.packed, beta, C, static_cast<size_t>(ldc), tp);
+    } else {
+      ::onnxruntime::math::GemmEx<float>(CblasNoTrans, CblasTrans, M, N, K, alpha, A, lda,
+                                         weights.buffer.data(), K, beta, C, ldc, tp);
+    }
+    return;
+  }
+
+  // the steps of the RNNs run with few rows, so these stay small
+  std::vector<uint8_t> quantized_A(static_cast<size_t>(M) * K);
+  std::vector<int32_t> quantized_C(static_cast<size_t>(M) * N);
+  float A_scale;
+  uint8_t A_zero_point;
+  DynamicQuantizeu8(M, K, A, lda, quantized_A.data(), A_scale, A_zero_point);
+
+  if (weights.quantized_packed != nullptr) {
+    QGemmu8u8_s32(M, N, K, quantized_A.data(), K, A_zero_point, weights.quantized_packed, weights.zero_point,
+                  quantized_C.data(), N, tp);
+  } else {
+    QGemmu8u8_s32(M, N, K, quantized_A.data(), K, A_zero_point, weights.quantized_buffer, N, weights.zero_point,
+                  quantized_C.data(), N, tp);
+  }
+
+  // C = alpha * A_scale * B_scale * (A - A_zero_point) * (B - B_zero_point) + beta * C
+  const float multiplier = alpha * A_scale * weights.scale;
+  const int32_t* quantized_row = quantized_C.data();
+  for (int m = 0; m < M; ++m, quantized_row += N) {
+    float* row = C + m * ldc;
+    if (beta == 0.f) {
+      for (int n = 0; n < N; ++n) {
+        row[n] = multiplier * quantized_row[n];
+      }
+    } else {
+      for (int n = 0; n < N; ++n) {
+        row[n] = multiplier * quantized_row[n] + beta * row[n];
+      }
+    }
+  }
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>>
     NameToArgUsageMap{{"affine", {1, 1}},
@@ -175,6 +175,57 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// The weights B of a GEMM of a RNN, given as the N x K rows of B^T like the weights of the RNN operators.
+// They are floats, packed once by GemmPackB if packed isn't nullptr, or uint8 quantized by QuantizeGemmWeights,
+// in which case A is quantized on the fly for an integer GEMM.
+struct GemmWeights {
+  GemmWeights() = default;
+  GemmWeights(gsl::span<const float> weights, const void* packed_weights = nullptr)
+      : buffer(weights), packed(packed_weights) {}
+
+  gsl::span<const float> buffer;
+  const void* packed = nullptr;
+
+  bool quantized = false;
+  // the K x N rows of B, or B packed by QGemmPackBu8 if quantized_packed isn't nullptr
+  const uint8_t* quantized_buffer = nullptr;
+  const void* quantized_packed = nullptr;
+  float scale = 1.f;
+  uint8_t zero_point = 0;
+};
+
+// Prepares the uint8 weights of a GEMM, given as the N x K rows of B^T, for ComputeGemm: transposes them and
+// packs them with QGemmPackBu8 when it can. buffer holds the result and has to outlive the returned weights.
+GemmWeights QuantizeGemmWeights(const AllocatorPtr& allocator, int N, int K, const uint8_t* weights, float scale,
+                                uint8_t zero_point, BufferUniquePtr& buffer);
+
+// C = alpha * A * B^T + beta * C for the weights B
+void ComputeGemm(int M, int N, int K, float alpha, const float* A, int lda, const GemmWeights& weights,
+                 float beta, float* C, int ldc, concurrency::ThreadPool* tp);
+
+// Same as ComputeGemm above, with the weights B given by GemmWeights
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const GemmWeights& weights,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(weights.quantized || weights.packed != nullptr ||
+              static_cast<size_t>(N) * K <= static_cast<size_t>(weights.buffer.size()));
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  ComputeGemm(M, N, K, alpha, &*A, lda, weights, beta, &*C, ldc, tp);
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
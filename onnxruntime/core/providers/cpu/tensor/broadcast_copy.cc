@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tensor/broadcast_copy.h"
+
+#include <algorithm>
+#include <cstring>
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+constexpr int64_t kMinBroadcastCopyBytesPerTask = 32768;
+
+template <typename T>
+void FillElements(const uint8_t* input, uint8_t* output, int64_t count) {
+  T value;
+  memcpy(&value, input, sizeof(T));
+  std::fill_n(reinterpret_cast<T*>(output), count, value);
+}
+
+// Fills count elements at output with the element at input.
+void FillElements(const uint8_t* input, uint8_t* output, size_t element_size, int64_t count) {
+  switch (element_size) {
+    case 1:
+      memset(output, *input, static_cast<size_t>(count));
+      break;
+    case 2:
+      FillElements<uint16_t>(input, output, count);
+      break;
+    case 4:
+      FillElements<uint32_t>(input, output, count);
+      break;
+    case 8:
+      FillElements<uint64_t>(input, output, count);
+      break;
+    default:
+      for (int64_t i = 0; i < count; ++i) {
+        memcpy(output + i * element_size, input, element_size);
+      }
+      break;
+  }
+}
+}  // namespace
+
+void BroadcastCopy(const void* input, void* output, size_t element_size,
+                   const std::vector<int64_t>& output_dims, const std::vector<int64_t>& input_strides,
+                   concurrency::ThreadPool* tp) {
+  ORT_ENFORCE(output_dims.size() == input_strides.size(), "Each output dimension needs an input stride");
+
+  // Drop the axes of size 1, and merge an axis into the next inner one when the input walks both with one stride.
+  // Two broadcast axes merge, as does a contiguous run of input axes.
+  std::vector<int64_t> dims;
+  std::vector<int64_t> strides;
+  int64_t size = 1;
+  for (size_t i = 0; i < output_dims.size(); ++i) {
+    size *= output_dims[i];
+    if (output_dims[i] == 1) {
+      continue;
+    }
+    if (!dims.empty() && strides.back() == input_strides[i] * output_dims[i]) {
+      dims.back() *= output_dims[i];
+      strides.back() = input_strides[i];
+    } else {
+      dims.push_back(output_dims[i]);
+      strides.push_back(input_strides[i]);
+    }
+  }
+
+  const auto* input_bytes = static_cast<const uint8_t*>(input);
+  auto* output_bytes = static_cast<uint8_t*>(output);
+  if (size == 0) {
+    return;
+  }
+  if (dims.empty()) {
+    memcpy(output_bytes, input_bytes, element_size);
+    return;
+  }
+
+  // The innermost axis is the run, and a broadcast axis around it repeats the run, so the block written for each
+  // index of the outer axes is the run followed by copies of itself.
+  const size_t rank = dims.size();
+  const int64_t run = dims[rank - 1];
+  const int64_t run_stride = strides[rank - 1];
+  const size_t run_bytes = static_cast<size_t>(run) * element_size;
+  size_t outer_rank = rank - 1;
+  int64_t run_repeats = 1;
+  if (outer_rank > 0 && strides[outer_rank - 1] == 0) {
+    run_repeats = dims[outer_rank - 1];
+    --outer_rank;
+  }
+  const size_t block_bytes = run_bytes * static_cast<size_t>(run_repeats);
+  const int64_t block_count = size / (run * run_repeats);
+
+  auto copy_block = [&](const uint8_t* source, uint8_t* target) {
+    if (run_stride == 1) {
+      memcpy(target, source, run_bytes);
+    } else if (run_stride == 0) {
+      FillElements(source, target, element_size, run);
+    } else {
+      for (int64_t i = 0; i < run; ++i) {
+        memcpy(target + i * element_size, source + i * run_stride * element_size, element_size);
+      }
+    }
+    // double the copies of the run until the block is complete
+    for (int64_t written = 1; written < run_repeats;) {
+      const int64_t count = std::min(written, run_repeats - written);
+      memcpy(target + written * run_bytes, target, static_cast<size_t>(count) * run_bytes);
+      written += count;
+    }
+  };
+
+  // Each task decomposes its first block into the indices of the outer axes once, then steps the indices along.
+  auto copy_range = [&](int64_t first, int64_t last) {
+    std::vector<int64_t> indices(outer_rank);
+    int64_t offset = 0;
+    int64_t remainder = first;
+    for (size_t axis = outer_rank; axis-- > 0;) {
+      indices[axis] = remainder % dims[axis];
+      remainder /= dims[axis];
+      offset += indices[axis] * strides[axis];
+    }
+
+    uint8_t* target = output_bytes + first * block_bytes;
+    for (int64_t block = first; block < last; ++block) {
+      copy_block(input_bytes + offset * element_size, target);
+      target += block_bytes;
+
+      for (size_t axis = outer_rank; axis-- > 0;) {
+        offset += strides[axis];
+        if (++indices[axis] < dims[axis]) {
+          break;
+        }
+        offset -= indices[axis] * strides[axis];
+        indices[axis] = 0;
+      }
+    }
+  };
+
+  int64_t num_tasks = std::min(block_count, size * static_cast<int64_t>(element_size) / kMinBroadcastCopyBytesPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    copy_range(0, block_count);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [block_count, num_tasks, &copy_range](int32_t task) {
+      copy_range(block_count * task / num_tasks, block_count * (task + 1) / num_tasks);
+    });
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+Copy the elements of element_size bytes of input to the output of output_dims, where the output element at an index
+is the input element at the dot product of the index and input_strides, in elements. A stride of 0 repeats the input
+along that axis, which is how Expand broadcasts and Tile repeats.
+Axes are merged where the input walks them with a single stride, so the copy is made of contiguous runs copied with
+memcpy, or single elements filled, with the runs repeated along the next axis copied from the output already
+written. If tp is not null, large copies are split across its threads.
+*/
+void BroadcastCopy(const void* input, void* output, size_t element_size,
+                   const std::vector<int64_t>& output_dims, const std::vector<int64_t>& input_strides,
+                   concurrency::ThreadPool* tp);
+
+}  // namespace onnxruntime
@@ -2,70 +2,98 @@
 // Licensed under the MIT License.
 
 
+#include <algorithm>
 #include <sstream>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/GPU/Half.h"
-#include "core/common/common.h"
-
-#if defined(_M_AMD64)
-#include "core/mlas/inc/mlas.h"
-#endif
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 
+namespace {
+constexpr int64_t kMinCastElementsPerTask = 16384;
+
+// the number of float16 values converted through a float buffer on the stack at a time
+constexpr int64_t kCastFloat16BlockSize = 256;
+}  // namespace
+
+// Casts count values from in to out. Eigen vectorizes the casts it has packet conversions for.
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
-  output_vector = in_vector.template cast<DstType>();
-}
+struct CastSpan {
+  static void Cast(const SrcType* in, DstType* out, int64_t count) {
+    auto in_vector = ConstEigenVectorMap<SrcType>(in, count);
+    auto output_vector = EigenVectorMap<DstType>(out, count);
+    output_vector = in_vector.template cast<DstType>();
+  }
+};
 
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
-}
+struct CastSpan<MLFloat16, float> {
+  static void Cast(const MLFloat16* in, float* out, int64_t count) {
+    MlasConvertHalfToFloatBuffer(&in[0].val, out, static_cast<size_t>(count));
+  }
+};
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
-}
+struct CastSpan<float, MLFloat16> {
+  static void Cast(const float* in, MLFloat16* out, int64_t count) {
+    MlasConvertFloatToHalfBuffer(in, &out[0].val, static_cast<size_t>(count));
+  }
+};
+
+// The other casts of float16 go through float a block at a time.
+template <typename DstType>
+struct CastSpan<MLFloat16, DstType> {
+  static void Cast(const MLFloat16* in, DstType* out, int64_t count) {
+    float buffer[kCastFloat16BlockSize];
+    for (int64_t i = 0; i < count; i += kCastFloat16BlockSize) {
+      const int64_t block = std::min(kCastFloat16BlockSize, count - i);
+      CastSpan<MLFloat16, float>::Cast(in + i, buffer, block);
+      CastSpan<float, DstType>::Cast(buffer, out + i, block);
+    }
+  }
+};
 
+template <typename SrcType>
+struct CastSpan<SrcType, MLFloat16> {
+  static void Cast(const SrcType* in, MLFloat16* out, int64_t count) {
+    float buffer[kCastFloat16BlockSize];
+    for (int64_t i = 0; i < count; i += kCastFloat16BlockSize) {
+      const int64_t block = std::min(kCastFloat16BlockSize, count - i);
+      CastSpan<SrcType, float>::Cast(in + i, buffer, block);
+      CastSpan<float, MLFloat16>::Cast(buffer, out + i, block);
+    }
+  }
+};
+
+// Casts the tensor, splitting large tensors across the threads of tp.
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
-  ORT_ENFORCE(allocator != nullptr);
-  const int64_t len = shape.Size();
-  ORT_ENFORCE(len > 0);
-  void* buffer = allocator->AllocArray(sizeof(float), len);
-  ORT_ENFORCE(buffer);
-  Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info());
-  if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
-  } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
+inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const int64_t shape_size = shape.Size();
+  const auto* in_data = in->template Data<SrcType>();
+  auto* out_data = out->template MutableData<DstType>();
+
+  int64_t num_tasks = shape_size / kMinCastElementsPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    CastSpan<SrcType, DstType>::Cast(in_data, out_data, shape_size);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [=](int32_t task) {
+      const int64_t first = shape_size * task / num_tasks;
+      const int64_t last = shape_size * (task + 1) / num_tasks;
+      CastSpan<SrcType, DstType>::Cast(in_data + first, out_data + first, last - first);
+    });
   }
-  allocator->Free(buffer);
 }
 
 template <typename SrcType>
@@ -168,17 +196,9 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
-  }
-
-  template <typename SrcType,
-            typename DstType>
-  Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
-    AllocatorPtr allocator;
-    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
-    return Status::OK();
+  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
+    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape,
+                                              static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
   }
 
   template <typename SrcType>
@@ -229,45 +249,40 @@ const std::vector<MLDataType> castOpTypeConstraints{
                                                                                                                                    \
     switch (to_) {                                                                                                                 \
       case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
+        CastData<in_type, bool>(X, Y, shape, context);                                                                             \
         break;                                                                                                                     \
       case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int16_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int32_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int64_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, uint8_t>(X, Y, shape, context);                                                                          \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint16_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint32_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint64_t>(X, Y, shape, context);                                                                         \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
+        CastData<in_type, float>(X, Y, shape, context);                                                                            \
         break;                                                                                                                     \
       case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
+        CastData<in_type, double>(X, Y, shape, context);                                                                           \
         break;                                                                                                                     \
       case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
+        CastData<in_type, int8_t>(X, Y, shape, context);                                                                           \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT16:                                                                                           \
-        if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
-        } else {                                                                                                                   \
-          auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
-          if (!st.IsOK()) return st;                                                                                               \
-        }                                                                                                                          \
+        CastData<in_type, MLFloat16>(X, Y, shape, context);                                                                        \
         break;                                                                                                                     \
       case TensorProto_DataType_STRING:                                                                                            \
         CastToStringData<in_type>(X, Y, shape);                                                                                    \
@@ -308,31 +323,31 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
   Status st;
   switch (to_) {
     case TensorProto_DataType_BOOL:
-      st = CastFloat16Data<MLFloat16, bool>(X, Y, shape, context);
+      CastData<MLFloat16, bool>(X, Y, shape, context);
       break;
     case TensorProto_DataType_INT16:
-      st = CastFloat16Data<MLFloat16, int16_t>(X, Y, shape, context);
+      CastData<MLFloat16, int16_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_INT32:
-      st = CastFloat16Data<MLFloat16, int32_t>(X, Y, shape, context);
+      CastData<MLFloat16, int32_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_INT64:
-      st = CastFloat16Data<MLFloat16, int64_t>(X, Y, shape, context);
+      CastData<MLFloat16, int64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_UINT8:
-      st = CastFloat16Data<MLFloat16, uint8_t>(X, Y, shape, context);
+      CastData<MLFloat16, uint8_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_UINT16:
-      st = CastFloat16Data<MLFloat16, uint16_t>(X, Y, shape, context);
+      CastData<MLFloat16, uint16_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_UINT32:
-      st = CastFloat16Data<MLFloat16, uint32_t>(X, Y, shape, context);
+      CastData<MLFloat16, uint32_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_UINT64:
-      st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
+      CastData<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT16: {
       auto X_type = X->DataType();
@@ -346,10 +361,10 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       break;
     }
     case TensorProto_DataType_DOUBLE:
-      st = CastFloat16Data<MLFloat16, double>(X, Y, shape, context);
+      CastData<MLFloat16, double>(X, Y, shape, context);
       break;
     case TensorProto_DataType_INT8:
-      st = CastFloat16Data<MLFloat16, int8_t>(X, Y, shape, context);
+      CastData<MLFloat16, int8_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_STRING:
       ORT_THROW("Casting from 'float16' to 'string' is not supported yet."); /*break;*/
@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/compress.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -13,6 +19,31 @@ ONNX_CPU_OPERATOR_KERNEL(
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Compress);
 
+namespace {
+constexpr int64_t kMinCompressConditionsPerTask = 16384;
+constexpr int64_t kMinCompressBytesPerTask = 32768;
+
+// Runs fn for each task, across the threads of tp if there is more than one task.
+void ForEachTask(concurrency::ThreadPool* tp, int64_t num_tasks, const std::function<void(int64_t)>& fn) {
+  if (tp == nullptr || num_tasks <= 1) {
+    for (int64_t task = 0; task < num_tasks; ++task) {
+      fn(task);
+    }
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&fn](int32_t task) { fn(task); });
+  }
+}
+
+// Copies count elements, assigning strings and copying the bytes of other types.
+void CopyElements(const uint8_t* source, uint8_t* target, int64_t count, size_t element_bytes, bool is_string_type) {
+  if (is_string_type) {
+    std::copy_n(reinterpret_cast<const std::string*>(source), count, reinterpret_cast<std::string*>(target));
+  } else {
+    memcpy(target, source, static_cast<size_t>(count) * element_bytes);
+  }
+}
+}  // namespace
+
 Status Compress::Compute(OpKernelContext* ctx) const {
   const auto* input_tensor = ctx->Input<Tensor>(0);
   size_t rank = input_tensor->Shape().NumDimensions();
@@ -25,18 +56,29 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->template Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[axis_] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
-    }
+  // The output size depends on the condition, so it is split into chunks and the true conditions of each chunk are
+  // counted in parallel. The counts of the chunks before a chunk sum to where its selected elements are written.
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  int64_t num_chunks = 1;
+  if (tp != nullptr) {
+    num_chunks = std::max<int64_t>(std::min(valid_condition_length / kMinCompressConditionsPerTask,
+                                            static_cast<int64_t>(tp->NumThreads()) + 1),
+                                   1);
   }
 
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  ForEachTask(tp, num_chunks, [&](int64_t chunk) {
+    const bool* first = condition_data + valid_condition_length * chunk / num_chunks;
+    const bool* last = condition_data + valid_condition_length * (chunk + 1) / num_chunks;
+    chunk_offsets[chunk + 1] = std::count(first, last, true);
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  const int64_t positive_condition_count = chunk_offsets[num_chunks];
+
   std::vector<int64_t> output_dims(input_dimensions);
   if (has_axis_) {
     output_dims[axis_] = positive_condition_count;
@@ -55,7 +97,6 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->DataType() == DataTypeImpl::GetType<std::string>();
-  int64_t output_index = 0;
 
   if (has_axis_) {
     int64_t axes_left_stride = 1;
@@ -68,45 +109,64 @@ Status Compress::Compute(OpKernelContext* ctx) const {
       axes_right_stride *= input_dimensions[i];
     }
     int64_t axes_included_right_stride = axes_right_stride * input_dimensions[axis_];
-    int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
     ORT_ENFORCE(axes_right_stride >= 0 &&
                 static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
     size_t axes_right_stride_bytes = 0;
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
-          continue;
-        }
-        if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-              reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
-          }
-          output_index += axes_right_stride;
-        } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
-        }
+
+    // the condition along the axis is short, so the selected indices are listed once, and each block of the output
+    // is then the right stride of the input at a left index and a selected index
+    std::vector<int64_t> selected_indices;
+    selected_indices.reserve(positive_condition_count);
+    for (int64_t j = 0; j < valid_condition_length; ++j) {
+      if (condition_data[j]) {
+        selected_indices.push_back(j);
       }
     }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
+
+    const int64_t block_count = axes_left_stride * positive_condition_count;
+    int64_t num_tasks = std::min(block_count, static_cast<int64_t>(block_count * axes_right_stride_bytes /
+                                                                   kMinCompressBytesPerTask));
+    if (tp != nullptr) {
+      num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+    }
+    num_tasks = std::max<int64_t>(num_tasks, 1);
+
+    ForEachTask(tp, num_tasks, [&](int64_t task) {
+      for (int64_t block = block_count * task / num_tasks, end = block_count * (task + 1) / num_tasks;
+           block < end; ++block) {
+        const int64_t i = block / positive_condition_count;
+        const int64_t j = selected_indices[block % positive_condition_count];
+        CopyElements(input_data + (i * axes_included_right_stride + j * axes_right_stride) * element_bytes,
+                     output_data + block * axes_right_stride_bytes, axes_right_stride, element_bytes,
+                     is_string_type);
       }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
+    });
+  } else {
+    // each chunk copies its runs of true conditions to the output from the offset of the chunk
+    ForEachTask(tp, num_chunks, [&](int64_t chunk) {
+      const int64_t first = valid_condition_length * chunk / num_chunks;
+      const int64_t last = valid_condition_length * (chunk + 1) / num_chunks;
+      uint8_t* output = output_data + chunk_offsets[chunk] * element_bytes;
+      for (int64_t i = first; i < last;) {
+        if (!condition_data[i]) {
+          ++i;
+          continue;
+        }
+        int64_t run_end = i + 1;
+        while (run_end < last && condition_data[run_end]) {
+          ++run_end;
+        }
+        CopyElements(input_data + i * element_bytes, output, run_end - i, element_bytes, is_string_type);
+        output += (run_end - i) * element_bytes;
+        i = run_end;
       }
-      ++output_index;
-    }
+    });
   }
 
-return Status::OK();
+  return Status::OK();
 }
 
 }  // namespace onnxruntime
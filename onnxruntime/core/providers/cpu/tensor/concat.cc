@@ -125,6 +125,13 @@ Status Concat::Compute(OpKernelContext* ctx) const {
 
     // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
     uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+
+    // the producer of the input may have written it in place, see AllocKind::kSubTensor
+    if (static_cast<int64_t>(input_size) == input_axis_pitch && input == output + initial_output_offset * element_bytes) {
+      initial_output_offset += input_axis_pitch;
+      continue;
+    }
+
     int64_t cur_out_offset = 0;
     int64_t cur_in_offset = 0;
     for (size_t idx_copy = 0, end = input_size / input_axis_pitch; idx_copy < end; ++idx_copy) {
@@ -4,6 +4,12 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace onnxruntime {
 
@@ -40,15 +46,41 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+namespace {
+
+// smallest number of bytes copied by a task
+constexpr int64_t kMinGatherBytesPerTask = 32768;
+
+// number of slices ahead of the current one whose source is prefetched, and the most bytes of
+// each of those slices that are prefetched
+constexpr int64_t kGatherPrefetchDistance = 8;
+constexpr int64_t kGatherPrefetchMaxBytes = 1024;
+
+inline void PrefetchSlice(const uint8_t* src, int64_t bytes) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    _mm_prefetch(reinterpret_cast<const char*>(src + offset), _MM_HINT_T0);
+  }
+#elif defined(__GNUC__)
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    __builtin_prefetch(src + offset);
+  }
+#else
+  ORT_UNUSED_PARAMETER(src);
+  ORT_UNUSED_PARAMETER(bytes);
+#endif
+}
+
+}  // namespace
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
                       const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const TensorShape& input_data_shape, const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
-  // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // Check the indices first in case there's a out of bound index, so the copies below can't fail.
   for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
     if (idx < 0 || idx >= input_data_shape[axis]) {
@@ -57,25 +89,49 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
+  auto copy_range = [&](int64_t first, int64_t last) {
     if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+      for (int64_t index = first; index < last; ++index) {
+        int64_t batch = index / N;
+        int64_t i = index % N;
+        const int64_t src_offset = batch * data_batch_bytes + indices_data[i] * block_size;
+        const int64_t dst_offset = batch * gathered_batch_bytes + i * block_size;
+        reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
+            reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+      }
+    } else if (M == 1) {
+      // Embedding lookup: whole rows of a table gathered along axis 0. The rows are usually scattered
+      // over a table much larger than the caches, so the source rows a few indices ahead are prefetched.
+      const int64_t prefetch_bytes = std::min(block_size, kGatherPrefetchMaxBytes);
+      for (int64_t i = first; i < last; ++i) {
+        if (i + kGatherPrefetchDistance < last) {
+          PrefetchSlice(src_base + indices_data[i + kGatherPrefetchDistance] * block_size, prefetch_bytes);
+        }
+        memcpy(dst_base + i * block_size, src_base + indices_data[i] * block_size, block_size);
+      }
     } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+      for (int64_t index = first; index < last; ++index) {
+        int64_t batch = index / N;
+        int64_t i = index % N;
+        const int64_t src_offset = batch * data_batch_bytes + indices_data[i] * block_size;
+        const int64_t dst_offset = batch * gathered_batch_bytes + i * block_size;
+        memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+      }
     }
+  };
+
+  const int64_t total = M * N;
+  int64_t num_tasks = total * block_size / kMinGatherBytesPerTask;
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    copy_range(0, total);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      copy_range(total * task / num_tasks, total * (task + 1) / num_tasks);
+    });
   }
 
   return Status::OK();
@@ -100,14 +156,18 @@ Status Gather::Compute(OpKernelContext* context) const {
   const auto* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
     return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
   if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
     return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
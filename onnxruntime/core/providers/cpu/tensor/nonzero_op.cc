@@ -3,10 +3,14 @@
 
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <numeric>
 #include <vector>
 
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -40,68 +44,94 @@ NONZERO_TYPED_KERNEL(float)
 #undef NONZERO_TYPED_KERNEL_WITH_TYPE_NAME
 #undef NONZERO_TYPED_KERNEL
 
+namespace {
+constexpr int64_t kMinNonZeroElementsPerTask = 16384;
+}  // namespace
+
 template <typename T>
 Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto X = context->Input<Tensor>(0);
   ORT_ENFORCE(X, "X input is required!");
 
-  const auto X_shape = X->Shape();
+  const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : X_shape.NumDimensions();
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(X_shape.Size() * coordinate_size);
-
+  const int64_t coordinate_size = X_shape.IsScalar() ? 1 : static_cast<int64_t>(X_shape.NumDimensions());
+  const int64_t size = X_shape.Size();
   const T* data = X->Data<T>();
 
-  if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
+  // The output size depends on the data, so the input is split into chunks and found in two passes: the first
+  // counts the non-zero values of each chunk, and the second writes the coordinates of each chunk at the offset
+  // the counts of the chunks before it sum to.
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_chunks = 1;
+  if (tp != nullptr) {
+    num_chunks = std::max<int64_t>(std::min(size / kMinNonZeroElementsPerTask,
+                                            static_cast<int64_t>(tp->NumThreads()) + 1),
+                                   1);
+  }
+
+  auto for_each_chunk = [tp, num_chunks](const std::function<void(int64_t)>& fn) {
+    if (num_chunks <= 1) {
+      fn(0);
+    } else {
+      tp->ParallelFor(static_cast<int32_t>(num_chunks), [&fn](int32_t chunk) { fn(chunk); });
     }
-  } else {
-    std::vector<int64_t> coordinate(coordinate_size, 0);
+  };
 
-    // as we iterate the entries, increment the coordinate for the current entry
-    // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (int64_t idx = coordinate_size - 1; idx >= 0; --idx) {
-        int64_t& cur_coord = coordinate[idx];
-        if (cur_coord != X_shape[idx] - 1) {
-          ++cur_coord;
-          break;
-        }
-        cur_coord = 0;
-      }
-    };
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  for_each_chunk([&](int64_t chunk) {
+    const T* first = data + size * chunk / num_chunks;
+    const T* last = data + size * (chunk + 1) / num_chunks;
+    chunk_offsets[chunk + 1] = std::count_if(first, last, [](const T& value) { return value != T{}; });
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  const int64_t num_non_zero_values = chunk_offsets[num_chunks];
 
-    for (size_t i = 0, end = X_shape.Size(); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
-      }
+  Tensor* const Y = context->Output(0, TensorShape{coordinate_size, num_non_zero_values});
+  ORT_ENFORCE(Y, "failed to get first output!");
+  if (num_non_zero_values == 0) {
+    return Status::OK();
+  }
 
-      increment_coordinate();
-    }
+  // the output is [rank, count], so the coordinate on an axis of the k-th non-zero value is at axis * count + k
+  int64_t* y_data = Y->MutableData<int64_t>();
+  if (X_shape.IsScalar()) {
+    y_data[0] = 0;
+    return Status::OK();
   }
 
-  const Eigen::Index num_non_zero_values = non_zero_indices_buffer.size() / coordinate_size;
+  for_each_chunk([&](int64_t chunk) {
+    const int64_t first = size * chunk / num_chunks;
+    const int64_t last = size * (chunk + 1) / num_chunks;
 
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
+    // decompose the first index of the chunk into its coordinate once, then increment the coordinate along
+    // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
+    std::vector<int64_t> coordinate(coordinate_size, 0);
+    int64_t remainder = first;
+    for (int64_t axis = coordinate_size - 1; axis >= 0; --axis) {
+      coordinate[axis] = remainder % X_shape[axis];
+      remainder /= X_shape[axis];
+    }
 
-  Tensor* const Y = context->Output(0, TensorShape{coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
+    int64_t* y = y_data + chunk_offsets[chunk];
+    for (int64_t i = first; i < last; ++i) {
+      if (data[i] != T{}) {
+        for (int64_t axis = 0; axis < coordinate_size; ++axis) {
+          y[axis * num_non_zero_values] = coordinate[axis];
+        }
+        ++y;
+      }
 
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+      for (int64_t axis = coordinate_size - 1; axis >= 0; --axis) {
+        if (++coordinate[axis] < X_shape[axis]) {
+          break;
+        }
+        coordinate[axis] = 0;
+      }
+    }
+  });
 
   return Status::OK();
-}  // namespace onnxruntime
+}
 }  // namespace onnxruntime
@@ -8,25 +8,30 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/providers/cpu/tensor/pad.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 
+namespace {
+constexpr int64_t kMinPadBytesPerTask = 32768;
+}  // namespace
+
 ONNX_CPU_OPERATOR_KERNEL(
     Pad,
     2,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Pad<float>);
 
-// This is the general padding method to n-dimensionally do edge or reflection padding (based on the inputDelta values)
+// This is the general padding method to n-dimensionally do edge or reflection padding of the outer axes. Each block of
+// block_size values is copied from input, which then moves by input_pitch past the end of the block it was copied from.
 template <typename T>
-static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
+static void PadAxis(T* output, T* input, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
   for (size_t block_index = 0; block_index < block_count; block_index++) {
-    for (size_t i = 0; i < block_size; i++) {
-      *output++ = *input;
-      input += input_delta;
-    }
-    input += input_pitch;
+    std::copy(input, input + block_size, output);
+    output += block_size;
+    input += block_size + input_pitch;
   }
 }
 
@@ -40,13 +45,6 @@ static void PadInnermostAxis(T* output, T* input, ptrdiff_t input_delta, size_t
   }
 }
 
-// For constant padding, there is no input, just a size to write the constant to
-template <typename T>
-static void PadAxisConstant(T* output, T constant, size_t size) {
-  for (size_t i = 0; i < size; i++)
-    *output++ = constant;
-}
-
 // Flatten no padding inner most Axis, so one memcpy cover multiple Axis.
 // For example, for a shape of [1,224,224,3] with padding [0,3,3,0,0,3,3,0], can be flatten as
 // [1,224,224*3] with padding [0,3,3*3,0,3,3*3].
@@ -87,58 +85,14 @@ static void ReshapePads(const std::vector<int64_t>& src_pad, size_t src_dim_coun
   reshaped_pad[inner_axis + new_dim_count] = src_pad[inner_axis + src_dim_count] * inner_no_pad_size;
 }
 
-template <>
-Status PadCpuImpl<float>(OpKernelContext* ctx,
-                         const std::vector<int64_t>& pads,
-                         const std::vector<int64_t>& slices,
-                         const Mode& mode,
-                         float value) {
-  auto& input_tensor = *ctx->Input<Tensor>(0);
-  std::vector<int64_t> output_dims(input_tensor.Shape().GetDims());
-  size_t dimension_count = output_dims.size();
-
-  // make copy of raw_pads as it may be mutated below
-  ORT_ENFORCE(dimension_count > 0, "Input tensor has no dimensions");
-  ORT_ENFORCE(dimension_count * 2 == pads.size(), "'pads' has wrong number of values");
-
-  // Reshape input dims
-  std::vector<int64_t> reshaped_input_dims;
-  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
-
-  // Reshape padding
-  size_t new_dims_count = reshaped_input_dims.size();
+// Copies the input walked by input over input_extents to the output, and writes the padding of reshaped_pad around it.
+// output is the start of the region of the output the padding and the copies are written to.
+template <typename T>
+static void PadRegion(T* output, SliceIterator<T>& input, const std::vector<int64_t>& input_extents,
+                      const std::vector<int64_t>& reshaped_pad, const TensorPitches& output_pitches,
+                      const Mode& mode, T value) {
+  size_t new_dims_count = input_extents.size();
   size_t inner_axis = new_dims_count - 1;
-  size_t inner_no_pad_size = reshaped_input_dims[inner_axis] / output_dims[inner_axis];
-  std::vector<int64_t> reshaped_pad(2 * new_dims_count), reshaped_slice(2 * new_dims_count);
-  ReshapePads(pads, dimension_count, new_dims_count, inner_no_pad_size, reshaped_pad);
-  ReshapePads(slices, dimension_count, new_dims_count, inner_no_pad_size, reshaped_slice);
-
-  std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
-  std::vector<int64_t> input_starts;
-  std::vector<int64_t> input_extents;
-
-  // Calculate output dimensions, and handle any negative padding
-  input_starts.reserve(2 * new_dims_count);
-  input_extents.reserve(2 * new_dims_count);
-  for (size_t i = 0; i < new_dims_count; i++) {
-    input_starts.push_back(reshaped_slice[i]);
-    input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
-    reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
-  }
-
-  for (size_t i = 0; i < dimension_count; i++) {
-    output_dims[i] += pads[i] + pads[i + dimension_count] + slices[i] + slices[i + dimension_count];
-  }
-  TensorShape output_shape(output_dims);
-
-  TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<float> input(input_tensor, input_shape, input_starts, input_extents, {});
-
-  // output_shape need to keep original.
-  auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = output_tensor.template MutableData<float>();
-
-  TensorPitches output_pitches(reshaped_output_dims);
   size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
 
   // Initial skip, sum up the begin padding on each axis
@@ -155,24 +109,24 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
       while (input_counters) {
         output += alignSkip;
         {
-          float* axisStart = output;
+          T* axisStart = output;
           output = input.CopyInnermostAxisSolitaryInnerStep(output);
 
           int64_t prePad = reshaped_pad[inner_axis];
           int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
+          std::fill_n(axisStart - prePad, prePad, value);
+          std::fill_n(output, postPad, value);
           output += postPad;
           alignSkip = prePad;
         }
         // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
+          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
           int64_t prePad = reshaped_pad[input_counters.Axis()];
           int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
+          std::fill_n(axisStart - prePad * inner_pitch, prePad * inner_pitch, value);
+          std::fill_n(output, postPad * inner_pitch, value);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
@@ -186,24 +140,24 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
       while (input_counters) {
         output += alignSkip;
         {
-          float* axisStart = output;
+          T* axisStart = output;
           output = input.CopyInnermostAxisSolitaryInnerStep(output);
 
           int64_t prePad = reshaped_pad[inner_axis];
           int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, *axisStart, prePad);
-          PadAxisConstant(output, *(output - 1), postPad);
+          std::fill_n(axisStart - prePad, prePad, *axisStart);
+          std::fill_n(output, postPad, *(output - 1));
           output += postPad;
           alignSkip = prePad;
         }
         // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
+          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
           int64_t prePad = reshaped_pad[input_counters.Axis()];
           int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
+          PadAxis(axisStart - prePad * inner_pitch, axisStart, -inner_pitch, inner_pitch, prePad);
+          PadAxis(output, output - inner_pitch, -inner_pitch, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
@@ -217,7 +171,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
       while (input_counters) {
         output += alignSkip;
         {
-          float* axisStart = output;
+          T* axisStart = output;
           output = input.CopyInnermostAxisSolitaryInnerStep(output);
 
           int64_t prePad = reshaped_pad[inner_axis];
@@ -230,17 +184,133 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
         // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
         while (input_counters.Increment()) {
           ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
+          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
           int64_t prePad = reshaped_pad[input_counters.Axis()];
           int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2, inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
+          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, -inner_pitch * 2, inner_pitch, prePad);
+          PadAxis(output, output - 2 * inner_pitch, -inner_pitch * 2, inner_pitch, postPad);
           output += inner_pitch * postPad;
           alignSkip += inner_pitch * prePad;
         }
       }
       break;
   }
+}
+
+// Writes the padding of the outermost axis around the rows of the output already written, each row output_pitch values.
+// Edge and reflect padding copy whole rows.
+template <typename T>
+static void PadOutermostAxis(T* output, int64_t output_pitch, int64_t extent, int64_t pre_pad, int64_t post_pad,
+                             const Mode& mode, T value) {
+  T* first_row = output + pre_pad * output_pitch;
+  T* end = first_row + extent * output_pitch;
+  switch (mode) {
+    case Mode::Constant:
+      std::fill_n(output, pre_pad * output_pitch, value);
+      std::fill_n(end, post_pad * output_pitch, value);
+      break;
+
+    case Mode::Edge:
+      PadAxis(output, first_row, -output_pitch, output_pitch, pre_pad);
+      PadAxis(end, end - output_pitch, -output_pitch, output_pitch, post_pad);
+      break;
+
+    case Mode::Reflect:
+      PadAxis(output, first_row + pre_pad * output_pitch, -output_pitch * 2, output_pitch, pre_pad);
+      PadAxis(end, end - 2 * output_pitch, -output_pitch * 2, output_pitch, post_pad);
+      break;
+  }
+}
+
+template <>
+Status PadCpuImpl<float>(OpKernelContext* ctx,
+                         const std::vector<int64_t>& pads,
+                         const std::vector<int64_t>& slices,
+                         const Mode& mode,
+                         float value) {
+  auto& input_tensor = *ctx->Input<Tensor>(0);
+  std::vector<int64_t> output_dims(input_tensor.Shape().GetDims());
+  size_t dimension_count = output_dims.size();
+
+  // make copy of raw_pads as it may be mutated below
+  ORT_ENFORCE(dimension_count > 0, "Input tensor has no dimensions");
+  ORT_ENFORCE(dimension_count * 2 == pads.size(), "'pads' has wrong number of values");
+
+  // Reshape input dims
+  std::vector<int64_t> reshaped_input_dims;
+  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
+
+  // Reshape padding
+  size_t new_dims_count = reshaped_input_dims.size();
+  size_t inner_axis = new_dims_count - 1;
+  size_t inner_no_pad_size = reshaped_input_dims[inner_axis] / output_dims[inner_axis];
+  std::vector<int64_t> reshaped_pad(2 * new_dims_count), reshaped_slice(2 * new_dims_count);
+  ReshapePads(pads, dimension_count, new_dims_count, inner_no_pad_size, reshaped_pad);
+  ReshapePads(slices, dimension_count, new_dims_count, inner_no_pad_size, reshaped_slice);
+
+  std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
+  std::vector<int64_t> input_starts;
+  std::vector<int64_t> input_extents;
+
+  // Calculate output dimensions, and handle any negative padding
+  input_starts.reserve(2 * new_dims_count);
+  input_extents.reserve(2 * new_dims_count);
+  for (size_t i = 0; i < new_dims_count; i++) {
+    input_starts.push_back(reshaped_slice[i]);
+    input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
+    reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
+  }
+
+  for (size_t i = 0; i < dimension_count; i++) {
+    output_dims[i] += pads[i] + pads[i + dimension_count] + slices[i] + slices[i + dimension_count];
+  }
+  TensorShape output_shape(output_dims);
+
+  TensorShape input_shape(reshaped_input_dims);
+
+  // output_shape need to keep original.
+  auto& output_tensor = *ctx->Output(0, output_shape);
+  auto* output = output_tensor.template MutableData<float>();
+
+  TensorPitches output_pitches(reshaped_output_dims);
+
+  if (new_dims_count == 1 || input_extents[0] == 0) {
+    SliceIterator<float> input(input_tensor, input_shape, input_starts, input_extents, {});
+    PadRegion(output, input, input_extents, reshaped_pad, output_pitches, mode, value);
+    return Status::OK();
+  }
+
+  // The rows of the outermost axis are padded independently, so ranges of them are split across the threads, each
+  // walking its own slice of the input. The padding of the outermost axis is written after the rows it copies.
+  std::vector<int64_t> inner_pad(reshaped_pad);
+  inner_pad[0] = 0;
+  inner_pad[new_dims_count] = 0;
+  const int64_t extent = input_extents[0];
+  auto pad_rows = [&](int64_t first, int64_t last) {
+    std::vector<int64_t> starts(input_starts);
+    std::vector<int64_t> extents(input_extents);
+    starts[0] += first;
+    extents[0] = last - first;
+    SliceIterator<float> input(input_tensor, input_shape, starts, extents, {});
+    PadRegion(output + (reshaped_pad[0] + first) * output_pitches[0], input, extents, inner_pad, output_pitches,
+              mode, value);
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(extent, output_shape.Size() * static_cast<int64_t>(sizeof(float)) / kMinPadBytesPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    pad_rows(0, extent);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [extent, num_tasks, &pad_rows](int32_t task) {
+      pad_rows(extent * task / num_tasks, extent * (task + 1) / num_tasks);
+    });
+  }
+
+  PadOutermostAxis(output, output_pitches[0], extent, reshaped_pad[0], reshaped_pad[new_dims_count], mode, value);
 
   return Status::OK();
 }
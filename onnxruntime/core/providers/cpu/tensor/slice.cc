@@ -15,7 +15,10 @@ namespace onnxruntime {
       Slice,                                                                            \
       1, 9,                                                                             \
       data_type,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()), \
+      KernelDefBuilder()                                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())                \
+          .MayView(0, 0)                                                                \
+          .AcceptStridedInput(0),                                                       \
       Slice<data_type, false>);
 
 ADD_TYPED_SLICE_V9_OP(uint8_t);
@@ -39,7 +42,9 @@ ADD_TYPED_SLICE_V9_OP(string);
       data_type,                                                                            \
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())      \
                         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),    \
-                                                 DataTypeImpl::GetTensorType<int64_t>()}),  \
+                                                 DataTypeImpl::GetTensorType<int64_t>()})   \
+                        .MayView(0, 0)                                                      \
+                        .AcceptStridedInput(0),                                             \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V10_OP(uint8_t);
@@ -249,12 +254,32 @@ Status SliceImpl(OpKernelContext* ctx,
                  const std::vector<int64_t>& starts,
                  const std::vector<int64_t>& steps) {
   TensorShape output_shape(output_dims);
+
+  // the slice starts at the element of the starts and steps through the input with its strides multiplied
+  const auto input_strides = input_tensor.Strides();
+  std::vector<int64_t> output_strides(input_strides.size());
+  int64_t byte_offset = input_tensor.ByteOffset();
+  for (size_t i = 0; i < input_strides.size(); ++i) {
+    byte_offset += starts[i] * input_strides[i] * static_cast<int64_t>(sizeof(T));
+    output_strides[i] = input_strides[i] * steps[i];
+  }
+  if (ctx->OutputView(0, input_tensor, output_shape, output_strides, byte_offset) != nullptr)
+    return Status::OK();
+
   auto& output_tensor = *ctx->Output(0, output_shape);
 
   // output tensor's size is 0, nothing to fill - return
   if (output_shape.Size() == 0)
     return Status::OK();
 
+  if (!input_tensor.IsContiguous()) {
+    Tensor input_slice(input_tensor.DataType(), output_shape, const_cast<void*>(input_tensor.DataRaw()),
+                       input_tensor.Location(), byte_offset);
+    input_slice.SetStrides(output_strides);
+    CopyToContiguous(input_slice, output_tensor);
+    return Status::OK();
+  }
+
   auto* output = output_tensor.template MutableData<T>();
   const auto* output_end = output + output_tensor.Shape().Size();
 
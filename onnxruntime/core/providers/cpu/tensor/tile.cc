@@ -1,21 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-// there's no way to use a raw pointer as the copy destination with std::copy_n
-// (which gsl::copy uses with span::data() which returns a raw pointer) with the 14.11 toolset
-// without generating a 4996 warning. going through an iterator is way too much overhead so turn off the warning.
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#endif
-
-#include "gsl/gsl_algorithm"
 #include "core/providers/cpu/tensor/tile.h"
-#include "core/providers/cpu/tensor/utils.h"
-
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/broadcast_copy.h"
 
 using namespace ::onnxruntime::common;
 
@@ -38,49 +26,6 @@ ONNX_CPU_OPERATOR_KERNEL(
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
-Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
-  const auto& input_shape = input_tensor.Shape().GetDims();
-  const size_t dimension_count = input_shape.size();
-
-  const auto* input = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
-  auto* output = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
-
-  // some helper variables that will be used along the way
-  size_t block_size = 0;
-  int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
-  const int64_t innermost_dim = input_shape[dimension_count - 1];
-
-  while (input_counters) {
-    // Copy the input data over
-    block_size = innermost_dim * element_size;
-    memcpy(output, input, block_size);
-    output += block_size;
-    input += block_size;
-
-    // Tile data for the innermost axis
-    copy = output - block_size;
-    num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
-    }
-
-    // Tile data for other axes
-    while (input_counters.Increment()) {
-      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()];
-      block_size = pitch * element_size;
-      copy = output - block_size;
-      num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
-    }
-  }
-  return Status::OK();
-}
-
 Status Tile::Compute(OpKernelContext* ctx) const {
   const auto* tensor_pointer = ctx->Input<Tensor>(0);
   if (tensor_pointer == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "Input count of Tile OP mismatch, the first one is empty");
@@ -114,34 +59,22 @@ Status Tile::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  const auto& dtype = input_tensor.DataType();
-  TensorAxisCounters input_counters(input_tensor);
-  TensorPitches output_pitches(output_tensor);
-
-  static_assert(sizeof(float) == sizeof(int32_t), "Float and Int32 are of different sizes");
-  static_assert(sizeof(double) == sizeof(int64_t), "Double and Int64 are of different sizes");
-
-  if (dtype == DataTypeImpl::GetType<float>() ||
-      dtype == DataTypeImpl::GetType<int32_t>() ||
-      dtype == DataTypeImpl::GetType<uint32_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(float));
-
-  if (dtype == DataTypeImpl::GetType<double>() || dtype == DataTypeImpl::GetType<int64_t>() ||
-      dtype == DataTypeImpl::GetType<uint64_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(double));
-
-  else if (dtype == DataTypeImpl::GetType<int8_t>() ||
-           dtype == DataTypeImpl::GetType<uint8_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int8_t));
-
-  if (dtype == DataTypeImpl::GetType<int16_t>() || dtype == DataTypeImpl::GetType<uint16_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int16_t));
-
-  else if (dtype == DataTypeImpl::GetType<bool>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(bool));
+  // Tile is a broadcast copy of the input viewed as [1, d0, 1, d1, ...] to [r0, d0, r1, d1, ...], where each repeat
+  // axis has a stride of 0, and the contiguous runs are copied and repeated by BroadcastCopy.
+  const auto& input_dims = input_shape.GetDims();
+  std::vector<int64_t> tiled_dims(2 * input_rank);
+  std::vector<int64_t> tiled_strides(2 * input_rank);
+  int64_t pitch = 1;
+  for (size_t axis = input_rank; axis-- > 0;) {
+    tiled_dims[2 * axis] = repeats[axis];
+    tiled_dims[2 * axis + 1] = input_dims[axis];
+    tiled_strides[2 * axis] = 0;
+    tiled_strides[2 * axis + 1] = pitch;
+    pitch *= input_dims[axis];
+  }
 
-  // TODO: Support 'string' and 'float16' types for completeness
-  else
-    ORT_THROW("Tile doesn't have an implementation yet for the type: ", dtype);
+  BroadcastCopy(input_tensor.DataRaw(), output_tensor.MutableDataRaw(), input_tensor.DataType()->Size(),
+                tiled_dims, tiled_strides, static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool());
+  return Status::OK();
 }
 }  // namespace onnxruntime
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/transpose.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -175,7 +177,183 @@ static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& tar
   }
 }
 
-static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+// A permutation that swaps two adjacent axes, once the axes of size 1 are dropped and the input axes that stay
+// adjacent and in order in the output are merged. This covers NCHW <-> NHWC and swapping the last two axes:
+// the input is viewed as [batch, rows, cols, inner] and the output as [batch, cols, rows, inner].
+struct SingleSwapTranspose {
+  size_t batch;
+  size_t rows;
+  size_t cols;
+  size_t inner;
+};
+
+static bool IsSingleSwapTranspose(const std::vector<size_t>& permutations, const std::vector<int64_t>& input_dims,
+                                  SingleSwapTranspose& shape) {
+  const size_t rank = input_dims.size();
+
+  // renumber the input axes without the axes of size 1
+  std::vector<size_t> new_axis(rank);
+  std::vector<size_t> dims;
+  for (size_t i = 0; i < rank; ++i) {
+    new_axis[i] = dims.size();
+    if (input_dims[i] != 1) {
+      dims.push_back(static_cast<size_t>(input_dims[i]));
+    }
+  }
+
+  // the first input axis of each group of merged axes, in output order
+  std::vector<size_t> group_first;
+  std::vector<size_t> group_last;
+  for (size_t i = 0; i < rank; ++i) {
+    const size_t axis = permutations[i];
+    if (input_dims[axis] == 1) {
+      continue;
+    }
+    if (!group_last.empty() && new_axis[axis] == group_last.back() + 1) {
+      group_last.back() = new_axis[axis];
+    } else {
+      group_first.push_back(new_axis[axis]);
+      group_last.push_back(new_axis[axis]);
+    }
+  }
+
+  // the output order of the groups must be their input order with a single pair of adjacent groups swapped
+  std::vector<size_t> input_order(group_first);
+  std::sort(input_order.begin(), input_order.end());
+  size_t swap = input_order.size();
+  for (size_t i = 0; i < input_order.size(); ++i) {
+    if (group_first[i] == input_order[i]) {
+      continue;
+    }
+    if (swap != input_order.size() || i + 1 == input_order.size() ||
+        group_first[i] != input_order[i + 1] || group_first[i + 1] != input_order[i]) {
+      return false;
+    }
+    swap = i++;
+  }
+
+  if (swap == input_order.size()) {
+    // the permutation doesn't move any data
+    shape.batch = 1;
+    shape.rows = 1;
+    shape.cols = 1;
+    shape.inner = 1;
+    for (size_t dim : dims) {
+      shape.inner *= dim;
+    }
+    return true;
+  }
+
+  auto product = [&dims](size_t first, size_t last) {
+    size_t size = 1;
+    for (size_t i = first; i < last; ++i) {
+      size *= dims[i];
+    }
+    return size;
+  };
+  // group_first[swap + 1] is the first axis of the rows and group_first[swap] the first axis of the cols
+  shape.batch = product(0, group_first[swap + 1]);
+  shape.rows = product(group_first[swap + 1], group_first[swap]);
+  shape.cols = product(group_first[swap], swap + 2 < group_first.size() ? group_first[swap + 2] : dims.size());
+  shape.inner = product(swap + 2 < group_first.size() ? group_first[swap + 2] : dims.size(), dims.size());
+  return true;
+}
+
+// smallest number of bytes copied by a task
+constexpr size_t kMinTransposeBytesPerTask = 32768;
+
+// Transposes the M x N matrix A into the N x M matrix B in tiles that fit in the cache.
+template <typename T>
+static void TransposeTiled(size_t M, size_t N, const T* A, size_t lda, T* B, size_t ldb) {
+  constexpr size_t kTileSize = 16;
+  for (size_t m0 = 0; m0 < M; m0 += kTileSize) {
+    const size_t m1 = std::min(M, m0 + kTileSize);
+    for (size_t n0 = 0; n0 < N; n0 += kTileSize) {
+      const size_t n1 = std::min(N, n0 + kTileSize);
+      for (size_t n = n0; n < n1; ++n) {
+        for (size_t m = m0; m < m1; ++m) {
+          B[n * ldb + m] = A[m * lda + n];
+        }
+      }
+    }
+  }
+}
+
+static void DoSingleSwapTranspose(const SingleSwapTranspose& shape, const Tensor& input, Tensor& output,
+                                  concurrency::ThreadPool* tp) {
+  const auto* input_data = reinterpret_cast<const uint8_t*>(input.DataRaw());
+  auto* output_data = reinterpret_cast<uint8_t*>(output.MutableDataRaw());
+  const size_t element_size = input.DataType()->Size();
+  const bool is_float = input.DataType() == DataTypeImpl::GetType<float>();
+  const size_t inner_bytes = shape.inner * element_size;
+  const size_t matrix_bytes = shape.rows * shape.cols * inner_bytes;
+
+  // transposes the cols [col_begin, col_end) of the matrix of a batch, which are rows of the output
+  auto transpose_cols = [&shape, is_float, element_size, inner_bytes](const uint8_t* source, uint8_t* target,
+                                                                      size_t col_begin, size_t col_end) {
+    const size_t M = shape.rows;
+    const size_t N = col_end - col_begin;
+    source += col_begin * inner_bytes;
+    target += col_begin * M * inner_bytes;
+    if (shape.inner != 1) {
+      for (size_t n = 0; n < N; ++n) {
+        for (size_t m = 0; m < M; ++m) {
+          memcpy(target + (n * M + m) * inner_bytes, source + (m * shape.cols + n) * inner_bytes, inner_bytes);
+        }
+      }
+    } else if (is_float) {
+      MlasTranspose(M, N, reinterpret_cast<const float*>(source), shape.cols, reinterpret_cast<float*>(target), M);
+    } else {
+      switch (element_size) {
+        case sizeof(uint64_t):
+          TransposeTiled(M, N, reinterpret_cast<const uint64_t*>(source), shape.cols,
+                         reinterpret_cast<uint64_t*>(target), M);
+          break;
+        case sizeof(uint32_t):
+          TransposeTiled(M, N, reinterpret_cast<const uint32_t*>(source), shape.cols,
+                         reinterpret_cast<uint32_t*>(target), M);
+          break;
+        case sizeof(uint16_t):
+          TransposeTiled(M, N, reinterpret_cast<const uint16_t*>(source), shape.cols,
+                         reinterpret_cast<uint16_t*>(target), M);
+          break;
+        case sizeof(uint8_t):
+          TransposeTiled(M, N, source, shape.cols, target, M);
+          break;
+        default:
+          assert(false);
+      }
+    }
+  };
+
+  // transposes the output rows [first, last) of all the batches
+  auto transpose_range = [&](size_t first, size_t last) {
+    while (first < last) {
+      const size_t batch = first / shape.cols;
+      const size_t col_begin = first - batch * shape.cols;
+      const size_t col_end = std::min(shape.cols, col_begin + (last - first));
+      transpose_cols(input_data + batch * matrix_bytes, output_data + batch * matrix_bytes, col_begin, col_end);
+      first += col_end - col_begin;
+    }
+  };
+
+  const size_t num_output_rows = shape.batch * shape.cols;
+  size_t num_tasks = std::min(num_output_rows, shape.batch * matrix_bytes / kMinTransposeBytesPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<size_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    transpose_range(0, num_output_rows);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [num_output_rows, num_tasks, &transpose_range](int32_t task) {
+      transpose_range(num_output_rows * task / num_tasks, num_output_rows * (task + 1) / num_tasks);
+    });
+  }
+}
+
+static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                 concurrency::ThreadPool* tp) {
   const auto& input_shape = input.Shape();
   const auto& input_dims = input_shape.GetDims();
   auto rank = input_shape.NumDimensions();
@@ -183,6 +361,12 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
   const auto element_size = input.DataType()->Size();
   const bool is_string_type = input.DataType() == DataTypeImpl::GetType<std::string>();
 
+  SingleSwapTranspose single_swap;
+  if (!is_string_type && input_shape.Size() > 0 && IsSingleSwapTranspose(permutations, input_dims, single_swap)) {
+    DoSingleSwapTranspose(single_swap, input, output, tp);
+    return Status::OK();
+  }
+
   std::vector<size_t> stride(rank);
   for (size_t i = 0; i < rank; i++) {
     size_t inpdim = permutations[i];
@@ -239,7 +423,8 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
   return Status::OK();
 }
 
-Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                  concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -249,7 +434,7 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
   } else {
-    status = DoUntypedTranspose(permutations, input, output);
+    status = DoUntypedTranspose(permutations, input, output, tp);
   }
 
   return status;
@@ -272,17 +457,32 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     return status;
 
   TensorShape output_shape{output_dims};
-  Tensor& Y = *ctx->Output(0, output_shape);
 
-  DoUntypedTranspose(*p_perm, X, Y);
+  // the transpose of X is X read with its strides permuted
+  const auto input_strides = X.Strides();
+  std::vector<int64_t> output_strides(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    output_strides[i] = input_strides[(*p_perm)[i]];
+  }
+  if (ctx->OutputView(0, X, output_shape, output_strides, X.ByteOffset()) != nullptr) {
+    return Status::OK();
+  }
 
-  return Status::OK();
+  Tensor& Y = *ctx->Output(0, output_shape);
+  if (!X.IsContiguous()) {
+    Tensor X_transposed(X.DataType(), output_shape, const_cast<void*>(X.DataRaw()), X.Location(), X.ByteOffset());
+    X_transposed.SetStrides(output_strides);
+    CopyToContiguous(X_transposed, Y);
+    return Status::OK();
+  }
+
+  return DoUntypedTranspose(*p_perm, X, Y, static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool());
 }
 
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()).MayView(0, 0).AcceptStridedInput(0),
     Transpose);
 
 }  // namespace onnxruntime
@@ -9,14 +9,19 @@
 #include <sstream>
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 class TransposeBase {
  public:
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
   Both Tensors must have the same data type. 
+  If tp is not null, large transposes are split across its threads.
   */
-  static Status DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output);
+  static Status DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                            concurrency::ThreadPool* tp = nullptr);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
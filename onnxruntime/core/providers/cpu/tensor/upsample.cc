@@ -4,6 +4,9 @@
 #include "core/providers/cpu/tensor/upsample.h"
 #include <cmath>
 #include <sstream>
+#include <type_traits>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 using namespace std;
@@ -30,6 +33,69 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
     Upsample<uint8_t>);
 
+// smallest number of output elements computed by a task
+constexpr int64_t kMinUpsampleElementsPerTask = 16384;
+
+// Calls compute_rows(first, last) over [0, num_rows) output rows of row_size elements,
+// splitting the rows across the thread pool when there is enough work.
+template <typename F>
+void ParallelForRows(concurrency::ThreadPool* tp, int64_t num_rows, int64_t row_size, F&& compute_rows) {
+  int64_t num_tasks = std::min(num_rows, num_rows * row_size / kMinUpsampleElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    compute_rows(int64_t{0}, num_rows);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [&](int32_t task) {
+      compute_rows(num_rows * task / num_tasks, num_rows * (task + 1) / num_tasks);
+    });
+  }
+}
+
+// Maps each output coordinate along one axis to the input coordinate nearest mode reads.
+static std::vector<int64_t> NearestInputIndices(int64_t output_dim, int64_t input_dim, float scale) {
+  std::vector<int64_t> indices(output_dim);
+  for (int64_t o = 0; o < output_dim; ++o) {
+    auto i = static_cast<int64_t>(scale < 1 ? std::ceil(o / scale) : o / scale);
+    indices[o] = std::min(i, input_dim - 1);
+  }
+  return indices;
+}
+
+// 4-D nearest mode with the input coordinate of every output coordinate looked up once per axis,
+// so each output row is a gather from a single input row.
+template <typename T>
+void UpsampleNearest4D(const T* input,
+                       T* output,
+                       const TensorShape& input_shape,
+                       const TensorShape& output_shape,
+                       const vector<float>& scales,
+                       concurrency::ThreadPool* tp) {
+  const std::vector<int64_t> in_n = NearestInputIndices(output_shape[0], input_shape[0], scales[0]);
+  const std::vector<int64_t> in_c = NearestInputIndices(output_shape[1], input_shape[1], scales[1]);
+  const std::vector<int64_t> in_y = NearestInputIndices(output_shape[2], input_shape[2], scales[2]);
+  const std::vector<int64_t> in_x = NearestInputIndices(output_shape[3], input_shape[3], scales[3]);
+  const int64_t output_channels = output_shape[1];
+  const int64_t output_height = output_shape[2];
+  const int64_t output_width = output_shape[3];
+
+  ParallelForRows(tp, output_shape.SizeToDimension(3), output_width, [&](int64_t first_row, int64_t last_row) {
+    for (int64_t row = first_row; row < last_row; ++row) {
+      const int64_t plane = row / output_height;
+      const int64_t n = plane / output_channels;
+      const int64_t c = plane % output_channels;
+      const T* input_row =
+          input + ((in_n[n] * input_shape[1] + in_c[c]) * input_shape[2] + in_y[row % output_height]) * input_shape[3];
+      T* output_row = output + row * output_width;
+      for (int64_t x = 0; x < output_width; ++x) {
+        output_row[x] = input_row[in_x[x]];
+      }
+    }
+  });
+}
+
 template <typename T>
 void UpsampleNearest2x(
     int64_t batch_size,
@@ -63,7 +129,8 @@ Status UpsampleNearest(const T* input,
                        const TensorShape& input_shape,
                        const TensorShape& output_shape,
                        const vector<float>& scales,
-                       bool is_resize) {
+                       bool is_resize,
+                       concurrency::ThreadPool* tp) {
   if (!input || !output)
     return Status(ONNXRUNTIME, FAIL, is_resize ? "Resize: input/output value is nullptr" : 
                                                  "Upsample: input/output value is nullptr");
@@ -135,19 +202,7 @@ Status UpsampleNearest(const T* input,
       UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
       return Status::OK();
     }
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDemensionProcessor(2);
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            OneDemensionProcessor(3);
-            output[output_idx++] = input[input_idx];
-          }
-        }
-      }
-    }
+    UpsampleNearest4D<T>(input, output, input_shape, output_shape, scales, tp);
     return Status::OK();
   }
 
@@ -265,7 +320,8 @@ void upsampleBilinear(
     float width_scale,
     const T* Xdata,
     T* Ydata,
-    AllocatorPtr& alloc) {
+    AllocatorPtr& alloc,
+    concurrency::ThreadPool* tp) {
   auto output_width = static_cast<int64_t>(input_width * width_scale);
   auto output_height = static_cast<int64_t>(input_height * height_scale);
 
@@ -274,8 +330,8 @@ void upsampleBilinear(
   auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
   BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
   auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = idx_data + output_height;
+  int64_t* in_y1 = idx_data;
+  int64_t* in_y2 = idx_data + output_height;
   int64_t* in_x1 = idx_data + 2 * output_height;
   int64_t* in_x2 = idx_data + 2 * output_height + output_width;
 
@@ -287,17 +343,14 @@ void upsampleBilinear(
 
   for (int64_t y = 0; y < output_height; ++y) {
     float in_y = std::min(y / height_scale, static_cast<float>(input_height - 1));
-    const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-    const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
-    if (in_y1 == in_y2) {
+    in_y1[y] = std::min(static_cast<int64_t>(in_y), input_height - 1);
+    in_y2[y] = std::min(in_y1[y] + 1, input_height - 1);
+    dy1[y] = std::fabs(in_y - in_y1[y]);
+    dy2[y] = std::fabs(in_y - in_y2[y]);
+    if (in_y1[y] == in_y2[y]) {
       dy1[y] = 0.5f;
       dy2[y] = 0.5f;
     }
-
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
   }
 
   for (int64_t x = 0; x < output_width; ++x) {
@@ -313,25 +366,67 @@ void upsampleBilinear(
     }
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
+  const int64_t num_rows = batch_size * num_channels * output_height;
+  if (!std::is_same<T, float>::value) {
+    // Integral outputs truncate the interpolated value, so they keep the four-tap formula the
+    // results have always been rounded from.
+    ParallelForRows(tp, num_rows, output_width, [&](int64_t first_row, int64_t last_row) {
+      for (int64_t output_row = first_row; output_row < last_row; ++output_row) {
+        const int64_t y = output_row % output_height;
+        const T* X = Xdata + output_row / output_height * input_height * input_width;
+        const T* X1 = X + in_y1[y] * input_width;
+        const T* X2 = X + in_y2[y] * input_width;
+        T* Y = Ydata + output_row * output_width;
         for (int64_t x = 0; x < output_width; ++x) {
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
-
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
+          Y[x] = static_cast<T>(dx2[x] * dy2[y] * X1[in_x1[x]] +
+                                dx1[x] * dy2[y] * X1[in_x2[x]] +
+                                dx2[x] * dy1[y] * X2[in_x1[x]] +
+                                dx1[x] * dy1[y] * X2[in_x2[x]]);
         }
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
-    }
+    });
+    return;
   }
+
+  // The interpolation is separable: every input row an output row needs is first interpolated
+  // horizontally, then the output row blends two of those rows with a contiguous loop the compiler
+  // vectorizes. Neighbouring output rows mostly read the same input rows, so each task keeps the
+  // last two horizontally interpolated rows and computes each input row about once.
+  ParallelForRows(tp, num_rows, output_width, [&](int64_t first_row, int64_t last_row) {
+    std::vector<float> row_buffer(2 * output_width);
+    float* rows[2] = {row_buffer.data(), row_buffer.data() + output_width};
+    // index of the input row held by each buffer, counted over all N * C planes
+    int64_t cached_rows[2] = {-1, -1};
+
+    auto horizontal_row = [&](int64_t input_row, int64_t keep_row) -> const float* {
+      for (int slot = 0; slot < 2; ++slot) {
+        if (cached_rows[slot] == input_row) {
+          return rows[slot];
+        }
+      }
+      const int slot = cached_rows[0] == keep_row ? 1 : 0;
+      const T* X = Xdata + input_row * input_width;
+      float* row = rows[slot];
+      for (int64_t x = 0; x < output_width; ++x) {
+        row[x] = dx2[x] * X[in_x1[x]] + dx1[x] * X[in_x2[x]];
+      }
+      cached_rows[slot] = input_row;
+      return row;
+    };
+
+    for (int64_t output_row = first_row; output_row < last_row; ++output_row) {
+      const int64_t y = output_row % output_height;
+      const int64_t plane_row = output_row / output_height * input_height;
+      const float* row1 = horizontal_row(plane_row + in_y1[y], plane_row + in_y2[y]);
+      const float* row2 = horizontal_row(plane_row + in_y2[y], plane_row + in_y1[y]);
+      const float w1 = dy2[y];
+      const float w2 = dy1[y];
+      T* Y = Ydata + output_row * output_width;
+      for (int64_t x = 0; x < output_width; ++x) {
+        Y[x] = static_cast<T>(w1 * row1[x] + w2 * row2[x]);
+      }
+    }
+  });
 }
 
 template <typename T>
@@ -360,9 +455,10 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
     return Status::OK();
   }
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
   switch (mode_) {
     case UpsampleMode::NN:
-      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, is_resize);
+      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, is_resize, tp);
     case UpsampleMode::LINEAR: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
       //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case 
@@ -384,7 +480,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
       ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
       upsampleBilinear(batch_size, num_channels, input_height, input_width,
                        is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], 
-                       X->template Data<T>(), Y->template MutableData<T>(), alloc);
+                       X->template Data<T>(), Y->template MutableData<T>(), alloc, tp);
       return Status::OK();
     }
     default:
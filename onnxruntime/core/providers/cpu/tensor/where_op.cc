@@ -4,9 +4,10 @@
 #include "core/providers/cpu/tensor/where_op.h"
 
 #include <algorithm>
-#include <type_traits>
+#include <array>
 
-#include "core/providers/cpu/math/element_wise_ops.h"  // for broadcast utilities
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -41,124 +42,29 @@ WHERE_TYPED_KERNEL_WITH_TYPE_NAME(std::string, string)
 #undef WHERE_TYPED_KERNEL
 
 namespace {
-template <typename T>
-constexpr bool IsEigenScalarCompatible = std::is_arithmetic<T>::value;
-
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target,
-                    TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoop(
-      *select_broadcaster, *select_broadcast_output,
-      [target](EigenVectorMap<T> output, bool condition, ConstEigenVectorMap<T> value) {
-        if (condition == target) {
-          output = value;
-        } else {
-          output = EigenVectorMap<T>::PlainObject::Constant(value.size(), T{});
-        }
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, const T& value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, ConstEigenVectorMap<T> value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      });
+constexpr int64_t kMinWhereElementsPerTask = 16384;
+
+// Selects n elements into output, stepping each input by one element if its Step is true or holding it otherwise.
+// The steps are compile time constants so the loop over contiguous inputs vectorizes to compares and blends.
+template <typename T, bool ConditionStep, bool XStep, bool YStep>
+void SelectRun(const bool* condition, const T* X, const T* Y, T* output, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    output[i] = condition[ConditionStep ? i : 0] ? X[XStep ? i : 0] : Y[YStep ? i : 0];
+  }
 }
 
 template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target, TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoopSpan(
-      *select_broadcaster, *select_broadcast_output,
-      [target](gsl::span<T> output, bool condition, gsl::span<const T> value) {
-        if (condition == target) {
-          std::copy(value.cbegin(), value.cend(), output.begin());
-        } else {
-          std::fill(output.begin(), output.end(), T{});
-        }
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, const T& value) {
-        std::transform(condition.cbegin(), condition.cend(), output.begin(),
-                       [target, &value](bool condition_element) {
-                         return condition_element == target ? value : T{};
-                       });
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, gsl::span<const T> value) {
-        std::transform(condition.cbegin(), condition.cend(), value.cbegin(), output.begin(),
-                       [target](bool condition_element, const T& value_element) {
-                         return condition_element == target ? value_element : T{};
-                       });
-      });
-}
+using SelectRunFunction = void (*)(const bool*, const T*, const T*, T*, int64_t);
 
+// Returns the run function for the innermost strides of the inputs, each 0 or 1.
 template <typename T>
-std::unique_ptr<Tensor> Select(bool target, const Tensor& condition_tensor, const Tensor& value_tensor,
-                               TensorAllocator<T>& tensor_allocator) {
-  TBroadcaster<bool, T> select_broadcaster{condition_tensor, value_tensor};
-  std::unique_ptr<Tensor> select_tensor{
-      tensor_allocator.Allocate(select_broadcaster.GetOutputShape())};
-  TBroadcastOutput<T> select_broadcast_output{
-      select_broadcaster.GetSpanSize(), *select_tensor};
-
-  SelectBroadcastLoop(target, &select_broadcaster, &select_broadcast_output);
-
-  return select_tensor;
-}
-
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](EigenVectorMap<T> output,
-                                      const T& scalar_value, ConstEigenVectorMap<T> vector_value) {
-    if (scalar_value != T{}) {
-      output = EigenVectorMap<T>::PlainObject::Constant(vector_value.size(), scalar_value);
-    } else {
-      output = vector_value;
-    }
-  };
-
-  BroadcastLoop(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](EigenVectorMap<T> output, const T& X_selection, ConstEigenVectorMap<T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, ConstEigenVectorMap<T> Y_selection) {
-        output = X_selection.binaryExpr(Y_selection, [](T x, T y) -> T {
-          return x != T{} ? x : y;
-        });
-      });
-}
-
-template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](gsl::span<T> output, const T& scalar_value, gsl::span<const T> vector_value) {
-    if (!scalar_value.empty()) {
-      std::fill(output.begin(), output.end(), scalar_value);
-    } else {
-      std::copy(vector_value.cbegin(), vector_value.cend(), output.begin());
-    }
-  };
-
-  BroadcastLoopSpan(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](gsl::span<T> output, const T& X_selection, gsl::span<const T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](gsl::span<T> output, gsl::span<const T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](gsl::span<T> output, gsl::span<const T> X_selection, gsl::span<const T> Y_selection) {
-        std::transform(X_selection.cbegin(), X_selection.cend(), Y_selection.cbegin(), output.begin(),
-                       [](const T& x, const T& y) { return !x.empty() ? x : y; });
-      });
+SelectRunFunction<T> GetSelectRun(int64_t condition_stride, int64_t X_stride, int64_t Y_stride) {
+  static const SelectRunFunction<T> select_runs[] = {
+      SelectRun<T, false, false, false>, SelectRun<T, false, false, true>,
+      SelectRun<T, false, true, false>, SelectRun<T, false, true, true>,
+      SelectRun<T, true, false, false>, SelectRun<T, true, false, true>,
+      SelectRun<T, true, true, false>, SelectRun<T, true, true, true>};
+  return select_runs[(condition_stride << 2) | (X_stride << 1) | Y_stride];
 }
 }  // namespace
 
@@ -169,24 +75,124 @@ Status Where<T>::Compute(OpKernelContext* context) const {
   const auto* const Y = context->Input<Tensor>(2);
   ORT_ENFORCE(condition && X && Y, "condition, X, and Y inputs are required!");
 
-  // The current implementation is limited to broadcasting over two tensors at once.
-  // So, we first broadcast over condition and X to select the values from X:
-  //   X_selection = condition ? X : default value
-  // Similarly, we broadcast over condition and Y to select the values from Y:
-  //   Y_selection = !condition ? Y : default value
-  // Finally, we broadcast over and merge X_selection and Y_selection:
-  //   output = (X_selection != default value) ? X_selection : Y_selection
-  TensorAllocator<T> tensor_allocator{*context};
-  auto X_selection_tensor = Select<T>(true, *condition, *X, tensor_allocator);
-  auto Y_selection_tensor = Select<T>(false, *condition, *Y, tensor_allocator);
-
-  TBroadcaster<T, T> merge_broadcaster{*X_selection_tensor, *Y_selection_tensor};
-  Tensor* const output = context->Output(0, merge_broadcaster.GetOutputShape());
+  // Broadcast the three inputs together in one pass. Each input gets a stride per output axis, 0 where it is
+  // broadcast, and axes are merged where all the inputs walk them with a single stride.
+  const std::vector<const TensorShape*> input_shapes{&condition->Shape(), &X->Shape(), &Y->Shape()};
+  size_t output_rank = 0;
+  for (const auto* shape : input_shapes) {
+    output_rank = std::max(output_rank, shape->NumDimensions());
+  }
+
+  std::vector<int64_t> output_dims(output_rank, 1);
+  for (const auto* shape : input_shapes) {
+    const size_t offset = output_rank - shape->NumDimensions();
+    for (size_t i = 0; i < shape->NumDimensions(); ++i) {
+      const int64_t dim = (*shape)[i];
+      int64_t& output_dim = output_dims[offset + i];
+      ORT_ENFORCE(dim == 1 || output_dim == 1 || dim == output_dim,
+                  "Attempting to broadcast an axis by a dimension other than 1. ", dim, " by ", output_dim);
+      if (dim != 1) {
+        output_dim = dim;
+      }
+    }
+  }
+
+  Tensor* const output = context->Output(0, TensorShape(output_dims));
   ORT_ENFORCE(output, "failed to get first output!");
-  TBroadcastOutput<T> merge_broadcast_output{
-      merge_broadcaster.GetSpanSize(), *output};
+  const int64_t size = output->Shape().Size();
+  if (size == 0) {
+    return Status::OK();
+  }
+
+  std::vector<std::array<int64_t, 3>> input_strides(output_rank);
+  for (size_t input = 0; input < input_shapes.size(); ++input) {
+    const auto& shape = *input_shapes[input];
+    const size_t offset = output_rank - shape.NumDimensions();
+    int64_t pitch = 1;
+    for (size_t axis = output_rank; axis-- > 0;) {
+      const int64_t dim = axis < offset ? 1 : shape[axis - offset];
+      input_strides[axis][input] = dim == 1 ? 0 : pitch;
+      pitch *= dim;
+    }
+  }
+
+  std::vector<int64_t> dims;
+  std::vector<std::array<int64_t, 3>> strides;
+  for (size_t i = 0; i < output_rank; ++i) {
+    if (output_dims[i] == 1) {
+      continue;
+    }
+    const auto& axis_strides = input_strides[i];
+    if (!dims.empty() && std::equal(axis_strides.begin(), axis_strides.end(), strides.back().begin(),
+                                    [&](int64_t stride, int64_t outer_stride) {
+                                      return outer_stride == stride * output_dims[i];
+                                    })) {
+      dims.back() *= output_dims[i];
+      strides.back() = axis_strides;
+    } else {
+      dims.push_back(output_dims[i]);
+      strides.push_back(axis_strides);
+    }
+  }
+  if (dims.empty()) {
+    dims.push_back(1);
+    strides.push_back({0, 0, 0});
+  }
+
+  const size_t outer_rank = dims.size() - 1;
+  const int64_t run = dims[outer_rank];
+  const auto select_run = GetSelectRun<T>(strides[outer_rank][0], strides[outer_rank][1], strides[outer_rank][2]);
+  const int64_t run_count = size / run;
+
+  const bool* condition_data = condition->template Data<bool>();
+  const T* X_data = X->template Data<T>();
+  const T* Y_data = Y->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  // Each task decomposes its first run into the indices of the outer axes once, then steps the indices along.
+  auto select_range = [&](int64_t first, int64_t last) {
+    std::vector<int64_t> indices(outer_rank);
+    std::array<int64_t, 3> offsets{0, 0, 0};
+    int64_t remainder = first;
+    for (size_t axis = outer_rank; axis-- > 0;) {
+      indices[axis] = remainder % dims[axis];
+      remainder /= dims[axis];
+      for (size_t input = 0; input < 3; ++input) {
+        offsets[input] += indices[axis] * strides[axis][input];
+      }
+    }
+
+    for (int64_t r = first; r < last; ++r) {
+      select_run(condition_data + offsets[0], X_data + offsets[1], Y_data + offsets[2], output_data + r * run, run);
+
+      for (size_t axis = outer_rank; axis-- > 0;) {
+        for (size_t input = 0; input < 3; ++input) {
+          offsets[input] += strides[axis][input];
+        }
+        if (++indices[axis] < dims[axis]) {
+          break;
+        }
+        for (size_t input = 0; input < 3; ++input) {
+          offsets[input] -= indices[axis] * strides[axis][input];
+        }
+        indices[axis] = 0;
+      }
+    }
+  };
 
-  MergeBroadcastLoop(&merge_broadcaster, &merge_broadcast_output);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  int64_t num_tasks = std::min(run_count, size / kMinWhereElementsPerTask);
+  if (tp != nullptr) {
+    num_tasks = std::min(num_tasks, static_cast<int64_t>(tp->NumThreads()) + 1);
+  }
+
+  if (tp == nullptr || num_tasks <= 1) {
+    select_range(0, run_count);
+  } else {
+    tp->ParallelFor(static_cast<int32_t>(num_tasks), [run_count, num_tasks, &select_range](int32_t task) {
+      select_range(run_count * task / num_tasks, run_count * (task + 1) / num_tasks);
+    });
+  }
 
   return Status::OK();
 }
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kWarpSize = 32;
+
+struct SumOp {
+  template <typename T>
+  __device__ __inline__ T operator()(T a, T b) const { return a + b; }
+};
+
+struct ProdOp {
+  template <typename T>
+  __device__ __inline__ T operator()(T a, T b) const { return a * b; }
+};
+
+// MaxOp and MinOp return NaN if either operand is NaN.
+struct MaxOp {
+  template <typename T>
+  __device__ __inline__ T operator()(T a, T b) const { return (a != a || a > b) ? a : b; }
+};
+
+struct MinOp {
+  template <typename T>
+  __device__ __inline__ T operator()(T a, T b) const { return (a != a || a < b) ? a : b; }
+};
+
+// Reduces value across the warp and returns the result to its first lane.
+template <typename T, typename Op>
+__device__ __inline__ T WarpReduce(T value, Op op) {
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    value = op(value, __shfl_down_sync(0xffffffff, value, offset));
+  }
+  return value;
+}
+
+// Reduces value across the warp and returns the result to every lane.
+template <typename T, typename Op>
+__device__ __inline__ T WarpAllReduce(T value, Op op) {
+  for (int mask = kWarpSize / 2; mask > 0; mask /= 2) {
+    value = op(value, __shfl_xor_sync(0xffffffff, value, mask));
+  }
+  return value;
+}
+
+// Reduces value across the thread block and returns the result to every thread. The block size
+// must be a multiple of the warp size, and every thread of the block must call it.
+template <typename T, typename Op>
+__device__ __inline__ T BlockReduce(T value, Op op, T identity) {
+  __shared__ T warp_results[kWarpSize];
+  __shared__ T result;
+  const int lane = threadIdx.x % kWarpSize;
+  const int warp = threadIdx.x / kWarpSize;
+
+  value = WarpReduce(value, op);
+  if (lane == 0) {
+    warp_results[warp] = value;
+  }
+  __syncthreads();
+
+  if (warp == 0) {
+    value = lane < blockDim.x / kWarpSize ? warp_results[lane] : identity;
+    value = WarpReduce(value, op);
+    if (lane == 0) {
+      result = value;
+    }
+  }
+  __syncthreads();
+  return result;
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,273 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "cuda_caching_allocator.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "cuda_common.h"
+
+namespace onnxruntime {
+
+namespace {
+// the size classes are kMinBlockBytes apart up to kSmallBlockBytes
+constexpr size_t kMinBlockBytes = 512;
+constexpr size_t kSmallBlockBytes = 1 << 20;
+// and kSizeClassesPerPowerOfTwo apart above
+constexpr size_t kSizeClassesPerPowerOfTwo = 8;
+// a cached block of up to this fraction more than the size class requested is reused for it
+constexpr size_t kMaxReuseWasteDivisor = 4;
+}  // namespace
+
+CUDACachingAllocator::CUDACachingAllocator(int device_id, const char* name)
+    : info_(name, OrtAllocatorType::OrtArenaAllocator,
+            OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id), device_id, OrtMemTypeDefault) {}
+
+CUDACachingAllocator::~CUDACachingAllocator() {
+  // do not throw errors since it's OK for cudaFree to fail during shutdown
+  for (auto& block : blocks_) {
+    cudaFree(block.first);
+    if (block.second.event != nullptr) {
+      cudaEventDestroy(block.second.event);
+    }
+  }
+  for (cudaEvent_t event : free_events_) {
+    cudaEventDestroy(event);
+  }
+}
+
+size_t CUDACachingAllocator::RoundSize(size_t size) {
+  if (size <= kSmallBlockBytes) {
+    return std::max(kMinBlockBytes, (size + kMinBlockBytes - 1) / kMinBlockBytes * kMinBlockBytes);
+  }
+
+  // the largest power of two below size
+  size_t power_of_two = kSmallBlockBytes;
+  while (power_of_two * 2 < size) {
+    power_of_two *= 2;
+  }
+  const size_t step = power_of_two / kSizeClassesPerPowerOfTwo;
+  return (size + step - 1) / step * step;
+}
+
+CUDACachingAllocator::StreamId CUDACachingAllocator::CurrentStream() {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  return std::this_thread::get_id();
+#else
+  return 0;
+#endif
+}
+
+void CUDACachingAllocator::CheckDevice() const {
+#ifndef NDEBUG
+  // check device to match at debug build
+  int current_device;
+  CUDA_CALL_THROW(cudaGetDevice(&current_device));
+  ORT_ENFORCE(current_device == info_.id);
+#endif
+}
+
+void CUDACachingAllocator::RecordEvent(Block& block) {
+  if (block.event == nullptr) {
+    if (free_events_.empty()) {
+      CUDA_CALL_THROW(cudaEventCreateWithFlags(&block.event, cudaEventDisableTiming));
+    } else {
+      block.event = free_events_.back();
+      free_events_.pop_back();
+    }
+  }
+  CUDA_CALL_THROW(cudaEventRecord(block.event, cudaStreamLegacy));
+}
+
+void* CUDACachingAllocator::TakeCachedBlock(size_t size, StreamId stream) {
+  const size_t max_size = size + size / kMaxReuseWasteDivisor;
+
+  // the bin of the stream first, whose blocks it can reuse without waiting for other streams
+  auto own_bin = bins_.find(stream);
+  Bin* bin = nullptr;
+  Bin::iterator it;
+  if (own_bin != bins_.end()) {
+    it = own_bin->second.lower_bound(size);
+    if (it != own_bin->second.end() && it->first <= max_size) {
+      bin = &own_bin->second;
+    }
+  }
+  if (bin == nullptr) {
+    for (auto& other_bin : bins_) {
+      if (other_bin.first == stream) {
+        continue;
+      }
+      it = other_bin.second.lower_bound(size);
+      if (it != other_bin.second.end() && it->first <= max_size) {
+        bin = &other_bin.second;
+        break;
+      }
+    }
+  }
+  if (bin == nullptr) {
+    return nullptr;
+  }
+
+  void* p = it->second;
+  bin->erase(it);
+  Block& block = blocks_.at(p);
+  cached_bytes_ -= block.size;
+
+  if (block.stream != stream) {
+    // fence the work the other stream submitted before its block is taken over
+    RecordEvent(block);
+    block.stream = stream;
+  }
+  if (block.event != nullptr) {
+    // the stream continues once the work of the other streams on the block is done, without blocking the host
+    CUDA_CALL_THROW(cudaStreamWaitEvent(nullptr, block.event, 0));
+    free_events_.push_back(block.event);
+    block.event = nullptr;
+  }
+  return p;
+}
+
+void* CUDACachingAllocator::Malloc(size_t size) {
+  void* p = nullptr;
+  if (cudaMalloc(&p, size) == cudaSuccess) {
+    return p;
+  }
+
+  // clear the error, and retry once the cached blocks are given back
+  cudaGetLastError();
+  TrimLocked(0);
+  CUDA_CALL_THROW(cudaMalloc(&p, size));
+  return p;
+}
+
+void* CUDACachingAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  CheckDevice();
+
+  const size_t rounded_size = RoundSize(size);
+  const StreamId stream = CurrentStream();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  void* p = TakeCachedBlock(rounded_size, stream);
+  if (p == nullptr) {
+    p = Malloc(rounded_size);
+    Block block;
+    block.size = rounded_size;
+    block.stream = stream;
+    blocks_.emplace(p, block);
+  }
+  used_bytes_ += blocks_.at(p).size;
+  return p;
+}
+
+void* CUDACachingAllocator::Reserve(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  CheckDevice();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  void* p = Malloc(size);
+  Block block;
+  block.size = size;
+  block.stream = CurrentStream();
+  block.reserved = true;
+  blocks_.emplace(p, block);
+  used_bytes_ += size;
+  return p;
+}
+
+void CUDACachingAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  CheckDevice();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = blocks_.find(p);
+  ORT_ENFORCE(it != blocks_.end(), "Freed memory the CUDA caching allocator didn't allocate");
+  Block& block = it->second;
+  used_bytes_ -= block.size;
+
+  if (block.reserved) {
+    cudaFree(p);
+    blocks_.erase(it);
+    return;
+  }
+
+  if (block.stream != CurrentStream()) {
+    // the stream freeing the block may still be using it
+    RecordEvent(block);
+  }
+  block.free_order = next_free_order_++;
+  bins_[block.stream].emplace(block.size, p);
+  cached_bytes_ += block.size;
+}
+
+size_t CUDACachingAllocator::TrimLocked(size_t max_cached_bytes) {
+  if (cached_bytes_ <= max_cached_bytes) {
+    return 0;
+  }
+
+  // the cached blocks, the least recently freed first
+  using CachedBlock = std::tuple<uint64_t, Bin*, Bin::iterator>;
+  std::vector<CachedBlock> cached_blocks;
+  for (auto& bin : bins_) {
+    for (auto it = bin.second.begin(); it != bin.second.end(); ++it) {
+      cached_blocks.emplace_back(blocks_.at(it->second).free_order, &bin.second, it);
+    }
+  }
+  std::sort(cached_blocks.begin(), cached_blocks.end(),
+            [](const CachedBlock& a, const CachedBlock& b) { return std::get<0>(a) < std::get<0>(b); });
+
+  // cudaFree waits for the device to be done with the memory, so the events of the blocks don't need to complete
+  size_t trimmed_bytes = 0;
+  for (auto& cached_block : cached_blocks) {
+    if (cached_bytes_ <= max_cached_bytes) {
+      break;
+    }
+    void* p = std::get<2>(cached_block)->second;
+    std::get<1>(cached_block)->erase(std::get<2>(cached_block));
+
+    auto it = blocks_.find(p);
+    if (it->second.event != nullptr) {
+      free_events_.push_back(it->second.event);
+    }
+    cached_bytes_ -= it->second.size;
+    trimmed_bytes += it->second.size;
+    blocks_.erase(it);
+    cudaFree(p);
+  }
+  return trimmed_bytes;
+}
+
+size_t CUDACachingAllocator::Trim(size_t max_cached_bytes) {
+  CheckDevice();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return TrimLocked(max_cached_bytes);
+}
+
+Status CUDACachingAllocator::Shrink() {
+  Trim(0);
+  return Status::OK();
+}
+
+size_t CUDACachingAllocator::Used() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return used_bytes_;
+}
+
+size_t CUDACachingAllocator::Max() const {
+  return std::numeric_limits<size_t>::max();
+}
+
+size_t CUDACachingAllocator::Cached() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return cached_bytes_;
+}
+
+}  // namespace onnxruntime
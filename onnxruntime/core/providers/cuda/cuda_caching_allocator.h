@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cuda_pch.h"
+#include "core/framework/arena.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+A caching allocator of device memory whose blocks are reused in the order of the stream they were allocated on.
+
+The memory freed is kept in bins of size classes rather than given back with cudaFree, and handed out again to the
+allocations of the same size class on the same stream right away: the work submitted to the stream next runs after
+the work that used the block, so neither the host nor the stream waits for it. The stream of an allocation is the
+stream the kernels of the allocating thread run on. That is the per-thread default stream of the thread with
+CUDA_API_PER_THREAD_DEFAULT_STREAM, and otherwise the legacy default stream, which all the threads share.
+
+A block freed by a thread running on another stream than the one it was allocated on, and a block a stream takes
+over from the bins of another stream, are fenced with an event recorded on the legacy default stream, which completes
+after the work submitted to every blocking stream before it. The stream reusing the block waits for the event on the
+device, so the host never waits for a block.
+
+The size classes are 512 bytes apart up to 1MB, and 8 per power of two above, so tensors of varying shapes share
+the blocks of their size class and the memory a block wastes is bounded. When cudaMalloc runs out of memory, the
+blocks cached are given back and the allocation retried, and Shrink or Trim give the cached blocks back on request.
+*/
+class CUDACachingAllocator : public IArenaAllocator {
+ public:
+  CUDACachingAllocator(int device_id, const char* name);
+  ~CUDACachingAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  // The memory of a reservation is not cached, and goes back with cudaFree when it's freed.
+  void* Reserve(size_t size) override;
+
+  // the bytes of the blocks handed out
+  size_t Used() const override;
+  size_t Max() const override;
+
+  // Gives the cached blocks back to the device.
+  Status Shrink() override;
+
+  // Gives the cached blocks back to the device, the least recently freed first, until the cache holds at most
+  // max_cached_bytes. Returns the bytes given back.
+  size_t Trim(size_t max_cached_bytes);
+
+  // the bytes of the blocks cached for reuse
+  size_t Cached() const;
+
+  const OrtMemoryInfo& Info() const override { return info_; }
+
+  // The size class of an allocation of size bytes.
+  static size_t RoundSize(size_t size);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDACachingAllocator);
+
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  using StreamId = std::thread::id;
+#else
+  using StreamId = int;
+#endif
+
+  struct Block {
+    size_t size;
+    StreamId stream;
+    // fences the work of other streams on the block while it's cached. nullptr if only its own stream used it.
+    cudaEvent_t event = nullptr;
+    bool reserved = false;
+    // the position of the block in the order blocks were freed, while it's cached
+    uint64_t free_order = 0;
+  };
+
+  // the cached blocks of a stream, by size
+  using Bin = std::multimap<size_t, void*>;
+
+  static StreamId CurrentStream();
+
+  // Takes a cached block of size class size for stream, or returns nullptr. Requires mutex_.
+  void* TakeCachedBlock(size_t size, StreamId stream);
+
+  // Records an event on the legacy default stream for block. Requires mutex_.
+  void RecordEvent(Block& block);
+
+  // Gives the cached blocks back to the device until the cache holds at most max_cached_bytes. Requires mutex_.
+  size_t TrimLocked(size_t max_cached_bytes);
+
+  void* Malloc(size_t size);
+  void CheckDevice() const;
+
+  const OrtMemoryInfo info_;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<void*, Block> blocks_;
+  std::map<StreamId, Bin> bins_;
+  // the events of the blocks given back, to be reused
+  std::vector<cudaEvent_t> free_events_;
+  uint64_t next_free_order_ = 0;
+  size_t used_bytes_ = 0;
+  size_t cached_bytes_ = 0;
+};
+
+}  // namespace onnxruntime
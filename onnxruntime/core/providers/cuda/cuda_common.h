@@ -181,5 +181,20 @@ inline bool CalculateFdmStrides(gsl::span<fast_divmod> p, const std::vector<int6
   return true;
 }
 
+// Returns the bytes the data-movement kernels copy per thread: the widest of 16, 8 and 4 bytes that divides
+// offset_bits, or element_size if that is wider. offset_bits is the bitwise or of the byte sizes of the contiguous
+// runs copied and of the addresses of the buffers they're copied between, so a copy of that many bytes is aligned.
+inline size_t GetVectorizedCopyBytes(size_t element_size, uint64_t offset_bits) {
+  for (size_t copy_bytes : {16, 8, 4}) {
+    if (copy_bytes <= element_size) {
+      break;
+    }
+    if (offset_bits % copy_bytes == 0) {
+      return copy_bytes;
+    }
+  }
+  return element_size;
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -5,10 +5,14 @@
 #include "cuda_execution_provider.h"
 #include "core/framework/memcpy.h"
 #include "cuda_fence.h"
+#include "cudnn_algo_cache.h"
 #include "cuda_allocator.h"
+#include "cuda_caching_allocator.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/cuda_profiler.h"
+#include "core/providers/cuda/cuda_weight_streamer.h"
 
 #ifndef DISABLE_CONTRIB_OPS
 #include "contrib_ops/cuda_contrib_kernels.h"
@@ -44,31 +48,108 @@ ONNX_OPERATOR_KERNEL_EX(
 
 }  // namespace cuda
 
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+namespace {
+// Hands out the memory of the per-thread allocator while a graph is captured, and keeps the memory freed until the
+// graph is destroyed, as its replays read and write the same addresses.
+class CUDAGraphAllocator : public IAllocator {
+ public:
+  explicit CUDAGraphAllocator(AllocatorPtr allocator) : allocator_(std::move(allocator)) {}
+
+  ~CUDAGraphAllocator() override {
+    for (void* p : freed_) {
+      allocator_->Free(p);
+    }
+  }
+
+  void* Alloc(size_t size) override {
+    return allocator_->Alloc(size);
+  }
+
+  void Free(void* p) override {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    freed_.push_back(p);
+  }
+
+  const OrtMemoryInfo& Info() const override {
+    return allocator_->Info();
+  }
+
+ private:
+  AllocatorPtr allocator_;
+  OrtMutex mutex_;
+  std::vector<void*> freed_;
+};
+
+class CUDAGraph : public ICapturedGraph {
+ public:
+  CUDAGraph(cudaGraphExec_t graph_exec, AllocatorPtr allocator)
+      : graph_exec_(graph_exec), allocator_(std::move(allocator)) {}
+
+  ~CUDAGraph() override {
+    CUDA_CALL(cudaGraphExecDestroy(graph_exec_));
+  }
+
+  Status Replay() override {
+    CUDA_RETURN_IF_ERROR(cudaGraphLaunch(graph_exec_, cudaStreamPerThread));
+    return Status::OK();
+  }
+
+ private:
+  cudaGraphExec_t graph_exec_;
+  // keeps the memory the graph uses
+  AllocatorPtr allocator_;
+};
+}  // namespace
+#endif
+
 thread_local std::unique_ptr<CUDAExecutionProvider::PerThreadContextMap> CUDAExecutionProvider::per_thread_context_map_;
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id) {
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id, AllocatorPtr allocator)
+    : allocator_(std::move(allocator)) {
   CUDA_CALL_THROW(cudaSetDevice(device_id));
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, cudaStreamPerThread));
+  CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, cudaStreamPerThread));
+#endif
+
+  if (allocator_ == nullptr) {
+    DeviceAllocatorRegistrationInfo default_memory_info(
+        {OrtMemTypeDefault,
+         [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
+    allocator_ = CreateAllocator(default_memory_info, device_id);
+  }
 
-  DeviceAllocatorRegistrationInfo default_memory_info(
-      {OrtMemTypeDefault,
-       [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
-  allocator_ = CreateAllocator(default_memory_info, device_id);
+  CUDA_CALL_THROW(cudaEventCreateWithFlags(&compute_stream_event_, cudaEventDisableTiming));
 }
 
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
   CUBLAS_CALL_THROW(cublasDestroy(cublas_handle_));
   CUDNN_CALL_THROW(cudnnDestroy(cudnn_handle_));
+  CUDA_CALL_THROW(cudaEventDestroy(compute_stream_event_));
 }
 
 CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kCudaExecutionProvider},
+      device_id_(info.device_id),
+      compute_stream_(info.compute_stream),
+      cudnn_algo_cache_filepath_(info.cudnn_algo_cache_filepath) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
-  DeviceAllocatorRegistrationInfo default_memory_info(
-      {OrtMemTypeDefault, [](int device_id) { return std::make_unique<CUDAAllocator>(device_id, CUDA); }, std::numeric_limits<size_t>::max()});
-  InsertAllocator(CreateAllocator(default_memory_info, device_id_));
+  if (!cudnn_algo_cache_filepath_.empty()) {
+    ORT_THROW_IF_ERROR(cuda::CudnnAlgoCache::Instance().Load(cudnn_algo_cache_filepath_));
+  }
+
+  if (info.use_caching_allocator) {
+    caching_allocator_ = std::make_shared<CUDACachingAllocator>(device_id_, CUDA);
+    InsertAllocator(caching_allocator_);
+  } else {
+    DeviceAllocatorRegistrationInfo default_memory_info(
+        {OrtMemTypeDefault, [](int device_id) { return std::make_unique<CUDAAllocator>(device_id, CUDA); }, std::numeric_limits<size_t>::max()});
+    InsertAllocator(CreateAllocator(default_memory_info, device_id_));
+  }
 
   DeviceAllocatorRegistrationInfo pinned_memory_info(
       {OrtMemTypeCPUOutput, [](int device_id) { return std::make_unique<CUDAPinnedAllocator>(device_id, CUDA_PINNED); }, std::numeric_limits<size_t>::max()});
@@ -99,6 +180,13 @@ CUDAExecutionProvider::~CUDAExecutionProvider() {
     it = deferred_release_cpu_ptr_.erase(it);
   }
   ReleasePerThreadStuffs();
+
+  if (!cudnn_algo_cache_filepath_.empty()) {
+    auto status = cuda::CudnnAlgoCache::Instance().Save(cudnn_algo_cache_filepath_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to save the cudnn algorithm cache: " << status.ErrorMessage();
+    }
+  }
 }
 
 CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadContext() const {
@@ -110,7 +198,7 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
   if (p->count(this) == 0) {
     std::lock_guard<OrtMutex> lock(context_pool_mutex_);
     if (context_pool_.empty()) {
-      p->insert(std::make_pair(this, std::make_shared<PerThreadContext>(device_id_)));
+      p->insert(std::make_pair(this, std::make_shared<PerThreadContext>(device_id_, caching_allocator_)));
     } else {
       p->insert(std::make_pair(this, context_pool_.back()));
       context_pool_.pop_back();
@@ -145,6 +233,67 @@ AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) co
   }
 }
 
+bool CUDAExecutionProvider::SupportsGraphCapture() const {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  return true;
+#else
+  // the cuBLAS/cuDNN calls go to the legacy default stream, which can't be captured
+  return false;
+#endif
+}
+
+Status CUDAExecutionProvider::BeginGraphCapture() const {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  // relaxed, as the arena may need to call cudaMalloc during the capture
+  CUDA_RETURN_IF_ERROR(cudaStreamBeginCapture(cudaStreamPerThread, cudaStreamCaptureModeRelaxed));
+  auto& context = GetPerThreadContext();
+  context.SetGraphAllocator(std::make_shared<CUDAGraphAllocator>(context.GetAllocator()));
+  return Status::OK();
+#else
+  return IExecutionProvider::BeginGraphCapture();
+#endif
+}
+
+Status CUDAExecutionProvider::EndGraphCapture(std::unique_ptr<ICapturedGraph>& captured_graph) const {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  auto& context = GetPerThreadContext();
+  AllocatorPtr graph_allocator = context.GetAllocator();
+  context.SetGraphAllocator(nullptr);
+
+  // a kernel that synchronized with the host invalidates the capture. clear the error, the kernels can still run.
+  cudaGraph_t graph = nullptr;
+  if (cudaStreamEndCapture(cudaStreamPerThread, &graph) != cudaSuccess || graph == nullptr) {
+    cudaGetLastError();
+    return Status::OK();
+  }
+
+  cudaGraphExec_t graph_exec = nullptr;
+  cudaError_t result = cudaGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0);
+  CUDA_RETURN_IF_ERROR(cudaGraphDestroy(graph));
+  if (result != cudaSuccess) {
+    cudaGetLastError();
+    return Status::OK();
+  }
+
+  captured_graph = std::make_unique<CUDAGraph>(graph_exec, std::move(graph_allocator));
+  return Status::OK();
+#else
+  return IExecutionProvider::EndGraphCapture(captured_graph);
+#endif
+}
+
+#ifdef ENABLE_CUDA_PROFILING
+std::unique_ptr<profiling::EpProfiler> CUDAExecutionProvider::GetProfiler() {
+  return std::make_unique<CudaProfiler>();
+}
+#endif
+
+std::unique_ptr<IWeightStreamer> CUDAExecutionProvider::CreateWeightStreamer(size_t buffer_size) {
+  return std::make_unique<CudaWeightStreamer>(device_id_, buffer_size,
+                                              GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPUOutput)->Info(),
+                                              GetAllocator(device_id_, OrtMemTypeDefault)->Info());
+}
+
 Status CUDAExecutionProvider::Sync() const {
   CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
   return Status::OK();
@@ -163,7 +312,12 @@ void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
   }
 }
 
-Status CUDAExecutionProvider::OnRunStart() {
+cudaStream_t CUDAExecutionProvider::GetComputeStream(const RunOptions& run_options) const {
+  return run_options.compute_stream != nullptr ? static_cast<cudaStream_t>(run_options.compute_stream)
+                                               : compute_stream_;
+}
+
+Status CUDAExecutionProvider::OnRunStart(const RunOptions& run_options) {
   auto cpu_alloc = GetAllocator(0, OrtMemTypeCPU);
   // check if cudaEvents has passed for deferred release
   // note that we need to take a mutex in case of multi-threaded Run()
@@ -188,13 +342,40 @@ Status CUDAExecutionProvider::OnRunStart() {
   auto& current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
   CUDA_RETURN_IF_ERROR(cudaEventCreate(&current_deferred_release_event, cudaEventDisableTiming));
   deferred_release_cpu_ptr_.emplace(current_deferred_release_event, DeferredReleaseCPUPtrs());
+
+  // the kernels run on the default streams, which all synchronize with the legacy stream. make it wait for the
+  // work the application submitted to its stream, without blocking the host.
+  cudaStream_t compute_stream = GetComputeStream(run_options);
+  if (compute_stream != nullptr) {
+    auto compute_stream_event = GetPerThreadContext().GetComputeStreamEvent();
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(compute_stream_event, compute_stream));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(cudaStreamLegacy, compute_stream_event, 0));
+  }
   return Status::OK();
 }
 
-Status CUDAExecutionProvider::OnRunEnd() {
+Status CUDAExecutionProvider::OnRunEnd(const RunOptions& run_options) {
+  // make the work the application submits to its stream next wait for the Run
+  cudaStream_t compute_stream = GetComputeStream(run_options);
+  if (compute_stream != nullptr) {
+    auto compute_stream_event = GetPerThreadContext().GetComputeStreamEvent();
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(compute_stream_event, cudaStreamLegacy));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(compute_stream, compute_stream_event, 0));
+  }
+
   // record deferred release event on default stream, and release per_thread_context
   auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+  // the nodes may have run on the streams of other threads, which all synchronize with the legacy stream.
+  // wait for them before the memory they read goes back to the arenas of those threads. the caching allocator
+  // fences the blocks freed across streams itself.
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, cudaStreamLegacy));
+  if (caching_allocator_ == nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(current_deferred_release_event));
+  }
+#else
   CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, nullptr));
+#endif
   ReleasePerThreadStuffs();
   std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
   deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
@@ -539,6 +720,13 @@ class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain,
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, Dropout);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, QuantizeLinear);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, QuantizeLinear);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, DequantizeLinear);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, DequantizeLinear);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul);
 
 static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
   static const BuildKernelCreateInfoFn function_table[] = {
@@ -878,6 +1066,13 @@ static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, MLFloat16, Less)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, QuantizeLinear)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, QuantizeLinear)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, DequantizeLinear)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, DequantizeLinear)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul)>,
   };
 
   for (auto& function_table_entry : function_table) {
@@ -1001,8 +1196,28 @@ static bool CastNeedFallbackToCPU(const onnxruntime::Node& node) {
   return false;
 }
 
+// returns true if the CUDA kernel of the node doesn't support its attributes or types.
+static bool NeedFallbackToCPU(const onnxruntime::Node& node) {
+  if ("LSTM" == node.OpType()) {
+    // the supported activations covers the bidirectional mode
+    std::vector<std::string> activations_supported{"sigmoid", "tanh", "tanh", "sigmoid", "tanh", "tanh"};
+    return RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
+  } else if ("RNN" == node.OpType()) {
+    std::vector<std::string> activations_supported{"tanh", "tanh"};
+    return RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
+  } else if ("GRU" == node.OpType()) {
+    std::vector<std::string> activations_supported{"sigmoid", "tanh", "sigmoid", "tanh"};
+    return RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
+  } else if ("Conv" == node.OpType()) {
+    return ConvNeedFallbackToCPU(node);
+  } else if ("Cast" == node.OpType()) {
+    return CastNeedFallbackToCPU(node);
+  }
+  return false;
+}
+
 std::unique_ptr<onnxruntime::IDataTransfer> CUDAExecutionProvider::GetDataTransfer() const {
-  return std::make_unique<onnxruntime::GPUDataTransfer>();
+  return std::make_unique<onnxruntime::GPUDataTransfer>(GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPUOutput));
 }
 
 std::vector<std::unique_ptr<ComputeCapability>>
@@ -1025,29 +1240,11 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
       continue;
     }
 
-    bool not_supported = false;
+    const bool not_supported = NeedFallbackToCPU(node);
     bool force_outside = false;
-    bool force_inside = false;  // for some compute heavy ops, we'll force it to run inside CUDA
-    if ("LSTM" == node.OpType()) {
-      // the supported activations covers the bidirectional mode
-      std::vector<std::string> activations_supported{"sigmoid", "tanh", "tanh", "sigmoid", "tanh", "tanh"};
-      not_supported = RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
-      force_inside = !not_supported;
-    } else if ("RNN" == node.OpType()) {
-      std::vector<std::string> activations_supported{"tanh", "tanh"};
-      not_supported = RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
-      force_inside = !not_supported;
-    } else if ("GRU" == node.OpType()) {
-      std::vector<std::string> activations_supported{"sigmoid", "tanh", "sigmoid", "tanh"};
-      not_supported = RNNNeedFallbackToCPU(node, activations_supported, node.OpType());
-      force_inside = !not_supported;
-    } else if ("Conv" == node.OpType()) {
-      not_supported = ConvNeedFallbackToCPU(node);
-      force_inside = !not_supported;
-    } else if ("Cast" == node.OpType()) {
-      not_supported = CastNeedFallbackToCPU(node);
-      // cast is not compute heavy, and may be placed outside
-    }
+    // for some compute heavy ops, we'll force it to run inside CUDA. Cast is not compute heavy, and may be placed outside
+    const bool force_inside = !not_supported && ("LSTM" == node.OpType() || "RNN" == node.OpType() ||
+                                                 "GRU" == node.OpType() || "Conv" == node.OpType());
 
     if (!not_supported && !force_inside) {
       // Note that nodes with only inputs from initializer would not be place on CUDA
@@ -1100,4 +1297,8 @@ CUDAExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+bool CUDAExecutionProvider::CanRunNode(const onnxruntime::Node& node) const {
+  return GetKernelRegistry()->TryFindKernel(node, Type()) != nullptr && !NeedFallbackToCPU(node);
+}
+
 }  // namespace onnxruntime
@@ -18,6 +18,14 @@ const int CPU_ALLOCATOR_DEVICE_ID = 0;
 // Information needed to construct CUDA execution providers.
 struct CUDAExecutionProviderInfo {
   int device_id{0};
+  // stream of the application that every Run is ordered with, unless the Run gives one.
+  cudaStream_t compute_stream{nullptr};
+  // non empty filepath loads the cudnn algorithms found by earlier processes when the provider is created, and
+  // saves the ones found since when it is destroyed. See CudnnAlgoCache.
+  std::basic_string<ORTCHAR_T> cudnn_algo_cache_filepath;
+  // allocate the device memory with one CUDACachingAllocator shared by the threads, whose blocks are reused in the
+  // order of the stream they were allocated on, instead of an arena per thread.
+  bool use_caching_allocator{false};
 };
 
 // Logical device representation.
@@ -30,9 +38,24 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status Sync() const override;
 
-  Status OnRunStart() override;
+  Status OnRunStart(const RunOptions& run_options) override;
 
-  Status OnRunEnd() override;
+  Status OnRunEnd(const RunOptions& run_options) override;
+
+  // only with onnxruntime_CUDA_PER_THREAD_STREAMS, which puts all the work on the per-thread default stream.
+  bool SupportsGraphCapture() const override;
+
+  Status BeginGraphCapture() const override;
+
+  Status EndGraphCapture(std::unique_ptr<ICapturedGraph>& captured_graph) const override;
+
+#ifdef ENABLE_CUDA_PROFILING
+  // records the kernels and copies of the devices with CUPTI, only with onnxruntime_ENABLE_CUDA_PROFILING.
+  std::unique_ptr<profiling::EpProfiler> GetProfiler() override;
+#endif
+
+  // copies the initializers of the kernels from pinned host memory on a stream of its own.
+  std::unique_ptr<IWeightStreamer> CreateWeightStreamer(size_t buffer_size) override;
 
   cublasHandle_t PerThreadCublasHandle() {
     return GetPerThreadContext().CublasHandle();
@@ -64,10 +87,18 @@ class CUDAExecutionProvider : public IExecutionProvider {
   GetCapability(const onnxruntime::GraphViewer& graph,
                 const std::vector<const KernelRegistry*>& kernel_registries) const override;
 
+  // the nodes CUDA has kernels for that support their attributes, including those GetCapability leaves on the CPU
+  // because their inputs come from the CPU.
+  bool CanRunNode(const onnxruntime::Node& node) const override;
+
   int GetDeviceId() const { return device_id_; }
 
  private:
   int device_id_;
+  cudaStream_t compute_stream_;
+  std::basic_string<ORTCHAR_T> cudnn_algo_cache_filepath_;
+  // the allocator of the device memory of every thread with CUDAExecutionProviderInfo::use_caching_allocator
+  AllocatorPtr caching_allocator_;
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
@@ -78,7 +109,8 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   class PerThreadContext final {
    public:
-    PerThreadContext(int device_id);
+    // allocator is the allocator of the device memory, or nullptr to create an arena for the thread
+    PerThreadContext(int device_id, AllocatorPtr allocator);
     ~PerThreadContext();
 
     cublasHandle_t CublasHandle() const {
@@ -93,6 +125,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return current_deferred_release_event_;
     }
 
+    cudaEvent_t GetComputeStreamEvent() const {
+      return compute_stream_event_;
+    }
+
     template <typename T>
     const T* GetConstOnes(size_t count) {
       if (std::is_same<T, float>::value) {
@@ -116,7 +152,11 @@ class CUDAExecutionProvider : public IExecutionProvider {
     }
 
     AllocatorPtr GetAllocator() const {
-      return allocator_;
+      return graph_allocator_ ? graph_allocator_ : allocator_;
+    }
+
+    void SetGraphAllocator(AllocatorPtr graph_allocator) {
+      graph_allocator_ = std::move(graph_allocator);
     }
 
    private:
@@ -128,11 +168,17 @@ class CUDAExecutionProvider : public IExecutionProvider {
     // so the ownership is passed to deferred_release_cpu_ptr_
     cudaEvent_t current_deferred_release_event_ = nullptr;
 
+    // orders the work of a Run with the compute stream of the application
+    cudaEvent_t compute_stream_event_ = nullptr;
+
     std::unique_ptr<cuda::IConstantBuffer<float>> constant_ones_float_;
     std::unique_ptr<cuda::IConstantBuffer<double>> constant_ones_double_;
     std::unique_ptr<cuda::IConstantBuffer<half>> constant_ones_half_;
 
     AllocatorPtr allocator_;
+
+    // set while a graph is captured, to keep the memory its kernels use. See BeginGraphCapture.
+    AllocatorPtr graph_allocator_;
   };
 
   // thread local context during execution
@@ -145,6 +191,8 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   PerThreadContext& GetPerThreadContext() const;
   void ReleasePerThreadStuffs() const;
+
+  cudaStream_t GetComputeStream(const RunOptions& run_options) const;
 };
 
 }  // namespace onnxruntime
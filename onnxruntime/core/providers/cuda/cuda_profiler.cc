@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifdef ENABLE_CUDA_PROFILING
+
+#include "core/providers/cuda/cuda_profiler.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include <cupti.h>
+#ifndef _WIN32
+#include <cxxabi.h>
+#endif
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+namespace {
+// CUPTI fills buffers of this size with the activity records, and hands them back when full or flushed
+constexpr size_t kActivityBufferSize = 1 << 20;
+constexpr size_t kActivityBufferAlignment = 8;
+
+constexpr CUpti_ActivityKind kActivityKinds[] = {CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL,
+                                                CUPTI_ACTIVITY_KIND_MEMCPY,
+                                                CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION};
+
+bool CuptiCall(CUptiResult result, const char* expr) {
+  if (result == CUPTI_SUCCESS) {
+    return true;
+  }
+  const char* message = nullptr;
+  cuptiGetResultString(result, &message);
+  LOGS_DEFAULT(WARNING) << "CUPTI failure " << result << ": " << (message != nullptr ? message : "") << " ; "
+                        << expr;
+  return false;
+}
+
+#define CUPTI_CALL(expr) (CuptiCall((expr), #expr))
+
+std::string Demangle(const char* name) {
+#ifndef _WIN32
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled != nullptr) {
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+const char* MemcpyName(uint8_t copy_kind) {
+  switch (copy_kind) {
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOD:
+      return "Memcpy HtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOH:
+      return "Memcpy DtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOD:
+      return "Memcpy DtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOH:
+      return "Memcpy HtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_PTOP:
+      return "Memcpy PtoP";
+    default:
+      return "Memcpy";
+  }
+}
+
+// a kernel or a copy the device ran
+struct DeviceActivity {
+  std::string name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint32_t stream_id;
+  uint32_t correlation_id;
+  std::unordered_map<std::string, std::string> args;
+};
+
+/**
+The activities CUPTI records for the whole process, while at least one session is profiling.
+*/
+class CuptiActivities {
+ public:
+  static CuptiActivities& Instance() {
+    // never destroyed, as CUPTI may hand back buffers until the process exits
+    static CuptiActivities* instance = new CuptiActivities();
+    return *instance;
+  }
+
+  // returns false if CUPTI can't record the activities
+  bool AddClient() {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (num_clients_ == 0) {
+      if (!CUPTI_CALL(cuptiActivityRegisterCallbacks(BufferRequested, BufferCompleted))) {
+        return false;
+      }
+      for (auto kind : kActivityKinds) {
+        if (!CUPTI_CALL(cuptiActivityEnable(kind))) {
+          DisableActivities();
+          return false;
+        }
+      }
+    }
+    ++num_clients_;
+    return true;
+  }
+
+  void RemoveClient() {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (--num_clients_ == 0) {
+      DisableActivities();
+      activities_.clear();
+      external_ids_.clear();
+    }
+  }
+
+  // hands the activities completed so far to func, with the external correlation id of each, or 0 if none
+  template <typename TFunc>
+  void ForEach(TFunc&& func) {
+    // CUPTI calls BufferCompleted from this thread, so the lock is not held yet
+    CUPTI_CALL(cuptiActivityFlushAll(0));
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (const auto& activity : activities_) {
+      auto it = external_ids_.find(activity.correlation_id);
+      func(activity, it == external_ids_.end() ? 0 : it->second);
+    }
+  }
+
+ private:
+  CuptiActivities() = default;
+
+  void DisableActivities() {
+    for (auto kind : kActivityKinds) {
+      cuptiActivityDisable(kind);
+    }
+  }
+
+  static void CUPTIAPI BufferRequested(uint8_t** buffer, size_t* size, size_t* max_num_records) {
+    // malloc aligns to more than the 8 bytes CUPTI needs
+    static_assert(alignof(std::max_align_t) >= kActivityBufferAlignment, "activity buffers are misaligned");
+    *buffer = static_cast<uint8_t*>(std::malloc(kActivityBufferSize));
+    *size = *buffer != nullptr ? kActivityBufferSize : 0;
+    *max_num_records = 0;
+  }
+
+  static void CUPTIAPI BufferCompleted(CUcontext /*context*/, uint32_t /*stream_id*/, uint8_t* buffer,
+                                       size_t /*size*/, size_t valid_size) {
+    Instance().AddRecords(buffer, valid_size);
+    std::free(buffer);
+  }
+
+  void AddRecords(uint8_t* buffer, size_t valid_size) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    CUpti_Activity* record = nullptr;
+    while (cuptiActivityGetNextRecord(buffer, valid_size, &record) == CUPTI_SUCCESS) {
+      switch (record->kind) {
+        case CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL: {
+          const auto* kernel = reinterpret_cast<const CUpti_ActivityKernel4*>(record);
+          activities_.push_back({Demangle(kernel->name), kernel->start, kernel->end, kernel->streamId,
+                                 kernel->correlationId,
+                                 {{"device", std::to_string(kernel->deviceId)},
+                                  {"stream", std::to_string(kernel->streamId)},
+                                  {"grid", std::to_string(kernel->gridX) + "," + std::to_string(kernel->gridY) +
+                                               "," + std::to_string(kernel->gridZ)},
+                                  {"block", std::to_string(kernel->blockX) + "," + std::to_string(kernel->blockY) +
+                                                "," + std::to_string(kernel->blockZ)}}});
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMCPY: {
+          const auto* copy = reinterpret_cast<const CUpti_ActivityMemcpy*>(record);
+          activities_.push_back({MemcpyName(copy->copyKind), copy->start, copy->end, copy->streamId,
+                                 copy->correlationId,
+                                 {{"device", std::to_string(copy->deviceId)},
+                                  {"stream", std::to_string(copy->streamId)},
+                                  {"bytes", std::to_string(copy->bytes)}}});
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION: {
+          const auto* correlation = reinterpret_cast<const CUpti_ActivityExternalCorrelation*>(record);
+          external_ids_[correlation->correlationId] = correlation->externalId;
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
+    size_t num_dropped = 0;
+    if (cuptiActivityGetNumDroppedRecords(nullptr, 0, &num_dropped) == CUPTI_SUCCESS && num_dropped > 0) {
+      LOGS_DEFAULT(WARNING) << num_dropped << " CUDA activities were dropped from the profile.";
+    }
+  }
+
+  OrtMutex mutex_;
+  int num_clients_{0};
+  std::vector<DeviceActivity> activities_;
+  // the external correlation ids by the correlation ids of CUPTI
+  std::unordered_map<uint32_t, uint64_t> external_ids_;
+};
+}  // namespace
+
+CudaProfiler::~CudaProfiler() {
+  if (enabled_) {
+    CuptiActivities::Instance().RemoveClient();
+  }
+}
+
+void CudaProfiler::StartProfiling(TimePoint /*profiling_start_time*/) {
+  if (enabled_) {
+    return;
+  }
+  if (!CuptiActivities::Instance().AddClient()) {
+    LOGS_DEFAULT(WARNING) << "The CUDA kernels and copies are not recorded in the profile.";
+    return;
+  }
+  CUPTI_CALL(cuptiGetTimestamp(&cupti_start_ns_));
+  host_start_time_ = std::chrono::high_resolution_clock::now();
+  enabled_ = true;
+}
+
+void CudaProfiler::EndProfiling(TimePoint profiling_start_time, std::vector<EventRecord>& events) {
+  if (!enabled_) {
+    return;
+  }
+
+  const long long host_start_us = TimeDiffMicroSeconds(profiling_start_time, host_start_time_);
+  const int pid = logging::GetProcessId();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  CuptiActivities::Instance().ForEach([&](const DeviceActivity& activity, uint64_t external_id) {
+    if (activity.start_ns < cupti_start_ns_) {
+      return;
+    }
+    auto args = activity.args;
+    if (external_id != 0) {
+      auto it = node_names_.find(external_id);
+      if (it == node_names_.end()) {
+        // the work of another session
+        return;
+      }
+      args.emplace("parent_name", it->second);
+    }
+    // a row per stream in the trace
+    events.emplace_back(profiling::KERNEL_EVENT, pid, static_cast<int>(activity.stream_id), activity.name,
+                        host_start_us + static_cast<long long>((activity.start_ns - cupti_start_ns_) / 1000),
+                        static_cast<long long>((activity.end_ns - activity.start_ns) / 1000), std::move(args));
+  });
+
+  node_names_.clear();
+  CuptiActivities::Instance().RemoveClient();
+  enabled_ = false;
+}
+
+void CudaProfiler::Start(uint64_t id, const std::string& node_name) {
+  if (!enabled_) {
+    return;
+  }
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    node_names_.emplace(id, node_name);
+  }
+  cuptiActivityPushExternalCorrelationId(CUPTI_EXTERNAL_CORRELATION_KIND_UNKNOWN, id);
+}
+
+void CudaProfiler::Stop(uint64_t /*id*/) {
+  if (!enabled_) {
+    return;
+  }
+  uint64_t last_id = 0;
+  cuptiActivityPopExternalCorrelationId(CUPTI_EXTERNAL_CORRELATION_KIND_UNKNOWN, &last_id);
+}
+
+}  // namespace onnxruntime
+
+#endif  // ENABLE_CUDA_PROFILING
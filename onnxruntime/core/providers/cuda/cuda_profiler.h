@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifdef ENABLE_CUDA_PROFILING
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/profiler.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+Records the kernels and memory copies run on the CUDA devices with the activity API of CUPTI, which reads their
+start and end times from the devices asynchronously, so the runs are not synchronized with the devices to time them.
+CUPTI traces the whole process: the work is attributed to the nodes of the session through the external correlation
+ids pushed between Start and Stop, and the work submitted outside of any node, such as the copies of the inputs and
+outputs, is given to every session profiling at the time.
+*/
+class CudaProfiler : public profiling::EpProfiler {
+ public:
+  CudaProfiler() = default;
+  ~CudaProfiler() override;
+
+  void StartProfiling(TimePoint profiling_start_time) override;
+  void EndProfiling(TimePoint profiling_start_time, std::vector<EventRecord>& events) override;
+  void Start(uint64_t id, const std::string& node_name) override;
+  void Stop(uint64_t id) override;
+
+ private:
+  bool enabled_{false};
+  // the CUPTI timestamp and the time of the host when profiling started, to time the device events from the latter
+  uint64_t cupti_start_ns_{0};
+  TimePoint host_start_time_;
+
+  // the nodes by the ids of Start
+  OrtMutex mutex_;
+  std::unordered_map<uint64_t, std::string> node_names_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudaProfiler);
+};
+
+}  // namespace onnxruntime
+
+#endif  // ENABLE_CUDA_PROFILING
@@ -3,7 +3,10 @@
 
 #include "core/providers/cuda/cuda_provider_factory.h"
 #include <atomic>
+#include <limits>
 #include "cuda_execution_provider.h"
+#include "cuda_allocator.h"
+#include "core/framework/allocatormgr.h"
 #include "core/session/abi_session_options_impl.h"
 
 using namespace onnxruntime;
@@ -11,28 +14,92 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct CUDAProviderFactory : IExecutionProviderFactory {
-  CUDAProviderFactory(int device_id) : device_id_(device_id) {}
+  CUDAProviderFactory(const CUDAExecutionProviderInfo& info) : info_(info) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  int device_id_;
+  CUDAExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
-  CUDAExecutionProviderInfo info;
-  info.device_id = device_id_;
-  return std::make_unique<CUDAExecutionProvider>(info);
+  return std::make_unique<CUDAExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(const CUDAExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id);
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  return CreateExecutionProviderFactory_CUDA(info);
 }
 
+// The OrtAllocator of an arena of pinned host memory
+struct OrtCudaPinnedAllocator : OrtAllocator {
+  OrtCudaPinnedAllocator() {
+    DeviceAllocatorRegistrationInfo pinned_memory_info(
+        {OrtMemTypeCPUOutput, [](int device_id) { return std::make_unique<CUDAPinnedAllocator>(device_id, CUDA_PINNED); }, std::numeric_limits<size_t>::max()});
+    allocator_ = CreateAllocator(pinned_memory_info, CPU_ALLOCATOR_DEVICE_ID);
+
+    OrtAllocator::version = ORT_API_VERSION;
+    OrtAllocator::Alloc = [](OrtAllocator* this_, size_t size) {
+      return static_cast<OrtCudaPinnedAllocator*>(this_)->allocator_->Alloc(size);
+    };
+    OrtAllocator::Free = [](OrtAllocator* this_, void* p) {
+      static_cast<OrtCudaPinnedAllocator*>(this_)->allocator_->Free(p);
+    };
+    OrtAllocator::Info = [](const OrtAllocator* this_) {
+      return &static_cast<const OrtCudaPinnedAllocator*>(this_)->allocator_->Info();
+    };
+  }
+
+ private:
+  AllocatorPtr allocator_;
+};
+
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id) {
   options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(device_id));
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDAWithStream, _In_ OrtSessionOptions* options,
+                    int device_id, _In_ void* compute_stream) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.compute_stream = static_cast<cudaStream_t>(compute_stream);
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDAWithAlgoCache, _In_ OrtSessionOptions* options,
+                    int device_id, _In_ const ORTCHAR_T* cudnn_algo_cache_filepath) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.cudnn_algo_cache_filepath = cudnn_algo_cache_filepath;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDAWithCachingAllocator, _In_ OrtSessionOptions* options,
+                    int device_id) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.use_caching_allocator = true;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtGetCudaPinnedAllocator, _Outptr_ OrtAllocator** out) {
+  try {
+    static onnxruntime::OrtCudaPinnedAllocator pinned_allocator;
+    *out = &pinned_allocator;
+    return nullptr;
+  } catch (const std::exception& ex) {
+    return OrtCreateStatus(ORT_RUNTIME_EXCEPTION, ex.what());
+  }
+}
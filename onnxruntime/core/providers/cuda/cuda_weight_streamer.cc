@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_weight_streamer.h"
+#include "cuda_common.h"
+
+namespace onnxruntime {
+
+CudaWeightStreamer::CudaWeightStreamer(int device_id, size_t buffer_size, const OrtMemoryInfo& host_location,
+                                       const OrtMemoryInfo& buffer_location)
+    : host_location_(host_location), buffer_location_(buffer_location), buffer_size_(buffer_size) {
+  CUDA_CALL_THROW(cudaSetDevice(device_id));
+  // the buffer lives as long as the session, so it is kept out of the memory arena
+  CUDA_CALL_THROW(cudaMalloc(&buffer_, buffer_size_));
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&copy_stream_, cudaStreamNonBlocking));
+}
+
+CudaWeightStreamer::~CudaWeightStreamer() {
+  // the kernels still reading the buffer must finish first
+  CUDA_CALL(cudaDeviceSynchronize());
+  for (auto& events : slots_) {
+    CUDA_CALL(cudaEventDestroy(events.copied));
+    CUDA_CALL(cudaEventDestroy(events.used));
+  }
+  CUDA_CALL(cudaStreamDestroy(copy_stream_));
+  CUDA_CALL(cudaFree(buffer_));
+}
+
+Status CudaWeightStreamer::GetSlot(int slot, SlotEvents*& events) {
+  while (slots_.size() <= static_cast<size_t>(slot)) {
+    SlotEvents created{nullptr, nullptr};
+    CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&created.copied, cudaEventDisableTiming));
+    CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&created.used, cudaEventDisableTiming));
+    slots_.push_back(created);
+  }
+  events = &slots_[slot];
+  return Status::OK();
+}
+
+Status CudaWeightStreamer::CopyAsync(const Tensor& src, Tensor& dst) {
+  // the initializers are in pinned memory, so the copy doesn't block the host
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes(),
+                                       cudaMemcpyHostToDevice, copy_stream_));
+  return Status::OK();
+}
+
+Status CudaWeightStreamer::RecordCopies(int slot) {
+  SlotEvents* events;
+  ORT_RETURN_IF_ERROR(GetSlot(slot, events));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(events->copied, copy_stream_));
+  return Status::OK();
+}
+
+Status CudaWeightStreamer::WaitForCopies(int slot) {
+  SlotEvents* events;
+  ORT_RETURN_IF_ERROR(GetSlot(slot, events));
+  CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(nullptr, events->copied, 0));
+  return Status::OK();
+}
+
+Status CudaWeightStreamer::RecordUse(int slot) {
+  SlotEvents* events;
+  ORT_RETURN_IF_ERROR(GetSlot(slot, events));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(events->used, nullptr));
+  return Status::OK();
+}
+
+Status CudaWeightStreamer::WaitForUse(int slot) {
+  SlotEvents* events;
+  ORT_RETURN_IF_ERROR(GetSlot(slot, events));
+  CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(copy_stream_, events->used, 0));
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "cuda_pch.h"
+#include "core/framework/weight_streaming.h"
+
+namespace onnxruntime {
+
+// Streams the initializers of the CUDA kernels from pinned host memory into a buffer of device memory, on a copy
+// stream of its own. The kernels run on the default stream.
+class CudaWeightStreamer : public IWeightStreamer {
+ public:
+  // host_location and buffer_location are the pinned and default memory of the CUDA execution provider.
+  CudaWeightStreamer(int device_id, size_t buffer_size, const OrtMemoryInfo& host_location,
+                     const OrtMemoryInfo& buffer_location);
+  ~CudaWeightStreamer() override;
+
+  const OrtMemoryInfo& HostLocation() const override { return host_location_; }
+
+  void* Buffer() const override { return buffer_; }
+  size_t BufferSize() const override { return buffer_size_; }
+  const OrtMemoryInfo& BufferLocation() const override { return buffer_location_; }
+
+  common::Status CopyAsync(const Tensor& src, Tensor& dst) override;
+
+  common::Status RecordCopies(int slot) override;
+  common::Status WaitForCopies(int slot) override;
+
+  common::Status RecordUse(int slot) override;
+  common::Status WaitForUse(int slot) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudaWeightStreamer);
+
+  struct SlotEvents {
+    cudaEvent_t copied;
+    cudaEvent_t used;
+  };
+
+  // the events of slot, created on first use
+  common::Status GetSlot(int slot, SlotEvents*& events);
+
+  const OrtMemoryInfo host_location_;
+  const OrtMemoryInfo buffer_location_;
+  const size_t buffer_size_;
+  void* buffer_ = nullptr;
+  cudaStream_t copy_stream_ = nullptr;
+  std::vector<SlotEvents> slots_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cudnn_algo_cache.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "core/common/metrics.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+void AppendDims(std::ostringstream& key, char prefix, const std::vector<int64_t>& dims) {
+  key << '_' << prefix;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    key << (i == 0 ? "" : "x") << dims[i];
+  }
+}
+}  // namespace
+
+CudnnAlgoCache& CudnnAlgoCache::Instance() {
+  static CudnnAlgoCache cache;
+  return cache;
+}
+
+// The signature names the GPU model, its compute capability and the cudnn version, without spaces.
+const std::string& CudnnAlgoCache::GetDeviceSignature(int device_id) {
+  auto it = device_signatures_.find(device_id);
+  if (it != device_signatures_.end()) {
+    return it->second;
+  }
+
+  cudaDeviceProp prop;
+  CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id));
+  std::string name(prop.name);
+  for (auto& c : name) {
+    if (c == ' ') {
+      c = '-';
+    }
+  }
+
+  std::ostringstream signature;
+  signature << name << "_sm" << prop.major << prop.minor << "_cudnn" << cudnnGetVersion();
+  return device_signatures_.emplace(device_id, signature.str()).first->second;
+}
+
+std::string CudnnAlgoCache::MakeConvKey(int device_id,
+                                        const char* kind,
+                                        cudnnDataType_t data_type,
+                                        const std::vector<int64_t>& x_dims,
+                                        const std::vector<int64_t>& w_dims,
+                                        const std::vector<int64_t>& y_dims,
+                                        const std::vector<int64_t>& pads,
+                                        const std::vector<int64_t>& strides,
+                                        const std::vector<int64_t>& dilations,
+                                        int64_t group) {
+  std::ostringstream key;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    key << GetDeviceSignature(device_id);
+  }
+  key << '_' << kind << "_t" << static_cast<int>(data_type);
+  AppendDims(key, 'x', x_dims);
+  AppendDims(key, 'w', w_dims);
+  AppendDims(key, 'y', y_dims);
+  AppendDims(key, 'p', pads);
+  AppendDims(key, 's', strides);
+  AppendDims(key, 'd', dilations);
+  key << "_g" << group;
+  return key.str();
+}
+
+bool CudnnAlgoCache::Lookup(const std::string& key, Result& result) const {
+  static metrics::Counter& hits = metrics::MetricsRegistry::Global().GetCounter(
+      "onnxruntime_cudnn_algo_cache_hits_total", "Lookups of the cuDNN algorithm cache which found a result.");
+  static metrics::Counter& misses = metrics::MetricsRegistry::Global().GetCounter(
+      "onnxruntime_cudnn_algo_cache_misses_total", "Lookups of the cuDNN algorithm cache which had to benchmark.");
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = results_.find(key);
+  if (it == results_.end()) {
+    misses.Increment();
+    return false;
+  }
+  hits.Increment();
+  result = it->second;
+  return true;
+}
+
+void CudnnAlgoCache::Insert(const std::string& key, const Result& result) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  results_[key] = result;
+  modified_ = true;
+}
+
+common::Status CudnnAlgoCache::Load(const std::basic_string<ORTCHAR_T>& path) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  return LoadLocked(path);
+}
+
+// The file holds a line per result, with the key followed by the algorithm, the workspace size and the math type.
+// Keys don't contain spaces. The results in the cache take precedence over the ones in the file.
+common::Status CudnnAlgoCache::LoadLocked(const std::basic_string<ORTCHAR_T>& path) {
+  std::ifstream stream(path);
+  if (!stream) {
+    return common::Status::OK();
+  }
+
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string key;
+    Result result;
+    if (!(fields >> key >> result.algo >> result.memory >> result.math_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid cudnn algorithm cache entry: ", line);
+    }
+    results_.emplace(key, result);
+  }
+  return common::Status::OK();
+}
+
+common::Status CudnnAlgoCache::Save(const std::basic_string<ORTCHAR_T>& path) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (!modified_) {
+    return common::Status::OK();
+  }
+
+  // keep the results other processes saved since the file was loaded
+  ORT_RETURN_IF_ERROR(LoadLocked(path));
+
+  std::ofstream stream(path, std::ios::out | std::ios::trunc);
+  if (!stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the cudnn algorithm cache file for writing.");
+  }
+
+  for (const auto& result : results_) {
+    stream << result.first << ' ' << result.second.algo << ' ' << result.second.memory << ' '
+           << result.second.math_type << '\n';
+  }
+  stream.flush();
+  if (!stream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the cudnn algorithm cache file.");
+  }
+  modified_ = false;
+  return common::Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
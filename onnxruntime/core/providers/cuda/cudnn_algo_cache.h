@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+#include "cuda_pch.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// CudnnAlgoCache holds the cudnn algorithms the kernels found by benchmarking, such as with
+// cudnnFindConvolutionForwardAlgorithmEx, for the kernels of all the sessions in the process. It can be saved to a
+// file and loaded again, so later processes skip the benchmarks. The keys start with the GPU model and the cudnn
+// version, so a file can be shared by machines with different GPUs, and each only uses the entries that match it.
+// Thread-safe.
+class CudnnAlgoCache final {
+ public:
+  struct Result {
+    int algo;
+    size_t memory;
+    int math_type;
+  };
+
+  static CudnnAlgoCache& Instance();
+
+  // returns the key of a convolution of the given kind, such as "conv_fwd", on the device.
+  std::string MakeConvKey(int device_id,
+                          const char* kind,
+                          cudnnDataType_t data_type,
+                          const std::vector<int64_t>& x_dims,
+                          const std::vector<int64_t>& w_dims,
+                          const std::vector<int64_t>& y_dims,
+                          const std::vector<int64_t>& pads,
+                          const std::vector<int64_t>& strides,
+                          const std::vector<int64_t>& dilations,
+                          int64_t group);
+
+  // returns true and sets result if the cache holds a result for key.
+  bool Lookup(const std::string& key, Result& result) const;
+
+  void Insert(const std::string& key, const Result& result);
+
+  // loads the results saved to path by Save. A missing file leaves the cache unchanged.
+  common::Status Load(const std::basic_string<ORTCHAR_T>& path);
+
+  // saves the results to path, together with the ones other processes saved to it, if results were inserted since
+  // the last Save.
+  common::Status Save(const std::basic_string<ORTCHAR_T>& path);
+
+ private:
+  CudnnAlgoCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnAlgoCache);
+
+  const std::string& GetDeviceSignature(int device_id);
+
+  common::Status LoadLocked(const std::basic_string<ORTCHAR_T>& path);
+
+  mutable OrtMutex lock_;
+  std::map<std::string, Result> results_;
+  std::unordered_map<int, std::string> device_signatures_;
+  bool modified_ = false;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -41,6 +41,22 @@ Status CudnnTensor::Set(const std::vector<int64_t>& input_dims, cudnnDataType_t
   return Status::OK();
 }
 
+Status CudnnTensor::Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType, cudnnTensorFormat_t format) {
+  if (format == CUDNN_TENSOR_NCHW) {
+    return Set(input_dims, dataType);
+  }
+
+  ORT_RETURN_IF_ERROR(CreateTensorIfNeeded());
+
+  int rank = gsl::narrow_cast<int>(input_dims.size());
+  std::vector<int> dims(rank);
+  for (int i = 0; i < rank; i++) {
+    dims[i] = gsl::narrow_cast<int>(input_dims[i]);
+  }
+  CUDNN_RETURN_IF_ERROR(cudnnSetTensorNdDescriptorEx(tensor_, format, dataType, rank, dims.data()));
+  return Status::OK();
+}
+
 Status CudnnTensor::Set(const CudnnTensor& x_desc, cudnnBatchNormMode_t mode) {
   ORT_RETURN_IF_ERROR(CreateTensorIfNeeded());
   CUDNN_RETURN_IF_ERROR(cudnnDeriveBNTensorDescriptor(tensor_, x_desc, mode));
@@ -106,7 +122,8 @@ CudnnFilterDescriptor::~CudnnFilterDescriptor() {
   }
 }
 
-Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_type) {
+Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_type,
+                                  cudnnTensorFormat_t format) {
   if (!desc_)
     CUDNN_RETURN_IF_ERROR(cudnnCreateFilterDescriptor(&desc_));
 
@@ -118,12 +135,25 @@ Status CudnnFilterDescriptor::Set(const std::vector<int64_t>& filter_dims, cudnn
 
   CUDNN_RETURN_IF_ERROR(cudnnSetFilterNdDescriptor(desc_,
                                                    data_type,
-                                                   CUDNN_TENSOR_NCHW,
+                                                   format,
                                                    rank,
                                                    w_dims.data()));
   return Status::OK();
 }
 
+std::vector<int64_t> ChannelsLastToNchwDims(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> nchw_dims{dims.front(), dims.back()};
+  nchw_dims.insert(nchw_dims.end(), dims.begin() + 1, dims.end() - 1);
+  return nchw_dims;
+}
+
+std::vector<int64_t> NchwToChannelsLastDims(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> channels_last_dims{dims.front()};
+  channels_last_dims.insert(channels_last_dims.end(), dims.begin() + 2, dims.end());
+  channels_last_dims.push_back(dims[1]);
+  return channels_last_dims;
+}
+
 template cudnnDataType_t CudnnTensor::GetDataType<float>();
 template cudnnDataType_t CudnnTensor::GetDataType<double>();
 template cudnnDataType_t CudnnTensor::GetDataType<half>();
@@ -15,6 +15,8 @@ class CudnnTensor final {
   ~CudnnTensor();
 
   Status Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType);
+  // input_dims are in the NCHW order whatever the format, which is the layout of the tensor in memory
+  Status Set(const std::vector<int64_t>& input_dims, cudnnDataType_t dataType, cudnnTensorFormat_t format);
   Status Set(const CudnnTensor& x_desc, cudnnBatchNormMode_t mode);
 
   operator cudnnTensorDescriptor_t() const { return tensor_; }
@@ -28,6 +30,13 @@ class CudnnTensor final {
   cudnnTensorDescriptor_t tensor_;
 };
 
+// The dimensions of a channels-last tensor, (N, D1, ..., Dn, C), in the NCHW order cuDNN describes it with the
+// CUDNN_TENSOR_NHWC format: (N, C, D1, ..., Dn).
+std::vector<int64_t> ChannelsLastToNchwDims(const std::vector<int64_t>& dims);
+
+// The inverse of ChannelsLastToNchwDims: (N, C, D1, ..., Dn) to (N, D1, ..., Dn, C).
+std::vector<int64_t> NchwToChannelsLastDims(const std::vector<int64_t>& dims);
+
 class CudnnDataTensor final {
  public:
   CudnnDataTensor();
@@ -52,7 +61,9 @@ class CudnnFilterDescriptor final {
   CudnnFilterDescriptor();
   ~CudnnFilterDescriptor();
 
-  Status Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_typ);
+  // filter_dims are in the KCRS order whatever the format, which is the layout of the filter in memory
+  Status Set(const std::vector<int64_t>& filter_dims, cudnnDataType_t data_typ,
+             cudnnTensorFormat_t format = CUDNN_TENSOR_NCHW);
 
   operator cudnnFilterDescriptor_t() const { return desc_; }
 
@@ -4,8 +4,16 @@
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
 
+#include <set>
+#include <utility>
+
 namespace onnxruntime {
-GPUDataTransfer::GPUDataTransfer() {
+
+// the most memory staged for the copies in flight. larger copies block instead, so copying the initializers of a
+// big model doesn't grow the pinned memory arena to their size.
+static constexpr size_t kMaxStagingBytes = 64 * 1024 * 1024;
+
+GPUDataTransfer::GPUDataTransfer(AllocatorPtr pinned_allocator) : pinned_allocator_(std::move(pinned_allocator)) {
   // create streams, default is nullptr
   streams_[kCudaStreamDefault] = nullptr;
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyIn], cudaStreamNonBlocking));
@@ -13,10 +21,84 @@ GPUDataTransfer::GPUDataTransfer() {
 }
 
 GPUDataTransfer::~GPUDataTransfer() {
+  {
+    std::lock_guard<OrtMutex> lock(staging_mutex_);
+    ReleaseStagingBuffers(true);
+    for (auto event : free_events_) {
+      CUDA_CALL(cudaEventDestroy(event));
+    }
+  }
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
   CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyOut]));
 }
 
+void GPUDataTransfer::ReleaseStagingBuffers(bool wait) const {
+  auto it = staging_buffers_.begin();
+  while (it != staging_buffers_.end()) {
+    if (wait) {
+      CUDA_CALL(cudaEventSynchronize(it->copied));
+    } else if (cudaEventQuery(it->copied) != cudaSuccess) {
+      ++it;
+      continue;
+    }
+    pinned_allocator_->Free(it->p);
+    staging_bytes_ -= it->bytes;
+    free_events_.push_back(it->copied);
+    it = staging_buffers_.erase(it);
+  }
+}
+
+common::Status GPUDataTransfer::StageCopyToGPU(const void* src_data, void* dst_data, size_t bytes,
+                                               cudaStream_t stream, bool& staged) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  ReleaseStagingBuffers(false);
+  staged = staging_bytes_ + bytes <= kMaxStagingBytes;
+  if (!staged) {
+    return Status::OK();
+  }
+
+  StagingBuffer buffer{pinned_allocator_->Alloc(bytes), bytes, nullptr};
+  if (free_events_.empty()) {
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&buffer.copied, cudaEventDisableTiming));
+  } else {
+    buffer.copied = free_events_.back();
+    free_events_.pop_back();
+  }
+  // the buffer is released by the next call if the copy fails, as the event hasn't been recorded again
+  staging_buffers_.push_back(buffer);
+  staging_bytes_ += bytes;
+
+  memcpy(buffer.p, src_data, bytes);
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, buffer.p, bytes, cudaMemcpyHostToDevice, stream));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copied, stream));
+  return Status::OK();
+}
+
+// lets device read the memory of peer_device directly, once per pair of devices, so the copies between them don't
+// go through the host. copies between devices without peer access still work, through the host.
+static void EnablePeerAccess(int device, int peer_device) {
+  static OrtMutex mutex;
+  static std::set<std::pair<int, int>> checked;
+  std::lock_guard<OrtMutex> lock(mutex);
+  if (!checked.insert({device, peer_device}).second) {
+    return;
+  }
+
+  int can_access = 0;
+  if (cudaDeviceCanAccessPeer(&can_access, device, peer_device) != cudaSuccess || !can_access) {
+    cudaGetLastError();
+    return;
+  }
+  int current_device = 0;
+  CUDA_CALL(cudaGetDevice(&current_device));
+  CUDA_CALL(cudaSetDevice(device));
+  // fails if another library enabled it already
+  if (cudaDeviceEnablePeerAccess(peer_device, 0) != cudaSuccess) {
+    cudaGetLastError();
+  }
+  CUDA_CALL(cudaSetDevice(current_device));
+}
+
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::GPU || src_device.MemType() == OrtDevice::MemType::CUDA_PINNED
          || dst_device.Type() == OrtDevice::GPU || dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED;
@@ -34,12 +116,27 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
     if (src_device.Type() == OrtDevice::CPU && src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copy from pinned memory to GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+    } else if (src_device.Type() == OrtDevice::GPU && src_device.Id() != dst_device.Id()) {
+      // copying between the memory of two GPUs, such as the stages of a PipelineParallelSession. the kernels of the
+      // session producing src ran on the other device, so this waits for the work queued on both devices.
+      EnablePeerAccess(dst_device.Id(), src_device.Id());
+      CUDA_RETURN_IF_ERROR(cudaMemcpyPeer(dst_data, dst_device.Id(), src_data, src_device.Id(), bytes));
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU. if the copy is staged in pinned memory it is non-blocking, and the default
+      // queue uses the legacy stream, so the kernels of every thread wait for it. otherwise this is blocking.
+      // the copy stream is used so the fences are honored.
+      bool staged = false;
+      if (pinned_allocator_ != nullptr && bytes > 0) {
+        cudaStream_t stream = exec_queue_id == kCudaStreamDefault ? cudaStreamLegacy : streams_[exec_queue_id];
+        ORT_RETURN_IF_ERROR(StageCopyToGPU(src_data, dst_data, bytes, stream, staged));
+      }
+      if (!staged) {
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+        CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[exec_queue_id]));
+      }
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
@@ -47,7 +144,8 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
     } else {
       // copying from GPU to CPU memory, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[exec_queue_id]));
     }
   } else {
     // copying between cpu memory
@@ -3,8 +3,13 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "cuda_pch.h"
+#include "core/framework/allocator.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -15,9 +20,11 @@ enum CUDAStreamType : int {
   kTotalCudaStreams,
 };
 
+// Copies from pageable host memory to the GPU are staged in memory of pinned_allocator, if given, so they don't
+// block the host until the copy finishes. A staging buffer goes back to the allocator once its copy is done.
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer();
+  explicit GPUDataTransfer(AllocatorPtr pinned_allocator = nullptr);
   ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
@@ -30,7 +37,26 @@ class GPUDataTransfer : public IDataTransfer {
   }
 
  private:
+  struct StagingBuffer {
+    void* p;
+    size_t bytes;
+    cudaEvent_t copied;
+  };
+
+  // sets staged to false if the copy should block instead, because too much memory is staged already.
+  common::Status StageCopyToGPU(const void* src_data, void* dst_data, size_t bytes, cudaStream_t stream,
+                                bool& staged) const;
+
+  // frees the staging buffers whose copies finished, or all of them after waiting for the copies if wait is true.
+  void ReleaseStagingBuffers(bool wait) const;
+
   cudaStream_t streams_[kTotalCudaStreams];
+
+  AllocatorPtr pinned_allocator_;
+  mutable OrtMutex staging_mutex_;
+  mutable std::deque<StagingBuffer> staging_buffers_;
+  mutable std::vector<cudaEvent_t> free_events_;
+  mutable size_t staging_bytes_ = 0;
 };
 
 }  // namespace onnxruntime
@@ -8,7 +8,7 @@
 namespace onnxruntime {
 namespace cuda {
 template <typename T>
-class Gemm final : public CudaKernel {
+class Gemm : public CudaKernel {
   using Base = CudaKernel;
 
  public:
@@ -26,7 +26,7 @@ class Gemm final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
- private:
+ protected:
   bool trans_A_;
   bool trans_B_;
   float alpha_;
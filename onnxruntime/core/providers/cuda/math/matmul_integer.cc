@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "matmul_integer.h"
+#include "matmul_integer_impl.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the zero points and the scales are scalars, so they are read on the CPU and passed to the kernel by value
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulInteger,
+    kOnnxDomain,
+    10,
+    uint8_t,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    MatMulInteger<uint8_t, uint8_t>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulInteger,
+    kOnnxDomain,
+    10,
+    int8_t,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    MatMulInteger<uint8_t, int8_t>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearMatMul,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(4)
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6)
+        .InputMemoryType<OrtMemTypeCPUInput>(7)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMatMul<uint8_t, uint8_t, uint8_t>);
+
+namespace {
+template <typename T>
+Status GetScalar(const Tensor* tensor, const char* name, T default_value, T& value) {
+  if (tensor == nullptr) {
+    value = default_value;
+    return Status::OK();
+  }
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(tensor), name, " must be a scalar or 1D tensor of size 1.");
+  value = *tensor->template Data<T>();
+  return Status::OK();
+}
+
+// runs the batch as a single launch when its matrices are evenly spaced, and a launch per matrix otherwise
+template <typename TA, typename TB, typename TY>
+void ComputeMatMulInteger(const MatMulComputeHelper& helper,
+                          const Tensor& a, TA a_zero_point,
+                          const Tensor& b, TB b_zero_point,
+                          Tensor& y, float y_multiplier, TY y_zero_point) {
+  const int M = static_cast<int>(helper.M());
+  const int N = static_cast<int>(helper.N());
+  const int K = static_cast<int>(helper.K());
+  const TA* a_data = a.template Data<TA>();
+  const TB* b_data = b.template Data<TB>();
+  TY* y_data = y.template MutableData<TY>();
+
+  size_t a_stride, b_stride, y_stride;
+  if (helper.BatchStrides(a_stride, b_stride, y_stride)) {
+    MatMulIntegerImpl<TA, TB, TY>(M, N, K,
+                                  a_data, static_cast<int64_t>(a_stride), a_zero_point,
+                                  b_data, static_cast<int64_t>(b_stride), b_zero_point,
+                                  y_data, static_cast<int64_t>(y_stride),
+                                  static_cast<int>(helper.OutputOffsets().size()), y_multiplier, y_zero_point);
+    return;
+  }
+
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    MatMulIntegerImpl<TA, TB, TY>(M, N, K,
+                                  a_data + helper.LeftOffsets()[i], 0, a_zero_point,
+                                  b_data + helper.RightOffsets()[i], 0, b_zero_point,
+                                  y_data + helper.OutputOffsets()[i], 0,
+                                  1, y_multiplier, y_zero_point);
+  }
+}
+}  // namespace
+
+template <typename T1, typename T2>
+Status MatMulInteger<T1, T2>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (helper.OutputShape().Size() == 0) {
+    return Status::OK();
+  }
+
+  T1 a_zero_point;
+  T2 b_zero_point;
+  ORT_RETURN_IF_ERROR(GetScalar<T1>(ctx->Input<Tensor>(2), "a_zero_point", 0, a_zero_point));
+  ORT_RETURN_IF_ERROR(GetScalar<T2>(ctx->Input<Tensor>(3), "b_zero_point", 0, b_zero_point));
+
+  ComputeMatMulInteger<T1, T2, int32_t>(helper, *a, a_zero_point, *b, b_zero_point, *y, 1.0f, 0);
+  return Status::OK();
+}
+
+// formula is Y = (A - a_zero_point) * (B - b_zero_point) * a_scale * b_scale / y_scale + y_zero_point
+template <typename T1, typename T2, typename T3>
+Status QLinearMatMul<T1, T2, T3>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(3);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (helper.OutputShape().Size() == 0) {
+    return Status::OK();
+  }
+
+  float a_scale, b_scale, y_scale;
+  T1 a_zero_point;
+  T2 b_zero_point;
+  T3 y_zero_point;
+  ORT_RETURN_IF_ERROR(GetScalar<float>(ctx->Input<Tensor>(1), "a_scale", 1.0f, a_scale));
+  ORT_RETURN_IF_ERROR(GetScalar<T1>(ctx->Input<Tensor>(2), "a_zero_point", 0, a_zero_point));
+  ORT_RETURN_IF_ERROR(GetScalar<float>(ctx->Input<Tensor>(4), "b_scale", 1.0f, b_scale));
+  ORT_RETURN_IF_ERROR(GetScalar<T2>(ctx->Input<Tensor>(5), "b_zero_point", 0, b_zero_point));
+  ORT_RETURN_IF_ERROR(GetScalar<float>(ctx->Input<Tensor>(6), "y_scale", 1.0f, y_scale));
+  ORT_RETURN_IF_ERROR(GetScalar<T3>(ctx->Input<Tensor>(7), "y_zero_point", 0, y_zero_point));
+
+  ComputeMatMulInteger<T1, T2, T3>(helper, *a, a_zero_point, *b, b_zero_point, *y,
+                                   a_scale * b_scale / y_scale, y_zero_point);
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "matmul_integer_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+constexpr int kTileSize = 16;
+
+// uint8 values are offset by -128 to int8, which keeps the differences with the zero points, so both types use the
+// signed dot products
+__device__ __forceinline__ int8_t ToInt8(uint8_t v) { return static_cast<int8_t>(v ^ 0x80); }
+__device__ __forceinline__ int8_t ToInt8(int8_t v) { return v; }
+
+inline int ToInt8Offset(uint8_t v) { return static_cast<int>(v) - 128; }
+inline int ToInt8Offset(int8_t v) { return static_cast<int>(v); }
+
+// adds the dot product of the 4 signed bytes packed in a and b to c, with dp4a where the GPU has it
+__device__ __forceinline__ int Dot4(int a, int b, int c) {
+#if __CUDA_ARCH__ >= 610
+  return __dp4a(a, b, c);
+#else
+  for (int i = 0; i < 4; ++i) {
+    c += static_cast<int>(static_cast<int8_t>(a >> (8 * i))) * static_cast<int>(static_cast<int8_t>(b >> (8 * i)));
+  }
+  return c;
+#endif
+}
+
+__device__ __forceinline__ void Store(int32_t& y, int value, float, int32_t) {
+  y = value;
+}
+
+__device__ __forceinline__ void Store(uint8_t& y, int value, float multiplier, uint8_t zero_point) {
+  float v = rintf(static_cast<float>(value) * multiplier) + static_cast<float>(zero_point);
+  y = static_cast<uint8_t>(fminf(fmaxf(v, 0.0f), 255.0f));
+}
+}  // namespace
+
+// Each block computes a tile of Y, reading the K dimension a tile at a time, with the int8 values of A and B packed 4
+// to an int so a thread multiplies 4 of them per dp4a. The row sums of A and the column sums of B, which apply the
+// zero points as Y = A * B - b_zero_point * rowsum(A) - a_zero_point * colsum(B) + K * a_zero_point * b_zero_point,
+// come from dp4a against ones. Values past the edges of the matrices are 0, which leaves all the sums unchanged.
+template <typename TA, typename TB, typename TY>
+__global__ void _MatMulIntegerKernel(
+    const int M,
+    const int N,
+    const int K,
+    const TA* a,
+    const int64_t a_stride,
+    const int a_zero_point,
+    const TB* b,
+    const int64_t b_stride,
+    const int b_zero_point,
+    TY* y,
+    const int64_t y_stride,
+    const float y_multiplier,
+    const TY y_zero_point) {
+  // the rows of the A tile and the columns of the B tile, 4 values of K to an int
+  __shared__ int a_tile[kTileSize][kTileSize / 4];
+  __shared__ int b_tile[kTileSize][kTileSize / 4];
+
+  const int tx = threadIdx.x;
+  const int ty = threadIdx.y;
+  const int row = blockIdx.y * kTileSize + ty;
+  const int col = blockIdx.x * kTileSize + tx;
+  a += blockIdx.z * a_stride;
+  b += blockIdx.z * b_stride;
+  y += blockIdx.z * y_stride;
+
+  int dot = 0;
+  int a_sum = 0;
+  int b_sum = 0;
+  for (int k = 0; k < K; k += kTileSize) {
+    reinterpret_cast<int8_t*>(a_tile[ty])[tx] = (row < M && k + tx < K) ? ToInt8(a[row * K + k + tx]) : 0;
+    reinterpret_cast<int8_t*>(b_tile[tx])[ty] = (col < N && k + ty < K) ? ToInt8(b[(k + ty) * N + col]) : 0;
+    __syncthreads();
+
+#pragma unroll
+    for (int i = 0; i < kTileSize / 4; ++i) {
+      const int a_packed = a_tile[ty][i];
+      const int b_packed = b_tile[tx][i];
+      dot = Dot4(a_packed, b_packed, dot);
+      a_sum = Dot4(a_packed, 0x01010101, a_sum);
+      b_sum = Dot4(b_packed, 0x01010101, b_sum);
+    }
+    __syncthreads();
+  }
+
+  if (row < M && col < N) {
+    const int value = dot - b_zero_point * a_sum - a_zero_point * b_sum + K * a_zero_point * b_zero_point;
+    Store(y[row * N + col], value, y_multiplier, y_zero_point);
+  }
+}
+
+template <typename TA, typename TB, typename TY>
+void MatMulIntegerImpl(
+    int M,
+    int N,
+    int K,
+    const TA* a,
+    int64_t a_stride,
+    TA a_zero_point,
+    const TB* b,
+    int64_t b_stride,
+    TB b_zero_point,
+    TY* y,
+    int64_t y_stride,
+    int batch_count,
+    float y_multiplier,
+    TY y_zero_point) {
+  dim3 threads(kTileSize, kTileSize);
+  dim3 blocks((N + kTileSize - 1) / kTileSize, (M + kTileSize - 1) / kTileSize, batch_count);
+  _MatMulIntegerKernel<TA, TB, TY><<<blocks, threads, 0>>>(
+      M, N, K, a, a_stride, ToInt8Offset(a_zero_point), b, b_stride, ToInt8Offset(b_zero_point),
+      y, y_stride, y_multiplier, y_zero_point);
+}
+
+#define SPECIALIZED_IMPL(TA, TB, TY)                                                                    \
+  template void MatMulIntegerImpl<TA, TB, TY>(int M, int N, int K, const TA* a, int64_t a_stride,     \
+                                              TA a_zero_point, const TB* b, int64_t b_stride,         \
+                                              TB b_zero_point, TY* y, int64_t y_stride,               \
+                                              int batch_count, float y_multiplier, TY y_zero_point);
+
+SPECIALIZED_IMPL(uint8_t, uint8_t, int32_t)
+SPECIALIZED_IMPL(uint8_t, int8_t, int32_t)
+SPECIALIZED_IMPL(uint8_t, uint8_t, uint8_t)
+
+}  // namespace cuda
+}  // namespace onnxruntime
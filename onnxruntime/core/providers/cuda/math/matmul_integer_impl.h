@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// Computes batch_count row major products Y = (A - a_zero_point) * (B - b_zero_point) of M x K and K x N matrices,
+// with the matrices of a batch at multiples of the strides. Y is int32_t, or a quantized type, in which case the
+// product is requantized as Y = product * y_multiplier + y_zero_point, saturated.
+template <typename TA, typename TB, typename TY>
+void MatMulIntegerImpl(
+    int M,
+    int N,
+    int K,
+    const TA* a,
+    int64_t a_stride,
+    TA a_zero_point,
+    const TB* b,
+    int64_t b_stride,
+    TB b_zero_point,
+    TY* y,
+    int64_t y_stride,
+    int batch_count,
+    float y_multiplier,
+    TY y_zero_point);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "softmax.h"
+#include "softmax_impl.h"
 #include "core/providers/common.h"
 #include "core/providers/cuda/cudnn_common.h"
 
@@ -35,6 +36,12 @@ Status Softmax<T>::ComputeInternal(OpKernelContext* ctx) const {
   auto y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
   auto x_data = reinterpret_cast<const CudaT*>(X.template Data<T>());
 
+  // the rows that fit the hand-written kernel skip the descriptor setup of cudnn, which dominates small inputs
+  if (D <= kSoftmaxImplMaxRowSize && input_shape.Size() <= std::numeric_limits<int>::max()) {
+    SoftmaxImpl<CudaT>(x_data, y_data, static_cast<int>(N), static_cast<int>(D));
+    return Status::OK();
+  }
+
   const auto alpha = Consts<CudaT>::One;
   const auto beta = Consts<CudaT>::Zero;
   CudnnTensor input_tensor;
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <math_constants.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cu_inc/block_reduce.cuh"
+#include "softmax_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+constexpr int kWarpsPerBlock = 4;
+constexpr int kMaxThreadsPerBlock = 512;
+// rows up to this size are computed by a warp, longer ones by a block
+constexpr int kWarpRowSize = 1024;
+
+template <typename T>
+struct AccumulationType { typedef T type; };
+template <>
+struct AccumulationType<half> { typedef float type; };
+}  // namespace
+
+// Each warp computes the softmax of one row.
+template <typename T>
+__global__ void _SoftmaxWarpKernel(const T* input_data, T* output_data, int rows, int row_size) {
+  typedef typename AccumulationType<T>::type AccT;
+  const int row = blockIdx.x * kWarpsPerBlock + threadIdx.x / kWarpSize;
+  if (row >= rows) {
+    return;
+  }
+  const int lane = threadIdx.x % kWarpSize;
+  const T* input = input_data + static_cast<int64_t>(row) * row_size;
+  T* output = output_data + static_cast<int64_t>(row) * row_size;
+
+  AccT max_value = -CUDART_INF_F;
+  for (int i = lane; i < row_size; i += kWarpSize) {
+    max_value = MaxOp()(max_value, static_cast<AccT>(input[i]));
+  }
+  max_value = WarpAllReduce(max_value, MaxOp());
+
+  AccT sum = 0;
+  for (int i = lane; i < row_size; i += kWarpSize) {
+    sum += _Exp(static_cast<AccT>(input[i]) - max_value);
+  }
+  const AccT inv_sum = AccT(1) / WarpAllReduce(sum, SumOp());
+
+  for (int i = lane; i < row_size; i += kWarpSize) {
+    output[i] = static_cast<T>(_Exp(static_cast<AccT>(input[i]) - max_value) * inv_sum);
+  }
+}
+
+// Each block computes the softmax of one row.
+template <typename T>
+__global__ void _SoftmaxBlockKernel(const T* input_data, T* output_data, int row_size) {
+  typedef typename AccumulationType<T>::type AccT;
+  const T* input = input_data + static_cast<int64_t>(blockIdx.x) * row_size;
+  T* output = output_data + static_cast<int64_t>(blockIdx.x) * row_size;
+
+  AccT max_value = -CUDART_INF_F;
+  for (int i = threadIdx.x; i < row_size; i += blockDim.x) {
+    max_value = MaxOp()(max_value, static_cast<AccT>(input[i]));
+  }
+  max_value = BlockReduce(max_value, MaxOp(), AccT(-CUDART_INF_F));
+
+  AccT sum = 0;
+  for (int i = threadIdx.x; i < row_size; i += blockDim.x) {
+    sum += _Exp(static_cast<AccT>(input[i]) - max_value);
+  }
+  const AccT inv_sum = AccT(1) / BlockReduce(sum, SumOp(), AccT(0));
+
+  for (int i = threadIdx.x; i < row_size; i += blockDim.x) {
+    output[i] = static_cast<T>(_Exp(static_cast<AccT>(input[i]) - max_value) * inv_sum);
+  }
+}
+
+template <typename T>
+void SoftmaxImpl(const T* input_data, T* output_data, int rows, int row_size) {
+  if (rows == 0) {
+    return;
+  }
+
+  if (row_size <= kWarpRowSize) {
+    const int blocks = (rows + kWarpsPerBlock - 1) / kWarpsPerBlock;
+    _SoftmaxWarpKernel<T><<<blocks, kWarpsPerBlock * kWarpSize, 0>>>(input_data, output_data, rows, row_size);
+    return;
+  }
+
+  const int threads = std::min(kMaxThreadsPerBlock, (row_size + kWarpSize - 1) / kWarpSize * kWarpSize);
+  _SoftmaxBlockKernel<T><<<rows, threads, 0>>>(input_data, output_data, row_size);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void SoftmaxImpl<T>(const T* input_data, T* output_data, int rows, int row_size);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
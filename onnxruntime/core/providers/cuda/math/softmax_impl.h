@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// The longest rows SoftmaxImpl computes. Longer ones, which have few rows per element, go to cudnnSoftmaxForward.
+constexpr int64_t kSoftmaxImplMaxRowSize = 16384;
+
+// Computes the softmax of each row of the rows x row_size input, accumulating in float for half.
+template <typename T>
+void SoftmaxImpl(const T* input_data, T* output_data, int rows, int row_size);
+
+}  // namespace cuda
+}  // namespace onnxruntime
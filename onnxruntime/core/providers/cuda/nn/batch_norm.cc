@@ -49,7 +49,7 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
   const Tensor* mean = p_op_kernel_context->Input<Tensor>(3);
   const Tensor* var = p_op_kernel_context->Input<Tensor>(4);
 
-  ORT_RETURN_IF_ERROR(BatchNormHelper::ValidateInputs(X, scale, B, mean, var));
+  ORT_RETURN_IF_ERROR(BatchNormHelper::ValidateInputs(X, scale, B, mean, var, channels_last_));
 
   const TensorShape& x_shape = X->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
@@ -64,10 +64,17 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
   const auto alpha = Consts<CudaT>::One;
   const auto beta = Consts<CudaT>::Zero;
 
+  // cuDNN takes the dimensions of NHWC tensors in the NCHW order, with the NHWC format
   CudnnTensor data_desc;
   vector<int64_t> new_dims;
-  BatchNormHelper::NormalizeDims(x_shape, new_dims);
-  ORT_RETURN_IF_ERROR(data_desc.Set(new_dims, CudnnTensor::GetDataType<CudaT>()));
+  if (channels_last_) {
+    ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
+    BatchNormHelper::NormalizeDims(TensorShape(ChannelsLastToNchwDims(x_shape.GetDims())), new_dims);
+  } else {
+    BatchNormHelper::NormalizeDims(x_shape, new_dims);
+  }
+  ORT_RETURN_IF_ERROR(data_desc.Set(new_dims, CudnnTensor::GetDataType<CudaT>(),
+                                    channels_last_ ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW));
 
   // For half data type, the alpha, beta, scale, B, mean, var need to be float type
   if (X->DataType() == DataTypeImpl::GetType<MLFloat16>()) {
@@ -77,7 +84,7 @@ Status BatchNorm<T>::ComputeInternal(OpKernelContext* p_op_kernel_context) const
     ORT_RETURN_IF_ERROR(bn_tensor_desc.Set(data_desc, cudnn_batch_norm_mode_));
 
     // Convert the scale, B, mean, var to float
-    const int64_t C = x_shape.GetDims()[1];
+    const int64_t C = new_dims[1];
     auto f_scale = GetScratchBuffer<float>(C);
     auto f_B = GetScratchBuffer<float>(C);
     auto f_mean = GetScratchBuffer<float>(C);
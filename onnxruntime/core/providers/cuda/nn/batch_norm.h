@@ -14,7 +14,8 @@ class BatchNorm final : public CudaKernel {
  public:
   BatchNorm(const OpKernelInfo& op_kernel_info)
       : CudaKernel{op_kernel_info},
-        cudnn_batch_norm_mode_(CUDNN_BATCHNORM_SPATIAL) {
+        cudnn_batch_norm_mode_(CUDNN_BATCHNORM_SPATIAL),
+        channels_last_(op_kernel_info.GetKernelDef().OpName() == "NhwcBatchNormalization") {
     float tmp_epsilon;
     ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &tmp_epsilon).IsOK());
     epsilon_ = ClampCudnnBatchNormEpsilon(tmp_epsilon);
@@ -36,6 +37,8 @@ class BatchNorm final : public CudaKernel {
   double epsilon_;
   int64_t spatial_ = 1;  // default as per spec
   cudnnBatchNormMode_t cudnn_batch_norm_mode_;
+  // set for NhwcBatchNormalization, whose X and Y are in the NHWC layout
+  const bool channels_last_;
 };
 
 }  // namespace cuda
@@ -3,6 +3,7 @@
 
 #include "core/providers/common.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/cudnn_algo_cache.h"
 #include "core/providers/cuda/nn/conv.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 
@@ -24,7 +25,7 @@ REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
 template <typename T>
-Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
+Status Conv<T>::UpdateState(OpKernelContext* context, Tensor*& Y) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
 
   const Tensor* X = context->Input<Tensor>(0);
@@ -37,11 +38,9 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
   std::vector<int64_t> w_dims = w_shape.GetDims();
   auto w_data = reinterpret_cast<const CudaT*>(W->template Data<T>());
 
-  size_t num_inputs = OpKernel::Node().InputDefs().size();
-  bool has_bias = (num_inputs == 3);
-
-  CudaT* y_data = nullptr;
+  const Tensor* B = context->Input<Tensor>(2);
 
+  Y = nullptr;
   {
     std::lock_guard<OrtMutex> lock(s_.mutex);
     // TODO: add a global cache if need to handle cases for multiple frames running simultaneuously with different batch_size
@@ -59,10 +58,20 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       const int64_t N = X->Shape()[0];
       const int64_t M = W->Shape()[0];
 
-      ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+      // cuDNN takes the dimensions of NHWC tensors and filters in the NCHW order, with the NHWC format
+      const cudnnTensorFormat_t format = channels_last_ ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW;
+      std::vector<int64_t> x_dims_nchw = x_dims;
+      if (channels_last_) {
+        ORT_RETURN_IF_NOT(x_dims.size() >= 3 && w_dims.size() == x_dims.size(),
+                          "X and W should have the same rank, at least 3");
+        x_dims_nchw = ChannelsLastToNchwDims(x_dims);
+        w_dims = ChannelsLastToNchwDims(w_dims);
+      }
+
+      ORT_RETURN_IF_ERROR(ValidateInputShape(TensorShape(x_dims_nchw), TensorShape(w_dims)));
 
       std::vector<int64_t> kernel_shape;
-      ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+      ORT_RETURN_IF_ERROR(ComputeKernelShape(TensorShape(w_dims), kernel_shape));
       auto rank = kernel_shape.size();
       std::vector<int64_t> pads(pads_);
       if (pads.empty()) {
@@ -79,10 +88,11 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
 
       std::vector<int64_t> y_dims;
       y_dims.insert(y_dims.begin(), {N, M});
-      ORT_RETURN_IF_ERROR(InferOutputShape<true>(x_shape.Slice(2), kernel_shape, strides, dilations, &pads, &y_dims));
-      s_.y_dims = y_dims;
+      ORT_RETURN_IF_ERROR(InferOutputShape<true>(TensorShape(x_dims_nchw).Slice(2), kernel_shape, strides, dilations,
+                                                 &pads, &y_dims));
+      s_.y_dims = channels_last_ ? NchwToChannelsLastDims(y_dims) : y_dims;
 
-      std::vector<int64_t> x_dims_cudnn = x_dims;
+      std::vector<int64_t> x_dims_cudnn = x_dims_nchw;
       std::vector<int64_t> y_dims_cudnn = y_dims;
       if (rank < 2) {
         // cudnn only takes 4D or 5D input, so pad dimensions if needed
@@ -95,18 +105,17 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
         strides.push_back(1);
         dilations.push_back(1);
       }
-      ORT_RETURN_IF_ERROR(s_.x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
-      ORT_RETURN_IF_ERROR(s_.y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
+      ORT_RETURN_IF_ERROR(s_.x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
+      ORT_RETURN_IF_ERROR(s_.y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
 
       if (w_dims_changed)
-        ORT_RETURN_IF_ERROR(s_.filter_desc.Set(w_dims, CudnnTensor::GetDataType<CudaT>()));
+        ORT_RETURN_IF_ERROR(s_.filter_desc.Set(w_dims, CudnnTensor::GetDataType<CudaT>(), format));
 
       cudnnConvolutionMode_t mode = CUDNN_CROSS_CORRELATION;
       ORT_RETURN_IF_ERROR(s_.conv_desc.Set(kernel_shape.size(), pads, strides, dilations, mode, CudnnTensor::GetDataType<CudaT>()));
       CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionGroupCount(s_.conv_desc, gsl::narrow_cast<int>(group_)));
 
-      if (has_bias) {
-        const Tensor* B = context->Input<Tensor>(2);
+      if (B != nullptr) {
         const auto& b_shape = B->Shape();
         ORT_RETURN_IF_NOT(b_shape.NumDimensions() == 1, "bias should be 1D");
         std::vector<int64_t> b_dims(2 + kernel_shape.size());
@@ -115,36 +124,49 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
         for (int i = 0; i < kernel_shape.size(); i++)
           b_dims[2 + i] = 1;
 
-        ORT_RETURN_IF_ERROR(s_.b_tensor.Set(b_dims, CudnnTensor::GetDataType<CudaT>()));
+        ORT_RETURN_IF_ERROR(s_.b_tensor.Set(b_dims, CudnnTensor::GetDataType<CudaT>(), format));
       }
 
-      Tensor* Y = context->Output(0, TensorShape(s_.y_dims));
-      y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+      Y = context->Output(0, TensorShape(s_.y_dims));
 
       if (!s_.cached_benchmark_results.contains(x_dims_cudnn)) {
-        IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
-        // set math type to tensor core before algorithm search
-        if (std::is_same<T, MLFloat16>::value)
-          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
-
-        cudnnConvolutionFwdAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
-            CudnnHandle(),
-            s_.x_tensor,
-            x_data,
-            s_.filter_desc,
-            w_data,
-            s_.conv_desc,
-            s_.y_tensor,
-            y_data,
-            1,
-            &algo_count,
-            &perf,
-            algo_search_workspace.get(),
-            AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+        // the kernels of other sessions, or earlier processes, may have found the algorithm already
+        auto& algo_cache = CudnnAlgoCache::Instance();
+        const auto algo_key = algo_cache.MakeConvKey(GetDeviceId(), channels_last_ ? "nhwc_conv_fwd" : "conv_fwd",
+                                                     CudnnTensor::GetDataType<CudaT>(),
+                                                     x_dims_cudnn, w_dims, y_dims_cudnn, pads, strides, dilations,
+                                                     group_);
+        CudnnAlgoCache::Result cached;
+        if (algo_cache.Lookup(algo_key, cached)) {
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {static_cast<cudnnConvolutionFwdAlgo_t>(cached.algo),
+                                                            cached.memory,
+                                                            static_cast<cudnnMathType_t>(cached.math_type)});
+        } else {
+          IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
+
+          // set math type to tensor core before algorithm search
+          if (std::is_same<T, MLFloat16>::value)
+            CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
+
+          cudnnConvolutionFwdAlgoPerf_t perf;
+          int algo_count = 1;
+          CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
+              CudnnHandle(),
+              s_.x_tensor,
+              x_data,
+              s_.filter_desc,
+              w_data,
+              s_.conv_desc,
+              s_.y_tensor,
+              Y->template MutableData<T>(),
+              1,
+              &algo_count,
+              &perf,
+              algo_search_workspace.get(),
+              AlgoSearchWorkspaceSize));
+          s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+          algo_cache.Insert(algo_key, {static_cast<int>(perf.algo), perf.memory, static_cast<int>(perf.mathType)});
+        }
       }
 
       const auto& perf = s_.cached_benchmark_results.at(x_dims_cudnn);
@@ -152,13 +174,27 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
       s_.algo = perf.algo;
       s_.workspace_bytes = perf.memory;
     }
-  }
 
-  if (!y_data) {
-    Tensor* Y = context->Output(0, TensorShape(s_.y_dims));
-    y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+    if (Y == nullptr) {
+      Y = context->Output(0, TensorShape(s_.y_dims));
+    }
   }
 
+  return Status::OK();
+}
+
+template <typename T>
+Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  Tensor* Y;
+  ORT_RETURN_IF_ERROR(UpdateState(context, Y));
+
+  auto x_data = reinterpret_cast<const CudaT*>(context->Input<Tensor>(0)->template Data<T>());
+  auto w_data = reinterpret_cast<const CudaT*>(context->Input<Tensor>(1)->template Data<T>());
+  auto y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  const Tensor* B = context->Input<Tensor>(2);
+
   const auto alpha = Consts<CudaT>::One;
   const auto beta = Consts<CudaT>::Zero;
 
@@ -178,8 +214,7 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
                                                 s_.y_tensor,
                                                 y_data));
 
-  if (has_bias) {
-    const Tensor* B = context->Input<Tensor>(2);
+  if (B != nullptr) {
     auto b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
     CUDNN_RETURN_IF_ERROR(cudnnAddTensor(CudnnHandle(), &alpha, s_.b_tensor, b_data, &alpha, s_.y_tensor, y_data));
   }
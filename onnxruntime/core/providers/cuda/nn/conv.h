@@ -144,7 +144,8 @@ enum : size_t {
 template <typename T>
 class Conv : public CudaKernel, public ConvBase {
  public:
-  Conv(const OpKernelInfo& info) : CudaKernel(info), ConvBase(info) {
+  Conv(const OpKernelInfo& info)
+      : CudaKernel(info), ConvBase(info), channels_last_(info.GetKernelDef().OpName() == "NhwcConv") {
     auto pads_size = pads_.size();
     ORT_ENFORCE(pads_size % 2 == 0);
     auto rank = pads_size / 2;
@@ -155,8 +156,14 @@ class Conv : public CudaKernel, public ConvBase {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
- private:
+ protected:
+  // updates the cudnn descriptors and the algorithm if the shapes of X or W changed, and allocates Y
+  Status UpdateState(OpKernelContext* context, Tensor*& Y) const;
+
   mutable CudnnConvState<cudnnConvolutionFwdAlgoPerf_t> s_;
+
+  // set for NhwcConv, whose X and Y are in the NHWC layout and W in the (M, kH, kW, C / group) layout
+  const bool channels_last_;
 };
 
 }  // namespace cuda
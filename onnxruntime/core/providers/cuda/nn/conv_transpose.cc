@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "conv_transpose.h"
+#include "core/providers/cuda/cudnn_algo_cache.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -89,29 +90,41 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
       y_data = reinterpret_cast<CudaT*>(p.Y->template MutableData<T>());
 
       if (!s_.cached_benchmark_results.contains(x_dims)) {
-        IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
-        // set math type to tensor core before algorithm search
-        if (std::is_same<T, MLFloat16>::value)
-          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
-
-        cudnnConvolutionBwdDataAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
-            CudnnHandle(),
-            s_.filter_desc,
-            w_data,
-            s_.x_tensor,
-            x_data,
-            s_.conv_desc,
-            s_.y_tensor,
-            y_data,
-            1,
-            &algo_count,
-            &perf,
-            algo_search_workspace.get(),
-            AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
+        // the kernels of other sessions, or earlier processes, may have found the algorithm already
+        auto& algo_cache = CudnnAlgoCache::Instance();
+        const auto algo_key = algo_cache.MakeConvKey(GetDeviceId(), "conv_bwd_data", CudnnTensor::GetDataType<CudaT>(),
+                                                     x_dims, w_dims, y_dims, p.pads, p.strides, p.dilations, group_);
+        CudnnAlgoCache::Result cached;
+        if (algo_cache.Lookup(algo_key, cached)) {
+          s_.cached_benchmark_results.insert(x_dims, {static_cast<cudnnConvolutionBwdDataAlgo_t>(cached.algo),
+                                                      cached.memory,
+                                                      static_cast<cudnnMathType_t>(cached.math_type)});
+        } else {
+          IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
+
+          // set math type to tensor core before algorithm search
+          if (std::is_same<T, MLFloat16>::value)
+            CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
+
+          cudnnConvolutionBwdDataAlgoPerf_t perf;
+          int algo_count = 1;
+          CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
+              CudnnHandle(),
+              s_.filter_desc,
+              w_data,
+              s_.x_tensor,
+              x_data,
+              s_.conv_desc,
+              s_.y_tensor,
+              y_data,
+              1,
+              &algo_count,
+              &perf,
+              algo_search_workspace.get(),
+              AlgoSearchWorkspaceSize));
+          s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
+          algo_cache.Insert(algo_key, {static_cast<int>(perf.algo), perf.memory, static_cast<int>(perf.mathType)});
+        }
       }
 
       const auto& perf = s_.cached_benchmark_results.at(x_dims);
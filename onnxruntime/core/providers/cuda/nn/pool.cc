@@ -107,12 +107,15 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   const Tensor* X = context->Input<Tensor>(0);
   const TensorShape& x_shape = X->Shape();
-  const auto& x_dims = x_shape.GetDims();
 
   if (x_shape.NumDimensions() < 3) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input dimension cannot be less than 3.");
   }
 
+  // cuDNN takes the dimensions of NHWC tensors in the NCHW order, with the NHWC format
+  const cudnnTensorFormat_t format = channels_last_ ? CUDNN_TENSOR_NHWC : CUDNN_TENSOR_NCHW;
+  const std::vector<int64_t> x_dims = channels_last_ ? ChannelsLastToNchwDims(x_shape.GetDims()) : x_shape.GetDims();
+
   std::vector<int64_t> kernel_shape = kernel_shape_;
   std::vector<int64_t> pads = pads_;
   std::vector<int64_t> strides = strides_;
@@ -123,8 +126,9 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
     strides.assign(kernel_shape.size(), 1);
   }
 
-  std::vector<int64_t> y_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads, dilations_, ceil_mode_);
-  Tensor* Y = context->Output(0, TensorShape(y_dims));
+  std::vector<int64_t> y_dims = PoolBase::SetOutputSize(TensorShape(x_dims), x_dims[1], &pads, dilations_,
+                                                        ceil_mode_);
+  Tensor* Y = context->Output(0, TensorShape(channels_last_ ? NchwToChannelsLastDims(y_dims) : y_dims));
 
   auto x_data = reinterpret_cast<const CudaT*>(X->template Data<T>());
   auto y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
@@ -145,8 +149,8 @@ Status Pool<T, PoolType>::ComputeInternal(OpKernelContext* context) const {
   const auto beta = Consts<CudaT>::Zero;
   CudnnTensor x_tensor;
   CudnnTensor y_tensor;
-  ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_ERROR(x_tensor.Set(x_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
+  ORT_RETURN_IF_ERROR(y_tensor.Set(y_dims_cudnn, CudnnTensor::GetDataType<CudaT>(), format));
 
   cudnnPoolingMode_t mode = CUDNN_POOLING_MAX;
   if (PoolType::type == onnxruntime::PoolType::kAveragePool) {
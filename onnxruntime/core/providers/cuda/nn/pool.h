@@ -14,9 +14,13 @@ namespace cuda {
 template <typename T, typename PoolType>
 class Pool : public CudaKernel, public PoolBase {
  public:
-  Pool(OpKernelInfo info) : CudaKernel(info), PoolBase(info) {}
+  Pool(OpKernelInfo info) : CudaKernel(info), PoolBase(info), channels_last_(op_name_.compare(0, 4, "Nhwc") == 0) {}
 
   Status ComputeInternal(OpKernelContext* context) const override;
+
+ protected:
+  // set for the NHWC pooling ops of the com.microsoft domain, whose X and Y are in the NHWC layout
+  const bool channels_last_;
 };
 
 template <typename T>
@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <math_constants.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cu_inc/block_reduce.cuh"
+#include "reduction_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+constexpr int kWarpsPerBlock = 4;
+constexpr int kMaxThreadsPerBlock = 512;
+// rows up to this size are reduced by a warp, longer ones by a block
+constexpr int kWarpRowSize = 1024;
+
+template <typename T>
+struct AccumulationType { typedef T type; };
+template <>
+struct AccumulationType<half> { typedef float type; };
+
+// The reductions combine the transformed elements with Op, starting from Identity, and finalize the result.
+// LogSumExp subtracts the maximum of the row from the elements first.
+struct SumReduction {
+  typedef SumOp Op;
+  static constexpr bool kSubtractMax = false;
+  template <typename A>
+  static __device__ A Identity() { return A(0); }
+  template <typename A>
+  static __device__ A Transform(A x) { return x; }
+  template <typename A>
+  static __device__ A Finalize(A acc, int, A) { return acc; }
+};
+
+struct MeanReduction : SumReduction {
+  template <typename A>
+  static __device__ A Finalize(A acc, int row_size, A) { return acc / A(row_size); }
+};
+
+struct MaxReduction : SumReduction {
+  typedef MaxOp Op;
+  template <typename A>
+  static __device__ A Identity() { return A(-CUDART_INF); }
+};
+
+struct MinReduction : SumReduction {
+  typedef MinOp Op;
+  template <typename A>
+  static __device__ A Identity() { return A(CUDART_INF); }
+};
+
+struct ProdReduction : SumReduction {
+  typedef ProdOp Op;
+  template <typename A>
+  static __device__ A Identity() { return A(1); }
+};
+
+struct L1Reduction : SumReduction {
+  template <typename A>
+  static __device__ A Transform(A x) { return _Abs(x); }
+};
+
+struct SumSquareReduction : SumReduction {
+  template <typename A>
+  static __device__ A Transform(A x) { return x * x; }
+};
+
+struct L2Reduction : SumSquareReduction {
+  template <typename A>
+  static __device__ A Finalize(A acc, int, A) { return _Sqrt(acc); }
+};
+
+struct LogSumReduction : SumReduction {
+  template <typename A>
+  static __device__ A Finalize(A acc, int, A) { return _Log(acc); }
+};
+
+struct LogSumExpReduction : SumReduction {
+  static constexpr bool kSubtractMax = true;
+  template <typename A>
+  static __device__ A Transform(A x) { return _Exp(x); }
+  template <typename A>
+  static __device__ A Finalize(A acc, int, A max_value) { return _Log(acc) + max_value; }
+};
+
+// The threads reducing a row, the lanes of a warp or the threads of a block.
+template <bool kWarp>
+struct RowThreads {
+  static __device__ int Row() { return blockIdx.x * kWarpsPerBlock + threadIdx.x / kWarpSize; }
+  static __device__ int First() { return threadIdx.x % kWarpSize; }
+  static __device__ int Stride() { return kWarpSize; }
+  template <typename A, typename Op>
+  static __device__ A Reduce(A value, Op op, A) { return WarpAllReduce(value, op); }
+};
+
+template <>
+struct RowThreads<false> {
+  static __device__ int Row() { return blockIdx.x; }
+  static __device__ int First() { return threadIdx.x; }
+  static __device__ int Stride() { return blockDim.x; }
+  template <typename A, typename Op>
+  static __device__ A Reduce(A value, Op op, A identity) { return BlockReduce(value, op, identity); }
+};
+}  // namespace
+
+template <typename T, typename Reduction, bool kWarp>
+__global__ void _ReduceRowsKernel(const T* input_data, T* output_data, int rows, int row_size) {
+  typedef typename AccumulationType<T>::type AccT;
+  typedef RowThreads<kWarp> Threads;
+  const int row = Threads::Row();
+  if (row >= rows) {
+    return;
+  }
+  const T* input = input_data + static_cast<int64_t>(row) * row_size;
+
+  AccT max_value = 0;
+  if (Reduction::kSubtractMax) {
+    max_value = -CUDART_INF;
+    for (int i = Threads::First(); i < row_size; i += Threads::Stride()) {
+      max_value = MaxOp()(max_value, static_cast<AccT>(input[i]));
+    }
+    max_value = Threads::Reduce(max_value, MaxOp(), AccT(-CUDART_INF));
+  }
+
+  typename Reduction::Op op;
+  const AccT identity = Reduction::template Identity<AccT>();
+  AccT value = identity;
+  for (int i = Threads::First(); i < row_size; i += Threads::Stride()) {
+    value = op(value, Reduction::Transform(static_cast<AccT>(input[i]) - max_value));
+  }
+  value = Threads::Reduce(value, op, identity);
+
+  if (Threads::First() == 0) {
+    output_data[row] = static_cast<T>(Reduction::Finalize(value, row_size, max_value));
+  }
+}
+
+template <typename T, typename Reduction>
+void ReduceRows(const T* input_data, T* output_data, int rows, int row_size) {
+  if (row_size <= kWarpRowSize) {
+    const int blocks = (rows + kWarpsPerBlock - 1) / kWarpsPerBlock;
+    _ReduceRowsKernel<T, Reduction, true><<<blocks, kWarpsPerBlock * kWarpSize, 0>>>(
+        input_data, output_data, rows, row_size);
+    return;
+  }
+
+  const int threads = std::min(kMaxThreadsPerBlock, (row_size + kWarpSize - 1) / kWarpSize * kWarpSize);
+  _ReduceRowsKernel<T, Reduction, false><<<rows, threads, 0>>>(input_data, output_data, rows, row_size);
+}
+
+template <typename T>
+void ReduceRowsImpl(ReduceRowsOp op, const T* input_data, T* output_data, int rows, int row_size) {
+  if (rows == 0) {
+    return;
+  }
+
+  switch (op) {
+    case ReduceRowsOp::Sum:
+      ReduceRows<T, SumReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::Mean:
+      ReduceRows<T, MeanReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::Max:
+      ReduceRows<T, MaxReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::Min:
+      ReduceRows<T, MinReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::Prod:
+      ReduceRows<T, ProdReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::L1:
+      ReduceRows<T, L1Reduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::L2:
+      ReduceRows<T, L2Reduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::SumSquare:
+      ReduceRows<T, SumSquareReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::LogSum:
+      ReduceRows<T, LogSumReduction>(input_data, output_data, rows, row_size);
+      break;
+    case ReduceRowsOp::LogSumExp:
+      ReduceRows<T, LogSumExpReduction>(input_data, output_data, rows, row_size);
+      break;
+  }
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void ReduceRowsImpl<T>(ReduceRowsOp op, const T* input_data, T* output_data, int rows, int row_size);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+enum class ReduceRowsOp {
+  Sum,
+  Mean,
+  Max,
+  Min,
+  Prod,
+  L1,
+  L2,
+  SumSquare,
+  LogSum,
+  LogSumExp,
+};
+
+// The longest rows ReduceRowsImpl reduces when there are few of them. Longer ones go to cudnnReduceTensor, which
+// splits a row across blocks.
+constexpr int64_t kReduceRowsImplMaxRowSize = 65536;
+constexpr int64_t kReduceRowsImplMinRows = 64;
+
+// Reduces each row of the rows x row_size input to an element of output, accumulating in float for half.
+template <typename T>
+void ReduceRowsImpl(ReduceRowsOp op, const T* input_data, T* output_data, int rows, int row_size);
+
+}  // namespace cuda
+}  // namespace onnxruntime
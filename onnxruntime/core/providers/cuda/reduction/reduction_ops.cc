@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "reduction_ops.h"
+#include "reduction_impl.h"
 #include "core/providers/common.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
@@ -55,6 +56,43 @@ class CudnnReduceDescriptor final {
   cudnnReduceTensorDescriptor_t desc_;
 };
 
+// maps a cudnn reduction, with the steps the kernels add around it for ReduceSumSquare, ReduceLogSum and
+// ReduceLogSumExp, to the op of ReduceRowsImpl
+static bool GetReduceRowsOp(cudnnReduceTensorOp_t cudnn_reduce_op, bool calculate_log, bool calculate_sqt,
+                            bool log_sum_exp, ReduceRowsOp& op) {
+  switch (cudnn_reduce_op) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      if (calculate_sqt) {
+        op = ReduceRowsOp::SumSquare;
+      } else if (log_sum_exp) {
+        op = ReduceRowsOp::LogSumExp;
+      } else {
+        op = calculate_log ? ReduceRowsOp::LogSum : ReduceRowsOp::Sum;
+      }
+      return true;
+    case CUDNN_REDUCE_TENSOR_AVG:
+      op = ReduceRowsOp::Mean;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      op = ReduceRowsOp::Max;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      op = ReduceRowsOp::Min;
+      return true;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      op = ReduceRowsOp::Prod;
+      return true;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      op = ReduceRowsOp::L1;
+      return true;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      op = ReduceRowsOp::L2;
+      return true;
+    default:
+      return false;
+  }
+}
+
 template <bool allow_multi_axes>
 template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices>
 Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnReduceTensorOp_t cudnnReduceOp) const {
@@ -95,6 +133,27 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
   Tensor* Y = ctx->Output(0, TensorShape(squeezed_output_dims));
 
   int64_t input_count = input_shape.Size();
+
+  // the reductions of the trailing axes, each reducing a row of the input to an element of the output, run in a
+  // hand-written kernel, which skips the descriptor and workspace setup of cudnn
+  ReduceRowsOp reduce_rows_op;
+  size_t first_reduced = axes_.empty() ? 0 : rank;
+  while (first_reduced > 0 && reduced[first_reduced - 1]) {
+    --first_reduced;
+  }
+  if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_NO_INDICES &&
+      GetReduceRowsOp(cudnnReduceOp, calculate_log_, calculate_sqt_, log_sum_exp_, reduce_rows_op) &&
+      std::none_of(reduced.begin(), reduced.begin() + first_reduced, [](bool r) { return r; }) &&
+      input_count > 0 && input_count <= std::numeric_limits<int>::max()) {
+    const int64_t rows = input_shape.SizeToDimension(first_reduced);
+    const int64_t row_size = input_shape.SizeFromDimension(first_reduced);
+    if (row_size <= kReduceRowsImplMaxRowSize || rows >= kReduceRowsImplMinRows) {
+      ReduceRowsImpl<CudaT>(reduce_rows_op, reinterpret_cast<const CudaT*>(X->template Data<T>()),
+                            reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+                            static_cast<int>(rows), static_cast<int>(row_size));
+      return Status::OK();
+    }
+  }
   IAllocatorUniquePtr<float> temp_X;
   cudnnDataType_t cudnn_type_X = CudnnTensor::GetDataType<CudaT>();
   if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_FLATTENED_INDICES && std::is_same<T, MLFloat16>::value) {
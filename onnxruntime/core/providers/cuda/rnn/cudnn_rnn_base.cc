@@ -72,7 +72,7 @@ template <typename T>
 Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                                           IAllocatorUniquePtr<void>& reorganized_w_data,
                                           CudnnFilterDescriptor& target_w_desc,
-                                          CudnnRNN& rnn_desc) const {
+                                          const CudnnRNN& rnn_desc) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   int64_t input_size = W->Shape()[2];
   // RNN W[num_directions_, hidden_size_, input_size]
@@ -107,8 +107,28 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
 }
 
 template <typename T>
-Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
+Status CudnnRnnBase<T>::SetCudnnRnnDesc() {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  ORT_RETURN_IF_ERROR(rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                    cudnn_direction_mode_, rnn_mode_, CUDNN_RNN_ALGO_STANDARD,
+                                    CudnnTensor::GetDataType<CudaT>()));
+  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
+  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+
+  if (persistent_rnn_supported_) {
+    // the weights are laid out the same for all the algorithms, so the persistent kernels share them
+    ORT_RETURN_IF_ERROR(persistent_rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                                 cudnn_direction_mode_, rnn_mode_, CUDNN_RNN_ALGO_PERSIST_STATIC,
+                                                 CudnnTensor::GetDataType<CudaT>()));
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
+  ORT_RETURN_IF_ERROR(SetCudnnRnnDesc());
+
   // Cache the weight
   const Tensor* W;
   const Tensor* R;
@@ -118,20 +138,46 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   bool get_B = info.TryGetConstantInput(RNN_Input_Index::B, &B);
 
   if (get_W && get_R) {
-    CudnnRNN tmp_rnn_desc;
-    ORT_RETURN_IF_ERROR(tmp_rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                         cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
-    if (get_B) {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
-    } else {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
-    }
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, get_B ? B : nullptr, w_data_cache_, w_desc_cache_, rnn_desc_));
     weight_cached_ = true;
   }
 
   return Status::OK();
 }
 
+template <typename T>
+Status CudnnRnnBase<T>::UpdateState(int64_t seq_length, int64_t batch_size, int64_t input_size) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  if (s_.seq_length == seq_length && s_.batch_size == batch_size) {
+    return Status::OK();
+  }
+
+  // invalidate the state until it's set up completely
+  s_.seq_length = -1;
+  s_.batch_size = -1;
+
+  std::vector<int64_t> dims_x({batch_size, input_size, 1});
+  std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
+  std::vector<int64_t> dims_hxy({RNN_NUM_LAYERS * num_directions_, batch_size, hidden_size_});
+  ORT_RETURN_IF_ERROR(s_.x_desc_temp.Set(dims_x, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_ERROR(s_.y_desc_temp.Set(dims_y, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_ERROR(s_.hxy_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
+  s_.x_desc.assign(seq_length, s_.x_desc_temp);
+  s_.y_desc.assign(seq_length, s_.y_desc_temp);
+
+  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc_, gsl::narrow_cast<int>(seq_length),
+                                                 s_.x_desc.data(), &s_.workspace_bytes));
+
+  // cuDNN reports the sizes the persistent kernels don't support here
+  s_.persistent = persistent_rnn_supported_ && batch_size <= RNN_MAX_PERSISTENT_BATCH_SIZE &&
+                  cudnnGetRNNWorkspaceSize(CudnnHandle(), persistent_rnn_desc_, gsl::narrow_cast<int>(seq_length),
+                                           s_.x_desc.data(), &s_.persistent_workspace_bytes) == CUDNN_STATUS_SUCCESS;
+
+  s_.seq_length = seq_length;
+  s_.batch_size = batch_size;
+  return Status::OK();
+}
+
 template <typename T>
 Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
@@ -160,25 +206,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   Tensor* Y_h = ctx->Output(Output_Index::Y_h, dims_hxy);
   Tensor* Y_c = ctx->Output(Output_Index::Y_c, dims_yc);
 
-  std::vector<int64_t> dims_x({batch_size, input_size, 1});
-  std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
-
-  CudnnTensor x_desc_temp;
-  x_desc_temp.Set(dims_x, CudnnTensor::GetDataType<CudaT>());
-  CudnnTensor y_desc_temp;
-  y_desc_temp.Set(dims_y, CudnnTensor::GetDataType<CudaT>());
-  std::vector<cudnnTensorDescriptor_t> x_desc(seq_length, x_desc_temp);
-  std::vector<cudnnTensorDescriptor_t> y_desc(seq_length, y_desc_temp);
-
-  CudnnTensor hx_desc;
-  CudnnTensor cx_desc;
-  CudnnTensor y_h_desc;
-  CudnnTensor y_c_desc;
-  ORT_RETURN_IF_ERROR(hx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(cx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_h_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_c_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-
   IAllocatorUniquePtr<T> x_reversed_data;
   const T* x_data = X->template Data<T>();
   if (reverse_) {
@@ -210,10 +237,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
 
-  CudnnRNN rnn_desc;
-  ORT_RETURN_IF_ERROR(rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                   cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
-
   // Prepare the weight data
   IAllocatorUniquePtr<void> w_data;
   CudnnFilterDescriptor w_desc;
@@ -221,39 +244,53 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(RNN_Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(RNN_Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(RNN_Input_Index::B);
-    ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc);
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc_));
   }
 
-  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
-  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc, CUDNN_RNN_PADDED_IO_ENABLED));
-
-  size_t workspace_bytes;
-  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
-  auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
   int32_t zero_seq_count = 0;
   std::vector<int32_t> zero_seq_index_cache(batch_size, 0);
   int64_t zero_seq_index_cache_size = 0;
 
+  // the descriptors are shared by the Computes of the kernel, so they hold the lock while they use them
+  std::lock_guard<OrtMutex> lock(s_.mutex);
+  ORT_RETURN_IF_ERROR(UpdateState(seq_length, batch_size, input_size));
+
   if (CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data) {
-    CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
-                                                   rnn_desc,
-                                                   gsl::narrow_cast<int>(seq_length),
-                                                   x_desc.data(),
-                                                   x_data_input,
-                                                   hx_desc,
-                                                   hx_data,
-                                                   cx_desc,
-                                                   cx_data,
-                                                   weight_cached_ ? w_desc_cache_ : w_desc,
-                                                   weight_cached_ ? w_data_cache_.get() : w_data.get(),
-                                                   y_desc.data(),
-                                                   y_data,
-                                                   y_h_desc,
-                                                   y_h_data,
-                                                   y_c_desc,
-                                                   y_c_data,
-                                                   workspace_cuda.get(),
-                                                   workspace_bytes));
+    auto forward_inference = [&](const CudnnRNN& rnn_desc, size_t workspace_bytes) {
+      auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+      return cudnnRNNForwardInference(CudnnHandle(),
+                                      rnn_desc,
+                                      gsl::narrow_cast<int>(seq_length),
+                                      s_.x_desc.data(),
+                                      x_data_input,
+                                      s_.hxy_desc,
+                                      hx_data,
+                                      s_.hxy_desc,
+                                      cx_data,
+                                      weight_cached_ ? w_desc_cache_ : w_desc,
+                                      weight_cached_ ? w_data_cache_.get() : w_data.get(),
+                                      s_.y_desc.data(),
+                                      y_data,
+                                      s_.hxy_desc,
+                                      y_h_data,
+                                      s_.hxy_desc,
+                                      y_c_data,
+                                      workspace_cuda.get(),
+                                      workspace_bytes);
+    };
+
+    cudnnStatus_t status = CUDNN_STATUS_NOT_SUPPORTED;
+    if (s_.persistent && persistent_rnn_supported_) {
+      status = forward_inference(persistent_rnn_desc_, s_.persistent_workspace_bytes);
+      if (status == CUDNN_STATUS_NOT_SUPPORTED) {
+        // the recurrent weights don't fit on chip, so the kernel keeps to the standard kernels from now on
+        persistent_rnn_supported_ = false;
+      }
+    }
+    if (status == CUDNN_STATUS_NOT_SUPPORTED) {
+      status = forward_inference(rnn_desc_, s_.workspace_bytes);
+    }
+    CUDNN_RETURN_IF_ERROR(status);
   } else {
     // cudnn doesn't support 0 sequence inside the batch, find the 0 sequence and set it to 1
     // there's a ZeroMask kernel to reset the result to 0 for the 0 sequence
@@ -282,26 +319,28 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     CudnnDataTensor y_desc;
     y_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, hidden_size_ * num_directions_, seq_len_array.data());
 
+    // the padded layout of the sequences of varying lengths only runs with the standard kernels
+    auto workspace_cuda = GetScratchBuffer<void>(s_.workspace_bytes);
     CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInferenceEx(CudnnHandle(),
-                                                     rnn_desc,
+                                                     rnn_desc_,
                                                      x_desc,
                                                      x_data_input,
-                                                     hx_desc,
+                                                     s_.hxy_desc,
                                                      hx_data,
-                                                     cx_desc,
+                                                     s_.hxy_desc,
                                                      cx_data,
                                                      weight_cached_ ? w_desc_cache_ : w_desc,
                                                      weight_cached_ ? w_data_cache_.get() : w_data.get(),
                                                      y_desc,
                                                      y_data,
-                                                     y_h_desc,
+                                                     s_.hxy_desc,
                                                      y_h_data,
-                                                     y_c_desc,
+                                                     s_.hxy_desc,
                                                      y_c_data,
                                                      nullptr, nullptr, nullptr, nullptr,
                                                      nullptr, nullptr, nullptr, nullptr,
                                                      workspace_cuda.get(),
-                                                     workspace_bytes));
+                                                     s_.workspace_bytes));
 
     // Early terminate for this case since Y data is not required, and Y_h is obtained correctly, no need the following code to retrive Y_h from Y data.
     if (nullptr == Y) {
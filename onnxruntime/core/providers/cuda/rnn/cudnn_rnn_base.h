@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "gsl/gsl_util"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include <cudnn.h>
@@ -24,6 +27,10 @@ enum RNN_Input_Index {
 // Onnx RNN/GRU/LSTM only support 1 layer
 const int RNN_NUM_LAYERS = 1;
 
+// The largest batch run with the persistent kernels of cuDNN, which keep the recurrent weights on chip across the
+// time steps. Larger batches have enough parallelism in each step for the standard kernels to do better.
+const int64_t RNN_MAX_PERSISTENT_BATCH_SIZE = 32;
+
 class CudnnRNN {
  public:
   CudnnRNN() : cudnn_rnn_desc_(nullptr) {
@@ -38,7 +45,7 @@ class CudnnRNN {
 
   Status Set(const cudnnHandle_t& cudnnHandle, int64_t hidden_size, int num_layers,
              cudnnDropoutDescriptor_t cudnn_dropout_desc, cudnnDirectionMode_t cudnn_direction_model,
-             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType) {
+             cudnnRNNMode_t rnn_mode, cudnnRNNAlgo_t rnn_algo, cudnnDataType_t dataType) {
     if (!cudnn_rnn_desc_)
       CUDNN_RETURN_IF_ERROR(cudnnCreateRNNDescriptor(&cudnn_rnn_desc_));
 
@@ -50,7 +57,7 @@ class CudnnRNN {
                                                 CUDNN_LINEAR_INPUT,  // We can also skip the input matrix transformation
                                                 cudnn_direction_model,
                                                 rnn_mode,
-                                                CUDNN_RNN_ALGO_STANDARD,  //CUDNN_RNN_ALGO_PERSIST_STATIC, CUDNN_RNN_ALGO_PERSIST_DYNAMIC
+                                                rnn_algo,
                                                 dataType));
 
     return Status::OK();
@@ -91,7 +98,12 @@ class CudnnRnnBase : public CudaKernel {
     rnn_mode_ = CUDNN_LSTM;
     weight_cached_ = false;
     w_data_cache_ = nullptr;
-    
+
+    // the persistent kernels need Pascal or newer, and don't run in double
+    cudaDeviceProp prop;
+    CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, GetDeviceId()));
+    persistent_rnn_supported_ = prop.major >= 6 && !std::is_same<T, double>::value;
+
     size_t state_size;
     cudnn_dropout_desc_.CreateDescriptorIfNeeded();
     cudnn_dropout_desc_.GetCudnnDropoutStatesSize(CudnnHandle(), state_size);
@@ -99,6 +111,7 @@ class CudnnRnnBase : public CudaKernel {
     cudnn_dropout_desc_.Set(CudnnHandle(), state_buffer_.get(), state_size);
   }
 
+  // Sets the RNN descriptors up, and reorganizes the weights once if they are constant inputs.
   Status CacheCudnnRnnWeights(const OpKernelInfo& info);
 
   Status ComputeInternal(OpKernelContext* ctx) const override;
@@ -106,6 +119,12 @@ class CudnnRnnBase : public CudaKernel {
   void SetRNNMode(cudnnRNNMode_t rnn_mode) { rnn_mode_ = rnn_mode; }
 
  private:
+  Status SetCudnnRnnDesc();
+
+  // Sets the descriptors of the inputs of seq_length x batch_size x input_size up, unless they have the shape of the
+  // last Compute. Requires s_.mutex.
+  Status UpdateState(int64_t seq_length, int64_t batch_size, int64_t input_size) const;
+
   Status SetCudnnRnnWeightBias(const cudnnHandle_t cudnn_handle,
                                const cudnnRNNDescriptor_t rnn_desc,
                                const cudnnTensorDescriptor_t x_desc,
@@ -118,7 +137,7 @@ class CudnnRnnBase : public CudaKernel {
   Status ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                            IAllocatorUniquePtr<void>& target_w_data,
                            CudnnFilterDescriptor& target_w_desc,
-                           CudnnRNN& rnn_desc) const;
+                           const CudnnRNN& rnn_desc) const;
 
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
@@ -150,11 +169,35 @@ class CudnnRnnBase : public CudaKernel {
   // hidden_size_ from attribute
   int64_t hidden_size_;
   cudnnRNNMode_t rnn_mode_;
+  // the RNN descriptors only depend on the attributes, so they are set once. persistent_rnn_desc_ runs the persistent
+  // kernels, used for small batches without sequence_lens when the device supports them.
+  CudnnRNN rnn_desc_;
+  CudnnRNN persistent_rnn_desc_;
+  // whether the device supports the persistent kernels. Cleared if cuDNN turns them down for the sizes of the kernel.
+  mutable std::atomic<bool> persistent_rnn_supported_;
   // w_desc_cache_ & w_data_cache_ are changed in Constructor if we can get the weights as constant input
   CudnnFilterDescriptor w_desc_cache_;
   IAllocatorUniquePtr<void> w_data_cache_;
   bool weight_cached_;
 
+  // the descriptors of the inputs of the last Compute, and of its outputs
+  struct RnnState {
+    OrtMutex mutex;
+    int64_t seq_length = -1;
+    int64_t batch_size = -1;
+    CudnnTensor x_desc_temp;
+    CudnnTensor y_desc_temp;
+    std::vector<cudnnTensorDescriptor_t> x_desc;
+    std::vector<cudnnTensorDescriptor_t> y_desc;
+    // the descriptor of initial_h, initial_c, Y_h and Y_c, which have the same shape
+    CudnnTensor hxy_desc;
+    size_t workspace_bytes = 0;
+    // whether the batch runs with persistent_rnn_desc_, and its workspace
+    bool persistent = false;
+    size_t persistent_workspace_bytes = 0;
+  };
+  mutable RnnState s_;
+
   // cudnn_dropout_desc_ is a cache, never to be changed
   IAllocatorUniquePtr<void> state_buffer_;
   CudnnDropout cudnn_dropout_desc_;
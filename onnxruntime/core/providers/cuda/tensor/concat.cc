@@ -51,19 +51,37 @@ Status Concat::ComputeInternal(OpKernelContext* ctx) const {
   axis_dimension_input_output_mapping_gpu.CopyToGpu();
   concat_sizes_range_gpu.CopyToGpu();
   input_ptr.CopyToGpu();
-  int block_size_inside_axis_dim = static_cast<int>(p.output_axis_pitch / p.output_tensor->Shape()[p.axis]);
-  int block_size_including_axis_dim = static_cast<int>(p.output_axis_pitch);
+  int64_t block_size_inside_axis_dim = p.output_axis_pitch / p.output_tensor->Shape()[p.axis];
+  int64_t block_size_including_axis_dim = p.output_axis_pitch;
+  int64_t output_num_elements = p.output_num_elements;
   auto element_bytes = p.output_tensor->DataType()->Size();
+
+  // Each input is copied in contiguous runs of a multiple of the elements inside the axis, so the elements are
+  // copied as wider words when these runs and the buffers are aligned to them.
+  uint64_t offset_bits = static_cast<uint64_t>(block_size_inside_axis_dim * element_bytes) |
+                         reinterpret_cast<uintptr_t>(p.output_tensor->MutableDataRaw());
+  for (int i = 0; i < input_count; ++i) {
+    offset_bits |= reinterpret_cast<uintptr_t>(input_ptr_cpuspan[i]);
+  }
+  const size_t copy_bytes = GetVectorizedCopyBytes(element_bytes, offset_bits);
+  if (copy_bytes != element_bytes) {
+    const int64_t elements_per_copy = static_cast<int64_t>(copy_bytes / element_bytes);
+    block_size_inside_axis_dim /= elements_per_copy;
+    block_size_including_axis_dim /= elements_per_copy;
+    output_num_elements /= elements_per_copy;
+    element_bytes = copy_bytes;
+  }
+
   ORT_RETURN_IF_ERROR(ConcatImpl(element_bytes,
-                                 block_size_including_axis_dim,
-                                 block_size_inside_axis_dim,
+                                 static_cast<int>(block_size_including_axis_dim),
+                                 static_cast<int>(block_size_inside_axis_dim),
                                  concat_sizes_gpu.GpuPtr(),
                                  concat_sizes_range_gpu.GpuPtr(),
                                  axis_dimension_input_output_mapping_gpu.GpuPtr(),
                                  input_count,
                                  p.output_tensor->MutableDataRaw(),
                                  input_ptr.GpuPtr(),
-                                 p.output_num_elements));
+                                 output_num_elements));
   return Status::OK();
 }
 
@@ -91,6 +91,15 @@ Status ConcatImpl(const size_t element_bytes,
           input_ptr,
           (CUDA_LONG)N);
       break;
+    case sizeof(int4):
+      _ConcatKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+          block_size_including_axis_dim_div, block_size_inside_axis_dim_div,
+          concat_sizes, concat_sizes_range, axis_dimension_input_output_mapping,
+          num_inputs,
+          reinterpret_cast<int4*>(output_data),
+          input_ptr,
+          (CUDA_LONG)N);
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for Concat operator");
   }
@@ -48,6 +48,27 @@ ONNX_OPERATOR_KERNEL_EX(
     }                                                                         \
   }
 
+// Gathers the blocks of the input as VectorT words, each holding several elements.
+template <typename VectorT>
+static Status GatherVectorized(const Tensor& input_tensor, const Tensor& indices_tensor, Tensor& output_tensor,
+                               int64_t input_block_size, int64_t indices_max, const fast_divmod* div_strides) {
+  const auto* input_data = reinterpret_cast<const VectorT*>(input_tensor.DataRaw());
+  auto* output_data = reinterpret_cast<VectorT*>(output_tensor.MutableDataRaw());
+  const size_t N = output_tensor.SizeInBytes() / sizeof(VectorT);
+  MLDataType Tin_type = indices_tensor.DataType();
+  if (Tin_type == DataTypeImpl::GetType<int32_t>()) {
+    GatherImpl(input_block_size, indices_max, indices_tensor.Data<int32_t>(), div_strides,
+               input_data, output_data, N);
+    return Status::OK();
+  }
+  if (Tin_type == DataTypeImpl::GetType<int64_t>()) {
+    GatherImpl(input_block_size, indices_max, indices_tensor.Data<int64_t>(), div_strides,
+               input_data, output_data, N);
+    return Status::OK();
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
+}
+
 Status Gather::ComputeInternal(OpKernelContext* context) const {
   Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
@@ -60,16 +81,39 @@ Status Gather::ComputeInternal(OpKernelContext* context) const {
   const int64_t output_block_size = N * block_size;
   const int64_t indices_max = input_shape[p.axis];
 
+  MLDataType T_type = p.input_tensor->DataType();
+  MLDataType Tin_type = p.indices_tensor->DataType();
+
+  // Each index gathers a contiguous block of the input, so the elements are copied as wider words when the blocks
+  // and the buffers are aligned to them.
+  const size_t element_size = T_type->Size();
+  const uint64_t offset_bits = static_cast<uint64_t>(block_size * element_size) |
+                               reinterpret_cast<uintptr_t>(p.input_tensor->DataRaw()) |
+                               reinterpret_cast<uintptr_t>(p.output_tensor->MutableDataRaw());
+  const size_t copy_bytes = GetVectorizedCopyBytes(element_size, offset_bits);
+  const int64_t elements_per_copy = static_cast<int64_t>(copy_bytes / element_size);
+
   // Put the output_block_size and block_size into div_strides
   // for divmod calling in _GatherKernel to calculate the input index
   CudaAsyncBuffer<fast_divmod> div_strides(this, 2);
   gsl::span<fast_divmod> div_strides_span = div_strides.CpuSpan();
-  div_strides_span[0] = fast_divmod(gsl::narrow_cast<int>(output_block_size));
-  div_strides_span[1] = fast_divmod(gsl::narrow_cast<int>(block_size));
+  div_strides_span[0] = fast_divmod(gsl::narrow_cast<int>(output_block_size / elements_per_copy));
+  div_strides_span[1] = fast_divmod(gsl::narrow_cast<int>(block_size / elements_per_copy));
   ORT_RETURN_IF_ERROR(div_strides.CopyToGpu());
 
-  MLDataType T_type = p.input_tensor->DataType();
-  MLDataType Tin_type = p.indices_tensor->DataType();
+  if (copy_bytes != element_size) {
+    switch (copy_bytes) {
+      case sizeof(int32_t):
+        return GatherVectorized<int32_t>(*p.input_tensor, *p.indices_tensor, *p.output_tensor,
+                                         input_block_size / elements_per_copy, indices_max, div_strides.GpuPtr());
+      case sizeof(int64_t):
+        return GatherVectorized<int64_t>(*p.input_tensor, *p.indices_tensor, *p.output_tensor,
+                                         input_block_size / elements_per_copy, indices_max, div_strides.GpuPtr());
+      case sizeof(int4):
+        return GatherVectorized<int4>(*p.input_tensor, *p.indices_tensor, *p.output_tensor,
+                                      input_block_size / elements_per_copy, indices_max, div_strides.GpuPtr());
+    }
+  }
 
   TYPED_FUNCTION_CALL(int8_t)
   TYPED_FUNCTION_CALL(int16_t)
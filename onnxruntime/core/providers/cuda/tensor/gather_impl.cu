@@ -7,6 +7,16 @@
 namespace onnxruntime {
 namespace cuda {
 
+template <typename T>
+__device__ __forceinline__ void _SetZero(T& value) {
+  value = 0;
+}
+
+template <>
+__device__ __forceinline__ void _SetZero(int4& value) {
+  value = make_int4(0, 0, 0, 0);
+}
+
 template <typename T, typename Tin>
 __global__ void _GatherKernel(
     const int64_t input_block_size,
@@ -25,7 +35,7 @@ __global__ void _GatherKernel(
   int block_size = div_strides[1].d_;
   int64_t idx = indices_data[indices_index];
   if (idx < 0 || idx >= indices_max) {
-    output_data[id] = 0;
+    _SetZero(output_data[id]);
     return;
   }
 
@@ -63,6 +73,7 @@ SPECIALIZED_IMPL(half)
 SPECIALIZED_IMPL(float)
 SPECIALIZED_IMPL(double)
 SPECIALIZED_IMPL(bool)
+SPECIALIZED_IMPL(int4)
 
 }  // namespace cuda
 }  // namespace onnxruntime
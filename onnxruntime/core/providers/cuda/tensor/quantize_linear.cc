@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "quantize_linear.h"
+#include "quantize_linear_impl.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the scale and the zero point are scalars, so they are read on the CPU and passed to the kernel by value
+#define REGISTER_Q_KERNEL_TYPED(T)                                          \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                            \
+      QuantizeLinear,                                                       \
+      kOnnxDomain,                                                          \
+      10,                                                                   \
+      T,                                                                    \
+      kCudaExecutionProvider,                                               \
+      KernelDefBuilder()                                                    \
+          .InputMemoryType<OrtMemTypeCPUInput>(1)                           \
+          .InputMemoryType<OrtMemTypeCPUInput>(2)                           \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())       \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T>()),          \
+      QuantizeLinear<T>);
+
+#define REGISTER_DQ_KERNEL_TYPED(T)                                         \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                            \
+      DequantizeLinear,                                                     \
+      kOnnxDomain,                                                          \
+      10,                                                                   \
+      T,                                                                    \
+      kCudaExecutionProvider,                                               \
+      KernelDefBuilder()                                                    \
+          .InputMemoryType<OrtMemTypeCPUInput>(1)                           \
+          .InputMemoryType<OrtMemTypeCPUInput>(2)                           \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),           \
+      DequantizeLinear<T>);
+
+// formula is Y = X / Scale + ZeroPoint
+template <typename T>
+Status QuantizeLinear<T>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor& x = *ctx->Input<Tensor>(0);
+  const Tensor& y_scale = *ctx->Input<Tensor>(1);
+  const Tensor* y_zero_point = ctx->Input<Tensor>(2);
+  Tensor& y = *ctx->Output(0, x.Shape());
+
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(&y_scale), "y_scale must be a scalar or 1D tensor of size 1.");
+  ORT_RETURN_IF_NOT(y_zero_point == nullptr || IsScalarOr1ElementVector(y_zero_point),
+                    "y_zero_point must be a scalar or 1D tensor of size 1.");
+
+  const float scale = *y_scale.template Data<float>();
+  const T zero_point = y_zero_point != nullptr ? *y_zero_point->template Data<T>() : static_cast<T>(0);
+
+  QuantizeLinearImpl<T>(x.template Data<float>(), scale, zero_point, y.template MutableData<T>(),
+                        static_cast<size_t>(x.Shape().Size()));
+  return Status::OK();
+}
+
+// formula is Y = (X - ZeroPoint) * Scale
+template <typename T>
+Status DequantizeLinear<T>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor& x = *ctx->Input<Tensor>(0);
+  const Tensor& x_scale = *ctx->Input<Tensor>(1);
+  const Tensor* x_zero_point = ctx->Input<Tensor>(2);
+  Tensor& y = *ctx->Output(0, x.Shape());
+
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(&x_scale), "x_scale must be a scalar or 1D tensor of size 1.");
+  ORT_RETURN_IF_NOT(x_zero_point == nullptr || IsScalarOr1ElementVector(x_zero_point),
+                    "x_zero_point must be a scalar or 1D tensor of size 1.");
+
+  const float scale = *x_scale.template Data<float>();
+  const T zero_point = x_zero_point != nullptr ? *x_zero_point->template Data<T>() : static_cast<T>(0);
+
+  DequantizeLinearImpl<T>(x.template Data<T>(), scale, zero_point, y.template MutableData<float>(),
+                          static_cast<size_t>(x.Shape().Size()));
+  return Status::OK();
+}
+
+REGISTER_Q_KERNEL_TYPED(uint8_t)
+REGISTER_Q_KERNEL_TYPED(int8_t)
+REGISTER_DQ_KERNEL_TYPED(uint8_t)
+REGISTER_DQ_KERNEL_TYPED(int8_t)
+
+}  // namespace cuda
+}  // namespace onnxruntime
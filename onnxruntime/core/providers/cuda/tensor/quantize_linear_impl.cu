@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "quantize_linear_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// the lowest value of int8 is -127 instead of -128, as on the CPU, so a zero point of 0 stays symmetric
+template <typename T>
+struct QuantizeRange;
+
+template <>
+struct QuantizeRange<uint8_t> {
+  static constexpr float min = 0.0f;
+  static constexpr float max = 255.0f;
+};
+
+template <>
+struct QuantizeRange<int8_t> {
+  static constexpr float min = -127.0f;
+  static constexpr float max = 127.0f;
+};
+
+template <typename T>
+__global__ void _QuantizeLinearKernel(
+    const float* input_data,
+    const float scale,
+    const T zero_point,
+    T* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  // rintf rounds half to even, as the spec requires
+  float value = rintf(input_data[id] / scale) + static_cast<float>(zero_point);
+  output_data[id] = static_cast<T>(fminf(fmaxf(value, QuantizeRange<T>::min), QuantizeRange<T>::max));
+}
+
+template <typename T>
+__global__ void _DequantizeLinearKernel(
+    const T* input_data,
+    const float scale,
+    const T zero_point,
+    float* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  output_data[id] = static_cast<float>(static_cast<int>(input_data[id]) - static_cast<int>(zero_point)) * scale;
+}
+
+template <typename T>
+void QuantizeLinearImpl(
+    const float* input_data,
+    const float scale,
+    const T zero_point,
+    T* output_data,
+    size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _QuantizeLinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input_data, scale, zero_point, output_data, (CUDA_LONG)N);
+}
+
+template <typename T>
+void DequantizeLinearImpl(
+    const T* input_data,
+    const float scale,
+    const T zero_point,
+    float* output_data,
+    size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _DequantizeLinearKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input_data, scale, zero_point, output_data, (CUDA_LONG)N);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                      \
+  template void QuantizeLinearImpl<T>(const float* input_data, const float scale, const T zero_point,           \
+                                      T* output_data, size_t N);                                                \
+  template void DequantizeLinearImpl<T>(const T* input_data, const float scale, const T zero_point,             \
+                                        float* output_data, size_t N);
+
+SPECIALIZED_IMPL(uint8_t)
+SPECIALIZED_IMPL(int8_t)
+
+}  // namespace cuda
+}  // namespace onnxruntime
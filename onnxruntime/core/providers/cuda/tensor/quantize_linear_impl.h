@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+void QuantizeLinearImpl(
+    const float* input_data,
+    const float scale,
+    const T zero_point,
+    T* output_data,
+    size_t count);
+
+template <typename T>
+void DequantizeLinearImpl(
+    const T* input_data,
+    const float scale,
+    const T zero_point,
+    float* output_data,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -46,9 +46,8 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   auto& input_dimensions = input_tensor->Shape().GetDims();
 
   // Initialize the starts & ends to the actual tensor shape
-  const size_t dimension_count = input_dimensions.size();
-  std::vector<int64_t> starts(dimension_count, 0);
-  std::vector<int64_t> steps(dimension_count, 1);
+  std::vector<int64_t> starts(input_dimensions.size(), 0);
+  std::vector<int64_t> steps(input_dimensions.size(), 1);
   std::vector<int64_t> output_dims(input_dimensions);
 
   if (dynamic) {
@@ -68,6 +67,42 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   if (output_size == 0) {
     return Status::OK();
   }
+
+  // Merge the innermost axes the slice copies whole into the axis before them, while that axis is sliced with a
+  // step of 1, so the innermost axis copies the longest contiguous runs of the input.
+  std::vector<int64_t> input_dims(input_dimensions);
+  size_t element_size = input_tensor->DataType()->Size();
+  while (input_dims.size() > 1 && starts.back() == 0 && steps.back() == 1 && output_dims.back() == input_dims.back() &&
+         steps[input_dims.size() - 2] == 1) {
+    const int64_t inner_size = input_dims.back();
+    input_dims.pop_back();
+    output_dims.pop_back();
+    starts.pop_back();
+    steps.pop_back();
+    input_dims.back() *= inner_size;
+    output_dims.back() *= inner_size;
+    starts.back() *= inner_size;
+  }
+
+  // Copy the contiguous runs of the innermost axis as wider words when they and the buffers are aligned to them.
+  if (!steps.empty() && steps.back() == 1) {
+    const uint64_t offset_bits = static_cast<uint64_t>(input_dims.back() * element_size) |
+                                 static_cast<uint64_t>(output_dims.back() * element_size) |
+                                 static_cast<uint64_t>(starts.back() * element_size) |
+                                 reinterpret_cast<uintptr_t>(input_tensor->DataRaw()) |
+                                 reinterpret_cast<uintptr_t>(output_tensor->MutableDataRaw());
+    const size_t copy_bytes = GetVectorizedCopyBytes(element_size, offset_bits);
+    if (copy_bytes != element_size) {
+      const int64_t elements_per_copy = static_cast<int64_t>(copy_bytes / element_size);
+      input_dims.back() /= elements_per_copy;
+      output_dims.back() /= elements_per_copy;
+      starts.back() /= elements_per_copy;
+      output_size /= elements_per_copy;
+      element_size = copy_bytes;
+    }
+  }
+  const size_t dimension_count = input_dims.size();
+
   CudaAsyncBuffer<int64_t> starts_buffer(this, dimension_count);
   gsl::span<int64_t> starts_buffer_span = starts_buffer.CpuSpan();
   for (int i = 0; i < dimension_count; ++i) {
@@ -83,7 +118,7 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   steps_buffer.CopyToGpu();
 
   CudaAsyncBuffer<int64_t> input_strides(this, dimension_count);
-  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_dimensions));
+  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_dims));
   input_strides.CopyToGpu();
 
   TensorPitches output_pitches(output_dims);
@@ -95,8 +130,6 @@ Status Slice<Tind, dynamic>::ComputeInternal(OpKernelContext* ctx) const {
   }
   div_strides.CopyToGpu();
 
-  size_t element_size = input_tensor->DataType()->Size();
-
   ORT_RETURN_IF_ERROR(SliceImpl(element_size,
                               gsl::narrow_cast<int32_t>(dimension_count),
                               starts_buffer.GpuPtr(),
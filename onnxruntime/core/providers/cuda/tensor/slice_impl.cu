@@ -72,6 +72,13 @@ Status SliceImpl(const size_t element_size,
           reinterpret_cast<ToCudaType<int64_t>::MappedType*>(output_data),
           (CUDA_LONG)N);
       break;
+    case sizeof(int4):
+      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+          dimension_count, starts, steps, input_strides, output_div_strides,
+          reinterpret_cast<const int4*>(input_data),
+          reinterpret_cast<int4*>(output_data),
+          (CUDA_LONG)N);
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for Slice operator");
   }
@@ -6,6 +6,9 @@
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 
+#include <algorithm>
+#include <numeric>
+
 namespace onnxruntime {
 namespace cuda {
 
@@ -46,6 +49,54 @@ std::tuple<int, int> TryTransposeWithCublas(const std::vector<size_t>& perm, con
   return std::make_tuple(M, N);
 }
 
+// Merges the input axes that stay consecutive in the output, after dropping the axes of size 1, so the transpose is
+// described by the fewest dimensions. A transpose of NCHW to NHWC merges to a batch of C x HW matrix transposes.
+static void MergeTransposeDims(const std::vector<int64_t>& input_dims, const std::vector<size_t>& perm,
+                               std::vector<int64_t>& merged_dims, std::vector<size_t>& merged_perm) {
+  // the input axes that aren't 1, in the output order
+  std::vector<size_t> output_axes;
+  for (auto axis : perm) {
+    if (input_dims[axis] != 1) {
+      output_axes.push_back(axis);
+    }
+  }
+
+  // the first input axis of each group of axes, and the group of each input axis, in the output order
+  std::vector<size_t> group_first_axes;
+  std::vector<int64_t> group_dims;
+  for (size_t i = 0; i < output_axes.size(); ++i) {
+    bool extends_group = false;
+    if (i > 0) {
+      // the axes are consecutive in the input if only axes of size 1 are between them
+      size_t axis = output_axes[i - 1] + 1;
+      while (axis < output_axes[i] && input_dims[axis] == 1) {
+        ++axis;
+      }
+      extends_group = axis == output_axes[i];
+    }
+    if (extends_group) {
+      group_dims.back() *= input_dims[output_axes[i]];
+    } else {
+      group_first_axes.push_back(output_axes[i]);
+      group_dims.push_back(input_dims[output_axes[i]]);
+    }
+  }
+
+  // the groups in the input order
+  const size_t merged_rank = group_first_axes.size();
+  std::vector<size_t> input_order(merged_rank);
+  std::iota(input_order.begin(), input_order.end(), size_t{0});
+  std::sort(input_order.begin(), input_order.end(),
+            [&group_first_axes](size_t a, size_t b) { return group_first_axes[a] < group_first_axes[b]; });
+
+  merged_dims.resize(merged_rank);
+  merged_perm.resize(merged_rank);
+  for (size_t i = 0; i < merged_rank; ++i) {
+    merged_dims[i] = group_dims[input_order[i]];
+    merged_perm[input_order[i]] = i;
+  }
+}
+
 template <typename T>
 Status Transpose<T>::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* X_ptr = ctx->Input<Tensor>(0);
@@ -92,18 +143,53 @@ Status Transpose<T>::ComputeInternal(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  CudaAsyncBuffer<int64_t> input_strides(this, rank);
-  CudaAsyncBuffer<size_t> perm(this, *p_perm);
-  CudaAsyncBuffer<fast_divmod> fdm_output_strides(this, rank);
-  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), input_dims));
-  ORT_ENFORCE(CalculateFdmStrides(fdm_output_strides.CpuSpan(), output_dims));
+  if (output_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  std::vector<int64_t> merged_dims;
+  std::vector<size_t> merged_perm;
+  MergeTransposeDims(input_dims, *p_perm, merged_dims, merged_perm);
+  const size_t merged_rank = merged_dims.size();
+
+  const void* input_data = X.DataRaw();
+  void* output_data = Y->MutableDataRaw();
+  const size_t element_size = X.DataType()->Size();
+
+  // the transpose keeps the order of the elements
+  if (merged_rank <= 1) {
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_data, input_data, output_shape.Size() * element_size,
+                                         cudaMemcpyDeviceToDevice));
+    return Status::OK();
+  }
+
+  // a matrix transpose, or a batch of them
+  if (merged_rank == 2 || (merged_rank == 3 && merged_perm[0] == 0)) {
+    const int64_t batch = merged_rank == 3 ? merged_dims[0] : 1;
+    const int64_t m = merged_dims[merged_rank - 2];
+    const int64_t n = merged_dims[merged_rank - 1];
+    if (CanDoTranspose3D(batch, m, n)) {
+      return Transpose3DImpl(element_size, batch, m, n, input_data, output_data);
+    }
+  }
+
+  std::vector<int64_t> merged_output_dims(merged_rank);
+  for (size_t i = 0; i < merged_rank; ++i) {
+    merged_output_dims[i] = merged_dims[merged_perm[i]];
+  }
+
+  CudaAsyncBuffer<int64_t> input_strides(this, merged_rank);
+  CudaAsyncBuffer<size_t> perm(this, merged_perm);
+  CudaAsyncBuffer<fast_divmod> fdm_output_strides(this, merged_rank);
+  ORT_ENFORCE(TensorPitches::Calculate(input_strides.CpuSpan(), merged_dims));
+  ORT_ENFORCE(CalculateFdmStrides(fdm_output_strides.CpuSpan(), merged_output_dims));
 
   ORT_RETURN_IF_ERROR(input_strides.CopyToGpu());
   ORT_RETURN_IF_ERROR(perm.CopyToGpu());
   ORT_RETURN_IF_ERROR(fdm_output_strides.CopyToGpu());
 
   TransposeImpl(
-      rank,
+      merged_rank,
       input_strides.GpuPtr(),
       perm.GpuPtr(),
       reinterpret_cast<const typename ToCudaType<T>::MappedType*>(X.template Data<T>()),
@@ -4,6 +4,9 @@
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "transpose_impl.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace onnxruntime {
 namespace cuda {
 
@@ -32,6 +35,84 @@ void TransposeImpl(size_t shape_rank, const int64_t* input_strides, const size_t
       fdm_output_strides, output_data, N);
 }
 
+// The tiles of the batched matrix transpose, each read and written by kTileDim x kBlockRows threads.
+constexpr int kTileDim = 32;
+constexpr int kBlockRows = 8;
+
+// Transposes the batch of m x n matrices of the input to n x m matrices. The threads of a block read a tile along
+// the rows of the input and write it along the rows of the output, so both the reads and the writes of each warp
+// are coalesced. The tile is padded by a column so the transposed reads of the shared memory don't conflict.
+template <typename T>
+__global__ void _Transpose3DKernel(const int64_t batch, const int m, const int n, const T* input_data,
+                                   T* output_data) {
+  __shared__ T tile[kTileDim][kTileDim + 1];
+
+  const int tile_row = blockIdx.y * kTileDim;
+  const int tile_col = blockIdx.x * kTileDim;
+  for (int64_t b = blockIdx.z; b < batch; b += gridDim.z) {
+    const T* input = input_data + b * m * n;
+    T* output = output_data + b * m * n;
+
+    const int col = tile_col + threadIdx.x;
+    for (int j = threadIdx.y; j < kTileDim; j += kBlockRows) {
+      const int row = tile_row + j;
+      if (row < m && col < n) {
+        tile[j][threadIdx.x] = input[row * n + col];
+      }
+    }
+    __syncthreads();
+
+    // the columns of the output are the rows of the input
+    const int output_col = tile_row + threadIdx.x;
+    for (int j = threadIdx.y; j < kTileDim; j += kBlockRows) {
+      const int output_row = tile_col + j;
+      if (output_row < n && output_col < m) {
+        output[output_row * m + output_col] = tile[threadIdx.x][j];
+      }
+    }
+    __syncthreads();
+  }
+}
+
+template <typename T>
+void Transpose3DImplT(int64_t batch, int m, int n, const void* input_data, void* output_data) {
+  dim3 block_dim(kTileDim, kBlockRows);
+  dim3 grid_dim((n + kTileDim - 1) / kTileDim,
+                (m + kTileDim - 1) / kTileDim,
+                static_cast<unsigned int>(std::min<int64_t>(batch, kMaxTranspose3DGridZ)));
+  _Transpose3DKernel<T><<<grid_dim, block_dim, 0>>>(batch, m, n, reinterpret_cast<const T*>(input_data),
+                                                     reinterpret_cast<T*>(output_data));
+}
+
+bool CanDoTranspose3D(int64_t batch, int64_t m, int64_t n) {
+  return batch > 0 && m > 0 && n > 0 &&
+         m * n <= std::numeric_limits<int>::max() &&
+         (m + kTileDim - 1) / kTileDim <= kMaxTranspose3DGridY &&
+         (n + kTileDim - 1) / kTileDim <= std::numeric_limits<int>::max();
+}
+
+Status Transpose3DImpl(size_t element_size, int64_t batch, int64_t m, int64_t n, const void* input_data,
+                       void* output_data) {
+  switch (element_size) {
+    case sizeof(int8_t):
+      Transpose3DImplT<int8_t>(batch, static_cast<int>(m), static_cast<int>(n), input_data, output_data);
+      break;
+    case sizeof(int16_t):
+      Transpose3DImplT<int16_t>(batch, static_cast<int>(m), static_cast<int>(n), input_data, output_data);
+      break;
+    case sizeof(int32_t):
+      Transpose3DImplT<int32_t>(batch, static_cast<int>(m), static_cast<int>(n), input_data, output_data);
+      break;
+    case sizeof(int64_t):
+      Transpose3DImplT<int64_t>(batch, static_cast<int>(m), static_cast<int>(n), input_data, output_data);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type not supported for Transpose operator");
+  }
+
+  return Status::OK();
+}
+
 #define SPECIALIZED_IMPL(T)                                                                                  \
   template void TransposeImpl<T>(size_t shape_rank, const int64_t* input_strides, const size_t* perm,        \
                                  const T* input_data, const fast_divmod* fdm_output_strides, T* output_data, \
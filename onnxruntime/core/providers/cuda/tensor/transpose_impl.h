@@ -4,6 +4,7 @@
 #pragma once
 #include <stdint.h>
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "core/common/common.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -12,5 +13,18 @@ template <typename T>
 void TransposeImpl(size_t shape_rank, const int64_t* input_strides, const size_t* perm, const T* input_data,
                    const fast_divmod* fdm_output_strides, T* output_data, size_t N);
 
+// The grid dimensions of a Transpose3DImpl launch are bounded by those of the device, the rows of tiles by
+// kMaxTranspose3DGridY and the matrices transposed concurrently by kMaxTranspose3DGridZ.
+constexpr int64_t kMaxTranspose3DGridY = 65535;
+constexpr int64_t kMaxTranspose3DGridZ = 65535;
+
+// Returns true if Transpose3DImpl can transpose a batch of m x n matrices.
+bool CanDoTranspose3D(int64_t batch, int64_t m, int64_t n);
+
+// Transposes the batch of m x n matrices of input_data to n x m matrices in output_data through tiles of shared
+// memory, so the reads and writes of the device memory are coalesced.
+Status Transpose3DImpl(size_t element_size, int64_t batch, int64_t m, int64_t n, const void* input_data,
+                       void* output_data);
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -273,7 +273,7 @@ std::vector<std::unique_ptr<ComputeCapability>> MKLDNNExecutionProvider::GetCapa
             const auto& next_node_inputs = next_node->InputDefs();
             bool input_from_subgraph = true;
             size_t inputs_count = 1;
-            if (next_node->OpType() == "Sum")
+            if (next_node->OpType() == "Sum" || next_node->OpType() == "Add" || next_node->OpType() == "Concat")
               inputs_count = next_node_inputs.size();
             for (size_t i = 0; i < inputs_count; i++) {
               auto in = next_node_inputs[i];
@@ -123,6 +123,28 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
       if (node->OutputDefs().size() > 1)
         supported = false;
     }
+    if (node->OpType() == "Add") {
+      // mkldnn sum doesn't broadcast, Add runs in the subgraph when its inputs have the same known shape
+      auto node_inputs = node->InputDefs();
+      const auto* shape_a = node_inputs[0]->Shape();
+      const auto* shape_b = node_inputs[1]->Shape();
+      if (shape_a == nullptr || shape_b == nullptr || shape_a->dim_size() != shape_b->dim_size()) {
+        supported = false;
+      } else {
+        for (int i = 0; i < shape_a->dim_size(); i++) {
+          const auto& dim_a = shape_a->dim(i);
+          const auto& dim_b = shape_b->dim(i);
+          if (!dim_a.has_dim_value() || !dim_b.has_dim_value() || dim_a.dim_value() != dim_b.dim_value()) {
+            supported = false;
+          }
+        }
+      }
+    }
+    if (node->OpType() == "Concat") {
+      // axis has no default value since opset 4
+      if (node->Op()->SinceVersion() < 4)
+        supported = false;
+    }
     return supported;
   }
 
@@ -150,7 +172,7 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
   mutable int subgraph_index_ = 0;
 
   // supported MklDnn Operators
-  std::set<std::string> mkldnn_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum",
+  std::set<std::string> mkldnn_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum", "Add", "Concat",
                                        "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN"};
 
   mutable std::unordered_map<std::string, std::shared_ptr<mkl_dnn::Subgraph>> mkl_subgraphs_;
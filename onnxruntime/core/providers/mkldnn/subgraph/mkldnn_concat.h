@@ -0,0 +1,158 @@
+// Copyright(C) 2019 Intel Corporation
+// Licensed under the MIT License
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_kernel.h"
+#include "core/util/math.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+template <typename T>
+class MklDnnConcat : public MklDnnKernel {
+ public:
+  explicit MklDnnConcat(const MklDnnNode& node,
+                        MKLDNNExecutionProvider* provider,
+                        const NodeAttributes& attributes,
+                        const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  Status CreatePrimitives(const OrtCustomOpApi* api,
+                          OrtKernelContext* context,
+                          mkldnn::engine& cpu_engine,
+                          std::vector<mkldnn::primitive>& net,
+                          mkldnn::memory::format& source_format) override {
+    Ort::CustomOpApi ort{*api};
+    int num_inputs = mklnode_ptr_->num_inputs;
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    // the inputs keep the formats of their parents, blocked ones included, and the output takes the format
+    // MKL-DNN picks for them
+    std::vector<int64_t> y_dims;
+    for (int i = 0; i < num_inputs; i++) {
+      TensorShape x_shape;
+      if (mklnode_ptr_->parent_nodes.empty()) {
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + i);
+        auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        auto tensor_shape = ort.GetTensorShape(tensor_info);
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        auto xshape = tensor_shape.data();
+        auto xdim = tensor_shape.size();
+
+        ort_source_format_ = GetSourceFormat(static_cast<int>(xdim));
+        source_format = ort_source_format_;
+        src_format_ = ort_source_format_;
+        x_shape = TensorShape(xshape, xdim);
+
+        mkldnn::memory::dims src_dims_mkl(x_shape.GetDims().begin(), x_shape.GetDims().end());
+        auto mpd = mkldnn::memory::primitive_desc(
+            mkldnn::memory::desc({src_dims_mkl}, MklDnnType<T>(), src_format_), cpu_engine);
+        srcs_pd_.push_back(mpd);
+        srcs_memory_.push_back(mkldnn::memory(mpd, nullptr));
+      } else {
+        x_shape = parents_[i].get()->primitive_dst_shape_;
+        auto mpd = parents_[i].get()->primitive_dst_mem_.get()->get_primitive_desc();
+        srcs_pd_.push_back(mpd);
+        srcs_memory_.push_back(*parents_[i].get()->primitive_dst_mem_);
+        ort_source_format_ = source_format;
+      }
+
+      if (i == 0) {
+        if (axis_ < 0) {
+          axis_ += static_cast<int64_t>(x_shape.NumDimensions());
+        }
+        if (axis_ < 0 || axis_ >= static_cast<int64_t>(x_shape.NumDimensions())) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Concat axis: ", axis_);
+        }
+        y_dims = x_shape.GetDims();
+      } else {
+        if (x_shape.NumDimensions() != y_dims.size()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Concat inputs must have the same rank.");
+        }
+        y_dims[axis_] += x_shape[axis_];
+      }
+    }
+    primitive_dst_shape_ = TensorShape(y_dims);
+
+    mkldnn::memory::dims dst_dims_mkl(y_dims.begin(), y_dims.end());
+    primitive_dst_md_.reset(new mkldnn::memory::desc(
+        {dst_dims_mkl}, MklDnnType<T>(), mkldnn::memory::format::any));
+    concat_pd_.reset(new mkldnn::concat::primitive_desc(
+        *primitive_dst_md_, static_cast<int>(axis_), srcs_pd_));
+    primitive_dst_format_ = static_cast<mkldnn::memory::format>(concat_pd_->dst_primitive_desc().desc().data.format);
+
+    if (mklnode_ptr_->output_index >= 0 && primitive_dst_format_ == ort_source_format_) {
+      // Last node and re-order not needed. The output buffer is bound in Bind
+      primitive_dst_mem_.reset(new mkldnn::memory(concat_pd_->dst_primitive_desc(), nullptr));
+    } else {
+      // Intermediate node, or last node which reorders its output.
+      primitive_dst_mem_.reset(new mkldnn::memory(concat_pd_->dst_primitive_desc()));
+    }
+
+    std::vector<mkldnn::primitive::at> inputs;
+    for (int i = 0; i < num_inputs; i++) {
+      inputs.push_back(srcs_memory_[i]);
+    }
+    net.push_back(mkldnn::concat(*concat_pd_, inputs, *primitive_dst_mem_));
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // one of the end nodes. Allocate output buffer memory and
+      // reorder is necessary
+      mkldnn::memory::data_type t = MklDnnType<T>();
+      InitDstReorderOutput(cpu_engine, t, net);
+    }
+    return Status::OK();
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    int num_inputs = mklnode_ptr_->num_inputs;
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      for (int i = 0; i < num_inputs; i++) {
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + i);
+        const T* src_data = const_cast<T*>(ort.GetTensorData<T>(input_tensor));
+        srcs_memory_[i].set_data_handle(static_cast<void*>(const_cast<T*>(src_data)));
+      }
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // Last node. Allocate output buffer memory and reorder if needed
+      const auto& y_dims = primitive_dst_shape_.GetDims();
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0], static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      T* dst_data = ort.GetTensorMutableData<T>(output);
+
+      if (primitive_dst_format_ != ort_source_format_) {
+        reorder_dst_mem_to_->set_data_handle(dst_data);
+      } else {
+        primitive_dst_mem_->set_data_handle(dst_data);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    auto attr = attributes.find(attributes_prefix + "axis");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetIntAttr(proto, axis_);
+    }
+  }
+
+ private:
+  int64_t axis_ = 0;
+
+  std::vector<mkldnn::memory> srcs_memory_;
+  std::vector<mkldnn::memory::primitive_desc> srcs_pd_;
+  std::unique_ptr<mkldnn::concat::primitive_desc> concat_pd_;
+};
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
@@ -364,7 +364,7 @@ class MklDnnConv : public MklDnnKernel {
     {
       // lock to make sure reordering is done only once
       std::lock_guard<OrtMutex> lock(provider_->GetMutex());
-      std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(GetWeightsKey());
 
       if (filter_dst_mem == nullptr) {
         auto pd = mkldnn::memory::primitive_desc(
@@ -379,7 +379,7 @@ class MklDnnConv : public MklDnnKernel {
         DoReorder<T>(params);
         provider_->SaveAllocatedMemory(std::move(filter_reorder_buffer));
         filter_data = static_cast<T*>(filter_dst_mem->get_data_handle());
-        provider_->SetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_dst_mem);
+        provider_->SetWeightsMemoryBuffer(GetWeightsKey(), filter_dst_mem);
       }
     }
   }
@@ -405,10 +405,10 @@ class MklDnnConv : public MklDnnKernel {
       const OrtValue* binput_tensor = ort.KernelContext_GetInput(context, input_index + 2);
       bias_data = const_cast<T*>(ort.GetTensorData<T>(binput_tensor));
     }
-    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(GetWeightsKey());
     if (filter_dst_mem == nullptr) {
       ReorderWeights(api, context, GetEngine());
-      filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      filter_dst_mem = provider_->GetWeightsMemoryBuffer(GetWeightsKey());
     }
     filter_data = static_cast<T*>(filter_dst_mem->get_data_handle());
 
@@ -455,6 +455,11 @@ class MklDnnConv : public MklDnnKernel {
   }
 
  private:
+  // The weights are reordered once per format MKL-DNN picks for them, which may change with the input shape.
+  std::string GetWeightsKey() const {
+    return mklnode_ptr_->weight_name + "-" + std::to_string(static_cast<int>(mkldnn_filter_format_));
+  }
+
   void ReadAttributes(const NodeAttributes& attributes,
                       const std::string attributes_prefix = "") override {
     std::string auto_pad;
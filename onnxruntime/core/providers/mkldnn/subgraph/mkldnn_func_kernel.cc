@@ -14,6 +14,7 @@
 #include "core/providers/mkldnn/subgraph/mkldnn_pool.h"
 #include "core/providers/mkldnn/subgraph/mkldnn_sum.h"
 #include "core/providers/mkldnn/subgraph/mkldnn_lrn.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_concat.h"
 #include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
@@ -143,7 +144,7 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
-      } else if (mkldnn_node.name == "Sum") {
+      } else if (mkldnn_node.name == "Sum" || mkldnn_node.name == "Add") {
         std::ostringstream os;
         os << "Sum-" << mkldnn_node.node_index << "-";
         std::shared_ptr<MklDnnSum<T>> kernel;
@@ -152,6 +153,15 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
+      } else if (mkldnn_node.name == "Concat") {
+        std::ostringstream os;
+        os << "Concat-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnConcat<T>> kernel;
+        kernel.reset(new MklDnnConcat<T>(mkldnn_node, params.provider, params.attributes, os.str()));
+        for (auto index : mkldnn_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
       } else if (mkldnn_node.name == "LRN") {
         std::ostringstream os;
         os << "LRN-" << mkldnn_node.node_index << "-";
@@ -201,8 +211,11 @@ class SubgraphPrimitivePool : public PrimitivePool<T> {
                                    OrtKernelContext* context,
                                    const SubgraphParams& params) {
     Ort::CustomOpApi ort{*api};
+    // the primitives are cached by the shapes of all the inputs of the subgraph, so that the shapes seen before
+    // reuse their primitives, and the weights reordered for them
     std::string dims_str;
-    for (auto i = 0; i < params.subgraph->mkldnn_nodes[0].num_inputs; i++) {
+    const size_t num_inputs = ort.KernelContext_GetInputCount(context);
+    for (size_t i = 0; i < num_inputs; i++) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
       auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
       auto tensor_shape = ort.GetTensorShape(tensor_info);
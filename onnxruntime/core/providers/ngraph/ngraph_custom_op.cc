@@ -1,6 +1,7 @@
 // Copyright(C) 2019 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -37,10 +38,43 @@ static bool check_ngraph_dump_ops() {
 #endif
 }
 
-NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
-                               const ONNX_NAMESPACE::ModelProto& model_proto,
-                               const std::shared_ptr<ngraph::runtime::Backend>& ng_backend) :
+NGRAPHExecutableCache::NGRAPHExecutableCache(const ONNX_NAMESPACE::ModelProto& model_proto,
+                                             const std::shared_ptr<ngraph::runtime::Backend>& ng_backend) :
   ng_backend_{ng_backend}, model_proto_{model_proto}
+{
+  // Get cache size from environment
+  std::string tempSize;
+  #ifdef _WIN32
+  char *buf{nullptr};
+  size_t bufSize = 0;
+  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
+    tempSize = buf;
+    free(buf);
+  }
+  #else
+  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
+    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
+  }
+  #endif
+  cache_size_ = tempSize.empty() ? NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE : std::max(std::stoi(tempSize), 1);
+}
+
+NGRAPHExecutableCache::~NGRAPHExecutableCache() {
+  for (const auto& compiled_exe : ng_exe_map_) {
+    if (compiled_exe.second->exe != nullptr) {
+      ng_backend_->remove_compiled_function(compiled_exe.second->exe);
+    }
+  }
+}
+
+void NGRAPHExecutableCache::SerializeModel(std::ostream& stream) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  model_proto_.SerializeToOstream(&stream);
+}
+
+NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
+                               const std::shared_ptr<NGRAPHExecutableCache>& executables) :
+  executables_{executables}
 {
   allocate_func_ = context->allocate_func;
   release_func_ = context->release_func;
@@ -49,18 +83,14 @@ NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
 
   if (check_ngraph_dump_ops()) {
     std::fstream dump(name_ + ".onnx", std::ios::out | std::ios::trunc | std::ios::binary);
-    model_proto_.SerializeToOstream(&dump);
-  }
-}
-
-NGRAPHCustomOp::~NGRAPHCustomOp() {
-  for (const auto& compiled_exe : ng_exe_map_) {
-    ng_backend_->remove_compiled_function(compiled_exe.second);
+    executables_->SerializeModel(dump);
   }
 }
 
 //This method gets called in critical path of execution: Optimize
-void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const {
+std::shared_ptr<NGRAPHExecutableCache::CompiledExecutable> NGRAPHExecutableCache::Get(const OrtCustomOpApi* api,
+                                                                                      OrtKernelContext* context,
+                                                                                      const std::string& name) {
   Ort::CustomOpApi ort{*api};
 
   size_t num_inputs = ort.KernelContext_GetInputCount(context);
@@ -71,123 +101,105 @@ void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* con
   //Optimizing for general case of 4D tensors
   uniq_input_shape.reserve(4 * sizeof(int64_t) * num_inputs + num_inputs);
 
+  std::vector<std::vector<int64_t>> input_shapes;
+  input_shapes.reserve(num_inputs);
   for (size_t i = 0; i < num_inputs; i++) {
     const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
     auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-    auto tensor_shape = ort.GetTensorShape(tensor_info);
+    input_shapes.push_back(ort.GetTensorShape(tensor_info));
     ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
 
+    const auto& tensor_shape = input_shapes.back();
     const auto ndim = tensor_shape.size();
     uniq_input_shape.append(reinterpret_cast<const char*>(&ndim), sizeof(ndim));
     uniq_input_shape.append(reinterpret_cast<const char*>(tensor_shape.data()), ndim * sizeof(int64_t));
   }
 
-  // Get cache size from environment
-  std::string tempSize;
-  #ifdef _WIN32
-  char *buf{nullptr};
-  size_t bufSize = 0;
-  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
-    tempSize = buf;
-    free(buf);
-  }
-  #else
-  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
-    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
+  std::lock_guard<std::mutex> lock(cache_lock_);
+
+  //ng_exe with current shape already exists: move it to the front of the LRU list
+  auto it = ng_exe_map_.find(uniq_input_shape);
+  if (it != ng_exe_map_.end()) {
+    keyCache.splice(keyCache.begin(), keyCache, it->second->key_cache_pos);
+    return it->second;
   }
-  #endif
-  size_t cacheSize = tempSize.empty() ? NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE : std::stoi(tempSize);
-
-  // Not in cache
-  if (ng_exe_map_.find(uniq_input_shape) == ng_exe_map_.end()) {
-    // Check if full
-    if (keyCache.size() == cacheSize) {
-      // Delete least recently used element
-      std::string last = keyCache.back();
-  
-      // Pop the last elmeent
-      keyCache.pop_back();
-  
-      // Erase the last element from cache
-      ng_exe_map_.erase(ng_exe_map_.find(last)); 
-    } 
-  } 
-  
-  // Found in cache 
-  else {
-    keyCache.remove(uniq_input_shape);
-  }
-  
-  // update reference
-  keyCache.push_front(uniq_input_shape);
-  auto it = ng_exe_map_.insert({uniq_input_shape, nullptr});
-
-  //ng_exe with current shape already exists
-  if (!it.second) {
-    ng_curr_exe_ = it.first->second;
-    return;
-  } else {
-    auto graph_proto = model_proto_.mutable_graph();
-
-    LOGS_DEFAULT(INFO) << "[NGRAPHCustomOp] Compiling customOp: " << name_;
-
-    // Clear previous shapes if any and set new input shapes
-    for (size_t i = 0; i < num_inputs; i++) {
-      auto g_in_shape = graph_proto->mutable_input((int)i)->mutable_type()->mutable_tensor_type()->mutable_shape();
-      g_in_shape->clear_dim();
-
-      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
-      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-      auto tensor_shape = ort.GetTensorShape(tensor_info);
-      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
-
-      for (size_t dim = 0; dim < tensor_shape.size(); dim++) {
-        g_in_shape->add_dim()->set_dim_value(tensor_shape[dim]);
-      }
-    }
 
-    std::istringstream model_stream{model_proto_.SerializeAsString()};
-    std::shared_ptr<ngraph::Function> ng_function;
-    try {
-      ng_function = ngraph::onnx_import::import_onnx_model(model_stream);
-    } catch (const std::exception& exp) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Exception while importing model to nGraph: " << std::string(exp.what());
-      throw;
-    } catch (...) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Unknown exception while importing model to nGraph";
-      throw;
-    }
+  auto graph_proto = model_proto_.mutable_graph();
 
-    for (auto& result : ng_function->get_results()) {
-      result->set_needs_default_layout(true);
-    }
+  LOGS_DEFAULT(INFO) << "[NGRAPHCustomOp] Compiling customOp: " << name;
 
-    // Finally compile nGraph with backend.
-    try {
-      ng_curr_exe_ = ng_backend_->compile(ng_function);
-    } catch (const std::exception& exp) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Exception while compiling ngraph::Function: " << std::string(exp.what());
-    } catch (...) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - " << "Unknown exception while compiling ngraph::Function";
+  // Clear previous shapes if any and set new input shapes
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto g_in_shape = graph_proto->mutable_input((int)i)->mutable_type()->mutable_tensor_type()->mutable_shape();
+    g_in_shape->clear_dim();
+
+    for (const auto dim : input_shapes[i]) {
+      g_in_shape->add_dim()->set_dim_value(dim);
     }
-    it.first->second = ng_curr_exe_;
   }
-}  // namespace ngraph_ep
+
+  std::istringstream model_stream{model_proto_.SerializeAsString()};
+  std::shared_ptr<ngraph::Function> ng_function;
+  try {
+    ng_function = ngraph::onnx_import::import_onnx_model(model_stream);
+  } catch (const std::exception& exp) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name << " - "
+                        << "Exception while importing model to nGraph: " << std::string(exp.what());
+    throw;
+  } catch (...) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name << " - "
+                        << "Unknown exception while importing model to nGraph";
+    throw;
+  }
+
+  for (auto& result : ng_function->get_results()) {
+    result->set_needs_default_layout(true);
+  }
+
+  // Finally compile nGraph with backend.
+  auto compiled_exe = std::make_shared<CompiledExecutable>();
+  try {
+    compiled_exe->exe = ng_backend_->compile(ng_function);
+  } catch (const std::exception& exp) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name << " - "
+                        << "Exception while compiling ngraph::Function: " << std::string(exp.what());
+  } catch (...) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name << " - " << "Unknown exception while compiling ngraph::Function";
+  }
+
+  // Don't cache a failed compilation, the next run with these shapes retries it
+  if (compiled_exe->exe == nullptr) {
+    return compiled_exe;
+  }
+
+  // Check if full: delete least recently used element.
+  // A Compute still running it keeps the executable alive until it is done.
+  if (keyCache.size() >= cache_size_) {
+    auto last = ng_exe_map_.find(keyCache.back());
+    ng_backend_->remove_compiled_function(last->second->exe);
+    ng_exe_map_.erase(last);
+    keyCache.pop_back();
+  }
+
+  keyCache.push_front(uniq_input_shape);
+  compiled_exe->key_cache_pos = keyCache.begin();
+  ng_exe_map_.emplace(uniq_input_shape, compiled_exe);
+  return compiled_exe;
+}
 
 //This method gets called in critical path of execution: Optimize
 Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const {
   Ort::CustomOpApi ort{*api};
 
   // Initialize nGraph function if it is not already initialized.
-  {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    Initialize(api, context);
+  auto compiled_exe = executables_->Get(api, context, name_);
+  if (compiled_exe->exe == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Failed to compile the nGraph function");
   }
 
-  ORT_ENFORCE(ng_curr_exe_ != nullptr);
+  // Computes on different executables run concurrently
+  std::lock_guard<std::mutex> lock(compiled_exe->call_lock);
+  const auto& ng_exe = compiled_exe->exe;
 
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_inputs;
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_outputs;
@@ -195,11 +207,10 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   // Write ONNXR input data to nGraph input tensors.
   try {
     unsigned input_index = 0;
-    for (const auto& ng_param : ng_curr_exe_->get_parameters()) {
+    for (const auto& ng_param : ng_exe->get_parameters()) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index++);
       void* input_data = const_cast<void*>(ort.GetTensorData<void>(input_tensor));
-      std::lock_guard<std::mutex> lock(compute_lock_);
-      ng_inputs.emplace_back(ng_backend_->create_tensor(ng_param->get_output_element_type(0), ng_param->get_output_shape(0), input_data));
+      ng_inputs.emplace_back(executables_->Backend()->create_tensor(ng_param->get_output_element_type(0), ng_param->get_output_shape(0), input_data));
     }
   } catch (const std::exception& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Exception while copying input data to nGraph: " + std::string(exp.what()));
@@ -211,15 +222,14 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   try {
     //TODO: Optimize
     unsigned output_index = 0;
-    for (auto& ng_result : ng_curr_exe_->get_results()) {
+    for (auto& ng_result : ng_exe->get_results()) {
       const auto& dtype = ng_result->get_element_type();
       const auto& shape = ng_result->get_shape();
 
       std::vector<int64_t> ort_shape{shape.begin(), shape.end()};
       OrtValue* output_tensor = ort.KernelContext_GetOutput(context, output_index++, ort_shape.data(), ort_shape.size());
       void* output_data = ort.GetTensorMutableData<void>(output_tensor);
-      std::lock_guard<std::mutex> lock(compute_lock_);
-      ng_outputs.emplace_back(ng_backend_->create_tensor(dtype, shape, output_data));
+      ng_outputs.emplace_back(executables_->Backend()->create_tensor(dtype, shape, output_data));
     }
   } catch (const std::exception& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Exception while creating nGraph output Tensor: " + std::string(exp.what()));
@@ -229,8 +239,7 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
 
   // Run the graph through nGraph.
   try {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    if (!ng_curr_exe_->call(ng_outputs, ng_inputs))
+    if (!ng_exe->call(ng_outputs, ng_inputs))
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Error while executing nGraph computation");
   } catch (const std::exception& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Exception while executing nGraph computation: " + std::string(exp.what()));
@@ -20,25 +20,76 @@
 #include "core/framework/func_api.h"
 #include "core/graph/onnx_protobuf.h"
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 namespace onnxruntime {
 namespace ngraph_ep {
 
-class NGRAPHCustomOp {
+/*
+The executables nGraph compiled for a fused subgraph, shared by the kernels of the sessions that share the functions
+compiled for the subgraph, see CompiledFuncCache. So the subgraph is compiled once per input shapes in the process.
+*/
+class NGRAPHExecutableCache {
  public:
-  NGRAPHCustomOp(const ComputeContext* context,
-                 const ONNX_NAMESPACE::ModelProto& model_proto,
-                 const std::shared_ptr<ngraph::runtime::Backend>& ng_backend);
+  NGRAPHExecutableCache(const ONNX_NAMESPACE::ModelProto& model_proto,
+                        const std::shared_ptr<ngraph::runtime::Backend>& ng_backend);
 
-  Status Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const;
+  ~NGRAPHExecutableCache();
 
-  ~NGRAPHCustomOp();
+  /*
+  An executable compiled for some input shapes. Executables of different input shapes run concurrently,
+  while the calls of an executable are serialized.
+  */
+  struct CompiledExecutable {
+    std::shared_ptr<ngraph::runtime::Executable> exe;
+    std::mutex call_lock;
+    // position of the key in keyCache
+    std::list<std::string>::iterator key_cache_pos;
+  };
+
+  // Returns the executable for the shapes of the inputs, compiling it on a cache miss. name is the name of the
+  // fused node, for the logs.
+  std::shared_ptr<CompiledExecutable> Get(const OrtCustomOpApi* api, OrtKernelContext* context,
+                                          const std::string& name);
+
+  const std::shared_ptr<ngraph::runtime::Backend>& Backend() const { return ng_backend_; }
+
+  // Writes the subgraph as an ONNX model.
+  void SerializeModel(std::ostream& stream);
 
  private:
-  void Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const;
-
   std::shared_ptr<ngraph::runtime::Backend> ng_backend_;
 
-  mutable std::shared_ptr<ngraph::runtime::Executable> ng_curr_exe_ = nullptr;
+  /*
+  nGraph::Executable objects are specific to input shapes.
+  Here we keep a LRU cache of nGraph::Executable objects with key as input shapes, of at most cache_size_ entries,
+  set by ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE.
+  Logically, key = [i0.rank,[i0.dims],i1.rank,[i1.dims] ... iN.rank,[iN.dims]] raw bytes enclosed inside a string.
+  Example: input0.shape(1,2,3) input1.shape(4,5)
+  key = [3,1,2,3,2,4,5]
+*/
+  std::unordered_map<std::string, std::shared_ptr<CompiledExecutable>> ng_exe_map_;
+  // keys of ng_exe_map_, most recently used first
+  std::list<std::string> keyCache;
+
+  size_t cache_size_;
+
+  // guards ng_exe_map_, keyCache and model_proto_, but not the calls of the executables
+  std::mutex cache_lock_;
+
+  ONNX_NAMESPACE::ModelProto model_proto_;
+};
+
+class NGRAPHCustomOp {
+ public:
+  NGRAPHCustomOp(const ComputeContext* context, const std::shared_ptr<NGRAPHExecutableCache>& executables);
+
+  Status Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const;
+
+ private:
+  std::shared_ptr<NGRAPHExecutableCache> executables_;
 
   AllocateFunc allocate_func_ = nullptr;
 
@@ -47,20 +98,6 @@ class NGRAPHCustomOp {
   AllocatorHandle allocator_ = nullptr;
 
   std::string name_;
-
-  /*
-  nGraph::Executable objects are specific to input shapes.
-  Here we keep of a cache of nGraph::Executable objects with key as input shapes. TODO: Configure size of this cache.
-  Logically, key = [i0.rank,[i0.dims],i1.rank,[i1.dims] ... iN.rank,[iN.dims]] raw bytes enclosed inside a string.
-  Example: input0.shape(1,2,3) input1.shape(4,5)
-  key = [3,1,2,3,2,4,5]
-*/
-  mutable std::unordered_map<std::string, std::shared_ptr<ngraph::runtime::Executable>> ng_exe_map_;
-  mutable std::list<std::string> keyCache;
-  
-  mutable std::mutex compute_lock_;
-
-  mutable ONNX_NAMESPACE::ModelProto model_proto_;
 };
 }  // namespace ngraph_ep
 }  // namespace onnxruntime
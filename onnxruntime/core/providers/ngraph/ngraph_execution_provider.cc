@@ -32,7 +32,7 @@ namespace onnxruntime {
 constexpr const char* NGRAPH = "nGraph";
 
 NGRAPHExecutionProvider::NGRAPHExecutionProvider(const NGRAPHExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kNGraphExecutionProvider} {
+    : IExecutionProvider{onnxruntime::kNGraphExecutionProvider}, ng_backend_type_{info.ng_backend_type} {
 
   ORT_ENFORCE(info.ng_backend_type == "CPU", "nGraph Execution Provider for onnxruntime currently is only supported for CPU backend.");
 
@@ -560,12 +560,12 @@ Status NGRAPHExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& f
   for (const auto& fused_node : fused_nodes) {
     NodeComputeInfo compute_info;
 
-    // Local copy of backend since, class members cannot be captured.
-    auto ngraph_backend = ng_backend_;
-    compute_info.create_state_func = [model_proto = GetModelProtoFromFusedNode(fused_node), ngraph_backend]
-                                     (ComputeContext* context, FunctionState* state)
+    // The kernels of every session sharing these functions share the executables compiled for the subgraph.
+    auto executables = std::make_shared<ngraph_ep::NGRAPHExecutableCache>(GetModelProtoFromFusedNode(fused_node),
+                                                                           ng_backend_);
+    compute_info.create_state_func = [executables](ComputeContext* context, FunctionState* state)
     {
-      auto* p = new ngraph_ep::NGRAPHCustomOp(context, model_proto, ngraph_backend);
+      auto* p = new ngraph_ep::NGRAPHCustomOp(context, executables);
       *state = p;
       return 0;
     };
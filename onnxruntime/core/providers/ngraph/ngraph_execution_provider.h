@@ -32,7 +32,11 @@ class NGRAPHExecutionProvider : public IExecutionProvider {
   Status Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                  std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
+  // the compiled functions hold the fused subgraph, the backend and the executables it compiled, not the provider
+  std::string GetCompileCacheKey() const override { return ng_backend_type_; }
+
  private:
+  const std::string ng_backend_type_;
   std::shared_ptr<ngraph::runtime::Backend> ng_backend_;
 };
 
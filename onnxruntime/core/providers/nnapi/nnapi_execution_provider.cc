@@ -211,8 +211,9 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     dnn::ModelBuilder model_builder;
     onnx_reader.ReadOnnx(model_proto, model_builder);
     model_builder.AllowFp16(true);
-    auto dnn_model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
-    dnn_models_.emplace(fused_node->Name(), std::move(dnn_model));
+    auto nnapi_model = std::make_unique<NnapiModel>();
+    nnapi_model->dnn_model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
+    dnn_models_.emplace(fused_node->Name(), std::move(nnapi_model));
 
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [&](ComputeContext* context, FunctionState* state) {
@@ -221,20 +222,25 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     };
 
     compute_info.release_state_func = [](FunctionState state) {
-      // the `state` is a dnn::model managed by unique_ptr
+      // the `state` is a NnapiModel managed by unique_ptr
       ORT_UNUSED_PARAMETER(state);
     };
 
     compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
-      dnn::Model* model = reinterpret_cast<dnn::Model*>(state);
+      NnapiModel* nnapi_model = reinterpret_cast<NnapiModel*>(state);
+      dnn::Model* model = nnapi_model->dnn_model.get();
+      std::lock_guard<std::mutex> lock(nnapi_model->run_lock);
+
       const size_t num_inputs = ort.KernelContext_GetInputCount(context);
       const size_t num_outputs = ort.KernelContext_GetOutputCount(context);
       ORT_ENFORCE(model->GetInputs().size() <= num_inputs, "Inconsistent input sizes");
       ORT_ENFORCE(model->GetOutputs().size() == num_outputs, "Inconsistent output sizes");
-      // Maintain the created nhwc buffers so that they can be deleted after inferencing
-      std::vector<float*> nhwc_inputs;
-      std::vector<std::tuple<size_t, float*, std::vector<int64_t>>> nhwc_outputs;
+      nnapi_model->nhwc_inputs.resize(model->GetInputs().size());
+      nnapi_model->nhwc_outputs.resize(num_outputs);
+
+      // The outputs which are not 4-D are written in place, the 4-D ones are transposed from their NHWC buffer
+      std::vector<std::pair<size_t, std::vector<int64_t>>> nhwc_outputs;
       for (size_t i = 0; i < num_outputs; i++) {
         const auto output_name = model->GetOutputs()[i];
         const auto output_shape = model->GetShape(output_name);
@@ -243,9 +249,10 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           // NHWC to NCHW
           std::swap(int64_output_shape[1], int64_output_shape[3]);
           std::swap(int64_output_shape[2], int64_output_shape[3]);
-          float* nhwc_output = new float[model->GetSize(output_name)];
-          model->SetOutputBuffer(i, nhwc_output);
-          nhwc_outputs.push_back(std::make_tuple(i, nhwc_output, int64_output_shape));
+          auto& nhwc_output = nnapi_model->nhwc_outputs[i];
+          nhwc_output.resize(model->GetSize(output_name));
+          model->SetOutputBuffer(i, nhwc_output.data());
+          nhwc_outputs.emplace_back(i, int64_output_shape);
         } else {
           auto* output_tensor = ort.KernelContext_GetOutput(context, i, int64_output_shape.data(), int64_output_shape.size());
           model->SetOutputBuffer(i, ort.GetTensorMutableData<float>(output_tensor));
@@ -262,7 +269,9 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
         if (tensor_shape.size() == 4) {
           // Transpose nchw -> nhwc manually
           const int N = tensor_shape[0], C = tensor_shape[1], H = tensor_shape[2], W = tensor_shape[3];
-          float* nhwc_input = new float[N * C * H * W];
+          auto& nhwc_input_buffer = nnapi_model->nhwc_inputs[i];
+          nhwc_input_buffer.resize(static_cast<size_t>(N) * C * H * W);
+          float* nhwc_input = nhwc_input_buffer.data();
           for (int n = 0; n < N; n++) {
             for (int c = 0; c < C; c++) {
               for (int h = 0; h < H; h++) {
@@ -273,7 +282,6 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
             }
           }
           inputs.push_back(nhwc_input);
-          nhwc_inputs.push_back(nhwc_input);
         } else {
           inputs.push_back(input);
         }
@@ -281,12 +289,10 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
       }
       model->Predict(inputs);
       // Transpose nhwc -> nchw manually
-      for (size_t i = 0; i < nhwc_outputs.size(); i++) {
-        const auto output = nhwc_outputs[i];
-        size_t index;
-        float* nhwc_data;
-        std::vector<int64_t> nchw_shape;
-        std::tie(index, nhwc_data, nchw_shape) = output;
+      for (const auto& output : nhwc_outputs) {
+        const size_t index = output.first;
+        const auto& nchw_shape = output.second;
+        const float* nhwc_data = nnapi_model->nhwc_outputs[index].data();
         auto* output_tensor = ort.KernelContext_GetOutput(context, index, nchw_shape.data(), nchw_shape.size());
         const int N = nchw_shape[0], C = nchw_shape[1], H = nchw_shape[2], W = nchw_shape[3];
         float* nchw_output = ort.GetTensorMutableData<float>(output_tensor);
@@ -300,12 +306,6 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           }
         }
       }
-      for (auto nhwc_input : nhwc_inputs) {
-        delete[] nhwc_input;
-      }
-      for (auto nhwc_output : nhwc_outputs) {
-        delete[] std::get<1>(nhwc_output);
-      }
       return Status::OK();
     };
 
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "core/framework/execution_provider.h"
 #include "core/graph/onnx_protobuf.h"
 #include "dnnlibrary/Model.h"
@@ -19,7 +21,17 @@ class NnapiExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<dnn::Model>> dnn_models_;
+  // A compiled subgraph, with the buffers of the NHWC copies of its 4-D inputs and outputs,
+  // allocated at the first run and reused by the next ones
+  struct NnapiModel {
+    std::unique_ptr<dnn::Model> dnn_model;
+    std::vector<std::vector<float>> nhwc_inputs;
+    std::vector<std::vector<float>> nhwc_outputs;
+    // the buffers and the output bindings of dnn_model are shared by the runs
+    std::mutex run_lock;
+  };
+
+  std::unordered_map<std::string, std::unique_ptr<NnapiModel>> dnn_models_;
   std::vector<std::vector<int>> GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const;
 };
 }  // namespace onnxruntime
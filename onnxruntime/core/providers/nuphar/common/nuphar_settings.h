@@ -33,6 +33,18 @@ constexpr static const char* kNupharActivations_DeepCpu = "deep_cpu_activation";
 // Option to control nuphar code generation target (avx2 or avx512)
 constexpr static const char* kNupharCodeGenTarget = "nuphar_codegen_target";
 
+// Option to control the number of threads compiling the subgraphs of a fused node, 1 to compile them sequentially.
+// Defaults to the number of hardware threads
+constexpr static const char* kNupharCodeGenThreads = "nuphar_codegen_threads";
+
+// Options to control the specialization of subgraphs to the realized values of their symbolic dims.
+// A subgraph is specialized in the background once it ran nuphar_specialize_hot_count times with the same values,
+// 0 to disable, for at most nuphar_specialize_max_funcs different values.
+constexpr static const char* kNupharSpecializeHotCount = "nuphar_specialize_hot_count";
+constexpr static const char* kNupharSpecializeMaxFuncs = "nuphar_specialize_max_funcs";
+constexpr static int kNupharSpecializeHotCount_Default = 64;
+constexpr static int kNupharSpecializeMaxFuncs_Default = 4;
+
 // cache version number (MAJOR.MINOR.PATCH) following https://semver.org/
 // 1. MAJOR version when you make incompatible changes that old cache files no longer work,
 // 2. MINOR version when you add functionality in a backwards - compatible manner, and
@@ -42,6 +54,9 @@ constexpr static const char* kNupharCacheVersion_Current = "1.0.0";
 
 constexpr static const char* kNupharCacheSoName_Default = "jit.so";
 
+// the model checksum of the functions cached as LLVM IR, written next to them in the cache directory
+constexpr static const char* kNupharCacheJITChecksumFileName = "jit_checksum.txt";
+
 void CreateNupharCodeGenSettings(const NupharExecutionProviderInfo& info);
 
 }  // namespace nuphar
@@ -16,6 +16,9 @@
 #include <tvm/ir_pass.h>
 #include <experimental/filesystem>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_set>
 namespace fs = std::experimental::filesystem;
 
 namespace onnxruntime {
@@ -126,42 +129,92 @@ static bool VerifyTVMModuleChecksum(const std::string& so_path) {
   return last_checksum_validated;
 }
 
-tvm::runtime::PackedFunc LoadTVMPackedFuncFromCache(const std::string& func_name) {
-  std::string so_path;
-  if (!GetCacheSoFilePath(so_path))
-    return nullptr;
+// The functions compiled by JIT are also cached as LLVM IR, a file per function, that later sessions
+// compile to machine code without building and lowering their subgraphs again.
+// Function names only depend on the order of the subgraphs in the model, so when a model checksum is set,
+// the cache directory records it and the functions are only loaded for the same checksum.
+static bool GetJITCacheFilePath(const std::string& func_name, fs::path& file_path, bool create) {
+  fs::path path;
+  if (!GetOrCreateTVMModuleCacheDirectory(path, create))
+    return false;
+
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(kNupharCacheModelChecksum)) {
+    std::string model_checksum = settings.GetOptionValue(kNupharCacheModelChecksum);
+    fs::path checksum_path = path;
+    checksum_path.append(kNupharCacheJITChecksumFileName);
+    std::ifstream checksum_file(checksum_path.string());
+    if (checksum_file) {
+      std::string cached_checksum((std::istreambuf_iterator<char>(checksum_file)), std::istreambuf_iterator<char>());
+      if (cached_checksum != model_checksum) {
+        LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "JIT cache checksum validation failed, skip JIT cache...";
+        return false;
+      }
+    } else if (create) {
+      std::ofstream(checksum_path.string()) << model_checksum;
+    } else {
+      // the cached functions, if any, were saved for an unknown model
+      return false;
+    }
+  }
+
+  file_path = path;
+  file_path.append(func_name + ".ll");
+  return true;
+}
 
-  if (!VerifyTVMModuleChecksum(so_path))
+static tvm::runtime::PackedFunc LoadTVMPackedFuncFromJITCache(const std::string& func_name) {
+  fs::path path;
+  if (!GetJITCacheFilePath(func_name, path, /*create*/ false) || !fs::is_regular_file(path))
     return nullptr;
 
-  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(so_path);
-  tvm::runtime::PackedFunc func = module.GetFunction(func_name);
-  if (func == nullptr) {
+  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(path.string(), "ll");
+  return module.GetFunction(func_name);
+}
+
+tvm::runtime::PackedFunc LoadTVMPackedFuncFromCache(const std::string& func_name) {
+  std::string so_path;
+  if (GetCacheSoFilePath(so_path) && VerifyTVMModuleChecksum(so_path)) {
+    tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(so_path);
+    tvm::runtime::PackedFunc func = module.GetFunction(func_name);
+    if (func != nullptr) {
+      return func;
+    }
     LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cannot find " << func_name << " in cache, using JIT...";
   }
-  return func;
-}
 
-thread_local int saved_tvm_model_cnt = 0;
+  return LoadTVMPackedFuncFromJITCache(func_name);
+}
 
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module) {
-  fs::path path;
-
-  if (disable_caching_due_to_checksum_failure)
-    return;
-
+  // subgraphs are compiled concurrently, so the file names are counted under the lock
   static std::mutex save_cache_mutex;
   static std::unordered_set<std::string> existing_files;
+  static int saved_tvm_model_cnt = 0;
   std::lock_guard<std::mutex> lock(save_cache_mutex);
-  if (existing_files.count(filename) == 0 &&
+  if (existing_files.count(filename) > 0)
+    return;
+  existing_files.insert(filename);
+
+  fs::path path;
+  if (!disable_caching_due_to_checksum_failure &&
       GetOrCreateTVMModuleCacheDirectory(path, /*create*/ true)) {
-    existing_files.insert(filename);
     path.append("cached_" + std::to_string(saved_tvm_model_cnt++) + ".o");
     if (fs::exists(path)) {
       LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Object file " << path << " already exists, skip saving...";
-      return;
+    } else {
+      module->SaveToFile(path.string(), "o");
     }
-    module->SaveToFile(path.string(), "o");
+  }
+
+  if (std::string(module->type_key()) == "llvm" &&
+      GetJITCacheFilePath(filename, path, /*create*/ true) &&
+      !fs::exists(path)) {
+    // save to a temporary file first, so that other processes sharing the cache never load a partial function
+    fs::path temp_path = path;
+    temp_path += ".tmp";
+    module->SaveToFile(temp_path.string(), "ll");
+    fs::rename(temp_path, path);
   }
 }
 
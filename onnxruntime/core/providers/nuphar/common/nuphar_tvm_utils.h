@@ -16,6 +16,7 @@ struct NupharSubgraphUnit;  //forward
 // Helper functions to create or load from offline cached dll
 // note after saving to obj file, we need to use tvm Python to create dll
 // using script at onnxruntime/core/codegen/mti/scripts/create_shared.py
+// Functions not in the dll are loaded from, or saved to, the JIT cache of LLVM IR in the same directory
 tvm::runtime::PackedFunc
 LoadTVMPackedFuncFromCache(const std::string& func_name);
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module);
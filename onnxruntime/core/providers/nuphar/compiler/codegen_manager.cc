@@ -6,6 +6,7 @@
 #include "core/codegen/common/op_macro.h"
 #include "core/codegen/passes/op_ir_creator/all_ops.h"
 #include "core/codegen/passes/scheduler/all_schedules.h"
+#include "core/codegen/passes/weight_layout/packed_panels_2d.h"
 #include "core/codegen/passes/weight_layout/transpose_2d.h"
 #include "core/codegen/passes/weight_layout/vertical_stripes_2d.h"
 #include "core/providers/nuphar/compiler/x86/op_ir_creator/all_ops.h"
@@ -106,6 +107,20 @@ static void RegisterAllNupharWeightLayouts(tvm_codegen::WeightLayoutRegistry* la
       std::move(std::make_unique<tvm_codegen::WeightLayoutTranspose2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_UINT8)));
   layout_registry->Register(
       std::move(std::make_unique<tvm_codegen::WeightLayoutTranspose2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT16)));
+
+  // packed panels of 2x the natural vector width of AVX2 (16 32-bit lanes) and AVX512 (32 32-bit lanes),
+  // the tile widths of the MatMul microkernels, see MatMul_weights2D
+  for (int panel_width : {16, 32}) {
+    layout_registry->Register(
+        std::move(std::make_unique<tvm_codegen::WeightLayoutPackedPanels2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT, panel_width, 1)));
+    // 4 8-bit or 2 16-bit values of a column are interleaved in each 32-bit lane, as reduced by VNNI/vpmaddwd
+    layout_registry->Register(
+        std::move(std::make_unique<tvm_codegen::WeightLayoutPackedPanels2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT8, panel_width, 4)));
+    layout_registry->Register(
+        std::move(std::make_unique<tvm_codegen::WeightLayoutPackedPanels2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_UINT8, panel_width, 4)));
+    layout_registry->Register(
+        std::move(std::make_unique<tvm_codegen::WeightLayoutPackedPanels2D>(ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT16, panel_width, 2)));
+  }
 }
 
 // END: Nuphar Weight Layouts classes
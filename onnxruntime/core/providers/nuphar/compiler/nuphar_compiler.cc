@@ -3,6 +3,7 @@
 
 #include "core/providers/nuphar/compiler/nuphar_compiler.h"
 
+#include "core/codegen/common/common.h"
 #include "core/codegen/common/profile.h"
 #include "core/codegen/common/settings.h"
 #include "core/codegen/mti/mti_tvm_utils.h"
@@ -202,25 +203,51 @@ static tvm::BuildConfig CreateConfig(const Node& node,
   return config;
 }
 
+void NupharCompiler::Specialize(const std::unordered_map<std::string, int64_t>& dims) {
+  context_.SetSpecializedDims(dims);
+
+  // ordered by symbol, so that the same dims give the same name
+  std::map<std::string, int64_t> ordered_dims(dims.begin(), dims.end());
+  func_name_suffix_.clear();
+  for (const auto& dim : ordered_dims) {
+    func_name_suffix_ += "_" + dim.first + "_" + std::to_string(dim.second);
+  }
+}
+
+std::string NupharCompiler::GetFuncName(const nuphar::NupharSubgraphUnit& subgraph) const {
+  const auto& target_codegen = *context_.GetCodeGenHandle()->codegen_target;
+  if (func_name_suffix_.empty()) {
+    return nuphar::GetPackedFuncName(subgraph, target_codegen);
+  }
+  return NormalizeCppName(nuphar::GetPackedFuncName(subgraph, target_codegen) + func_name_suffix_);
+}
+
 // Lower compiles the tvm::Tensor to a function
 Status NupharCompiler::Lower(const nuphar::NupharSubgraphUnit& subgraph,
                              tvm::Target tvm_target,
                              tvm::Target tvm_host_target,
-                             NupharFuncInfo* func_info,
-                             nuphar::OrtSubgraphAllocationInfo* partition_info) {
-  const auto& target_codegen = *context_.GetCodeGenHandle()->codegen_target;
-  std::string func_name = nuphar::GetPackedFuncName(subgraph, target_codegen);
+                             tvm::runtime::PackedFunc& func) {
+  std::string func_name = GetFuncName(subgraph);
   tvm::BuildConfig config = CreateConfig(*subgraph.nodes.front(),
                                          context_.GetCodeGenHandle()->allow_unaligned_buffers);
 
   // using "subgraph" for type and name for now
   // TODO: change name
-  tvm::runtime::PackedFunc cached_func =
-      GetLoweredPackedFunc(
-          func_name, tvm_target, tvm_host_target,
-          config, "subgraph", "subgraph");
+  func = GetLoweredPackedFunc(
+      func_name, tvm_target, tvm_host_target,
+      config, "subgraph", "subgraph");
+
+  return Status::OK();
+}
+
+Status NupharCompiler::FillFuncInfo(const nuphar::NupharSubgraphUnit& subgraph,
+                                    tvm::Target tvm_target,
+                                    const tvm::runtime::PackedFunc& func,
+                                    NupharFuncInfo* func_info,
+                                    nuphar::OrtSubgraphAllocationInfo* partition_info) {
+  std::string func_name = GetFuncName(subgraph);
 
-  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, cached_func, func_name);
+  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, func, func_name);
 
   return Status::OK();
 }
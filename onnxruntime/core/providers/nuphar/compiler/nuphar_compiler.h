@@ -31,15 +31,25 @@ class NupharCompiler {
                  std::unordered_map<std::string, std::unique_ptr<Tensor>>& generated_initializers,
                  const NupharCodeGenHandle* handle);
 
+  // Specialize builds the subgraph for the given values of its symbolic dims, must be called before Build
+  void Specialize(const std::unordered_map<std::string, int64_t>& dims);
+
   // Build builds tvm IR and apply passes
   Status Build(const nuphar::NupharSubgraphUnit& subgraph);
 
-  // Lower lowers the built tvm IR to llvm ir and compiles it
+  // Lower lowers the built tvm IR to llvm ir and compiles it to func
+  // It only touches the state of this compiler, so the compilers of different subgraphs may lower concurrently
   Status Lower(const nuphar::NupharSubgraphUnit& subgraph,
                tvm::Target tvm_target,
                tvm::Target tvm_host_target,
-               NupharFuncInfo* ctx_func,
-               nuphar::OrtSubgraphAllocationInfo* partition_info);
+               tvm::runtime::PackedFunc& func);
+
+  // FillFuncInfo fills the NupharFuncInfo of the func compiled by Lower
+  Status FillFuncInfo(const nuphar::NupharSubgraphUnit& subgraph,
+                      tvm::Target tvm_target,
+                      const tvm::runtime::PackedFunc& func,
+                      NupharFuncInfo* ctx_func,
+                      nuphar::OrtSubgraphAllocationInfo* partition_info);
 
   tvm::runtime::PackedFunc GetLoweredPackedFunc(
       const std::string& func_name,
@@ -52,6 +62,11 @@ class NupharCompiler {
  private:
   size_t num_initializers_in_graph_inputs_;
 
+  // appended to the name of a specialized function
+  std::string func_name_suffix_;
+
+  std::string GetFuncName(const nuphar::NupharSubgraphUnit& subgraph) const;
+
   // BuildSubgraph builds tvm IR and apply passes for a subgraph
   Status BuildSubgraph(const Node& node);
 
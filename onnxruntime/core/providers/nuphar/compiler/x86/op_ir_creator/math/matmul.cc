@@ -6,8 +6,8 @@
 #include "core/providers/nuphar/compiler/nuphar_codegen_ctx.h"
 #include "core/providers/nuphar/mti_x86/math/matmul_ops.h"
 #include "core/codegen/mti/mti_tvm_utils.h"
+#include "core/codegen/passes/weight_layout/packed_panels_2d.h"
 #include "core/codegen/passes/weight_layout/transpose_2d.h"
-#include "core/codegen/passes/weight_layout/vertical_stripes_2d.h"
 #include "core/providers/nuphar/compiler/x86/x86_target_info.h"
 
 #include <tvm/ir_pass.h>
@@ -31,17 +31,23 @@ static bool MatMul_weights2D(
 
   // optimizations for B being 2D weights
 
-  // The 2D weight is marshalled with stripe_width.
-  // This should be 2x nature vector width
-  int stripe_width = 8;
+  // The 2D weight is marshalled into panels of panel_width columns,
+  // with interleave rows of a column in each 32-bit lane for 8-bit and 16-bit weights.
+  // The panel width should be 2x nature vector width of 32-bit lanes
+  int interleave = B->dtype.bits() < 32 ? 32 / B->dtype.bits() : 1;
+  int panel_width = 16;
   int block_size = 32;
 
   onnxruntime::CodeGenTargetX86* target =
       dynamic_cast<onnxruntime::CodeGenTargetX86*>(ctx_codegen.GetCodeGenHandle()->codegen_target);
   if (nullptr != target) {
-    stripe_width = 2 * target->NaturalVectorWidth(B->dtype.bits());
+    panel_width = 2 * target->NaturalVectorWidth(32);
   }
 
+  auto layout_key = tvm_codegen::WeightLayoutPackedPanels2D::GetKey(proto_type, panel_width, interleave);
+  if (!ctx_nuphar->GetCodeGenHandle()->layout_registry->Contains(layout_key))
+    return false;
+
   // align A, B to multiple of block size
   const auto& A_shape = A->shape;
   tvm::Expr A0_size = tvm_codegen::SizeToDimension(A_shape, -1);
@@ -64,7 +70,6 @@ static bool MatMul_weights2D(
   if (A0_need_pad || A1_need_pad || B1_need_pad)
     return false;
 
-  auto layout_key = tvm_codegen::WeightLayoutVerticalStripe2D::GetKey(proto_type, stripe_width);
   auto B_unmarshalled = ctx_nuphar->ApplyWeightLayout(layout_key, initializer_name, B, false);
 
   ORT_ENFORCE(B_unmarshalled->op.as<tvm::ComputeOpNode>());
@@ -4,14 +4,20 @@
 #include "core/providers/nuphar/kernel.h"
 
 #include "core/codegen/passes/utils/codegen_context.h"
+#include "core/common/logging/logging.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/nuphar/common/analysis/subgraph_codegen_stats.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/nuphar_execution_provider.h"
 #include "core/providers/nuphar/partition/subgraph_partitioner.h"
 #include "core/providers/nuphar/runtime/sequential/basic.h"
 #include "core/providers/nuphar/runtime/sequential/loop.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace onnxruntime {
 namespace nuphar {
 
@@ -25,54 +31,118 @@ NupharKernelState::NupharKernelState(
       ctx_(ctx) {
   partition_info_ = std::make_unique<OrtSubgraphAllocationInfo>(node);
 
-  std::vector<NupharSubgraphUnit> subgraphs;
-
   // create a partitioner
   SubgraphPartitioner subgraph_partitioner;
   subgraph_partitioner.Partition(
       node,
-      subgraphs,
+      subgraphs_,
       [&](const std::string& name) { return provider_.GetConstantInitializer(name); });
 
-  for (auto& subgraph : subgraphs) {
-    Compile(subgraph);
-    if (!codegen_status_.IsOK()) {
-      return;  // early return
-    }
+  Compile(subgraphs_);
+  if (!codegen_status_.IsOK()) {
+    return;  // early return
   }
 
   // Currently BuildExecBlocksAndCalls is inserted here
   // TODO: after AOT support, we should move it to a proper location
-  BuildExecBlocksAndCalls(subgraphs);
+  BuildExecBlocksAndCalls(subgraphs_);
+}
+
+static int GetIntOption(const std::string& key, int default_value) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(key)) {
+    return std::stoi(settings.GetOptionValue(key));
+  }
+  return default_value;
+}
+
+static int GetCodeGenThreads(size_t num_subgraphs) {
+  int num_threads = GetIntOption(kNupharCodeGenThreads, static_cast<int>(std::thread::hardware_concurrency()));
+  return std::max(1, std::min(num_threads, static_cast<int>(num_subgraphs)));
 }
 
-void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
+void NupharKernelState::Compile(const std::vector<NupharSubgraphUnit>& subgraphs) {
   // TODO: rename tvm_target to a proper name
   auto tvm_target = provider_.GetTVMTarget();
+  auto tvm_host_target = provider_.GetTVMHostTarget();
+
+  // Building tvm IR shares the generated initializers and the codegen handle, so the subgraphs are built in order
+  std::vector<std::unique_ptr<NupharCompiler>> tvm_compilers;
+  for (const auto& subgraph : subgraphs) {
+    tvm_compilers.push_back(std::make_unique<NupharCompiler>(subgraph,
+                                                             generated_initailizers_,
+                                                             provider_.GetNupharCodeGenHandle()));
+    codegen_status_ = tvm_compilers.back()->Build(subgraph);
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
+  }
 
-  NupharCompiler tvm_compiler(subgraph,
-                              generated_initailizers_,
-                              provider_.GetNupharCodeGenHandle());
-
-  codegen_status_ = tvm_compiler.Build(subgraph);
+  // Lowering and llvm codegen, most of the compile time, only touch the state of each compiler
+  std::vector<tvm::runtime::PackedFunc> funcs(subgraphs.size());
+  std::vector<Status> statuses(subgraphs.size());
+  auto lower = [&](int32_t idx) {
+    try {
+      statuses[idx] = tvm_compilers[idx]->Lower(subgraphs[idx], tvm_target, tvm_host_target, funcs[idx]);
+    } catch (const std::exception& ex) {
+      statuses[idx] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+
+  const int num_threads = GetCodeGenThreads(subgraphs.size());
+  if (num_threads > 1) {
+    // the calling thread lowers subgraphs too
+    concurrency::ThreadPool codegen_thread_pool("NUPHAR_CODEGEN", num_threads - 1);
+    codegen_thread_pool.ParallelFor(static_cast<int32_t>(subgraphs.size()), lower);
+  } else {
+    for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+      lower(static_cast<int32_t>(idx));
+    }
+  }
 
-  if (codegen_status_.IsOK()) {
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    codegen_status_ = statuses[idx];
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
     func_infos_.emplace_back(std::make_unique<NupharFuncInfo>());
-    codegen_status_ = tvm_compiler.Lower(subgraph,
-                                         tvm_target,
-                                         provider_.GetTVMHostTarget(),
-                                         func_infos_.back().get(),
-                                         partition_info_.get());
+    codegen_status_ = tvm_compilers[idx]->FillFuncInfo(subgraphs[idx],
+                                                      tvm_target,
+                                                      funcs[idx],
+                                                      func_infos_.back().get(),
+                                                      partition_info_.get());
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
   }
 }
 
 void NupharKernelState::BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs) {
+  const int specialize_hot_count = GetIntOption(kNupharSpecializeHotCount, kNupharSpecializeHotCount_Default);
+  const int specialize_max_funcs = GetIntOption(kNupharSpecializeMaxFuncs, kNupharSpecializeMaxFuncs_Default);
+
   // create ExecBlocks
   for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    // subgraphs with symbolic dims are specialized to their hot values, except Scan, whose ExecBlock runs a loop
+    SpecializedFuncs* specialized_funcs = nullptr;
+    if (specialize_hot_count > 0 && specialize_max_funcs > 0 &&
+        !(subgraphs[idx].IsSingleNode() && subgraphs[idx].nodes.front()->OpType() == "Scan") &&
+        !SpecializedFuncs::GetSymbols(func_infos_[idx].get()).empty()) {
+      specialized_funcs_.push_back(std::make_unique<SpecializedFuncs>(
+          func_infos_[idx].get(),
+          [this, idx](const std::unordered_map<std::string, int64_t>& dims) {
+            return CompileSpecialized(idx, dims);
+          },
+          specialize_hot_count,
+          specialize_max_funcs));
+      specialized_funcs = specialized_funcs_.back().get();
+    }
+
     CreateExecBlock(exec_blocks_,
                     func_infos_[idx].get(),
                     subgraphs[idx],
-                    provider_.GetNupharRuntimeHandle()->enable_model_parallelism);
+                    provider_.GetNupharRuntimeHandle()->enable_model_parallelism,
+                    specialized_funcs);
   }
 
   // create calls
@@ -81,6 +151,47 @@ void NupharKernelState::BuildExecBlocksAndCalls(const std::vector<NupharSubgraph
   }
 }
 
+tvm::runtime::PackedFunc NupharKernelState::CompileSpecialized(
+    size_t subgraph_idx,
+    const std::unordered_map<std::string, int64_t>& dims) const {
+  const NupharSubgraphUnit& subgraph = subgraphs_[subgraph_idx];
+  const NupharFuncInfo& func_info = *func_infos_[subgraph_idx];
+
+  // the specialized function is called with the initializers of the generic one,
+  // its own marshalled initializers are only needed to build it
+  std::unordered_map<std::string, std::unique_ptr<Tensor>> generated_initializers;
+  NupharCompiler tvm_compiler(subgraph,
+                              generated_initializers,
+                              provider_.GetNupharCodeGenHandle());
+  tvm_compiler.Specialize(dims);
+
+  auto tvm_target = provider_.GetTVMTarget();
+  tvm::runtime::PackedFunc func;
+  ORT_THROW_IF_ERROR(tvm_compiler.Build(subgraph));
+  ORT_THROW_IF_ERROR(tvm_compiler.Lower(subgraph, tvm_target, provider_.GetTVMHostTarget(), func));
+
+  // check the arguments of the specialized function match the generic one,
+  // on a copy of the allocation info, which the running kernel reads
+  NupharFuncInfo specialized_info;
+  OrtSubgraphAllocationInfo partition_info = *partition_info_;
+  ORT_THROW_IF_ERROR(tvm_compiler.FillFuncInfo(subgraph, tvm_target, func, &specialized_info, &partition_info));
+
+  bool same_args = specialized_info.func_input_count == func_info.func_input_count &&
+                   specialized_info.func_output_count == func_info.func_output_count &&
+                   specialized_info.type_codes == func_info.type_codes &&
+                   specialized_info.intializers.size() == func_info.intializers.size();
+  for (size_t i = 0; same_args && i < func_info.intializers.size(); ++i) {
+    same_args = specialized_info.intializers[i]->Shape() == func_info.intializers[i]->Shape() &&
+                specialized_info.intializers[i]->DataType() == func_info.intializers[i]->DataType();
+  }
+  if (!same_args) {
+    LOGS_DEFAULT(WARNING) << "The specialized " << specialized_info.name << " takes different arguments than "
+                          << func_info.name << ", keeping the generic function";
+    return nullptr;
+  }
+  return func;
+}
+
 NupharKernelState::~NupharKernelState() {
   if (nullptr != nuphar_compute_ctx_map_)
     nuphar_compute_ctx_map_->erase(this);
@@ -11,6 +11,7 @@
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/runtime/compute_ctx.h"
 #include "core/providers/nuphar/runtime/exec_block.h"
+#include "core/providers/nuphar/runtime/specialized_funcs.h"
 
 #include <tvm/build_module.h>
 
@@ -38,10 +39,16 @@ class NupharKernelState {
 
   Status Compute(OpKernelContext* op_kernel_context) const;
 
-  void Compile(const NupharSubgraphUnit& subgraph);
+  // Compile builds the subgraphs in order and lowers them concurrently, see kNupharCodeGenThreads
+  void Compile(const std::vector<NupharSubgraphUnit>& subgraphs);
 
   void BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs);
 
+  // CompileSpecialized compiles the function of the subgraph for the given values of its symbolic dims,
+  // with the same arguments as the generic function, or returns nullptr when it can't
+  tvm::runtime::PackedFunc CompileSpecialized(size_t subgraph_idx,
+                                              const std::unordered_map<std::string, int64_t>& dims) const;
+
  private:
   const NupharExecutionProvider& provider_;
 
@@ -57,6 +64,13 @@ class NupharKernelState {
   // Hold NupharFuncInfo from codegen.
   std::vector<std::unique_ptr<NupharFuncInfo>> func_infos_;
 
+  // the subgraphs of func_infos_, kept to specialize them
+  std::vector<NupharSubgraphUnit> subgraphs_;
+
+  // the functions specialized at runtime, declared after what they are compiled from
+  // so that a compilation in progress completes before it is destroyed
+  std::vector<std::unique_ptr<SpecializedFuncs>> specialized_funcs_;
+
   // ExecBlocks of runtime
   // Ownership of ExecBlock
   std::vector<std::unique_ptr<ExecBlock>> exec_blocks_;
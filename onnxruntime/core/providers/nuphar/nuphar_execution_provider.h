@@ -69,7 +69,7 @@ class NupharExecutionProvider : public IExecutionProvider {
     return nullptr;
   }
 
-  Status OnRunStart() override {
+  Status OnRunStart(const RunOptions& /*run_options*/) override {
     if (tls_realized_dims_ != nullptr) {
       // at frame start, reset realized_dims since new execution frame may have different dynamic value
       for (auto& pair : *(tls_realized_dims_.get())) {
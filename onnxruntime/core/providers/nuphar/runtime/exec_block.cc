@@ -15,13 +15,14 @@ namespace nuphar {
 void CreateExecBlock(std::vector<std::unique_ptr<ExecBlock>>& exec_blocks,
                      const NupharFuncInfo* func_info,
                      const nuphar::NupharSubgraphUnit& subgraph,
-                     bool /*enable_tiling*/) {
+                     bool /*enable_tiling*/,
+                     SpecializedFuncs* specialized_funcs) {
   if (subgraph.IsSingleNode() && subgraph.nodes.front()->OpType() == "Scan") {
     exec_blocks.push_back(
         std::move(std::make_unique<LoopExecBlock>(func_info, "nuphar_exec_" + subgraph.Name())));
   } else {
     exec_blocks.push_back(
-        std::move(std::make_unique<BasicExecBlock>(func_info, "nuphar_exec_" + subgraph.Name())));
+        std::move(std::make_unique<BasicExecBlock>(func_info, "nuphar_exec_" + subgraph.Name(), specialized_funcs)));
   }
 }
 
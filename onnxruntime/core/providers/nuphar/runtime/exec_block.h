@@ -12,6 +12,8 @@
 namespace onnxruntime {
 namespace nuphar {
 
+class SpecializedFuncs;
+
 // base class for Execution
 class ExecBlock {
  public:
@@ -48,7 +50,8 @@ void CreateExecBlock(
     std::vector<std::unique_ptr<ExecBlock>>& exec_blocks,
     const NupharFuncInfo* info,
     const NupharSubgraphUnit& subgraph,
-    bool enable_tiling = false);
+    bool enable_tiling = false,
+    SpecializedFuncs* specialized_funcs = nullptr);
 
 }  // namespace nuphar
 }  // namespace onnxruntime
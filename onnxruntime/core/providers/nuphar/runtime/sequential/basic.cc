@@ -34,7 +34,9 @@ void BasicExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
                         tvm_num_args);
 
   tvm::TVMRetValue rvalue;
-  const tvm::runtime::PackedFunc& func = func_info_->packed_func;
+  const tvm::runtime::PackedFunc& func =
+      specialized_funcs_ != nullptr ? specialized_funcs_->Select(kernel_compute_ctx->GetRealizedDims())
+                                    : func_info_->packed_func;
 
   func.CallPacked(tvm_args, &rvalue);
 
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/providers/nuphar/runtime/compute_ctx.h"
 #include "core/providers/nuphar/runtime/exec_block.h"
+#include "core/providers/nuphar/runtime/specialized_funcs.h"
 #include "core/common/common.h"
 
 namespace onnxruntime {
@@ -14,8 +15,9 @@ namespace nuphar {
 class BasicExecBlock : public ExecBlock {
  public:
   BasicExecBlock(const NupharFuncInfo* info,
-                 const std::string& name)
-      : ExecBlock(info, name, "BasicExecBlock") {}
+                 const std::string& name,
+                 SpecializedFuncs* specialized_funcs = nullptr)
+      : ExecBlock(info, name, "BasicExecBlock"), specialized_funcs_(specialized_funcs) {}
 
   BasicExecBlock(const NupharFuncInfo* info,
                  const std::string& name,
@@ -27,6 +29,9 @@ class BasicExecBlock : public ExecBlock {
   void UpdateContext(KernelComputeCtx* compute_ctx) const override;
 
  private:
+  // selects the function specialized for the realized dims, if any, instead of the generic one
+  SpecializedFuncs* specialized_funcs_ = nullptr;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BasicExecBlock);
 };
 
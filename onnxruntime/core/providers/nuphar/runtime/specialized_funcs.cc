@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/runtime/specialized_funcs.h"
+
+#include "core/codegen/common/common.h"
+#include "core/common/logging/logging.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace nuphar {
+
+// the number of distinct realized values counted, so that ever changing dims don't grow the table
+constexpr static size_t kMaxCountedEntries = 256;
+
+std::vector<std::string> SpecializedFuncs::GetSymbols(const NupharFuncInfo* func_info) {
+  std::vector<std::string> symbols;
+  for (const auto& input_meta : func_info->input_metas) {
+    for (const auto& dim_symbol : input_meta.dim_symbols) {
+      symbols.push_back(dim_symbol.second);
+    }
+  }
+  std::sort(symbols.begin(), symbols.end());
+  symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+  return symbols;
+}
+
+SpecializedFuncs::SpecializedFuncs(const NupharFuncInfo* func_info,
+                                   CompileFunc compile_func,
+                                   int hot_count,
+                                   int max_funcs)
+    : func_info_(func_info),
+      compile_func_(compile_func),
+      hot_count_(hot_count),
+      max_funcs_(max_funcs),
+      symbols_(GetSymbols(func_info)) {}
+
+SpecializedFuncs::~SpecializedFuncs() {
+  if (compilation_.valid()) {
+    compilation_.wait();
+  }
+}
+
+const tvm::runtime::PackedFunc& SpecializedFuncs::Select(const std::unordered_map<std::string, int64_t>& realized_dims) {
+  std::vector<int64_t> key;
+  key.reserve(symbols_.size());
+  for (const auto& symbol : symbols_) {
+    auto iter = realized_dims.find(symbol);
+    if (iter == realized_dims.end()) {
+      return func_info_->packed_func;
+    }
+    key.push_back(iter->second);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    if (entries_.size() >= kMaxCountedEntries) {
+      return func_info_->packed_func;
+    }
+    iter = entries_.emplace(key, Entry()).first;
+  }
+
+  Entry& entry = iter->second;
+  // the func of an entry is only set once, so it can be called after the lock is released
+  if (entry.func != nullptr) {
+    return entry.func;
+  }
+
+  if (!entry.compiled && ++entry.count >= hot_count_ && num_compiled_ < max_funcs_ && !compiling_) {
+    std::unordered_map<std::string, int64_t> dims;
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+      dims.emplace(symbols_[i], key[i]);
+    }
+
+    entry.compiled = true;
+    ++num_compiled_;
+    compiling_ = true;
+    Entry* p_entry = &entry;
+    compilation_ = std::async(std::launch::async, [this, p_entry, dims]() {
+      tvm::runtime::PackedFunc func;
+      try {
+        func = compile_func_(dims);
+      } catch (const std::exception& ex) {
+        LOGS_DEFAULT(WARNING) << "Failed to specialize " << func_info_->name << ": " << ex.what();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      p_entry->func = func;
+      compiling_ = false;
+    });
+  }
+
+  return func_info_->packed_func;
+}
+
+}  // namespace nuphar
+}  // namespace onnxruntime
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/nuphar/compiler/func_info.h"
+
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace onnxruntime {
+namespace nuphar {
+
+// SpecializedFuncs holds the functions of a subgraph specialized for the realized values of its symbolic dims.
+// It counts the calls of the generic function per realized values, and once some values get hot,
+// compiles a function specialized for them in the background. Calls use the specialized function once it is ready,
+// and the generic function otherwise.
+// A specialized function takes the same arguments as the generic function of func_info.
+class SpecializedFuncs {
+ public:
+  // compiles the function specialized for the dims, or returns nullptr when it can't
+  using CompileFunc = std::function<tvm::runtime::PackedFunc(const std::unordered_map<std::string, int64_t>&)>;
+
+  SpecializedFuncs(const NupharFuncInfo* func_info,
+                   CompileFunc compile_func,
+                   int hot_count,
+                   int max_funcs);
+
+  // waits for the function in compilation
+  ~SpecializedFuncs();
+
+  // returns the function to call for the realized dims
+  const tvm::runtime::PackedFunc& Select(const std::unordered_map<std::string, int64_t>& realized_dims);
+
+  // returns the symbols a subgraph is specialized on, the symbolic dims of its inputs
+  static std::vector<std::string> GetSymbols(const NupharFuncInfo* func_info);
+
+ private:
+  struct Entry {
+    int count = 0;
+    bool compiled = false;
+    // empty until compiled, or when the compilation failed
+    tvm::runtime::PackedFunc func;
+  };
+
+  const NupharFuncInfo* func_info_;
+  CompileFunc compile_func_;
+  const int hot_count_;
+  const int max_funcs_;
+  const std::vector<std::string> symbols_;
+
+  std::mutex mutex_;
+  std::map<std::vector<int64_t>, Entry> entries_;
+  int num_compiled_ = 0;
+  // at most a function is compiled at a time
+  bool compiling_ = false;
+  std::future<void> compilation_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SpecializedFuncs);
+};
+
+}  // namespace nuphar
+}  // namespace onnxruntime
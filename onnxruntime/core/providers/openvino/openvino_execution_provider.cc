@@ -26,8 +26,7 @@ namespace onnxruntime {
 constexpr const char* OpenVINO = "OpenVINO";
 
 OpenVINOExecutionProvider::OpenVINOExecutionProvider(OpenVINOExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kOpenVINOExecutionProvider} {
-  ORT_UNUSED_PARAMETER(info);
+    : IExecutionProvider{onnxruntime::kOpenVINOExecutionProvider}, info_(info) {
 
   DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault, [](int) { return std::make_unique<CPUAllocator>(std::make_unique<OrtMemoryInfo>(OPENVINO, OrtDeviceAllocator)); }, std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(device_info));
@@ -554,7 +553,7 @@ common::Status OpenVINOExecutionProvider::Compile(
   for (auto fused_node : fused_nodes) {
     std::shared_ptr<openvino_ep::OpenVINOGraph> openvino_graph;
     try {
-      openvino_graph = std::make_shared<openvino_ep::OpenVINOGraph>(fused_node);
+      openvino_graph = std::make_shared<openvino_ep::OpenVINOGraph>(fused_node, info_.num_streams);
 
     } catch (const char* msg) {
       LOGS_DEFAULT(ERROR) << openvino_ep::OpenVINOGraph::log_tag << "Compilation error: " << msg;
@@ -17,9 +17,14 @@ constexpr const char* OPENVINO = "OpenVINO";
 // Information needed to construct OpenVINO execution providers.
 struct OpenVINOExecutionProviderInfo {
   const char* device{"CPU_FP32"};
+  // the number of infer requests per subgraph, which concurrent Runs share, and on CPU the number of
+  // throughput streams. 0 keeps the latency mode of the device, a single request except 8 on VAD-M.
+  int num_streams{0};
 
   explicit OpenVINOExecutionProviderInfo(const char* dev) : device(dev) {
   }
+  OpenVINOExecutionProviderInfo(const char* dev, int streams) : device(dev), num_streams(streams) {
+  }
   OpenVINOExecutionProviderInfo() {
   }
 };
@@ -6,6 +6,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <Python.h>
@@ -25,7 +26,7 @@ namespace openvino_ep {
 
 const std::string OpenVINOGraph::log_tag = "[OpenVINO-EP] ";
 
-OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
+OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node, int num_streams) {
   device_id_ = "CPU";
   precision_ = InferenceEngine::Precision::FP32;
   std::string precision_str = "FP32";
@@ -70,6 +71,12 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   // sets number of maximum parallel inferences
   num_inf_reqs_ = (device_id_ == "HDDL") ? 8 : 1;
 
+  // In throughput mode, there is an Infer Request per stream, and concurrent Infer calls
+  // run on different Infer Requests. On CPU, each stream runs on its own subset of the cores.
+  if (num_streams > 0) {
+    num_inf_reqs_ = static_cast<size_t>(num_streams);
+  }
+
   fused_node_ = fused_node;
 
   // Save the indexes of graph inputs among fused_node's inputDefs
@@ -106,7 +113,11 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
                 .getPluginByDevice(device_id_);
 
   //Loading model to the plugin
-  InferenceEngine::ExecutableNetwork exeNetwork = plugin_.LoadNetwork(*openvino_network_, {});
+  std::map<std::string, std::string> config;
+  if (num_streams > 0 && device_id_ == "CPU") {
+    config[InferenceEngine::PluginConfigParams::KEY_CPU_THROUGHPUT_STREAMS] = std::to_string(num_streams);
+  }
+  InferenceEngine::ExecutableNetwork exeNetwork = plugin_.LoadNetwork(*openvino_network_, config);
 
   LOGS_DEFAULT(INFO) << log_tag << "Network loaded into accelerator plug-in succesfully";
 
@@ -115,6 +126,7 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
     auto infRequest = exeNetwork.CreateInferRequestPtr();
 
     infer_requests_.push_back(infRequest);
+    free_infer_requests_.push_back(i);
   }
   LOGS_DEFAULT(INFO) << log_tag << "Infer requests created: " << num_inf_reqs_;
 }
@@ -388,12 +400,13 @@ void OpenVINOGraph::GetInputTensors(Ort::CustomOpApi ort, OrtKernelContext* cont
   }
 }
 
-void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size) {
+void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[],
+                                     size_t batch_size, size_t infer_req_idx) {
   auto graph_output_info = openvino_network_->getOutputsInfo();
 
   // All infer_requests process identical tensor slices from the batch.
-  // So using info from first infer_request to allocate all output tensors.
-  auto infer_request = infer_requests_[0];
+  // So using info from an infer_request of this Infer to allocate all output tensors.
+  auto infer_request = infer_requests_[infer_req_idx];
 
   size_t i = 0;
   for (auto output_info_iter = graph_output_info.begin();
@@ -416,11 +429,25 @@ void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* con
   }
 }
 
-void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
-  std::lock_guard<std::mutex> lock(compute_lock_);
+std::vector<size_t> OpenVINOGraph::AcquireInferRequests(size_t max_count) {
+  std::unique_lock<std::mutex> lock(infer_requests_lock_);
+  infer_request_freed_.wait(lock, [this] { return !free_infer_requests_.empty(); });
+
+  size_t count = std::min(std::max<size_t>(max_count, 1), free_infer_requests_.size());
+  std::vector<size_t> infer_req_indexes(free_infer_requests_.end() - count, free_infer_requests_.end());
+  free_infer_requests_.resize(free_infer_requests_.size() - count);
+  return infer_req_indexes;
+}
+
+void OpenVINOGraph::ReleaseInferRequests(const std::vector<size_t>& infer_req_indexes) {
+  {
+    std::lock_guard<std::mutex> lock(infer_requests_lock_);
+    free_infer_requests_.insert(free_infer_requests_.end(), infer_req_indexes.begin(), infer_req_indexes.end());
+  }
+  infer_request_freed_.notify_all();
+}
 
+void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   LOGS_DEFAULT(INFO) << log_tag << "Starting inference";
 
   // Get Input and Output tensors
@@ -435,34 +462,43 @@ void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   auto batch_size = DeduceBatchSize(ort, input_tensors[0],
                                     openvino_network_->getInputsInfo().begin()->second->getTensorDesc().getDims());
 
-  size_t full_parallel_runs = batch_size / num_inf_reqs_;
-  size_t remainder_parallel_runs = batch_size % num_inf_reqs_;
+  // Concurrent Infer calls share the Infer Requests, each takes the free ones it can use
+  std::vector<size_t> infer_reqs = AcquireInferRequests(batch_size);
+  struct InferRequestsReleaser {
+    OpenVINOGraph* graph;
+    const std::vector<size_t>& infer_reqs;
+    ~InferRequestsReleaser() { graph->ReleaseInferRequests(infer_reqs); }
+  } releaser{this, infer_reqs};
+
+  size_t num_inf_reqs = infer_reqs.size();
+  size_t full_parallel_runs = batch_size / num_inf_reqs;
+  size_t remainder_parallel_runs = batch_size % num_inf_reqs;
 
-  GetOutputTensors(ort, context, output_tensors, batch_size);
+  GetOutputTensors(ort, context, output_tensors, batch_size, infer_reqs[0]);
 
   // Distribute the batched inputs among available Infer Requests
   // for parallel inference.
 
-  // Run parallel inferences as sets of num_inf_reqs_
+  // Run parallel inferences as sets of num_inf_reqs
   for (size_t set = 0; set < full_parallel_runs; set++) {
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
+    for (size_t i = 0; i < num_inf_reqs; i++) {
+      size_t batch_slice_idx = set * num_inf_reqs + i;
+      StartAsyncInference(ort, input_tensors, batch_slice_idx, infer_reqs[i]);
     }
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
+    for (size_t i = 0; i < num_inf_reqs; i++) {
+      size_t batch_slice_idx = set * num_inf_reqs + i;
+      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, infer_reqs[i]);
     }
   }
 
   // Run parallel inferences for remaining batch slices
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
+  for (size_t i = 0; i < remainder_parallel_runs; i++) {
+    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs + i;
+    StartAsyncInference(ort, input_tensors, batch_slice_idx, infer_reqs[i]);
   }
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
+  for (size_t i = 0; i < remainder_parallel_runs; i++) {
+    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs + i;
+    CompleteAsyncInference(ort, output_tensors, batch_slice_idx, infer_reqs[i]);
   }
 
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <ie_utils.hpp>
@@ -21,7 +24,7 @@ namespace openvino_ep {
 class OpenVINOGraph {
  public:
 
-  OpenVINOGraph(const onnxruntime::Node* fused_node);
+  OpenVINOGraph(const onnxruntime::Node* fused_node, int num_streams = 0);
 
   void Infer(Ort::CustomOpApi ort, OrtKernelContext* context);
 
@@ -42,12 +45,18 @@ class OpenVINOGraph {
 
   void GetInputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, const OrtValue* input_tensors[]);
 
-  void GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size);
+  void GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size,
+                        size_t infer_req_idx);
 
   void StartAsyncInference(Ort::CustomOpApi ort, const OrtValue* input_tensors[], size_t batch_slice_idx, size_t infer_req_idx);
 
   void CompleteAsyncInference(Ort::CustomOpApi ort, OrtValue* output_tensors[], size_t batch_slice_idx, size_t infer_req_idx);
 
+  // Takes up to max_count free Infer Requests, waiting until at least one is free
+  std::vector<size_t> AcquireInferRequests(size_t max_count);
+
+  void ReleaseInferRequests(const std::vector<size_t>& infer_req_indexes);
+
   std::vector<std::string> GetEnvLdLibraryPath() const;
 
   const onnxruntime::Node* fused_node_;
@@ -56,7 +65,10 @@ class OpenVINOGraph {
   InferenceEngine::InferencePlugin plugin_;
   std::vector<InferenceEngine::InferRequest::Ptr> infer_requests_;
   std::string device_id_;
-  mutable std::mutex compute_lock_;
+  // the indexes of the Infer Requests no Infer is using, shared by concurrent Infer calls
+  std::vector<size_t> free_infer_requests_;
+  std::mutex infer_requests_lock_;
+  std::condition_variable infer_request_freed_;
   std::vector<int> input_indexes_;
   InferenceEngine::Precision precision_;
   const onnxruntime::Graph* onnx_graph_;
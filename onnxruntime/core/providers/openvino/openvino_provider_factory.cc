@@ -7,7 +7,7 @@
 
 namespace onnxruntime {
 struct OpenVINOProviderFactory : IExecutionProviderFactory {
-  OpenVINOProviderFactory(const char* device) : device_(device) {
+  OpenVINOProviderFactory(const char* device, int num_streams) : device_(device), num_streams_(num_streams) {
   }
   ~OpenVINOProviderFactory() override {
   }
@@ -16,17 +16,24 @@ struct OpenVINOProviderFactory : IExecutionProviderFactory {
 
  private:
   const char* device_;
+  int num_streams_;
 };
 
 std::unique_ptr<IExecutionProvider> OpenVINOProviderFactory::CreateProvider() {
   OpenVINOExecutionProviderInfo info;
   info.device = device_;
+  info.num_streams = num_streams_;
   return std::make_unique<OpenVINOExecutionProvider>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(
     const char* device_id) {
-  return std::make_shared<onnxruntime::OpenVINOProviderFactory>(device_id);
+  return std::make_shared<onnxruntime::OpenVINOProviderFactory>(device_id, 0);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_OpenVINO(
+    const char* device_id, int num_streams) {
+  return std::make_shared<onnxruntime::OpenVINOProviderFactory>(device_id, num_streams);
 }
 
 }  // namespace onnxruntime
@@ -37,3 +44,10 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_OpenVINO,
       onnxruntime::CreateExecutionProviderFactory_OpenVINO(device_id));
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_OpenVINOWithStreams,
+                    _In_ OrtSessionOptions* options, const char* device_id, int num_streams) {
+  options->provider_factories.push_back(
+      onnxruntime::CreateExecutionProviderFactory_OpenVINO(device_id, num_streams));
+  return nullptr;
+}
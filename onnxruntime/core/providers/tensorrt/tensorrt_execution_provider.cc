@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "tensorrt_execution_provider.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/framework/execution_provider.h"
@@ -32,6 +36,17 @@ TensorrtLogger& GetTensorrtLogger() {
   return trt_logger;
 }
 
+namespace {
+// FNV-1a, which names the cached engines the same way in every build
+uint64_t HashString(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : data) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace
+
 #define CHECK_CUDA(call)                                        \
   do {                                                          \
     cudaError_t status = call;                                  \
@@ -44,6 +59,39 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
+  // the options of the provider take precedence over the environment variables
+  const char* batch_env = getenv("ORT_TENSORRT_MAX_BATCH_SIZE");
+  if (info.max_batch_size > 0) {
+    SetMaxBatchSize(info.max_batch_size);
+  } else if (batch_env) {
+    SetMaxBatchSize(atoi(batch_env));
+  }
+
+  const char* workspace_env = getenv("ORT_TENSORRT_MAX_WORKSPACE_SIZE");
+  if (info.max_workspace_size > 0) {
+    SetMaxWorkspaceSize(info.max_workspace_size);
+  } else if (workspace_env) {
+    SetMaxWorkspaceSize(atoi(workspace_env));
+  }
+
+  max_dynamic_batch_size_ = info.max_dynamic_batch_size;
+
+  const char* fp16_env = getenv("ORT_TENSORRT_FP16_ENABLE");
+  fp16_enable_ = info.fp16_enable || (fp16_env && atoi(fp16_env) == 1);
+
+  const char* int8_env = getenv("ORT_TENSORRT_INT8_ENABLE");
+  int8_enable_ = info.int8_enable || (int8_env && atoi(int8_env) == 1);
+
+  const char* calibration_table_env = getenv("ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH");
+  if (!info.int8_calibration_table_path.empty()) {
+    int8_calibration_table_path_ = info.int8_calibration_table_path;
+  } else if (calibration_table_env) {
+    int8_calibration_table_path_ = calibration_table_env;
+  }
+  if (info.int8_calibration_size > 0) {
+    int8_calibration_size_ = info.int8_calibration_size;
+  }
+
   DeviceAllocatorRegistrationInfo default_memory_info(
       {OrtMemTypeDefault, [](int id) { return std::make_unique<CUDAAllocator>(id, TRT); }, std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(default_memory_info, device_id_));
@@ -59,6 +107,151 @@ std::unique_ptr<onnxruntime::IDataTransfer> TensorrtExecutionProvider::GetDataTr
   return std::make_unique<onnxruntime::GPUDataTransfer>();
 }
 
+TensorrtExecutionProvider::unique_pointer<nvinfer1::ICudaEngine> TensorrtExecutionProvider::GetCudaEngine(
+    const std::string& model_data, int batch_size, nvinfer1::IBuilder& builder,
+    nvinfer1::INetworkDefinition& network, TensorrtInt8Calibrator* calibrator) {
+  const bool fp16 = fp16_enable_ && builder.platformHasFastFp16();
+  builder.setMaxBatchSize(batch_size);
+  builder.setMaxWorkspaceSize(max_workspace_size_);
+  builder.setFp16Mode(fp16);
+  builder.setInt8Mode(calibrator != nullptr);
+  builder.setInt8Calibrator(calibrator);
+
+  // the engine that calibrates isn't cached, as its calibration table is computed by the build
+  if (engine_cache_path_.empty() || (calibrator != nullptr && !calibrator->HasTable())) {
+    return unique_pointer<nvinfer1::ICudaEngine>(builder.buildCudaEngine(network));
+  }
+
+  cudaDeviceProp prop;
+  CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id_));
+  std::ostringstream key;
+  key << model_data << "|trt" << getInferLibVersion() << "|" << prop.name << "|sm" << prop.major << prop.minor
+      << "|batch" << batch_size << "|workspace" << max_workspace_size_ << "|fp16" << fp16;
+  if (calibrator != nullptr) {
+    key << "|int8" << calibrator->GetTable();
+  }
+  std::ostringstream file_name;
+  file_name << engine_cache_path_ << "/trt_" << std::hex << HashString(key.str()) << ".engine";
+  const std::string engine_path = file_name.str();
+
+  TensorrtLogger& trt_logger = GetTensorrtLogger();
+  std::ifstream engine_file(engine_path, std::ios::binary | std::ios::in);
+  if (engine_file) {
+    const std::string engine_data((std::istreambuf_iterator<char>(engine_file)), std::istreambuf_iterator<char>());
+    if (runtime_ == nullptr) {
+      runtime_ = unique_pointer<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(trt_logger));
+    }
+    auto engine = unique_pointer<nvinfer1::ICudaEngine>(
+        runtime_->deserializeCudaEngine(engine_data.data(), engine_data.size(), nullptr));
+    if (engine != nullptr) {
+      LOGS_DEFAULT(INFO) << "Deserialized the TensorRT engine " << engine_path;
+      return engine;
+    }
+    LOGS_DEFAULT(WARNING) << "Failed to deserialize the TensorRT engine " << engine_path << ", building it again";
+  }
+
+  auto engine = unique_pointer<nvinfer1::ICudaEngine>(builder.buildCudaEngine(network));
+  if (engine == nullptr) {
+    return engine;
+  }
+
+  // the engine is written to a temporary file first, so that other processes never read a partial engine. The
+  // processes of different containers sharing the cache can have the same id, the time tells them apart.
+  auto serialized_engine = unique_pointer<nvinfer1::IHostMemory>(engine->serialize());
+  const std::string temp_path = engine_path + "." + std::to_string(Env::Default().GetSelfPid()) + "_" +
+                                std::to_string(Env::Default().NowMicros()) + ".tmp";
+  {
+    std::ofstream temp_file(temp_path, std::ios::binary | std::ios::out | std::ios::trunc);
+    temp_file.write(static_cast<const char*>(serialized_engine->data()), serialized_engine->size());
+    if (!temp_file) {
+      LOGS_DEFAULT(WARNING) << "Failed to write the TensorRT engine cache file " << temp_path;
+      return engine;
+    }
+  }
+  if (std::rename(temp_path.c_str(), engine_path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    LOGS_DEFAULT(WARNING) << "Failed to add the TensorRT engine " << engine_path << " to the cache";
+  }
+  return engine;
+}
+
+common::Status TensorrtExecutionProvider::GetExecutionContext(EngineSet& engine_set, int batch_size,
+                                                              nvinfer1::IExecutionContext*& context) {
+  auto it = engine_set.engines.lower_bound(batch_size);
+  if (it != engine_set.engines.end()) {
+    context = it->second.second.get();
+    return Status::OK();
+  }
+
+  if (batch_size > max_dynamic_batch_size_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The batch size ", batch_size,
+                           " is larger than the max batch size of the TensorRT engines. Set max_dynamic_batch_size "
+                           "or ORT_TENSORRT_MAX_BATCH_SIZE to at least ",
+                           batch_size);
+  }
+
+  int engine_batch_size = 1;
+  while (engine_batch_size < batch_size) {
+    engine_batch_size *= 2;
+  }
+  engine_batch_size = std::min(engine_batch_size, max_dynamic_batch_size_);
+
+  auto engine = GetCudaEngine(engine_set.model_data, engine_batch_size, *engine_set.builder, *engine_set.network,
+                              engine_set.calibrator != nullptr && engine_set.calibrator->HasTable()
+                                  ? engine_set.calibrator.get()
+                                  : nullptr);
+  if (engine == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to build the TensorRT engine for batch size ",
+                           engine_batch_size);
+  }
+  auto engine_context = unique_pointer<nvinfer1::IExecutionContext>(engine->createExecutionContext());
+  if (engine_context == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the TensorRT execution context");
+  }
+
+  context = engine_context.get();
+  engine_set.engines.emplace(engine_batch_size, std::make_pair(std::move(engine), std::move(engine_context)));
+  return Status::OK();
+}
+
+common::Status TensorrtExecutionProvider::Calibrate(EngineSet& engine_set, int batch_size,
+                                                    const std::vector<void*>& inputs,
+                                                    const std::vector<size_t>& input_sizes) {
+  auto* calibrator = engine_set.calibrator.get();
+  if (calibrator == nullptr || calibrator->HasTable()) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(calibrator->RecordBatch(batch_size, inputs, input_sizes));
+  if (calibrator->NumRecordedRows() < int8_calibration_size_) {
+    return Status::OK();
+  }
+
+  // the smallest engine has the max batch size of the session, which the calibration batches can't exceed
+  LOGS_DEFAULT(INFO) << "Calibrating the TensorRT INT8 engines on " << calibrator->NumRecordedRows() << " rows";
+  calibrator->SetBatchSize(std::min(calibrator->NumRecordedRows(), max_batch_size_));
+  decltype(engine_set.engines) int8_engines;
+  for (const auto& engine : engine_set.engines) {
+    auto int8_engine = GetCudaEngine(engine_set.model_data, engine.first, *engine_set.builder, *engine_set.network,
+                                     calibrator);
+    if (int8_engine == nullptr || !calibrator->HasTable()) {
+      calibrator->ReleaseRecordedRows();
+      engine_set.calibrator.reset();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to calibrate the TensorRT INT8 engine for batch size ",
+                             engine.first);
+    }
+    auto int8_context = unique_pointer<nvinfer1::IExecutionContext>(int8_engine->createExecutionContext());
+    if (int8_context == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the TensorRT execution context");
+    }
+    int8_engines.emplace(engine.first, std::make_pair(std::move(int8_engine), std::move(int8_context)));
+  }
+
+  calibrator->ReleaseRecordedRows();
+  engine_set.engines.swap(int8_engines);
+  return Status::OK();
+}
+
 std::unique_ptr<IndexedSubGraph> TensorrtExecutionProvider::GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index, const onnxruntime::GraphViewer& graph) const {
   const std::vector<NodeIndex>& node_index = graph.GetNodesInTopologicalOrder();
   std::unordered_set<size_t> node_set;
@@ -340,21 +533,26 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
     trt_parser->parse(string_buf.data(), string_buf.size());
 
-    const char* batch_env = getenv("ORT_TENSORRT_MAX_BATCH_SIZE");
-    if (batch_env) {
-      const int max_batch_size = atoi(batch_env);
-      SetMaxBatchSize(max_batch_size);
+    const char* engine_cache_env = getenv("ORT_TENSORRT_ENGINE_CACHE_PATH");
+    if (engine_cache_env) {
+      SetEngineCachePath(engine_cache_env);
     }
 
-    const char* workspace_env = getenv("ORT_TENSORRT_MAX_WORKSPACE_SIZE");
-    if (workspace_env) {
-      const size_t max_workspace_size = atoi(workspace_env);
-      SetMaxWorkspaceSize(max_workspace_size);
+    // without a calibration table, the engines run in FP32, or FP16, until the calibration recorded enough runs
+    std::unique_ptr<TensorrtInt8Calibrator> trt_calibrator;
+    if (int8_enable_ && !trt_builder->platformHasFastInt8()) {
+      LOGS_DEFAULT(WARNING) << "The GPU has no fast INT8, the TensorRT engines are built without INT8";
+    } else if (int8_enable_) {
+      std::ostringstream table_path;
+      if (!int8_calibration_table_path_.empty()) {
+        table_path << int8_calibration_table_path_ << "/trt_" << std::hex << HashString(string_buf) << ".calibration";
+      }
+      trt_calibrator = std::make_unique<TensorrtInt8Calibrator>(table_path.str());
     }
 
-    trt_builder->setMaxBatchSize(max_batch_size_);
-    trt_builder->setMaxWorkspaceSize(max_workspace_size_);
-    auto trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildCudaEngine(*trt_network.get()));
+    auto trt_engine = GetCudaEngine(string_buf, max_batch_size_, *trt_builder, *trt_network,
+                                    trt_calibrator != nullptr && trt_calibrator->HasTable() ? trt_calibrator.get()
+                                                                                             : nullptr);
     ORT_ENFORCE(trt_engine != nullptr);
 
     // Build TensorRT context
@@ -365,9 +563,11 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     int num_inputs = trt_network->getNbInputs();
     input_indexes.resize(num_inputs);
     input_dim_sizes.resize(num_inputs);
+    std::vector<std::string> input_names(num_inputs);
     for (int i = 0; i < num_inputs; ++i) {
       const std::string& name = trt_network->getInput(i)->getName();
       size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
+      input_names[bindingIndex] = name;
       nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
       auto iter = input_map.find(name);
       if (iter != input_map.end()) {
@@ -415,9 +615,17 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs));
 
     // Save engine, context and input/output info to map
-    parsers_.emplace(fused_node->Name(), std::move(trt_parser));
-    engines_.emplace(fused_node->Name(), std::move(trt_engine));
-    contexts_.emplace(fused_node->Name(), std::move(trt_context));
+    // the engines for larger batches are built from the same network, their bindings are in the same order
+    EngineSet& engine_set = engine_sets_[fused_node->Name()];
+    engine_set.builder = std::move(trt_builder);
+    engine_set.network = std::move(trt_network);
+    engine_set.parser = std::move(trt_parser);
+    if (trt_calibrator != nullptr) {
+      trt_calibrator->SetInputNames(input_names);
+    }
+    engine_set.calibrator = std::move(trt_calibrator);
+    engine_set.model_data = std::move(string_buf);
+    engine_set.engines.emplace(max_batch_size_, std::make_pair(std::move(trt_engine), std::move(trt_context)));
     input_info_[fused_node->Name()].push_back(input_indexes);
     input_info_[fused_node->Name()].push_back(input_dim_sizes);
     output_info_[fused_node->Name()].push_back(output_indexes);
@@ -430,7 +638,15 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [=](ComputeContext* context, FunctionState* state) {
       std::unique_ptr<TensorrtFuncState> p = std::make_unique<TensorrtFuncState>();
-      *p = {context->allocate_func, context->release_func, context->allocator_handle, parsers_[context->node_name].get(), engines_[context->node_name].get(), contexts_[context->node_name].get(),
+      EngineSet* engine_set = &engine_sets_[context->node_name];
+      auto get_context = [this, engine_set](int batch_size, nvinfer1::IExecutionContext*& trt_context) {
+        return GetExecutionContext(*engine_set, batch_size, trt_context);
+      };
+      auto calibrate = [this, engine_set](int batch_size, const std::vector<void*>& inputs,
+                                          const std::vector<size_t>& input_sizes) {
+        return Calibrate(*engine_set, batch_size, inputs, input_sizes);
+      };
+      *p = {context->allocate_func, context->release_func, context->allocator_handle, engine_set->parser.get(), get_context, calibrate,
             input_info_[context->node_name], output_info_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_};
       *state = p.release();
       return 0;
@@ -455,6 +671,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       int num_binding_outputs = output_indexes.size();
       int total_bindings = num_binding_inputs + num_binding_outputs;
       std::vector<void*> buffers(total_bindings);
+      std::vector<size_t> input_sizes(num_binding_inputs);
       int batch_size = 1;
 
       // Get batch size and allocate cuda memory for inputs
@@ -463,6 +680,7 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
         const auto& tensor_shape = ort.GetTensorShape(tensor_info);
         auto tensor_type = ort.GetTensorElementType(tensor_info);
+        const size_t element_count = ort.GetTensorShapeElementCount(tensor_info);
         ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
 
         const int input_batch_size = tensor_shape[0];
@@ -473,10 +691,13 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
 
         if (tensor_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
           buffers[i] = const_cast<float*>(ort.GetTensorData<float>(input_tensor));
+          input_sizes[i] = element_count * sizeof(float);
         } else if (tensor_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
           buffers[i] = const_cast<int8_t*>(ort.GetTensorData<int8_t>(input_tensor));
+          input_sizes[i] = element_count * sizeof(int8_t);
         } else if (tensor_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32) {
           buffers[i] = const_cast<int32_t*>(ort.GetTensorData<int32_t>(input_tensor));
+          input_sizes[i] = element_count * sizeof(int32_t);
         } else {
           return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
         }
@@ -501,12 +722,12 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
 
       // Run TRT inference
       std::lock_guard<OrtMutex> lock(*(trt_state->tensorrt_mu_ptr));
-      bool ret = trt_state->context->enqueue(batch_size, &buffers[0], nullptr, nullptr);
+      std::vector<void*> inputs(buffers.begin(), buffers.begin() + num_binding_inputs);
+      ORT_RETURN_IF_ERROR(trt_state->calibrate(batch_size, inputs, input_sizes));
+      nvinfer1::IExecutionContext* trt_context = nullptr;
+      ORT_RETURN_IF_ERROR(trt_state->get_context(batch_size, trt_context));
+      bool ret = trt_context->enqueue(batch_size, &buffers[0], nullptr, nullptr);
       if (!ret) {
-        if (trt_state->context->getEngine().getMaxBatchSize() < batch_size) {
-          return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                                "TRT enqueue failed: Set ORT_TENSORRT_MAX_BATCH_SIZE environment variable to at least " + to_string(batch_size));
-        }
         return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to enqueue to TRT execution context.");
       }
 
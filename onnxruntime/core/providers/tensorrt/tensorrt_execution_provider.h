@@ -3,11 +3,14 @@
 
 #pragma once
 #include <ctime>
+#include <functional>
+#include <map>
 #include "core/common/logging/logging.h"
 #include "core/framework/op_kernel.h"
 #include "NvInfer.h"
 #include "NvOnnxParser.h"
 #include "core/platform/ort_mutex.h"
+#include "tensorrt_int8_calibrator.h"
 
 namespace onnxruntime {
 
@@ -33,6 +36,21 @@ class TensorrtLogger : public nvinfer1::ILogger {
 // Information needed to construct trt execution providers.
 struct TensorrtExecutionProviderInfo {
   int device_id{0};
+  // the max batch size of the engines built with the session, 0 for ORT_TENSORRT_MAX_BATCH_SIZE or 1
+  int max_batch_size{0};
+  // the max workspace size of the engines, 0 for ORT_TENSORRT_MAX_WORKSPACE_SIZE or 1 GB
+  size_t max_workspace_size{0};
+  // the largest batch size of the engines built on demand for larger batches, 0 to fail them
+  int max_dynamic_batch_size{0};
+  // build FP16 engines, or set ORT_TENSORRT_FP16_ENABLE to 1
+  bool fp16_enable{false};
+  // build INT8 engines, or set ORT_TENSORRT_INT8_ENABLE to 1. The engines run in FP32, or FP16, until the INT8
+  // calibration recorded int8_calibration_size input rows from the runs, unless a calibration table is found.
+  bool int8_enable{false};
+  // the directory of the INT8 calibration tables, or ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH
+  std::string int8_calibration_table_path;
+  // the number of input rows the INT8 calibration records, 0 for 512
+  int int8_calibration_size{0};
 };
 
 // Information to construct kernel function state.
@@ -41,8 +59,11 @@ struct TensorrtFuncState {
   DestroyFunc test_release_func = nullptr;
   AllocatorHandle allocator = nullptr;
   nvonnxparser::IParser* parser = nullptr;
-  nvinfer1::ICudaEngine* engine = nullptr;
-  nvinfer1::IExecutionContext* context = nullptr;
+  // returns the context of an engine that runs batches of batch_size, building the engine if needed
+  std::function<common::Status(int batch_size, nvinfer1::IExecutionContext*& context)> get_context;
+  // records the inputs of a run for the INT8 calibration, which builds the INT8 engines once it has enough of them
+  std::function<common::Status(int batch_size, const std::vector<void*>& inputs, const std::vector<size_t>& input_sizes)>
+      calibrate;
   std::vector<std::vector<int>> input_info;
   std::vector<std::vector<int>> output_info;
   std::vector<std::vector<int64_t>> output_shapes;
@@ -74,10 +95,21 @@ class TensorrtExecutionProvider : public IExecutionProvider {
     max_workspace_size_ = workspace_size;
   }
 
+  void SetEngineCachePath(const std::string& engine_cache_path) {
+    engine_cache_path_ = engine_cache_path;
+  }
+
  private:
   int max_batch_size_ = 1;
   size_t max_workspace_size_ = 1 << 30;  // 1GB
+  int max_dynamic_batch_size_ = 0;
+  bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  std::string int8_calibration_table_path_;
+  int int8_calibration_size_ = 512;
   int max_parser_iterations_ = 6;
+  // the directory of the serialized engines, empty to build them in every session
+  std::string engine_cache_path_;
 
   struct InferDeleter {
     template <typename T>
@@ -91,15 +123,50 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   template <typename T>
   using unique_pointer = std::unique_ptr<T, InferDeleter>;
 
+  // The engines of a fused node by their max batch size, and the network they are built from.
+  struct EngineSet {
+    // set with INT8, the builder reads the calibration from it
+    std::unique_ptr<TensorrtInt8Calibrator> calibrator;
+    unique_pointer<nvinfer1::IBuilder> builder;
+    unique_pointer<nvinfer1::INetworkDefinition> network;
+    unique_pointer<nvonnxparser::IParser> parser;
+    std::string model_data;
+    std::map<int, std::pair<unique_pointer<nvinfer1::ICudaEngine>, unique_pointer<nvinfer1::IExecutionContext>>>
+        engines;
+  };
+
   OrtMutex tensorrt_mu_;
   int device_id_;
-  std::unordered_map<std::string, unique_pointer<nvonnxparser::IParser>> parsers_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::ICudaEngine>> engines_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::IExecutionContext>> contexts_;
+  // deserializes the cached engines, created with the first one
+  unique_pointer<nvinfer1::IRuntime> runtime_;
+  std::unordered_map<std::string, EngineSet> engine_sets_;
   std::unordered_map<std::string, std::vector<std::vector<int>>> input_info_;
   std::unordered_map<std::string, std::vector<std::vector<int>>> output_info_;
   std::unordered_map<std::string, std::vector<std::vector<int64_t>>> output_shapes_;
 
+  /**
+  Build the engine of the network, or deserialize it from the engine cache. The engines are cached by the hash of
+  the model of the subgraph, the TensorRT version, the GPU and the builder configuration, and the ones built are
+  added to the cache.
+  */
+  unique_pointer<nvinfer1::ICudaEngine> GetCudaEngine(const std::string& model_data, int batch_size,
+                                                      nvinfer1::IBuilder& builder,
+                                                      nvinfer1::INetworkDefinition& network,
+                                                      TensorrtInt8Calibrator* calibrator);
+
+  /**
+  Get the context of the engine with the smallest max batch size of at least batch_size. If there's none, build an
+  engine for the next power of two, up to max_dynamic_batch_size_, so that the batches of a range share an engine.
+  */
+  common::Status GetExecutionContext(EngineSet& engine_set, int batch_size, nvinfer1::IExecutionContext*& context);
+
+  /**
+  Record the inputs of a run for the INT8 calibration of the engine set. Once int8_calibration_size_ rows are
+  recorded, calibrate and replace the engines with INT8 engines of the same batch sizes.
+  */
+  common::Status Calibrate(EngineSet& engine_set, int batch_size, const std::vector<void*>& inputs,
+                           const std::vector<size_t>& input_sizes);
+
   /**Get IndexedSubGraph based on node list of the subgraph*/
   std::unique_ptr<IndexedSubGraph> GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index,
                                                const onnxruntime::GraphViewer& graph) const;
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "tensorrt_int8_calibrator.h"
+#include <cstring>
+#include <fstream>
+#include "core/common/logging/logging.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+
+TensorrtInt8Calibrator::TensorrtInt8Calibrator(const std::string& table_path) : table_path_(table_path) {
+  if (table_path_.empty()) {
+    return;
+  }
+  std::ifstream table_file(table_path_, std::ios::binary | std::ios::in);
+  if (table_file) {
+    table_.assign((std::istreambuf_iterator<char>(table_file)), std::istreambuf_iterator<char>());
+  }
+}
+
+TensorrtInt8Calibrator::~TensorrtInt8Calibrator() {
+  ReleaseRecordedRows();
+}
+
+common::Status TensorrtInt8Calibrator::RecordBatch(int batch_size, const std::vector<void*>& inputs,
+                                                   const std::vector<size_t>& input_sizes) {
+  if (inputs.size() != input_names_.size() || batch_size <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid inputs for the INT8 calibration");
+  }
+  if (rows_.empty()) {
+    rows_.resize(inputs.size());
+    for (const auto input_size : input_sizes) {
+      row_sizes_.push_back(input_size / batch_size);
+    }
+  }
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (input_sizes[i] != row_sizes_[i] * batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input ", input_names_[i],
+                             " has a different row size than in the previous runs of the INT8 calibration");
+    }
+    const size_t offset = rows_[i].size();
+    rows_[i].resize(offset + input_sizes[i]);
+    CUDA_RETURN_IF_ERROR(cudaMemcpy(&rows_[i][offset], inputs[i], input_sizes[i], cudaMemcpyDeviceToHost));
+  }
+  num_rows_ += batch_size;
+  return Status::OK();
+}
+
+void TensorrtInt8Calibrator::ReleaseRecordedRows() {
+  for (auto* device_batch : device_batches_) {
+    cudaFree(device_batch);
+  }
+  device_batches_.clear();
+  rows_.clear();
+  row_sizes_.clear();
+  num_rows_ = 0;
+  next_row_ = 0;
+}
+
+bool TensorrtInt8Calibrator::getBatch(void* bindings[], const char* names[], int nbBindings) {
+  if (next_row_ + batch_size_ > num_rows_) {
+    return false;
+  }
+
+  if (device_batches_.empty()) {
+    device_batches_.resize(rows_.size(), nullptr);
+    for (size_t i = 0; i < rows_.size(); ++i) {
+      if (cudaMalloc(&device_batches_[i], row_sizes_[i] * batch_size_) != cudaSuccess) {
+        LOGS_DEFAULT(ERROR) << "Failed to allocate the batches of the INT8 calibration";
+        return false;
+      }
+    }
+  }
+
+  for (int binding = 0; binding < nbBindings; ++binding) {
+    size_t i = 0;
+    while (i < input_names_.size() && input_names_[i] != names[binding]) {
+      ++i;
+    }
+    if (i == input_names_.size()) {
+      LOGS_DEFAULT(ERROR) << "The INT8 calibration has no rows recorded for the input " << names[binding];
+      return false;
+    }
+    const size_t batch_bytes = row_sizes_[i] * batch_size_;
+    if (cudaMemcpy(device_batches_[i], &rows_[i][row_sizes_[i] * next_row_], batch_bytes, cudaMemcpyHostToDevice) !=
+        cudaSuccess) {
+      return false;
+    }
+    bindings[binding] = device_batches_[i];
+  }
+  next_row_ += batch_size_;
+  return true;
+}
+
+const void* TensorrtInt8Calibrator::readCalibrationCache(size_t& length) {
+  length = table_.size();
+  return table_.empty() ? nullptr : table_.data();
+}
+
+void TensorrtInt8Calibrator::writeCalibrationCache(const void* cache, size_t length) {
+  table_.assign(static_cast<const char*>(cache), length);
+  if (table_path_.empty()) {
+    return;
+  }
+  std::ofstream table_file(table_path_, std::ios::binary | std::ios::out | std::ios::trunc);
+  table_file.write(table_.data(), table_.size());
+  if (!table_file) {
+    LOGS_DEFAULT(WARNING) << "Failed to write the INT8 calibration table " << table_path_;
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <string>
+#include <vector>
+#include "core/common/common.h"
+#include "NvInfer.h"
+
+namespace onnxruntime {
+
+/**
+Calibrates the INT8 engines of a TensorRT network on the inputs recorded from the first runs of the session, or reads
+the calibration table a previous session wrote. The table is written to table_path once computed, so that the
+following sessions build their INT8 engines without calibrating.
+*/
+class TensorrtInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  // table_path is the file of the calibration table, empty to keep the table in memory
+  explicit TensorrtInt8Calibrator(const std::string& table_path);
+  ~TensorrtInt8Calibrator() override;
+
+  bool HasTable() const { return !table_.empty(); }
+
+  const std::string& GetTable() const { return table_; }
+
+  // the names of the inputs of the network in the order of their bindings
+  void SetInputNames(const std::vector<std::string>& input_names) { input_names_ = input_names; }
+
+  /**
+  Record the rows of a batch of the inputs, which are in device memory, in the order of their bindings.
+  @param input_sizes the size of each input in bytes.
+  */
+  common::Status RecordBatch(int batch_size, const std::vector<void*>& inputs, const std::vector<size_t>& input_sizes);
+
+  int NumRecordedRows() const { return num_rows_; }
+
+  // the number of rows the calibration reads per batch, at most the max batch size of the engine it builds
+  void SetBatchSize(int batch_size) { batch_size_ = batch_size; }
+
+  // free the recorded rows, once the table is computed
+  void ReleaseRecordedRows();
+
+  int getBatchSize() const override { return batch_size_; }
+  bool getBatch(void* bindings[], const char* names[], int nbBindings) override;
+  const void* readCalibrationCache(size_t& length) override;
+  void writeCalibrationCache(const void* cache, size_t length) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TensorrtInt8Calibrator);
+
+  const std::string table_path_;
+  std::string table_;
+  std::vector<std::string> input_names_;
+  // the recorded rows of each input, in host memory, and the size of a row
+  std::vector<std::string> rows_;
+  std::vector<size_t> row_sizes_;
+  int num_rows_ = 0;
+  int next_row_ = 0;
+  int batch_size_ = 1;
+  // the batch of each input read by the calibration
+  std::vector<void*> device_batches_;
+};
+
+}  // namespace onnxruntime
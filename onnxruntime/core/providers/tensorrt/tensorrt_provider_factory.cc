@@ -11,23 +11,27 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct TensorrtProviderFactory : IExecutionProviderFactory {
-  TensorrtProviderFactory(int device_id) : device_id_(device_id) {}
+  TensorrtProviderFactory(const TensorrtExecutionProviderInfo& info) : info_(info) {}
   ~TensorrtProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  int device_id_;
+  TensorrtExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> TensorrtProviderFactory::CreateProvider() {
-  TensorrtExecutionProviderInfo info;
-  info.device_id = device_id_;
-  return std::make_unique<TensorrtExecutionProvider>(info);
+  return std::make_unique<TensorrtExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(const TensorrtExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::TensorrtProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id) {
-  return std::make_shared<onnxruntime::TensorrtProviderFactory>(device_id);
+  TensorrtExecutionProviderInfo info;
+  info.device_id = device_id;
+  return CreateExecutionProviderFactory_Tensorrt(info);
 }
 }  // namespace onnxruntime
 
@@ -36,3 +40,28 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Tensorrt, _In_ OrtS
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_TensorrtWithBatchSizes, _In_ OrtSessionOptions* options,
+                    int device_id, int max_batch_size, size_t max_workspace_size, int max_dynamic_batch_size) {
+  TensorrtExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.max_batch_size = max_batch_size;
+  info.max_workspace_size = max_workspace_size;
+  info.max_dynamic_batch_size = max_dynamic_batch_size;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Tensorrt(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_TensorrtWithPrecision, _In_ OrtSessionOptions* options,
+                    int device_id, int fp16_enable, int int8_enable, _In_opt_ const char* int8_calibration_table_path,
+                    int int8_calibration_size) {
+  TensorrtExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.fp16_enable = fp16_enable != 0;
+  info.int8_enable = int8_enable != 0;
+  if (int8_calibration_table_path != nullptr) {
+    info.int8_calibration_table_path = int8_calibration_table_path;
+  }
+  info.int8_calibration_size = int8_calibration_size;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Tensorrt(info));
+  return nullptr;
+}
@@ -97,6 +97,16 @@ const std::vector<std::string>& IOBinding::GetInputNames() const {
 
 const std::vector<OrtValue>& IOBinding::GetInputs() const { return feeds_; }
 
+void IOBinding::ClearInputs() {
+  feed_names_.clear();
+  feeds_.clear();
+}
+
+void IOBinding::ClearOutputs() {
+  output_names_.clear();
+  outputs_.clear();
+}
+
 AllocatorPtr IOBinding::GetCPUAllocator(int id, onnxruntime::ProviderType provider_type) const {
   auto& exec_providers = session_state_.GetExecutionProviders();
   auto* p_provider = exec_providers.Get(provider_type);
@@ -72,6 +72,12 @@ class IOBinding {
   const std::vector<std::string>& GetInputNames() const;
   const std::vector<OrtValue>& GetInputs() const;
 
+  /**
+    * Removes the bound inputs or outputs, to bind others with the same IOBinding.
+    */
+  void ClearInputs();
+  void ClearOutputs();
+
   /**
     * Get a CPU allocator from provider for async copy later if the provider supports that
     * If it doesn't support that, return the default allocator from CPU provider
@@ -62,6 +62,34 @@ ORT_API_STATUS_IMPL(OrtDisableProfiling, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtSetProfilingSamplingInterval, _In_ OrtSessionOptions* options, int sampling_interval) {
+  if (sampling_interval < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "sampling_interval must be 0 or above");
+  }
+  options->value.profile_sampling_interval = sampling_interval;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableProfilingHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_profiling_hardware_counters = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableProfilingHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_profiling_hardware_counters = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableMetrics, _In_ OrtSessionOptions* options) {
+  options->value.enable_metrics = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableMetrics, _In_ OrtSessionOptions* options) {
+  options->value.enable_metrics = false;
+  return nullptr;
+}
+
 // enable the memory pattern optimization.
 // The idea is if the input shapes are the same, we could trace the internal memory allocation
 // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -75,6 +103,16 @@ ORT_API_STATUS_IMPL(OrtDisableMemPattern, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtEnableStaticMemoryPlanning, _In_ OrtSessionOptions* options) {
+  options->value.enable_static_memory_planning = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableStaticMemoryPlanning, _In_ OrtSessionOptions* options) {
+  options->value.enable_static_memory_planning = false;
+  return nullptr;
+}
+
 // enable the memory arena on CPU
 // Arena may pre-allocate memory for future usage.
 // set this option to false if you don't want it.
@@ -88,6 +126,145 @@ ORT_API_STATUS_IMPL(OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+// enable a per-thread cache of small freed chunks in front of the CPU memory arena.
+// Frees and re-allocations of cached sizes skip the arena lock.
+ORT_API_STATUS_IMPL(OrtEnableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_arena_thread_cache = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableCpuMemArenaThreadCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_arena_thread_cache = false;
+  return nullptr;
+}
+
+// back the large regions of the CPU memory arena with huge pages where the platform has them.
+ORT_API_STATUS_IMPL(OrtEnableCpuMemArenaHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_arena_huge_pages = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableCpuMemArenaHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_arena_huge_pages = false;
+  return nullptr;
+}
+
+// set initial size, growth strategy and limit of the memory arena on CPU.
+ORT_API_STATUS_IMPL(OrtSetCpuMemArenaCfg, _In_ OrtSessionOptions* options, _In_ const OrtArenaCfg* arena_cfg) {
+  if (arena_cfg == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "arena_cfg is null");
+  }
+  options->value.cpu_mem_arena_cfg = *arena_cfg;
+  return nullptr;
+}
+
+// use the allocators registered with the environment so that sessions share their arenas.
+ORT_API_STATUS_IMPL(OrtEnableEnvAllocators, _In_ OrtSessionOptions* options) {
+  options->value.use_env_allocators = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableEnvAllocators, _In_ OrtSessionOptions* options) {
+  options->value.use_env_allocators = false;
+  return nullptr;
+}
+
+// give unused memory of the arenas back to the devices whenever the last in-progress Run call finishes.
+ORT_API_STATUS_IMPL(OrtEnableMemArenaShrinkAfterRun, _In_ OrtSessionOptions* options) {
+  options->value.enable_mem_arena_shrink_after_run = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableMemArenaShrinkAfterRun, _In_ OrtSessionOptions* options) {
+  options->value.enable_mem_arena_shrink_after_run = false;
+  return nullptr;
+}
+
+// let the kernels benchmark their implementations when the session is initialized.
+ORT_API_STATUS_IMPL(OrtEnableKernelTuning, _In_ OrtSessionOptions* options) {
+  options->value.enable_kernel_tuning = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableKernelTuning, _In_ OrtSessionOptions* options) {
+  options->value.enable_kernel_tuning = false;
+  return nullptr;
+}
+
+// set filepath to load and save the implementations chosen by the kernels.
+ORT_API_STATUS_IMPL(OrtSetKernelTuningCacheFilePath, _In_ OrtSessionOptions* options,
+                    _In_ const ORTCHAR_T* kernel_tuning_cache_filepath) {
+  options->value.kernel_tuning_cache_filepath = kernel_tuning_cache_filepath;
+  return nullptr;
+}
+
+// move the device nodes that cost more to copy data for than they save to the CPU.
+ORT_API_STATUS_IMPL(OrtEnableCostBasedPartitioning, _In_ OrtSessionOptions* options) {
+  options->value.enable_cost_based_partitioning = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableCostBasedPartitioning, _In_ OrtSessionOptions* options) {
+  options->value.enable_cost_based_partitioning = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetCostBasedPartitioningFactors, _In_ OrtSessionOptions* options, double device_speedup,
+                    double copy_latency, double copy_cost_per_byte) {
+  if (!(device_speedup > 0) || !(copy_latency >= 0) || !(copy_cost_per_byte >= 0)) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT,
+                           "device_speedup must be positive, copy_latency and copy_cost_per_byte not negative");
+  }
+  options->value.partitioning_cost_model.device_speedup = device_speedup;
+  options->value.partitioning_cost_model.copy_latency = copy_latency;
+  options->value.partitioning_cost_model.copy_cost_per_byte = copy_cost_per_byte;
+  return nullptr;
+}
+
+// replay the device work captured from a Run for the later Runs.
+ORT_API_STATUS_IMPL(OrtEnableGraphCapture, _In_ OrtSessionOptions* options) {
+  options->value.enable_graph_capture = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableGraphCapture, _In_ OrtSessionOptions* options) {
+  options->value.enable_graph_capture = false;
+  return nullptr;
+}
+
+// compute the float nodes of the CUDA execution provider in float16.
+ORT_API_STATUS_IMPL(OrtEnableFloat16Compute, _In_ OrtSessionOptions* options) {
+  options->value.enable_float16_compute = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableFloat16Compute, _In_ OrtSessionOptions* options) {
+  options->value.enable_float16_compute = false;
+  return nullptr;
+}
+
+// output the class probabilities of ZipMap nodes producing model outputs as tensors.
+ORT_API_STATUS_IMPL(OrtEnableZipMapElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_elimination = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableZipMapElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_elimination = false;
+  return nullptr;
+}
+
+// initialize the subgraphs of control flow nodes on their first run.
+ORT_API_STATUS_IMPL(OrtEnableLazySubgraphInitialization, _In_ OrtSessionOptions* options) {
+  options->value.enable_lazy_subgraph_initialization = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableLazySubgraphInitialization, _In_ OrtSessionOptions* options) {
+  options->value.enable_lazy_subgraph_initialization = false;
+  return nullptr;
+}
+
 ///< logger id to use for session output
 ORT_API_STATUS_IMPL(OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -137,3 +314,79 @@ ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options
   options->value.session_thread_pool_size = session_thread_pool_size;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtDisablePerSessionThreads, _In_ OrtSessionOptions* options) {
+  options->value.use_per_session_threads = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableLowLatencyThreading, _In_ OrtSessionOptions* options, int spin_duration_us) {
+  if (spin_duration_us < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "spin_duration_us must not be negative");
+  }
+  options->value.enable_low_latency_threading = true;
+  options->value.thread_pool_spin_duration_us = spin_duration_us;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableLowLatencyThreading, _In_ OrtSessionOptions* options) {
+  options->value.enable_low_latency_threading = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtAddInitializer, _In_ OrtSessionOptions* options, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  if (name == nullptr || val == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "name and val must not be null");
+  }
+  if (!val->IsTensor()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "val must be a tensor");
+  }
+  options->value.initializers_to_share_map[name] = val;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolReplicas, _In_ OrtSessionOptions* options, int num_replicas,
+                    _In_opt_ const int* replica_affinities, size_t num_processors_per_replica) {
+  if (num_replicas < 1) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "num_replicas must be at least 1");
+  }
+  if (replica_affinities != nullptr && num_processors_per_replica == 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "num_processors_per_replica must not be 0");
+  }
+
+  options->value.num_thread_pool_replicas = num_replicas;
+  options->value.thread_pool_replica_affinities.clear();
+  if (replica_affinities != nullptr) {
+    for (size_t i = 0; i < static_cast<size_t>(num_replicas); ++i) {
+      const int* begin = replica_affinities + i * num_processors_per_replica;
+      options->value.thread_pool_replica_affinities.emplace_back(begin, begin + num_processors_per_replica);
+    }
+  }
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableNuma, _In_ OrtSessionOptions* options) {
+  options->value.enable_numa = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableNuma, _In_ OrtSessionOptions* options) {
+  options->value.enable_numa = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetWeightStreamingBufferSize, _In_ OrtSessionOptions* options, size_t buffer_size) {
+  options->value.weight_streaming_buffer_size = buffer_size;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableRunStateCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_run_state_cache = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableRunStateCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_run_state_cache = false;
+  return nullptr;
+}
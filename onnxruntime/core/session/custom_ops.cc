@@ -12,6 +12,9 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/tensor_type_and_shape.h"
+#include "core/platform/threadpool.h"
+
+#include <limits>
 
 ONNXTensorElementDataType MLDataTypeToOnnxRuntimeTensorElementDataType(const onnxruntime::DataTypeImpl* cpp_type);
 
@@ -50,6 +53,48 @@ ORT_API_STATUS_IMPL(OrtKernelContext_GetOutput, _Inout_ OrtKernelContext* contex
   return nullptr;
 };
 
+ORT_API_STATUS_IMPL(OrtKernelContext_GetThreadCount, _In_ const OrtKernelContext* context, _Out_ size_t* out) {
+  const auto* thread_pool = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  *out = thread_pool != nullptr ? static_cast<size_t>(thread_pool->NumThreads()) + 1 : 1;
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_ParallelFor, _In_ OrtKernelContext* context, _In_ void(ORT_API_CALL* fn)(_In_ void* user_data, _In_ size_t index), _In_ size_t total, _In_ void* user_data) {
+  if (total > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "Too many iterations for a parallel for");
+  }
+
+  auto* thread_pool = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (thread_pool == nullptr || total == 1) {
+    for (size_t i = 0; i < total; ++i) {
+      fn(user_data, i);
+    }
+  } else {
+    thread_pool->ParallelFor(static_cast<int32_t>(total), [fn, user_data](int32_t i) { fn(user_data, static_cast<size_t>(i)); });
+  }
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_AllocateTemp, _In_ OrtKernelContext* context, _In_ size_t size, _Outptr_ void** out) {
+  API_IMPL_BEGIN
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetTempSpaceAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  *out = allocator->Alloc(size);
+  return nullptr;
+  API_IMPL_END
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_FreeTemp, _In_ OrtKernelContext* context, _In_ void* p) {
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetTempSpaceAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  allocator->Free(p);
+  return nullptr;
+};
+
 ORT_API_STATUS_IMPL(OrtKernelInfoGetAttribute_string, _In_ const OrtKernelInfo* info, _In_ const char* name, _Out_ char* out, _Inout_ size_t* size) {
   std::string value;
   auto status = reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->GetAttr<std::string>(name, &value);
@@ -88,6 +133,11 @@ constexpr OrtCustomOpApi g_custom_op_api = {
     &OrtKernelContext_GetInput,
     &OrtKernelContext_GetOutputCount,
     &OrtKernelContext_GetOutput,
+
+    &OrtKernelContext_GetThreadCount,
+    &OrtKernelContext_ParallelFor,
+    &OrtKernelContext_AllocateTemp,
+    &OrtKernelContext_FreeTemp,
 };
 
 const OrtCustomOpApi& GetCustomOpApi() { return g_custom_op_api; }
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/session/environment.h"
+#include <thread>
 #include "core/framework/allocatormgr.h"
+#include "core/platform/threadpool.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 #include "onnx/defs/operator_sets.h"
@@ -28,6 +30,36 @@ Status Environment::Create(std::unique_ptr<Environment>& environment) {
   return status;
 }
 
+Status Environment::Create(std::unique_ptr<Environment>& environment, const ThreadingOptions* tp_options) {
+  ORT_RETURN_IF_ERROR(Create(environment));
+  if (tp_options == nullptr) {
+    return Status::OK();
+  }
+
+  int intra_op_num_threads = tp_options->intra_op_num_threads;
+  if (intra_op_num_threads < 0) {
+    intra_op_num_threads = std::thread::hardware_concurrency() / 2;
+  }
+
+  if (intra_op_num_threads > 0) {
+    concurrency::ThreadOptions thread_options;
+    thread_options.affinity = tp_options->intra_op_thread_affinity;
+    environment->intra_op_thread_pool_ = std::make_unique<concurrency::ThreadPool>("ENV_INTRA_OP",
+                                                                                   intra_op_num_threads,
+                                                                                   thread_options);
+  }
+
+  if (tp_options->inter_op_num_threads > 0) {
+    concurrency::ThreadOptions thread_options;
+    thread_options.affinity = tp_options->inter_op_thread_affinity;
+    environment->inter_op_thread_pool_ = std::make_unique<concurrency::ThreadPool>("ENV_INTER_OP",
+                                                                                   tp_options->inter_op_num_threads,
+                                                                                   thread_options);
+  }
+
+  return Status::OK();
+}
+
 Status Environment::Initialize() {
   auto status = Status::OK();
 
@@ -86,6 +118,54 @@ Internal copy node
   return status;
 }
 
+Status Environment::RegisterAllocator(AllocatorPtr allocator) {
+  ORT_RETURN_IF_NOT(allocator != nullptr, "allocator is null");
+
+  std::lock_guard<OrtMutex> lock(shared_allocators_mutex_);
+  for (const auto& registered : shared_allocators_) {
+    if (registered->Info() == allocator->Info()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "An allocator for ", allocator->Info(),
+                             " is already registered.");
+    }
+  }
+
+  shared_allocators_.push_back(std::move(allocator));
+  return Status::OK();
+}
+
+Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, const OrtArenaCfg* arena_cfg) {
+  if (strcmp(mem_info.name, CPU) != 0 || mem_info.device.Type() != OrtDevice::CPU) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Only CPU allocators can be created by the environment. Got ", mem_info);
+  }
+
+  ArenaCfg cfg = arena_cfg == nullptr ? ArenaCfg() : *arena_cfg;
+  DeviceAllocatorRegistrationInfo device_info{mem_info.mem_type,
+                                              [mem_info](int) {
+                                                return std::make_unique<CPUAllocator>(
+                                                    std::make_unique<OrtMemoryInfo>(
+                                                        mem_info.name, OrtDeviceAllocator, mem_info.device,
+                                                        mem_info.id, mem_info.mem_type));
+                                              },
+                                              cfg.max_mem};
+  device_info.arena_extend_strategy = cfg.arena_extend_strategy;
+  device_info.initial_chunk_size_bytes = cfg.initial_chunk_size_bytes;
+
+  AllocatorPtr allocator;
+  if (mem_info.type == OrtArenaAllocator) {
+    allocator = CreateAllocator(device_info, mem_info.id);
+  } else {
+    allocator = device_info.factory(mem_info.id);
+  }
+
+  return RegisterAllocator(std::move(allocator));
+}
+
+std::vector<AllocatorPtr> Environment::GetRegisteredSharedAllocators() const {
+  std::lock_guard<OrtMutex> lock(shared_allocators_mutex_);
+  return shared_allocators_;
+}
+
 Environment::~Environment() {
   ::google::protobuf::ShutdownProtobufLibrary();
 }
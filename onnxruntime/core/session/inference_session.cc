@@ -8,6 +8,7 @@
 #include "core/session/inference_session.h"
 
 #include <memory>
+#include <algorithm>
 #include <sstream>
 #include <unordered_set>
 #include <list>
@@ -30,6 +31,7 @@
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/numa_arena.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/ort_value_name_idx_map.h"
@@ -42,6 +44,8 @@
 #include "core/framework/utils.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/float16_compute_transformer.h"
+#include "core/optimizer/zipmap_elimination.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/providers/cpu/controlflow/utils.h"
@@ -89,37 +93,188 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
-concurrency::ThreadPool* CreateThreadPool(int size) {
+// the optimized model saved with SessionOptions::optimized_model_filepath is tagged with its optimization level and
+// the execution providers it was partitioned for, so that loading it again for them skips the optimizations
+constexpr const char* kOptimizationLevelMetadataKey = "onnxruntime.graph_optimization_level";
+constexpr const char* kExecutionProvidersMetadataKey = "onnxruntime.execution_providers";
+
+std::string GetExecutionProviderTypes(const ExecutionProviders& providers) {
+  std::string types;
+  for (const auto& provider : providers) {
+    if (!types.empty()) {
+      types += ',';
+    }
+    types += provider->Type();
+  }
+  return types;
+}
+
+Env::FileMappingAdvice GetExternalDataAdvice(const SessionOptions& session_options) {
+  Env::FileMappingAdvice advice;
+  advice.prefetch = session_options.prefetch_external_data;
+  advice.huge_pages = session_options.use_huge_pages_for_external_data;
+  return advice;
+}
+
+// the level the model was saved optimized at for the providers, -1 if it wasn't
+int GetSavedOptimizationLevel(const Model& model, const ExecutionProviders& providers) {
+  const auto& metadata = model.MetaData();
+  auto level = metadata.find(kOptimizationLevelMetadataKey);
+  auto saved_providers = metadata.find(kExecutionProvidersMetadataKey);
+  if (level == metadata.end() || saved_providers == metadata.end() ||
+      saved_providers->second != GetExecutionProviderTypes(providers)) {
+    return -1;
+  }
+
+  std::istringstream iss(level->second);
+  int saved_level = -1;
+  iss >> saved_level;
+  return iss.fail() ? -1 : saved_level;
+}
+
+// the provider that all the nodes of the graph are assigned to, if it can capture their executions.
+// nullptr if a node copies data to or from the host or runs a subgraph, as their work isn't all on the device.
+const IExecutionProvider* GetGraphCaptureProvider(const Graph& graph, const ExecutionProviders& providers) {
+  const IExecutionProvider* provider = nullptr;
+  for (const auto& node : graph.Nodes()) {
+    if (node.ContainsSubgraph() || node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost") {
+      return nullptr;
+    }
+
+    const IExecutionProvider* node_provider = providers.Get(node);
+    if (node_provider == nullptr || (provider != nullptr && node_provider != provider)) {
+      return nullptr;
+    }
+    provider = node_provider;
+  }
+
+  return provider != nullptr && provider->SupportsGraphCapture() ? provider : nullptr;
+}
+
+// the most idle states kept by the Run state cache. more are only needed by more concurrent Run calls.
+constexpr size_t kMaxCachedRunStates = 16;
+
+// the loggers of Runs kept for the next Runs with the same run tag and log levels, see CreateLoggerForRun
+constexpr size_t kMaxRunLoggers = 16;
+
+// the session options with a thread pool replica per NUMA node if SessionOptions::enable_numa is set. enable_numa is
+// cleared if the machine has a single node.
+SessionOptions ApplyNumaTopology(const SessionOptions& session_options) {
+  SessionOptions options = session_options;
+  if (!options.enable_numa) {
+    return options;
+  }
+
+  auto nodes = Env::Default().GetNumaNodes();
+  if (nodes.size() < 2) {
+    options.enable_numa = false;
+    return options;
+  }
+
+  if (options.session_thread_pool_size < 0) {
+    size_t node_size = nodes.front().size();
+    for (const auto& node : nodes) {
+      node_size = std::min(node_size, node.size());
+    }
+    options.session_thread_pool_size = std::max(static_cast<int>(node_size / 2), 1);
+  }
+  options.num_thread_pool_replicas = static_cast<int>(nodes.size());
+  options.thread_pool_replica_affinities = std::move(nodes);
+  return options;
+}
+
+// creates the session thread pool of the given replica, see SessionOptions::num_thread_pool_replicas
+concurrency::ThreadPool* CreateThreadPool(const SessionOptions& session_options, size_t replica = 0) {
+  int size = session_options.session_thread_pool_size;
   if (size < 0) size = std::thread::hardware_concurrency() / 2;
-  return size > 0 ? new concurrency::ThreadPool("SESSION", size) : nullptr;
+  if (size <= 0) {
+    return nullptr;
+  }
+
+  concurrency::ThreadOptions thread_options;
+  thread_options.low_latency = session_options.enable_low_latency_threading;
+  thread_options.spin_duration_us = session_options.thread_pool_spin_duration_us;
+  if (replica < session_options.thread_pool_replica_affinities.size()) {
+    thread_options.affinity = session_options.thread_pool_replica_affinities[replica];
+  }
+  return new concurrency::ThreadPool("SESSION", size, thread_options);
+}
+
+// the rows [begin, end) of the first dimension of tensor, sharing its buffer
+OrtValue SliceRows(const Tensor& tensor, int64_t begin, int64_t end) {
+  std::vector<int64_t> dims = tensor.Shape().GetDims();
+  const int64_t row_size = dims[0] == 0 ? 0 : tensor.Shape().Size() / dims[0];
+  dims[0] = end - begin;
+  auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) +
+               begin * row_size * static_cast<int64_t>(tensor.DataType()->Size());
+
+  auto rows = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  OrtValue ort_value;
+  ort_value.Init(rows.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return ort_value;
 }
 
 }  // namespace
 
 InferenceSession::InferenceSession(const SessionOptions& session_options,
                                    logging::LoggingManager* logging_manager)
-    : session_options_{session_options},
+    : InferenceSession(session_options, logging_manager, nullptr, nullptr) {
+}
+
+InferenceSession::InferenceSession(const SessionOptions& session_options,
+                                   logging::LoggingManager* logging_manager,
+                                   concurrency::ThreadPool* external_intra_op_thread_pool,
+                                   concurrency::ThreadPool* external_inter_op_thread_pool)
+    : session_options_{ApplyNumaTopology(session_options)},
       graph_transformation_mgr_{session_options.max_num_graph_transformation_steps},
       logging_manager_{logging_manager},
-      thread_pool_(CreateThreadPool(session_options.session_thread_pool_size)),
+      thread_pool_(session_options.use_per_session_threads
+                       ? CreateThreadPool(session_options_)
+                       : nullptr),
       session_state_(execution_providers_,
                      session_options.enable_mem_pattern && session_options.enable_sequential_execution,
-                     thread_pool_.get()),
+                     session_options.use_per_session_threads ? thread_pool_.get() : external_intra_op_thread_pool),
       insert_cast_transformer_{"CastFloat16Transformer"} {
   ORT_ENFORCE(Environment::IsInitialized(),
               "Environment must be initialized before creating an InferenceSession.");
 
   InitLogger(logging_manager);
 
+  if (!session_options.use_per_session_threads) {
+    session_state_.SetInterOpThreadPool(external_inter_op_thread_pool);
+  } else if (thread_pool_ != nullptr && session_options_.num_thread_pool_replicas > 1) {
+    const auto num_replicas = static_cast<size_t>(session_options_.num_thread_pool_replicas);
+    for (size_t i = 1; i < num_replicas; ++i) {
+      thread_pool_replicas_.emplace_back(CreateThreadPool(session_options_, i));
+    }
+    thread_pool_replica_runs_ = std::make_unique<std::atomic<int>[]>(num_replicas);
+    for (size_t i = 0; i < num_replicas; ++i) {
+      thread_pool_replica_runs_[i] = 0;
+    }
+  }
+
   session_state_.SetDataTransferMgr(&data_transfer_mgr_);
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
   if (session_options.enable_profiling) {
     StartProfiling(session_options.profile_file_prefix);
+    if (session_options.profile_sampling_interval > 0) {
+      session_profiler_.EnableSampling(session_options.profile_sampling_interval);
+    }
+    if (session_options.enable_profiling_hardware_counters) {
+      session_profiler_.EnableHardwareCounters();
+    }
   }
 }
 
 InferenceSession::~InferenceSession() {
+  {
+    // the scheduled Runs use the session until their callback returns
+    std::unique_lock<onnxruntime::OrtMutex> l(async_runs_mutex_);
+    async_runs_done_.wait(l, [this]() { return num_pending_async_runs_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -221,9 +376,7 @@ common::Status InferenceSession::Load(std::function<common::Status(std::shared_p
     status = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Load()");
   }
 
-  if (session_profiler_.IsEnabled()) {
-    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, event_name, tp);
-  }
+  session_profiler_.RecordInitializationPhase(event_name, tp, {{"phase", "model_loading"}});
 
   return status;
 }
@@ -291,21 +444,23 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
 
 common::Status InferenceSession::Load(std::istream& model_istream) {
   auto loader = [this, &model_istream](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    // the Model takes the parsed proto over, so the initializers aren't held twice while the session loads
+    auto model_proto = std::make_unique<ModelProto>();
 
     google::protobuf::io::IstreamInputStream zero_copy_input(&model_istream);
-    const bool result = model_proto.ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+    const bool result = model_proto->ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr);
   };
 
   return Load(loader, "model_loading_istream");
@@ -313,21 +468,22 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
 
 common::Status InferenceSession::Load(const void* model_data, int model_data_len) {
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    auto model_proto = std::make_unique<ModelProto>();
 
-    const bool result = model_proto.ParseFromArray(model_data, model_data_len);
+    const bool result = model_proto->ParseFromArray(model_data, model_data_len);
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
 
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr);
   };
 
   return Load(loader, "model_loading_array");
@@ -345,21 +501,48 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // 3. do node placement according to kernel definition
   // 4. insert copy nodes
   // 5. insert cast nodes.
+  // float nodes are converted to float16 before the cast nodes are inserted, if enabled.
+
+  // the ZipMap nodes producing graph outputs are removed first if requested, since that changes the output types.
+  if (session_options_.enable_zipmap_elimination) {
+    bool zipmap_removed = false;
+    ORT_RETURN_IF_ERROR(ZipMapElimination().Apply(graph, zipmap_removed));
+  }
 
   // first apply global(execution provider independent),  level 1(default/system/basic) graph to graph optimizations
-  ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
+  ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1, &session_profiler_));
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  GraphPartitioner partitioner(kernel_registry_manager, providers,
+                               session_options_.enable_cost_based_partitioning
+                                   ? &session_options_.partitioning_cost_model
+                                   : nullptr,
+                               &session_profiler_);
+  auto tp = session_profiler_.StartTime();
   ORT_RETURN_IF_ERROR(partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr()));
+  session_profiler_.RecordInitializationPhase("graph_partitioning", tp, {{"phase", "graph_partitioning"}});
 
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
   for (int i = static_cast<int>(TransformerLevel::Level1); i < static_cast<int>(TransformerLevel::MaxTransformerLevel); i++) {
-    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i)));
+    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i),
+                                                                &session_profiler_));
   }
 
+  tp = session_profiler_.StartTime();
   bool modified = false;
+  if (session_options_.weight_compression != WeightCompression::kNone) {
+    WeightCompressionTransformer weight_compression_transformer{session_options_.weight_compression,
+                                                                {onnxruntime::kCpuExecutionProvider}};
+    ORT_RETURN_IF_ERROR(weight_compression_transformer.Apply(graph, modified));
+  }
+
+  if (session_options_.enable_float16_compute) {
+    Float16ComputeTransformer float16_compute_transformer{kernel_registry_manager,
+                                                          {onnxruntime::kCudaExecutionProvider}};
+    ORT_RETURN_IF_ERROR(float16_compute_transformer.Apply(graph, modified));
+  }
+
   // Insert cast node/s.
   ORT_RETURN_IF_ERROR(insert_cast_transformer.Apply(graph, modified));
 
@@ -385,6 +568,7 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // Insert copy node/s.
   MemcpyTransformer copy_transformer{provider_types, kernel_registry_manager};
   ORT_RETURN_IF_ERROR(copy_transformer.Apply(graph, modified));
+  session_profiler_.RecordInitializationPhase("cast_and_copy_insertion", tp, {{"phase", "cast_and_copy_insertion"}});
 
   return common::Status::OK();
 }
@@ -401,6 +585,7 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
       auto subgraph_session_state = std::make_unique<SessionState>(execution_providers_,
                                                                    session_state.GetEnableMemoryPattern(),
                                                                    session_state.GetThreadPool());
+      subgraph_session_state->SetInterOpThreadPool(session_state.GetInterOpThreadPool());
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
       // Pass data transfer manager to subgraph.
@@ -434,37 +619,59 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
     }
 
     for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
-      auto& name = entry.first;
+      const std::string& name = entry.first;
       Graph& subgraph = *entry.second;
 
       SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), name);
       ORT_ENFORCE(subgraph_session_state, "CreateSubgraphSessionState should have created an entry earlier.");
 
-      // setup everything required to execute the subgraph and save it in subgraph_session_state
-      SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
-                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_);
-
-      const auto implicit_inputs = node.ImplicitInputDefs();
-      ORT_RETURN_IF_ERROR(initializer.CreatePlan(&node, &implicit_inputs,
-                                                 session_options_.enable_sequential_execution));
-
-      // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
-      //                                                   &*subgraph_info.session_state);
-
-      // setup all the info for handling the feeds and fetches used in subraph execution
-      auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
-      auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(session_state, name, *subgraph_session_state));
-
-      // recurse
-      ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(subgraph, *subgraph_session_state));
+      if (session_options_.enable_lazy_subgraph_initialization) {
+        // the node initializes the subgraph when it first gets its SessionState.
+        // the session owns the graphs and SessionState instances, so they outlive the initializer.
+        subgraph_session_state->SetDeferredInitializer(
+            [this, &node, name, &subgraph, &session_state, subgraph_session_state]() {
+              return InitializeSubgraphSession(node, name, subgraph, session_state, *subgraph_session_state);
+            });
+      } else {
+        ORT_RETURN_IF_ERROR(InitializeSubgraphSession(node, name, subgraph, session_state, *subgraph_session_state));
+      }
     }
   }
 
   return Status::OK();
 }
 
+common::Status InferenceSession::InitializeSubgraphSession(Node& node, const std::string& attribute_name,
+                                                           Graph& subgraph, SessionState& session_state,
+                                                           SessionState& subgraph_session_state) {
+  // setup everything required to execute the subgraph and save it in subgraph_session_state
+  SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
+                                      subgraph_session_state, execution_providers_, kernel_registry_manager_,
+                                      nullptr, &session_profiler_, GetExternalDataAdvice(session_options_));
+
+  const auto implicit_inputs = node.ImplicitInputDefs();
+  ORT_RETURN_IF_ERROR(initializer.CreatePlan(&node, &implicit_inputs,
+                                             session_options_.enable_sequential_execution,
+                                             session_options_.enable_static_memory_planning));
+
+  // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
+  //                                                   &*subgraph_info.session_state);
+
+  // setup all the info for handling the feeds and fetches used in subraph execution
+  auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
+  ORT_ENFORCE(p_op_kernel);
+  auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+  ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(session_state, attribute_name,
+                                                                     subgraph_session_state));
+
+  // recurse
+  return InitializeSubgraphSessions(subgraph, subgraph_session_state);
+}
+
+void InferenceSession::UseSharedAllocators(std::vector<AllocatorPtr> shared_allocators) {
+  shared_allocators_ = std::move(shared_allocators);
+}
+
 common::Status InferenceSession::Initialize() {
   Status status = Status::OK();
   auto tp = session_profiler_.StartTime();
@@ -486,10 +693,35 @@ common::Status InferenceSession::Initialize() {
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.enable_arena_thread_cache = session_options_.enable_cpu_mem_arena_thread_cache;
+      epi.use_huge_pages = session_options_.enable_cpu_mem_arena_huge_pages;
+      epi.arena_cfg = session_options_.cpu_mem_arena_cfg;
+      if (session_options_.enable_numa) {
+        epi.numa_nodes = Env::Default().GetNumaNodes();
+      }
+      if (session_options_.enable_kernel_tuning || !session_options_.kernel_tuning_cache_filepath.empty()) {
+        kernel_tuning_cache_ = std::make_shared<KernelTuningCache>(session_options_.enable_kernel_tuning);
+        if (!session_options_.kernel_tuning_cache_filepath.empty()) {
+          ORT_RETURN_IF_ERROR(kernel_tuning_cache_->Load(session_options_.kernel_tuning_cache_filepath));
+        }
+        epi.kernel_tuning_cache = kernel_tuning_cache_;
+      }
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
 
+    if (session_options_.use_env_allocators) {
+      for (const auto& allocator : shared_allocators_) {
+        for (auto& xp : execution_providers_) {
+          if (xp->ReplaceAllocator(allocator)) {
+            LOGS(*session_logger_, INFO) << "Using shared allocator " << allocator->Info() << " for " << xp->Type();
+          }
+        }
+      }
+    }
+
+#ifndef CUDA_API_PER_THREAD_DEFAULT_STREAM
+    // the CUDA nodes of all threads would be serialized on the legacy default stream.
     if (!session_options_.enable_sequential_execution &&
         execution_providers_.Get(onnxruntime::kCudaExecutionProvider)) {
       LOGS(*session_logger_, ERROR) << "Parallel execution is currently not supported "
@@ -498,9 +730,18 @@ common::Status InferenceSession::Initialize() {
                             "Parallel execution is currently not supported "
                             "for the registered CUDA Execution Provider.");
     }
+#endif
 
-    // add predefined transformers
-    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
+    // add predefined transformers, unless the model was saved already optimized for the same execution providers
+    const int saved_optimization_level = GetSavedOptimizationLevel(*model_, execution_providers_);
+    if (transformers_to_enable_.empty() &&
+        saved_optimization_level >= static_cast<int>(session_options_.graph_optimization_level)) {
+      LOGS(*session_logger_, INFO) << "The model was saved optimized at level " << saved_optimization_level
+                                   << ", skipping the graph optimizations.";
+    } else {
+      AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
+                                transformers_to_enable_);
+    }
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
@@ -512,10 +753,14 @@ common::Status InferenceSession::Initialize() {
     // The 1st ones should have already been registered via session-level API into KernelRegistryManager.
     //
     // Register 2nd registries into KernelRegistryManager.
+    auto phase_tp = session_profiler_.StartTime();
     ORT_RETURN_IF_ERROR(kernel_registry_manager_.RegisterKernels(execution_providers_));
+    session_profiler_.RecordInitializationPhase("kernel_registration", phase_tp, {{"phase", "kernel_registration"}});
 
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
-                                                session_state_, execution_providers_, kernel_registry_manager_);
+                                                session_state_, execution_providers_, kernel_registry_manager_,
+                                                &session_options_.initializers_to_share_map, &session_profiler_,
+                                                GetExternalDataAdvice(session_options_));
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
@@ -527,22 +772,83 @@ common::Status InferenceSession::Initialize() {
                                        session_state_));
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
+    phase_tp = session_profiler_.StartTime();
     ORT_RETURN_IF_ERROR(graph.Resolve());
+    session_profiler_.RecordInitializationPhase("graph_resolve", phase_tp, {{"phase", "graph_resolve"}});
 
     if (!session_options_.optimized_model_filepath.empty()) {
       if (session_options_.graph_optimization_level < TransformerLevel::Level3) {
-        // Serialize optimized ONNX model.
+        // Serialize optimized ONNX model, tagged for the next loads to skip the optimizations.
+        // a model loaded already optimized stays as optimized as it was.
+        const int level = std::max(saved_optimization_level,
+                                   static_cast<int>(session_options_.graph_optimization_level));
+        model_->SetMetaDataValue(kOptimizationLevelMetadataKey, std::to_string(level));
+        model_->SetMetaDataValue(kExecutionProvidersMetadataKey, GetExecutionProviderTypes(execution_providers_));
+        phase_tp = session_profiler_.StartTime();
         ORT_RETURN_IF_ERROR(Model::Save(*model_, session_options_.optimized_model_filepath));
+        session_profiler_.RecordInitializationPhase("optimized_model_saving", phase_tp,
+                                                    {{"phase", "optimized_model_saving"}});
       } else {
         LOGS(*session_logger_, WARNING) << "Serializing Optimized ONNX model with Graph Optimization"
                                            " level greater than 2 is not supported.";
       }
     }
 
-    ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.enable_sequential_execution));
+    ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.enable_sequential_execution,
+                                                       session_options_.enable_static_memory_planning,
+                                                       session_options_.weight_streaming_buffer_size));
+    session_state_.SetDeviceOutputs(session_options_.device_outputs);
+
+    // the streamed weights are copied as the nodes run, which replaying a captured graph skips
+    if (session_options_.enable_graph_capture && session_options_.enable_sequential_execution &&
+        session_state_.GetWeightStreaming() == nullptr) {
+      session_state_.SetGraphCaptureProvider(GetGraphCaptureProvider(graph, execution_providers_));
+      if (session_state_.GetGraphCaptureProvider() == nullptr) {
+        LOGS(*session_logger_, WARNING) << "Graph capture is disabled: the nodes aren't all assigned to one execution "
+                                           "provider that supports it, or some copy data with the host.";
+      }
+    }
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
+
+    // the kernels are created now, so the cache holds the implementations they chose
+    if (kernel_tuning_cache_ && kernel_tuning_cache_->IsTuningEnabled() &&
+        !session_options_.kernel_tuning_cache_filepath.empty()) {
+      ORT_RETURN_IF_ERROR(kernel_tuning_cache_->Save(session_options_.kernel_tuning_cache_filepath));
+    }
+
+    // the providers recording their device work start with the profiler, when profiling is enabled or later
+    for (auto& xp : execution_providers_) {
+      auto ep_profiler = xp->GetProfiler();
+      if (ep_profiler != nullptr) {
+        session_profiler_.AddEpProfiler(std::move(ep_profiler));
+      }
+    }
+
+    if (session_options_.enable_metrics) {
+      session_metrics_ = std::make_unique<SessionMetrics>(session_options_.session_logid, execution_providers_);
+      session_state_.SetMetrics(session_metrics_.get());
+    }
+
+    if (session_options_.num_pipeline_stages > 1 && session_options_.enable_sequential_execution) {
+      // the stages run the compiled steps without copying the streamed weights ahead of their nodes
+      if (session_state_.GetWeightStreaming() != nullptr) {
+        LOGS(*session_logger_, WARNING) << "Pipelined execution is disabled: the session streams its weights.";
+      } else if (session_state_.GetCompiledExecutionPlan() != nullptr) {
+        // stage i runs on replica i % num_thread_pool_replicas, so each stage has its own cores if there are enough
+        std::vector<concurrency::ThreadPool*> stage_thread_pools;
+        for (size_t i = 0; i < static_cast<size_t>(session_options_.num_pipeline_stages); ++i) {
+          const size_t replica = i % (thread_pool_replicas_.size() + 1);
+          stage_thread_pools.push_back(replica == 0 ? session_state_.GetThreadPool()
+                                                    : thread_pool_replicas_[replica - 1].get());
+        }
+        execution_pipeline_ = std::make_unique<ExecutionPipeline>(session_state_, stage_thread_pools);
+      } else {
+        LOGS(*session_logger_, WARNING) << "Pipelined execution is disabled: the execution plan of the session "
+                                           "can't be compiled.";
+      }
+    }
     is_inited_ = true;
 
     LOGS(*session_logger_, INFO) << "Session successfully initialized.";
@@ -557,9 +863,7 @@ common::Status InferenceSession::Initialize() {
     LOGS(*session_logger_, ERROR) << status.ErrorMessage();
   }
 
-  if (session_profiler_.IsEnabled()) {
-    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_initialization", tp);
-  }
+  session_profiler_.RecordInitializationPhase("session_initialization", tp, {{"phase", "session_initialization"}});
   return status;
 }
 
@@ -567,6 +871,97 @@ int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
 
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      // GetAllocators only hands out const pointers, so look the allocator up again to be able to shrink it.
+      AllocatorPtr alloc = xp->GetAllocator(allocator->Info().id, allocator->Info().mem_type);
+      auto* arena = dynamic_cast<IArenaAllocator*>(alloc.get());
+      if (arena != nullptr) {
+        ORT_RETURN_IF_ERROR(arena->Shrink());
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ReleaseCachedMemory(std::unique_ptr<ExecutionFrame>* cached_frame) {
+  if (cached_frame != nullptr) {
+    cached_frame->reset();
+  }
+
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(cached_run_states_mutex_);
+    for (auto& state : cached_run_states_) {
+      state->frame.reset();
+    }
+  }
+
+  return ShrinkMemoryArenas();
+}
+
+common::Status InferenceSession::Warmup(
+    const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& shape_profiles) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  std::vector<std::string> output_names;
+  for (const auto* output : output_def_list_) {
+    output_names.push_back(output->Name());
+  }
+
+  AllocatorPtr allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  RunOptions run_options;
+  run_options.run_tag = "warmup";
+
+  for (const auto& profile : shape_profiles) {
+    for (const auto& input_shape : profile) {
+      if (required_inputs_.find(input_shape.first) == required_inputs_.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup shape given for ", input_shape.first,
+                               ", which is not a required input of the model.");
+      }
+    }
+
+    NameMLValMap feeds;
+    for (const auto& input_name : required_inputs_) {
+      const auto& input_def = input_def_map_.at(input_name);
+      if (!input_def.ml_data_type->IsTensorType()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup only creates tensor inputs, and input ",
+                               input_name, " is not a tensor.");
+      }
+
+      auto profile_shape = profile.find(input_name);
+      TensorShape shape = profile_shape != profile.end() ? TensorShape(profile_shape->second) : input_def.tensor_shape;
+      for (size_t i = 0; i < shape.NumDimensions(); ++i) {
+        if (shape[i] < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup needs the shape of input ", input_name,
+                                 ", whose shape in the model is ", input_def.tensor_shape, ".");
+        }
+      }
+
+      auto tensor = std::make_unique<Tensor>(input_def.ml_data_type->AsTensorType()->GetElementType(), shape, allocator);
+      if (!tensor->IsDataTypeString() && tensor->SizeInBytes() > 0) {
+        memset(tensor->MutableDataRaw(), 0, tensor->SizeInBytes());
+      }
+      OrtValue value;
+      value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      feeds.emplace(input_name, std::move(value));
+    }
+
+    std::vector<OrtValue> fetches;
+    ORT_RETURN_IF_ERROR(Run(run_options, feeds, output_names, &fetches));
+  }
+
+  LOGS(*session_logger_, INFO) << "Session warmed up with " << shape_profiles.size() << " shape profiles.";
+  return Status::OK();
+}
+
 const std::vector<std::string>& InferenceSession::GetRegisteredProviderTypes() const {
   return execution_providers_.GetIds();
 }
@@ -640,29 +1035,51 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
                              "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
-                               feed_name, " is not expected to be of type tensor.");
-      }
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_name, feeds[i], iter->second.ml_data_type, iter->second.tensor_shape));
+  }
+
+  return Status::OK();
+}
 
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
+common::Status InferenceSession::ValidateInputs(const PreparedRun& prepared_run,
+                                                const std::vector<OrtValue>& feeds) const {
+  const auto& feed_names = prepared_run.GetFeedNames();
+  if (feed_names.size() != feeds.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Size mismatch: the prepared run has ",
+                           feed_names.size(), " feeds, but feeds has ",
+                           feeds.size(), " elements.");
+  }
 
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_names[i], feeds[i], prepared_run.feed_types_[i],
+                                      *prepared_run.feed_shapes_[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, const OrtValue& feed,
+                                               MLDataType expected_type, const TensorShape& expected_shape) const {
+  if (feed.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
+                             feed_name, " is not expected to be of type tensor.");
+    }
+
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = feed.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = feed.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
     }
+  } else {
+    auto input_type = feed.Type();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
   }
 
   return Status::OK();
@@ -700,24 +1117,253 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
   return common::Status::OK();
 }
 
+bool InferenceSession::UseRunStateCache() const {
+  // the frame of a captured graph must be kept, as the graph refers to its buffers
+  return session_options_.enable_sequential_execution &&
+         ((session_options_.enable_run_state_cache && utils::HaveCpuExecutionProvidersOnly(execution_providers_)) ||
+          session_state_.GetGraphCaptureProvider() != nullptr);
+}
+
 Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
                              const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                              std::vector<OrtValue>* p_fetches) {
+  return Run(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
+}
+
+std::unordered_map<size_t, IExecutor::CustomAllocator> InferenceSession::CreateFetchAllocators(
+    const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+    const OutputAllocator& output_allocator) const {
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  const auto& allocation_plan = session_state_.GetExecutionPlan()->allocation_plan;
+
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    if (!fetches.empty() && fetches[i].IsAllocated()) {
+      continue;
+    }
+
+    int ort_value_idx;
+    if (!session_state_.GetOrtValueNameIdxMap().GetIdx(output_names[i], ort_value_idx).IsOK()) {
+      continue;
+    }
+
+    // the buffers of the caller are in CPU memory, so outputs that are written on a device are left to the session
+    const auto& per_alloc_plan = allocation_plan[ort_value_idx];
+    const OrtMemoryInfo& location = per_alloc_plan.location;
+    if (per_alloc_plan.value_type == nullptr || !per_alloc_plan.value_type->IsTensorType() ||
+        location.device.Type() != OrtDevice::CPU || location.device.MemType() != OrtDevice::MemType::DEFAULT) {
+      continue;
+    }
+
+    // strings are constructed by the allocator of the tensor, so they can't be written into a raw buffer
+    const auto* element_type = static_cast<const TensorTypeBase*>(per_alloc_plan.value_type)->GetElementType();
+    if (element_type == DataTypeImpl::GetType<std::string>()) {
+      continue;
+    }
+
+    fetch_allocators[i] = [this, i, element_type, location, &output_allocator](const TensorShape& shape,
+                                                                                OrtValue& ort_value) {
+      const int64_t num_elements = shape.Size();
+      size_t size;
+      if (num_elements < 0 ||
+          !IAllocator::CalcMemSizeForArray(static_cast<size_t>(num_elements), element_type->Size(), &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid shape ", shape, " for output ", i);
+      }
+
+      std::unique_ptr<Tensor> tensor;
+      void* buffer = output_allocator(i, element_type, shape, size);
+      if (buffer != nullptr) {
+        tensor = std::make_unique<Tensor>(element_type, shape, buffer, location);
+      } else {
+        tensor = std::make_unique<Tensor>(element_type, shape, utils::GetAllocator(session_state_, location));
+      }
+
+      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+      ort_value.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+      return Status::OK();
+    };
+  }
+
+  return fetch_allocators;
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                             std::vector<OrtValue>* p_fetches, const OutputAllocator& output_allocator) {
   auto tp = session_profiler_.StartTime();
-  Status retval = Status::OK();
 
-  try {
-    if (!is_inited_) {
-      LOGS(*session_logger_, ERROR) << "Session was not initialized";
-      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+  ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  if (output_allocator) {
+    fetch_allocators = CreateFetchAllocators(output_names, *p_fetches, output_allocator);
+  }
+
+  const int64_t micro_batched_size = GetMicroBatchedSize(run_options, feed_names, feeds);
+  if (micro_batched_size > 0) {
+    return RunInMicroBatches(run_options, feed_names, feeds, output_names, p_fetches, fetch_allocators,
+                             micro_batched_size);
+  }
+
+  std::unique_ptr<CachedRunState> cached_run_state;
+  std::unique_ptr<FeedsFetchesManager> owned_feeds_fetches_manager;
+  if (UseRunStateCache() && fetch_allocators.empty()) {
+    ORT_RETURN_IF_ERROR(AcquireCachedRunState(feed_names, output_names, cached_run_state));
+  } else {
+    ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                                    owned_feeds_fetches_manager));
+  }
+
+  FeedsFetchesManager& feeds_fetches_manager = cached_run_state ? *cached_run_state->feeds_fetches_manager
+                                                                : *owned_feeds_fetches_manager;
+
+  auto retval = RunImpl(run_options, feeds_fetches_manager, feeds, p_fetches,
+                        cached_run_state ? &cached_run_state->frame : nullptr, tp, fetch_allocators);
+
+  // a frame that failed mid-execution may hold values of that Run, and is reset when reused
+  if (cached_run_state) {
+    ReleaseCachedRunState(std::move(cached_run_state));
+  }
+
+  return retval;
+}
+
+int64_t InferenceSession::GetMicroBatchedSize(const RunOptions& run_options,
+                                              const std::vector<std::string>& feed_names,
+                                              const std::vector<OrtValue>& feeds) const {
+  if (run_options.max_micro_batch_size <= 0 || feeds.empty()) {
+    return 0;
+  }
+
+  int64_t batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return 0;
+    }
+
+    const auto& shape = feeds[i].Get<Tensor>().Shape();
+    if (shape.NumDimensions() == 0 || (batch_size >= 0 && shape[0] != batch_size)) {
+      return 0;
+    }
+    batch_size = shape[0];
+
+    // a first dimension the model fixes can't be split
+    auto input_def = input_def_map_.find(feed_names[i]);
+    if (input_def != input_def_map_.end() && input_def->second.tensor_shape.NumDimensions() > 0 &&
+        input_def->second.tensor_shape[0] >= 0) {
+      return 0;
+    }
+  }
+
+  return batch_size > run_options.max_micro_batch_size ? batch_size : 0;
+}
+
+Status InferenceSession::RunInMicroBatches(
+    const RunOptions& run_options, const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+    const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators, int64_t batch_size) {
+  std::vector<OrtValue> fetches = p_fetches->empty() ? std::vector<OrtValue>(output_names.size()) : *p_fetches;
+  std::vector<OrtValue> micro_batch_feeds(feeds.size());
+
+  for (int64_t begin = 0; begin < batch_size; begin += run_options.max_micro_batch_size) {
+    const int64_t end = std::min(begin + run_options.max_micro_batch_size, batch_size);
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      micro_batch_feeds[i] = SliceRows(feeds[i].Get<Tensor>(), begin, end);
+    }
+
+    // the micro-batch isn't larger than max_micro_batch_size, so it isn't split again, and Runs on the execution
+    // frame that the Run state cache keeps for these feeds and outputs
+    std::vector<OrtValue> micro_batch_fetches;
+    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, micro_batch_feeds, output_names, &micro_batch_fetches, nullptr));
+
+    for (size_t i = 0; i < output_names.size(); ++i) {
+      if (!micro_batch_fetches[i].IsTensor()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", output_names[i],
+                               " is not a tensor, so the Run can't be split into micro-batches.");
+      }
+
+      const auto& micro_batch_output = micro_batch_fetches[i].Get<Tensor>();
+      std::vector<int64_t> dims = micro_batch_output.Shape().GetDims();
+      if (dims.empty() || dims[0] != end - begin) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", output_names[i], " of shape ",
+                               micro_batch_output.Shape(), " doesn't keep the ", end - begin,
+                               " rows of its micro-batch in its first dimension, so the Run can't be split into "
+                               "micro-batches.");
+      }
+      dims[0] = batch_size;
+      const TensorShape shape(dims);
+
+      if (!fetches[i].IsAllocated()) {
+        auto fetch_allocator = fetch_allocators.find(i);
+        if (fetch_allocator != fetch_allocators.end()) {
+          ORT_RETURN_IF_ERROR(fetch_allocator->second(shape, fetches[i]));
+        } else {
+          auto tensor = std::make_unique<Tensor>(micro_batch_output.DataType(), shape,
+                                                 utils::GetAllocator(session_state_, micro_batch_output.Location()));
+          auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+          fetches[i].Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+        }
+      }
+
+      auto& output = *fetches[i].GetMutable<Tensor>();
+      if (output.Shape() != shape || output.DataType() != micro_batch_output.DataType()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", output_names[i], " of shape ",
+                               output.Shape(), " doesn't match the shape ", shape, " of the batch.");
+      }
+
+      OrtValue rows = SliceRows(output, begin, end);
+      auto& rows_tensor = *rows.GetMutable<Tensor>();
+      if (micro_batch_output.IsDataTypeString()) {
+        std::copy_n(micro_batch_output.Data<std::string>(), micro_batch_output.Shape().Size(),
+                    rows_tensor.MutableData<std::string>());
+      } else {
+        ORT_RETURN_IF_ERROR(data_transfer_mgr_.CopyTensor(micro_batch_output, rows_tensor));
+      }
     }
+  }
 
-    ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+  *p_fetches = std::move(fetches);
+  return Status::OK();
+}
 
-    FeedsFetchesInfo info(feed_names, output_names, session_state_.GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) {
+  auto tp = session_profiler_.StartTime();
+
+  if (prepared_run.session_ != this) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "The run was prepared by another session.");
+  }
 
+  ORT_RETURN_IF_ERROR(ValidateInputs(prepared_run, feeds));
+
+  if (p_fetches == nullptr) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  const size_t num_outputs = prepared_run.GetOutputNames().size();
+  if (!p_fetches->empty() && p_fetches->size() != num_outputs) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector incorrectly sized: the prepared run has ",
+                           num_outputs, " outputs, p_fetches->size(): ", p_fetches->size());
+  }
+
+  return RunImpl(run_options, *prepared_run.feeds_fetches_manager_, feeds, p_fetches,
+                 UseRunStateCache() ? &prepared_run.frame_ : nullptr, tp);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                 const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches,
+                                 std::unique_ptr<ExecutionFrame>* cached_frame, TimePoint tp,
+                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  Status retval = Status::OK();
+  size_t replica = 0;
+  concurrency::ThreadPool* replica_thread_pool = nullptr;
+
+  try {
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
@@ -734,13 +1380,58 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     // info all execution providers InferenceSession:Run started
     // TODO: only call OnRunStart for all providers in-use
     for (auto& xp : execution_providers_) {
-      ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
+      ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart(run_options));
     }
 
+    // the pipeline runs each stage on its own thread pool, and records nothing per node
+    const bool use_pipeline = execution_pipeline_ != nullptr && fetch_allocators.empty() &&
+                              session_metrics_ == nullptr && !session_profiler_.IsEnabled();
+
+    // run on the thread pool replica with the fewest Runs in progress
+    if (!thread_pool_replicas_.empty() && !use_pipeline) {
+      for (size_t i = 1; i <= thread_pool_replicas_.size(); ++i) {
+        if (thread_pool_replica_runs_[i] < thread_pool_replica_runs_[replica]) {
+          replica = i;
+        }
+      }
+      ++thread_pool_replica_runs_[replica];
+      replica_thread_pool = replica == 0 ? thread_pool_.get() : thread_pool_replicas_[replica - 1].get();
+    }
+
+    // with a replica per NUMA node, the Run allocates from the arena of the node of its replica
+    NumaArena::ScopedNode numa_node(session_options_.enable_numa && replica_thread_pool != nullptr
+                                        ? static_cast<int>(replica)
+                                        : -1);
+
     // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(
-        utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                            session_options_.enable_sequential_execution, run_options.terminate, run_logger));
+    auto execute_graph = [&]() {
+      if (use_pipeline) {
+        return utils::ExecuteGraphWithPipeline(session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                               *execution_pipeline_, run_options.terminate, run_logger);
+      }
+      if (fetch_allocators.empty()) {
+        return utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                   session_options_.enable_sequential_execution, run_options.terminate, run_logger,
+                                   cached_frame, replica_thread_pool);
+      }
+      return utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches, fetch_allocators,
+                                 session_options_.enable_sequential_execution, run_options.terminate, run_logger,
+                                 replica_thread_pool);
+    };
+
+    // the fetches the caller pre-allocated, to start a retry from
+    const std::vector<OrtValue> preallocated_fetches = *p_fetches;
+    ORT_CHECK_AND_SET_RETVAL(execute_graph());
+
+    // running out of memory may only be due to the memory this session keeps between Runs, so give it back
+    // and try once more before failing.
+    if (retval.Code() == common::OUT_OF_MEMORY) {
+      LOGS(*session_logger_, WARNING) << "Run ran out of memory, retrying after releasing cached memory. "
+                                      << retval.ErrorMessage();
+      *p_fetches = preallocated_fetches;
+      retval = ReleaseCachedMemory(cached_frame);
+      ORT_CHECK_AND_SET_RETVAL(execute_graph());
+    }
 
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
@@ -748,19 +1439,183 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
   }
 
+  if (replica_thread_pool != nullptr) {
+    --thread_pool_replica_runs_[replica];
+  }
+
   // info all execution providers InferenceSession:Run ended
   for (auto& xp : execution_providers_) {
-    ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
+    ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd(run_options));
   }
 
-  --current_num_runs_;
-  if (session_profiler_.IsEnabled()) {
+  if (--current_num_runs_ == 0 && session_options_.enable_mem_arena_shrink_after_run) {
+    ORT_CHECK_AND_SET_RETVAL(ShrinkMemoryArenas());
+  }
+
+  if (session_metrics_ != nullptr) {
+    session_metrics_->RecordRun(std::chrono::high_resolution_clock::now() - tp, !retval.IsOK());
+  }
+
+  if (session_profiler_.IsEnabled() && !session_profiler_.IsSampling()) {
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
   }
 
   return retval;
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!callback) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  concurrency::ThreadPool* thread_pool = session_state_.GetInterOpThreadPool();
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(async_runs_mutex_);
+    if (thread_pool == nullptr && session_options_.use_per_session_threads) {
+      // one thread per thread pool replica, so the scheduled Runs can use all of them like concurrent Runs would
+      if (run_async_thread_pool_ == nullptr) {
+        run_async_thread_pool_ = std::make_unique<concurrency::ThreadPool>(
+            "RUN_ASYNC", std::max(session_options_.num_thread_pool_replicas, 1));
+      }
+      thread_pool = run_async_thread_pool_.get();
+    }
+
+    if (thread_pool == nullptr) {
+      return Status(common::ONNXRUNTIME, common::FAIL,
+                    "RunAsync requires an inter-op thread pool when the session uses the global thread pools.");
+    }
+    ++num_pending_async_runs_;
+  }
+
+  // the thread pool copies its tasks, so the captured values are moved into a shared one
+  struct AsyncRun {
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+
+  auto async_run = std::make_shared<AsyncRun>();
+  async_run->feed_names = std::move(feed_names);
+  async_run->feeds = std::move(feeds);
+  async_run->output_names = std::move(output_names);
+  async_run->fetches = std::move(fetches);
+  async_run->callback = std::move(callback);
+
+  thread_pool->Schedule([this, &run_options, async_run]() {
+    Status status;
+    try {
+      status = Run(run_options, async_run->feed_names, async_run->feeds, async_run->output_names,
+                   &async_run->fetches);
+    } catch (const std::exception& e) {
+      status = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+    }
+
+    try {
+      async_run->callback(status, async_run->fetches);
+    } catch (const std::exception& e) {
+      LOGS(*session_logger_, ERROR) << "RunAsync callback threw an exception: " << e.what();
+    } catch (...) {
+      LOGS(*session_logger_, ERROR) << "RunAsync callback threw an unknown exception";
+    }
+
+    // release the values before the session can be destroyed
+    async_run->feeds.clear();
+    async_run->fetches.clear();
+    async_run->callback = nullptr;
+
+    std::lock_guard<onnxruntime::OrtMutex> l(async_runs_mutex_);
+    if (--num_pending_async_runs_ == 0) {
+      async_runs_done_.notify_all();
+    }
+  });
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                            const std::vector<std::string>& output_names,
+                                            std::unique_ptr<PreparedRun>& prepared_run) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  if (output_names.empty()) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  for (const auto& name : output_names) {
+    if (model_output_names_.find(name) == model_output_names_.end()) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Invalid Output Name:" + name);
+    }
+  }
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<PreparedRun> run{new PreparedRun()};
+  run->session_ = this;
+  run->feed_types_.reserve(feed_names.size());
+  run->feed_shapes_.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+
+    run->feed_types_.push_back(iter->second.ml_data_type);
+    run->feed_shapes_.push_back(&iter->second.tensor_shape);
+  }
+
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                                  run->feeds_fetches_manager_));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state_, *run->feeds_fetches_manager_));
+
+  prepared_run = std::move(run);
+  return Status::OK();
+}
+
+PreparedRun::~PreparedRun() = default;
+
+const std::vector<std::string>& PreparedRun::GetFeedNames() const {
+  return feeds_fetches_manager_->GetFeedsFetchesInfo().feed_names;
+}
+
+const std::vector<std::string>& PreparedRun::GetOutputNames() const {
+  return feeds_fetches_manager_->GetFeedsFetchesInfo().output_names;
+}
+
+common::Status InferenceSession::AcquireCachedRunState(const std::vector<std::string>& feed_names,
+                                                       const std::vector<std::string>& output_names,
+                                                       std::unique_ptr<CachedRunState>& state) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(cached_run_states_mutex_);
+    for (auto it = cached_run_states_.begin(), end = cached_run_states_.end(); it != end; ++it) {
+      const auto& info = (*it)->feeds_fetches_manager->GetFeedsFetchesInfo();
+      if (info.feed_names == feed_names && info.output_names == output_names) {
+        state = std::move(*it);
+        // order doesn't matter, so avoid shifting the other entries
+        *it = std::move(cached_run_states_.back());
+        cached_run_states_.pop_back();
+        return Status::OK();
+      }
+    }
+  }
+
+  state = std::make_unique<CachedRunState>();
+  return FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                     state->feeds_fetches_manager);
+}
+
+void InferenceSession::ReleaseCachedRunState(std::unique_ptr<CachedRunState> state) {
+  std::lock_guard<onnxruntime::OrtMutex> l(cached_run_states_mutex_);
+  if (cached_run_states_.size() < kMaxCachedRunStates) {
+    cached_run_states_.push_back(std::move(state));
+  }
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -823,6 +1678,27 @@ std::pair<common::Status, const OutputDefList*> InferenceSession::GetModelOutput
   return std::make_pair(common::Status::OK(), &output_def_list_);
 }
 
+common::Status InferenceSession::GetCpuInitializers(
+    std::unordered_map<std::string, const OrtValue*>& initializers) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  const auto& initialized_tensors = session_state_.GetInitializedTensors();
+  for (const auto& entry : session_state_.GetOrtValueNameIdxMap()) {
+    auto it = initialized_tensors.find(entry.second);
+    if (it != initialized_tensors.end() && it->second.IsTensor() &&
+        it->second.Get<Tensor>().Location().device == OrtDevice()) {
+      initializers[entry.first] = &it->second;
+    }
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_binding) {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -883,6 +1759,10 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+std::string InferenceSession::GetInitializationTimings() const {
+  return session_profiler_.GetInitializationTimings();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
@@ -942,16 +1822,27 @@ common::Status InferenceSession::SaveModelMetadata(const onnxruntime::Model& mod
 }
 
 // Create a Logger for a single execution if possible. Otherwise use the default logger.
-// If a new logger is created, it will also be stored in new_run_logger,
+// The logger of an earlier execution with the same run tag and log levels is reused if it was kept in run_loggers_.
+// If a new logger is created and not kept, it will be stored in new_run_logger,
 // which must remain valid for the duration of the execution.
-// If the default logger is used, new_run_logger will remain empty.
+// Otherwise new_run_logger will remain empty.
 // The returned value should be used in the execution.
 const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& run_options,
                                                             std::unique_ptr<logging::Logger>& new_run_logger) {
   const logging::Logger* run_logger;
 
-  // create a per-run logger if we can
-  if (logging_manager_ != nullptr) {
+  // create a per-run logger if we can, unless it would be the same as the session logger
+  if (logging_manager_ != nullptr &&
+      !(owned_session_logger_ != nullptr && run_options.run_tag.empty() && run_options.run_log_severity_level == -1 &&
+        run_options.run_log_verbosity_level == session_options_.session_log_verbosity_level)) {
+    std::lock_guard<onnxruntime::OrtMutex> lock(run_loggers_mutex_);
+    for (const RunLogger& cached : run_loggers_) {
+      if (cached.severity_level == run_options.run_log_severity_level &&
+          cached.verbosity_level == run_options.run_log_verbosity_level && cached.run_tag == run_options.run_tag) {
+        return *cached.logger;
+      }
+    }
+
     std::string run_log_id{session_options_.session_logid};
 
     if (!session_options_.session_logid.empty() && !run_options.run_tag.empty()) {
@@ -978,8 +1869,14 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
 
     run_logger = new_run_logger.get();
     VLOGS(*run_logger, 1) << "Created logger for run with id of " << run_log_id;
+
+    if (run_loggers_.size() < kMaxRunLoggers) {
+      run_loggers_.push_back(RunLogger{run_options.run_tag, run_options.run_log_severity_level,
+                                       run_options.run_log_verbosity_level, std::move(new_run_logger)});
+    }
   } else {
-    // fallback to using default logger. this does NOT have any session or run specific id/tag in it
+    // use the session logger. unless it was created for the session, this is the default logger, which does NOT
+    // have any session or run specific id/tag in it
     run_logger = session_logger_;
     VLOGS(*run_logger, 1) << "Using default logger for run " << run_options.run_tag;
   }
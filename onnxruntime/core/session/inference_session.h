@@ -3,27 +3,37 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
+#include "core/framework/execution_pipeline.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/kernel_tuning_cache.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/partitioning_cost_model.h"
+#include "core/framework/session_metrics.h"
 #include "core/framework/session_state.h"
 #include "core/graph/basic_types.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/weight_compression_transformer.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
 
 namespace onnxruntime {  // forward declarations
+class ExecutionFrame;
+class FeedsFetchesManager;
 class GraphTransformer;
 }  // namespace onnxruntime
 
@@ -57,6 +67,8 @@ struct SessionOptions {
   bool enable_profiling = false;
 
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
+  // The model is tagged with graph_optimization_level and the execution providers of the session in its metadata,
+  // and the sessions created from it for the same providers at the same or a lower level skip the transformations.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
   // enable the memory pattern optimization.
@@ -66,14 +78,134 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // plan the memory pattern once during Initialize from the execution plan and the inferred shapes,
+  // instead of tracing it from a Run. Tensors with non-overlapping lifetimes share memory even if their sizes
+  // differ. Only used if enable_mem_pattern is set and the sizes of all the intermediate tensors are known.
+  // See SequentialPlanner::CreateStaticMemoryPattern.
+  bool enable_static_memory_planning = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // enable a per-thread cache of small freed chunks in front of the CPU memory arena.
+  // Useful when many threads call Run concurrently, as cached frees and re-allocations
+  // skip the arena lock. Has no effect unless enable_cpu_mem_arena is set.
+  bool enable_cpu_mem_arena_thread_cache = false;
+
+  // back the allocations of the CPU memory arena of at least 2MB, its regions and so the initializers placed
+  // in them, with huge pages where the platform has them. Saves TLB misses on large tensors.
+  bool enable_cpu_mem_arena_huge_pages = false;
+
+  // initial size, growth strategy and limit of the memory arena on CPU.
+  ArenaCfg cpu_mem_arena_cfg;
+
+  // use the allocators registered with the Environment instead of the ones the execution
+  // providers create, so that sessions share their arenas. See InferenceSession::UseSharedAllocators.
+  bool use_env_allocators = false;
+
+  // give memory regions of the arenas that are completely unused back to the device
+  // whenever the last in-progress Run call of the session finishes.
+  // See InferenceSession::ShrinkMemoryArenas.
+  bool enable_mem_arena_shrink_after_run = false;
+
+  // let the kernels of the default CPU execution provider that support several implementations, such as Conv,
+  // benchmark them for the static input shapes of their nodes when they are created, and use the fastest one.
+  // See KernelTuningCache.
+  bool enable_kernel_tuning = false;
+
+  // non empty filepath loads the implementations chosen by the kernels from the file, and saves them to it after
+  // the kernels are created if enable_kernel_tuning is set.
+  std::basic_string<ORTCHAR_T> kernel_tuning_cache_filepath;
+
+  // after the execution providers claim their nodes, move the connected groups of nodes left on the CPU between
+  // nodes of a device such as CUDA to the device, and the groups of nodes assigned to a device to the CPU, where the
+  // estimated compute and copies between the host and the device cost less. Only groups with static shapes are
+  // moved, to providers that have kernels for all their nodes. See GraphPartitioner::PlaceIslandsByCost.
+  bool enable_cost_based_partitioning = false;
+
+  // the estimates the cost based partitioning compares.
+  PartitioningCostModel partitioning_cost_model;
+
+  // keep the feeds/fetches mapping and the execution frame of a Run, and reuse them for the next Runs with the same
+  // feed and output names, instead of building them again for every Run. Together with reused feed and output
+  // values (e.g. an IOBinding), this keeps the framework from allocating on the heap for every Run, leaving the
+  // tensors the kernels output. Only used with sequential execution in sessions with CPU execution providers only.
+  bool enable_run_state_cache = false;
+
+  // capture the device work of a Run into a graph, such as a CUDA graph, and replay it for the later Runs with
+  // feeds of the same shapes, instead of launching the kernels one by one. Used with sequential execution if all
+  // the nodes are assigned to one execution provider that supports it, and none of them copies data to or from
+  // the host or runs a subgraph. The Runs keep their execution frame as with enable_run_state_cache, so the
+  // device addresses stay the same. See SequentialExecutor.
+  bool enable_graph_capture = false;
+
+  // if not 0, run models whose initializers don't fit in the memory of the device: the initializers the nodes of
+  // an execution provider that supports it read from its device memory (the CUDA one) are kept in pinned host
+  // memory, and copied into a device buffer of this many bytes ahead of the nodes reading them, while the nodes
+  // before compute. The buffer must hold the initializers of every node, and a larger one copies further ahead.
+  // Used with sequential execution. Runs of the session take turns, as they share the buffer. See WeightStreaming.
+  size_t weight_streaming_buffer_size = 0;
+
+  // the outputs a Run returns in the device memory the graph produces them in, such as CUDA memory, instead of
+  // copying them to CPU memory, when the Run doesn't pre-allocate them. The caller passes them on to the next
+  // consumer on the device, such as the session of the next stage of PipelineParallelSession.
+  std::unordered_set<std::string> device_outputs;
+
+  // run the float nodes assigned to the CUDA execution provider in float16 where it has kernels for them, so
+  // Tensor Cores compute the convolutions and matrix multiplications. Reductions and Softmax stay in float.
+  // See Float16ComputeTransformer.
+  bool enable_float16_compute = false;
+
+  // store the large constant float weights of the MatMul and Gemm nodes assigned to the CPU execution provider in
+  // float16, or in int8 with a scale per weight, and expand them to float while the multiplication packs them.
+  // Halves or quarters the memory of the weights on memory bound devices, at the cost of their precision, without
+  // quantizing the activations. See WeightCompressionTransformer.
+  WeightCompression weight_compression = WeightCompression::kNone;
+
+  // remove the ZipMap nodes producing graph outputs, so those outputs hold the float tensor of the probabilities of
+  // each class, one row per sample, instead of a sequence of one map per sample. The columns follow the order of
+  // the class labels of the ZipMap. Saves allocating the maps for large batches of classifier models.
+  // See ZipMapElimination.
+  bool enable_zipmap_elimination = false;
+
+  // create the kernels and load the initializers of the subgraph of a control flow node, such as a branch of an If,
+  // when the node first runs it instead of when the session is initialized. Saves the startup time and memory of
+  // the subgraphs a model rarely runs, such as the unused heads of a multi-task model, at the cost of a slower
+  // first Run of each. See SessionState::SetDeferredInitializer.
+  bool enable_lazy_subgraph_initialization = false;
+
+  // initializers of the main graph, by name, that use the given values instead of being deserialized from the
+  // model. Sessions of the same model created with the same values share their memory, instead of each holding
+  // a copy of the weights. The values are owned by the caller and must outlive the sessions. Each must have the
+  // element type and shape of the initializer and be on the device the session places it on.
+  std::unordered_map<std::string, const OrtValue*> initializers_to_share_map;
+
+  // the initializers on CPU whose external data is mapped from its file are used in place for the lifetime of the
+  // session. These ask the system to read their data ahead when the session is initialized, instead of on the first
+  // Run that touches each page, and to back it with huge pages where the file system supports it, to save TLB
+  // misses on large weights. Linux only, see Env::AdviseFileMapping.
+  bool prefetch_external_data = false;
+  bool use_huge_pages_for_external_data = false;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
+  // if above 0, profile only 1 in this many executions of the graphs, recording the time of their nodes into
+  // per-thread ring buffers drained in the background, so that profiling can stay enabled in production.
+  // Only used if enable_profiling is set. See Profiler::EnableSampling.
+  int profile_sampling_interval = 0;
+
+  // record the cycles, instructions, last level cache misses and estimated memory bandwidth of each node in its
+  // kernel time event. Linux only, see HardwareCounters. Only used if enable_profiling is set.
+  bool enable_profiling_hardware_counters = false;
+
+  // record the duration and failures of the runs, the compute time of the kernels per execution provider and the
+  // bytes the Memcpy nodes copy in the metrics registry of the process, labelled with session_logid.
+  // See SessionMetrics and OrtGetMetrics.
+  bool enable_metrics = false;
+
   std::string session_logid;  ///< logger id to use for session output
 
   /// Log severity for the inference session. Applies to session load, initialization, etc.
@@ -89,6 +221,38 @@ struct SessionOptions {
 
   // How many threads in the session thread pool.
   int session_thread_pool_size = -1;
+
+  // make the session thread pool split the parallel loops into one block per thread, and keep its threads
+  // polling for the next loop for thread_pool_spin_duration_us before they park.
+  // Lowers the latency of small models at the cost of busy processors. See concurrency::ThreadOptions.
+  bool enable_low_latency_threading = false;
+  int thread_pool_spin_duration_us = 1000;
+
+  // create num_thread_pool_replicas session thread pools of session_thread_pool_size threads each, and run every
+  // Run on the one with the fewest Runs in progress. Concurrent Runs of a model too small to use the whole machine
+  // then run side by side on their own threads, over the weights and kernels of the one session.
+  // The threads of replica i are pinned to thread_pool_replica_affinities[i] if it's set, see
+  // concurrency::ThreadOptions::affinity. Only used with use_per_session_threads.
+  int num_thread_pool_replicas = 1;
+  std::vector<std::vector<int>> thread_pool_replica_affinities;
+
+  // on a machine of several NUMA nodes, create one thread pool replica per node, pinned to the processors of the
+  // node, in place of num_thread_pool_replicas and thread_pool_replica_affinities, and give the CPU memory arena an
+  // arena per node. Each Run then computes on the threads of one node over memory of that node.
+  // session_thread_pool_size defaults to half the processors of a node. See NumaArena.
+  bool enable_numa = false;
+
+  // split the nodes of the execution plan into num_pipeline_stages stages of consecutive nodes, balanced by their
+  // number and cut where the execution provider changes if possible, each run by its own thread on the thread pool replica i % num_thread_pool_replicas. The concurrent Runs
+  // then flow through the stages one after the other, so each stage keeps the weights of its nodes hot on its cores.
+  // Only used with enable_sequential_execution, and not with weight_streaming_buffer_size. The Runs that are
+  // profiled, record metrics or allocate their outputs with custom allocators don't use the pipeline.
+  int num_pipeline_stages = 1;
+
+  // create a thread pool for the session. If false, the session runs on the thread pools passed to the
+  // InferenceSession constructor (the ones owned by the Environment when created through the C API),
+  // and session_thread_pool_size is ignored.
+  bool use_per_session_threads = true;
 };
 
 /**
@@ -103,6 +267,36 @@ struct ModelMetadata {
   std::unordered_map<std::string, std::string> custom_metadata_map;
 };
 
+/**
+  * The feeds and outputs of Runs, resolved once by InferenceSession::PrepareRun for the Runs that use it.
+  * The names are mapped to their OrtValue indexes and checked against the model when it's prepared, and the
+  * device copies of the feeds and fetches are worked out in the first Run, so later Runs must use feeds and
+  * fetches on the same devices.
+  * The Runs of a PreparedRun must not execute concurrently. Prepare one for each thread instead.
+  */
+class PreparedRun {
+ public:
+  ~PreparedRun();
+
+  const std::vector<std::string>& GetFeedNames() const;
+  const std::vector<std::string>& GetOutputNames() const;
+
+ private:
+  friend class InferenceSession;
+  PreparedRun() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  const InferenceSession* session_ = nullptr;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+
+  // expected type and shape of each feed. the shapes are owned by the session.
+  std::vector<MLDataType> feed_types_;
+  std::vector<const TensorShape*> feed_shapes_;
+
+  // reused by the Runs when SessionOptions::enable_run_state_cache applies
+  std::unique_ptr<ExecutionFrame> frame_;
+};
+
 /**
  * @brief This is the main class used to Run a model.
  * Sample simple usage:
@@ -139,6 +333,19 @@ class InferenceSession {
   explicit InferenceSession(const SessionOptions& session_options,
                             logging::LoggingManager* logging_manager = nullptr);
 
+  /**
+    Create a new InferenceSession that runs on thread pools it doesn't own if
+    session_options.use_per_session_threads is false.
+    @param external_intra_op_thread_pool Thread pool running the parallel loops inside the kernels. May be nullptr.
+    @param external_inter_op_thread_pool Thread pool the parallel executor runs the nodes on.
+    If nullptr, the nodes run on external_intra_op_thread_pool.
+    Both must outlive the session.
+    */
+  InferenceSession(const SessionOptions& session_options,
+                   logging::LoggingManager* logging_manager,
+                   concurrency::ThreadPool* external_intra_op_thread_pool,
+                   concurrency::ThreadPool* external_inter_op_thread_pool);
+
   virtual ~InferenceSession();
 
   /**
@@ -209,6 +416,14 @@ class InferenceSession {
     */
   common::Status Load(const void* model_data, int model_data_len);
 
+  /**
+    * Provide allocators that are shared with other sessions, typically the ones registered with the Environment.
+    * If SessionOptions::use_env_allocators is set, Initialize replaces the allocator an execution provider
+    * created for the same OrtMemoryInfo with the shared one.
+    * This API is not thread-safe and must be called before Initialize.
+    */
+  void UseSharedAllocators(std::vector<AllocatorPtr> shared_allocators);
+
   /**
     * Initializes a previously loaded model. Initialization includes but is not
     * limited to graph transformations, construction of kernels, etc.
@@ -222,6 +437,28 @@ class InferenceSession {
                      const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                      std::vector<OrtValue>* p_fetches);
 
+  /**
+    * Called once the shape of a missing output is known, for the buffer to write it into.
+    * @param output_index index of the output in the output names of the Run.
+    * @param size the size of the buffer in bytes.
+    * @return a buffer of at least size bytes, which must stay valid while the output is used, or nullptr for the
+    *         output to be allocated by the session.
+    */
+  using OutputAllocator = std::function<void*(size_t output_index, MLDataType element_type, const TensorShape& shape,
+                                              size_t size)>;
+
+  /**
+    * Run with the missing outputs written into the buffers of output_allocator, so that they don't need to be
+    * copied out of the session's memory afterwards.
+    * Only the non-string tensor outputs that the execution plan places in CPU memory are allocated with
+    * output_allocator.
+    * The others, and the outputs that aren't allocated by the Run, e.g. initializers, are allocated as usual.
+    * Such Runs don't reuse an execution frame. See SessionOptions::enable_run_state_cache.
+    */
+  common::Status Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                     const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>* p_fetches, const OutputAllocator& output_allocator);
+
   /**
     * Run a pre-loaded and pre-intialized model.
     * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -253,6 +490,47 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+    * Resolve the feed and output names of Runs ahead of them. See PreparedRun.
+    * This method assumes that Initialize() has been called.
+    * @param feed_names names of the inputs, in the order of the feeds passed to Run.
+    * @param output_names names of the outputs, in the order of the fetches returned by Run.
+    * @param prepared_run the new PreparedRun. It must not outlive this session.
+    * @return OK if success.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>& prepared_run);
+
+  /**
+    * Run with feeds and outputs resolved by PrepareRun.
+    * @param prepared_run a PreparedRun of this session. It must not be used by another Run at the same time.
+    * @param feeds input values in the order of the feed names of prepared_run.
+    * @param p_fetches output values in the order of the output names of prepared_run. Pre-allocated values are
+    *        used as is, and missing ones are allocated.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run, const std::vector<OrtValue>& feeds,
+                     std::vector<OrtValue>* p_fetches);
+
+  /**
+    * Called with the status and the outputs of a RunAsync call, on the thread that executed it.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Schedule a Run on the session's inter-op thread pool, or on threads of its own when it creates its thread pools
+    * and has no inter-op one, and return without waiting for it. The Runs are never scheduled on the intra-op thread
+    * pool, as a Run waiting there for the loops of its kernels could deadlock it.
+    * This API is thread-safe. The session waits for the pending Runs when it's destroyed.
+    * @param run_options must stay valid until the callback is called. it can terminate the Run as usual.
+    * @param fetches pre-allocated output values, or empty. see Run.
+    * @param callback called once with the result, including when the Run failed.
+    * @return OK if the Run was scheduled. the callback is not called otherwise.
+    */
+  common::Status RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback);
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -279,6 +557,24 @@ class InferenceSession {
     */
   int GetCurrentNumRuns() const;
 
+  /**
+    * Run the session on synthetic inputs so the first Run calls of real traffic don't pay for the arena growth,
+    * memory patterns, algorithm searches and compilation the kernels do for the shapes they first see.
+    * This method assumes that Initialize() has been called, and is meant to be called before the session serves.
+    * @param shape_profiles the shapes to run: each profile is one Run with the shapes of the inputs it names, and
+    *        the shapes of the model for the inputs it doesn't, which must then be fully known.
+    *        The inputs are filled with zeros, or empty strings, so inputs holding indices or shapes must be valid
+    *        when zero.
+    */
+  common::Status Warmup(const std::vector<std::unordered_map<std::string, std::vector<int64_t>>>& shape_profiles);
+
+  /**
+    * Give the memory regions of all arenas used by this session that hold no in-use
+    * allocations back to their devices, so that memory usage follows the actual load
+    * after a spike. Safe to call concurrently with Run, e.g. from a timer.
+    */
+  common::Status ShrinkMemoryArenas();
+
   /**
     * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
     * priority. The first provider in the vector has the highest priority.
@@ -290,6 +586,13 @@ class InferenceSession {
    */
   const SessionOptions& GetSessionOptions() const;
 
+  /**
+    * Get the initializers the session keeps in CPU memory, by name, which the sessions of the same model with the
+    * same execution providers can share through SessionOptions::initializers_to_share_map.
+    * The values are owned by this session. This API must be called after Initialize.
+    */
+  common::Status GetCpuInitializers(std::unordered_map<std::string, const OrtValue*>& initializers) const;
+
   /**
     * Start profiling on this inference session. This simply turns on profiling events to be
     * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
@@ -312,6 +615,15 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the time taken by each phase of Load and Initialize, whether profiling is enabled or not: the model
+    * loading, every graph transformer run, the GetCapability and Compile calls of every execution provider, the
+    * planning, the loading of the initializers and the creation of the kernels of every graph.
+    @return a JSON array of events in the chrome tracing format, timed in microseconds from the creation of the
+    session, with the phase of each in its "phase" argument.
+    */
+  std::string GetInitializationTimings() const;
+
  protected:
   /**
     * Load an ONNX model.
@@ -355,9 +667,10 @@ class InferenceSession {
   common::Status SaveModelMetadata(const onnxruntime::Model& model);
 
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
-  // If a new logger is created, it will also be stored in new_run_logger,
+  // The logger of an earlier execution with the same run tag and log levels is reused if it was kept in run_loggers_.
+  // If a new logger is created and not kept, it will be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
-  // If the default logger is used, new_run_logger will remain empty.
+  // Otherwise new_run_logger will remain empty.
   // The returned value should be used in the execution.
   const logging::Logger& CreateLoggerForRun(const RunOptions& run_options,
                                             std::unique_ptr<logging::Logger>& new_run_logger);
@@ -375,6 +688,10 @@ class InferenceSession {
 
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state);
 
+  // creates the plan, initializers and kernels of one subgraph of node, and sets up the node to run it
+  common::Status InitializeSubgraphSession(Node& node, const std::string& attribute_name, Graph& subgraph,
+                                           SessionState& session_state, SessionState& subgraph_session_state);
+
   void AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                  TransformerLevel graph_optimization_level,
                                  const std::vector<std::string>& custom_list);
@@ -389,6 +706,45 @@ class InferenceSession {
 
   common::Status ValidateOutputs(const std::vector<std::string>& output_names, const std::vector<OrtValue>* p_fetches) const;
 
+  // validate feeds against the types and shapes resolved by PrepareRun
+  common::Status ValidateInputs(const PreparedRun& prepared_run, const std::vector<OrtValue>& feeds) const;
+
+  common::Status ValidateInput(const std::string& feed_name, const OrtValue& feed, MLDataType expected_type,
+                               const TensorShape& expected_shape) const;
+
+  // true if Runs reuse their feeds/fetches mapping and execution frame. See SessionOptions::enable_run_state_cache
+  // and SessionOptions::enable_graph_capture.
+  bool UseRunStateCache() const;
+
+  // execute the graph with resolved feeds and fetches. fetch_allocators allocate the fetches of their index,
+  // and can't be used with a cached_frame.
+  common::Status RunImpl(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                         const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches,
+                         std::unique_ptr<ExecutionFrame>* cached_frame, TimePoint tp,
+                         const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators = {});
+
+  // free the memory held between Runs so a Run that ran out of memory can be retried: the execution frames of
+  // the cached run states and cached_frame, if not null, and the unused regions of the arenas.
+  common::Status ReleaseCachedMemory(std::unique_ptr<ExecutionFrame>* cached_frame);
+
+  // the size of the first dimension of the feeds if the Run is split into micro-batches, otherwise 0.
+  // See RunOptions::max_micro_batch_size.
+  int64_t GetMicroBatchedSize(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                              const std::vector<OrtValue>& feeds) const;
+
+  // run the batch_size rows of the feeds in micro-batches of at most run_options.max_micro_batch_size rows, and
+  // write the outputs of each into the rows of the outputs of the whole batch.
+  common::Status RunInMicroBatches(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                   const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                                   std::vector<OrtValue>* p_fetches,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                   int64_t batch_size);
+
+  // the fetch allocators that forward the allocation of the missing outputs to output_allocator
+  std::unordered_map<size_t, IExecutor::CustomAllocator> CreateFetchAllocators(
+      const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+      const OutputAllocator& output_allocator) const;
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
   template <typename T>
@@ -412,22 +768,47 @@ class InferenceSession {
   /// Logger for this session. WARNING: Will contain nullptr if logging_manager_ is nullptr.
   std::unique_ptr<logging::Logger> owned_session_logger_ = nullptr;
 
+  // The loggers created for Runs with a run tag or log levels of their own, reused by the next Runs with the same
+  // ones instead of creating a logger per Run. Bounded, past which the Runs create their own.
+  struct RunLogger {
+    std::string run_tag;
+    int severity_level;
+    int verbosity_level;
+    std::unique_ptr<logging::Logger> logger;
+  };
+  onnxruntime::OrtMutex run_loggers_mutex_;
+  std::vector<RunLogger> run_loggers_;  // GUARDED_BY(run_loggers_mutex_)
+
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // the metrics of the session when enable_metrics is set, nullptr otherwise
+  std::unique_ptr<SessionMetrics> session_metrics_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
+  // Allocators shared with other sessions. See UseSharedAllocators.
+  std::vector<AllocatorPtr> shared_allocators_;
+
  private:
   // Threadpool for this session
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
 
+  // the pools of SessionOptions::num_thread_pool_replicas after thread_pool_, the first one,
+  // and the number of Runs in progress on each of them
+  std::vector<std::unique_ptr<onnxruntime::concurrency::ThreadPool>> thread_pool_replicas_;
+  std::unique_ptr<std::atomic<int>[]> thread_pool_replica_runs_;
+
  protected:
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
   SessionState session_state_;
 
  private:
+  // runs the plan of session_state_ as SessionOptions::num_pipeline_stages stages, if more than one
+  std::unique_ptr<ExecutionPipeline> execution_pipeline_;
+
   KernelRegistryManager kernel_registry_manager_;
   std::list<std::shared_ptr<onnxruntime::IOnnxRuntimeOpSchemaCollection>> custom_schema_registries_;
 
@@ -454,12 +835,24 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Number of RunAsync calls whose callback hasn't returned yet
+  int num_pending_async_runs_ = 0;  // GUARDED_BY(async_runs_mutex_)
+  onnxruntime::OrtMutex async_runs_mutex_;
+  onnxruntime::OrtCondVar async_runs_done_;
+
+  // the threads RunAsync schedules the Runs on when the session has no inter-op thread pool, created by the first
+  // RunAsync. Declared after async_runs_mutex_, so it joins its threads before the mutex is destroyed.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> run_async_thread_pool_;  // GUARDED_BY(async_runs_mutex_)
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
 
   InsertCastTransformer insert_cast_transformer_;
 
+  // implementations chosen by the kernels of the default CPU execution provider, if kernel tuning is used.
+  std::shared_ptr<KernelTuningCache> kernel_tuning_cache_;
+
   //CustomRegistry objects own the corresponding KernelRegistry and OnnxRuntimeOpSchemaRegistry objects.
   //So its lifetime should be same as its constituents. This vector is to extend the lifetime of the owner.
   std::vector<std::shared_ptr<CustomRegistry>> custom_registries_;
@@ -467,5 +860,23 @@ class InferenceSession {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
   InterOpDomains interop_domains_;
 #endif
+
+  // State of a Run that is reused by the next Run with the same feed and output names.
+  // See SessionOptions::enable_run_state_cache.
+  struct CachedRunState {
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+    std::unique_ptr<ExecutionFrame> frame;
+  };
+
+  // take an idle state for the names out of the cache, or create one
+  common::Status AcquireCachedRunState(const std::vector<std::string>& feed_names,
+                                       const std::vector<std::string>& output_names,
+                                       std::unique_ptr<CachedRunState>& state);
+  void ReleaseCachedRunState(std::unique_ptr<CachedRunState> state);
+
+  // idle states. a Run takes one and gives it back when done, so concurrent Runs never share one.
+  // declared last so the frames release their buffers before the allocators are destroyed.
+  onnxruntime::OrtMutex cached_run_states_mutex_;
+  std::vector<std::unique_ptr<CachedRunState>> cached_run_states_;  // GUARDED_BY(cached_run_states_mutex_)
 };
 }  // namespace onnxruntime
@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/multi_device_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+// creates a tensor value viewing rows [first_row, first_row + num_rows) of tensor, without copying them
+OrtValue SliceRows(const Tensor& tensor, int64_t first_row, int64_t num_rows) {
+  std::vector<int64_t> dims = tensor.Shape().GetDims();
+  const size_t row_size = tensor.SizeInBytes() / static_cast<size_t>(dims[0]);
+  dims[0] = num_rows;
+
+  auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) + first_row * row_size;
+  auto p_tensor = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+  OrtValue value;
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return value;
+}
+
+// concatenates the values the shards returned for an output along their first dimension
+common::Status ConcatRows(const std::string& name, const std::vector<std::vector<OrtValue>>& shard_fetches,
+                          size_t output_index, const AllocatorPtr& allocator, OrtValue& value) {
+  const Tensor* first = nullptr;
+  int64_t num_rows = 0;
+  for (const auto& fetches : shard_fetches) {
+    const auto& shard_value = fetches[output_index];
+    if (!shard_value.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The output ", name,
+                             " is not a tensor and can't be concatenated across the shards of the Run.");
+    }
+
+    const Tensor& tensor = shard_value.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (first == nullptr) {
+      first = &tensor;
+    }
+    if (shape.NumDimensions() == 0 || tensor.IsDataTypeString() || tensor.DataType() != first->DataType() ||
+        shape.Slice(1) != first->Shape().Slice(1) || !(tensor.Location().device == OrtDevice())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The output ", name,
+                             " can't be concatenated across the shards of the Run along its first dimension.");
+    }
+    num_rows += shape[0];
+  }
+
+  std::vector<int64_t> dims = first->Shape().GetDims();
+  dims[0] = num_rows;
+  auto p_tensor = std::make_unique<Tensor>(first->DataType(), TensorShape(dims), allocator);
+  auto* data = static_cast<char*>(p_tensor->MutableDataRaw());
+  for (const auto& fetches : shard_fetches) {
+    const Tensor& tensor = fetches[output_index].Get<Tensor>();
+    memcpy(data, tensor.DataRaw(), tensor.SizeInBytes());
+    data += tensor.SizeInBytes();
+  }
+
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return Status::OK();
+}
+}  // namespace
+
+MultiDeviceSession::MultiDeviceSession(const SessionOptions& session_options,
+                                       const std::vector<std::shared_ptr<IExecutionProviderFactory>>& provider_factories,
+                                       int64_t min_shard_batch_size,
+                                       logging::LoggingManager* logging_manager)
+    : session_options_{session_options},
+      provider_factories_{provider_factories},
+      min_shard_batch_size_{min_shard_batch_size},
+      logging_manager_{logging_manager},
+      cpu_allocator_{std::make_shared<CPUAllocator>()} {
+  ORT_ENFORCE(!provider_factories_.empty(), "MultiDeviceSession needs an execution provider factory per replica.");
+
+  if (provider_factories_.size() > 1) {
+    shard_thread_pool_ = std::make_unique<concurrency::ThreadPool>("MULTI_DEVICE",
+                                                                   static_cast<int>(provider_factories_.size()) - 1);
+  }
+
+  replicas_.push_back(std::make_unique<Replica>());
+  replicas_[0]->session = std::make_unique<InferenceSession>(session_options_, logging_manager_);
+  ORT_THROW_IF_ERROR(replicas_[0]->session->RegisterExecutionProvider(provider_factories_[0]->CreateProvider()));
+}
+
+MultiDeviceSession::~MultiDeviceSession() {
+  // the first replica owns the initializers the others share, it goes last
+  while (!replicas_.empty()) {
+    replicas_.pop_back();
+  }
+}
+
+common::Status MultiDeviceSession::Load(const std::string& model_uri) {
+  loader_ = [model_uri](InferenceSession& session) { return session.Load(model_uri); };
+  return loader_(*replicas_[0]->session);
+}
+
+#ifdef _WIN32
+common::Status MultiDeviceSession::Load(const std::wstring& model_uri) {
+  loader_ = [model_uri](InferenceSession& session) { return session.Load(model_uri); };
+  return loader_(*replicas_[0]->session);
+}
+#endif
+
+common::Status MultiDeviceSession::Load(const void* model_data, int model_data_len) {
+  // the other replicas load the model in Initialize, the caller may free model_data before
+  auto data = std::make_shared<std::string>(static_cast<const char*>(model_data), model_data_len);
+  loader_ = [data](InferenceSession& session) {
+    return session.Load(data->data(), static_cast<int>(data->size()));
+  };
+  return loader_(*replicas_[0]->session);
+}
+
+common::Status MultiDeviceSession::Initialize() {
+  if (replicas_.size() == provider_factories_.size() && !loader_) {
+    return replicas_[0]->session->Initialize();
+  }
+  if (!loader_) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Model was not loaded.");
+  }
+
+  ORT_RETURN_IF_ERROR(replicas_[0]->session->Initialize());
+
+  SessionOptions replica_options = session_options_;
+  ORT_RETURN_IF_ERROR(replicas_[0]->session->GetCpuInitializers(replica_options.initializers_to_share_map));
+
+  const size_t num_replicas = provider_factories_.size();
+  for (size_t i = 1; i < num_replicas; ++i) {
+    replicas_.push_back(std::make_unique<Replica>());
+    replicas_[i]->session = std::make_unique<InferenceSession>(replica_options, logging_manager_);
+  }
+
+  // the replicas initialize concurrently, each on its own device
+  std::vector<Status> statuses(num_replicas);
+  auto initialize = [&](int32_t i) {
+    auto& session = *replicas_[i + 1]->session;
+    try {
+      statuses[i] = session.RegisterExecutionProvider(provider_factories_[i + 1]->CreateProvider());
+      if (statuses[i].IsOK()) {
+        statuses[i] = loader_(session);
+      }
+      if (statuses[i].IsOK()) {
+        statuses[i] = session.Initialize();
+      }
+    } catch (const std::exception& ex) {
+      statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+  if (shard_thread_pool_ != nullptr) {
+    shard_thread_pool_->ParallelFor(static_cast<int32_t>(num_replicas - 1), initialize);
+  }
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  loader_ = nullptr;
+  return Status::OK();
+}
+
+int64_t MultiDeviceSession::GetShardBatchSize(const NameMLValMap& feeds) const {
+  if (replicas_.size() < 2 || min_shard_batch_size_ <= 0 || feeds.empty()) {
+    return 0;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return 0;
+    }
+    const Tensor& tensor = feed.second.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() == 0 || tensor.IsDataTypeString() || !(tensor.Location().device == OrtDevice()) ||
+        (batch_size != -1 && shape[0] != batch_size)) {
+      return 0;
+    }
+    batch_size = shape[0];
+  }
+
+  return batch_size >= std::max<int64_t>(min_shard_batch_size_, 2) ? batch_size : 0;
+}
+
+std::vector<size_t> MultiDeviceSession::GetReplicasByLoad() const {
+  std::vector<size_t> order(replicas_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return replicas_[a]->num_runs < replicas_[b]->num_runs;
+  });
+  return order;
+}
+
+common::Status MultiDeviceSession::RunOnReplica(Replica& replica, const RunOptions& run_options,
+                                                const NameMLValMap& feeds,
+                                                const std::vector<std::string>& output_names,
+                                                std::vector<OrtValue>* p_fetches) {
+  ++replica.num_runs;
+  Status status;
+  try {
+    status = replica.session->Run(run_options, feeds, output_names, p_fetches);
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+  }
+  --replica.num_runs;
+  return status;
+}
+
+common::Status MultiDeviceSession::RunShards(const RunOptions& run_options, const NameMLValMap& feeds,
+                                             int64_t batch_size, const std::vector<std::string>& output_names,
+                                             std::vector<OrtValue>* p_fetches) {
+  const auto replica_order = GetReplicasByLoad();
+  const auto num_shards = static_cast<int32_t>(std::min<int64_t>(batch_size, replica_order.size()));
+
+  // the first batch_size % num_shards shards take a row more than the others
+  std::vector<NameMLValMap> shard_feeds(num_shards);
+  int64_t first_row = 0;
+  for (int32_t i = 0; i < num_shards; ++i) {
+    const int64_t num_rows = batch_size / num_shards + (i < batch_size % num_shards ? 1 : 0);
+    for (const auto& feed : feeds) {
+      shard_feeds[i].emplace(feed.first, SliceRows(feed.second.Get<Tensor>(), first_row, num_rows));
+    }
+    first_row += num_rows;
+  }
+
+  std::vector<std::vector<OrtValue>> shard_fetches(num_shards);
+  std::vector<Status> statuses(num_shards);
+  shard_thread_pool_->ParallelFor(num_shards, [&](int32_t i) {
+    statuses[i] = RunOnReplica(*replicas_[replica_order[i]], run_options, shard_feeds[i], output_names,
+                               &shard_fetches[i]);
+  });
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  p_fetches->resize(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(ConcatRows(output_names[i], shard_fetches, i, cpu_allocator_, (*p_fetches)[i]));
+  }
+  return Status::OK();
+}
+
+common::Status MultiDeviceSession::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                       const std::vector<std::string>& output_names,
+                                       std::vector<OrtValue>* p_fetches) {
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  const int64_t batch_size = p_fetches->empty() ? GetShardBatchSize(feeds) : 0;
+  if (batch_size > 0) {
+    return RunShards(run_options, feeds, batch_size, output_names, p_fetches);
+  }
+
+  return RunOnReplica(*replicas_[GetReplicasByLoad()[0]], run_options, feeds, output_names, p_fetches);
+}
+
+}  // namespace onnxruntime
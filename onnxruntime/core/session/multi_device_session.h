@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/providers.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+  * Runs a model on several devices, such as the GPUs of a machine, with a replica of the session per device.
+  *
+  * The replicas are created with the same SessionOptions, each with the execution provider created by its factory,
+  * such as the CUDA execution provider of one device id. The initializers the first replica keeps in CPU memory are
+  * shared with the other replicas through SessionOptions::initializers_to_share_map, so only the weights placed on
+  * the devices are duplicated.
+  *
+  * A Run whose feeds are all CPU tensors with the same first dimension of at least min_shard_batch_size is split along
+  * that dimension into one shard per replica, the shards run concurrently, and the outputs are concatenated along
+  * their first dimension. The other Runs run whole on the replica with the fewest Runs in progress.
+  *
+  * Sample usage:
+  *
+  *  std::vector<std::shared_ptr<IExecutionProviderFactory>> factories;
+  *  for (int device_id : {0, 1, 2, 3}) {
+  *    factories.push_back(CreateExecutionProviderFactory_CUDA(device_id));
+  *  }
+  *  MultiDeviceSession session(so, factories, 8);
+  *  common::Status status = session.Load(MODEL_URI);
+  *  status = session.Initialize();
+  *  status = session.Run(run_options, feeds, output_names, &fetches);
+  */
+class MultiDeviceSession {
+ public:
+  /**
+    * @param session_options the options of every replica.
+    * @param provider_factories create the execution provider of each replica, at least one.
+    * @param min_shard_batch_size the smallest batch split across the replicas, 0 to never split Runs.
+    * @param logging_manager the logging manager of the replicas, see InferenceSession.
+    */
+  MultiDeviceSession(const SessionOptions& session_options,
+                     const std::vector<std::shared_ptr<IExecutionProviderFactory>>& provider_factories,
+                     int64_t min_shard_batch_size,
+                     logging::LoggingManager* logging_manager = nullptr);
+
+  ~MultiDeviceSession();
+
+  /**
+    * Load an ONNX model in every replica.
+    * @param model_uri absolute path of the model file.
+    * @return OK if success.
+    */
+  common::Status Load(const std::string& model_uri);
+#ifdef _WIN32
+  common::Status Load(const std::wstring& model_uri);
+#endif
+  common::Status Load(const void* model_data, int model_data_len);
+
+  /**
+    * Initialize the replicas, the first one before the others, which share its initializers in CPU memory.
+    * @return OK if success.
+    */
+  common::Status Initialize();
+
+  /**
+    * Run the model, split across the replicas or on the least loaded one, see MultiDeviceSession.
+    * Multiple threads are allowed to run this function.
+    * @param fetches output values in the order of output_names. A Run with pre-allocated fetches is not split.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  size_t NumReplicas() const { return replicas_.size(); }
+
+  InferenceSession& GetReplica(size_t index) { return *replicas_[index]->session; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MultiDeviceSession);
+
+  struct Replica {
+    std::unique_ptr<InferenceSession> session;
+    std::atomic<int> num_runs{0};
+  };
+
+  // returns the batch size of the feeds if the Run can be split, 0 otherwise
+  int64_t GetShardBatchSize(const NameMLValMap& feeds) const;
+
+  // returns the indices of the replicas ordered by the number of their Runs in progress
+  std::vector<size_t> GetReplicasByLoad() const;
+
+  common::Status RunOnReplica(Replica& replica, const RunOptions& run_options, const NameMLValMap& feeds,
+                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  common::Status RunShards(const RunOptions& run_options, const NameMLValMap& feeds, int64_t batch_size,
+                           const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  const SessionOptions session_options_;
+  const std::vector<std::shared_ptr<IExecutionProviderFactory>> provider_factories_;
+  const int64_t min_shard_batch_size_;
+  logging::LoggingManager* const logging_manager_;
+  // loads the model in a replica, kept from Load until Initialize created the other replicas
+  std::function<common::Status(InferenceSession&)> loader_;
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  // runs the shards of split Runs besides the calling thread
+  std::unique_ptr<concurrency::ThreadPool> shard_thread_pool_;
+  // allocates the concatenated outputs of split Runs
+  AllocatorPtr cpu_allocator_;
+};
+
+}  // namespace onnxruntime
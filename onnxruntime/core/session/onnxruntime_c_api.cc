@@ -10,7 +10,9 @@
 #include <sstream>
 
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
+#include "core/common/metrics.h"
 #include "core/common/status.h"
 #include "core/graph/graph.h"
 #include "core/framework/allocator.h"
@@ -39,6 +41,8 @@ using onnxruntime::common::Status;
 
 using namespace onnxruntime;
 
+ONNXTensorElementDataType MLDataTypeToOnnxRuntimeTensorElementDataType(const onnxruntime::DataTypeImpl* cpp_type);
+
 #define ORT_API_RETURN_IF_ERROR(expr) \
   do {                                \
     auto _status = (expr);            \
@@ -108,6 +112,95 @@ ORT_API_STATUS_IMPL(OrtCreateEnvWithCustomLogger, OrtLoggingFunction logging_fun
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtCreateEnvWithAsyncLogger, _In_opt_ OrtLoggingFunction logging_function,
+                    _In_opt_ void* logger_param, OrtLoggingLevel default_warning_level, _In_ const char* logid,
+                    _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  std::unique_ptr<ISink> sink;
+  if (logging_function != nullptr) {
+    sink = std::make_unique<LoggingWrapper>(logging_function, logger_param);
+  } else {
+    sink = std::make_unique<CLogSink>();
+  }
+  auto default_logging_manager = std::make_unique<LoggingManager>(std::make_unique<AsyncSink>(std::move(sink)),
+                                                                  static_cast<Severity>(default_warning_level), false,
+                                                                  LoggingManager::InstanceType::Temporal,
+                                                                  &name);
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env);
+  if (status.IsOK())
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreateAndRegisterAllocator, _Inout_ OrtEnv* env, _In_ const OrtMemoryInfo* mem_info,
+                    _In_opt_ const OrtArenaCfg* arena_cfg) {
+  API_IMPL_BEGIN
+  return ToOrtStatus(env->value->CreateAndRegisterAllocator(*mem_info, arena_cfg));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreateThreadingOptions, _Outptr_ OrtThreadingOptions** out) {
+  API_IMPL_BEGIN
+  *out = new OrtThreadingOptions();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int intra_op_num_threads) {
+  tp_options->intra_op_num_threads = intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int inter_op_num_threads) {
+  if (inter_op_num_threads < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "inter_op_num_threads must not be negative");
+  }
+  tp_options->inter_op_num_threads = inter_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_opt_ const int* logical_processors, size_t num_processors) {
+  API_IMPL_BEGIN
+  tp_options->intra_op_thread_affinity.assign(logical_processors, logical_processors + num_processors);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSetGlobalInterOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_opt_ const int* logical_processors, size_t num_processors) {
+  API_IMPL_BEGIN
+  tp_options->inter_op_thread_affinity.assign(logical_processors, logical_processors + num_processors);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtReleaseThreadingOptions, _Frees_ptr_opt_ OrtThreadingOptions* p) { delete p; }
+
+ORT_API_STATUS_IMPL(OrtCreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  auto default_logging_manager = std::make_unique<LoggingManager>(std::unique_ptr<ISink>{new CLogSink{}},
+                                                                  static_cast<Severity>(default_warning_level), false,
+                                                                  LoggingManager::InstanceType::Default,
+                                                                  &name);
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env, tp_options);
+  if (status.IsOK()) {
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+    return nullptr;
+  }
+  *out = nullptr;
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
 ORT_API(const char*, OrtGetVersionString) {
   return ORT_VERSION;
 }
@@ -368,9 +461,14 @@ template <typename Loader>
 OrtStatus* CreateSessionImpl(_In_ const OrtEnv* env, _In_ const OrtSessionOptions* options,
                              Loader loader, _Outptr_ OrtSession** out) {
   auto sess = std::make_unique<::onnxruntime::InferenceSession>(
-      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager);
+      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager,
+      env->value->GetIntraOpThreadPool(), env->value->GetInterOpThreadPool());
   Status status;
   if (options != nullptr) {
+    if (options->value.use_env_allocators) {
+      sess->UseSharedAllocators(env->value->GetRegisteredSharedAllocators());
+    }
+
     if (!options->custom_op_domains_.empty()) {
       status = sess->AddCustomOpDomains(options->custom_op_domains_);
       if (!status.IsOK())
@@ -477,6 +575,237 @@ ORT_API_STATUS_IMPL(OrtRun, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtRunWithOutputAllocator, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _In_ OrtOutputAllocatorFn allocator, _In_opt_ void* user_data, _Inout_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  if (allocator == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "allocator cannot be NULL");
+  }
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    feed_names[i] = input_names[i];
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<OrtValue> fetches(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  auto output_allocator = [allocator, user_data](size_t output_index, onnxruntime::MLDataType element_type,
+                                                 const onnxruntime::TensorShape& shape, size_t size) {
+    const auto& dims = shape.GetDims();
+    return allocator(user_data, output_index, MLDataTypeToOnnxRuntimeTensorElementDataType(element_type),
+                     dims.data(), dims.size(), size);
+  };
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, feed_names, feeds, output_names, &fetches, output_allocator);
+  } else {
+    status = session->Run(*run_options, feed_names, feeds, output_names, &fetches, output_allocator);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunAsync, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  if (callback == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be NULL");
+  }
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    feed_names[i] = input_names[i];
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<OrtValue> fetches(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  // never changed, so it can be shared by all the runs without options
+  static const OrtRunOptions default_run_options;
+
+  auto status = session->RunAsync(
+      run_options == nullptr ? default_run_options : *run_options, std::move(feed_names), std::move(feeds),
+      std::move(output_names), std::move(fetches),
+      [output, output_names_len, callback, user_data](const Status& run_status, std::vector<OrtValue>& run_fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, output, output_names_len, ToOrtStatus(run_status));
+          return;
+        }
+
+        for (size_t i = 0; i != output_names_len; ++i) {
+          ::OrtValue& value = run_fetches[i];
+          if (value.Fence())
+            value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+          if (output[i] == nullptr) {
+            output[i] = new OrtValue(value);
+          }
+        }
+        callback(user_data, output, output_names_len, nullptr);
+      });
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtPrepareRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunPrepared, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options, _Inout_ OrtPreparedRun* prepared,
+                    _In_ const OrtValue* const* input, size_t input_len,
+                    size_t output_len, _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& prepared_run = *reinterpret_cast<::onnxruntime::PreparedRun*>(prepared);
+  const int queue_id = 0;
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  if (output_len != prepared_run.GetOutputNames().size()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output_len doesn't match the number of prepared outputs");
+  }
+
+  std::vector<OrtValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared_run, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, prepared_run, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _Inout_ OrtValue* value, _Outptr_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -547,6 +876,29 @@ ORT_API_STATUS_IMPL(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtSessionShrinkArenas, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  return ToOrtStatus(session->ShrinkMemoryArenas());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionWarmup, _Inout_ OrtSession* sess, _In_ const char* const* input_names,
+                    _In_ const int64_t* const* input_shapes, _In_ const size_t* input_shape_lengths,
+                    size_t input_count) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unordered_map<std::string, std::vector<int64_t>> profile;
+  for (size_t i = 0; i != input_count; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    profile[input_names[i]].assign(input_shapes[i], input_shapes[i] + input_shape_lengths[i]);
+  }
+  return ToOrtStatus(session->Warmup({profile}));
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtSessionGetInputTypeInfo, _In_ const OrtSession* sess, size_t index, _Outptr_ struct OrtTypeInfo** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -579,6 +931,22 @@ static char* StrDup(const std::string& str, OrtAllocator* allocator) {
   return output_string;
 }
 
+ORT_API_STATUS_IMPL(OrtGetMetrics, _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  *out = StrDup(onnxruntime::metrics::MetricsRegistry::Global().ToPrometheusText(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetInitializationTimings, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetInitializationTimings(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 static OrtStatus* GetInputOutputNameImpl(_In_ const OrtSession* sess, size_t index,
                                          _Inout_ OrtAllocator* allocator, bool is_input,
                                          _Outptr_ char** output) {
@@ -1111,3 +1479,4 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
@@ -0,0 +1,450 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_parallel_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+// creates a tensor value viewing rows [first_row, first_row + num_rows) of tensor, without copying them
+OrtValue SliceRows(const Tensor& tensor, int64_t first_row, int64_t num_rows) {
+  std::vector<int64_t> dims = tensor.Shape().GetDims();
+  const size_t row_size = tensor.SizeInBytes() / static_cast<size_t>(dims[0]);
+  dims[0] = num_rows;
+
+  auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) + first_row * row_size;
+  auto p_tensor = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+  OrtValue value;
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return value;
+}
+
+// concatenates the values the micro-batches returned for an output along their first dimension
+common::Status ConcatRows(const std::string& name, const std::vector<std::vector<OrtValue>>& micro_batch_fetches,
+                          size_t output_index, const AllocatorPtr& allocator, OrtValue& value) {
+  const Tensor* first = nullptr;
+  int64_t num_rows = 0;
+  for (const auto& fetches : micro_batch_fetches) {
+    const auto& micro_batch_value = fetches[output_index];
+    if (!micro_batch_value.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The output ", name,
+                             " is not a tensor and can't be concatenated across the micro-batches of the Run.");
+    }
+
+    const Tensor& tensor = micro_batch_value.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (first == nullptr) {
+      first = &tensor;
+    }
+    if (shape.NumDimensions() == 0 || tensor.IsDataTypeString() || tensor.DataType() != first->DataType() ||
+        shape.Slice(1) != first->Shape().Slice(1) || !(tensor.Location().device == OrtDevice())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The output ", name,
+                             " can't be concatenated across the micro-batches of the Run along its first dimension.");
+    }
+    num_rows += shape[0];
+  }
+
+  std::vector<int64_t> dims = first->Shape().GetDims();
+  dims[0] = num_rows;
+  auto p_tensor = std::make_unique<Tensor>(first->DataType(), TensorShape(dims), allocator);
+  auto* data = static_cast<char*>(p_tensor->MutableDataRaw());
+  for (const auto& fetches : micro_batch_fetches) {
+    const Tensor& tensor = fetches[output_index].Get<Tensor>();
+    memcpy(data, tensor.DataRaw(), tensor.SizeInBytes());
+    data += tensor.SizeInBytes();
+  }
+
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return Status::OK();
+}
+
+// assigns the nodes, in topological order, to num_stages contiguous stages of about the same cost, the bytes of the
+// initializers a node reads plus one, so the nodes without initializers are spread as well
+std::vector<size_t> AssignStages(const std::vector<size_t>& node_costs, size_t num_stages) {
+  size_t total_cost = 0;
+  for (size_t cost : node_costs) {
+    total_cost += cost;
+  }
+
+  const size_t num_nodes = node_costs.size();
+  std::vector<size_t> stage_of_node(num_nodes);
+  size_t stage = 0;
+  size_t cost = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    stage_of_node[i] = stage;
+    cost += node_costs[i];
+    // every stage keeps at least a node
+    const size_t nodes_left = num_nodes - i - 1;
+    const size_t stages_left = num_stages - stage - 1;
+    if (stages_left > 0 && (nodes_left == stages_left ||
+                            static_cast<double>(cost) >= static_cast<double>(total_cost) * (stage + 1) / num_stages)) {
+      ++stage;
+    }
+  }
+  return stage_of_node;
+}
+}  // namespace
+
+PipelineParallelSession::PipelineParallelSession(
+    const SessionOptions& session_options,
+    const std::vector<std::shared_ptr<IExecutionProviderFactory>>& provider_factories,
+    int64_t micro_batch_size,
+    logging::LoggingManager* logging_manager)
+    : session_options_{session_options},
+      provider_factories_{provider_factories},
+      micro_batch_size_{micro_batch_size},
+      logging_manager_{logging_manager},
+      cpu_allocator_{std::make_shared<CPUAllocator>()} {
+  ORT_ENFORCE(!provider_factories_.empty(), "PipelineParallelSession needs an execution provider factory per stage.");
+}
+
+PipelineParallelSession::~PipelineParallelSession() = default;
+
+common::Status PipelineParallelSession::Load(const std::string& model_uri) {
+  std::ifstream model_istream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_istream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open ", model_uri);
+  }
+  auto model_proto = std::make_unique<ModelProto>();
+  ORT_RETURN_IF_ERROR(Model::Load(model_istream, model_proto.get()));
+  model_proto_ = std::move(model_proto);
+  return Status::OK();
+}
+
+#ifdef _WIN32
+common::Status PipelineParallelSession::Load(const std::wstring& model_uri) {
+  std::ifstream model_istream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_istream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Failed to open ", ToMBString(model_uri));
+  }
+  auto model_proto = std::make_unique<ModelProto>();
+  ORT_RETURN_IF_ERROR(Model::Load(model_istream, model_proto.get()));
+  model_proto_ = std::move(model_proto);
+  return Status::OK();
+}
+#endif
+
+common::Status PipelineParallelSession::Load(const void* model_data, int model_data_len) {
+  auto model_proto = std::make_unique<ModelProto>();
+  if (!model_proto->ParseFromArray(model_data, model_data_len)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
+                  "Failed to load model because protobuf parsing failed.");
+  }
+  model_proto_ = std::move(model_proto);
+  return Status::OK();
+}
+
+common::Status PipelineParallelSession::CreateStageModels(std::vector<ModelProto>& stage_models) {
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(*model_proto_, model));
+  const Graph& graph = model->MainGraph();
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  const auto& initializers = graph.GetAllInitializedTensors();
+  if (order.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has no nodes to split into stages.");
+  }
+
+  // the values each node reads, including the ones its subgraphs read
+  auto node_inputs = [&graph](NodeIndex index) {
+    const Node& node = *graph.GetNode(index);
+    std::vector<const NodeArg*> inputs(node.InputDefs().cbegin(), node.InputDefs().cend());
+    inputs.insert(inputs.end(), node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+    return inputs;
+  };
+
+  std::vector<size_t> node_costs;
+  node_costs.reserve(order.size());
+  for (NodeIndex index : order) {
+    size_t cost = 1;
+    for (const auto* input : node_inputs(index)) {
+      auto it = initializers.find(input->Name());
+      if (input->Exists() && it != initializers.cend()) {
+        cost += it->second->ByteSizeLong();
+      }
+    }
+    node_costs.push_back(cost);
+  }
+
+  const size_t num_stages = std::min(provider_factories_.size(), order.size());
+  const auto stage_of_node = AssignStages(node_costs, num_stages);
+
+  std::unordered_map<std::string, size_t> producer_stage;
+  for (size_t i = 0; i < order.size(); ++i) {
+    for (const auto* output : graph.GetNode(order[i])->OutputDefs()) {
+      if (output->Exists()) {
+        producer_stage[output->Name()] = stage_of_node[i];
+      }
+    }
+  }
+
+  std::unordered_set<std::string> graph_inputs;
+  for (const auto* input : graph.GetInputsIncludingInitializers()) {
+    graph_inputs.insert(input->Name());
+  }
+  model_outputs_.clear();
+  for (const auto* output : graph.GetOutputs()) {
+    if (producer_stage.count(output->Name()) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "The output ", output->Name(),
+                             " isn't produced by a node, which PipelineParallelSession doesn't support.");
+    }
+    model_outputs_.insert(output->Name());
+  }
+
+  // the models of the stages keep everything but the graph of the model
+  ModelProto model_without_graph;
+  GraphProto* graph_proto = model_proto_->release_graph();
+  model_without_graph = *model_proto_;
+  model_proto_->set_allocated_graph(graph_proto);
+
+  stages_.resize(num_stages);
+  stage_models.assign(num_stages, model_without_graph);
+  std::vector<std::unordered_set<std::string>> stage_initializers(num_stages);
+  std::vector<std::unordered_set<std::string>> stage_inputs(num_stages);
+  std::vector<std::unordered_set<std::string>> stage_outputs(num_stages);
+  for (size_t s = 0; s < num_stages; ++s) {
+    stage_models[s].mutable_graph()->set_name(graph.Name() + "_stage_" + std::to_string(s));
+  }
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    const size_t s = stage_of_node[i];
+    auto& stage_graph = *stage_models[s].mutable_graph();
+    graph.GetNode(order[i])->ToProto(*stage_graph.add_node());
+
+    for (const auto* input : node_inputs(order[i])) {
+      const auto& name = input->Name();
+      if (!input->Exists()) {
+        continue;
+      }
+
+      auto initializer = initializers.find(name);
+      if (initializer != initializers.cend() && stage_initializers[s].insert(name).second) {
+        *stage_graph.add_initializer() = *initializer->second;
+      }
+      // an initializer that is an input of the model may be overridden by the feeds
+      const bool is_input = initializer == initializers.cend() || graph_inputs.count(name) != 0;
+      auto producer = producer_stage.find(name);
+      if (is_input && (producer == producer_stage.cend() || producer->second != s) &&
+          stage_inputs[s].insert(name).second) {
+        *stage_graph.add_input() = input->ToProto();
+        stages_[s].inputs.push_back(name);
+      }
+      if (producer != producer_stage.cend() && producer->second != s &&
+          stage_outputs[producer->second].insert(name).second) {
+        stages_[producer->second].outputs.push_back(name);
+      }
+    }
+  }
+
+  for (const auto* output : graph.GetOutputs()) {
+    const size_t s = producer_stage[output->Name()];
+    if (stage_outputs[s].insert(output->Name()).second) {
+      stages_[s].outputs.push_back(output->Name());
+    }
+  }
+  for (size_t s = 0; s < num_stages; ++s) {
+    for (const auto& name : stages_[s].outputs) {
+      *stage_models[s].mutable_graph()->add_output() = graph.GetNodeArg(name)->ToProto();
+    }
+  }
+  return Status::OK();
+}
+
+common::Status PipelineParallelSession::Initialize() {
+  if (!stages_.empty() && model_proto_ == nullptr) {
+    return Status::OK();
+  }
+  if (model_proto_ == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Model was not loaded.");
+  }
+
+  std::vector<ModelProto> stage_models;
+  ORT_RETURN_IF_ERROR(CreateStageModels(stage_models));
+  model_proto_.reset();
+
+  const size_t num_stages = stages_.size();
+  if (num_stages > 1) {
+    stage_thread_pool_ = std::make_unique<concurrency::ThreadPool>("PIPELINE_PARALLEL",
+                                                                   static_cast<int>(num_stages) - 1);
+  }
+
+  // the stages initialize concurrently, each on its own device
+  std::vector<Status> statuses(num_stages);
+  auto initialize = [&](int32_t s) {
+    SessionOptions stage_options = session_options_;
+    // the values passed to the next stages stay on the device, the outputs of the model are returned in CPU memory
+    for (const auto& name : stages_[s].outputs) {
+      if (model_outputs_.count(name) == 0) {
+        stage_options.device_outputs.insert(name);
+      }
+    }
+
+    try {
+      auto session = std::make_unique<InferenceSession>(stage_options, logging_manager_);
+      std::string model_data;
+      stage_models[s].SerializeToString(&model_data);
+      statuses[s] = session->RegisterExecutionProvider(provider_factories_[s]->CreateProvider());
+      if (statuses[s].IsOK()) {
+        statuses[s] = session->Load(model_data.data(), static_cast<int>(model_data.size()));
+      }
+      if (statuses[s].IsOK()) {
+        statuses[s] = session->Initialize();
+      }
+      stages_[s].session = std::move(session);
+    } catch (const std::exception& ex) {
+      statuses[s] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+  };
+  if (stage_thread_pool_ != nullptr) {
+    stage_thread_pool_->ParallelFor(static_cast<int32_t>(num_stages), initialize);
+  } else {
+    initialize(0);
+  }
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+int64_t PipelineParallelSession::GetNumMicroBatches(const NameMLValMap& feeds) const {
+  if (micro_batch_size_ <= 0 || feeds.empty()) {
+    return 1;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return 1;
+    }
+    const Tensor& tensor = feed.second.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() == 0 || tensor.IsDataTypeString() || !(tensor.Location().device == OrtDevice()) ||
+        (batch_size != -1 && shape[0] != batch_size)) {
+      return 1;
+    }
+    batch_size = shape[0];
+  }
+
+  return batch_size > micro_batch_size_ ? (batch_size + micro_batch_size_ - 1) / micro_batch_size_ : 1;
+}
+
+common::Status PipelineParallelSession::RunStage(size_t stage_index, const RunOptions& run_options,
+                                                 NameMLValMap& values) {
+  const auto& stage = stages_[stage_index];
+  NameMLValMap stage_feeds;
+  for (const auto& name : stage.inputs) {
+    // the initializers that are inputs of the model keep their value if not fed
+    auto it = values.find(name);
+    if (it != values.cend()) {
+      stage_feeds.emplace(name, it->second);
+    }
+  }
+
+  std::vector<OrtValue> stage_fetches;
+  Status status;
+  try {
+    status = stage.session->Run(run_options, stage_feeds, stage.outputs, &stage_fetches);
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  for (size_t i = 0; i < stage.outputs.size(); ++i) {
+    values[stage.outputs[i]] = stage_fetches[i];
+  }
+  return Status::OK();
+}
+
+common::Status PipelineParallelSession::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                            const std::vector<std::string>& output_names,
+                                            std::vector<OrtValue>* p_fetches) {
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+  if (!p_fetches->empty()) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "PipelineParallelSession doesn't support pre-allocated fetches.");
+  }
+  if (stages_.empty() || stages_.back().session == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Session was not initialized.");
+  }
+
+  // the values of each micro-batch, the feeds and the outputs of the stages that ran it
+  const int64_t num_micro_batches = GetNumMicroBatches(feeds);
+  std::vector<NameMLValMap> values(num_micro_batches);
+  if (num_micro_batches == 1) {
+    values[0] = feeds;
+  } else {
+    const int64_t batch_size = feeds.cbegin()->second.Get<Tensor>().Shape()[0];
+    for (int64_t m = 0; m < num_micro_batches; ++m) {
+      const int64_t first_row = m * micro_batch_size_;
+      const int64_t num_rows = std::min(micro_batch_size_, batch_size - first_row);
+      for (const auto& feed : feeds) {
+        values[m].emplace(feed.first, SliceRows(feed.second.Get<Tensor>(), first_row, num_rows));
+      }
+    }
+  }
+
+  // at step t, stage s runs micro-batch t - s, concurrently with the other stages
+  const auto num_stages = static_cast<int64_t>(stages_.size());
+  std::vector<std::vector<OrtValue>> micro_batch_fetches(num_micro_batches);
+  for (int64_t t = 0; t < num_micro_batches + num_stages - 1; ++t) {
+    const int64_t first_stage = std::max<int64_t>(0, t - num_micro_batches + 1);
+    const int64_t last_stage = std::min(t, num_stages - 1);
+    std::vector<Status> statuses(last_stage - first_stage + 1);
+    auto run_stage = [&](int32_t i) {
+      const int64_t s = first_stage + i;
+      auto& micro_batch_values = values[t - s];
+      statuses[i] = RunStage(s, run_options, micro_batch_values);
+      if (!statuses[i].IsOK() || s != num_stages - 1) {
+        return;
+      }
+
+      // the micro-batch went through the stages, keep its outputs only
+      auto& fetches = micro_batch_fetches[t - s];
+      for (const auto& name : output_names) {
+        auto it = micro_batch_values.find(name);
+        if (model_outputs_.count(name) == 0 || it == micro_batch_values.cend()) {
+          statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Output Name:", name);
+          return;
+        }
+        fetches.push_back(it->second);
+      }
+      micro_batch_values.clear();
+    };
+    if (statuses.size() > 1) {
+      stage_thread_pool_->ParallelFor(static_cast<int32_t>(statuses.size()), run_stage);
+    } else {
+      run_stage(0);
+    }
+
+    for (const auto& status : statuses) {
+      ORT_RETURN_IF_ERROR(status);
+    }
+  }
+
+  if (num_micro_batches == 1) {
+    *p_fetches = std::move(micro_batch_fetches[0]);
+    return Status::OK();
+  }
+  p_fetches->resize(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(ConcatRows(output_names[i], micro_batch_fetches, i, cpu_allocator_, (*p_fetches)[i]));
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
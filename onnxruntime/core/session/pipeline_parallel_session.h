@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/providers.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+  * Runs a model too large for the memory of one device, such as a GPU, across several devices: the nodes are split in
+  * topological order into contiguous stages with about the same size of initializers, and each stage runs in a
+  * session of its own with the execution provider created by its factory, such as the CUDA execution provider of one
+  * device id. The values passed from a stage to the next stay in device memory (see SessionOptions::device_outputs),
+  * and are copied from device to device, peer to peer where the devices allow it.
+  *
+  * A Run whose feeds are all CPU tensors with the same first dimension larger than micro_batch_size is split along
+  * that dimension into micro-batches of micro_batch_size rows, which go through the stages as a pipeline: while a
+  * stage runs a micro-batch the previous stage runs the next one, so the devices compute concurrently. The outputs
+  * are concatenated along their first dimension. The other Runs go through the stages whole.
+  *
+  * Sample usage:
+  *
+  *  std::vector<std::shared_ptr<IExecutionProviderFactory>> factories;
+  *  for (int device_id : {0, 1}) {
+  *    factories.push_back(CreateExecutionProviderFactory_CUDA(device_id));
+  *  }
+  *  PipelineParallelSession session(so, factories, 4);
+  *  common::Status status = session.Load(MODEL_URI);
+  *  status = session.Initialize();
+  *  status = session.Run(run_options, feeds, output_names, &fetches);
+  */
+class PipelineParallelSession {
+ public:
+  /**
+    * @param session_options the options of the session of every stage.
+    * @param provider_factories create the execution provider of each stage, at least one.
+    * @param micro_batch_size the rows of a micro-batch, 0 to never split Runs.
+    * @param logging_manager the logging manager of the stage sessions, see InferenceSession.
+    */
+  PipelineParallelSession(const SessionOptions& session_options,
+                          const std::vector<std::shared_ptr<IExecutionProviderFactory>>& provider_factories,
+                          int64_t micro_batch_size,
+                          logging::LoggingManager* logging_manager = nullptr);
+
+  ~PipelineParallelSession();
+
+  /**
+    * Load an ONNX model. Its initializers must be stored in the model, not in external data files.
+    * @param model_uri absolute path of the model file.
+    * @return OK if success.
+    */
+  common::Status Load(const std::string& model_uri);
+#ifdef _WIN32
+  common::Status Load(const std::wstring& model_uri);
+#endif
+  common::Status Load(const void* model_data, int model_data_len);
+
+  /**
+    * Split the model into stages and initialize their sessions.
+    * @return OK if success.
+    */
+  common::Status Initialize();
+
+  /**
+    * Run the model through the stages, see PipelineParallelSession.
+    * Multiple threads are allowed to run this function.
+    * @param output_names outputs of the model.
+    * @param fetches output values in the order of output_names, which must be empty as pre-allocated fetches aren't
+    * supported.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  size_t NumStages() const { return stages_.size(); }
+
+  InferenceSession& GetStage(size_t index) { return *stages_[index].session; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineParallelSession);
+
+  struct Stage {
+    std::unique_ptr<InferenceSession> session;
+    // the values the stage reads from the feeds of the Run or the outputs of the stages before it
+    std::vector<std::string> inputs;
+    // the values the stages after it read, and the outputs of the model it produces
+    std::vector<std::string> outputs;
+  };
+
+  // builds the model of each stage, with the nodes assigned to it and the initializers they read
+  common::Status CreateStageModels(std::vector<ONNX_NAMESPACE::ModelProto>& stage_models);
+
+  // returns the number of micro-batches the Run is split into
+  int64_t GetNumMicroBatches(const NameMLValMap& feeds) const;
+
+  common::Status RunStage(size_t stage_index, const RunOptions& run_options, NameMLValMap& values);
+
+  const SessionOptions session_options_;
+  const std::vector<std::shared_ptr<IExecutionProviderFactory>> provider_factories_;
+  const int64_t micro_batch_size_;
+  logging::LoggingManager* const logging_manager_;
+  // the model loaded, kept from Load until Initialize split it into the stages
+  std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
+  std::vector<Stage> stages_;
+  // the outputs of the model, which the Runs return
+  std::unordered_set<std::string> model_outputs_;
+  // runs the stages concurrently
+  std::unique_ptr<concurrency::ThreadPool> stage_thread_pool_;
+  // allocates the concatenated outputs of split Runs
+  AllocatorPtr cpu_allocator_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,609 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/model.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// the number of levels of the magnitudes of the values kEntropy quantizes a histogram to
+constexpr size_t kNumQuantizedBins = 128;
+
+// A MatMul or Conv with a constant float weight, by the names of its values.
+struct QuantizableNode {
+  bool is_conv;
+  std::string input;
+  std::string weight;
+  std::string output;
+};
+
+// Finds the quantizable nodes of the model, and the opset of its ONNX domain.
+Status FindQuantizableNodes(const ModelProto& model_proto, std::vector<QuantizableNode>& nodes, int& onnx_opset) {
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(model_proto, model));
+  const Graph& graph = model->MainGraph();
+
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  auto onnx_version = domain_to_version.find(kOnnxDomain);
+  onnx_opset = onnx_version != domain_to_version.end() ? onnx_version->second : 0;
+
+  for (const auto& node : graph.Nodes()) {
+    const bool is_conv = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11});
+    if (!is_conv && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) {
+      continue;
+    }
+
+    const auto& inputs = node.InputDefs();
+    const auto* weight = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+    if (inputs[0]->Type() == nullptr || *inputs[0]->Type() != "tensor(float)" || weight == nullptr ||
+        weight->data_type() != TensorProto_DataType_FLOAT ||
+        (is_conv ? weight->dims_size() < 3 : weight->dims_size() != 2)) {
+      continue;
+    }
+
+    nodes.push_back({is_conv, inputs[0]->Name(), inputs[1]->Name(), node.OutputDefs()[0]->Name()});
+  }
+  return Status::OK();
+}
+
+// The asymmetric uint8 quantization of [min, max], extended to include 0 so it's exactly representable.
+void GetUint8Quantization(float min, float max, float& scale, uint8_t& zero_point) {
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+  scale = (max - min) / 255.f;
+  if (scale == 0.f) {
+    scale = 1.f;
+  }
+  zero_point = static_cast<uint8_t>(std::nearbyint(std::min(255.f, std::max(0.f, -min / scale))));
+}
+
+uint8_t QuantizeValue(float value, float scale, uint8_t zero_point) {
+  return static_cast<uint8_t>(std::min(255.f, std::max(0.f, std::nearbyint(value / scale) + zero_point)));
+}
+
+// Creates the names of the values added to a graph, distinct from the names it already has.
+class NameGenerator {
+ public:
+  explicit NameGenerator(const GraphProto& graph_proto) {
+    for (const auto& node : graph_proto.node()) {
+      names_.insert(node.input().begin(), node.input().end());
+      names_.insert(node.output().begin(), node.output().end());
+    }
+    for (const auto& initializer : graph_proto.initializer()) {
+      names_.insert(initializer.name());
+    }
+    for (const auto& input : graph_proto.input()) {
+      names_.insert(input.name());
+    }
+  }
+
+  std::string Generate(const std::string& base_name) {
+    std::string name = base_name;
+    for (int i = 1; !names_.insert(name).second; ++i) {
+      name = base_name + "_" + std::to_string(i);
+    }
+    return name;
+  }
+
+ private:
+  std::unordered_set<std::string> names_;
+};
+
+TensorProto MakeScalar(const std::string& name, float value) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.add_float_data(value);
+  return tensor;
+}
+
+TensorProto MakeScalar(const std::string& name, uint8_t value) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_UINT8);
+  tensor.add_int32_data(value);
+  return tensor;
+}
+
+NodeProto MakeNode(const std::string& op_type, const std::vector<std::string>& inputs,
+                   const std::vector<std::string>& outputs, const std::string& domain = kOnnxDomain) {
+  NodeProto node;
+  node.set_op_type(op_type);
+  node.set_domain(domain);
+  for (const auto& input : inputs) {
+    node.add_input(input);
+  }
+  for (const auto& output : outputs) {
+    node.add_output(output);
+  }
+  return node;
+}
+
+// Rewrites the graph of a model, node by node, removing the float weights that were quantized.
+class GraphQuantizer {
+ public:
+  explicit GraphQuantizer(GraphProto& graph_proto) : graph_proto_{graph_proto}, names_{graph_proto} {
+    for (int i = 0; i < graph_proto.initializer_size(); ++i) {
+      initializers_[graph_proto.initializer(i).name()] = &graph_proto.initializer(i);
+    }
+  }
+
+  NameGenerator& Names() { return names_; }
+
+  void AddNode(NodeProto node) {
+    *nodes_.Add() = std::move(node);
+  }
+
+  void AddInitializer(TensorProto initializer) {
+    *new_initializers_.Add() = std::move(initializer);
+  }
+
+  // Quantizes a float weight to uint8 per tensor, or symmetrically per slice of its first dimension with a zero
+  // point of 128 if per_channel is set. Returns the names of the quantized weight, its zero point and its scale.
+  std::vector<std::string> QuantizeWeight(const std::string& weight, bool per_channel) {
+    auto cached = quantized_weights_.find(weight);
+    if (cached != quantized_weights_.end()) {
+      return cached->second;
+    }
+
+    const TensorProto& weight_proto = *initializers_.at(weight);
+    Initializer values(&weight_proto);
+    const float* data = values.data<float>();
+    const int64_t size = values.size();
+    const int64_t num_channels = per_channel ? weight_proto.dims(0) : 1;
+    const int64_t channel_size = size / num_channels;
+
+    std::vector<float> scales(static_cast<size_t>(num_channels));
+    uint8_t zero_point = 128;
+    std::string quantized_data(static_cast<size_t>(size), '\0');
+    for (int64_t m = 0; m < num_channels; ++m) {
+      const float* channel = data + m * channel_size;
+      const auto min_max = std::minmax_element(channel, channel + channel_size);
+      if (per_channel) {
+        const float max_abs = std::max(std::abs(*min_max.first), std::abs(*min_max.second));
+        scales[m] = max_abs > 0.f ? max_abs / 127.f : 1.f;
+      } else {
+        GetUint8Quantization(*min_max.first, *min_max.second, scales[m], zero_point);
+      }
+      for (int64_t i = 0; i < channel_size; ++i) {
+        quantized_data[m * channel_size + i] = static_cast<char>(QuantizeValue(channel[i], scales[m], zero_point));
+      }
+    }
+
+    TensorProto quantized_weight;
+    quantized_weight.set_name(names_.Generate(weight + "_quantized"));
+    quantized_weight.set_data_type(TensorProto_DataType_UINT8);
+    *quantized_weight.mutable_dims() = weight_proto.dims();
+    quantized_weight.set_raw_data(std::move(quantized_data));
+
+    TensorProto scale;
+    scale.set_name(names_.Generate(weight + "_scale"));
+    scale.set_data_type(TensorProto_DataType_FLOAT);
+    if (per_channel) {
+      scale.add_dims(num_channels);
+    }
+    for (float value : scales) {
+      scale.add_float_data(value);
+    }
+
+    // a DequantizeLinear along an axis takes as many zero points as scales
+    TensorProto zero_points = MakeScalar(names_.Generate(weight + "_zero_point"), zero_point);
+    if (per_channel) {
+      zero_points.add_dims(num_channels);
+      for (int64_t m = 1; m < num_channels; ++m) {
+        zero_points.add_int32_data(zero_point);
+      }
+    }
+
+    std::vector<std::string> names{quantized_weight.name(), zero_points.name(), scale.name()};
+    AddInitializer(std::move(quantized_weight));
+    AddInitializer(std::move(zero_points));
+    AddInitializer(std::move(scale));
+    quantized_weights_[weight] = names;
+    return names;
+  }
+
+  // Replaces the nodes and the weights that were quantized.
+  void Finalize() {
+    std::unordered_set<std::string> used_values;
+    for (const auto& node : nodes_) {
+      used_values.insert(node.input().begin(), node.input().end());
+    }
+
+    auto is_removed = [this, &used_values](const std::string& name) {
+      return quantized_weights_.count(name) && !used_values.count(name);
+    };
+
+    google::protobuf::RepeatedPtrField<TensorProto> initializers;
+    for (auto& initializer : *graph_proto_.mutable_initializer()) {
+      if (!is_removed(initializer.name())) {
+        *initializers.Add() = std::move(initializer);
+      }
+    }
+    for (auto& initializer : new_initializers_) {
+      *initializers.Add() = std::move(initializer);
+    }
+
+    graph_proto_.mutable_initializer()->Swap(&initializers);
+
+    // models before IR version 4 list their initializers as inputs too
+    auto& inputs = *graph_proto_.mutable_input();
+    inputs.erase(std::remove_if(inputs.begin(), inputs.end(),
+                                [&is_removed](const ValueInfoProto& input) { return is_removed(input.name()); }),
+                 inputs.end());
+    graph_proto_.mutable_node()->Swap(&nodes_);
+  }
+
+ private:
+  GraphProto& graph_proto_;
+  NameGenerator names_;
+  std::unordered_map<std::string, const TensorProto*> initializers_;
+  std::unordered_map<std::string, std::vector<std::string>> quantized_weights_;
+  google::protobuf::RepeatedPtrField<NodeProto> nodes_;
+  google::protobuf::RepeatedPtrField<TensorProto> new_initializers_;
+};
+
+// The threshold of the magnitudes of a histogram whose quantization to kNumQuantizedBins levels diverges the least
+// from the histogram, with the magnitudes beyond the threshold clipped to it.
+float GetEntropyThreshold(const std::vector<uint64_t>& counts, float bin_width) {
+  const size_t num_bins = counts.size();
+  if (num_bins <= kNumQuantizedBins) {
+    return num_bins * bin_width;
+  }
+
+  size_t best_num_bins = num_bins;
+  double best_divergence = std::numeric_limits<double>::infinity();
+  std::vector<double> reference(num_bins);
+  std::vector<double> candidate(num_bins);
+  uint64_t outliers = 0;
+  for (size_t i = kNumQuantizedBins; i <= num_bins; ++i) {
+    outliers = 0;
+    for (size_t j = i; j < num_bins; ++j) {
+      outliers += counts[j];
+    }
+
+    // the reference keeps the first i bins, with the outliers clipped into the last one
+    std::copy(counts.begin(), counts.begin() + i, reference.begin());
+    reference[i - 1] += static_cast<double>(outliers);
+
+    // the candidate merges the first i bins into kNumQuantizedBins levels, each spread evenly over the nonzero bins
+    // it merges
+    std::fill(candidate.begin(), candidate.begin() + i, 0.);
+    for (size_t level = 0; level < kNumQuantizedBins; ++level) {
+      const size_t begin = level * i / kNumQuantizedBins;
+      const size_t end = (level + 1) * i / kNumQuantizedBins;
+      double sum = 0.;
+      size_t nonzero = 0;
+      for (size_t j = begin; j < end; ++j) {
+        sum += static_cast<double>(counts[j]);
+        nonzero += counts[j] != 0;
+      }
+      for (size_t j = begin; j < end; ++j) {
+        candidate[j] = counts[j] != 0 ? sum / nonzero : 0.;
+      }
+    }
+    // the clipped outliers are counted with the last level
+    candidate[i - 1] += static_cast<double>(outliers);
+
+    double reference_sum = 0.;
+    double candidate_sum = 0.;
+    for (size_t j = 0; j < i; ++j) {
+      reference_sum += reference[j];
+      candidate_sum += candidate[j];
+    }
+    if (reference_sum == 0. || candidate_sum == 0.) {
+      continue;
+    }
+
+    double divergence = 0.;
+    for (size_t j = 0; j < i; ++j) {
+      if (reference[j] == 0.) {
+        continue;
+      }
+      const double p = reference[j] / reference_sum;
+      const double q = candidate[j] / candidate_sum;
+      divergence += q > 0. ? p * std::log(p / q) : std::numeric_limits<double>::infinity();
+    }
+
+    if (divergence < best_divergence) {
+      best_divergence = divergence;
+      best_num_bins = i;
+    }
+  }
+
+  return best_num_bins * bin_width;
+}
+
+}  // namespace
+
+// The range of the values of an activation, and the histogram of their magnitudes over [0, max_abs] for the
+// methods that clip.
+struct Calibrator::Histogram {
+  float min = std::numeric_limits<float>::max();
+  float max = std::numeric_limits<float>::lowest();
+  float max_abs = 0.f;
+  uint64_t count = 0;
+  std::vector<uint64_t> counts;
+
+  void Update(const float* data, size_t size, size_t num_bins) {
+    if (size == 0) {
+      return;
+    }
+    const auto min_max = std::minmax_element(data, data + size);
+    min = std::min(min, *min_max.first);
+    max = std::max(max, *min_max.second);
+    count += size;
+    if (num_bins == 0) {
+      return;
+    }
+
+    // a larger magnitude widens the bins, merging the counts so far into the new ones
+    const float batch_max_abs = std::max(std::abs(*min_max.first), std::abs(*min_max.second));
+    if (counts.empty()) {
+      counts.assign(num_bins, 0);
+      max_abs = batch_max_abs;
+    } else if (batch_max_abs > max_abs) {
+      std::vector<uint64_t> merged(num_bins, 0);
+      for (size_t i = 0; i < num_bins; ++i) {
+        const float center = (i + 0.5f) * max_abs / num_bins;
+        merged[std::min(num_bins - 1, static_cast<size_t>(center / batch_max_abs * num_bins))] += counts[i];
+      }
+      counts.swap(merged);
+      max_abs = batch_max_abs;
+    }
+
+    if (max_abs == 0.f) {
+      counts[0] += size;
+      return;
+    }
+    const float bins_per_unit = num_bins / max_abs;
+    for (size_t i = 0; i < size; ++i) {
+      ++counts[std::min(num_bins - 1, static_cast<size_t>(std::abs(data[i]) * bins_per_unit))];
+    }
+  }
+};
+
+Calibrator::Calibrator(const ModelProto& model_proto, const CalibrationOptions& options,
+                       logging::LoggingManager* logging_manager)
+    : model_proto_{model_proto}, options_{options}, logging_manager_{logging_manager} {
+}
+
+Calibrator::~Calibrator() = default;
+
+Status Calibrator::Initialize() {
+  std::vector<QuantizableNode> nodes;
+  int onnx_opset;
+  ORT_RETURN_IF_ERROR(FindQuantizableNodes(model_proto_, nodes, onnx_opset));
+
+  ModelProto calibration_model = model_proto_;
+  GraphProto& graph_proto = *calibration_model.mutable_graph();
+  std::unordered_set<std::string> outputs;
+  for (const auto& output : graph_proto.output()) {
+    outputs.insert(output.name());
+  }
+
+  // the activations are fetched as outputs of the graph
+  std::unordered_set<std::string> values;
+  for (const auto& node : nodes) {
+    for (const auto* value : {&node.input, &node.output}) {
+      if (!values.insert(*value).second) {
+        continue;
+      }
+      value_names_.push_back(*value);
+      if (!outputs.count(*value)) {
+        auto& output = *graph_proto.add_output();
+        output.set_name(*value);
+        output.mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+      }
+    }
+  }
+  histograms_.resize(value_names_.size());
+
+  std::string model_data;
+  if (!calibration_model.SerializeToString(&model_data)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to serialize the calibration model");
+  }
+
+  SessionOptions so;
+  so.session_logid = "Calibrator";
+  // the optimizations could fuse the activations away or change their values
+  so.graph_optimization_level = TransformerLevel::Default;
+  session_ = std::make_unique<InferenceSession>(so, logging_manager_);
+  ORT_RETURN_IF_ERROR(session_->Load(model_data.data(), static_cast<int>(model_data.size())));
+  return session_->Initialize();
+}
+
+Status Calibrator::Collect(const NameMLValMap& feeds) {
+  ORT_RETURN_IF_NOT(session_ != nullptr, "The calibrator must be initialized before collecting data");
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(session_->Run(RunOptions(), feeds, value_names_, &fetches));
+
+  const size_t num_bins = options_.method == CalibrationMethod::kMinMax ? 0 : options_.num_bins;
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const Tensor& tensor = fetches[i].Get<Tensor>();
+    ORT_RETURN_IF_NOT(tensor.IsDataType<float>(), "The activation ", value_names_[i], " is not a float tensor");
+    histograms_[i].Update(tensor.Data<float>(), static_cast<size_t>(tensor.Shape().Size()), num_bins);
+  }
+  return Status::OK();
+}
+
+Status Calibrator::ComputeRanges(std::unordered_map<std::string, QuantizationRange>& ranges) const {
+  for (size_t i = 0; i < value_names_.size(); ++i) {
+    const Histogram& histogram = histograms_[i];
+    ORT_RETURN_IF_NOT(histogram.count > 0, "No values of the activation ", value_names_[i], " were collected");
+
+    QuantizationRange range{histogram.min, histogram.max};
+    if (options_.method != CalibrationMethod::kMinMax && histogram.max_abs > 0.f) {
+      const float bin_width = histogram.max_abs / histogram.counts.size();
+      float threshold = histogram.max_abs;
+      if (options_.method == CalibrationMethod::kPercentile) {
+        const double kept = histogram.count * static_cast<double>(options_.percentile) / 100.;
+        uint64_t cumulative = 0;
+        for (size_t bin = 0; bin < histogram.counts.size(); ++bin) {
+          cumulative += histogram.counts[bin];
+          if (cumulative >= kept) {
+            threshold = (bin + 1) * bin_width;
+            break;
+          }
+        }
+      } else {
+        threshold = GetEntropyThreshold(histogram.counts, bin_width);
+      }
+      range.min = std::max(range.min, -threshold);
+      range.max = std::min(range.max, threshold);
+    }
+    ranges[value_names_[i]] = range;
+  }
+  return Status::OK();
+}
+
+Status QuantizeModelStatic(ModelProto& model_proto, const std::unordered_map<std::string, QuantizationRange>& ranges,
+                           bool per_channel) {
+  std::vector<QuantizableNode> nodes;
+  int onnx_opset;
+  ORT_RETURN_IF_ERROR(FindQuantizableNodes(model_proto, nodes, onnx_opset));
+  ORT_RETURN_IF_NOT(onnx_opset >= 10, "Static quantization requires opset 10 or above, the model imports opset ",
+                    onnx_opset);
+
+  std::unordered_map<std::string, const QuantizableNode*> nodes_by_output;
+  for (const auto& node : nodes) {
+    if (ranges.count(node.input) && ranges.count(node.output)) {
+      nodes_by_output[node.output] = &node;
+    }
+  }
+
+  GraphProto& graph_proto = *model_proto.mutable_graph();
+  GraphQuantizer quantizer(graph_proto);
+  NameGenerator& names = quantizer.Names();
+
+  // the quantized and dequantized values of each activation, by name. The output of a quantized node is produced by
+  // its DequantizeLinear, so the nodes using it dequantize the same uint8 values
+  std::unordered_map<std::string, std::string> dequantized_values;
+  auto quantize_activation = [&](const QuantizationRange& range, const std::string& value,
+                                 const std::string& quantized_value, const std::string& dequantized_value) {
+    float scale;
+    uint8_t zero_point;
+    GetUint8Quantization(range.min, range.max, scale, zero_point);
+    const std::string scale_name = names.Generate(value + "_scale");
+    const std::string zero_point_name = names.Generate(value + "_zero_point");
+    quantizer.AddInitializer(MakeScalar(scale_name, scale));
+    quantizer.AddInitializer(MakeScalar(zero_point_name, zero_point));
+    quantizer.AddNode(MakeNode("QuantizeLinear", {value, scale_name, zero_point_name}, {quantized_value}));
+    quantizer.AddNode(MakeNode("DequantizeLinear", {quantized_value, scale_name, zero_point_name},
+                               {dequantized_value}));
+  };
+
+  for (auto& node : *graph_proto.mutable_node()) {
+    auto quantizable = node.output_size() > 0 ? nodes_by_output.find(node.output(0)) : nodes_by_output.end();
+    if (quantizable == nodes_by_output.end()) {
+      quantizer.AddNode(std::move(node));
+      continue;
+    }
+    const QuantizableNode& q = *quantizable->second;
+
+    if (!dequantized_values.count(q.input)) {
+      dequantized_values[q.input] = names.Generate(q.input + "_dequantized");
+      quantize_activation(ranges.at(q.input), q.input, names.Generate(q.input + "_quantized"),
+                          dequantized_values[q.input]);
+    }
+
+    const bool per_channel_weight = per_channel && q.is_conv;
+    const auto weight = quantizer.QuantizeWeight(q.weight, per_channel_weight);
+    const std::string dequantized_weight = names.Generate(q.weight + "_dequantized");
+    if (per_channel_weight) {
+      NodeProto dequantize = MakeNode("DequantizeLinear", {weight[0], weight[2], weight[1]}, {dequantized_weight},
+                                      kMSDomain);
+      auto& axis = *dequantize.add_attribute();
+      axis.set_name("axis");
+      axis.set_type(AttributeProto_AttributeType_INT);
+      axis.set_i(0);
+      quantizer.AddNode(std::move(dequantize));
+    } else {
+      quantizer.AddNode(MakeNode("DequantizeLinear", {weight[0], weight[2], weight[1]}, {dequantized_weight}));
+    }
+
+    const std::string float_output = names.Generate(q.output + "_float");
+    node.set_input(0, dequantized_values[q.input]);
+    node.set_input(1, dequantized_weight);
+    node.set_output(0, float_output);
+    quantizer.AddNode(std::move(node));
+
+    // the output keeps its name, produced by the DequantizeLinear
+    quantize_activation(ranges.at(q.output), float_output, names.Generate(q.output + "_quantized"), q.output);
+    dequantized_values[q.output] = q.output;
+  }
+
+  quantizer.Finalize();
+  return Status::OK();
+}
+
+Status QuantizeModelDynamic(ModelProto& model_proto) {
+  std::vector<QuantizableNode> nodes;
+  int onnx_opset;
+  ORT_RETURN_IF_ERROR(FindQuantizableNodes(model_proto, nodes, onnx_opset));
+  ORT_RETURN_IF_NOT(onnx_opset >= 11, "Dynamic quantization requires opset 11 or above, the model imports opset ",
+                    onnx_opset);
+
+  std::unordered_map<std::string, const QuantizableNode*> nodes_by_output;
+  for (const auto& node : nodes) {
+    if (!node.is_conv) {
+      nodes_by_output[node.output] = &node;
+    }
+  }
+
+  GraphProto& graph_proto = *model_proto.mutable_graph();
+  GraphQuantizer quantizer(graph_proto);
+  NameGenerator& names = quantizer.Names();
+
+  // the outputs of the DynamicQuantizeLinear of each input: the values, their scale and their zero point
+  std::unordered_map<std::string, std::vector<std::string>> quantized_inputs;
+  for (auto& node : *graph_proto.mutable_node()) {
+    auto quantizable = node.output_size() > 0 ? nodes_by_output.find(node.output(0)) : nodes_by_output.end();
+    if (quantizable == nodes_by_output.end()) {
+      quantizer.AddNode(std::move(node));
+      continue;
+    }
+    const QuantizableNode& q = *quantizable->second;
+
+    auto& input = quantized_inputs[q.input];
+    if (input.empty()) {
+      input = {names.Generate(q.input + "_quantized"), names.Generate(q.input + "_scale"),
+               names.Generate(q.input + "_zero_point")};
+      quantizer.AddNode(MakeNode("DynamicQuantizeLinear", {q.input}, input));
+    }
+
+    const auto weight = quantizer.QuantizeWeight(q.weight, false);
+    const std::string integer_output = names.Generate(q.output + "_int32");
+    const std::string float_output = names.Generate(q.output + "_unscaled");
+    const std::string output_scale = names.Generate(q.output + "_scale");
+    quantizer.AddNode(MakeNode("MatMulInteger", {input[0], weight[0], input[2], weight[1]}, {integer_output}));
+
+    NodeProto cast = MakeNode("Cast", {integer_output}, {float_output});
+    auto& to = *cast.add_attribute();
+    to.set_name("to");
+    to.set_type(AttributeProto_AttributeType_INT);
+    to.set_i(TensorProto_DataType_FLOAT);
+    quantizer.AddNode(std::move(cast));
+
+    quantizer.AddNode(MakeNode("Mul", {input[1], weight[2]}, {output_scale}));
+    quantizer.AddNode(MakeNode("Mul", {float_output, output_scale}, {q.output}));
+  }
+
+  quantizer.Finalize();
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/framework_common.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+  * How the range of the values of a tensor is chosen from the values seen during calibration.
+  * kMinMax keeps all the values, kPercentile clips the largest magnitudes beyond the given percentile of them, and
+  * kEntropy clips at the threshold whose quantized distribution diverges the least (Kullback-Leibler) from the
+  * distribution seen.
+  */
+enum class CalibrationMethod {
+  kMinMax,
+  kPercentile,
+  kEntropy
+};
+
+struct CalibrationOptions {
+  CalibrationMethod method = CalibrationMethod::kMinMax;
+  // the percentile of the magnitudes kept by kPercentile
+  float percentile = 99.99f;
+  // the number of bins of the histograms of magnitudes of kPercentile and kEntropy
+  size_t num_bins = 2048;
+};
+
+struct QuantizationRange {
+  float min;
+  float max;
+};
+
+/**
+  * Collects the ranges of the activations of the MatMul and Conv nodes of a model that QuantizeModelStatic
+  * quantizes, over calibration data.
+  *
+  * The calibration session runs the model with these activations added to its outputs, so the values are observed
+  * as they are computed, without graph optimizations that would change them.
+  *
+  * Sample usage:
+  *
+  *  Calibrator calibrator(model_proto, options);
+  *  status = calibrator.Initialize();
+  *  for (const auto& feeds : calibration_data) {
+  *    status = calibrator.Collect(feeds);
+  *  }
+  *  status = calibrator.ComputeRanges(ranges);
+  *  status = QuantizeModelStatic(model_proto, ranges, true);
+  */
+class Calibrator {
+ public:
+  /**
+    * @param logging_manager the logging manager of the calibration session, see InferenceSession.
+    */
+  Calibrator(const ONNX_NAMESPACE::ModelProto& model_proto, const CalibrationOptions& options,
+             logging::LoggingManager* logging_manager = nullptr);
+
+  ~Calibrator();
+
+  common::Status Initialize();
+
+  /**
+    * Runs the model on a batch of calibration data and accumulates the values of the activations.
+    */
+  common::Status Collect(const NameMLValMap& feeds);
+
+  /**
+    * The range of each activation, by name, for the calibration method. Fails if nothing was collected.
+    */
+  common::Status ComputeRanges(std::unordered_map<std::string, QuantizationRange>& ranges) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Calibrator);
+
+  struct Histogram;
+
+  ONNX_NAMESPACE::ModelProto model_proto_;
+  CalibrationOptions options_;
+  logging::LoggingManager* logging_manager_;
+  std::unique_ptr<InferenceSession> session_;
+  std::vector<std::string> value_names_;
+  std::vector<Histogram> histograms_;
+};
+
+/**
+  * Quantizes the MatMul and Conv nodes of a model with constant float weights and uint8 activations.
+  *
+  * The weights are replaced with uint8 initializers, per tensor, or per output channel for the filters of Conv
+  * nodes if per_channel is set. The activations with a range are quantized with QuantizeLinear and
+  * DequantizeLinear nodes around the nodes, so the model still runs in float where the QDQFusion transformer doesn't
+  * apply, and runs QLinearMatMul and QLinearConv where it does. A quantized node whose input or output has no
+  * range is left in float. The model must import opset 10 or above of the ONNX domain.
+  */
+common::Status QuantizeModelStatic(ONNX_NAMESPACE::ModelProto& model_proto,
+                                   const std::unordered_map<std::string, QuantizationRange>& ranges,
+                                   bool per_channel);
+
+/**
+  * Quantizes the MatMul nodes of a model with constant float weights, whose inputs are quantized at run time:
+  * each MatMul becomes a DynamicQuantizeLinear of its input and a MatMulInteger with the uint8 weight, whose result
+  * is scaled back to float. The model must import opset 11 or above of the ONNX domain.
+  */
+common::Status QuantizeModelDynamic(ONNX_NAMESPACE::ModelProto& model_proto);
+
+}  // namespace onnxruntime
@@ -52,4 +52,26 @@ class EuclideanWithEigen {
     return std::sqrt((ConstEigenVectorMap<T>(a1, n) - ConstEigenVectorMap<T>(b1, n)).array().square().sum());
   }
 };
+
+// Computes the city block (Manhattan) distance between the vectors.
+template <typename T>
+class Cityblock {
+ public:
+  T operator()(const T* a1, const T* b1, size_t n) const {
+    // if n is too small, Eigen is much slower than a plain loop
+    T sum = 0;
+    for (size_t k = 0; k != n; ++k) {
+      sum += std::abs(a1[k] - b1[k]);
+    }
+    return sum;
+  }
+};
+
+template <typename T>
+class CityblockWithEigen {
+ public:
+  T operator()(const T* a1, const T* b1, size_t n) const {
+    return (ConstEigenVectorMap<T>(a1, n) - ConstEigenVectorMap<T>(b1, n)).array().abs().sum();
+  }
+};
 }  // namespace onnxruntime
\ No newline at end of file
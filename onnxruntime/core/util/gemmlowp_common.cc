@@ -4,6 +4,8 @@
 #include "core/util/gemmlowp_common_wrapper.h"
 #include "core/util/gemmlowp_common.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 
 void GemmlowpMultiplyu8u8_u8(const uint8_t* lhs_data, const uint8_t* rhs_data, uint8_t* result_data,
@@ -46,4 +48,16 @@ void GemmlowpMultiplyu8u8_s32(const uint8_t* lhs_data, const uint8_t* rhs_data,
       &gemm_context, lhs, rhs, &result, -lhs_offset, -rhs_offset, empty_pipeline);
 
 }
-}
\ No newline at end of file
+
+void QuantizeDownInt32ToUint8(const int32_t* input, uint8_t* output, int rows, int cols, const int32_t* bias,
+                              std::int32_t result_offset, std::int32_t result_mult_int, std::int32_t result_shift) {
+  for (int row = 0; row < rows; row++) {
+    const std::int32_t row_bias = bias == nullptr ? 0 : bias[row];
+    for (int col = 0; col < cols; col++) {
+      std::int32_t value = gemmlowp::SaturatingRoundingDoublingHighMul(*input++ + row_bias, result_mult_int);
+      value = gemmlowp::RoundingDivideByPOT(value, result_shift) + result_offset;
+      *output++ = static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+    }
+  }
+}
+}
@@ -59,6 +59,11 @@ void GemmlowpMultiplyu8u8_u8(const uint8_t* lhs_data, const uint8_t* rhs_data, u
                         const int lhs_offset, const int rhs_offset, const int result_offset,
                         int m, int n, int k, int32_t int_multiplier, int32_t right_shift, const int32_t* bias = nullptr);
 
+// Requantizes the int32 result of a GEMM to uint8 with the same fixed point steps as the output pipelines above,
+// so results match whichever GEMM produced the int32 values. bias is optional and holds one value per row.
+void QuantizeDownInt32ToUint8(const int32_t* input, uint8_t* output, int rows, int cols, const int32_t* bias,
+                              std::int32_t result_offset, std::int32_t result_mult_int, std::int32_t result_shift);
+
 void GemmlowpMultiplyu8u8_s32(const uint8_t* lhs_data, const uint8_t* rhs_data, int32_t* result_data,
                              const int lhs_offset, const int rhs_offset, int m, int n, int k, concurrency::ThreadPool*);
 
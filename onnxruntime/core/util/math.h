@@ -79,6 +79,22 @@ void MatMul(
     const T* B,
     T* C, concurrency::ThreadPool* threadpool);
 
+// Runs batch_count MatMuls whose matrices are separated by constant strides, splitting the work of the whole
+// batch across the thread pool at once. A stride of 0 reuses the same matrix for every multiply.
+template <typename T>
+void MatMulBatch(
+    int M,
+    int N,
+    int K,
+    const T* A,
+    size_t stride_a,
+    const T* B,
+    size_t stride_b,
+    T* C,
+    size_t stride_c,
+    size_t batch_count,
+    concurrency::ThreadPool* threadpool);
+
 // Decaf gemm provides a simpler interface to the gemm functions, with the
 // limitation that the data has to be contiguous in memory.
 template <typename T, class Provider>
@@ -76,6 +76,13 @@ void MatMul<float>(int M, int N, int K, const float* A, const float* B, float* C
   MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.f, A, K, B, N, 0.f, C, N, threadpool);
 }
 
+template <>
+void MatMulBatch<float>(int M, int N, int K, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                        float* C, size_t stride_c, size_t batch_count, ThreadPool* threadpool) {
+  MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.f, A, K, stride_a, B, N, stride_b, 0.f, C, N, stride_c,
+                 batch_count, threadpool);
+}
+
 EIGEN_MATMUL_FUNCTION(double)
 
 template <>
@@ -145,6 +152,15 @@ void MatMul<float>(int M, int N, int K, const float* A, const float* B, float* C
   cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, 1, A, K, B, N, 0, C, N);
 }
 
+template <>
+void MatMulBatch<float>(int M, int N, int K, const float* A, size_t stride_a, const float* B, size_t stride_b,
+                        float* C, size_t stride_c, size_t batch_count, ThreadPool*) {
+  for (size_t i = 0; i < batch_count; i++) {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, 1, A + i * stride_a, K, B + i * stride_b, N, 0,
+                C + i * stride_c, N);
+  }
+}
+
 template <>
 void MatMul<double>(int M, int N, int K, const double* A, const double* B, double* C, ThreadPool*) {
   cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, 1, A, K, B, N, 0, C, N);
@@ -4,6 +4,10 @@
 #include "core/util/qmath.h"
 #include "core/common/common.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace onnxruntime {
 
 void QGemmu8u8_s32(
@@ -30,4 +34,160 @@ void QGemmu8u8_s32(
 
 #endif
 }
+
+void QGemmBatchu8u8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    size_t lhs_stride,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    size_t rhs_stride,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    size_t result_stride,
+    size_t batch_count,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+  for (size_t i = 0; i < batch_count; i++) {
+    GemmlowpMultiplyu8u8_s32(lhs_data + i * lhs_stride, rhs_data + i * rhs_stride, result_data + i * result_stride,
+                             lhs_offset, rhs_offset, M, N, K, thread_pool);
+  }
+#else
+  MlasQgemmBatch(M, N, K, lhs_data, K, lhs_stride, lhs_offset, rhs_data, N, rhs_stride, rhs_offset,
+                 result_data, N, result_stride, batch_count, thread_pool);
+#endif
+}
+
+bool QGemmPackBu8(const Tensor& rhs, const AllocatorPtr& alloc, BufferUniquePtr& packed_rhs) {
+  packed_rhs.reset();
+
+#ifdef USE_GEMMLOWP
+  // gemmlowp packs its inputs on every call
+  ORT_UNUSED_PARAMETER(rhs);
+  ORT_UNUSED_PARAMETER(alloc);
+  return false;
+#else
+  const auto& shape = rhs.Shape();
+  if (rhs.DataType() != DataTypeImpl::GetType<uint8_t>() || shape.NumDimensions() != 2 || shape.Size() == 0) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(shape[0]);
+  const size_t N = static_cast<size_t>(shape[1]);
+  return QGemmPackBu8(N, K, rhs.Data<uint8_t>(), N, alloc, packed_rhs);
+#endif
+}
+
+bool QGemmPackBu8(size_t N, size_t K, const uint8_t* rhs_data, size_t ldb, const AllocatorPtr& alloc,
+                  BufferUniquePtr& packed_rhs) {
+  packed_rhs.reset();
+
+#ifdef USE_GEMMLOWP
+  ORT_UNUSED_PARAMETER(N);
+  ORT_UNUSED_PARAMETER(K);
+  ORT_UNUSED_PARAMETER(rhs_data);
+  ORT_UNUSED_PARAMETER(ldb);
+  ORT_UNUSED_PARAMETER(alloc);
+  return false;
+#else
+  if (N == 0 || K == 0) {
+    return false;
+  }
+
+  void* buffer = alloc->Alloc(MlasQgemmPackBSize(N, K));
+  packed_rhs = BufferUniquePtr(buffer, BufferDeleter(alloc));
+  MlasQgemmPackB(N, K, rhs_data, ldb, buffer);
+  return true;
+#endif
+}
+
+void QGemmu8u8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const void* packed_rhs,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    int ldc,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+  ORT_UNUSED_PARAMETER(M);
+  ORT_UNUSED_PARAMETER(N);
+  ORT_UNUSED_PARAMETER(K);
+  ORT_UNUSED_PARAMETER(lhs_data);
+  ORT_UNUSED_PARAMETER(lda);
+  ORT_UNUSED_PARAMETER(lhs_offset);
+  ORT_UNUSED_PARAMETER(packed_rhs);
+  ORT_UNUSED_PARAMETER(rhs_offset);
+  ORT_UNUSED_PARAMETER(result_data);
+  ORT_UNUSED_PARAMETER(ldc);
+  ORT_UNUSED_PARAMETER(thread_pool);
+  ORT_THROW("Packed matrices are not supported with gemmlowp");
+#else
+  MlasQgemm(M, N, K, lhs_data, lda, lhs_offset, packed_rhs, rhs_offset, result_data, ldc, thread_pool);
+#endif
+}
+
+void QGemmApplyRowOffsets(int M, int N, int K, const uint8_t* lhs_offsets, const uint8_t* rhs_data, int ldb,
+                          uint8_t rhs_offset, int32_t* result_data, int ldc) {
+  std::vector<int32_t> column_sums(static_cast<size_t>(N), -K * static_cast<int32_t>(rhs_offset));
+  for (int k = 0; k < K; ++k) {
+    const uint8_t* row = rhs_data + static_cast<size_t>(k) * ldb;
+    for (int n = 0; n < N; ++n) {
+      column_sums[n] += row[n];
+    }
+  }
+
+  for (int m = 0; m < M; ++m) {
+    const int32_t lhs_offset = lhs_offsets[m];
+    int32_t* result_row = result_data + static_cast<size_t>(m) * ldc;
+    for (int n = 0; n < N; ++n) {
+      result_row[n] -= lhs_offset * column_sums[n];
+    }
+  }
+}
+
+void QGemmApplyColumnOffsets(int M, int N, int K, const uint8_t* lhs_data, int lda, uint8_t lhs_offset,
+                             const uint8_t* rhs_offsets, int32_t* result_data, int ldc) {
+  for (int m = 0; m < M; ++m) {
+    const uint8_t* lhs_row = lhs_data + static_cast<size_t>(m) * lda;
+    int32_t row_sum = -K * static_cast<int32_t>(lhs_offset);
+    for (int k = 0; k < K; ++k) {
+      row_sum += lhs_row[k];
+    }
+
+    int32_t* result_row = result_data + static_cast<size_t>(m) * ldc;
+    for (int n = 0; n < N; ++n) {
+      result_row[n] -= row_sum * static_cast<int32_t>(rhs_offsets[n]);
+    }
+  }
+}
+
+void DynamicQuantizeu8(int M, int K, const float* A, int lda, uint8_t* quantized, float& scale, uint8_t& zero_point) {
+  float min = 0.f;
+  float max = 0.f;
+  for (int m = 0; m < M; ++m) {
+    const float* row = A + m * lda;
+    for (int k = 0; k < K; ++k) {
+      min = std::min(min, row[k]);
+      max = std::max(max, row[k]);
+    }
+  }
+
+  scale = max > min ? (max - min) / 255.f : 1.f;
+  zero_point = static_cast<uint8_t>(std::max(0.f, std::min(255.f, std::nearbyint(-min / scale))));
+
+  for (int m = 0; m < M; ++m) {
+    const float* row = A + m * lda;
+    for (int k = 0; k < K; ++k) {
+      const float value = std::nearbyint(row[k] / scale) + zero_point;
+      *quantized++ = static_cast<uint8_t>(std::max(0.f, std::min(255.f, value)));
+    }
+  }
+}
 }  // namespace onnxruntime
\ No newline at end of file
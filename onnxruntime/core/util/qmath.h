@@ -15,6 +15,7 @@
 #else
 #include "core/mlas/inc/mlas.h"
 #endif
+#include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 #include <mutex>
 #include <thread>
@@ -35,4 +36,58 @@ void QGemmu8u8_s32(
     int ldc,
     concurrency::ThreadPool* thread_pool);
 
+// Runs batch_count QGemmu8u8_s32 multiplies of row major matrices separated by constant strides, splitting the
+// work of the whole batch across the thread pool at once. A stride of 0 reuses the same matrix for every multiply.
+void QGemmBatchu8u8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    size_t lhs_stride,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    size_t rhs_stride,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    size_t result_stride,
+    size_t batch_count,
+    concurrency::ThreadPool* thread_pool);
+
+// Packs a constant 2-D uint8 matrix B once, with its column sums, for the QGemmu8u8_s32 overload below.
+// Returns false and leaves packed_rhs empty if B can't be packed.
+bool QGemmPackBu8(const Tensor& rhs, const AllocatorPtr& alloc, BufferUniquePtr& packed_rhs);
+
+// Same as above, with a K x N matrix B given by its data and the stride ldb between its rows.
+bool QGemmPackBu8(size_t N, size_t K, const uint8_t* rhs_data, size_t ldb, const AllocatorPtr& alloc,
+                  BufferUniquePtr& packed_rhs);
+
+// Same as QGemmu8u8_s32 above, with a row major K x N matrix B packed by QGemmPackBu8.
+void QGemmu8u8_s32(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const void* packed_rhs,
+    const uint8_t rhs_offset,
+    int32_t* result_data,
+    int ldc,
+    concurrency::ThreadPool* thread_pool);
+
+// Turns the product C of A and B computed by QGemmu8u8_s32 with a zero point of 0 for A into the product with the
+// zero point lhs_offsets[m] for each row m of A: subtracts lhs_offsets[m] times the sum of column n of B - rhs_offset
+// from C[m, n]. MLAS and gemmlowp only take a single zero point per matrix.
+void QGemmApplyRowOffsets(int M, int N, int K, const uint8_t* lhs_offsets, const uint8_t* rhs_data, int ldb,
+                          uint8_t rhs_offset, int32_t* result_data, int ldc);
+
+// Same as QGemmApplyRowOffsets above, for the zero point rhs_offsets[n] of each column n of B instead: subtracts
+// rhs_offsets[n] times the sum of row m of A - lhs_offset from C[m, n].
+void QGemmApplyColumnOffsets(int M, int N, int K, const uint8_t* lhs_data, int lda, uint8_t lhs_offset,
+                             const uint8_t* rhs_offsets, int32_t* result_data, int ldc);
+
+// Quantizes the M x K row major matrix A, with the stride lda between its rows, to uint8 like DynamicQuantizeLinear:
+// the range of the values, extended to include 0, maps to [0, 255]. Returns the scale and zero point used.
+void DynamicQuantizeu8(int M, int K, const float* A, int lda, uint8_t* quantized, float& scale, uint8_t& zero_point);
+
 }  // namespace onnxruntime
@@ -13,6 +13,10 @@
 #include "core/framework/tensor.h"
 #include "core/framework/allocator.h"
 
+#ifdef ENABLE_DLPACK
+#include <dlpack/dlpack.h>
+#endif
+
 using namespace std;
 namespace onnxruntime {
 namespace python {
@@ -95,8 +99,55 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+// Keeps a numpy array alive for as long as a tensor uses its buffer.
+// The tensor frees its buffer through this allocator, which releases the array.
+class NumpyArrayBufferOwner : public IAllocator {
+ public:
+  NumpyArrayBufferOwner(PyArrayObject* array, const OrtMemoryInfo& info) : array_(array), info_(info) {
+    Py_INCREF(array_);
+  }
+
+  void* Alloc(size_t /*size*/) override {
+    ORT_THROW("A numpy array buffer cannot allocate.");
+  }
+
+  // The tensor may be destructed by a thread not holding the GIL, e.g. after run_async.
+  void Free(void* /*p*/) override {
+    py::gil_scoped_acquire acquire;
+    Py_DECREF(array_);
+  }
+
+  const OrtMemoryInfo& Info() const override { return info_; }
+
+ private:
+  PyArrayObject* array_;
+  const OrtMemoryInfo info_;
+};
+
+// Numeric arrays laid out as a tensor - contiguous, aligned and in the native byte order - are used without a copy.
+static bool CanUseArrayBuffer(PyArrayObject* array, const DataTypeImpl* element_type) {
+  return element_type != DataTypeImpl::GetType<std::string>() &&
+         PyArray_IS_C_CONTIGUOUS(array) && PyArray_ISALIGNED(array) && PyArray_ISNOTSWAPPED(array) &&
+         static_cast<size_t>(PyArray_ITEMSIZE(array)) == element_type->Size();
+}
+
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject,
                          OrtValue* p_mlvalue) {
+  const auto* array_element_type = NumpyToOnnxRuntimeTensorType(PyArray_TYPE(pyObject));
+  if (CanUseArrayBuffer(pyObject, array_element_type)) {
+    int ndim = PyArray_NDIM(pyObject);
+    npy_intp* npy_dims = PyArray_DIMS(pyObject);
+    std::vector<int64_t> dims(npy_dims, npy_dims + ndim);
+    // the tensor holds a reference to the array, as the OrtValue may be kept beyond the call, e.g. as an output
+    auto owner = std::make_shared<NumpyArrayBufferOwner>(pyObject, alloc->Info());
+    std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(array_element_type, TensorShape(dims),
+                                                                PyArray_DATA(pyObject), owner);
+    p_mlvalue->Init(p_tensor.release(),
+                    DataTypeImpl::GetType<Tensor>(),
+                    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    return;
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -197,6 +248,196 @@ void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyAr
   }
 }
 
+#ifdef ENABLE_DLPACK
+static const char* const kDlpackCapsuleName = "dltensor";
+// a consumer renames the capsule, then calls the deleter of the tensor once done with it
+static const char* const kUsedDlpackCapsuleName = "used_dltensor";
+
+// The DLPack tensor of an OrtValue, whose copy holds the memory.
+struct OrtDLManagedTensor {
+  OrtValue ort_value;
+  std::vector<int64_t> shape;
+  DLManagedTensor tensor;
+};
+
+static DLDataType GetDlpackDataType(MLDataType type) {
+  DLDataType dtype;
+  dtype.lanes = 1;
+  dtype.bits = static_cast<uint8_t>(type->Size() * 8);
+  if (type == DataTypeImpl::GetType<float>() || type == DataTypeImpl::GetType<double>() ||
+      type == DataTypeImpl::GetType<MLFloat16>()) {
+    dtype.code = kDLFloat;
+  } else if (type == DataTypeImpl::GetType<int8_t>() || type == DataTypeImpl::GetType<int16_t>() ||
+             type == DataTypeImpl::GetType<int32_t>() || type == DataTypeImpl::GetType<int64_t>()) {
+    dtype.code = kDLInt;
+  } else if (type == DataTypeImpl::GetType<uint8_t>() || type == DataTypeImpl::GetType<uint16_t>() ||
+             type == DataTypeImpl::GetType<uint32_t>() || type == DataTypeImpl::GetType<uint64_t>() ||
+             type == DataTypeImpl::GetType<bool>()) {
+    dtype.code = kDLUInt;
+  } else {
+    throw std::runtime_error(std::string("Tensors of type ") + DataTypeImpl::ToString(type) +
+                             " can't be converted to DLPack.");
+  }
+  return dtype;
+}
+
+static MLDataType GetOnnxRuntimeDataType(const DLDataType& dtype) {
+  if (dtype.lanes == 1) {
+    switch (dtype.code) {
+      case kDLFloat:
+        switch (dtype.bits) {
+          case 16:
+            return DataTypeImpl::GetType<MLFloat16>();
+          case 32:
+            return DataTypeImpl::GetType<float>();
+          case 64:
+            return DataTypeImpl::GetType<double>();
+        }
+        break;
+      case kDLInt:
+        switch (dtype.bits) {
+          case 8:
+            return DataTypeImpl::GetType<int8_t>();
+          case 16:
+            return DataTypeImpl::GetType<int16_t>();
+          case 32:
+            return DataTypeImpl::GetType<int32_t>();
+          case 64:
+            return DataTypeImpl::GetType<int64_t>();
+        }
+        break;
+      case kDLUInt:
+        switch (dtype.bits) {
+          case 8:
+            return DataTypeImpl::GetType<uint8_t>();
+          case 16:
+            return DataTypeImpl::GetType<uint16_t>();
+          case 32:
+            return DataTypeImpl::GetType<uint32_t>();
+          case 64:
+            return DataTypeImpl::GetType<uint64_t>();
+        }
+        break;
+    }
+  }
+  throw std::runtime_error("Unsupported DLPack data type: code " + std::to_string(dtype.code) + ", " +
+                           std::to_string(dtype.bits) + " bits, " + std::to_string(dtype.lanes) + " lanes.");
+}
+
+static void DeleteDlpackCapsule(PyObject* capsule) {
+  // a capsule which wasn't consumed still owns its tensor
+  if (PyCapsule_IsValid(capsule, kDlpackCapsuleName)) {
+    auto* tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, kDlpackCapsuleName));
+    tensor->deleter(tensor);
+  }
+}
+
+py::object ToDlpack(const OrtValue& ort_value) {
+  if (!ort_value.IsTensor()) {
+    throw std::runtime_error("Only tensors can be converted to DLPack.");
+  }
+  const Tensor& tensor = ort_value.Get<Tensor>();
+  const OrtDevice& device = tensor.Location().device;
+  if (device.Type() != OrtDevice::CPU && device.Type() != OrtDevice::GPU) {
+    throw std::runtime_error("Only tensors on CPU or CUDA devices can be converted to DLPack.");
+  }
+  const DLDataType dtype = GetDlpackDataType(tensor.DataType());
+
+  auto managed = std::make_unique<OrtDLManagedTensor>();
+  managed->ort_value = ort_value;
+  managed->shape = tensor.Shape().GetDims();
+  DLTensor& dl_tensor = managed->tensor.dl_tensor;
+  dl_tensor.data = const_cast<void*>(tensor.DataRaw());
+  dl_tensor.ctx.device_type = device.Type() == OrtDevice::GPU ? kDLGPU : kDLCPU;
+  dl_tensor.ctx.device_id = device.Id();
+  dl_tensor.ndim = static_cast<int>(managed->shape.size());
+  dl_tensor.dtype = dtype;
+  dl_tensor.shape = managed->shape.data();
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+  managed->tensor.manager_ctx = managed.get();
+  managed->tensor.deleter = [](DLManagedTensor* self) {
+    delete static_cast<OrtDLManagedTensor*>(self->manager_ctx);
+  };
+
+  PyObject* capsule = PyCapsule_New(&managed->tensor, kDlpackCapsuleName, DeleteDlpackCapsule);
+  if (capsule == NULL) {
+    throw py::error_already_set();
+  }
+  managed.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+// Gives the memory of a DLPack tensor back to its producer when the tensor using it is destructed.
+class DlpackBufferOwner : public IAllocator {
+ public:
+  DlpackBufferOwner(DLManagedTensor* tensor, const OrtMemoryInfo& info) : tensor_(tensor), info_(info) {}
+
+  void* Alloc(size_t /*size*/) override {
+    ORT_THROW("A DLPack tensor buffer cannot allocate.");
+  }
+
+  // the deleter of a python producer may need the GIL
+  void Free(void* /*p*/) override {
+    py::gil_scoped_acquire acquire;
+    if (tensor_->deleter != nullptr) {
+      tensor_->deleter(tensor_);
+    }
+  }
+
+  const OrtMemoryInfo& Info() const override { return info_; }
+
+ private:
+  DLManagedTensor* tensor_;
+  const OrtMemoryInfo info_;
+};
+
+void FromDlpack(py::object capsule, OrtValue* p_mlvalue) {
+  auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), kDlpackCapsuleName));
+  if (managed == nullptr) {
+    PyErr_Clear();
+    throw std::runtime_error("Expected a DLPack capsule which wasn't consumed yet.");
+  }
+  const DLTensor& dl_tensor = managed->dl_tensor;
+
+  std::vector<int64_t> dims(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides != nullptr) {
+    int64_t stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      if (dims[i] != 1 && dl_tensor.strides[i] != stride) {
+        throw std::runtime_error("Only DLPack tensors in the row-major, compact layout are supported.");
+      }
+      stride *= dims[i];
+    }
+  }
+
+  const MLDataType type = GetOnnxRuntimeDataType(dl_tensor.dtype);
+  std::shared_ptr<DlpackBufferOwner> owner;
+  if (dl_tensor.ctx.device_type == kDLCPU) {
+    owner = std::make_shared<DlpackBufferOwner>(managed, OrtMemoryInfo(CPU, OrtDeviceAllocator));
+#ifdef USE_CUDA
+  } else if (dl_tensor.ctx.device_type == kDLGPU) {
+    const int device_id = dl_tensor.ctx.device_id;
+    owner = std::make_shared<DlpackBufferOwner>(
+        managed, OrtMemoryInfo(CUDA, OrtDeviceAllocator,
+                               OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT,
+                                         static_cast<OrtDevice::DeviceId>(device_id)),
+                               device_id));
+#endif
+  } else {
+    throw std::runtime_error("Unsupported device of DLPack tensor: " + std::to_string(dl_tensor.ctx.device_type));
+  }
+
+  std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(
+      type, TensorShape(dims), static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset, owner);
+  // the tensor owns the DLPack tensor from now on
+  PyCapsule_SetName(capsule.ptr(), kUsedDlpackCapsuleName);
+  p_mlvalue->Init(p_tensor.release(),
+                  DataTypeImpl::GetType<Tensor>(),
+                  DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+}
+#endif
+
 std::string _get_type_name(int64_t&) {
   return std::string("int64_t");
 }
@@ -24,7 +24,17 @@ namespace py = pybind11;
 
 int OnnxRuntimeTensorToNumpyType(const DataTypeImpl* tensor_type);
 
+const DataTypeImpl* NumpyToOnnxRuntimeTensorType(int numpy_type);
+
 void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue);
 
+#ifdef ENABLE_DLPACK
+// Returns a DLPack capsule of a tensor, which shares its memory and keeps it alive.
+py::object ToDlpack(const OrtValue& ort_value);
+
+// Creates a tensor on the memory of a DLPack capsule, which it consumes.
+void FromDlpack(py::object capsule, OrtValue* p_mlvalue);
+#endif
+
 }  // namespace python
 }  // namespace onnxruntime
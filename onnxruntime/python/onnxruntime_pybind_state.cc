@@ -8,9 +8,12 @@
 #include <numpy/arrayobject.h>
 
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/IOBinding.h"
+#include "core/platform/ort_mutex.h"
 #include "core/graph/graph_viewer.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
+#include "core/common/metrics.h"
 
 #if USE_CUDA
 #define BACKEND_PROC "GPU"
@@ -69,7 +72,9 @@
 #include "core/providers/cpu/cpu_provider_factory.h"
 
 #ifdef USE_CUDA
+#include <cuda_runtime_api.h>
 #include "core/providers/cuda/cuda_provider_factory.h"
+#include "core/providers/cuda/cuda_allocator.h"
 #endif
 #ifdef USE_TENSORRT
 #include "core/providers/tensorrt/tensorrt_provider_factory.h"
@@ -180,6 +185,23 @@ void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+
+  // A numeric tensor in CPU memory which it owns is returned without a copy: the array uses the tensor's buffer,
+  // and keeps the tensor alive through a copy of the OrtValue held by its base object.
+  // Tensors which don't own their buffer, such as initializers returned as outputs, are copied.
+  if (numpy_type != NPY_OBJECT && rtensor.OwnsBuffer() && rtensor.Location().device.Type() == OrtDevice::CPU) {
+    py::capsule base(new OrtValue(val), [](void* p) { delete static_cast<OrtValue*>(p); });
+    py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+        shape.NumDimensions(), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw(dtype))));
+    if (!obj) {
+      throw py::error_already_set();
+    }
+    // steals the reference to the capsule
+    PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), base.release().ptr());
+    pyobjs.push_back(obj);
+    return;
+  }
+
   py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -199,6 +221,202 @@ void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
   pyobjs.push_back(obj);
 }
 
+// Converts a feed from python. Throws if the python object isn't a valid value.
+static void CreateFeedValue(const std::string& name, py::object& value, OrtValue& ml_value) {
+  CreateGenericMLValue(GetAllocator(), name, value, &ml_value);
+  if (PyErr_Occurred()) {
+    PyObject *ptype, *pvalue, *ptraceback;
+    PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+    PyObject* pStr = PyObject_Str(ptype);
+    std::string sType = py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    pStr = PyObject_Str(pvalue);
+    sType += ": ";
+    sType += py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    throw std::runtime_error(sType);
+  }
+}
+
+static std::vector<py::object> CreateFetchObjects(std::vector<OrtValue>& fetches) {
+  std::vector<py::object> rfetch;
+  rfetch.reserve(fetches.size());
+  for (auto _ : fetches) {
+    if (_.IsTensor()) {
+      AddTensorAsPyObj(_, rfetch);
+    } else {
+      AddNonTensorAsPyObj(_, rfetch);
+    }
+  }
+  return rfetch;
+}
+
+#ifdef USE_CUDA
+static void CheckCudaCall(cudaError_t result, const char* expr) {
+  if (result != cudaSuccess) {
+    throw std::runtime_error(std::string("CUDA failure ") + std::to_string(result) + ": " +
+                             cudaGetErrorString(result) + " ; " + expr);
+  }
+}
+
+// Makes a CUDA device current for the lifetime of the object, as the CUDA allocator expects.
+class CudaDeviceScope {
+ public:
+  explicit CudaDeviceScope(int device_id) {
+    CheckCudaCall(cudaGetDevice(&previous_device_id_), "cudaGetDevice");
+    CheckCudaCall(cudaSetDevice(device_id), "cudaSetDevice");
+  }
+  ~CudaDeviceScope() {
+    cudaSetDevice(previous_device_id_);
+  }
+
+ private:
+  int previous_device_id_;
+};
+
+// Allocates device memory for the OrtValues created from python, from any thread.
+class PythonCudaAllocator : public IAllocator {
+ public:
+  explicit PythonCudaAllocator(int device_id) : allocator_(device_id, CUDA), device_id_(device_id) {}
+
+  void* Alloc(size_t size) override {
+    CudaDeviceScope scope(device_id_);
+    return allocator_.Alloc(size);
+  }
+
+  void Free(void* p) override {
+    CudaDeviceScope scope(device_id_);
+    allocator_.Free(p);
+  }
+
+  const OrtMemoryInfo& Info() const override { return allocator_.Info(); }
+
+ private:
+  CUDAAllocator allocator_;
+  const int device_id_;
+};
+#endif
+
+// Returns the allocator of a device named as in OrtValue.ortvalue_from_numpy.
+static AllocatorPtr GetDeviceAllocator(const std::string& device_type, int device_id) {
+  if (device_type == "cpu") {
+    return GetAllocator();
+  }
+#ifdef USE_CUDA
+  if (device_type == "cuda") {
+    static OrtMutex mutex;
+    static std::unordered_map<int, AllocatorPtr> allocators;
+    std::lock_guard<OrtMutex> lock(mutex);
+    auto& allocator = allocators[device_id];
+    if (allocator == nullptr) {
+      allocator = std::make_shared<PythonCudaAllocator>(device_id);
+    }
+    return allocator;
+  }
+#endif
+  throw std::runtime_error("Unsupported device '" + device_type + "' (device id " + std::to_string(device_id) + ")");
+}
+
+static std::string GetDeviceName(const OrtDevice& device) {
+  switch (device.Type()) {
+    case OrtDevice::CPU:
+      return "cpu";
+    case OrtDevice::GPU:
+      return "cuda";
+    case OrtDevice::FPGA:
+      return "fpga";
+    default:
+      return "unknown";
+  }
+}
+
+// Copies the data of a numeric tensor to another of the same type and shape, on the CPU or a CUDA device.
+static void CopyTensorData(const Tensor& src, Tensor& dst) {
+  const size_t bytes = src.SizeInBytes();
+  if (bytes == 0) {
+    return;
+  }
+  if (src.Location().device.Type() == OrtDevice::CPU && dst.Location().device.Type() == OrtDevice::CPU) {
+    memcpy(dst.MutableDataRaw(), src.DataRaw(), bytes);
+    return;
+  }
+#ifdef USE_CUDA
+  const auto& gpu_location = src.Location().device.Type() == OrtDevice::GPU ? src.Location() : dst.Location();
+  CudaDeviceScope scope(gpu_location.id);
+  // the copy is synchronous, so the data is ready for any stream
+  CheckCudaCall(cudaMemcpy(dst.MutableDataRaw(), src.DataRaw(), bytes, cudaMemcpyDefault), "cudaMemcpy");
+#else
+  throw std::runtime_error("Copies between " + src.Location().device.ToString() + " and " +
+                           dst.Location().device.ToString() + " are not supported.");
+#endif
+}
+
+// Creates an OrtValue of a python object on a device. Numpy arrays on the CPU are used without a copy when
+// their layout allows it.
+static OrtValue CreateDeviceValue(py::object& value, const std::string& device_type, int device_id) {
+  OrtValue cpu_value;
+  CreateFeedValue("OrtValue", value, cpu_value);
+  if (device_type == "cpu") {
+    return cpu_value;
+  }
+  if (!cpu_value.IsTensor()) {
+    throw std::runtime_error("Only tensors can be created on device '" + device_type + "'.");
+  }
+  const Tensor& cpu_tensor = cpu_value.Get<Tensor>();
+  if (cpu_tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+    throw std::runtime_error("String tensors can't be created on device '" + device_type + "'.");
+  }
+  auto p_tensor = std::make_unique<Tensor>(cpu_tensor.DataType(), cpu_tensor.Shape(),
+                                           GetDeviceAllocator(device_type, device_id));
+  CopyTensorData(cpu_tensor, *p_tensor);
+  OrtValue device_value;
+  device_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return device_value;
+}
+
+// Converts an OrtValue to a python object, copying the tensors on a device to numpy arrays.
+static py::object CreateHostObject(const OrtValue& value) {
+  std::vector<py::object> objects;
+  OrtValue host_value = value;
+  if (value.IsTensor() && value.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+    const Tensor& device_tensor = value.Get<Tensor>();
+    auto p_tensor = std::make_unique<Tensor>(device_tensor.DataType(), device_tensor.Shape(), GetAllocator());
+    CopyTensorData(device_tensor, *p_tensor);
+    host_value = OrtValue();
+    host_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  }
+  if (host_value.IsTensor()) {
+    AddTensorAsPyObj(host_value, objects);
+  } else {
+    AddNonTensorAsPyObj(host_value, objects);
+  }
+  return objects.front();
+}
+
+// The IOBinding of a session, which the python object keeps alive.
+struct SessionIOBinding {
+  explicit SessionIOBinding(InferenceSession* session) : session(session) {
+    auto status = session->NewIOBinding(&binding);
+    if (!status.IsOK()) {
+      throw std::runtime_error(status.ToString());
+    }
+  }
+
+  InferenceSession* session;
+  std::unique_ptr<IOBinding> binding;
+};
+
+// Destroying a session waits for its pending run_async calls, whose callbacks need the GIL.
+struct InferenceSessionDeleter {
+  void operator()(InferenceSession* sess) const {
+    py::gil_scoped_release release;
+    delete sess;
+  }
+};
+
 class SessionObjectInitializer {
  public:
   typedef const SessionOptions& Arg1;
@@ -328,6 +546,9 @@ void addGlobalMethods(py::module& m) {
       "Return the device used to compute the prediction (CPU, MKL, ...)");
   m.def("get_all_providers", []() -> const std::vector<std::string>& { return GetAllProviders(); });
   m.def("get_available_providers", []() -> const std::vector<std::string>& { return GetAvailableProviders(); });
+  m.def(
+      "get_metrics", []() -> std::string { return metrics::MetricsRegistry::Global().ToPrometheusText(); },
+      "Return the metrics of the process in the Prometheus text format.");
 
 #ifdef USE_NUPHAR
   m.def("set_nuphar_settings", [](const std::string& str) {
@@ -519,6 +740,15 @@ void addObjectMethods(py::module& m) {
 Set this option to false if you don't want it. Default is True.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
+      .def_readwrite("profile_sampling_interval", &SessionOptions::profile_sampling_interval,
+                     R"pbdoc(If above 0, profile only 1 in this many executions with low overhead, so that profiling
+can stay enabled in production. Only used if *enable_profiling* is set. Default is 0.)pbdoc")
+      .def_readwrite("enable_profiling_hardware_counters", &SessionOptions::enable_profiling_hardware_counters,
+                     R"pbdoc(Record the cycles, instructions, last level cache misses and estimated memory
+bandwidth of each node in the profile. Linux only. Only used if *enable_profiling* is set. Default is false.)pbdoc")
+      .def_readwrite("enable_metrics", &SessionOptions::enable_metrics,
+                     R"pbdoc(Record the duration of the runs and the kernel time per execution provider of this
+session in the metrics returned by *get_metrics*, labelled with *logid*. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
@@ -590,7 +820,10 @@ Applies to a particular Run() invocation. Default is 0.)pbdoc")
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("max_micro_batch_size", &RunOptions::max_micro_batch_size,
+                     R"pbdoc(If greater than 0, split the inputs along a first (batch) dimension left unspecified by
+the model into micro-batches of at most this many rows, run one after another to bound peak memory. Default is 0.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -662,8 +895,117 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           },
           "node shape (assuming the node holds a tensor)");
 
+  py::class_<OrtValue>(m, "OrtValue", R"pbdoc(A value of ONNX Runtime, whose tensor data may be on a device.)pbdoc")
+      .def_static(
+          "ortvalue_from_numpy", [](py::object& value, const std::string& device_type, int device_id) {
+            return CreateDeviceValue(value, device_type, device_id);
+          },
+          py::arg("value"), py::arg("device_type") = "cpu", py::arg("device_id") = 0,
+          R"pbdoc(Create an OrtValue from a numpy array, copied to the device. On the CPU, an array with the layout
+of a tensor is used without a copy, and kept alive by the OrtValue.)pbdoc")
+      .def_static(
+          "ortvalue_from_shape_and_type", [](const std::vector<int64_t>& shape, py::object& element_type,
+                                             const std::string& device_type, int device_id) {
+            PyArray_Descr* descr = nullptr;
+            if (!PyArray_DescrConverter(element_type.ptr(), &descr)) {
+              throw py::error_already_set();
+            }
+            const int numpy_type = descr->type_num;
+            Py_DECREF(descr);
+            const auto* type = NumpyToOnnxRuntimeTensorType(numpy_type);
+            if (type == DataTypeImpl::GetType<std::string>() && device_type != "cpu") {
+              throw std::runtime_error("String tensors can't be created on device '" + device_type + "'.");
+            }
+            auto p_tensor = std::make_unique<Tensor>(type, TensorShape(shape),
+                                                     GetDeviceAllocator(device_type, device_id));
+            OrtValue value;
+            value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                       DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+            return value;
+          },
+          py::arg("shape"), py::arg("element_type"), py::arg("device_type") = "cpu", py::arg("device_id") = 0,
+          R"pbdoc(Allocate an uninitialized tensor on the device, e.g. to bind as an output.)pbdoc")
+#ifdef ENABLE_DLPACK
+      .def_static(
+          "from_dlpack", [](py::object capsule) {
+            OrtValue value;
+            FromDlpack(capsule, &value);
+            return value;
+          },
+          R"pbdoc(Create an OrtValue on the memory of a DLPack capsule, which it consumes.)pbdoc")
+      .def("to_dlpack", [](const OrtValue* value) -> py::object { return ToDlpack(*value); },
+           R"pbdoc(Return a DLPack capsule sharing the memory of the tensor.)pbdoc")
+#endif
+      .def("is_tensor", [](const OrtValue* value) -> bool { return value->IsTensor(); })
+      .def("device_name", [](const OrtValue* value) -> std::string {
+        return GetDeviceName(value->Get<Tensor>().Location().device);
+      })
+      .def("device_id", [](const OrtValue* value) -> int {
+        return value->Get<Tensor>().Location().device.Id();
+      })
+      .def("shape", [](const OrtValue* value) -> std::vector<int64_t> {
+        return value->Get<Tensor>().Shape().GetDims();
+      })
+      .def("element_type", [](const OrtValue* value) -> py::object {
+        const int numpy_type = OnnxRuntimeTensorToNumpyType(value->Get<Tensor>().DataType());
+        return py::reinterpret_steal<py::object>(reinterpret_cast<PyObject*>(PyArray_DescrFromType(numpy_type)));
+      })
+      .def("data_ptr", [](const OrtValue* value) -> uintptr_t {
+        return reinterpret_cast<uintptr_t>(value->Get<Tensor>().DataRaw());
+      },
+           R"pbdoc(Address of the tensor data, on its device.)pbdoc")
+      .def("numpy", [](const OrtValue* value) -> py::object { return CreateHostObject(*value); },
+           R"pbdoc(Return the value as a numpy array, copied from the device if needed.)pbdoc");
+
+  py::class_<SessionIOBinding>(m, "SessionIOBinding", R"pbdoc(The inputs and outputs bound to a session for
+run_with_iobinding.)pbdoc")
+      .def(py::init<InferenceSession*>(), py::keep_alive<1, 2>())
+      .def(
+          "bind_input", [](SessionIOBinding* io_binding, const std::string& name, const OrtValue& value) {
+            // copies the value to the device of the nodes consuming the input, if needed
+            auto status = io_binding->binding->BindInput(name, value);
+            if (!status.IsOK()) {
+              throw std::runtime_error("Failed to bind input '" + name + "': " + status.ErrorMessage());
+            }
+          },
+          R"pbdoc(Bind an OrtValue to an input, copying it to the device where the input is used if needed.)pbdoc")
+      .def(
+          "bind_output", [](SessionIOBinding* io_binding, const std::string& name, const OrtValue* value) {
+            auto status = io_binding->binding->BindOutput(name, value != nullptr ? *value : OrtValue());
+            if (!status.IsOK()) {
+              throw std::runtime_error("Failed to bind output '" + name + "': " + status.ErrorMessage());
+            }
+          },
+          py::arg("name"), py::arg("value") = nullptr,
+          R"pbdoc(Bind an output to a preallocated OrtValue, which the run writes to on its device, or to None for
+an output allocated by the run on the CPU.)pbdoc")
+      .def("synchronize_inputs", [](SessionIOBinding* io_binding) {
+        auto status = io_binding->binding->SynchronizeInputs();
+        if (!status.IsOK()) {
+          throw std::runtime_error(status.ToString());
+        }
+      })
+      .def("synchronize_outputs", [](SessionIOBinding* io_binding) {
+        auto status = io_binding->binding->SynchronizeOutputs();
+        if (!status.IsOK()) {
+          throw std::runtime_error(status.ToString());
+        }
+      })
+      .def("clear_binding_inputs", [](SessionIOBinding* io_binding) { io_binding->binding->ClearInputs(); })
+      .def("clear_binding_outputs", [](SessionIOBinding* io_binding) { io_binding->binding->ClearOutputs(); })
+      .def("get_outputs", [](SessionIOBinding* io_binding) -> std::vector<OrtValue> {
+        return io_binding->binding->GetOutputs();
+      })
+      .def("copy_outputs_to_cpu", [](SessionIOBinding* io_binding) -> std::vector<py::object> {
+        std::vector<py::object> outputs;
+        for (const auto& value : io_binding->binding->GetOutputs()) {
+          outputs.push_back(CreateHostObject(value));
+        }
+        return outputs;
+      });
+
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
-  py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
+  py::class_<InferenceSession, std::unique_ptr<InferenceSession, InferenceSessionDeleter>>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       .def(py::init<SessionObjectInitializer, SessionObjectInitializer>())
       .def(py::init<SessionOptions, SessionObjectInitializer>())
       .def(
@@ -689,20 +1031,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         NameMLValMap feeds;
         for (auto _ : pyfeeds) {
           OrtValue ml_value;
-          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
-          if (PyErr_Occurred()) {
-            PyObject *ptype, *pvalue, *ptraceback;
-            PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-            PyObject* pStr = PyObject_Str(ptype);
-            std::string sType = py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            pStr = PyObject_Str(pvalue);
-            sType += ": ";
-            sType += py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            throw std::runtime_error(sType);
-          }
+          CreateFeedValue(_.first, _.second, ml_value);
           feeds.insert(std::make_pair(_.first, ml_value));
         }
 
@@ -724,20 +1053,154 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           throw std::runtime_error(std::string("Method run failed due to: ") + std::string(mes.c_str()));
         }
 
-        std::vector<py::object> rfetch;
-        rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
-          if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
-          } else {
-            AddNonTensorAsPyObj(_, rfetch);
-          }
-        }
-        return rfetch;
+        return CreateFetchObjects(fetches);
       })
+      .def(
+          "run_async", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, py::function callback, py::object run_options) {
+            std::vector<std::string> feed_names;
+            std::vector<OrtValue> feeds;
+            feed_names.reserve(pyfeeds.size());
+            feeds.reserve(pyfeeds.size());
+            for (auto _ : pyfeeds) {
+              feeds.emplace_back();
+              CreateFeedValue(_.first, _.second, feeds.back());
+              feed_names.push_back(_.first);
+            }
+
+            // keeps the callback and the run options alive until the run completes.
+            // it holds python objects, so it's only destroyed with the GIL.
+            struct AsyncRunContext {
+              py::function callback;
+              py::object run_options;
+            };
+            auto* context = new AsyncRunContext{callback, run_options};
+
+            static const RunOptions default_run_options;
+            const RunOptions& ro = run_options.is_none() ? default_run_options : *run_options.cast<RunOptions*>();
+
+            auto status = sess->RunAsync(
+                ro, std::move(feed_names), std::move(feeds), std::move(output_names), {},
+                [context](const common::Status& run_status, std::vector<OrtValue>& fetches) {
+                  py::gil_scoped_acquire acquire;
+                  std::unique_ptr<AsyncRunContext> owned_context{context};
+                  try {
+                    if (run_status.IsOK()) {
+                      owned_context->callback(CreateFetchObjects(fetches), py::none());
+                    } else {
+                      owned_context->callback(py::none(), std::string("Method run_async failed due to: ") + run_status.ToString());
+                    }
+                  } catch (py::error_already_set& e) {
+                    // nothing can catch it on this thread, so report it like an exception in a python thread
+                    e.restore();
+                    PyErr_Print();
+                  }
+                });
+
+            if (!status.IsOK()) {
+              delete context;
+              throw std::runtime_error(std::string("Method run_async failed due to: ") + status.ToString());
+            }
+          },
+          R"pbdoc(Schedule a run on the session's thread pool and return without waiting for it.
+The callback is called on a thread of the pool with the outputs and None, or with None and an error message.)pbdoc")
+      .def(
+          "run_many", [](InferenceSession* sess, std::vector<std::string> output_names, py::list input_feeds, std::vector<std::string> input_names, RunOptions* run_options = nullptr) -> std::vector<std::vector<py::object>> {
+            const size_t num_runs = input_feeds.size();
+            if (num_runs == 0) {
+              return {};
+            }
+
+            // the feeds of all the runs are converted first, so the runs don't need the GIL
+            std::vector<std::vector<OrtValue>> feeds(num_runs);
+            for (size_t i = 0; i < num_runs; ++i) {
+              py::handle feed = input_feeds[i];
+              if (PyDict_Check(feed.ptr())) {
+                // the inputs are in the order of the first feed unless given
+                if (input_names.empty()) {
+                  for (auto item : py::reinterpret_borrow<py::dict>(feed)) {
+                    input_names.push_back(item.first.cast<std::string>());
+                  }
+                }
+                if (static_cast<size_t>(PyDict_Size(feed.ptr())) != input_names.size()) {
+                  throw std::runtime_error("Feed " + std::to_string(i) + " doesn't have the inputs of the other feeds.");
+                }
+                for (const auto& name : input_names) {
+                  PyObject* value = PyDict_GetItemString(feed.ptr(), name.c_str());
+                  if (value == nullptr) {
+                    throw std::runtime_error("Feed " + std::to_string(i) + " has no input '" + name + "'.");
+                  }
+                  py::object py_value = py::reinterpret_borrow<py::object>(value);
+                  feeds[i].emplace_back();
+                  CreateFeedValue(name, py_value, feeds[i].back());
+                }
+              } else {
+                if (!PySequence_Check(feed.ptr()) || static_cast<size_t>(PySequence_Size(feed.ptr())) != input_names.size()) {
+                  throw std::runtime_error("Feed " + std::to_string(i) + " must be a dictionary, or a sequence of values of the input names.");
+                }
+                py::sequence values = py::reinterpret_borrow<py::sequence>(feed);
+                for (size_t j = 0; j < input_names.size(); ++j) {
+                  py::object py_value = values[j];
+                  feeds[i].emplace_back();
+                  CreateFeedValue(input_names[j], py_value, feeds[i].back());
+                }
+              }
+            }
+
+            std::unique_ptr<PreparedRun> prepared_run;
+            auto status = sess->PrepareRun(input_names, output_names, prepared_run);
+            if (!status.IsOK()) {
+              throw std::runtime_error(std::string("Method run_many failed due to: ") + status.ToString());
+            }
+
+            static const RunOptions default_run_options;
+            const RunOptions& ro = run_options != nullptr ? *run_options : default_run_options;
+            std::vector<std::vector<OrtValue>> fetches(num_runs);
+            size_t run = 0;
+            {
+              // release GIL for all the runs
+              py::gil_scoped_release release;
+              for (; run < num_runs; ++run) {
+                status = sess->Run(ro, *prepared_run, feeds[run], &fetches[run]);
+                if (!status.IsOK()) {
+                  break;
+                }
+              }
+            }
+            if (!status.IsOK()) {
+              throw std::runtime_error(std::string("Method run_many failed on feed ") + std::to_string(run) +
+                                       " due to: " + status.ToString());
+            }
+
+            std::vector<std::vector<py::object>> results;
+            results.reserve(num_runs);
+            for (auto& run_fetches : fetches) {
+              results.push_back(CreateFetchObjects(run_fetches));
+            }
+            return results;
+          },
+          R"pbdoc(Run once for each feed, in one call which releases the GIL for all the runs.)pbdoc")
+      .def(
+          "run_with_iobinding", [](InferenceSession* sess, SessionIOBinding& io_binding, RunOptions* run_options = nullptr) {
+            common::Status status;
+            {
+              py::gil_scoped_release release;
+              if (run_options != nullptr) {
+                status = sess->Run(*run_options, *io_binding.binding);
+              } else {
+                status = sess->Run(*io_binding.binding);
+              }
+            }
+            if (!status.IsOK()) {
+              throw std::runtime_error(std::string("Method run_with_iobinding failed due to: ") + status.ToString());
+            }
+          },
+          R"pbdoc(Run with the inputs and outputs of an IOBinding, whose outputs hold the results.)pbdoc")
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
+      .def("get_initialization_timings", [](const InferenceSession* sess) -> std::string {
+        return sess->GetInitializationTimings();
+      })
       .def("get_providers", [](InferenceSession* sess) -> const std::vector<std::string>& {
         return sess->GetRegisteredProviderTypes();
       })
@@ -99,6 +99,75 @@ class InferenceSession:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run(output_names, input_feed, run_options)
 
+    def run_many(self, output_names, input_feeds, run_options=None, input_names=None):
+        """
+        Compute the predictions of several feeds in one call.
+        This saves the per-call overhead of :meth:`run` for small models: the names are
+        resolved once, and the runs are executed one after the other without the GIL.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }`` with the same inputs,
+            or list of sequences of input values in the order of *input_names*
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param input_names: names of the inputs, required if the feeds are sequences
+        :return: the outputs of each feed, as :meth:`run` returns them
+
+        ::
+
+            sess.run_many([output_name], [{input_name: x} for x in batch])
+            sess.run_many([output_name], [(x,) for x in batch], input_names=[input_name])
+        """
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_many(output_names, input_feeds, input_names or [], run_options)
+
+    def run_async(self, output_names, input_feed, callback, run_options=None):
+        """
+        Compute the predictions without waiting for them.
+        The run is executed on the session's thread pool, which then calls
+        ``callback(outputs, error)``: the outputs and None if it succeeded,
+        else None and an error message.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param callback: called once with the result, on a thread of the pool
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+
+        ::
+
+            sess.run_async([output_name], {input_name: x}, lambda res, err: print(res or err))
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        # the graph may have optional inputs used to override initializers. allow for that.
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        self._sess.run_async(output_names, input_feed, callback, run_options)
+
+    def io_binding(self):
+        "Return an :class:`onnxruntime.IOBinding` of the session, for :meth:`run_with_iobinding`."
+        return IOBinding(self)
+
+    def run_with_iobinding(self, iobinding, run_options=None):
+        """
+        Compute the predictions with the inputs and outputs bound to an :class:`onnxruntime.IOBinding`.
+        Inputs and outputs bound to OrtValues on the device where they are used are not copied, so the
+        outputs of a model can be the inputs of another one without leaving the device.
+
+        :param iobinding: the bound inputs and outputs, which holds the outputs after the run
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+
+        ::
+
+            binding = sess.io_binding()
+            binding.bind_input(input_name, OrtValue.ortvalue_from_numpy(x, 'cuda', 0))
+            binding.bind_output(output_name, OrtValue.ortvalue_from_shape_and_type(shape, np.float32, 'cuda', 0))
+            sess.run_with_iobinding(binding)
+        """
+        self._sess.run_with_iobinding(iobinding._iobinding, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -107,3 +176,62 @@ class InferenceSession:
         :meth:`onnxruntime.SessionOptions.enable_profiling`.
         """
         return self._sess.end_profiling()
+
+    def get_initialization_timings(self):
+        """
+        Return the time taken by each phase of loading and initializing the session, as a JSON array of events
+        in the chrome tracing format, whether profiling is enabled or not.
+        """
+        return self._sess.get_initialization_timings()
+
+
+class IOBinding:
+    """
+    The inputs and outputs of a session bound to values, which may be on a device.
+    See :meth:`InferenceSession.run_with_iobinding`.
+    """
+    def __init__(self, session):
+        self._iobinding = C.SessionIOBinding(session._sess)
+
+    def bind_input(self, name, value):
+        """
+        Bind an input, copying it to the device where it is used if it isn't there.
+
+        :param name: name of the input
+        :param value: a :class:`onnxruntime.OrtValue`, or a numpy array
+        """
+        if not isinstance(value, C.OrtValue):
+            value = C.OrtValue.ortvalue_from_numpy(value)
+        self._iobinding.bind_input(name, value)
+
+    def bind_output(self, name, value=None):
+        """
+        Bind an output.
+
+        :param name: name of the output
+        :param value: a preallocated :class:`onnxruntime.OrtValue`, which the run writes the output to on its device,
+            or None to let the run allocate the output on the CPU
+        """
+        self._iobinding.bind_output(name, value)
+
+    def get_outputs(self):
+        "Return the outputs of the last run as a list of :class:`onnxruntime.OrtValue`, where they were computed."
+        return self._iobinding.get_outputs()
+
+    def copy_outputs_to_cpu(self):
+        "Return the outputs of the last run as numpy arrays, copied from their devices if needed."
+        return self._iobinding.copy_outputs_to_cpu()
+
+    def synchronize_inputs(self):
+        "Wait for the copies of the bound inputs to their devices."
+        self._iobinding.synchronize_inputs()
+
+    def synchronize_outputs(self):
+        "Wait for the computation of the outputs on their devices."
+        self._iobinding.synchronize_outputs()
+
+    def clear_binding_inputs(self):
+        self._iobinding.clear_binding_inputs()
+
+    def clear_binding_outputs(self):
+        self._iobinding.clear_binding_outputs()
@@ -0,0 +1,257 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "batcher.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct Batcher::Request {
+  std::vector<Ort::Value>* input_values;
+  int64_t num_rows;
+  std::vector<Ort::Value> outputs;
+};
+
+struct Batcher::Batch {
+  const std::vector<std::string>* input_names;
+  const std::vector<std::string>* output_names;
+  std::vector<Request*> requests;
+  int64_t num_rows = 0;
+  size_t num_sequence_steps = 0;
+
+  bool done = false;
+  OrtErrorCode error_code = ORT_OK;
+  std::string error_message;
+};
+
+Batcher::Batcher(Ort::Session& session, size_t max_batch_size, std::chrono::microseconds max_queue_delay)
+    : session_(session),
+      max_batch_size_(static_cast<int64_t>(max_batch_size)),
+      max_queue_delay_(max_queue_delay) {
+  // only inputs with a symbolic first dimension accept batches of any size
+  for (size_t i = 0, end = session_.GetInputCount(); i < end && batching_; ++i) {
+    auto type_info = session_.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      batching_ = false;
+      break;
+    }
+
+    auto shape = type_info.GetTensorTypeAndShapeInfo().GetShape();
+    batching_ = !shape.empty() && shape[0] < 0;
+  }
+
+  batching_ = batching_ && max_batch_size_ > 1;
+}
+
+bool Batcher::GetBatchKey(const std::vector<std::string>& input_names,
+                          std::vector<Ort::Value>& input_values,
+                          const std::vector<std::string>& output_names,
+                          std::string& key, int64_t& num_rows) const {
+  num_rows = -1;
+  key.clear();
+
+  for (size_t i = 0; i < input_values.size(); ++i) {
+    auto& value = input_values[i];
+    if (!value.IsTensor()) {
+      return false;
+    }
+
+    auto info = value.GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    if (GetTensorElementSize(type) == 0 || shape.empty() || (num_rows >= 0 && shape[0] != num_rows)) {
+      return false;
+    }
+
+    num_rows = shape[0];
+    key += input_names[i];
+    key += ':';
+    key += std::to_string(static_cast<int>(type));
+    for (size_t dim = 1; dim < shape.size(); ++dim) {
+      key += ',';
+      key += std::to_string(shape[dim]);
+    }
+    key += ';';
+  }
+
+  key += "->";
+  for (const auto& name : output_names) {
+    key += name;
+    key += ';';
+  }
+
+  return num_rows > 0;
+}
+
+void Batcher::BeginSequence() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++active_sequences_;
+}
+
+void Batcher::EndSequence() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --active_sequences_;
+  }
+
+  // the batches waiting for a step of the sequence may be ready now
+  batch_changed_.notify_all();
+}
+
+bool Batcher::IsReady(const Batch& batch) const {
+  return batch.num_rows >= max_batch_size_ ||
+         (batch.num_sequence_steps > 0 && batch.num_sequence_steps >= active_sequences_);
+}
+
+std::vector<Ort::Value> Batcher::Run(const Ort::RunOptions& options,
+                                     const std::vector<std::string>& input_names,
+                                     std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& output_names,
+                                     bool sequence_step) {
+  std::string key;
+  int64_t num_rows = 0;
+  if (!batching_ || !GetBatchKey(input_names, input_values, output_names, key, num_rows) ||
+      num_rows >= max_batch_size_) {
+    ++num_session_runs_;
+    return RunSession(session_, options, input_names, input_values, output_names);
+  }
+
+  Request request{&input_values, num_rows, {}};
+  std::shared_ptr<Batch> batch;
+  bool is_leader = false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = open_batches_.find(key);
+  if (it != open_batches_.end() && it->second->num_rows + num_rows <= max_batch_size_) {
+    batch = it->second;
+  } else {
+    // the batch that is too full to take this request is run by its leader once its time is up
+    batch = std::make_shared<Batch>();
+    batch->input_names = &input_names;
+    batch->output_names = &output_names;
+    open_batches_[key] = batch;
+    is_leader = true;
+  }
+
+  batch->requests.push_back(&request);
+  batch->num_rows += num_rows;
+  if (sequence_step) {
+    ++batch->num_sequence_steps;
+  }
+
+  if (is_leader) {
+    const auto deadline = std::chrono::steady_clock::now() + max_queue_delay_;
+    batch_changed_.wait_until(lock, deadline, [&batch, this]() { return IsReady(*batch); });
+
+    // close the batch. a newer batch may already have replaced it.
+    it = open_batches_.find(key);
+    if (it != open_batches_.end() && it->second == batch) {
+      open_batches_.erase(it);
+    }
+
+    lock.unlock();
+    RunBatch(options, *batch);
+    lock.lock();
+
+    batch->done = true;
+    batch_changed_.notify_all();
+  } else {
+    if (IsReady(*batch)) {
+      batch_changed_.notify_all();
+    }
+
+    batch_changed_.wait(lock, [&batch]() { return batch->done; });
+  }
+
+  lock.unlock();
+
+  if (batch->error_code != ORT_OK) {
+    throw Ort::Exception(std::string(batch->error_message), batch->error_code);
+  }
+
+  return std::move(request.outputs);
+}
+
+void Batcher::RunBatch(const Ort::RunOptions& options, Batch& batch) {
+  try {
+    if (batch.requests.size() > 1 && RunConcatenated(options, batch)) {
+      return;
+    }
+
+    // a single request, or outputs that don't have the batch dimension
+    for (auto* request : batch.requests) {
+      ++num_session_runs_;
+      request->outputs = RunSession(session_, options, *batch.input_names, *request->input_values,
+                                    *batch.output_names);
+    }
+  } catch (const Ort::Exception& e) {
+    batch.error_code = e.GetOrtErrorCode();
+    batch.error_message = e.what();
+  } catch (const std::exception& e) {
+    batch.error_code = ORT_FAIL;
+    batch.error_message = e.what();
+  }
+}
+
+bool Batcher::RunConcatenated(const Ort::RunOptions& options, Batch& batch) {
+  const auto& first_inputs = *batch.requests.front()->input_values;
+
+  std::vector<Ort::Value> inputs;
+  inputs.reserve(first_inputs.size());
+  for (size_t i = 0; i < first_inputs.size(); ++i) {
+    auto info = first_inputs[i].GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    shape[0] = batch.num_rows;
+
+    inputs.push_back(Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type));
+    auto* dst = inputs.back().GetTensorMutableData<char>();
+    const size_t element_size = GetTensorElementSize(type);
+    for (auto* request : batch.requests) {
+      auto& value = (*request->input_values)[i];
+      const size_t num_bytes = value.GetTensorTypeAndShapeInfo().GetElementCount() * element_size;
+      std::memcpy(dst, value.GetTensorMutableData<char>(), num_bytes);
+      dst += num_bytes;
+    }
+  }
+
+  ++num_session_runs_;
+  auto outputs = RunSession(session_, options, *batch.input_names, inputs, *batch.output_names);
+
+  // every output must hold one row per input row to be split
+  for (auto& output : outputs) {
+    if (!output.IsTensor()) {
+      return false;
+    }
+
+    auto info = output.GetTensorTypeAndShapeInfo();
+    auto shape = info.GetShape();
+    if (GetTensorElementSize(info.GetElementType()) == 0 || shape.empty() || shape[0] != batch.num_rows) {
+      return false;
+    }
+  }
+
+  for (auto& output : outputs) {
+    auto info = output.GetTensorTypeAndShapeInfo();
+    auto type = info.GetElementType();
+    auto shape = info.GetShape();
+    const size_t row_bytes = info.GetElementCount() / static_cast<size_t>(batch.num_rows) * GetTensorElementSize(type);
+
+    const auto* src = output.GetTensorMutableData<char>();
+    for (auto* request : batch.requests) {
+      shape[0] = request->num_rows;
+      request->outputs.push_back(Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type));
+      const size_t num_bytes = row_bytes * static_cast<size_t>(request->num_rows);
+      std::memcpy(request->outputs.back().GetTensorMutableData<char>(), src, num_bytes);
+      src += num_bytes;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
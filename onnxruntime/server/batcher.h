@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Groups concurrent Run calls with the same input and output names, element types and non-batch dimensions along
+// the batch dimension (the first one), runs them as one batch, and splits the outputs back to each caller.
+// A batch is run once it holds max_batch_size rows, or once its first request waited max_queue_delay.
+// Requests that can't be batched, e.g. string tensors or a model whose inputs have a fixed first dimension, are
+// run on their own.
+//
+// The steps of the sequences run by ServedModel::Run for a step model are batched the same way, so sequences
+// join the batches of the others as they start and leave them as they finish, without padding them to a common
+// length. A batch holding a step of every sequence in progress runs right away rather than after the delay.
+class Batcher {
+ public:
+  Batcher(Ort::Session& session, size_t max_batch_size, std::chrono::microseconds max_queue_delay);
+  Batcher(const Batcher&) = delete;
+  Batcher& operator=(const Batcher&) = delete;
+
+  // Same as Ort::Session::Run. Blocks until the batch holding the request was run.
+  // sequence_step is true for the steps of a sequence between BeginSequence and EndSequence.
+  // Throws Ort::Exception if the run failed.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& options,
+                              const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names,
+                              bool sequence_step = false);
+
+  // Counts a sequence in progress, whose steps the batches wait for
+  void BeginSequence();
+  void EndSequence();
+
+  // Counts a sequence in progress on batcher, if not nullptr, for its lifetime, so the batches stop waiting for
+  // its steps once it's done, even if it failed
+  class SequenceScope {
+   public:
+    explicit SequenceScope(Batcher* batcher) : batcher_(batcher) {
+      if (batcher_ != nullptr) {
+        batcher_->BeginSequence();
+      }
+    }
+
+    ~SequenceScope() {
+      if (batcher_ != nullptr) {
+        batcher_->EndSequence();
+      }
+    }
+
+    SequenceScope(const SequenceScope&) = delete;
+    SequenceScope& operator=(const SequenceScope&) = delete;
+
+   private:
+    Batcher* const batcher_;
+  };
+
+  // false if the model inputs have a fixed first dimension, so every request is run on its own
+  bool IsBatching() const { return batching_; }
+
+  // the number of times the requests ran the session, once per batch if they were batched
+  size_t GetNumSessionRuns() const { return num_session_runs_; }
+
+ private:
+  struct Request;
+  struct Batch;
+
+  // Gets the key of the batches the request can join, and its number of rows.
+  // Returns false if the request can't be batched.
+  bool GetBatchKey(const std::vector<std::string>& input_names,
+                   std::vector<Ort::Value>& input_values,
+                   const std::vector<std::string>& output_names,
+                   std::string& key, int64_t& num_rows) const;
+
+  // Whether the batch is to run without waiting for more requests. Requires mutex_.
+  bool IsReady(const Batch& batch) const;
+
+  void RunBatch(const Ort::RunOptions& options, Batch& batch);
+
+  // Runs the batch with the inputs of each request concatenated. Returns false if the outputs can't be split.
+  bool RunConcatenated(const Ort::RunOptions& options, Batch& batch);
+
+  Ort::Session& session_;
+  const int64_t max_batch_size_;
+  const std::chrono::microseconds max_queue_delay_;
+  bool batching_ = true;
+  Ort::AllocatorWithDefaultOptions allocator_;
+
+  std::mutex mutex_;
+  std::condition_variable batch_changed_;
+  // the batches still accepting requests, by key
+  std::unordered_map<std::string, std::shared_ptr<Batch>> open_batches_;
+  size_t active_sequences_ = 0;
+  std::atomic<size_t> num_session_runs_{0};
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -172,18 +172,12 @@ void MLValueToTensorProto(Ort::Value& ml_value, bool using_raw_data,
     }
     case onnx::TensorProto_DataType_BFLOAT16: {  // Target: raw_data or int32_data
       const auto* data = ml_value.GetTensorMutableData<onnxruntime::BFloat16>();
-
-      std::vector<uint16_t> raw_data;
-      raw_data.reserve(elem_count);
-      for (size_t i = 0; i < elem_count; ++i) {
-        raw_data.push_back(data[i].val);
-      }
-
+      static_assert(sizeof(onnxruntime::BFloat16) == sizeof(uint16_t), "BFloat16 is stored as its uint16_t bits");
       if (using_raw_data) {
-        tensor_proto.set_raw_data(raw_data.data(), raw_data.size() * sizeof(uint16_t));
+        tensor_proto.set_raw_data(data, sizeof(onnxruntime::BFloat16) * elem_count);
       } else {
         for (size_t i = 0, count = elem_count; i < count; ++i) {
-          tensor_proto.add_int32_data(raw_data[i]);
+          tensor_proto.add_int32_data(data[i].val);
         }
       }
       break;
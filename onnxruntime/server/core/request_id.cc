@@ -15,6 +15,10 @@ std::string InternalRequestId() {
 }
 const std::string MS_REQUEST_ID_HEADER = "x-ms-request-id";
 const std::string MS_CLIENT_REQUEST_ID_HEADER = "x-ms-client-request-id";
+const std::string MODEL_NAME_METADATA = "x-ms-model-name";
+const std::string MODEL_VERSION_METADATA = "x-ms-model-version";
+const std::string REQUEST_PRIORITY_METADATA = "x-ms-request-priority";
+const std::string REQUEST_TIMEOUT_METADATA = "x-ms-request-timeout-ms";
 }  // namespace util
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
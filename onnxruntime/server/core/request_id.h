@@ -8,6 +8,10 @@ namespace util {
 std::string InternalRequestId();
 extern const std::string MS_REQUEST_ID_HEADER;
 extern const std::string MS_CLIENT_REQUEST_ID_HEADER;
+extern const std::string MODEL_NAME_METADATA;
+extern const std::string MODEL_VERSION_METADATA;
+extern const std::string REQUEST_PRIORITY_METADATA;
+extern const std::string REQUEST_TIMEOUT_METADATA;
 }  // namespace util
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -1,9 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <fstream>
 #include <memory>
 #include "environment.h"
+#include "core/framework/path_lib.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#ifdef USE_CUDA
+#include "core/providers/cuda/cuda_provider_factory.h"
+#endif
 
 namespace onnxruntime {
 namespace server {
@@ -37,35 +42,284 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
                                                                                                sink_(sink),
                                                                                                default_logger_(std::make_shared<spdlog::logger>(logger_id_, sink)),
                                                                                                runtime_environment_(severity, logger_id_.c_str(), Log, default_logger_.get()),
-                                                                                               session(nullptr) {
+                                                                                               scheduler_(std::make_unique<RequestScheduler>(0)) {
+  EnableModelResidency(0);
   spdlog::set_automatic_registration(false);
   spdlog::set_level(Convert(severity_));
   spdlog::initialize_logger(default_logger_);
 }
 
+ServerEnvironment::~ServerEnvironment() {
+  {
+    std::lock_guard<std::mutex> lock(poll_mutex_);
+    stop_polling_ = true;
+  }
+  poll_stop_.notify_all();
+  if (poll_thread_.joinable()) {
+    poll_thread_.join();
+  }
+}
+
+void ServerEnvironment::EnableBatching(size_t max_batch_size, std::chrono::microseconds max_queue_delay) {
+  max_batch_size_ = max_batch_size;
+  max_queue_delay_ = max_queue_delay;
+}
+
+void ServerEnvironment::EnableSequences(const SequenceStates& sequence_states) {
+  sequence_states_ = sequence_states;
+}
+
+void ServerEnvironment::EnableScheduling(size_t max_concurrent_runs) {
+  scheduler_ = std::make_unique<RequestScheduler>(max_concurrent_runs);
+}
+
+void ServerEnvironment::EnableResponseCache(size_t max_bytes, std::chrono::milliseconds ttl) {
+  response_cache_ = std::make_unique<ResponseCache>(max_bytes, ttl);
+}
+
+void ServerEnvironment::EnableModelResidency(size_t max_bytes) {
+  model_memory_budget_ = max_bytes;
+  residency_ = std::make_unique<ModelResidency>(max_bytes, [this](const std::string& model_path) {
+    return std::make_shared<ServedModel>(runtime_environment_, model_path, session_options_,
+                                         max_batch_size_, max_queue_delay_, sequence_states_);
+  });
+}
+
+void ServerEnvironment::EnableReplicas(int num_replicas, int threads_per_replica) {
+  if (threads_per_replica <= 0) {
+    session_options_.SetThreadPoolReplicas(num_replicas);
+    return;
+  }
+
+  std::vector<int> replica_affinities(static_cast<size_t>(num_replicas) * threads_per_replica);
+  for (size_t i = 0; i < replica_affinities.size(); ++i) {
+    replica_affinities[i] = static_cast<int>(i);
+  }
+  session_options_.SetThreadPoolSize(threads_per_replica);
+  session_options_.SetThreadPoolReplicas(num_replicas, replica_affinities.data(),
+                                         static_cast<size_t>(threads_per_replica));
+}
+
+void ServerEnvironment::EnableCuda(int device_id) {
+#ifdef USE_CUDA
+  ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_CUDA(session_options_, device_id));
+  ORT_THROW_ON_ERROR(OrtGetCudaPinnedAllocator(&request_allocator_));
+#else
+  ORT_UNUSED_PARAMETER(device_id);
+  throw Ort::Exception("The server wasn't built with CUDA", ORT_NOT_IMPLEMENTED);
+#endif
+}
+
 void ServerEnvironment::InitializeModel(const std::string& model_path) {
-  session = Ort::Session(runtime_environment_, model_path.c_str(), Ort::SessionOptions());
+  auto model = std::make_shared<ServedModel>(runtime_environment_, model_path, session_options_,
+                                             max_batch_size_, max_queue_delay_, sequence_states_);
+  if (model->GetBatcher() != nullptr && !model->GetBatcher()->IsBatching()) {
+    default_logger_->warn("Batching is disabled: the model inputs don't all have a symbolic first dimension");
+  }
+
+  std::lock_guard<std::mutex> lock(models_mutex_);
+  default_model_ = std::move(model);
+}
 
-  auto output_count = session.GetOutputCount();
+void ServerEnvironment::InitializeModelRepository(const std::string& model_repository) {
+  model_repository_ = model_repository;
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  for (size_t i = 0; i < output_count; i++) {
-    auto name = session.GetOutputName(i, allocator);
-    model_output_names_.push_back(name);
-    allocator.Free(name);
+  // fail early if the repository can't be read, the later reloads only log it
+  ScanModelRepository();
+  ReloadModelRepository();
+}
+
+static bool ParseVersion(const std::string& name, int64_t& version) {
+  if (name.empty() || name.size() > 18 || name.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
   }
+
+  version = std::stoll(name);
+  return version > 0;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames() const {
-  return model_output_names_;
+static bool IsDirectory(OrtFileType type) {
+  // some file systems don't report the type of the entries
+  return type == OrtFileType::TYPE_DIR || type == OrtFileType::TYPE_LNK || type == OrtFileType::TYPE_UNKNOWN;
 }
 
-OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
-  return severity_;
+ServerEnvironment::ModelVersions ServerEnvironment::ScanModelRepository() const {
+  ModelVersions found;
+
+  std::vector<std::string> model_names;
+  LoopDir(model_repository_, [&model_names](const char* name, OrtFileType type) -> bool {
+    if (IsDirectory(type) && name[0] != '.') {
+      model_names.push_back(name);
+    }
+    return true;
+  });
+
+  for (const auto& model_name : model_names) {
+    const auto model_dir = model_repository_ + "/" + model_name;
+    std::map<int64_t, std::string> versions;
+    try {
+      LoopDir(model_dir, [&model_dir, &versions](const char* name, OrtFileType type) -> bool {
+        int64_t version = 0;
+        if (IsDirectory(type) && ParseVersion(name, version)) {
+          auto model_path = model_dir + "/" + name + "/model.onnx";
+          if (std::ifstream(model_path).good()) {
+            versions[version] = std::move(model_path);
+          }
+        }
+        return true;
+      });
+    } catch (const std::runtime_error&) {
+      // not a directory
+      continue;
+    }
+
+    if (!versions.empty()) {
+      found[model_name] = std::move(versions);
+    }
+  }
+
+  return found;
 }
 
-const Ort::Session& ServerEnvironment::GetSession() const {
-  return session;
+void ServerEnvironment::ReloadModelRepository() {
+  std::lock_guard<std::mutex> reload_lock(reload_mutex_);
+
+  ModelVersions found;
+  try {
+    found = ScanModelRepository();
+  } catch (const std::exception& e) {
+    default_logger_->error("Reading the model repository {} failed: {}", model_repository_, e.what());
+    return;
+  }
+
+  for (const auto& model : found) {
+    for (const auto& version : model.second) {
+      {
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        auto it = models_.find(model.first);
+        if (it != models_.end() && it->second.count(version.first) > 0) {
+          continue;
+        }
+      }
+
+      // with a memory budget, the new version is loaded on its first request
+      if (model_memory_budget_ > 0) {
+        residency_->Add(version.second);
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        models_[model.first][version.first] = version.second;
+        default_logger_->info("Serving model {} version {}", model.first, version.first);
+        continue;
+      }
+
+      // load the new version without blocking the requests
+      std::shared_ptr<ServedModel> served_model;
+      try {
+        served_model = std::make_shared<ServedModel>(runtime_environment_, version.second, session_options_,
+                                                     max_batch_size_, max_queue_delay_, sequence_states_);
+      } catch (const Ort::Exception& e) {
+        default_logger_->error("Loading {} failed: {}", version.second, e.what());
+        continue;
+      }
+
+      try {
+        served_model->WarmUp();
+      } catch (const Ort::Exception& e) {
+        // zero-filled inputs may not be valid for the model, the version is still served
+        default_logger_->warn("Warming up {} failed: {}", version.second, e.what());
+      }
+
+      residency_->Add(version.second, std::move(served_model));
+      {
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        models_[model.first][version.first] = version.second;
+      }
+      default_logger_->info("Serving model {} version {}", model.first, version.first);
+    }
+  }
+
+  // unload the removed versions. the requests running them hold them until they are done.
+  std::vector<std::string> unloaded;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    for (auto it = models_.begin(); it != models_.end();) {
+      auto found_model = found.find(it->first);
+      auto& versions = it->second;
+      for (auto version = versions.begin(); version != versions.end();) {
+        if (found_model == found.end() || found_model->second.count(version->first) == 0) {
+          default_logger_->info("Unloading model {} version {}", it->first, version->first);
+          unloaded.push_back(std::move(version->second));
+          version = versions.erase(version);
+        } else {
+          ++version;
+        }
+      }
+
+      it = versions.empty() ? models_.erase(it) : std::next(it);
+    }
+  }
+
+  for (const auto& model_path : unloaded) {
+    residency_->Remove(model_path);
+  }
+
+  // load back the unloaded models that were requested since the previous reload, while they fit in the budget
+  if (model_memory_budget_ > 0) {
+    residency_->Prefetch();
+  }
+}
+
+void ServerEnvironment::StartModelRepositoryPolling(std::chrono::milliseconds poll_interval) {
+  poll_thread_ = std::thread([this, poll_interval]() {
+    std::unique_lock<std::mutex> lock(poll_mutex_);
+    while (!poll_stop_.wait_for(lock, poll_interval, [this]() { return stop_polling_; })) {
+      lock.unlock();
+      ReloadModelRepository();
+      lock.lock();
+    }
+  });
+}
+
+std::shared_ptr<ServedModel> ServerEnvironment::GetModel(const std::string& name, const std::string& version) const {
+  std::string model_path;
+  {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    if (model_repository_.empty()) {
+      return default_model_;
+    }
+
+    auto model = models_.find(name);
+    if (model == models_.end()) {
+      return nullptr;
+    }
+
+    const auto& versions = model->second;
+    if (version.empty()) {
+      model_path = versions.rbegin()->second;
+    } else {
+      int64_t version_number = 0;
+      if (!ParseVersion(version, version_number)) {
+        return nullptr;
+      }
+
+      auto it = versions.find(version_number);
+      if (it == versions.end()) {
+        return nullptr;
+      }
+      model_path = it->second;
+    }
+  }
+
+  // a model that isn't loaded is loaded out of the lock, the requests of the other models don't wait for it
+  try {
+    return residency_->Get(model_path);
+  } catch (const Ort::Exception& e) {
+    default_logger_->error("Loading {} failed: {}", model_path, e.what());
+    return nullptr;
+  }
+}
+
+OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
+  return severity_;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -3,26 +3,101 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include <spdlog/spdlog.h>
 
+#include "model_residency.h"
+#include "served_model.h"
+#include "request_scheduler.h"
+#include "response_cache.h"
+#include "shared_memory.h"
+
 namespace onnxruntime {
 namespace server {
 
 class ServerEnvironment {
  public:
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
-  ~ServerEnvironment() = default;
+  ~ServerEnvironment();
   ServerEnvironment(const ServerEnvironment&) = delete;
 
   OrtLoggingLevel GetLogSeverity() const;
 
-  const Ort::Session& GetSession() const;
+  // Batches concurrent requests to the models loaded after this call, see Batcher.
+  // A max_batch_size of 1 disables batching.
+  void EnableBatching(size_t max_batch_size, std::chrono::microseconds max_queue_delay);
+
+  // Serves the models loaded after this call as step models carrying sequence_states from a step to the next, which
+  // a request runs over a whole sequence, the steps of the concurrent sequences being batched. See ServedModel::Run.
+  void EnableSequences(const SequenceStates& sequence_states);
+
+  // Runs the requests to the models loaded after this call on num_replicas thread pools of threads_per_replica
+  // threads each, sharing the weights of the model, see OrtSetSessionThreadPoolReplicas. A threads_per_replica
+  // of 0 lets the runtime choose the size of the pools and doesn't pin their threads; otherwise the threads of
+  // replica i are pinned to the processors [i * threads_per_replica, (i + 1) * threads_per_replica).
+  // Throws Ort::Exception on a bad value.
+  void EnableReplicas(int num_replicas, int threads_per_replica);
+
+  // Runs the models loaded after this call on CUDA device device_id, the tensors of the requests being allocated in
+  // pinned host memory so they're copied to the device asynchronously, without staging. Throws Ort::Exception if
+  // the runtime wasn't built with CUDA.
+  void EnableCuda(int device_id);
+
+  // The allocator of the tensors of the requests, nullptr to read them from the request or allocate them on the heap
+  OrtAllocator* GetRequestAllocator() const { return request_allocator_; }
+
+  // Lets at most max_concurrent_runs requests run at once, the others waiting in the order of their priority and
+  // deadline, see RequestScheduler. 0 doesn't limit them. To be called before serving the requests.
+  void EnableScheduling(size_t max_concurrent_runs);
+
+  // The order the requests run in
+  RequestScheduler& GetScheduler() { return *scheduler_; }
+
+  // Answers the repeated requests from a cache of max_bytes, the responses expiring after ttl (never if 0).
+  // Only for deterministic models: a cached response isn't run again. See ResponseCache.
+  void EnableResponseCache(size_t max_bytes, std::chrono::milliseconds ttl);
+
+  // nullptr if the response cache isn't enabled
+  ResponseCache* GetResponseCache() { return response_cache_.get(); }
+
+  // Keeps the models of the repository loaded within max_bytes, estimated from the size of their files: the models
+  // are loaded on their first request, the least recently used ones unloaded beyond the budget, and the ones
+  // requested since the previous poll of the repository loaded back while they fit. See ModelResidency.
+  // 0 loads every model with the repository. To be called before InitializeModelRepository.
+  void EnableModelResidency(size_t max_bytes);
+
+  // Loads a single model, served under any model name and version. Throws Ort::Exception on failure.
   void InitializeModel(const std::string& model_path);
-  const std::vector<std::string>& GetModelOutputNames() const;
+
+  // Serves the models of a repository directory laid out as <model_repository>/<model name>/<version>/model.onnx,
+  // the versions being positive integers. Several models and versions of each are served at the same time.
+  // Throws std::runtime_error if the directory can't be read.
+  void InitializeModelRepository(const std::string& model_repository);
+
+  // Loads the versions added to the model repository and unloads the removed ones.
+  // A new version is loaded and warmed up in the calling thread, then swapped in at once: requests keep running
+  // the versions already loaded meanwhile, and the ones still running a removed version finish with it.
+  void ReloadModelRepository();
+
+  // Calls ReloadModelRepository every poll_interval in a background thread, until the environment is destroyed.
+  void StartModelRepositoryPolling(std::chrono::milliseconds poll_interval);
+
+  // Gets the model serving a request, an empty version being the latest one, loading it if it isn't loaded.
+  // nullptr if there is no such model or it couldn't be loaded, which is logged.
+  std::shared_ptr<ServedModel> GetModel(const std::string& name, const std::string& version) const;
+
+  // The shared memory regions registered by the clients, see PredictRequest.shared_memory_inputs.
+  SharedMemoryManager& GetSharedMemory() { return shared_memory_; }
+
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
 
@@ -33,9 +108,36 @@ class ServerEnvironment {
   const std::shared_ptr<spdlog::logger> default_logger_;
 
   Ort::Env runtime_environment_;
-  Ort::SessionOptions options_;
-  Ort::Session session;
-  std::vector<std::string> model_output_names_;
+
+  size_t max_batch_size_ = 1;
+  std::chrono::microseconds max_queue_delay_{0};
+  SequenceStates sequence_states_;
+  Ort::SessionOptions session_options_;
+  OrtAllocator* request_allocator_ = nullptr;
+
+  // versions of each model, by name, found in the model repository
+  using ModelVersions = std::unordered_map<std::string, std::map<int64_t, std::string>>;
+  ModelVersions ScanModelRepository() const;
+
+  std::string model_repository_;
+  std::mutex reload_mutex_;
+
+  mutable std::mutex models_mutex_;
+  std::shared_ptr<ServedModel> default_model_;
+  // the paths of the versions served, the models being held by residency_
+  ModelVersions models_;
+  size_t model_memory_budget_ = 0;
+  std::unique_ptr<ModelResidency> residency_;
+
+  SharedMemoryManager shared_memory_;
+
+  std::unique_ptr<RequestScheduler> scheduler_;
+  std::unique_ptr<ResponseCache> response_cache_;
+
+  std::mutex poll_mutex_;
+  std::condition_variable poll_stop_;
+  bool stop_polling_ = false;
+  std::thread poll_thread_;
 };
 
 }  // namespace server
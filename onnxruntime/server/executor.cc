@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include "core/common/logging/logging.h"
+#include "core/common/metrics.h"
 #include "core/framework/data_types.h"
 #include "core/session/environment.h"
 #include "core/framework/framework_common.h"
@@ -25,10 +29,24 @@ namespace protobufutil = google::protobuf::util;
 
 protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           MemBufferArray& buffers,
-                                          OrtMemoryInfo* cpu_memory_info,
+                                          const OrtMemoryInfo* memory_info,
+                                          const OrtMemoryInfo* cpu_memory_info,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // use the raw data of the request in place if possible, the request outlives the run. the inputs copied to a
+  // device are read into pinned buffers instead, from which the copy doesn't need to be staged.
+  if (buffers.GetAllocator() == nullptr) {
+    try {
+      if (onnxruntime::server::TryTensorProtoRawDataToMLValue(input_tensor, *cpu_memory_info, ml_value)) {
+        return protobufutil::Status::OK;
+      }
+    } catch (const Ort::Exception& e) {
+      logger->error("TryTensorProtoRawDataToMLValue() failed. Message: {}", e.what());
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -37,11 +55,14 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
 
-  auto* buf = buffers.AllocNewBuffer(cpu_tensor_length);
+  // the strings are objects, which only the CPU reads
+  const bool on_heap = input_tensor.data_type() == onnx::TensorProto_DataType_STRING;
   try {
-    onnxruntime::server::TensorProtoToMLValue(input_tensor,
-                                              onnxruntime::server::MemBuffer(buf, cpu_tensor_length, *cpu_memory_info),
-                                              ml_value);
+    auto* buf = buffers.AllocNewBuffer(cpu_tensor_length, on_heap);
+    onnxruntime::server::TensorProtoToMLValue(
+        input_tensor,
+        onnxruntime::server::MemBuffer(buf, cpu_tensor_length, on_heap ? *cpu_memory_info : *memory_info),
+        ml_value);
 
   } catch (const Ort::Exception& e) {
     logger->error("TensorProtoToMLValue() failed. Message: {}", e.what());
@@ -51,28 +72,105 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
   return protobufutil::Status::OK;
 }
 
+// Gets the data of the range of a shared memory tensor, and holds its region in regions
+static protobufutil::Status GetSharedMemoryData(SharedMemoryManager& shared_memory, const SharedMemoryTensor& tensor,
+                                                std::vector<std::shared_ptr<SharedMemoryRegion>>& regions,
+                                                /* out */ uint8_t*& data) {
+  auto region = shared_memory.Get(tensor.region());
+  if (region == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::NOT_FOUND,
+                                "No shared memory region is registered as " + tensor.region());
+  }
+
+  if (tensor.offset() > region->GetSize() || tensor.byte_size() > region->GetSize() - tensor.offset()) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "The tensor range exceeds shared memory region " + tensor.region());
+  }
+
+  data = region->GetData() + tensor.offset();
+  regions.push_back(std::move(region));
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status Executor::SetSharedMemoryInputs(std::vector<std::string>& input_names,
+                                                     std::vector<Ort::Value>& input_values,
+                                                     const onnxruntime::server::PredictRequest& request,
+                                                     std::vector<std::shared_ptr<SharedMemoryRegion>>& regions) {
+  auto logger = env_->GetLogger(request_id_);
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+  for (const auto& input : request.shared_memory_inputs()) {
+    const auto& tensor = input.second;
+    uint8_t* data = nullptr;
+    auto status = GetSharedMemoryData(env_->GetSharedMemory(), tensor, regions, data);
+    if (!status.ok()) {
+      logger->error("Shared memory input {}: {}", input.first, status.error_message());
+      return status;
+    }
+
+    const auto type = static_cast<ONNXTensorElementDataType>(tensor.data_type());
+    const size_t element_size = GetTensorElementSize(type);
+    if (element_size == 0) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Unsupported data type of shared memory input " + input.first);
+    }
+
+    std::vector<int64_t> dims(tensor.dims().begin(), tensor.dims().end());
+    uint64_t num_elements = 1;
+    for (auto dim : dims) {
+      if (dim < 0) {
+        return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                    "Negative dimension of shared memory input " + input.first);
+      }
+      num_elements *= static_cast<uint64_t>(dim);
+    }
+    if (num_elements * element_size != tensor.byte_size()) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "The byte size of shared memory input " + input.first +
+                                      " doesn't match its type and dims");
+    }
+
+    try {
+      input_values.push_back(Ort::Value::CreateTensor(memory_info, data, static_cast<size_t>(tensor.byte_size()),
+                                                      dims.data(), dims.size(), type));
+    } catch (const Ort::Exception& e) {
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+    input_names.push_back(input.first);
+  }
+
+  return protobufutil::Status::OK;
+}
+
 protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input_names,
                                                  std::vector<Ort::Value>& input_values,
                                                  const onnxruntime::server::PredictRequest& request,
                                                  MemBufferArray& buffers) {
   auto logger = env_->GetLogger(request_id_);
 
-  OrtMemoryInfo* memory_info = nullptr;
-  auto ort_status = OrtCreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info);
+  OrtMemoryInfo* cpu_memory_info = nullptr;
+  auto ort_status = OrtCreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &cpu_memory_info);
 
-  if (ort_status != nullptr || memory_info == nullptr) {
+  if (ort_status != nullptr || cpu_memory_info == nullptr) {
+    OrtReleaseStatus(ort_status);
     logger->error("OrtCreateCpuMemoryInfo failed");
     return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED, "OrtCreateCpuMemoryInfo() failed");
   }
 
+  // the buffers allocated by the allocator of the requests are described by its memory info, e.g. pinned memory
+  const OrtMemoryInfo* memory_info = cpu_memory_info;
+  if (buffers.GetAllocator() != nullptr) {
+    OrtReleaseStatus(OrtAllocatorGetInfo(buffers.GetAllocator(), &memory_info));
+  }
+
   // Prepare the Value object
   for (const auto& input : request.inputs()) {
     using_raw_data_ = using_raw_data_ && input.second.has_raw_data();
 
     Ort::Value ml_value{nullptr};
-    auto status = SetMLValue(input.second, buffers, memory_info, ml_value);
+    auto status = SetMLValue(input.second, buffers, memory_info, cpu_memory_info, ml_value);
     if (status != protobufutil::Status::OK) {
-      OrtReleaseMemoryInfo(memory_info);
+      OrtReleaseMemoryInfo(cpu_memory_info);
       logger->error("SetMLValue() failed! Input name: {}", input.first);
       return status;
     }
@@ -81,36 +179,138 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
     input_values.push_back(std::move(ml_value));
   }
 
-  OrtReleaseMemoryInfo(memory_info);
+  OrtReleaseMemoryInfo(cpu_memory_info);
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
-  size_t input_count = input_names.size();
-  size_t output_count = output_names.size();
+namespace {
+// The range of shared memory an output is written to
+struct SharedMemoryOutput {
+  const SharedMemoryTensor* tensor = nullptr;
+  uint8_t* data = nullptr;
+  size_t size = 0;
+};
+}  // namespace
+
+// Writes the outputs into their ranges of shared memory. An output that doesn't fit is allocated by the session, and
+// then fails in SetSharedMemoryOutput.
+static void* ORT_API_CALL AllocateSharedMemoryOutput(void* user_data, size_t output_index,
+                                                     ONNXTensorElementDataType /*type*/, const int64_t* /*shape*/,
+                                                     size_t /*shape_len*/, size_t size) {
+  const auto& outputs = *static_cast<const std::vector<SharedMemoryOutput>*>(user_data);
+  const auto& output = outputs[output_index];
+  return output.tensor != nullptr && size <= output.size ? output.data : nullptr;
+}
+
+// Describes an output written into shared memory in the response. The outputs that the session didn't write in place,
+// e.g. initializers, are copied into their range.
+static protobufutil::Status SetSharedMemoryOutput(Ort::Value& value, const SharedMemoryOutput& output,
+                                                  const std::string& name, /* out */ SharedMemoryTensor& tensor) {
+  if (!value.IsTensor()) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Output " + name + " isn't a tensor, it can't be written to shared memory");
+  }
 
-  std::vector<const char*> input_ptrs{};
-  input_ptrs.reserve(input_count);
-  for (const auto& input : input_names) {
-    input_ptrs.push_back(input.data());
+  auto type_and_shape = value.GetTensorTypeAndShapeInfo();
+  const auto type = type_and_shape.GetElementType();
+  const size_t element_size = GetTensorElementSize(type);
+  if (element_size == 0) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Unsupported data type of output " + name + " for shared memory");
   }
-  std::vector<const char*> output_ptrs{};
-  output_ptrs.reserve(output_count);
-  for (const auto& output : output_names) {
-    output_ptrs.push_back(output.data());
+
+  const size_t size = type_and_shape.GetElementCount() * element_size;
+  if (size > output.size) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Output " + name + " of " + std::to_string(size) +
+                                    " bytes doesn't fit in its shared memory range");
   }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  auto* data = value.GetTensorMutableData<uint8_t>();
+  if (data != output.data && size > 0) {
+    std::memcpy(output.data, data, size);
+  }
+
+  tensor.set_data_type(MLDataTypeToTensorProtoDataType(type));
+  for (auto dim : type_and_shape.GetShape()) {
+    tensor.add_dims(dim);
+  }
+  tensor.set_region(output.tensor->region());
+  tensor.set_offset(output.tensor->offset());
+  tensor.set_byte_size(size);
+  return protobufutil::Status::OK;
+}
+
+// Counts a request, and its duration if it succeeded
+static void RecordRequest(const std::string& model_name, const protobufutil::Status& status,
+                          std::chrono::duration<double> duration) {
+  auto& registry = metrics::MetricsRegistry::Global();
+  registry.GetCounter("onnxruntime_server_requests_total", "Prediction requests by model and status code.",
+                      {{"model", model_name}, {"code", std::to_string(status.error_code())}})
+      .Increment();
+  if (status.ok()) {
+    registry.GetHistogram("onnxruntime_server_request_duration_seconds", "Duration of the successful predictions.",
+                          metrics::MetricsRegistry::DefaultDurationBounds(), {{"model", model_name}})
+        .Observe(duration.count());
+  }
 }
 
 protobufutil::Status Executor::Predict(const std::string& model_name,
                                        const std::string& model_version,
                                        const onnxruntime::server::PredictRequest& request,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
+  auto model = env_->GetModel(model_name, model_version);
+  if (model == nullptr) {
+    auto logger = env_->GetLogger(request_id_);
+    logger->error("Model {} version {} not found", model_name, model_version);
+    protobufutil::Status status(protobufutil::error::Code::NOT_FOUND,
+                                "Model " + model_name + (model_version.empty() ? "" : " version " + model_version) + " not found");
+    // the names of the unknown models aren't labels, so that clients can't grow the metrics without bound
+    RecordRequest("", status, {});
+    return status;
+  }
+
+  return Predict(model, model_name, request, response);
+}
+
+protobufutil::Status Executor::Predict(const std::shared_ptr<ServedModel>& model,
+                                       const std::string& model_name,
+                                       const onnxruntime::server::PredictRequest& request,
+                                       /* out */ onnxruntime::server::PredictResponse& response) {
+  const auto begin_time = std::chrono::high_resolution_clock::now();
+
+  // a repeated request is answered from the cache without running the model
+  auto* cache = env_->GetResponseCache();
+  std::string cache_key;
+  const bool cacheable = cache != nullptr && ResponseCache::GetKey(model->GetModelPath(), request, cache_key);
+  if (cacheable) {
+    const bool hit = cache->Get(cache_key, response);
+    metrics::MetricsRegistry::Global()
+        .GetCounter(hit ? "onnxruntime_server_response_cache_hits_total" : "onnxruntime_server_response_cache_misses_total",
+                    hit ? "Predictions answered from the response cache." : "Cacheable predictions not in the response cache.",
+                    {{"model", model_name}})
+        .Increment();
+    if (hit) {
+      RecordRequest(model_name, protobufutil::Status::OK, std::chrono::high_resolution_clock::now() - begin_time);
+      return protobufutil::Status::OK;
+    }
+  }
+
+  auto status = PredictImpl(*model, request, response);
+  if (cacheable && status.ok()) {
+    cache->Put(cache_key, response);
+  }
+  RecordRequest(model_name, status, std::chrono::high_resolution_clock::now() - begin_time);
+  return status;
+}
+
+protobufutil::Status Executor::PredictImpl(ServedModel& model,
+                                           const onnxruntime::server::PredictRequest& request,
+                                           /* out */ onnxruntime::server::PredictResponse& response) {
   auto logger = env_->GetLogger(request_id_);
 
   // Convert PredictRequest to NameMLValMap
-  MemBufferArray buffer_array;
+  MemBufferArray buffer_array(env_->GetRequestAllocator());
   std::vector<std::string> input_names;
   std::vector<Ort::Value> input_values;
   auto conversion_status = SetNameMLValueMap(input_names, input_values, request, buffer_array);
@@ -118,6 +318,13 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
     return conversion_status;
   }
 
+  // the regions of the shared memory tensors, held until the response is built
+  std::vector<std::shared_ptr<SharedMemoryRegion>> regions;
+  conversion_status = SetSharedMemoryInputs(input_names, input_values, request, regions);
+  if (conversion_status != protobufutil::Status::OK) {
+    return conversion_status;
+  }
+
   Ort::RunOptions run_options{};
   run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
   run_options.SetRunTag(request_id_.c_str());
@@ -131,19 +338,78 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       output_names.push_back(name);
     }
   } else {
-    output_names = env_->GetModelOutputNames();
+    output_names = model.GetOutputNames();
+  }
+
+  // the range of each output written into shared memory, by output index
+  std::vector<SharedMemoryOutput> shared_memory_outputs(output_names.size());
+  for (const auto& output : request.shared_memory_outputs()) {
+    auto it = std::find(output_names.begin(), output_names.end(), output.first);
+    const size_t index = static_cast<size_t>(it - output_names.begin());
+    if (it == output_names.end()) {
+      output_names.push_back(output.first);
+      shared_memory_outputs.emplace_back();
+    }
+
+    auto& shared_memory_output = shared_memory_outputs[index];
+    shared_memory_output.tensor = &output.second;
+    shared_memory_output.size = static_cast<size_t>(output.second.byte_size());
+    auto status = GetSharedMemoryData(env_->GetSharedMemory(), output.second, regions, shared_memory_output.data);
+    if (!status.ok()) {
+      logger->error("Shared memory output {}: {}", output.first, status.error_message());
+      return status;
+    }
+  }
+
+  // wait for the turn of the request. the admission is released before run_options goes away.
+  // a batch runs with the options of one of its requests, so a batching model doesn't terminate it at a deadline.
+  std::unique_ptr<RequestScheduler::Admission> admission;
+  auto* terminated_options = model.GetBatcher() == nullptr ? &run_options : nullptr;
+  auto admission_status = env_->GetScheduler().Admit(priority_, deadline_, terminated_options, admission);
+  if (!admission_status.ok()) {
+    logger->warn("Request dropped: {}", admission_status.error_message());
+    return admission_status;
   }
 
   std::vector<Ort::Value> outputs;
   try {
-    outputs = Run(env_->GetSession(), run_options, input_names, input_values, output_names);
+    if (request.shared_memory_outputs().empty()) {
+      outputs = model.Run(run_options, input_names, input_values, output_names);
+    } else {
+      outputs = model.Run(run_options, input_names, input_values, output_names, AllocateSharedMemoryOutput,
+                           &shared_memory_outputs);
+    }
   } catch (const Ort::Exception& e) {
+    if (std::chrono::steady_clock::now() >= deadline_) {
+      logger->warn("Request terminated at its deadline: {}", e.what());
+      return protobufutil::Status(protobufutil::error::Code::DEADLINE_EXCEEDED,
+                                  "The request was terminated at its deadline");
+    }
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
+  admission.reset();
 
   // Build the response
+  auto& response_outputs = *response.mutable_outputs();
+  auto& response_shared_memory_outputs = *response.mutable_shared_memory_outputs();
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    if (shared_memory_outputs[i].tensor != nullptr) {
+      auto status = SetSharedMemoryOutput(outputs[i], shared_memory_outputs[i], output_names[i],
+                                          response_shared_memory_outputs[output_names[i]]);
+      if (!status.ok()) {
+        logger->error("Shared memory output {}: {}", output_names[i], status.error_message());
+        return status;
+      }
+      continue;
+    }
+
+    if (response_outputs.count(output_names[i]) > 0) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
+
+    // serialize in place, the tensor data is only copied once into the response
+    auto& output_tensor = response_outputs[output_names[i]];
     try {
       MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
     } catch (const Ort::Exception& e) {
@@ -151,13 +417,6 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
-
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
   }
 
   return protobufutil::Status::OK;
@@ -6,6 +6,8 @@
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
+#include "request_scheduler.h"
+#include "shared_memory.h"
 #include "predict.pb.h"
 #include "util.h"
 #include "core/session/onnxruntime_cxx_api.h"
@@ -19,22 +21,50 @@ class Executor {
                                                                     request_id_(std::move(request_id)),
                                                                     using_raw_data_(true) {}
 
+  // Schedules the request among the others, see RequestScheduler. Normal priority and no deadline by default.
+  void SetSchedule(RequestPriority priority, RequestDeadline deadline) {
+    priority_ = priority;
+    deadline_ = deadline;
+  }
+
   // Prediction method
   google::protobuf::util::Status Predict(const std::string& model_name,
                                          const std::string& model_version,
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Prediction with a model the caller got from the environment, e.g. once for a stream of requests.
+  // model_name labels the metrics of the request.
+  google::protobuf::util::Status Predict(const std::shared_ptr<ServedModel>& model,
+                                         const std::string& model_name,
+                                         const onnxruntime::server::PredictRequest& request,
+                                         /* out */ onnxruntime::server::PredictResponse& response);
+
  private:
   ServerEnvironment* env_;
   const std::string request_id_;
   bool using_raw_data_;
+  RequestPriority priority_ = RequestPriority::Normal;
+  RequestDeadline deadline_ = kNoDeadline;
+
+  google::protobuf::util::Status PredictImpl(ServedModel& model,
+                                             const onnxruntime::server::PredictRequest& request,
+                                             /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Reads the input in place from the request if it's raw data and buffers are on the heap, otherwise into a buffer
+  // of buffers, described by memory_info, or by cpu_memory_info if it's on the heap.
   google::protobuf::util::Status SetMLValue(const onnx::TensorProto& input_tensor,
                                             MemBufferArray& buffers,
-                                            OrtMemoryInfo* cpu_memory_info,
+                                            const OrtMemoryInfo* memory_info,
+                                            const OrtMemoryInfo* cpu_memory_info,
                                             /* out */ Ort::Value& ml_value);
 
+  // Adds the inputs read in place from shared memory. Their regions are held in regions for the run.
+  google::protobuf::util::Status SetSharedMemoryInputs(/* out */ std::vector<std::string>& input_names,
+                                                       /* out */ std::vector<Ort::Value>& input_values,
+                                                       const onnxruntime::server::PredictRequest& request,
+                                                       /* out */ std::vector<std::shared_ptr<SharedMemoryRegion>>& regions);
+
   google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
                                                    /* out */ std::vector<Ort::Value>& input_values,
                                                    const onnxruntime::server::PredictRequest& request,
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "prediction_service_impl.h"
 #include "request_id.h"
 
@@ -7,11 +9,101 @@ namespace grpc {
 
 PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
 
+// Gets the value of the client metadata with the given key, or default_value if the client didn't send it
+static std::string GetClientMetadata(const ::grpc::ServerContext* context, const std::string& key, const std::string& default_value) {
+  const auto& metadata = context->client_metadata();
+  auto search = metadata.find(key);
+  if (search == metadata.end()) {
+    return default_value;
+  }
+  return std::string{search->second.data(), search->second.length()};
+}
+
+// Gets the priority and deadline of a request from its metadata. The deadline is the earlier of the timeout
+// metadata and the deadline of the call.
+static google::protobuf::util::Status GetRequestSchedule(const ::grpc::ServerContext* context,
+                                                         /* out */ RequestPriority& priority,
+                                                         /* out */ RequestDeadline& deadline) {
+  auto status = ParseRequestSchedule(GetClientMetadata(context, util::REQUEST_PRIORITY_METADATA, ""),
+                                     GetClientMetadata(context, util::REQUEST_TIMEOUT_METADATA, ""), priority, deadline);
+  if (status.ok() && context->deadline() != std::chrono::system_clock::time_point::max()) {
+    auto call_deadline = std::chrono::steady_clock::now() + (context->deadline() - std::chrono::system_clock::now());
+    deadline = std::min(deadline, std::chrono::time_point_cast<RequestDeadline::duration>(call_deadline));
+  }
+  return status;
+}
+
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
   onnxruntime::server::Executor executor(environment_.get(), request_id);
-  //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  // the request message has no model spec, the model is picked with the metadata. the latest version by default.
+  auto model_name = GetClientMetadata(context, util::MODEL_NAME_METADATA, "default");
+  auto model_version = GetClientMetadata(context, util::MODEL_VERSION_METADATA, "");
+  RequestPriority priority;
+  RequestDeadline deadline;
+  auto status = GetRequestSchedule(context, priority, deadline);
+  if (!status.ok()) {
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+  executor.SetSchedule(priority, deadline);
+  status = executor.Predict(model_name, model_version, *request, *response);
+  if (!status.ok()) {
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::PredictStream(::grpc::ServerContext* context, ::grpc::ServerReaderWriter<::onnxruntime::server::PredictResponse, ::onnxruntime::server::PredictRequest>* stream) {
+  // the request context and the model are set up once, and the messages reused, for all the requests of the stream.
+  // holding the model also keeps the stream on the same version when the repository is reloaded.
+  auto request_id = SetRequestContext(context);
+  auto model_name = GetClientMetadata(context, util::MODEL_NAME_METADATA, "default");
+  auto model_version = GetClientMetadata(context, util::MODEL_VERSION_METADATA, "");
+  auto model = environment_->GetModel(model_name, model_version);
+  if (model == nullptr) {
+    return ::grpc::Status(::grpc::StatusCode::NOT_FOUND, "Model " + model_name + (model_version.empty() ? "" : " version " + model_version) + " not found");
+  }
+
+  ::onnxruntime::server::PredictRequest request;
+  ::onnxruntime::server::PredictResponse response;
+  while (stream->Read(&request)) {
+    response.Clear();
+    onnxruntime::server::Executor executor(environment_.get(), request_id);
+    // the timeout counts from the read of each request
+    RequestPriority priority;
+    RequestDeadline deadline;
+    auto status = GetRequestSchedule(context, priority, deadline);
+    if (!status.ok()) {
+      return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+    }
+    executor.SetSchedule(priority, deadline);
+    status = executor.Predict(model, model_name, request, response);
+    if (!status.ok()) {
+      return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+    }
+    if (!stream->Write(response)) {
+      break;
+    }
+  }
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* /*response*/) {
+  auto request_id = SetRequestContext(context);
+  auto logger = environment_->GetLogger(request_id);
+  logger->info("Registering shared memory region {}: {} [{}, +{})", request->name(), request->key(), request->offset(), request->byte_size());
+  auto status = environment_->GetSharedMemory().Register(request->name(), request->key(), request->offset(), request->byte_size());
+  if (!status.ok()) {
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* /*response*/) {
+  auto request_id = SetRequestContext(context);
+  auto logger = environment_->GetLogger(request_id);
+  logger->info("Unregistering shared memory region {}", request->name());
+  auto status = environment_->GetSharedMemory().Unregister(request->name());
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
@@ -11,6 +11,9 @@ class PredictionServiceImpl final : public onnxruntime::server::PredictionServic
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
   ::grpc::Status Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response);
+  ::grpc::Status PredictStream(::grpc::ServerContext* context, ::grpc::ServerReaderWriter<::onnxruntime::server::PredictResponse, ::onnxruntime::server::PredictRequest>* stream);
+  ::grpc::Status RegisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::RegisterSharedMemoryRequest* request, ::onnxruntime::server::RegisterSharedMemoryResponse* response);
+  ::grpc::Status UnregisterSharedMemory(::grpc::ServerContext* context, const ::onnxruntime::server::UnregisterSharedMemoryRequest* request, ::onnxruntime::server::UnregisterSharedMemoryResponse* response);
 
  private:
   std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
@@ -12,6 +12,7 @@
 #include "context.h"
 #include "session.h"
 #include "listener.h"
+#include "worker_pool.h"
 
 #include "http_server.h"
 
@@ -26,6 +27,8 @@ App::App() {
   http_details.address = boost::asio::ip::make_address_v4("0.0.0.0");
   http_details.port = 8001;
   http_details.threads = std::thread::hardware_concurrency();
+  http_details.worker_threads = std::thread::hardware_concurrency();
+  http_details.max_queued_requests = 1024;
 }
 
 App& App::Bind(net::ip::address address, unsigned short port) {
@@ -39,6 +42,16 @@ App& App::NumThreads(int threads) {
   return *this;
 }
 
+App& App::NumWorkerThreads(int threads) {
+  http_details.worker_threads = threads;
+  return *this;
+}
+
+App& App::MaxQueuedRequests(size_t max_queued_requests) {
+  http_details.max_queued_requests = max_queued_requests;
+  return *this;
+}
+
 App& App::RegisterStartup(const StartFn& on_start) {
   on_start_ = on_start;
   return *this;
@@ -49,6 +62,11 @@ App& App::RegisterPost(const std::string& route, const HandlerFn& fn) {
   return *this;
 }
 
+App& App::RegisterGet(const std::string& route, const HandlerFn& fn) {
+  routes_.RegisterController(http::verb::get, route, fn);
+  return *this;
+}
+
 App& App::RegisterError(const ErrorFn& fn) {
   routes_.RegisterErrorCallback(fn);
   return *this;
@@ -56,8 +74,10 @@ App& App::RegisterError(const ErrorFn& fn) {
 
 App& App::Run() {
   net::io_context ioc{http_details.threads};
+  // Declared after the I/O context, the workers are joined before it goes away
+  WorkerPool workers{http_details.worker_threads, http_details.max_queued_requests};
   // Create and launch a listening port
-  auto listener = std::make_shared<Listener>(routes_, ioc, tcp::endpoint{http_details.address, http_details.port});
+  auto listener = std::make_shared<Listener>(routes_, workers, ioc, tcp::endpoint{http_details.address, http_details.port});
 
   auto initialized = listener->Init();
   if (!initialized) {
@@ -27,6 +27,10 @@ struct Details {
   net::ip::address address;
   unsigned short port;
   int threads;
+  // the threads running the requests, 0 runs them on the I/O threads
+  int worker_threads;
+  // the requests queued or running on the workers at most, the others are answered with 429
+  size_t max_queued_requests;
 };
 
 using StartFn = std::function<void(Details&)>;
@@ -39,8 +43,11 @@ class App {
 
   App& Bind(net::ip::address address, unsigned short port);
   App& NumThreads(int threads);
+  App& NumWorkerThreads(int threads);
+  App& MaxQueuedRequests(size_t max_queued_requests);
   App& RegisterStartup(const StartFn& fn);
   App& RegisterPost(const std::string& route, const HandlerFn& fn);
+  App& RegisterGet(const std::string& route, const HandlerFn& fn);
   App& RegisterError(const ErrorFn& fn);
   App& Run();
 
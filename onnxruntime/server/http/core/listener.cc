@@ -11,8 +11,8 @@ namespace server {
 namespace net = boost::asio;       // from <boost/asio.hpp>
 using tcp = boost::asio::ip::tcp;  // from <boost/asio/ip/tcp.hpp>
 
-Listener::Listener(const Routes& routes, net::io_context& ioc, const tcp::endpoint& endpoint)
-    : routes_(routes), acceptor_(ioc), socket_(ioc), endpoint_(endpoint) {
+Listener::Listener(const Routes& routes, WorkerPool& workers, net::io_context& ioc, const tcp::endpoint& endpoint)
+    : routes_(routes), workers_(workers), acceptor_(ioc), socket_(ioc), endpoint_(endpoint) {
 }
 
 bool Listener::Init() {
@@ -72,7 +72,7 @@ void Listener::OnAccept(beast::error_code ec) {
   if (ec) {
     ErrorHandling(ec, "accept");
   } else {
-    std::make_shared<HttpSession>(routes_, std::move(socket_))->Run();
+    std::make_shared<HttpSession>(routes_, workers_, std::move(socket_))->Run();
   }
 
   // Accept another connection
@@ -9,6 +9,7 @@
 
 #include "routes.h"
 #include "util.h"
+#include "worker_pool.h"
 
 namespace onnxruntime {
 namespace server {
@@ -19,12 +20,13 @@ using tcp = boost::asio::ip::tcp;  // from <boost/asio/ip/tcp.hpp>
 // Listens on a socket and creates an HTTP session
 class Listener : public std::enable_shared_from_this<Listener> {
   Routes routes_;
+  WorkerPool& workers_;
   tcp::acceptor acceptor_;
   tcp::socket socket_;
   const tcp::endpoint endpoint_;
 
  public:
-  Listener(const Routes& routes, net::io_context& ioc, const tcp::endpoint& endpoint);
+  Listener(const Routes& routes, WorkerPool& workers, net::io_context& ioc, const tcp::endpoint& endpoint);
 
   // Initialize the HTTP server
   bool Init();
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
 #include "re2/re2.h"
 
@@ -60,9 +61,15 @@ http::status Routes::ParseUrl(http::verb method,
     return http::status::method_not_allowed;
   }
 
+  // a pattern captures at most the model name, the model version and the action, in this order
+  re2::RE2::Arg model_name_arg(&model_name), model_version_arg(&model_version), action_arg(&action);
+  const re2::RE2::Arg* const args[] = {&model_name_arg, &model_version_arg, &action_arg};
+
   bool found_match = false;
   for (const auto& pattern : func_table) {
-    if (re2::RE2::FullMatch(url, pattern.first, &model_name, &model_version, &action)) {
+    re2::RE2 re(pattern.first);
+    const int num_args = std::min(3, re.NumberOfCapturingGroups());
+    if (re2::RE2::FullMatchN(url, re, args, num_args)) {
       func = pattern.second;
 
       found_match = true;
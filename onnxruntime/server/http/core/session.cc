@@ -10,11 +10,17 @@ namespace net = boost::asio;       // from <boost/asio.hpp>
 namespace beast = boost::beast;    // from <boost/beast.hpp>
 using tcp = boost::asio::ip::tcp;  // from <boost/asio/ip/tcp.hpp>
 
-HttpSession::HttpSession(const Routes& routes, tcp::socket socket)
-    : routes_(routes), socket_(std::move(socket)), strand_(socket_.get_executor()) {
+HttpSession::HttpSession(const Routes& routes, WorkerPool& workers, tcp::socket socket)
+    : routes_(routes), workers_(workers), socket_(std::move(socket)), strand_(socket_.get_executor()) {
 }
 
 void HttpSession::DoRead() {
+  // the next requests are read once the responses catch up
+  if (reading_ || read_done_ || pending_.size() >= kMaxPipelinedRequests) {
+    return;
+  }
+  reading_ = true;
+
   req_.emplace();
 
   // TODO: make the max request size configable.
@@ -32,10 +38,15 @@ void HttpSession::DoRead() {
 
 void HttpSession::OnRead(beast::error_code ec, std::size_t bytes_transferred) {
   boost::ignore_unused(bytes_transferred);
+  reading_ = false;
 
   // This means they closed the connection
   if (ec == http::error::end_of_stream) {
-    return DoClose();
+    read_done_ = true;
+    if (pending_.empty()) {
+      DoClose();
+    }
+    return;
   }
 
   if (ec) {
@@ -43,12 +54,33 @@ void HttpSession::OnRead(beast::error_code ec, std::size_t bytes_transferred) {
     return;
   }
 
-  // Send the response
-  HandleRequest(req_->release());
+  // no request follows one without keep-alive
+  auto req = req_->release();
+  read_done_ = !req.keep_alive();
+
+  HandleRequest(std::move(req));
+  DoRead();
+}
+
+void HttpSession::DoWrite() {
+  if (writing_ || pending_.empty() || !pending_.front()->done) {
+    return;
+  }
+  writing_ = true;
+
+  // The pending request holds the response until it is written
+  auto self = shared_from_this();
+  auto& response = pending_.front()->context.response;
+  http::async_write(socket_, response,
+                    net::bind_executor(strand_,
+                                       [self, close = response.need_eof()](beast::error_code ec, std::size_t bytes) {
+                                         self->OnWrite(ec, bytes, close);
+                                       }));
 }
 
 void HttpSession::OnWrite(beast::error_code ec, std::size_t bytes_transferred, bool close) {
   boost::ignore_unused(bytes_transferred);
+  writing_ = false;
 
   if (ec) {
     ErrorHandling(ec, "write");
@@ -62,9 +94,13 @@ void HttpSession::OnWrite(beast::error_code ec, std::size_t bytes_transferred, b
   }
 
   // We're done with the response so delete it
-  res_ = nullptr;
+  pending_.pop_front();
+
+  if (read_done_ && pending_.empty()) {
+    return DoClose();
+  }
 
-  // Read another request
+  DoWrite();
   DoRead();
 }
 
@@ -76,40 +112,50 @@ void HttpSession::DoClose() {
   // At this point the connection is closed gracefully
 }
 
-template <class Msg>
-void HttpSession::Send(Msg&& msg) {
-  using item_type = std::remove_reference_t<decltype(msg)>;
+void HttpSession::HandleRequest(http::request<http::string_body>&& req) {
+  auto pending = std::make_shared<PendingRequest>();
+  pending_.push_back(pending);
 
-  auto ptr = std::make_shared<item_type>(std::move(msg));
-  auto self_ = shared_from_this();
-  self_->res_ = ptr;
-
-  http::async_write(self_->socket_, *ptr,
-                    net::bind_executor(strand_,
-                                       [self_, close = ptr->need_eof()](beast::error_code ec, std::size_t bytes) {
-                                         self_->OnWrite(ec, bytes, close);
-                                       }));
-}
-
-template <typename Body, typename Allocator>
-void HttpSession::HandleRequest(http::request<Body, http::basic_fields<Allocator> >&& req) {
-  HttpContext context{};
+  HttpContext& context = pending->context;
   context.request = std::move(req);
+  const bool keep_alive = context.request.keep_alive();
 
   // Special handle the liveness probe endpoint for orchestration systems like Kubernetes.
   if (context.request.method() == http::verb::get && context.request.target().to_string() == "/") {
     context.response.body() = "Healthy";
-  } else {
-    auto status = ExecuteUserFunction(context);
+    context.response.keep_alive(keep_alive);
+    context.response.prepare_payload();
+    pending->done = true;
+    return DoWrite();
+  }
+
+  // The request runs on a worker, then its response is written back on the strand of the session
+  auto self = shared_from_this();
+  const bool posted = workers_.TryPost([self, pending, keep_alive]() {
+    HttpContext& worker_context = pending->context;
+    auto status = self->ExecuteUserFunction(worker_context);
 
     if (status != http::status::ok) {
-      routes_.on_error(context);
+      self->routes_.on_error(worker_context);
     }
-  }
 
-  context.response.keep_alive(context.request.keep_alive());
-  context.response.prepare_payload();
-  return Send(std::move(context.response));
+    worker_context.response.keep_alive(keep_alive);
+    worker_context.response.prepare_payload();
+    net::post(self->strand_, [self, pending]() {
+      pending->done = true;
+      self->DoWrite();
+    });
+  });
+
+  if (!posted) {
+    context.error_code = http::status::too_many_requests;
+    context.error_message = "The server is handling too many requests, retry later";
+    routes_.on_error(context);
+    context.response.keep_alive(keep_alive);
+    context.response.prepare_payload();
+    pending->done = true;
+    DoWrite();
+  }
 }
 
 http::status HttpSession::ExecuteUserFunction(HttpContext& context) {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <boost/beast/version.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -13,6 +14,7 @@
 #include "context.h"
 #include "routes.h"
 #include "util.h"
+#include "worker_pool.h"
 
 namespace onnxruntime {
 namespace server {
@@ -24,9 +26,11 @@ namespace http = beast::http;
 
 // An implementation of a single HTTP session
 // Used by a listener to hand off the work and async write back to a socket
+// The requests of the connection are read ahead while the earlier ones run on the worker pool (HTTP pipelining),
+// and their responses are written back in the order of the requests.
 class HttpSession : public std::enable_shared_from_this<HttpSession> {
  public:
-  HttpSession(const Routes& routes, tcp::socket socket);
+  HttpSession(const Routes& routes, WorkerPool& workers, tcp::socket socket);
 
   // Start the asynchronous operation
   // The entrypoint for the class
@@ -35,39 +39,48 @@ class HttpSession : public std::enable_shared_from_this<HttpSession> {
   }
 
  private:
+  // A request read from the connection, and its response once handled
+  struct PendingRequest {
+    HttpContext context;
+    bool done = false;
+  };
+
+  // The number of requests of a connection that are read ahead of their responses
+  static constexpr size_t kMaxPipelinedRequests = 16;
+
   const Routes routes_;
+  WorkerPool& workers_;
   tcp::socket socket_;
   net::strand<net::io_context::executor_type> strand_;
   beast::flat_buffer buffer_;
   boost::optional<http::request_parser<http::string_body>> req_;
-  std::shared_ptr<void> res_{nullptr};
 
-  // Writes the message asynchronously back to the socket
-  // Stores the pointer to the message and the class itself so that
-  // They do not get destructed before the async process is finished
-  // If you pass shared_from_this() are guaranteed that the life time
-  // of your object will be extended to as long as the function needs it
-  // Most examples in boost::asio are based on this logic
-  template <class Msg>
-  void Send(Msg&& msg);
+  // The requests read, in order. Only accessed on the strand
+  std::deque<std::shared_ptr<PendingRequest>> pending_;
+  bool reading_ = false;
+  bool writing_ = false;
+  // Set once the client is done sending requests, the connection is closed after the pending responses
+  bool read_done_ = false;
 
   // Called after the session is finished reading the message
-  // Should set the response before calling Send
-  template <typename Body, typename Allocator>
-  void HandleRequest(http::request<Body, http::basic_fields<Allocator>>&& req);
+  // Runs the request on the worker pool, or answers 429 if the pool is full
+  void HandleRequest(http::request<http::string_body>&& req);
 
   // Handle the request and hand it off to the user's function
   // Execute user function, handle errors
   // HttpContext parameter can be updated here or in HandleRequest
   http::status ExecuteUserFunction(HttpContext& context);
 
-  // Asynchronously reads the request from the socket
+  // Asynchronously reads the request from the socket, unless too many requests are pending
   void DoRead();
 
   // Perform error checking before handing off to HandleRequest
   void OnRead(beast::error_code ec, std::size_t bytes_transferred);
 
-  // After writing, make the session read another request
+  // Writes the response of the first pending request once it is handled
+  void DoWrite();
+
+  // After writing, write the next response and read another request
   void OnWrite(beast::error_code ec, std::size_t bytes_transferred, bool close);
 
   // Close the connection
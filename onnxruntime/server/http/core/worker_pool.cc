@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "worker_pool.h"
+
+#include <boost/asio/post.hpp>
+
+namespace onnxruntime {
+namespace server {
+
+WorkerPool::WorkerPool(int num_threads, size_t max_queued) : max_queued_(max_queued) {
+  if (num_threads > 0) {
+    pool_ = std::make_unique<net::thread_pool>(num_threads);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  if (pool_) {
+    pool_->join();
+  }
+}
+
+bool WorkerPool::TryPost(std::function<void()> fn) {
+  if (queued_.fetch_add(1) >= max_queued_) {
+    --queued_;
+    return false;
+  }
+
+  if (!pool_) {
+    fn();
+    --queued_;
+    return true;
+  }
+
+  net::post(*pool_, [this, fn = std::move(fn)]() {
+    fn();
+    --queued_;
+  });
+  return true;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace onnxruntime {
+namespace server {
+
+namespace net = boost::asio;  // from <boost/asio.hpp>
+
+// The threads the requests are handled on, apart from the I/O threads reading and writing the connections,
+// so that a slow model doesn't hold up the other connections.
+// At most max_queued requests wait or run at a time: the server turns the others away rather than queuing them
+// without bound.
+class WorkerPool {
+ public:
+  // With 0 threads, the requests run on the thread posting them
+  WorkerPool(int num_threads, size_t max_queued);
+
+  // Waits for the requests posted
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Runs fn on a worker thread. Returns false without running it if max_queued requests are already queued or
+  // running.
+  bool TryPost(std::function<void()> fn);
+
+ private:
+  const size_t max_queued_;
+  std::atomic<size_t> queued_{0};
+  std::unique_ptr<net::thread_pool> pool_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -1,8 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <array>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 #include <boost/beast/core.hpp>
 #include <google/protobuf/util/json_util.h>
@@ -15,14 +17,156 @@ namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
 namespace server {
 
+namespace {
+// A base64 string of the raw data of an input in a JSON request
+struct RawDataString {
+  std::string input_name;
+  // range of the characters of the string, without the quotes
+  size_t begin;
+  size_t end;
+};
+}  // namespace
+
+// Returns the offset after the closing quote of the JSON string starting at json[pos], or npos if it isn't closed.
+// escaped is set if the string has escape sequences.
+static size_t SkipJsonString(const std::string& json, size_t pos, /* out */ bool& escaped) {
+  escaped = false;
+  for (++pos; pos < json.size(); ++pos) {
+    if (json[pos] == '\\') {
+      escaped = true;
+      ++pos;
+    } else if (json[pos] == '"') {
+      return pos + 1;
+    }
+  }
+  return std::string::npos;
+}
+
+// Finds the strings at "inputs" -> <input name> -> "rawData" (or "raw_data") of a JSON request.
+// The strings and names with escape sequences are left out, and left to the JSON parser.
+static std::vector<RawDataString> FindRawDataStrings(const std::string& json) {
+  std::vector<RawDataString> raw_data_strings;
+  // the last key read in each enclosing object, empty for arrays
+  std::vector<std::string> keys;
+  for (size_t pos = 0; pos < json.size();) {
+    const char c = json[pos];
+    if (c == '"') {
+      bool escaped;
+      const size_t end = SkipJsonString(json, pos, escaped);
+      if (end == std::string::npos) {
+        break;
+      }
+
+      const size_t next = json.find_first_not_of(" \t\r\n", end);
+      if (next != std::string::npos && json[next] == ':') {
+        if (!keys.empty()) {
+          keys.back() = escaped ? std::string() : json.substr(pos + 1, end - pos - 2);
+        }
+        pos = next + 1;
+        continue;
+      }
+
+      if (!escaped && keys.size() == 3 && keys[0] == "inputs" && !keys[1].empty() &&
+          (keys[2] == "rawData" || keys[2] == "raw_data")) {
+        raw_data_strings.push_back({keys[1], pos + 1, end - 1});
+      }
+      pos = end;
+      continue;
+    }
+
+    if (c == '{' || c == '[') {
+      keys.emplace_back();
+    } else if ((c == '}' || c == ']') && !keys.empty()) {
+      keys.pop_back();
+    }
+    ++pos;
+  }
+  return raw_data_strings;
+}
+
+// Decodes base64 in the standard or URL-safe alphabet, with or without padding, as the JSON parser does.
+// Returns false if data isn't valid base64.
+static bool DecodeBase64(const char* data, size_t size, /* out */ std::string& out) {
+  static const auto table = []() {
+    std::array<int8_t, 256> values;
+    values.fill(-1);
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (int8_t i = 0; i < 64; ++i) {
+      values[static_cast<unsigned char>(alphabet[i])] = i;
+    }
+    values['-'] = 62;
+    values['_'] = 63;
+    return values;
+  }();
+
+  while (size > 0 && data[size - 1] == '=') {
+    --size;
+  }
+  if (size % 4 == 1) {
+    return false;
+  }
+
+  out.resize(size / 4 * 3 + (size % 4 == 0 ? 0 : size % 4 - 1));
+  char* dst = &out[0];
+  uint32_t bits = 0;
+  int num_bits = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const int8_t value = table[static_cast<unsigned char>(data[i])];
+    if (value < 0) {
+      return false;
+    }
+    bits = ((bits << 6) | static_cast<uint32_t>(value)) & 0xFFFFFF;
+    num_bits += 6;
+    if (num_bits >= 8) {
+      num_bits -= 8;
+      *dst++ = static_cast<char>((bits >> num_bits) & 0xFF);
+    }
+  }
+  return true;
+}
+
 protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request) {
   protobufutil::JsonParseOptions options;
   options.ignore_unknown_fields = true;
 
+  // the JSON parser goes through several copies of the base64 strings, which make up most of a request with large
+  // tensors. parse the request without them, and decode them straight into the raw data of the tensors instead.
+  const auto raw_data_strings = FindRawDataStrings(json_string);
+  if (!raw_data_strings.empty()) {
+    std::string stripped_json;
+    size_t pos = 0;
+    for (const auto& raw_data : raw_data_strings) {
+      stripped_json.append(json_string, pos, raw_data.begin - pos);
+      pos = raw_data.end;
+    }
+    stripped_json.append(json_string, pos, std::string::npos);
+
+    bool decoded = JsonStringToMessage(stripped_json, &request, options).ok();
+    for (size_t i = 0; decoded && i < raw_data_strings.size(); ++i) {
+      const auto& raw_data = raw_data_strings[i];
+      auto& tensor = (*request.mutable_inputs())[raw_data.input_name];
+      decoded = DecodeBase64(json_string.data() + raw_data.begin, raw_data.end - raw_data.begin,
+                             *tensor.mutable_raw_data());
+    }
+    if (decoded) {
+      return protobufutil::Status::OK;
+    }
+
+    // parse the whole request again for the error message
+    request.Clear();
+  }
+
   protobufutil::Status result = JsonStringToMessage(json_string, &request, options);
   return result;
 }
 
+protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::RegisterSharedMemoryRequest& request) {
+  protobufutil::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+
+  return JsonStringToMessage(json_string, &request, options);
+}
+
 protobufutil::Status GenerateResponseInJson(const onnxruntime::server::PredictResponse& response, /* out */ std::string& json_string) {
   protobufutil::JsonPrintOptions options;
   options.add_whitespace = false;
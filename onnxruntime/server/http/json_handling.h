@@ -17,6 +17,10 @@ namespace http = boost::beast::http;
 // Unknown fields in the json file will be ignored.
 google::protobuf::util::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request);
 
+// Deserialize Json input to RegisterSharedMemoryRequest.
+// Unknown fields in the json file will be ignored.
+google::protobuf::util::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::RegisterSharedMemoryRequest& request);
+
 // Serialize PredictResponse to json string
 // 1. Proto3 primitive fields with default values will be omitted in JSON output. Eg. int32 field with value 0 will be omitted
 // 2. Enums will be printed as string, not int, to improve readability
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
@@ -28,6 +29,12 @@ namespace protobufutil = google::protobuf::util;
     (context).response.set(http::field::content_type, "application/json");                       \
   }
 
+// Gets the value of a header of the request, empty if it isn't set
+static std::string GetHeader(const HttpContext& context, const std::string& name) {
+  auto it = context.request.find(name);
+  return it != context.request.end() ? it->value().to_string() : std::string();
+}
+
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type,
                                 /* out */ PredictRequest& predictRequest, /* out */ http::status& error_code, /* out */ std::string& error_message);
 
@@ -50,9 +57,19 @@ void Predict(const std::string& name,
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
 
-  // Deserialize the payload
-  auto body = context.request.body();
-  PredictRequest predict_request{};
+  // the timeout of the request counts from here
+  RequestPriority priority;
+  RequestDeadline deadline;
+  auto schedule_status = ParseRequestSchedule(GetHeader(context, util::REQUEST_PRIORITY_METADATA),
+                                              GetHeader(context, util::REQUEST_TIMEOUT_METADATA), priority, deadline);
+  if (!schedule_status.ok()) {
+    GenerateErrorResponse(logger, http::status::bad_request, schedule_status.error_message(), context);
+    return;
+  }
+
+  // Deserialize the payload. the messages are allocated on an arena, freed at once with the request.
+  google::protobuf::Arena arena;
+  auto& predict_request = *google::protobuf::Arena::CreateMessage<PredictRequest>(&arena);
   http::status error_code;
   std::string error_message;
   bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
@@ -63,7 +80,8 @@ void Predict(const std::string& name,
 
   // Run Prediction
   Executor executor(env.get(), context.request_id);
-  PredictResponse predict_response{};
+  executor.SetSchedule(priority, deadline);
+  auto& predict_response = *google::protobuf::Arena::CreateMessage<PredictResponse>(&arena);
   auto status = executor.Predict(name, version, predict_request, predict_response);
   if (!status.ok()) {
     GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
@@ -93,12 +111,46 @@ void Predict(const std::string& name,
   if (!context.client_request_id.empty()) {
     context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
   }
-  context.response.body() = response_body;
+  context.response.body() = std::move(response_body);
   context.response.result(http::status::ok);
 };
 
+void SharedMemory(const std::string& name,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+  logger->info("Shared memory region: {}, Action: {}", name, action);
+
+  protobufutil::Status status;
+  if (action == "register") {
+    RegisterSharedMemoryRequest request;
+    status = GetRequestFromJson(context.request.body(), request);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+      return;
+    }
+    status = env->GetSharedMemory().Register(name, request.key(), request.offset(), request.byte_size());
+  } else {
+    status = env->GetSharedMemory().Unregister(name);
+  }
+
+  if (!status.ok()) {
+    GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+    return;
+  }
+
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.set(http::field::content_type, "application/json");
+  context.response.body() = "{}";
+  context.response.result(http::status::ok);
+}
+
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
-  auto body = context.request.body();
+  const auto& body = context.request.body();
   protobufutil::Status status;
   switch (request_type) {
     case SupportedContentType::Json: {
@@ -19,5 +19,12 @@ void Predict(const std::string& name,
              /* in, out */ HttpContext& context,
              const std::shared_ptr<ServerEnvironment>& env);
 
+// Registers (action "register") or unregisters (action "unregister") the shared memory region name.
+// The body of a registration is a JSON RegisterSharedMemoryRequest, e.g. {"key": "/frames", "byteSize": 1048576}.
+void SharedMemory(const std::string& name,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env);
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -23,8 +23,10 @@ boost::beast::http::status GetHttpStatusCode(const protobufutil::Status& status)
     case protobufutil::error::Code::OK:
       return boost::beast::http::status::ok;
 
-    case protobufutil::error::Code::UNKNOWN:
     case protobufutil::error::Code::DEADLINE_EXCEEDED:
+      return boost::beast::http::status::gateway_timeout;
+
+    case protobufutil::error::Code::UNKNOWN:
     case protobufutil::error::Code::RESOURCE_EXHAUSTED:
     case protobufutil::error::Code::ABORTED:
     case protobufutil::error::Code::UNIMPLEMENTED:
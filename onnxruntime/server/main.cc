@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/metrics.h"
 #include "environment.h"
 #include "http_server.h"
 #include "predict_request_handler.h"
@@ -60,14 +61,68 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}", config.model_path);
 
-  try {
-    env->InitializeModel(config.model_path);
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+  if (config.max_batch_size > 1) {
+    logger->info("Max batch size: {}, max queue delay: {}us", config.max_batch_size, config.max_queue_delay_us);
+    env->EnableBatching(config.max_batch_size, std::chrono::microseconds(config.max_queue_delay_us));
+  }
+
+  if (!config.sequence_states.empty()) {
+    logger->info("Sequence states: {}", config.sequence_states.size());
+    env->EnableSequences(config.sequence_states);
+  }
+
+  if (config.max_concurrent_runs > 0) {
+    logger->info("Max concurrent runs: {}", config.max_concurrent_runs);
+    env->EnableScheduling(static_cast<size_t>(config.max_concurrent_runs));
+  }
+
+  if (config.response_cache_mb > 0) {
+    logger->info("Response cache: {} MiB, ttl: {}s", config.response_cache_mb, config.response_cache_ttl_s);
+    env->EnableResponseCache(static_cast<size_t>(config.response_cache_mb) * 1024 * 1024,
+                             std::chrono::seconds(config.response_cache_ttl_s));
+  }
+
+  if (config.num_replicas > 1 || config.threads_per_replica > 0) {
+    logger->info("Replicas: {}, threads per replica: {}", config.num_replicas, config.threads_per_replica);
+    env->EnableReplicas(config.num_replicas, config.threads_per_replica);
+  }
+
+  if (config.cuda_device_id >= 0) {
+    logger->info("CUDA device: {}", config.cuda_device_id);
+    try {
+      env->EnableCuda(config.cuda_device_id);
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Enable CUDA Failed: {}", ex.what());
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (!config.model_path.empty()) {
+    logger->info("Model path: {}", config.model_path);
+    try {
+      env->InitializeModel(config.model_path);
+      logger->debug("Initialize Model Successfully!");
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
+  } else {
+    logger->info("Model repository: {}", config.repository_path);
+    if (config.model_memory_budget_mb > 0) {
+      logger->info("Model memory budget: {} MiB", config.model_memory_budget_mb);
+      env->EnableModelResidency(static_cast<size_t>(config.model_memory_budget_mb) * 1024 * 1024);
+    }
+    try {
+      env->InitializeModelRepository(config.repository_path);
+    } catch (const std::exception& ex) {
+      logger->critical("Initialize Model Repository Failed: {}", ex.what());
+      exit(EXIT_FAILURE);
+    }
+
+    if (config.repository_poll_interval_s > 0) {
+      env->StartModelRepositoryPolling(std::chrono::seconds(config.repository_poll_interval_s));
+    }
   }
 
   //Setup GRPC Server
@@ -109,8 +164,25 @@ int main(int argc, char* argv[]) {
         server::Predict(name, version, action, context, env);
       });
 
+  app.RegisterPost(
+      R"(/v1/shared_memory/([^/:]+):(register|unregister))",
+      [&env](const auto& name, const auto& action, const auto& /*unused*/, auto& context) -> void {
+        server::SharedMemory(name, action, context, env);
+      });
+
+  // the metrics of the server, then the ones of the runtime, in the Prometheus text format
+  app.RegisterGet(
+      R"(/metrics)",
+      [](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        context.response.result(http::status::ok);
+        context.response.set(http::field::content_type, "text/plain; version=0.0.4");
+        context.response.body() = onnxruntime::metrics::MetricsRegistry::Global().ToPrometheusText() + Ort::GetMetrics();
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
+      .NumWorkerThreads(config.num_http_workers)
+      .MaxQueuedRequests(static_cast<size_t>(config.max_queued_http_requests))
       .Run();
 
   grpc_app.Run();
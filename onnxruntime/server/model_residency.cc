@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_residency.h"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+namespace onnxruntime {
+namespace server {
+
+ModelResidency::ModelResidency(size_t max_bytes, Loader loader) : max_bytes_(max_bytes), loader_(std::move(loader)) {
+}
+
+void ModelResidency::Add(const std::string& model_path, std::shared_ptr<ServedModel> model) {
+  const size_t bytes = model != nullptr ? EstimateBytes(model_path) : 0;
+
+  std::vector<std::shared_ptr<ServedModel>> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.emplace(model_path, Entry{}).first;
+  if (model != nullptr && it->second.model == nullptr) {
+    SetLoaded(it, std::move(model), bytes);
+    evicted = Evict(&it->first);
+  }
+}
+
+void ModelResidency::Remove(const std::string& model_path) {
+  std::shared_ptr<ServedModel> model;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(model_path);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  if (it->second.model != nullptr) {
+    model = std::move(it->second.model);
+    loaded_bytes_ -= it->second.bytes;
+    lru_.erase(it->second.lru);
+  }
+  entries_.erase(it);
+}
+
+std::shared_ptr<ServedModel> ModelResidency::Get(const std::string& model_path) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(model_path);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+
+    ++it->second.requests;
+    if (it->second.model != nullptr) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return it->second.model;
+    }
+  }
+
+  return Load(model_path);
+}
+
+std::shared_ptr<ServedModel> ModelResidency::Load(const std::string& model_path) {
+  // the model of the entry if it's loaded, making it the most recently used. found is false if there is no entry.
+  auto find_loaded = [this, &model_path](std::shared_ptr<std::mutex>* load_mutex, bool& found) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(model_path);
+    found = it != entries_.end();
+    if (!found) {
+      return std::shared_ptr<ServedModel>();
+    }
+
+    if (it->second.model != nullptr) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+    } else if (load_mutex != nullptr) {
+      *load_mutex = it->second.load_mutex;
+    }
+    return it->second.model;
+  };
+
+  bool found = false;
+  std::shared_ptr<std::mutex> load_mutex;
+  auto model = find_loaded(&load_mutex, found);
+  if (!found || model != nullptr) {
+    return model;
+  }
+
+  // a concurrent request to the model may have loaded it while this one waited
+  std::lock_guard<std::mutex> load_lock(*load_mutex);
+  model = find_loaded(nullptr, found);
+  if (!found || model != nullptr) {
+    return model;
+  }
+
+  // load out of mutex_, the requests of the loaded models don't wait for it
+  model = loader_(model_path);
+  const size_t bytes = EstimateBytes(model_path);
+
+  // the evicted models are destroyed after mutex_ is released
+  std::vector<std::shared_ptr<ServedModel>> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(model_path);
+  if (it != entries_.end() && it->second.model == nullptr) {
+    SetLoaded(it, model, bytes);
+    evicted = Evict(&it->first);
+  }
+  return model;
+}
+
+void ModelResidency::Prefetch(size_t min_requests) {
+  std::vector<std::pair<size_t, std::string>> candidates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+      if (entry.second.model == nullptr && entry.second.requests >= min_requests) {
+        candidates.emplace_back(entry.second.requests, entry.first);
+      }
+      entry.second.requests /= 2;
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<size_t, std::string>& a, const std::pair<size_t, std::string>& b) {
+              return a.first > b.first;
+            });
+
+  for (const auto& candidate : candidates) {
+    const size_t bytes = EstimateBytes(candidate.second);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (max_bytes_ > 0 && loaded_bytes_ + bytes > max_bytes_) {
+        continue;
+      }
+    }
+
+    try {
+      Load(candidate.second);
+    } catch (const Ort::Exception&) {
+      // the next request to the model loads it again and reports the failure
+    }
+  }
+}
+
+bool ModelResidency::IsLoaded(const std::string& model_path) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(model_path);
+  return it != entries_.end() && it->second.model != nullptr;
+}
+
+size_t ModelResidency::GetLoadedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return loaded_bytes_;
+}
+
+void ModelResidency::SetLoaded(std::unordered_map<std::string, Entry>::iterator it,
+                               std::shared_ptr<ServedModel> model, size_t bytes) {
+  it->second.model = std::move(model);
+  it->second.bytes = bytes;
+  lru_.push_front(&it->first);
+  it->second.lru = lru_.begin();
+  loaded_bytes_ += bytes;
+}
+
+std::vector<std::shared_ptr<ServedModel>> ModelResidency::Evict(const std::string* keep) {
+  std::vector<std::shared_ptr<ServedModel>> evicted;
+  if (max_bytes_ == 0) {
+    return evicted;
+  }
+
+  for (auto lru = lru_.end(); loaded_bytes_ > max_bytes_ && lru != lru_.begin();) {
+    --lru;
+    if (*lru == keep) {
+      continue;
+    }
+
+    auto& entry = entries_.at(**lru);
+    evicted.push_back(std::move(entry.model));
+    entry.model = nullptr;
+    loaded_bytes_ -= entry.bytes;
+    lru = lru_.erase(lru);
+  }
+  return evicted;
+}
+
+size_t ModelResidency::EstimateBytes(const std::string& model_path) {
+  std::ifstream file(model_path, std::ios::binary | std::ios::ate);
+  const auto size = file.tellg();
+  return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
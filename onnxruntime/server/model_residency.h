@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "served_model.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The models of a repository that are loaded, by model path, within a memory budget so that a server can host many
+// more models than it keeps loaded. A model is loaded on its first request, and once the loaded models take more
+// than max_bytes the least recently used ones are unloaded: the requests still running them hold them until they
+// are done, and the memory of their sessions is freed then. The memory of a model is estimated from the size of its
+// file, which its weights dominate. A max_bytes of 0 keeps every model loaded.
+class ModelResidency {
+ public:
+  // Loads a model. Throws Ort::Exception on failure.
+  using Loader = std::function<std::shared_ptr<ServedModel>(const std::string& model_path)>;
+
+  ModelResidency(size_t max_bytes, Loader loader);
+  ModelResidency(const ModelResidency&) = delete;
+  ModelResidency& operator=(const ModelResidency&) = delete;
+
+  // Serves the model at model_path, already loaded if model isn't nullptr, and otherwise loaded on its first request.
+  void Add(const std::string& model_path, std::shared_ptr<ServedModel> model = nullptr);
+
+  // Stops serving the model at model_path, which is unloaded once the requests running it are done.
+  void Remove(const std::string& model_path);
+
+  // Gets the model at model_path, loading it in the calling thread if it isn't loaded. The requests of other models
+  // don't wait for the load. nullptr if the model isn't served. Throws Ort::Exception if it can't be loaded.
+  std::shared_ptr<ServedModel> Get(const std::string& model_path);
+
+  // Loads the unloaded models requested at least min_requests times since the previous call, the most requested
+  // first, as long as they fit in the budget without unloading others, and halves the request counts so that they
+  // follow the recent traffic. To be called periodically, e.g. when the repository is polled.
+  void Prefetch(size_t min_requests = 1);
+
+  bool IsLoaded(const std::string& model_path) const;
+
+  // the estimated memory of the loaded models
+  size_t GetLoadedBytes() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<ServedModel> model;
+    size_t bytes = 0;
+    size_t requests = 0;
+    // held while the model loads, so the concurrent requests to it wait for the one load
+    std::shared_ptr<std::mutex> load_mutex = std::make_shared<std::mutex>();
+    // the position of the path in lru_, while the model is loaded
+    std::list<const std::string*>::iterator lru;
+  };
+
+  // Loads the model of the entry at model_path. The returned model is loaded even if the entry was removed meanwhile.
+  std::shared_ptr<ServedModel> Load(const std::string& model_path);
+
+  // Makes the model of it loaded and the most recently used. Requires mutex_.
+  void SetLoaded(std::unordered_map<std::string, Entry>::iterator it, std::shared_ptr<ServedModel> model,
+                 size_t bytes);
+
+  // Unloads the least recently used models other than keep until the loaded ones fit in the budget, returning them
+  // to be destroyed outside of mutex_. Requires mutex_.
+  std::vector<std::shared_ptr<ServedModel>> Evict(const std::string* keep);
+
+  static size_t EstimateBytes(const std::string& model_path);
+
+  const size_t max_bytes_;
+  const Loader loader_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // the paths of the loaded models, the most recently used first
+  std::list<const std::string*> lru_;
+  size_t loaded_bytes_ = 0;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
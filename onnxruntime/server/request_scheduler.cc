@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "request_scheduler.h"
+
+#include <stdexcept>
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+protobufutil::Status ParseRequestSchedule(const std::string& priority, const std::string& timeout_ms,
+                                          /* out */ RequestPriority& request_priority,
+                                          /* out */ RequestDeadline& request_deadline) {
+  if (priority.empty() || priority == "normal") {
+    request_priority = RequestPriority::Normal;
+  } else if (priority == "high") {
+    request_priority = RequestPriority::High;
+  } else if (priority == "low") {
+    request_priority = RequestPriority::Low;
+  } else {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "The request priority must be one of high, normal or low, not " + priority);
+  }
+
+  request_deadline = kNoDeadline;
+  if (!timeout_ms.empty()) {
+    int64_t timeout = -1;
+    size_t end = 0;
+    try {
+      timeout = std::stoll(timeout_ms, &end);
+    } catch (const std::logic_error&) {
+    }
+    if (timeout < 0 || end != timeout_ms.size()) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "The request timeout must be a number of milliseconds, not " + timeout_ms);
+    }
+    request_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  }
+
+  return protobufutil::Status::OK;
+}
+
+RequestScheduler::RequestScheduler(size_t max_concurrent_runs)
+    : max_concurrent_runs_(max_concurrent_runs), watch_thread_(&RequestScheduler::Watch, this) {
+}
+
+RequestScheduler::~RequestScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  watched_changed_.notify_all();
+  watch_thread_.join();
+}
+
+RequestScheduler::Admission::~Admission() {
+  scheduler_.Release(watched_);
+}
+
+protobufutil::Status RequestScheduler::Admit(RequestPriority priority, RequestDeadline deadline,
+                                             Ort::RunOptions* options,
+                                             /* out */ std::unique_ptr<Admission>& admission) {
+  static const protobufutil::Status deadline_exceeded(protobufutil::error::Code::DEADLINE_EXCEEDED,
+                                                      "The deadline of the request passed before it could run");
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (std::chrono::steady_clock::now() >= deadline) {
+    return deadline_exceeded;
+  }
+
+  if (max_concurrent_runs_ > 0) {
+    const Waiter waiter{priority, deadline, next_arrival_++};
+    waiters_.insert(waiter);
+    auto can_run = [&]() { return running_ < max_concurrent_runs_ && *waiters_.begin() == waiter; };
+    bool admitted = true;
+    if (deadline == kNoDeadline) {
+      admission_changed_.wait(lock, can_run);
+    } else {
+      admitted = admission_changed_.wait_until(lock, deadline, can_run);
+    }
+    waiters_.erase(waiter);
+
+    if (!admitted) {
+      // the next waiter may be able to run in its place
+      admission_changed_.notify_all();
+      return deadline_exceeded;
+    }
+    ++running_;
+    // let the next waiter check whether a slot is left for it
+    admission_changed_.notify_all();
+  }
+
+  auto watched = watched_.end();
+  if (deadline != kNoDeadline && options != nullptr) {
+    watched = watched_.emplace(deadline, options);
+    watched_changed_.notify_all();
+  }
+
+  admission.reset(new Admission(*this, watched));
+  return protobufutil::Status::OK;
+}
+
+void RequestScheduler::Release(std::multimap<RequestDeadline, Ort::RunOptions*>::iterator watched) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (watched != watched_.end()) {
+    watched_.erase(watched);
+  }
+  if (max_concurrent_runs_ > 0) {
+    --running_;
+    admission_changed_.notify_all();
+  }
+}
+
+void RequestScheduler::Watch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (watched_.empty()) {
+      watched_changed_.wait(lock);
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    // the runs stay watched until released, so each one is only terminated once
+    auto first_pending = watched_.begin();
+    while (first_pending != watched_.end() && first_pending->first <= now) {
+      if (first_pending->second != nullptr) {
+        first_pending->second->SetTerminate();
+        first_pending->second = nullptr;
+      }
+      ++first_pending;
+    }
+
+    if (first_pending == watched_.end()) {
+      watched_changed_.wait(lock);
+    } else {
+      watched_changed_.wait_until(lock, first_pending->first);
+    }
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
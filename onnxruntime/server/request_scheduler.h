@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The priority class of a request, from the x-ms-request-priority metadata
+enum class RequestPriority {
+  High = 0,
+  Normal = 1,
+  Low = 2,
+};
+
+using RequestDeadline = std::chrono::steady_clock::time_point;
+
+// No deadline
+constexpr RequestDeadline kNoDeadline = RequestDeadline::max();
+
+// Parses the x-ms-request-priority ("high", "normal" or "low") and x-ms-request-timeout-ms (milliseconds from now)
+// metadata of a request, an empty value keeping the default. Fails with INVALID_ARGUMENT on a bad value.
+google::protobuf::util::Status ParseRequestSchedule(const std::string& priority, const std::string& timeout_ms,
+                                                    /* out */ RequestPriority& request_priority,
+                                                    /* out */ RequestDeadline& request_deadline);
+
+// Picks the order the requests run in once more than max_concurrent_runs of them are ready: the higher priority
+// first, then the earlier deadline, then the earlier request. A request whose deadline passes before it gets to
+// run is dropped, and one whose deadline passes while it runs is terminated through RunOptions::SetTerminate.
+// A max_concurrent_runs of 0 doesn't limit the runs, the deadlines still being enforced.
+class RequestScheduler {
+ public:
+  explicit RequestScheduler(size_t max_concurrent_runs);
+  ~RequestScheduler();
+  RequestScheduler(const RequestScheduler&) = delete;
+  RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+  // The run of an admitted request, which holds its slot until destroyed
+  class Admission {
+   public:
+    ~Admission();
+    Admission(const Admission&) = delete;
+    Admission& operator=(const Admission&) = delete;
+
+   private:
+    friend class RequestScheduler;
+    Admission(RequestScheduler& scheduler, std::multimap<RequestDeadline, Ort::RunOptions*>::iterator watched)
+        : scheduler_(scheduler), watched_(watched) {}
+
+    RequestScheduler& scheduler_;
+    // the entry of the run in the watched runs
+    std::multimap<RequestDeadline, Ort::RunOptions*>::iterator watched_;
+  };
+
+  // Waits for the request to be let run. options must outlive the admission, its terminate flag being set once
+  // deadline passes; with nullptr options, the run isn't terminated. Fails with DEADLINE_EXCEEDED if the deadline
+  // passes before the request gets to run.
+  google::protobuf::util::Status Admit(RequestPriority priority, RequestDeadline deadline, Ort::RunOptions* options,
+                                       /* out */ std::unique_ptr<Admission>& admission);
+
+  size_t GetMaxConcurrentRuns() const { return max_concurrent_runs_; }
+
+ private:
+  // (priority, deadline, arrival) of a waiting request, the first one running next
+  using Waiter = std::tuple<RequestPriority, RequestDeadline, uint64_t>;
+
+  void Release(std::multimap<RequestDeadline, Ort::RunOptions*>::iterator watched);
+
+  // Terminates the runs past their deadline
+  void Watch();
+
+  const size_t max_concurrent_runs_;
+
+  std::mutex mutex_;
+  std::condition_variable admission_changed_;
+  std::set<Waiter> waiters_;
+  uint64_t next_arrival_ = 0;
+  size_t running_ = 0;
+
+  // the running requests with a deadline
+  std::multimap<RequestDeadline, Ort::RunOptions*> watched_;
+  std::condition_variable watched_changed_;
+  bool stop_ = false;
+  std::thread watch_thread_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "response_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace onnxruntime {
+namespace server {
+
+ResponseCache::ResponseCache(size_t max_bytes, std::chrono::milliseconds ttl) : max_bytes_(max_bytes), ttl_(ttl) {
+}
+
+bool ResponseCache::GetKey(const std::string& model_path, const onnxruntime::server::PredictRequest& request,
+                           /* out */ std::string& key) {
+  if (!request.shared_memory_inputs().empty() || !request.shared_memory_outputs().empty()) {
+    return false;
+  }
+
+  // the map of the inputs has no order, so they are added by name. the names and tensors are length-prefixed,
+  // so that different requests can't make up the same key.
+  auto append = [&key](const std::string& value) {
+    const uint64_t size = value.size();
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(value);
+  };
+
+  key.clear();
+  append(model_path);
+
+  std::vector<const std::string*> input_names;
+  input_names.reserve(request.inputs().size());
+  for (const auto& input : request.inputs()) {
+    input_names.push_back(&input.first);
+  }
+  std::sort(input_names.begin(), input_names.end(),
+            [](const std::string* a, const std::string* b) { return *a < *b; });
+
+  std::string tensor;
+  for (const auto* name : input_names) {
+    append(*name);
+    request.inputs().at(*name).SerializeToString(&tensor);
+    append(tensor);
+  }
+
+  for (const auto& output : request.output_filter()) {
+    append(output);
+  }
+  return true;
+}
+
+bool ResponseCache::Get(const std::string& key, /* out */ onnxruntime::server::PredictResponse& response) {
+  std::shared_ptr<const onnxruntime::server::PredictResponse> cached;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+
+    if (ttl_.count() > 0 && std::chrono::steady_clock::now() >= it->second.expiry) {
+      Erase(it);
+      return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    cached = it->second.response;
+  }
+
+  // copy out of the lock, the cached response can't change
+  response.CopyFrom(*cached);
+  return true;
+}
+
+void ResponseCache::Put(const std::string& key, const onnxruntime::server::PredictResponse& response) {
+  const size_t bytes = key.size() + response.ByteSizeLong();
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  auto cached = std::make_shared<onnxruntime::server::PredictResponse>(response);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    Erase(it);
+  }
+
+  while (bytes_ + bytes > max_bytes_) {
+    Erase(entries_.find(*lru_.back()));
+  }
+
+  it = entries_.emplace(key, Entry{std::move(cached), bytes, std::chrono::steady_clock::now() + ttl_, {}}).first;
+  lru_.push_front(&it->first);
+  it->second.lru = lru_.begin();
+  bytes_ += bytes;
+}
+
+size_t ResponseCache::GetSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void ResponseCache::Erase(std::unordered_map<std::string, Entry>::iterator it) {
+  bytes_ -= it->second.bytes;
+  lru_.erase(it->second.lru);
+  entries_.erase(it);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
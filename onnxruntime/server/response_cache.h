@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The responses of the recent requests, by model version and inputs, so that a repeated request to a deterministic
+// model is answered without running it. The least recently used responses are evicted once the keys and responses
+// take more than max_bytes, and the responses expire ttl after they were added. A ttl of 0 doesn't expire them.
+class ResponseCache {
+ public:
+  ResponseCache(size_t max_bytes, std::chrono::milliseconds ttl);
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Gets the key of a request to the model at model_path, which holds its inputs and output filter.
+  // Returns false if the request can't be cached: its shared memory tensors aren't part of the request.
+  static bool GetKey(const std::string& model_path, const onnxruntime::server::PredictRequest& request,
+                     /* out */ std::string& key);
+
+  // Copies the cached response of key into response. Returns false if there is none.
+  bool Get(const std::string& key, /* out */ onnxruntime::server::PredictResponse& response);
+
+  // Caches the response of key, unless it is larger than the cache
+  void Put(const std::string& key, const onnxruntime::server::PredictResponse& response);
+
+  size_t GetSize() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const onnxruntime::server::PredictResponse> response;
+    size_t bytes;
+    std::chrono::steady_clock::time_point expiry;
+    // the position of the key in lru_
+    std::list<const std::string*>::iterator lru;
+  };
+
+  void Erase(std::unordered_map<std::string, Entry>::iterator it);
+
+  const size_t max_bytes_;
+  const std::chrono::milliseconds ttl_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // the keys of entries_, the most recently used first
+  std::list<const std::string*> lru_;
+  size_t bytes_ = 0;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
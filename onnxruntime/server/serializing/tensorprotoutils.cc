@@ -424,6 +424,40 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+bool TryTensorProtoRawDataToMLValue(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info,
+                                    /* out */ Ort::Value& value) {
+  ONNXTensorElementDataType ele_type = server::GetTensorElementType(tensor_proto);
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() || ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  size_t tensor_size = 1;
+  for (auto dim : tensor_shape_vec) {
+    if (dim < 0) throw Ort::Exception("Tensor can't contain negative dims", OrtErrorCode::ORT_FAIL);
+    tensor_size *= static_cast<size_t>(dim);
+  }
+
+  size_t size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes);
+  const auto& raw_data = tensor_proto.raw_data();
+  if (tensor_size == 0 || raw_data.size() != size_in_bytes) {
+    // let TensorProtoToMLValue report the mismatch
+    return false;
+  }
+
+  // the kernels may read the elements with aligned loads
+  const size_t element_size = size_in_bytes / tensor_size;
+  if (reinterpret_cast<uintptr_t>(raw_data.data()) % element_size != 0) {
+    return false;
+  }
+
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(), ele_type);
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
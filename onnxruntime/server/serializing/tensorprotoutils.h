@@ -27,6 +27,14 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Creates a value pointing directly into the raw_data of the TensorProto, which must outlive the value,
+ * instead of copying it into a buffer like TensorProtoToMLValue.
+ * Returns false if the TensorProto has no raw data, or it can't be used as is (big endian machine, misaligned data).
+ */
+bool TryTensorProtoRawDataToMLValue(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info,
+                                    /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
@@ -0,0 +1,322 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+
+#include "served_model.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+// the index of name in names, names.size() if it isn't there
+size_t IndexOf(const std::vector<std::string>& names, const std::string& name) {
+  return static_cast<size_t>(std::find(names.begin(), names.end(), name) - names.begin());
+}
+}  // namespace
+
+ServedModel::ServedModel(Ort::Env& env, const std::string& model_path, const Ort::SessionOptions& session_options,
+                         size_t max_batch_size, std::chrono::microseconds max_queue_delay,
+                         const SequenceStates& sequence_states)
+    : model_path_(model_path),
+      session_(env, model_path.c_str(), session_options),
+      sequence_states_(sequence_states) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0, input_count = session_.GetInputCount(); i < input_count; i++) {
+    auto name = session_.GetInputName(i, allocator);
+    input_names_.push_back(name);
+    allocator.Free(name);
+  }
+  for (size_t i = 0, output_count = session_.GetOutputCount(); i < output_count; i++) {
+    auto name = session_.GetOutputName(i, allocator);
+    output_names_.push_back(name);
+    allocator.Free(name);
+  }
+
+  for (const auto& state : sequence_states_) {
+    if (IndexOf(input_names_, state.first) == input_names_.size() ||
+        IndexOf(output_names_, state.second) == output_names_.size()) {
+      throw Ort::Exception("The sequence state " + state.first + ":" + state.second +
+                               " isn't an input and an output of the model",
+                           ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  if (max_batch_size > 1) {
+    batcher_ = std::make_unique<Batcher>(session_, max_batch_size, max_queue_delay);
+  }
+}
+
+void ServedModel::WarmUp() {
+  Ort::AllocatorWithDefaultOptions allocator;
+
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  for (size_t i = 0, input_count = session_.GetInputCount(); i < input_count; i++) {
+    auto type_info = session_.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+      return;
+    }
+
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    auto type = tensor_info.GetElementType();
+    const size_t element_size = GetTensorElementSize(type);
+    if (element_size == 0) {
+      return;
+    }
+
+    auto shape = tensor_info.GetShape();
+    for (auto& dim : shape) {
+      if (dim < 0) {
+        dim = 1;
+      }
+    }
+
+    auto name = session_.GetInputName(i, allocator);
+    input_names.push_back(name);
+    allocator.Free(name);
+
+    input_values.push_back(Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type));
+    auto& value = input_values.back();
+    std::memset(value.GetTensorMutableData<void>(), 0,
+                value.GetTensorTypeAndShapeInfo().GetElementCount() * element_size);
+  }
+
+  // bypass the batcher, there is nothing to batch the warm-up run with
+  std::vector<const char*> input_ptrs;
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+  std::vector<const char*> output_ptrs;
+  for (const auto& output : output_names_) {
+    output_ptrs.push_back(output.data());
+  }
+
+  session_.Run(Ort::RunOptions{}, input_ptrs.data(), input_values.data(), input_values.size(),
+               output_ptrs.data(), output_ptrs.size());
+}
+
+std::vector<Ort::Value> ServedModel::Run(const Ort::RunOptions& options,
+                                         const std::vector<std::string>& input_names,
+                                         std::vector<Ort::Value>& input_values,
+                                         const std::vector<std::string>& output_names) {
+  if (IsStepModel()) {
+    return RunSequence(options, input_names, input_values, output_names);
+  }
+
+  if (batcher_ != nullptr) {
+    return batcher_->Run(options, input_names, input_values, output_names);
+  }
+
+  return RunSession(session_, options, input_names, input_values, output_names);
+}
+
+std::vector<Ort::Value> ServedModel::Run(const Ort::RunOptions& options,
+                                         const std::vector<std::string>& input_names,
+                                         std::vector<Ort::Value>& input_values,
+                                         const std::vector<std::string>& output_names,
+                                         OrtOutputAllocatorFn output_allocator, void* user_data) {
+  if (IsStepModel()) {
+    throw Ort::Exception("The outputs of a step model can't be written into shared memory", ORT_INVALID_ARGUMENT);
+  }
+
+  std::vector<const char*> input_ptrs;
+  input_ptrs.reserve(input_names.size());
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+
+  std::vector<const char*> output_ptrs;
+  output_ptrs.reserve(output_names.size());
+  for (const auto& output : output_names) {
+    output_ptrs.push_back(output.data());
+  }
+
+  std::vector<Ort::Value> output_values;
+  output_values.reserve(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    output_values.emplace_back(nullptr);
+  }
+
+  session_.Run(options, input_ptrs.data(), input_values.data(), input_values.size(), output_ptrs.data(),
+               output_values.data(), output_values.size(), output_allocator, user_data);
+  return output_values;
+}
+
+std::vector<Ort::Value> ServedModel::RunSequence(const Ort::RunOptions& options,
+                                                 const std::vector<std::string>& input_names,
+                                                 std::vector<Ort::Value>& input_values,
+                                                 const std::vector<std::string>& output_names) {
+  auto state_of = [this](const std::string& name, bool output) {
+    return static_cast<size_t>(std::find_if(sequence_states_.begin(), sequence_states_.end(),
+                                            [&name, output](const std::pair<std::string, std::string>& state) {
+                                              return (output ? state.second : state.first) == name;
+                                            }) -
+                               sequence_states_.begin());
+  };
+
+  // the steps are fed as views of the request tensors, which aren't copied
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  struct View {
+    char* data;
+    size_t bytes;
+    std::vector<int64_t> shape;
+    ONNXTensorElementDataType type;
+
+    Ort::Value Create(const OrtMemoryInfo* info, size_t offset) const {
+      return Ort::Value::CreateTensor(info, data + offset, bytes, shape.data(), shape.size(), type);
+    }
+  };
+  auto get_view = [](const std::string& name, Ort::Value& value, View& view) {
+    if (!value.IsTensor()) {
+      throw Ort::Exception("The sequence input " + name + " must be a tensor", ORT_INVALID_ARGUMENT);
+    }
+
+    auto info = value.GetTensorTypeAndShapeInfo();
+    view.type = info.GetElementType();
+    view.shape = info.GetShape();
+    view.bytes = info.GetElementCount() * GetTensorElementSize(view.type);
+    view.data = value.GetTensorMutableData<char>();
+    if (GetTensorElementSize(view.type) == 0) {
+      throw Ort::Exception("The sequence input " + name + " must be a numeric tensor", ORT_INVALID_ARGUMENT);
+    }
+  };
+
+  // the inputs holding the steps, then the states
+  std::vector<std::string> step_input_names;
+  std::vector<View> step_views;
+  int64_t num_steps = -1;
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    if (state_of(input_names[i], false) < sequence_states_.size()) {
+      continue;
+    }
+
+    View view;
+    get_view(input_names[i], input_values[i], view);
+    if (view.shape.empty() || (num_steps >= 0 && view.shape[0] != num_steps)) {
+      throw Ort::Exception("The sequence inputs must have the same first dimension, the number of steps",
+                           ORT_INVALID_ARGUMENT);
+    }
+
+    num_steps = view.shape[0];
+    view.shape.erase(view.shape.begin());
+    view.bytes = num_steps > 0 ? view.bytes / static_cast<size_t>(num_steps) : 0;
+    step_input_names.push_back(input_names[i]);
+    step_views.push_back(std::move(view));
+  }
+  if (num_steps <= 0) {
+    throw Ort::Exception("A sequence needs at least one step, held by the inputs other than the states",
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  const int64_t num_rows = step_views.front().shape.empty() ? 1 : step_views.front().shape[0];
+  std::vector<Ort::Value> states;
+  for (const auto& state : sequence_states_) {
+    step_input_names.push_back(state.first);
+    const size_t index = IndexOf(input_names, state.first);
+    if (index == input_names.size()) {
+      states.push_back(CreateInitialState(IndexOf(input_names_, state.first), num_rows));
+    } else {
+      View view;
+      get_view(state.first, input_values[index], view);
+      states.push_back(view.Create(memory_info, 0));
+    }
+  }
+
+  // the outputs gathered from the steps, then the states
+  std::vector<std::string> step_output_names;
+  for (const auto& name : output_names) {
+    if (state_of(name, true) == sequence_states_.size()) {
+      step_output_names.push_back(name);
+    }
+  }
+  const size_t num_gathered_outputs = step_output_names.size();
+  for (const auto& state : sequence_states_) {
+    step_output_names.push_back(state.second);
+  }
+
+  Batcher::SequenceScope sequence(batcher_.get());
+
+  std::vector<Ort::Value> gathered_outputs;
+  std::vector<std::vector<int64_t>> step_output_shapes;
+  for (int64_t step = 0; step < num_steps; ++step) {
+    std::vector<Ort::Value> step_inputs;
+    step_inputs.reserve(step_input_names.size());
+    for (const auto& view : step_views) {
+      step_inputs.push_back(view.Create(memory_info, static_cast<size_t>(step) * view.bytes));
+    }
+    for (auto& state : states) {
+      step_inputs.push_back(std::move(state));
+    }
+
+    auto step_outputs = batcher_ != nullptr
+                            ? batcher_->Run(options, step_input_names, step_inputs, step_output_names, true)
+                            : RunSession(session_, options, step_input_names, step_inputs, step_output_names);
+
+    for (size_t i = 0; i < num_gathered_outputs; ++i) {
+      auto& output = step_outputs[i];
+      auto info = output.GetTensorTypeAndShapeInfo();
+      auto type = info.GetElementType();
+      auto shape = info.GetShape();
+      const size_t bytes = info.GetElementCount() * GetTensorElementSize(type);
+      if (step == 0) {
+        if (GetTensorElementSize(type) == 0) {
+          throw Ort::Exception("The output " + step_output_names[i] + " of a step model must be a numeric tensor",
+                               ORT_INVALID_ARGUMENT);
+        }
+
+        step_output_shapes.push_back(shape);
+        shape.insert(shape.begin(), num_steps);
+        gathered_outputs.push_back(Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type));
+      } else if (shape != step_output_shapes[i]) {
+        throw Ort::Exception("The shape of the output " + step_output_names[i] + " changed across the steps",
+                             ORT_FAIL);
+      }
+
+      std::memcpy(gathered_outputs[i].GetTensorMutableData<char>() + static_cast<size_t>(step) * bytes,
+                  output.GetTensorMutableData<char>(), bytes);
+    }
+
+    states.clear();
+    for (size_t i = num_gathered_outputs; i < step_outputs.size(); ++i) {
+      states.push_back(std::move(step_outputs[i]));
+    }
+  }
+
+  std::vector<Ort::Value> outputs;
+  outputs.reserve(output_names.size());
+  size_t next_gathered_output = 0;
+  for (const auto& name : output_names) {
+    const size_t state = state_of(name, true);
+    outputs.push_back(state < sequence_states_.size() ? std::move(states[state])
+                                                      : std::move(gathered_outputs[next_gathered_output++]));
+  }
+  return outputs;
+}
+
+Ort::Value ServedModel::CreateInitialState(size_t input_index, int64_t num_rows) {
+  auto type_info = session_.GetInputTypeInfo(input_index);
+  auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+  auto type = tensor_info.GetElementType();
+  auto shape = tensor_info.GetShape();
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] < 0 && i > 0) {
+      throw Ort::Exception("The state input " + input_names_[input_index] +
+                               " has a symbolic dimension besides the first, so it can't be left out of a request",
+                           ORT_INVALID_ARGUMENT);
+    }
+    if (shape[i] < 0) {
+      shape[i] = num_rows;
+    }
+  }
+
+  auto value = Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type);
+  std::memset(value.GetTensorMutableData<void>(), 0,
+              value.GetTensorTypeAndShapeInfo().GetElementCount() * GetTensorElementSize(type));
+  return value;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
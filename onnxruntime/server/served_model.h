@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The pairs of model input and output names of the states a step model carries from a step to the next
+using SequenceStates = std::vector<std::pair<std::string, std::string>>;
+
+// A loaded model. Requests hold a shared_ptr to it while they run, so a model that is replaced or unloaded
+// is only destroyed once the requests still running it are done.
+//
+// A model with sequence states is a step model, the cell of a recurrent network, which a request runs over a whole
+// sequence: see Run.
+class ServedModel {
+ public:
+  // Loads the model. Throws Ort::Exception on failure, or if a name of sequence_states isn't one of the model.
+  // A max_batch_size of 1 disables batching.
+  ServedModel(Ort::Env& env, const std::string& model_path, const Ort::SessionOptions& session_options,
+              size_t max_batch_size, std::chrono::microseconds max_queue_delay,
+              const SequenceStates& sequence_states = {});
+  ServedModel(const ServedModel&) = delete;
+  ServedModel& operator=(const ServedModel&) = delete;
+
+  // Runs the model once with zero-filled inputs, symbolic dimensions set to 1, so the first request doesn't pay
+  // for the lazy initialization of the session. Does nothing if an input isn't a numeric tensor.
+  // Throws Ort::Exception if the run failed.
+  void WarmUp();
+
+  // Same as Ort::Session::Run, through the batcher if batching is enabled.
+  //
+  // For a step model, the inputs other than the states hold the sequence, a step per index of their first
+  // dimension, and the model is run once per step, the state outputs of a step being the state inputs of the next.
+  // The state inputs left out start zero-filled. The outputs other than the states hold the output of each step
+  // along their first dimension, and the state outputs are the ones of the last step. The steps of the concurrent
+  // requests are batched together, see Batcher.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& options,
+                              const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names);
+
+  // Same as Ort::Session::Run with an output allocator, see OrtRunWithOutputAllocator. Bypasses the batcher, which
+  // would allocate the outputs of the whole batch. Throws Ort::Exception for a step model, whose outputs are
+  // gathered from its steps.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& options,
+                              const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names,
+                              OrtOutputAllocatorFn output_allocator, void* user_data);
+
+  const std::string& GetModelPath() const { return model_path_; }
+  const std::vector<std::string>& GetOutputNames() const { return output_names_; }
+  // nullptr if batching isn't enabled
+  Batcher* GetBatcher() const { return batcher_.get(); }
+  bool IsStepModel() const { return !sequence_states_.empty(); }
+
+ private:
+  std::vector<Ort::Value> RunSequence(const Ort::RunOptions& options,
+                                      const std::vector<std::string>& input_names,
+                                      std::vector<Ort::Value>& input_values,
+                                      const std::vector<std::string>& output_names);
+
+  // A zero-filled initial value of the state input at input_index, for steps of num_rows rows
+  Ort::Value CreateInitialState(size_t input_index, int64_t num_rows);
+
+  const std::string model_path_;
+  Ort::Session session_;
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+  std::unique_ptr<Batcher> batcher_;
+  const SequenceStates sequence_states_;
+  Ort::AllocatorWithDefaultOptions allocator_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -5,7 +5,10 @@
 
 #include <thread>
 #include <fstream>
+#include <sstream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "boost/program_options.hpp"
 #include "core/session/onnxruntime_cxx_api.h"
@@ -39,20 +42,49 @@ class ServerConfiguration {
  public:
   const std::string full_desc = "ONNX Server: host an ONNX model with ONNX Runtime";
   std::string model_path;
+  std::string repository_path;
+  int repository_poll_interval_s = 30;
+  int model_memory_budget_mb = 0;
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int num_http_workers = std::thread::hardware_concurrency();
+  int max_queued_http_requests = 1024;
+  int max_batch_size = 1;
+  int max_queue_delay_us = 1000;
+  // the input and output names of the states of a step model
+  std::vector<std::pair<std::string, std::string>> sequence_states;
+  int num_replicas = 1;
+  int response_cache_mb = 0;
+  int response_cache_ttl_s = 0;
+  int max_concurrent_runs = 0;
+  int threads_per_replica = 0;
+  int cuda_device_id = -1;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model");
+    desc.add_options()("repository_path", po::value(&repository_path), "Path to a model repository laid out as <model name>/<version>/model.onnx, instead of model_path");
+    desc.add_options()("repository_poll_interval_s", po::value(&repository_poll_interval_s)->default_value(repository_poll_interval_s), "Interval in seconds between two scans of the model repository for new or removed versions. 0 disables the scans");
+    desc.add_options()("model_memory_budget_mb", po::value(&model_memory_budget_mb)->default_value(model_memory_budget_mb), "Size in MiB of the model files of the repository kept loaded. The models are loaded on their first request and the least recently used unloaded beyond it. 0 loads every model");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
+    desc.add_options()("num_http_workers", po::value(&num_http_workers)->default_value(num_http_workers), "Number of threads running the http requests, apart from the http threads. 0 runs them on the http threads");
+    desc.add_options()("max_queued_http_requests", po::value(&max_queued_http_requests)->default_value(max_queued_http_requests), "Maximum number of http requests waiting or running on the workers. The others are answered with 429 Too Many Requests");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum number of rows of concurrent requests run as one batch. 1 disables batching");
+    desc.add_options()("max_queue_delay_us", po::value(&max_queue_delay_us)->default_value(max_queue_delay_us), "Maximum time in microseconds a request waits for others to join its batch");
+    desc.add_options()("sequence_states", po::value(&sequence_states_str), "Comma-separated <input>:<output> pairs of the states a step model carries from a step to the next. A request then runs the model over the sequence of steps along the first dimension of its other inputs, the steps of concurrent requests being batched");
+    desc.add_options()("max_concurrent_runs", po::value(&max_concurrent_runs)->default_value(max_concurrent_runs), "Maximum number of requests running at once, the others waiting in the order of their priority and deadline. 0 doesn't limit them");
+    desc.add_options()("response_cache_mb", po::value(&response_cache_mb)->default_value(response_cache_mb), "Size in MiB of the cache answering repeated requests without running the model, for deterministic models only. 0 disables the cache");
+    desc.add_options()("response_cache_ttl_s", po::value(&response_cache_ttl_s)->default_value(response_cache_ttl_s), "Time in seconds the responses stay in the response cache. 0 keeps them until evicted");
+    desc.add_options()("num_replicas", po::value(&num_replicas)->default_value(num_replicas), "Number of thread pools the concurrent requests to a model are spread over, sharing its weights");
+    desc.add_options()("cuda_device_id", po::value(&cuda_device_id)->default_value(cuda_device_id), "CUDA device the models run on, the tensors of the requests being allocated in pinned host memory. -1 runs them on the CPU");
+    desc.add_options()("threads_per_replica", po::value(&threads_per_replica)->default_value(threads_per_replica), "Number of threads of each replica, pinned to their own cores. 0 lets the runtime choose and doesn't pin them");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -89,6 +121,7 @@ class ServerConfiguration {
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
   std::string log_level_str = "info";
+  std::string sequence_states_str;
 
   // Print help and return if there is a bad value
   Result ValidateOptions() {
@@ -99,14 +132,72 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (num_http_workers < 0) {
+      PrintHelp(std::cerr, "num_http_workers must not be negative");
+      return Result::ExitFailure;
+    } else if (max_queued_http_requests <= 0) {
+      PrintHelp(std::cerr, "max_queued_http_requests must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_batch_size <= 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_queue_delay_us < 0) {
+      PrintHelp(std::cerr, "max_queue_delay_us must not be negative");
+      return Result::ExitFailure;
+    } else if (!ParseSequenceStates()) {
+      PrintHelp(std::cerr, "sequence_states must be comma-separated <input>:<output> pairs");
+      return Result::ExitFailure;
+    } else if (max_concurrent_runs < 0) {
+      PrintHelp(std::cerr, "max_concurrent_runs must not be negative");
+      return Result::ExitFailure;
+    } else if (response_cache_mb < 0) {
+      PrintHelp(std::cerr, "response_cache_mb must not be negative");
+      return Result::ExitFailure;
+    } else if (response_cache_ttl_s < 0) {
+      PrintHelp(std::cerr, "response_cache_ttl_s must not be negative");
+      return Result::ExitFailure;
+    } else if (num_replicas <= 0) {
+      PrintHelp(std::cerr, "num_replicas must be greater than 0");
+      return Result::ExitFailure;
+    } else if (threads_per_replica < 0) {
+      PrintHelp(std::cerr, "threads_per_replica must not be negative");
+      return Result::ExitFailure;
+    } else if (cuda_device_id < -1) {
+      PrintHelp(std::cerr, "cuda_device_id must be -1 or a device id");
+      return Result::ExitFailure;
+    } else if (model_path.empty() == repository_path.empty()) {
+      PrintHelp(std::cerr, "one of model_path or repository_path is required");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
+    } else if (repository_poll_interval_s < 0) {
+      PrintHelp(std::cerr, "repository_poll_interval_s must not be negative");
+      return Result::ExitFailure;
+    } else if (model_memory_budget_mb < 0) {
+      PrintHelp(std::cerr, "model_memory_budget_mb must not be negative");
+      return Result::ExitFailure;
     } else {
       return Result::ContinueSuccess;
     }
   }
 
+  // Parses sequence_states_str into sequence_states. Returns false if a pair is malformed.
+  bool ParseSequenceStates() {
+    sequence_states.clear();
+    std::istringstream pairs(sequence_states_str);
+    std::string pair;
+    while (std::getline(pairs, pair, ',')) {
+      const auto colon = pair.find(':');
+      if (colon == 0 || colon == std::string::npos || colon + 1 == pair.size() ||
+          pair.find(':', colon + 1) != std::string::npos) {
+        return false;
+      }
+      sequence_states.emplace_back(pair.substr(0, colon), pair.substr(colon + 1));
+    }
+    return true;
+  }
+
   // Checks if program options contains help
   bool ContainsHelp() const {
     return vm.count("help") || vm.count("h");
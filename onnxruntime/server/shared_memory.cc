@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "shared_memory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+#ifndef _WIN32
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& key, uint64_t offset, uint64_t byte_size) : key_(key) {
+  if (byte_size == 0) {
+    throw std::runtime_error("The byte size of shared memory region " + key + " is 0");
+  }
+
+  const int fd = shm_open(key.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    throw std::runtime_error("Failed to open shared memory object " + key + ": " + std::strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || offset > static_cast<uint64_t>(st.st_size) ||
+      byte_size > static_cast<uint64_t>(st.st_size) - offset) {
+    close(fd);
+    throw std::runtime_error("The range of shared memory region " + key + " exceeds its shared memory object");
+  }
+
+  // mmap needs an offset on a page boundary
+  const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGE_SIZE));
+  const uint64_t mapping_offset = offset - offset % page_size;
+  mapping_size_ = static_cast<size_t>(byte_size + offset - mapping_offset);
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(mapping_offset));
+  const int mmap_errno = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw std::runtime_error("Failed to map shared memory object " + key + ": " + std::strerror(mmap_errno));
+  }
+
+  data_ = static_cast<uint8_t*>(mapping_) + (offset - mapping_offset);
+  size_ = static_cast<size_t>(byte_size);
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+#else
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& key, uint64_t /*offset*/, uint64_t /*byte_size*/)
+    : key_(key) {
+  throw std::runtime_error("Shared memory regions are not supported on Windows");
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() = default;
+
+#endif
+
+protobufutil::Status SharedMemoryManager::Register(const std::string& name, const std::string& key, uint64_t offset,
+                                                   uint64_t byte_size) {
+  if (name.empty()) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "The region name is empty");
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (regions_.count(name) > 0) {
+      return protobufutil::Status(protobufutil::error::Code::ALREADY_EXISTS,
+                                  "A shared memory region is already registered as " + name);
+    }
+  }
+
+  // map outside of the lock, the requests keep getting the other regions meanwhile
+  std::shared_ptr<SharedMemoryRegion> region;
+  try {
+    region = std::make_shared<SharedMemoryRegion>(key, offset, byte_size);
+  } catch (const std::runtime_error& e) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, e.what());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!regions_.emplace(name, std::move(region)).second) {
+    return protobufutil::Status(protobufutil::error::Code::ALREADY_EXISTS,
+                                "A shared memory region is already registered as " + name);
+  }
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status SharedMemoryManager::Unregister(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (regions_.erase(name) == 0) {
+    return protobufutil::Status(protobufutil::error::Code::NOT_FOUND,
+                                "No shared memory region is registered as " + name);
+  }
+  return protobufutil::Status::OK;
+}
+
+std::shared_ptr<SharedMemoryRegion> SharedMemoryManager::Get(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = regions_.find(name);
+  return it != regions_.end() ? it->second : nullptr;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
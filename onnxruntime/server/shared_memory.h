@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <google/protobuf/stubs/status.h>
+
+namespace onnxruntime {
+namespace server {
+
+// A range of a POSIX shared memory object, mapped into the server
+class SharedMemoryRegion {
+ public:
+  // Maps byte_size bytes at offset of the shared memory object key, as named for shm_open.
+  // Throws std::runtime_error if it can't be mapped.
+  SharedMemoryRegion(const std::string& key, uint64_t offset, uint64_t byte_size);
+  ~SharedMemoryRegion();
+  SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+  SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+  const std::string& GetKey() const { return key_; }
+  uint8_t* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+ private:
+  const std::string key_;
+  // the mapping starts at the page holding offset
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// The shared memory regions registered by the clients, that the tensors of their requests are read from and
+// written to in place, by name.
+class SharedMemoryManager {
+ public:
+  SharedMemoryManager() = default;
+  SharedMemoryManager(const SharedMemoryManager&) = delete;
+  SharedMemoryManager& operator=(const SharedMemoryManager&) = delete;
+
+  // Maps the region under name. Fails with ALREADY_EXISTS if the name is taken, with INVALID_ARGUMENT if the region
+  // can't be mapped.
+  google::protobuf::util::Status Register(const std::string& name, const std::string& key, uint64_t offset,
+                                          uint64_t byte_size);
+
+  // Fails with NOT_FOUND if no region is registered under name. The region is unmapped once the requests still
+  // using it are done.
+  google::protobuf::util::Status Unregister(const std::string& name);
+
+  // nullptr if no region is registered under name
+  std::shared_ptr<SharedMemoryRegion> Get(const std::string& name) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<SharedMemoryRegion>> regions_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
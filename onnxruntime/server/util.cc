@@ -35,6 +35,9 @@ protobufutil::Status GenerateProtobufStatus(const int& onnx_status, const std::s
     case onnxruntime::common::StatusCode::RUNTIME_EXCEPTION:
       code = protobufutil::error::Code::INTERNAL;
       break;
+    case onnxruntime::common::StatusCode::OUT_OF_MEMORY:
+      code = protobufutil::error::Code::RESOURCE_EXHAUSTED;
+      break;
     default:
       code = protobufutil::error::Code::UNKNOWN;
   }
@@ -44,5 +47,49 @@ protobufutil::Status GenerateProtobufStatus(const int& onnx_status, const std::s
   return protobufutil::Status(code, oss.str());
 }
 
+size_t GetTensorElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+std::vector<Ort::Value> RunSession(Ort::Session& session, const Ort::RunOptions& options,
+                                   const std::vector<std::string>& input_names,
+                                   std::vector<Ort::Value>& input_values,
+                                   const std::vector<std::string>& output_names) {
+  std::vector<const char*> input_ptrs;
+  input_ptrs.reserve(input_names.size());
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+
+  std::vector<const char*> output_ptrs;
+  output_ptrs.reserve(output_names.size());
+  for (const auto& output : output_names) {
+    output_ptrs.push_back(output.data());
+  }
+
+  return session.Run(options, input_ptrs.data(), input_values.data(), input_values.size(),
+                     output_ptrs.data(), output_ptrs.size());
+}
+
 }  // namespace server
 }  // namespace onnxruntime
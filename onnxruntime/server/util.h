@@ -3,9 +3,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <google/protobuf/stubs/status.h>
 
 #include "core/common/status.h"
+#include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
 namespace server {
@@ -16,24 +23,45 @@ namespace server {
 class MemBufferArray {
  public:
   MemBufferArray() = default;
+  // The buffers are allocated by allocator, e.g. in pinned host memory, or on the heap if it's nullptr
+  explicit MemBufferArray(OrtAllocator* allocator) : allocator_(allocator) {}
+  MemBufferArray(const MemBufferArray&) = delete;
+  MemBufferArray& operator=(const MemBufferArray&) = delete;
 
-  uint8_t* AllocNewBuffer(size_t tensor_length) {
-    auto* data = new uint8_t[tensor_length];
+  // on_heap allocates the buffer on the heap whatever the allocator, e.g. for the strings of a string tensor
+  uint8_t* AllocNewBuffer(size_t tensor_length, bool on_heap = false) {
+    uint8_t* data;
+    if (allocator_ != nullptr && !on_heap) {
+      void* p = nullptr;
+      ORT_THROW_ON_ERROR(OrtAllocatorAlloc(allocator_, std::max<size_t>(tensor_length, 1), &p));
+      data = static_cast<uint8_t*>(p);
+    } else {
+      data = new uint8_t[tensor_length];
+    }
     memset(data, 0, tensor_length);
-    buffers_.push_back(data);
+    buffers_.push_back({data, allocator_ != nullptr && !on_heap});
     return data;
   }
 
+  // nullptr if the buffers are allocated on the heap
+  OrtAllocator* GetAllocator() const { return allocator_; }
+
   ~MemBufferArray() {
     FreeBuffers();
   }
 
  private:
-  std::vector<uint8_t*> buffers_;
+  OrtAllocator* allocator_ = nullptr;
+  // the buffers, and whether allocator_ allocated them
+  std::vector<std::pair<uint8_t*, bool>> buffers_;
 
   void FreeBuffers() {
-    for (auto* buf : buffers_) {
-      delete[] buf;
+    for (auto& buf : buffers_) {
+      if (buf.second) {
+        OrtReleaseStatus(OrtAllocatorFree(allocator_, buf.first));
+      } else {
+        delete[] buf.first;
+      }
     }
   }
 };
@@ -42,5 +70,14 @@ google::protobuf::util::Status GenerateProtobufStatus(const int& onnx_status, co
 // Generate protobuf status from ONNX Runtime status
 google::protobuf::util::Status GenerateProtobufStatus(const onnxruntime::common::Status& onnx_status, const std::string& message);
 
+// Size in bytes of an element of a tensor of the given type, or 0 if the elements don't have a fixed size
+size_t GetTensorElementSize(ONNXTensorElementDataType type);
+
+// Runs the session on the named inputs and returns the named outputs
+std::vector<Ort::Value> RunSession(Ort::Session& session, const Ort::RunOptions& options,
+                                   const std::vector<std::string>& input_names,
+                                   std::vector<Ort::Value>& input_values,
+                                   const std::vector<std::string>& output_names);
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -92,6 +92,63 @@ TEST(DateTimeTransformer, Future_2025_June_30) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(DateTimeBatchTransformer, Batch) {
+  OpTester test("DateTimeBatchTransformer", 1, onnxruntime::kMSAutoMLDomain);
+  // 1976-11-17 12:27:04, 2025-06-30, 1776-07-04 and 2000-02-29
+  test.AddInput<int64_t>("X", {2, 2}, {217081624, 1751241600, -6106060800, 951782400});
+
+  test.AddOutput<int32_t>("year", {2, 2}, {1976, 2025, 1776, 2000});
+  test.AddOutput<uint8_t>("month", {2, 2}, {dft::TimePoint::NOVEMBER, dft::TimePoint::JUNE, dft::TimePoint::JULY,
+                                            dft::TimePoint::FEBRUARY});
+  test.AddOutput<uint8_t>("day", {2, 2}, {17, 30, 4, 29});
+  test.AddOutput<uint8_t>("hour", {2, 2}, {12, 0, 0, 0});
+  test.AddOutput<uint8_t>("minute", {2, 2}, {27, 0, 0, 0});
+  test.AddOutput<uint8_t>("second", {2, 2}, {4, 0, 0, 0});
+  test.AddOutput<uint8_t>("day_of_week", {2, 2}, {dft::TimePoint::WEDNESDAY, dft::TimePoint::MONDAY,
+                                                  dft::TimePoint::THURSDAY, dft::TimePoint::TUESDAY});
+  test.AddOutput<uint16_t>("day_of_year", {2, 2}, {321, 180, 185, 59});
+  test.AddOutput<uint8_t>("quarter_of_year", {2, 2}, {4, 2, 3, 1});
+  test.AddOutput<uint8_t>("week_of_month", {2, 2}, {2, 4, 0, 4});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(DateTimeBatchTransformer, MatchesTimePoint) {
+  // enough timestamps for several chunks, one every day and 13 seconds from 1970
+  constexpr int64_t count = 40000;
+  std::vector<int64_t> dates(count);
+  std::vector<int32_t> years(count);
+  std::vector<uint8_t> months(count), days(count), hours(count), minutes(count), seconds(count), days_of_week(count),
+      quarters(count), weeks(count);
+  std::vector<uint16_t> days_of_year(count);
+  for (int64_t i = 0; i < count; ++i) {
+    dates[i] = i * 86413;
+    dft::TimePoint tp(SysClock::from_time_t(dates[i]));
+    years[i] = tp.year;
+    months[i] = tp.month;
+    days[i] = tp.day;
+    hours[i] = tp.hour;
+    minutes[i] = tp.minute;
+    seconds[i] = tp.second;
+    days_of_week[i] = tp.dayOfWeek;
+    days_of_year[i] = tp.dayOfYear;
+    quarters[i] = tp.quarterOfYear;
+    weeks[i] = tp.weekOfMonth;
+  }
+
+  OpTester test("DateTimeBatchTransformer", 1, onnxruntime::kMSAutoMLDomain);
+  test.AddInput<int64_t>("X", {count}, dates);
+  test.AddOutput<int32_t>("year", {count}, years);
+  test.AddOutput<uint8_t>("month", {count}, months);
+  test.AddOutput<uint8_t>("day", {count}, days);
+  test.AddOutput<uint8_t>("hour", {count}, hours);
+  test.AddOutput<uint8_t>("minute", {count}, minutes);
+  test.AddOutput<uint8_t>("second", {count}, seconds);
+  test.AddOutput<uint8_t>("day_of_week", {count}, days_of_week);
+  test.AddOutput<uint16_t>("day_of_year", {count}, days_of_year);
+  test.AddOutput<uint8_t>("quarter_of_year", {count}, quarters);
+  test.AddOutput<uint8_t>("week_of_month", {count}, weeks);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
 
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -144,3 +145,40 @@ TEST(LoggingTests, TestCompositeSink) {
 
   LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning";
 }
+
+/// <summary>
+/// Tests that the async sink sends every message, in order, to the sink it wraps before it is destroyed.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kWARNING;
+
+  MockSink* sink_ptr = new MockSink();
+  std::vector<std::string> messages;
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, testing::_, testing::_))
+      .Times(10)
+      .WillRepeatedly(testing::Invoke([&messages](const Timestamp&, const std::string& logger_id,
+                                                  const Capture& message) {
+        EXPECT_EQ(logger_id, "TestAsyncSink");
+        EXPECT_EQ(message.Severity(), Severity::kWARNING);
+        EXPECT_STREQ(message.Category(), "ArbitraryCategory");
+        messages.push_back(message.Message());
+      }));
+
+  {
+    // a queue shorter than the messages, so logging waits for the sink thread
+    LoggingManager manager{std::make_unique<AsyncSink>(std::unique_ptr<ISink>{sink_ptr}, 4), min_log_level, false,
+                           InstanceType::Temporal};
+    auto logger = manager.CreateLogger(logid);
+
+    for (int i = 0; i < 10; ++i) {
+      LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Message " << i;
+    }
+    LOGS_CATEGORY(*logger, INFO, "ArbitraryCategory") << "Filtered";
+  }
+
+  ASSERT_EQ(messages.size(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(messages[i], "Message " + std::to_string(i));
+  }
+}
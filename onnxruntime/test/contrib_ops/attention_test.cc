@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Computes multi-head self-attention the way the unfused subgraph does, one head at a time.
+static std::vector<float> ReferenceAttention(const std::vector<float>& input, const std::vector<float>& weight,
+                                             const std::vector<float>& bias, const std::vector<float>* mask,
+                                             int64_t mask_batch, int64_t mask_rows,
+                                             int64_t batch_size, int64_t sequence_length, int64_t hidden_size,
+                                             int64_t num_heads) {
+  const int64_t head_size = hidden_size / num_heads;
+  std::vector<float> qkv(batch_size * sequence_length * 3 * hidden_size);
+  for (int64_t t = 0; t < batch_size * sequence_length; ++t) {
+    for (int64_t j = 0; j < 3 * hidden_size; ++j) {
+      float sum = bias[j];
+      for (int64_t i = 0; i < hidden_size; ++i) {
+        sum += input[t * hidden_size + i] * weight[i * 3 * hidden_size + j];
+      }
+      qkv[t * 3 * hidden_size + j] = sum;
+    }
+  }
+
+  std::vector<float> output(batch_size * sequence_length * hidden_size);
+  std::vector<float> probs(sequence_length);
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t n = 0; n < num_heads; ++n) {
+      for (int64_t s = 0; s < sequence_length; ++s) {
+        const float* q = qkv.data() + (b * sequence_length + s) * 3 * hidden_size + n * head_size;
+        float max_score = -INFINITY;
+        for (int64_t t = 0; t < sequence_length; ++t) {
+          const float* k = qkv.data() + (b * sequence_length + t) * 3 * hidden_size + hidden_size + n * head_size;
+          float score = 0.0f;
+          for (int64_t h = 0; h < head_size; ++h) {
+            score += q[h] * k[h];
+          }
+          score /= std::sqrt(static_cast<float>(head_size));
+          if (mask != nullptr) {
+            score += (*mask)[((mask_batch == 1 ? 0 : b) * mask_rows + (mask_rows == 1 ? 0 : s)) * sequence_length + t];
+          }
+          probs[t] = score;
+          max_score = std::max(max_score, score);
+        }
+        float sum = 0.0f;
+        for (int64_t t = 0; t < sequence_length; ++t) {
+          probs[t] = std::exp(probs[t] - max_score);
+          sum += probs[t];
+        }
+        for (int64_t h = 0; h < head_size; ++h) {
+          float value = 0.0f;
+          for (int64_t t = 0; t < sequence_length; ++t) {
+            value += probs[t] / sum * qkv[(b * sequence_length + t) * 3 * hidden_size + 2 * hidden_size + n * head_size + h];
+          }
+          output[(b * sequence_length + s) * hidden_size + n * head_size + h] = value;
+        }
+      }
+    }
+  }
+  return output;
+}
+
+static void RunAttentionTest(int64_t batch_size, int64_t sequence_length, int64_t hidden_size, int64_t num_heads,
+                             bool use_mask) {
+  std::vector<float> input(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(static_cast<int64_t>(i * 7 % 23) - 11) / 10.0f;
+  }
+  std::vector<float> weight(hidden_size * 3 * hidden_size);
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = static_cast<float>(static_cast<int64_t>(i * 13 % 17) - 8) / 20.0f;
+  }
+  std::vector<float> bias(3 * hidden_size);
+  for (size_t i = 0; i < bias.size(); ++i) {
+    bias[i] = static_cast<float>(i % 5) / 10.0f;
+  }
+
+  // mask out the last position of every sequence but the first
+  std::vector<float> mask(batch_size * sequence_length, 0.0f);
+  for (int64_t b = 1; b < batch_size; ++b) {
+    mask[b * sequence_length + sequence_length - 1] = -10000.0f;
+  }
+
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input);
+  test.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight);
+  test.AddInput<float>("bias", {3 * hidden_size}, bias);
+  if (use_mask) {
+    test.AddInput<float>("mask", {batch_size, 1, 1, sequence_length}, mask);
+  }
+  test.AddOutput<float>("output", {batch_size, sequence_length, hidden_size},
+                        ReferenceAttention(input, weight, bias, use_mask ? &mask : nullptr, batch_size, 1,
+                                           batch_size, sequence_length, hidden_size, num_heads));
+  test.Run();
+}
+
+TEST(AttentionOpTest, SingleHead) {
+  RunAttentionTest(1, 3, 4, 1, false);
+}
+
+TEST(AttentionOpTest, MultipleHeadsWithMask) {
+  RunAttentionTest(2, 5, 8, 2, true);
+}
+
+TEST(AttentionOpTest, ManyHeads) {
+  RunAttentionTest(3, 16, 64, 4, true);
+}
+
+TEST(AttentionOpTest, InvalidHiddenSize) {
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", 3);
+  test.AddInput<float>("input", {1, 2, 4}, std::vector<float>(8, 1.0f));
+  test.AddInput<float>("weight", {4, 12}, std::vector<float>(48, 1.0f));
+  test.AddInput<float>("bias", {12}, std::vector<float>(12, 0.0f));
+  test.AddOutput<float>("output", {1, 2, 4}, std::vector<float>(8, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is not a multiple of num_heads");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
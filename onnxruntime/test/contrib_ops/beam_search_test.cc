@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "test/providers/provider_test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// The decoder of a vocabulary of 4 tokens where the logits of the next token only depend on the last one, with a
+// single layer whose present state appends the tokens to the past state.
+static GraphProto CreateDecoder() {
+  Model model("decoder");
+  auto& graph = model.MainGraph();
+
+  TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  int32_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  int32_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+
+  TypeProto logits_tensor;
+  logits_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  logits_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  logits_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  logits_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  // [2, batch_size, num_heads, sequence_length, head_size] with num_heads and head_size of 1
+  TypeProto state_tensor;
+  state_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* state_shape = state_tensor.mutable_tensor_type()->mutable_shape();
+  state_shape->add_dim()->set_dim_value(2);
+  state_shape->add_dim();
+  state_shape->add_dim()->set_dim_value(1);
+  state_shape->add_dim();
+  state_shape->add_dim()->set_dim_value(1);
+
+  auto& input_ids = graph.GetOrCreateNodeArg("input_ids", &int32_tensor);
+  auto& position_ids = graph.GetOrCreateNodeArg("position_ids", &int32_tensor);
+  auto& attention_mask = graph.GetOrCreateNodeArg("attention_mask", &int32_tensor);
+  auto& past = graph.GetOrCreateNodeArg("past_0", &state_tensor);
+  auto& logits = graph.GetOrCreateNodeArg("logits", &logits_tensor);
+  auto& present = graph.GetOrCreateNodeArg("present_0", &state_tensor);
+
+  auto& table = graph.GetOrCreateNodeArg("table", nullptr);
+  auto& constant = graph.AddNode("table", "Constant", "The logits following each token", {}, {&table});
+  TensorProto value_tensor;
+  value_tensor.add_dims(4);
+  value_tensor.add_dims(4);
+  for (float value : {0.f, 0.f, 0.f, 0.f,
+                      0.f, 0.f, 2.f, 1.f,
+                      0.f, 1.f, 0.f, 3.f,
+                      0.f, 0.f, 0.f, 0.f}) {
+    value_tensor.add_float_data(value);
+  }
+  value_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  constant.AddAttribute("value", value_tensor);
+
+  graph.AddNode("gather", "Gather", "Look up the logits", {&table, &input_ids}, {&logits});
+
+  auto& tokens = graph.GetOrCreateNodeArg("tokens", nullptr);
+  auto& cast = graph.AddNode("cast", "Cast", "Cast the tokens to float", {&input_ids}, {&tokens});
+  cast.AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+
+  auto& token_state = graph.GetOrCreateNodeArg("token_state", nullptr);
+  auto& unsqueeze = graph.AddNode("unsqueeze", "Unsqueeze", "Shape the tokens as a state", {&tokens},
+                                  {&token_state});
+  unsqueeze.AddAttribute("axes", std::vector<int64_t>{0, 2, 4});
+
+  auto& new_state = graph.GetOrCreateNodeArg("new_state", nullptr);
+  auto& concat_halves = graph.AddNode("concat_halves", "Concat", "Duplicate the state", {&token_state, &token_state},
+                                      {&new_state});
+  concat_halves.AddAttribute("axis", int64_t{0});
+
+  auto& concat = graph.AddNode("concat", "Concat", "Append to the past state", {&past, &new_state}, {&present});
+  concat.AddAttribute("axis", int64_t{3});
+
+  graph.SetInputs({&input_ids, &position_ids, &attention_mask, &past});
+  graph.SetOutputs({&logits, &present});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+TEST(BeamSearchTest, GreedySearch) {
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", 3);
+  test.AddAttribute<int64_t>("pad_token_id", 0);
+  test.AddAttribute<GraphProto>("decoder", CreateDecoder());
+
+  test.AddInput<int32_t>("input_ids", {2, 1}, {1, 2});
+  test.AddInput<int32_t>("max_length", {1}, {5});
+
+  // the sequences are padded once both have ended
+  test.AddOutput<int32_t>("sequences", {2, 5}, {1, 2, 3, 0, 0,
+                                                 2, 3, 0, 0, 0});
+  test.Run();
+}
+
+TEST(BeamSearchTest, GreedySearchMinLength) {
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", 3);
+  test.AddAttribute<int64_t>("pad_token_id", 0);
+  test.AddAttribute<GraphProto>("decoder", CreateDecoder());
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+  test.AddInput<int32_t>("max_length", {1}, {5});
+  test.AddInput<int32_t>("min_length", {1}, {4});
+
+  // eos_token_id can't end the sequence before its 4th token
+  test.AddOutput<int32_t>("sequences", {1, 5}, {1, 2, 1, 2, 3});
+  test.Run();
+}
+
+TEST(BeamSearchTest, BeamSearch) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", 3);
+  test.AddAttribute<int64_t>("pad_token_id", 0);
+  test.AddAttribute<GraphProto>("decoder", CreateDecoder());
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+  test.AddInput<int32_t>("max_length", {1}, {4});
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddInput<int32_t>("num_beams", {1}, {2});
+  test.AddInput<int32_t>("num_return_sequences", {1}, {2});
+
+  // the sum of the log probabilities of the tokens divided by the length of the sequence before eos
+  test.AddOutput<int32_t>("sequences", {1, 2, 4}, {1, 2, 3, 0,
+                                                    1, 2, 1, 2});
+  test.AddOutput<float>("sequences_scores", {1, 2}, {-0.352405f, -0.799655f});
+  test.Run();
+}
+
+TEST(BeamSearchTest, InvalidNumReturnSequences) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", 3);
+  test.AddAttribute<int64_t>("pad_token_id", 0);
+  test.AddAttribute<GraphProto>("decoder", CreateDecoder());
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+  test.AddInput<int32_t>("max_length", {1}, {4});
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddInput<int32_t>("num_beams", {1}, {2});
+  test.AddInput<int32_t>("num_return_sequences", {1}, {3});
+
+  test.AddOutput<int32_t>("sequences", {1, 3, 4}, std::vector<int32_t>(12, 0));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Input num_return_sequences must be in [1, num_beams]");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// rows of 8 values, which take the matrix multiplication path of the euclidean and cosine metrics
+static const std::vector<float> kA = {0, 0, 0, 0, 0, 0, 0, 1,
+                                      1, 1, 1, 1, 1, 1, 1, 1,
+                                      2, 0, 1, 0, 2, 0, 1, 0};
+static const std::vector<float> kB = {1, 1, 1, 1, 1, 1, 1, 1,
+                                      3, 4, 0, 0, 0, 0, 0, 0};
+
+static void RunCDist(const std::string& metric, const std::vector<int64_t>& a_dims, const std::vector<float>& a,
+                     const std::vector<int64_t>& b_dims, const std::vector<float>& b, const std::vector<float>& c) {
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", metric);
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<float>("B", b_dims, b);
+  test.AddOutput<float>("C", {a_dims[0], b_dims[0]}, c);
+  test.Run();
+}
+
+TEST(CDistOpTest, Sqeuclidean) {
+  RunCDist("sqeuclidean", {3, 8}, kA, {2, 8}, kB, {7, 26, 0, 19, 6, 23});
+  RunCDist("sqeuclidean", {2, 2}, {0, 0, 1, 1}, {1, 2}, {3, 4}, {25, 13});
+}
+
+TEST(CDistOpTest, Euclidean) {
+  RunCDist("euclidean", {3, 8}, kA, {2, 8}, kB, {2.6457513f, 5.0990195f, 0.0f, 4.3588989f, 2.4494897f, 4.7958315f});
+  RunCDist("euclidean", {2, 2}, {0, 0, 1, 1}, {1, 2}, {3, 4}, {5.0f, 3.6055513f});
+}
+
+TEST(CDistOpTest, Cosine) {
+  RunCDist("cosine", {3, 8}, kA, {2, 8}, kB, {0.6464466f, 1.0f, 0.0f, 0.5050253f, 0.3291796f, 0.6205267f});
+}
+
+TEST(CDistOpTest, Cityblock) {
+  RunCDist("cityblock", {3, 8}, kA, {2, 8}, kB, {7, 8, 0, 11, 6, 9});
+  RunCDist("cityblock", {2, 2}, {0, 0, 1, 1}, {1, 2}, {3, 4}, {7, 5});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "core/util/math.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<MLFloat16> ToFloat16(const std::vector<float>& values) {
+  std::vector<MLFloat16> float16_values;
+  for (auto value : values) {
+    float16_values.push_back(MLFloat16(math::floatToHalf(value)));
+  }
+  return float16_values;
+}
+
+TEST(CompressedMatMulTest, Int8WeightWithBias) {
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("scale", 0.5f);
+  test.AddAttribute("beta", 2.f);
+
+  test.AddInput<float>("A", {1, 2, 3}, {1.f, 2.f, 3.f,
+                                        -1.f, 0.f, 2.f});
+  test.AddInput<int8_t>("B", {3, 2}, {1, -2,
+                                      3, 0,
+                                      -1, 4},
+                        true);
+  test.AddInput<float>("C", {2}, {1.f, -1.f});
+  test.AddOutput<float>("Y", {1, 2, 2}, {4.f, 3.f,
+                                         0.5f, 3.f});
+  test.Run();
+}
+
+TEST(CompressedMatMulTest, Float16TransposedWeight) {
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 2.f);
+
+  test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f,
+                                     -1.f, 0.f, 2.f});
+  test.AddInput<MLFloat16>("B", {2, 3}, ToFloat16({1.f, 0.5f, -2.f,
+                                                   0.25f, 4.f, 1.f}),
+                           true);
+  test.AddOutput<float>("Y", {2, 2}, {-8.f, 22.5f,
+                                      -10.f, 3.5f});
+  test.Run();
+}
+
+TEST(CompressedMatMulTest, EmptyInnerDimension) {
+  OpTester test("CompressedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("beta", 3.f);
+
+  test.AddInput<float>("A", {2, 0}, {});
+  test.AddInput<int8_t>("B", {0, 2}, {}, true);
+  test.AddInput<float>("C", {1}, {1.f});
+  test.AddOutput<float>("Y", {2, 2}, {3.f, 3.f, 3.f, 3.f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A ranges over [0, 255], so it is quantized with a scale of 1 and a zero point of 0 without loss
+TEST(DynamicQuantizeMatMulOpTest, WithZeroPointAndBias) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 2}, {0.f, 255.f, 10.f, 20.f});
+  // B = {-0.5, 0.5, 0.5, 1}
+  test.AddInput<uint8_t>("B", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<float>("b_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {2});
+  test.AddInput<float>("bias", {2}, {1.f, -1.f});
+  test.AddOutput<float>("Y", {2, 2}, {128.5f, 254.f, 6.f, 19.f});
+  test.Run();
+}
+
+// a batch of A multiplied with a constant B, which the kernel packs once
+TEST(DynamicQuantizeMatMulOpTest, BatchedWithConstantWeight) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 1, 2}, {255.f, 0.f, 100.f, 50.f});
+  // B = {0.5, 1, 1.5, 2}
+  test.AddInput<uint8_t>("B", {2, 2}, {1, 2, 3, 4}, true);
+  test.AddInput<float>("b_scale", {}, {0.5f});
+  test.AddOutput<float>("Y", {2, 1, 2}, {127.5f, 255.f, 125.f, 200.f});
+  test.Run();
+}
+
+// the scale and zero point of B are given per column
+TEST(DynamicQuantizeMatMulOpTest, PerColumnScaleAndZeroPoint) {
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 2}, {0.f, 255.f, 10.f, 20.f});
+  // B = {-0.5, 0.5, 0.5, 1}
+  test.AddInput<uint8_t>("B", {2, 2}, {1, 4, 3, 6});
+  test.AddInput<float>("b_scale", {2}, {0.5f, 0.25f});
+  test.AddInput<uint8_t>("b_zero_point", {2}, {2, 2});
+  test.AddOutput<float>("Y", {2, 2}, {127.5f, 255.f, 5.f, 25.f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
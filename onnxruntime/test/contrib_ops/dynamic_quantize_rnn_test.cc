@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// The inputs are multiples of the scale 2.55 / 255 of each GEMM input and R is 0 once dequantized, so the outputs
+// match the float operators with W = 0.1 * (W_quantized - 128).
+static const std::vector<float> X_data{2.55f, 0.f, 1.02f, 2.55f};
+static const std::vector<uint8_t> W_data{129, 127, 130, 126, 131, 128, 128, 132,
+                                         126, 130, 133, 129, 127, 127, 132, 131};
+
+static void RunDynamicQuantizeLSTM(bool weights_are_initializers) {
+  const int64_t seq_length = 2, batch_size = 1, input_size = 2, hidden_size = 2;
+
+  OpTester test("DynamicQuantizeLSTM", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("hidden_size", hidden_size);
+
+  test.AddInput<float>("X", {seq_length, batch_size, input_size}, X_data);
+  test.AddInput<uint8_t>("W", {1, 4 * hidden_size, input_size}, W_data, weights_are_initializers);
+  test.AddInput<uint8_t>("R", {1, 4 * hidden_size, hidden_size}, std::vector<uint8_t>(16, 128),
+                         weights_are_initializers);
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<float>("W_scale", {1}, {0.1f}, weights_are_initializers);
+  test.AddInput<uint8_t>("W_zero_point", {1}, {128}, weights_are_initializers);
+  test.AddInput<float>("R_scale", {1}, {0.1f}, weights_are_initializers);
+  test.AddInput<uint8_t>("R_zero_point", {1}, {128}, weights_are_initializers);
+
+  test.AddOutput<float>("Y", {seq_length, 1, batch_size, hidden_size}, {-0.095346f, 0.223529f, -0.135188f, 0.433908f});
+  test.AddOutput<float>("Y_h", {1, batch_size, hidden_size}, {-0.135188f, 0.433908f});
+  test.AddOutput<float>("Y_c", {1, batch_size, hidden_size}, {-0.239199f, 0.678238f});
+  test.Run();
+}
+
+static void RunDynamicQuantizeGRU(bool weights_are_initializers) {
+  const int64_t seq_length = 2, batch_size = 1, input_size = 2, hidden_size = 2;
+
+  OpTester test("DynamicQuantizeGRU", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("hidden_size", hidden_size);
+
+  test.AddInput<float>("X", {seq_length, batch_size, input_size}, X_data);
+  test.AddInput<uint8_t>("W", {1, 3 * hidden_size, input_size},
+                         std::vector<uint8_t>(W_data.begin(), W_data.begin() + 12), weights_are_initializers);
+  test.AddInput<uint8_t>("R", {1, 3 * hidden_size, hidden_size}, std::vector<uint8_t>(12, 128),
+                         weights_are_initializers);
+  test.AddMissingOptionalInput<float>();
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<float>("W_scale", {1}, {0.1f}, weights_are_initializers);
+  test.AddInput<uint8_t>("W_zero_point", {1}, {128}, weights_are_initializers);
+  test.AddInput<float>("R_scale", {1}, {0.1f}, weights_are_initializers);
+  test.AddInput<uint8_t>("R_zero_point", {1}, {128}, weights_are_initializers);
+
+  test.AddOutput<float>("Y", {seq_length, 1, batch_size, hidden_size}, {-0.205175f, 0.320846f, 0.064972f, 0.506960f});
+  test.AddOutput<float>("Y_h", {1, batch_size, hidden_size}, {0.064972f, 0.506960f});
+  test.Run();
+}
+
+TEST(DynamicQuantizeRnnTest, LSTM) {
+  RunDynamicQuantizeLSTM(false);
+}
+
+// constant weights are quantized and packed once by the kernel
+TEST(DynamicQuantizeRnnTest, LSTMConstantWeights) {
+  RunDynamicQuantizeLSTM(true);
+}
+
+TEST(DynamicQuantizeRnnTest, GRU) {
+  RunDynamicQuantizeGRU(false);
+}
+
+TEST(DynamicQuantizeRnnTest, GRUConstantWeights) {
+  RunDynamicQuantizeGRU(true);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
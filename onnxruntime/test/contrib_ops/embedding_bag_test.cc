@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static const std::vector<float> kEmbeddingTable = {0.0f, 1.0f,
+                                                   10.0f, 11.0f,
+                                                   20.0f, 21.0f,
+                                                   30.0f, 31.0f};
+
+TEST(EmbeddingBagOpTest, SumFixedLengthBags) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2}, kEmbeddingTable);
+  test.AddInput<int64_t>("indices", {2, 3}, {0, 1, 2, 3, 3, 1});
+  test.AddOutput<float>("output", {2, 2}, {30.0f, 33.0f, 70.0f, 73.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, MeanWithOffsetsAndWeights) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("mode", "mean");
+  test.AddInput<float>("data", {4, 2}, kEmbeddingTable);
+  test.AddInput<int32_t>("indices", {5}, {1, 2, 3, 0, 2});
+  test.AddInput<int32_t>("offsets", {4}, {0, 2, 2, 3});
+  test.AddInput<float>("per_sample_weights", {5}, {1.0f, 2.0f, 0.5f, 3.0f, 1.0f});
+  // bag 0 = (10, 11) + 2 * (20, 21), bag 1 is empty, bag 2 = 0.5 * (30, 31), bag 3 = 3 * (0, 1) + (20, 21)
+  test.AddOutput<float>("output", {4, 2}, {25.0f, 26.5f, 0.0f, 0.0f, 15.0f, 15.5f, 10.0f, 12.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, SumManyBags) {
+  // enough bags that they are split across threads
+  const int64_t rows = 1000, cols = 16, bags = 512, bag_length = 8;
+  std::vector<float> data(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    data[i] = static_cast<float>(i % 101);
+  }
+
+  std::vector<int64_t> indices(bags * bag_length);
+  std::vector<float> output(bags * cols, 0.0f);
+  for (int64_t i = 0; i < bags * bag_length; ++i) {
+    indices[i] = (i * 37) % rows;
+    for (int64_t c = 0; c < cols; ++c) {
+      output[(i / bag_length) * cols + c] += data[indices[i] * cols + c];
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {rows, cols}, data);
+  test.AddInput<int64_t>("indices", {bags, bag_length}, indices);
+  test.AddOutput<float>("output", {bags, cols}, output);
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2}, kEmbeddingTable);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 4});
+  test.AddOutput<float>("output", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedElementwise_MulAddRelu) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "Add", "Relu"});
+  test.AddInput<float>("X", {2, 3}, {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f});
+  test.AddInput<float>("W", {2, 3}, {2.0f, 2.0f, 2.0f, 0.5f, 0.5f, 0.5f});
+  test.AddInput<float>("B", {1}, {1.0f});
+  test.AddOutput<float>("Y", {2, 3}, {3.0f, 0.0f, 7.0f, 0.0f, 3.5f, 0.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_SubDivSigmoid) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Div", "Sigmoid"});
+  std::vector<float> x{0.0f, 1.0f, 2.0f, 3.0f};
+  std::vector<float> y;
+  for (float v : x) {
+    y.push_back(1.0f / (1.0f + std::exp(-(v - 1.0f) / 2.0f)));
+  }
+  test.AddInput<float>("X", {4}, x);
+  test.AddInput<float>("mean", {}, {1.0f});
+  test.AddInput<float>("stddev", {1}, {2.0f});
+  test.AddOutput<float>("Y", {4}, y);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_Large) {
+  // spans several blocks and tasks, with a partial block at the end
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Abs", "Sqrt", "Mul", "Neg", "Tanh"});
+  const int64_t size = 100003;
+  std::vector<float> x(size), w(size), y(size);
+  for (int64_t i = 0; i < size; i++) {
+    x[i] = static_cast<float>(i % 37) - 18.0f;
+    w[i] = static_cast<float>(i % 5) * 0.1f;
+    y[i] = std::tanh(-(std::sqrt(std::abs(x[i])) * w[i]));
+  }
+  test.AddInput<float>("X", {size}, x);
+  test.AddInput<float>("W", {size}, w);
+  test.AddOutput<float>("Y", {size}, y);
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedElementwise_InvalidOperandShape) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddInput<float>("X", {2, 3}, std::vector<float>(6, 1.0f));
+  test.AddInput<float>("B", {3}, std::vector<float>(3, 1.0f));
+  test.AddOutput<float>("Y", {2, 3}, std::vector<float>(6, 2.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is neither a scalar nor the shape of the first input");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
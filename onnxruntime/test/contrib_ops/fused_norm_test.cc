@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ContribOpTest, FusedBatchNormalization_LeakyRelu) {
+  OpTester test("FusedBatchNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", 0.0f);
+  test.AddAttribute("activation", std::string("LeakyRelu"));
+  test.AddAttribute("activation_params", std::vector<float>{0.1f});
+  test.AddInput<float>("X", {1, 2, 1, 2}, {1.0f, -2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("scale", {2}, {1.0f, 2.0f});
+  test.AddInput<float>("B", {2}, {0.0f, 1.0f});
+  test.AddInput<float>("mean", {2}, {0.0f, 1.0f});
+  test.AddInput<float>("var", {2}, {1.0f, 4.0f});
+  test.AddOutput<float>("Y", {1, 2, 1, 2}, {1.0f, -0.2f, 3.0f, 4.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedInstanceNormalization_Relu) {
+  OpTester test("FusedInstanceNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", 0.3f);
+  test.AddAttribute("activation", std::string("Relu"));
+  test.AddInput<float>("input", {1, 3, 4},
+                       {3.1513367f, 9.283596f, 1.4546119f, 5.4617004f,
+                        8.519701f, 1.2382338f, 1.7930176f, 5.1099434f,
+                        7.9195533f, 7.638727f, 8.065445f, 3.8082376f});
+  test.AddInput<float>("scale", {3}, {1.0f, 1.0f, 1.0f});
+  test.AddInput<float>("B", {3}, {0.0f, 0.0f, 0.0f});
+  test.AddOutput<float>("Y", {1, 3, 4},
+                        {0.0f, 1.48930046f, 0.0f, 0.20899761f,
+                         1.46688162f, 0.0f, 0.0f, 0.31824524f,
+                         0.57370438f, 0.42193634f, 0.6525492f, 0.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, FusedInstanceNormalization_Large) {
+  // planes large enough to be split across tasks, with a mean far from zero
+  OpTester test("FusedInstanceNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", 1e-5f);
+  test.AddAttribute("activation", std::string("Clip"));
+  test.AddAttribute("activation_params", std::vector<float>{-1.0f, 1.0f});
+  const int64_t channels = 3;
+  const int64_t plane_size = 10007;
+  std::vector<float> X(static_cast<size_t>(2 * channels * plane_size));
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = 100.0f + static_cast<float>(i % 13) - 6.0f;
+  }
+  const std::vector<float> scale{1.0f, 0.5f, 2.0f};
+  const std::vector<float> B{0.0f, 0.25f, -0.5f};
+
+  std::vector<float> Y(X.size());
+  for (int64_t plane = 0; plane < 2 * channels; ++plane) {
+    const float* x = X.data() + plane * plane_size;
+    double mean = 0.0;
+    for (int64_t i = 0; i < plane_size; ++i) {
+      mean += x[i];
+    }
+    mean /= plane_size;
+    double variance = 0.0;
+    for (int64_t i = 0; i < plane_size; ++i) {
+      variance += (x[i] - mean) * (x[i] - mean);
+    }
+    variance /= plane_size;
+    const int64_t c = plane % channels;
+    for (int64_t i = 0; i < plane_size; ++i) {
+      const double y = (x[i] - mean) / std::sqrt(variance + 1e-5) * scale[c] + B[c];
+      Y[plane * plane_size + i] = static_cast<float>(std::min(std::max(y, -1.0), 1.0));
+    }
+  }
+
+  test.AddInput<float>("input", {2, channels, plane_size}, X);
+  test.AddInput<float>("scale", {channels}, scale);
+  test.AddInput<float>("B", {channels}, B);
+  test.AddOutput<float>("Y", {2, channels, plane_size}, Y);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -101,6 +101,28 @@ TEST(GatherNDOpTest, GatherND_3tensor_int64) {
   test3.Run();
 }
 
+TEST(GatherNDOpTest, GatherND_large_slices_float_int64) {
+  // enough slices are gathered that the copies are split across threads
+  const int64_t rows = 4096, cols = 32, lookups = 2048;
+  std::vector<float> data(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    data[i] = static_cast<float>(i);
+  }
+
+  std::vector<int64_t> indices(lookups);
+  std::vector<float> output;
+  for (int64_t i = 0; i < lookups; ++i) {
+    indices[i] = (i * 31) % rows;
+    output.insert(output.end(), data.begin() + indices[i] * cols, data.begin() + (indices[i] + 1) * cols);
+  }
+
+  OpTester test("GatherND", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {rows, cols}, data);
+  test.AddInput<int64_t>("indices", {lookups, 1}, indices);
+  test.AddOutput<float>("output", {lookups, cols}, output);
+  test.Run();
+}
+
 TEST(GatherNDOpTest, GatherND_batched_index_int64) {
   OpTester test("GatherND", 1, onnxruntime::kMSDomain);
   test.AddInput<int64_t>("data", {2,2}, {0LL,1LL,2LL,3LL});
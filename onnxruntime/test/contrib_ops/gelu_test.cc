@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void RunGeluTest(const std::vector<float>& input, const std::vector<int64_t>& dims) {
+  std::vector<float> output(input.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    output[i] = 0.5f * input[i] * (1.0f + std::erf(input[i] / std::sqrt(2.0f)));
+  }
+
+  OpTester test("Gelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", dims, input);
+  test.AddOutput<float>("Y", dims, output);
+  test.Run();
+}
+
+TEST(GeluOpTest, Basic) {
+  RunGeluTest({-3.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 3.0f, 10.0f}, {2, 4});
+}
+
+TEST(GeluOpTest, ManyElements) {
+  // enough elements for several blocks split across threads
+  const int64_t size = 40000;
+  std::vector<float> input(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input[i] = static_cast<float>(i % 1001 - 500) / 100.0f;
+  }
+  RunGeluTest(input, {4, size / 4});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// two lists of vectors around (0, 0) and (10, 10)
+static void AddFlatIndex(OpTester& test) {
+  test.AddInput<float>("centroids", {2, 2}, {0.0f, 0.0f, 10.0f, 10.0f}, true);
+  test.AddInput<int64_t>("list_offsets", {3}, {0, 3, 5}, true);
+  test.AddInput<int64_t>("ids", {5}, {10, 11, 12, 13, 14}, true);
+  test.AddInput<float>("vectors", {5, 2}, {0.0f, 1.0f, 1.0f, 0.0f, 2.0f, 2.0f, 9.0f, 9.0f, 10.0f, 11.0f}, true);
+}
+
+TEST(IVFSearchOpTest, Flat) {
+  OpTester test("IVFSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("k", 2);
+  test.AddInput<float>("X", {2, 2}, {0.5f, 0.0f, 10.0f, 10.0f});
+  AddFlatIndex(test);
+  test.AddOutput<float>("distances", {2, 2}, {0.25f, 1.25f, 1.0f, 2.0f});
+  test.AddOutput<int64_t>("indices", {2, 2}, {11, 10, 14, 13});
+  test.Run();
+}
+
+TEST(IVFSearchOpTest, FlatSeveralLists) {
+  OpTester test("IVFSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("k", 4);
+  test.AddAttribute<int64_t>("nprobe", 2);
+  test.AddInput<float>("X", {2, 2}, {0.5f, 0.0f, 10.0f, 10.0f});
+  AddFlatIndex(test);
+  test.AddOutput<float>("distances", {2, 4}, {0.25f, 1.25f, 6.25f, 153.25f, 1.0f, 2.0f, 128.0f, 181.0f});
+  test.AddOutput<int64_t>("indices", {2, 4}, {11, 10, 12, 13, 14, 13, 12, 10});
+  test.Run();
+}
+
+TEST(IVFSearchOpTest, ProductQuantization) {
+  // the residuals are split in two subvectors of one value, and code c stands for the value c
+  std::vector<float> codebooks(2 * 256);
+  for (size_t i = 0; i < codebooks.size(); ++i) {
+    codebooks[i] = static_cast<float>(i % 256);
+  }
+
+  OpTester test("IVFSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("k", 2);
+  test.AddInput<float>("X", {1, 2}, {1.0f, 1.0f});
+  test.AddInput<float>("centroids", {1, 2}, {0.0f, 0.0f}, true);
+  test.AddInput<int64_t>("list_offsets", {2}, {0, 2}, true);
+  test.AddInput<int64_t>("ids", {2}, {7, 8}, true);
+  test.AddInput<uint8_t>("vectors", {2, 2}, {3, 0, 1, 2}, true);
+  test.AddInput<float>("codebooks", {2, 256, 1}, codebooks, true);
+  test.AddOutput<float>("distances", {1, 2}, {1.0f, 5.0f});
+  test.AddOutput<int64_t>("indices", {1, 2}, {8, 7});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static void RunLayerNormTest(const std::vector<float>& input, const std::vector<int64_t>& dims,
+                             const std::vector<float>& scale, const std::vector<float>& bias, float epsilon) {
+  const size_t norm_size = scale.size();
+  std::vector<float> output(input.size());
+  for (size_t row = 0; row < input.size() / norm_size; ++row) {
+    const float* x = input.data() + row * norm_size;
+    double mean = 0.0, variance = 0.0;
+    for (size_t i = 0; i < norm_size; ++i) {
+      mean += x[i];
+    }
+    mean /= norm_size;
+    for (size_t i = 0; i < norm_size; ++i) {
+      variance += (x[i] - mean) * (x[i] - mean);
+    }
+    variance /= norm_size;
+    for (size_t i = 0; i < norm_size; ++i) {
+      output[row * norm_size + i] =
+          static_cast<float>((x[i] - mean) / std::sqrt(variance + epsilon) * scale[i] + bias[i]);
+    }
+  }
+
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", epsilon);
+  test.AddInput<float>("X", dims, input);
+  test.AddInput<float>("scale", {static_cast<int64_t>(norm_size)}, scale);
+  test.AddInput<float>("B", {static_cast<int64_t>(norm_size)}, bias);
+  test.AddOutput<float>("Y", dims, output);
+  test.Run();
+}
+
+TEST(LayerNormOpTest, Basic) {
+  RunLayerNormTest({1.0f, 2.0f, 3.0f, 4.0f,
+                    -2.0f, 0.0f, 0.0f, 10.0f,
+                    5.0f, 5.0f, 5.0f, 5.0f},
+                   {1, 3, 4}, {1.0f, 0.5f, 2.0f, -1.0f}, {0.0f, 0.1f, -0.2f, 0.3f}, 1e-5f);
+}
+
+TEST(LayerNormOpTest, LargeOffset) {
+  // a mean much larger than the deviation must not cancel the variance
+  RunLayerNormTest({1000.0f, 1000.5f, 1001.0f, 1001.5f}, {1, 4}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f},
+                   1e-12f);
+}
+
+TEST(LayerNormOpTest, ManyRows) {
+  // enough rows that they are split across threads
+  const int64_t rows = 256, norm_size = 128;
+  std::vector<float> input(rows * norm_size);
+  for (int64_t i = 0; i < rows * norm_size; ++i) {
+    input[i] = static_cast<float>((i * 37) % 101) / 10.0f;
+  }
+  std::vector<float> scale(norm_size), bias(norm_size);
+  for (int64_t i = 0; i < norm_size; ++i) {
+    scale[i] = 1.0f + 0.01f * i;
+    bias[i] = 0.5f - 0.01f * i;
+  }
+  RunLayerNormTest(input, {2, rows / 2, norm_size}, scale, bias, 1e-5f);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
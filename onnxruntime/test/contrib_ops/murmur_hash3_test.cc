@@ -107,5 +107,44 @@ TEST(MurmurHash3OpTest, StringKeyUIntWithSeed42) {
   test.Run();
 }
 
+TEST(MurmurHash3OpTest, Int64Keys) {
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<int64_t>("X", {3}, {3LL, 1LL << 40, -1LL});
+  test.AddAttribute<int64_t>("seed", 0LL);
+  test.AddOutput<uint32_t>("Y", {3}, {2738575283UL, 2851483426UL, 1651860712UL});
+  test.Run();
+}
+
+TEST(MurmurHash3OpTest, Buckets) {
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("X", {2}, {3L, 4L});
+  test.AddAttribute<int64_t>("positive", 0);
+  test.AddAttribute<int64_t>("num_buckets", 1000);
+  test.AddOutput<int32_t>("Y", {2}, {505L, 975L});
+  test.Run();
+}
+
+TEST(MurmurHash3OpTest, StringKeyBuckets) {
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<std::string>("X", {1}, {"foo"});
+  test.AddAttribute<int64_t>("num_buckets", 100);
+  test.AddOutput<uint32_t>("Y", {1}, {84UL});
+  test.Run();
+}
+
+// large enough to be split across the threads
+TEST(MurmurHash3OpTest, ManyKeys) {
+  const size_t count = 1 << 16;
+  std::vector<int32_t> keys(count, 3);
+  keys[count - 1] = 4;
+  std::vector<uint32_t> hashes(count, 847579505UL);
+  hashes[count - 1] = 1889779975UL;
+
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("X", {static_cast<int64_t>(count)}, keys);
+  test.AddOutput<uint32_t>("Y", {static_cast<int64_t>(count)}, hashes);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A 3x3 image with 2 channels, where the second channel is 10 times the first.
+static const std::vector<float> nhwc_pool_input{0.0f, 0.0f, 1.0f, 10.0f, 2.0f, 20.0f,
+                                                3.0f, 30.0f, 4.0f, 40.0f, 5.0f, 50.0f,
+                                                6.0f, 60.0f, 7.0f, 70.0f, 8.0f, 80.0f};
+
+TEST(ContribOpTest, NhwcMaxPool) {
+  OpTester test("NhwcMaxPool", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  test.AddInput<float>("X", {1, 3, 3, 2}, nhwc_pool_input);
+  test.AddOutput<float>("Y", {1, 2, 2, 2}, {4.0f, 40.0f, 5.0f, 50.0f, 7.0f, 70.0f, 8.0f, 80.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, NhwcAveragePool_Pads) {
+  OpTester test("NhwcAveragePool", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  test.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+  test.AddInput<float>("X", {1, 3, 3, 2}, nhwc_pool_input);
+  test.AddOutput<float>("Y", {1, 2, 2, 2}, {0.0f, 0.0f, 1.5f, 15.0f, 4.5f, 45.0f, 6.0f, 60.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, NhwcGlobalAveragePool) {
+  OpTester test("NhwcGlobalAveragePool", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {1, 3, 3, 2}, nhwc_pool_input);
+  test.AddOutput<float>("Y", {1, 1, 1, 2}, {4.0f, 40.0f});
+  test.Run();
+}
+
+TEST(ContribOpTest, NhwcGlobalMaxPool) {
+  OpTester test("NhwcGlobalMaxPool", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {1, 3, 3, 2}, nhwc_pool_input);
+  test.AddOutput<float>("Y", {1, 1, 1, 2}, {8.0f, 80.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -165,5 +165,37 @@ TEST(QuantizeLinearContribOpTest, QuantizeLinear_2) {
                            0, 1, 1, 250});
   test.Run();
 }
+TEST(QLinearAddContribOpTest, QLinearAdd) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  std::vector<int64_t> dims{2, 2};
+  // A = {0, 1, 2, 6}, B = {2.5, 5, 7.5, 10}
+  test.AddInput<uint8_t>("A", dims, {128, 130, 132, 140});
+  test.AddInput<float>("A_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("A_zero_point", {}, {128});
+  test.AddInput<uint8_t>("B", dims, {10, 20, 30, 40});
+  test.AddInput<float>("B_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("B_zero_point", {}, {0});
+  test.AddInput<float>("C_scale", {}, {0.1f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {10});
+  test.AddOutput<uint8_t>("C", dims, {35, 70, 105, 170});
+  test.Run();
+}
+
+// a broadcast scalar, with the results out of the range of uint8 saturated
+TEST(QLinearAddContribOpTest, QLinearAdd_Broadcast) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  // A = {-40, 160, 470}, B = 10
+  test.AddInput<uint8_t>("A", {3}, {0, 100, 255});
+  test.AddInput<float>("A_scale", {}, {2.0f});
+  test.AddInput<uint8_t>("A_zero_point", {}, {20});
+  test.AddInput<uint8_t>("B", {1}, {10});
+  test.AddInput<float>("B_scale", {}, {1.0f});
+  test.AddInput<uint8_t>("B_zero_point", {}, {0});
+  test.AddInput<float>("C_scale", {}, {1.0f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {0});
+  test.AddOutput<uint8_t>("C", {3}, {0, 170, 255});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// The sparse tensor of shape dims holding values at indices, which are either linear or coordinates.
+static SparseTensorProto CreateSparseTensor(const std::vector<int64_t>& dims, const std::vector<float>& values,
+                                            const std::vector<int64_t>& indices) {
+  SparseTensorProto sparse_tensor;
+  for (auto dim : dims) {
+    sparse_tensor.add_dims(dim);
+  }
+
+  auto& values_tensor = *sparse_tensor.mutable_values();
+  values_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  values_tensor.add_dims(static_cast<int64_t>(values.size()));
+  for (auto value : values) {
+    values_tensor.add_float_data(value);
+  }
+
+  auto& indices_tensor = *sparse_tensor.mutable_indices();
+  indices_tensor.set_data_type(TensorProto_DataType_INT64);
+  indices_tensor.add_dims(static_cast<int64_t>(values.size()));
+  if (indices.size() != values.size()) {
+    indices_tensor.add_dims(2);
+  }
+  for (auto index : indices) {
+    indices_tensor.add_int64_data(index);
+  }
+  return sparse_tensor;
+}
+
+TEST(SparseMatMulTest, CoordinateIndices) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  // B = [[0, 2, 0],
+  //      [1, 0, 0],
+  //      [0, 0, 0],
+  //      [0, 3, 4]], with its nonzeros out of order
+  test.AddAttribute("B", CreateSparseTensor({4, 3}, {4.f, 2.f, 1.f, 3.f}, {3, 2, 0, 1, 1, 0, 3, 1}));
+
+  test.AddInput<float>("A", {2, 1, 4}, {1.f, 2.f, 3.f, 4.f,
+                                        0.f, -1.f, 5.f, 1.f});
+  test.AddOutput<float>("Y", {2, 1, 3}, {2.f, 14.f, 16.f,
+                                         -1.f, 3.f, 4.f});
+  test.Run();
+}
+
+TEST(SparseMatMulTest, LinearIndicesWithBias) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  // B = [[1, 0],
+  //      [0, 0],
+  //      [0, 2]]
+  test.AddAttribute("B", CreateSparseTensor({3, 2}, {1.f, 2.f}, {0, 5}));
+  test.AddAttribute("alpha", 2.f);
+  test.AddAttribute("beta", 0.5f);
+
+  test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f,
+                                     4.f, 5.f, 6.f});
+  test.AddInput<float>("C", {2}, {10.f, 20.f});
+  test.AddOutput<float>("Y", {2, 2}, {7.f, 22.f,
+                                      13.f, 34.f});
+  test.Run();
+}
+
+TEST(SparseMatMulTest, InvalidInputShape) {
+  OpTester test("SparseMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("B", CreateSparseTensor({3, 2}, {1.f, 2.f}, {0, 5}));
+
+  test.AddInput<float>("A", {1, 2}, {1.f, 2.f});
+  test.AddOutput<float>("Y", {1, 2}, {0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The last dimension of A must");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -43,5 +43,44 @@ TEST(UniqueOpTest, Unique_AllUniqueElements) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+TEST(UniqueOpTest, Unique_Int64) {
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<int64_t>("x", {6}, {20, 10, 10, 30, 40, 30});
+  test.AddOutput<int64_t>("uniques", {4}, {20, 10, 30, 40});
+  test.AddOutput<int64_t>("idx", {6}, {0, 1, 1, 2, 3, 2});
+  test.AddOutput<int64_t>("counts", {4}, {1, 2, 2, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(UniqueOpTest, Unique_Sorted) {
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("sorted", 1);
+  test.AddInput<float>("x", {6}, {2.0, 1.0, 1.0, 3.0, 4.0, 3.0});
+  test.AddOutput<float>("uniques", {4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddOutput<int64_t>("idx", {6}, {1, 0, 0, 2, 3, 2});
+  test.AddOutput<int64_t>("counts", {4}, {2, 1, 2, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// large enough to be split across the threads
+TEST(UniqueOpTest, Unique_LargeInput) {
+  const int64_t num_uniques = 1000;
+  const int64_t repeats = 128;
+  std::vector<int32_t> x(num_uniques * repeats);
+  std::vector<int64_t> idx(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    // 7919 is coprime with 1000, so the first 1000 elements are all different
+    x[i] = static_cast<int32_t>((i * 7919) % num_uniques);
+    idx[i] = static_cast<int64_t>(i % num_uniques);
+  }
+
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("x", {static_cast<int64_t>(x.size())}, x);
+  test.AddOutput<int32_t>("uniques", {num_uniques}, std::vector<int32_t>(x.begin(), x.begin() + num_uniques));
+  test.AddOutput<int64_t>("idx", {static_cast<int64_t>(idx.size())}, idx);
+  test.AddOutput<int64_t>("counts", {num_uniques}, std::vector<int64_t>(num_uniques, repeats));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
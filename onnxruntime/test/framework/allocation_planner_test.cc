@@ -245,6 +245,18 @@ class PlannerTest : public ::testing::Test {
     AllocationPlanTestUtility::BasicIntegrityCheck(*plan_, name_to_arg_.size());
   }
 
+  Status CreateStaticMemoryPattern(std::unique_ptr<MemoryPatternGroup>& mem_patterns) {
+    SequentialPlannerTestContext test_context(&shape_map_);
+    return SequentialPlanner::CreateStaticMemoryPattern(GraphViewer(graph_), *plan_, state_.GetOrtValueNameIdxMap(),
+                                                        test_context, mem_patterns);
+  }
+
+  int Index(const std::string& name) {
+    int id = -1;
+    index(name, id);
+    return id;
+  }
+
   void CheckAllocKind(const std::string& name, AllocKind kind) {
     int id;
     index(name, id);
@@ -441,5 +453,82 @@ TEST_F(PlannerTest, PlanOutputTest) {
   }
 }
 
+TEST_F(PlannerTest, StaticMemoryPatternTest) {
+  // tensor variables:
+  std::string X("X"), A("A"), B("B"), C("C"), D("D"), Z("Z");
+
+  AddNormalNode(X, A);
+  AddNormalNode(A, B);
+  AddNormalNode(B, C);
+  AddNormalNode(C, D);
+  AddNormalNode(D, Z);
+
+  // simulate shape-inference results. all sizes differ so no buffer is reused by the plan itself.
+  Shape shape_x{8}, shape_a{10}, shape_b{20}, shape_c{5}, shape_d{30}, shape_z{8};
+  SetShape({{X, &shape_x.value}, {A, &shape_a.value}, {B, &shape_b.value},
+            {C, &shape_c.value}, {D, &shape_d.value}, {Z, &shape_z.value}});
+
+  CreatePlan();
+  CheckAllocKind(A, AllocKind::kAllocate);
+  CheckAllocKind(B, AllocKind::kAllocate);
+  CheckAllocKind(C, AllocKind::kAllocate);
+  CheckAllocKind(D, AllocKind::kAllocate);
+
+  std::unique_ptr<MemoryPatternGroup> mem_patterns;
+  auto status = CreateStaticMemoryPattern(mem_patterns);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(mem_patterns, nullptr);
+  ASSERT_EQ(mem_patterns->patterns.size(), 1);
+
+  // each allocation is 64-byte aligned: A and C take 64 bytes, B and D 128.
+  // B and D don't overlap so share offset 0, A and C don't overlap either and are placed after them.
+  const auto& pattern = mem_patterns->patterns[0];
+  EXPECT_EQ(pattern.PeakSize(), 128 + 64);
+  EXPECT_EQ(pattern.GetBlock(Index(B))->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(Index(D))->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(Index(A))->offset_, 128);
+  EXPECT_EQ(pattern.GetBlock(Index(C))->offset_, 128);
+  // graph outputs are not part of the pattern
+  EXPECT_EQ(pattern.GetBlock(Index(Z)), nullptr);
+}
+
+TEST_F(PlannerTest, StaticMemoryPatternUnknownShapeTest) {
+  std::string X("X"), A("A"), B("B"), Z("Z");
+
+  AddNormalNode(X, A);
+  AddNormalNode(A, B);
+  AddNormalNode(B, Z);
+
+  // no shape for B
+  Shape shape1{50, 100};
+  SetShape({{X, &shape1.value}, {A, &shape1.value}, {Z, &shape1.value}});
+
+  CreatePlan();
+
+  std::unique_ptr<MemoryPatternGroup> mem_patterns;
+  auto status = CreateStaticMemoryPattern(mem_patterns);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(mem_patterns, nullptr);
+}
+
+TEST_F(PlannerTest, CopyToDeviceHoistedTest) {
+  std::string X("X"), A("A"), B("B"), C("C"), D("D");
+  auto copy_kernel =
+      KernelDefBuilder().SetName("MemcpyFromHost").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+
+  auto* producer = AddNormalNode(X, A);
+  AddNormalNode(A, B);
+  AddNormalNode(B, C);
+  auto* copy = AddNode(*copy_kernel, A, D);
+
+  CreatePlan();
+
+  // the copy runs right after the node producing its input, ahead of the nodes before its users
+  const auto& execution_plan = GetPlan().execution_plan;
+  ASSERT_EQ(execution_plan.size(), 4);
+  EXPECT_EQ(execution_plan[0].node_index, producer->Index());
+  EXPECT_EQ(execution_plan[1].node_index, copy->Index());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
+#include "core/framework/huge_page_allocator.h"
 #include "test_utils.h"
 #include "gtest/gtest.h"
 
@@ -26,6 +27,21 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   //todo: test the used / max api.
 }
 
+TEST(AllocatorTest, HugePageCPUAllocatorTest) {
+  HugePageCPUAllocator allocator;
+
+  // large allocations use huge pages where the platform has them, small ones the regular CPU allocation
+  for (size_t size : {size_t{1024}, HugePageCPUAllocator::kMinHugePageAllocation + 1}) {
+    auto* bytes = static_cast<char*>(allocator.Alloc(size));
+    ASSERT_NE(bytes, nullptr);
+    memset(bytes, -1, size);
+    EXPECT_EQ(bytes[size - 1], -1);
+    allocator.Free(bytes);
+  }
+
+  allocator.Free(nullptr);
+}
+
 // helper class to validate values in Alloc and Free calls made via IAllocator::MakeUniquePtr
 class TestAllocator : public IAllocator {
  public:
@@ -4,6 +4,7 @@
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +235,230 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, ShrinkFreesUnusedRegions) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  // The first region is 1MiB, so this forces a second, larger region.
+  void* small_ptr = a.Alloc(1024);
+  void* large_ptr = a.Alloc(1 << 22);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (1 << 20) + (1 << 22));
+
+  // The region holding small_ptr is still in use.
+  a.Free(large_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+
+  a.Free(small_ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // The arena grows again from the initial region size.
+  void* ptr = a.Alloc(1024);
+  EXPECT_NE(nullptr, ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  a.Free(ptr);
+}
+
+TEST(BFCArenaTest, ProcessMemoryLimit) {
+  // The limit is shared by all the arenas of the device.
+  BFCArena::SetProcessMemoryLimit(OrtDevice(), 3 << 20);
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  BFCArena b(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+
+  void* a_ptr = a.Alloc(2 << 20);
+  EXPECT_NE(nullptr, a_ptr);
+  EXPECT_EQ(nullptr, b.Alloc(2 << 20));
+  void* b_ptr = b.Alloc(1024);
+  EXPECT_NE(nullptr, b_ptr);
+  b.Free(b_ptr);
+  ASSERT_TRUE(b.Shrink().IsOK());
+
+  // The region of a is unused once freed, so a gives it back to fit the larger region.
+  a.Free(a_ptr);
+  a_ptr = a.Alloc((2 << 20) + (1 << 19));
+  EXPECT_NE(nullptr, a_ptr);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, (2 << 20) + (1 << 19));
+  a.Free(a_ptr);
+
+  BFCArena::SetProcessMemoryLimit(OrtDevice(), 0);
+}
+
+TEST(BFCArenaTest, TestInitialChunkSize) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kNextPowerOfTwo, 4096);
+
+  void* first_ptr = a.Alloc(1024);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096);
+
+  // The next region doubles in size.
+  void* second_ptr = a.Alloc(4096);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096 + 8192);
+
+  a.Free(first_ptr);
+  a.Free(second_ptr);
+}
+
+TEST(BFCArenaTest, TestExtendSameAsRequested) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+             ArenaExtendStrategy::kSameAsRequested, 4096);
+
+  std::vector<void*> ptrs;
+  ptrs.push_back(a.Alloc(1024));
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096);
+
+  // Regions grow by the requested size, never by more...
+  ptrs.push_back(a.Alloc(10000));
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096 + 10240);
+
+  // ...but at least by the initial chunk size.
+  ptrs.push_back(a.Alloc(3072));
+  ptrs.push_back(a.Alloc(1024));
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4096 + 10240 + 4096);
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+}
+
+static ArenaThreadCacheConfig ThreadCacheConfig(size_t high_water_mark) {
+  ArenaThreadCacheConfig config;
+  config.enable = true;
+  config.max_cached_chunk_size = 4096;
+  config.high_water_mark = high_water_mark;
+  return config;
+}
+
+TEST(BFCArenaTest, ThreadCacheReusesFreedChunk) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             kDefaultArenaInitialChunkSizeBytes, ThreadCacheConfig(1 << 20));
+
+  void* first_ptr = a.Alloc(1024);
+  a.Free(first_ptr);
+  // The freed chunk is parked in the thread cache and reported as free.
+  CheckStats(&a, 1, 0, 1024, 1024);
+
+  void* second_ptr = a.Alloc(1000);
+  EXPECT_EQ(first_ptr, second_ptr);
+  CheckStats(&a, 2, 1024, 1024, 1024);
+  a.Free(second_ptr);
+
+  // Larger allocations bypass the cache.
+  void* large_ptr = a.Alloc(8192);
+  EXPECT_NE(nullptr, large_ptr);
+  a.Free(large_ptr);
+  CheckStats(&a, 3, 0, 9216, 8192);
+}
+
+TEST(BFCArenaTest, ThreadCacheDrainsAtHighWaterMark) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             kDefaultArenaInitialChunkSizeBytes, ThreadCacheConfig(4096));
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; i++) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // Draining returns the chunks to the bins where they coalesce again,
+  // so a large allocation fits into the memory they used.
+  std::sort(ptrs.begin(), ptrs.end());
+  char* large_ptr = static_cast<char*>(a.Alloc(32 * 1024));
+  EXPECT_GE(large_ptr, static_cast<char*>(ptrs.front()));
+  EXPECT_LE(large_ptr + 32 * 1024, static_cast<char*>(ptrs.back()) + 1024);
+  a.Free(large_ptr);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheFreeFromOtherThread) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             kDefaultArenaInitialChunkSizeBytes, ThreadCacheConfig(1 << 20));
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; i++) {
+    ptrs.push_back(a.Alloc(512));
+  }
+
+  std::thread other([&a, &ptrs]() {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  });
+  other.join();
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // The chunks went back to the bins, so they can be re-used by anybody.
+  void* ptr = a.Alloc(512 * 16);
+  EXPECT_EQ(ptrs[0], ptr);
+  a.Free(ptr);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             kDefaultArenaInitialChunkSizeBytes, ThreadCacheConfig(16 * 1024));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&a, t]() {
+      std::vector<void*> ptrs;
+      for (int i = 0; i < 1000; i++) {
+        ptrs.push_back(a.Alloc(static_cast<size_t>(((i + t) % 16 + 1) * 256)));
+        if (ptrs.size() == 8) {
+          for (void* p : ptrs) {
+            a.Free(p);
+          }
+          ptrs.clear();
+        }
+      }
+      for (void* p : ptrs) {
+        a.Free(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, 8000);
+}
+
+TEST(BFCArenaTest, ShrinkDrainsThreadCache) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             kDefaultArenaInitialChunkSizeBytes, ThreadCacheConfig(1 << 20));
+
+  void* ptr = a.Alloc(1024);
+  a.Free(ptr);
+  ASSERT_TRUE(a.Shrink().IsOK());
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
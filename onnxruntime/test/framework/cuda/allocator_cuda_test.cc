@@ -6,6 +6,7 @@
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_caching_allocator.h"
 
 namespace onnxruntime {
 namespace test {
@@ -67,5 +68,48 @@ TEST(AllocatorTest, CUDAAllocatorTest) {
   cuda_arena->Free(cuda_addr);
   pinned_allocator->Free(pinned_addr);
 }
+
+TEST(AllocatorTest, CUDACachingAllocatorTest) {
+  EXPECT_EQ(CUDACachingAllocator::RoundSize(1), 512u);
+  EXPECT_EQ(CUDACachingAllocator::RoundSize(1000), 1024u);
+  EXPECT_EQ(CUDACachingAllocator::RoundSize(1 << 20), 1u << 20);
+  EXPECT_EQ(CUDACachingAllocator::RoundSize((1 << 20) + 1), (1u << 20) + (1u << 17));
+  EXPECT_EQ(CUDACachingAllocator::RoundSize(3 << 20), 3u << 20);
+
+  CUDACachingAllocator allocator(0, CUDA);
+  EXPECT_STREQ(allocator.Info().name, CUDA);
+  EXPECT_EQ(allocator.Info().mem_type, OrtMemTypeDefault);
+  EXPECT_EQ(allocator.Info().type, OrtArenaAllocator);
+
+  // a block freed is reused by the next allocation of its size class
+  void* a = allocator.Alloc(1000);
+  EXPECT_TRUE(a);
+  EXPECT_EQ(allocator.Used(), 1024u);
+  allocator.Free(a);
+  EXPECT_EQ(allocator.Used(), 0u);
+  EXPECT_EQ(allocator.Cached(), 1024u);
+  void* b = allocator.Alloc(900);
+  EXPECT_EQ(b, a);
+  EXPECT_EQ(allocator.Cached(), 0u);
+
+  // but not by a much smaller one
+  allocator.Free(b);
+  void* c = allocator.Alloc(100);
+  EXPECT_NE(c, a);
+  allocator.Free(c);
+  EXPECT_EQ(allocator.Cached(), 1536u);
+
+  // the least recently freed blocks are given back first
+  EXPECT_EQ(allocator.Trim(512), 1024u);
+  EXPECT_EQ(allocator.Cached(), 512u);
+  EXPECT_TRUE(allocator.Shrink().IsOK());
+  EXPECT_EQ(allocator.Cached(), 0u);
+
+  // a reservation isn't cached
+  void* reserved = allocator.Reserve(1000);
+  EXPECT_TRUE(reserved);
+  allocator.Free(reserved);
+  EXPECT_EQ(allocator.Cached(), 0u);
+}
 }  // namespace test
 }  // namespace onnxruntime
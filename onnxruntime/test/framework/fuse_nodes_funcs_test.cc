@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/fuse_nodes_funcs.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// functions counting the states they create and release
+NodeComputeInfo CountingComputeInfo(int& num_states) {
+  NodeComputeInfo info;
+  info.create_state_func = [&num_states](ComputeContext*, FunctionState* state) {
+    ++num_states;
+    *state = &num_states;
+    return 0;
+  };
+  info.compute_func = [](FunctionState, const OrtCustomOpApi*, OrtKernelContext*) { return Status::OK(); };
+  info.release_state_func = [&num_states](FunctionState) { --num_states; };
+  return info;
+}
+}  // namespace
+
+TEST(CompiledFuncCacheTest, SharedBySessions) {
+  auto& cache = CompiledFuncCache::Instance();
+  const std::string key = "CompiledFuncCacheTest;SharedBySessions";
+  EXPECT_EQ(cache.Get(key), nullptr);
+
+  int num_states = 0;
+  const size_t size = cache.Size();
+  auto compiled = cache.Insert(key, CountingComputeInfo(num_states));
+  ASSERT_NE(compiled, nullptr);
+  EXPECT_EQ(cache.Size(), size + 1);
+
+  // a second session compiling the same subgraph meanwhile gets the cached functions
+  int other_num_states = 0;
+  EXPECT_EQ(cache.Insert(key, CountingComputeInfo(other_num_states)), compiled);
+
+  {
+    FuncManager session_funcs;
+    ASSERT_TRUE(session_funcs.AddFuncInfo("fused_node", compiled).IsOK());
+    compiled = nullptr;
+
+    FuncManager other_session_funcs;
+    auto cached = cache.Get(key);
+    ASSERT_NE(cached, nullptr);
+    ASSERT_TRUE(other_session_funcs.AddFuncInfo("other_fused_node", std::move(cached)).IsOK());
+
+    ComputeFunc compute;
+    CreateFunctionStateFunc create;
+    DestroyFunctionStateFunc release;
+    ASSERT_TRUE(other_session_funcs.GetFuncs("other_fused_node", &compute, &create, &release).IsOK());
+    FunctionState state = nullptr;
+    EXPECT_EQ(create(nullptr, &state), 0);
+    EXPECT_EQ(num_states, 1);
+    EXPECT_TRUE(compute(state, nullptr, nullptr).IsOK());
+    release(state);
+    EXPECT_EQ(num_states, 0);
+    EXPECT_EQ(other_num_states, 0);
+  }
+
+  // the entry goes once no session uses it
+  EXPECT_EQ(cache.Get(key), nullptr);
+  EXPECT_EQ(cache.Size(), size);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
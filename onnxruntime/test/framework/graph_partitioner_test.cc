@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/compute_capability.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr const char* kMockDeviceExecutionProvider = "MockDeviceExecutionProvider";
+
+// A provider of device memory with kernels for Add, Relu and Mul, which leaves the Relu nodes to the CPU like CUDA
+// leaves the nodes whose inputs come from the CPU, though it can run them.
+class MockDeviceExecutionProvider : public IExecutionProvider {
+ public:
+  MockDeviceExecutionProvider() : IExecutionProvider{kMockDeviceExecutionProvider} {
+    InsertAllocator(std::make_shared<CPUAllocator>(std::make_unique<OrtMemoryInfo>(
+        "MockDevice", OrtAllocatorType::OrtDeviceAllocator, OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0))));
+  }
+
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const GraphViewer& graph_viewer,
+                const std::vector<const KernelRegistry*>& kernel_registries) const override {
+    auto capabilities = IExecutionProvider::GetCapability(graph_viewer, kernel_registries);
+    capabilities.erase(std::remove_if(capabilities.begin(), capabilities.end(),
+                                      [&](const std::unique_ptr<ComputeCapability>& capability) {
+                                        const auto* node = graph_viewer.GetNode(capability->sub_graph->nodes[0]);
+                                        return node->OpType() == "Relu";
+                                      }),
+                       capabilities.end());
+    return capabilities;
+  }
+
+  bool CanRunNode(const Node& node) const override {
+    return GetKernelRegistry()->TryFindKernel(node, Type()) != nullptr;
+  }
+
+  std::shared_ptr<KernelRegistry> GetKernelRegistry() const override {
+    static std::shared_ptr<KernelRegistry> kernel_registry = CreateKernelRegistry();
+    return kernel_registry;
+  }
+
+ private:
+  static std::shared_ptr<KernelRegistry> CreateKernelRegistry() {
+    auto kernel_registry = std::make_shared<KernelRegistry>();
+    // the kernels are never created, the partitioner only looks them up
+    for (const auto& op : std::vector<std::pair<std::string, int>>{{"Add", 7}, {"Relu", 6}, {"Mul", 7}}) {
+      KernelDefBuilder builder;
+      builder.SetName(op.first)
+          .SetDomain(kOnnxDomain)
+          .SinceVersion(op.second)
+          .Provider(kMockDeviceExecutionProvider)
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<float>());
+      ORT_ENFORCE(kernel_registry->Register(builder, [](const OpKernelInfo&) -> OpKernel* { return nullptr; }).IsOK());
+    }
+    return kernel_registry;
+  }
+};
+
+// Partitions Y = Relu(X + X) * Relu(X + X) of float tensors of the shape between the mock device and the CPU,
+// and returns the providers the Add, Relu and Mul nodes are assigned to.
+std::vector<std::string> Partition(const std::vector<int64_t>& shape, const PartitioningCostModel* cost_model) {
+  Model model("GraphPartitionerTest", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 7}});
+  Graph& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (const auto dim : shape) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &type);
+  auto& relu = graph.GetOrCreateNodeArg("relu", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+  auto& add_node = graph.AddNode("add", "Add", "", {&x, &x}, {&sum});
+  auto& relu_node = graph.AddNode("relu", "Relu", "", {&sum}, {&relu});
+  auto& mul_node = graph.AddNode("mul", "Mul", "", {&relu, &relu}, {&y});
+  ORT_ENFORCE(graph.Resolve().IsOK());
+
+  ExecutionProviders providers;
+  ORT_ENFORCE(providers.Add(kMockDeviceExecutionProvider, std::make_unique<MockDeviceExecutionProvider>()).IsOK());
+  ORT_ENFORCE(providers.Add(kCpuExecutionProvider,
+                            std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{false}))
+                  .IsOK());
+  KernelRegistryManager krm;
+  ORT_ENFORCE(krm.RegisterKernels(providers).IsOK());
+
+  GraphPartitioner partitioner(krm, providers, cost_model);
+  FuncManager func_mgr;
+  ORT_ENFORCE(partitioner.Partition(graph, false, func_mgr).IsOK());
+
+  return {add_node.GetExecutionProviderType(), relu_node.GetExecutionProviderType(),
+          mul_node.GetExecutionProviderType()};
+}
+}  // namespace
+
+TEST(GraphPartitionerTest, WithoutCostModel) {
+  const std::vector<std::string> expected{kMockDeviceExecutionProvider, kCpuExecutionProvider,
+                                          kMockDeviceExecutionProvider};
+  EXPECT_EQ(Partition({1024, 1024}, nullptr), expected);
+}
+
+TEST(GraphPartitionerTest, KeepCpuIslandOnDevice) {
+  // copying the Relu input and output costs more than the device saves computing it on the CPU, so it joins the
+  // Add and Mul nodes on the device, which save more computing than copying the graph input and output costs.
+  PartitioningCostModel cost_model;
+  const std::vector<std::string> expected(3, kMockDeviceExecutionProvider);
+  EXPECT_EQ(Partition({1024, 1024}, &cost_model), expected);
+}
+
+TEST(GraphPartitionerTest, MoveSmallDeviceIslandToCpu) {
+  // the copies of a few elements cost more than their compute, so the whole graph runs on the CPU
+  PartitioningCostModel cost_model;
+  const std::vector<std::string> expected(3, kCpuExecutionProvider);
+  EXPECT_EQ(Partition({2, 2}, &cost_model), expected);
+
+  // unless the copies are free
+  cost_model.copy_latency = 0;
+  cost_model.copy_cost_per_byte = 0;
+  const std::vector<std::string> expected_on_device(3, kMockDeviceExecutionProvider);
+  EXPECT_EQ(Partition({2, 2}, &cost_model), expected_on_device);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,14 +5,18 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cstdio>
 #include <functional>
 #include <iterator>
 #include <thread>
 #include <fstream>
+#include <future>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/logging/logging.h"
+#include "core/common/metrics.h"
 #include "core/common/profiler.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
@@ -24,12 +28,17 @@
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "core/platform/env.h"
+#include "core/platform/hardware_counters.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
 #include "core/session/IOBinding.h"
+#include "core/session/multi_device_session.h"
+#include "core/session/pipeline_parallel_session.h"
+#include "core/session/quantization.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -45,6 +54,8 @@ using namespace ONNX_NAMESPACE;
 using namespace onnxruntime::logging;
 
 namespace onnxruntime {
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
+
 class FuseAdd : public OpKernel {
  public:
   FuseAdd(const OpKernelInfo& info) : OpKernel(info) {}
@@ -125,9 +136,21 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
                                            logging::LoggingManager* logging_manager) : InferenceSession(session_options, logging_manager) {
   }
 
+  InferenceSessionGetGraphWrapper(const SessionOptions& session_options,
+                                  logging::LoggingManager* logging_manager,
+                                  concurrency::ThreadPool* external_intra_op_thread_pool,
+                                  concurrency::ThreadPool* external_inter_op_thread_pool)
+      : InferenceSession(session_options, logging_manager,
+                         external_intra_op_thread_pool, external_inter_op_thread_pool) {
+  }
+
   const Graph& GetGraph() {
     return model_->MainGraph();
   }
+
+  const SessionState& GetSessionState() {
+    return session_state_;
+  }
 };
 
 namespace test {
@@ -137,6 +160,29 @@ static const std::string MODEL_URI = "testdata/mul_1.onnx";
 static const std::string MODEL_URI_NO_OPSET = "testdata/mul_1.noopset.onnx";
 //static const std::string MODEL_URI = "./testdata/squeezenet/model.onnx"; // TODO enable this after we've weights?
 
+// Loads the model built in code into a session with the options, registering the execution provider first if given,
+// and initializes it. Returns nullptr if that failed.
+static std::unique_ptr<InferenceSessionGetGraphWrapper> LoadModel(
+    Model& model, const SessionOptions& so, std::unique_ptr<IExecutionProvider> execution_provider = nullptr) {
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+  std::stringstream sstr(serialized_model);
+
+  auto session_object = std::make_unique<InferenceSessionGetGraphWrapper>(so, &DefaultLoggingManager());
+  Status st;
+  if (execution_provider != nullptr) {
+    st = session_object->RegisterExecutionProvider(std::move(execution_provider));
+  }
+  if (st.IsOK()) {
+    st = session_object->Load(sstr);
+  }
+  if (st.IsOK()) {
+    st = session_object->Initialize();
+  }
+  EXPECT_TRUE(st.IsOK()) << st.ErrorMessage();
+  return st.IsOK() ? std::move(session_object) : nullptr;
+}
+
 static void CreateMatMulModel(std::unique_ptr<onnxruntime::Model>& p_model, ProviderType provider_type) {
   std::unordered_map<std::string, int> domain_to_version;
   domain_to_version[onnxruntime::kOnnxDomain] = 7;
@@ -355,6 +401,927 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, LowLatencyThreading) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.LowLatencyThreading";
+  so.session_thread_pool_size = 2;
+  so.enable_low_latency_threading = true;
+  so.thread_pool_spin_duration_us = 100;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "one session/one tag";
+  for (int i = 0; i < 10; ++i) {
+    RunModel(session_object, run_options);
+  }
+}
+
+TEST(InferenceSessionTests, RunStateCache) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunStateCache";
+  so.enable_run_state_cache = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the later Runs reuse the state of the first one. an empty run tag also uses the session logger.
+  RunOptions run_options;
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  run_options.run_tag = "one session/one tag";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, ThreadPoolReplicas) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ThreadPoolReplicas";
+  so.session_thread_pool_size = 2;
+  so.num_thread_pool_replicas = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the concurrent Runs are spread over both replicas
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&session_object]() {
+      RunOptions run_options;
+      run_options.run_tag = "one session/one tag";
+      for (int j = 0; j < 10; ++j) {
+        RunModel(session_object, run_options);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(InferenceSessionTests, PipelineStages) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.PipelineStages";
+  so.session_thread_pool_size = 1;
+  so.num_thread_pool_replicas = 2;
+  so.num_pipeline_stages = 3;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the concurrent Runs flow through the stages, some of which have no nodes of this model
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&session_object]() {
+      RunOptions run_options;
+      run_options.run_tag = "one session/one tag";
+      for (int j = 0; j < 10; ++j) {
+        RunModel(session_object, run_options);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// the element-wise kernels write their outputs into the buffers of inputs that are used for the last time
+TEST(InferenceSessionTests, InPlaceElementwiseKernels) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_2x3;
+  tensor_2x3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto tensor_3;
+  tensor_3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // Y = Neg(Abs(B + Neg(X))), where B is broadcast so the Add reuses its second input
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_2x3);
+  auto& b = graph.GetOrCreateNodeArg("B", &tensor_3);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_2x3);
+  auto& c = graph.GetOrCreateNodeArg("C", &tensor_2x3);
+  auto& d = graph.GetOrCreateNodeArg("D", &tensor_2x3);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_2x3);
+  graph.AddNode("neg_x", "Neg", "", {&x}, {&a});
+  graph.AddNode("add", "Add", "", {&b, &a}, {&c});
+  graph.AddNode("abs", "Abs", "", {&c}, {&d});
+  graph.AddNode("neg_d", "Neg", "", {&d}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InPlaceElementwiseKernels";
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  const auto& session_state = session_object->GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int a_index, c_index, d_index;
+  ASSERT_TRUE(name_idx_map.GetIdx("A", a_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("C", c_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("D", d_index).IsOK());
+  for (int index : {c_index, d_index}) {
+    EXPECT_EQ(allocation_plan[index].alloc_kind, AllocKind::kReuse);
+    EXPECT_EQ(allocation_plan[index].reused_buffer, a_index);
+  }
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value, b_value;
+  CreateMLValue<float>(allocator, {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x_value);
+  CreateMLValue<float>(allocator, {3}, {1.0f, 2.0f, 3.0f}, &b_value);
+  NameMLValMap feeds{{"X", x_value}, {"B", b_value}};
+
+  std::vector<OrtValue> fetches;
+  auto st = session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {2, 3}, {0.0f, 0.0f, 0.0f, -3.0f, -3.0f, -3.0f});
+}
+
+TEST(InferenceSessionTests, ConcatInputsWrittenInPlace) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  auto make_type = [](int64_t columns) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(columns);
+    return type;
+  };
+  TypeProto tensor_1x2 = make_type(2), tensor_1x3 = make_type(3), tensor_1x5 = make_type(5);
+
+  // Y = Neg(Concat(Neg(X), Abs(W))), where Neg and Abs write their outputs into the output of the Concat
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_1x2);
+  auto& w = graph.GetOrCreateNodeArg("W", &tensor_1x3);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_1x2);
+  auto& b = graph.GetOrCreateNodeArg("B", &tensor_1x3);
+  auto& c = graph.GetOrCreateNodeArg("C", &tensor_1x5);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_1x5);
+  graph.AddNode("neg_x", "Neg", "", {&x}, {&a});
+  graph.AddNode("abs_w", "Abs", "", {&w}, {&b});
+  graph.AddNode("concat", "Concat", "", {&a, &b}, {&c}).AddAttribute("axis", int64_t{1});
+  graph.AddNode("neg_c", "Neg", "", {&c}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ConcatInputsWrittenInPlace";
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  const auto& session_state = session_object->GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int a_index, b_index, c_index;
+  ASSERT_TRUE(name_idx_map.GetIdx("A", a_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("B", b_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("C", c_index).IsOK());
+  EXPECT_EQ(allocation_plan[c_index].alloc_kind, AllocKind::kAllocate);
+  for (int index : {a_index, b_index}) {
+    EXPECT_EQ(allocation_plan[index].alloc_kind, AllocKind::kSubTensor);
+    EXPECT_EQ(allocation_plan[index].reused_buffer, c_index);
+  }
+  EXPECT_EQ(allocation_plan[a_index].sub_tensor_offset, size_t{0});
+  EXPECT_EQ(allocation_plan[b_index].sub_tensor_offset, 2 * sizeof(float));
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value, w_value;
+  CreateMLValue<float>(allocator, {1, 2}, {1.0f, -2.0f}, &x_value);
+  CreateMLValue<float>(allocator, {1, 3}, {3.0f, -4.0f, 5.0f}, &w_value);
+  NameMLValMap feeds{{"X", x_value}, {"W", w_value}};
+
+  // the second run allocates from the memory pattern of the first
+  for (int i = 0; i < 2; ++i) {
+    std::vector<OrtValue> fetches;
+    auto st = session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, {1, 5}, {1.0f, -2.0f, -3.0f, -4.0f, -5.0f});
+  }
+}
+
+TEST(InferenceSessionTests, NestedConcatInputsWrittenInPlace) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  auto make_type = [](int64_t columns) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(columns);
+    return type;
+  };
+  TypeProto tensor_1x2 = make_type(2), tensor_1x3 = make_type(3), tensor_1x5 = make_type(5), tensor_1x7 = make_type(7);
+
+  // Y = Neg(Concat(Concat(Neg(X), Neg(P)), Abs(V))), with P = Abs(W). The inner Concat writes its output into the
+  // outer one, so the outer output is allocated by Neg(P), while P is live. The node indexes order the plan as
+  // Abs(W), Neg(P), Neg(X), the inner Concat, Abs(V), the outer Concat and Neg.
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_1x2);
+  auto& w = graph.GetOrCreateNodeArg("W", &tensor_1x3);
+  auto& v = graph.GetOrCreateNodeArg("V", &tensor_1x2);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_1x2);
+  auto& d = graph.GetOrCreateNodeArg("D", &tensor_1x2);
+  auto& p = graph.GetOrCreateNodeArg("P", &tensor_1x3);
+  auto& b = graph.GetOrCreateNodeArg("B", &tensor_1x3);
+  auto& c1 = graph.GetOrCreateNodeArg("C1", &tensor_1x5);
+  auto& c2 = graph.GetOrCreateNodeArg("C2", &tensor_1x7);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_1x7);
+  graph.AddNode("neg_x", "Neg", "", {&x}, {&a});
+  graph.AddNode("abs_v", "Abs", "", {&v}, {&d});
+  graph.AddNode("abs_w", "Abs", "", {&w}, {&p});
+  graph.AddNode("neg_p", "Neg", "", {&p}, {&b});
+  graph.AddNode("concat_ab", "Concat", "", {&a, &b}, {&c1}).AddAttribute("axis", int64_t{1});
+  graph.AddNode("concat_c1d", "Concat", "", {&c1, &d}, {&c2}).AddAttribute("axis", int64_t{1});
+  graph.AddNode("neg_c2", "Neg", "", {&c2}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.NestedConcatInputsWrittenInPlace";
+  so.enable_static_memory_planning = true;
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  const auto& session_state = session_object->GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int p_index, c1_index, c2_index;
+  ASSERT_TRUE(name_idx_map.GetIdx("P", p_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("C1", c1_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("C2", c2_index).IsOK());
+  EXPECT_EQ(allocation_plan[c1_index].alloc_kind, AllocKind::kSubTensor);
+  EXPECT_EQ(allocation_plan[c1_index].reused_buffer, c2_index);
+  EXPECT_EQ(allocation_plan[c2_index].alloc_kind, AllocKind::kAllocate);
+
+  // the outer output is live while Abs(W) is, so their blocks don't overlap
+  auto mem_patterns = session_state.GetStaticMemoryPatternGroup();
+  ASSERT_NE(mem_patterns, nullptr);
+  ASSERT_EQ(mem_patterns->patterns.size(), size_t{1});
+  const auto* p_block = mem_patterns->patterns[0].GetBlock(p_index);
+  const auto* c2_block = mem_patterns->patterns[0].GetBlock(c2_index);
+  ASSERT_NE(p_block, nullptr);
+  ASSERT_NE(c2_block, nullptr);
+  EXPECT_TRUE(p_block->offset_ + p_block->size_ <= c2_block->offset_ ||
+              c2_block->offset_ + c2_block->size_ <= p_block->offset_);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value, w_value, v_value;
+  CreateMLValue<float>(allocator, {1, 2}, {1.0f, -2.0f}, &x_value);
+  CreateMLValue<float>(allocator, {1, 3}, {3.0f, -4.0f, 5.0f}, &w_value);
+  CreateMLValue<float>(allocator, {1, 2}, {-6.0f, 7.0f}, &v_value);
+  NameMLValMap feeds{{"X", x_value}, {"W", w_value}, {"V", v_value}};
+
+  std::vector<OrtValue> fetches;
+  auto st = session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {1, 7}, {1.0f, -2.0f, 3.0f, 4.0f, 5.0f, -6.0f, -7.0f});
+}
+
+TEST(InferenceSessionTests, StridedViews) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  // Y = Neg(Transpose(Slice(Transpose(X)))). T and S are views of X, while U is copied, as Neg doesn't accept
+  // strided inputs.
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& t = graph.GetOrCreateNodeArg("T", &float_tensor);
+  auto& s = graph.GetOrCreateNodeArg("S", &float_tensor);
+  auto& u = graph.GetOrCreateNodeArg("U", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("transpose_x", "Transpose", "", {&x}, {&t});
+  auto& slice = graph.AddNode("slice", "Slice", "", {&t}, {&s});
+  slice.AddAttribute("starts", std::vector<int64_t>{1});
+  slice.AddAttribute("ends", std::vector<int64_t>{3});
+  slice.AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("transpose_s", "Transpose", "", {&s}, {&u});
+  graph.AddNode("neg", "Neg", "", {&u}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StridedViews";
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  const auto& session_state = session_object->GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int x_index, t_index, s_index, u_index;
+  ASSERT_TRUE(name_idx_map.GetIdx("X", x_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("T", t_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("S", s_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("U", u_index).IsOK());
+  for (int index : {t_index, s_index}) {
+    EXPECT_EQ(allocation_plan[index].alloc_kind, AllocKind::kView);
+    EXPECT_EQ(allocation_plan[index].reused_buffer, x_index);
+  }
+  EXPECT_NE(allocation_plan[u_index].alloc_kind, AllocKind::kView);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value;
+  CreateMLValue<float>(allocator, {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  std::vector<OrtValue> fetches;
+  auto st = session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {2, 2}, {-2.0f, -3.0f, -5.0f, -6.0f});
+}
+
+TEST(InferenceSessionTests, PassThroughOutputsShareTheirValues) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_dims(2);
+  weight.add_float_data(2.0f);
+  weight.add_float_data(3.0f);
+  graph.AddInitializedTensor(weight);
+
+  // Y = Identity(X) and Z = Identity(W)
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  graph.AddNode("identity_x", "Identity", "", {&x}, {&y});
+  graph.AddNode("identity_w", "Identity", "", {&w}, {&z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PassThroughOutputsShareTheirValues";
+  // constant folding would turn Z into an initializer
+  so.graph_optimization_level = TransformerLevel::Default;
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  const auto& session_state = session_object->GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int x_index, w_index, y_index, z_index;
+  ASSERT_TRUE(name_idx_map.GetIdx("X", x_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("W", w_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("Y", y_index).IsOK());
+  ASSERT_TRUE(name_idx_map.GetIdx("Z", z_index).IsOK());
+  EXPECT_EQ(allocation_plan[y_index].alloc_kind, AllocKind::kShare);
+  EXPECT_EQ(allocation_plan[y_index].reused_buffer, x_index);
+  EXPECT_EQ(allocation_plan[z_index].alloc_kind, AllocKind::kShare);
+  EXPECT_EQ(allocation_plan[z_index].reused_buffer, w_index);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value;
+  CreateMLValue<float>(allocator, {2}, {1.0f, 4.0f}, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  std::vector<OrtValue> fetches;
+  auto st = session_object->Run(RunOptions{}, feeds, {"Y", "Z"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 2u);
+  EXPECT_EQ(fetches[0].Get<Tensor>().DataRaw(), x_value.Get<Tensor>().DataRaw());
+  EXPECT_EQ(fetches[1].Get<Tensor>().DataRaw(), session_state.GetInitializedTensors().at(w_index).Get<Tensor>().DataRaw());
+
+  // an output buffer provided by the caller is still written
+  OrtValue y_value;
+  CreateMLValue<float>(allocator, {2}, {0.0f, 0.0f}, &y_value);
+  fetches = {y_value, OrtValue()};
+  st = session_object->Run(RunOptions{}, feeds, {"Y", "Z"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  EXPECT_EQ(fetches[0].Get<Tensor>().DataRaw(), y_value.Get<Tensor>().DataRaw());
+  const float* y_data = y_value.Get<Tensor>().Data<float>();
+  EXPECT_EQ(std::vector<float>(y_data, y_data + 2), (std::vector<float>{1.0f, 4.0f}));
+}
+
+TEST(InferenceSessionTests, CalibrateAndQuantizeMatMul) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 11;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_dims(2);
+  weight.add_dims(2);
+  for (float value : {0.5f, -1.0f, 2.0f, 1.5f}) {
+    weight.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weight);
+
+  // Y = MatMul(X, W)
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("matmul", "MatMul", "", {&x, &w}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  const ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value;
+  CreateMLValue<float>(allocator, {2, 2}, {1.0f, -2.0f, 0.5f, 3.0f}, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  const std::vector<float> expected{-3.5f, -4.0f, 6.25f, 4.0f};
+
+  Calibrator calibrator(model_proto, CalibrationOptions(), &DefaultLoggingManager());
+  ASSERT_TRUE(calibrator.Initialize().IsOK());
+  ASSERT_TRUE(calibrator.Collect(feeds).IsOK());
+  std::unordered_map<std::string, QuantizationRange> ranges;
+  ASSERT_TRUE(calibrator.ComputeRanges(ranges).IsOK());
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges["X"].min, -2.0f);
+  EXPECT_EQ(ranges["X"].max, 3.0f);
+  EXPECT_EQ(ranges["Y"].min, -4.0f);
+  EXPECT_EQ(ranges["Y"].max, 6.25f);
+
+  auto run_quantized = [&](const ONNX_NAMESPACE::ModelProto& quantized_model, const std::string& op_type) {
+    std::string serialized_model;
+    quantized_model.SerializeToString(&serialized_model);
+    std::stringstream sstr(serialized_model);
+
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.CalibrateAndQuantizeMatMul";
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    std::map<std::string, int> op_to_count = CountOpsInGraph(session_object.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count[op_type], 1);
+
+    std::vector<OrtValue> fetches;
+    auto st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    const float* y_data = fetches[0].Get<Tensor>().Data<float>();
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_NEAR(y_data[i], expected[i], 0.1f);
+    }
+  };
+
+  // the QuantizeLinear and DequantizeLinear nodes around the MatMul fuse into a QLinearMatMul
+  ONNX_NAMESPACE::ModelProto static_model = model_proto;
+  ASSERT_TRUE(QuantizeModelStatic(static_model, ranges, false).IsOK());
+  run_quantized(static_model, "QLinearMatMul");
+
+  ONNX_NAMESPACE::ModelProto dynamic_model = model_proto;
+  ASSERT_TRUE(QuantizeModelDynamic(dynamic_model).IsOK());
+  run_quantized(dynamic_model, "MatMulInteger");
+}
+
+TEST(InferenceSessionTests, SharedInitializers) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  // replaces the weights [[1], [2]] of the model
+  OrtValue weights;
+  CreateMLValue<float>(allocator, {2, 1}, {3.0f, 4.0f}, &weights);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SharedInitializers";
+  so.initializers_to_share_map["W"] = &weights;
+
+  InferenceSession session_1{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_1.Load("testdata/matmul_2.onnx").IsOK());
+  ASSERT_TRUE(session_1.Initialize().IsOK());
+  InferenceSession session_2{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_2.Load("testdata/matmul_2.onnx").IsOK());
+  ASSERT_TRUE(session_2.Initialize().IsOK());
+
+  OrtValue x;
+  CreateMLValue<float>(allocator, {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}, &x);
+  NameMLValMap feeds{{"X", x}};
+
+  for (auto* session : {&session_1, &session_2}) {
+    std::vector<OrtValue> fetches;
+    auto st = session->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, {2, 1}, {11.0f, 25.0f});
+  }
+
+  // the shared value must have the shape of the initializer
+  OrtValue wrong_weights;
+  CreateMLValue<float>(allocator, {1, 2}, {3.0f, 4.0f}, &wrong_weights);
+  so.initializers_to_share_map["W"] = &wrong_weights;
+
+  InferenceSession session_3{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_3.Load("testdata/matmul_2.onnx").IsOK());
+  ASSERT_FALSE(session_3.Initialize().IsOK());
+}
+
+TEST(InferenceSessionTests, ExternalDataInitializers) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  {
+    std::ifstream model_file("testdata/matmul_2.onnx", std::ios::binary);
+    ASSERT_TRUE(model_proto.ParseFromIstream(&model_file));
+  }
+
+  // move the weights of the model to a file next to it, after 4 bytes of something else
+  const std::string model_path = "external_data_test.onnx";
+  const std::string data_path = "external_data_test.bin";
+  {
+    const float data[] = {0.0f, 3.0f, 4.0f};
+    std::ofstream data_file(data_path, std::ios::binary);
+    data_file.write(reinterpret_cast<const char*>(data), sizeof(data));
+  }
+
+  auto& weights = *model_proto.mutable_graph()->mutable_initializer(0);
+  ASSERT_EQ(weights.name(), "W");
+  weights.clear_float_data();
+  weights.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+  auto* location = weights.add_external_data();
+  location->set_key("location");
+  location->set_value(data_path);
+  auto* offset = weights.add_external_data();
+  offset->set_key("offset");
+  offset->set_value("4");
+  auto* length = weights.add_external_data();
+  length->set_key("length");
+  length->set_value("8");
+  {
+    std::ofstream model_file(model_path, std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_file));
+  }
+
+  // the weights are used in place in the mapping of the file
+  ASSERT_TRUE(utils::IsExternalDataUsedInPlace(weights));
+
+  // the hints about the access to the mapping don't change the results
+  for (bool advise : {false, true}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ExternalDataInitializers";
+    so.prefetch_external_data = advise;
+    so.use_huge_pages_for_external_data = advise;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_path).IsOK());
+    auto st = session_object.Initialize();
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 2},
+                         {1.0f, 2.0f, 3.0f, 4.0f}, &x);
+    NameMLValMap feeds{{"X", x}};
+    std::vector<OrtValue> fetches;
+    st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, {2, 1}, {11.0f, 25.0f});
+  }
+
+  // misaligned data is copied
+  offset->set_value("2");
+  EXPECT_FALSE(utils::IsExternalDataUsedInPlace(weights));
+
+  std::remove(model_path.c_str());
+  std::remove(data_path.c_str());
+}
+
+TEST(InferenceSessionTests, PreparedRun) {
+  for (bool enable_run_state_cache : {false, true}) {
+    SessionOptions so;
+
+    so.session_logid = "InferenceSessionTests.PreparedRun";
+    so.enable_run_state_cache = enable_run_state_cache;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+    std::unique_ptr<PreparedRun> prepared_run;
+    ASSERT_FALSE(session_object.PrepareRun({"X"}, {"Y"}, prepared_run).IsOK());
+
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    ASSERT_FALSE(session_object.PrepareRun({"X"}, {"Z"}, prepared_run).IsOK());
+    ASSERT_FALSE(session_object.PrepareRun({"Z"}, {"Y"}, prepared_run).IsOK());
+    auto st = session_object.PrepareRun({"X"}, {"Y"}, prepared_run);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    std::vector<int64_t> dims_mul_x = {3, 2};
+    std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &feeds[0]);
+
+    std::vector<int64_t> expected_dims_mul_y = {3, 2};
+    std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+    RunOptions run_options;
+    for (int i = 0; i < 3; ++i) {
+      std::vector<OrtValue> fetches;
+      st = session_object.Run(run_options, *prepared_run, feeds, &fetches);
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+      VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+    }
+
+    // wrong number of feeds
+    std::vector<OrtValue> fetches;
+    ASSERT_FALSE(session_object.Run(run_options, *prepared_run, {}, &fetches).IsOK());
+
+    // a run prepared by another session
+    InferenceSession other_session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(other_session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(other_session_object.Initialize().IsOK());
+    ASSERT_FALSE(other_session_object.Run(run_options, *prepared_run, feeds, &fetches).IsOK());
+  }
+}
+
+TEST(InferenceSessionTests, RunWithOutputAllocator) {
+  for (bool enable_run_state_cache : {false, true}) {
+    SessionOptions so;
+
+    so.session_logid = "InferenceSessionTests.RunWithOutputAllocator";
+    so.enable_run_state_cache = enable_run_state_cache;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    std::vector<int64_t> dims_mul_x = {3, 2};
+    std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &feeds[0]);
+
+    std::vector<int64_t> expected_dims_mul_y = {3, 2};
+    std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+    std::vector<float> buffer(6);
+    size_t num_calls = 0;
+    auto output_allocator = [&](size_t output_index, MLDataType element_type, const TensorShape& shape,
+                                size_t size) -> void* {
+      ++num_calls;
+      EXPECT_EQ(output_index, 0u);
+      EXPECT_EQ(element_type, DataTypeImpl::GetType<float>());
+      EXPECT_EQ(shape, TensorShape(expected_dims_mul_y));
+      EXPECT_EQ(size, buffer.size() * sizeof(float));
+      return buffer.data();
+    };
+
+    RunOptions run_options;
+    for (int i = 0; i < 2; ++i) {
+      std::vector<OrtValue> fetches;
+      auto st = session_object.Run(run_options, {"X"}, feeds, {"Y"}, &fetches, output_allocator);
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+      VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+
+      // the output was written into the buffer
+      ASSERT_EQ(fetches[0].Get<Tensor>().Data<float>(), buffer.data());
+      ASSERT_EQ(buffer, expected_values_mul_y);
+      std::fill(buffer.begin(), buffer.end(), 0.0f);
+    }
+    ASSERT_EQ(num_calls, 2u);
+
+    // returning nullptr leaves the output to the session
+    std::vector<OrtValue> fetches;
+    auto st = session_object.Run(run_options, {"X"}, feeds, {"Y"}, &fetches,
+                                 [](size_t, MLDataType, const TensorShape&, size_t) -> void* { return nullptr; });
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+  }
+}
+
+TEST(InferenceSessionTests, RunAsync) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsync";
+  so.session_thread_pool_size = 2;
+  so.num_thread_pool_replicas = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  RunOptions run_options;
+  constexpr int num_runs = 8;
+  std::vector<std::promise<void>> done(num_runs);
+  for (int i = 0; i < num_runs; ++i) {
+    auto st = session_object.RunAsync(run_options, {"X"}, {ml_value}, {"Y"}, {},
+                                      [&done, i, &expected_dims_mul_y, &expected_values_mul_y](
+                                          const common::Status& status, std::vector<OrtValue>& fetches) {
+                                        EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+                                        if (status.IsOK()) {
+                                          VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+                                        }
+                                        done[i].set_value();
+                                      });
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  }
+
+  for (auto& run_done : done) {
+    run_done.get_future().wait();
+  }
+
+  // a failed Run is reported to the callback
+  std::promise<common::Status> failed;
+  ASSERT_TRUE(session_object.RunAsync(run_options, {"X"}, {ml_value}, {"Z"}, {},
+                                      [&failed](const common::Status& status, std::vector<OrtValue>&) {
+                                        failed.set_value(status);
+                                      })
+                  .IsOK());
+  EXPECT_FALSE(failed.get_future().get().IsOK());
+}
+
+TEST(InferenceSessionTests, RunAsyncWithoutThreadPool) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunAsyncWithoutThreadPool";
+  so.use_per_session_threads = false;
+
+  // the Runs aren't scheduled on the intra-op thread pool when there is no inter-op one
+  concurrency::ThreadPool intra_op_thread_pool("TEST", 2);
+  InferenceSession session_object{so, &DefaultLoggingManager(), &intra_op_thread_pool, nullptr};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  auto st = session_object.RunAsync(run_options, {"X"}, {}, {"Y"}, {},
+                                    [](const common::Status&, std::vector<OrtValue>&) { FAIL(); });
+  ASSERT_FALSE(st.IsOK());
+}
+
+// Returns the bytes the BFCArena of the CPU execution provider of the session allocated from the device.
+static int64_t GetCpuArenaAllocatedBytes(InferenceSessionGetGraphWrapper& session_object) {
+  const auto* provider = session_object.GetSessionState().GetExecutionProviders().Get(kCpuExecutionProvider);
+  auto* arena = dynamic_cast<BFCArena*>(provider->GetAllocator(0, OrtMemTypeDefault).get());
+  EXPECT_NE(arena, nullptr);
+  AllocatorStats stats;
+  if (arena != nullptr) {
+    arena->GetStats(&stats);
+  }
+  return stats.total_allocated_bytes;
+}
+
+TEST(InferenceSessionTests, ShrinkArenasAfterRun) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  // Y = ReduceSum(Neg(X)), where the 4MB output of Neg needs a region of the arena beyond the initial one
+  TypeProto tensor_1024x1024;
+  tensor_1024x1024.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_1024x1024.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+  tensor_1024x1024.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_1024x1024);
+  auto& a = graph.GetOrCreateNodeArg("A", &tensor_1024x1024);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("neg", "Neg", "", {&x}, {&a});
+  graph.AddNode("sum", "ReduceSum", "", {&a}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1024, 1024},
+                       std::vector<float>(1024 * 1024, 1.0f), &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShrinkArenasAfterRun";
+  // the memory pattern would reserve the buffers of the Run outside the arena regions
+  so.enable_mem_pattern = false;
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  std::vector<OrtValue> fetches;
+  ASSERT_TRUE(session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches).IsOK());
+  fetches.clear();
+  const int64_t allocated_bytes = GetCpuArenaAllocatedBytes(*session_object);
+  ASSERT_TRUE(session_object->ShrinkMemoryArenas().IsOK());
+  EXPECT_LT(GetCpuArenaAllocatedBytes(*session_object), allocated_bytes);
+
+  // the arena is shrunk once the Run is done
+  so.enable_mem_arena_shrink_after_run = true;
+  auto shrinking_session_object = LoadModel(model, so);
+  ASSERT_NE(shrinking_session_object, nullptr);
+  ASSERT_TRUE(shrinking_session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches).IsOK());
+  VerifyOutputs(fetches, {1, 1}, {-1024.0f * 1024.0f});
+  EXPECT_LT(GetCpuArenaAllocatedBytes(*shrinking_session_object), allocated_bytes);
+}
+
+TEST(InferenceSessionTests, Warmup) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.Warmup";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_FALSE(session_object.Warmup({{}}).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the shape of the model, then a profile naming the input
+  ASSERT_TRUE(session_object.Warmup({{}, {{"X", {3, 2}}}}).IsOK());
+  ASSERT_FALSE(session_object.Warmup({{{"Y", {3, 2}}}}).IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "after warmup";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, RunInMicroBatches) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  // Y = Neg(X), with the rows of X left unspecified
+  TypeProto batch_x2;
+  batch_x2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  batch_x2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  batch_x2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& x = graph.GetOrCreateNodeArg("X", &batch_x2);
+  auto& y = graph.GetOrCreateNodeArg("Y", &batch_x2);
+  graph.AddNode("neg", "Neg", "", {&x}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunInMicroBatches";
+  auto session_object = LoadModel(model, so);
+  ASSERT_NE(session_object, nullptr);
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue x_value;
+  CreateMLValue<float>(allocator, {5, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f}, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  const std::vector<float> expected_y{-1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f, -7.0f, -8.0f, -9.0f, -10.0f};
+
+  // the 5 rows run as micro-batches of 2, 2 and 1 rows
+  RunOptions run_options;
+  run_options.max_micro_batch_size = 2;
+  std::vector<OrtValue> fetches;
+  auto st = session_object->Run(run_options, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {5, 2}, expected_y);
+
+  // the rows are written into a pre-allocated output
+  fetches.resize(1);
+  CreateMLValue<float>(allocator, {5, 2}, std::vector<float>(10, 0.0f), &fetches[0]);
+  st = session_object->Run(run_options, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {5, 2}, expected_y);
+}
+
+TEST(InferenceSessionTests, UseSharedAllocators) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.UseSharedAllocators";
+  so.use_env_allocators = true;
+
+  DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
+                                              [](int) { return std::make_unique<CPUAllocator>(); },
+                                              std::numeric_limits<size_t>::max()};
+  AllocatorPtr shared_allocator = CreateAllocator(device_info);
+
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  InferenceSessionGetGraphWrapper session_object2{so, &DefaultLoggingManager()};
+  for (auto* session : {&session_object, &session_object2}) {
+    session->UseSharedAllocators({shared_allocator});
+    ASSERT_TRUE(session->Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session->Initialize().IsOK());
+
+    const auto& providers = session->GetSessionState().GetExecutionProviders();
+    EXPECT_EQ(providers.GetAllocator(shared_allocator->Info()), shared_allocator);
+
+    RunOptions run_options;
+    run_options.run_tag = "one session/one tag";
+    RunModel(*session, run_options);
+  }
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -397,6 +1364,12 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_opt.Load(so.optimized_model_filepath).IsOK());
   ASSERT_TRUE(session_object_opt.Initialize().IsOK());
 
+  // the optimized model is tagged for its next loads to skip the optimizations it already had
+  auto metadata = session_object_opt.GetModelMetadata();
+  ASSERT_TRUE(metadata.first.IsOK());
+  EXPECT_EQ(metadata.second->custom_metadata_map.at("onnxruntime.graph_optimization_level"), "1");
+  EXPECT_EQ(metadata.second->custom_metadata_map.at("onnxruntime.execution_providers"), kCpuExecutionProvider);
+
   // Assert that re-feed of optimized model with default transform level results
   // in same runtime model as abs-id-max.onnx with TransformLevel-1.
   std::ifstream model_fs_session1(so.optimized_model_filepath, ios::in | ios::binary);
@@ -479,83 +1452,277 @@ TEST(InferenceSessionTests, ModelMetadata) {
                 m->version == p_model->ModelVersion());
   }
 
-  {
-    // 2. test inputs
-    auto& inputs = graph.GetInputs();
-    auto weights = graph.GetAllInitializedTensors();
+  {
+    // 2. test inputs
+    auto& inputs = graph.GetInputs();
+    auto weights = graph.GetAllInitializedTensors();
+
+    // skip the weights
+    InputDefList inputs_no_weights;
+    for (auto& elem : inputs) {
+      if (weights.find(elem->Name()) != weights.end()) {
+        continue;
+      } else {
+        inputs_no_weights.push_back(elem);
+      }
+    }
+
+    auto retval = session_object.GetModelInputs();
+    cout << "weights size: " << weights.size()
+         << " inputs.size(): " << inputs.size()
+         << " from session: " << retval.second->size() << endl;
+    ASSERT_TRUE(retval.first.IsOK());
+    ASSERT_TRUE(Compare(inputs_no_weights, *retval.second));
+  }
+
+  // 3. test outputs
+  {
+    auto retval = session_object.GetModelOutputs();
+    ASSERT_TRUE(retval.first.IsOK());
+
+    auto& outputs = graph.GetOutputs();
+    retval = session_object.GetModelOutputs();
+    ASSERT_TRUE(retval.first.IsOK());
+    ASSERT_TRUE(Compare(outputs, *retval.second));
+  }
+}
+#endif
+TEST(InferenceSessionTests, CheckRunLogger) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunLogger";
+
+  // create CapturingSink. LoggingManager will own it, but as long as the logging_manager
+  // is around our pointer stays valid.
+  auto capturing_sink = new CapturingSink();
+
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(capturing_sink), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  InferenceSession session_object{so, logging_manager.get()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  run_options.run_log_severity_level = static_cast<int>(Severity::kVERBOSE);
+  RunModel(session_object, run_options);
+
+#ifndef NDEBUG
+  // check for some VLOG output to make sure tag was correct. VLOG is not enabled in release build
+  auto& msgs = capturing_sink->Messages();
+  std::copy(msgs.begin(), msgs.end(), std::ostream_iterator<std::string>(std::cout, "\n"));
+  bool have_log_entry_with_run_tag =
+      (std::find_if(msgs.begin(), msgs.end(),
+                    [&run_options](std::string msg) {
+                      return msg.find(run_options.run_tag) != string::npos;
+                    }) != msgs.end());
+
+  ASSERT_TRUE(have_log_entry_with_run_tag);
+#endif
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfiler";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_profile_test");
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+
+  std::vector<std::string> lines;
+  while (std::getline(profile, line)) {
+    lines.push_back(line);
+  }
+  ASSERT_GE(lines.size(), 3u);
+  ASSERT_TRUE(lines.front().find("[") != string::npos);
+  ASSERT_TRUE(lines.back().find("]") != string::npos);
+
+  // the phases of the initialization, the events of the node, the peak memory and the CPU arena
+  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
+  for (size_t i = 1; i < lines.size() - 1; ++i) {
+    for (auto& s : tags) {
+      ASSERT_TRUE(lines[i].find(s) != string::npos);
+    }
+  }
+  ASSERT_TRUE(lines[1].find("model_loading_uri") != string::npos);
+  ASSERT_TRUE(std::any_of(lines.begin(), lines.end(), [](const std::string& l) {
+    return l.find("session_initialization") != string::npos;
+  }));
+}
+
+TEST(InferenceSessionTests, GetInitializationTimings) {
+  SessionOptions so;
+  so.session_logid = "GetInitializationTimings";
+
+  // recorded without profiling
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  const std::string timings = session_object.GetInitializationTimings();
+  ASSERT_EQ(timings.front(), '[');
+  for (const char* phase : {"\"model_loading\"", "\"kernel_registration\"", "\"get_capability\"",
+                            "\"graph_partitioning\"", "\"graph_resolve\"", "\"execution_planning\"",
+                            "\"initializers_loading\"", "\"kernel_creation\"", "\"session_initialization\""}) {
+    EXPECT_NE(timings.find(phase), std::string::npos) << phase << " not in " << timings;
+  }
+  EXPECT_NE(timings.find(onnxruntime::kCpuExecutionProvider), std::string::npos);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerRecordsMemory) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerRecordsMemory";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_memory_test");
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+
+  bool has_node_memory = false;
+  bool has_peak_memory = false;
+  bool has_arena_stats = false;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") != string::npos) {
+      ASSERT_TRUE(line.find("output_allocated_bytes") != string::npos);
+      ASSERT_TRUE(line.find("arena_bytes_in_use") != string::npos);
+      has_node_memory = true;
+    }
+    if (line.find("SequentialExecutor::PeakMemory") != string::npos) {
+      ASSERT_TRUE(line.find("tensors_at_peak") != string::npos);
+      has_peak_memory = true;
+    }
+    if (line.find("Arena::") != string::npos) {
+      ASSERT_TRUE(line.find("fragmentation") != string::npos);
+      has_arena_stats = true;
+    }
+  }
+  ASSERT_TRUE(has_node_memory);
+  ASSERT_TRUE(has_peak_memory);
+  ASSERT_TRUE(has_arena_stats);
+}
+
+TEST(InferenceSessionTests, CheckRunRecordsMetrics) {
+  SessionOptions so;
 
-    // skip the weights
-    InputDefList inputs_no_weights;
-    for (auto& elem : inputs) {
-      if (weights.find(elem->Name()) != weights.end()) {
-        continue;
-      } else {
-        inputs_no_weights.push_back(elem);
-      }
-    }
+  so.session_logid = "CheckRunRecordsMetrics";
+  so.enable_metrics = true;
 
-    auto retval = session_object.GetModelInputs();
-    cout << "weights size: " << weights.size()
-         << " inputs.size(): " << inputs.size()
-         << " from session: " << retval.second->size() << endl;
-    ASSERT_TRUE(retval.first.IsOK());
-    ASSERT_TRUE(Compare(inputs_no_weights, *retval.second));
-  }
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
 
-  // 3. test outputs
-  {
-    auto retval = session_object.GetModelOutputs();
-    ASSERT_TRUE(retval.first.IsOK());
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
 
-    auto& outputs = graph.GetOutputs();
-    retval = session_object.GetModelOutputs();
-    ASSERT_TRUE(retval.first.IsOK());
-    ASSERT_TRUE(Compare(outputs, *retval.second));
-  }
+  std::string metrics = metrics::MetricsRegistry::Global().ToPrometheusText();
+  EXPECT_NE(metrics.find("onnxruntime_session_run_duration_seconds_count{session=\"CheckRunRecordsMetrics\"} 2"),
+            string::npos);
+  EXPECT_NE(metrics.find("onnxruntime_session_run_failures_total{session=\"CheckRunRecordsMetrics\"} 0"),
+            string::npos);
+  EXPECT_NE(metrics.find("onnxruntime_session_kernel_compute_microseconds_total{session=\"CheckRunRecordsMetrics\","
+                         "provider=\"CPUExecutionProvider\"}"),
+            string::npos);
+  EXPECT_NE(metrics.find("onnxruntime_arena_bytes_in_use{arena=\"Cpu\"}"), string::npos);
 }
-#endif
-TEST(InferenceSessionTests, CheckRunLogger) {
+
+TEST(InferenceSessionTests, CheckRunProfilerRecordsHardwareCounters) {
   SessionOptions so;
 
-  so.session_logid = "CheckRunLogger";
+  so.session_logid = "CheckRunProfilerRecordsHardwareCounters";
+  so.enable_profiling = true;
+  so.enable_profiling_hardware_counters = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_hardware_counters_test");
 
-  // create CapturingSink. LoggingManager will own it, but as long as the logging_manager
-  // is around our pointer stays valid.
-  auto capturing_sink = new CapturingSink();
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
 
-  auto logging_manager = std::make_unique<logging::LoggingManager>(
-      std::unique_ptr<ISink>(capturing_sink), logging::Severity::kVERBOSE, false,
-      LoggingManager::InstanceType::Temporal);
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
 
-  InferenceSession session_object{so, logging_manager.get()};
+  // the counters are only recorded where they can be opened, e.g. not on Windows or in most containers
+  const bool has_counters = HardwareCounters::ForCurrentThread() != nullptr;
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  bool has_kernel_time = false;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") != string::npos) {
+      has_kernel_time = true;
+      ASSERT_EQ(line.find("\"instructions\"") != string::npos, has_counters);
+      ASSERT_EQ(line.find("\"memory_bandwidth_mbps\"") != string::npos, has_counters);
+    }
+  }
+  ASSERT_TRUE(has_kernel_time);
+}
+
+#if defined(USE_CUDA) && defined(ENABLE_CUDA_PROFILING)
+TEST(InferenceSessionTests, CheckRunProfilerRecordsCudaKernels) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerRecordsCudaKernels";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_cuda_kernels_test");
+
+  InferenceSession session_object(so);
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
   ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
   ASSERT_TRUE(session_object.Initialize().IsOK());
 
   RunOptions run_options;
-  run_options.run_tag = "RunTag";
-  run_options.run_log_severity_level = static_cast<int>(Severity::kVERBOSE);
   RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
 
-#ifndef NDEBUG
-  // check for some VLOG output to make sure tag was correct. VLOG is not enabled in release build
-  auto& msgs = capturing_sink->Messages();
-  std::copy(msgs.begin(), msgs.end(), std::ostream_iterator<std::string>(std::cout, "\n"));
-  bool have_log_entry_with_run_tag =
-      (std::find_if(msgs.begin(), msgs.end(),
-                    [&run_options](std::string msg) {
-                      return msg.find(run_options.run_tag) != string::npos;
-                    }) != msgs.end());
-
-  ASSERT_TRUE(have_log_entry_with_run_tag);
-#endif
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  bool has_node_kernel = false;
+  while (std::getline(profile, line)) {
+    if (line.find("\"Kernel\"") != string::npos && line.find("\"parent_name\"") != string::npos) {
+      has_node_kernel = true;
+    }
+  }
+  ASSERT_TRUE(has_node_kernel);
 }
+#endif
 
-TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
+TEST(InferenceSessionTests, CheckRunProfilerWithSampling) {
   SessionOptions so;
 
-  so.session_logid = "CheckRunProfiler";
+  so.session_logid = "CheckRunProfilerWithSampling";
   so.enable_profiling = true;
-  so.profile_file_prefix = ORT_TSTR("onnxprofile_profile_test");
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_sampling_test");
+  so.profile_sampling_interval = 2;
 
   InferenceSession session_object(so);
   ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
@@ -564,31 +1731,31 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   RunOptions run_options;
   run_options.run_tag = "RunTag";
 
-  RunModel(session_object, run_options);
+  for (int i = 0; i < 4; ++i) {
+    RunModel(session_object, run_options);
+  }
   std::string profile_file = session_object.EndProfiling();
 
   std::ifstream profile(profile_file);
   ASSERT_TRUE(profile);
   std::string line;
 
-  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
-  int count = 0;
+  // 1 in 2 executions is recorded, with the kernel time of its nodes, and no Run records its model_run event
+  int num_executions = 0;
+  int num_kernel_events = 0;
   while (std::getline(profile, line)) {
-    if (count == 0) {
-      ASSERT_TRUE(line.find("[") != string::npos);
-    } else if (count <= 7) {
-      for (auto& s : tags) {
-        ASSERT_TRUE(line.find(s) != string::npos);
-      }
-    } else {
-      ASSERT_TRUE(line.find("]") != string::npos);
+    ASSERT_TRUE(line.find("model_run") == string::npos);
+    if (line.find("SequentialExecutor::Execute") != string::npos) {
+      num_executions++;
     }
-
-    if (count == 1) {
-      ASSERT_TRUE(line.find("model_loading_uri") != string::npos);
+    if (line.find("_kernel_time") != string::npos) {
+      ASSERT_TRUE(line.find("op_name") != string::npos);
+      num_kernel_events++;
     }
-    count++;
   }
+  ASSERT_EQ(num_executions, 2);
+  ASSERT_GT(num_kernel_events, 0);
+  ASSERT_EQ(num_kernel_events % 2, 0);
 }
 
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
@@ -615,7 +1782,7 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   while (std::getline(profile, line)) {
     if (count == 0) {
       ASSERT_TRUE(line.find("[") != string::npos);
-    } else if (count <= 5) {
+    } else if (count <= 7) {  // the events of the node and the execution, the peak memory and the CPU arena
       for (auto& s : tags) {
         ASSERT_TRUE(line.find(s) != string::npos);
       }
@@ -907,6 +2074,67 @@ TEST(InferenceSessionTests, TestBindCudaPreallocateOutputOnCpu2) {
                  kCpuExecutionProvider);
 }
 
+// Runs Y = X + W0 + W1 + W2 + W3 on CUDA with the weights streamed by the session options.
+static void RunWeightStreamingTest(const SessionOptions& so) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  // Y = X + W0 + W1 + W2 + W3, with Wi = {i + 1, i + 1}
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  NodeArg* input = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (int i = 0; i < 4; ++i) {
+    TensorProto weight;
+    weight.set_name("W" + std::to_string(i));
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(2);
+    weight.add_float_data(i + 1.0f);
+    weight.add_float_data(i + 1.0f);
+    graph.AddInitializedTensor(weight);
+
+    auto& w = graph.GetOrCreateNodeArg(weight.name(), &float_tensor);
+    auto& output = graph.GetOrCreateNodeArg(i == 3 ? "Y" : "T" + std::to_string(i), &float_tensor);
+    graph.AddNode("add" + std::to_string(i), "Add", "", {input, &w}, {&output});
+    input = &output;
+  }
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  auto session_object = LoadModel(model, so, std::make_unique<CUDAExecutionProvider>(epi));
+  ASSERT_NE(session_object, nullptr);
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {1.0f, 2.0f},
+                       &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  for (int run = 0; run < 2; ++run) {
+    std::vector<OrtValue> fetches;
+    auto st = session_object->Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, {2}, {11.0f, 12.0f});
+  }
+}
+
+TEST(InferenceSessionTests, WeightStreaming) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.WeightStreaming";
+  // the buffer holds the weights of two nodes, so the copies rotate through it
+  so.weight_streaming_buffer_size = 512;
+  RunWeightStreamingTest(so);
+}
+
+TEST(InferenceSessionTests, WeightStreamingWithPipeline) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.WeightStreamingWithPipeline";
+  so.weight_streaming_buffer_size = 512;
+  // the stages wouldn't copy the weights, so the session runs without the pipeline
+  so.num_pipeline_stages = 2;
+  RunWeightStreamingTest(so);
+}
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -1368,6 +2596,71 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
   }
 }
 
+TEST(InferenceSessionTests, LazySubgraphInitialization) {
+  // the Scan nodes of the model run their LSTM bodies as subgraphs
+  static const std::string LSTM_MODEL_URI = "testdata/scan_1.onnx";
+
+  std::vector<int64_t> X_dims = {5, 1, 3};
+  std::vector<float> X = {0.5488135f, 0.71518934f, 0.60276335f,
+                          0.5448832f, 0.4236548f, 0.6458941f,
+                          0.4375872f, 0.891773f, 0.96366274f,
+                          0.3834415f, 0.79172504f, 0.5288949f,
+                          0.56804454f, 0.92559665f, 0.07103606f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), X_dims, X, &ml_value);
+  NameMLValMap feeds = {{"Input13165", ml_value}};
+  RunOptions run_options;
+
+  SessionOptions so;
+  InferenceSession eager_session{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(eager_session.Load(LSTM_MODEL_URI).IsOK());
+  ASSERT_TRUE(eager_session.Initialize().IsOK());
+
+  so.enable_lazy_subgraph_initialization = true;
+  InferenceSessionGetGraphWrapper lazy_session{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(lazy_session.Load(LSTM_MODEL_URI).IsOK());
+  ASSERT_TRUE(lazy_session.Initialize().IsOK());
+
+  // the subgraphs have no plan until the Scan nodes first run
+  auto& session_state = const_cast<SessionState&>(lazy_session.GetSessionState());
+  std::vector<SessionState*> subgraph_session_states;
+  for (const auto& node : lazy_session.GetGraph().Nodes()) {
+    if (node.OpType() == "Scan") {
+      subgraph_session_states.push_back(session_state.GetMutableSubgraphSessionState(node.Index(), "body"));
+      ASSERT_NE(subgraph_session_states.back(), nullptr);
+      EXPECT_EQ(subgraph_session_states.back()->GetExecutionPlan(), nullptr);
+    }
+  }
+  ASSERT_FALSE(subgraph_session_states.empty());
+
+  std::vector<std::string> output_names;
+  for (const auto* output : *lazy_session.GetModelOutputs().second) {
+    output_names.push_back(output->Name());
+  }
+
+  std::vector<OrtValue> eager_fetches;
+  ASSERT_TRUE(eager_session.Run(run_options, feeds, output_names, &eager_fetches).IsOK());
+
+  // the second Run uses the subgraphs initialized by the first
+  for (int run = 0; run < 2; ++run) {
+    std::vector<OrtValue> lazy_fetches;
+    ASSERT_TRUE(lazy_session.Run(run_options, feeds, output_names, &lazy_fetches).IsOK());
+    ASSERT_EQ(eager_fetches.size(), lazy_fetches.size());
+    for (size_t i = 0; i < eager_fetches.size(); ++i) {
+      const auto& expected = eager_fetches[i].Get<Tensor>();
+      const auto& actual = lazy_fetches[i].Get<Tensor>();
+      ASSERT_EQ(expected.Shape(), actual.Shape());
+      for (int64_t j = 0; j < expected.Shape().Size(); ++j) {
+        EXPECT_EQ(expected.Data<float>()[j], actual.Data<float>()[j]);
+      }
+    }
+  }
+
+  for (const auto* subgraph_session_state : subgraph_session_states) {
+    EXPECT_NE(subgraph_session_state->GetExecutionPlan(), nullptr);
+  }
+}
+
 // create the feeds and fetches using the dummy allocator so that we have to copy to CPU to execute, and from
 // CPU to return in utils::ExecuteGraph. Call InferenceSession::Run twice to test the caching of the copy logic.
 TEST(InferenceSessionTests, TestCopyToFromDevices) {
@@ -1471,6 +2764,282 @@ TEST(InferenceSessionTests, TestL1AndL2Transformers) {
   }
 }
 
+// create a model with num_branches independent Neg nodes reading X, summed up into Y
+static void CreateWideModel(std::unique_ptr<onnxruntime::Model>& p_model, int num_branches) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 8;
+  p_model = std::make_unique<onnxruntime::Model>("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                 domain_to_version);
+  onnxruntime::Graph& graph = p_model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  std::vector<onnxruntime::NodeArg*> sum_inputs;
+  for (int i = 0; i < num_branches; ++i) {
+    auto& branch_arg = graph.GetOrCreateNodeArg("B" + std::to_string(i), &tensor_float);
+    graph.AddNode("neg" + std::to_string(i), "Neg", "Neg", {&input_arg}, {&branch_arg});
+    sum_inputs.push_back(&branch_arg);
+  }
+
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("sum", "Sum", "Sum", sum_inputs, {&output_arg});
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(InferenceSessionTests, ParallelExecutionWideGraph) {
+  const int num_branches = 16;
+  std::unique_ptr<Model> p_model;
+  CreateWideModel(p_model, num_branches);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  // with and without a session thread pool to share
+  for (int thread_pool_size : {4, 0}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ParallelExecutionWideGraph";
+    so.enable_sequential_execution = false;
+    so.session_thread_pool_size = thread_pool_size;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream sstr(model_str);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    std::vector<int64_t> dims_x = {3};
+    std::vector<float> values_x = {1.0f, 2.0f, 3.0f};
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+    std::vector<std::string> output_names{"Y"};
+    std::vector<float> expected_values_y = {-1.0f * num_branches, -2.0f * num_branches, -3.0f * num_branches};
+
+    RunOptions run_options;
+    for (int i = 0; i < 10; ++i) {
+      std::vector<OrtValue> fetches;
+      auto st = session_object.Run(run_options, feeds, output_names, &fetches);
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+      VerifyOutputs(fetches, dims_x, expected_values_y);
+    }
+  }
+}
+
+TEST(InferenceSessionTests, ParallelExecutionTerminate) {
+  const int num_branches = 16;
+  std::unique_ptr<Model> p_model;
+  CreateWideModel(p_model, num_branches);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ParallelExecutionTerminate";
+  so.enable_sequential_execution = false;
+  so.session_thread_pool_size = 4;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(model_str);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<int64_t> dims_x = {3};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+  std::vector<std::string> output_names{"Y"};
+
+  // every root node stops, and the Run fails once with the status of the sequential executor
+  RunOptions run_options;
+  run_options.terminate = true;
+  std::vector<OrtValue> fetches;
+  auto st = session_object.Run(run_options, feeds, output_names, &fetches);
+  ASSERT_FALSE(st.IsOK());
+  EXPECT_EQ(st.ErrorMessage(), OpKernelContext::TerminatedStatus().ErrorMessage());
+
+  // the session runs again once the flag is cleared
+  run_options.terminate = false;
+  st = session_object.Run(run_options, feeds, output_names, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  std::vector<float> expected_values_y = {-1.0f * num_branches, -2.0f * num_branches, -3.0f * num_branches};
+  VerifyOutputs(fetches, dims_x, expected_values_y);
+}
+
+TEST(InferenceSessionTests, ParallelExecutionExternalThreadPools) {
+  const int num_branches = 16;
+  std::unique_ptr<Model> p_model;
+  CreateWideModel(p_model, num_branches);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  concurrency::ThreadOptions thread_options;
+  thread_options.affinity = {0};
+  concurrency::ThreadPool intra_op_thread_pool("TEST_INTRA_OP", 2, thread_options);
+  concurrency::ThreadPool inter_op_thread_pool("TEST_INTER_OP", 2);
+
+  // external pools are used by every session that doesn't create its own
+  for (int i = 0; i < 2; ++i) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ParallelExecutionExternalThreadPools";
+    so.enable_sequential_execution = false;
+    so.use_per_session_threads = false;
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager(),
+                                                   &intra_op_thread_pool, &inter_op_thread_pool};
+    std::stringstream sstr(model_str);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+    EXPECT_EQ(session_object.GetSessionState().GetThreadPool(), &intra_op_thread_pool);
+    EXPECT_EQ(session_object.GetSessionState().GetInterOpThreadPool(), &inter_op_thread_pool);
+
+    std::vector<int64_t> dims_x = {3};
+    std::vector<float> values_x = {1.0f, 2.0f, 3.0f};
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+    std::vector<std::string> output_names{"Y"};
+    std::vector<float> expected_values_y = {-1.0f * num_branches, -2.0f * num_branches, -3.0f * num_branches};
+
+    RunOptions run_options;
+    std::vector<OrtValue> fetches;
+    auto st = session_object.Run(run_options, feeds, output_names, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, dims_x, expected_values_y);
+  }
+}
+
+TEST(InferenceSessionTests, MultiDeviceSessionShardsBatch) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TensorProto scale;
+  scale.set_name("W");
+  scale.set_data_type(TensorProto_DataType_FLOAT);
+  scale.add_dims(2);
+  scale.add_float_data(2.0f);
+  scale.add_float_data(3.0f);
+  graph.AddInitializedTensor(scale);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& scale_arg = graph.GetOrCreateNodeArg("W", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("mul", "Mul", "Mul", {&input_arg, &scale_arg}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.MultiDeviceSessionShardsBatch";
+  std::vector<std::shared_ptr<IExecutionProviderFactory>> factories{CreateExecutionProviderFactory_CPU(1),
+                                                                    CreateExecutionProviderFactory_CPU(1)};
+  MultiDeviceSession session(so, factories, 2, &DefaultLoggingManager());
+  ASSERT_TRUE(session.Load(model_str.data(), static_cast<int>(model_str.size())).IsOK());
+  auto st = session.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  ASSERT_EQ(2u, session.NumReplicas());
+
+  // the second replica uses the weight of the first one
+  std::unordered_map<std::string, const OrtValue*> initializers[2];
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_TRUE(session.GetReplica(i).GetCpuInitializers(initializers[i]).IsOK());
+    ASSERT_EQ(1u, initializers[i].count("W"));
+  }
+  EXPECT_EQ(&initializers[0]["W"]->Get<Tensor>(), &initializers[1]["W"]->Get<Tensor>());
+
+  // a batch of 5 is split in shards of 3 and 2, a batch of 1 runs whole
+  for (int64_t batch_size : {5, 1}) {
+    std::vector<int64_t> dims_x = {batch_size, 2};
+    std::vector<float> values_x;
+    std::vector<float> expected_values_y;
+    for (int64_t i = 0; i < batch_size; ++i) {
+      values_x.insert(values_x.end(), {static_cast<float>(i), 1.0f});
+      expected_values_y.insert(expected_values_y.end(), {2.0f * i, 3.0f});
+    }
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+
+    RunOptions run_options;
+    std::vector<OrtValue> fetches;
+    st = session.Run(run_options, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, dims_x, expected_values_y);
+  }
+}
+
+TEST(InferenceSessionTests, PipelineParallelSessionMicroBatches) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (const char* name : {"W1", "W2"}) {
+    TensorProto scale;
+    scale.set_name(name);
+    scale.set_data_type(TensorProto_DataType_FLOAT);
+    scale.add_dims(2);
+    scale.add_float_data(2.0f);
+    scale.add_float_data(3.0f);
+    graph.AddInitializedTensor(scale);
+  }
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& hidden_arg = graph.GetOrCreateNodeArg("H", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("mul1", "Mul", "Mul", {&input_arg, &graph.GetOrCreateNodeArg("W1", &tensor_float)}, {&hidden_arg});
+  graph.AddNode("mul2", "Mul", "Mul", {&hidden_arg, &graph.GetOrCreateNodeArg("W2", &tensor_float)}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PipelineParallelSessionMicroBatches";
+  std::vector<std::shared_ptr<IExecutionProviderFactory>> factories{CreateExecutionProviderFactory_CPU(1),
+                                                                    CreateExecutionProviderFactory_CPU(1)};
+  PipelineParallelSession session(so, factories, 2, &DefaultLoggingManager());
+  ASSERT_TRUE(session.Load(model_str.data(), static_cast<int>(model_str.size())).IsOK());
+  auto st = session.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  ASSERT_EQ(2u, session.NumStages());
+
+  // each stage keeps the weight of its node only
+  for (size_t i = 0; i < 2; ++i) {
+    std::unordered_map<std::string, const OrtValue*> initializers;
+    ASSERT_TRUE(session.GetStage(i).GetCpuInitializers(initializers).IsOK());
+    ASSERT_EQ(1u, initializers.size());
+  }
+
+  // a batch of 5 goes through the stages in micro-batches of 2, 2 and 1, a batch of 1 goes whole
+  for (int64_t batch_size : {5, 1}) {
+    std::vector<int64_t> dims_x = {batch_size, 2};
+    std::vector<float> values_x;
+    std::vector<float> expected_values_y;
+    for (int64_t i = 0; i < batch_size; ++i) {
+      values_x.insert(values_x.end(), {static_cast<float>(i), 1.0f});
+      expected_values_y.insert(expected_values_y.end(), {4.0f * i, 9.0f});
+    }
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+
+    RunOptions run_options;
+    std::vector<OrtValue> fetches;
+    st = session.Run(run_options, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, dims_x, expected_values_y);
+  }
+}
+
 #ifdef USE_CUDA
 
 TEST(InferenceSessionTests, TestParallelExecutionWithCudaProvider) {
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include "core/framework/kernel_registry.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Adds an Add node of elem_type inputs to graph, named after the prefix.
+static Node& AddAddNode(Graph& graph, const std::string& prefix, TensorProto_DataType elem_type) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto& a = graph.GetOrCreateNodeArg(prefix + "_a", &type);
+  auto& b = graph.GetOrCreateNodeArg(prefix + "_b", &type);
+  auto& c = graph.GetOrCreateNodeArg(prefix + "_c", &type);
+  return graph.AddNode(prefix + "_add", "Add", "", {&a, &b}, {&c});
+}
+
+TEST(KernelRegistryTest, TryFindKernelBySignature) {
+  CPUExecutionProvider provider{CPUExecutionProviderInfo()};
+  std::shared_ptr<KernelRegistry> registry = provider.GetKernelRegistry();
+
+  Model model("KernelRegistry");
+  auto& graph = model.MainGraph();
+  Node& float_add = AddAddNode(graph, "float", TensorProto_DataType_FLOAT);
+  Node& other_float_add = AddAddNode(graph, "other_float", TensorProto_DataType_FLOAT);
+  Node& int_add = AddAddNode(graph, "int", TensorProto_DataType_INT32);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  const KernelCreateInfo* float_kernel = registry->TryFindKernel(float_add, kCpuExecutionProvider);
+  ASSERT_NE(float_kernel, nullptr);
+  const auto& float_types = float_kernel->kernel_def->TypeConstraints().at("T");
+  ASSERT_NE(std::find(float_types.begin(), float_types.end(), DataTypeImpl::GetTensorType<float>()),
+            float_types.end());
+
+  // a node of the same signature finds the same kernel, again when looked up a second time
+  ASSERT_EQ(registry->TryFindKernel(other_float_add, kCpuExecutionProvider), float_kernel);
+  ASSERT_EQ(registry->TryFindKernel(float_add, kCpuExecutionProvider), float_kernel);
+
+  const KernelCreateInfo* int_kernel = registry->TryFindKernel(int_add, kCpuExecutionProvider);
+  ASSERT_NE(int_kernel, nullptr);
+  const auto& int_types = int_kernel->kernel_def->TypeConstraints().at("T");
+  ASSERT_NE(std::find(int_types.begin(), int_types.end(), DataTypeImpl::GetTensorType<int32_t>()), int_types.end());
+
+  // there is no kernel for another provider, which is cached too
+  ASSERT_EQ(registry->TryFindKernel(float_add, kCudaExecutionProvider), nullptr);
+  ASSERT_EQ(registry->TryFindKernel(float_add, kCudaExecutionProvider), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
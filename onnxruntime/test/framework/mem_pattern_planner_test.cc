@@ -34,5 +34,23 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, StaticPlanningTest) {
+  // a chain where each value is freed after the step consuming it
+  StaticMemPatternPlanner planner;
+  planner.AddValue(0, 1024, 0, 1);
+  planner.AddValue(1, 256, 1, 2);
+  planner.AddValue(2, 512, 2, 3);
+  planner.AddValue(3, 1024, 3, 4);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  // 0 and 3 don't overlap so they share offset 0. 2 overlaps with 3, and 1 overlaps with 0 and 2.
+  EXPECT_EQ(pattern.PeakSize(), 1024 + 512 + 256);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 1024);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 1024 + 512);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_arena.h"
+#include "gtest/gtest.h"
+#include <limits>
+#include <thread>
+
+namespace onnxruntime {
+namespace test {
+static DeviceAllocatorRegistrationInfo CpuRegistrationInfo() {
+  return DeviceAllocatorRegistrationInfo{OrtMemTypeDefault, [](int) { return std::make_unique<CPUAllocator>(); },
+                                         std::numeric_limits<size_t>::max()};
+}
+
+TEST(NumaArenaTest, AllocatesFromSelectedNode) {
+  // placing the memory on a node the machine lacks is only a hint, so the nodes don't need to exist
+  NumaArena a(CpuRegistrationInfo(), {{0}, {1}});
+  EXPECT_EQ(a.NumNodes(), 2u);
+
+  void* node0_ptr;
+  void* node1_ptr;
+  {
+    NumaArena::ScopedNode node(0);
+    node0_ptr = a.Alloc(1024);
+  }
+  {
+    NumaArena::ScopedNode node(1);
+    node1_ptr = a.Alloc(1024);
+  }
+  ASSERT_NE(nullptr, node0_ptr);
+  ASSERT_NE(nullptr, node1_ptr);
+  EXPECT_EQ(a.Used(), 2048u);
+
+  // memory is freed to the arena that allocated it, whatever node the freeing thread uses
+  {
+    NumaArena::ScopedNode node(0);
+    a.Free(node1_ptr);
+  }
+  std::thread([&a, node0_ptr]() {
+    NumaArena::ScopedNode node(1);
+    a.Free(node0_ptr);
+  }).join();
+  EXPECT_EQ(a.Used(), 0u);
+  EXPECT_TRUE(a.Shrink().IsOK());
+}
+
+TEST(NumaArenaTest, SingleNode) {
+  NumaArena a(CpuRegistrationInfo(), {});
+  EXPECT_EQ(a.NumNodes(), 1u);
+
+  // a node the arena doesn't have falls back to the first one
+  NumaArena::ScopedNode node(3);
+  void* ptr = a.Alloc(256);
+  ASSERT_NE(nullptr, ptr);
+  a.Free(ptr);
+  EXPECT_EQ(a.Used(), 0u);
+}
+}  // namespace test
+}  // namespace onnxruntime
@@ -150,5 +150,144 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
 }
 
 INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
+
+// The compiled plan has a step per node of the execution plan, with its kernel, the offset of its values and the
+// values it frees.
+TEST(SessionStateTest, CompiledExecutionPlan) {
+  concurrency::ThreadPool tp{"test", 1};
+
+  std::string model_path = "testdata/optional_inputs_ir4.onnx";
+  Status status;
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE((status = Model::Load(model_path, model)).IsOK()) << status;
+  Graph& graph = model->MainGraph();
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(onnxruntime::kCpuExecutionProvider, std::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SessionState session_state(execution_providers, true, &tp);
+  SessionStateInitializer session_initializer(true, ToWideString(model_path), graph, session_state,
+                                              execution_providers, krm);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  status = partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  status = session_initializer.CreatePlan(nullptr, nullptr, true);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const auto& exec_plan = *session_state.GetExecutionPlan();
+  const auto* compiled_plan = session_state.GetCompiledExecutionPlan();
+  ASSERT_NE(compiled_plan, nullptr);
+  ASSERT_EQ(compiled_plan->steps.size(), exec_plan.execution_plan.size());
+
+  for (size_t i = 0; i < compiled_plan->steps.size(); ++i) {
+    const auto& step = compiled_plan->steps[i];
+    const auto& node_plan = exec_plan.execution_plan[i];
+    EXPECT_EQ(step.kernel, session_state.GetKernel(node_plan.node_index));
+    EXPECT_EQ(step.node_offset, session_state.GetNodeIndexInfo().GetNodeOffset(node_plan.node_index));
+    EXPECT_EQ(step.has_fence, exec_plan.NodeHasFence(node_plan.node_index));
+
+    std::vector<OrtValueIndex> expected_release_values(exec_plan.to_be_freed.begin() + node_plan.free_from_index,
+                                                       exec_plan.to_be_freed.begin() + node_plan.free_to_index + 1);
+    std::vector<OrtValueIndex> release_values(compiled_plan->release_values.begin() + step.release_begin,
+                                              compiled_plan->release_values.begin() + step.release_end);
+    EXPECT_EQ(release_values, expected_release_values);
+  }
+}
+
+// A node has a higher priority than its consumers, as its longest path to the end of the graph goes through them.
+TEST(SessionStateTest, NodePriorities) {
+  concurrency::ThreadPool tp{"test", 1};
+
+  std::string model_path = "testdata/optional_inputs_ir4.onnx";
+  Status status;
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE((status = Model::Load(model_path, model)).IsOK()) << status;
+  Graph& graph = model->MainGraph();
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(onnxruntime::kCpuExecutionProvider, std::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SessionState session_state(execution_providers, true, &tp);
+  SessionStateInitializer session_initializer(true, ToWideString(model_path), graph, session_state,
+                                              execution_providers, krm);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  status = partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr());
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  status = session_initializer.CreatePlan(nullptr, nullptr, true);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const auto& priorities = session_state.GetNodePriorities();
+  ASSERT_EQ(priorities.size(), graph.MaxNodeIndex());
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_GT(priorities[node.Index()], 0);
+    for (auto consumer = node.OutputNodesBegin(); consumer != node.OutputNodesEnd(); ++consumer) {
+      EXPECT_GT(priorities[node.Index()], priorities[consumer->Index()]);
+    }
+  }
+}
+
+TEST(SessionStateTest, MemoryPatternCacheBucketsInputShapes) {
+  concurrency::ThreadPool tp{"test", 1};
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, &tp, 2};
+
+  auto get = [&s](const TensorShape& shape) {
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{std::cref(shape)};
+    return s.GetMemoryPatternGroup(shapes);
+  };
+  auto update = [&s](const TensorShape& shape) {
+    std::vector<std::reference_wrapper<const TensorShape>> shapes{std::cref(shape)};
+    auto status = s.UpdateMemoryPatternGroupCache(shapes, std::make_unique<MemoryPatternGroup>());
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  };
+
+  TensorShape seq_5({1, 5});
+  TensorShape seq_6({1, 6});
+  TensorShape seq_7({1, 7});
+  TensorShape seq_9({1, 9});
+  TensorShape seq_20({1, 20});
+
+  update(seq_6);
+  auto pattern_6 = get(seq_6);
+  ASSERT_NE(pattern_6, nullptr);
+  // smaller shapes in the same bucket re-use the pattern
+  EXPECT_EQ(get(seq_5), pattern_6);
+  // larger shapes in the same bucket can't, until a pattern is generated for them
+  EXPECT_EQ(get(seq_7), nullptr);
+  update(seq_7);
+  auto pattern_7 = get(seq_7);
+  ASSERT_NE(pattern_7, nullptr);
+  EXPECT_NE(pattern_7, pattern_6);
+  EXPECT_EQ(get(seq_5), pattern_7);
+  // a pattern from smaller shapes doesn't replace it
+  update(seq_5);
+  EXPECT_EQ(get(seq_7), pattern_7);
+  // a different bucket
+  EXPECT_EQ(get(seq_9), nullptr);
+
+  // capacity is 2 so adding a third bucket evicts the least recently used one
+  update(seq_9);
+  EXPECT_EQ(get(seq_7), pattern_7);
+  update(seq_20);
+  EXPECT_EQ(get(seq_9), nullptr);
+  EXPECT_EQ(get(seq_7), pattern_7);
+  EXPECT_NE(get(seq_20), nullptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
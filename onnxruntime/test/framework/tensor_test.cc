@@ -194,5 +194,30 @@ TEST(TensorTest, Int64PtrConstructor) {
   EXPECT_THAT(shape.GetDims(), testing::ElementsAre(2, 3));
 }
 
+TEST(TensorTest, StridedViewCopyToContiguous) {
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  Tensor t(DataTypeImpl::GetType<float>(), TensorShape({2, 3}), alloc);
+  float* data = t.MutableData<float>();
+  for (int i = 0; i < 6; ++i) data[i] = static_cast<float>(i);
+  EXPECT_TRUE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(3, 1));
+
+  // the transpose of t, from its second column
+  Tensor view(DataTypeImpl::GetType<float>(), TensorShape({2, 2}), t.MutableDataRaw(), t.Location(),
+              sizeof(float));
+  view.SetStrides({1, 3});
+  EXPECT_FALSE(view.IsContiguous());
+  EXPECT_THAT(view.Strides(), testing::ElementsAre(1, 3));
+
+  Tensor copy(DataTypeImpl::GetType<float>(), TensorShape({2, 2}), alloc);
+  CopyToContiguous(view, copy);
+  EXPECT_THAT(gsl::make_span(copy.Data<float>(), 4), testing::ElementsAre(1.f, 4.f, 2.f, 5.f));
+
+  // the strides of dimensions of size 1 don't matter
+  Tensor row(DataTypeImpl::GetType<float>(), TensorShape({1, 3}), t.MutableDataRaw(), t.Location());
+  row.SetStrides({6, 1});
+  EXPECT_TRUE(row.IsContiguous());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/threadpool.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+void TestParallelFor(concurrency::ThreadPool& tp, int32_t total) {
+  std::vector<std::atomic<int>> counts(static_cast<size_t>(total));
+  for (auto& count : counts) {
+    count = 0;
+  }
+
+  tp.ParallelFor(total, [&counts](int32_t i) { ++counts[i]; });
+
+  for (int32_t i = 0; i < total; ++i) {
+    EXPECT_EQ(counts[i], 1) << "iteration " << i << " of " << total;
+  }
+}
+}  // namespace
+
+TEST(ThreadPoolTest, ParallelFor) {
+  concurrency::ThreadPool tp("test", 4);
+  for (int32_t total : {1, 2, 4, 5, 17, 1000}) {
+    TestParallelFor(tp, total);
+  }
+}
+
+TEST(ThreadPoolTest, LowLatencyParallelFor) {
+  concurrency::ThreadOptions thread_options;
+  thread_options.low_latency = true;
+  concurrency::ThreadPool tp("test", 4, thread_options);
+
+  // repeated so that later calls are run by the threads still polling after the earlier ones
+  for (int repeat = 0; repeat < 100; ++repeat) {
+    for (int32_t total : {1, 2, 4, 5, 17, 1000}) {
+      TestParallelFor(tp, total);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, LowLatencyParallelForConcurrentCallers) {
+  concurrency::ThreadOptions thread_options;
+  thread_options.low_latency = true;
+  thread_options.spin_duration_us = 100;
+  concurrency::ThreadPool tp("test", 3, thread_options);
+
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i) {
+    callers.emplace_back([&tp]() {
+      for (int repeat = 0; repeat < 200; ++repeat) {
+        TestParallelFor(tp, 37);
+      }
+    });
+  }
+
+  for (auto& caller : callers) {
+    caller.join();
+  }
+}
+
+TEST(ThreadPoolTest, LowLatencyParallelForNoSpinning) {
+  concurrency::ThreadOptions thread_options;
+  thread_options.low_latency = true;
+  thread_options.spin_duration_us = 0;
+  concurrency::ThreadPool tp("test", 2, thread_options);
+
+  for (int repeat = 0; repeat < 20; ++repeat) {
+    TestParallelFor(tp, 9);
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
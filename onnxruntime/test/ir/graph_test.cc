@@ -814,6 +814,36 @@ TEST(TypeInferenceTest, VariadicOutput) {
   CheckTensorEltType(Z.TypeAsProto(), TensorProto_DataType_FLOAT);
 }
 
+// Test that a Resolve after changes to a resolved graph infers the new nodes, and re-infers the nodes whose
+// attributes changed, while nodes that did not change keep their types
+TEST(TypeInferenceTest, IncrementalResolve) {
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+  auto& X = graph.GetOrCreateNodeArg("X", &tensor_type);
+  auto& Y = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& cast_1 = graph.AddNode("cast_1", "Cast", "cast 1.", {&X}, {&Y});
+  cast_1.AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  CheckTensorEltType(Y.TypeAsProto(), TensorProto_DataType_FLOAT);
+
+  auto& Z = graph.GetOrCreateNodeArg("Z", nullptr);
+  auto& cast_2 = graph.AddNode("cast_2", "Cast", "cast 2.", {&Y}, {&Z});
+  cast_2.AddAttribute("to", int64_t{TensorProto_DataType_INT64});
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  CheckTensorEltType(Y.TypeAsProto(), TensorProto_DataType_FLOAT);
+  CheckTensorEltType(Z.TypeAsProto(), TensorProto_DataType_INT64);
+
+  // the type Y already has no longer matches the attribute
+  cast_1.AddAttribute("to", int64_t{TensorProto_DataType_DOUBLE});
+  status = graph.Resolve();
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("does not match expected type"), std::string::npos) << status.ErrorMessage();
+}
+
 // Test that Graph::Resolve identifies name-duplication across initializer and node-output-arg
 TEST(NameResolutionTest, DuplicateName) {
   Model model("graph_1");
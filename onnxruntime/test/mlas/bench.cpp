@@ -0,0 +1,872 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bench.cpp
+
+Abstract:
+
+    This module implements microbenchmarks of the MLAS library.
+
+    Each benchmark is registered once for every instruction set dispatch path
+    supported by the processor (see MlasSetMaximumIsa) and, for the routines
+    that accept a thread pool, once for every thread count. The benchmark
+    names are of the form <routine>/<isa>/<arguments>, so a run can be limited
+    to one path with --benchmark_filter and runs of the same binary before and
+    after a kernel or dispatch change can be compared directly.
+
+--*/
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mlas.h>
+
+#if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
+#include "core/platform/threadpool.h"
+#elif defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__)
+#define MLAS_HAS_QGEMM_U8U8
+#endif
+
+//
+// Buffer aligned to the largest preferred buffer alignment of any dispatch
+// path, so that a buffer can be reused after the dispatch path is changed.
+//
+
+template <typename T>
+class AlignedBuffer
+{
+public:
+    AlignedBuffer(size_t Elements, T Value = T(0))
+    {
+        constexpr size_t BufferAlignment = 64;
+
+        _BaseBuffer.reset(new uint8_t[Elements * sizeof(T) + BufferAlignment]);
+        _Buffer = reinterpret_cast<T*>((reinterpret_cast<uintptr_t>(_BaseBuffer.get()) + BufferAlignment - 1) & ~(uintptr_t(BufferAlignment) - 1));
+
+        std::fill_n(_Buffer, Elements, Value);
+    }
+
+    T* get(void)
+    {
+        return _Buffer;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> _BaseBuffer;
+    T* _Buffer;
+};
+
+template <typename T>
+void
+FillBuffer(
+    T* Buffer,
+    size_t Elements,
+    int Range
+    )
+{
+    unsigned Seed = 0x2545F491;
+
+    for (size_t i = 0; i < Elements; i++) {
+        Seed = Seed * 1664525 + 1013904223;
+        Buffer[i] = T(int((Seed >> 16) % unsigned(Range)) - Range / 2);
+    }
+}
+
+//
+// Thread pools are created once per thread count and are shared by all of the
+// benchmarks. A thread count of one runs without a thread pool.
+//
+
+MLAS_THREADPOOL*
+GetThreadPool(
+    int64_t Threads
+    )
+{
+#if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
+    static std::map<int64_t, std::unique_ptr<onnxruntime::concurrency::ThreadPool>> ThreadPools;
+
+    if (Threads <= 1) {
+        return nullptr;
+    }
+
+    auto& ThreadPool = ThreadPools[Threads];
+
+    if (ThreadPool == nullptr) {
+        ThreadPool.reset(new onnxruntime::concurrency::ThreadPool("mlas_bench", int(Threads)));
+    }
+
+    return ThreadPool.get();
+#else
+#if defined(_OPENMP)
+    omp_set_num_threads(int(Threads));
+#endif
+    return nullptr;
+#endif
+}
+
+std::vector<int64_t>
+GetThreadCounts(
+    void
+    )
+{
+    int64_t MaximumThreads = int64_t(std::thread::hardware_concurrency());
+    std::vector<int64_t> ThreadCounts;
+
+    for (int64_t Threads = 1; Threads < MaximumThreads; Threads *= 2) {
+        ThreadCounts.push_back(Threads);
+    }
+
+    ThreadCounts.push_back(std::max(MaximumThreads, int64_t(1)));
+
+    return ThreadCounts;
+}
+
+//
+// The benchmark routines are passed the dispatch path to select before the
+// timed loop. The benchmarks run one at a time, so selecting the dispatch path
+// does not race with other library routines.
+//
+
+void
+SGEMM(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t M = size_t(state.range(0));
+    const size_t N = size_t(state.range(1));
+    const size_t K = size_t(state.range(2));
+    const bool TransB = state.range(3) != 0;
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(4));
+
+    MlasSetMaximumIsa(Isa);
+
+    AlignedBuffer<float> A(M * K);
+    AlignedBuffer<float> B(N * K);
+    AlignedBuffer<float> C(M * N);
+
+    FillBuffer(A.get(), M * K, 23);
+    FillBuffer(B.get(), N * K, 23);
+
+    for (auto _ : state) {
+        MlasSgemm(CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, M, N, K, 1.0f,
+                  A.get(), K, B.get(), TransB ? K : N, 0.0f, C.get(), N, ThreadPool);
+    }
+
+    state.counters["FLOPS"] = benchmark::Counter(double(2 * M * N * K),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void
+SGEMM_PACKB(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t M = size_t(state.range(0));
+    const size_t N = size_t(state.range(1));
+    const size_t K = size_t(state.range(2));
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(4));
+
+    MlasSetMaximumIsa(Isa);
+
+    AlignedBuffer<float> A(M * K);
+    AlignedBuffer<float> B(N * K);
+    AlignedBuffer<float> C(M * N);
+    AlignedBuffer<uint8_t> PackedB(MlasSgemmPackBSize(N, K));
+
+    FillBuffer(A.get(), M * K, 23);
+    FillBuffer(B.get(), N * K, 23);
+
+    MlasSgemmPackB(CblasNoTrans, N, K, B.get(), N, PackedB.get());
+
+    for (auto _ : state) {
+        MlasSgemm(CblasNoTrans, M, N, K, 1.0f, A.get(), K, PackedB.get(), 0.0f,
+                  C.get(), N, ThreadPool);
+    }
+
+    state.counters["FLOPS"] = benchmark::Counter(double(2 * M * N * K),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+#ifdef MLAS_HAS_QGEMM_U8U8
+
+void
+QGEMM(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t M = size_t(state.range(0));
+    const size_t N = size_t(state.range(1));
+    const size_t K = size_t(state.range(2));
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(4));
+
+    MlasSetMaximumIsa(Isa);
+
+    AlignedBuffer<uint8_t> A(M * K);
+    AlignedBuffer<uint8_t> B(N * K);
+    AlignedBuffer<int32_t> C(M * N);
+
+    FillBuffer(A.get(), M * K, 255);
+    FillBuffer(B.get(), N * K, 255);
+
+    for (auto _ : state) {
+        MlasQgemm(M, N, K, A.get(), K, 128, B.get(), N, 128, C.get(), N, ThreadPool);
+    }
+
+    state.counters["OPS"] = benchmark::Counter(double(2 * M * N * K),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+#endif
+
+//
+// Single precision matrix/matrix multiply shapes: the matrix/vector paths,
+// square matrices, and shapes from convolutional and transformer models.
+//
+
+void
+GemmArguments(
+    benchmark::internal::Benchmark* b,
+    bool TransposeB
+    )
+{
+    static const int64_t Shapes[][4] = {
+        // M, N, K, TransB
+        { 1, 4096, 1024, 0 },
+        { 1, 4096, 1024, 1 },
+        { 16, 1024, 1024, 0 },
+        { 64, 64, 64, 0 },
+        { 256, 256, 256, 0 },
+        { 1024, 1024, 1024, 0 },
+        { 1024, 1024, 1024, 1 },
+        { 128, 3072, 768, 0 },
+        { 128, 768, 3072, 0 },
+        { 3136, 64, 576, 0 },
+        { 49, 2048, 512, 0 },
+    };
+
+    b->ArgNames({ "M", "N", "K", "TransB", "Threads" });
+
+    for (const auto& Shape : Shapes) {
+        if (Shape[3] != 0 && !TransposeB) {
+            continue;
+        }
+        for (int64_t Threads : GetThreadCounts()) {
+            b->Args({ Shape[0], Shape[1], Shape[2], Shape[3], Threads });
+        }
+    }
+}
+
+void
+SgemmArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    GemmArguments(b, true);
+}
+
+void
+PackedGemmArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    GemmArguments(b, false);
+}
+
+void
+CONV(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t BatchCount = size_t(state.range(0));
+    const size_t GroupCount = size_t(state.range(1));
+    const size_t InputChannels = size_t(state.range(2));
+    const int64_t InputSize = state.range(3);
+    const size_t FilterCount = size_t(state.range(4));
+    const int64_t KernelSize = state.range(5);
+    const int64_t Stride = state.range(6);
+    const int64_t Pad = state.range(7);
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(8));
+
+    MlasSetMaximumIsa(Isa);
+
+    const int64_t OutputSize = (InputSize + 2 * Pad - KernelSize) / Stride + 1;
+
+    int64_t InputShape[] = { InputSize, InputSize };
+    int64_t KernelShape[] = { KernelSize, KernelSize };
+    int64_t DilationShape[] = { 1, 1 };
+    int64_t Padding[] = { Pad, Pad, Pad, Pad };
+    int64_t StrideShape[] = { Stride, Stride };
+    int64_t OutputShape[] = { OutputSize, OutputSize };
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels,
+                    InputShape, KernelShape, DilationShape, Padding, StrideShape,
+                    OutputShape, FilterCount, &Activation, &WorkingBufferSize,
+                    ThreadPool);
+
+    const size_t InputElements = BatchCount * GroupCount * InputChannels * size_t(InputSize * InputSize);
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * size_t(KernelSize * KernelSize);
+    const size_t OutputElements = BatchCount * GroupCount * FilterCount * size_t(OutputSize * OutputSize);
+
+    AlignedBuffer<float> Input(InputElements);
+    AlignedBuffer<float> Filter(FilterElements);
+    AlignedBuffer<float> Bias(GroupCount * FilterCount);
+    AlignedBuffer<float> WorkingBuffer(std::max(WorkingBufferSize, size_t(1)));
+    AlignedBuffer<float> Output(OutputElements);
+
+    FillBuffer(Input.get(), InputElements, 23);
+    FillBuffer(Filter.get(), FilterElements, 23);
+    FillBuffer(Bias.get(), GroupCount * FilterCount, 23);
+
+    //
+    // The Winograd algorithm consumes a filter that has been transformed once
+    // by the caller.
+    //
+
+    std::unique_ptr<AlignedBuffer<float>> WinogradFilter;
+    const float* ConvFilter = Filter.get();
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+        WinogradFilter.reset(new AlignedBuffer<float>(MlasConvWinogradFilterSize(GroupCount, FilterCount, InputChannels)));
+        MlasConvWinogradTransformFilter(GroupCount, FilterCount, InputChannels, Filter.get(), WinogradFilter->get());
+        ConvFilter = WinogradFilter->get();
+    }
+
+    for (auto _ : state) {
+        MlasConv(&Parameters, Input.get(), ConvFilter, Bias.get(), WorkingBuffer.get(),
+                 Output.get(), ThreadPool);
+    }
+
+    state.counters["FLOPS"] = benchmark::Counter(double(2 * OutputElements * InputChannels * size_t(KernelSize * KernelSize)),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void
+ConvArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    static const int64_t Shapes[][8] = {
+        // Batch, Group, Channels, Size, Filters, Kernel, Stride, Pad
+        { 1, 1, 3, 224, 64, 7, 2, 3 },
+        { 1, 1, 64, 56, 64, 3, 1, 1 },
+        { 1, 1, 256, 56, 64, 1, 1, 0 },
+        { 1, 1, 128, 28, 128, 3, 2, 1 },
+        { 1, 1, 512, 7, 512, 3, 1, 1 },
+        { 4, 1, 64, 56, 64, 3, 1, 1 },
+        { 1, 2, 64, 28, 64, 3, 1, 1 },
+        { 1, 32, 1, 112, 1, 3, 1, 1 },
+        { 1, 144, 1, 56, 1, 5, 1, 2 },
+    };
+
+    b->ArgNames({ "N", "G", "C", "HW", "M", "K", "S", "P", "Threads" });
+
+    for (const auto& Shape : Shapes) {
+        for (int64_t Threads : GetThreadCounts()) {
+            b->Args({ Shape[0], Shape[1], Shape[2], Shape[3], Shape[4], Shape[5], Shape[6], Shape[7], Threads });
+        }
+    }
+}
+
+void
+NCHWC_CONV(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t GroupCount = size_t(state.range(0));
+    const size_t InputChannels = size_t(state.range(1));
+    const int64_t InputSize = state.range(2);
+    const size_t FilterCount = size_t(state.range(3));
+    const int64_t KernelSize = state.range(4);
+    const int64_t Stride = state.range(5);
+    const int64_t Pad = state.range(6);
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(7));
+
+    MlasSetMaximumIsa(Isa);
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    if (BlockSize <= 1) {
+        state.SkipWithError("NCHWc is not supported");
+        return;
+    }
+
+    const int64_t OutputSize = (InputSize + 2 * Pad - KernelSize) / Stride + 1;
+    const size_t NchwcInputChannels = (GroupCount * InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+    const size_t NchwcOutputChannels = (GroupCount * FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { 1, int64_t(GroupCount * InputChannels), InputSize, InputSize };
+    int64_t FilterShape[] = { int64_t(GroupCount * FilterCount), int64_t(InputChannels), KernelSize, KernelSize };
+    int64_t KernelShape[] = { KernelSize, KernelSize };
+    int64_t DilationShape[] = { 1, 1 };
+    int64_t Padding[] = { Pad, Pad, Pad, Pad };
+    int64_t StrideShape[] = { Stride, Stride };
+    int64_t NchwcOutputShape[] = { 1, int64_t(NchwcOutputChannels), OutputSize, OutputSize };
+
+    //
+    // Select the filter and input formats in the same way as the NCHWc graph
+    // transformer: depthwise and NCHW convolutions use the OIHWBo filter
+    // format and the NCHW convolution consumes the input without reordering.
+    //
+
+    const bool Depthwise = (GroupCount > 1 && InputChannels == 1 && FilterCount == 1);
+    const bool DoReorderInput = Depthwise || InputChannels >= BlockSize;
+
+    const size_t InputElements = GroupCount * InputChannels * size_t(InputSize * InputSize);
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * size_t(KernelSize * KernelSize);
+
+    AlignedBuffer<float> Input(InputElements);
+    AlignedBuffer<float> Filter(FilterElements);
+    AlignedBuffer<float> Bias(NchwcOutputChannels);
+    AlignedBuffer<float> NchwcInput(NchwcInputChannels * size_t(InputSize * InputSize));
+    AlignedBuffer<float> NchwcFilter(NchwcOutputChannels * NchwcInputChannels * size_t(KernelSize * KernelSize));
+    AlignedBuffer<float> NchwcOutput(NchwcOutputChannels * size_t(OutputSize * OutputSize));
+
+    FillBuffer(Input.get(), InputElements, 23);
+    FillBuffer(Filter.get(), FilterElements, 23);
+    FillBuffer(Bias.get(), GroupCount * FilterCount, 23);
+
+    if (Depthwise || !DoReorderInput) {
+        MlasReorderFilterOIHWBo(FilterShape, Filter.get(), NchwcFilter.get());
+    } else {
+        MlasReorderFilterOIHWBiBo(FilterShape, Filter.get(), NchwcFilter.get());
+    }
+
+    const float* ConvInput = Input.get();
+
+    if (DoReorderInput) {
+        MlasReorderInput(InputShape, Input.get(), NchwcInput.get());
+        InputShape[1] = int64_t(NchwcInputChannels);
+        ConvInput = NchwcInput.get();
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    for (auto _ : state) {
+        MlasNchwcConv(2, InputShape, KernelShape, DilationShape, Padding, StrideShape,
+                      NchwcOutputShape, GroupCount, ConvInput, NchwcFilter.get(),
+                      Bias.get(), NchwcOutput.get(), &Activation, true, ThreadPool);
+    }
+
+    state.counters["FLOPS"] = benchmark::Counter(double(2 * GroupCount * FilterCount * size_t(OutputSize * OutputSize) * InputChannels * size_t(KernelSize * KernelSize)),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void
+NchwcConvArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    static const int64_t Shapes[][7] = {
+        // Group, Channels, Size, Filters, Kernel, Stride, Pad
+        { 1, 3, 224, 64, 7, 2, 3 },
+        { 1, 64, 56, 64, 3, 1, 1 },
+        { 1, 256, 56, 64, 1, 1, 0 },
+        { 1, 64, 56, 256, 1, 1, 0 },
+        { 1, 128, 28, 128, 3, 2, 1 },
+        { 1, 512, 7, 512, 3, 1, 1 },
+        { 32, 1, 112, 1, 3, 1, 1 },
+        { 144, 1, 56, 1, 5, 1, 2 },
+    };
+
+    b->ArgNames({ "G", "C", "HW", "M", "K", "S", "P", "Threads" });
+
+    for (const auto& Shape : Shapes) {
+        for (int64_t Threads : GetThreadCounts()) {
+            b->Args({ Shape[0], Shape[1], Shape[2], Shape[3], Shape[4], Shape[5], Shape[6], Threads });
+        }
+    }
+}
+
+void
+NCHWC_POOL(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const MLAS_POOLING_KIND PoolingKind = MLAS_POOLING_KIND(state.range(0));
+    const int64_t Channels = state.range(1);
+    const int64_t InputSize = state.range(2);
+    const int64_t KernelSize = state.range(3);
+    const int64_t Stride = state.range(4);
+    const int64_t Pad = state.range(5);
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(6));
+
+    MlasSetMaximumIsa(Isa);
+
+    const int64_t BlockSize = int64_t(MlasNchwcGetBlockSize());
+
+    if (BlockSize <= 1) {
+        state.SkipWithError("NCHWc is not supported");
+        return;
+    }
+
+    const int64_t OutputSize = (InputSize + 2 * Pad - KernelSize) / Stride + 1;
+    const int64_t NchwcChannels = (Channels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { 1, NchwcChannels, InputSize, InputSize };
+    int64_t KernelShape[] = { KernelSize, KernelSize };
+    int64_t Padding[] = { Pad, Pad, Pad, Pad };
+    int64_t StrideShape[] = { Stride, Stride };
+    int64_t OutputShape[] = { 1, NchwcChannels, OutputSize, OutputSize };
+
+    AlignedBuffer<float> Input(size_t(NchwcChannels * InputSize * InputSize));
+    AlignedBuffer<float> Output(size_t(NchwcChannels * OutputSize * OutputSize));
+
+    FillBuffer(Input.get(), size_t(NchwcChannels * InputSize * InputSize), 23);
+
+    for (auto _ : state) {
+        MlasNchwcPool(PoolingKind, 2, InputShape, KernelShape, nullptr, Padding,
+                      StrideShape, OutputShape, Input.get(), Output.get(), ThreadPool);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * NchwcChannels * InputSize * InputSize * int64_t(sizeof(float)));
+}
+
+void
+NchwcPoolArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    static const int64_t Shapes[][5] = {
+        // Channels, Size, Kernel, Stride, Pad
+        { 64, 112, 3, 2, 1 },
+        { 256, 56, 2, 2, 0 },
+        { 2048, 7, 7, 1, 0 },
+    };
+
+    b->ArgNames({ "Kind", "C", "HW", "K", "S", "P", "Threads" });
+
+    for (int64_t PoolingKind = 0; PoolingKind < MlasPoolingKindCount; PoolingKind++) {
+        for (const auto& Shape : Shapes) {
+            for (int64_t Threads : GetThreadCounts()) {
+                b->Args({ PoolingKind, Shape[0], Shape[1], Shape[2], Shape[3], Shape[4], Threads });
+            }
+        }
+    }
+}
+
+void
+ACTIVATION(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t M = size_t(state.range(1));
+    const size_t N = size_t(state.range(2));
+
+    MlasSetMaximumIsa(Isa);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MLAS_ACTIVATION_KIND(state.range(0));
+
+    if (Activation.ActivationKind == MlasLeakyReluActivation) {
+        Activation.Parameters.LeakyRelu.alpha = 0.1f;
+    } else if (Activation.ActivationKind == MlasClipActivation) {
+        Activation.Parameters.Clip.minimum = -6.0f;
+        Activation.Parameters.Clip.maximum = 6.0f;
+    }
+
+    AlignedBuffer<float> Buffer(M * N);
+    AlignedBuffer<float> Bias(M);
+
+    FillBuffer(Bias.get(), M, 23);
+
+    for (auto _ : state) {
+        FillBuffer(Buffer.get(), M * N, 23);
+        MlasActivation(&Activation, Buffer.get(), Bias.get(), M, N, N);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(M * N));
+}
+
+void
+ActivationArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    static const MLAS_ACTIVATION_KIND Kinds[] = {
+        MlasReluActivation,
+        MlasLeakyReluActivation,
+        MlasTanhActivation,
+        MlasLogisticActivation,
+        MlasClipActivation,
+    };
+
+    b->ArgNames({ "Kind", "M", "N" });
+
+    for (MLAS_ACTIVATION_KIND Kind : Kinds) {
+        b->Args({ int64_t(Kind), 64, 3136 });
+        b->Args({ int64_t(Kind), 1, 4096 });
+    }
+}
+
+//
+// Element-wise routines that are dispatched through the platform kernels.
+//
+
+typedef void (MLASCALL *PMLAS_ELEMENTWISE_ROUTINE)(const float* Input, float* Output, size_t N);
+
+void
+ELEMENTWISE(
+    benchmark::State& state,
+    MLAS_ISA Isa,
+    PMLAS_ELEMENTWISE_ROUTINE Routine
+    )
+{
+    const size_t N = size_t(state.range(0));
+
+    MlasSetMaximumIsa(Isa);
+
+    AlignedBuffer<float> Input(N);
+    AlignedBuffer<float> Output(N);
+
+    FillBuffer(Input.get(), N, 23);
+
+    for (auto _ : state) {
+        Routine(Input.get(), Output.get(), N);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(N));
+}
+
+void
+SOFTMAX(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const size_t N = size_t(state.range(0));
+    const size_t D = size_t(state.range(1));
+    const bool LogSoftmax = state.range(2) != 0;
+    MLAS_THREADPOOL* ThreadPool = GetThreadPool(state.range(3));
+
+    MlasSetMaximumIsa(Isa);
+
+    AlignedBuffer<float> Input(N * D);
+    AlignedBuffer<float> Output(N * D);
+
+    FillBuffer(Input.get(), N * D, 23);
+
+    for (auto _ : state) {
+        MlasComputeSoftmax(Input.get(), Output.get(), N, D, LogSoftmax, ThreadPool);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(N * D));
+}
+
+void
+SoftmaxArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    b->ArgNames({ "N", "D", "Log", "Threads" });
+
+    for (int64_t LogSoftmax = 0; LogSoftmax < 2; LogSoftmax++) {
+        for (int64_t Threads : GetThreadCounts()) {
+            b->Args({ 1, 1000, LogSoftmax, Threads });
+            b->Args({ 1536, 128, LogSoftmax, Threads });
+            b->Args({ 128, 30528, LogSoftmax, Threads });
+        }
+    }
+}
+
+void
+REORDER_INPUT(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const int64_t Channels = state.range(0);
+    const int64_t Size = state.range(1);
+
+    MlasSetMaximumIsa(Isa);
+
+    const int64_t BlockSize = int64_t(MlasNchwcGetBlockSize());
+
+    if (BlockSize <= 1) {
+        state.SkipWithError("NCHWc is not supported");
+        return;
+    }
+
+    //
+    // MlasReorderInput only reorders whole blocks of channels.
+    //
+
+    if (Channels % BlockSize != 0) {
+        state.SkipWithError("Channels must be a multiple of the NCHWc block size");
+        return;
+    }
+
+    int64_t InputShape[] = { 1, Channels, Size, Size };
+
+    AlignedBuffer<float> Input(size_t(Channels * Size * Size));
+    AlignedBuffer<float> Output(size_t(Channels * Size * Size));
+
+    FillBuffer(Input.get(), size_t(Channels * Size * Size), 23);
+
+    for (auto _ : state) {
+        MlasReorderInput(InputShape, Input.get(), Output.get());
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * Channels * Size * Size * int64_t(sizeof(float)));
+}
+
+void
+REORDER_OUTPUT(
+    benchmark::State& state,
+    MLAS_ISA Isa
+    )
+{
+    const int64_t Channels = state.range(0);
+    const int64_t Size = state.range(1);
+
+    MlasSetMaximumIsa(Isa);
+
+    const int64_t BlockSize = int64_t(MlasNchwcGetBlockSize());
+
+    if (BlockSize <= 1) {
+        state.SkipWithError("NCHWc is not supported");
+        return;
+    }
+
+    const int64_t NchwcChannels = (Channels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t OutputShape[] = { 1, Channels, Size, Size };
+
+    AlignedBuffer<float> Input(size_t(NchwcChannels * Size * Size));
+    AlignedBuffer<float> Output(size_t(Channels * Size * Size));
+
+    FillBuffer(Input.get(), size_t(NchwcChannels * Size * Size), 23);
+
+    for (auto _ : state) {
+        MlasReorderOutput(OutputShape, Input.get(), Output.get());
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * Channels * Size * Size * int64_t(sizeof(float)));
+}
+
+void
+ReorderArguments(
+    benchmark::internal::Benchmark* b
+    )
+{
+    b->ArgNames({ "C", "HW" });
+    b->Args({ 16, 224 });
+    b->Args({ 64, 112 });
+    b->Args({ 96, 56 });
+    b->Args({ 2048, 7 });
+}
+
+const char*
+GetIsaName(
+    MLAS_ISA Isa
+    )
+{
+    switch (Isa) {
+        case MlasIsaBaseline:
+#if defined(MLAS_HAS_QGEMM_U8U8)
+            return "SSE2";
+#else
+            return "Baseline";
+#endif
+        case MlasIsaAvx:
+            return "AVX";
+        case MlasIsaAvx2:
+            return "AVX2";
+        case MlasIsaAvx512F:
+            return "AVX512F";
+        case MlasIsaAvx512BW:
+            return "AVX512BW";
+        case MlasIsaAvx512Vnni:
+            return "AVX512VNNI";
+    }
+
+    return "Unknown";
+}
+
+void
+RegisterBenchmarks(
+    MLAS_ISA Isa
+    )
+{
+    auto Name = [Isa](const char* Routine) {
+        return std::string(Routine) + "/" + GetIsaName(Isa);
+    };
+
+    benchmark::RegisterBenchmark(Name("SGEMM").c_str(), SGEMM, Isa)->Apply(SgemmArguments)->UseRealTime();
+    benchmark::RegisterBenchmark(Name("SGEMM_PACKB").c_str(), SGEMM_PACKB, Isa)->Apply(PackedGemmArguments)->UseRealTime();
+#ifdef MLAS_HAS_QGEMM_U8U8
+    benchmark::RegisterBenchmark(Name("QGEMM").c_str(), QGEMM, Isa)->Apply(PackedGemmArguments)->UseRealTime();
+#endif
+    benchmark::RegisterBenchmark(Name("CONV").c_str(), CONV, Isa)->Apply(ConvArguments)->UseRealTime();
+    benchmark::RegisterBenchmark(Name("NCHWC_CONV").c_str(), NCHWC_CONV, Isa)->Apply(NchwcConvArguments)->UseRealTime();
+    benchmark::RegisterBenchmark(Name("NCHWC_POOL").c_str(), NCHWC_POOL, Isa)->Apply(NchwcPoolArguments)->UseRealTime();
+    benchmark::RegisterBenchmark(Name("ACTIVATION").c_str(), ACTIVATION, Isa)->Apply(ActivationArguments);
+    benchmark::RegisterBenchmark(Name("LOGISTIC").c_str(), ELEMENTWISE, Isa, MlasComputeLogistic)->Arg(4096)->Arg(65536);
+    benchmark::RegisterBenchmark(Name("TANH").c_str(), ELEMENTWISE, Isa, MlasComputeTanh)->Arg(4096)->Arg(65536);
+    benchmark::RegisterBenchmark(Name("ERF").c_str(), ELEMENTWISE, Isa, MlasComputeErf)->Arg(4096)->Arg(65536);
+    benchmark::RegisterBenchmark(Name("EXP").c_str(), ELEMENTWISE, Isa, MlasComputeExp)->Arg(4096)->Arg(65536);
+    benchmark::RegisterBenchmark(Name("SOFTMAX").c_str(), SOFTMAX, Isa)->Apply(SoftmaxArguments)->UseRealTime();
+    benchmark::RegisterBenchmark(Name("REORDER_INPUT").c_str(), REORDER_INPUT, Isa)->Apply(ReorderArguments);
+    benchmark::RegisterBenchmark(Name("REORDER_OUTPUT").c_str(), REORDER_OUTPUT, Isa)->Apply(ReorderArguments);
+}
+
+int
+#if defined(_WIN32)
+__cdecl
+#endif
+main(
+    int argc,
+    char** argv
+    )
+{
+    //
+    // Register the benchmarks for each dispatch path supported by this
+    // processor. Limiting the selection to an unsupported instruction set
+    // selects a lower instruction set that is registered separately.
+    //
+
+    for (int Isa = MlasIsaBaseline; Isa <= MlasIsaMaximum; Isa++) {
+        if (MlasSetMaximumIsa(MLAS_ISA(Isa)) == MLAS_ISA(Isa)) {
+            RegisterBenchmarks(MLAS_ISA(Isa));
+        }
+    }
+
+    MlasSetMaximumIsa(MlasIsaMaximum);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return -1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
@@ -17,6 +17,7 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <mlas.h>
@@ -244,6 +245,125 @@ private:
                 printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
             }
         }
+
+        //
+        // Repeat the operation with matrix B packed once up front.
+        //
+
+        void* PackedB = BufferBPacked.GetBuffer(MlasSgemmPackBSize(N, K) / sizeof(float));
+
+        MlasSgemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasSgemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+            }
+        }
+    }
+
+    void
+    TestSparse(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferBSparse.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        for (CBLAS_TRANSPOSE TransA : { CblasNoTrans, CblasTrans }) {
+
+            for (CBLAS_TRANSPOSE TransB : { CblasNoTrans, CblasTrans }) {
+
+                size_t lda = (TransA == CblasNoTrans) ? K : M;
+                size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+                //
+                // Keep one in four blocks of 16x16 elements of matrix B so
+                // that it is packed as block sparse.
+                //
+
+                if (TransB == CblasNoTrans) {
+                    for (size_t f = 0; f < N * K; f++) {
+                        B[f] = (((f / N / 16) + (f % N / 16)) % 4 == 0) ? float((f % 11) + 1) : 0.0f;
+                    }
+                } else {
+                    for (size_t f = 0; f < N * K; f++) {
+                        B[f] = (((f / K / 16) + (f % K / 16)) % 4 == 0) ? float((f % 11) + 1) : 0.0f;
+                    }
+                }
+
+                size_t PackedBSize = MlasSgemmPackBSparseSize(TransB, N, K, B, ldb);
+
+                if (PackedBSize == 0) {
+                    printf("not sparse TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd!\n", TransA, TransB, M, N, K);
+                    continue;
+                }
+
+                void* PackedB = BufferBPacked.GetBuffer(PackedBSize / sizeof(float));
+
+                MlasSgemmPackBSparse(TransB, N, K, B, ldb, PackedB);
+
+                std::fill_n(C, M * N, -0.5f);
+                std::fill_n(CReference, M * N, -0.5f);
+
+                MlasSgemmSparse(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool);
+                ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+                for (size_t f = 0; f < M * N; f++) {
+                    if (C[f] != CReference[f]) {
+                        printf("mismatch sparse TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void
+    TestBatch(
+        size_t BatchCount,
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M * BatchCount);
+        const float* B = BufferB.GetBuffer(N * K * BatchCount);
+        float* C = BufferC.GetBuffer(N * M * BatchCount);
+        float* CReference = BufferCReference.GetBuffer(N * M * BatchCount);
+
+        //
+        // Test with a matrix B per operation and with a matrix B shared by
+        // the whole batch.
+        //
+
+        for (size_t StrideB : { N * K, size_t(0) }) {
+
+            std::fill_n(C, M * N * BatchCount, -0.5f);
+            std::fill_n(CReference, M * N * BatchCount, -0.5f);
+
+            MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, K * M, B, N, StrideB, 0.0f, C, N, N * M, BatchCount, threadpool);
+
+            for (size_t batch = 0; batch < BatchCount; batch++) {
+                ReferenceSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A + batch * K * M, K, B + batch * StrideB, N, 0.0f, CReference + batch * N * M, N);
+            }
+
+            for (size_t f = 0; f < M * N * BatchCount; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch batch BatchCount=%zd, M=%zd, N=%zd, K=%zd, StrideB=%zd!\n", BatchCount, M, N, K, StrideB);
+                    break;
+                }
+            }
+        }
     }
 
     void
@@ -357,6 +477,8 @@ private:
 
     MatrixGuardBuffer<float> BufferA;
     MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBPacked;
+    MatrixGuardBuffer<float> BufferBSparse;
     MatrixGuardBuffer<float> BufferC;
     MatrixGuardBuffer<float> BufferCReference;
 
@@ -369,12 +491,22 @@ public:
         for (size_t b = 1; b < 16; b++) {
             Test(b, b, b, 1.0f, 0.0f);
         }
+        for (size_t b = 64; b <= 256; b <<= 1) {
+            TestSparse(b, b, b, 1.0f, 0.0f);
+            TestSparse(b + 3, b + 5, b + 7, -0.5f, 0.25f);
+            TestSparse(b, b + 9, b, 1.0f, 1.0f);
+        }
         for (size_t b = 16; b <= 256; b <<= 1) {
             Test(b, b, b, 1.0f, 0.0f);
         }
         for (size_t b = 256; b < 320; b += 32) {
             Test(b, b, b, 1.0f, 0.0f);
         }
+        for (size_t b = 1; b <= 32; b <<= 1) {
+            TestBatch(b, 16, 16, 16);
+            TestBatch(b, 7, 45, 13);
+            TestBatch(b, 96, 17, 64);
+        }
     }
 
     void
@@ -452,6 +584,144 @@ public:
     }
 };
 
+class MlasHalfGemmTest : public MlasTestBase
+{
+private:
+    //
+    // The test values are small multiples of 0.25 that both half precision and
+    // bfloat16 represent exactly, so the products sum exactly in single
+    // precision and the results can be compared bit for bit.
+    //
+
+    static
+    unsigned short
+    FloatToHalf(
+        float Value
+        )
+    {
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+
+        if ((Bits & 0x7FFFFFFF) == 0) {
+            return (unsigned short)(Bits >> 16);
+        }
+
+        uint32_t Exponent = ((Bits >> 23) & 0xFF) - 127 + 15;
+
+        return (unsigned short)(((Bits >> 16) & 0x8000) | (Exponent << 10) | ((Bits >> 13) & 0x3FF));
+    }
+
+    static
+    unsigned short
+    FloatToBFloat16(
+        float Value
+        )
+    {
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+
+        return (unsigned short)(Bits >> 16);
+    }
+
+    void
+    Test(
+        bool BFloat16,
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        float* A = BufferA.GetBuffer(K * M);
+        float* B = BufferB.GetBuffer(N * K);
+        unsigned short* AReduced = BufferAReduced.GetBuffer(K * M);
+        unsigned short* BReduced = BufferBReduced.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        for (size_t i = 0; i < K * M; i++) {
+            A[i] = float(int(i % 23) - 11) * 0.25f;
+            AReduced[i] = BFloat16 ? FloatToBFloat16(A[i]) : FloatToHalf(A[i]);
+        }
+
+        for (size_t i = 0; i < N * K; i++) {
+            B[i] = float(int(i % 19) - 9) * 0.25f;
+            BReduced[i] = BFloat16 ? FloatToBFloat16(B[i]) : FloatToHalf(B[i]);
+        }
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        size_t lda = (TransA == CblasNoTrans) ? K : M;
+        size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+        if (BFloat16) {
+            MlasBFloat16Gemm(TransA, TransB, M, N, K, alpha, AReduced, lda, BReduced, ldb, beta, C, N, threadpool);
+        } else {
+            MlasHalfGemm(TransA, TransB, M, N, K, alpha, AReduced, lda, BReduced, ldb, beta, C, N, threadpool);
+        }
+
+        MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch BFloat16=%d, TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", int(BFloat16), TransA, TransB, M, N, K, alpha, beta);
+                break;
+            }
+        }
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        for (bool BFloat16 : { false, true }) {
+            Test(BFloat16, CblasNoTrans, CblasNoTrans, M, N, K, alpha, beta);
+            Test(BFloat16, CblasNoTrans, CblasTrans, M, N, K, alpha, beta);
+            Test(BFloat16, CblasTrans, CblasNoTrans, M, N, K, alpha, beta);
+            Test(BFloat16, CblasTrans, CblasTrans, M, N, K, alpha, beta);
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<unsigned short> BufferAReduced;
+    MatrixGuardBuffer<unsigned short> BufferBReduced;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        Test(33, 161, 263, 0.5f, 1.0f);
+        Test(150, 17, 129, 1.0f, 2.0f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8U8
 
 class MlasQgemmU8U8Test : public MlasTestBase
@@ -501,6 +771,64 @@ private:
                 printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
             }
         }
+
+        //
+        // Repeat the operation with matrix B packed once up front.
+        //
+
+        void* PackedB = BufferBPacked.GetBuffer((MlasQgemmPackBSize(N, K) + 63) & ~size_t(63));
+
+        MlasQgemmPackB(N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -1);
+
+        MlasQgemm(M, N, K, A, lda, offa, PackedB, offb, C, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+            }
+        }
+    }
+
+    void
+    TestBatch(
+        size_t BatchCount,
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        uint8_t offb
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M * BatchCount);
+        const uint8_t* B = BufferB.GetBuffer(N * K * BatchCount);
+        int32_t* C = BufferC.GetBuffer(N * M * BatchCount);
+        int32_t* CReference = BufferCReference.GetBuffer(N * M * BatchCount);
+
+        //
+        // Test with a matrix B per operation and with a matrix B shared by
+        // the whole batch.
+        //
+
+        for (size_t StrideB : { N * K, size_t(0) }) {
+
+            std::fill_n(C, M * N * BatchCount, -1);
+            std::fill_n(CReference, M * N * BatchCount, -1);
+
+            MlasQgemmBatch(M, N, K, A, K, K * M, offa, B, N, StrideB, offb, C, N, N * M, BatchCount, threadpool);
+
+            for (size_t batch = 0; batch < BatchCount; batch++) {
+                ReferenceQgemm(M, N, K, A + batch * K * M, K, offa, B + batch * StrideB, N, offb, CReference + batch * N * M, N);
+            }
+
+            for (size_t f = 0; f < M * N * BatchCount; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch batch BatchCount=%zd, M=%zd, N=%zd, K=%zd, offa=%d, offb=%d, StrideB=%zd!\n", BatchCount, M, N, K, offa, offb, StrideB);
+                    break;
+                }
+            }
+        }
     }
 
     void
@@ -540,6 +868,7 @@ private:
 
     MatrixGuardBuffer<uint8_t> BufferA;
     MatrixGuardBuffer<uint8_t> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
     MatrixGuardBuffer<int32_t> BufferC;
     MatrixGuardBuffer<int32_t> BufferCReference;
 
@@ -558,6 +887,11 @@ public:
         for (size_t b = 256; b < 320; b += 32) {
             Test(b, b, b, 85, 173);
         }
+        for (size_t b = 1; b <= 32; b <<= 1) {
+            TestBatch(b, 16, 16, 16, 14, 211);
+            TestBatch(b, 7, 45, 13, 34, 1);
+            TestBatch(b, 96, 17, 64, 85, 173);
+        }
     }
 
     void
@@ -679,6 +1013,8 @@ protected:
         float* Output = BufferOutput.GetBuffer(OutputElements);
         float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
 
+        ApproximateResult = false;
+
         MlasConv2D(BatchCount,
                    GroupCount,
                    InputChannels,
@@ -710,7 +1046,36 @@ protected:
                         Bias,
                         OutputReference);
 
-        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+        bool Mismatch;
+
+        if (ApproximateResult) {
+
+            //
+            // The transforms round intermediate values proportional to the
+            // magnitude of the outputs, so scale the tolerance by the
+            // largest reference output.
+            //
+
+            float MaximumValue = 1.0f;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                MaximumValue = std::max(MaximumValue, std::fabs(OutputReference[i]));
+            }
+
+            Mismatch = false;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                if (std::fabs(Output[i] - OutputReference[i]) > MaximumValue * 1e-4f) {
+                    Mismatch = true;
+                    break;
+                }
+            }
+
+        } else {
+            Mismatch = (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0);
+        }
+
+        if (Mismatch) {
             printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
                 BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
                 KernelHeight, KernelWidth);
@@ -773,6 +1138,28 @@ protected:
                         &WorkingBufferSize,
                         nullptr);
 
+        if (ForceAlgorithm) {
+            MlasConvSelectAlgorithm(&Parameters, ForcedAlgorithm, &WorkingBufferSize, nullptr);
+        }
+
+        //
+        // The Winograd algorithm requires the filter to be transformed and
+        // only produces results within a tolerance of the reference.
+        //
+
+        ApproximateResult = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
+        if (ApproximateResult) {
+
+            float* TransformedFilter = BufferWinogradFilter.GetBuffer(
+                MlasConvWinogradFilterSize(GroupCount, FilterCount, InputChannels));
+
+            MlasConvWinogradTransformFilter(GroupCount, FilterCount, InputChannels, Filter,
+                TransformedFilter);
+
+            Filter = TransformedFilter;
+        }
+
         MlasConv(&Parameters,
                  Input,
                  Filter,
@@ -879,6 +1266,10 @@ protected:
     MatrixGuardBuffer<float> BufferOutputReference;
     MatrixGuardBuffer<float> BufferWorking;
     MatrixGuardBuffer<float> BufferIm2Col;
+    MatrixGuardBuffer<float> BufferWinogradFilter;
+    bool ApproximateResult;
+    bool ForceAlgorithm = false;
+    MLAS_CONV_ALGORITHM ForcedAlgorithm;
 
 public:
     void
@@ -894,7 +1285,34 @@ public:
             Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i, 1, 3, 3, 2, 2, 2, 2, 2, 2, 1, 1);
+            Test(1, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 2, 2);
+            Test(2, 32, 1, i, i, 1, 7, 7, 3, 3, 3, 3, 1, 1, 1, 1);
+            Test(2, 1, 16, i + 3, i + 5, 24, 3, 3, 1, 0, 0, 1, 1, 1, 1, 1);
+            Test(1, 1, 64, i, i + 2, 48, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1);
         }
+
+        //
+        // Compute the 3x3 convolutions with each of the algorithms that
+        // MlasConvSelectAlgorithm can switch between.
+        //
+
+        for (MLAS_CONV_ALGORITHM Algorithm : { MlasConvAlgorithmWinograd, MlasConvAlgorithmExpandThenGemm }) {
+
+            ForceAlgorithm = true;
+            ForcedAlgorithm = Algorithm;
+
+            for (unsigned i = 1; i < 256; i <<= 1) {
+                Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+                Test(2, 1, 16, i + 3, i + 5, 24, 3, 3, 1, 0, 0, 1, 1, 1, 1, 1);
+            }
+        }
+
+        ForceAlgorithm = false;
     }
 
     void
@@ -915,6 +1333,26 @@ public:
             Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
         }
 
+        for (unsigned i = 4; i <= 40; i += 3) {
+            Test(2, 3, 16, i, i + 1, 16, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 2, 32, i, i, 24, 3, 3, 0, 0, 2, 2, 1, 1, 1, 1);
+        }
+
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                for (unsigned k = 1; k <= 5; k++) {
+                    for (unsigned p = 0; p <= 2; p++) {
+                        for (unsigned d = 1; d <= 2; d++) {
+                            for (unsigned s = 1; s <= 2; s++) {
+                                Test(3, 14, 1, is[ih], is[iw], 1, k, k, p, p, p, 0, d, d, s, s);
+                                Test(3, 14, 1, is[ih], is[iw], 1, k, 3, p, 0, 0, p, d, 1, s, 1);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
         for (unsigned ic = 0; ic < _countof(cs); ic++) {
             for (unsigned ih = 0; ih < _countof(is); ih++) {
                 for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1260,6 +1698,20 @@ protected:
         MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
     }
 
+    //
+    // Returns false if the pooling under test requires a channel count that is a
+    // multiple of the NCHWc block size.
+    //
+
+    virtual
+    bool
+    SupportsUnalignedChannels(
+        void
+        ) const
+    {
+        return true;
+    }
+
     void
     ReferenceMaximumPool2D(
         const int64_t* InputShape,
@@ -1413,6 +1865,10 @@ public:
             Test(1, 16, i, i, 1, 1, 0, 0, 0, 0, 1, 1);
             Test(1, 16, i, i, i, 1, 0, 0, 0, 0, 1, 1);
             Test(1, 16, i, i, 1, i, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, i, i, 0, 0, 0, 0, 1, 1);
+            if (SupportsUnalignedChannels()) {
+                Test(2, 97, i, i, i, i, 0, 0, 0, 0, 1, 1);
+            }
         }
     }
 
@@ -1499,6 +1955,18 @@ protected:
         MlasReorderOutput(OutputShape, NchwcOutput, Output);
     }
 
+    bool
+    SupportsUnalignedChannels(
+        void
+        ) const override
+    {
+        //
+        // MlasReorderInput only reorders whole blocks of channels.
+        //
+
+        return false;
+    }
+
     MatrixGuardBuffer<float> BufferNchwcInput;
     MatrixGuardBuffer<float> BufferNchwcOutput;
 
@@ -1543,6 +2011,67 @@ public:
 
 };
 
+class MlasNhwcPool2DTest : public MlasPool2DTest
+{
+protected:
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        ) override
+    {
+        const size_t BatchCount = size_t(InputShape[0]);
+        const size_t Channels = size_t(InputShape[1]);
+        const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+        const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+        int64_t NhwcInputShape[] = { InputShape[0], InputShape[2], InputShape[3], InputShape[1] };
+        float* NhwcInput = BufferNhwcInput.GetBuffer(BatchCount * InputSize * Channels);
+
+        int64_t NhwcOutputShape[] = { OutputShape[0], OutputShape[2], OutputShape[3], OutputShape[1] };
+        float* NhwcOutput = BufferNhwcOutput.GetBuffer(BatchCount * OutputSize * Channels);
+
+        for (size_t n = 0; n < BatchCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < InputSize; i++) {
+                    NhwcInput[(n * InputSize + i) * Channels + c] = Input[(n * Channels + c) * InputSize + i];
+                }
+            }
+        }
+
+        bool IsGlobal = KernelShape[0] == InputShape[2] && KernelShape[1] == InputShape[3] &&
+            Padding[0] == 0 && Padding[1] == 0 && Padding[2] == 0 && Padding[3] == 0;
+
+        MlasNhwcPool(PoolingKind,
+                     2,
+                     NhwcInputShape,
+                     IsGlobal ? nullptr : KernelShape,
+                     IsGlobal ? nullptr : Padding,
+                     IsGlobal ? nullptr : StrideShape,
+                     NhwcOutputShape,
+                     NhwcInput,
+                     NhwcOutput,
+                     threadpool);
+
+        for (size_t n = 0; n < BatchCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < OutputSize; i++) {
+                    Output[(n * Channels + c) * OutputSize + i] = NhwcOutput[(n * OutputSize + i) * Channels + c];
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferNhwcInput;
+    MatrixGuardBuffer<float> BufferNhwcOutput;
+};
+
 class MlasPool3DTest : public MlasTestBase
 {
 protected:
@@ -1958,6 +2487,244 @@ public:
     }
 };
 
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    void
+    TestExp(
+        size_t N
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = -110.0f + float(n % 200);
+        }
+
+        MlasComputeExp(Input, Output, N);
+
+        for (size_t n = 0; n < N; n++) {
+            float Reference = std::exp(Input[n]);
+            float Difference = std::fabs(Output[n] - Reference);
+            if (!(Difference <= 1e-6f * Reference + std::numeric_limits<float>::denorm_min() * 2) &&
+                !(std::isinf(Reference) && Output[n] == Reference)) {
+                printf("mismatch exp: N=%zd n=%zd value=%e expected=%e\n", N, n, Output[n], Reference);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceSoftmax(
+        const float* Input,
+        float* Output,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        for (size_t n = 0; n < N; n++) {
+
+            double Maximum = Input[0];
+
+            for (size_t d = 1; d < D; d++) {
+                Maximum = (std::max)(Maximum, double(Input[d]));
+            }
+
+            double Sum = 0.0;
+
+            for (size_t d = 0; d < D; d++) {
+                Sum += std::exp(double(Input[d]) - Maximum);
+            }
+
+            for (size_t d = 0; d < D; d++) {
+                if (LogSoftmax) {
+                    Output[d] = float(double(Input[d]) - Maximum - std::log(Sum));
+                } else {
+                    Output[d] = float(std::exp(double(Input[d]) - Maximum) / Sum);
+                }
+            }
+
+            Input += D;
+            Output += D;
+        }
+    }
+
+    void
+    TestSoftmax(
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = float(int32_t((nd * 7919) % 401) - 200) * 0.125f;
+        }
+
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
+        ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+
+        constexpr float AbsoluteTolerance = 1e-6f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            float Difference = std::fabs(Output[nd] - OutputReference[nd]);
+            if (!(Difference <= AbsoluteTolerance + RelativeTolerance * std::fabs(OutputReference[nd]))) {
+                printf("mismatch softmax: N=%zd D=%zd log=%d nd=%zd value=%e expected=%e\n",
+                    N, D, int(LogSoftmax), nd, Output[nd], OutputReference[nd]);
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 128; n++) {
+            TestExp(n);
+        }
+
+        for (size_t d = 1; d < 128; d++) {
+            TestSoftmax(1, d, false);
+            TestSoftmax(1, d, true);
+            TestSoftmax(3, d, false);
+            TestSoftmax(3, d, true);
+        }
+
+        TestSoftmax(63, 95, false);
+        TestSoftmax(63, 95, true);
+        TestSoftmax(16, 32000, false);
+        TestSoftmax(16, 32000, true);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+class MlasHalfConvertTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<unsigned short> BufferHalf;
+    MatrixGuardBuffer<unsigned short> BufferHalfOutput;
+    MatrixGuardBuffer<float> BufferFloat;
+
+    static
+    bool
+    IsHalfNaN(
+        unsigned short Value
+        )
+    {
+        return (Value & 0x7C00) == 0x7C00 && (Value & 0x03FF) != 0;
+    }
+
+    void
+    TestRoundTrip(
+        size_t Start,
+        size_t N
+        )
+    {
+        unsigned short* Half = BufferHalf.GetBuffer(N);
+        unsigned short* HalfOutput = BufferHalfOutput.GetBuffer(N);
+        float* Float = BufferFloat.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Half[n] = (unsigned short)(Start + n);
+        }
+
+        //
+        // Every half precision value is exact in single precision, so the
+        // conversions must restore each value.
+        //
+
+        MlasConvertHalfToFloatBuffer(Half, Float, N);
+        MlasConvertFloatToHalfBuffer(Float, HalfOutput, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (IsHalfNaN(Half[n]) ? !IsHalfNaN(HalfOutput[n]) : HalfOutput[n] != Half[n]) {
+                printf("mismatch half round trip: N=%zd n=%zd value=%04x expected=%04x\n", N, n, HalfOutput[n], Half[n]);
+                break;
+            }
+        }
+    }
+
+    void
+    TestRounding(
+        void
+        )
+    {
+        //
+        // The values halfway between adjacent finite half precision values
+        // round to the even value, and those past the largest value round to
+        // infinity.
+        //
+
+        const size_t N = 0x7C00;
+
+        unsigned short* Half = BufferHalf.GetBuffer(N);
+        unsigned short* HalfOutput = BufferHalfOutput.GetBuffer(N);
+        float* Float = BufferFloat.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Half[n] = (unsigned short)n;
+        }
+
+        MlasConvertHalfToFloatBuffer(Half, Float, N);
+
+        for (size_t n = 0; n < N - 1; n++) {
+            Float[n] = (Float[n] + Float[n + 1]) * 0.5f;
+        }
+        Float[N - 1] = 65520.0f;
+
+        MlasConvertFloatToHalfBuffer(Float, HalfOutput, N);
+
+        for (size_t n = 0; n < N; n++) {
+            unsigned short Expected = (unsigned short)((n & 1) ? n + 1 : n);
+            if (HalfOutput[n] != Expected) {
+                printf("mismatch half rounding: n=%zd value=%04x expected=%04x\n", n, HalfOutput[n], Expected);
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 32; n++) {
+            TestRoundTrip(0x3C00 - n, n);
+            TestRoundTrip(0x8000 + n, n);
+        }
+
+        TestRoundTrip(0, 0x10000);
+        TestRounding();
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
 int
 #if defined(_WIN32)
 __cdecl
@@ -1970,6 +2737,9 @@ main(
         printf("SGEMM tests.\n");
         std::make_unique<MlasSgemmTest>()->ExecuteShort();
 
+        printf("Half precision GEMM tests.\n");
+        std::make_unique<MlasHalfGemmTest>()->ExecuteShort();
+
 #ifdef MLAS_HAS_QGEMM_U8U8
         printf("QGEMM tests.\n");
         std::make_unique<MlasQgemmU8U8Test>()->ExecuteShort();
@@ -1986,6 +2756,7 @@ main(
         if (MlasNchwcGetBlockSize() > 1) {
             std::make_unique<MlasNchwcPool2DTest>()->ExecuteShort();
         }
+        std::make_unique<MlasNhwcPool2DTest>()->ExecuteShort();
 
         printf("Pool3D tests.\n");
         std::make_unique<MlasPool3DTest>()->ExecuteShort();
@@ -1993,6 +2764,12 @@ main(
         printf("Activation tests.\n");
         std::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Softmax tests.\n");
+        std::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+        printf("Half conversion tests.\n");
+        std::make_unique<MlasHalfConvertTest>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
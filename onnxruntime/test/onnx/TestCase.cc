@@ -240,6 +240,9 @@ class OnnxModelInfo : public TestModelInfo {
   const ONNX_NAMESPACE::ValueInfoProto* GetOutputInfoFromModel(size_t i) const override {
     return &output_value_info_[i];
   }
+  const ONNX_NAMESPACE::ValueInfoProto* GetInputInfoFromModel(size_t i) const override {
+    return &input_value_info_[i];
+  }
   int GetInputCount() const override { return static_cast<int>(input_value_info_.size()); }
   int GetOutputCount() const override { return static_cast<int>(output_value_info_.size()); }
   const std::string& GetInputName(size_t i) const override { return input_value_info_[i].name(); }
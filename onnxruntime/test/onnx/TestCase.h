@@ -50,6 +50,8 @@ class TestModelInfo {
   }
   virtual const std::string& GetNodeName() const = 0;
   virtual const ONNX_NAMESPACE::ValueInfoProto* GetOutputInfoFromModel(size_t i) const = 0;
+  // nullptr if the model doesn't describe its inputs with ONNX value infos
+  virtual const ONNX_NAMESPACE::ValueInfoProto* GetInputInfoFromModel(size_t) const { return nullptr; }
   virtual int GetInputCount() const = 0;
   virtual int GetOutputCount() const = 0;
   virtual const std::string& GetInputName(size_t i) const = 0;
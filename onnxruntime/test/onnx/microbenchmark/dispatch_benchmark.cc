@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of the cost the executor adds to each node: chains of Add nodes on single element tensors, whose
+// kernels do almost no work, so the time of a Run divided by the number of nodes is the dispatch overhead of a node.
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <core/framework/allocator.h>
+#include <core/framework/tensor.h>
+#include <core/graph/model.h>
+#include <core/session/inference_session.h>
+
+using namespace onnxruntime;
+
+namespace {
+
+constexpr int kOpsetVersion = 10;
+
+// the serialized model of Y = X + 1 + 1 + ... with num_nodes Add nodes
+Status BuildAddChain(int64_t num_nodes, std::string& model_data) {
+  Model model("dispatch_benchmark", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, kOpsetVersion}});
+  Graph& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  ONNX_NAMESPACE::TensorProto one;
+  one.set_name("one");
+  one.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  one.add_dims(1);
+  one.add_float_data(1.f);
+  graph.AddInitializedTensor(one);
+  NodeArg* one_arg = &graph.GetOrCreateNodeArg("one", &type);
+
+  NodeArg* input_arg = &graph.GetOrCreateNodeArg("X", &type);
+  for (int64_t i = 0; i < num_nodes; ++i) {
+    const std::string output_name = i + 1 == num_nodes ? "Y" : "T" + std::to_string(i);
+    NodeArg* output_arg = &graph.GetOrCreateNodeArg(output_name, &type);
+    graph.AddNode("add" + std::to_string(i), "Add", "", {input_arg, one_arg}, {output_arg});
+    input_arg = output_arg;
+  }
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  if (!model.ToProto().SerializeToString(&model_data)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to serialize the model");
+  }
+  return Status::OK();
+}
+
+OrtValue CreateTensorValue(float value) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  auto p_tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape({1}), allocator);
+  *p_tensor->MutableData<float>() = value;
+
+  OrtValue ort_value;
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return ort_value;
+}
+
+// Runs a chain of state.range(0) nodes. The ns_per_node counter is the time of a Run divided by its nodes.
+void BM_DispatchAddChain(benchmark::State& state) {
+  const int64_t num_nodes = state.range(0);
+  std::string model_data;
+  auto st = BuildAddChain(num_nodes, model_data);
+
+  SessionOptions so;
+  InferenceSession session{so};
+  if (st.IsOK()) {
+    st = session.Load(model_data.data(), static_cast<int>(model_data.size()));
+  }
+  if (st.IsOK()) {
+    st = session.Initialize();
+  }
+
+  RunOptions run_options;
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  const std::vector<OrtValue> feeds{CreateTensorValue(0.f)};
+  std::vector<OrtValue> fetches;
+
+  // warm up: the first Run allocates the buffers of the memory pattern
+  if (st.IsOK()) {
+    st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+  }
+  if (!st.IsOK()) {
+    state.SkipWithError(st.ErrorMessage().c_str());
+    return;
+  }
+
+  int64_t num_runs = 0;
+  const auto begin = std::chrono::high_resolution_clock::now();
+  for (auto _ : state) {
+    fetches.clear();
+    st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+    if (!st.IsOK()) {
+      state.SkipWithError(st.ErrorMessage().c_str());
+      return;
+    }
+    ++num_runs;
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - begin);
+
+  if (num_runs > 0) {
+    state.counters["ns_per_node"] = elapsed.count() / (num_runs * num_nodes);
+  }
+}
+BENCHMARK(BM_DispatchAddChain)->Arg(1)->Arg(100)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -65,6 +65,7 @@ OrtEnv* env = nullptr;
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return -1;
+  // the env creates the default logger, which the sessions the benchmarks create without a logging manager log to
   ORT_ABORT_ON_ERROR(OrtCreateEnv(ORT_LOGGING_LEVEL_WARNING, "test", &env));
   ::benchmark::RunSpecifiedBenchmarks();
   OrtReleaseEnv(env);
@@ -0,0 +1,376 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of single node graphs of the common operators at representative shapes, run through InferenceSession
+// on every execution provider of the build. Each benchmark is named BM_Op/<case>/<provider>, so
+// --benchmark_filter selects operators or providers. To compare commits, save the results of each build with
+// --benchmark_out=<file>.json --benchmark_out_format=json and diff them with compare.py of Google Benchmark.
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <core/framework/allocator.h>
+#include <core/framework/tensor.h>
+#include <core/graph/model.h>
+#include <core/session/inference_session.h>
+#include "default_providers.h"
+
+using namespace onnxruntime;
+using ONNX_NAMESPACE::TensorProto_DataType;
+using ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+using ONNX_NAMESPACE::TensorProto_DataType_INT64;
+
+namespace {
+
+constexpr int kOpsetVersion = 10;
+
+// An input of the node. The float inputs are fed with random values in [0, 1) unless they are initializers.
+// The int64 inputs, such as shapes or indices, are always initializers.
+struct OpInput {
+  std::string name;
+  std::vector<int64_t> shape;
+  TensorProto_DataType type;
+  bool is_initializer;
+  std::vector<float> float_data;  // random if empty
+  std::vector<int64_t> int64_data;
+};
+
+OpInput Float(std::string name, std::vector<int64_t> shape) {
+  return {std::move(name), std::move(shape), TensorProto_DataType_FLOAT, false, {}, {}};
+}
+
+OpInput FloatConst(std::string name, std::vector<int64_t> shape, std::vector<float> data = {}) {
+  return {std::move(name), std::move(shape), TensorProto_DataType_FLOAT, true, std::move(data), {}};
+}
+
+OpInput Int64Const(std::string name, std::vector<int64_t> shape, std::vector<int64_t> data) {
+  return {std::move(name), std::move(shape), TensorProto_DataType_INT64, true, {}, std::move(data)};
+}
+
+// random int64 values in [0, max)
+OpInput Int64RandomConst(std::string name, std::vector<int64_t> shape, int64_t max) {
+  std::mt19937 engine(0);
+  std::uniform_int_distribution<int64_t> dist(0, max - 1);
+  int64_t size = 1;
+  for (auto dim : shape) {
+    size *= dim;
+  }
+  std::vector<int64_t> data(static_cast<size_t>(size));
+  for (auto& value : data) {
+    value = dist(engine);
+  }
+  return Int64Const(std::move(name), std::move(shape), std::move(data));
+}
+
+struct OpCase {
+  std::string name;
+  std::string op_type;
+  std::vector<OpInput> inputs;
+  size_t num_outputs;
+  std::function<void(Node&)> add_attributes;
+};
+
+std::function<void(Node&)> Ints(std::string name, std::vector<int64_t> values) {
+  return [name, values](Node& node) { node.AddAttribute(name, values); };
+}
+
+std::function<void(Node&)> Int(std::string name, int64_t value) {
+  return [name, value](Node& node) { node.AddAttribute(name, value); };
+}
+
+std::function<void(Node&)> Attributes(std::vector<std::function<void(Node&)>> attributes) {
+  return [attributes](Node& node) {
+    for (const auto& add_attribute : attributes) {
+      add_attribute(node);
+    }
+  };
+}
+
+// an elementwise operator of a single input
+OpCase Unary(const std::string& op_type, std::vector<int64_t> shape) {
+  return {op_type, op_type, {Float("X", std::move(shape))}, 1, nullptr};
+}
+
+const std::vector<OpCase>& OpCases() {
+  static const std::vector<OpCase> cases{
+      // convolutions
+      {"Conv_3x3_64x56x56", "Conv",
+       {Float("X", {1, 64, 56, 56}), FloatConst("W", {64, 64, 3, 3}), FloatConst("B", {64})}, 1,
+       Ints("pads", {1, 1, 1, 1})},
+      {"Conv_1x1_256x14x14", "Conv", {Float("X", {1, 256, 14, 14}), FloatConst("W", {256, 256, 1, 1})}, 1, nullptr},
+      {"Conv_7x7_s2_3x224x224", "Conv", {Float("X", {1, 3, 224, 224}), FloatConst("W", {64, 3, 7, 7})}, 1,
+       Attributes({Ints("strides", {2, 2}), Ints("pads", {3, 3, 3, 3})})},
+      {"Conv_depthwise_3x3_128x56x56", "Conv", {Float("X", {1, 128, 56, 56}), FloatConst("W", {128, 1, 3, 3})}, 1,
+       Attributes({Int("group", 128), Ints("pads", {1, 1, 1, 1})})},
+      {"ConvTranspose_4x4_s2_64x28x28", "ConvTranspose",
+       {Float("X", {1, 64, 28, 28}), FloatConst("W", {64, 32, 4, 4})}, 1,
+       Attributes({Ints("strides", {2, 2}), Ints("pads", {1, 1, 1, 1})})},
+
+      // matrix multiplications
+      {"MatMul_128x768x768", "MatMul", {Float("A", {128, 768}), FloatConst("B", {768, 768})}, 1, nullptr},
+      {"MatMul_batched_12x128x64x128", "MatMul", {Float("A", {12, 128, 64}), Float("B", {12, 64, 128})}, 1, nullptr},
+      {"Gemm_1x1024x1000", "Gemm",
+       {Float("A", {1, 1024}), FloatConst("B", {1000, 1024}), FloatConst("C", {1000})}, 1, Int("transB", 1)},
+      {"Gemm_64x512x512", "Gemm", {Float("A", {64, 512}), FloatConst("B", {512, 512}), FloatConst("C", {512})}, 1,
+       nullptr},
+
+      // elementwise
+      {"Add_64x128x128", "Add", {Float("A", {1, 64, 128, 128}), Float("B", {1, 64, 128, 128})}, 1, nullptr},
+      {"Add_broadcast_64x56x56", "Add", {Float("A", {1, 64, 56, 56}), FloatConst("B", {64, 1, 1})}, 1, nullptr},
+      {"Mul_64x128x128", "Mul", {Float("A", {1, 64, 128, 128}), Float("B", {1, 64, 128, 128})}, 1, nullptr},
+      {"Div_64x128x128", "Div", {Float("A", {1, 64, 128, 128}), Float("B", {1, 64, 128, 128})}, 1, nullptr},
+      {"Pow_64x56x56", "Pow", {Float("X", {1, 64, 56, 56}), FloatConst("Y", {}, {2.f})}, 1, nullptr},
+      Unary("Relu", {1, 64, 112, 112}),
+      Unary("Sigmoid", {1, 64, 112, 112}),
+      Unary("Tanh", {1, 64, 112, 112}),
+      Unary("Exp", {1, 64, 112, 112}),
+      Unary("Erf", {1, 64, 112, 112}),
+      Unary("Abs", {1, 64, 112, 112}),
+      {"LeakyRelu", "LeakyRelu", {Float("X", {1, 64, 112, 112})}, 1, nullptr},
+      {"Clip", "Clip", {Float("X", {1, 64, 112, 112})}, 1,
+       [](Node& node) {
+         node.AddAttribute("min", 0.f);
+         node.AddAttribute("max", 6.f);
+       }},
+      {"Cast_float_to_int64", "Cast", {Float("X", {1, 64, 112, 112})}, 1,
+       Int("to", TensorProto_DataType_INT64)},
+
+      // normalizations
+      {"Softmax_128x1000", "Softmax", {Float("X", {128, 1000})}, 1, nullptr},
+      {"Softmax_attention_12x128x128", "Softmax", {Float("X", {12, 128, 128})}, 1, Int("axis", 2)},
+      {"LogSoftmax_128x1000", "LogSoftmax", {Float("X", {128, 1000})}, 1, nullptr},
+      {"BatchNormalization_64x56x56", "BatchNormalization",
+       {Float("X", {1, 64, 56, 56}), FloatConst("scale", {64}), FloatConst("B", {64}), FloatConst("mean", {64}),
+        FloatConst("var", {64})},
+       1, nullptr},
+      {"InstanceNormalization_64x56x56", "InstanceNormalization",
+       {Float("X", {1, 64, 56, 56}), FloatConst("scale", {64}), FloatConst("B", {64})}, 1, nullptr},
+      {"LRN_64x56x56", "LRN", {Float("X", {1, 64, 56, 56})}, 1, Int("size", 5)},
+
+      // pooling
+      {"MaxPool_3x3_s2_64x112x112", "MaxPool", {Float("X", {1, 64, 112, 112})}, 1,
+       Attributes({Ints("kernel_shape", {3, 3}), Ints("strides", {2, 2}), Ints("pads", {1, 1, 1, 1})})},
+      {"AveragePool_3x3_64x56x56", "AveragePool", {Float("X", {1, 64, 56, 56})}, 1,
+       Attributes({Ints("kernel_shape", {3, 3}), Ints("pads", {1, 1, 1, 1})})},
+      {"GlobalAveragePool_2048x7x7", "GlobalAveragePool", {Float("X", {1, 2048, 7, 7})}, 1, nullptr},
+      {"GlobalMaxPool_2048x7x7", "GlobalMaxPool", {Float("X", {1, 2048, 7, 7})}, 1, nullptr},
+
+      // reductions
+      {"ReduceSum_spatial_64x56x56", "ReduceSum", {Float("X", {1, 64, 56, 56})}, 1, Ints("axes", {2, 3})},
+      {"ReduceMean_128x768", "ReduceMean", {Float("X", {128, 768})}, 1, Ints("axes", {1})},
+      {"ReduceMax_128x1000", "ReduceMax", {Float("X", {128, 1000})}, 1, Ints("axes", {1})},
+      {"ReduceL2_128x768", "ReduceL2", {Float("X", {128, 768})}, 1, Ints("axes", {1})},
+      {"ArgMax_128x1000", "ArgMax", {Float("X", {128, 1000})}, 1, Int("axis", 1)},
+      {"TopK_5_128x1000", "TopK", {Float("X", {128, 1000}), Int64Const("K", {1}, {5})}, 2, nullptr},
+
+      // data movement
+      {"Transpose_NCHW_to_NHWC_64x56x56", "Transpose", {Float("X", {1, 64, 56, 56})}, 1,
+       Ints("perm", {0, 2, 3, 1})},
+      {"Transpose_heads_128x12x64", "Transpose", {Float("X", {128, 12, 64})}, 1, Ints("perm", {1, 0, 2})},
+      {"Reshape_64x56x56", "Reshape", {Float("X", {1, 64, 56, 56}), Int64Const("shape", {2}, {1, -1})}, 1, nullptr},
+      {"Concat_2x64x56x56", "Concat", {Float("A", {1, 64, 56, 56}), Float("B", {1, 64, 56, 56})}, 1,
+       Int("axis", 1)},
+      {"Split_128x56x56", "Split", {Float("X", {1, 128, 56, 56})}, 2, Int("axis", 1)},
+      {"Slice_64x56x56", "Slice",
+       {Float("X", {1, 64, 56, 56}), Int64Const("starts", {2}, {8, 8}), Int64Const("ends", {2}, {48, 48}),
+        Int64Const("axes", {2}, {2, 3})},
+       1, nullptr},
+      {"Gather_embeddings_8192x768", "Gather",
+       {FloatConst("data", {8192, 768}), Int64RandomConst("indices", {1, 128}, 8192)}, 1, nullptr},
+      {"Tile_64x28x28", "Tile", {Float("X", {1, 64, 28, 28}), Int64Const("repeats", {4}, {1, 1, 2, 2})}, 1,
+       nullptr},
+      {"Expand_64x56x56", "Expand", {Float("X", {64, 1, 1}), Int64Const("shape", {4}, {1, 64, 56, 56})}, 1,
+       nullptr},
+      {"Pad_64x56x56", "Pad", {Float("X", {1, 64, 56, 56})}, 1, Ints("pads", {0, 0, 1, 1, 0, 0, 1, 1})},
+      {"Resize_nearest_64x56x56", "Resize", {Float("X", {1, 64, 56, 56}), FloatConst("scales", {4}, {1, 1, 2, 2})},
+       1, nullptr},
+      {"Resize_linear_64x56x56", "Resize", {Float("X", {1, 64, 56, 56}), FloatConst("scales", {4}, {1, 1, 2, 2})},
+       1, [](Node& node) { node.AddAttribute("mode", std::string("linear")); }},
+
+      // recurrent
+      {"LSTM_32x256", "LSTM",
+       {Float("X", {32, 1, 256}), FloatConst("W", {1, 1024, 256}), FloatConst("R", {1, 1024, 256}),
+        FloatConst("B", {1, 2048})},
+       3, Int("hidden_size", 256)},
+      {"GRU_32x256", "GRU",
+       {Float("X", {32, 1, 256}), FloatConst("W", {1, 768, 256}), FloatConst("R", {1, 768, 256}),
+        FloatConst("B", {1, 1536})},
+       2, Int("hidden_size", 256)},
+
+      // detection
+      {"NonMaxSuppression_1000", "NonMaxSuppression",
+       {Float("boxes", {1, 1000, 4}), Float("scores", {1, 1, 1000}), Int64Const("max_output_boxes_per_class", {1}, {100}),
+        FloatConst("iou_threshold", {1}, {0.5f})},
+       1, nullptr},
+  };
+  return cases;
+}
+
+struct OpProvider {
+  std::string name;
+  // nullptr for the CPU provider, which sessions register by default
+  std::function<std::unique_ptr<IExecutionProvider>()> create;
+};
+
+const std::vector<OpProvider>& OpProviders() {
+  static const std::vector<OpProvider> providers{
+      {"cpu", nullptr},
+#ifdef USE_CUDA
+      {"cuda", []() { return test::DefaultCudaExecutionProvider(); }},
+#endif
+#ifdef USE_MKLDNN
+      {"mkldnn", []() { return test::DefaultMkldnnExecutionProvider(); }},
+#endif
+#ifdef USE_NGRAPH
+      {"ngraph", []() { return test::DefaultNGraphExecutionProvider(); }},
+#endif
+#ifdef USE_NUPHAR
+      {"nuphar", []() { return test::DefaultNupharExecutionProvider(); }},
+#endif
+#ifdef USE_TENSORRT
+      {"tensorrt", []() { return test::DefaultTensorrtExecutionProvider(); }},
+#endif
+#ifdef USE_OPENVINO
+      {"openvino", []() { return test::DefaultOpenVINOExecutionProvider(); }},
+#endif
+  };
+  return providers;
+}
+
+OrtValue CreateRandomTensorValue(const std::vector<int64_t>& dims, std::mt19937& engine) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  auto p_tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape(dims), allocator);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  auto* data = p_tensor->MutableData<float>();
+  for (int64_t i = 0; i != p_tensor->Shape().Size(); ++i) {
+    data[i] = dist(engine);
+  }
+
+  OrtValue ort_value;
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return ort_value;
+}
+
+// the serialized model of the node of the case, and the feeds of its float inputs
+Status BuildModel(const OpCase& op_case, std::string& model_data, std::vector<std::string>& feed_names,
+                  std::vector<OrtValue>& feeds, std::vector<std::string>& output_names) {
+  std::mt19937 engine(0);
+  Model model("op_benchmark", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, kOpsetVersion}});
+  Graph& graph = model.MainGraph();
+
+  std::vector<NodeArg*> input_args;
+  for (const auto& input : op_case.inputs) {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(input.type);
+    for (auto dim : input.shape) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    input_args.push_back(&graph.GetOrCreateNodeArg(input.name, &type));
+
+    if (!input.is_initializer) {
+      feed_names.push_back(input.name);
+      feeds.push_back(CreateRandomTensorValue(input.shape, engine));
+      continue;
+    }
+
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(input.name);
+    tensor_proto.set_data_type(input.type);
+    int64_t size = 1;
+    for (auto dim : input.shape) {
+      tensor_proto.add_dims(dim);
+      size *= dim;
+    }
+    if (input.type == TensorProto_DataType_INT64) {
+      for (auto value : input.int64_data) {
+        tensor_proto.add_int64_data(value);
+      }
+    } else if (!input.float_data.empty()) {
+      for (auto value : input.float_data) {
+        tensor_proto.add_float_data(value);
+      }
+    } else {
+      std::uniform_real_distribution<float> dist(0.f, 1.f);
+      for (int64_t i = 0; i != size; ++i) {
+        tensor_proto.add_float_data(dist(engine));
+      }
+    }
+    graph.AddInitializedTensor(tensor_proto);
+  }
+
+  std::vector<NodeArg*> output_args;
+  for (size_t i = 0; i != op_case.num_outputs; ++i) {
+    output_names.push_back("Y" + std::to_string(i));
+    output_args.push_back(&graph.GetOrCreateNodeArg(output_names.back(), nullptr));
+  }
+
+  Node& node = graph.AddNode("node", op_case.op_type, op_case.op_type, input_args, output_args);
+  if (op_case.add_attributes) {
+    op_case.add_attributes(node);
+  }
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  if (!model.ToProto().SerializeToString(&model_data)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to serialize the model of ", op_case.name);
+  }
+  return Status::OK();
+}
+
+void RunOp(benchmark::State& state, const OpCase& op_case, const OpProvider& provider) {
+  std::string model_data;
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  auto st = BuildModel(op_case, model_data, feed_names, feeds, output_names);
+
+  SessionOptions so;
+  InferenceSession session{so};
+  if (st.IsOK() && provider.create) {
+    st = session.RegisterExecutionProvider(provider.create());
+  }
+  if (st.IsOK()) {
+    st = session.Load(model_data.data(), static_cast<int>(model_data.size()));
+  }
+  if (st.IsOK()) {
+    st = session.Initialize();
+  }
+
+  // warm up: the first Run allocates the buffers of the memory pattern
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  if (st.IsOK()) {
+    st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+  }
+  if (!st.IsOK()) {
+    state.SkipWithError(st.ErrorMessage().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    fetches.clear();
+    st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+    if (!st.IsOK()) {
+      state.SkipWithError(st.ErrorMessage().c_str());
+      break;
+    }
+  }
+}
+
+bool RegisterOpBenchmarks() {
+  for (const auto& op_case : OpCases()) {
+    for (const auto& provider : OpProviders()) {
+      const std::string name = "BM_Op/" + op_case.name + "/" + provider.name;
+      benchmark::RegisterBenchmark(name.c_str(), [&op_case, &provider](benchmark::State& state) {
+        RunOp(state, op_case, provider);
+      })->Unit(benchmark::kMicrosecond);
+    }
+  }
+  return true;
+}
+
+const bool op_benchmarks_registered = RegisterOpBenchmarks();
+
+}  // namespace
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <core/framework/allocator.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+
+using namespace onnxruntime;
+
+// counts the heap allocations of the process, so the benchmarks can report how many a Run does
+static std::atomic<size_t> num_allocations{0};
+
+void* operator new(size_t size) {
+  ++num_allocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+static OrtValue CreateTensorValue(const std::vector<int64_t>& dims, float value) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  auto p_tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape(dims), allocator);
+  auto* data = p_tensor->MutableData<float>();
+  std::fill(data, data + p_tensor->Shape().Size(), value);
+
+  OrtValue ort_value;
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return ort_value;
+}
+
+// Runs testdata/mul_1.onnx (Y = X * X, with X of shape {3, 2}) with the same feeds and pre-allocated fetches.
+static void RunMul(benchmark::State& state, bool enable_run_state_cache) {
+  SessionOptions so;
+  so.enable_run_state_cache = enable_run_state_cache;
+
+  InferenceSession session{so};
+  auto st = session.Load("testdata/mul_1.onnx");
+  if (st.IsOK()) {
+    st = session.Initialize();
+  }
+  if (!st.IsOK()) {
+    state.SkipWithError(st.ErrorMessage().c_str());
+    return;
+  }
+
+  RunOptions run_options;
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  const std::vector<OrtValue> feeds{CreateTensorValue({3, 2}, 2.f)};
+  std::vector<OrtValue> fetches{CreateTensorValue({3, 2}, 0.f)};
+
+  // warm up: the first Run creates the cached state
+  st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+  if (!st.IsOK()) {
+    state.SkipWithError(st.ErrorMessage().c_str());
+    return;
+  }
+
+  size_t num_runs = 0;
+  const size_t allocations_before = num_allocations;
+  for (auto _ : state) {
+    st = session.Run(run_options, feed_names, feeds, output_names, &fetches);
+    if (!st.IsOK()) {
+      state.SkipWithError(st.ErrorMessage().c_str());
+      break;
+    }
+    ++num_runs;
+  }
+
+  if (num_runs > 0) {
+    state.counters["allocs_per_run"] = static_cast<double>(num_allocations - allocations_before) / num_runs;
+  }
+}
+
+static void BM_RunMul(benchmark::State& state) {
+  RunMul(state, false);
+}
+BENCHMARK(BM_RunMul);
+
+static void BM_RunMul_RunStateCache(benchmark::State& state) {
+  RunMul(state, true);
+}
+BENCHMARK(BM_RunMul_RunStateCache);
@@ -8,20 +8,31 @@ namespace onnxruntime {
 namespace test {
 
 // Dummy graph transformer that does nothing, but just sets the modified value
+// for its first modifying_invocations invocations
 class DummyGraphTransformer : public GraphTransformer {
  public:
-  DummyGraphTransformer(const std::string& name) noexcept : GraphTransformer(name),
-                                                            transformer_invoked_(false) {}
+  DummyGraphTransformer(const std::string& name, int modifying_invocations = 0) noexcept
+      : GraphTransformer(name),
+        transformer_invoked_(false),
+        invocation_count_(0),
+        modifying_invocations_(modifying_invocations) {}
 
   bool IsTransformerInvoked() const {
     return transformer_invoked_;
   }
 
+  int InvocationCount() const {
+    return invocation_count_;
+  }
+
  private:
   mutable bool transformer_invoked_;
+  mutable int invocation_count_;
+  const int modifying_invocations_;
 
-  Status ApplyImpl(Graph& /*graph*/, bool& /*modified*/, int /*graph_level*/) const override {
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/) const override {
     transformer_invoked_ = true;
+    modified = invocation_count_++ < modifying_invocations_;
     return Status::OK();
   }
 };
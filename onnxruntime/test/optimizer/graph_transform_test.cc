@@ -1,12 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <numeric>
+
 #include "core/session/inference_session.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
+#include "core/optimizer/initializer.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/slice_elimination.h"
@@ -14,10 +17,26 @@
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
+#include "core/optimizer/gemm_bn_fusion.h"
+#include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/conv_activation_fusion.h"
+#include "core/optimizer/conv_add_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/norm_activation_fusion.h"
+#include "core/optimizer/nhwc_pool_transformer.h"
+#include "core/optimizer/cuda_nhwc_transformer.h"
+#include "core/optimizer/sparse_matmul_transformer.h"
+#include "core/optimizer/weight_compression_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/zipmap_elimination.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/attention_fusion.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
 #include "core/util/math.h"
@@ -28,6 +47,9 @@
 #include "gtest/gtest.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/optimizer/symbolic_shape_folding.h"
 #include "core/optimizer/shape_to_initializer.h"
 
 using namespace std;
@@ -115,6 +137,73 @@ TEST(GraphTransformationTests, ConstantFolding) {
   ASSERT_TRUE(op_to_count["Unsqueeze"] == 0);
 }
 
+TEST(GraphTransformationTests, ConstantFoldingSizeLimit) {
+  auto fold = [](size_t max_output_bytes, std::map<std::string, int>& op_to_count) {
+    Model model("ConstantFoldingSizeLimit");
+    auto& graph = model.MainGraph();
+
+    auto add_initializer = [&graph](const std::string& name, TensorProto_DataType data_type,
+                                    const std::vector<int64_t>& dims, const std::vector<int64_t>& values) -> NodeArg& {
+      TensorProto tensor;
+      tensor.set_name(name);
+      tensor.set_data_type(data_type);
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(data_type);
+      for (auto dim : dims) {
+        tensor.add_dims(dim);
+        type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+      }
+      for (auto value : values) {
+        if (data_type == TensorProto_DataType_INT64) {
+          tensor.add_int64_data(value);
+        } else {
+          tensor.add_float_data(static_cast<float>(value));
+        }
+      }
+      graph.AddInitializedTensor(tensor);
+      return graph.GetOrCreateNodeArg(name, &type);
+    };
+    auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+    // A ConstantOfShape with a small output, one with an output much larger than its input, and a Transpose of a
+    // 64x64 weight, whose output is as large as its input.
+    auto& small_shape = add_initializer("small_shape", TensorProto_DataType_INT64, {2}, {2, 3});
+    auto& large_shape = add_initializer("large_shape", TensorProto_DataType_INT64, {2}, {256, 256});
+    auto& weight = add_initializer("weight", TensorProto_DataType_FLOAT, {64, 64}, std::vector<int64_t>(64 * 64, 1));
+    graph.AddNode("small", "ConstantOfShape", "", {&small_shape}, {&make_arg("small_out")});
+    graph.AddNode("large", "ConstantOfShape", "", {&large_shape}, {&make_arg("large_out")});
+    graph.AddNode("transpose", "Transpose", "", {&weight}, {&make_arg("transpose_out")});
+
+    // Consume the results so they are not graph outputs.
+    TypeProto input_type;
+    input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+    graph.AddNode("add_small", "Add", "", {&x, &make_arg("small_out")}, {&make_arg("y0")});
+    graph.AddNode("add_large", "Add", "", {&x, &make_arg("large_out")}, {&make_arg("y1")});
+    graph.AddNode("add_transpose", "Add", "", {&x, &make_arg("transpose_out")}, {&make_arg("y2")});
+
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(
+        std::make_unique<ConstantFolding>(std::unordered_set<std::string>{}, max_output_bytes),
+        TransformerLevel::Level1);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+    op_to_count = CountOpsInGraph(graph);
+  };
+
+  std::map<std::string, int> op_to_count;
+  fold(ConstantFolding::kDefaultMaxOutputBytes, op_to_count);
+  ASSERT_EQ(op_to_count["ConstantOfShape"], 1);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+
+  // The Transpose output exceeds the limit.
+  fold(1024, op_to_count);
+  ASSERT_EQ(op_to_count["ConstantOfShape"], 1);
+  ASSERT_EQ(op_to_count["Transpose"], 1);
+}
+
 TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
   TensorProto value_tensor;
   value_tensor.add_dims(1);
@@ -189,6 +278,221 @@ TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // two initializers with different names and the same value
+  for (const auto* name : {"w0", "w1"}) {
+    TensorProto weight;
+    weight.set_name(name);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(2);
+    weight.add_dims(3);
+    for (int i = 0; i < 6; ++i) {
+      weight.add_float_data(static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(weight);
+  }
+
+  auto make_arg = [&](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, &tensor_type); };
+
+  // Relu(x) twice and Mul(x, w0), Mul(x, w1), which are the same once the initializers are merged.
+  // The RandomUniformLike nodes are not deterministic and must be kept.
+  graph.AddNode("relu0", "Relu", "", {&make_arg("x")}, {&make_arg("relu0_out")});
+  graph.AddNode("relu1", "Relu", "", {&make_arg("x")}, {&make_arg("relu1_out")});
+  graph.AddNode("add", "Add", "", {&make_arg("relu0_out"), &make_arg("relu1_out")}, {&make_arg("add_out")});
+  graph.AddNode("mul0", "Mul", "", {&make_arg("add_out"), &make_arg("w0")}, {&make_arg("mul0_out")});
+  graph.AddNode("mul1", "Mul", "", {&make_arg("add_out"), &make_arg("w1")}, {&make_arg("mul1_out")});
+  graph.AddNode("sub", "Sub", "", {&make_arg("mul0_out"), &make_arg("mul1_out")}, {&make_arg("sub_out")});
+  graph.AddNode("random0", "RandomUniformLike", "", {&make_arg("x")}, {&make_arg("random0_out")});
+  graph.AddNode("random1", "RandomUniformLike", "", {&make_arg("x")}, {&make_arg("random1_out")});
+  graph.AddNode("sum", "Sum", "", {&make_arg("sub_out"), &make_arg("random0_out"), &make_arg("random1_out")},
+                {&make_arg("y")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<CommonSubexpressionElimination>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 1);
+  ASSERT_EQ(op_to_count["RandomUniformLike"], 2);
+
+  const TensorProto* tensor = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("w0", tensor));
+  ASSERT_FALSE(graph.GetInitializedTensor("w1", tensor));
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Add" || node.OpType() == "Sub") {
+      ASSERT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, TransposeOptimizer) {
+  Model model("TransposeOptimizer");
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto nhwc_type = make_type({1, 4, 5, 3});
+  TypeProto nchw_type = make_type({1, 3, 4, 5});
+
+  TensorProto scalar;
+  scalar.set_name("scale");
+  scalar.set_data_type(TensorProto_DataType_FLOAT);
+  scalar.add_float_data(2.0f);
+  graph.AddInitializedTensor(scalar);
+  TypeProto scalar_type = make_type({});
+
+  auto& x = graph.GetOrCreateNodeArg("x", &nchw_type);
+  auto& z = graph.GetOrCreateNodeArg("z", &nchw_type);
+  auto& scale = graph.GetOrCreateNodeArg("scale", &scalar_type);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+  auto add_transpose = [&graph](const std::string& name, NodeArg& input, NodeArg& output,
+                                std::vector<int64_t> perm) {
+    graph.AddNode(name, "Transpose", "", {&input}, {&output}).AddAttribute("perm", perm);
+  };
+
+  // NCHW -> NHWC, Relu, Mul by a scalar, Add with another NCHW -> NHWC input, then back to NCHW.
+  // Every Transpose can be pushed down until it cancels with the last one.
+  add_transpose("to_nhwc", x, make_arg("x_nhwc"), {0, 2, 3, 1});
+  graph.AddNode("relu", "Relu", "", {&make_arg("x_nhwc")}, {&make_arg("relu_out")});
+  graph.AddNode("mul", "Mul", "", {&make_arg("relu_out"), &scale}, {&make_arg("mul_out")});
+  add_transpose("z_to_nhwc", z, make_arg("z_nhwc"), {0, 2, 3, 1});
+  graph.AddNode("add", "Add", "", {&make_arg("z_nhwc"), &make_arg("mul_out")}, {&make_arg("add_out")});
+  add_transpose("to_nchw", make_arg("add_out"), make_arg("y"), {0, 3, 1, 2});
+
+  // Two transposes that combine into a single one.
+  auto& w = graph.GetOrCreateNodeArg("w", &nchw_type);
+  add_transpose("swap_hw", w, make_arg("w_swapped"), {0, 1, 3, 2});
+  add_transpose("swap_cw", make_arg("w_swapped"), make_arg("w_out"), {0, 2, 1, 3});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Transpose") {
+      std::vector<int64_t> perm;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+      ASSERT_EQ(perm, (std::vector<int64_t>{0, 3, 1, 2}));
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "w");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "w_out");
+    }
+    if (node.OpType() == "Relu") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "x");
+    }
+    if (node.OpType() == "Add") {
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "y");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, SymbolicShapeFolding) {
+  Model model("SymbolicShapeFolding");
+  auto& graph = model.MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(6);
+  auto& x = graph.GetOrCreateNodeArg("x", &x_type);
+
+  auto add_int64_initializer = [&graph](const std::string& name, const std::vector<int64_t>& values,
+                                        bool is_scalar) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_INT64);
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    if (!is_scalar) {
+      tensor.add_dims(static_cast<int64_t>(values.size()));
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(values.size());
+    }
+    for (auto value : values) {
+      tensor.add_int64_data(value);
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+  auto& zero = add_int64_initializer("zero", {0}, true);
+  auto& one = add_int64_initializer("one", {1}, true);
+  auto& six = add_int64_initializer("six", {6}, false);
+
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // Reshape(x, [batch, 4, 6]) with the batch gathered from Shape(x) and 4 sliced from it, which is [0, 4, 6].
+  graph.AddNode("shape", "Shape", "", {&x}, {&make_arg("shape_out")});
+  graph.AddNode("gather_batch", "Gather", "", {&make_arg("shape_out"), &zero}, {&make_arg("batch")});
+  graph.AddNode("unsqueeze", "Unsqueeze", "", {&make_arg("batch")}, {&make_arg("batch_1d")})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  Node& slice = graph.AddNode("slice", "Slice", "", {&make_arg("shape_out")}, {&make_arg("rows")});
+  slice.AddAttribute("starts", std::vector<int64_t>{1});
+  slice.AddAttribute("ends", std::vector<int64_t>{2});
+  graph.AddNode("concat", "Concat", "", {&make_arg("batch_1d"), &make_arg("rows"), &six}, {&make_arg("target")})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("reshape", "Reshape", "", {&x, &make_arg("target")}, {&make_arg("y")});
+
+  // Reshape(x, [batch * 4, 6]), where the product is only known at run time, which is [-1, 6].
+  graph.AddNode("gather_rows", "Gather", "", {&make_arg("shape_out"), &one}, {&make_arg("rows_scalar")});
+  graph.AddNode("mul", "Mul", "", {&make_arg("batch"), &make_arg("rows_scalar")}, {&make_arg("flat")});
+  graph.AddNode("unsqueeze_flat", "Unsqueeze", "", {&make_arg("flat")}, {&make_arg("flat_1d")})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("concat_flat", "Concat", "", {&make_arg("flat_1d"), &six}, {&make_arg("flat_target")})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("reshape_flat", "Reshape", "", {&x, &make_arg("flat_target")}, {&make_arg("z")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<SymbolicShapeFolding>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Reshape"], 2);
+  ASSERT_EQ(op_to_count["Shape"], 0);
+  ASSERT_EQ(op_to_count["Gather"], 0);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 0);
+  ASSERT_EQ(op_to_count["Slice"], 0);
+  ASSERT_EQ(op_to_count["Concat"], 0);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    const TensorProto* tensor = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), tensor));
+    std::vector<int64_t> shape(tensor->int64_data().begin(), tensor->int64_data().end());
+    if (node.OutputDefs()[0]->Name() == "y") {
+      ASSERT_EQ(shape, (std::vector<int64_t>{0, 4, 6}));
+    } else {
+      ASSERT_EQ(shape, (std::vector<int64_t>{-1, 6}));
+    }
+  }
+}
+
 TEST(GraphTransformationTests, ShapeToInitializer) {
   string model_uri = MODEL_FOLDER + "shape-add.onnx";
   std::shared_ptr<Model> model;
@@ -285,6 +589,142 @@ TEST(GraphTransformationTests, FuseConvBNMulAddUnsqueeze) {
   }
 }
 
+static TypeProto MakeTensorType(TensorProto_DataType elem_type, std::initializer_list<int64_t> dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  for (auto dim : dims) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+static NodeArg& AddFloatInitializer(Graph& graph, const std::string& name, std::initializer_list<int64_t> dims,
+                                    float fill) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  int64_t size = 1;
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    size *= dim;
+  }
+  for (int64_t i = 0; i < size; ++i) {
+    tensor.add_float_data(fill + 0.01f * i);
+  }
+  graph.AddInitializedTensor(tensor);
+
+  TypeProto type = MakeTensorType(TensorProto_DataType_FLOAT, dims);
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+TEST(GraphTransformationTests, FuseGemmBN) {
+  for (const std::string op_type : {"Gemm", "MatMul"}) {
+    Model model("FuseGemmBN");
+    auto& graph = model.MainGraph();
+
+    TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 3});
+    auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+    auto& gemm_out = graph.GetOrCreateNodeArg("gemm_out", nullptr);
+    auto& y = graph.GetOrCreateNodeArg("y", nullptr);
+    auto& scale = AddFloatInitializer(graph, "scale", {4}, 1.0f);
+    auto& bias = AddFloatInitializer(graph, "bias", {4}, 0.5f);
+    auto& mean = AddFloatInitializer(graph, "mean", {4}, 0.1f);
+    auto& var = AddFloatInitializer(graph, "var", {4}, 1.0f);
+
+    if (op_type == "Gemm") {
+      auto& weight = AddFloatInitializer(graph, "weight", {4, 3}, 0.1f);
+      auto& c = AddFloatInitializer(graph, "c", {4}, 0.2f);
+      auto& gemm = graph.AddNode("gemm", "Gemm", "", {&x, &weight, &c}, {&gemm_out});
+      gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    } else {
+      auto& weight = AddFloatInitializer(graph, "weight", {3, 4}, 0.1f);
+      graph.AddNode("matmul", "MatMul", "", {&x, &weight}, {&gemm_out});
+    }
+    graph.AddNode("bn", "BatchNormalization", "", {&gemm_out, &scale, &bias, &mean, &var}, {&y});
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    auto rule_transformer_L2 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformerL2");
+    rule_transformer_L2->Register(std::make_unique<GemmBNFusion>());
+    graph_transformation_mgr.Register(std::move(rule_transformer_L2), TransformerLevel::Level2);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_EQ(op_to_count["BatchNormalization"], 0);
+    ASSERT_EQ(op_to_count[op_type], 1);
+    ASSERT_EQ(op_to_count["Add"], op_type == "MatMul" ? 1 : 0);
+
+    // The weights of output column 1 are scaled by scale[1] / sqrt(var[1] + epsilon).
+    const float column_scale = 1.01f / std::sqrt(1.01f + 1e-5f);
+    const TensorProto* weight_proto = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor("weight", weight_proto));
+    Initializer weight_value(weight_proto);
+    const int64_t weight_index = op_type == "Gemm" ? 3 : 1;
+    ASSERT_NEAR(weight_value.data<float>()[weight_index], (0.1f + 0.01f * weight_index) * column_scale, 1e-6f);
+
+    if (op_type == "Gemm") {
+      const TensorProto* c_proto = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor("c", c_proto));
+      Initializer c_value(c_proto);
+      ASSERT_NEAR(c_value.data<float>()[1], (0.21f - 0.11f) * column_scale + 0.51f, 1e-6f);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, FuseMatMulScale) {
+  Model model("FuseMatMulScale");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 3});
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // MatMul -> Mul(per column) -> Add folds the Mul into the weights.
+  auto& matmul_weight = AddFloatInitializer(graph, "matmul_weight", {3, 4}, 0.1f);
+  auto& column_scale = AddFloatInitializer(graph, "column_scale", {1, 4}, 2.0f);
+  auto& bias = AddFloatInitializer(graph, "bias", {4}, 0.5f);
+  graph.AddNode("matmul", "MatMul", "", {&x, &matmul_weight}, {&make_arg("matmul_out")});
+  graph.AddNode("mul", "Mul", "", {&column_scale, &make_arg("matmul_out")}, {&make_arg("mul_out")});
+  graph.AddNode("add", "Add", "", {&make_arg("mul_out"), &bias}, {&make_arg("y1")});
+
+  // Gemm -> Mul(scalar) folds the Mul into the weights and bias.
+  auto& gemm_weight = AddFloatInitializer(graph, "gemm_weight", {3, 4}, 0.1f);
+  auto& c = AddFloatInitializer(graph, "c", {4}, 0.2f);
+  auto& scalar_scale = AddFloatInitializer(graph, "scalar_scale", {}, 3.0f);
+  graph.AddNode("gemm", "Gemm", "", {&x, &gemm_weight, &c}, {&make_arg("gemm_out")});
+  graph.AddNode("gemm_mul", "Mul", "", {&make_arg("gemm_out"), &scalar_scale}, {&make_arg("y2")});
+
+  // A Mul by a full tensor varies per row and can't be folded.
+  auto& other_weight = AddFloatInitializer(graph, "other_weight", {3, 4}, 0.1f);
+  auto& full_scale = AddFloatInitializer(graph, "full_scale", {2, 4}, 2.0f);
+  graph.AddNode("other_matmul", "MatMul", "", {&x, &other_weight}, {&make_arg("other_out")});
+  graph.AddNode("other_mul", "Mul", "", {&make_arg("other_out"), &full_scale}, {&make_arg("y3")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  auto rule_transformer_L2 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformerL2");
+  rule_transformer_L2->Register(std::make_unique<MatMulScaleFusion>());
+  graph_transformation_mgr.Register(std::move(rule_transformer_L2), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Mul"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 2);
+  ASSERT_EQ(op_to_count["Gemm"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+
+  const TensorProto* tensor_proto = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("matmul_weight", tensor_proto));
+  ASSERT_NEAR(Initializer(tensor_proto).data<float>()[5], 0.15f * 2.01f, 1e-6f);
+  ASSERT_TRUE(graph.GetInitializedTensor("gemm_weight", tensor_proto));
+  ASSERT_NEAR(Initializer(tensor_proto).data<float>()[5], 0.15f * 3.0f, 1e-6f);
+  ASSERT_TRUE(graph.GetInitializedTensor("c", tensor_proto));
+  ASSERT_NEAR(Initializer(tensor_proto).data<float>()[2], 0.22f * 3.0f, 1e-6f);
+  ASSERT_TRUE(graph.GetInitializedTensor("other_weight", tensor_proto));
+  ASSERT_NEAR(Initializer(tensor_proto).data<float>()[5], 0.15f, 1e-6f);
+}
+
 #ifndef DISABLE_CONTRIB_OPS
 TEST(GraphTransformationTests, FuseConvActivation) {
   std::unordered_map<std::string, std::string> model_to_op_name{{"fusion/conv_relu.onnx", "Relu"},
@@ -311,6 +751,50 @@ TEST(GraphTransformationTests, FuseConvActivation) {
     ASSERT_TRUE(op_to_count[model.second] == 0);
   }
 }
+
+TEST(GraphTransformationTests, FuseConvAddActivation) {
+  Model model("FuseConvAddActivation");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {1, 2, 4, 4});
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto& residual = graph.GetOrCreateNodeArg("residual", &input_type);
+  auto& w = AddFloatInitializer(graph, "w", {2, 2, 1, 1}, 0.5f);
+  auto& bias = AddFloatInitializer(graph, "bias", {2, 1, 1}, 0.1f);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // Relu(Conv + residual)
+  graph.AddNode("conv0", "Conv", "", {&x, &w}, {&make_arg("conv0_out")});
+  graph.AddNode("add0", "Add", "", {&make_arg("conv0_out"), &residual}, {&make_arg("add0_out")});
+  graph.AddNode("relu0", "Relu", "", {&make_arg("add0_out")}, {&make_arg("y0")});
+
+  // residual + Conv
+  graph.AddNode("conv1", "Conv", "", {&x, &w}, {&make_arg("conv1_out")});
+  graph.AddNode("add1", "Add", "", {&residual, &make_arg("conv1_out")}, {&make_arg("y1")});
+
+  // a broadcast Add is not a residual
+  graph.AddNode("conv2", "Conv", "", {&x, &w}, {&make_arg("conv2_out")});
+  graph.AddNode("add2", "Add", "", {&make_arg("conv2_out"), &bias}, {&make_arg("y2")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ConvAddActivationFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedConv"], 2);
+  ASSERT_EQ(op_to_count["Conv"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 0);
+
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "FusedConv") {
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+      ASSERT_EQ(node.InputDefs()[3]->Name(), "residual");
+    }
+  }
+}
 #endif
 
 TEST(GraphTransformationTests, FuseConvMulNoBias) {
@@ -606,5 +1090,907 @@ TEST(GraphTransformationTests, ReluClipFusion) {
   }
 }
 
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, ElementwiseFusion) {
+  Model model("ElementwiseFusion");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  TypeProto scalar_type;
+  scalar_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  scalar_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  // Mul -> Add -> Relu -> Sub fuses into one node. The second Sub takes the running value as its
+  // second operand, so it ends the chain.
+  auto& x = graph.GetOrCreateNodeArg("x", &tensor_type);
+  auto& w = graph.GetOrCreateNodeArg("w", &tensor_type);
+  auto& b = graph.GetOrCreateNodeArg("b", &scalar_type);
+  auto& c = graph.GetOrCreateNodeArg("c", &tensor_type);
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", &tensor_type);
+  auto& add_out = graph.GetOrCreateNodeArg("add_out", &tensor_type);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &tensor_type);
+  auto& sub_out = graph.GetOrCreateNodeArg("sub_out", &tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("y", &tensor_type);
+
+  graph.AddNode("mul", "Mul", "", {&x, &w}, {&mul_out});
+  graph.AddNode("add", "Add", "", {&b, &mul_out}, {&add_out});
+  graph.AddNode("relu", "Relu", "", {&add_out}, {&relu_out});
+  graph.AddNode("sub", "Sub", "", {&relu_out, &c}, {&sub_out});
+  graph.AddNode("sub_swapped", "Sub", "", {&c, &sub_out}, {&y});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedElementwise"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Relu"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise") {
+      std::vector<std::string> expected_ops{"Mul", "Add", "Relu", "Sub"};
+      const auto* ops = graph_utils::GetNodeAttribute(node, "ops");
+      ASSERT_EQ(std::vector<std::string>(ops->strings().begin(), ops->strings().end()), expected_ops);
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "sub_out");
+    }
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, EmbeddingBagFusion) {
+  Model model("EmbeddingBagFusion");
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](TensorProto_DataType elem_type, std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(elem_type);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto table_type = make_type(TensorProto_DataType_FLOAT, {100, 8});
+  TypeProto indices_type = make_type(TensorProto_DataType_INT64, {4, 3});
+  TypeProto gathered_type = make_type(TensorProto_DataType_FLOAT, {4, 3, 8});
+  TypeProto weights_type = make_type(TensorProto_DataType_FLOAT, {4, 3, 1});
+  TypeProto bags_type = make_type(TensorProto_DataType_FLOAT, {4, 8});
+
+  // Gather -> ReduceSum, Gather -> Mul -> ReduceMean, and a Gather -> ReduceSum over the embedding
+  // dimension that must not be fused.
+  auto& table = graph.GetOrCreateNodeArg("table", &table_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& weights = graph.GetOrCreateNodeArg("weights", &weights_type);
+  auto& gathered0 = graph.GetOrCreateNodeArg("gathered0", &gathered_type);
+  auto& gathered1 = graph.GetOrCreateNodeArg("gathered1", &gathered_type);
+  auto& gathered2 = graph.GetOrCreateNodeArg("gathered2", &gathered_type);
+  auto& weighted = graph.GetOrCreateNodeArg("weighted", &gathered_type);
+  auto& bags0 = graph.GetOrCreateNodeArg("bags0", &bags_type);
+  auto& bags1 = graph.GetOrCreateNodeArg("bags1", &bags_type);
+  auto& bags2 = graph.GetOrCreateNodeArg("bags2", nullptr);
+
+  graph.AddNode("gather0", "Gather", "", {&table, &indices}, {&gathered0});
+  auto& reduce0 = graph.AddNode("reduce0", "ReduceSum", "", {&gathered0}, {&bags0});
+  reduce0.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce0.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  graph.AddNode("gather1", "Gather", "", {&table, &indices}, {&gathered1});
+  graph.AddNode("mul1", "Mul", "", {&gathered1, &weights}, {&weighted});
+  auto& reduce1 = graph.AddNode("reduce1", "ReduceMean", "", {&weighted}, {&bags1});
+  reduce1.AddAttribute("axes", std::vector<int64_t>{-2});
+  reduce1.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  graph.AddNode("gather2", "Gather", "", {&table, &indices}, {&gathered2});
+  auto& reduce2 = graph.AddNode("reduce2", "ReduceSum", "", {&gathered2}, {&bags2});
+  reduce2.AddAttribute("axes", std::vector<int64_t>{2});
+  reduce2.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["EmbeddingBag"], 2);
+  ASSERT_EQ(op_to_count["Gather"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["ReduceSum"], 1);
+  ASSERT_EQ(op_to_count["ReduceMean"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "EmbeddingBag" && node.OutputDefs()[0]->Name() == "bags1") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "mode")->s(), "mean");
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+      ASSERT_FALSE(node.InputDefs()[2]->Exists());
+      ASSERT_EQ(node.InputDefs()[3]->Name(), "weights");
+    }
+  }
+}
+#endif
+
+TEST(GraphTransformationTests, ZipMapElimination) {
+  Model model("ZipMapElimination");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // Softmax -> ZipMap producing a graph output, and a ZipMap of a graph input that must stay.
+  auto& scores = graph.GetOrCreateNodeArg("scores", &float_type);
+  auto& probabilities = graph.GetOrCreateNodeArg("probabilities", &float_type);
+  auto& output_probability = graph.GetOrCreateNodeArg("output_probability", nullptr);
+  auto& output_scores = graph.GetOrCreateNodeArg("output_scores", nullptr);
+  graph.AddNode("softmax", "Softmax", "class probabilities", {&scores}, {&probabilities});
+  auto& zipmap = graph.AddNode("zipmap", "ZipMap", "probabilities per label", {&probabilities},
+                               {&output_probability}, nullptr, kMLDomain);
+  zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{0, 1, 2});
+  auto& input_zipmap = graph.AddNode("input_zipmap", "ZipMap", "scores per label", {&scores}, {&output_scores},
+                                     nullptr, kMLDomain);
+  input_zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{0, 1, 2});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  bool modified = false;
+  ASSERT_TRUE(ZipMapElimination().Apply(graph, modified).IsOK());
+  ASSERT_TRUE(modified);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["ZipMap"], 1);
+  ASSERT_EQ(op_to_count["Softmax"], 1);
+
+  const NodeArg* output = graph.GetNodeArg("output_probability");
+  ASSERT_NE(output, nullptr);
+  ASSERT_EQ(*output->Type(), "tensor(float)");
+  ASSERT_NE(std::find(graph.GetOutputs().cbegin(), graph.GetOutputs().cend(), output), graph.GetOutputs().cend());
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Softmax") {
+      ASSERT_EQ(node.OutputDefs()[0], output);
+    }
+  }
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, SparseMatMulTransformer) {
+  Model model("SparseMatMulTransformer");
+  auto& graph = model.MainGraph();
+
+  constexpr int64_t size = 128;
+  auto add_weight = [&graph](const std::string& name, bool diagonal) -> NodeArg& {
+    TensorProto weight;
+    weight.set_name(name);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(size);
+    weight.add_dims(size);
+    for (int64_t i = 0; i < size * size; ++i) {
+      weight.add_float_data(!diagonal || i % (size + 1) == 0 ? 1.f : 0.f);
+    }
+    graph.AddInitializedTensor(weight);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(size);
+
+  // A MatMul and a Gemm with a weight that is zero except for its diagonal, and a Gemm with a dense weight.
+  auto& input = graph.GetOrCreateNodeArg("input", &float_type);
+  auto& hidden1 = graph.GetOrCreateNodeArg("hidden1", &float_type);
+  auto& hidden2 = graph.GetOrCreateNodeArg("hidden2", &float_type);
+  auto& output = graph.GetOrCreateNodeArg("output", &float_type);
+  graph.AddNode("matmul", "MatMul", "sparse weight", {&input, &add_weight("sparse1", true)}, {&hidden1});
+  auto& gemm = graph.AddNode("gemm", "Gemm", "sparse weight", {&hidden1, &add_weight("sparse2", true)}, {&hidden2});
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+  gemm.AddAttribute("alpha", 2.f);
+  graph.AddNode("dense_gemm", "Gemm", "dense weight", {&hidden2, &add_weight("dense", false)}, {&output});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<SparseMatMulTransformer>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["SparseMatMul"], 2);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["Gemm"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "SparseMatMul") {
+      const auto& sparse_weight = graph_utils::GetNodeAttribute(node, "B")->sparse_tensor();
+      ASSERT_EQ(sparse_weight.values().float_data_size(), size);
+      ASSERT_EQ(sparse_weight.indices().int64_data(1), size + 1);
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "alpha")->f(),
+                node.OutputDefs()[0]->Name() == "hidden2" ? 2.f : 1.f);
+    }
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, WeightCompressionTransformer) {
+  for (auto compression : {WeightCompression::kFloat16, WeightCompression::kInt8}) {
+    Model model("WeightCompressionTransformer");
+    auto& graph = model.MainGraph();
+
+    auto add_weight = [&graph](const std::string& name, int64_t rows, int64_t columns) -> NodeArg& {
+      TensorProto weight;
+      weight.set_name(name);
+      weight.set_data_type(TensorProto_DataType_FLOAT);
+      weight.add_dims(rows);
+      weight.add_dims(columns);
+      for (int64_t i = 0; i < rows * columns; ++i) {
+        weight.add_float_data(static_cast<float>(i % 7) - 3.f);
+      }
+      graph.AddInitializedTensor(weight);
+      return graph.GetOrCreateNodeArg(name, nullptr);
+    };
+
+    constexpr int64_t size = 128;
+    TypeProto float_type;
+    float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+    float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(size);
+    TypeProto small_type;
+    small_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    small_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+    small_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    // A MatMul and a Gemm sharing a weight, and a Gemm with a weight too small to be compressed.
+    auto& input = graph.GetOrCreateNodeArg("input", &float_type);
+    auto& hidden1 = graph.GetOrCreateNodeArg("hidden1", &float_type);
+    auto& hidden2 = graph.GetOrCreateNodeArg("hidden2", &float_type);
+    auto& output = graph.GetOrCreateNodeArg("output", &small_type);
+    auto& shared_weight = add_weight("shared", size, size);
+    graph.AddNode("matmul", "MatMul", "large weight", {&input, &shared_weight}, {&hidden1});
+    auto& gemm = graph.AddNode("gemm", "Gemm", "large weight", {&hidden1, &shared_weight}, {&hidden2});
+    gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    gemm.AddAttribute("alpha", 2.f);
+    graph.AddNode("small_gemm", "Gemm", "small weight", {&hidden2, &add_weight("small", size, 2)}, {&output});
+
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::make_unique<WeightCompressionTransformer>(compression),
+                                      TransformerLevel::Level2);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_EQ(op_to_count["CompressedMatMul"], 2);
+    ASSERT_EQ(op_to_count["MatMul"], 0);
+    ASSERT_EQ(op_to_count["Gemm"], 1);
+
+    // the shared weight is compressed once, and the float weight is no longer used
+    const auto expected_type = compression == WeightCompression::kFloat16 ? TensorProto_DataType_FLOAT16
+                                                                          : TensorProto_DataType_INT8;
+    const NodeArg* compressed_weight = nullptr;
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "CompressedMatMul") {
+        if (compressed_weight == nullptr) {
+          compressed_weight = node.InputDefs()[1];
+        }
+        ASSERT_EQ(node.InputDefs()[1], compressed_weight);
+        ASSERT_EQ(graph_utils::GetConstantInitializer(graph, compressed_weight->Name())->data_type(), expected_type);
+        ASSERT_EQ(graph_utils::GetNodeAttribute(node, "transB")->i(),
+                  static_cast<int64_t>(node.OutputDefs()[0]->Name() == "hidden2"));
+        ASSERT_EQ(graph_utils::GetNodeAttribute(node, "alpha")->f(),
+                  node.OutputDefs()[0]->Name() == "hidden2" ? 2.f : 1.f);
+        ASSERT_EQ(graph_utils::GetNodeAttribute(node, "scale")->f(),
+                  compression == WeightCompression::kFloat16 ? 1.f : 3.f / 127.f);
+      }
+    }
+
+    ASSERT_TRUE(graph.Resolve().IsOK());
+    ASSERT_EQ(graph.GetAllInitializedTensors().count("shared"), 0u);
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, NormActivationFusion) {
+  Model model("NormActivationFusion");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      tensor.add_float_data(1.f);
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 2, 3, 3}) {
+    float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  std::vector<NodeArg*> args;
+  for (const char* name : {"input", "in", "in_relu", "conv", "conv_bn", "conv_bn_relu", "bn", "output"}) {
+    args.push_back(&graph.GetOrCreateNodeArg(name, &float_type));
+  }
+  auto& scale = add_initializer("scale", {2});
+  auto& bias = add_initializer("bias", {2});
+  auto& mean = add_initializer("mean", {2});
+  auto& var = add_initializer("var", {2});
+
+  // An InstanceNormalization and a BatchNormalization followed by activations, and a BatchNormalization of the
+  // output of a Conv that is left to the NCHWc transformer.
+  graph.AddNode("in", "InstanceNormalization", "", {args[0], &scale, &bias}, {args[1]});
+  graph.AddNode("in_relu", "Relu", "", {args[1]}, {args[2]});
+  graph.AddNode("conv", "Conv", "", {args[2], &add_initializer("W", {2, 2, 1, 1})}, {args[3]});
+  graph.AddNode("conv_bn", "BatchNormalization", "", {args[3], &scale, &bias, &mean, &var}, {args[4]});
+  graph.AddNode("conv_bn_relu", "Relu", "", {args[4]}, {args[5]});
+  graph.AddNode("bn", "BatchNormalization", "", {args[5], &scale, &bias, &mean, &var}, {args[6]});
+  auto& leaky_relu = graph.AddNode("bn_leaky_relu", "LeakyRelu", "", {args[6]}, {args[7]});
+  leaky_relu.AddAttribute("alpha", 0.2f);
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<NormActivationFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedInstanceNormalization"], 1);
+  ASSERT_EQ(op_to_count["FusedBatchNormalization"], 1);
+  ASSERT_EQ(op_to_count["InstanceNormalization"], 0);
+  ASSERT_EQ(op_to_count["BatchNormalization"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["LeakyRelu"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "FusedBatchNormalization") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "activation")->s(), "LeakyRelu");
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "activation_params")->floats(0), 0.2f);
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "output");
+    }
+  }
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, NhwcPoolTransformer) {
+  Model model("NhwcPoolTransformer");
+  auto& graph = model.MainGraph();
+
+  TypeProto nhwc_type;
+  nhwc_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : {1, 4, 5, 3}) {
+    nhwc_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+  auto add_transpose = [&graph](const std::string& name, NodeArg& input, NodeArg& output,
+                                std::vector<int64_t> perm) {
+    graph.AddNode(name, "Transpose", "", {&input}, {&output}).AddAttribute("perm", perm);
+  };
+
+  // A GlobalAveragePool between a Transpose to NCHW and one back to NHWC, which both go.
+  add_transpose("a_to_nchw", graph.GetOrCreateNodeArg("a", &nhwc_type), make_arg("a_nchw"), {0, 3, 1, 2});
+  graph.AddNode("a_pool", "GlobalAveragePool", "", {&make_arg("a_nchw")}, {&make_arg("a_pool_out")});
+  add_transpose("a_to_nhwc", make_arg("a_pool_out"), make_arg("a_out"), {0, 2, 3, 1});
+
+  // A MaxPool with an NCHW output, whose output is transposed instead of its input.
+  add_transpose("b_to_nchw", graph.GetOrCreateNodeArg("b", &nhwc_type), make_arg("b_nchw"), {0, 3, 1, 2});
+  graph.AddNode("b_pool", "MaxPool", "", {&make_arg("b_nchw")}, {&make_arg("b_out")})
+      .AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+
+  // A dilated MaxPool, which the NHWC kernel doesn't compute.
+  add_transpose("c_to_nchw", graph.GetOrCreateNodeArg("c", &nhwc_type), make_arg("c_nchw"), {0, 3, 1, 2});
+  Node& dilated_pool = graph.AddNode("c_pool", "MaxPool", "", {&make_arg("c_nchw")}, {&make_arg("c_out")});
+  dilated_pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  dilated_pool.AddAttribute("dilations", std::vector<int64_t>{2, 2});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<NhwcPoolTransformer>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["NhwcGlobalAveragePool"], 1);
+  ASSERT_EQ(op_to_count["NhwcMaxPool"], 1);
+  ASSERT_EQ(op_to_count["GlobalAveragePool"], 0);
+  ASSERT_EQ(op_to_count["MaxPool"], 1);
+  ASSERT_EQ(op_to_count["Transpose"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "NhwcGlobalAveragePool") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "a");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "a_out");
+    }
+    if (node.OpType() == "NhwcMaxPool") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "b");
+      std::vector<int64_t> kernel_shape;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "kernel_shape", kernel_shape));
+      ASSERT_EQ(kernel_shape, (std::vector<int64_t>{2, 2}));
+    }
+    if (node.OpType() == "Transpose" && node.OutputDefs()[0]->Name() == "b_out") {
+      std::vector<int64_t> perm;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+      ASSERT_EQ(perm, (std::vector<int64_t>{0, 3, 1, 2}));
+    }
+  }
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, CudaNhwcTransformer) {
+  Model model("CudaNhwcTransformer");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  for (int64_t dim : {1, 3, 8, 8}) {
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // The float16 values are stored as their bits, which are only moved by the transform.
+  std::vector<uint16_t> w_values(4 * 3 * 1 * 2);
+  std::iota(w_values.begin(), w_values.end(), static_cast<uint16_t>(0));
+  TensorProto w_tensor;
+  w_tensor.set_name("W");
+  w_tensor.set_data_type(TensorProto_DataType_FLOAT16);
+  for (int64_t dim : {4, 3, 1, 2}) {
+    w_tensor.add_dims(dim);
+  }
+  w_tensor.set_raw_data(w_values.data(), w_values.size() * sizeof(uint16_t));
+  graph.AddInitializedTensor(w_tensor);
+
+  // A Conv, Relu and MaxPool, which run in the NHWC layout between a Transpose to NHWC and one back to NCHW.
+  graph.AddNode("conv", "Conv", "", {&graph.GetOrCreateNodeArg("X", &input_type), &make_arg("W")},
+                {&make_arg("conv_out")});
+  graph.AddNode("relu", "Relu", "", {&make_arg("conv_out")}, {&make_arg("relu_out")});
+  graph.AddNode("pool", "MaxPool", "", {&make_arg("relu_out")}, {&make_arg("Y")})
+      .AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<CudaNhwcTransformer>(), TransformerLevel::Level3);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["NhwcConv"], 1);
+  ASSERT_EQ(op_to_count["NhwcMaxPool"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["Conv"], 0);
+  ASSERT_EQ(op_to_count["MaxPool"], 0);
+  ASSERT_EQ(op_to_count["Transpose"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "NhwcConv") {
+      const TensorProto* nhwc_w_tensor = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), nhwc_w_tensor));
+      Initializer nhwc_w{nhwc_w_tensor};
+      ASSERT_EQ(nhwc_w.dims(), (std::vector<int64_t>{4, 1, 2, 3}));
+      const auto* nhwc_w_data = nhwc_w.data<uint16_t>();
+      for (int m = 0; m < 4; m++) {
+        for (int k = 0; k < 2; k++) {
+          for (int c = 0; c < 3; c++) {
+            ASSERT_EQ(nhwc_w_data[(m * 2 + k) * 3 + c], w_values[(m * 3 + c) * 2 + k]);
+          }
+        }
+      }
+    }
+    if (node.OpType() == "Transpose" && node.OutputDefs()[0]->Name() == "Y") {
+      std::vector<int64_t> perm;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+      ASSERT_EQ(perm, (std::vector<int64_t>{0, 3, 1, 2}));
+    }
+  }
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+#endif
+
+TEST(GraphTransformationTests, QDQFusion) {
+  Model model("QDQFusion");
+  auto& graph = model.MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, TensorProto_DataType data_type,
+                                  const std::vector<int64_t>& dims, const std::vector<float>& values) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+    }
+    for (auto value : values) {
+      if (data_type == TensorProto_DataType_FLOAT) {
+        tensor.add_float_data(value);
+      } else {
+        tensor.add_int32_data(static_cast<int32_t>(value));
+      }
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  // input -> QuantizeLinear -> DequantizeLinear -> MatMul (with a dequantized uint8 weight) -> QuantizeLinear
+  // -> DequantizeLinear -> output, and a MatMul whose output isn't quantized.
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 2});
+  auto& input = graph.GetOrCreateNodeArg("input", &input_type);
+  auto& scale = add_initializer("scale", TensorProto_DataType_FLOAT, {}, {0.5f});
+  auto& zero_point = add_initializer("zero_point", TensorProto_DataType_UINT8, {}, {128.f});
+  auto& weight = add_initializer("weight", TensorProto_DataType_UINT8, {2, 2}, {130.f, 128.f, 128.f, 130.f});
+
+  auto& input_quantized = graph.GetOrCreateNodeArg("input_quantized", nullptr);
+  auto& input_dequantized = graph.GetOrCreateNodeArg("input_dequantized", nullptr);
+  auto& weight_dequantized = graph.GetOrCreateNodeArg("weight_dequantized", nullptr);
+  auto& matmul_output = graph.GetOrCreateNodeArg("matmul_output", nullptr);
+  auto& output_quantized = graph.GetOrCreateNodeArg("output_quantized", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("output", nullptr);
+  auto& float_output = graph.GetOrCreateNodeArg("float_output", nullptr);
+  graph.AddNode("quantize_input", "QuantizeLinear", "", {&input, &scale, &zero_point}, {&input_quantized});
+  graph.AddNode("dequantize_input", "DequantizeLinear", "", {&input_quantized, &scale, &zero_point},
+                {&input_dequantized});
+  graph.AddNode("dequantize_weight", "DequantizeLinear", "", {&weight, &scale, &zero_point}, {&weight_dequantized});
+  graph.AddNode("matmul", "MatMul", "", {&input_dequantized, &weight_dequantized}, {&matmul_output});
+  graph.AddNode("quantize_output", "QuantizeLinear", "", {&matmul_output, &scale, &zero_point}, {&output_quantized});
+  graph.AddNode("dequantize_output", "DequantizeLinear", "", {&output_quantized, &scale, &zero_point}, {&output});
+  graph.AddNode("float_matmul", "MatMul", "", {&input_dequantized, &weight_dequantized}, {&float_output});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["QLinearMatMul"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  // the dequantized input and weight still feed the float MatMul
+  ASSERT_EQ(op_to_count["QuantizeLinear"], 1);
+  ASSERT_EQ(op_to_count["DequantizeLinear"], 3);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "QLinearMatMul") {
+      ASSERT_EQ(node.InputDefs()[0], &input_quantized);
+      ASSERT_EQ(node.InputDefs()[3], &weight);
+      ASSERT_EQ(node.OutputDefs()[0], &output_quantized);
+    }
+  }
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, QDQFusionAdd) {
+  Model model("QDQFusionAdd");
+  auto& graph = model.MainGraph();
+
+  auto add_scalar = [&graph](const std::string& name, TensorProto_DataType data_type, float value) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(data_type);
+    if (data_type == TensorProto_DataType_FLOAT) {
+      tensor.add_float_data(value);
+    } else {
+      tensor.add_int32_data(static_cast<int32_t>(value));
+    }
+    graph.AddInitializedTensor(tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+
+  // C = Q(DQ(A) + DQ(B)), from uint8 inputs
+  TypeProto uint8_type = MakeTensorType(TensorProto_DataType_UINT8, {2, 2});
+  auto& a = graph.GetOrCreateNodeArg("A", &uint8_type);
+  auto& b = graph.GetOrCreateNodeArg("B", &uint8_type);
+  auto& scale = add_scalar("scale", TensorProto_DataType_FLOAT, 0.5f);
+  auto& zero_point = add_scalar("zero_point", TensorProto_DataType_UINT8, 128.f);
+  auto& a_dequantized = graph.GetOrCreateNodeArg("A_dequantized", nullptr);
+  auto& b_dequantized = graph.GetOrCreateNodeArg("B_dequantized", nullptr);
+  auto& sum = graph.GetOrCreateNodeArg("sum", nullptr);
+  auto& c = graph.GetOrCreateNodeArg("C", nullptr);
+  graph.AddNode("dequantize_a", "DequantizeLinear", "", {&a, &scale, &zero_point}, {&a_dequantized});
+  graph.AddNode("dequantize_b", "DequantizeLinear", "", {&b, &scale, &zero_point}, {&b_dequantized});
+  graph.AddNode("add", "Add", "", {&a_dequantized, &b_dequantized}, {&sum});
+  graph.AddNode("quantize_sum", "QuantizeLinear", "", {&sum, &scale, &zero_point}, {&c});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // QLinearAdd is only fused for the CPU execution provider
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["QLinearAdd"], 1);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["QuantizeLinear"], 0);
+  ASSERT_EQ(op_to_count["DequantizeLinear"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.Domain(), kMSDomain);
+    ASSERT_EQ(node.InputDefs()[0], &a);
+    ASSERT_EQ(node.InputDefs()[3], &b);
+    ASSERT_EQ(node.OutputDefs()[0], &c);
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, DynamicQuantizeMatMulFusion) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 11;
+  Model model("DynamicQuantizeMatMulFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  auto& graph = model.MainGraph();
+
+  TensorProto weight;
+  weight.set_name("weight");
+  weight.set_data_type(TensorProto_DataType_UINT8);
+  weight.add_dims(2);
+  weight.add_dims(3);
+  for (int32_t value : {1, 2, 3, 4, 5, 6}) {
+    weight.add_int32_data(value);
+  }
+  graph.AddInitializedTensor(weight);
+  TensorProto weight_scale;
+  weight_scale.set_name("weight_scale");
+  weight_scale.set_data_type(TensorProto_DataType_FLOAT);
+  weight_scale.add_float_data(0.5f);
+  graph.AddInitializedTensor(weight_scale);
+  TensorProto weight_zero_point;
+  weight_zero_point.set_name("weight_zero_point");
+  weight_zero_point.set_data_type(TensorProto_DataType_UINT8);
+  weight_zero_point.add_int32_data(3);
+  graph.AddInitializedTensor(weight_zero_point);
+  TensorProto bias;
+  bias.set_name("bias");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  bias.add_dims(3);
+  for (float value : {1.f, 2.f, 3.f}) {
+    bias.add_float_data(value);
+  }
+  graph.AddInitializedTensor(bias);
+
+  // the nodes the dynamic quantization of a MatMul with a bias is made of
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {4, 2});
+  auto& input = graph.GetOrCreateNodeArg("input", &input_type);
+  auto& input_quantized = graph.GetOrCreateNodeArg("input_quantized", nullptr);
+  auto& input_scale = graph.GetOrCreateNodeArg("input_scale", nullptr);
+  auto& input_zero_point = graph.GetOrCreateNodeArg("input_zero_point", nullptr);
+  auto& product = graph.GetOrCreateNodeArg("product", nullptr);
+  auto& product_float = graph.GetOrCreateNodeArg("product_float", nullptr);
+  auto& scale = graph.GetOrCreateNodeArg("scale", nullptr);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("output", nullptr);
+  graph.AddNode("quantize", "DynamicQuantizeLinear", "", {&input}, {&input_quantized, &input_scale, &input_zero_point});
+  graph.AddNode("matmul", "MatMulInteger", "",
+                {&input_quantized, graph.GetNodeArg("weight"), &input_zero_point, graph.GetNodeArg("weight_zero_point")},
+                {&product});
+  graph.AddNode("cast", "Cast", "", {&product}, {&product_float})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("scale_mul", "Mul", "", {&input_scale, graph.GetNodeArg("weight_scale")}, {&scale});
+  graph.AddNode("mul", "Mul", "", {&product_float, &scale}, {&scaled});
+  graph.AddNode("add", "Add", "", {&scaled, graph.GetNodeArg("bias")}, {&output});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<DynamicQuantizeMatMulFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["DynamicQuantizeMatMul"], 1);
+  ASSERT_EQ(graph.NumberOfNodes(), 1);
+
+  const Node& fused_node = *graph.Nodes().begin();
+  ASSERT_EQ(fused_node.InputDefs().size(), 5u);
+  ASSERT_EQ(fused_node.InputDefs()[0], &input);
+  ASSERT_EQ(fused_node.InputDefs()[2]->Name(), "weight_scale");
+  ASSERT_EQ(fused_node.InputDefs()[3]->Name(), "weight_zero_point");
+  ASSERT_EQ(fused_node.InputDefs()[4]->Name(), "bias");
+  ASSERT_EQ(fused_node.OutputDefs()[0], &output);
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+static NodeArg& AddShapeInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& shape) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_INT64);
+  tensor.add_dims(static_cast<int64_t>(shape.size()));
+  for (auto value : shape) {
+    tensor.add_int64_data(value);
+  }
+  graph.AddInitializedTensor(tensor);
+
+  TypeProto type = MakeTensorType(TensorProto_DataType_INT64, {static_cast<int64_t>(shape.size())});
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+TEST(GraphTransformationTests, LayerNormFusion) {
+  Model model("LayerNormFusion");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 3, 4});
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto& two = AddFloatInitializer(graph, "two", {}, 2.0f);
+  auto& epsilon = AddFloatInitializer(graph, "epsilon", {}, 1e-5f);
+  auto& gamma = AddFloatInitializer(graph, "gamma", {4}, 1.0f);
+  auto& beta = AddFloatInitializer(graph, "beta", {4}, 0.0f);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  auto& mean = graph.AddNode("mean", "ReduceMean", "", {&x}, {&make_arg("mean_out")});
+  mean.AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("sub", "Sub", "", {&x, &make_arg("mean_out")}, {&make_arg("centered")});
+  graph.AddNode("pow", "Pow", "", {&make_arg("centered"), &two}, {&make_arg("squared")});
+  auto& variance = graph.AddNode("variance", "ReduceMean", "", {&make_arg("squared")}, {&make_arg("variance_out")});
+  variance.AddAttribute("axes", std::vector<int64_t>{2});
+  graph.AddNode("add_epsilon", "Add", "", {&make_arg("variance_out"), &epsilon}, {&make_arg("variance_eps")});
+  graph.AddNode("sqrt", "Sqrt", "", {&make_arg("variance_eps")}, {&make_arg("std")});
+  graph.AddNode("div", "Div", "", {&make_arg("centered"), &make_arg("std")}, {&make_arg("normalized")});
+  graph.AddNode("mul", "Mul", "", {&make_arg("normalized"), &gamma}, {&make_arg("scaled")});
+  graph.AddNode("add", "Add", "", {&beta, &make_arg("scaled")}, {&make_arg("y")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["LayerNormalization"], 1);
+  ASSERT_EQ(op_to_count["ReduceMean"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 0);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Div"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "LayerNormalization") {
+      ASSERT_EQ(node.InputDefs()[1]->Name(), "gamma");
+      ASSERT_EQ(node.InputDefs()[2]->Name(), "beta");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "y");
+      ASSERT_FLOAT_EQ(graph_utils::GetNodeAttribute(node, "epsilon")->f(), 1e-5f);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, GeluFusion) {
+  Model model("GeluFusion");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 8});
+  auto& x0 = graph.GetOrCreateNodeArg("x0", &input_type);
+  auto& x1 = graph.GetOrCreateNodeArg("x1", &input_type);
+  auto& sqrt2 = AddFloatInitializer(graph, "sqrt2", {}, 1.4142135f);
+  auto& one = AddFloatInitializer(graph, "one", {}, 1.0f);
+  auto& half = AddFloatInitializer(graph, "half", {}, 0.5f);
+  auto& three = AddFloatInitializer(graph, "three", {}, 3.0f);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  // (X * (1 + erf(X / sqrt(2)))) * 0.5
+  graph.AddNode("div0", "Div", "", {&x0, &sqrt2}, {&make_arg("div0_out")});
+  graph.AddNode("erf0", "Erf", "", {&make_arg("div0_out")}, {&make_arg("erf0_out")});
+  graph.AddNode("add0", "Add", "", {&make_arg("erf0_out"), &one}, {&make_arg("add0_out")});
+  graph.AddNode("mul0", "Mul", "", {&x0, &make_arg("add0_out")}, {&make_arg("mul0_out")});
+  graph.AddNode("half0", "Mul", "", {&make_arg("mul0_out"), &half}, {&make_arg("y0")});
+
+  // (X * 0.5) * (1 + erf(X / sqrt(2)))
+  graph.AddNode("div1", "Div", "", {&x1, &sqrt2}, {&make_arg("div1_out")});
+  graph.AddNode("erf1", "Erf", "", {&make_arg("div1_out")}, {&make_arg("erf1_out")});
+  graph.AddNode("add1", "Add", "", {&one, &make_arg("erf1_out")}, {&make_arg("add1_out")});
+  graph.AddNode("half1", "Mul", "", {&x1, &half}, {&make_arg("half1_out")});
+  graph.AddNode("mul1", "Mul", "", {&make_arg("half1_out"), &make_arg("add1_out")}, {&make_arg("y1")});
+
+  // a different divisor is not GELU
+  graph.AddNode("div2", "Div", "", {&x1, &three}, {&make_arg("div2_out")});
+  graph.AddNode("erf2", "Erf", "", {&make_arg("div2_out")}, {&make_arg("erf2_out")});
+  graph.AddNode("add2", "Add", "", {&make_arg("erf2_out"), &one}, {&make_arg("add2_out")});
+  graph.AddNode("mul2", "Mul", "", {&x1, &make_arg("add2_out")}, {&make_arg("mul2_out")});
+  graph.AddNode("half2", "Mul", "", {&make_arg("mul2_out"), &half}, {&make_arg("y2")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<GeluFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Gelu"], 2);
+  ASSERT_EQ(op_to_count["Erf"], 1);
+  ASSERT_EQ(op_to_count["Div"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 2);
+}
+
+TEST(GraphTransformationTests, AttentionFusion) {
+  Model model("AttentionFusion");
+  auto& graph = model.MainGraph();
+
+  // batch 2, sequence 3, hidden 4 split into 2 heads of 2
+  TypeProto input_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 3, 4});
+  TypeProto mask_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, 1, 1, 3});
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto& mask = graph.GetOrCreateNodeArg("mask", &mask_type);
+  auto& split_shape = AddShapeInitializer(graph, "split_shape", {0, 0, 2, 2});
+  auto& merge_shape = AddShapeInitializer(graph, "merge_shape", {0, -1, 4});
+  auto& sqrt_head_size = AddFloatInitializer(graph, "sqrt_head_size", {}, 1.4142135f);
+  auto make_arg = [&graph](const std::string& name) -> NodeArg& { return graph.GetOrCreateNodeArg(name, nullptr); };
+
+  auto add_projection = [&](const std::string& name, std::vector<int64_t> perm) {
+    auto& weight = AddFloatInitializer(graph, name + "_weight", {4, 4}, 0.1f);
+    auto& bias = AddFloatInitializer(graph, name + "_bias", {4}, 0.2f);
+    graph.AddNode(name + "_matmul", "MatMul", "", {&x, &weight}, {&make_arg(name + "_matmul_out")});
+    graph.AddNode(name + "_add", "Add", "", {&make_arg(name + "_matmul_out"), &bias}, {&make_arg(name + "_add_out")});
+    graph.AddNode(name + "_reshape", "Reshape", "", {&make_arg(name + "_add_out"), &split_shape},
+                  {&make_arg(name + "_reshape_out")});
+    auto& transpose = graph.AddNode(name + "_transpose", "Transpose", "", {&make_arg(name + "_reshape_out")},
+                                    {&make_arg(name + "_heads")});
+    transpose.AddAttribute("perm", perm);
+  };
+  add_projection("q", {0, 2, 1, 3});
+  add_projection("k", {0, 2, 3, 1});
+  add_projection("v", {0, 2, 1, 3});
+
+  graph.AddNode("qk", "MatMul", "", {&make_arg("q_heads"), &make_arg("k_heads")}, {&make_arg("qk_out")});
+  graph.AddNode("scale", "Div", "", {&make_arg("qk_out"), &sqrt_head_size}, {&make_arg("scale_out")});
+  graph.AddNode("add_mask", "Add", "", {&make_arg("scale_out"), &mask}, {&make_arg("masked")});
+  auto& softmax = graph.AddNode("softmax", "Softmax", "", {&make_arg("masked")}, {&make_arg("probs")});
+  softmax.AddAttribute("axis", static_cast<int64_t>(3));
+  graph.AddNode("pv", "MatMul", "", {&make_arg("probs"), &make_arg("v_heads")}, {&make_arg("pv_out")});
+  auto& merge = graph.AddNode("merge_transpose", "Transpose", "", {&make_arg("pv_out")}, {&make_arg("merged")});
+  merge.AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  graph.AddNode("merge_reshape", "Reshape", "", {&make_arg("merged"), &merge_shape}, {&make_arg("y")});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Attention"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Reshape"], 0);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Softmax"], 0);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Attention") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "num_heads")->i(), 2);
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "x");
+      ASSERT_EQ(node.InputDefs()[3]->Name(), "mask");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "y");
+
+      const TensorProto* weight = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), weight));
+      ASSERT_EQ(weight->dims(0), 4);
+      ASSERT_EQ(weight->dims(1), 12);
+    }
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -79,27 +79,33 @@ struct NchwcTestHelper {
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
-  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape, const std::vector<float>& data) {
     std::string name = graph_.GenerateNodeArgName("constant");
     ONNX_NAMESPACE::TensorProto tensor_proto;
     tensor_proto.set_name(name);
     tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
 
-    int64_t num_elements = 1;
     for (auto& dim : shape) {
       tensor_proto.add_dims(dim);
-      num_elements *= dim;
     }
 
-    auto random_data = FillRandomData(static_cast<size_t>(num_elements));
-    tensor_proto.mutable_float_data()->Resize(static_cast<int>(num_elements), 0.0f);
-    memcpy(tensor_proto.mutable_float_data()->mutable_data(), random_data.data(), random_data.size() * sizeof(float));
+    tensor_proto.mutable_float_data()->Resize(static_cast<int>(data.size()), 0.0f);
+    memcpy(tensor_proto.mutable_float_data()->mutable_data(), data.data(), data.size() * sizeof(float));
 
     graph_.AddInitializedTensor(tensor_proto);
 
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      num_elements *= dim;
+    }
+
+    return MakeInitializer(shape, FillRandomData(static_cast<size_t>(num_elements)));
+  }
+
   Node& AddNode(const std::string& op_type,
                 const std::vector<NodeArg*>& input_args,
                 const std::vector<NodeArg*>& output_args) {
@@ -622,6 +628,112 @@ TEST(NchwcOptimizerTests, ConvConcat) {
   test_case(0, 64, 3);
 }
 
+TEST(NchwcOptimizerTests, BatchNormalization) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 23, 21});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* add_output_arg = helper.MakeIntermediate();
+    auto* bn_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    auto& conv1_node = helper.AddConvNode(input_arg, conv1_output_arg, {64, 32, 3, 3});
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    helper.AddConvNode(input_arg, conv2_output_arg, {64, 32, 1, 1});
+    helper.AddNode("Add", {conv1_output_arg, conv2_output_arg}, {add_output_arg});
+
+    // Use variances that are powers of four so that folding the normalization
+    // into a convolution produces exactly the same results.
+    std::vector<float> scale(64), bias(64), mean(64), var(64);
+    static const float variances[] = {0.25f, 1.0f, 4.0f, 16.0f};
+    for (size_t c = 0; c < 64; c++) {
+      scale[c] = static_cast<float>(static_cast<int>(c % 7) - 3);
+      bias[c] = static_cast<float>(static_cast<int>(c % 5) - 2);
+      mean[c] = static_cast<float>(static_cast<int>(c % 11) - 5);
+      var[c] = variances[c % 4];
+    }
+
+    auto& bn_node = helper.AddNode("BatchNormalization",
+                                   {add_output_arg,
+                                    helper.MakeInitializer({64}, scale),
+                                    helper.MakeInitializer({64}, bias),
+                                    helper.MakeInitializer({64}, mean),
+                                    helper.MakeInitializer({64}, var)},
+                                   {bn_output_arg});
+    bn_node.AddAttribute("epsilon", 0.0f);
+
+    helper.AddNode("Relu", {bn_output_arg}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 3);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  // Verify that a BatchNormalization node that could not be fused into a
+  // convolution at earlier levels is converted to a NCHWc depthwise
+  // convolution with the following activation fused.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
+TEST(NchwcOptimizerTests, Upsample) {
+  auto test_case = [&](const std::string& op_type, int opset_version, float scale_h, float scale_w, bool transformed) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input1_arg = helper.MakeInput({1, 48, 17, 15});
+      auto* input2_arg = helper.MakeInput({1, 48, static_cast<int64_t>(17 * scale_h), static_cast<int64_t>(15 * scale_w)});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* upsample_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      auto& conv1_node = helper.AddConvNode(input1_arg, conv1_output_arg, {32, 48, 3, 3});
+      conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+
+      std::vector<float> scales{1.0f, 1.0f, scale_h, scale_w};
+      if (opset_version >= 9) {
+        helper.AddNode(op_type, {conv1_output_arg, helper.MakeInitializer({4}, scales)}, {upsample_output_arg});
+      } else {
+        auto& upsample_node = helper.AddNode(op_type, {conv1_output_arg}, {upsample_output_arg});
+        upsample_node.AddAttribute("scales", scales);
+      }
+
+      // The lateral connection of a feature pyramid network.
+      helper.AddConvNode(input2_arg, conv2_output_arg, {32, 48, 1, 1});
+      helper.AddNode("Add", {upsample_output_arg, conv2_output_arg}, {output_arg});
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 2);
+      if (transformed) {
+        EXPECT_EQ(op_to_count["nchwc.Upsample"], 1);
+        EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+        EXPECT_EQ(op_to_count[op_type], 0);
+        EXPECT_EQ(op_to_count["Add"], 0);
+      } else {
+        EXPECT_EQ(op_to_count["nchwc.Upsample"], 0);
+        EXPECT_EQ(op_to_count[op_type], 1);
+      }
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, opset_version);
+  };
+
+  // Integral scale factors stay in NCHWc format.
+  test_case("Upsample", 7, 2.0f, 2.0f, true);
+  test_case("Upsample", 9, 2.0f, 3.0f, true);
+  test_case("Resize", 10, 3.0f, 1.0f, true);
+
+  // Fractional scale factors reorder back to NCHW.
+  test_case("Resize", 10, 1.5f, 2.0f, false);
+}
+
 TEST(NchwcOptimizerTests, ConvReuseWeightsOIHWBiBo) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput({1, 64, 7, 7});
@@ -53,5 +53,29 @@ TEST(RuleBasedGraphTransformerTest, TestCompatibleProviders) {
   ASSERT_TRUE(dummy_rule1_ptr->IsRewriteRuleInvoked());
 }
 
+TEST(GraphTransformerManagerTest, SkipTransformersWithoutChanges) {
+  string model_uri = "testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
+
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  // The first transformer modifies the graph on its first two runs, the second one never does.
+  auto modifying_transformer = std::make_unique<DummyGraphTransformer>("ModifyingTransformer", 2);
+  const auto* modifying_transformer_ptr = modifying_transformer.get();
+  auto idle_transformer = std::make_unique<DummyGraphTransformer>("IdleTransformer");
+  const auto* idle_transformer_ptr = idle_transformer.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(modifying_transformer), TransformerLevel::Level2);
+  graph_transformation_mgr.Register(std::move(idle_transformer), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  // The idle transformer runs after each modification, and is skipped in the last step, in which the graph
+  // isn't modified anymore.
+  ASSERT_EQ(modifying_transformer_ptr->InvocationCount(), 3);
+  ASSERT_EQ(idle_transformer_ptr->InvocationCount(), 2);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -3,8 +3,10 @@
 
 #include "command_args_parser.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <iostream>
+#include <map>
 
 // Windows Specific
 #ifdef _WIN32
@@ -32,6 +34,8 @@ namespace perftest {
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-q [target_qps]: Starts the runs at the given rate, spread over the -c parallel runs, whether the previous "
+      "runs ended or not. The latencies then count from the time each run was due.\n"
       "\t-e [cpu|cuda|mkldnn|tensorrt|ngraph|openvino|nuphar]: Specifies the provider 'cpu','cuda','mkldnn','tensorrt', "
       "'ngraph', 'openvino' or 'nuphar'. "
       "Default:'cpu'.\n"
@@ -43,6 +47,13 @@ namespace perftest {
       "\t-v: Show verbose information.\n"
       "\t-x [thread_size]: Session thread pool size, must >=0.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
+      "\t-d [name=value,...]: Runs with random inputs, of the shapes of the model with its symbolic dimensions set to "
+      "the given values, instead of the test data next to the model. e.g. -d batch=8,sequence=128\n"
+      "\t-S [sweep_file]: Benchmarks every combination of the settings of the file and writes a CSV table of the "
+      "results to result_file. The file has a line per setting, with the values to try separated by commas: "
+      "'provider=cpu,cuda', 'threads=0,1,4', 'execution=sequential,parallel' or 'dim.[name]=1,8,32' for a "
+      "symbolic dimension.\n"
+      "\t-R [seed]: Seeds the random picks of the test data, so that runs are reproducible. Default: random.\n"
       "\t-o [optimization level]: Default is 1. Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels. \n"
       "\t-h: help\n");
@@ -50,7 +61,7 @@ namespace perftest {
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:c:o:AMPvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:c:q:d:S:R:o:AMPvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -74,25 +85,7 @@ namespace perftest {
         test_config.run_config.enable_cpu_mem_arena = false;
         break;
       case 'e':
-        if (!CompareCString(optarg, ORT_TSTR("cpu"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCpuExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("cuda"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCudaExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("mkldnn"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kMklDnnExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("ngraph"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kNGraphExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("brainslice"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kBrainSliceExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("tensorrt"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kTensorrtExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("openvino"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kOpenVINOExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("nnapi"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kNnapiExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("nuphar"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kNupharExecutionProvider;
-        } else {
+        if (!ParseProviderName(ToMBString(optarg), test_config.machine_config.provider_type_name)) {
           return false;
         }
         break;
@@ -132,6 +125,26 @@ namespace perftest {
           return false;
         }
         break;
+      case 'd':
+        if (!ParseSymbolicDims(ToMBString(optarg), test_config.run_config.symbolic_dims)) {
+          return false;
+        }
+        break;
+      case 'S':
+        test_config.sweep_file = optarg;
+        break;
+      case 'R':
+        test_config.run_config.random_seed = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.random_seed < 0) {
+          return false;
+        }
+        break;
+      case 'q':
+        test_config.run_config.target_qps = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
@@ -175,5 +188,47 @@ namespace perftest {
   return true;
 }
 
+/*static*/ bool CommandLineParser::ParseProviderName(const std::string& name, std::string& provider_type) {
+  static const std::map<std::string, std::string> provider_types{
+      {"cpu", onnxruntime::kCpuExecutionProvider},
+      {"cuda", onnxruntime::kCudaExecutionProvider},
+      {"mkldnn", onnxruntime::kMklDnnExecutionProvider},
+      {"ngraph", onnxruntime::kNGraphExecutionProvider},
+      {"brainslice", onnxruntime::kBrainSliceExecutionProvider},
+      {"tensorrt", onnxruntime::kTensorrtExecutionProvider},
+      {"openvino", onnxruntime::kOpenVINOExecutionProvider},
+      {"nnapi", onnxruntime::kNnapiExecutionProvider},
+      {"nuphar", onnxruntime::kNupharExecutionProvider}};
+  auto it = provider_types.find(name);
+  if (it == provider_types.end()) {
+    return false;
+  }
+  provider_type = it->second;
+  return true;
+}
+
+/*static*/ bool CommandLineParser::ParseSymbolicDims(const std::string& text,
+                                                     std::map<std::string, int64_t>& symbolic_dims) {
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t end = text.find(',', begin);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    const std::string pair = text.substr(begin, end - begin);
+    const size_t equal = pair.find('=');
+    if (equal == std::string::npos || equal == 0) {
+      return false;
+    }
+    const long long value = strtoll(pair.c_str() + equal + 1, nullptr, 10);
+    if (value <= 0) {
+      return false;
+    }
+    symbolic_dims[pair.substr(0, equal)] = value;
+    begin = end + 1;
+  }
+  return true;
+}
+
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #pragma once
 #include <core/session/onnxruntime_c_api.h>
+#include <cstdint>
+#include <map>
+#include <string>
 
 namespace onnxruntime {
 namespace perftest {
@@ -13,6 +16,12 @@ class CommandLineParser {
  public:
   static void ShowUsage();
   static bool ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]);
+
+  // the provider type of a provider name of -e, e.g. "cuda"
+  static bool ParseProviderName(const std::string& name, std::string& provider_type);
+
+  // name=value pairs separated by commas, e.g. "batch=8,sequence=128"
+  static bool ParseSymbolicDims(const std::string& text, std::map<std::string, int64_t>& symbolic_dims);
 };
 
 }  // namespace perftest
@@ -6,6 +6,7 @@
 #include <random>
 #include "command_args_parser.h"
 #include "performance_runner.h"
+#include "sweep_runner.h"
 
 using namespace onnxruntime;
 
@@ -29,6 +30,16 @@ int real_main(int argc, char* argv[]) {
     return -1;
   }
   std::random_device rd;
+  if (!test_config.sweep_file.empty()) {
+    perftest::SweepRunner sweep_runner(env, test_config, rd);
+    auto status = sweep_runner.Run();
+    if (!status.IsOK()) {
+      printf("Sweep failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+    return 0;
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
   auto status = perf_runner.Run();
   if (!status.IsOK()) {
@@ -12,9 +12,13 @@ namespace onnxruntime {
 namespace perftest {
 
 std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
-  //Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
+  //Randomly pick one OrtValueArray from test_inputs_.
   const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
-  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+  size_t id;
+  {
+    std::lock_guard<std::mutex> guard(rand_mutex_);
+    id = static_cast<size_t>(dist_(rand_engine_, p));
+  }
   auto& input = test_inputs_.at(id);
   auto start = std::chrono::high_resolution_clock::now();
   auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
@@ -27,7 +31,10 @@ std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
 OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd,
                                                const PerformanceTestConfig& performance_test_config,
                                                const TestModelInfo* m)
-    : rand_engine_(rd()), input_names_(m->GetInputCount()), input_length_(m->GetInputCount()) {
+    : rand_engine_(performance_test_config.run_config.random_seed >= 0
+                       ? static_cast<std::mt19937::result_type>(performance_test_config.run_config.random_seed)
+                       : rd()),
+      input_names_(m->GetInputCount()), input_length_(m->GetInputCount()) {
   Ort::SessionOptions session_options;
   const std::string& provider_name = performance_test_config.machine_config.provider_type_name;
   if (provider_name == onnxruntime::kMklDnnExecutionProvider) {
@@ -7,7 +7,11 @@
 #endif
 
 #include "performance_runner.h"
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <thread>
+#include <type_traits>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -18,27 +22,6 @@
 #endif
 using onnxruntime::Status;
 
-// TODO: Temporary, while we bring up the threadpool impl...
-#include "core/platform/threadpool.h"
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
-#include <unsupported/Eigen/CXX11/ThreadPool>
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif
-using DefaultThreadPoolType = Eigen::ThreadPool;
-static std::unique_ptr<DefaultThreadPoolType> default_pool;
-static std::once_flag default_pool_init;
-Eigen::ThreadPoolInterface* GetDefaultThreadPool(const onnxruntime::Env& env) {
-  std::call_once(default_pool_init, [&env] {
-    int core_num = env.GetNumCpuCores();
-    default_pool.reset(new DefaultThreadPoolType(core_num));
-  });
-  return default_pool.get();
-}
-
 namespace onnxruntime {
 namespace perftest {
 Status PerformanceRunner::Run() {
@@ -77,96 +60,93 @@ Status PerformanceRunner::Run() {
             << "Total iterations:" << performance_result_.time_costs.size() << std::endl
             << "Average time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl
             // Time between start and end of run. Less than Total time cost when running requests in parallel.
-            << "Total run time:" << duration.count() << " s" << std::endl;
+            << "Total run time:" << duration.count() << " s" << std::endl
+            << "Session creation time cost:" << performance_result_.session_creation_time_cost << " s" << std::endl
+            << "Peak working set size:" << performance_result_.peak_workingset_size << " bytes" << std::endl;
+
+  const auto& run_config = performance_test_config_.run_config;
+  if ((run_config.concurrent_session_runs > 1 || run_config.target_qps > 0) &&
+      !performance_result_.time_costs.empty()) {
+    std::vector<double> sorted_time = performance_result_.time_costs;
+    std::sort(sorted_time.begin(), sorted_time.end());
+    auto percentile = [&sorted_time](double p) { return PerformanceResult::Percentile(sorted_time, p) * 1000; };
+    std::cout << "Throughput:" << sorted_time.size() / duration.count() << " runs/s" << std::endl
+              << "Latency P50:" << percentile(0.5) << " ms, P90:" << percentile(0.9)
+              << " ms, P99:" << percentile(0.99) << " ms, P99.9:" << percentile(0.999) << " ms" << std::endl;
+  }
   return Status::OK();
 }
 
 Status PerformanceRunner::FixDurationTest() {
-  if (performance_test_config_.run_config.concurrent_session_runs <= 1) {
+  if (performance_test_config_.run_config.concurrent_session_runs <= 1 &&
+      performance_test_config_.run_config.target_qps <= 0) {
     return RunFixDuration();
   }
 
-  return RunParallelDuration();
+  return RunClients();
 }
 
 Status PerformanceRunner::RepeatedTimesTest() {
-  if (performance_test_config_.run_config.concurrent_session_runs <= 1) {
+  if (performance_test_config_.run_config.concurrent_session_runs <= 1 &&
+      performance_test_config_.run_config.target_qps <= 0) {
     return RunRepeatedTimes();
   }
 
-  return ForkJoinRepeat();
-}
-
-Status PerformanceRunner::RunParallelDuration() {
-  // Simple method to continually queue parallel work until the timer has run down.
-  // TODO: Make each thread enqueue a new worker.
-  auto tpool = GetDefaultThreadPool(Env::Default());
-  std::atomic<int> counter = {0};
-  std::mutex m;
-  std::condition_variable cv;
-
-  auto start = std::chrono::high_resolution_clock::now();
-  auto end = start;
-  std::chrono::duration<double> duration_seconds;
-  do {
-    // We will queue work as deep as requested, ignoring the size of the threadpool itself
-    int count = counter.load(std::memory_order_seq_cst);
-    while (count < static_cast<int>(performance_test_config_.run_config.concurrent_session_runs)) {
-      count++;
-      counter++;
-      tpool->Schedule([this, &counter, &m, &cv]() {
-        session_->ThreadSafeRun();
-        // Simplified version of Eigen::Barrier
-        std::lock_guard<std::mutex> lg(m);
-        counter--;
-        cv.notify_all();
-      });
-    }
-    end = std::chrono::high_resolution_clock::now();
-    duration_seconds = end - start;
-  } while (duration_seconds.count() < performance_test_config_.run_config.duration_in_seconds);
-
-  //Join
-  std::unique_lock<std::mutex> lock(m);
-  cv.wait(lock, [&counter]() { return counter == 0; });
-
-  return Status::OK();
+  return RunClients();
 }
 
-Status PerformanceRunner::ForkJoinRepeat() {
+Status PerformanceRunner::RunClients() {
+  using Clock = std::chrono::high_resolution_clock;
   const auto& run_config = performance_test_config_.run_config;
+  const bool is_duration_mode = run_config.test_mode == TestMode::kFixDurationMode;
+  const bool is_paced = run_config.target_qps > 0;
+
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(run_config.duration_in_seconds);
+  std::atomic<size_t> next_run{0};
+  std::mutex status_mutex;
+  Status status;
+
+  auto client = [&]() {
+    for (;;) {
+      const size_t run = next_run++;
+      if (!is_duration_mode && run >= run_config.repeated_times) {
+        return;
+      }
 
-  // create a threadpool with one thread per concurrent request
-  auto tpool = std::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
-  std::atomic<int> counter{0}, requests{0};
-  std::mutex m;
-  std::condition_variable cv;
-
-  // Fork
-  counter.load(std::memory_order_seq_cst);
-  requests.load(std::memory_order_seq_cst);
+      // the time the run is due with pacing, or now without
+      Clock::time_point due = Clock::now();
+      if (is_paced) {
+        due = start + std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(run / run_config.target_qps));
+      }
+      if (is_duration_mode && due >= end) {
+        return;
+      }
+      if (is_paced) {
+        std::this_thread::sleep_until(due);
+      }
 
-  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
-    counter++;
-    tpool->Schedule([this, &counter, &requests, &m, &cv, &run_config]() {
-      while (requests++ < static_cast<int>(run_config.repeated_times)) {
-        auto status = RunOneIteration<false>();
-        if (!status.IsOK())
-          std::cerr << status.ErrorMessage();
+      try {
+        session_->Run();
+      } catch (const std::exception& ex) {
+        std::lock_guard<std::mutex> guard(status_mutex);
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "run failed: ", ex.what());
+        return;
       }
+      RecordTimeCost(std::chrono::duration<double>(Clock::now() - due).count());
+    }
+  };
 
-      // Simplified version of Eigen::Barrier
-      std::lock_guard<std::mutex> lg(m);
-      counter--;
-      cv.notify_all();
-    });
+  std::vector<std::thread> clients;
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    clients.emplace_back(client);
+  }
+  for (auto& thread : clients) {
+    thread.join();
   }
 
-  //Join
-  std::unique_lock<std::mutex> lock(m);
-  cv.wait(lock, [&counter]() { return counter == 0; });
-
-  return Status::OK();
+  return status;
 }
 
 static TestModelInfo* CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
@@ -194,8 +174,12 @@ static TestSession* CreateSession(Ort::Env& env, std::random_device& rd,
 }
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)),
-      session_(CreateSession(env, rd, test_config, test_model_info_)) {}
+      test_model_info_(CreateModelInfo(test_config)) {
+  const auto start = std::chrono::high_resolution_clock::now();
+  session_.reset(CreateSession(env, rd, test_config, test_model_info_));
+  const std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+  performance_result_.session_creation_time_cost = duration.count();
+}
 
 PerformanceRunner::~PerformanceRunner() = default;
 
@@ -214,6 +198,12 @@ bool PerformanceRunner::Initialize() {
   std::string narrow_model_name = ToMBString(model_name);
   performance_result_.model_name = narrow_model_name;
 
+  if (!performance_test_config_.run_config.symbolic_dims.empty()) {
+    const bool generated = GenerateInputs();
+    test_model_info_ = nullptr;
+    return generated;
+  }
+
   test_case_.reset(CreateOnnxTestCase(narrow_model_name, test_model_info_, 0.0, 0.0));
 
   // TODO: Place input tensor on cpu memory if mkldnn provider type to avoid CopyTensor logic in CopyInputAcrossDevices
@@ -242,6 +232,82 @@ bool PerformanceRunner::Initialize() {
   return true;
 }
 
+template <typename T>
+static void FillRandom(Ort::Value& value, size_t count, std::mt19937& engine, T min, T max) {
+  T* data = value.GetTensorMutableData<T>();
+  std::uniform_real_distribution<double> dist(static_cast<double>(min), static_cast<double>(max));
+  for (size_t i = 0; i != count; ++i) {
+    const double x = dist(engine);
+    data[i] = static_cast<T>(std::is_integral<T>::value ? std::floor(x) : x);
+  }
+}
+
+bool PerformanceRunner::GenerateInputs() {
+  const auto& symbolic_dims = performance_test_config_.run_config.symbolic_dims;
+  // the same inputs for every run of the tool, so that the configurations of a sweep compare
+  std::mt19937 engine(0);
+  Ort::AllocatorWithDefaultOptions allocator;
+
+  const int input_count = test_model_info_->GetInputCount();
+  for (int i = 0; i != input_count; ++i) {
+    const std::string& name = test_model_info_->GetInputName(i);
+    const ONNX_NAMESPACE::ValueInfoProto* info = test_model_info_->GetInputInfoFromModel(i);
+    if (info == nullptr || !info->type().has_tensor_type()) {
+      std::cout << "can't generate input " << name << ", which is not a tensor of an ONNX model" << std::endl;
+      return false;
+    }
+
+    const auto& tensor_type = info->type().tensor_type();
+    std::vector<int64_t> shape;
+    for (const auto& dim : tensor_type.shape().dim()) {
+      if (dim.has_dim_value()) {
+        shape.push_back(dim.dim_value());
+        continue;
+      }
+      auto it = symbolic_dims.find(dim.dim_param());
+      if (it == symbolic_dims.end()) {
+        std::cout << "no value is given for the dimension '" << dim.dim_param() << "' of input " << name
+                  << std::endl;
+        return false;
+      }
+      shape.push_back(it->second);
+    }
+
+    const auto type = static_cast<ONNXTensorElementDataType>(tensor_type.elem_type());
+    Ort::Value value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+    const size_t count = value.GetTensorTypeAndShapeInfo().GetElementCount();
+    // small integers, as they are often indices into the tensors of the model
+    switch (type) {
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+        FillRandom<float>(value, count, engine, -1, 1);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+        FillRandom<double>(value, count, engine, -1, 1);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        FillRandom<int32_t>(value, count, engine, 0, 16);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        FillRandom<int64_t>(value, count, engine, 0, 16);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+        FillRandom<int8_t>(value, count, engine, -16, 16);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        FillRandom<uint8_t>(value, count, engine, 0, 16);
+        break;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        FillRandom<bool>(value, count, engine, 0, 2);
+        break;
+      default:
+        std::cout << "can't generate input " << name << " of type " << type << std::endl;
+        return false;
+    }
+    session_->PreLoadTestData(0, static_cast<size_t>(i), value.release());
+  }
+  return true;
+}
+
 }  // namespace perftest
 
 }  // namespace onnxruntime
@@ -31,11 +31,18 @@ struct PerformanceResult {
   std::chrono::time_point<std::chrono::high_resolution_clock> start_;
   std::chrono::time_point<std::chrono::high_resolution_clock> end_;
   size_t peak_workingset_size{0};
+  // the seconds taken to create the session: loading, optimizing and initializing the model
+  double session_creation_time_cost{0};
   short average_CPU_usage{0};
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
 
+  // the time cost at a percentile, e.g. 0.99, of sorted time costs
+  static double Percentile(const std::vector<double>& sorted_time, double percentile) {
+    return sorted_time[std::min(sorted_time.size() - 1, static_cast<size_t>(sorted_time.size() * percentile))];
+  }
+
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const {
     std::ofstream outfile;
     outfile.open(path, std::ofstream::out | std::ofstream::app);
@@ -97,25 +104,35 @@ class PerformanceRunner {
  private:
   bool Initialize();
 
+  // preload random inputs of the shapes of the model, see RunConfig::symbolic_dims
+  bool GenerateInputs();
+
   template <bool isWarmup>
   Status RunOneIteration() {
     std::chrono::duration<double> duration_seconds = session_->Run();
     if (!isWarmup) {
-      std::lock_guard<std::mutex> guard(results_mutex_);
-      performance_result_.time_costs.emplace_back(duration_seconds.count());
-      performance_result_.total_time_cost += duration_seconds.count();
-      if (performance_test_config_.run_config.f_verbose) {
-        std::cout << "iteration:" << performance_result_.time_costs.size() << ","
-                  << "time_cost:" << performance_result_.time_costs.back() << std::endl;
-      }
+      RecordTimeCost(duration_seconds.count());
     }
     return Status::OK();
   }
 
+  void RecordTimeCost(double time_cost) {
+    std::lock_guard<std::mutex> guard(results_mutex_);
+    performance_result_.time_costs.emplace_back(time_cost);
+    performance_result_.total_time_cost += time_cost;
+    if (performance_test_config_.run_config.f_verbose) {
+      std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+                << "time_cost:" << performance_result_.time_costs.back() << std::endl;
+    }
+  }
+
   Status FixDurationTest();
   Status RepeatedTimesTest();
-  Status ForkJoinRepeat();
-  Status RunParallelDuration();
+
+  // Runs with concurrent_session_runs clients. Without target_qps, each client starts its next run when the previous
+  // one ends (closed loop). With it, the runs are due at that rate whether the previous ones ended or not (open loop),
+  // and their time costs count from when they were due, so they include the time waiting for a free client.
+  Status RunClients();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
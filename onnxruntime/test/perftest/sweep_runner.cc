@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "sweep_runner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "command_args_parser.h"
+#include "performance_runner.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+static const char* const kDimSettingPrefix = "dim.";
+
+static std::string Trim(const std::string& s) {
+  const size_t begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+// quoted if needed, as the error messages may contain commas and line breaks
+static std::string CsvField(const std::string& s) {
+  if (s.find_first_of(",\"\n") == std::string::npos) {
+    return s;
+  }
+  std::string quoted = "\"";
+  for (char c : s) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+/*static*/ bool SweepRunner::ApplySetting(const std::string& name, const std::string& value,
+                                          PerformanceTestConfig& config) {
+  if (name == "provider") {
+    return CommandLineParser::ParseProviderName(value, config.machine_config.provider_type_name);
+  }
+  if (name == "threads") {
+    char* end = nullptr;
+    const long threads = strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0' || threads < 0) {
+      return false;
+    }
+    config.run_config.session_thread_pool_size = static_cast<int>(threads);
+    return true;
+  }
+  if (name == "execution") {
+    if (value != "sequential" && value != "parallel") {
+      return false;
+    }
+    config.run_config.enable_sequential_execution = value == "sequential";
+    return true;
+  }
+  if (name.compare(0, strlen(kDimSettingPrefix), kDimSettingPrefix) == 0 && name.size() > strlen(kDimSettingPrefix)) {
+    return CommandLineParser::ParseSymbolicDims(name.substr(strlen(kDimSettingPrefix)) + "=" + value,
+                                                config.run_config.symbolic_dims);
+  }
+  return false;
+}
+
+Status SweepRunner::LoadSweepFile() {
+  std::ifstream file(test_config_.sweep_file);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to open sweep file ", ToMBString(test_config_.sweep_file));
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    line = Trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const size_t equal = line.find('=');
+    if (equal == std::string::npos) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid line in sweep file: ", line);
+    }
+
+    std::pair<std::string, std::vector<std::string>> setting;
+    setting.first = Trim(line.substr(0, equal));
+    std::istringstream values(line.substr(equal + 1));
+    std::string value;
+    while (std::getline(values, value, ',')) {
+      value = Trim(value);
+      // check the values now rather than after benchmarking the configurations before them
+      PerformanceTestConfig config = test_config_;
+      if (!ApplySetting(setting.first, value, config)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid value '", value, "' of setting '",
+                               setting.first, "' in sweep file");
+      }
+      setting.second.push_back(value);
+    }
+    if (setting.second.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "no value for setting '", setting.first,
+                             "' in sweep file");
+    }
+    settings_.push_back(std::move(setting));
+  }
+  return Status::OK();
+}
+
+Status SweepRunner::Run() {
+  ORT_RETURN_IF_ERROR(LoadSweepFile());
+
+  std::ofstream table(test_config_.model_info.result_file_path, std::ofstream::out | std::ofstream::trunc);
+  if (!table.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to open result file");
+  }
+  for (const auto& setting : settings_) {
+    table << CsvField(setting.first) << ",";
+  }
+  table << "iterations,average_ms,p50_ms,p90_ms,p99_ms,p999_ms,runs_per_second,error" << std::endl;
+
+  // the index of the value of each setting in the current configuration, the last setting varying fastest
+  std::vector<size_t> indices(settings_.size(), 0);
+  for (;;) {
+    PerformanceTestConfig config = test_config_;
+    std::string row;
+    for (size_t i = 0; i != settings_.size(); ++i) {
+      const std::string& value = settings_[i].second[indices[i]];
+      ApplySetting(settings_[i].first, value, config);
+      row += CsvField(value) + ",";
+    }
+    std::cout << "Configuration: " << row << std::endl;
+
+    std::string error;
+    PerformanceResult result;
+    try {
+      PerformanceRunner runner(env_, config, rd_);
+      const Status status = runner.Run();
+      if (status.IsOK()) {
+        result = runner.GetResult();
+      } else {
+        error = status.ErrorMessage();
+      }
+    } catch (const std::exception& ex) {
+      error = ex.what();
+    }
+
+    table << row;
+    if (result.time_costs.empty()) {
+      table << ",,,,,,,";
+    } else {
+      std::vector<double> sorted_time = result.time_costs;
+      std::sort(sorted_time.begin(), sorted_time.end());
+      const std::chrono::duration<double> duration = result.end_ - result.start_;
+      table << sorted_time.size() << "," << result.total_time_cost / sorted_time.size() * 1000 << ","
+            << PerformanceResult::Percentile(sorted_time, 0.5) * 1000 << ","
+            << PerformanceResult::Percentile(sorted_time, 0.9) * 1000 << ","
+            << PerformanceResult::Percentile(sorted_time, 0.99) * 1000 << ","
+            << PerformanceResult::Percentile(sorted_time, 0.999) * 1000 << ","
+            << sorted_time.size() / duration.count() << ",";
+    }
+    table << CsvField(error) << std::endl;
+
+    size_t i = settings_.size();
+    while (i > 0 && ++indices[i - 1] == settings_[i - 1].second.size()) {
+      indices[i - 1] = 0;
+      --i;
+    }
+    if (i == 0) {
+      break;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <core/common/common.h>
+#include <core/common/status.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include "test_configuration.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+/**
+Benchmarks every combination of the settings of a sweep file with a PerformanceRunner, and writes a CSV table of their
+results to the result file. The sweep file has a line per setting, with the values to try separated by commas:
+  provider=cpu,cuda
+  threads=0,1,4
+  execution=sequential,parallel
+  dim.batch=1,8,32
+where dim.<name> sets a symbolic dimension of the inputs, which are then random. Lines starting with # are ignored,
+and the settings left out keep the values of the command line.
+*/
+class SweepRunner {
+ public:
+  SweepRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
+      : env_(env), test_config_(test_config), rd_(rd) {}
+
+  Status Run();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SweepRunner);
+
+ private:
+  Status LoadSweepFile();
+
+  // set a setting of the sweep file in a configuration. returns false if the setting or its value is invalid.
+  static bool ApplySetting(const std::string& name, const std::string& value, PerformanceTestConfig& config);
+
+  Ort::Env& env_;
+  const PerformanceTestConfig test_config_;
+  std::random_device& rd_;
+  // the settings and their values, in the order of the file
+  std::vector<std::pair<std::string, std::vector<std::string>>> settings_;
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
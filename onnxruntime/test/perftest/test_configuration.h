@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
 
 #include "core/graph/constants.h"
@@ -39,6 +40,8 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // paces the runs at this rate when positive, see PerformanceRunner::RunClients
+  double target_qps{0};
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
@@ -46,6 +49,11 @@ struct RunConfig {
   bool enable_sequential_execution{true};
   int session_thread_pool_size{-1};
   GraphOptimizationLevel optimization_level{ORT_ENABLE_EXTENDED};
+  // the values of the symbolic dimensions of the inputs. when set, the inputs are random tensors of the shapes the
+  // model gives them instead of the test data next to it.
+  std::map<std::string, int64_t> symbolic_dims;
+  // seeds the random picks of the test data when not negative, so the runs are reproducible
+  int64_t random_seed{-1};
 };
 
 struct PerformanceTestConfig {
@@ -53,6 +61,8 @@ struct PerformanceTestConfig {
   MachineConfig machine_config;
   RunConfig run_config;
   std::basic_string<ORTCHAR_T> backend = ORT_TSTR("ort");
+  // benchmarks the configurations of the file instead of a single one, see SweepRunner
+  std::basic_string<ORTCHAR_T> sweep_file;
 };
 
 }  // namespace perftest
@@ -10,11 +10,8 @@ namespace onnxruntime {
 namespace perftest {
 class TestSession {
  public:
+  // may be called concurrently, see RunConfig::concurrent_session_runs
   virtual std::chrono::duration<double> Run() = 0;
-  // TODO: implement it
-  // This function won't return duration, because it may vary largely.
-  // Please measure the perf at a higher level.
-  void ThreadSafeRun() { abort(); }
   virtual void PreLoadTestData(size_t test_data_id, size_t input_id, OrtValue* value) = 0;
 
   virtual ~TestSession() = default;
@@ -4,6 +4,7 @@
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
 #include <core/platform/env.h>
+#include <mutex>
 #include "test_configuration.h"
 #include "tensorflow/c/c_api.h"
 #include "test_session.h"
@@ -12,6 +13,8 @@ namespace onnxruntime {
 namespace perftest {
 class TensorflowTestSession : public TestSession {
  private:
+  // guards the random pick of the inputs of the concurrent runs
+  std::mutex rand_mutex_;
   std::mt19937 rand_engine_;
   std::uniform_int_distribution<int> dist_;
   OrtCallback model_deleter;
@@ -45,7 +48,9 @@ class TensorflowTestSession : public TestSession {
  public:
   TensorflowTestSession(std::random_device& rd, const PerformanceTestConfig& performance_test_config,
                         const TestModelInfo* m)
-      : rand_engine_(rd()) {
+      : rand_engine_(performance_test_config.run_config.random_seed >= 0
+                         ? static_cast<std::mt19937::result_type>(performance_test_config.run_config.random_seed)
+                         : rd()) {
     TF_Status* s = TF_NewStatus();
     tf_graph_ = TF_NewGraph();
     TF_ImportGraphDefOptions* opts = TF_NewImportGraphDefOptions();
@@ -198,9 +203,13 @@ class TensorflowTestSession : public TestSession {
     feed_tensors_[test_data_id][input_id] = t;
   }
   std::chrono::duration<double> Run() override {
-    //Randomly pick one OrtValueArray from feed_tensors_. (NOT ThreadSafe)
+    //Randomly pick one OrtValueArray from feed_tensors_.
     const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(feed_tensors_.size() - 1));
-    const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+    size_t id;
+    {
+      std::lock_guard<std::mutex> guard(rand_mutex_);
+      id = static_cast<size_t>(dist_(rand_engine_, p));
+    }
     std::vector<TF_Tensor*>& feed_tensors = feed_tensors_.at(id);
 
     TF_Status* s = TF_NewStatus();
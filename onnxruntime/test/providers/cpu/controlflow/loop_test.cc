@@ -713,6 +713,61 @@ TEST(Loop, Opset11WithNoVariadicInputsAndOutputs) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// loop carried vars produced with a static shape alternate between two buffers across the iterations
+TEST(Loop, DoubleBufferedLoopCarriedVar) {
+  auto create_subgraph = []() {
+    Model model("Loop double buffered body graph");
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_tensor;
+    int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_tensor;
+    bool_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_tensor);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_tensor);
+    auto& loop_var_in = graph.GetOrCreateNodeArg("loop_var_in", &float_tensor);
+
+    auto& not_cond = graph.GetOrCreateNodeArg("not_cond", &bool_tensor);
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_tensor);
+    auto& loop_var_out = graph.GetOrCreateNodeArg("loop_var_out", &float_tensor);
+    auto& loop_out = graph.GetOrCreateNodeArg("loop_out", &float_tensor);
+
+    graph.AddNode("not_0", "Not", "Negate cond_in", {&cond_in}, {&not_cond});
+    graph.AddNode("not_1", "Not", "Negate it back to cond_out", {&not_cond}, {&cond_out});
+    graph.AddNode("add", "Add", "Double the loop carried var", {&loop_var_in, &loop_var_in}, {&loop_var_out});
+    graph.AddNode("mul", "Mul", "Square the loop carried var", {&loop_var_in, &loop_var_in}, {&loop_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_in});
+    graph.SetOutputs({&cond_out, &loop_var_out, &loop_out});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", create_subgraph());
+  test.AddInput<int64_t>("M", {1}, {4});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var", {2}, {1.f, 2.f});
+
+  // the later iterations write over the values of the earlier ones, which must not change the squares before them
+  test.AddOutput<float>("loop_var_final", {2}, {16.f, 32.f});
+  test.AddOutput<float>("loop_out_final", {4, 2}, {1.f, 4.f, 4.f, 16.f, 16.f, 64.f, 64.f, 256.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
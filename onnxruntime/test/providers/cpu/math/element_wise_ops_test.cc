@@ -49,6 +49,32 @@ TEST(MathOpTest, Add_float) {
 #endif
 }
 
+// the float kernels selected for the instruction set level of the CPU process spans of 8 or 16 elements, then the
+// remaining ones
+TEST(MathOpTest, BinaryFloat_VectorTail) {
+  const int64_t size = 37;
+  std::vector<float> a(size);
+  std::vector<float> b(size);
+  for (int64_t i = 0; i < size; ++i) {
+    a[i] = 0.5f * i - 3.0f;
+    b[i] = 2.0f + 0.25f * i;
+  }
+
+  for (const char* op : {"Add", "Sub", "Mul", "Div"}) {
+    std::vector<float> expected(size);
+    for (int64_t i = 0; i < size; ++i) {
+      const std::string op_type(op);
+      expected[i] = op_type == "Add" ? a[i] + b[i] : op_type == "Sub" ? a[i] - b[i] : op_type == "Mul" ? a[i] * b[i] : a[i] / b[i];
+    }
+
+    OpTester test(op);
+    test.AddInput<float>("A", {size}, a);
+    test.AddInput<float>("B", {size}, b);
+    test.AddOutput<float>("C", {size}, expected);
+    test.Run();
+  }
+}
+
 TEST(MathOpTest, Add_double) {
   OpTester test("Add");
   std::vector<int64_t> dims{3, 3};
@@ -194,6 +220,40 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+TEST(MathOpTest, Add_Broadcast_Large_ManySpans) {
+  // many short spans, so the spans are partitioned across threads
+  const int64_t rows = 1024, cols = 96;
+  std::vector<float> a(rows), b(rows * cols), c(rows * cols);
+  for (int64_t i = 0; i < rows; ++i) a[i] = static_cast<float>(i);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    b[i] = static_cast<float>(i % 97) * 0.5f;
+    c[i] = a[i / cols] + b[i];
+  }
+
+  OpTester test("Add");
+  test.AddInput<float>("A", {rows, 1}, a);
+  test.AddInput<float>("B", {rows, cols}, b);
+  test.AddOutput<float>("C", {rows, cols}, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Mul_Broadcast_Large_FewSpans) {
+  // a few long spans, so each span is split across threads
+  const int64_t outer = 2, inner = 65536;
+  std::vector<float> a(outer * inner), b(inner), c(outer * inner);
+  for (int64_t i = 0; i < inner; ++i) b[i] = static_cast<float>(i % 13) - 6.0f;
+  for (int64_t i = 0; i < outer * inner; ++i) {
+    a[i] = static_cast<float>(i % 7) * 0.25f;
+    c[i] = a[i] * b[i % inner];
+  }
+
+  OpTester test("Mul");
+  test.AddInput<float>("A", {outer, inner}, a);
+  test.AddInput<float>("B", {inner}, b);
+  test.AddOutput<float>("C", {outer, inner}, c);
+  test.Run();
+}
+
 TEST(MathOpTest, Sub_int32) {
   OpTester test("Sub");
   test.AddInput<int32_t>("A", {3}, {1, 4, 3});
@@ -1062,6 +1122,22 @@ TEST(MathOpTest, Expand_8_1x3) {
   test.Run();
 }
 
+// Large enough for the copy to be split across threads, with a broadcast axis on each side of a copied one.
+TEST(MathOpTest, Expand_8_Large) {
+  OpTester test("Expand", 8);
+  std::vector<float> input{1.0f, 2.0f, 3.0f};
+  std::vector<float> output;
+  for (int i = 0; i < 64; ++i) {
+    for (float value : input) {
+      output.insert(output.end(), 64, value);
+    }
+  }
+  test.AddInput<float>("data_0", {3, 1}, input);
+  test.AddInput<int64_t>("data_1", {3}, {64, 1, 64});
+  test.AddOutput<float>("result", {64, 3, 64}, output);
+  test.Run();
+}
+
 TEST(MathOpTest, Expand_8_3x3_int32) {
   OpTester test("Expand", 8);
   test.AddInput<int32_t>("data_0", {1}, {1});
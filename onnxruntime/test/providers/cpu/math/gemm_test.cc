@@ -26,8 +26,6 @@ TEST(GemmOpTest, GemmNoTrans) {
   test.Run();
 }
 
-// Only CUDA kernel has float 16 support
-#ifdef USE_CUDA
 TEST(GemmOpTest, GemmNoTrans_f16) {
   OpTester test("Gemm");
 
@@ -58,7 +56,6 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
   test.AddOutput<MLFloat16>("Y", {2, 3}, f_Y);
   test.Run();
 }
-#endif
 
 TEST(GemmOpTest, GemmBroadcast) {
   OpTester test("Gemm");
@@ -100,6 +97,41 @@ TEST(GemmOpTest, GemmTrans) {
   test.Run();
 }
 
+TEST(GemmOpTest, GemmConstantB) {
+  // a constant B is packed when the kernel is created
+  for (int64_t trans_b = 0; trans_b <= 1; ++trans_b) {
+    OpTester test("Gemm");
+
+    test.AddAttribute("transA", (int64_t)0);
+    test.AddAttribute("transB", trans_b);
+    test.AddAttribute("alpha", 1.0f);
+    test.AddAttribute("beta", 1.0f);
+
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    if (trans_b == 0) {
+      test.AddInput<float>("B", {4, 3},
+                           {0.0f, 1.0f, 2.0f,
+                            3.0f, 4.0f, 5.0f,
+                            6.0f, 7.0f, 8.0f,
+                            9.0f, 10.0f, 11.0f},
+                           true);
+    } else {
+      test.AddInput<float>("B", {3, 4},
+                           {0.0f, 3.0f, 6.0f, 9.0f,
+                            1.0f, 4.0f, 7.0f, 10.0f,
+                            2.0f, 5.0f, 8.0f, 11.0f},
+                           true);
+    }
+    test.AddInput<float>("C", {3}, std::vector<float>(3, 1.0f));
+    test.AddOutput<float>("Y", {2, 3},
+                          {61.0f, 71.0f, 81.0f,
+                           -59.0f, -69.0f, -79.0f});
+    test.Run();
+  }
+}
+
 TEST(GemmOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
@@ -23,6 +23,40 @@ TEST(MatmulIntegerOpTest, MatMulInteger_2D) {
   test.Run();
 }
 
+TEST(MatmulIntegerOpTest, MatMulInteger_3D) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {2, 2, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {2, 3, 2}, {1, 4, 2, 5, 3, 6, 6, 3, 5, 2, 4, 1});
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {}, {0});
+  test.AddOutput<int32_t>("T3", {2, 2, 2}, {-38, -83, -44, -98, -97, -34, -112, -40});
+  test.Run();
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_2D_ConstantB) {
+  // a constant B is packed when the kernel is created
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6}, true);
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {}, {1});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-23, -68, -26, -80, -29, -92, -32, -104});
+  test.Run();
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_2D_PerColumnZeroPoint) {
+  // the columns of B have the zero points of MatMulInteger_2D and MatMulInteger_2D_ConstantB
+  for (bool constant_b : {false, true}) {
+    OpTester test("MatMulInteger", 10);
+    test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+    test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6}, constant_b);
+    test.AddInput<uint8_t>("a_zero_point", {}, {12});
+    test.AddInput<uint8_t>("b_zero_point", {2}, {0, 1});
+    test.AddOutput<int32_t>("T3", {4, 2}, {-38, -68, -44, -80, -50, -92, -56, -104});
+    test.Run();
+  }
+}
+
 TEST(MatmulIntegerOpTest, MatMulInteger) {
   OpTester test("MatMulInteger", 10);
   test.AddInput<uint8_t>("T1", {1, 1}, {11});
@@ -81,7 +81,7 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
@@ -93,7 +93,7 @@ void RunMatMulTest(int32_t opset_version = 7)
 
     int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
 
@@ -105,6 +105,35 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+TEST(MathOpTest, MatMulFloatTypeConstantB) {
+  // a constant 2-D B is packed when the kernel is created
+  RunMatMulTest<float>(7, true);
+}
+
+TEST(MathOpTest, MatMulFloat16Type) {
+  // the test values are small integers, which half precision represents exactly
+  std::vector<float> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  for (auto t : GenerateTestCases<float>()) {
+    OpTester test("MatMul", 7);
+
+    int64_t size0 = TensorShape::ReinterpretBaseType(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    std::vector<MLFloat16> input0_vals(size0);
+    ConvertFloatToMLFloat16(common_input_vals.data(), input0_vals.data(), static_cast<int>(size0));
+    test.AddInput<MLFloat16>("A", t.input0_dims, input0_vals);
+
+    int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    std::vector<MLFloat16> input1_vals(size1);
+    ConvertFloatToMLFloat16(common_input_vals.data(), input1_vals.data(), static_cast<int>(size1));
+    test.AddInput<MLFloat16>("B", t.input1_dims, input1_vals);
+
+    std::vector<MLFloat16> expected_vals(t.expected_vals.size());
+    ConvertFloatToMLFloat16(t.expected_vals.data(), expected_vals.data(), static_cast<int>(expected_vals.size()));
+    test.AddOutput<MLFloat16>("Y", t.expected_dims, expected_vals);
+
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // Disable TensorRT because of unsupported data type
+  }
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
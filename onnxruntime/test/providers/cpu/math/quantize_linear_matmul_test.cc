@@ -58,5 +58,20 @@ TEST(QuantizeLinearMatmulOpTest, QLinearMatMul) {
   test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
   test.Run();
 }
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulConstantB) {
+  // a constant T2 is packed when the kernel is created
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 4}, {208, 236, 0, 238, 3, 214, 255, 29});
+  test.AddInput<float>("a_scale", {}, {0.0066f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {113});
+  test.AddInput<uint8_t>("T2", {4, 3}, {152, 51, 244, 60, 26, 255, 0, 127, 246, 127, 254, 247}, true);
+  test.AddInput<float>("b_scale", {}, {0.00705f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {114});
+  test.AddInput<float>("y_scale", {}, {0.0107f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {118});
+  test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -179,6 +179,22 @@ TEST(SoftmaxOperator, ThreeDimsNegativeAxis) {
   RunTest(x_vals_3dims, expected_vals, three_dimensions, /*axis*/ -1);
 }
 
+TEST(SoftmaxOperator, LongRows) {
+  // rows of 2000 elements, longer than the ones a single warp computes on CUDA
+  const int64_t D = 2000;
+  std::vector<float> x_vals(2 * D);
+  std::vector<float> expected_vals(2 * D);
+  for (int64_t i = 0; i < D; ++i) {
+    x_vals[i] = 1.0f;
+    expected_vals[i] = 1.0f / D;
+    // the second row holds one large value, which takes nearly all the probability
+    x_vals[D + i] = i == 7 ? 100.0f : 0.0f;
+    expected_vals[D + i] = i == 7 ? 1.0f : 0.0f;
+  }
+
+  RunTest(x_vals, expected_vals, {2, D});
+}
+
 TEST(SoftmaxOperator, InvalidAxis) {
   std::vector<float> x_vals = {-1.0f, 0.0f, 1.0f};
   std::vector<float> expected_vals = {0.0f, 0.0f, 0.0f};
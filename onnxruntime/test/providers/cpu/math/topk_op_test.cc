@@ -264,5 +264,39 @@ TEST(TopKOperator, Top1ExplicitAxisMultiDInputOpset10) {
   RunTest(10, 1, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, axis);
 }
 
+TEST(TopKOperator, Top5LargeVocabularyOpset10) {
+  // beam search style: a few rows over a large vocabulary, so the rows are split across threads
+  // and each row is selected with the heap
+  const int64_t rows = 4, vocabulary = 50000, k = 5;
+  std::vector<float> input_vals(rows * vocabulary);
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t v = 0; v < vocabulary; ++v) {
+      input_vals[i * vocabulary + v] = static_cast<float>((v * 7919 + i * 13) % vocabulary);
+    }
+    // the values of each row are a permutation of 0..vocabulary-1
+    for (int64_t l = 0; l < k; ++l) {
+      const int64_t value = vocabulary - 1 - l;
+      expected_vals.push_back(static_cast<float>(value));
+      for (int64_t v = 0; v < vocabulary; ++v) {
+        if (input_vals[i * vocabulary + v] == static_cast<float>(value)) {
+          expected_indices.push_back(v);
+          break;
+        }
+      }
+    }
+  }
+  RunTest(10, k, input_vals, {rows, vocabulary}, expected_vals, expected_indices, {rows, k}, false);
+}
+
+TEST(TopKOperator, TopHalfWithTiesOpset10) {
+  // k is large compared to the axis, so nth_element is used; ties keep the lower index first
+  std::vector<float> input_vals = {3.0f, 1.0f, 3.0f, 2.0f, 1.0f, 2.0f, 0.0f, 3.0f};
+  std::vector<float> expected_vals = {3.0f, 3.0f, 3.0f, 2.0f};
+  std::vector<int64_t> expected_indices = {0, 2, 7, 3};
+  RunTest(10, 4, input_vals, {1, 8}, expected_vals, expected_indices, {1, 4});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
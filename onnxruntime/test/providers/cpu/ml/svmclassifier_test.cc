@@ -211,5 +211,59 @@ TEST(MLOpTest, SVMClassifierSVCDouble) {
   test.Run();
 }
 
+TEST(MLOpTest, SVMClassifierMulticlassSVCBatch) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<float> dual_coefficients = {1.14360327f, 1.95968249f, -1.175683f, -1.92760275f, -1.32575698f,
+                                          -1.32575698f, 0.66332785f, 0.66242913f, 0.53120854f, 0.53510444f,
+                                          -1.06631298f, -1.06631298f, 0.66332785f, 0.66242913f, 0.53120854f,
+                                          0.53510444f, 1.f, -1.f};
+  std::vector<float> support_vectors = {0.f, 0.5f, 32.f, 2.f, 2.9f, -32.f, 1.f, 1.5f, 1.f, 3.f,
+                                        13.3f, -11.f, 12.f, 12.9f, -312.f, 43.f, 413.3f, -114.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3};
+  std::vector<int64_t> vectors_per_class = {2, 2, 1, 1};
+  std::vector<float> rho = {0.5279583f, 0.32605162f, 0.32605162f, 0.06663721f, 0.06663721f, 0.f};
+  std::vector<float> kernel_params = {0.001f, 0.f, 3.f};  //gamma, coef0, degree
+
+  std::vector<float> X = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f,
+                          11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f,
+                          11.3f, -222.f, 43.0f, 413.3f, -114.f};
+  std::vector<int64_t> predictions = {1, 1, 2, 0, 0, 0, 0, 3};
+  std::vector<float> scores = {
+      -0.956958294f, 0.799815655f, 0.799815655f, 0.988598406f, 0.988598406f, 0,
+      -0.159782529f, 0.407864451f, 0.407864451f, 0.347750872f, 0.347750872f, 0,
+      0.527958274f, -0.999705434f, 0.326051623f, -0.999675810f, 0.0666372105f, 1.00000000f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, 0.326051623f, 0.0666372105f, 0.0666372105f, 0,
+      0.527958274f, 0.325695992f, 0.326051623f, 0.0663511604f, 0.0666372105f, 0.000268258271f,
+      0.527958274f, 0.326051623f, -0.999705434f, 0.0666372105f, -0.999675810f, -1.00000000f};
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  // enough rows for several blocks of rows, which score each row as on its own
+  const int64_t repeats = 64;
+  std::vector<float> batch_X;
+  std::vector<int64_t> batch_predictions;
+  std::vector<float> batch_scores;
+  for (int64_t i = 0; i < repeats; ++i) {
+    batch_X.insert(batch_X.end(), X.begin(), X.end());
+    batch_predictions.insert(batch_predictions.end(), predictions.begin(), predictions.end());
+    batch_scores.insert(batch_scores.end(), scores.begin(), scores.end());
+  }
+
+  test.AddInput<float>("X", {8 * repeats, 3}, batch_X);
+  test.AddOutput<int64_t>("Y", {8 * repeats}, batch_predictions);
+  test.AddOutput<float>("Z", {8 * repeats, 6}, batch_scores);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
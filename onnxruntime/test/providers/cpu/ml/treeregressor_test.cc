@@ -121,5 +121,63 @@ TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorManyRowsAndTrees) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  // enough trees and rows that the evaluation is split into row blocks and tree partitions
+  const int64_t num_trees = 300;
+  const int64_t num_rows = 150;
+
+  std::vector<int64_t> lefts, rights, treeids, nodeids, featureids;
+  std::vector<float> thresholds;
+  std::vector<std::string> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_classids;
+  std::vector<float> target_weights;
+  for (int64_t t = 0; t < num_trees; ++t) {
+    // stump on feature t % 2: x <= 0.5 votes 1 for target 0, otherwise votes 2 for target 1
+    lefts.insert(lefts.end(), {1, 0, 0});
+    rights.insert(rights.end(), {2, 0, 0});
+    treeids.insert(treeids.end(), {t, t, t});
+    nodeids.insert(nodeids.end(), {0, 1, 2});
+    featureids.insert(featureids.end(), {t % 2, 0, 0});
+    thresholds.insert(thresholds.end(), {0.5f, 0.f, 0.f});
+    modes.insert(modes.end(), {"BRANCH_LEQ", "LEAF", "LEAF"});
+    target_treeids.insert(target_treeids.end(), {t, t});
+    target_nodeids.insert(target_nodeids.end(), {1, 2});
+    target_classids.insert(target_classids.end(), {0, 1});
+    target_weights.insert(target_weights.end(), {1.f, 2.f});
+  }
+
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int64_t r = 0; r < num_rows; ++r) {
+    // row r % 3: both features low, feature 0 high, both features high
+    float x0 = r % 3 == 0 ? 0.f : 1.f;
+    float x1 = r % 3 == 2 ? 1.f : 0.f;
+    X.push_back(x0);
+    X.push_back(x1);
+    int64_t low_votes = (x0 <= 0.5f ? num_trees / 2 : 0) + (x1 <= 0.5f ? num_trees / 2 : 0);
+    results.push_back(static_cast<float>(low_votes));
+    results.push_back(2.f * static_cast<float>(num_trees - low_votes));
+  }
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)2);
+
+  test.AddInput<float>("X", {num_rows, 2}, X);
+  test.AddOutput<float>("Y", {num_rows, 2}, results);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
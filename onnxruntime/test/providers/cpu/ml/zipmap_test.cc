@@ -51,6 +51,11 @@ TEST(MLOpTest, ZipMapOpInt64Float) {
   TestHelper<int64_t>({10, 20, 30}, "int64_t", {2, 3});
 }
 
+TEST(MLOpTest, ZipMapOpUnsortedLabels) {
+  TestHelper<string>({"class3", "class1", "class2"}, "string", {2, 3});
+  TestHelper<int64_t>({30, 10, 20}, "int64_t", {2, 3});
+}
+
 TEST(MLOpTest, ZipMapOpInt64Float1D) {
   TestHelper<int64_t>({10, 20, 30, 40, 50, 60}, "int64_t", {6});
 }
@@ -47,5 +47,29 @@ TEST(ConvIntegerTest_with_padding, ConvIntegerTest) {
   test.Run();
 }
 
+TEST(ConvIntegerTest_pointwise, ConvIntegerTest) {
+  OpTester test("ConvInteger", 10);
+  std::vector<int64_t> x_dims{1, 2, 2, 2};
+  test.AddInput<uint8_t>("x", x_dims,
+                         {2, 3,
+                          4, 5,
+
+                          6, 7,
+                          8, 9});
+  std::vector<int64_t> w_dims{2, 2, 1, 1};
+  test.AddInput<uint8_t>("w", w_dims,
+                         {1, 2,
+                          3, 1});
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+  std::vector<int64_t> y_dims{1, 2, 2, 2};
+  test.AddOutput<int32_t>("y", y_dims,
+                          {11, 14,
+                           17, 20,
+
+                           8, 12,
+                           16, 20});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
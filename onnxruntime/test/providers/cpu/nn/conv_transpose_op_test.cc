@@ -77,6 +77,38 @@ TEST(ConvTransposeTest, ConvTranspose_2D) {
   TestConvTransposeOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+TEST(ConvTransposeTest, ConvTranspose_2D_Stride2_Group_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{4, 4},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{1, 1, 1, 1},  // pads
+      vector<int64_t>{2, 2},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      2                             // group
+  };
+  vector<float> X = {3.0f, 1.0f, 2.0f, 4.0f,
+                     5.0f, 2.0f, 1.0f, 3.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, -2.0f, -1.0f, 0.0f,
+                     1.0f, 2.0f, -2.0f, -1.0f, 0.0f, 1.0f, 2.0f, -2.0f,
+                     -1.0f, 0.0f, 1.0f, 2.0f, -2.0f, -1.0f, 0.0f, 1.0f,
+                     2.0f, -2.0f, -1.0f, 0.0f, 1.0f, 2.0f, -2.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 1, 4, 4};
+  vector<float> B = {1.0f, -2.0f};
+  vector<int64_t> B_shape = {2};
+  vector<int64_t> Y_shape = {1, 2, 4, 4};
+  auto expected_vals = {-5.0f, 0.0f, -1.0f, 0.0f,
+                        5.0f, -12.0f, -2.0f, -1.0f,
+                        0.0f, 13.0f, -12.0f, -1.0f,
+                        5.0f, 1.0f, 7.0f, -7.0f,
+                        -7.0f, -6.0f, 1.0f, -2.0f,
+                        -12.0f, -5.0f, -4.0f, -1.0f,
+                        7.0f, -16.0f, -5.0f, -6.0f,
+                        -4.0f, 3.0f, -8.0f, -5.0f};
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 TEST(ConvTransposeTest, ConvTranspose_2D_Bias_1) {
   ConvTransposeOpAttributes attrs = {
       vector<int64_t>{3, 3},        // kernel_shape
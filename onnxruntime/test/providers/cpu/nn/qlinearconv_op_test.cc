@@ -176,6 +176,49 @@ TEST(ConvTest, QLinearConv3DTest) {
   test.Run();
 }
 
+#ifndef USE_GEMMLOWP
+TEST(ConvTest, QLinearConvPerChannelFilterScale) {
+  OpTester test("QLinearConv", 10);
+
+  // the second output channel is scaled by half, with a bias of 2
+  test.AddInput<uint8_t>("x", {1, 1, 1, 3}, {2, 4, 6});
+  test.AddInput<float>("x_scale", {}, {1.f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {0});
+
+  test.AddInput<uint8_t>("w", {2, 1, 1, 1}, {1, 1});
+  test.AddInput<float>("w_scale", {2}, {1.f, 0.5f});
+  test.AddInput<uint8_t>("w_zero_point", {}, {0});
+
+  test.AddInput<float>("y_scale", {}, {1.f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {0});
+  test.AddInput<int32_t>("B", {2}, {0, 4});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 1, 3}, {2, 4, 6, 3, 4, 5});
+
+  test.Run();
+}
+
+TEST(ConvTest, QLinearConvPerChannelFilterZeroPoint) {
+  OpTester test("QLinearConv", 10);
+
+  // x - x_zero_point = {1, 3, 5}, and w - w_zero_point = {2, 3}
+  test.AddInput<uint8_t>("x", {1, 1, 1, 3}, {2, 4, 6});
+  test.AddInput<float>("x_scale", {}, {1.f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+
+  test.AddInput<uint8_t>("w", {2, 1, 1, 1}, {3, 11});
+  test.AddInput<float>("w_scale", {}, {1.f});
+  test.AddInput<uint8_t>("w_zero_point", {2}, {1, 8});
+
+  test.AddInput<float>("y_scale", {}, {1.f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {0});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 1, 3}, {2, 6, 10, 3, 9, 15});
+
+  test.Run();
+}
+#endif
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
@@ -344,5 +344,44 @@ TEST(NonMaxSuppressionOpTest, ZeroMaxOutputPerClass) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManyBatchesAndClasses) {
+  // enough (batch, class) pairs and boxes that the pairs are split across threads
+  const int64_t num_batches = 2, num_classes = 8, num_boxes = 512, max_output = 3;
+  std::vector<float> boxes;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t i = 0; i < num_boxes; ++i) {
+      // disjoint unit boxes, so only max_output_boxes_per_class limits the selection
+      const float x = static_cast<float>(2 * i);
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+  }
+
+  std::vector<float> scores;
+  std::vector<int64_t> selected;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t c = 0; c < num_classes; ++c) {
+      // 7 is coprime with num_boxes, so each class scores the boxes with a different permutation
+      std::vector<int64_t> box_with_rank(num_boxes);
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        const int64_t rank = (i * 7 + c * 13 + b * 5) % num_boxes;
+        scores.push_back(static_cast<float>(rank) / num_boxes);
+        box_with_rank[rank] = i;
+      }
+      for (int64_t k = 0; k < max_output; ++k) {
+        selected.insert(selected.end(), {b, c, box_with_rank[num_boxes - 1 - k]});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 10, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * max_output, 3}, selected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
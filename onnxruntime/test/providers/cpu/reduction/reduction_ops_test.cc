@@ -1240,5 +1240,66 @@ TEST(ReductionOpTest, ArgMin_int32_neg_axis) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", excluded_eps); 
 }
 
+TEST(ReductionOpTest, ArgMax_middle_axis) {
+  OpTester test("ArgMax");
+  test.AddAttribute("axis", (int64_t)1);
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {2, 3, 2},
+                       {1.0f, 6.0f,
+                        3.0f, 6.0f,
+                        2.0f, 5.0f,
+
+                        7.0f, 8.0f,
+                        9.0f, 8.0f,
+                        9.0f, 10.0f});
+  test.AddOutput<int64_t>("reduced", {2, 2},
+                          {1, 0,
+                           1, 2});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMean_middle_axes_large) {
+  // large enough to be split across the threads of the pool
+  const int64_t outer = 4, reduced = 3 * 256, inner = 64;
+  std::vector<float> data(static_cast<size_t>(outer * reduced * inner));
+  std::vector<float> expected(static_cast<size_t>(outer * inner), 0.0f);
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t r = 0; r < reduced; ++r) {
+      for (int64_t i = 0; i < inner; ++i) {
+        float value = static_cast<float>((o * 7 + r * 3 + i) % 17);
+        data[(o * reduced + r) * inner + i] = value;
+        expected[o * inner + i] += value / reduced;
+      }
+    }
+  }
+
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {outer, 3, 256, inner}, data);
+  test.AddOutput<float>("reduced", {outer, 1, 1, inner}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceSum_head_axes_large) {
+  const int64_t reduced = 512, inner = 300;
+  std::vector<float> data(static_cast<size_t>(reduced * inner));
+  std::vector<float> expected(static_cast<size_t>(inner), 0.0f);
+  for (int64_t r = 0; r < reduced; ++r) {
+    for (int64_t i = 0; i < inner; ++i) {
+      float value = static_cast<float>((r + i) % 5) - 2.0f;
+      data[r * inner + i] = value;
+      expected[i] += value;
+    }
+  }
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {reduced, inner}, data);
+  test.AddOutput<float>("reduced", {inner}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
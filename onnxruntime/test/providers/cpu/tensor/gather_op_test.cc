@@ -305,5 +305,28 @@ TEST(GatherOpTest, Gather_perf) {
   test.AddOutput<int32_t>("output", {800, 1, 100}, output);
   test.Run();
 }
+TEST(GatherOpTest, Gather_axis0_embedding_lookup) {
+  // enough rows are gathered from the table that the lookups are split across threads
+  const int64_t rows = 20000, cols = 64, lookups = 1024;
+  std::vector<float> table(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    table[i] = static_cast<float>(i % 1000) + 0.5f;
+  }
+
+  std::vector<int64_t> indices(lookups);
+  std::vector<float> output;
+  output.reserve(lookups * cols);
+  for (int64_t i = 0; i < lookups; ++i) {
+    indices[i] = (i * 7919) % rows;
+    output.insert(output.end(), table.begin() + indices[i] * cols, table.begin() + (indices[i] + 1) * cols);
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {rows, cols}, table);
+  test.AddInput<int64_t>("indices", {32, lookups / 32}, indices);
+  test.AddOutput<float>("output", {32, lookups / 32, cols}, output);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
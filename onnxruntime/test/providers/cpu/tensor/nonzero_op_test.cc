@@ -93,5 +93,31 @@ TEST(NonZeroOpTest, EmptyInput) {
   test.Run();
 }
 
+// large enough for the input to be counted and scattered in chunks
+TEST(NonZeroOpTest, Large) {
+  OpTester test{kOpName, kOpVersion};
+
+  const int64_t rows = 300;
+  const int64_t columns = 257;
+  std::vector<float> X(rows * columns, 0.f);
+  std::vector<int64_t> row_indices;
+  std::vector<int64_t> column_indices;
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < columns; ++j) {
+      if ((i * columns + j) % 7 == 0 || j == columns - 1) {
+        X[i * columns + j] = static_cast<float>(j + 1);
+        row_indices.push_back(i);
+        column_indices.push_back(j);
+      }
+    }
+  }
+
+  std::vector<int64_t> Y(row_indices);
+  Y.insert(Y.end(), column_indices.begin(), column_indices.end());
+  test.AddInput<float>("X", {rows, columns}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(row_indices.size())}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
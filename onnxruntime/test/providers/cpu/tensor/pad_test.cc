@@ -163,5 +163,40 @@ TEST(TensorOpTest, Pad_Reflect_2D) {
   test.Run();
 }
 
+// Large enough for the rows of the outermost axis to be split across threads, with the outermost axis padded too.
+TEST(TensorOpTest, Pad_Reflect_3D_Large) {
+  OpTester test("Pad");
+
+  const int64_t D0 = 40, D1 = 16, D2 = 16;
+  const int64_t pads[] = {2, 1, 3, 2, 1, 3};
+  const int64_t O0 = D0 + 4, O1 = D1 + 2, O2 = D2 + 6;
+  auto reflect = [](int64_t index, int64_t pad, int64_t dim) {
+    index -= pad;
+    if (index < 0) return -index;
+    if (index >= dim) return 2 * (dim - 1) - index;
+    return index;
+  };
+
+  std::vector<float> input(D0 * D1 * D2);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+  std::vector<float> output;
+  for (int64_t i0 = 0; i0 < O0; ++i0) {
+    for (int64_t i1 = 0; i1 < O1; ++i1) {
+      for (int64_t i2 = 0; i2 < O2; ++i2) {
+        output.push_back(input[(reflect(i0, pads[0], D0) * D1 + reflect(i1, pads[1], D1)) * D2 +
+                               reflect(i2, pads[2], D2)]);
+      }
+    }
+  }
+
+  test.AddAttribute("pads", std::vector<int64_t>(pads, pads + 6));
+  test.AddAttribute("mode", "reflect");
+  test.AddInput<float>("data", {D0, D1, D2}, input);
+  test.AddOutput<float>("output", {O0, O1, O2}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <numeric>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -509,6 +511,33 @@ TEST(SliceTest, Slice2D_ImplicitCopyBySlicingADimensionFully) {
                       true);
 }
 
+// The axes copied whole are merged into the sliced axis, whose contiguous runs may be copied as wider words
+TEST(SliceTest, Slice3D_InnerAxesCopiedWhole) {
+  std::vector<float> input_vals(2 * 4 * 8);
+  std::iota(input_vals.begin(), input_vals.end(), 0.0f);
+
+  std::vector<float> output_vals;
+  for (int n = 0; n < 2; ++n) {
+    for (int c = 1; c < 3; ++c) {
+      for (int w = 0; w < 8; ++w) {
+        output_vals.push_back(static_cast<float>((n * 4 + c) * 8 + w));
+      }
+    }
+  }
+  RunSliceTest<float>({2, 4, 8}, input_vals, {1}, {3}, {1}, {}, {2, 2, 8}, output_vals);
+
+  // runs starting off the alignment of the wider words
+  output_vals.clear();
+  for (int n = 0; n < 2; ++n) {
+    for (int c = 0; c < 4; ++c) {
+      for (int w = 1; w < 7; ++w) {
+        output_vals.push_back(static_cast<float>((n * 4 + c) * 8 + w));
+      }
+    }
+  }
+  RunSliceTest<float>({2, 4, 8}, input_vals, {1}, {7}, {2}, {}, {2, 4, 6}, output_vals);
+}
+
 TEST(SliceTest, OptionalAxesInputAloneMissing) {
   std::vector<int64_t> input_dims = {6};
   auto input_vals = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
@@ -205,5 +205,76 @@ TEST(TransposeOpTest, NHWC2NCHW) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Computes the expected output of a transpose with a reference implementation.
+template <class T>
+std::vector<T> ReferenceTranspose(const std::vector<int64_t>& input_shape, const std::vector<T>& input_vals,
+                                  const std::vector<int64_t>& perm, std::vector<int64_t>& output_shape) {
+  size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+  output_shape.resize(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    output_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<T> output_vals;
+  std::vector<int64_t> index(rank, 0);
+  for (size_t n = 0; n < input_vals.size(); ++n) {
+    int64_t offset = 0;
+    for (size_t i = 0; i < rank; ++i) {
+      offset += index[i] * input_strides[perm[i]];
+    }
+    output_vals.push_back(input_vals[offset]);
+    for (size_t i = rank; i > 0; --i) {
+      if (++index[i - 1] < output_shape[i - 1]) break;
+      index[i - 1] = 0;
+    }
+  }
+  return output_vals;
+}
+
+template <class T>
+void LargeTransposeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  int64_t size = 1;
+  for (auto dim : input_shape) {
+    size *= dim;
+  }
+  std::vector<T> input_vals(static_cast<size_t>(size));
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 127);
+  }
+  std::vector<int64_t> output_shape;
+  std::vector<T> output_vals = ReferenceTranspose(input_shape, input_vals, perm, output_shape);
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", output_shape, output_vals);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// Large enough to use the tiled kernels and to be split across threads, with sizes that aren't multiples of the tiles
+TEST(TransposeOpTest, NCHW2NHWCLarge) {
+  LargeTransposeTest<float>({2, 35, 19, 21}, {0, 2, 3, 1});
+  LargeTransposeTest<int8_t>({2, 35, 19, 21}, {0, 2, 3, 1});
+}
+
+TEST(TransposeOpTest, NHWC2NCHWLarge) {
+  LargeTransposeTest<float>({2, 19, 21, 35}, {0, 3, 1, 2});
+  LargeTransposeTest<int64_t>({2, 19, 21, 35}, {0, 3, 1, 2});
+}
+
+TEST(TransposeOpTest, SwapLastTwoAxesLarge) {
+  LargeTransposeTest<int32_t>({3, 1, 130, 67}, {0, 1, 3, 2});
+  LargeTransposeTest<uint16_t>({3, 130, 1, 67}, {0, 3, 2, 1});
+}
+
+TEST(TransposeOpTest, SwapOuterAxesWithInnerBlock) {
+  LargeTransposeTest<float>({33, 65, 7}, {1, 0, 2});
+  LargeTransposeTest<float>({4, 1, 5}, {1, 2, 0});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
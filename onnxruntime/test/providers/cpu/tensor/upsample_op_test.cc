@@ -428,5 +428,67 @@ TEST(UpsampleOpTest, UpsampleOpNearest2XTest_opset9) {
   test.AddOutput<int32_t>("Y", {N, C, (int64_t)(H * scales[2]), (int64_t)(W * scales[3])}, Y);
   test.Run();
 }
+
+TEST(UpsampleOpTest, UpsampleOp4DNearestTest_ChannelsAndWidth) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 2.0f, 1.0f, 3.0f};
+  test.AddAttribute("mode", "nearest");
+  test.AddAttribute("scales", scales);
+
+  const int64_t N = 1, C = 2, H = 1, W = 2;
+  std::vector<float> X = {1.0f, 2.0f,
+
+                          3.0f, 4.0f};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+
+  std::vector<float> Y = {
+      1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f,
+
+      1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f,
+
+      3.0f, 3.0f, 3.0f, 4.0f, 4.0f, 4.0f,
+
+      3.0f, 3.0f, 3.0f, 4.0f, 4.0f, 4.0f};
+
+  test.AddOutput<float>("Y", {N, (int64_t)(C * scales[1]), H, (int64_t)(W * scales[3])}, Y);
+  test.Run();
+}
+
+TEST(UpsampleOpTest, UpsampleOp4DBilinearTest_ManyChannels) {
+  // enough output rows that they are split across threads
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 1.0f, 2.0f, 2.0f};
+  test.AddAttribute("mode", "linear");
+  test.AddAttribute("scales", scales);
+
+  // every plane is a linear ramp, which bilinear interpolation reproduces exactly
+  const int64_t N = 2, C = 16, H = 16, W = 16;
+  std::vector<float> X;
+  for (int64_t plane = 0; plane < N * C; ++plane) {
+    for (int64_t h = 0; h < H; ++h) {
+      for (int64_t w = 0; w < W; ++w) {
+        X.push_back(static_cast<float>(plane + h * W + w));
+      }
+    }
+  }
+  test.AddInput<float>("X", {N, C, H, W}, X);
+
+  std::vector<float> Y;
+  for (int64_t plane = 0; plane < N * C; ++plane) {
+    for (int64_t y = 0; y < H * 2; ++y) {
+      for (int64_t x = 0; x < W * 2; ++x) {
+        const float in_y = std::min(y / 2.0f, static_cast<float>(H - 1));
+        const float in_x = std::min(x / 2.0f, static_cast<float>(W - 1));
+        Y.push_back(plane + in_y * W + in_x);
+      }
+    }
+  }
+
+  test.AddOutput<float>("Y", {N, C, H * 2, W * 2}, Y);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
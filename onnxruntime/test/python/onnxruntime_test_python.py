@@ -2,6 +2,7 @@
 # Licensed under the MIT License.
 
 # -*- coding: UTF-8 -*-
+import json
 import unittest
 import os
 import numpy as np
@@ -80,6 +81,88 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelWithoutCopies(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        # the first array is used in place, the others are copied
+        inputs = [np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32),
+                  np.array([[1.0, 3.0, 5.0], [2.0, 4.0, 6.0]], dtype=np.float32).T,
+                  np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype='>f4')]
+        for x in inputs:
+            res = sess.run(["Y"], {"X": x})
+            np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        # the output keeps the memory of the session
+        res = sess.run(["Y"], {"X": inputs[0]})[0]
+        self.assertIsNotNone(res.base)
+        del sess
+        np.testing.assert_allclose(output_expected, res, rtol=1e-05, atol=1e-08)
+        res[0, 0] = 2.0
+        self.assertEqual(res[0, 0], 2.0)
+
+    def testRunMany(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        xs = [np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32) * i for i in range(4)]
+
+        results = sess.run_many(["Y"], [{"X": x} for x in xs])
+        self.assertEqual(len(results), len(xs))
+        for x, res in zip(xs, results):
+            np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+
+        results = sess.run_many(["Y"], [(x,) for x in xs], input_names=["X"])
+        for x, res in zip(xs, results):
+            np.testing.assert_allclose(x * x, res[0], rtol=1e-05, atol=1e-08)
+
+        self.assertEqual(sess.run_many(["Y"], []), [])
+        with self.assertRaises(RuntimeError):
+            sess.run_many(["Y"], [{"X": xs[0]}, {"Z": xs[1]}])
+
+    def testRunModelWithIOBinding(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        # an output allocated by the run
+        binding = sess.io_binding()
+        binding.bind_input("X", x)
+        binding.bind_output("Y")
+        sess.run_with_iobinding(binding)
+        outputs = binding.get_outputs()
+        self.assertEqual(outputs[0].device_name(), "cpu")
+        self.assertEqual(outputs[0].shape(), [3, 2])
+        self.assertEqual(outputs[0].element_type(), np.float32)
+        np.testing.assert_allclose(output_expected, binding.copy_outputs_to_cpu()[0], rtol=1e-05, atol=1e-08)
+
+        # an output written to a numpy array, which the OrtValue uses
+        y = np.zeros((3, 2), dtype=np.float32)
+        binding.clear_binding_outputs()
+        binding.bind_output("Y", onnxrt.OrtValue.ortvalue_from_numpy(y))
+        sess.run_with_iobinding(binding)
+        np.testing.assert_allclose(output_expected, y, rtol=1e-05, atol=1e-08)
+
+        if 'CUDAExecutionProvider' in onnxrt.get_available_providers():
+            x_gpu = onnxrt.OrtValue.ortvalue_from_numpy(x, 'cuda', 0)
+            y_gpu = onnxrt.OrtValue.ortvalue_from_shape_and_type([3, 2], np.float32, 'cuda', 0)
+            self.assertEqual(x_gpu.device_name(), "cuda")
+            binding.clear_binding_inputs()
+            binding.clear_binding_outputs()
+            binding.bind_input("X", x_gpu)
+            binding.bind_output("Y", y_gpu)
+            sess.run_with_iobinding(binding)
+            np.testing.assert_allclose(output_expected, y_gpu.numpy(), rtol=1e-05, atol=1e-08)
+
+    def testOrtValueDlpack(self):
+        if not hasattr(onnxrt.OrtValue, "from_dlpack"):
+            return
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        value = onnxrt.OrtValue.ortvalue_from_numpy(x)
+        copy = onnxrt.OrtValue.from_dlpack(value.to_dlpack())
+        self.assertEqual(copy.data_ptr(), value.data_ptr())
+        del value
+        np.testing.assert_allclose(x, copy.numpy())
+
     def testRunModelFromBytes(self):
         with open(self.get_name("mul_1.onnx"), "rb") as f:
             content = f.read()
@@ -132,6 +215,31 @@ class TestInferenceSession(unittest.TestCase):
         t1.join()
         t2.join()
 
+    def testRunModelAsync(self):
+        so = onnxrt.SessionOptions()
+        so.thread_pool_size = 2
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        results = []
+        done = threading.Event()
+
+        def callback(outputs, error):
+            results.append((outputs, error))
+            if len(results) == 4:
+                done.set()
+
+        for i in range(4):
+            sess.run_async(["Y"], {"X": x}, callback)
+        self.assertTrue(done.wait(60))
+
+        for outputs, error in results:
+            self.assertIsNone(error)
+            np.testing.assert_allclose(
+                output_expected, outputs[0], rtol=1e-05, atol=1e-08)
+
     def testRunDevice(self):
         device = onnxrt.get_device()
         self.assertTrue('CPU' in device or 'GPU' in device)
@@ -398,10 +506,18 @@ class TestInferenceSession(unittest.TestCase):
         with open(profile_file) as f:
             lines = f.readlines()
             self.assertTrue('[' in lines[0])
-            for i in range(1, 8):
+            for i in range(1, len(lines) - 1):
                 for tag in tags:
                     self.assertTrue(tag in lines[i])
-            self.assertTrue(']' in lines[8])
+            self.assertTrue(']' in lines[-1])
+
+    def testInitializationTimings(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        phases = [event['args']['phase'] for event in json.loads(sess.get_initialization_timings())]
+        self.assertIn('model_loading', phases)
+        self.assertIn('graph_partitioning', phases)
+        self.assertIn('kernel_creation', phases)
+        self.assertEqual(phases[-1], 'session_initialization')
 
     def testDictVectorizer(self):
         sess = onnxrt.InferenceSession(
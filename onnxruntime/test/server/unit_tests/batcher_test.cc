@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "server/batcher.h"
+#include "server/served_model.h"
+#include "server/environment.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace {
+Ort::Value CreateInput(std::vector<float>& data, std::vector<int64_t> shape) {
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  return Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+}
+
+// Runs one request with the given rows of X through the batcher and checks Y = X * [[1], [2]]
+void RunMatMul(Batcher& batcher, std::vector<float> x) {
+  const std::vector<std::string> input_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  const int64_t num_rows = static_cast<int64_t>(x.size() / 2);
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateInput(x, {num_rows, 2}));
+
+  auto outputs = batcher.Run(Ort::RunOptions{}, input_names, inputs, output_names);
+  ASSERT_EQ(outputs.size(), 1u);
+  auto shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+  ASSERT_EQ(shape, (std::vector<int64_t>{num_rows, 1}));
+
+  const auto* y = outputs[0].GetTensorMutableData<float>();
+  for (int64_t i = 0; i < num_rows; ++i) {
+    EXPECT_EQ(y[i], x[2 * i] + 2 * x[2 * i + 1]) << "row " << i;
+  }
+}
+
+// Runs a sequence of one row per step through the step model H_out = X + H_in, Y = H_out, starting from h or
+// zero-filled if h is empty, and checks Y holds the running sum of the steps and H_out the final sum
+void RunStepAdd(ServedModel& model, std::vector<float> x, std::vector<float> h) {
+  std::vector<std::string> input_names{"X"};
+  const std::vector<std::string> output_names{"Y", "H_out"};
+  const int64_t num_steps = static_cast<int64_t>(x.size() / 2);
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateInput(x, {num_steps, 1, 2}));
+  if (!h.empty()) {
+    input_names.push_back("H_in");
+    inputs.push_back(CreateInput(h, {1, 2}));
+  }
+
+  auto outputs = model.Run(Ort::RunOptions{}, input_names, inputs, output_names);
+  ASSERT_EQ(outputs.size(), 2u);
+  ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{num_steps, 1, 2}));
+  ASSERT_EQ(outputs[1].GetTensorTypeAndShapeInfo().GetShape(), (std::vector<int64_t>{1, 2}));
+
+  std::vector<float> sum = h.empty() ? std::vector<float>{0, 0} : h;
+  const auto* y = outputs[0].GetTensorMutableData<float>();
+  for (int64_t step = 0; step < num_steps; ++step) {
+    for (int64_t i = 0; i < 2; ++i) {
+      sum[i] += x[2 * step + i];
+      EXPECT_EQ(y[2 * step + i], sum[i]) << "step " << step;
+    }
+  }
+
+  const auto* h_out = outputs[1].GetTensorMutableData<float>();
+  EXPECT_EQ(h_out[0], sum[0]);
+  EXPECT_EQ(h_out[1], sum[1]);
+}
+}  // namespace
+
+TEST(BatcherTests, ConcurrentRequests) {
+  ServerEnvironment* env = ServerEnv();
+  env->EnableBatching(4, std::chrono::seconds(1));
+  env->InitializeModel("testdata/matmul_2.onnx");
+
+  auto model = env->GetModel("Name", "");
+  ASSERT_NE(model, nullptr);
+  Batcher* batcher = model->GetBatcher();
+  ASSERT_NE(batcher, nullptr);
+  EXPECT_TRUE(batcher->IsBatching());
+
+  // 1 + 1 + 2 rows fill a batch, the 3 rows of the last request make a second one that runs after the delay
+  std::vector<std::vector<float>> requests{{1, 2}, {3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12, 13, 14}};
+  const size_t num_session_runs = batcher->GetNumSessionRuns();
+  std::vector<std::thread> threads;
+  for (const auto& x : requests) {
+    threads.emplace_back([batcher, x]() { RunMatMul(*batcher, x); });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // whatever the order the requests arrive in, some of them share a batch
+  const size_t num_batches = batcher->GetNumSessionRuns() - num_session_runs;
+  EXPECT_LT(num_batches, requests.size());
+
+  // requests of max_batch_size rows are run on their own
+  RunMatMul(*batcher, {1, 2, 3, 4, 5, 6, 7, 8});
+  EXPECT_EQ(batcher->GetNumSessionRuns() - num_session_runs, num_batches + 1);
+
+  env->EnableBatching(1, std::chrono::microseconds(0));
+}
+
+TEST(BatcherTests, FixedBatchDimension) {
+  ServerEnvironment* env = ServerEnv();
+  env->EnableBatching(4, std::chrono::microseconds(100));
+  env->InitializeModel("testdata/mul_1.onnx");
+
+  auto model = env->GetModel("Name", "");
+  ASSERT_NE(model, nullptr);
+  Batcher* batcher = model->GetBatcher();
+  ASSERT_NE(batcher, nullptr);
+  EXPECT_FALSE(batcher->IsBatching());
+
+  std::vector<float> x{1, 2, 3, 4, 5, 6};
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateInput(x, {3, 2}));
+  auto outputs = batcher->Run(Ort::RunOptions{}, {"X"}, inputs, {"Y"});
+  ASSERT_EQ(outputs.size(), 1u);
+
+  const auto* y = outputs[0].GetTensorMutableData<float>();
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_EQ(y[i], x[i] * x[i]);
+  }
+
+  env->EnableBatching(1, std::chrono::microseconds(0));
+}
+
+TEST(BatcherTests, ConcurrentSequences) {
+  ServerEnvironment* env = ServerEnv();
+  env->EnableBatching(4, std::chrono::seconds(1));
+  env->EnableSequences({{"H_in", "H_out"}});
+  env->InitializeModel("testdata/step_add.onnx");
+
+  auto model = env->GetModel("Name", "");
+  ASSERT_NE(model, nullptr);
+  EXPECT_TRUE(model->IsStepModel());
+  ASSERT_NE(model->GetBatcher(), nullptr);
+  EXPECT_TRUE(model->GetBatcher()->IsBatching());
+
+  // sequences of 1, 3 and 5 steps share the batches of their steps, each leaving them once it's done
+  std::vector<std::vector<float>> sequences{{1, 2}, {3, 4, 5, 6, 7, 8}, {1, 1, 2, 2, 3, 3, 4, 4, 5, 5}};
+  std::vector<std::thread> threads;
+  for (const auto& x : sequences) {
+    threads.emplace_back([&model, x]() { RunStepAdd(*model, x, {}); });
+  }
+  threads.emplace_back([&model]() { RunStepAdd(*model, {1, 2, 3, 4}, {10, 20}); });
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  env->EnableSequences({});
+  env->EnableBatching(1, std::chrono::microseconds(0));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
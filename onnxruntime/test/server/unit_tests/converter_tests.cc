@@ -1108,6 +1108,40 @@ void CreateMLValueBool(AllocatorPtr alloc, const std::vector<int64_t>& dims, con
   p_value = Ort::Value{p_mlvalue};
 }
 
+TEST(TensorProtoToMLValueTests, RawDataInPlace) {
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> values = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+
+  onnx::TensorProto tp;
+  tp.set_raw_data(values.data(), values.size() * sizeof(float));
+  for (auto const& dim : dims) {
+    tp.add_dims(dim);
+  }
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Ort::Value ml_value{nullptr};
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto info = allocator.GetInfo();
+  ASSERT_TRUE(onnxruntime::server::TryTensorProtoRawDataToMLValue(tp, *info, ml_value));
+
+  // the value points into the raw data of the TensorProto
+  EXPECT_EQ(static_cast<const void*>(ml_value.GetTensorMutableData<float>()),
+            static_cast<const void*>(tp.raw_data().data()));
+  EXPECT_EQ(ml_value.GetTensorTypeAndShapeInfo().GetShape(), dims);
+}
+
+TEST(TensorProtoToMLValueTests, NoRawData) {
+  onnx::TensorProto tp;
+  tp.add_float_data(1.f);
+  tp.add_dims(1);
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Ort::Value ml_value{nullptr};
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto info = allocator.GetInfo();
+  EXPECT_FALSE(onnxruntime::server::TryTensorProtoRawDataToMLValue(tp, *info, ml_value));
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -63,6 +63,16 @@ TEST(HttpRouteTests, PostRouteInvalidURLTest) {
   run_route(predict_regex, http::verb::post, actions, false);
 }
 
+TEST(HttpRouteTests, GetRouteWithoutCaptureTest) {
+  auto metrics_regex = R"(/metrics)";
+
+  std::vector<test_data> actions{
+      std::make_tuple(http::verb::get, "/metrics", "", "", "", http::status::ok),
+      std::make_tuple(http::verb::get, "/metrics/foo", "", "", "", http::status::not_found)};
+
+  run_route(metrics_regex, http::verb::get, actions, true);
+}
+
 // These tests are because we currently only support POST and GET
 // Some HTTP methods should be removed from test data if we support more (e.g. PUT)
 TEST(HttpRouteTests, PostRouteInvalidMethodTest) {
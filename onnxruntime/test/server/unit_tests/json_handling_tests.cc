@@ -30,6 +30,28 @@ TEST(JsonDeserializationTests, WithUnknownField) {
   EXPECT_EQ(protobufutil::error::OK, status.error_code());
 }
 
+TEST(JsonDeserializationTests, RawData) {
+  // raw data as the JSON parser takes it: padded, unpadded, URL-safe, under either field name
+  std::string input_json = R"({"inputs":{"X":{"dims":["2"],"dataType":1,"rawData":"AACAPwAAAEA="},"Y" : {"raw_data" : "-_8"}},"outputFilter":["Z"]})";
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = onnxruntime::server::GetRequestFromJson(input_json, request);
+
+  ASSERT_EQ(protobufutil::error::OK, status.error_code());
+  const auto& x = request.inputs().at("X");
+  EXPECT_EQ(1, x.data_type());
+  EXPECT_EQ(1, x.dims_size());
+  EXPECT_EQ(std::string("\x00\x00\x80\x3f\x00\x00\x00\x40", 8), x.raw_data());
+  EXPECT_EQ(std::string("\xfb\xff"), request.inputs().at("Y").raw_data());
+  EXPECT_EQ("Z", request.output_filter(0));
+
+  // a rawData string out of the inputs is left to the JSON parser
+  input_json = R"({"foo":{"rawData":"hello"},"inputs":{"X":{"rawData":"AAE="}}})";
+  request.Clear();
+  status = onnxruntime::server::GetRequestFromJson(input_json, request);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code());
+  EXPECT_EQ(std::string("\x00\x01", 2), request.inputs().at("X").raw_data());
+}
+
 TEST(JsonDeserializationTests, InvalidData) {
   std::string input_json = R"({"inputs":{"Input3":{"dims":["1","1","28","28"],"dataType":1,"rawData":"hello"}},"outputFilter":["Plus214_Output_0"]})";
   onnxruntime::server::PredictRequest request;
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "server/environment.h"
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_sinks.h>
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace {
+const std::string kRepository = "model_repository_test";
+
+void AddVersion(const std::string& model_name, const std::string& version, const std::string& source) {
+  mkdir(kRepository.c_str(), 0755);
+  mkdir((kRepository + "/" + model_name).c_str(), 0755);
+  const auto version_dir = kRepository + "/" + model_name + "/" + version;
+  mkdir(version_dir.c_str(), 0755);
+
+  std::ifstream in(source, std::ios::binary);
+  std::ofstream out(version_dir + "/model.onnx", std::ios::binary);
+  out << in.rdbuf();
+}
+
+void RemoveVersion(const std::string& model_name, const std::string& version) {
+  const auto version_dir = kRepository + "/" + model_name + "/" + version;
+  std::remove((version_dir + "/model.onnx").c_str());
+  rmdir(version_dir.c_str());
+  rmdir((kRepository + "/" + model_name).c_str());
+}
+
+std::unique_ptr<ServerEnvironment> CreateEnvironment() {
+  spdlog::sink_ptr sink = std::make_shared<spdlog::sinks::stdout_sink_st>();
+  return std::make_unique<ServerEnvironment>(ORT_LOGGING_LEVEL_WARNING, spdlog::sinks_init_list{sink});
+}
+}  // namespace
+
+TEST(ModelRepositoryTests, MultipleModelsAndVersions) {
+  AddVersion("mul", "1", "testdata/mul_1.onnx");
+  AddVersion("matmul", "1", "testdata/matmul_1.onnx");
+  AddVersion("matmul", "2", "testdata/matmul_2.onnx");
+
+  auto env = CreateEnvironment();
+  env->InitializeModelRepository(kRepository);
+
+  auto mul = env->GetModel("mul", "");
+  ASSERT_NE(mul, nullptr);
+  EXPECT_EQ(mul->GetModelPath(), kRepository + "/mul/1/model.onnx");
+
+  auto latest = env->GetModel("matmul", "");
+  ASSERT_NE(latest, nullptr);
+  EXPECT_EQ(latest->GetModelPath(), kRepository + "/matmul/2/model.onnx");
+  EXPECT_EQ(env->GetModel("matmul", "2"), latest);
+
+  auto first = env->GetModel("matmul", "1");
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->GetModelPath(), kRepository + "/matmul/1/model.onnx");
+
+  EXPECT_EQ(env->GetModel("matmul", "3"), nullptr);
+  EXPECT_EQ(env->GetModel("matmul", "latest"), nullptr);
+  EXPECT_EQ(env->GetModel("add", ""), nullptr);
+
+  // a new version is swapped in, the loaded ones are kept
+  AddVersion("matmul", "3", "testdata/matmul_2.onnx");
+  env->ReloadModelRepository();
+  auto newest = env->GetModel("matmul", "");
+  ASSERT_NE(newest, nullptr);
+  EXPECT_EQ(newest->GetModelPath(), kRepository + "/matmul/3/model.onnx");
+  EXPECT_EQ(env->GetModel("matmul", "2"), latest);
+
+  // a removed version is unloaded, requests still holding it keep it alive
+  RemoveVersion("matmul", "3");
+  env->ReloadModelRepository();
+  EXPECT_EQ(env->GetModel("matmul", "3"), nullptr);
+  EXPECT_EQ(env->GetModel("matmul", ""), latest);
+  EXPECT_EQ(newest->GetModelPath(), kRepository + "/matmul/3/model.onnx");
+
+  RemoveVersion("matmul", "2");
+  RemoveVersion("matmul", "1");
+  RemoveVersion("mul", "1");
+  env->ReloadModelRepository();
+  EXPECT_EQ(env->GetModel("matmul", ""), nullptr);
+  EXPECT_EQ(env->GetModel("mul", ""), nullptr);
+  rmdir(kRepository.c_str());
+}
+
+TEST(ModelRepositoryTests, MemoryBudget) {
+  AddVersion("mul", "1", "testdata/mul_1.onnx");
+  AddVersion("matmul", "1", "testdata/matmul_1.onnx");
+  AddVersion("matmul", "2", "testdata/matmul_2.onnx");
+
+  // room for two of the models, whose files take 121 to 129 bytes
+  auto env = CreateEnvironment();
+  env->EnableModelResidency(260);
+  env->InitializeModelRepository(kRepository);
+
+  // the models are loaded on their first request and stay loaded while they fit
+  auto mul = env->GetModel("mul", "");
+  ASSERT_NE(mul, nullptr);
+  auto latest = env->GetModel("matmul", "");
+  ASSERT_NE(latest, nullptr);
+  EXPECT_EQ(env->GetModel("mul", ""), mul);
+
+  // a third model unloads the least recently used one, which the requests holding it keep alive
+  auto first = env->GetModel("matmul", "1");
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(env->GetModel("mul", ""), mul);
+  auto reloaded = env->GetModel("matmul", "2");
+  ASSERT_NE(reloaded, nullptr);
+  EXPECT_NE(reloaded, latest);
+  EXPECT_EQ(reloaded->GetModelPath(), latest->GetModelPath());
+  EXPECT_EQ(env->GetModel("mul", ""), mul);
+
+  RemoveVersion("matmul", "2");
+  RemoveVersion("matmul", "1");
+  RemoveVersion("mul", "1");
+  env->ReloadModelRepository();
+  EXPECT_EQ(env->GetModel("matmul", ""), nullptr);
+  rmdir(kRepository.c_str());
+}
+
+TEST(ModelRepositoryTests, SingleModel) {
+  auto env = CreateEnvironment();
+  EXPECT_EQ(env->GetModel("mul", ""), nullptr);
+
+  // a single model is served under any name and version
+  env->InitializeModel("testdata/mul_1.onnx");
+  auto model = env->GetModel("mul", "");
+  ASSERT_NE(model, nullptr);
+  EXPECT_EQ(env->GetModel("other", "3"), model);
+}
+
+TEST(ModelRepositoryTests, MissingRepository) {
+  auto env = CreateEnvironment();
+  EXPECT_THROW(env->InitializeModelRepository("does/not/exist"), std::runtime_error);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "server/request_scheduler.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+TEST(RequestSchedulerTests, ParseRequestSchedule) {
+  RequestPriority priority;
+  RequestDeadline deadline;
+  EXPECT_TRUE(ParseRequestSchedule("", "", priority, deadline).ok());
+  EXPECT_EQ(priority, RequestPriority::Normal);
+  EXPECT_EQ(deadline, kNoDeadline);
+
+  const auto now = std::chrono::steady_clock::now();
+  EXPECT_TRUE(ParseRequestSchedule("high", "100", priority, deadline).ok());
+  EXPECT_EQ(priority, RequestPriority::High);
+  EXPECT_GE(deadline, now + std::chrono::milliseconds(100));
+
+  EXPECT_EQ(ParseRequestSchedule("urgent", "", priority, deadline).error_code(),
+            protobufutil::error::Code::INVALID_ARGUMENT);
+  EXPECT_EQ(ParseRequestSchedule("low", "-1", priority, deadline).error_code(),
+            protobufutil::error::Code::INVALID_ARGUMENT);
+  EXPECT_EQ(ParseRequestSchedule("low", "10ms", priority, deadline).error_code(),
+            protobufutil::error::Code::INVALID_ARGUMENT);
+}
+
+TEST(RequestSchedulerTests, DropsRequestsPastTheirDeadline) {
+  RequestScheduler scheduler(1);
+  Ort::RunOptions options;
+  std::unique_ptr<RequestScheduler::Admission> admission;
+  EXPECT_EQ(scheduler.Admit(RequestPriority::High, std::chrono::steady_clock::now(), &options, admission).error_code(),
+            protobufutil::error::Code::DEADLINE_EXCEEDED);
+  EXPECT_EQ(admission, nullptr);
+
+  // the deadline passes while the request waits for the one running
+  ASSERT_TRUE(scheduler.Admit(RequestPriority::Normal, kNoDeadline, &options, admission).ok());
+  std::unique_ptr<RequestScheduler::Admission> waiting;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+  EXPECT_EQ(scheduler.Admit(RequestPriority::High, deadline, &options, waiting).error_code(),
+            protobufutil::error::Code::DEADLINE_EXCEEDED);
+
+  admission.reset();
+  EXPECT_TRUE(scheduler.Admit(RequestPriority::Low, kNoDeadline, nullptr, waiting).ok());
+}
+
+TEST(RequestSchedulerTests, RunsHigherPriorityFirst) {
+  RequestScheduler scheduler(1);
+  Ort::RunOptions options;
+  std::unique_ptr<RequestScheduler::Admission> running;
+  ASSERT_TRUE(scheduler.Admit(RequestPriority::Normal, kNoDeadline, &options, running).ok());
+
+  std::mutex mutex;
+  std::vector<RequestPriority> order;
+  auto run = [&](RequestPriority priority) {
+    Ort::RunOptions request_options;
+    std::unique_ptr<RequestScheduler::Admission> admission;
+    ASSERT_TRUE(scheduler.Admit(priority, kNoDeadline, &request_options, admission).ok());
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(priority);
+  };
+
+  // the requests queue up in the reverse order of their priority
+  std::vector<std::thread> threads;
+  for (auto priority : {RequestPriority::Low, RequestPriority::Normal, RequestPriority::High}) {
+    threads.emplace_back(run, priority);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  running.reset();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(order, (std::vector<RequestPriority>{RequestPriority::High, RequestPriority::Normal, RequestPriority::Low}));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace {
+PredictRequest CreateRequest(const std::string& x, const std::string& y) {
+  PredictRequest request;
+  (*request.mutable_inputs())["X"].set_raw_data(x);
+  (*request.mutable_inputs())["Y"].set_raw_data(y);
+  return request;
+}
+
+PredictResponse CreateResponse(const std::string& z) {
+  PredictResponse response;
+  (*response.mutable_outputs())["Z"].set_raw_data(z);
+  return response;
+}
+}  // namespace
+
+TEST(ResponseCacheTests, Key) {
+  std::string key, other_key;
+  ASSERT_TRUE(ResponseCache::GetKey("model/1/model.onnx", CreateRequest("a", "b"), key));
+  ASSERT_TRUE(ResponseCache::GetKey("model/1/model.onnx", CreateRequest("a", "b"), other_key));
+  EXPECT_EQ(key, other_key);
+
+  ASSERT_TRUE(ResponseCache::GetKey("model/2/model.onnx", CreateRequest("a", "b"), other_key));
+  EXPECT_NE(key, other_key);
+  ASSERT_TRUE(ResponseCache::GetKey("model/1/model.onnx", CreateRequest("ab", ""), other_key));
+  EXPECT_NE(key, other_key);
+
+  auto request = CreateRequest("a", "b");
+  request.add_output_filter("Z");
+  ASSERT_TRUE(ResponseCache::GetKey("model/1/model.onnx", request, other_key));
+  EXPECT_NE(key, other_key);
+
+  // the shared memory inputs aren't in the request
+  (*request.mutable_shared_memory_inputs())["W"].set_region("frames");
+  EXPECT_FALSE(ResponseCache::GetKey("model/1/model.onnx", request, other_key));
+}
+
+TEST(ResponseCacheTests, EvictsLeastRecentlyUsed) {
+  // room for about two entries
+  ResponseCache cache(200, std::chrono::milliseconds(0));
+  const std::string value(50, 'z');
+
+  PredictResponse response;
+  EXPECT_FALSE(cache.Get("a", response));
+  cache.Put("a", CreateResponse(value));
+  cache.Put("b", CreateResponse(value));
+  ASSERT_TRUE(cache.Get("a", response));
+  EXPECT_EQ(response.outputs().at("Z").raw_data(), value);
+
+  // b is the least recently used
+  cache.Put("c", CreateResponse(value));
+  EXPECT_EQ(cache.GetSize(), 2u);
+  EXPECT_TRUE(cache.Get("a", response));
+  EXPECT_FALSE(cache.Get("b", response));
+  EXPECT_TRUE(cache.Get("c", response));
+
+  // larger than the cache
+  cache.Put("d", CreateResponse(std::string(300, 'z')));
+  EXPECT_FALSE(cache.Get("d", response));
+  EXPECT_EQ(cache.GetSize(), 2u);
+}
+
+TEST(ResponseCacheTests, Expires) {
+  ResponseCache cache(1024, std::chrono::milliseconds(50));
+  cache.Put("a", CreateResponse("z"));
+
+  PredictResponse response;
+  EXPECT_TRUE(cache.Get("a", response));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(cache.Get("a", response));
+  EXPECT_EQ(cache.GetSize(), 0u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
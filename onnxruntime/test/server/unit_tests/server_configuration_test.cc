@@ -42,6 +42,13 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.address, "0.0.0.0");
   EXPECT_EQ(config.http_port, 8001);
   EXPECT_EQ(config.num_http_threads, 3);
+  EXPECT_EQ(config.num_http_workers, static_cast<int>(std::thread::hardware_concurrency()));
+  EXPECT_EQ(config.max_queued_http_requests, 1024);
+  EXPECT_EQ(config.max_batch_size, 1);
+  EXPECT_EQ(config.max_concurrent_runs, 0);
+  EXPECT_EQ(config.response_cache_mb, 0);
+  EXPECT_EQ(config.num_replicas, 1);
+  EXPECT_EQ(config.threads_per_replica, 0);
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
@@ -92,6 +99,127 @@ TEST(ConfigParsingTests, WrongLoggingLevel) {
   EXPECT_EQ(res, Result::ExitFailure);
 }
 
+TEST(ConfigParsingTests, Batching) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("8"),
+      const_cast<char*>("--max_queue_delay_us"), const_cast<char*>("500")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 8);
+  EXPECT_EQ(config.max_queue_delay_us, 500);
+}
+
+TEST(ConfigParsingTests, WrongMaxBatchSize) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, Replicas) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_replicas"), const_cast<char*>("4"),
+      const_cast<char*>("--threads_per_replica"), const_cast<char*>("2")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_replicas, 4);
+  EXPECT_EQ(config.threads_per_replica, 2);
+}
+
+TEST(ConfigParsingTests, WrongNumReplicas) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_replicas"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, CudaDevice) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--cuda_device_id"), const_cast<char*>("1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.cuda_device_id, 1);
+}
+
+TEST(ConfigParsingTests, ModelRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata"),
+      const_cast<char*>("--repository_poll_interval_s"), const_cast<char*>("5")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.repository_path, "testdata");
+  EXPECT_EQ(config.repository_poll_interval_s, 5);
+  EXPECT_TRUE(config.model_path.empty());
+}
+
+TEST(ConfigParsingTests, ModelMemoryBudget) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata"),
+      const_cast<char*>("--model_memory_budget_mb"), const_cast<char*>("512")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.model_memory_budget_mb, 512);
+}
+
+TEST(ConfigParsingTests, SequenceStates) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--sequence_states"), const_cast<char*>("h_in:h_out,c_in:c_out")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  ASSERT_EQ(config.sequence_states.size(), 2u);
+  EXPECT_EQ(config.sequence_states[0], std::make_pair(std::string("h_in"), std::string("h_out")));
+  EXPECT_EQ(config.sequence_states[1], std::make_pair(std::string("c_in"), std::string("c_out")));
+
+  char* bad_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--sequence_states"), const_cast<char*>("h_in:h_out,c_in")};
+
+  onnxruntime::server::ServerConfiguration bad_config{};
+  EXPECT_EQ(bad_config.ParseInput(5, bad_argv), Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, ModelPathAndRepository) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--repository_path"), const_cast<char*>("testdata")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
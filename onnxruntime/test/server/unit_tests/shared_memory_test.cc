@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "server/environment.h"
+#include "server/executor.h"
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_sinks.h>
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+namespace {
+const std::string kKey = "/onnxruntime_server_shared_memory_test";
+
+// a shared memory object of the test, removed once the test is done
+class SharedMemoryObject {
+ public:
+  explicit SharedMemoryObject(size_t size) : size_(size) {
+    const int fd = shm_open(kKey.c_str(), O_CREAT | O_RDWR, 0600);
+    EXPECT_NE(fd, -1);
+    EXPECT_EQ(ftruncate(fd, static_cast<off_t>(size)), 0);
+    data_ = static_cast<float*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+  }
+
+  ~SharedMemoryObject() {
+    munmap(data_, size_);
+    shm_unlink(kKey.c_str());
+  }
+
+  float* Data() const { return data_; }
+
+ private:
+  size_t size_;
+  float* data_;
+};
+
+std::unique_ptr<ServerEnvironment> CreateEnvironment() {
+  spdlog::sink_ptr sink = std::make_shared<spdlog::sinks::stdout_sink_st>();
+  return std::make_unique<ServerEnvironment>(ORT_LOGGING_LEVEL_WARNING, spdlog::sinks_init_list{sink});
+}
+
+void SetTensor(SharedMemoryTensor& tensor, uint64_t offset, uint64_t byte_size) {
+  tensor.Clear();
+  tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  tensor.add_dims(3);
+  tensor.add_dims(2);
+  tensor.set_region("frames");
+  tensor.set_offset(offset);
+  tensor.set_byte_size(byte_size);
+}
+}  // namespace
+
+TEST(SharedMemoryTests, Registration) {
+  SharedMemoryObject object(4096);
+  SharedMemoryManager manager;
+
+  EXPECT_TRUE(manager.Register("frames", kKey, 0, 4096).ok());
+  EXPECT_EQ(manager.Register("frames", kKey, 0, 4096).error_code(), protobufutil::error::Code::ALREADY_EXISTS);
+  EXPECT_EQ(manager.Register("missing", "/onnxruntime_server_missing", 0, 16).error_code(),
+            protobufutil::error::Code::INVALID_ARGUMENT);
+  EXPECT_EQ(manager.Register("too_large", kKey, 4000, 100).error_code(), protobufutil::error::Code::INVALID_ARGUMENT);
+
+  // the region starts within a page
+  EXPECT_TRUE(manager.Register("offset", kKey, 100, 8).ok());
+  object.Data()[25] = 42.0f;
+  EXPECT_EQ(*reinterpret_cast<float*>(manager.Get("offset")->GetData()), 42.0f);
+
+  // a region held by a request stays mapped once unregistered
+  auto region = manager.Get("frames");
+  EXPECT_TRUE(manager.Unregister("frames").ok());
+  EXPECT_EQ(manager.Get("frames"), nullptr);
+  EXPECT_EQ(manager.Unregister("frames").error_code(), protobufutil::error::Code::NOT_FOUND);
+  EXPECT_EQ(reinterpret_cast<float*>(region->GetData())[25], 42.0f);
+}
+
+TEST(SharedMemoryTests, PredictInPlace) {
+  SharedMemoryObject object(4096);
+  const std::vector<float> input = {1, 2, 3, 4, 5, 6};
+  std::memcpy(object.Data(), input.data(), input.size() * sizeof(float));
+
+  auto env = CreateEnvironment();
+  env->InitializeModel("testdata/mul_1.onnx");
+  ASSERT_TRUE(env->GetSharedMemory().Register("frames", kKey, 0, 4096).ok());
+
+  PredictRequest request;
+  SetTensor((*request.mutable_shared_memory_inputs())["X"], 0, 24);
+  SetTensor((*request.mutable_shared_memory_outputs())["Y"], 1024, 1024);
+
+  Executor executor(env.get(), "RequestId");
+  PredictResponse response;
+  auto status = executor.Predict("Name", "", request, response);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+
+  EXPECT_TRUE(response.outputs().empty());
+  const auto& output = response.shared_memory_outputs().at("Y");
+  EXPECT_EQ(output.data_type(), onnx::TensorProto_DataType_FLOAT);
+  EXPECT_EQ(std::vector<int64_t>(output.dims().begin(), output.dims().end()), std::vector<int64_t>({3, 2}));
+  EXPECT_EQ(output.offset(), 1024u);
+  EXPECT_EQ(output.byte_size(), 24u);
+
+  const std::vector<float> expected = {1, 4, 9, 16, 25, 36};
+  EXPECT_EQ(std::vector<float>(object.Data() + 256, object.Data() + 262), expected);
+
+  // the output doesn't fit in a range too small for it
+  SetTensor((*request.mutable_shared_memory_outputs())["Y"], 1024, 16);
+  response.Clear();
+  EXPECT_EQ(executor.Predict("Name", "", request, response).error_code(),
+            protobufutil::error::Code::INVALID_ARGUMENT);
+
+  // an unknown region
+  (*request.mutable_shared_memory_inputs())["X"].set_region("unknown");
+  EXPECT_EQ(executor.Predict("Name", "", request, response).error_code(), protobufutil::error::Code::NOT_FOUND);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
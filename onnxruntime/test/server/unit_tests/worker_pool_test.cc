@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "server/http/core/worker_pool.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(WorkerPoolTests, TurnsAwayRequestsOverTheQueueLimit) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool release = false;
+  int done = 0;
+
+  {
+    WorkerPool workers(1, 2);
+    auto blocked = [&]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return release; });
+      ++done;
+    };
+
+    EXPECT_TRUE(workers.TryPost(blocked));
+    EXPECT_TRUE(workers.TryPost(blocked));
+    EXPECT_FALSE(workers.TryPost(blocked));
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      release = true;
+    }
+    cv.notify_all();
+  }
+
+  // the pool waits for the requests posted
+  EXPECT_EQ(done, 2);
+}
+
+TEST(WorkerPoolTests, RunsInlineWithoutThreads) {
+  WorkerPool workers(0, 1);
+  std::thread::id id;
+  EXPECT_TRUE(workers.TryPost([&id]() { id = std::this_thread::get_id(); }));
+  EXPECT_EQ(id, std::this_thread::get_id());
+  EXPECT_TRUE(workers.TryPost([]() {}));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "providers.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -145,6 +146,35 @@ INSTANTIATE_TEST_CASE_P(CApiTestWithProviders,
                         CApiTestWithProvider,
                         ::testing::Values(0, 1, 2, 3, 4));
 
+TEST_F(CApiTest, prepared_run) {
+  Ort::SessionOptions session_options;
+  Ort::Session session(env_, MODEL_URI, session_options);
+
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  Ort::PreparedRun prepared_run = session.PrepareRun(&input_name, 1, &output_name, 1);
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  auto default_allocator = std::make_unique<MockedOrtAllocator>();
+  Ort::Value input = Ort::Value::CreateTensor<float>(default_allocator->Info(default_allocator.get()),
+                                                     values_x.data(), values_x.size(), dims_x.data(), dims_x.size());
+  Ort::Value output = Ort::Value::CreateTensor<float>(default_allocator.get(), dims_x.data(), dims_x.size());
+
+  for (int i = 0; i != 2; ++i) {
+    session.Run(Ort::RunOptions{nullptr}, prepared_run, &input, 1, &output, 1);
+
+    auto type_info = output.GetTensorTypeAndShapeInfo();
+    ASSERT_EQ(type_info.GetShape(), dims_x);
+    float* f = output.GetTensorMutableData<float>();
+    for (size_t j = 0; j != expected_values_y.size(); ++j) {
+      ASSERT_EQ(expected_values_y[j], f[j]);
+    }
+  }
+}
+
 struct OrtTensorDimensions : std::vector<int64_t> {
   OrtTensorDimensions(Ort::CustomOpApi ort, const OrtValue* value) {
     OrtTensorTypeAndShapeInfo* info = ort.GetTensorTypeAndShape(value);
@@ -218,6 +248,68 @@ TEST_F(CApiTest, custom_op_handler) {
   TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
 }
 
+// Adds on the thread pool of the session, through a scratch buffer from its allocator
+struct MyParallelCustomKernel {
+  MyParallelCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* /*info*/) : ort_(ort) {
+  }
+
+  void Compute(OrtKernelContext* context) {
+    const OrtValue* input_X = ort_.KernelContext_GetInput(context, 0);
+    const OrtValue* input_Y = ort_.KernelContext_GetInput(context, 1);
+    const float* X = ort_.GetTensorData<float>(input_X);
+    const float* Y = ort_.GetTensorData<float>(input_Y);
+
+    OrtTensorDimensions dimensions(ort_, input_X);
+    OrtValue* output = ort_.KernelContext_GetOutput(context, 0, dimensions.data(), dimensions.size());
+    float* out = ort_.GetTensorMutableData<float>(output);
+
+    OrtTensorTypeAndShapeInfo* output_info = ort_.GetTensorTypeAndShape(output);
+    size_t size = ort_.GetTensorShapeElementCount(output_info);
+    ort_.ReleaseTensorTypeAndShapeInfo(output_info);
+
+    float* scratch = static_cast<float*>(ort_.KernelContext_AllocateTemp(context, size * sizeof(float)));
+    const size_t num_blocks = std::min(size, ort_.KernelContext_GetThreadCount(context));
+    ort_.KernelContext_ParallelFor(context, num_blocks, [&](size_t block) {
+      for (size_t i = block * size / num_blocks; i < (block + 1) * size / num_blocks; i++) {
+        scratch[i] = X[i] + Y[i];
+      }
+    });
+    std::copy(scratch, scratch + size, out);
+    ort_.KernelContext_FreeTemp(context, scratch);
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+};
+
+struct MyParallelCustomOp : Ort::CustomOpBase<MyParallelCustomOp, MyParallelCustomKernel> {
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyParallelCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+};
+
+TEST_F(CApiTest, custom_op_thread_pool_and_allocator) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyParallelCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
+}
+
 #if defined(ENABLE_LANGUAGE_INTEROP_OPS) && !defined(_WIN32)  // on windows, PYTHONHOME must be set explicitly
 TEST_F(CApiTest, test_pyop) {
   std::cout << "Test model with pyop" << std::endl;
@@ -80,6 +80,10 @@ Use the individual flags to only run the specified stages.
                                             "Read from CUDA_HOME environment variable if --use_cuda is true and --cuda_home is not specified.")
     parser.add_argument("--cudnn_home", help="Path to CUDNN home. "
                                              "Read from CUDNN_HOME environment variable if --use_cuda is true and --cudnn_home is not specified.")
+    parser.add_argument("--cuda_per_thread_streams", action='store_true',
+                        help="Run the CUDA nodes on a stream per thread, so that parallel execution is supported.")
+    parser.add_argument("--enable_cuda_profiling", action='store_true',
+                        help="Record the CUDA kernels and copies in the profile with CUPTI.")
 
     # Python bindings
     parser.add_argument("--enable_pybind", action='store_true', help="Enable Python Bindings.")
@@ -331,6 +335,8 @@ def generate_build_tree(cmake_path, source_dir, build_dir, cuda_home, cudnn_home
                  "-Donnxruntime_CUDNN_HOME=" + (cudnn_home if args.use_cuda else ""),
                  "-Donnxruntime_USE_AUTOML=" + ("ON" if args.use_automl else "OFF"),				 
                  "-Donnxruntime_CUDA_HOME=" + (cuda_home if args.use_cuda else ""),
+                 "-Donnxruntime_CUDA_PER_THREAD_STREAMS=" + ("ON" if args.use_cuda and args.cuda_per_thread_streams else "OFF"),
+                 "-Donnxruntime_ENABLE_CUDA_PROFILING=" + ("ON" if args.use_cuda and args.enable_cuda_profiling else "OFF"),
                  "-Donnxruntime_USE_JEMALLOC=" + ("ON" if args.use_jemalloc else "OFF"),
                  "-Donnxruntime_USE_MIMALLOC=" + ("ON" if args.use_mimalloc else "OFF"),
                  "-Donnxruntime_ENABLE_PYTHON=" + ("ON" if args.enable_pybind else "OFF"),
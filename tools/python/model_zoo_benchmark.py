@@ -0,0 +1,153 @@
+#!/usr/bin/env python
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+"""
+Runs the models of a manifest through onnxruntime_perf_test, records their latency, throughput, peak working set and
+session creation time, and compares them with a baseline of earlier results.
+
+The manifest lists the models by name, with the path of each relative to --model_dir. A model is run with the test
+data next to it, or with random inputs when "dims" gives the values of its symbolic dimensions (see the -d option of
+onnxruntime_perf_test). The random picks of the test data and the random inputs are seeded, so that runs compare.
+
+Exits with 1 if a metric of a model regressed by more than its tolerance from the baseline. --update_baseline writes
+the results as the new baseline instead.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+# the relative increase of each metric over the baseline that is reported as a regression
+DEFAULT_TOLERANCES = {
+    "average_ms": 0.10,
+    "p90_ms": 0.15,
+    "session_creation_ms": 0.20,
+    "peak_working_set_mb": 0.10,
+}
+
+# metrics that regress by decreasing
+HIGHER_IS_BETTER = {"runs_per_second"}
+
+DEFAULT_REPEATED_TIMES = 1000
+SEED = 0
+
+
+def parse_arguments():
+    script_dir = os.path.dirname(os.path.realpath(__file__))
+    parser = argparse.ArgumentParser(description="Model zoo benchmark of ONNX Runtime.")
+    parser.add_argument("--perf_test", required=True, help="Path to onnxruntime_perf_test.")
+    parser.add_argument("--model_dir", required=True, help="Directory of the models of the manifest.")
+    parser.add_argument("--manifest", default=os.path.join(script_dir, "model_zoo_benchmark.json"),
+                        help="JSON file listing the models to run.")
+    parser.add_argument("--provider", default="cpu", help="Execution provider, as the -e option of perf_test.")
+    parser.add_argument("--models", nargs="+", help="Run only these models of the manifest.")
+    parser.add_argument("--output", help="Write the results to this JSON file.")
+    parser.add_argument("--baseline", help="JSON file of the results to compare with.")
+    parser.add_argument("--update_baseline", action="store_true", help="Write the results to --baseline.")
+    parser.add_argument("--tolerance", type=float,
+                        help="Relative regression allowed for every metric, instead of the defaults of each.")
+    return parser.parse_args()
+
+
+def parse_output(output):
+    def find(pattern):
+        match = re.search(pattern, output)
+        if not match:
+            raise RuntimeError("'{}' not found in the output of perf_test:\n{}".format(pattern, output))
+        return float(match.group(1))
+
+    iterations = find(r"Total iterations:(\d+)")
+    run_time = find(r"Total run time:([\d.eE+-]+) s")
+    return {
+        "average_ms": find(r"Average time cost:([\d.eE+-]+) ms"),
+        "p90_ms": find(r"P90 Latency is ([\d.eE+-]+)sec") * 1000,
+        "runs_per_second": iterations / run_time,
+        "session_creation_ms": find(r"Session creation time cost:([\d.eE+-]+) s") * 1000,
+        "peak_working_set_mb": find(r"Peak working set size:(\d+) bytes") / (1024 * 1024),
+    }
+
+
+def run_model(args, model):
+    model_path = os.path.join(args.model_dir, model["path"])
+    # the result file of perf_test is appended to, so each run gets a new one
+    result_file = tempfile.NamedTemporaryFile(suffix=".txt", delete=False)
+    result_file.close()
+    try:
+        command = [args.perf_test, "-e", args.provider, "-m", "times",
+                   "-r", str(model.get("repeated_times", DEFAULT_REPEATED_TIMES)), "-R", str(SEED), "-s"]
+        if "dims" in model:
+            command += ["-d", model["dims"]]
+        command += [model_path, result_file.name]
+        print("Running " + " ".join(command))
+        process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        if process.returncode != 0:
+            raise RuntimeError("perf_test failed on {}:\n{}".format(model["name"], process.stdout))
+        return parse_output(process.stdout)
+    finally:
+        os.remove(result_file.name)
+
+
+def find_regressions(results, baseline, tolerance):
+    regressions = []
+    for name, metrics in sorted(results.items()):
+        if name not in baseline:
+            print("{} is not in the baseline".format(name))
+            continue
+        for metric, value in sorted(metrics.items()):
+            base = baseline[name].get(metric)
+            if not base:
+                continue
+            allowed = tolerance if tolerance is not None else DEFAULT_TOLERANCES.get(metric, 0.10)
+            change = (value - base) / base
+            if metric in HIGHER_IS_BETTER:
+                change = -change
+            if change > allowed:
+                regressions.append("{} {}: {:.3f} vs {:.3f} in the baseline ({:+.1%})".format(
+                    name, metric, value, base, change))
+    return regressions
+
+
+def main():
+    args = parse_arguments()
+    if args.update_baseline and not args.baseline:
+        raise ValueError("--update_baseline needs --baseline")
+
+    with open(args.manifest) as f:
+        models = json.load(f)["models"]
+    if args.models:
+        models = [model for model in models if model["name"] in args.models]
+
+    results = {}
+    for model in models:
+        results[model["name"]] = run_model(args, model)
+        print("{}: {}".format(model["name"], json.dumps(results[model["name"]], sort_keys=True)))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+        return 0
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = find_regressions(results, baseline, args.tolerance)
+        if regressions:
+            print("Regressions from the baseline:")
+            for regression in regressions:
+                print("  " + regression)
+            return 1
+        print("No regression from the baseline.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())